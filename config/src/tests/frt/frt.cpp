@@ -15,6 +15,7 @@
 #include <vespa/vespalib/data/slime/slime.h>
 #include <vespa/vespalib/data/slime/json_format.h>
 #include <vespa/vespalib/data/simple_buffer.h>
+#include <vespa/vespalib/util/exceptions.h>
 #include <vespa/fnet/frt/error.h>
 #include <vespa/fnet/frt/supervisor.h>
 #include <vespa/config/frt/protocol.h>
@@ -264,7 +265,7 @@ TEST("require that v3 request is correctly initialized") {
     Trace traceIn(3);
     traceIn.trace(2, "Hei");
     FRTConfigRequestV3 v3req(&conn, key, xxhash64, currentGeneration, hostName,
-                             timeout, traceIn, VespaVersion::fromString("1.2.3"), CompressionType::LZ4);
+                             timeout, traceIn, VespaVersion::fromString("1.2.3"), CompressionType::LZ4, false);
     ASSERT_TRUE(v3req.verifyState(ConfigState(xxhash64, 3, false)));
     ASSERT_FALSE(v3req.verifyState(ConfigState(xxhash64, 2, false)));
     ASSERT_FALSE(v3req.verifyState(ConfigState("xxx", 3, false)));
@@ -290,6 +291,7 @@ TEST("require that v3 request is correctly initialized") {
     EXPECT_EQUAL(count_ms(timeout), root[REQUEST_TIMEOUT].asLong());
     EXPECT_EQUAL("LZ4", root[REQUEST_COMPRESSION_TYPE].asString().make_string());
     EXPECT_EQUAL(root[REQUEST_VESPA_VERSION].asString().make_string(), "1.2.3");
+    EXPECT_FALSE(root[REQUEST_ACCEPT_PAYLOAD_DELTA].valid());
     Trace trace;
     trace.deserialize(root[REQUEST_TRACE]);
     EXPECT_TRUE(trace.shouldTrace(2));
@@ -305,6 +307,20 @@ TEST("require that v3 request is correctly initialized") {
     EXPECT_TRUE(response->validateResponse());
 }
 
+TEST("require that v3 request only accepts payload delta when it has a config to apply it to") {
+    ConnectionMock conn;
+    ConfigKey key = ConfigKey::create<MyConfig>("foobi");
+    auto accepts_delta = [&](const vespalib::string & xxhash64) {
+        FRTConfigRequestV3 v3req(&conn, key, xxhash64, 3, "myhost", 3s, Trace(0),
+                                 VespaVersion::fromString("1.2.3"), CompressionType::LZ4, true);
+        Slime slime;
+        JsonFormat::decode(Memory(v3req.getRequest()->GetParams()->GetValue(0)._string._str), slime);
+        return slime.get()[REQUEST_ACCEPT_PAYLOAD_DELTA].asBool();
+    };
+    EXPECT_TRUE(accepts_delta("myxxhash64"));
+    EXPECT_FALSE(accepts_delta(""));
+}
+
 struct V3RequestFixture {
     ConnectionMock conn;
     Slime slime;
@@ -408,4 +424,33 @@ TEST_F("require that empty v3 reponse is correctly initialized", V3RequestFixtur
     f1.assertResponse(*response, "defaultBar");
 }
 
+TEST_F("require that v3 payload delta response is applied to base config", V3RequestFixture()) {
+    const char *payload = "{\"barValue\":\"patched\"}";
+    f1.root.setString(RESPONSE_PAYLOAD_DELTA_BASE, "basexxhash64");
+    f1.encodePayload(payload, strlen(payload), strlen(payload), CompressionType::UNCOMPRESSED);
+    std::unique_ptr<FRTConfigResponseV3> response(f1.createResponse());
+    ASSERT_TRUE(response->validateResponse());
+    response->fill();
+    const ConfigValue & delta = response->getValue();
+    ASSERT_TRUE(delta.isPayloadDelta());
+    EXPECT_EQUAL("basexxhash64", delta.getPayloadDeltaBase());
+
+    auto baseSlime = std::make_unique<Slime>();
+    JsonFormat::decode("{\"barValue\":\"original\"}", *baseSlime);
+    struct BasePayload : Payload {
+        std::unique_ptr<Slime> data;
+        const Inspector & getSlimePayload() const override { return data->get(); }
+    };
+    auto basePayload = std::make_shared<BasePayload>();
+    basePayload->data = std::move(baseSlime);
+    ConfigValue base(basePayload, "basexxhash64");
+    ConfigValue merged(delta.applyPayloadDelta(base));
+    EXPECT_FALSE(merged.isPayloadDelta());
+    EXPECT_EQUAL(f1.xxhash64, merged.getXxhash64());
+    EXPECT_EQUAL("patched", merged.newInstance<BarConfig>()->barValue);
+
+    ConfigValue otherBase(basePayload, "otherxxhash64");
+    EXPECT_EXCEPTION(delta.applyPayloadDelta(otherBase), vespalib::IllegalArgumentException, "can not be applied");
+}
+
 TEST_MAIN() { TEST_RUN_ALL(); }
@@ -8,6 +8,7 @@
 #include <vespa/config/common/vespa_version.h>
 #include <vespa/config/subscription/sourcespec.h>
 #include <vespa/vespalib/stllike/hash_map.h>
+#include <vespa/vespalib/data/slime/slime.h>
 #include <map>
 
 using namespace config;
@@ -184,6 +185,24 @@ TEST("require that source spec parses compression type") {
     unsetenv(envName);
 }
 
+TEST("require that slime objects are merged as json merge patch") {
+    vespalib::Slime base;
+    vespalib::Slime patch;
+    vespalib::Slime merged;
+    vespalib::slime::JsonFormat::decode("{\"a\":1,\"b\":{\"c\":2,\"d\":3},\"e\":[1,2],\"f\":\"gone\"}", base);
+    vespalib::slime::JsonFormat::decode("{\"b\":{\"d\":4,\"x\":5},\"e\":[3],\"f\":null,\"g\":true}", patch);
+    mergeSlimeObject(base.get(), patch.get(), merged.setObject());
+    vespalib::Slime expected;
+    vespalib::slime::JsonFormat::decode("{\"a\":1,\"b\":{\"c\":2,\"d\":4,\"x\":5},\"e\":[3],\"g\":true}", expected);
+    EXPECT_EQUAL(expected, merged);
+
+    vespalib::Slime fromEmpty;
+    mergeSlimeObject(vespalib::Slime().get(), patch.get(), fromEmpty.setObject());
+    vespalib::Slime expectedFromEmpty;
+    vespalib::slime::JsonFormat::decode("{\"b\":{\"d\":4,\"x\":5},\"e\":[3],\"g\":true}", expectedFromEmpty);
+    EXPECT_EQUAL(expectedFromEmpty, fromEmpty);
+}
+
 TEST("require that vespa version is set") {
     VespaVersion vespaVersion = VespaVersion::getCurrentVersion();
     vespalib::string str = vespaVersion.toString();
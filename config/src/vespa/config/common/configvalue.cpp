@@ -4,31 +4,62 @@
 #include "misc.h"
 #include <vespa/config/frt/protocol.h>
 #include <vespa/vespalib/data/slime/slime.h>
+#include <vespa/vespalib/util/exceptions.h>
 
 namespace config {
 
+namespace {
+
+class MergedPayload : public protocol::Payload
+{
+public:
+    explicit MergedPayload(std::unique_ptr<vespalib::Slime> data) noexcept
+        : _data(std::move(data))
+    {
+    }
+
+    const vespalib::slime::Inspector & getSlimePayload() const override {
+        return _data->get();
+    }
+private:
+    std::unique_ptr<vespalib::Slime> _data;
+};
+
+}
+
 ConfigValue::ConfigValue(StringVector lines, const vespalib::string & xxhash)
     : _payload(),
       _lines(std::move(lines)),
-      _xxhash64(xxhash)
+      _xxhash64(xxhash),
+      _payloadDeltaBase()
 { }
 
 ConfigValue::ConfigValue(StringVector lines)
     : _payload(),
       _lines(std::move(lines)),
-      _xxhash64(calculateContentXxhash64(_lines))
+      _xxhash64(calculateContentXxhash64(_lines)),
+      _payloadDeltaBase()
 { }
 
 ConfigValue::ConfigValue()
     : _payload(),
       _lines(),
-      _xxhash64()
+      _xxhash64(),
+      _payloadDeltaBase()
 { }
 
 ConfigValue::ConfigValue(PayloadPtr payload, const vespalib::string & xxhash)
     : _payload(std::move(payload)),
       _lines(),
-      _xxhash64(xxhash)
+      _xxhash64(xxhash),
+      _payloadDeltaBase()
+{ }
+
+ConfigValue::ConfigValue(PayloadPtr payload, const vespalib::string & xxhash, const vespalib::string & payloadDeltaBase)
+    : _payload(std::move(payload)),
+      _lines(),
+      _xxhash64(xxhash),
+      _payloadDeltaBase(payloadDeltaBase)
 { }
 
 ConfigValue::ConfigValue(const ConfigValue &) = default;
@@ -47,6 +78,18 @@ ConfigValue::operator!=(const ConfigValue & rhs) const
     return (!(*this == rhs));
 }
 
+ConfigValue
+ConfigValue::applyPayloadDelta(const ConfigValue & base) const
+{
+    if ( ! isPayloadDelta() || ! _payload || ! base._payload || (base._xxhash64 != _payloadDeltaBase)) {
+        throw vespalib::IllegalArgumentException("Config payload delta against " + _payloadDeltaBase +
+                                                 " can not be applied to config " + base._xxhash64);
+    }
+    auto merged = std::make_unique<vespalib::Slime>();
+    mergeSlimeObject(base._payload->getSlimePayload(), _payload->getSlimePayload(), merged->setObject());
+    return ConfigValue(std::make_shared<MergedPayload>(std::move(merged)), _xxhash64);
+}
+
 StringVector
 ConfigValue::getLegacyFormat() const
 {
@@ -20,6 +20,7 @@ public:
     explicit ConfigValue(StringVector lines);
     ConfigValue(StringVector lines, const vespalib::string & xxhash);
     ConfigValue(PayloadPtr data, const vespalib::string & xxhash);
+    ConfigValue(PayloadPtr data, const vespalib::string & xxhash, const vespalib::string & payloadDeltaBase);
     ConfigValue();
     ConfigValue(ConfigValue &&) noexcept = default;
     ConfigValue & operator = (ConfigValue &&) noexcept = default;
@@ -37,6 +38,14 @@ public:
     vespalib::string asJson() const;
     const vespalib::string& getXxhash64() const { return _xxhash64; }
 
+    /**
+     * A payload delta is a JSON merge patch against the config with xxhash64
+     * getPayloadDeltaBase(), and must be applied to that config before use.
+     */
+    bool isPayloadDelta() const { return !_payloadDeltaBase.empty(); }
+    const vespalib::string& getPayloadDeltaBase() const { return _payloadDeltaBase; }
+    ConfigValue applyPayloadDelta(const ConfigValue & base) const;
+
     void serializeV1(::vespalib::slime::Cursor & cursor) const;
     void serializeV2(::vespalib::slime::Cursor & cursor) const;
 
@@ -47,6 +56,7 @@ private:
     PayloadPtr       _payload;
     StringVector     _lines;
     vespalib::string _xxhash64;
+    vespalib::string _payloadDeltaBase;
 };
 
 } //namespace config
@@ -81,7 +81,7 @@ public:
     void field(const Memory & symbol, const Inspector & inspector) override {
         switch(inspector.type().getId()) {
             case NIX::ID:
-                _dest.addNix();
+                _dest.setNix(symbol);
                 break;
             case BOOL::ID:
                 _dest.setBool(symbol, inspector.asBool());
@@ -164,4 +164,58 @@ void copySlimeObject(const Inspector & src, Cursor & dest)
     src.traverse(traverser);
 }
 
+namespace {
+
+class MergePatchTraverser : public ObjectTraverser
+{
+private:
+    const Inspector & _patch;
+    Cursor & _dest;
+public:
+    MergePatchTraverser(const Inspector & patch, Cursor & dest) : _patch(patch), _dest(dest) {}
+    void field(const Memory & symbol, const Inspector & inspector) override {
+        const Inspector & patched(_patch[symbol]);
+        if ( ! patched.valid()) {
+            CopyObjectTraverser(_dest).field(symbol, inspector);
+        } else if (patched.type().getId() == NIX::ID) {
+            // removed by patch
+        } else if ((patched.type().getId() == OBJECT::ID) && (inspector.type().getId() == OBJECT::ID)) {
+            mergeSlimeObject(inspector, patched, _dest.setObject(symbol));
+        } else {
+            CopyObjectTraverser(_dest).field(symbol, patched);
+        }
+    }
+};
+
+class AddedFieldsTraverser : public ObjectTraverser
+{
+private:
+    const Inspector & _base;
+    Cursor & _dest;
+public:
+    AddedFieldsTraverser(const Inspector & base, Cursor & dest) : _base(base), _dest(dest) {}
+    void field(const Memory & symbol, const Inspector & inspector) override {
+        if ( ! _base[symbol].valid() && (inspector.type().getId() != NIX::ID)) {
+            CopyObjectTraverser(_dest).field(symbol, inspector);
+        }
+    }
+};
+
+}
+
+void mergeSlimeObject(const Inspector & base, const Inspector & patch, Cursor & dest)
+{
+    if (patch.type().getId() != OBJECT::ID) {
+        throw vespalib::IllegalArgumentException("Patch inspector is not of type object");
+    }
+    if (base.type().getId() == OBJECT::ID) {
+        MergePatchTraverser merger(patch, dest);
+        base.traverse(merger);
+    } else if (base.type().getId() != NIX::ID) {
+        throw vespalib::IllegalArgumentException("Base inspector is not of type object");
+    }
+    AddedFieldsTraverser adder(base, dest);
+    patch.traverse(adder);
+}
+
 }
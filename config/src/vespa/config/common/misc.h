@@ -32,6 +32,15 @@ typedef std::shared_ptr<const vespalib::Slime> SlimePtr;
  */
 void copySlimeObject(const vespalib::slime::Inspector & src, vespalib::slime::Cursor & dest);
 
+/**
+ * Write the result of applying a JSON merge patch (RFC 7386) to the base
+ * object into dest: Fields set to null in the patch are removed, objects
+ * are merged recursively, and any other patch value (including arrays)
+ * replaces the base value. An empty (nix) base is treated as an empty object.
+ */
+void mergeSlimeObject(const vespalib::slime::Inspector & base, const vespalib::slime::Inspector & patch,
+                      vespalib::slime::Cursor & dest);
+
 StringVector getlines(vespalib::asciistream & is, char delim='\n');
 
 }
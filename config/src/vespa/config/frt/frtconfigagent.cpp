@@ -50,7 +50,19 @@ FRTConfigAgent::handleOKResponse(const ConfigRequest & request, std::unique_ptr<
 
     ConfigState newState = response->getConfigState();
     if ( ! request.verifyState(newState)) {
-        handleUpdatedGeneration(response->getKey(), newState, response->getValue());
+        const ConfigValue & value = response->getValue();
+        if (value.isPayloadDelta() && (value.getXxhash64() != _latest.getXxhash64())) {
+            if (value.getPayloadDeltaBase() != _latest.getXxhash64()) {
+                LOG(warning, "Got config payload delta against xxhash64 %s for %s, but have %s. Ignoring response",
+                    value.getPayloadDeltaBase().c_str(), response->getKey().toString().c_str(), _latest.getXxhash64().c_str());
+                setWaitTime(_timingValues.configuredErrorDelay, 1);
+                _nextTimeout = _timingValues.errorTimeout;
+                return;
+            }
+            handleUpdatedGeneration(response->getKey(), newState, value.applyPayloadDelta(_latest));
+        } else {
+            handleUpdatedGeneration(response->getKey(), newState, value);
+        }
     }
     setWaitTime(_timingValues.successDelay, 1);
     _nextTimeout = _timingValues.successTimeout;
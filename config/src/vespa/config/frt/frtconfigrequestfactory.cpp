@@ -1,6 +1,7 @@
 // Copyright Vespa.ai. Licensed under the terms of the Apache 2.0 license. See LICENSE in the project root.
 #include "frtconfigrequestfactory.h"
 #include "frtconfigrequestv3.h"
+#include "protocol.h"
 #include <vespa/config/common/trace.h>
 #include <vespa/config/common/configstate.h>
 #include <vespa/vespalib/util/host_name.h>
@@ -16,7 +17,8 @@ FRTConfigRequestFactory::FRTConfigRequestFactory(int traceLevel, const VespaVers
     : _traceLevel(traceLevel),
       _vespaVersion(vespaVersion),
       _hostName(vespalib::HostName::get()),
-      _compressionType(compressionType)
+      _compressionType(compressionType),
+      _acceptPayloadDelta(protocol::readProtocolPayloadDelta())
 {
 }
 
@@ -27,7 +29,8 @@ FRTConfigRequestFactory::createConfigRequest(const ConfigKey & key, Connection *
                                              const ConfigState & state, vespalib::duration serverTimeout) const
 {
     return make_unique<FRTConfigRequestV3>(connection, key, state.xxhash64, state.generation, _hostName,
-                                           serverTimeout, Trace(_traceLevel), _vespaVersion, _compressionType);
+                                           serverTimeout, Trace(_traceLevel), _vespaVersion, _compressionType,
+                                           _acceptPayloadDelta);
 }
 
 } // namespace config
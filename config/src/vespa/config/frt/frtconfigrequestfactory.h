@@ -30,6 +30,7 @@ private:
     const VespaVersion    _vespaVersion;
     vespalib::string      _hostName;
     const CompressionType _compressionType;
+    const bool            _acceptPayloadDelta;
 };
 
 } // namespace config
@@ -17,8 +17,10 @@ FRTConfigRequestV3::FRTConfigRequestV3(Connection * connection,
                                        vespalib::duration serverTimeout,
                                        const Trace & trace,
                                        const VespaVersion & vespaVersion,
-                                       const CompressionType & compressionType)
-    : SlimeConfigRequest(connection, key, configXxhash64, currentGeneration, hostName, serverTimeout, trace, vespaVersion, 3, compressionType, "config.v3.getConfig")
+                                       const CompressionType & compressionType,
+                                       bool acceptPayloadDelta)
+    : SlimeConfigRequest(connection, key, configXxhash64, currentGeneration, hostName, serverTimeout, trace, vespaVersion, 3, compressionType,
+                         acceptPayloadDelta, "config.v3.getConfig")
 {
 }
 
@@ -23,7 +23,8 @@ public:
                        duration serverTimeout,
                        const Trace & trace,
                        const VespaVersion & vespaVersion,
-                       const CompressionType & compressionType);
+                       const CompressionType & compressionType,
+                       bool acceptPayloadDelta);
     std::unique_ptr<ConfigResponse> createResponse(FRT_RPCRequest * request) const override;
 };
 
@@ -3,6 +3,8 @@
 #include "compressioninfo.h"
 #include <vespa/fnet/frt/values.h>
 #include <vespa/vespalib/data/simple_buffer.h>
+#include <cstring>
+#include <mutex>
 
 #include <vespa/log/log.h>
 LOG_SETUP(".config.frt.frtconfigresponsev3");
@@ -22,21 +24,60 @@ std::string make_json(const Slime &slime, bool compact) {
     return buf.get().make_string();
 }
 
+/**
+ * Keeps the payload as received, and only decompresses and decodes it when
+ * first inspected. Responses for a new generation of unchanged config are
+ * then dropped without ever being decoded.
+ */
 class V3Payload : public Payload
 {
 public:
-    explicit V3Payload(Slime::UP data) noexcept
-        : _data(std::move(data))
+    V3Payload(const char * buf, uint32_t len, const CompressionInfo & info)
+        : _raw(alloc::Alloc::alloc(len)),
+          _rawSize(len),
+          _info(info),
+          _decoded(),
+          _data()
     {
+        if (len > 0) {
+            memcpy(_raw.get(), buf, len);
+        }
     }
 
     const Inspector & getSlimePayload() const override {
+        std::call_once(_decoded, [this]() { decode(); });
         return _data->get();
     }
 private:
-    Slime::UP _data;
+    void decode() const;
+
+    mutable alloc::Alloc   _raw;
+    uint32_t               _rawSize;
+    CompressionInfo        _info;
+    mutable std::once_flag _decoded;
+    mutable Slime::UP      _data;
 };
 
+void
+V3Payload::decode() const
+{
+    auto slime = std::make_unique<Slime>();
+    DecompressedData data(decompress(static_cast<const char *>(_raw.get()), _rawSize, _info.compressionType, _info.uncompressedSize));
+    if (data.memRef.size > 0) {
+        size_t consumedSize = JsonFormat::decode(data.memRef, *slime);
+        if (consumedSize == 0) {
+            std::string json(make_json(*slime, true));
+            LOG(error, "Error decoding JSON. Consumed size: %lu, uncompressed size: %u, compression type: %s, assumed uncompressed size(%u), compressed size: %u, slime(%s)", consumedSize, data.size, compressionTypeToString(_info.compressionType).c_str(), _info.uncompressedSize, _rawSize, json.c_str());
+            LOG_ABORT("Error decoding JSON");
+        }
+    }
+    if (LOG_WOULD_LOG(spam)) {
+        LOG(spam, "decoded config payload, size: %lu", data.memRef.size);
+    }
+    _data = std::move(slime);
+    _raw = alloc::Alloc();
+}
+
 const vespalib::string FRTConfigResponseV3::RESPONSE_TYPES = "sx";
 
 FRTConfigResponseV3::FRTConfigResponseV3(FRT_RPCRequest * request)
@@ -54,22 +95,14 @@ ConfigValue
 FRTConfigResponseV3::readConfigValue() const
 {
     vespalib::string xxhash64(_data->get()[RESPONSE_CONFIG_XXHASH64].asString().make_string());
+    vespalib::string payloadDeltaBase(_data->get()[RESPONSE_PAYLOAD_DELTA_BASE].asString().make_string());
     CompressionInfo info;
     info.deserialize(_data->get()[RESPONSE_COMPRESSION_INFO]);
-    auto slime = std::make_unique<Slime>();
-    DecompressedData data(decompress(((*_returnValues)[1]._data._buf), ((*_returnValues)[1]._data._len), info.compressionType, info.uncompressedSize));
-    if (data.memRef.size > 0) {
-        size_t consumedSize = JsonFormat::decode(data.memRef, *slime);
-        if (consumedSize == 0) {
-            std::string json(make_json(*slime, true));
-            LOG(error, "Error decoding JSON. Consumed size: %lu, uncompressed size: %u, compression type: %s, assumed uncompressed size(%u), compressed size: %u, slime(%s)", consumedSize, data.size, compressionTypeToString(info.compressionType).c_str(), info.uncompressedSize, ((*_returnValues)[1]._data._len), json.c_str());
-            LOG_ABORT("Error decoding JSON");
-        }
-    }
+    const auto & payload = (*_returnValues)[1]._data;
     if (LOG_WOULD_LOG(spam)) {
-        LOG(spam, "read config value xxhash64(%s), payload size: %lu", xxhash64.c_str(), data.memRef.size);
+        LOG(spam, "read config value xxhash64(%s), payload size: %u, delta base(%s)", xxhash64.c_str(), payload._len, payloadDeltaBase.c_str());
     }
-    return ConfigValue(std::make_shared<V3Payload>(std::move(slime)), xxhash64);
+    return ConfigValue(std::make_shared<V3Payload>(payload._buf, payload._len, info), xxhash64, payloadDeltaBase);
 }
 
 } // namespace config
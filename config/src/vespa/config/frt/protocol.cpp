@@ -60,6 +60,8 @@ const Memory REQUEST_COMPRESSION_TYPE = "compressionType";
 const Memory RESPONSE_COMPRESSION_INFO = "compressionInfo";
 const Memory RESPONSE_COMPRESSION_INFO_TYPE = "compressionType";
 const Memory RESPONSE_COMPRESSION_INFO_UNCOMPRESSED_SIZE = "uncompressedSize";
+const Memory REQUEST_ACCEPT_PAYLOAD_DELTA = "acceptPayloadDelta";
+const Memory RESPONSE_PAYLOAD_DELTA_BASE = "payloadDeltaBase";
 
 DecompressedData
 decompress_lz4(const char * input, uint32_t inputLen, int uncompressedLength)
@@ -146,5 +148,16 @@ readProtocolCompressionType()
     return type;
 }
 
+bool
+readProtocolPayloadDelta()
+{
+    char *payloadDeltaStringPtr = getenv("VESPA_CONFIG_PROTOCOL_PAYLOAD_DELTA");
+    if (payloadDeltaStringPtr != NULL) {
+        vespalib::string payloadDelta(payloadDeltaStringPtr);
+        return (payloadDelta == "true" || payloadDelta == "1");
+    }
+    return false;
+}
+
 }
 }
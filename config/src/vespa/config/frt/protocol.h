@@ -18,6 +18,7 @@ namespace config::protocol {
 int readProtocolVersion();
 int readTraceLevel();
 CompressionType readProtocolCompressionType();
+bool readProtocolPayloadDelta();
 
 struct Payload {
     virtual ~Payload() = default;
@@ -62,6 +63,10 @@ extern const vespalib::Memory REQUEST_COMPRESSION_TYPE;
 extern const vespalib::Memory RESPONSE_COMPRESSION_INFO;
 extern const vespalib::Memory RESPONSE_COMPRESSION_INFO_TYPE;
 extern const vespalib::Memory RESPONSE_COMPRESSION_INFO_UNCOMPRESSED_SIZE;
+// Set in requests from clients able to apply a payload delta to the config they have
+extern const vespalib::Memory REQUEST_ACCEPT_PAYLOAD_DELTA;
+// Set in responses where the payload is a JSON merge patch against the config with this xxhash64
+extern const vespalib::Memory RESPONSE_PAYLOAD_DELTA_BASE;
 
 struct DecompressedData {
     DecompressedData(vespalib::alloc::Alloc mem, uint32_t sz)
@@ -29,11 +29,12 @@ SlimeConfigRequest::SlimeConfigRequest(Connection * connection,
                                        const VespaVersion & vespaVersion,
                                        int64_t protocolVersion,
                                        const CompressionType & compressionType,
+                                       bool acceptPayloadDelta,
                                        const vespalib::string & methodName)
     : FRTConfigRequest(connection, key),
       _data()
 {
-    populateSlimeRequest(key, configXxhash64, currentGeneration, hostName, serverTimeout, trace, vespaVersion, protocolVersion, compressionType);
+    populateSlimeRequest(key, configXxhash64, currentGeneration, hostName, serverTimeout, trace, vespaVersion, protocolVersion, compressionType, acceptPayloadDelta);
     _request->SetMethodName(methodName.c_str());
     _parameters.AddString(createJsonFromSlime(_data).c_str());
 }
@@ -56,7 +57,8 @@ SlimeConfigRequest::populateSlimeRequest(const ConfigKey & key,
                                          const Trace & trace,
                                          const VespaVersion & vespaVersion,
                                          int64_t protocolVersion,
-                                         const CompressionType & compressionType)
+                                         const CompressionType & compressionType,
+                                         bool acceptPayloadDelta)
 {
     Cursor & root(_data.setObject());
     root.setLong(REQUEST_VERSION, protocolVersion);
@@ -73,6 +75,10 @@ SlimeConfigRequest::populateSlimeRequest(const ConfigKey & key,
     trace.serialize(root.setObject(REQUEST_TRACE));
     root.setString(REQUEST_COMPRESSION_TYPE, Memory(compressionTypeToString(compressionType)));
     root.setString(REQUEST_VESPA_VERSION, Memory(vespaVersion.toString()));
+    if (acceptPayloadDelta && !configXxhash64.empty()) {
+        // A delta is only useful when we have a config to apply it to
+        root.setBool(REQUEST_ACCEPT_PAYLOAD_DELTA, true);
+    }
 }
 
 vespalib::string
@@ -30,6 +30,7 @@ public:
                        const VespaVersion & vespaVersion,
                        int64_t protocolVersion,
                        const CompressionType & compressionType,
+                       bool acceptPayloadDelta,
                        const vespalib::string & methodName);
     ~SlimeConfigRequest();
     bool verifyState(const ConfigState & state) const override;
@@ -43,7 +44,8 @@ private:
                               const Trace & trace,
                               const VespaVersion & vespaVersion,
                               int64_t protocolVersion,
-                              const CompressionType & compressionType);
+                              const CompressionType & compressionType,
+                              bool acceptPayloadDelta);
     static vespalib::string createJsonFromSlime(const vespalib::Slime & data);
     vespalib::Slime _data;
 };
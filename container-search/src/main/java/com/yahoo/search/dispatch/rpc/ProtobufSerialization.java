@@ -100,6 +100,7 @@ public class ProtobufSerialization {
         }
 
         mergeToSearchRequestFromRanking(query.getRanking(), scratchPad, builder);
+        builder.setColumnarMatchFeatures(true);
 
         return builder.build();
     }
@@ -245,6 +246,8 @@ public class ProtobufSerialization {
         List<String> featureNames = protobuf.getMatchFeatureNamesList();
         var haveMatchFeatures = ! featureNames.isEmpty();
         MatchFeatureData matchFeatures = haveMatchFeatures ? new MatchFeatureData(featureNames) : null;
+        List<SearchProtocol.FeatureColumn> featureColumns = protobuf.getMatchFeatureColumnsList();
+        var haveFeatureColumns = ! featureColumns.isEmpty();
         var haveGrouping = ! protobuf.getGroupingBlob().isEmpty();
         if (haveGrouping) {
             BufferSerializer buf = new BufferSerializer(new GrowableByteBuffer(protobuf.getGroupingBlob().asReadOnlyByteBuffer()));
@@ -259,29 +262,24 @@ public class ProtobufSerialization {
             hit.setQuery(query);
             result.getResult().hits().add(hit);
         }
+        int hitIndex = 0;
         for (var replyHit : protobuf.getHitsList()) {
             LeanHit hit = (replyHit.getSortData().isEmpty())
                     ? new LeanHit(replyHit.getGlobalId().toByteArray(), partId, distKey, replyHit.getRelevance())
                     : new LeanHit(replyHit.getGlobalId().toByteArray(), partId, distKey, replyHit.getRelevance(), replyHit.getSortData().toByteArray());
             if (haveMatchFeatures) {
                 var hitFeatures = matchFeatures.addHit();
-                var featureList = replyHit.getMatchFeaturesList();
-                if (featureList.size() == featureNames.size()) {
-                    int idx = 0;
-                    for (SearchProtocol.Feature value : featureList) {
-                        ByteString tensorBlob = value.getTensor();
-                        if (tensorBlob.isEmpty()) {
-                            hitFeatures.set(idx++, value.getNumber());
-                        } else {
-                            hitFeatures.set(idx++, tensorBlob.toByteArray());
-                        }
-                    }
+                boolean ok = haveFeatureColumns
+                        ? setMatchFeaturesFromColumns(hitFeatures, featureColumns, featureNames.size(), hitIndex)
+                        : setMatchFeaturesFromHit(hitFeatures, replyHit.getMatchFeaturesList(), featureNames.size());
+                if (ok) {
                     hit.addMatchFeatures(hitFeatures);
                 } else {
                     result.getResult().hits().addError(ErrorMessage.createBackendCommunicationError("mismatch in match feature sizes"));
                 }
             }
             result.getLeanHits().add(hit);
+            ++hitIndex;
         }
 
         var slimeTrace = protobuf.getSlimeTrace();
@@ -293,6 +291,38 @@ public class ProtobufSerialization {
         return result;
     }
 
+    private static boolean setMatchFeaturesFromHit(MatchFeatureData.HitValue hitFeatures,
+                                                   List<SearchProtocol.Feature> featureList, int numFeatures) {
+        if (featureList.size() != numFeatures) return false;
+        int idx = 0;
+        for (SearchProtocol.Feature value : featureList) {
+            ByteString tensorBlob = value.getTensor();
+            if (tensorBlob.isEmpty()) {
+                hitFeatures.set(idx++, value.getNumber());
+            } else {
+                hitFeatures.set(idx++, tensorBlob.toByteArray());
+            }
+        }
+        return true;
+    }
+
+    /** Each column holds the values of one match feature for all hits, either as numbers or as tensors */
+    private static boolean setMatchFeaturesFromColumns(MatchFeatureData.HitValue hitFeatures,
+                                                       List<SearchProtocol.FeatureColumn> columns, int numFeatures, int hitIndex) {
+        if (columns.size() != numFeatures) return false;
+        int idx = 0;
+        for (SearchProtocol.FeatureColumn column : columns) {
+            if (hitIndex < column.getNumbersCount()) {
+                hitFeatures.set(idx++, column.getNumbers(hitIndex));
+            } else if (hitIndex < column.getTensorsCount()) {
+                hitFeatures.set(idx++, column.getTensors(hitIndex).toByteArray());
+            } else {
+                return false;
+            }
+        }
+        return true;
+    }
+
     private static Coverage convertToCoverage(SearchProtocol.SearchReply protobuf) {
         var coverage = new Coverage(protobuf.getCoverageDocs(), protobuf.getActiveDocs(), 1);
         coverage.setNodesTried(1).setTargetActive(protobuf.getTargetActiveDocs());
@@ -0,0 +1,102 @@
+// Copyright Vespa.ai. Licensed under the terms of the Apache 2.0 license. See LICENSE in the project root.
+
+#include <vespa/document/datatype/documenttype.h>
+#include <vespa/document/fieldvalue/document_field_layout.h>
+#include <vespa/document/fieldvalue/fieldvalues.h>
+#include <vespa/document/repo/configbuilder.h>
+#include <vespa/document/repo/documenttyperepo.h>
+#include <vespa/vespalib/gtest/gtest.h>
+#include <vespa/vespalib/objects/nbostream.h>
+
+using document::config_builder::Array;
+using document::config_builder::Struct;
+using vespalib::nbostream;
+
+namespace document {
+
+namespace {
+
+config_builder::DocumenttypesConfigBuilderHelper
+createBuilder() {
+    config_builder::DocumenttypesConfigBuilderHelper builder;
+    builder.document(42, "test",
+                     Struct("test.header")
+                             .addField("int", DataType::T_INT)
+                             .addField("long", DataType::T_LONG)
+                             .addField("content", DataType::T_STRING)
+                             .addField("tags", Array(DataType::T_STRING)),
+                     Struct("test.body"));
+    builder.document(43, "other", Struct("other.header").addField("int", DataType::T_INT), Struct("other.body"));
+    return builder;
+}
+
+}
+
+class DocumentFieldLayoutTest : public ::testing::Test {
+protected:
+    DocumentTypeRepo repo;
+    const DocumentType &type;
+    DocumentFieldLayoutTest();
+    ~DocumentFieldLayoutTest() override;
+
+    std::unique_ptr<Document> make_doc(const vespalib::string &id, int32_t int_value, const vespalib::string &content) {
+        Document doc(repo, type, DocumentId("id:ns:test::" + id));
+        doc.setValue("int", IntFieldValue(int_value));
+        if (!content.empty()) {
+            doc.setValue("content", StringFieldValue(content));
+        }
+        // Round trip to get a document backed by its serialized form, as when received over the wire
+        nbostream stream = doc.serialize();
+        return std::make_unique<Document>(repo, stream);
+    }
+};
+
+DocumentFieldLayoutTest::DocumentFieldLayoutTest()
+    : repo(createBuilder().config()),
+      type(*repo.getDocumentType(42))
+{}
+
+DocumentFieldLayoutTest::~DocumentFieldLayoutTest() = default;
+
+TEST_F(DocumentFieldLayoutTest, only_known_primitive_fields_are_part_of_layout)
+{
+    DocumentFieldLayout layout(type, {"content", "tags", "int", "unknown", "int"});
+    EXPECT_EQ(2u, layout.num_slots());
+    EXPECT_EQ(0u, layout.slot("content"));
+    EXPECT_EQ(1u, layout.slot("int"));
+    EXPECT_EQ(DocumentFieldLayout::npos, layout.slot("tags"));
+    EXPECT_EQ(DocumentFieldLayout::npos, layout.slot("unknown"));
+    EXPECT_EQ("int", layout.getField(1).getName());
+}
+
+TEST_F(DocumentFieldLayoutTest, values_are_decoded_into_reused_field_values)
+{
+    DocumentFieldLayout layout(type, {"int", "long", "content"});
+    auto values = layout.make_values();
+    auto doc1 = make_doc("1", 17, "foo");
+    ASSERT_TRUE(layout.decode(*doc1, values));
+    ASSERT_TRUE(values.get(0) != nullptr);
+    EXPECT_EQ(17, values.get(0)->getAsInt());
+    EXPECT_TRUE(values.get(1) == nullptr);
+    ASSERT_TRUE(values.get(2) != nullptr);
+    EXPECT_EQ("foo", values.get(2)->getAsString());
+    const FieldValue *int_value = values.get(0);
+
+    auto doc2 = make_doc("2", 42, "");
+    ASSERT_TRUE(layout.decode(*doc2, values));
+    EXPECT_EQ(int_value, values.get(0));
+    EXPECT_EQ(42, values.get(0)->getAsInt());
+    EXPECT_TRUE(values.get(2) == nullptr);
+    EXPECT_EQ(*doc2->getValue("int"), *values.get(0));
+}
+
+TEST_F(DocumentFieldLayoutTest, documents_of_other_type_are_not_decoded)
+{
+    DocumentFieldLayout layout(type, {"int"});
+    auto values = layout.make_values();
+    Document doc(repo, *repo.getDocumentType(43), DocumentId("id:ns:other::1"));
+    doc.setValue("int", IntFieldValue(3));
+    EXPECT_FALSE(layout.decode(doc, values));
+}
+
+}
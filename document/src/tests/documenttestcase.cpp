@@ -250,6 +250,62 @@ TEST(DocumentTest, testVariables)
 
 }
 
+class ReadOnlyIteratorHandler : public VariableIteratorHandler {
+public:
+    bool readOnly() const override { return true; }
+};
+
+TEST(DocumentTest, testReadOnlyMapLookupDecodesOnlyMatchingEntry)
+{
+    Field primitive1("primitive1", 1, *DataType::INT);
+    Field text("text", 2, *DataType::STRING);
+    StructDataType struct1("struct1");
+    struct1.addField(primitive1);
+    struct1.addField(text);
+    MapDataType smap(*DataType::STRING, struct1);
+    MapDataType imap(*DataType::INT, *DataType::DOUBLE);
+    Field smapF("smap", 11, smap);
+    Field imapF("imap", 12, imap);
+    DocumentType type("test");
+    type.addField(smapF);
+    type.addField(imapF);
+
+    MapFieldValue smapV(smap);
+    MapFieldValue imapV(imap);
+    for (int i = 1; i < 4; i++) {
+        StructFieldValue value(struct1);
+        value.setValue(primitive1, IntFieldValue(i));
+        value.setValue(text, StringFieldValue(vespalib::make_string("text%d", i)));
+        smapV.put(StringFieldValue(vespalib::make_string("key%d", i)), value);
+        imapV.put(IntFieldValue(i), DoubleFieldValue(i * 1.5));
+    }
+    auto doc = Document::make_without_repo(type, DocumentId("id:ns:test::1"));
+    doc->setValue(smapF, smapV);
+    doc->setValue(imapF, imapV);
+
+    auto iterate = [&](const vespalib::string & expr, VariableIteratorHandler & handler) {
+        FieldPath path;
+        type.buildFieldPath(path, expr);
+        doc->iterateNested(path.getFullRange(), handler);
+        return handler.retVal;
+    };
+    for (const char * expr : {"smap{key2}.text", "smap{key3}.primitive1", "smap{key4}.text", "smap{key1}", "imap{3}", "imap{7}"}) {
+        VariableIteratorHandler full;
+        ReadOnlyIteratorHandler partial;
+        EXPECT_EQ(iterate(expr, full), iterate(expr, partial)) << expr;
+    }
+    ReadOnlyIteratorHandler handler;
+    EXPECT_EQ(" - text2\n", iterate("smap{key2}.text", handler));
+
+    nbostream stream = doc->getValue(smapF)->serialize();
+    MapFieldValue partial(smap);
+    DocumentTypeRepo repo(type);
+    VespaDocumentDeserializer deserializer(repo, stream, 8);
+    deserializer.readMapEntry(partial, StringFieldValue("key3"));
+    ASSERT_EQ(1u, partial.size());
+    EXPECT_EQ(IntFieldValue(3), *static_cast<const StructFieldValue &>(*partial.begin()->second).getValue("primitive1"));
+}
+
 class ModifyIteratorHandler : public IteratorHandler {
 public:
     ModificationStatus doModify(FieldValue& fv) override {
@@ -1088,4 +1144,36 @@ TEST(DocumentTest, testDeserializeMultiple)
     EXPECT_EQ(correct, sv3);
 }
 
+TEST(DocumentTest, retained_serialized_form_is_reused_until_document_is_modified)
+{
+    TestDocRepo testDocRepo;
+    const DocumentTypeRepo& repo(testDocRepo.getTypeRepo());
+    Document orig(repo, *repo.getDocumentType("testdoctype1"), DocumentId("id:ns:testdoctype1::1"));
+    orig.setValue("headerval", IntFieldValue(42));
+    orig.setValue("hstringval", StringFieldValue("foo"));
+    nbostream serialized = orig.serialize();
+    vespalib::string expected(serialized.peek(), serialized.size());
+
+    auto doc = Document::make_retaining_serialized_form(repo, serialized);
+    EXPECT_TRUE(serialized.empty());
+    EXPECT_EQ(expected.size(), doc->retained_serialized_form().size());
+    nbostream reserialized = doc->serialize();
+    EXPECT_EQ(expected, vespalib::string(reserialized.peek(), reserialized.size()));
+
+    Document copy(*doc);
+    EXPECT_EQ(expected.size(), copy.retained_serialized_form().size());
+
+    doc->setValue("headerval", IntFieldValue(43));
+    reserialized = doc->serialize();
+    EXPECT_NE(expected, vespalib::string(reserialized.peek(), reserialized.size()));
+    Document roundtrip(repo, reserialized);
+    EXPECT_EQ(*doc, roundtrip);
+
+    copy.getId() = DocumentId("id:ns:testdoctype1::2");
+    EXPECT_EQ(0u, copy.retained_serialized_form().size());
+    reserialized = copy.serialize();
+    Document copy_roundtrip(repo, reserialized);
+    EXPECT_EQ(copy.getId(), copy_roundtrip.getId());
+}
+
 }
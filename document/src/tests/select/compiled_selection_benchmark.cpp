@@ -0,0 +1,88 @@
+// Copyright Vespa.ai. Licensed under the terms of the Apache 2.0 license. See LICENSE in the project root.
+#include <vespa/document/base/documentid.h>
+#include <vespa/document/config/documenttypes_config_fwd.h>
+#include <vespa/document/datatype/documenttype.h>
+#include <vespa/document/fieldvalue/document.h>
+#include <vespa/document/fieldvalue/floatfieldvalue.h>
+#include <vespa/document/fieldvalue/intfieldvalue.h>
+#include <vespa/document/fieldvalue/stringfieldvalue.h>
+#include <vespa/document/repo/configbuilder.h>
+#include <vespa/document/repo/document_type_repo_factory.h>
+#include <vespa/document/repo/documenttyperepo.h>
+#include <vespa/document/select/compiled_selection.h>
+#include <vespa/document/select/parser.h>
+#include <vespa/vespalib/util/benchmark_timer.h>
+#include <vespa/vespalib/util/stringfmt.h>
+#include <cinttypes>
+
+using namespace document;
+using document::select::CompiledSelection;
+using document::select::Result;
+
+namespace {
+
+std::shared_ptr<DocumenttypesConfig> make_document_types() {
+    using Struct = config_builder::Struct;
+    config_builder::DocumenttypesConfigBuilderHelper builder;
+    builder.document(42, "music",
+                     Struct("music.header")
+                             .addField("year", DataType::T_INT)
+                             .addField("rating", DataType::T_FLOAT)
+                             .addField("title", DataType::T_STRING),
+                     Struct("music.body"));
+    return std::make_shared<DocumenttypesConfig>(builder.config());
+}
+
+}
+
+int main(int argc, char *argv[])
+{
+    vespalib::string expression("music and music.year >= 1990 and (music.rating > 3.5 or music.title == \"title7\")");
+    uint64_t num_docs = 1000;
+    double budget = 2.0;
+    if (argc > 1) {
+        expression = argv[1];
+    }
+    if (argc > 2) {
+        num_docs = strtoul(argv[2], nullptr, 0);
+    }
+    auto document_types = make_document_types();
+    auto repo = DocumentTypeRepoFactory::make(*document_types);
+    const DocumentType& type = *repo->getDocumentType("music");
+    std::vector<std::unique_ptr<Document>> docs;
+    for (uint64_t i = 0; i < num_docs; ++i) {
+        auto doc = std::make_unique<Document>(*repo, type, DocumentId(vespalib::make_string("id:ns:music::%" PRIu64, i)));
+        doc->setValue("year", IntFieldValue(1970 + (i % 50)));
+        doc->setValue("rating", FloatFieldValue((i % 10) * 0.5));
+        doc->setValue("title", StringFieldValue(vespalib::make_string("title%" PRIu64, i % 10)));
+        docs.push_back(std::move(doc));
+    }
+    BucketIdFactory bucket_id_factory;
+    select::Parser parser(*repo, bucket_id_factory);
+    auto node = parser.parse(expression);
+    auto compiled = CompiledSelection::compile(*node, *repo);
+    printf("Evaluating '%s' against %" PRIu64 " documents\n", expression.c_str(), num_docs);
+    printf("Compiled into %zu instructions, %zu interpreted sub-expressions\n",
+           compiled->num_instructions(), compiled->num_interpreted());
+
+    uint64_t interpreted_matches = 0;
+    uint64_t compiled_matches = 0;
+    double interpreted_time = vespalib::BenchmarkTimer::benchmark([&]() {
+        interpreted_matches = 0;
+        for (const auto& doc : docs) {
+            interpreted_matches += (node->contains(*doc).combineResults() == Result::True) ? 1 : 0;
+        }
+    }, budget);
+    double compiled_time = vespalib::BenchmarkTimer::benchmark([&]() {
+        compiled_matches = 0;
+        for (const auto& doc : docs) {
+            compiled_matches += (compiled->contains(*doc) == Result::True) ? 1 : 0;
+        }
+    }, budget);
+    printf("tree interpreter: %" PRIu64 " matches, %.1f ns/doc\n",
+           interpreted_matches, interpreted_time * 1e9 / num_docs);
+    printf("compiled:         %" PRIu64 " matches, %.1f ns/doc\n",
+           compiled_matches, compiled_time * 1e9 / num_docs);
+    printf("speedup: %.2fx\n", interpreted_time / compiled_time);
+    return (interpreted_matches == compiled_matches) ? 0 : 1;
+}
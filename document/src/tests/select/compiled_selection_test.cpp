@@ -0,0 +1,185 @@
+// Copyright Vespa.ai. Licensed under the terms of the Apache 2.0 license. See LICENSE in the project root.
+
+#include <vespa/vespalib/gtest/gtest.h>
+#include <vespa/document/base/documentid.h>
+#include <vespa/document/config/documenttypes_config_fwd.h>
+#include <vespa/document/datatype/documenttype.h>
+#include <vespa/document/fieldvalue/arrayfieldvalue.h>
+#include <vespa/document/fieldvalue/boolfieldvalue.h>
+#include <vespa/document/fieldvalue/document.h>
+#include <vespa/document/fieldvalue/floatfieldvalue.h>
+#include <vespa/document/fieldvalue/intfieldvalue.h>
+#include <vespa/document/fieldvalue/stringfieldvalue.h>
+#include <vespa/document/repo/configbuilder.h>
+#include <vespa/document/repo/documenttyperepo.h>
+#include <vespa/document/repo/document_type_repo_factory.h>
+#include <vespa/document/select/compiled_selection.h>
+#include <vespa/document/select/parser.h>
+
+using document::ArrayFieldValue;
+using document::BoolFieldValue;
+using document::BucketIdFactory;
+using document::DataType;
+using document::Document;
+using document::DocumentId;
+using document::DocumentType;
+using document::DocumentTypeRepo;
+using document::DocumentTypeRepoFactory;
+using document::FloatFieldValue;
+using document::IntFieldValue;
+using document::StringFieldValue;
+using document::select::CompiledSelection;
+using document::select::Parser;
+using document::select::Result;
+
+namespace {
+
+std::shared_ptr<DocumenttypesConfig> make_document_types() {
+    using Struct = document::config_builder::Struct;
+    using Array = document::config_builder::Array;
+    document::config_builder::DocumenttypesConfigBuilderHelper builder;
+    builder.document(42, "music",
+                     Struct("music.header")
+                             .addField("year", DataType::T_INT)
+                             .addField("rating", DataType::T_FLOAT)
+                             .addField("title", DataType::T_STRING)
+                             .addField("live", DataType::T_BOOL)
+                             .addField("tags", Array(DataType::T_STRING)),
+                     Struct("music.body"));
+    builder.document(43, "book",
+                     Struct("book.header")
+                             .addField("year", DataType::T_INT),
+                     Struct("book.body"));
+    return std::make_shared<DocumenttypesConfig>(builder.config());
+}
+
+}
+
+class CompiledSelectionTest : public ::testing::Test
+{
+protected:
+    std::shared_ptr<DocumenttypesConfig>    _document_types;
+    std::shared_ptr<const DocumentTypeRepo> _repo;
+    BucketIdFactory                         _bucket_id_factory;
+    Parser                                  _parser;
+    std::vector<std::unique_ptr<Document>>  _docs;
+
+    CompiledSelectionTest();
+    ~CompiledSelectionTest() override;
+
+    Document& add_music(const vespalib::string& id);
+    std::unique_ptr<CompiledSelection> compile(const vespalib::string& expression);
+    void check_same_as_interpreter(const vespalib::string& expression);
+};
+
+CompiledSelectionTest::CompiledSelectionTest()
+    : ::testing::Test(),
+      _document_types(make_document_types()),
+      _repo(DocumentTypeRepoFactory::make(*_document_types)),
+      _bucket_id_factory(),
+      _parser(*_repo, _bucket_id_factory),
+      _docs()
+{
+    add_music("id:ns:music::empty");
+    auto& old_song = add_music("id:ns:music::old");
+    old_song.setValue("year", IntFieldValue(1969));
+    old_song.setValue("rating", FloatFieldValue(4.5));
+    old_song.setValue("title", StringFieldValue("abbey road"));
+    old_song.setValue("live", BoolFieldValue(false));
+    auto& new_song = add_music("id:ns:music::new");
+    new_song.setValue("year", IntFieldValue(2020));
+    new_song.setValue("rating", FloatFieldValue(3.0));
+    new_song.setValue("title", StringFieldValue("zebra"));
+    new_song.setValue("live", BoolFieldValue(true));
+    ArrayFieldValue tags(new_song.getField("tags").getDataType());
+    tags.add(StringFieldValue("rock"));
+    tags.add(StringFieldValue("pop"));
+    new_song.setValue("tags", tags);
+    auto book = std::make_unique<Document>(*_repo, *_repo->getDocumentType("book"), DocumentId("id:ns:book::1"));
+    book->setValue("year", IntFieldValue(2020));
+    _docs.push_back(std::move(book));
+}
+
+CompiledSelectionTest::~CompiledSelectionTest() = default;
+
+Document&
+CompiledSelectionTest::add_music(const vespalib::string& id)
+{
+    _docs.push_back(std::make_unique<Document>(*_repo, *_repo->getDocumentType("music"), DocumentId(id)));
+    return *_docs.back();
+}
+
+std::unique_ptr<CompiledSelection>
+CompiledSelectionTest::compile(const vespalib::string& expression)
+{
+    auto node = _parser.parse(expression);
+    return CompiledSelection::compile(*node, *_repo);
+}
+
+void
+CompiledSelectionTest::check_same_as_interpreter(const vespalib::string& expression)
+{
+    SCOPED_TRACE(expression);
+    auto node = _parser.parse(expression);
+    auto compiled = CompiledSelection::compile(*node, *_repo);
+    for (const auto& doc : _docs) {
+        SCOPED_TRACE(doc->getId().toString());
+        EXPECT_EQ(node->contains(*doc).combineResults(), compiled->contains(*doc));
+    }
+}
+
+TEST_F(CompiledSelectionTest, results_match_tree_interpreter)
+{
+    for (const char* op : {"<", "<=", ">", ">=", "==", "!="}) {
+        vespalib::string o(op);
+        check_same_as_interpreter("music.year " + o + " 2000");
+        check_same_as_interpreter("2000 " + o + " music.year");
+        check_same_as_interpreter("music.year " + o + " 1969.5");
+        check_same_as_interpreter("music.rating " + o + " 4");
+        check_same_as_interpreter("4.5 " + o + " music.rating");
+        check_same_as_interpreter("music.title " + o + " \"abbey road\"");
+        check_same_as_interpreter("\"m\" " + o + " music.title");
+        check_same_as_interpreter("music.live " + o + " true");
+        check_same_as_interpreter("music.title " + o + " 3");
+    }
+    check_same_as_interpreter("music");
+    check_same_as_interpreter("book");
+    check_same_as_interpreter("true");
+    check_same_as_interpreter("not false");
+    check_same_as_interpreter("music.year == null");
+    check_same_as_interpreter("music and music.year > 2000");
+    check_same_as_interpreter("book.year > 2000 or music.rating < 4");
+    check_same_as_interpreter("not (music.year < 2000 and music.rating > 1)");
+    check_same_as_interpreter("music.year < 2000 or music.rating > 10 and music.title = \"zebra\"");
+    check_same_as_interpreter("music.tags == \"rock\"");
+    check_same_as_interpreter("not music.tags == \"rock\"");
+    check_same_as_interpreter("music.tags == \"jazz\" or music.year > 2000");
+    check_same_as_interpreter("id.namespace == \"ns\" and music.year >= 1969");
+    check_same_as_interpreter("music.title.lowercase() == \"zebra\"");
+    check_same_as_interpreter("music.tags[$x] == \"rock\" and music.tags[$x] != \"pop\"");
+}
+
+TEST_F(CompiledSelectionTest, field_comparisons_are_not_interpreted)
+{
+    auto compiled = compile("music and (music.year > 2000 or not (music.title == \"zebra\")) and music.rating <= 4.5");
+    EXPECT_EQ(0u, compiled->num_interpreted());
+    EXPECT_EQ(11u, compiled->num_instructions());
+}
+
+TEST_F(CompiledSelectionTest, unsupported_sub_expressions_are_interpreted)
+{
+    auto compiled = compile("music.year > 2000 and id.namespace == \"ns\" and music.tags == \"rock\"");
+    EXPECT_EQ(2u, compiled->num_interpreted());
+    EXPECT_EQ(Result::False, compiled->contains(*_docs[1]));
+    EXPECT_EQ(Result::True, compiled->contains(*_docs[2]));
+}
+
+TEST_F(CompiledSelectionTest, selection_with_variables_is_interpreted_as_a_whole)
+{
+    auto compiled = compile("music.tags[$x] == \"rock\" and music.year > 2000");
+    EXPECT_EQ(0u, compiled->num_instructions());
+    EXPECT_EQ(1u, compiled->num_interpreted());
+    EXPECT_EQ(Result::True, compiled->contains(*_docs[2]));
+}
+
+GTEST_MAIN_RUN_ALL_TESTS()
@@ -8,6 +8,7 @@
 #include <vespa/document/util/bytebuffer.h>
 #include <vespa/vespalib/gtest/gtest.h>
 #include <vespa/vespalib/objects/nbostream.h>
+#include <vespa/vespalib/util/exceptions.h>
 #include <gmock/gmock.h>
 
 using vespalib::nbostream;
@@ -189,5 +190,35 @@ TEST_F(StructFieldValueTest, testStruct)
     }
 }
 
+TEST_F(StructFieldValueTest, string_value_ref_is_read_from_serialized_field)
+{
+    const DocumentType *doc_type = doc_repo.getDocumentType(42);
+    ASSERT_TRUE(doc_type != nullptr);
+    FixedTypeRepo repo(doc_repo, *doc_type);
+    const DataType &type = *repo.getDataType("test.header");
+    StructFieldValue value(type);
+    const Field &intF = value.getField("int");
+    const Field &strF = value.getField("content");
+    vespalib::stringref ref;
+
+    EXPECT_FALSE(value.getStringValueRef(strF, ref));
+    value.setValue(intF, IntFieldValue(1));
+    value.setValue(strF, StringFieldValue("foo"));
+    ASSERT_TRUE(value.getStringValueRef(strF, ref));
+    EXPECT_EQ("foo", vespalib::string(ref));
+
+    nbostream buffer(value.serialize());
+    StructFieldValue value2(type);
+    deserialize(buffer, value2, repo);
+    ASSERT_TRUE(value2.getStringValueRef(strF, ref));
+    EXPECT_EQ("foo", vespalib::string(ref));
+
+    value2.setValue(strF, StringFieldValue(""));
+    ASSERT_TRUE(value2.getStringValueRef(strF, ref));
+    EXPECT_TRUE(ref.empty());
+
+    EXPECT_THROW(value2.getStringValueRef(intF, ref), vespalib::IllegalArgumentException);
+}
+
 } // document
 
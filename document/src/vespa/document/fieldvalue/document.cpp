@@ -9,6 +9,7 @@
 #include <vespa/vespalib/objects/nbostream.h>
 #include <vespa/document/util/serializableexceptions.h>
 #include <vespa/document/fieldset/fieldsets.h>
+#include <vespa/document/util/bytebuffer.h>
 #include <vespa/vespalib/data/databuffer.h>
 #include <vespa/vespalib/util/xmlstream.h>
 #include <vespa/vespalib/stllike/hash_map.hpp>
@@ -40,6 +41,15 @@ void throwTypeMismatch(vespalib::stringref type, vespalib::stringref docidType)
 
 }  // namespace
 
+struct Document::SerializedForm {
+    ByteBuffer buffer;
+    DocumentId id;
+    SerializedForm(ByteBuffer buffer_in, DocumentId id_in) noexcept
+        : buffer(std::move(buffer_in)),
+          id(std::move(id_in))
+    {}
+};
+
 const DataType &
 Document::verifyDocumentType(const DataType *type) {
     if (!type) {
@@ -62,6 +72,7 @@ void
 Document::setType(const DataType & type) {
     StructuredFieldValue::setType(type);
     _fields.setType(getType().getFieldsType());
+    _serialized.reset();
 }
 
 Document::Document()
@@ -69,6 +80,7 @@ Document::Document()
       _id(),
       _fields(getType().getFieldsType()),
       _backingBuffer(),
+      _serialized(),
       _lastModified(0)
 {
     _fields.setDocumentType(getType());
@@ -79,6 +91,7 @@ Document::Document(const Document& rhs)
       _id(rhs._id),
       _fields(rhs._fields),
       _backingBuffer(),
+      _serialized(rhs._serialized),
       _lastModified(rhs._lastModified)
 {}
 
@@ -87,6 +100,7 @@ Document::Document(const DataType &type, DocumentId documentId)
       _id(std::move(documentId)),
       _fields(getType().getFieldsType()),
       _backingBuffer(),
+      _serialized(),
       _lastModified(0)
 {
     _fields.setDocumentType(getType());
@@ -107,6 +121,7 @@ Document::Document(const DocumentTypeRepo& repo, const DataType &type, DocumentI
       _id(std::move(documentId)),
       _fields(repo, getType().getFieldsType()),
       _backingBuffer(),
+      _serialized(),
       _lastModified(0)
 {
     _fields.setDocumentType(getType());
@@ -125,6 +140,7 @@ Document::Document(const DocumentTypeRepo& repo, vespalib::nbostream & is)
       _id(),
       _fields(static_cast<const DocumentType &>(getType()).getFieldsType()),
       _backingBuffer(),
+      _serialized(),
       _lastModified(0)
 {
     deserialize(repo, is);
@@ -135,6 +151,7 @@ Document::Document(const DocumentTypeRepo& repo, vespalib::DataBuffer && backing
       _id(),
       _fields(static_cast<const DocumentType &>(getType()).getFieldsType()),
       _backingBuffer(),
+      _serialized(),
       _lastModified(0)
 {
     if (backingBuffer.referencesExternalData()) {
@@ -150,12 +167,33 @@ Document::Document(const DocumentTypeRepo& repo, vespalib::DataBuffer && backing
 Document::Document(Document &&) noexcept = default;
 Document::~Document() noexcept = default;
 
+std::shared_ptr<Document>
+Document::make_retaining_serialized_form(const DocumentTypeRepo& repo, nbostream & stream)
+{
+    const char *start = stream.peek();
+    size_t old_size = stream.size();
+    auto doc = std::make_shared<Document>(repo, stream);
+    size_t used = old_size - stream.size();
+    doc->_serialized = std::make_shared<const SerializedForm>(ByteBuffer::copyBuffer(start, used), doc->getId());
+    return doc;
+}
+
+vespalib::ConstBufferRef
+Document::retained_serialized_form() const noexcept
+{
+    if (!_serialized || !(_serialized->id == _id)) {
+        return {};
+    }
+    return {_serialized->buffer.getBuffer(), _serialized->buffer.getLength()};
+}
+
 Document &
 Document::operator =(Document &&rhs) noexcept {
     assert( ! _cache && ! rhs._cache);
     _id = std::move(rhs._id);
     _fields = std::move(rhs._fields);
     _backingBuffer = std::move(rhs._backingBuffer);
+    _serialized = std::move(rhs._serialized);
     _lastModified = rhs._lastModified;
     StructuredFieldValue::operator=(std::move(rhs));
     return *this;
@@ -170,6 +208,7 @@ Document::operator =(const Document &rhs) {
     _lastModified = rhs._lastModified;
     StructuredFieldValue::operator=(rhs);
     _backingBuffer.reset();
+    _serialized = rhs._serialized;
     return *this;
 }
 
@@ -263,6 +302,7 @@ void Document::serializeHeader(nbostream& stream) const {
 }
 
 void Document::deserialize(const DocumentTypeRepo& repo, vespalib::nbostream & os) {
+    _serialized.reset();
     VespaDocumentDeserializer deserializer(repo, os, 0);
     try {
         deserializer.read(*this);
@@ -277,11 +317,13 @@ void Document::deserialize(const DocumentTypeRepo& repo, vespalib::nbostream & h
 }
 
 void Document::deserializeHeader(const DocumentTypeRepo& repo, vespalib::nbostream & stream) {
+    _serialized.reset();
     VespaDocumentDeserializer deserializer(repo, stream, 0);
     deserializer.read(*this);
 }
 
 void Document::deserializeBody(const DocumentTypeRepo& repo, vespalib::nbostream & stream) {
+    _serialized.reset();
     VespaDocumentDeserializer deserializer(repo, stream, getFields().getVersion());
     deserializer.readStructNoReset(getFields());
 }
@@ -18,6 +18,7 @@
 #include "structfieldvalue.h"
 #include <vespa/document/base/documentid.h>
 #include <vespa/document/base/field.h>
+#include <vespa/vespalib/util/buffer.h>
 
 namespace vespalib { class DataBuffer; }
 namespace document {
@@ -27,10 +28,14 @@ class TransactionGuard;
 class Document final : public StructuredFieldValue
 {
 private:
+    struct SerializedForm;
+
     DocumentId _id;
     StructFieldValue _fields;
     std::unique_ptr<StructuredCache> _cache;
     std::unique_ptr<vespalib::DataBuffer> _backingBuffer;
+    // Serialized form kept by make_retaining_serialized_form()
+    std::shared_ptr<const SerializedForm> _serialized;
 
     // To avoid having to return another container object out of docblocks
     // the meta data has been added to document. This will not be serialized
@@ -61,6 +66,22 @@ public:
     Document(const DocumentTypeRepo& repo, vespalib::DataBuffer && buffer);
     ~Document() noexcept override;
 
+    /**
+     * Deserializes a document and keeps a copy of its serialized form.
+     * As long as the document is not modified, serializing it again
+     * writes the kept bytes instead of reserializing all fields. Meant
+     * for the feed path, where a received document is serialized again
+     * for the transaction log and the document store.
+     */
+    static std::shared_ptr<Document> make_retaining_serialized_form(const DocumentTypeRepo& repo, vespalib::nbostream& stream);
+
+    /**
+     * Returns the kept serialized form if the document id is unchanged,
+     * otherwise an empty buffer. The serializer must also check that the
+     * fields are unchanged before using it.
+     */
+    vespalib::ConstBufferRef retained_serialized_form() const noexcept;
+
     void setRepo(const DocumentTypeRepo & repo);
     const DocumentTypeRepo * getRepo() const { return _fields.getRepo(); }
 
@@ -123,6 +144,9 @@ private:
     void removeFieldValue(const Field& field) override { _fields.remove(field); }
     FieldValue::UP getFieldValue(const Field& field) const override { return _fields.getValue(field); }
     bool getFieldValue(const Field& field, FieldValue& value) const override { return _fields.getValue(field, value); }
+    FieldValue::UP getMapEntryFieldValue(const Field& field, const FieldValue& key) const override {
+        return _fields.getMapEntryFieldValue(field, key);
+    }
 
     StructuredIterator::UP getIterator(const Field* first) const override;
     StructuredCache * getCache() const override { return _cache.get(); }
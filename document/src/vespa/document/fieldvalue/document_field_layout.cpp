@@ -0,0 +1,68 @@
+// Copyright Vespa.ai. Licensed under the terms of the Apache 2.0 license. See LICENSE in the project root.
+
+#include "document_field_layout.h"
+#include "document.h"
+#include <vespa/document/datatype/documenttype.h>
+
+namespace document {
+
+DocumentFieldLayout::Values::Values() = default;
+DocumentFieldLayout::Values::Values(Values &&) noexcept = default;
+DocumentFieldLayout::Values & DocumentFieldLayout::Values::operator=(Values &&) noexcept = default;
+DocumentFieldLayout::Values::~Values() = default;
+
+DocumentFieldLayout::DocumentFieldLayout(const DocumentType &type, const std::vector<vespalib::string> &field_names)
+    : _type(&type),
+      _fields()
+{
+    _fields.reserve(field_names.size());
+    for (const auto &name : field_names) {
+        if (!type.hasField(name) || (slot(name) != npos)) {
+            continue;
+        }
+        const Field &field = type.getField(name);
+        if (field.getDataType().isPrimitive()) {
+            _fields.push_back(&field);
+        }
+    }
+}
+
+DocumentFieldLayout::~DocumentFieldLayout() = default;
+
+uint32_t
+DocumentFieldLayout::slot(vespalib::stringref field_name) const noexcept
+{
+    for (uint32_t i = 0; i < _fields.size(); ++i) {
+        if (_fields[i]->getName() == field_name) {
+            return i;
+        }
+    }
+    return npos;
+}
+
+DocumentFieldLayout::Values
+DocumentFieldLayout::make_values() const
+{
+    Values values;
+    values._values.reserve(_fields.size());
+    for (const Field *field : _fields) {
+        values._values.push_back(field->getDataType().createFieldValue());
+    }
+    values._decoded.resize(_fields.size(), nullptr);
+    return values;
+}
+
+bool
+DocumentFieldLayout::decode(const Document &doc, Values &values) const
+{
+    if (&doc.getType() != _type) {
+        return false;
+    }
+    for (size_t i = 0; i < _fields.size(); ++i) {
+        FieldValue &value = *values._values[i];
+        values._decoded[i] = doc.getValue(*_fields[i], value) ? &value : nullptr;
+    }
+    return true;
+}
+
+}
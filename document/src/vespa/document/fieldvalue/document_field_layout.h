@@ -0,0 +1,73 @@
+// Copyright Vespa.ai. Licensed under the terms of the Apache 2.0 license. See LICENSE in the project root.
+#pragma once
+
+#include <vespa/vespalib/stllike/string.h>
+#include <memory>
+#include <vector>
+
+namespace document {
+
+class Document;
+class DocumentType;
+class Field;
+class FieldValue;
+
+/**
+ * Flat layout of a set of primitive top level fields of a document type.
+ *
+ * Fields are resolved against the document type once, when the layout is
+ * built. Decoding a document reads the fields in the layout straight from
+ * their serialized form into field values owned by a Values instance, which
+ * are reused for every document decoded with it. Unlike Document::getValue()
+ * no field value is allocated per field and document, strings refer to the
+ * serialized document instead of being copied, and fields outside the
+ * layout are never deserialized.
+ *
+ * Fields that are unknown or not primitive are not part of the layout. The
+ * layout is immutable and may be shared between threads, while a Values
+ * instance may only be used by one thread at a time.
+ */
+class DocumentFieldLayout {
+public:
+    static constexpr uint32_t npos = static_cast<uint32_t>(-1);
+
+    class Values {
+        std::vector<std::unique_ptr<FieldValue>> _values;
+        std::vector<const FieldValue *>          _decoded;
+        friend class DocumentFieldLayout;
+    public:
+        Values();
+        Values(Values &&) noexcept;
+        Values & operator=(Values &&) noexcept;
+        ~Values();
+        /**
+         * Returns the value of the given slot in the last decoded document,
+         * or nullptr if the document has no value for it. The value is only
+         * valid as long as the document is alive and not modified.
+         */
+        const FieldValue *get(uint32_t slot) const noexcept { return _decoded[slot]; }
+    };
+
+    DocumentFieldLayout(const DocumentType &type, const std::vector<vespalib::string> &field_names);
+    ~DocumentFieldLayout();
+
+    const DocumentType &getDocumentType() const noexcept { return *_type; }
+    size_t num_slots() const noexcept { return _fields.size(); }
+    const Field &getField(uint32_t slot) const noexcept { return *_fields[slot]; }
+    // Returns the slot of the given field, or npos if it is not part of the layout
+    uint32_t slot(vespalib::stringref field_name) const noexcept;
+
+    Values make_values() const;
+    /**
+     * Decode the fields in the layout from the given document into values.
+     * Returns false, leaving values untouched, if the document is not of the
+     * type this layout was built for.
+     */
+    bool decode(const Document &doc, Values &values) const;
+
+private:
+    const DocumentType         *_type;
+    std::vector<const Field *>  _fields;
+};
+
+}
@@ -80,6 +80,11 @@ public:
     fieldvalue::VariableMap && stealVariables() { return std::move(_variables); }
     void setVariables(fieldvalue::VariableMap vars) { _variables = std::move(vars); }
     virtual bool createMissingPath() const { return false; }
+    /**
+     * Return true if this handler never modifies the values it is given.
+     * This lets map lookups in a field path decode only the entry looked up.
+     */
+    virtual bool readOnly() const { return false; }
 private:
     virtual bool onComplex(const Content &fv) {
         (void) fv;
@@ -3,6 +3,7 @@
 #include "structfieldvalue.h"
 #include "fieldvaluewriter.h"
 #include "document.h"
+#include "mapfieldvalue.h"
 #include <vespa/document/repo/fixedtyperepo.h>
 #include <vespa/document/repo/documenttyperepo.h>
 #include <vespa/document/serialization/vespadocumentdeserializer.h>
@@ -11,6 +12,7 @@
 #include <vespa/document/util/serializableexceptions.h>
 #include <vespa/document/base/exceptions.h>
 #include <vespa/document/util/bytebuffer.h>
+#include <vespa/vespalib/util/exceptions.h>
 #include <vespa/vespalib/util/xmlstream.h>
 #include <algorithm>
 #include <ostream>
@@ -160,6 +162,32 @@ StructFieldValue::getFieldValue(const Field& field) const
     return {};
 }
 
+FieldValue::UP
+StructFieldValue::getMapEntryFieldValue(const Field& field, const FieldValue& key) const
+{
+    if ( ! field.getDataType().isMap()) {
+        return getFieldValue(field);
+    }
+    vespalib::ConstBufferRef buf = getRawField(field.getId());
+    if (buf.size() == 0) {
+        return {};
+    }
+    nbostream stream(buf.c_str(), buf.size());
+    auto value = std::make_unique<MapFieldValue>(field.getDataType());
+    std::unique_ptr<DocumentTypeRepo> tmpRepo;
+    if ((_repo == nullptr) && (_doc_type != nullptr)) {
+        tmpRepo = std::make_unique<DocumentTypeRepo>(*_doc_type);
+    }
+    FixedTypeRepo frepo(tmpRepo ? tmpRepo.get() : _repo, _doc_type);
+    try {
+        VespaDocumentDeserializer deserializer(frepo, stream, _version);
+        deserializer.readMapEntry(*value, key);
+    } catch (WrongTensorTypeException &) {
+        // Same as createFV(); the entry will appear to have no tensor.
+    }
+    return value;
+}
+
 vespalib::ConstBufferRef
 StructFieldValue::getRawField(uint32_t id) const
 {
@@ -190,6 +218,28 @@ StructFieldValue::getFieldValue(const Field& field, FieldValue& value) const
     return false;
 }
 
+bool
+StructFieldValue::getStringValueRef(const Field& field, vespalib::stringref& value) const
+{
+    if (field.getDataType().getId() != DataType::T_STRING) {
+        throw vespalib::IllegalArgumentException(make_string("Field '%s' is not a string field", field.getName().c_str()), VESPA_STRLOC);
+    }
+    vespalib::ConstBufferRef buf = getRawField(field.getId());
+    if (buf.size() == 0) {
+        return false;
+    }
+    // Same layout as read by VespaDocumentDeserializer::read(StringFieldValue &)
+    nbostream_longlivedbuf stream(buf.c_str(), buf.size());
+    uint8_t coding = 0;
+    stream >> coding;
+    size_t size = stream.getInt1_4Bytes();
+    if ((size == 0) || (size > stream.size())) {
+        throw DeserializeException(make_string("invalid string length %zu", size), VESPA_STRLOC);
+    }
+    value = vespalib::stringref(stream.peek(), size - 1);
+    return true;
+}
+
 bool
 StructFieldValue::hasFieldValue(const Field& field) const
 {
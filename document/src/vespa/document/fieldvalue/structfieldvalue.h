@@ -54,6 +54,14 @@ public:
     bool serializeField(int raw_field_id, uint16_t version, FieldValueWriter &writer) const;
     uint16_t getVersion() const { return _version; }
 
+    /**
+     * Returns a reference to the serialized string of the given string
+     * field without creating a field value. Any annotations are ignored.
+     * The reference is valid as long as the field is not modified.
+     * Returns false if the field has no value.
+     */
+    bool getStringValueRef(const Field& field, vespalib::stringref& value) const;
+
     // raw_ids may contain ids for elements not in the struct's datatype.
     std::vector<int> getRawFieldIds() const;
     void getRawFieldIds(std::vector<int> &raw_ids, const FieldSet& fieldSet) const;
@@ -93,6 +101,7 @@ private:
     void setFieldValue(const Field&, FieldValue::UP value) override;
     FieldValue::UP getFieldValue(const Field&) const override;
     bool getFieldValue(const Field&, FieldValue&) const override;
+    FieldValue::UP getMapEntryFieldValue(const Field& field, const FieldValue& key) const override;
     bool hasFieldValue(const Field&) const override;
     void removeFieldValue(const Field&) override;
     VESPA_DLL_LOCAL vespalib::ConstBufferRef getRawField(uint32_t id) const;
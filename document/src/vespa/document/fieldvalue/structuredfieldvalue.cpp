@@ -114,12 +114,20 @@ StructuredFieldValue::onIterateNested(PathRange nested, IteratorHandler & handle
         const FieldPathEntry & fpe = nested.cur();
         if (fpe.getType() == FieldPathEntry::STRUCT_FIELD) {
             const Field & field = fpe.getFieldRef();
+            PathRange next = nested.next();
+            if (handler.readOnly() && (getCache() == nullptr) && field.getDataType().isMap()
+                && !next.atEnd() && (next.cur().getType() == FieldPathEntry::MAP_KEY))
+            {
+                // Only the looked up entry is needed, no need to decode the entire map.
+                FieldValue::UP entry = getMapEntryFieldValue(field, next.cur().getLookupKey());
+                return entry ? entry->iterateNested(next, handler) : ModificationStatus::NOT_MODIFIED;
+            }
             FieldValue::UP value = getValue(field, FieldValue::UP());
             LOG(spam, "fieldRef = %s", field.toString().c_str());
             LOG(spam, "fieldValueToSet = %s", value ? value->toString().c_str() : "<null>");
             ModificationStatus status = ModificationStatus::NOT_MODIFIED;
             if (value) {
-                status = value->iterateNested(nested.next(), handler);
+                status = value->iterateNested(next, handler);
                 if (status == ModificationStatus::REMOVED) {
                     LOG(spam, "field exists, status = REMOVED");
                     const_cast<StructuredFieldValue&>(*this).remove(field);
@@ -132,7 +140,7 @@ StructuredFieldValue::onIterateNested(PathRange nested, IteratorHandler & handle
                 }
             } else if (handler.createMissingPath()) {
                 LOG(spam, "createMissingPath is true");
-                status = fpe.getFieldValueToSet().iterateNested(nested.next(), handler);
+                status = fpe.getFieldValueToSet().iterateNested(next, handler);
                 if (status == ModificationStatus::MODIFIED) {
                     LOG(spam, "field did not exist, status = MODIFIED");
                     updateValue(field, fpe.stealFieldValueToSet());
@@ -100,6 +100,14 @@ protected:
     virtual bool getFieldValue(const Field& field, FieldValue& value) const = 0;
     virtual void setFieldValue(const Field&, FieldValue::UP value) = 0;
     void setFieldValue(const Field & field, const FieldValue & value);
+    /**
+     * Fetches a map field holding at most the entry with the given key.
+     * Used by read only iteration to avoid decoding the entire map.
+     */
+    virtual FieldValue::UP getMapEntryFieldValue(const Field& field, const FieldValue& key) const {
+        (void) key;
+        return getFieldValue(field);
+    }
 
     fieldvalue::ModificationStatus
     onIterateNested(PathRange nested, fieldvalue::IteratorHandler & handler) const override;
@@ -0,0 +1,431 @@
+// Copyright Vespa.ai. Licensed under the terms of the Apache 2.0 license. See LICENSE in the project root.
+
+#include "compiled_selection.h"
+#include "branch.h"
+#include "compare.h"
+#include "constant.h"
+#include "doctype.h"
+#include "operator.h"
+#include "traversingvisitor.h"
+#include "valuenodes.h"
+#include <vespa/document/datatype/documenttype.h>
+#include <vespa/document/fieldvalue/boolfieldvalue.h>
+#include <vespa/document/fieldvalue/bytefieldvalue.h>
+#include <vespa/document/fieldvalue/document.h>
+#include <vespa/document/fieldvalue/doublefieldvalue.h>
+#include <vespa/document/fieldvalue/floatfieldvalue.h>
+#include <vespa/document/fieldvalue/intfieldvalue.h>
+#include <vespa/document/fieldvalue/longfieldvalue.h>
+#include <vespa/document/repo/documenttyperepo.h>
+#include <algorithm>
+#include <array>
+#include <typeinfo>
+
+namespace document::select {
+
+namespace {
+
+// Upper bound on nesting of boolean operators evaluated by the program.
+// Deeper selections are interpreted as a whole.
+constexpr uint32_t MAX_STACK_DEPTH = 64;
+
+class VariableDetector : public TraversingVisitor {
+public:
+    bool _found = false;
+
+    void visitVariableValueNode(const VariableValueNode&) override { _found = true; }
+    void visitFieldValueNode(const FieldValueNode& node) override {
+        if (node.getFieldName().find('$') != vespalib::string::npos) {
+            _found = true;
+        }
+    }
+};
+
+bool
+uses_variables(const Node& node)
+{
+    VariableDetector detector;
+    node.visit(detector);
+    return detector._found;
+}
+
+uint32_t
+boolean_depth(const Node& node)
+{
+    if (const auto* and_node = dynamic_cast<const And*>(&node)) {
+        return 1 + std::max(boolean_depth(and_node->getLeft()), boolean_depth(and_node->getRight()));
+    }
+    if (const auto* or_node = dynamic_cast<const Or*>(&node)) {
+        return 1 + std::max(boolean_depth(or_node->getLeft()), boolean_depth(or_node->getRight()));
+    }
+    if (const auto* not_node = dynamic_cast<const Not*>(&node)) {
+        return 1 + boolean_depth(not_node->getChild());
+    }
+    return 1;
+}
+
+using CompareOp = CompiledSelection::CompareOp;
+using FieldKind = CompiledSelection::FieldKind;
+
+bool
+resolve_compare_op(const Operator& op, CompareOp& result)
+{
+    if (op == FunctionOperator::EQ) {
+        result = CompareOp::EQ;
+    } else if (op == FunctionOperator::NE) {
+        result = CompareOp::NE;
+    } else if (op == FunctionOperator::LT) {
+        result = CompareOp::LT;
+    } else if (op == FunctionOperator::LEQ) {
+        result = CompareOp::LEQ;
+    } else if (op == FunctionOperator::GT) {
+        result = CompareOp::GT;
+    } else if (op == FunctionOperator::GEQ) {
+        result = CompareOp::GEQ;
+    } else {
+        return false;
+    }
+    return true;
+}
+
+bool
+resolve_field_kind(const Field& field, FieldKind& result)
+{
+    switch (field.getDataType().getId()) {
+    case DataType::T_BYTE:   result = FieldKind::BYTE;   return true;
+    case DataType::T_INT:    result = FieldKind::INT;    return true;
+    case DataType::T_LONG:   result = FieldKind::LONG;   return true;
+    case DataType::T_BOOL:   result = FieldKind::BOOL;   return true;
+    case DataType::T_FLOAT:  result = FieldKind::FLOAT;  return true;
+    case DataType::T_DOUBLE: result = FieldKind::DOUBLE; return true;
+    case DataType::T_STRING: result = FieldKind::STRING; return true;
+    default: return false;
+    }
+}
+
+/*
+ * Mirrors how the select values implement the operators on top of
+ * '<' and '==' (see Value), so that NaN behaves as in the interpreter.
+ */
+template <typename T>
+const Result&
+compare_ordered(const T& lhs, const T& rhs, CompareOp op)
+{
+    switch (op) {
+    case CompareOp::LT:  return Result::get(lhs < rhs);
+    case CompareOp::LEQ: return Result::get((lhs < rhs) || (lhs == rhs));
+    case CompareOp::GT:  return Result::get(!(lhs < rhs) && !(lhs == rhs));
+    case CompareOp::GEQ: return Result::get(!(lhs < rhs));
+    case CompareOp::EQ:  return Result::get(lhs == rhs);
+    case CompareOp::NE:  return Result::get(!(lhs == rhs));
+    }
+    return Result::Invalid;
+}
+
+template <typename T>
+const Result&
+compare_values(const T& field_value, const T& literal, bool literal_left, CompareOp op)
+{
+    return literal_left ? compare_ordered(literal, field_value, op) : compare_ordered(field_value, literal, op);
+}
+
+// A missing field compares as a null value, which is neither ordered nor equal to a literal
+const Result&
+compare_null(CompareOp op)
+{
+    switch (op) {
+    case CompareOp::EQ: return Result::False;
+    case CompareOp::NE: return Result::True;
+    default:            return Result::Invalid;
+    }
+}
+
+bool
+read_field(const Document& doc, const Field& field, FieldValue& value)
+{
+    return doc.getValue(field, value);
+}
+
+}
+
+CompiledSelection::Instruction::Instruction(OpCode code_in)
+    : code(code_in),
+      compare_op(CompareOp::EQ),
+      field_kind(FieldKind::INT),
+      float_compare(false),
+      literal_left(false),
+      jump(0),
+      constant(nullptr),
+      node(nullptr),
+      doc_type(nullptr),
+      field(nullptr),
+      int_value(0),
+      float_value(0.0),
+      string_value()
+{
+}
+
+CompiledSelection::Instruction::Instruction(Instruction&&) noexcept = default;
+CompiledSelection::Instruction& CompiledSelection::Instruction::operator=(Instruction&&) noexcept = default;
+CompiledSelection::Instruction::~Instruction() = default;
+
+CompiledSelection::CompiledSelection(std::unique_ptr<Node> root, const DocumentTypeRepo& repo)
+    : _root(std::move(root)),
+      _program(),
+      _interpreted(0)
+{
+    if (uses_variables(*_root) || (boolean_depth(*_root) > MAX_STACK_DEPTH)) {
+        // Variable bindings must be combined across the whole tree
+        _interpreted = 1;
+        return;
+    }
+    compile_node(*_root, repo);
+}
+
+CompiledSelection::~CompiledSelection() = default;
+
+std::unique_ptr<CompiledSelection>
+CompiledSelection::compile(const Node& root, const DocumentTypeRepo& repo)
+{
+    return std::unique_ptr<CompiledSelection>(new CompiledSelection(root.clone(), repo));
+}
+
+void
+CompiledSelection::compile_node(const Node& node, const DocumentTypeRepo& repo)
+{
+    if (const auto* and_node = dynamic_cast<const And*>(&node)) {
+        compile_node(and_node->getLeft(), repo);
+        size_t skip = _program.size();
+        _program.emplace_back(OpCode::AND_SKIP);
+        compile_node(and_node->getRight(), repo);
+        _program.emplace_back(OpCode::AND);
+        _program[skip].jump = _program.size();
+    } else if (const auto* or_node = dynamic_cast<const Or*>(&node)) {
+        compile_node(or_node->getLeft(), repo);
+        size_t skip = _program.size();
+        _program.emplace_back(OpCode::OR_SKIP);
+        compile_node(or_node->getRight(), repo);
+        _program.emplace_back(OpCode::OR);
+        _program[skip].jump = _program.size();
+    } else if (const auto* not_node = dynamic_cast<const Not*>(&node)) {
+        compile_node(not_node->getChild(), repo);
+        _program.emplace_back(OpCode::NOT);
+    } else if (const auto* constant = dynamic_cast<const Constant*>(&node)) {
+        auto& insn = _program.emplace_back(OpCode::CONSTANT);
+        insn.constant = &Result::get(constant->getConstantValue());
+    } else if (const auto* doc_type = dynamic_cast<const DocType*>(&node)) {
+        auto& insn = _program.emplace_back(OpCode::DOC_TYPE);
+        insn.doc_type = repo.getDocumentType(doc_type->getDocType());
+        insn.string_value = doc_type->getDocType();
+    } else if (!compile_compare(node, repo)) {
+        emit_interpret(node);
+    }
+}
+
+bool
+CompiledSelection::compile_compare(const Node& node, const DocumentTypeRepo& repo)
+{
+    const auto* compare = dynamic_cast<const Compare*>(&node);
+    if (compare == nullptr) {
+        return false;
+    }
+    // Exact type match; subclasses (e.g. attribute backed nodes) evaluate differently
+    const ValueNode* field_node = &compare->getLeft();
+    const ValueNode* literal = &compare->getRight();
+    bool literal_left = false;
+    if (typeid(*field_node) != typeid(FieldValueNode)) {
+        std::swap(field_node, literal);
+        literal_left = true;
+    }
+    if (typeid(*field_node) != typeid(FieldValueNode)) {
+        return false;
+    }
+    const auto& field_value_node = static_cast<const FieldValueNode&>(*field_node);
+    if (field_value_node.getFieldName() != field_value_node.getRealFieldName()) {
+        return false; // Not a plain top level field
+    }
+    CompareOp op;
+    if (!resolve_compare_op(compare->getOperator(), op)) {
+        return false;
+    }
+    const DocumentType* doc_type = repo.getDocumentType(field_value_node.getDocType());
+    const vespalib::string& field_name = field_value_node.getRealFieldName();
+    if ((doc_type == nullptr) || !doc_type->hasField(field_name) || doc_type->has_imported_field_name(field_name)) {
+        return false;
+    }
+    const Field& field = doc_type->getField(field_name);
+    FieldKind kind;
+    if (!resolve_field_kind(field, kind)) {
+        return false;
+    }
+    Instruction insn(OpCode::COMPARE_FIELD);
+    if (kind == FieldKind::STRING) {
+        if (typeid(*literal) != typeid(StringValueNode)) {
+            return false;
+        }
+        insn.string_value = static_cast<const StringValueNode&>(*literal).getValue();
+    } else if ((typeid(*literal) == typeid(IntegerValueNode)) || (typeid(*literal) == typeid(BoolValueNode))) {
+        const auto& int_node = static_cast<const IntegerValueNode&>(*literal);
+        if (int_node.isBucketValue()) {
+            return false;
+        }
+        insn.int_value = int_node.getValue();
+        insn.float_value = insn.int_value;
+        insn.float_compare = ((kind == FieldKind::FLOAT) || (kind == FieldKind::DOUBLE));
+    } else if (typeid(*literal) == typeid(FloatValueNode)) {
+        insn.float_value = static_cast<const FloatValueNode&>(*literal).getValue();
+        insn.float_compare = true;
+    } else {
+        return false;
+    }
+    insn.compare_op = op;
+    insn.literal_left = literal_left;
+    insn.field_kind = kind;
+    insn.node = &node;
+    insn.doc_type = doc_type;
+    insn.field = &field;
+    _program.push_back(std::move(insn));
+    return true;
+}
+
+void
+CompiledSelection::emit_interpret(const Node& node)
+{
+    auto& insn = _program.emplace_back(OpCode::INTERPRET);
+    insn.node = &node;
+    ++_interpreted;
+}
+
+const Result*
+CompiledSelection::compare_field(const Instruction& insn, const Document& doc) const
+{
+    const Field& field = *insn.field;
+    const CompareOp op = insn.compare_op;
+    int64_t int_value = 0;
+    double float_value = 0.0;
+    bool has_value = false;
+    switch (insn.field_kind) {
+    case FieldKind::STRING: {
+        vespalib::stringref value;
+        if (!doc.getFields().getStringValueRef(field, value)) {
+            return &compare_null(op);
+        }
+        return &compare_values(value, vespalib::stringref(insn.string_value), insn.literal_left, op);
+    }
+    case FieldKind::BYTE: {
+        ByteFieldValue value;
+        has_value = read_field(doc, field, value);
+        int_value = value.getAsByte();
+        break;
+    }
+    case FieldKind::INT: {
+        IntFieldValue value;
+        has_value = read_field(doc, field, value);
+        int_value = value.getAsInt();
+        break;
+    }
+    case FieldKind::LONG: {
+        LongFieldValue value;
+        has_value = read_field(doc, field, value);
+        int_value = value.getAsLong();
+        break;
+    }
+    case FieldKind::BOOL: {
+        BoolFieldValue value;
+        has_value = read_field(doc, field, value);
+        int_value = value.getAsInt();
+        break;
+    }
+    case FieldKind::FLOAT: {
+        FloatFieldValue value;
+        has_value = read_field(doc, field, value);
+        float_value = value.getAsFloat();
+        break;
+    }
+    case FieldKind::DOUBLE: {
+        DoubleFieldValue value;
+        has_value = read_field(doc, field, value);
+        float_value = value.getAsDouble();
+        break;
+    }
+    }
+    if (!has_value) {
+        return &compare_null(op);
+    }
+    if (insn.float_compare) {
+        if ((insn.field_kind != FieldKind::FLOAT) && (insn.field_kind != FieldKind::DOUBLE)) {
+            float_value = int_value;
+        }
+        return &compare_values(float_value, insn.float_value, insn.literal_left, op);
+    }
+    return &compare_values(int_value, insn.int_value, insn.literal_left, op);
+}
+
+const Result&
+CompiledSelection::interpret_all(const Document& doc) const
+{
+    return _root->contains(Context(doc)).combineResults();
+}
+
+const Result&
+CompiledSelection::contains(const Document& doc) const
+{
+    if (_program.empty()) {
+        return interpret_all(doc);
+    }
+    std::array<const Result*, MAX_STACK_DEPTH> stack;
+    uint32_t sp = 0;
+    const uint32_t program_size = _program.size();
+    for (uint32_t pc = 0; pc < program_size; ++pc) {
+        const Instruction& insn = _program[pc];
+        switch (insn.code) {
+        case OpCode::CONSTANT:
+            stack[sp++] = insn.constant;
+            break;
+        case OpCode::DOC_TYPE:
+            stack[sp++] = &Result::get((&doc.getType() == insn.doc_type) ||
+                                       (doc.getType().getName() == insn.string_value));
+            break;
+        case OpCode::COMPARE_FIELD:
+            if (&doc.getType() == insn.doc_type) {
+                stack[sp++] = compare_field(insn, doc);
+                break;
+            }
+            [[fallthrough]];
+        case OpCode::INTERPRET: {
+            ResultList results = insn.node->contains(Context(doc));
+            const auto& entries = results.getResults();
+            if ((entries.size() != 1) || !entries[0].first.empty()) {
+                // Multi valued results do not combine piecewise; let the tree decide
+                return interpret_all(doc);
+            }
+            stack[sp++] = entries[0].second;
+            break;
+        }
+        case OpCode::AND_SKIP:
+            if (*stack[sp - 1] == Result::False) {
+                pc = insn.jump - 1;
+            }
+            break;
+        case OpCode::OR_SKIP:
+            if (*stack[sp - 1] == Result::True) {
+                pc = insn.jump - 1;
+            }
+            break;
+        case OpCode::AND:
+            --sp;
+            stack[sp - 1] = &(*stack[sp - 1] && *stack[sp]);
+            break;
+        case OpCode::OR:
+            --sp;
+            stack[sp - 1] = &(*stack[sp - 1] || *stack[sp]);
+            break;
+        case OpCode::NOT:
+            stack[sp - 1] = &!*stack[sp - 1];
+            break;
+        }
+    }
+    return *stack[0];
+}
+
+}
@@ -0,0 +1,84 @@
+// Copyright Vespa.ai. Licensed under the terms of the Apache 2.0 license. See LICENSE in the project root.
+#pragma once
+
+#include <vespa/vespalib/stllike/string.h>
+#include <memory>
+#include <vector>
+
+namespace document {
+    class Document;
+    class DocumentType;
+    class DocumentTypeRepo;
+    class Field;
+}
+
+namespace document::select {
+
+class Node;
+class Result;
+
+/**
+ * A document selection lowered into a flat program that is evaluated
+ * against documents without walking the expression tree.
+ *
+ * Document types and fields are resolved against the repo when compiling,
+ * and comparisons between a primitive field and a literal read the field
+ * into a value on the stack instead of allocating select values. Boolean
+ * operators short circuit. Any other sub-expression, or a document of a
+ * different type than the one resolved, is delegated to the tree
+ * interpreter so the result is always the same as Node::contains().
+ * Selections using variables are interpreted as a whole.
+ *
+ * The compiled selection is immutable and may be shared between threads.
+ */
+class CompiledSelection {
+public:
+    enum class OpCode : uint8_t { CONSTANT, DOC_TYPE, COMPARE_FIELD, INTERPRET, AND_SKIP, OR_SKIP, AND, OR, NOT };
+    enum class CompareOp : uint8_t { LT, LEQ, GT, GEQ, EQ, NE };
+    enum class FieldKind : uint8_t { BYTE, INT, LONG, BOOL, FLOAT, DOUBLE, STRING };
+
+    struct Instruction {
+        OpCode               code;
+        CompareOp            compare_op;
+        FieldKind            field_kind;
+        bool                 float_compare;
+        bool                 literal_left;
+        uint32_t             jump;
+        const Result       * constant;
+        const Node         * node;
+        const DocumentType * doc_type;
+        const Field        * field;
+        int64_t              int_value;
+        double               float_value;
+        vespalib::string     string_value;
+
+        explicit Instruction(OpCode code_in);
+        Instruction(Instruction&&) noexcept;
+        Instruction& operator=(Instruction&&) noexcept;
+        ~Instruction();
+    };
+
+private:
+    std::unique_ptr<Node>    _root;
+    std::vector<Instruction> _program;
+    size_t                   _interpreted;
+
+    CompiledSelection(std::unique_ptr<Node> root, const DocumentTypeRepo& repo);
+    void compile_node(const Node& node, const DocumentTypeRepo& repo);
+    bool compile_compare(const Node& node, const DocumentTypeRepo& repo);
+    void emit_interpret(const Node& node);
+    const Result* compare_field(const Instruction& insn, const Document& doc) const;
+    const Result& interpret_all(const Document& doc) const;
+public:
+    ~CompiledSelection();
+
+    static std::unique_ptr<CompiledSelection> compile(const Node& root, const DocumentTypeRepo& repo);
+
+    const Result& contains(const Document& doc) const;
+
+    size_t num_instructions() const noexcept { return _program.size(); }
+    // Number of sub-expressions delegated to the tree interpreter
+    size_t num_interpreted() const noexcept { return _interpreted; }
+};
+
+}
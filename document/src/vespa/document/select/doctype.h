@@ -27,6 +27,8 @@ public:
     void print(std::ostream& out, bool verbose, const std::string& indent) const override;
     void visit(Visitor& v) const override;
 
+    const vespalib::string& getDocType() const { return _doctype; }
+
     Node::UP clone() const override { return wrapParens(new DocType(_doctype)); }
 
 };
@@ -248,6 +248,7 @@ public:
     bool hasSingleValue() const;
     std::unique_ptr<Value> stealSingleValue() &&;
     std::vector<ArrayValue::VariableValue> stealValues() &&;
+    bool readOnly() const override { return true; }
 private:
     std::unique_ptr<Value> _firstValue;
     std::vector<ArrayValue::VariableValue> _values;
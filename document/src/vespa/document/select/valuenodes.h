@@ -79,6 +79,7 @@ public:
         : _value(val), _isBucketValue(isBucketValue) {}
 
     int64_t getValue() const { return _value; }
+    bool isBucketValue() const { return _isBucketValue; }
 
     std::unique_ptr<Value> getValue(const Context&) const override {
         return std::make_unique<IntegerValue>(_value, _isBucketValue);
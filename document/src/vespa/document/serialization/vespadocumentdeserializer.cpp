@@ -2,6 +2,7 @@
 
 #include "vespadocumentdeserializer.h"
 #include "annotationdeserializer.h"
+#include <vespa/document/datatype/mapdatatype.h>
 #include <vespa/document/fieldvalue/annotationreferencefieldvalue.h>
 #include <vespa/document/fieldvalue/arrayfieldvalue.h>
 #include <vespa/document/fieldvalue/boolfieldvalue.h>
@@ -186,6 +187,79 @@ VespaDocumentDeserializer::read(MapFieldValue &value) {
     }
 }
 
+void
+VespaDocumentDeserializer::readMapEntry(MapFieldValue &value, const FieldValue &key) {
+    value.clear();
+    uint32_t size = readSize(_stream);
+    const MapDataType &mapType = *value.getDataType()->cast_map();
+    FieldValue::UP entryKey = mapType.getKeyType().createFieldValue();
+    if (entryKey->type() != key.type()) {
+        return;
+    }
+    const DataType &valueType = mapType.getValueType();
+    for (uint32_t i = 0; i < size; ++i) {
+        entryKey->accept(*this);
+        if (*entryKey == key) {
+            FieldValue::UP entryValue = valueType.createFieldValue();
+            entryValue->accept(*this);
+            value.push_back(std::move(entryKey), std::move(entryValue));
+            return;
+        }
+        skip(valueType);
+    }
+}
+
+void
+VespaDocumentDeserializer::skip(const DataType &type) {
+    switch (type.getId()) {
+    case DataType::T_BYTE:
+    case DataType::T_BOOL:
+        _stream.adjustReadPos(1);
+        return;
+    case DataType::T_SHORT:
+        _stream.adjustReadPos(2);
+        return;
+    case DataType::T_INT:
+    case DataType::T_FLOAT:
+        _stream.adjustReadPos(4);
+        return;
+    case DataType::T_LONG:
+    case DataType::T_DOUBLE:
+        _stream.adjustReadPos(8);
+        return;
+    case DataType::T_STRING: {
+        uint8_t coding = readValue<uint8_t>(_stream);
+        _stream.adjustReadPos(getInt1_4Bytes(_stream));
+        if (coding & 0x40) {
+            _stream.adjustReadPos(readValue<uint32_t>(_stream));
+        }
+        return;
+    }
+    case DataType::T_RAW:
+        _stream.adjustReadPos(readValue<uint32_t>(_stream));
+        return;
+    default:
+        break;
+    }
+    if (type.isStructured() && !type.isDocument()) {
+        // Same layout as read by readStructNoReset(), without copying the data.
+        size_t data_size = readValue<uint32_t>(_stream);
+        const auto compression_type = CompressionConfig::Type(readValue<uint8_t>(_stream));
+        if (CompressionConfig::isCompressed(compression_type)) {
+            getInt2_4_8Bytes(_stream);
+        }
+        size_t field_count = getInt1_4Bytes(_stream);
+        for (size_t i = 0; i < field_count; ++i) {
+            getInt1_4Bytes(_stream);
+            getInt2_4_8Bytes(_stream);
+        }
+        _stream.adjustReadPos(data_size);
+        return;
+    }
+    FieldValue::UP ignored = type.createFieldValue();
+    ignored->accept(*this);
+}
+
 namespace {
 template <typename T> struct ValueType { using Type = typename T::Number; };
 template <> struct ValueType<BoolFieldValue> { using Type = bool; };
@@ -40,6 +40,7 @@ class VespaDocumentDeserializer : private FieldValueVisitor {
     void visit(ReferenceFieldValue &value) override { read(value); }
 
     void readDocument(Document &value);
+    void skip(const DataType &type);
 
 public:
     VespaDocumentDeserializer(const DocumentTypeRepo &repo, vespalib::nbostream &stream, uint16_t version) :
@@ -65,6 +66,12 @@ public:
     void read(AnnotationReferenceFieldValue &value);
     void read(ArrayFieldValue &value);
     void read(MapFieldValue &value);
+    /**
+     * Reads a serialized map, but only decodes the value of the entry with
+     * the given key. Other values are skipped. The resulting map holds
+     * at most one entry.
+     */
+    void readMapEntry(MapFieldValue &value, const FieldValue &key);
     void read(BoolFieldValue &value);
     void read(ByteFieldValue &value);
     void read(DoubleFieldValue &value);
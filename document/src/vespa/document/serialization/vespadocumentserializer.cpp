@@ -99,6 +99,11 @@ getContentCode(bool hasContent)
 
 void
 VespaDocumentSerializer::write(const Document &value) {
+    vespalib::ConstBufferRef retained = value.retained_serialized_form();
+    if ((retained.size() > 0) && !structNeedsReserialization(value.getFields())) {
+        _stream.write(retained.data(), retained.size());
+        return;
+    }
     nbostream doc_stream;
     VespaDocumentSerializer doc_serializer(doc_stream);
     doc_serializer.write(value.getId());
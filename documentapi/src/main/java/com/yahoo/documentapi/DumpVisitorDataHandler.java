@@ -3,6 +3,8 @@ package com.yahoo.documentapi;
 
 import com.yahoo.document.Document;
 import com.yahoo.document.DocumentId;
+import com.yahoo.documentapi.messagebus.protocol.DocumentListEntry;
+import com.yahoo.documentapi.messagebus.protocol.DocumentListMessage;
 import com.yahoo.documentapi.messagebus.protocol.PutDocumentMessage;
 import com.yahoo.documentapi.messagebus.protocol.RemoveDocumentMessage;
 import com.yahoo.messagebus.Message;
@@ -11,7 +13,8 @@ import com.yahoo.messagebus.Message;
  * <p>Implementation of VisitorDataHandler which invokes onDocument() for each
  * received document and onRemove() for each document id that was returned as
  * part of a remove entry. The latter only applies if the visitor was run with
- * visitRemoves enabled.</p>
+ * visitRemoves enabled. Documents received in document list batches (see
+ * VisitorParameters.setMaxBytesPerBatch) are passed on one at a time.</p>
  *
  * <p>NOTE: onDocument and onRemove may be called in a re-entrant manner, as
  * these run on top of a thread pool. Any mutation of shared state must be
@@ -31,8 +34,17 @@ public abstract class DumpVisitorDataHandler extends VisitorDataHandler {
         } else if (m instanceof RemoveDocumentMessage) {
             RemoveDocumentMessage rm = (RemoveDocumentMessage)m;
             onRemove(rm.getDocumentId());
+        } else if (m instanceof DocumentListMessage) {
+            DocumentListMessage dlm = (DocumentListMessage)m;
+            for (DocumentListEntry entry : dlm.getDocuments()) {
+                if (entry.isRemoveEntry()) {
+                    onRemove(entry.getDocument().getId());
+                } else {
+                    onDocument(entry.getDocument(), entry.getTimestamp());
+                }
+            }
         } else {
-            throw new UnsupportedOperationException("Received unsupported message " + m.toString() + " to dump visitor data handler. This handler only accepts Put and Remove");
+            throw new UnsupportedOperationException("Received unsupported message " + m.toString() + " to dump visitor data handler. This handler only accepts Put, Remove and DocumentList");
         }
         ack(token);
     }
@@ -221,6 +221,13 @@ public class VisitorParameters extends Parameters {
     /** Sets all visitor library specific parameters. */
     public void setLibraryParameters(Map<String, byte []> params) { libraryParameters = params; }
 
+    /**
+     * Makes the dump visitor send documents in document list messages of roughly the given number of bytes,
+     * instead of one message per document. Data handlers must then accept DocumentListMessage, as
+     * DumpVisitorDataHandler does. 0 (the default) sends one message per document.
+     */
+    public void setMaxBytesPerBatch(int bytes) { setLibraryParameter("maxbytesperbatch", String.valueOf(bytes)); }
+
     /** Sets progress token, which can be used to resume visitor. */
     public void setResumeToken(ProgressToken token) { resumeToken = token; }
 
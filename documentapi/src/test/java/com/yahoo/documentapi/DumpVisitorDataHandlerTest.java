@@ -0,0 +1,75 @@
+// Copyright Vespa.ai. Licensed under the terms of the Apache 2.0 license. See LICENSE in the project root.
+package com.yahoo.documentapi;
+
+import com.yahoo.document.Document;
+import com.yahoo.document.DocumentId;
+import com.yahoo.document.DocumentTypeManager;
+import com.yahoo.document.DocumentTypeManagerConfigurer;
+import com.yahoo.documentapi.messagebus.protocol.DocumentListEntry;
+import com.yahoo.documentapi.messagebus.protocol.DocumentListMessage;
+import org.junit.Before;
+import org.junit.Test;
+
+import java.util.ArrayList;
+import java.util.List;
+
+import static org.junit.Assert.assertEquals;
+import static org.junit.Assert.assertSame;
+
+public class DumpVisitorDataHandlerTest {
+
+    private final DocumentTypeManager docMan = new DocumentTypeManager();
+
+    @Before
+    public void setUp() {
+        DocumentTypeManagerConfigurer.configure(docMan, "file:./test/cfg/testdoc.cfg");
+    }
+
+    private Document createDocument(String docId) {
+        return new Document(docMan.getDocumentType("testdoc"), docId);
+    }
+
+    private static class RecordingHandler extends DumpVisitorDataHandler {
+        final List<Document> documents = new ArrayList<>();
+        final List<Long> timestamps = new ArrayList<>();
+        final List<DocumentId> removes = new ArrayList<>();
+        int acks = 0;
+
+        @Override
+        public void onDocument(Document doc, long timeStamp) {
+            documents.add(doc);
+            timestamps.add(timeStamp);
+        }
+
+        @Override
+        public void onRemove(DocumentId id) {
+            removes.add(id);
+        }
+
+        @Override
+        public void ack(AckToken token) {
+            ++acks;
+        }
+    }
+
+    @Test
+    public void document_list_entries_are_passed_on_one_at_a_time_and_acked_once() {
+        Document foo = createDocument("id:ns:testdoc::foo");
+        Document bar = createDocument("id:ns:testdoc::bar");
+        DocumentListMessage msg = new DocumentListMessage();
+        msg.getDocuments().add(new DocumentListEntry(foo, 1234, false));
+        msg.getDocuments().add(new DocumentListEntry(createDocument("id:ns:testdoc::baz"), 1235, true));
+        msg.getDocuments().add(new DocumentListEntry(bar, 1236, false));
+
+        RecordingHandler handler = new RecordingHandler();
+        handler.onMessage(msg, new AckToken(new Object()));
+
+        assertEquals(2, handler.documents.size());
+        assertSame(foo, handler.documents.get(0));
+        assertSame(bar, handler.documents.get(1));
+        assertEquals(List.of(1234L, 1236L), handler.timestamps);
+        assertEquals(List.of(new DocumentId("id:ns:testdoc::baz")), handler.removes);
+        assertEquals(1, handler.acks);
+    }
+
+}
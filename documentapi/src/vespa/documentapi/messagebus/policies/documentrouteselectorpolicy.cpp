@@ -2,6 +2,7 @@
 
 #include "documentrouteselectorpolicy.h"
 #include <vespa/document/bucket/bucketidfactory.h>
+#include <vespa/document/select/compiled_selection.h>
 #include <vespa/document/select/parser.h>
 #include <vespa/documentapi/messagebus/documentprotocol.h>
 #include <vespa/documentapi/messagebus/messages/getdocumentmessage.h>
@@ -49,11 +50,12 @@ DocumentRouteSelectorPolicy::configure(std::unique_ptr<messagebus::protocol::Doc
         if (route.selector.empty()) {
             continue;
         }
-        SelectorPtr selector;
+        Selector selector;
         try {
             document::BucketIdFactory factory;
             document::select::Parser parser(_repo, factory);
-            selector.reset(parser.parse(route.selector).release());
+            selector.node.reset(parser.parse(route.selector).release());
+            selector.compiled = document::select::CompiledSelection::compile(*selector.node, _repo);
         }
         catch (document::select::ParsingFailedException &e) {
             error = vespalib::make_string("Error parsing selector '%s' for route '%s'; %s",
@@ -122,21 +124,22 @@ DocumentRouteSelectorPolicy::select(mbus::RoutingContext &context, const vespali
         LOG(debug, "No config entry for route '%s', select it.", routeName.c_str());
         return true;
     }
-    LOG_ASSERT(it->second.get() != NULL);
+    LOG_ASSERT(it->second.node.get() != NULL);
+    const document::select::Node &selector = *it->second.node;
 
     // Select based on message content.
     const mbus::Message &msg = context.getMessage();
     switch(msg.getType()) {
     case DocumentProtocol::MESSAGE_PUTDOCUMENT:
-        return it->second->contains(static_cast<const PutDocumentMessage&>(msg).getDocument()) == Result::True;
+        return it->second.compiled->contains(static_cast<const PutDocumentMessage&>(msg).getDocument()) == Result::True;
 
     case DocumentProtocol::MESSAGE_UPDATEDOCUMENT:
-        return it->second->contains(static_cast<const UpdateDocumentMessage&>(msg).getDocumentUpdate()) != Result::False;
+        return selector.contains(static_cast<const UpdateDocumentMessage&>(msg).getDocumentUpdate()) != Result::False;
 
     case DocumentProtocol::MESSAGE_REMOVEDOCUMENT: {
         const RemoveDocumentMessage &removeMsg = static_cast<const RemoveDocumentMessage &>(msg);
         if (removeMsg.getDocumentId().hasDocType()) {
-            return it->second->contains(removeMsg.getDocumentId()) != Result::False;
+            return selector.contains(removeMsg.getDocumentId()) != Result::False;
         } else {
             return true;
         }
@@ -144,7 +147,7 @@ DocumentRouteSelectorPolicy::select(mbus::RoutingContext &context, const vespali
     case DocumentProtocol::MESSAGE_GETDOCUMENT: {
         const GetDocumentMessage &getMsg = static_cast<const GetDocumentMessage &>(msg);
         if (getMsg.getDocumentId().hasDocType()) {
-            return it->second->contains(getMsg.getDocumentId()) != Result::False;
+            return selector.contains(getMsg.getDocumentId()) != Result::False;
         } else {
             return true;
         }
@@ -9,7 +9,10 @@
 #include <vespa/config/helper/ifetchercallback.h>
 #include <mutex>
 
-namespace document { class DocumentTypeRepo; }
+namespace document {
+    class DocumentTypeRepo;
+    namespace select { class CompiledSelection; }
+}
 
 namespace mbus {
     class Route;
@@ -34,7 +37,12 @@ class DocumentRouteSelectorPolicy : public mbus::IRoutingPolicy,
 {
 private:
     using SelectorPtr = std::shared_ptr<document::select::Node>;
-    using ConfigMap = std::map<string, SelectorPtr>;
+    // Documents in puts are matched with the compiled form of the selector
+    struct Selector {
+        SelectorPtr                                                node;
+        std::shared_ptr<const document::select::CompiledSelection> compiled;
+    };
+    using ConfigMap = std::map<string, Selector>;
 
     const document::DocumentTypeRepo      &_repo;
     mutable std::mutex                     _lock;
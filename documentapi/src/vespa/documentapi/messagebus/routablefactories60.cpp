@@ -429,6 +429,15 @@ decodeDocument(const document::DocumentTypeRepo & repo, document::ByteBuffer & b
     return doc;
 }
 
+// Fed documents keep their serialized form, so forwarding them to storage does not reserialize
+std::shared_ptr<document::Document>
+decodeFedDocument(const document::DocumentTypeRepo & repo, document::ByteBuffer & buf) {
+    vespalib::nbostream stream(buf.getBufferAtPos(), buf.getRemaining());
+    auto doc = document::Document::make_retaining_serialized_form(repo, stream);
+    buf.incPos(buf.getRemaining() - stream.size());
+    return doc;
+}
+
 }
 DocumentReply::UP
 RoutableFactories60::GetDocumentReplyFactory::doDecode(document::ByteBuffer &buf) const
@@ -498,7 +507,7 @@ RoutableFactories60::MapVisitorReplyFactory::doEncode(const DocumentReply &, ves
 
 void
 RoutableFactories60::PutDocumentMessageFactory::decodeInto(PutDocumentMessage & msg, document::ByteBuffer & buf) const {
-    msg.setDocument(decodeDocument(_repo, buf));
+    msg.setDocument(decodeFedDocument(_repo, buf));
     msg.setTimestamp(static_cast<uint64_t>(decodeLong(buf)));
     decodeTasCondition(msg, buf);
     if (buf.getRemaining() > 0) {
@@ -2,6 +2,7 @@
 #include <vespa/vespalib/testkit/test_kit.h>
 #include <vespa/vespalib/testkit/time_bomb.h>
 #include <vespa/eval/eval/llvm/compile_cache.h>
+#include <vespa/eval/eval/llvm/file_object_cache.h>
 #include <vespa/eval/eval/key_gen.h>
 #include <vespa/eval/eval/test/eval_spec.h>
 #include <vespa/vespalib/util/time.h>
@@ -9,6 +10,7 @@
 #include <vespa/vespalib/util/blockingthreadstackexecutor.h>
 #include <vespa/vespalib/util/size_literals.h>
 #include <vespa/vespalib/util/stringfmt.h>
+#include <filesystem>
 #include <set>
 
 using namespace vespalib;
@@ -241,6 +243,103 @@ TEST("require that the same executor can be bound multiple times") {
     EXPECT_EQUAL(exe1->tasks.size(), 1u);
 }
 
+//-----------------------------------------------------------------------------
+
+const vespalib::string object_cache_dir("object_cache");
+
+struct ObjectCacheDir {
+    ObjectCacheDir() {
+        std::filesystem::remove_all(object_cache_dir.c_str());
+        std::filesystem::create_directories(object_cache_dir.c_str());
+    }
+    ~ObjectCacheDir() {
+        std::filesystem::remove_all(object_cache_dir.c_str());
+    }
+    size_t num_files() const {
+        size_t files = 0;
+        for (const auto &entry: std::filesystem::directory_iterator(object_cache_dir.c_str())) {
+            (void) entry;
+            ++files;
+        }
+        return files;
+    }
+};
+
+TEST_F("require that compiled functions are stored in and loaded from the object cache", ObjectCacheDir()) {
+    auto function = Function::parse("if(a<b,a*b,max(a,b))");
+    auto key = gen_key(*function, PassParams::SEPARATE);
+    FileObjectCache cache_1(object_cache_dir, key);
+    CompiledFunction compiled_1(*function, PassParams::SEPARATE, cache_1);
+    EXPECT_FALSE(cache_1.loaded());
+    EXPECT_TRUE(cache_1.stored());
+    EXPECT_EQUAL(f1.num_files(), 1u);
+    FileObjectCache cache_2(object_cache_dir, key);
+    EXPECT_EQUAL(cache_1.file_name(), cache_2.file_name());
+    CompiledFunction compiled_2(*function, PassParams::SEPARATE, cache_2);
+    EXPECT_TRUE(cache_2.loaded());
+    EXPECT_FALSE(cache_2.stored());
+    EXPECT_EQUAL(6.0, compiled_1.get_function<2>()(2.0, 3.0));
+    EXPECT_EQUAL(6.0, compiled_2.get_function<2>()(2.0, 3.0));
+    EXPECT_EQUAL(3.0, compiled_2.get_function<2>()(3.0, 2.0));
+}
+
+TEST_F("require that object cache files for other keys are not used", ObjectCacheDir()) {
+    auto function = Function::parse("a+b");
+    auto key = gen_key(*function, PassParams::SEPARATE);
+    FileObjectCache cache_1(object_cache_dir, key);
+    CompiledFunction compiled_1(*function, PassParams::SEPARATE, cache_1);
+    EXPECT_TRUE(cache_1.stored());
+    // simulate a hash collision by renaming the file to the name used by another key
+    auto other_function = Function::parse("a-b");
+    FileObjectCache cache_2(object_cache_dir, gen_key(*other_function, PassParams::SEPARATE));
+    std::filesystem::rename(cache_1.file_name().c_str(), cache_2.file_name().c_str());
+    CompiledFunction compiled_2(*other_function, PassParams::SEPARATE, cache_2);
+    EXPECT_FALSE(cache_2.loaded());
+    EXPECT_TRUE(cache_2.stored());
+    EXPECT_EQUAL(-1.0, compiled_2.get_function<2>()(2.0, 3.0));
+}
+
+TEST_F("require that corrupt object cache files are not used", ObjectCacheDir()) {
+    auto function = Function::parse("a*b");
+    auto key = gen_key(*function, PassParams::SEPARATE);
+    FileObjectCache cache_1(object_cache_dir, key);
+    {
+        FILE *file = fopen(cache_1.file_name().c_str(), "w");
+        ASSERT_TRUE(file != nullptr);
+        fputs("garbage", file);
+        fclose(file);
+    }
+    CompiledFunction compiled(*function, PassParams::SEPARATE, cache_1);
+    EXPECT_FALSE(cache_1.loaded());
+    EXPECT_TRUE(cache_1.stored());
+    EXPECT_EQUAL(6.0, compiled.get_function<2>()(2.0, 3.0));
+}
+
+TEST_F("require that old object cache files are pruned", ObjectCacheDir()) {
+    auto function = Function::parse("a*b");
+    FileObjectCache cache(object_cache_dir, gen_key(*function, PassParams::SEPARATE));
+    CompiledFunction compiled(*function, PassParams::SEPARATE, cache);
+    EXPECT_EQUAL(f1.num_files(), 1u);
+    FileObjectCache::prune(object_cache_dir, 1h);
+    EXPECT_EQUAL(f1.num_files(), 1u);
+    auto old_time = std::filesystem::file_time_type::clock::now() - 2h;
+    std::filesystem::last_write_time(cache.file_name().c_str(), old_time);
+    FileObjectCache::prune(object_cache_dir, 1h);
+    EXPECT_EQUAL(f1.num_files(), 0u);
+}
+
+TEST("require that the object cache dir can be set and cleared") {
+    EXPECT_EQUAL(CompileCache::get_object_cache_dir(), "");
+    CompileCache::set_object_cache_dir(object_cache_dir);
+    EXPECT_EQUAL(CompileCache::get_object_cache_dir(), object_cache_dir);
+    EXPECT_TRUE(std::filesystem::is_directory(object_cache_dir.c_str()));
+    CompileCache::set_object_cache_dir("");
+    EXPECT_EQUAL(CompileCache::get_object_cache_dir(), "");
+    std::filesystem::remove_all(object_cache_dir.c_str());
+}
+
+//-----------------------------------------------------------------------------
+
 struct CompileCheck : test::EvalSpec::EvalTest {
     struct Entry {
         CompileCache::Token::UP fun;
@@ -296,6 +395,24 @@ TEST_F("compile sequentially, then run all conformance tests", test::EvalSpec())
     }
 }
 
+TEST_FF("compile using object cache, then run all conformance tests", test::EvalSpec(), ObjectCacheDir()) {
+    f1.add_all_cases();
+    CompileCache::set_object_cache_dir(object_cache_dir);
+    for (size_t i = 0; i < 2; ++i) {
+        // the first run populates the object cache, the second run loads from it
+        CompileCheck test;
+        auto t0 = steady_clock::now();
+        f1.each_case(test);
+        CompileCache::wait_pending();
+        auto t1 = steady_clock::now();
+        test.verify();
+        fprintf(stderr, "object cache (run %zu): files: %zu, setup and wait: %" PRIu64 " ms\n",
+                i, f2.num_files(), count_ms(t1 - t0));
+    }
+    CompileCache::set_object_cache_dir("");
+    EXPECT_GREATER(f2.num_files(), 0u);
+}
+
 TEST_F("compile concurrently (8 threads), then run all conformance tests", test::EvalSpec()) {
     f1.add_all_cases();
     auto executor = std::make_shared<ThreadStackExecutor>(8);
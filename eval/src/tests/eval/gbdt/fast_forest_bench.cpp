@@ -4,6 +4,7 @@
 #include <vespa/eval/eval/fast_forest.h>
 #include <vespa/eval/eval/vm_forest.h>
 #include <vespa/eval/eval/llvm/compiled_function.h>
+#include <vespa/vespalib/util/benchmark_timer.h>
 #include "model.cpp"
 
 using namespace vespalib::eval;
@@ -23,6 +24,22 @@ void estimate_cost(size_t num_params, const char *label, const T &impl) {
             label, (us_min / 10.0), (us_med / 10.0), (us_max / 10.0), (us_nan / 10.0));
 }
 
+void estimate_batch_cost(size_t num_params, const FastForest &forest, size_t batch_size) {
+    auto ctx = forest.create_context();
+    std::vector<double> results(batch_size);
+    auto run = [&](double value) {
+        std::vector<float> params(num_params * batch_size, value);
+        double us = vespalib::BenchmarkTimer::benchmark([&](){ forest.eval_batch(*ctx, &params[0], batch_size, batch_size, &results[0]); }, 5.0) * 1000.0 * 1000.0;
+        return (us / batch_size);
+    };
+    double us_min = run(0.25);
+    double us_med = run(0.50);
+    double us_max = run(0.75);
+    double us_nan = run(std::numeric_limits<float>::quiet_NaN());
+    fprintf(stderr, "[%8s x%3zu] (per 100 eval): [low values] %6.3f ms, [medium values] %6.3f ms, [high values] %6.3f ms, [nan values] %6.3f ms\n",
+            "batch", batch_size, (us_min / 10.0), (us_med / 10.0), (us_max / 10.0), (us_nan / 10.0));
+}
+
 void run_fast_forest_bench() {
     for (size_t tree_size: std::vector<size_t>({8,16,32,64,128,256})) {
         for (size_t num_trees: std::vector<size_t>({100, 500, 2500, 5000, 10000})) {
@@ -36,6 +53,9 @@ void run_fast_forest_bench() {
                             auto forest = FastForest::try_convert(*function, min_bits, 64);
                             if (forest) {
                                 estimate_cost(function->num_params(), forest->impl_name().c_str(), *forest);
+                                for (size_t batch_size: std::vector<size_t>({16, 64})) {
+                                    estimate_batch_cost(function->num_params(), *forest, batch_size);
+                                }
                             }
                             if (min_bits > 64) {
                                 break;
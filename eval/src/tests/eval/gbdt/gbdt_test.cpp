@@ -408,6 +408,41 @@ TEST("require that fast forest evaluation is correct for all tree size categorie
     }
 }
 
+TEST("require that fast forest batch evaluation gives the same result as evaluating one by one") {
+    for (size_t tree_size: std::vector<size_t>({7,15,30,61,127})) {
+        for (size_t num_trees: std::vector<size_t>({127, 300})) {
+            vespalib::string expression = Model().max_features(35).less_percent(100).invert_percent(50).make_forest(num_trees, tree_size);
+            auto function = Function::parse(expression);
+            auto forest = FastForest::try_convert(*function);
+            if ((tree_size <= 64) || is_little_endian()) {
+                ASSERT_TRUE(forest);
+                TEST_STATE(forest->impl_name().c_str());
+                EXPECT_EQUAL(forest->prefer_batch_eval(), (tree_size <= 64));
+                size_t num_params = function->num_params();
+                size_t num_docs = 5;
+                size_t stride = 8;
+                std::vector<float> params(num_params * stride, 0.0);
+                std::vector<std::vector<double>> doc_params(num_docs);
+                for (size_t doc = 0; doc < num_docs; ++doc) {
+                    for (size_t param = 0; param < num_params; ++param) {
+                        double value = ((doc + param) % 4 == 3)
+                                       ? std::numeric_limits<double>::quiet_NaN()
+                                       : (0.1 + ((doc * 7 + param * 3) % 9) * 0.1);
+                        params[param * stride + doc] = value;
+                        doc_params[doc].push_back(value);
+                    }
+                }
+                auto ctx = forest->create_context();
+                std::vector<double> results(num_docs, 0.0);
+                forest->eval_batch(*ctx, &params[0], stride, num_docs, &results[0]);
+                for (size_t doc = 0; doc < num_docs; ++doc) {
+                    EXPECT_EQUAL(results[doc], eval_ff(*forest, *ctx, doc_params[doc]));
+                }
+            }
+        }
+    }
+}
+
 //-----------------------------------------------------------------------------
 
 TEST("require that GDBT expressions can be detected") {
@@ -0,0 +1,98 @@
+// Copyright Vespa.ai. Licensed under the terms of the Apache 2.0 license. See LICENSE in the project root.
+
+#include <vespa/eval/eval/fast_value.h>
+#include <vespa/eval/eval/simple_value.h>
+#include <vespa/eval/instruction/dense_fused_elementwise_function.h>
+#include <vespa/eval/eval/test/eval_fixture.h>
+#include <vespa/eval/eval/test/gen_spec.h>
+#include <vespa/vespalib/gtest/gtest.h>
+
+using namespace vespalib::eval;
+using namespace vespalib::eval::test;
+
+const ValueBuilderFactory &prod_factory = FastValueBuilderFactory::get();
+const ValueBuilderFactory &test_factory = SimpleValueBuilderFactory::get();
+
+//-----------------------------------------------------------------------------
+
+EvalFixture::ParamRepo make_params() {
+    return EvalFixture::ParamRepo()
+        .add_variants("a1", GenSpec(1.0).idx("x", 5).idx("y", 3))
+        .add_variants("a2", GenSpec(2.0).idx("x", 5).idx("y", 3))
+        .add_variants("b1", GenSpec(3.0).idx("x", 3))
+        .add_variants("b2", GenSpec(4.0).idx("x", 3))
+        .add("c1", GenSpec(1.0).idx("x", 5).idx("y", 3).cells(CellType::BFLOAT16))
+        .add("c2", GenSpec(2.0).idx("x", 5).idx("y", 3).cells(CellType::BFLOAT16))
+        .add("m1", GenSpec(1.0).map("x", 5, 1))
+        .add("m2", GenSpec(2.0).map("x", 5, 1));
+}
+EvalFixture::ParamRepo param_repo = make_params();
+
+void assert_optimized(const vespalib::string &expr, bool has_map, bool has_reduce) {
+    EvalFixture fast_fixture(prod_factory, expr, param_repo, true);
+    EvalFixture test_fixture(test_factory, expr, param_repo, true);
+    EvalFixture slow_fixture(prod_factory, expr, param_repo, false);
+    EXPECT_EQ(fast_fixture.result(), EvalFixture::ref(expr, param_repo));
+    EXPECT_EQ(test_fixture.result(), EvalFixture::ref(expr, param_repo));
+    EXPECT_EQ(slow_fixture.result(), EvalFixture::ref(expr, param_repo));
+    auto info = fast_fixture.find_all<DenseFusedElementwiseFunction>();
+    ASSERT_EQ(info.size(), 1u);
+    EXPECT_TRUE(info[0]->result_is_mutable());
+    EXPECT_EQ(info[0]->map_fun() != nullptr, has_map);
+    EXPECT_EQ(info[0]->aggr().has_value(), has_reduce);
+    EXPECT_EQ(test_fixture.find_all<DenseFusedElementwiseFunction>().size(), 1u);
+    EXPECT_EQ(slow_fixture.find_all<DenseFusedElementwiseFunction>().size(), 0u);
+}
+
+void assert_not_optimized(const vespalib::string &expr) {
+    EvalFixture fast_fixture(prod_factory, expr, param_repo, true);
+    EXPECT_EQ(fast_fixture.result(), EvalFixture::ref(expr, param_repo));
+    EXPECT_EQ(fast_fixture.find_all<DenseFusedElementwiseFunction>().size(), 0u);
+}
+
+//-----------------------------------------------------------------------------
+
+TEST(DenseFusedElementwise, map_of_join_can_be_optimized)
+{
+    assert_optimized("tanh(a1+a2)", true, false);
+    assert_optimized("map(a1*a2,f(x)(x+3))", true, false);
+    assert_optimized("exp(b1_f-b2_f)", true, false);
+    assert_optimized("map(join(a1_f,a2_f,f(x,y)(x*y+1)),f(x)(x*x))", true, false);
+}
+
+TEST(DenseFusedElementwise, full_reduce_of_join_can_be_optimized)
+{
+    assert_optimized("reduce(a1-a2,sum)", false, true);
+    assert_optimized("reduce(a1+a2,max)", false, true);
+    assert_optimized("reduce(b1_f/b2_f,min)", false, true);
+}
+
+TEST(DenseFusedElementwise, full_reduce_of_map_of_join_can_be_optimized)
+{
+    assert_optimized("reduce(tanh(a1+a2),sum)", true, true);
+    assert_optimized("reduce(map(a1*a2,f(x)(x-2)),max,x,y)", true, true);
+    assert_optimized("reduce(exp(b1_f-b2_f),min)", true, true);
+    assert_optimized("reduce(sqrt(a1_f*a2_f),sum)", true, true);
+}
+
+TEST(DenseFusedElementwise, specialized_functions_are_preferred)
+{
+    assert_not_optimized("reduce(a1*a2,sum)");
+    assert_not_optimized("reduce((a1-a2)^2,sum)");
+}
+
+TEST(DenseFusedElementwise, unsupported_expressions_are_not_optimized)
+{
+    assert_not_optimized("a1+a2");
+    assert_not_optimized("reduce(tanh(a1+a2),sum,x)");
+    assert_not_optimized("reduce(a1-a2,prod)");
+    assert_not_optimized("reduce(a1-a2,avg)");
+    assert_not_optimized("tanh(a1+a2_f)");
+    assert_not_optimized("tanh(a1+b1)");
+    assert_not_optimized("tanh(c1+c2)");
+    assert_not_optimized("reduce(tanh(m1+m2),sum)");
+}
+
+//-----------------------------------------------------------------------------
+
+GTEST_MAIN_RUN_ALL_TESTS()
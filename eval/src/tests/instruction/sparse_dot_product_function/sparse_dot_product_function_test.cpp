@@ -5,6 +5,7 @@
 #include <vespa/eval/instruction/sparse_dot_product_function.h>
 #include <vespa/eval/eval/test/eval_fixture.h>
 #include <vespa/eval/eval/test/gen_spec.h>
+#include <vespa/vespalib/util/stringfmt.h>
 #include <vespa/vespalib/gtest/gtest.h>
 
 using namespace vespalib::eval;
@@ -15,6 +16,16 @@ const ValueBuilderFactory &test_factory = SimpleValueBuilderFactory::get();
 
 //-----------------------------------------------------------------------------
 
+// Numeric labels of equal width are added in the same order whether sorted as
+// strings or as numbers, giving values with their label ids in sorted order.
+std::vector<vespalib::string> make_labels(size_t size, size_t stride, const char *prefix) {
+    std::vector<vespalib::string> labels;
+    for (size_t i = 0; i < size; ++i) {
+        labels.push_back(vespalib::make_string("%s%zu", prefix, 100000 + (i * stride)));
+    }
+    return labels;
+}
+
 EvalFixture::ParamRepo make_params() {
     return EvalFixture::ParamRepo()
         .add_variants("v1_x", GenSpec(3.0).map("x", 32, 1))
@@ -23,7 +34,13 @@ EvalFixture::ParamRepo make_params() {
         .add("v4_xd",  GenSpec().idx("x", 10))
         .add("m1_xy",  GenSpec(3.0).map("x", 32, 1).map("y", 16, 2))
         .add("m2_xy",  GenSpec(7.0).map("x", 16, 2).map("y", 32, 1))
-        .add("m3_xym", GenSpec().map("x", 8, 1).idx("y", 5));
+        .add("m3_xym", GenSpec().map("x", 8, 1).idx("y", 5))
+        .add_variants("v5_x", GenSpec(1.0).map("x", 2048, 1))
+        .add_variants("v6_x", GenSpec(2.0).map("x", 1536, 3))
+        .add_variants("s1_x", GenSpec(1.0).map("x", make_labels(2048, 1, "")))
+        .add_variants("s2_x", GenSpec(2.0).map("x", make_labels(1536, 3, "")))
+        .add_variants("w1_x", GenSpec(1.0).map("x", make_labels(2048, 1, "w")))
+        .add_variants("w2_x", GenSpec(2.0).map("x", make_labels(1536, 3, "w")));
 }
 EvalFixture::ParamRepo param_repo = make_params();
 
@@ -54,6 +71,54 @@ TEST(SparseDotProduct, expression_can_be_optimized)
     assert_optimized("reduce(v1_x_f*v2_x_f,sum)");
 }
 
+TEST(SparseDotProduct, large_expression_can_be_optimized)
+{
+    assert_optimized("reduce(v5_x*v6_x,sum,x)");
+    assert_optimized("reduce(v6_x*v5_x,sum)");
+    assert_optimized("reduce(v5_x_f*v6_x_f,sum)");
+}
+
+double expected_dot_product(const vespalib::string &lhs_name, const vespalib::string &rhs_name) {
+    const auto &lhs = param_repo.map.find(lhs_name)->second.value;
+    const auto &rhs = param_repo.map.find(rhs_name)->second.value;
+    double result = 0.0;
+    for (const auto &[addr, value]: lhs.cells()) {
+        auto pos = rhs.cells().find(addr);
+        if (pos != rhs.cells().end()) {
+            result += (value.value * pos->second.value);
+        }
+    }
+    return result;
+}
+
+void assert_dot_product(const vespalib::string &lhs_name, const vespalib::string &rhs_name) {
+    auto expr = vespalib::make_string("reduce(%s*%s,sum,x)", lhs_name.c_str(), rhs_name.c_str());
+    EvalFixture fixture(prod_factory, expr, param_repo, true);
+    EXPECT_EQ(fixture.find_all<SparseDotProductFunction>().size(), 1u);
+    EXPECT_DOUBLE_EQ(fixture.result().as_double(), expected_dot_product(lhs_name, rhs_name));
+}
+
+TEST(SparseDotProduct, large_operands_with_sorted_labels_are_merged_correctly)
+{
+    EXPECT_GT(expected_dot_product("s1_x", "s2_x"), 0.0);
+    assert_dot_product("s1_x", "s2_x");
+    assert_dot_product("s2_x", "s1_x");
+    assert_dot_product("s1_x_f", "s2_x_f");
+    assert_optimized("reduce(s1_x*s2_x,sum,x)");
+}
+
+TEST(SparseDotProduct, large_operands_without_sorted_labels_use_lookup_correctly)
+{
+    EXPECT_GT(expected_dot_product("w1_x", "w2_x"), 0.0);
+    assert_dot_product("w1_x", "w2_x");
+    assert_dot_product("w2_x", "w1_x");
+    // one sorted and one unsorted operand
+    assert_dot_product("s1_x", "w2_x");
+    // "1", "10", "100", ... are added in string order, so label ids are not sorted
+    assert_dot_product("v5_x", "v6_x");
+    assert_optimized("reduce(w1_x*w2_x,sum,x)");
+}
+
 TEST(SparseDotProduct, multi_dimensional_expression_can_be_optimized)
 {
     assert_optimized("reduce(m1_xy*m2_xy,sum,x,y)");
@@ -72,6 +72,20 @@ TEST(SumMaxDotProduct, expressions_can_be_optimized)
     assert_optimized(empty_query, empty_document, 5);
 }
 
+TEST(SumMaxDotProduct, bfloat16_and_int8_cells_can_be_optimized) {
+    auto bfloat16_query = Que().cells(CellType::BFLOAT16);
+    auto bfloat16_document = Doc().cells(CellType::BFLOAT16);
+    auto int8_query = Que().cells(CellType::INT8);
+    auto int8_document = Doc().cells(CellType::INT8);
+    assert_optimized(query, bfloat16_document, 5);
+    assert_optimized(bfloat16_document, query, 5);
+    assert_optimized(bfloat16_query, bfloat16_document, 5);
+    assert_optimized(query, int8_document, 5);
+    assert_optimized(int8_query, int8_document, 5);
+    assert_optimized(bfloat16_query, int8_document, 5);
+    assert_optimized(query, DocEmptyX().cells(CellType::BFLOAT16), 5);
+}
+
 TEST(SumMaxDotProduct, double_cells_are_not_optimized) {
     auto double_query = Que().cells_double();
     auto double_document = Doc().cells_double();
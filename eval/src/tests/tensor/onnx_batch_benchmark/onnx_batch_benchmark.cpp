@@ -0,0 +1,118 @@
+// Copyright Vespa.ai. Licensed under the terms of the Apache 2.0 license. See LICENSE in the project root.
+
+// Compares the throughput of evaluating an onnx model one document at
+// a time against evaluating it for several documents in a single
+// session run (Onnx::BatchEvalContext). The model must have a leading
+// batch dimension for all inputs and outputs. The default model is
+// small, making per-call overhead dominate for single evaluations.
+//
+// usage: eval_onnx_batch_benchmark_app [--smoke-test | <model file> <inner size>]
+
+#include <vespa/eval/eval/value_type.h>
+#include <vespa/eval/eval/value.h>
+#include <vespa/eval/onnx/onnx_wrapper.h>
+#include <vespa/vespalib/util/benchmark_timer.h>
+#include <vespa/vespalib/util/stringfmt.h>
+#include <cstdlib>
+#include <string>
+
+using namespace vespalib::eval;
+using vespalib::BenchmarkTimer;
+using vespalib::make_string_short::fmt;
+
+std::string get_source_dir() {
+    const char *dir = getenv("SOURCE_DIRECTORY");
+    return (dir ? dir : ".");
+}
+std::string probe_model = get_source_dir() + "/../onnx_wrapper/probe_model.onnx";
+
+double budget = 2.0;
+constexpr size_t num_docs = 1024;
+
+struct Inputs {
+    ValueType type;
+    std::vector<std::vector<float>> cells;
+    std::vector<std::unique_ptr<Value>> values;
+    Inputs(size_t inner_size)
+        : type(ValueType::from_spec(fmt("tensor<float>(x[1],y[%zu])", inner_size))),
+          cells(num_docs),
+          values()
+    {
+        for (size_t i = 0; i < num_docs; ++i) {
+            for (size_t j = 0; j < inner_size; ++j) {
+                cells[i].push_back(float((i * 31 + j) % 17));
+            }
+            values.push_back(std::make_unique<DenseValueView>(type, TypedCells(cells[i])));
+        }
+    }
+};
+
+Onnx::WireInfo make_wire_info(const Onnx &model, const ValueType &type) {
+    Onnx::WirePlanner planner;
+    for (const auto &input: model.inputs()) {
+        if (!planner.bind_input_type(type, input)) {
+            fprintf(stderr, "unable to bind %s to model input '%s'\n", type.to_spec().c_str(), input.name.c_str());
+            abort();
+        }
+    }
+    planner.prepare_output_types(model);
+    return planner.get_wire_info(model);
+}
+
+double per_doc_eval(const Onnx &model, const Onnx::WireInfo &wire_info, const Inputs &inputs) {
+    Onnx::EvalContext ctx(model, wire_info);
+    auto fun = [&]() {
+        for (const auto &value: inputs.values) {
+            for (size_t i = 0; i < ctx.num_params(); ++i) {
+                ctx.bind_param(i, *value);
+            }
+            ctx.eval();
+        }
+    };
+    return BenchmarkTimer::benchmark(fun, budget);
+}
+
+double batched_eval(const Onnx &model, const Onnx::WireInfo &wire_info, const Inputs &inputs, size_t batch_size) {
+    Onnx::BatchEvalContext ctx(model, wire_info, batch_size);
+    auto fun = [&]() {
+        for (size_t begin = 0; begin < num_docs; begin += batch_size) {
+            size_t end = std::min(num_docs, begin + batch_size);
+            for (size_t doc = begin; doc < end; ++doc) {
+                for (size_t i = 0; i < ctx.num_params(); ++i) {
+                    ctx.bind_param(doc - begin, i, *inputs.values[doc]);
+                }
+            }
+            ctx.eval(end - begin);
+        }
+    };
+    return BenchmarkTimer::benchmark(fun, budget);
+}
+
+void run(const std::string &model_file, size_t inner_size) {
+    Onnx model(model_file, Onnx::Optimize::ENABLE);
+    Inputs inputs(inner_size);
+    auto wire_info = make_wire_info(model, inputs.type);
+    if (!Onnx::BatchEvalContext::can_batch(model, wire_info)) {
+        fprintf(stderr, "model '%s' cannot be evaluated in batches\n", model_file.c_str());
+        abort();
+    }
+    double per_doc_time = per_doc_eval(model, wire_info, inputs);
+    fprintf(stderr, "per document:   %10.0f docs/s\n", num_docs / per_doc_time);
+    for (size_t batch_size: {1, 8, 32, 128, 512}) {
+        double batch_time = batched_eval(model, wire_info, inputs, batch_size);
+        fprintf(stderr, "batch size %3zu: %10.0f docs/s (speedup: %.2f)\n",
+                batch_size, num_docs / batch_time, per_doc_time / batch_time);
+    }
+}
+
+int main(int argc, char **argv) {
+    if ((argc > 1) && (std::string(argv[1]) == "--smoke-test")) {
+        budget = 0.001;
+        run(probe_model, 3);
+    } else if (argc > 2) {
+        run(argv[1], atoi(argv[2]));
+    } else {
+        run(probe_model, 64);
+    }
+    return 0;
+}
@@ -510,6 +510,60 @@ TEST(OnnxModelCacheTest, share_and_evict_onnx_models) {
     EXPECT_EQ(OnnxModelCache::count_refs(), 0);
 }
 
+TEST(OnnxModelCacheTest, onnx_models_are_shared_per_session_options) {
+    auto threads = Onnx::Options(Onnx::Optimize::ENABLE).set_intra_op_threads(2);
+    auto arena = Onnx::Options(Onnx::Optimize::ENABLE).set_shared_arena(true);
+    {
+        auto plain1 = OnnxModelCache::load(simple_model);
+        auto plain2 = OnnxModelCache::load(simple_model, Onnx::Options(Onnx::Optimize::ENABLE));
+        auto threads1 = OnnxModelCache::load(simple_model, threads);
+        auto threads2 = OnnxModelCache::load(simple_model, threads);
+        auto arena1 = OnnxModelCache::load(simple_model, arena);
+        auto arena2 = OnnxModelCache::load(simple_model, arena);
+        EXPECT_EQ(&(plain1->get()), &(plain2->get()));
+        EXPECT_EQ(&(threads1->get()), &(threads2->get()));
+        EXPECT_EQ(&(arena1->get()), &(arena2->get()));
+        EXPECT_NE(&(plain1->get()), &(threads1->get()));
+        EXPECT_NE(&(plain1->get()), &(arena1->get()));
+        EXPECT_NE(&(threads1->get()), &(arena1->get()));
+        EXPECT_EQ(OnnxModelCache::num_cached(), 3);
+        EXPECT_EQ(OnnxModelCache::count_refs(), 6);
+    }
+    EXPECT_EQ(OnnxModelCache::num_cached(), 0);
+    EXPECT_EQ(OnnxModelCache::count_refs(), 0);
+}
+
+TEST(OnnxTest, models_sharing_an_arena_give_correct_results) {
+    auto options = Onnx::Options(Onnx::Optimize::ENABLE).set_shared_arena(true);
+    Onnx model1(simple_model, options);
+    Onnx model2(simple_model, options);
+    for (const Onnx *model: {&model1, &model2}) {
+        Onnx::WirePlanner planner;
+        ValueType query_type = ValueType::from_spec("tensor<float>(a[1],b[4])");
+        ValueType attribute_type = ValueType::from_spec("tensor<float>(a[4],b[1])");
+        ValueType bias_type = ValueType::from_spec("tensor<float>(a[1],b[1])");
+        EXPECT_TRUE(planner.bind_input_type(query_type, model->inputs()[0]));
+        EXPECT_TRUE(planner.bind_input_type(attribute_type, model->inputs()[1]));
+        EXPECT_TRUE(planner.bind_input_type(bias_type, model->inputs()[2]));
+        planner.prepare_output_types(*model);
+        auto wire_info = planner.get_wire_info(*model);
+        Onnx::EvalContext ctx(*model, wire_info);
+        std::vector<float> query_values({1.0, 2.0, 3.0, 4.0});
+        DenseValueView query(query_type, TypedCells(query_values));
+        std::vector<float> attribute_values({5.0, 6.0, 7.0, 8.0});
+        DenseValueView attribute(attribute_type, TypedCells(attribute_values));
+        std::vector<float> bias_values({9.0});
+        DenseValueView bias(bias_type, TypedCells(bias_values));
+        ctx.bind_param(0, query);
+        ctx.bind_param(1, attribute);
+        ctx.bind_param(2, bias);
+        ctx.eval();
+        auto cells = ctx.get_result(0).cells();
+        ASSERT_EQ(cells.size, 1u);
+        EXPECT_EQ(cells.typify<float>()[0], 79.0);
+    }
+}
+
 TensorSpec val(const vespalib::string &expr) {
     auto result = TensorSpec::from_expr(expr);
     EXPECT_FALSE(ValueType::from_spec(result.type()).is_error());
@@ -530,4 +584,73 @@ TEST(OnnxTest, eval_onnx_with_probe_model) {
     EXPECT_EQ(result[2], out3);
 }
 
+Onnx::WireInfo make_wire_info(const Onnx &model, const std::vector<ValueType> &input_types) {
+    Onnx::WirePlanner planner;
+    for (size_t i = 0; i < input_types.size(); ++i) {
+        EXPECT_TRUE(planner.bind_input_type(input_types[i], model.inputs()[i]));
+    }
+    planner.prepare_output_types(model);
+    for (const auto &output: model.outputs()) {
+        EXPECT_FALSE(planner.make_output_type(output).is_error());
+    }
+    return planner.get_wire_info(model);
+}
+
+TEST(OnnxTest, batch_eval_requires_batch_dimension_of_size_1) {
+    Onnx probe(probe_model, Onnx::Optimize::ENABLE);
+    Onnx simple(simple_model, Onnx::Optimize::ENABLE);
+    Onnx guess_batch(guess_batch_model, Onnx::Optimize::ENABLE);
+    auto probe_1 = make_wire_info(probe, {ValueType::from_spec("tensor<float>(x[1],y[3])"),
+                                          ValueType::from_spec("tensor<float>(x[1],y[3])")});
+    auto probe_2 = make_wire_info(probe, {ValueType::from_spec("tensor<float>(x[2],y[3])"),
+                                          ValueType::from_spec("tensor<float>(x[2],y[3])")});
+    auto simple_1 = make_wire_info(simple, {ValueType::from_spec("tensor<float>(a[1],b[4])"),
+                                            ValueType::from_spec("tensor<float>(a[4],b[1])"),
+                                            ValueType::from_spec("tensor<float>(a[1],b[1])")});
+    auto guess_1 = make_wire_info(guess_batch, {ValueType::from_spec("tensor<float>(a[1])"),
+                                                ValueType::from_spec("tensor<float>(a[1])")});
+    EXPECT_TRUE(Onnx::BatchEvalContext::can_batch(probe, probe_1));
+    EXPECT_FALSE(Onnx::BatchEvalContext::can_batch(probe, probe_2));
+    EXPECT_FALSE(Onnx::BatchEvalContext::can_batch(simple, simple_1));
+    EXPECT_FALSE(Onnx::BatchEvalContext::can_batch(guess_batch, guess_1)); // different symbolic sizes
+}
+
+TEST(OnnxTest, batch_eval_gives_same_results_as_single_eval) {
+    Onnx model(probe_model, Onnx::Optimize::ENABLE);
+    auto type = ValueType::from_spec("tensor<float>(x[1],y[3])");
+    auto wire_info = make_wire_info(model, {type, type});
+    Onnx::EvalContext single(model, wire_info);
+    Onnx::BatchEvalContext batch(model, wire_info, 4);
+    EXPECT_EQ(batch.max_batch_size(), 4);
+    EXPECT_EQ(batch.num_params(), 2);
+    EXPECT_EQ(batch.num_results(), 3);
+    std::vector<std::vector<float>> in1_cells;
+    std::vector<std::vector<float>> in2_cells;
+    for (size_t i = 0; i < 4; ++i) {
+        float f = i;
+        in1_cells.push_back({f, 2 * f, 3});
+        in2_cells.push_back({7, f, -f});
+    }
+    for (size_t batch_size: {4, 3, 1}) {
+        for (size_t slot = 0; slot < batch_size; ++slot) {
+            DenseValueView in1(type, TypedCells(in1_cells[slot]));
+            DenseValueView in2(type, TypedCells(in2_cells[slot]));
+            batch.bind_param(slot, 0, in1);
+            batch.bind_param(slot, 1, in2);
+        }
+        batch.eval(batch_size);
+        for (size_t slot = 0; slot < batch_size; ++slot) {
+            DenseValueView in1(type, TypedCells(in1_cells[slot]));
+            DenseValueView in2(type, TypedCells(in2_cells[slot]));
+            single.bind_param(0, in1);
+            single.bind_param(1, in2);
+            single.eval();
+            for (size_t i = 0; i < 3; ++i) {
+                EXPECT_EQ(TensorSpec::from_value(batch.get_result(slot, i)),
+                          TensorSpec::from_value(single.get_result(i)));
+            }
+        }
+    }
+}
+
 GTEST_MAIN_RUN_ALL_TESTS()
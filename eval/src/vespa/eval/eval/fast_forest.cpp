@@ -8,6 +8,7 @@
 #include <vespa/vespalib/util/benchmark_timer.h>
 #include <algorithm>
 #include <cassert>
+#include <limits>
 #include <arpa/inet.h>
 
 namespace vespalib::eval::gbdt {
@@ -146,7 +147,9 @@ constexpr size_t max_leafs() { return (sizeof(T) * bits_per_byte); }
 template <typename T>
 struct FixedContext : FastForest::Context {
     std::vector<T> masks;
-    FixedContext(size_t num_trees) : masks(num_trees) {}
+    std::vector<T> batch_masks;        // one mask per tree and document
+    std::vector<double> batch_partial; // second partial sum per document
+    FixedContext(size_t num_trees) : masks(num_trees), batch_masks(), batch_partial() {}
 };
 
 template <typename T>
@@ -197,9 +200,16 @@ struct FixedForest : FastForest {
     static void apply_masks(T *ctx_masks, const DMask *pos, const DMask *end);
     double get_result(const T *ctx_masks) const;
 
+    static void apply_batch_masks(T *tree_masks, const float *features, size_t num_docs, float value, T bits);
+    static void apply_batch_default_masks(T *tree_masks, const float *features, size_t num_docs, T bits);
+    void get_batch_results(const T *batch_masks, size_t num_docs, double *results, double *partial) const;
+
     vespalib::string impl_name() const override { return fixed_impl_name<T>(); }
     Context::UP create_context() const override;
     double eval(Context &context, const float *params) const override;
+    void eval_batch(Context &context, const float *params, size_t param_stride,
+                    size_t num_docs, double *results) const override;
+    bool prefer_batch_eval() const override { return true; }
 };
 
 template <typename T>
@@ -335,13 +345,95 @@ FixedForest<T>::eval(Context &context, const float *params) const
     return get_result(ctx_masks);
 }
 
+template <typename T>
+void
+FixedForest<T>::apply_batch_masks(T *tree_masks, const float *features, size_t num_docs, float value, T bits)
+{
+    // branch-free to allow vectorization across documents; missing
+    // (NaN) feature values never pass the check
+    for (size_t i = 0; i < num_docs; ++i) {
+        tree_masks[i] &= (value <= features[i]) ? bits : T(-1);
+    }
+}
+
+template <typename T>
+void
+FixedForest<T>::apply_batch_default_masks(T *tree_masks, const float *features, size_t num_docs, T bits)
+{
+    for (size_t i = 0; i < num_docs; ++i) {
+        tree_masks[i] &= std::isnan(features[i]) ? bits : T(-1);
+    }
+}
+
+template <typename T>
+void
+FixedForest<T>::get_batch_results(const T *batch_masks, size_t num_docs, double *results, double *partial) const
+{
+    // sum leafs in the same order as get_result to get identical results
+    std::fill(results, results + num_docs, 0.0);
+    std::fill(partial, partial + num_docs, 0.0);
+    size_t unrolled_trees = (_num_trees & ~size_t(3));
+    const float *leafs = &_padded_leafs[0];
+    for (size_t tree = 0; tree < _num_trees; ++tree, batch_masks += num_docs, leafs += _max_leafs) {
+        double *dst = ((tree < unrolled_trees) && ((tree & 1) == 1)) ? partial : results;
+        for (size_t i = 0; i < num_docs; ++i) {
+            dst[i] += leafs[get_lsb(batch_masks[i])];
+        }
+    }
+    for (size_t i = 0; i < num_docs; ++i) {
+        results[i] += partial[i];
+    }
+}
+
+template <typename T>
+void
+FixedForest<T>::eval_batch(Context &context, const float *params, size_t param_stride,
+                           size_t num_docs, double *results) const
+{
+    if (num_docs == 0) {
+        return;
+    }
+    auto &ctx = static_cast<FixedContext<T>&>(context);
+    ctx.batch_masks.assign(_num_trees * num_docs, T(-1));
+    ctx.batch_partial.resize(num_docs);
+    T *batch_masks = &ctx.batch_masks[0];
+    const Mask *mask_pos = &_masks[0];
+    for (size_t param = 0; param < _mask_sizes.size(); ++param) {
+        const float *features = params + (param * param_stride);
+        const Mask *mask_end = mask_pos + _mask_sizes[param];
+        float max_feature = -std::numeric_limits<float>::infinity();
+        bool has_nan = false;
+        for (size_t i = 0; i < num_docs; ++i) {
+            if (std::isnan(features[i])) {
+                has_nan = true;
+            } else {
+                max_feature = std::max(max_feature, features[i]);
+            }
+        }
+        if (has_nan) {
+            const DMask *pos = _default_masks.data() + _default_offsets[param];
+            const DMask *end = _default_masks.data() + _default_offsets[param + 1];
+            for (; pos < end; ++pos) {
+                apply_batch_default_masks(batch_masks + (pos->tree * num_docs), features, num_docs, pos->bits);
+            }
+        }
+        // masks are sorted on value; masks beyond the largest feature value apply to no document
+        for (const Mask *pos = mask_pos; (pos < mask_end) && !(max_feature < pos->value); ++pos) {
+            apply_batch_masks(batch_masks + (pos->tree * num_docs), features, num_docs, pos->value, pos->bits);
+        }
+        mask_pos = mask_end;
+    }
+    get_batch_results(batch_masks, num_docs, results, &ctx.batch_partial[0]);
+}
+
 //-----------------------------------------------------------------------------
 // implementation using multiple words for each tree
 //-----------------------------------------------------------------------------
 
 struct MultiWordContext : FastForest::Context {
     std::vector<uint32_t> words;
-    MultiWordContext(size_t size) : words(size) {}
+    std::vector<float> params;
+    MultiWordContext(size_t size, size_t num_params) : words(size), params(num_params) {}
 };
 
 struct MultiWordForest : FastForest {
@@ -440,6 +532,8 @@ struct MultiWordForest : FastForest {
     vespalib::string impl_name() const override { return "ff-multiword"; }
     Context::UP create_context() const override;
     double eval(Context &context, const float *params) const override;
+    void eval_batch(Context &context, const float *params, size_t param_stride,
+                    size_t num_docs, double *results) const override;
 };
 
 MultiWordForest::MultiWordForest(const State &state)
@@ -591,7 +685,7 @@ MultiWordForest::get_result(const uint32_t *ctx_words) const
 FastForest::Context::UP
 MultiWordForest::create_context() const
 {
-    return std::make_unique<MultiWordContext>(_words_per_tree * _tree_offsets.size());
+    return std::make_unique<MultiWordContext>(_words_per_tree * _tree_offsets.size(), _mask_sizes.size());
 }
 
 double
@@ -620,6 +714,21 @@ MultiWordForest::eval(Context &context, const float *params) const
     return get_result(ctx_words);
 }
 
+void
+MultiWordForest::eval_batch(Context &context, const float *params, size_t param_stride,
+                            size_t num_docs, double *results) const
+{
+    // masks spanning multiple words are not batched; evaluate one by one
+    float *doc_params = &static_cast<MultiWordContext&>(context).params[0];
+    size_t num_params = _mask_sizes.size();
+    for (size_t i = 0; i < num_docs; ++i) {
+        for (size_t param = 0; param < num_params; ++param) {
+            doc_params[param] = params[(param * param_stride) + i];
+        }
+        results[i] = eval(context, doc_params);
+    }
+}
+
 }
 
 //-----------------------------------------------------------------------------
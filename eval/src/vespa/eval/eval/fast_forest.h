@@ -36,6 +36,24 @@ public:
     virtual vespalib::string impl_name() const = 0;
     virtual Context::UP create_context() const = 0;
     virtual double eval(Context &context, const float *params) const = 0;
+
+    /**
+     * Evaluate the forest for several documents at once. Parameters
+     * are stored per feature; the value of feature 'i' for document
+     * 'j' is found at params[(i * param_stride) + j]. The result for
+     * document 'j' is stored in results[j].
+     **/
+    virtual void eval_batch(Context &context, const float *params, size_t param_stride,
+                            size_t num_docs, double *results) const = 0;
+
+    /**
+     * Whether batch evaluation is expected to be faster than
+     * evaluating documents one by one for this forest. This is the
+     * case when all trees have masks fitting in a single word, which
+     * makes it possible to apply each mask to all documents in the
+     * batch at once.
+     **/
+    virtual bool prefer_batch_eval() const { return false; }
     double estimate_cost_us(const std::vector<double> &params, double budget = 5.0) const;
 };
 
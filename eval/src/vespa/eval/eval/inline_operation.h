@@ -2,8 +2,11 @@
 
 #pragma once
 
+#include "int8float.h"
 #include "operation.h"
+#include <vespa/vespalib/hwaccelrated/iaccelrated.h>
 #include <vespa/vespalib/util/typify.h>
+#include <algorithm>
 #include <cblas.h>
 #include <cmath>
 
@@ -174,6 +177,50 @@ struct DotProduct<double,double> {
     }
 };
 
+template <>
+struct DotProduct<Int8Float,Int8Float> {
+    static double apply(const Int8Float * lhs, const Int8Float * rhs, size_t count) {
+        static_assert(sizeof(Int8Float) == sizeof(int8_t));
+        return hwaccelrated::IAccelrated::getAccelerator().dotProduct(reinterpret_cast<const int8_t *>(lhs),
+                                                                      reinterpret_cast<const int8_t *>(rhs), count);
+    }
+};
+
+// Dot product of float, bfloat16 and int8 cells accumulated in
+// float. Cells that are not float are converted in small blocks that
+// stay in L1 cache, so that the float kernel can be used while only
+// the compact cells are read from memory.
+template <typename LCT, typename RCT>
+struct BlockedFloatDotProduct {
+    static constexpr size_t block_size = 256;
+    static const float *as_float(const float *src, size_t, float *) { return src; }
+    template <typename CT>
+    static const float *as_float(const CT *src, size_t n, float *dst) {
+        for (size_t i = 0; i < n; ++i) {
+            dst[i] = src[i];
+        }
+        return dst;
+    }
+    static float apply(const LCT * lhs, const RCT * rhs, size_t count) {
+        float lhs_block[block_size];
+        float rhs_block[block_size];
+        float result = 0.0;
+        for (size_t pos = 0; pos < count; pos += block_size) {
+            size_t n = std::min(block_size, count - pos);
+            result += cblas_sdot(n, as_float(lhs + pos, n, lhs_block), 1, as_float(rhs + pos, n, rhs_block), 1);
+        }
+        return result;
+    }
+};
+
+template <> struct DotProduct<BFloat16,BFloat16> : BlockedFloatDotProduct<BFloat16,BFloat16> {};
+template <> struct DotProduct<BFloat16,float> : BlockedFloatDotProduct<BFloat16,float> {};
+template <> struct DotProduct<float,BFloat16> : BlockedFloatDotProduct<float,BFloat16> {};
+template <> struct DotProduct<Int8Float,float> : BlockedFloatDotProduct<Int8Float,float> {};
+template <> struct DotProduct<float,Int8Float> : BlockedFloatDotProduct<float,Int8Float> {};
+template <> struct DotProduct<BFloat16,Int8Float> : BlockedFloatDotProduct<BFloat16,Int8Float> {};
+template <> struct DotProduct<Int8Float,BFloat16> : BlockedFloatDotProduct<Int8Float,BFloat16> {};
+
 //-----------------------------------------------------------------------------
 
 }
@@ -1,16 +1,29 @@
 // Copyright Vespa.ai. Licensed under the terms of the Apache 2.0 license. See LICENSE in the project root.
 
 #include "compile_cache.h"
+#include "file_object_cache.h"
 #include <vespa/eval/eval/key_gen.h>
 #include <vespa/vespalib/util/cpu_usage.h>
+#include <filesystem>
 #include <thread>
 
+#include <vespa/log/log.h>
+LOG_SETUP(".eval.eval.llvm.compile_cache");
+
 namespace vespalib::eval {
 
 std::mutex CompileCache::_lock{};
 CompileCache::Map CompileCache::_cached{};
 uint64_t CompileCache::_executor_tag{0};
 std::vector<std::pair<uint64_t,std::shared_ptr<Executor>>> CompileCache::_executor_stack{};
+vespalib::string CompileCache::_object_cache_dir{};
+
+namespace {
+
+// cache files are refreshed each time they are used
+constexpr vespalib::duration object_cache_max_age = std::chrono::hours(24 * 30);
+
+}
 
 const CompiledFunction &
 CompileCache::Value::wait_for_result()
@@ -64,7 +77,8 @@ CompileCache::compile(const Function &function, PassParams pass_params)
             auto res = _cached.emplace(std::move(key), Value::ctor_tag());
             assert(res.second);
             token = std::make_unique<Token>(res.first, Token::ctor_tag());
-            task = std::make_unique<CompileTask>(function, pass_params, res.first->second.result);
+            task = std::make_unique<CompileTask>(function, pass_params, res.first->second.result,
+                                                 res.first->first, _object_cache_dir);
             task = CpuUsage::wrap(std::move(task), CpuUsage::Category::SETUP);
             if (!_executor_stack.empty()) {
                 executor = _executor_stack.back().second;
@@ -101,6 +115,29 @@ CompileCache::wait_pending()
     }
 }
 
+void
+CompileCache::set_object_cache_dir(const vespalib::string &dir)
+{
+    if (!dir.empty()) {
+        std::error_code ec;
+        std::filesystem::create_directories(dir.c_str(), ec);
+        if (ec) {
+            LOG(warning, "could not create object cache directory '%s': %s", dir.c_str(), ec.message().c_str());
+            return;
+        }
+        FileObjectCache::prune(dir, object_cache_max_age);
+    }
+    std::lock_guard<std::mutex> guard(_lock);
+    _object_cache_dir = dir;
+}
+
+vespalib::string
+CompileCache::get_object_cache_dir()
+{
+    std::lock_guard<std::mutex> guard(_lock);
+    return _object_cache_dir;
+}
+
 size_t
 CompileCache::num_cached()
 {
@@ -142,7 +179,13 @@ CompileCache::count_pending()
 void
 CompileCache::CompileTask::run()
 {
-    auto compiled = std::make_unique<CompiledFunction>(*function, pass_params);
+    CompiledFunction::UP compiled;
+    if (object_cache_dir.empty()) {
+        compiled = std::make_unique<CompiledFunction>(*function, pass_params);
+    } else {
+        FileObjectCache object_cache(object_cache_dir, key);
+        compiled = std::make_unique<CompiledFunction>(*function, pass_params, object_cache);
+    }
     std::lock_guard<std::mutex> guard(result->lock);
     result->compiled_function = std::move(compiled);
     result->cf.store(result->compiled_function.get(), std::memory_order_release);
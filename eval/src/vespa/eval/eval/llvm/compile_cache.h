@@ -49,6 +49,7 @@ private:
     static Map _cached;
     static uint64_t _executor_tag;
     static std::vector<std::pair<uint64_t,std::shared_ptr<Executor>>> _executor_stack;
+    static vespalib::string _object_cache_dir;
 
     static void release(Map::iterator entry);
     static uint64_t attach_executor(std::shared_ptr<Executor> executor);
@@ -93,6 +94,13 @@ public:
     static ExecutorBinding::UP bind(std::shared_ptr<Executor> executor) {
         return std::make_unique<ExecutorBinding>(std::move(executor), ExecutorBinding::ctor_tag());
     }
+    // Store machine code for compiled functions in the given
+    // directory, letting functions compiled earlier (also by other
+    // processes) be loaded instead of compiled again. Cache files not
+    // used for a long time are removed. An empty directory name
+    // disables the object cache.
+    static void set_object_cache_dir(const vespalib::string &dir);
+    static vespalib::string get_object_cache_dir();
     static size_t num_cached();
     static size_t num_bound();
     static size_t count_refs();
@@ -103,8 +111,12 @@ private:
         std::shared_ptr<Function const> function;
         PassParams pass_params;
         Result::SP result;
-        CompileTask(const Function &function_in, PassParams pass_params_in, Result::SP result_in)
-            : function(function_in.shared_from_this()), pass_params(pass_params_in), result(std::move(result_in)) {}
+        Key key;
+        vespalib::string object_cache_dir;
+        CompileTask(const Function &function_in, PassParams pass_params_in, Result::SP result_in,
+                    const Key &key_in, const vespalib::string &object_cache_dir_in)
+            : function(function_in.shared_from_this()), pass_params(pass_params_in), result(std::move(result_in)),
+              key(key_in), object_cache_dir(object_cache_dir_in) {}
         void run() override;
     };
 };
@@ -33,7 +33,7 @@ double my_resolve(void *ctx, size_t idx) { return ((double *)ctx)[idx]; }
 } // namespace vespalib::eval::<unnamed>
 
 CompiledFunction::CompiledFunction(const nodes::Node &root_in, size_t num_params_in, PassParams pass_params_in,
-                                   const gbdt::Optimize::Chain &forest_optimizers)
+                                   const gbdt::Optimize::Chain &forest_optimizers, llvm::ObjectCache *object_cache)
     : _llvm_wrapper(),
       _address(nullptr),
       _num_params(num_params_in),
@@ -43,7 +43,11 @@ CompiledFunction::CompiledFunction(const nodes::Node &root_in, size_t num_params
                                             _pass_params,
                                             root_in,
                                             forest_optimizers);
-    _llvm_wrapper.compile();
+    if (object_cache != nullptr) {
+        _llvm_wrapper.compile(*object_cache);
+    } else {
+        _llvm_wrapper.compile();
+    }
     _address = _llvm_wrapper.get_function_address(id);
 }
 
@@ -39,13 +39,19 @@ private:
 public:
     using UP = std::unique_ptr<CompiledFunction>;
     CompiledFunction(const nodes::Node &root_in, size_t num_params_in, PassParams pass_params_in,
-                     const gbdt::Optimize::Chain &forest_optimizers);
+                     const gbdt::Optimize::Chain &forest_optimizers, llvm::ObjectCache *object_cache);
+    CompiledFunction(const nodes::Node &root_in, size_t num_params_in, PassParams pass_params_in,
+                     const gbdt::Optimize::Chain &forest_optimizers)
+        : CompiledFunction(root_in, num_params_in, pass_params_in, forest_optimizers, nullptr) {}
     CompiledFunction(const Function &function_in, PassParams pass_params_in, const gbdt::Optimize::Chain &forest_optimizers)
         : CompiledFunction(function_in.root(), function_in.num_params(), pass_params_in, forest_optimizers) {}
     CompiledFunction(const nodes::Node &root_in, size_t num_params_in, PassParams pass_params_in)
         : CompiledFunction(root_in, num_params_in, pass_params_in, gbdt::Optimize::best) {}
     CompiledFunction(const Function &function_in, PassParams pass_params_in)
         : CompiledFunction(function_in.root(), function_in.num_params(), pass_params_in, gbdt::Optimize::best) {}
+    // machine code is loaded from (or stored in) the given object cache when possible
+    CompiledFunction(const Function &function_in, PassParams pass_params_in, llvm::ObjectCache &object_cache)
+        : CompiledFunction(function_in.root(), function_in.num_params(), pass_params_in, gbdt::Optimize::best, &object_cache) {}
     CompiledFunction(CompiledFunction &&rhs);
     size_t num_params() const { return _num_params; }
     PassParams pass_params() const { return _pass_params; }
@@ -0,0 +1,161 @@
+// Copyright Vespa.ai. Licensed under the terms of the Apache 2.0 license. See LICENSE in the project root.
+
+#include "file_object_cache.h"
+#include <vespa/vespalib/stllike/hash_fun.h>
+#include <vespa/vespalib/util/stringfmt.h>
+#include <llvm/Config/llvm-config.h>
+#include <llvm/ADT/StringMap.h>
+#include <llvm/Support/MemoryBuffer.h>
+#if LLVM_VERSION_MAJOR < 17
+#include <llvm/Support/Host.h>
+#else
+#include <llvm/TargetParser/Host.h>
+#endif
+#include <algorithm>
+#include <cinttypes>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <iterator>
+#include <unistd.h>
+
+#include <vespa/log/log.h>
+LOG_SETUP(".eval.eval.llvm.file_object_cache");
+
+namespace vespalib::eval {
+
+namespace {
+
+constexpr char magic[8] = {'v','e','s','p','a','o','b','j'};
+
+vespalib::string make_host_signature() {
+    vespalib::string signature = LLVM_VERSION_STRING;
+    signature.append(";");
+    signature.append(llvm::sys::getHostCPUName().str());
+    signature.append(";");
+#if LLVM_VERSION_MAJOR < 19
+    llvm::StringMap<bool> features;
+    llvm::sys::getHostCPUFeatures(features);
+#else
+    auto features = llvm::sys::getHostCPUFeatures();
+#endif
+    std::vector<std::string> enabled;
+    for (const auto &feature: features) {
+        if (feature.getValue()) {
+            enabled.push_back(feature.getKey().str());
+        }
+    }
+    std::sort(enabled.begin(), enabled.end());
+    for (const auto &name: enabled) {
+        signature.append(name);
+        signature.append(",");
+    }
+    return signature;
+}
+
+vespalib::string make_key(const vespalib::string &function_key) {
+    vespalib::string key = FileObjectCache::host_signature();
+    key.append(";");
+    key.append(function_key);
+    return key;
+}
+
+vespalib::string make_file_name(const vespalib::string &dir, const vespalib::string &key) {
+    return make_string("%s/%016" PRIx64 ".obj", dir.c_str(), uint64_t(hashValue(key.data(), key.size())));
+}
+
+} // namespace vespalib::eval::<unnamed>
+
+FileObjectCache::FileObjectCache(const vespalib::string &dir, const vespalib::string &function_key)
+    : _file_name(),
+      _key(make_key(function_key)),
+      _loaded(false),
+      _stored(false)
+{
+    _file_name = make_file_name(dir, _key);
+}
+
+FileObjectCache::~FileObjectCache() = default;
+
+void
+FileObjectCache::notifyObjectCompiled(const llvm::Module *, llvm::MemoryBufferRef obj)
+{
+    vespalib::string tmp_name = make_string("%s.%d.tmp", _file_name.c_str(), int(getpid()));
+    {
+        std::ofstream out(tmp_name.c_str(), std::ios::binary | std::ios::trunc);
+        uint64_t key_size = _key.size();
+        out.write(magic, sizeof(magic));
+        out.write(reinterpret_cast<const char *>(&key_size), sizeof(key_size));
+        out.write(_key.data(), _key.size());
+        out.write(obj.getBufferStart(), obj.getBufferSize());
+        out.close();
+        if (!out) {
+            LOG(warning, "could not write compiled function to '%s'", tmp_name.c_str());
+            std::error_code ec;
+            std::filesystem::remove(tmp_name.c_str(), ec);
+            return;
+        }
+    }
+    std::error_code ec;
+    std::filesystem::rename(tmp_name.c_str(), _file_name.c_str(), ec);
+    if (ec) {
+        LOG(warning, "could not rename '%s' to '%s': %s", tmp_name.c_str(), _file_name.c_str(), ec.message().c_str());
+        std::filesystem::remove(tmp_name.c_str(), ec);
+        return;
+    }
+    _stored = true;
+}
+
+std::unique_ptr<llvm::MemoryBuffer>
+FileObjectCache::getObject(const llvm::Module *)
+{
+    std::ifstream in(_file_name.c_str(), std::ios::binary);
+    if (!in) {
+        return {};
+    }
+    std::string content((std::istreambuf_iterator<char>(in)), std::istreambuf_iterator<char>());
+    uint64_t key_size = 0;
+    size_t header_size = sizeof(magic) + sizeof(key_size);
+    if ((content.size() < header_size) || (content.compare(0, sizeof(magic), magic, sizeof(magic)) != 0)) {
+        return {};
+    }
+    memcpy(&key_size, content.data() + sizeof(magic), sizeof(key_size));
+    if ((key_size != _key.size()) || ((content.size() - header_size) <= key_size) ||
+        (content.compare(header_size, key_size, _key.data(), _key.size()) != 0))
+    {
+        return {};
+    }
+    size_t obj_offset = header_size + key_size;
+    std::error_code ec;
+    // refresh modification time to avoid pruning cache files still in use
+    std::filesystem::last_write_time(_file_name.c_str(), std::filesystem::file_time_type::clock::now(), ec);
+    _loaded = true;
+    return llvm::MemoryBuffer::getMemBufferCopy(llvm::StringRef(content.data() + obj_offset, content.size() - obj_offset),
+                                                _file_name.c_str());
+}
+
+const vespalib::string &
+FileObjectCache::host_signature()
+{
+    static const vespalib::string signature = make_host_signature();
+    return signature;
+}
+
+void
+FileObjectCache::prune(const vespalib::string &dir, vespalib::duration max_age)
+{
+    std::error_code ec;
+    auto now = std::filesystem::file_time_type::clock::now();
+    for (const auto &entry: std::filesystem::directory_iterator(dir.c_str(), ec)) {
+        auto ext = entry.path().extension();
+        if (!entry.is_regular_file(ec) || ((ext != ".obj") && (ext != ".tmp"))) {
+            continue;
+        }
+        auto modified = entry.last_write_time(ec);
+        if (!ec && ((now - modified) > max_age)) {
+            std::filesystem::remove(entry.path(), ec);
+        }
+    }
+}
+
+}
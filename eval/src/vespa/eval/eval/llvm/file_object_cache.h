@@ -0,0 +1,48 @@
+// Copyright Vespa.ai. Licensed under the terms of the Apache 2.0 license. See LICENSE in the project root.
+
+#pragma once
+
+#include <vespa/vespalib/stllike/string.h>
+#include <vespa/vespalib/util/time.h>
+#include <llvm/ExecutionEngine/ObjectCache.h>
+
+namespace vespalib::eval {
+
+/**
+ * An LLVM object cache storing the machine code for a single module
+ * in a file. The file starts with the complete key (function key,
+ * LLVM version and host cpu features), which must match for the
+ * object to be used. This way both hash collisions in the file name
+ * and cache files written by other builds or on other hardware will
+ * result in the function being compiled again (replacing the cached
+ * object) instead of loading the wrong machine code.
+ *
+ * Note that machine code containing addresses of objects created
+ * during code generation (like gbdt forests and set membership hash
+ * tables) must never be cached. This is handled by the LLVMWrapper.
+ **/
+class FileObjectCache : public llvm::ObjectCache
+{
+private:
+    vespalib::string _file_name;
+    vespalib::string _key;
+    bool             _loaded;
+    bool             _stored;
+
+public:
+    FileObjectCache(const vespalib::string &dir, const vespalib::string &function_key);
+    ~FileObjectCache() override;
+    void notifyObjectCompiled(const llvm::Module *module, llvm::MemoryBufferRef obj) override;
+    std::unique_ptr<llvm::MemoryBuffer> getObject(const llvm::Module *module) override;
+    const vespalib::string &file_name() const { return _file_name; }
+    bool loaded() const { return _loaded; }
+    bool stored() const { return _stored; }
+
+    // LLVM version and host cpu name and features
+    static const vespalib::string &host_signature();
+
+    // remove cache files in the given directory not used for max_age
+    static void prune(const vespalib::string &dir, vespalib::duration max_age);
+};
+
+}
@@ -712,7 +712,7 @@ LLVMWrapper::make_forest_fragment(size_t num_params, const std::vector<const Nod
 }
 
 void
-LLVMWrapper::compile(llvm::raw_ostream * dumpStream)
+LLVMWrapper::compile(llvm::raw_ostream * dumpStream, llvm::ObjectCache * object_cache)
 {
     if (dumpStream) {
         _module->print(*dumpStream, nullptr);
@@ -720,9 +720,16 @@ LLVMWrapper::compile(llvm::raw_ostream * dumpStream)
     // Set relocation model to silence valgrind on CentOS 8 / aarch64
     _engine.reset(llvm::EngineBuilder(std::move(_module)).setOptLevel(llvm::CodeGenOpt::Aggressive).setRelocationModel(llvm::Reloc::Static).create());
     assert(_engine && "llvm jit not available for your platform");
+    bool use_object_cache = (object_cache != nullptr) && !has_embedded_state();
+    if (use_object_cache) {
+        _engine->setObjectCache(object_cache);
+    }
 
     MallocMmapGuard largeAllocsAsMMap(1_Mi);
     _engine->finalizeObject();
+    if (use_object_cache) {
+        _engine->setObjectCache(nullptr);
+    }
 }
 
 void *
@@ -51,7 +51,7 @@ private:
     std::vector<gbdt::Forest::UP>          _forests;
     std::vector<PluginState::UP>           _plugin_state;
 
-    void compile(llvm::raw_ostream * dumpStream);
+    void compile(llvm::raw_ostream * dumpStream, llvm::ObjectCache * object_cache);
 public:
     LLVMWrapper();
     LLVMWrapper(LLVMWrapper &&rhs) = default;
@@ -60,8 +60,12 @@ public:
                          const gbdt::Optimize::Chain &forest_optimizers);
     size_t make_forest_fragment(size_t num_params, const std::vector<const nodes::Node *> &fragment);
     const std::vector<gbdt::Forest::UP> &get_forests() const { return _forests; }
-    void compile(llvm::raw_ostream & dumpStream) { compile(&dumpStream); }
-    void compile() { compile(nullptr); }
+    // true if the generated code refers to objects owned by this wrapper
+    bool has_embedded_state() const { return (!_forests.empty() || !_plugin_state.empty()); }
+    void compile(llvm::raw_ostream & dumpStream) { compile(&dumpStream, nullptr); }
+    // the object cache is ignored if the generated code has embedded state
+    void compile(llvm::ObjectCache & object_cache) { compile(nullptr, &object_cache); }
+    void compile() { compile(nullptr, nullptr); }
     void *get_function_address(size_t function_id);
     ~LLVMWrapper();
 };
@@ -5,6 +5,7 @@
 #include "simple_value.h"
 
 #include <vespa/eval/instruction/dense_dot_product_function.h>
+#include <vespa/eval/instruction/dense_fused_elementwise_function.h>
 #include <vespa/eval/instruction/sparse_dot_product_function.h>
 #include <vespa/eval/instruction/sparse_112_dot_product.h>
 #include <vespa/eval/instruction/mixed_112_dot_product.h>
@@ -102,6 +103,10 @@ const TensorFunction &optimize_for_factory(const ValueBuilderFactory &, const Te
                               child.set(UniversalDotProduct::optimize(child.get(), stash, false));
                           }
                       });
+    run_optimize_pass(root, [&stash](const Child &child)
+                      {
+                          child.set(DenseFusedElementwiseFunction::optimize(child.get(), stash));
+                      });
     run_optimize_pass(root, [&stash](const Child &child)
                       {
                           child.set(DenseSimpleExpandFunction::optimize(child.get(), stash));
@@ -10,6 +10,7 @@
 #include <vespa/vespalib/util/small_vector.h>
 #include <vespa/vespalib/util/stringfmt.h>
 #include <vespa/vespalib/util/shared_string_repo.h>
+#include <cstring>
 
 using vespalib::make_string_short::fmt;
 
@@ -156,13 +157,34 @@ void decode_mapped_labels(nbostream &input, size_t num_mapped_dims, SmallVector<
     }
 }
 
+template <size_t N> struct CellBits;
+template <> struct CellBits<1> { using type = uint8_t; };
+template <> struct CellBits<2> { using type = uint16_t; };
+template <> struct CellBits<4> { using type = uint32_t; };
+template <> struct CellBits<8> { using type = uint64_t; };
+
 template<typename T>
 void decode_cells(nbostream &input, size_t num_cells, ArrayRef<T> dst)
 {
     assert(num_cells == dst.size());
+    size_t num_bytes = num_cells * sizeof(T);
+    if (input.size() < num_bytes) {
+        for (size_t i = 0; i < num_cells; ++i) {
+            dst[i] = input.readValue<T>();
+        }
+        return;
+    }
+    // Convert all cells straight from the serialized buffer, without
+    // per cell bounds checking, so the compiler can vectorize the loop.
+    using Bits = typename CellBits<sizeof(T)>::type;
+    const char *src = input.peek();
     for (size_t i = 0; i < num_cells; ++i) {
-        dst[i] = input.readValue<T>();
+        Bits bits;
+        memcpy(&bits, src + i * sizeof(T), sizeof(T));
+        bits = nbo::n2h(bits);
+        memcpy(&dst[i], &bits, sizeof(T));
     }
+    input.adjustReadPos(num_bytes);
 }
 
 struct DecodeState {
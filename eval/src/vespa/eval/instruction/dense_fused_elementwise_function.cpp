@@ -0,0 +1,214 @@
+// Copyright Vespa.ai. Licensed under the terms of the Apache 2.0 license. See LICENSE in the project root.
+
+#include "dense_fused_elementwise_function.h"
+#include <vespa/vespalib/objects/objectvisitor.h>
+#include <vespa/eval/eval/value.h>
+#include <vespa/eval/eval/operation.h>
+#include <vespa/eval/eval/inline_operation.h>
+#include <vespa/eval/eval/wrap_param.h>
+#include <vespa/vespalib/util/typify.h>
+#include <array>
+
+namespace vespalib::eval {
+
+using namespace tensor_function;
+using operation::TypifyOp1;
+using operation::TypifyOp2;
+
+using Instruction = InterpretedFunction::Instruction;
+using State = InterpretedFunction::State;
+
+namespace {
+
+struct FusedParam {
+    ValueType res_type;
+    join_fun_t join_fun;
+    map_fun_t map_fun;
+    FusedParam(const ValueType &res_type_in, join_fun_t join_fun_in, map_fun_t map_fun_in)
+        : res_type(res_type_in), join_fun(join_fun_in), map_fun(map_fun_in) {}
+};
+
+struct NoMap {
+    NoMap(map_fun_t) {}
+    template <typename A> A operator()(A a) const { return a; }
+};
+
+struct NoReduce {};
+
+// the join result is rounded to the cell type before being mapped,
+// to produce the same result as the unfused join followed by map
+template <typename CT, typename JoinFun, typename MapFun>
+struct FusedFun {
+    JoinFun join_fun;
+    MapFun map_fun;
+    FusedFun(const FusedParam &param) : join_fun(param.join_fun), map_fun(param.map_fun) {}
+    CT operator()(CT a, CT b) const { return map_fun(CT(join_fun(a, b))); }
+};
+
+template <typename CT, typename AGGR, typename Fun>
+double fused_reduce(const CT *lhs, const CT *rhs, size_t n, const Fun &fun) {
+    if (n >= 4) {
+        std::array<AGGR,4> aggrs = { AGGR(fun(lhs[0], rhs[0])), AGGR(fun(lhs[1], rhs[1])),
+                                     AGGR(fun(lhs[2], rhs[2])), AGGR(fun(lhs[3], rhs[3])) };
+        size_t i = 4;
+        for (; (i + 3) < n; i += 4) {
+            for (size_t j = 0; j < 4; ++j) {
+                aggrs[j].sample(fun(lhs[i + j], rhs[i + j]));
+            }
+        }
+        for (size_t j = 0; (i + j) < n; ++j) {
+            aggrs[j].sample(fun(lhs[i + j], rhs[i + j]));
+        }
+        aggrs[0].merge(aggrs[2]);
+        aggrs[1].merge(aggrs[3]);
+        aggrs[0].merge(aggrs[1]);
+        return aggrs[0].result();
+    }
+    AGGR aggr;
+    for (size_t i = 0; i < n; ++i) {
+        aggr.sample(fun(lhs[i], rhs[i]));
+    }
+    return aggr.result();
+}
+
+template <typename CT, typename JoinFun, typename MapFun, typename Reduce>
+void my_fused_elementwise_op(State &state, uint64_t param_in) {
+    const auto &param = unwrap_param<FusedParam>(param_in);
+    FusedFun<CT,JoinFun,MapFun> fun(param);
+    auto lhs_cells = state.peek(1).cells().typify<CT>();
+    auto rhs_cells = state.peek(0).cells().typify<CT>();
+    size_t n = lhs_cells.size();
+    if constexpr (std::is_same_v<Reduce,NoReduce>) {
+        auto dst_cells = state.stash.create_uninitialized_array<CT>(n);
+        for (size_t i = 0; i < n; ++i) {
+            dst_cells[i] = fun(lhs_cells[i], rhs_cells[i]);
+        }
+        state.pop_pop_push(state.stash.create<DenseValueView>(param.res_type, TypedCells(dst_cells)));
+    } else {
+        double result = fused_reduce<CT,Reduce>(lhs_cells.data(), rhs_cells.data(), n, fun);
+        state.pop_pop_push(state.stash.create<DoubleValue>(result));
+    }
+}
+
+struct TypifyFusedMap {
+    template <typename T> using Result = TypifyResultType<T>;
+    template <typename F> static decltype(auto) resolve(map_fun_t value, F &&f) {
+        if (value == nullptr) {
+            return f(Result<NoMap>());
+        }
+        return TypifyOp1::resolve(value, std::forward<F>(f));
+    }
+};
+
+// full reduce of the (possibly mapped) cells into a double, using the
+// same aggregator cell type as the generic full reduce
+struct TypifyFusedReduce {
+    template <typename T> using Result = TypifyResultType<T>;
+    template <typename F> static decltype(auto) resolve(std::optional<Aggr> value, F &&f) {
+        if (!value.has_value()) {
+            return f(Result<NoReduce>());
+        }
+        switch (value.value()) {
+        case Aggr::SUM: return f(Result<aggr::Sum<double>>());
+        case Aggr::MAX: return f(Result<aggr::Max<double>>());
+        case Aggr::MIN: return f(Result<aggr::Min<double>>());
+        default: break;
+        }
+        abort();
+    }
+};
+
+struct SelectFusedOp {
+    template <typename CT, typename JoinFun, typename MapFun, typename Reduce>
+    static auto invoke() {
+        if constexpr (std::is_same_v<CT,double> || std::is_same_v<CT,float>) {
+            return my_fused_elementwise_op<CT,JoinFun,MapFun,Reduce>;
+        } else {
+            abort();
+            return my_fused_elementwise_op<float,JoinFun,MapFun,Reduce>;
+        }
+    }
+};
+
+using MyTypify = TypifyValue<TypifyCellType,TypifyOp2,TypifyFusedMap,TypifyFusedReduce>;
+
+bool is_fusable_aggr(Aggr aggr) {
+    return ((aggr == Aggr::SUM) || (aggr == Aggr::MAX) || (aggr == Aggr::MIN));
+}
+
+bool is_fusable_join(const Join &join) {
+    const ValueType &lhs_type = join.lhs().result_type();
+    const ValueType &rhs_type = join.rhs().result_type();
+    return (lhs_type.is_dense() && !lhs_type.is_double() &&
+            ((lhs_type.cell_type() == CellType::FLOAT) || (lhs_type.cell_type() == CellType::DOUBLE)) &&
+            (lhs_type == rhs_type));
+}
+
+} // namespace vespalib::eval::<unnamed>
+
+DenseFusedElementwiseFunction::DenseFusedElementwiseFunction(const ValueType &result_type,
+                                                             const TensorFunction &lhs,
+                                                             const TensorFunction &rhs,
+                                                             join_fun_t join_fun,
+                                                             map_fun_t map_fun,
+                                                             std::optional<Aggr> aggr)
+    : Super(result_type, lhs, rhs),
+      _join_fun(join_fun),
+      _map_fun(map_fun),
+      _aggr(aggr)
+{
+}
+
+DenseFusedElementwiseFunction::~DenseFusedElementwiseFunction() = default;
+
+Instruction
+DenseFusedElementwiseFunction::compile_self(const ValueBuilderFactory &, Stash &stash) const
+{
+    const auto &param = stash.create<FusedParam>(result_type(), _join_fun, _map_fun);
+    auto op = typify_invoke<4,MyTypify,SelectFusedOp>(lhs().result_type().cell_type(), _join_fun, _map_fun, _aggr);
+    return Instruction(op, wrap_param<FusedParam>(param));
+}
+
+void
+DenseFusedElementwiseFunction::visit_self(vespalib::ObjectVisitor &visitor) const
+{
+    Super::visit_self(visitor);
+    visitor.visitBool("has_map", (_map_fun != nullptr));
+    visitor.visitBool("has_reduce", _aggr.has_value());
+}
+
+const TensorFunction &
+DenseFusedElementwiseFunction::optimize(const TensorFunction &expr, Stash &stash)
+{
+    if (auto reduce = as<Reduce>(expr)) {
+        if (!expr.result_type().is_double() || !is_fusable_aggr(reduce->aggr())) {
+            return expr;
+        }
+        // the child map(join) may already have been fused on its own
+        if (auto fused = as<DenseFusedElementwiseFunction>(reduce->child())) {
+            if (!fused->aggr().has_value()) {
+                return stash.create<DenseFusedElementwiseFunction>(expr.result_type(), fused->lhs(), fused->rhs(),
+                                                                   fused->join_fun(), fused->map_fun(), reduce->aggr());
+            }
+            return expr;
+        }
+        map_fun_t map_fun = nullptr;
+        const TensorFunction *child = &reduce->child();
+        if (auto map = as<Map>(*child)) {
+            map_fun = map->function();
+            child = &map->child();
+        }
+        if (auto join = as<Join>(*child); join && is_fusable_join(*join)) {
+            return stash.create<DenseFusedElementwiseFunction>(expr.result_type(), join->lhs(), join->rhs(),
+                                                               join->function(), map_fun, reduce->aggr());
+        }
+    } else if (auto map = as<Map>(expr)) {
+        if (auto join = as<Join>(map->child()); join && is_fusable_join(*join)) {
+            return stash.create<DenseFusedElementwiseFunction>(expr.result_type(), join->lhs(), join->rhs(),
+                                                               join->function(), map->function(), std::nullopt);
+        }
+    }
+    return expr;
+}
+
+} // namespace vespalib::eval
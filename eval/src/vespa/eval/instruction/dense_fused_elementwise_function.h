@@ -0,0 +1,46 @@
+// Copyright Vespa.ai. Licensed under the terms of the Apache 2.0 license. See LICENSE in the project root.
+
+#pragma once
+
+#include <vespa/eval/eval/tensor_function.h>
+#include <optional>
+
+namespace vespalib::eval {
+
+/**
+ * Tensor function fusing an elementwise join of two dense tensors
+ * with the same type, an optional map of the join result and an
+ * optional full reduce into a single pass over the input cells:
+ *
+ *   map(join(a,b,f),g)
+ *   reduce(join(a,b,f),aggr)
+ *   reduce(map(join(a,b,f),g),aggr)
+ *
+ * No intermediate tensors are created. Only float and double cells
+ * are supported, and only sum, max and min for the full reduce.
+ **/
+class DenseFusedElementwiseFunction : public tensor_function::Op2
+{
+    using Super = tensor_function::Op2;
+private:
+    tensor_function::join_fun_t _join_fun;
+    tensor_function::map_fun_t  _map_fun;
+    std::optional<Aggr>         _aggr;
+public:
+    DenseFusedElementwiseFunction(const ValueType &result_type,
+                                  const TensorFunction &lhs,
+                                  const TensorFunction &rhs,
+                                  tensor_function::join_fun_t join_fun,
+                                  tensor_function::map_fun_t map_fun,
+                                  std::optional<Aggr> aggr);
+    ~DenseFusedElementwiseFunction() override;
+    tensor_function::join_fun_t join_fun() const { return _join_fun; }
+    tensor_function::map_fun_t map_fun() const { return _map_fun; }
+    std::optional<Aggr> aggr() const { return _aggr; }
+    bool result_is_mutable() const override { return true; }
+    InterpretedFunction::Instruction compile_self(const ValueBuilderFactory &factory, Stash &stash) const override;
+    void visit_self(vespalib::ObjectVisitor &visitor) const override;
+    static const TensorFunction &optimize(const TensorFunction &expr, Stash &stash);
+};
+
+} // namespace vespalib::eval
@@ -1,6 +1,7 @@
 // Copyright Vespa.ai. Licensed under the terms of the Apache 2.0 license. See LICENSE in the project root.
 
 #include "dense_matmul_function.h"
+#include "float_cells.h"
 #include <vespa/vespalib/objects/objectvisitor.h>
 #include <vespa/eval/eval/value.h>
 #include <vespa/eval/eval/operation.h>
@@ -62,8 +63,8 @@ void my_cblas_double_matmul_op(InterpretedFunction::State &state, uint64_t param
 template <bool lhs_common_inner, bool rhs_common_inner>
 void my_cblas_float_matmul_op(InterpretedFunction::State &state, uint64_t param) {
     const DenseMatMulFunction::Self &self = unwrap_param<DenseMatMulFunction::Self>(param);
-    auto lhs_cells = state.peek(1).cells().typify<float>();
-    auto rhs_cells = state.peek(0).cells().typify<float>();
+    auto lhs_cells = get_float_cells(state.peek(1).cells(), state.stash);
+    auto rhs_cells = get_float_cells(state.peek(0).cells(), state.stash);
     auto dst_cells = state.stash.create_array<float>(self.lhs_size * self.rhs_size);
     cblas_sgemm(CblasRowMajor, lhs_common_inner ? CblasNoTrans : CblasTrans, rhs_common_inner ? CblasTrans : CblasNoTrans,
                 self.lhs_size, self.rhs_size, self.common_size, 1.0,
@@ -120,7 +121,7 @@ struct SelectDenseMatmul {
         using OCT = CellValueType<ocm.cell_type>;
         if (std::is_same_v<LCT,double> && std::is_same_v<RCT,double>) {
             return my_cblas_double_matmul_op<LhsCommonInner::value, RhsCommonInner::value>;
-        } else if (std::is_same_v<LCT,float> && std::is_same_v<RCT,float>) {
+        } else if (std::is_same_v<OCT,float>) {
             return my_cblas_float_matmul_op<LhsCommonInner::value, RhsCommonInner::value>;
         } else {
             return my_matmul_op<LCT, RCT, OCT, LhsCommonInner::value, RhsCommonInner::value>;
@@ -1,6 +1,7 @@
 // Copyright Vespa.ai. Licensed under the terms of the Apache 2.0 license. See LICENSE in the project root.
 
 #include "dense_xw_product_function.h"
+#include "float_cells.h"
 #include <vespa/vespalib/objects/objectvisitor.h>
 #include <vespa/eval/eval/value.h>
 #include <vespa/eval/eval/operation.h>
@@ -58,8 +59,8 @@ void my_cblas_double_xw_product_op(InterpretedFunction::State &state, uint64_t p
 template <bool common_inner>
 void my_cblas_float_xw_product_op(InterpretedFunction::State &state, uint64_t param) {
     const DenseXWProductFunction::Self &self = unwrap_param<DenseXWProductFunction::Self>(param);
-    auto vector_cells = state.peek(1).cells().typify<float>();
-    auto matrix_cells = state.peek(0).cells().typify<float>();
+    auto vector_cells = get_float_cells(state.peek(1).cells(), state.stash);
+    auto matrix_cells = get_float_cells(state.peek(0).cells(), state.stash);
     auto dst_cells = state.stash.create_array<float>(self.result_size);
     cblas_sgemv(CblasRowMajor, common_inner ? CblasNoTrans : CblasTrans,
                 common_inner ? self.result_size : self.vector_size,
@@ -107,8 +108,7 @@ struct MyXWProductOp {
         if (std::is_same_v<LCT,double> && std::is_same_v<RCT,double>) {
             assert((std::is_same_v<OCT,double>));
             return my_cblas_double_xw_product_op<CommonInner::value>;
-        } else if (std::is_same_v<LCT,float> && std::is_same_v<RCT,float>) {
-            assert((std::is_same_v<OCT,float>));
+        } else if (std::is_same_v<OCT,float>) {
             return my_cblas_float_xw_product_op<CommonInner::value>;
         } else {
             return my_xw_product_op<LCT, RCT, OCT, CommonInner::value>;
@@ -0,0 +1,37 @@
+// Copyright Vespa.ai. Licensed under the terms of the Apache 2.0 license. See LICENSE in the project root.
+
+#include "float_cells.h"
+#include <cstdlib>
+
+namespace vespalib::eval {
+
+namespace {
+
+template <typename CT>
+ConstArrayRef<float> convert_cells(TypedCells cells, Stash &stash) {
+    auto src = cells.typify<CT>();
+    auto dst = stash.create_uninitialized_array<float>(src.size());
+    for (size_t i = 0; i < src.size(); ++i) {
+        dst[i] = src[i];
+    }
+    return dst;
+}
+
+}
+
+ConstArrayRef<float>
+get_float_cells(TypedCells cells, Stash &stash)
+{
+    switch (cells.type) {
+    case CellType::FLOAT:
+        return cells.typify<float>();
+    case CellType::BFLOAT16:
+        return convert_cells<BFloat16>(cells, stash);
+    case CellType::INT8:
+        return convert_cells<Int8Float>(cells, stash);
+    default:
+        abort();
+    }
+}
+
+}
@@ -0,0 +1,20 @@
+// Copyright Vespa.ai. Licensed under the terms of the Apache 2.0 license. See LICENSE in the project root.
+
+#pragma once
+
+#include <vespa/eval/eval/typed_cells.h>
+#include <vespa/vespalib/util/arrayref.h>
+#include <vespa/vespalib/util/stash.h>
+
+namespace vespalib::eval {
+
+/**
+ * Obtain the given float, bfloat16 or int8 cells as float cells. Float
+ * cells are returned as is, while other cells are converted into an
+ * array allocated in the given stash. This lets functions where each
+ * cell takes part in many multiplications use float kernels, paying
+ * for the conversion only once per cell.
+ **/
+ConstArrayRef<float> get_float_cells(TypedCells cells, Stash &stash);
+
+}
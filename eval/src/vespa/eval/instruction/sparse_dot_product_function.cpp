@@ -4,6 +4,7 @@
 #include "generic_join.h"
 #include <vespa/eval/eval/fast_value.hpp>
 #include <vespa/vespalib/util/typify.h>
+#include <algorithm>
 
 namespace vespalib::eval {
 
@@ -35,6 +36,51 @@ double my_sparse_dot_product_fallback(const Value::Index &lhs_idx, const Value::
     return result;
 }
 
+// Single-dimensional operands that are both large, of similar size and
+// already have their labels in sorted order are joined by merging their
+// label ids instead of probing the hash table of the larger one, replacing
+// random memory access with sequential scans. Sorting the labels on the fly
+// would cost more than the probes it saves. Labels are in insertion order,
+// which matches label id order when values are built from ascending numeric
+// labels of equal width (small numbers have label ids in numeric order).
+// Checking is a sequential scan that bails out early for unsorted labels.
+constexpr size_t MERGE_MIN_SIZE = 1024;
+constexpr size_t MERGE_MAX_SIZE_RATIO = 4;
+
+bool labels_sorted(const StringIdVector &labels) {
+    return std::is_sorted(labels.begin(), labels.end(),
+                          [](string_id a, string_id b) noexcept { return (a.value() < b.value()); });
+}
+
+bool use_sorted_merge(const FastAddrMap &small_map, const FastAddrMap &big_map) {
+    return (small_map.size() >= MERGE_MIN_SIZE) &&
+           (big_map.size() <= small_map.size() * MERGE_MAX_SIZE_RATIO) &&
+           labels_sorted(small_map.labels()) && labels_sorted(big_map.labels());
+}
+
+template <typename CT>
+double my_sorted_merge_sparse_dot_product(const FastAddrMap *lhs_map, const FastAddrMap *rhs_map,
+                                          const CT *lhs_cells, const CT *rhs_cells) __attribute__((noinline));
+template <typename CT>
+double my_sorted_merge_sparse_dot_product(const FastAddrMap *lhs_map, const FastAddrMap *rhs_map,
+                                          const CT *lhs_cells, const CT *rhs_cells)
+{
+    const auto &lhs = lhs_map->labels();
+    const auto &rhs = rhs_map->labels();
+    double result = 0.0;
+    size_t i = 0;
+    size_t j = 0;
+    while ((i < lhs.size()) && (j < rhs.size())) {
+        uint32_t lhs_label = lhs[i].value();
+        uint32_t rhs_label = rhs[j].value();
+        double product = lhs_cells[i] * rhs_cells[j];
+        result += (lhs_label == rhs_label) ? product : 0.0;
+        i += (lhs_label <= rhs_label);
+        j += (rhs_label <= lhs_label);
+    }
+    return result;
+}
+
 template <typename CT, bool single_dim>
 double my_fast_sparse_dot_product(const FastAddrMap *small_map, const FastAddrMap *big_map,
                                   const CT *small_cells, const CT *big_cells)
@@ -45,6 +91,9 @@ double my_fast_sparse_dot_product(const FastAddrMap *small_map, const FastAddrMa
         std::swap(small_cells, big_cells);
     }
     if constexpr (single_dim) {
+        if (use_sorted_merge(*small_map, *big_map)) {
+            return my_sorted_merge_sparse_dot_product<CT>(small_map, big_map, small_cells, big_cells);
+        }
         const auto &labels = small_map->labels();
         for (size_t i = 0; i < labels.size(); ++i) {
             auto big_subspace = big_map->lookup_singledim(labels[i]);
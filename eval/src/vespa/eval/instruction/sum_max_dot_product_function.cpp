@@ -1,6 +1,7 @@
 // Copyright Vespa.ai. Licensed under the terms of the Apache 2.0 license. See LICENSE in the project root.
 
 #include "sum_max_dot_product_function.h"
+#include "float_cells.h"
 #include <vespa/eval/eval/inline_operation.h>
 #include <vespa/eval/eval/value.h>
 
@@ -13,8 +14,8 @@ namespace {
 
 void my_sum_max_dot_product_op(InterpretedFunction::State &state, uint64_t dp_size) {
     double result = 0.0;
-    auto query_cells = state.peek(1).cells().typify<float>();
-    auto document_cells = state.peek(0).cells().typify<float>();
+    auto query_cells = get_float_cells(state.peek(1).cells(), state.stash);
+    auto document_cells = get_float_cells(state.peek(0).cells(), state.stash);
     using dot_product = DotProduct<float,float>;
     if ((query_cells.size() > 0) && (document_cells.size() > 0)) {
         for (const float *query = query_cells.begin(); query < query_cells.end(); query += dp_size) {
@@ -46,12 +47,18 @@ const Join *check_mul(const TensorFunction &expr) {
     return nullptr;
 }
 
+bool is_float_compatible(CellType cell_type) {
+    return ((cell_type == CellType::FLOAT) ||
+            (cell_type == CellType::BFLOAT16) ||
+            (cell_type == CellType::INT8));
+}
+
 bool check_params(const ValueType &res_type, const ValueType &query, const ValueType &document,
                   const vespalib::string &sum_dim, const vespalib::string &max_dim, const vespalib::string &dp_dim)
 {
     if (res_type.is_double() &&
-        (query.dimensions().size() == 2) && (query.cell_type() == CellType::FLOAT) &&
-        (document.dimensions().size() == 2) && (document.cell_type() == CellType::FLOAT))
+        (query.dimensions().size() == 2) && is_float_compatible(query.cell_type()) &&
+        (document.dimensions().size() == 2) && is_float_compatible(document.cell_type()))
     {
         size_t npos = ValueType::Dimension::npos;
         size_t sum_idx = query.dimension_index(sum_dim);
@@ -28,6 +28,9 @@ namespace vespalib::eval {
  * select the maximum result. Sum these partial results into the final
  * result value.
  *
+ * Cells may be float, bfloat16 or int8. Cells that are not float are
+ * converted to float before the dot products are calculated.
+ *
  * Note that not all equivalent forms are matched by this function
  * (initial matching will be very specific).
  **/
@@ -17,13 +17,14 @@ OnnxModelCache::release(Map::iterator entry)
 }
 
 OnnxModelCache::Token::UP
-OnnxModelCache::load(const vespalib::string &model_file)
+OnnxModelCache::load(const vespalib::string &model_file, const Onnx::Options &options)
 {
     std::lock_guard<std::mutex> guard(_lock);
-    auto pos = _cached.find(model_file);
+    Key key(model_file, options);
+    auto pos = _cached.find(key);
     if (pos == _cached.end()) {
-        auto model = std::make_unique<Onnx>(model_file, Onnx::Optimize::ENABLE);
-        auto res = _cached.emplace(model_file, std::move(model));
+        auto model = std::make_unique<Onnx>(model_file, options);
+        auto res = _cached.emplace(std::move(key), std::move(model));
         assert(res.second);
         pos = res.first;
     }
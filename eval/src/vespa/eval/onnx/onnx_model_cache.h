@@ -7,19 +7,23 @@
 #include <memory>
 #include <mutex>
 #include <map>
+#include <utility>
 
 namespace vespalib::eval {
 
 /**
  * Cache used to share loaded onnx models between users. The cache
  * itself will not keep anything alive, but will let you find loaded
- * models that are currently in use by others.
+ * models that are currently in use by others. Models are keyed on
+ * both model file and session options, letting users with the same
+ * options (e.g. rank profiles in different document dbs) share a
+ * single session.
  **/
 class OnnxModelCache
 {
 private:
     struct ctor_tag {};
-    using Key = vespalib::string;
+    using Key = std::pair<vespalib::string,Onnx::Options>;
     struct Value {
         size_t num_refs;
         std::unique_ptr<Onnx> model;
@@ -50,7 +54,10 @@ public:
         ~Token() { OnnxModelCache::release(_entry); }
     };
 
-    static Token::UP load(const vespalib::string &model_file);
+    static Token::UP load(const vespalib::string &model_file, const Onnx::Options &options);
+    static Token::UP load(const vespalib::string &model_file) {
+        return load(model_file, Onnx::Options(Onnx::Optimize::ENABLE));
+    }
     static size_t num_cached();
     static size_t count_refs();
 };
@@ -8,6 +8,7 @@
 #include <vespa/vespalib/util/stringfmt.h>
 #include <vespa/vespalib/util/typify.h>
 #include <vespa/vespalib/util/classname.h>
+#include <optional>
 #include <type_traits>
 
 #include <vespa/log/log.h>
@@ -108,6 +109,17 @@ struct CreateVespaTensor {
     }
 };
 
+struct CreateVespaTensorRowRef {
+    template <typename T> static Value::UP invoke(const ValueType &type_ref, Ort::Value &value, size_t row) {
+        size_t num_cells = type_ref.dense_subspace_size();
+        ConstArrayRef<T> cells(value.GetTensorMutableData<T>() + (row * num_cells), num_cells);
+        return std::make_unique<DenseValueView>(type_ref, TypedCells(cells));
+    }
+    Value::UP operator()(const ValueType &type_ref, Ort::Value &value, size_t row) {
+        return typify_invoke<1,MyTypify,CreateVespaTensorRowRef>(type_ref.cell_type(), type_ref, value, row);
+    }
+};
+
 struct ClearVespaTensor {
     template <typename CT> static void invoke(const Value &value) {
         auto cells = unconstify(value.cells().typify<CT>());
@@ -223,6 +235,20 @@ std::vector<int64_t> extract_sizes(const ValueType &type) {
     return sizes;
 }
 
+std::vector<int64_t> with_batch_size(std::vector<int64_t> sizes, size_t batch_size) {
+    assert(!sizes.empty());
+    sizes[0] = batch_size;
+    return sizes;
+}
+
+size_t inner_size(const std::vector<int64_t> &sizes) {
+    size_t size = 1;
+    for (size_t i = 1; i < sizes.size(); ++i) {
+        size *= sizes[i];
+    }
+    return size;
+}
+
 } // <unnamed>
 
 vespalib::string
@@ -609,11 +635,227 @@ Onnx::EvalContext::get_result(size_t i) const
 
 //-----------------------------------------------------------------------------
 
+template <typename SRC, typename DST>
+void
+Onnx::BatchEvalContext::stack_param(BatchEvalContext &self, size_t slot, size_t idx, const Value &param)
+{
+    auto cells = param.cells().typify<SRC>();
+    size_t n = self._param_sizes[idx];
+    assert(cells.size() == n);
+    const SRC *src = cells.begin();
+    DST *dst = self._param_buffers[idx].GetTensorMutableData<DST>() + (slot * n);
+    for (size_t i = 0; i < n; ++i) {
+        dst[i] = DST(src[i]);
+    }
+}
+
+template <typename SRC, typename DST>
+void
+Onnx::BatchEvalContext::convert_result(BatchEvalContext &self, size_t slot, size_t idx)
+{
+    const auto &cells_ref = (*self._results[(slot * self.num_results()) + idx]).cells();
+    auto cells = unconstify(cells_ref.typify<DST>());
+    size_t n = cells.size();
+    DST *dst = cells.begin();
+    const SRC *src = self._result_buffers[idx].GetTensorMutableData<SRC>() + (slot * n);
+    for (size_t i = 0; i < n; ++i) {
+        dst[i] = DST(src[i]);
+    }
+}
+
+template <typename T>
+Ort::Value
+Onnx::BatchEvalContext::make_view(BatchEvalContext &self, Ort::Value &buffer, const std::vector<int64_t> &sizes)
+{
+    size_t num_cells = sizes[0] * inner_size(sizes);
+    return Ort::Value::CreateTensor<T>(self._cpu_memory, buffer.GetTensorMutableData<T>(), num_cells, sizes.data(), sizes.size());
+}
+
+struct Onnx::BatchEvalContext::SelectStackParam {
+    template <typename ...Ts> static auto invoke() { return stack_param<Ts...>; }
+    auto operator()(CellType ct, Onnx::ElementType et) {
+        return typify_invoke<2,MyTypify,SelectStackParam>(ct, et);
+    }
+};
+
+struct Onnx::BatchEvalContext::SelectConvertResult {
+    template <typename ...Ts> static auto invoke() { return convert_result<Ts...>; }
+    auto operator()(Onnx::ElementType et, CellType ct) {
+        return typify_invoke<2,MyTypify,SelectConvertResult>(et, ct);
+    }
+};
+
+struct Onnx::BatchEvalContext::SelectMakeView {
+    template <typename ...Ts> static auto invoke() { return make_view<Ts...>; }
+    auto operator()(Onnx::ElementType et) {
+        return typify_invoke<1,MyTypify,SelectMakeView>(et);
+    }
+};
+
+bool
+Onnx::BatchEvalContext::can_batch(const Onnx &model, const WireInfo &wire_info)
+{
+    // all inputs and outputs must have a leading dimension of
+    // unknown size (or the same symbolic size) bound to 1
+    std::optional<vespalib::string> batch_dim;
+    auto check = [&batch_dim](const TensorInfo &info, const TensorType &type) {
+        if (info.dimensions.empty() || info.dimensions[0].is_known() ||
+            type.dimensions.empty() || (type.dimensions[0] != 1))
+        {
+            return false;
+        }
+        if (info.dimensions[0].is_symbolic()) {
+            if (batch_dim.has_value() && (batch_dim.value() != info.dimensions[0].name)) {
+                return false;
+            }
+            batch_dim = info.dimensions[0].name;
+        }
+        return true;
+    };
+    for (size_t i = 0; i < model.inputs().size(); ++i) {
+        if (!check(model.inputs()[i], wire_info.onnx_inputs[i])) {
+            return false;
+        }
+    }
+    for (size_t i = 0; i < model.outputs().size(); ++i) {
+        if (!check(model.outputs()[i], wire_info.onnx_outputs[i])) {
+            return false;
+        }
+    }
+    return true;
+}
+
+Onnx::BatchEvalContext::BatchEvalContext(const Onnx &model, const WireInfo &wire_info, size_t max_batch_size)
+    : _model(model),
+      _wire_info(wire_info),
+      _max_batch_size(max_batch_size),
+      _batch_size(0),
+      _cpu_memory(Ort::MemoryInfo::CreateCpu(OrtDeviceAllocator, OrtMemTypeDefault)),
+      _param_buffers(),
+      _result_buffers(),
+      _param_values(),
+      _result_values(),
+      _param_sizes(),
+      _result_sizes(),
+      _results(),
+      _param_binders(),
+      _param_viewers(),
+      _result_viewers(),
+      _result_converters()
+{
+    assert(_max_batch_size > 0);
+    assert(can_batch(_model, _wire_info));
+    size_t num_inputs = _model.inputs().size();
+    size_t num_outputs = _model.outputs().size();
+    for (size_t i = 0; i < num_inputs; ++i) {
+        const auto &vespa = _wire_info.vespa_inputs[i];
+        const auto &onnx = _wire_info.onnx_inputs[i];
+        TensorType batch_type(onnx.elements, with_batch_size(onnx.dimensions, _max_batch_size));
+        _param_buffers.push_back(CreateOnnxTensor()(batch_type, _alloc));
+        _param_sizes.push_back(inner_size(onnx.dimensions));
+        _param_binders.push_back(SelectStackParam()(vespa.cell_type(), onnx.elements));
+        _param_viewers.push_back(SelectMakeView()(onnx.elements));
+    }
+    for (size_t i = 0; i < num_outputs; ++i) {
+        const auto &onnx = _wire_info.onnx_outputs[i];
+        TensorType batch_type(onnx.elements, with_batch_size(onnx.dimensions, _max_batch_size));
+        _result_buffers.push_back(CreateOnnxTensor()(batch_type, _alloc));
+        _result_sizes.push_back(inner_size(onnx.dimensions));
+        _result_viewers.push_back(SelectMakeView()(onnx.elements));
+    }
+    _results.reserve(_max_batch_size * num_outputs);
+    for (size_t slot = 0; slot < _max_batch_size; ++slot) {
+        for (size_t i = 0; i < num_outputs; ++i) {
+            const auto &vespa = _wire_info.vespa_outputs[i];
+            const auto &onnx = _wire_info.onnx_outputs[i];
+            if (is_same_type(vespa.cell_type(), onnx.elements)) {
+                _results.push_back(CreateVespaTensorRowRef()(vespa, _result_buffers[i], slot));
+            } else {
+                _results.push_back(CreateVespaTensor()(vespa));
+            }
+        }
+    }
+    for (size_t i = 0; i < num_outputs; ++i) {
+        const auto &vespa = _wire_info.vespa_outputs[i];
+        const auto &onnx = _wire_info.onnx_outputs[i];
+        if (!is_same_type(vespa.cell_type(), onnx.elements)) {
+            _result_converters.emplace_back(i, SelectConvertResult()(onnx.elements, vespa.cell_type()));
+        }
+    }
+}
+
+Onnx::BatchEvalContext::~BatchEvalContext() = default;
+
+void
+Onnx::BatchEvalContext::prepare_views(size_t batch_size)
+{
+    if (batch_size == _batch_size) {
+        return;
+    }
+    _param_values.clear();
+    _result_values.clear();
+    for (size_t i = 0; i < _param_buffers.size(); ++i) {
+        auto sizes = with_batch_size(_wire_info.onnx_inputs[i].dimensions, batch_size);
+        _param_values.push_back(_param_viewers[i](*this, _param_buffers[i], sizes));
+    }
+    for (size_t i = 0; i < _result_buffers.size(); ++i) {
+        auto sizes = with_batch_size(_wire_info.onnx_outputs[i].dimensions, batch_size);
+        _result_values.push_back(_result_viewers[i](*this, _result_buffers[i], sizes));
+    }
+    _batch_size = batch_size;
+}
+
+void
+Onnx::BatchEvalContext::bind_param(size_t slot, size_t i, const Value &param)
+{
+    assert(slot < _max_batch_size);
+    _param_binders[i](*this, slot, i, param);
+}
+
+void
+Onnx::BatchEvalContext::eval(size_t batch_size)
+{
+    assert((batch_size > 0) && (batch_size <= _max_batch_size));
+    prepare_views(batch_size);
+    auto &session = const_cast<Ort::Session&>(_model._session);
+    Ort::RunOptions run_opts(nullptr);
+    session.Run(run_opts,
+                _model._input_name_refs.data(), _param_values.data(), _param_values.size(),
+                _model._output_name_refs.data(), _result_values.data(), _result_values.size());
+    for (const auto &entry: _result_converters) {
+        for (size_t slot = 0; slot < batch_size; ++slot) {
+            entry.second(*this, slot, entry.first);
+        }
+    }
+}
+
+const Value &
+Onnx::BatchEvalContext::get_result(size_t slot, size_t i) const
+{
+    return *_results[(slot * num_results()) + i];
+}
+
+//-----------------------------------------------------------------------------
+
 Ort::AllocatorWithDefaultOptions Onnx::_alloc;
 
 Onnx::Shared::Shared()
-    : _env(ORT_LOGGING_LEVEL_WARNING, "vespa-onnx-wrapper")
+    : _env(ORT_LOGGING_LEVEL_WARNING, "vespa-onnx-wrapper"),
+      _lock(),
+      _arena_registered(false)
+{
+}
+
+void
+Onnx::Shared::register_shared_arena()
 {
+    std::lock_guard<std::mutex> guard(_lock);
+    if (!_arena_registered) {
+        Ort::MemoryInfo memory_info = Ort::MemoryInfo::CreateCpu(OrtArenaAllocator, OrtMemTypeDefault);
+        Ort::ArenaCfg arena_cfg(0, -1, -1, -1); // use onnxruntime defaults
+        _env.CreateAndRegisterAllocator(memory_info, arena_cfg);
+        _arena_registered = true;
+    }
 }
 
 Onnx::Shared &
@@ -651,6 +893,11 @@ Onnx::extract_meta_data()
 }
 
 Onnx::Onnx(const vespalib::string &model_file, Optimize optimize)
+    : Onnx(model_file, Options(optimize))
+{
+}
+
+Onnx::Onnx(const vespalib::string &model_file, const Options &options)
     : _shared(Shared::get()),
       _options(),
       _session(nullptr),
@@ -659,10 +906,15 @@ Onnx::Onnx(const vespalib::string &model_file, Optimize optimize)
       _input_name_refs(),
       _output_name_refs()
 {
-    _options.SetIntraOpNumThreads(1);
+    _options.SetIntraOpNumThreads(options.intra_op_threads);
     _options.SetInterOpNumThreads(1);
-    _options.SetGraphOptimizationLevel(convert_optimize(optimize));
-    _options.DisableCpuMemArena();
+    _options.SetGraphOptimizationLevel(convert_optimize(options.optimize));
+    if (options.shared_arena) {
+        _shared.register_shared_arena();
+        _options.AddConfigEntry("session.use_env_allocators", "1");
+    } else {
+        _options.DisableCpuMemArena();
+    }
     _session = Ort::Session(_shared.env(), model_file.c_str(), _options);
     extract_meta_data();
 }
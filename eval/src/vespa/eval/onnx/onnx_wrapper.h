@@ -6,6 +6,9 @@
 #include <vespa/vespalib/stllike/string.h>
 #include <vespa/eval/eval/value_type.h>
 #include <vespa/eval/eval/value.h>
+#include <algorithm>
+#include <compare>
+#include <mutex>
 #include <vector>
 #include <map>
 #include <set>
@@ -34,6 +37,19 @@ public:
     // model optimization
     enum class Optimize { ENABLE, DISABLE };
 
+    // options used when creating the model session; models loaded
+    // with equal options may share a single session
+    struct Options {
+        Optimize optimize;
+        uint32_t intra_op_threads;
+        bool     shared_arena;
+        Options(Optimize optimize_in) noexcept
+          : optimize(optimize_in), intra_op_threads(1), shared_arena(false) {}
+        Options &set_intra_op_threads(uint32_t value) { intra_op_threads = std::max(value, 1u); return *this; }
+        Options &set_shared_arena(bool value) { shared_arena = value; return *this; }
+        auto operator<=>(const Options &) const = default;
+    };
+
     // the size of a dimension
     struct DimSize {
         size_t value;
@@ -137,15 +153,78 @@ public:
         const Value &get_result(size_t i) const;
     };
 
+    // evaluation context running multiple evaluations in a single
+    // session run by stacking their inputs along the first (batch)
+    // dimension of the model. The wire info describes a single
+    // evaluation, with the batch dimension bound to size 1 for all
+    // inputs and outputs (see can_batch). Parameters are bound per
+    // batch slot; results for a slot are valid until the next eval.
+    class BatchEvalContext {
+    private:
+        using param_fun_t = void (*)(BatchEvalContext &, size_t slot, size_t i, const Value &);
+        using result_fun_t = void (*)(BatchEvalContext &, size_t slot, size_t i);
+        using view_fun_t = Ort::Value (*)(BatchEvalContext &, Ort::Value &, const std::vector<int64_t> &);
+
+        const Onnx                  &_model;
+        const WireInfo              &_wire_info;
+        size_t                       _max_batch_size;
+        size_t                       _batch_size;
+        Ort::MemoryInfo              _cpu_memory;
+        std::vector<Ort::Value>      _param_buffers;
+        std::vector<Ort::Value>      _result_buffers;
+        std::vector<Ort::Value>      _param_values;
+        std::vector<Ort::Value>      _result_values;
+        std::vector<size_t>          _param_sizes;
+        std::vector<size_t>          _result_sizes;
+        std::vector<Value::UP>       _results;
+        std::vector<param_fun_t>     _param_binders;
+        std::vector<view_fun_t>      _param_viewers;
+        std::vector<view_fun_t>      _result_viewers;
+        std::vector<std::pair<size_t,result_fun_t>> _result_converters;
+
+        template <typename SRC, typename DST>
+        static void stack_param(BatchEvalContext &self, size_t slot, size_t idx, const Value &param);
+
+        template <typename SRC, typename DST>
+        static void convert_result(BatchEvalContext &self, size_t slot, size_t idx);
+
+        template <typename T>
+        static Ort::Value make_view(BatchEvalContext &self, Ort::Value &buffer, const std::vector<int64_t> &sizes);
+
+        void prepare_views(size_t batch_size);
+
+    public:
+        struct SelectStackParam;
+        struct SelectConvertResult;
+        struct SelectMakeView;
+
+        // check if the model can be evaluated in batches with the given wiring
+        static bool can_batch(const Onnx &model, const WireInfo &wire_info);
+
+        BatchEvalContext(const Onnx &model, const WireInfo &wire_info, size_t max_batch_size);
+        ~BatchEvalContext();
+        size_t max_batch_size() const { return _max_batch_size; }
+        size_t num_params() const { return _param_buffers.size(); }
+        size_t num_results() const { return _result_buffers.size(); }
+        void bind_param(size_t slot, size_t i, const Value &param);
+        void eval(size_t batch_size);
+        const Value &get_result(size_t slot, size_t i) const;
+    };
+
 private:
     // common stuff shared between model sessions
     class Shared {
     private:
-        Ort::Env _env;
+        Ort::Env   _env;
+        std::mutex _lock;
+        bool       _arena_registered;
         Shared();
     public:
         static Shared &get();
         Ort::Env &env() { return _env; }
+        // register a cpu arena allocator in the env, to be used by
+        // all sessions created with Options::shared_arena
+        void register_shared_arena();
     };
 
     static Ort::AllocatorWithDefaultOptions _alloc;
@@ -162,6 +241,7 @@ private:
 
 public:
     Onnx(const vespalib::string &model_file, Optimize optimize);
+    Onnx(const vespalib::string &model_file, const Options &options);
     ~Onnx();
     const std::vector<TensorInfo> &inputs() const { return _inputs; }
     const std::vector<TensorInfo> &outputs() const { return _outputs; }
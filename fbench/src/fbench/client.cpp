@@ -11,14 +11,16 @@
 
 using namespace vespalib;
 
-Client::Client(vespalib::CryptoEngine::SP engine, std::unique_ptr<ClientArguments> args)
+Client::Client(vespalib::CryptoEngine::SP engine, std::unique_ptr<ClientArguments> args,
+               std::shared_ptr<HTTP2Connection> http2)
     : _args(std::move(args)),
       _status(std::make_unique<ClientStatus>()),
       _reqTimer(std::make_unique<Timer>()),
       _cycleTimer(std::make_unique<Timer>()),
       _masterTimer(std::make_unique<Timer>()),
       _http(std::make_unique<HTTPClient>(std::move(engine), _args->_hostname, _args->_port, _args->_keepAlive,
-                                         _args->_headerBenchmarkdataCoverage, _args->_extraHeaders, _args->_authority)),
+                                         _args->_headerBenchmarkdataCoverage, _args->_extraHeaders, _args->_authority,
+                                         std::move(http2))),
       _reader(std::make_unique<FileReader>()),
       _output(),
       _linebufsize(_args->_maxLineSize),
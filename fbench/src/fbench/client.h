@@ -154,6 +154,7 @@ private:
 
 class Timer;
 class HTTPClient;
+class HTTP2Connection;
 class FileReader;
 struct ClientStatus;
 /**
@@ -186,9 +187,11 @@ public:
     using UP = std::unique_ptr<Client>;
     /**
      * The client arguments given to this method becomes the
-     * responsibility of the client.
+     * responsibility of the client. If a HTTP/2 connection is given,
+     * requests are sent as streams on it instead of using HTTP 1.1.
      **/
-    Client(vespalib::CryptoEngine::SP engine, std::unique_ptr<ClientArguments> args);
+    Client(vespalib::CryptoEngine::SP engine, std::unique_ptr<ClientArguments> args,
+           std::shared_ptr<HTTP2Connection> http2 = {});
     Client(const Client &) = delete;
     Client &operator=(const Client &) = delete;
 
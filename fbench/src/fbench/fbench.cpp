@@ -5,6 +5,7 @@
 
 #include <util/timer.h>
 #include <httpclient/httpclient.h>
+#include <httpclient/http2connection.h>
 #include <util/filereader.h>
 #include <util/clientstatus.h>
 #include <vespa/vespalib/crypto/crypto_exception.h>
@@ -18,6 +19,7 @@
 #include <csignal>
 #include <cinttypes>
 #include <cstdlib>
+#include <map>
 #include <unistd.h>
 
 namespace {
@@ -55,7 +57,8 @@ FBench::FBench()
       _usePostMode(false),
       _headerBenchmarkdataCoverage(false),
       _seconds(60),
-      _singleQueryFile(false)
+      _singleQueryFile(false),
+      _http2Streams(0)
 {
 }
 
@@ -117,7 +120,7 @@ FBench::InitBenchmark(int numClients, int ignoreCount, int cycle,
                       bool keepAlive, bool base64Decode,
                       bool headerBenchmarkdataCoverage, int seconds,
                       bool singleQueryFile, const std::string & queryStringToAppend, const std::string & extraHeaders,
-                      const std::string &authority, bool postMode)
+                      const std::string &authority, bool postMode, int http2Streams)
 {
     _clients.resize(numClients);
     _ignoreCount     = ignoreCount;
@@ -142,6 +145,7 @@ FBench::InitBenchmark(int numClients, int ignoreCount, int cycle,
     _headerBenchmarkdataCoverage = headerBenchmarkdataCoverage;
     _seconds = seconds;
     _singleQueryFile = singleQueryFile;
+    _http2Streams    = http2Streams;
 }
 
 void
@@ -149,6 +153,9 @@ FBench::CreateClients()
 {
     int spread = (_cycle > 1) ? _cycle : 1;
 
+    // with HTTP/2, consecutive clients using the same host share a
+    // connection, each client being one of its concurrent streams.
+    std::map<std::pair<size_t, size_t>, std::shared_ptr<HTTP2Connection>> http2Connections;
     int i(0);
     for(auto & client : _clients) {
         uint64_t off_beg = 0;
@@ -157,13 +164,24 @@ FBench::CreateClients()
             off_beg = _queryfileOffset[i];
             off_end = _queryfileOffset[i+1];
         }
+        std::shared_ptr<HTTP2Connection> http2;
+        if (_http2Streams > 0) {
+            size_t host = i % _hostnames.size();
+            size_t group = (i / _hostnames.size()) / _http2Streams;
+            auto &conn = http2Connections[std::make_pair(host, group)];
+            if (!conn) {
+                conn = std::make_shared<HTTP2Connection>(_hostnames[host].c_str(), _ports[host]);
+            }
+            http2 = conn;
+        }
         client = std::make_unique<Client>(_crypto_engine,
             std::make_unique<ClientArguments>(i, _filenamePattern, _outputPattern,
                                               _hostnames[i % _hostnames.size()].c_str(),
                                               _ports[i % _ports.size()], _cycle,random() % spread,
                                               _ignoreCount, _byteLimit, _restartLimit, _maxLineSize, _keepAlive,
                                               _base64Decode, _headerBenchmarkdataCoverage, off_beg, off_end,
-                                              _singleQueryFile, _queryStringToAppend, _extraHeaders, _authority, _usePostMode));
+                                              _singleQueryFile, _queryStringToAppend, _extraHeaders, _authority, _usePostMode),
+            std::move(http2));
         ++i;
     }
 }
@@ -255,6 +273,9 @@ FBench::PrintSummary()
     if (_keepAlive) {
         printf("*** HTTP keep-alive statistics ***\n");
         printf("connection reuse count -- %" PRIu64 "\n", status._reuseCnt);
+        if (_http2Streams > 0) {
+            printf("http/2 streams per connection -- %d\n", _http2Streams);
+        }
     }
     printf("***************** Benchmark Summary *****************\n");
     printf("clients:                %8ld\n", _clients.size());
@@ -293,7 +314,7 @@ FBench::Usage()
 {
     printf("usage: vespa-fbench [-H extraHeader] [-a queryStringToAppend ] [-n numClients] [-c cycleTime] [-l limit] [-i ignoreCount]\n");
     printf("              [-s seconds] [-q queryFilePattern] [-o outputFilePattern]\n");
-    printf("              [-r restartLimit] [-m maxLineSize] [-k] <hostname> <port>\n\n");
+    printf("              [-r restartLimit] [-m maxLineSize] [-k] [-2 streams] <hostname> <port>\n\n");
     printf(" -H <str> : append extra header to each get request.\n");
     printf(" -A <str> : assign authority.  <str> should be hostname:port format. Overrides Host: header sent.\n");
     printf(" -P       : use POST for requests instead of GET.\n");
@@ -313,6 +334,8 @@ FBench::Usage()
     printf("            Can not be less than the minimum [1024].\n");
     printf(" -p <num> : print summary every <num> seconds.\n");
     printf(" -k       : disable HTTP keep-alive.\n");
+    printf(" -2 <num> : use HTTP/2 over cleartext (h2c, prior knowledge) with up to\n");
+    printf("            <num> clients sharing each connection as concurrent streams.\n");
     printf(" -d       : Base64 decode POST request content.\n");
     printf(" -y       : write data on coverage to output file.\n");
     printf(" -z       : use single query file to be distributed between clients.\n");
@@ -366,6 +389,7 @@ FBench::Main(int argc, char *argv[])
     std::string authority;
 
     int  printInterval = 0;
+    int  http2Streams = 0;
 
     // parse options and override defaults.
     int         opt;
@@ -373,7 +397,7 @@ FBench::Main(int argc, char *argv[])
 
     optError = false;
     std::string content_type = "Content-type:application/json";
-    while((opt = getopt(argc, argv, "H:A:T:C:K:Da:n:c:l:i:s:q:o:r:m:p:kdxyzP")) != -1) {
+    while((opt = getopt(argc, argv, "H:A:T:C:K:Da:n:c:l:i:s:q:o:r:m:p:kdxyzP2:")) != -1) {
         switch(opt) {
         case 'A':
             authority = optarg;
@@ -445,6 +469,11 @@ FBench::Main(int argc, char *argv[])
         case 'k':
             keepAlive = false;
             break;
+        case '2':
+            http2Streams = atoi(optarg);
+            if (http2Streams <= 0)
+                optError = true;
+            break;
         case 'd':
             base64Decode = true;
             break;
@@ -482,6 +511,16 @@ FBench::Main(int argc, char *argv[])
         fprintf(stderr, "failed to initialize crypto engine\n");
         return -1;
     }
+    if (http2Streams > 0) {
+        if (_crypto_engine->use_tls_when_client()) {
+            fprintf(stderr, "HTTP/2 (-2) is only supported without TLS (h2c)\n");
+            return -1;
+        }
+        if (!keepAlive) {
+            fprintf(stderr, "HTTP/2 (-2) can not be combined with disabling keep-alive (-k)\n");
+            return -1;
+        }
+    }
 
     short hosts = args / 2;
 
@@ -540,7 +579,7 @@ FBench::Main(int argc, char *argv[])
                   keepAlive, base64Decode,
                   headerBenchmarkdataCoverage, seconds,
                   singleQueryFile, queryStringToAppend, extraHeaders,
-                  authority, usePostMode);
+                  authority, usePostMode, http2Streams);
 
     CreateClients();
     StartClients();
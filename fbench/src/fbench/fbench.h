@@ -39,6 +39,7 @@ private:
     std::string              _queryStringToAppend;
     std::string              _extraHeaders;
     std::string              _authority;
+    int                      _http2Streams;
 
     bool init_crypto_engine(const std::string &ca_certs_file_name,
                             const std::string &cert_chain_file_name,
@@ -51,7 +52,7 @@ private:
                        bool keepAlive, bool base64Decode,
                        bool headerBenchmarkdataCoverage, int seconds,
                        bool singleQueryFile, const std::string & queryStringToAppend, const std::string & extraHeaders,
-                       const std::string &authority, bool postMode);
+                       const std::string &authority, bool postMode, int http2Streams);
 
     void CreateClients();
     void StartClients();
@@ -0,0 +1,419 @@
+// Copyright Vespa.ai. Licensed under the terms of the Apache 2.0 license. See LICENSE in the project root.
+#include "hpack.h"
+#include <algorithm>
+#include <array>
+
+namespace hpack {
+
+namespace {
+
+struct StaticEntry {
+    const char *name;
+    const char *value;
+};
+
+// RFC 7541 Appendix A
+const StaticEntry static_table[] = {
+    {":authority", ""},
+    {":method", "GET"},
+    {":method", "POST"},
+    {":path", "/"},
+    {":path", "/index.html"},
+    {":scheme", "http"},
+    {":scheme", "https"},
+    {":status", "200"},
+    {":status", "204"},
+    {":status", "206"},
+    {":status", "304"},
+    {":status", "400"},
+    {":status", "404"},
+    {":status", "500"},
+    {"accept-charset", ""},
+    {"accept-encoding", "gzip, deflate"},
+    {"accept-language", ""},
+    {"accept-ranges", ""},
+    {"accept", ""},
+    {"access-control-allow-origin", ""},
+    {"age", ""},
+    {"allow", ""},
+    {"authorization", ""},
+    {"cache-control", ""},
+    {"content-disposition", ""},
+    {"content-encoding", ""},
+    {"content-language", ""},
+    {"content-length", ""},
+    {"content-location", ""},
+    {"content-range", ""},
+    {"content-type", ""},
+    {"cookie", ""},
+    {"date", ""},
+    {"etag", ""},
+    {"expect", ""},
+    {"expires", ""},
+    {"from", ""},
+    {"host", ""},
+    {"if-match", ""},
+    {"if-modified-since", ""},
+    {"if-none-match", ""},
+    {"if-range", ""},
+    {"if-unmodified-since", ""},
+    {"last-modified", ""},
+    {"link", ""},
+    {"location", ""},
+    {"max-forwards", ""},
+    {"proxy-authenticate", ""},
+    {"proxy-authorization", ""},
+    {"range", ""},
+    {"referer", ""},
+    {"refresh", ""},
+    {"retry-after", ""},
+    {"server", ""},
+    {"set-cookie", ""},
+    {"strict-transport-security", ""},
+    {"transfer-encoding", ""},
+    {"user-agent", ""},
+    {"vary", ""},
+    {"via", ""},
+    {"www-authenticate", ""},
+};
+constexpr uint64_t static_table_size = sizeof(static_table) / sizeof(static_table[0]);
+
+struct HuffmanCode {
+    uint32_t code;
+    uint32_t bits;
+};
+
+// RFC 7541 Appendix B, indexed by symbol (256 is EOS)
+const HuffmanCode huffman_codes[257] = {
+    {0x00001ff8, 13}, {0x007fffd8, 23}, {0x0fffffe2, 28}, {0x0fffffe3, 28},
+    {0x0fffffe4, 28}, {0x0fffffe5, 28}, {0x0fffffe6, 28}, {0x0fffffe7, 28},
+    {0x0fffffe8, 28}, {0x00ffffea, 24}, {0x3ffffffc, 30}, {0x0fffffe9, 28},
+    {0x0fffffea, 28}, {0x3ffffffd, 30}, {0x0fffffeb, 28}, {0x0fffffec, 28},
+    {0x0fffffed, 28}, {0x0fffffee, 28}, {0x0fffffef, 28}, {0x0ffffff0, 28},
+    {0x0ffffff1, 28}, {0x0ffffff2, 28}, {0x3ffffffe, 30}, {0x0ffffff3, 28},
+    {0x0ffffff4, 28}, {0x0ffffff5, 28}, {0x0ffffff6, 28}, {0x0ffffff7, 28},
+    {0x0ffffff8, 28}, {0x0ffffff9, 28}, {0x0ffffffa, 28}, {0x0ffffffb, 28},
+    {0x00000014,  6}, {0x000003f8, 10}, {0x000003f9, 10}, {0x00000ffa, 12},
+    {0x00001ff9, 13}, {0x00000015,  6}, {0x000000f8,  8}, {0x000007fa, 11},
+    {0x000003fa, 10}, {0x000003fb, 10}, {0x000000f9,  8}, {0x000007fb, 11},
+    {0x000000fa,  8}, {0x00000016,  6}, {0x00000017,  6}, {0x00000018,  6},
+    {0x00000000,  5}, {0x00000001,  5}, {0x00000002,  5}, {0x00000019,  6},
+    {0x0000001a,  6}, {0x0000001b,  6}, {0x0000001c,  6}, {0x0000001d,  6},
+    {0x0000001e,  6}, {0x0000001f,  6}, {0x0000005c,  7}, {0x000000fb,  8},
+    {0x00007ffc, 15}, {0x00000020,  6}, {0x00000ffb, 12}, {0x000003fc, 10},
+    {0x00001ffa, 13}, {0x00000021,  6}, {0x0000005d,  7}, {0x0000005e,  7},
+    {0x0000005f,  7}, {0x00000060,  7}, {0x00000061,  7}, {0x00000062,  7},
+    {0x00000063,  7}, {0x00000064,  7}, {0x00000065,  7}, {0x00000066,  7},
+    {0x00000067,  7}, {0x00000068,  7}, {0x00000069,  7}, {0x0000006a,  7},
+    {0x0000006b,  7}, {0x0000006c,  7}, {0x0000006d,  7}, {0x0000006e,  7},
+    {0x0000006f,  7}, {0x00000070,  7}, {0x00000071,  7}, {0x00000072,  7},
+    {0x000000fc,  8}, {0x00000073,  7}, {0x000000fd,  8}, {0x00001ffb, 13},
+    {0x0007fff0, 19}, {0x00001ffc, 13}, {0x00003ffc, 14}, {0x00000022,  6},
+    {0x00007ffd, 15}, {0x00000003,  5}, {0x00000023,  6}, {0x00000004,  5},
+    {0x00000024,  6}, {0x00000005,  5}, {0x00000025,  6}, {0x00000026,  6},
+    {0x00000027,  6}, {0x00000006,  5}, {0x00000074,  7}, {0x00000075,  7},
+    {0x00000028,  6}, {0x00000029,  6}, {0x0000002a,  6}, {0x00000007,  5},
+    {0x0000002b,  6}, {0x00000076,  7}, {0x0000002c,  6}, {0x00000008,  5},
+    {0x00000009,  5}, {0x0000002d,  6}, {0x00000077,  7}, {0x00000078,  7},
+    {0x00000079,  7}, {0x0000007a,  7}, {0x0000007b,  7}, {0x00007ffe, 15},
+    {0x000007fc, 11}, {0x00003ffd, 14}, {0x00001ffd, 13}, {0x0ffffffc, 28},
+    {0x000fffe6, 20}, {0x003fffd2, 22}, {0x000fffe7, 20}, {0x000fffe8, 20},
+    {0x003fffd3, 22}, {0x003fffd4, 22}, {0x003fffd5, 22}, {0x007fffd9, 23},
+    {0x003fffd6, 22}, {0x007fffda, 23}, {0x007fffdb, 23}, {0x007fffdc, 23},
+    {0x007fffdd, 23}, {0x007fffde, 23}, {0x00ffffeb, 24}, {0x007fffdf, 23},
+    {0x00ffffec, 24}, {0x00ffffed, 24}, {0x003fffd7, 22}, {0x007fffe0, 23},
+    {0x00ffffee, 24}, {0x007fffe1, 23}, {0x007fffe2, 23}, {0x007fffe3, 23},
+    {0x007fffe4, 23}, {0x001fffdc, 21}, {0x003fffd8, 22}, {0x007fffe5, 23},
+    {0x003fffd9, 22}, {0x007fffe6, 23}, {0x007fffe7, 23}, {0x00ffffef, 24},
+    {0x003fffda, 22}, {0x001fffdd, 21}, {0x000fffe9, 20}, {0x003fffdb, 22},
+    {0x003fffdc, 22}, {0x007fffe8, 23}, {0x007fffe9, 23}, {0x001fffde, 21},
+    {0x007fffea, 23}, {0x003fffdd, 22}, {0x003fffde, 22}, {0x00fffff0, 24},
+    {0x001fffdf, 21}, {0x003fffdf, 22}, {0x007fffeb, 23}, {0x007fffec, 23},
+    {0x001fffe0, 21}, {0x001fffe1, 21}, {0x003fffe0, 22}, {0x001fffe2, 21},
+    {0x007fffed, 23}, {0x003fffe1, 22}, {0x007fffee, 23}, {0x007fffef, 23},
+    {0x000fffea, 20}, {0x003fffe2, 22}, {0x003fffe3, 22}, {0x003fffe4, 22},
+    {0x007ffff0, 23}, {0x003fffe5, 22}, {0x003fffe6, 22}, {0x007ffff1, 23},
+    {0x03ffffe0, 26}, {0x03ffffe1, 26}, {0x000fffeb, 20}, {0x0007fff1, 19},
+    {0x003fffe7, 22}, {0x007ffff2, 23}, {0x003fffe8, 22}, {0x01ffffec, 25},
+    {0x03ffffe2, 26}, {0x03ffffe3, 26}, {0x03ffffe4, 26}, {0x07ffffde, 27},
+    {0x07ffffdf, 27}, {0x03ffffe5, 26}, {0x00fffff1, 24}, {0x01ffffed, 25},
+    {0x0007fff2, 19}, {0x001fffe3, 21}, {0x03ffffe6, 26}, {0x07ffffe0, 27},
+    {0x07ffffe1, 27}, {0x03ffffe7, 26}, {0x07ffffe2, 27}, {0x00fffff2, 24},
+    {0x001fffe4, 21}, {0x001fffe5, 21}, {0x03ffffe8, 26}, {0x03ffffe9, 26},
+    {0x0ffffffd, 28}, {0x07ffffe3, 27}, {0x07ffffe4, 27}, {0x07ffffe5, 27},
+    {0x000fffec, 20}, {0x00fffff3, 24}, {0x000fffed, 20}, {0x001fffe6, 21},
+    {0x003fffe9, 22}, {0x001fffe7, 21}, {0x001fffe8, 21}, {0x007ffff3, 23},
+    {0x003fffea, 22}, {0x003fffeb, 22}, {0x01ffffee, 25}, {0x01ffffef, 25},
+    {0x00fffff4, 24}, {0x00fffff5, 24}, {0x03ffffea, 26}, {0x007ffff4, 23},
+    {0x03ffffeb, 26}, {0x07ffffe6, 27}, {0x03ffffec, 26}, {0x03ffffed, 26},
+    {0x07ffffe7, 27}, {0x07ffffe8, 27}, {0x07ffffe9, 27}, {0x07ffffea, 27},
+    {0x07ffffeb, 27}, {0x0ffffffe, 28}, {0x07ffffec, 27}, {0x07ffffed, 27},
+    {0x07ffffee, 27}, {0x07ffffef, 27}, {0x07fffff0, 27}, {0x03ffffee, 26},
+    {0x3fffffff, 30},
+};
+
+constexpr uint32_t huffman_max_bits = 30;
+constexpr uint32_t huffman_eos = 256;
+
+/**
+ * The HPACK Huffman code is canonical; codes of the same length are
+ * consecutive when symbols are sorted by (length, symbol). This
+ * allows decoding one bit at a time using only the first code and
+ * the number of codes for each length.
+ **/
+struct HuffmanDecodeTable {
+    std::array<uint32_t, huffman_max_bits + 1> first_code;
+    std::array<uint32_t, huffman_max_bits + 1> first_index;
+    std::array<uint32_t, huffman_max_bits + 1> count;
+    std::array<uint16_t, 257> symbols;
+    HuffmanDecodeTable() : first_code(), first_index(), count(), symbols() {
+        for (uint32_t i = 0; i < 257; ++i) {
+            symbols[i] = i;
+        }
+        std::sort(symbols.begin(), symbols.end(), [](uint16_t a, uint16_t b) {
+                      return (huffman_codes[a].bits < huffman_codes[b].bits) ||
+                             ((huffman_codes[a].bits == huffman_codes[b].bits) && (a < b));
+                  });
+        for (uint32_t i = 0; i < 257; ++i) {
+            const HuffmanCode &hc = huffman_codes[symbols[i]];
+            if (count[hc.bits]++ == 0) {
+                first_code[hc.bits] = hc.code;
+                first_index[hc.bits] = i;
+            }
+        }
+    }
+};
+
+const HuffmanDecodeTable huffman_decode_table;
+
+void encode_int(std::string &dst, uint8_t first, uint32_t prefix_bits, uint64_t value) {
+    uint64_t mask = (uint64_t(1) << prefix_bits) - 1;
+    if (value < mask) {
+        dst.push_back(char(first | value));
+        return;
+    }
+    dst.push_back(char(first | mask));
+    value -= mask;
+    while (value >= 128) {
+        dst.push_back(char((value & 0x7f) | 0x80));
+        value >>= 7;
+    }
+    dst.push_back(char(value));
+}
+
+bool decode_int(const uint8_t *&pos, const uint8_t *end, uint32_t prefix_bits, uint64_t &value) {
+    if (pos >= end) {
+        return false;
+    }
+    uint64_t mask = (uint64_t(1) << prefix_bits) - 1;
+    value = (*pos++ & mask);
+    if (value < mask) {
+        return true;
+    }
+    for (uint32_t shift = 0; pos < end && shift <= 56; shift += 7) {
+        uint8_t byte = *pos++;
+        value += (uint64_t(byte & 0x7f) << shift);
+        if ((byte & 0x80) == 0) {
+            return true;
+        }
+    }
+    return false;
+}
+
+void encode_string(std::string &dst, std::string_view str) {
+    encode_int(dst, 0x00, 7, str.size());
+    dst.append(str.data(), str.size());
+}
+
+bool decode_string(const uint8_t *&pos, const uint8_t *end, std::string &dst) {
+    if (pos >= end) {
+        return false;
+    }
+    bool huffman = ((*pos & 0x80) != 0);
+    uint64_t len;
+    if (!decode_int(pos, end, 7, len) || (len > uint64_t(end - pos))) {
+        return false;
+    }
+    std::string_view src(reinterpret_cast<const char *>(pos), len);
+    pos += len;
+    if (huffman) {
+        dst.clear();
+        return huffman_decode(src, dst);
+    }
+    dst.assign(src.data(), src.size());
+    return true;
+}
+
+uint64_t find_static_name(std::string_view name) {
+    for (uint64_t i = 0; i < static_table_size; ++i) {
+        if (name == static_table[i].name) {
+            return (i + 1);
+        }
+    }
+    return 0;
+}
+
+size_t entry_size(const std::string &name, const std::string &value) {
+    return name.size() + value.size() + 32;
+}
+
+}
+
+void
+encode_literal(std::string &dst, std::string_view name, std::string_view value)
+{
+    uint64_t name_index = find_static_name(name);
+    encode_int(dst, 0x00, 4, name_index);
+    if (name_index == 0) {
+        encode_string(dst, name);
+    }
+    encode_string(dst, value);
+}
+
+bool
+huffman_decode(std::string_view src, std::string &dst)
+{
+    const HuffmanDecodeTable &table = huffman_decode_table;
+    uint32_t code = 0;
+    uint32_t bits = 0;
+    for (char c: src) {
+        uint8_t byte = c;
+        for (int bit = 7; bit >= 0; --bit) {
+            code = (code << 1) | ((byte >> bit) & 1);
+            if (++bits > huffman_max_bits) {
+                return false;
+            }
+            if ((table.count[bits] > 0) && (code >= table.first_code[bits]) &&
+                ((code - table.first_code[bits]) < table.count[bits]))
+            {
+                uint16_t symbol = table.symbols[table.first_index[bits] + (code - table.first_code[bits])];
+                if (symbol == huffman_eos) {
+                    return false;
+                }
+                dst.push_back(char(symbol));
+                code = 0;
+                bits = 0;
+            }
+        }
+    }
+    // padding must be a (strict) prefix of EOS; that is, at most 7 one bits
+    return ((bits <= 7) && (code == ((uint32_t(1) << bits) - 1)));
+}
+
+Decoder::Decoder(size_t max_table_size)
+    : _table(),
+      _table_size(0),
+      _max_table_size(max_table_size),
+      _settings_max_table_size(max_table_size)
+{
+}
+
+Decoder::~Decoder() = default;
+
+bool
+Decoder::lookup(uint64_t index, const std::string *&name, const std::string *&value) const
+{
+    static const std::array<std::pair<std::string,std::string>, static_table_size> static_strings = []() {
+        std::array<std::pair<std::string,std::string>, static_table_size> result;
+        for (uint64_t i = 0; i < static_table_size; ++i) {
+            result[i] = std::make_pair(std::string(static_table[i].name), std::string(static_table[i].value));
+        }
+        return result;
+    }();
+    if (index == 0) {
+        return false;
+    }
+    if (index <= static_table_size) {
+        name = &static_strings[index - 1].first;
+        value = &static_strings[index - 1].second;
+        return true;
+    }
+    uint64_t dynamic_index = (index - static_table_size - 1);
+    if (dynamic_index >= _table.size()) {
+        return false;
+    }
+    name = &_table[dynamic_index].name;
+    value = &_table[dynamic_index].value;
+    return true;
+}
+
+void
+Decoder::evict_to(size_t limit)
+{
+    while (_table_size > limit) {
+        _table_size -= entry_size(_table.back().name, _table.back().value);
+        _table.pop_back();
+    }
+}
+
+void
+Decoder::insert(std::string name, std::string value)
+{
+    size_t size = entry_size(name, value);
+    if (size > _max_table_size) {
+        evict_to(0);
+        return;
+    }
+    evict_to(_max_table_size - size);
+    _table.push_front(Entry{std::move(name), std::move(value)});
+    _table_size += size;
+}
+
+bool
+Decoder::decode(std::string_view block, const Handler &handler)
+{
+    const uint8_t *pos = reinterpret_cast<const uint8_t *>(block.data());
+    const uint8_t *end = pos + block.size();
+    const std::string *name_ref = nullptr;
+    const std::string *value_ref = nullptr;
+    std::string name;
+    std::string value;
+    bool size_update_allowed = true;
+    while (pos < end) {
+        uint8_t first = *pos;
+        uint64_t index;
+        if ((first & 0x80) != 0) {
+            // indexed header field
+            if (!decode_int(pos, end, 7, index) || !lookup(index, name_ref, value_ref)) {
+                return false;
+            }
+            handler(*name_ref, *value_ref);
+        } else if ((first & 0xe0) == 0x20) {
+            // dynamic table size update; only allowed first in a block
+            if (!size_update_allowed || !decode_int(pos, end, 5, index) || (index > _settings_max_table_size)) {
+                return false;
+            }
+            _max_table_size = index;
+            evict_to(_max_table_size);
+            continue;
+        } else {
+            // literal header field; with incremental indexing (6 bit
+            // prefix), without indexing or never indexed (4 bit prefix)
+            bool add_to_table = ((first & 0xc0) == 0x40);
+            if (!decode_int(pos, end, add_to_table ? 6 : 4, index)) {
+                return false;
+            }
+            if (index == 0) {
+                if (!decode_string(pos, end, name)) {
+                    return false;
+                }
+            } else {
+                if (!lookup(index, name_ref, value_ref)) {
+                    return false;
+                }
+                name = *name_ref;
+            }
+            if (!decode_string(pos, end, value)) {
+                return false;
+            }
+            handler(name, value);
+            if (add_to_table) {
+                insert(name, value);
+            }
+        }
+        size_update_allowed = false;
+    }
+    return true;
+}
+
+}
@@ -0,0 +1,71 @@
+// Copyright Vespa.ai. Licensed under the terms of the Apache 2.0 license. See LICENSE in the project root.
+#pragma once
+
+#include <cstdint>
+#include <deque>
+#include <functional>
+#include <string>
+#include <string_view>
+
+/**
+ * Minimal HPACK (RFC 7541) support needed by the HTTP/2 client.
+ *
+ * Request headers are encoded as literals without indexing, which
+ * keeps the encoder stateless and lets requests from different
+ * threads be encoded independently. Response headers are decoded
+ * with full support for the static and dynamic tables as well as
+ * Huffman coded strings.
+ **/
+namespace hpack {
+
+/**
+ * Append a header field to an encoded header block as a literal
+ * without indexing. Header names must already be lower case.
+ **/
+void encode_literal(std::string &dst, std::string_view name, std::string_view value);
+
+/**
+ * Decode a Huffman coded string. Returns false if the input is not
+ * valid according to the HPACK Huffman code.
+ **/
+bool huffman_decode(std::string_view src, std::string &dst);
+
+/**
+ * Stateful decoder for header blocks received on a single
+ * connection. All header blocks received on the connection must be
+ * passed to the same decoder in the order they were received.
+ **/
+class Decoder
+{
+public:
+    using Handler = std::function<void(const std::string &name, const std::string &value)>;
+
+    explicit Decoder(size_t max_table_size = 4096);
+    ~Decoder();
+
+    /**
+     * Decode a complete header block, calling the handler for each
+     * header field. Returns false on compression errors, after which
+     * the connection must be abandoned.
+     **/
+    bool decode(std::string_view block, const Handler &handler);
+
+    size_t table_size() const { return _table_size; }
+    size_t table_entries() const { return _table.size(); }
+
+private:
+    struct Entry {
+        std::string name;
+        std::string value;
+    };
+    std::deque<Entry> _table; // newest first
+    size_t            _table_size;
+    size_t            _max_table_size;
+    size_t            _settings_max_table_size;
+
+    bool lookup(uint64_t index, const std::string *&name, const std::string *&value) const;
+    void insert(std::string name, std::string value);
+    void evict_to(size_t limit);
+};
+
+}
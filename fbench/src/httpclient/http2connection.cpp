@@ -0,0 +1,669 @@
+// Copyright Vespa.ai. Licensed under the terms of the Apache 2.0 license. See LICENSE in the project root.
+#include "http2connection.h"
+#include <algorithm>
+#include <cerrno>
+#include <cstdlib>
+#include <cstring>
+
+namespace {
+
+const char connection_preface[] = "PRI * HTTP/2.0\r\n\r\nSM\r\n\r\n";
+
+constexpr uint8_t FRAME_DATA          = 0x0;
+constexpr uint8_t FRAME_HEADERS       = 0x1;
+constexpr uint8_t FRAME_RST_STREAM    = 0x3;
+constexpr uint8_t FRAME_SETTINGS      = 0x4;
+constexpr uint8_t FRAME_PUSH_PROMISE  = 0x5;
+constexpr uint8_t FRAME_PING          = 0x6;
+constexpr uint8_t FRAME_GOAWAY        = 0x7;
+constexpr uint8_t FRAME_WINDOW_UPDATE = 0x8;
+constexpr uint8_t FRAME_CONTINUATION  = 0x9;
+
+constexpr uint8_t FLAG_END_STREAM  = 0x01;
+constexpr uint8_t FLAG_ACK         = 0x01;
+constexpr uint8_t FLAG_END_HEADERS = 0x04;
+constexpr uint8_t FLAG_PADDED      = 0x08;
+constexpr uint8_t FLAG_PRIORITY    = 0x20;
+
+constexpr uint16_t SETTINGS_ENABLE_PUSH         = 0x2;
+constexpr uint16_t SETTINGS_INITIAL_WINDOW_SIZE = 0x4;
+constexpr uint16_t SETTINGS_MAX_FRAME_SIZE      = 0x5;
+
+constexpr uint32_t ERROR_NO_ERROR       = 0x0;
+constexpr uint32_t ERROR_REFUSED_STREAM = 0x7;
+
+constexpr uint32_t max_stream_id         = 0x7fffffff;
+constexpr int64_t  default_window        = 65535;
+constexpr uint32_t default_frame_size    = 16384;
+constexpr uint32_t stream_recv_window    = (1u << 20);
+constexpr uint32_t conn_recv_window      = (16u << 20);
+// window updates are sent when this much has been consumed; the
+// stream threshold must stay below the default window since the
+// server might not have applied our settings yet.
+constexpr uint32_t stream_update_trigger = 32768;
+constexpr uint32_t conn_update_trigger   = (conn_recv_window / 2);
+
+void append_u16(std::string &dst, uint16_t value) {
+    dst.push_back(char(value >> 8));
+    dst.push_back(char(value));
+}
+
+void append_u32(std::string &dst, uint32_t value) {
+    append_u16(dst, value >> 16);
+    append_u16(dst, value);
+}
+
+uint32_t read_u32(const char *src) {
+    const uint8_t *p = reinterpret_cast<const uint8_t *>(src);
+    return ((uint32_t(p[0]) << 24) | (uint32_t(p[1]) << 16) | (uint32_t(p[2]) << 8) | uint32_t(p[3]));
+}
+
+void append_frame_header(std::string &dst, uint32_t length, uint8_t type, uint8_t flags, uint32_t streamId) {
+    dst.push_back(char(length >> 16));
+    append_u16(dst, length);
+    dst.push_back(char(type));
+    dst.push_back(char(flags));
+    append_u32(dst, streamId);
+}
+
+void append_window_update(std::string &dst, uint32_t streamId, uint32_t increment) {
+    append_frame_header(dst, 4, FRAME_WINDOW_UPDATE, 0, streamId);
+    append_u32(dst, increment);
+}
+
+void append_rst_stream(std::string &dst, uint32_t streamId, uint32_t error) {
+    append_frame_header(dst, 4, FRAME_RST_STREAM, 0, streamId);
+    append_u32(dst, error);
+}
+
+/**
+ * Find the part of a DATA or HEADERS frame payload that is not
+ * padding (or priority information). Returns false if the frame is
+ * malformed.
+ **/
+bool frame_content(uint8_t flags, const std::string &payload, size_t skip, size_t &begin, size_t &end) {
+    begin = 0;
+    end = payload.size();
+    if ((flags & FLAG_PADDED) != 0) {
+        if (end < 1) {
+            return false;
+        }
+        size_t padding = uint8_t(payload[0]);
+        begin = 1;
+        if (padding > (end - begin)) {
+            return false;
+        }
+        end -= padding;
+    }
+    if (skip > (end - begin)) {
+        return false;
+    }
+    begin += skip;
+    return true;
+}
+
+}
+
+HTTP2Connection::Transport::Transport(vespalib::SocketHandle handle_in)
+    : handle(std::move(handle_in)),
+      writeLock(),
+      rbuf(64 * 1024),
+      rpos(0),
+      rused(0),
+      decoder()
+{
+}
+
+HTTP2Connection::Transport::~Transport() = default;
+
+bool
+HTTP2Connection::Transport::Write(const std::string &data)
+{
+    size_t written = 0;
+    while (written < data.size()) {
+        ssize_t res = handle.write(data.data() + written, data.size() - written);
+        if (res > 0) {
+            written += res;
+        } else if (res < 0 && errno == EINTR) {
+            continue;
+        } else {
+            return false;
+        }
+    }
+    return true;
+}
+
+bool
+HTTP2Connection::Transport::ReadFully(char *dst, size_t len)
+{
+    while (len > 0) {
+        if (rpos == rused) {
+            ssize_t res = handle.read(rbuf.data(), rbuf.size());
+            if (res < 0 && errno == EINTR) {
+                continue;
+            }
+            if (res <= 0) {
+                return false;
+            }
+            rpos = 0;
+            rused = res;
+        }
+        size_t chunk = std::min(len, rused - rpos);
+        memcpy(dst, rbuf.data() + rpos, chunk);
+        rpos += chunk;
+        dst += chunk;
+        len -= chunk;
+    }
+    return true;
+}
+
+bool
+HTTP2Connection::Transport::ReadFrame(Frame &frame)
+{
+    char header[9];
+    if (!ReadFully(header, sizeof(header))) {
+        return false;
+    }
+    const uint8_t *p = reinterpret_cast<const uint8_t *>(header);
+    frame.length = (uint32_t(p[0]) << 16) | (uint32_t(p[1]) << 8) | uint32_t(p[2]);
+    frame.type = p[3];
+    frame.flags = p[4];
+    frame.streamId = read_u32(header + 5) & max_stream_id;
+    frame.payload.resize(frame.length);
+    return ReadFully(frame.payload.data(), frame.length);
+}
+
+HTTP2Connection::Stream::Stream(std::ostream *file_in)
+    : file(file_in),
+      id(0),
+      sendWindow(0),
+      recvConsumed(0),
+      headersDone(false),
+      done(false),
+      failed(false),
+      retry(false),
+      fileFailed(false),
+      result()
+{
+}
+
+HTTP2Connection::HTTP2Connection(const char *hostname, int port)
+    : _address(vespalib::SocketAddress::select_remote(port, hostname)),
+      _lock(),
+      _cond(),
+      _transport(),
+      _leaderActive(false),
+      _goAway(false),
+      _nextStreamId(1),
+      _streams(),
+      _connSendWindow(default_window),
+      _initialSendWindow(default_window),
+      _peerMaxFrameSize(default_frame_size),
+      _connRecvConsumed(0),
+      _headerStreamId(0),
+      _headerFlags(0),
+      _headerBlock()
+{
+}
+
+HTTP2Connection::~HTTP2Connection() = default;
+
+bool
+HTTP2Connection::Connect()
+{
+    auto handle = _address.connect([](auto &h)
+                                   {
+                                       return (h.set_nodelay(true) &&
+                                               h.set_linger(false, 0));
+                                   });
+    if (!handle.valid()) {
+        return false;
+    }
+    auto transport = std::make_shared<Transport>(std::move(handle));
+    std::string out(connection_preface, sizeof(connection_preface) - 1);
+    append_frame_header(out, 12, FRAME_SETTINGS, 0, 0);
+    append_u16(out, SETTINGS_ENABLE_PUSH);
+    append_u32(out, 0);
+    append_u16(out, SETTINGS_INITIAL_WINDOW_SIZE);
+    append_u32(out, stream_recv_window);
+    append_window_update(out, 0, conn_recv_window - default_window);
+    if (!transport->Write(out)) {
+        return false;
+    }
+    _transport = std::move(transport);
+    _goAway = false;
+    _nextStreamId = 1;
+    _connSendWindow = default_window;
+    _initialSendWindow = default_window;
+    _peerMaxFrameSize = default_frame_size;
+    _connRecvConsumed = 0;
+    _headerStreamId = 0;
+    _headerBlock.clear();
+    return true;
+}
+
+void
+HTTP2Connection::FailConnection()
+{
+    if (!_transport) {
+        return;
+    }
+    // wakes up any thread blocked reading from the socket
+    _transport->handle.shutdown();
+    _transport.reset();
+    for (auto &entry : _streams) {
+        Stream &stream = *entry.second;
+        stream.done = true;
+        stream.failed = true;
+        stream.retry = !stream.headersDone;
+    }
+    _streams.clear();
+    _headerStreamId = 0;
+    _headerBlock.clear();
+    _cond.notify_all();
+}
+
+void
+HTTP2Connection::CloseStream(Stream &stream, bool failed, bool retry)
+{
+    stream.done = true;
+    stream.failed = failed;
+    stream.retry = retry;
+    _streams.erase(stream.id);
+}
+
+template <typename Pred>
+void
+HTTP2Connection::Await(std::unique_lock<std::mutex> &guard, Pred pred)
+{
+    while (!pred()) {
+        if (_leaderActive || !_transport) {
+            _cond.wait(guard);
+            continue;
+        }
+        // become the reader of the connection until a frame arrives
+        _leaderActive = true;
+        std::shared_ptr<Transport> transport = _transport;
+        guard.unlock();
+        Frame frame;
+        bool ok = transport->ReadFrame(frame);
+        std::string out;
+        guard.lock();
+        _leaderActive = false;
+        if (transport == _transport) {
+            if (ok) {
+                HandleFrame(frame, out);
+            } else {
+                FailConnection();
+            }
+        }
+        _cond.notify_all();
+        if (!out.empty() && (transport == _transport)) {
+            guard.unlock();
+            bool written;
+            {
+                std::lock_guard writeGuard(transport->writeLock);
+                written = transport->Write(out);
+            }
+            guard.lock();
+            if (!written && (transport == _transport)) {
+                FailConnection();
+            }
+        }
+    }
+}
+
+void
+HTTP2Connection::HandleFrame(const Frame &frame, std::string &out)
+{
+    if (_headerStreamId != 0 &&
+        (frame.type != FRAME_CONTINUATION || frame.streamId != _headerStreamId))
+    {
+        FailConnection(); // header blocks must be contiguous
+        return;
+    }
+    auto stream = _streams.find(frame.streamId);
+    switch (frame.type) {
+    case FRAME_DATA:
+        HandleData(frame, out);
+        break;
+    case FRAME_HEADERS: {
+        size_t begin, end;
+        size_t skip = ((frame.flags & FLAG_PRIORITY) != 0) ? 5 : 0;
+        if (frame.streamId == 0 || !frame_content(frame.flags, frame.payload, skip, begin, end)) {
+            FailConnection();
+            return;
+        }
+        _headerStreamId = frame.streamId;
+        _headerFlags = frame.flags;
+        _headerBlock.assign(frame.payload, begin, end - begin);
+        if ((frame.flags & FLAG_END_HEADERS) != 0) {
+            HandleHeaderBlock();
+        }
+        break;
+    }
+    case FRAME_CONTINUATION:
+        if (_headerStreamId == 0) {
+            FailConnection();
+            return;
+        }
+        _headerBlock.append(frame.payload);
+        if ((frame.flags & FLAG_END_HEADERS) != 0) {
+            HandleHeaderBlock();
+        }
+        break;
+    case FRAME_RST_STREAM:
+        if (frame.length != 4) {
+            FailConnection();
+            return;
+        }
+        if (stream != _streams.end()) {
+            Stream &s = *stream->second;
+            bool refused = (read_u32(frame.payload.data()) == ERROR_REFUSED_STREAM);
+            CloseStream(s, true, refused && !s.headersDone);
+        }
+        break;
+    case FRAME_SETTINGS:
+        HandleSettings(frame, out);
+        break;
+    case FRAME_PUSH_PROMISE:
+        FailConnection(); // push is disabled by our settings
+        break;
+    case FRAME_PING:
+        if (frame.length != 8) {
+            FailConnection();
+            return;
+        }
+        if ((frame.flags & FLAG_ACK) == 0) {
+            append_frame_header(out, 8, FRAME_PING, FLAG_ACK, 0);
+            out.append(frame.payload);
+        }
+        break;
+    case FRAME_GOAWAY: {
+        if (frame.length < 8) {
+            FailConnection();
+            return;
+        }
+        // streams above the last processed one may be retried on a
+        // new connection; no new streams may be started on this one.
+        uint32_t lastStreamId = read_u32(frame.payload.data()) & max_stream_id;
+        _goAway = true;
+        std::vector<Stream*> unprocessed;
+        for (auto it = _streams.upper_bound(lastStreamId); it != _streams.end(); ++it) {
+            unprocessed.push_back(it->second);
+        }
+        for (Stream *s: unprocessed) {
+            CloseStream(*s, true, true);
+        }
+        break;
+    }
+    case FRAME_WINDOW_UPDATE: {
+        if (frame.length != 4) {
+            FailConnection();
+            return;
+        }
+        uint32_t increment = read_u32(frame.payload.data()) & max_stream_id;
+        if (frame.streamId == 0) {
+            _connSendWindow += increment;
+        } else if (stream != _streams.end()) {
+            stream->second->sendWindow += increment;
+        }
+        break;
+    }
+    default:
+        break; // PRIORITY and unknown frame types are ignored
+    }
+}
+
+void
+HTTP2Connection::HandleSettings(const Frame &frame, std::string &out)
+{
+    if (frame.streamId != 0 || (frame.length % 6) != 0) {
+        FailConnection();
+        return;
+    }
+    if ((frame.flags & FLAG_ACK) != 0) {
+        return;
+    }
+    for (size_t pos = 0; pos < frame.length; pos += 6) {
+        const uint8_t *p = reinterpret_cast<const uint8_t *>(frame.payload.data() + pos);
+        uint16_t id = (uint16_t(p[0]) << 8) | p[1];
+        uint32_t value = read_u32(frame.payload.data() + pos + 2);
+        if (id == SETTINGS_INITIAL_WINDOW_SIZE) {
+            int64_t delta = int64_t(value) - _initialSendWindow;
+            for (auto &entry : _streams) {
+                entry.second->sendWindow += delta;
+            }
+            _initialSendWindow = value;
+        } else if (id == SETTINGS_MAX_FRAME_SIZE) {
+            _peerMaxFrameSize = std::max(value, default_frame_size);
+        }
+    }
+    append_frame_header(out, 0, FRAME_SETTINGS, FLAG_ACK, 0);
+}
+
+void
+HTTP2Connection::HandleHeaderBlock()
+{
+    uint32_t streamId = _headerStreamId;
+    uint8_t flags = _headerFlags;
+    _headerStreamId = 0;
+    uint32_t status = 0;
+    int32_t totalHitCount = -1;
+    std::string headerinfo;
+    const std::string benchmarkPrefix("x-yahoo-vespa-");
+    bool ok = _transport->decoder.decode(_headerBlock, [&](const std::string &name, const std::string &value)
+                                         {
+                                             if (name == ":status") {
+                                                 status = atoi(value.c_str());
+                                             } else if (name.compare(0, benchmarkPrefix.size(), benchmarkPrefix) == 0) {
+                                                 // same layout as the HTTP/1.1 client, but lower case
+                                                 headerinfo += name.substr(benchmarkPrefix.size());
+                                                 headerinfo += ": ";
+                                                 headerinfo += value;
+                                                 headerinfo += "\n";
+                                                 if (name == "x-yahoo-vespa-totalhitcount") {
+                                                     totalHitCount = atoi(value.c_str());
+                                                 }
+                                             }
+                                         });
+    _headerBlock.clear();
+    if (!ok) {
+        FailConnection(); // the decoder state is now out of sync
+        return;
+    }
+    auto entry = _streams.find(streamId);
+    if (entry == _streams.end()) {
+        return;
+    }
+    Stream &stream = *entry->second;
+    if (!stream.headersDone) {
+        if (status >= 100 && status < 200) {
+            return; // informational response; wait for the final one
+        }
+        stream.headersDone = true;
+        stream.result.status = status;
+        stream.result.totalHitCount = totalHitCount;
+        if (stream.file != nullptr) {
+            stream.file->write(headerinfo.c_str(), headerinfo.length());
+            stream.file->write("\r\n", 2);
+            stream.fileFailed = stream.file->fail();
+        }
+    }
+    if ((flags & FLAG_END_STREAM) != 0) {
+        CloseStream(stream, false, false);
+    }
+}
+
+void
+HTTP2Connection::HandleData(const Frame &frame, std::string &out)
+{
+    size_t begin, end;
+    if (frame.streamId == 0 || !frame_content(frame.flags, frame.payload, 0, begin, end)) {
+        FailConnection();
+        return;
+    }
+    _connRecvConsumed += frame.length;
+    if (_connRecvConsumed >= conn_update_trigger) {
+        append_window_update(out, 0, _connRecvConsumed);
+        _connRecvConsumed = 0;
+    }
+    auto entry = _streams.find(frame.streamId);
+    if (entry == _streams.end()) {
+        return;
+    }
+    Stream &stream = *entry->second;
+    if (!stream.headersDone) {
+        CloseStream(stream, true, false);
+        append_rst_stream(out, frame.streamId, ERROR_NO_ERROR);
+        return;
+    }
+    size_t len = end - begin;
+    stream.result.size += len;
+    if (stream.file != nullptr && !stream.fileFailed && len > 0) {
+        if (!stream.file->write(frame.payload.data() + begin, len)) {
+            stream.fileFailed = true;
+        }
+    }
+    if ((frame.flags & FLAG_END_STREAM) != 0) {
+        CloseStream(stream, false, false);
+        return;
+    }
+    stream.recvConsumed += frame.length;
+    if (stream.recvConsumed >= stream_update_trigger) {
+        append_window_update(out, stream.id, stream.recvConsumed);
+        stream.recvConsumed = 0;
+    }
+}
+
+bool
+HTTP2Connection::StartStream(Stream &stream, const Headers &headers, bool endStream,
+                             std::shared_ptr<Transport> &transport)
+{
+    std::string block;
+    for (const auto &header : headers) {
+        hpack::encode_literal(block, header.first, header.second);
+    }
+    for (;;) {
+        {
+            std::unique_lock guard(_lock);
+            while (!_transport || _goAway || _nextStreamId > max_stream_id) {
+                if (_transport && !_streams.empty()) {
+                    // let the active streams complete before reconnecting
+                    auto draining = _transport;
+                    Await(guard, [&]() { return (_transport != draining) || _streams.empty(); });
+                    continue;
+                }
+                FailConnection();
+                if (!Connect()) {
+                    return false;
+                }
+            }
+            transport = _transport;
+        }
+        // stream ids must be used in increasing order; hold the write
+        // lock from allocating the id until the headers are written.
+        std::lock_guard writeGuard(transport->writeLock);
+        std::string frames;
+        {
+            std::lock_guard guard(_lock);
+            if (transport != _transport || _goAway || _nextStreamId > max_stream_id) {
+                continue;
+            }
+            stream.id = _nextStreamId;
+            _nextStreamId += 2;
+            stream.sendWindow = _initialSendWindow;
+            stream.result.reused = (stream.id > 1);
+            _streams[stream.id] = &stream;
+            size_t pos = 0;
+            do {
+                size_t chunk = std::min(block.size() - pos, size_t(_peerMaxFrameSize));
+                bool first = (pos == 0);
+                bool last = (pos + chunk == block.size());
+                uint8_t flags = (last ? FLAG_END_HEADERS : 0) | ((first && endStream) ? FLAG_END_STREAM : 0);
+                append_frame_header(frames, chunk, first ? FRAME_HEADERS : FRAME_CONTINUATION, flags, stream.id);
+                frames.append(block, pos, chunk);
+                pos += chunk;
+            } while (pos < block.size());
+        }
+        if (!transport->Write(frames)) {
+            std::lock_guard guard(_lock);
+            if (transport == _transport) {
+                FailConnection();
+            }
+        }
+        return true;
+    }
+}
+
+bool
+HTTP2Connection::SendContent(Stream &stream, const char *content, size_t contentLen,
+                             const std::shared_ptr<Transport> &transport)
+{
+    size_t pos = 0;
+    while (pos < contentLen) {
+        size_t chunk;
+        {
+            std::unique_lock guard(_lock);
+            Await(guard, [&]() { return stream.done || (std::min(_connSendWindow, stream.sendWindow) > 0); });
+            if (stream.done) {
+                if (!stream.failed) {
+                    // response completed before we were done sending
+                    std::string rst;
+                    append_rst_stream(rst, stream.id, ERROR_NO_ERROR);
+                    guard.unlock();
+                    std::lock_guard writeGuard(transport->writeLock);
+                    transport->Write(rst);
+                }
+                return false;
+            }
+            chunk = std::min(contentLen - pos, size_t(std::min(_connSendWindow, stream.sendWindow)));
+            chunk = std::min(chunk, size_t(_peerMaxFrameSize));
+            _connSendWindow -= chunk;
+            stream.sendWindow -= chunk;
+        }
+        bool last = (pos + chunk == contentLen);
+        std::string frame;
+        append_frame_header(frame, chunk, FRAME_DATA, last ? FLAG_END_STREAM : 0, stream.id);
+        frame.append(content + pos, chunk);
+        bool written;
+        {
+            std::lock_guard writeGuard(transport->writeLock);
+            written = transport->Write(frame);
+        }
+        if (!written) {
+            std::lock_guard guard(_lock);
+            if (transport == _transport) {
+                FailConnection();
+            }
+            return false;
+        }
+        pos += chunk;
+    }
+    return true;
+}
+
+HTTP2Connection::Result
+HTTP2Connection::Fetch(const Headers &headers, const char *content, size_t contentLen, std::ostream *file)
+{
+    bool hasContent = (content != nullptr && contentLen > 0);
+    for (int attempt = 0; ; ++attempt) {
+        Stream stream(file);
+        std::shared_ptr<Transport> transport;
+        if (!StartStream(stream, headers, !hasContent, transport)) {
+            return stream.result;
+        }
+        if (hasContent) {
+            SendContent(stream, content, contentLen, transport);
+        }
+        {
+            std::unique_lock guard(_lock);
+            Await(guard, [&stream]() { return stream.done; });
+        }
+        if (stream.retry && attempt == 0) {
+            continue;
+        }
+        stream.result.complete = (!stream.failed && !stream.fileFailed);
+        return stream.result;
+    }
+}
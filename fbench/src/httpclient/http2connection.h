@@ -0,0 +1,133 @@
+// Copyright Vespa.ai. Licensed under the terms of the Apache 2.0 license. See LICENSE in the project root.
+#pragma once
+
+#include "hpack.h"
+#include <vespa/vespalib/net/socket_address.h>
+#include <vespa/vespalib/net/socket_handle.h>
+#include <condition_variable>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <ostream>
+#include <string>
+#include <vector>
+
+/**
+ * A HTTP/2 connection (cleartext with prior knowledge, h2c) that is
+ * shared by several client threads, each performing one request at a
+ * time as a separate stream. This lets a single connection carry as
+ * many concurrent streams as there are clients sharing it.
+ *
+ * There is no internal thread; while waiting for their own response,
+ * client threads take turns reading frames from the connection and
+ * dispatching them to the streams they belong to. The connection is
+ * (re)established on demand. Requests that were not processed by the
+ * server because the connection was lost or shut down are retried
+ * once on a new connection.
+ **/
+class HTTP2Connection
+{
+public:
+  using Headers = std::vector<std::pair<std::string,std::string>>;
+
+  /**
+   * Outcome of a single request.
+   **/
+  struct Result {
+    bool     complete;      // complete response received
+    uint32_t status;        // HTTP status; 0 if unknown
+    int32_t  totalHitCount; // -1 if not given by the server
+    int64_t  size;          // number of content bytes received
+    bool     reused;        // sent on an already used connection
+    Result() : complete(false), status(0), totalHitCount(-1), size(0), reused(false) {}
+  };
+
+  HTTP2Connection(const char *hostname, int port);
+  HTTP2Connection(const HTTP2Connection &) = delete;
+  HTTP2Connection &operator=(const HTTP2Connection &) = delete;
+  ~HTTP2Connection();
+
+  /**
+   * Perform a request and wait for the response. The headers must
+   * contain the request pseudo-headers and use lower case names. Any
+   * benchmark data headers received are written to 'file' (if given)
+   * before the response content, using the same layout as the
+   * HTTP/1.1 client.
+   *
+   * @param headers request headers, including pseudo-headers.
+   * @param content request content; nullptr for no content.
+   * @param contentLen length of content in bytes.
+   * @param file where to save the response, may be nullptr.
+   **/
+  Result Fetch(const Headers &headers, const char *content, size_t contentLen, std::ostream *file);
+
+private:
+  struct Frame {
+    uint32_t    length;
+    uint8_t     type;
+    uint8_t     flags;
+    uint32_t    streamId;
+    std::string payload;
+  };
+
+  /**
+   * The physical connection. Replaced when the connection is lost.
+   **/
+  struct Transport {
+    vespalib::SocketHandle handle;
+    std::mutex             writeLock;
+    std::vector<char>      rbuf;
+    size_t                 rpos;
+    size_t                 rused;
+    hpack::Decoder         decoder;
+    Transport(vespalib::SocketHandle handle_in);
+    ~Transport();
+    bool Write(const std::string &data);
+    bool ReadFully(char *dst, size_t len);
+    bool ReadFrame(Frame &frame);
+  };
+
+  struct Stream {
+    std::ostream *file;
+    uint32_t      id;
+    int64_t       sendWindow;
+    uint32_t      recvConsumed;
+    bool          headersDone;
+    bool          done;
+    bool          failed;
+    bool          retry;
+    bool          fileFailed;
+    Result        result;
+    Stream(std::ostream *file_in);
+  };
+
+  vespalib::SocketAddress    _address;
+  std::mutex                 _lock;
+  std::condition_variable    _cond;
+  std::shared_ptr<Transport> _transport;
+  bool                       _leaderActive;
+  bool                       _goAway;
+  uint32_t                   _nextStreamId;
+  std::map<uint32_t,Stream*> _streams;
+  int64_t                    _connSendWindow;
+  int64_t                    _initialSendWindow;
+  uint32_t                   _peerMaxFrameSize;
+  uint32_t                   _connRecvConsumed;
+  uint32_t                   _headerStreamId;
+  uint8_t                    _headerFlags;
+  std::string                _headerBlock;
+
+  bool Connect();
+  void FailConnection();
+  template <typename Pred>
+  void Await(std::unique_lock<std::mutex> &guard, Pred pred);
+  void HandleFrame(const Frame &frame, std::string &out);
+  void HandleHeaderBlock();
+  void HandleData(const Frame &frame, std::string &out);
+  void HandleSettings(const Frame &frame, std::string &out);
+  void CloseStream(Stream &stream, bool failed, bool retry);
+  bool StartStream(Stream &stream, const Headers &headers, bool endStream,
+                   std::shared_ptr<Transport> &transport);
+  bool SendContent(Stream &stream, const char *content, size_t contentLen,
+                   const std::shared_ptr<Transport> &transport);
+};
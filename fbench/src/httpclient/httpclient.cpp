@@ -3,7 +3,9 @@
 #include <vespa/vespalib/net/socket_spec.h>
 #include <vespa/vespalib/util/size_literals.h>
 #include <util/authority.h>
+#include <algorithm>
 #include <cassert>
+#include <cctype>
 #include <cstring>
 
 #define FETCH_BUFLEN 5120
@@ -22,7 +24,8 @@ HTTPClient::ChunkedReader::_instance;
 
 HTTPClient::HTTPClient(vespalib::CryptoEngine::SP engine, const char *hostname, int port,
                        bool keepAlive, bool headerBenchmarkdataCoverage,
-                       const std::string & extraHeaders, const std::string &authority)
+                       const std::string & extraHeaders, const std::string &authority,
+                       std::shared_ptr<HTTP2Connection> http2)
     : _engine(std::move(engine)),
       _address(vespalib::SocketAddress::select_remote(port, hostname)),
       _socket(),
@@ -34,6 +37,7 @@ HTTPClient::HTTPClient(vespalib::CryptoEngine::SP engine, const char *hostname,
     _sni_spec(make_sni_spec(authority, hostname, port, _engine->use_tls_when_client())),
     _host_header_value(make_host_header_value(_sni_spec, _engine->use_tls_when_client())),
     _reuseCount(0),
+    _http2(std::move(http2)),
     _bufsize(10_Ki),
     _buf(new char[_bufsize]),
     _bufused(0),
@@ -512,6 +516,10 @@ HTTPClient::Fetch(const char *url, std::ostream *file,
     ssize_t readRes  = 0;
     ssize_t written  = 0;
 
+    if (_http2) {
+        return FetchHTTP2(url, file, usePost, content, contentLen);
+    }
+
     std::string headerinfo;
     if (!Open(headerinfo, url, usePost, content, contentLen)) {
         return FetchStatus(false, _requestStatus, _totalHitCount, 0);
@@ -544,3 +552,60 @@ HTTPClient::Fetch(const char *url, std::ostream *file,
                        _totalHitCount,
                        written);
 }
+
+HTTPClient::FetchStatus
+HTTPClient::FetchHTTP2(const char *url, std::ostream *file,
+                       bool usePost, const char *content, int contentLen)
+{
+    HTTP2Connection::Headers headers;
+    headers.emplace_back(":method", usePost ? "POST" : "GET");
+    headers.emplace_back(":scheme", "http");
+    headers.emplace_back(":authority", _host_header_value);
+    headers.emplace_back(":path", url);
+    if (usePost) {
+        headers.emplace_back("content-length", std::to_string(contentLen));
+    }
+    // this is always requested to get robust info on total hit count.
+    headers.emplace_back("x-yahoo-vespa-benchmarkdata", "true");
+    if (_headerBenchmarkdataCoverage) {
+        headers.emplace_back("x-yahoo-vespa-benchmarkdata-coverage", "true");
+    }
+    headers.emplace_back("user-agent", "fbench/4.2.10");
+
+    // HTTP/2 requires lower case header names and does not allow
+    // connection-specific headers.
+    size_t pos = 0;
+    while (pos < _extraHeaders.size()) {
+        size_t eol = _extraHeaders.find("\r\n", pos);
+        if (eol == std::string::npos) {
+            eol = _extraHeaders.size();
+        }
+        std::string line = _extraHeaders.substr(pos, eol - pos);
+        pos = eol + 2;
+        size_t colon = line.find(':');
+        if (colon == std::string::npos) {
+            continue;
+        }
+        std::string name = line.substr(0, colon);
+        std::transform(name.begin(), name.end(), name.begin(), [](unsigned char c) { return std::tolower(c); });
+        size_t valueStart = line.find_first_not_of(" \t", colon + 1);
+        std::string value = (valueStart == std::string::npos) ? "" : line.substr(valueStart);
+        if (name == "connection" || name == "keep-alive" || name == "proxy-connection" ||
+            name == "transfer-encoding" || name == "upgrade" || name == "host")
+        {
+            continue;
+        }
+        headers.emplace_back(name, value);
+    }
+
+    auto result = _http2->Fetch(headers, usePost ? content : nullptr, usePost ? contentLen : 0, file);
+    _requestStatus = result.status;
+    _totalHitCount = result.totalHitCount;
+    if (result.reused) {
+        _reuseCount++;
+    }
+    return FetchStatus(result.complete && result.status == 200 && result.totalHitCount >= 0,
+                       result.status,
+                       result.totalHitCount,
+                       result.size);
+}
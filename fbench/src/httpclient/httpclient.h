@@ -3,6 +3,7 @@
 
 #include <ostream>
 #include <memory>
+#include "http2connection.h"
 #include <vespa/vespalib/net/sync_crypto_socket.h>
 #include <vespa/vespalib/net/crypto_engine.h>
 #include <vespa/vespalib/net/socket_address.h>
@@ -12,7 +13,8 @@
  * This class implements a HTTP client that may be used to fetch
  * documents from a HTTP server. It uses the HTTP 1.1 protocol, but in
  * order to keep the external interface simple, it does not support
- * request pipelining.
+ * request pipelining. If given a HTTP/2 connection, requests are sent
+ * as streams on that (possibly shared) connection instead.
  **/
 class HTTPClient
 {
@@ -103,6 +105,7 @@ protected:
   vespalib::SocketSpec _sni_spec;
   std::string          _host_header_value;
   uint64_t             _reuseCount;
+  std::shared_ptr<HTTP2Connection> _http2;
 
   size_t           _bufsize;
   char            *_buf;
@@ -265,9 +268,11 @@ public:
    * @param hostname the host you want to fetch documents from.
    * @param port the TCP port to use when contacting the host.
    * @param keepAlive flag indicating if keep-alive should be enabled.
+   * @param http2 HTTP/2 connection to use instead of HTTP 1.1, may be shared.
    **/
     HTTPClient(vespalib::CryptoEngine::SP engine, const char *hostname, int port, bool keepAlive,
-               bool headerBenchmarkdataCoverage, const std::string & extraHeaders="", const std::string &authority = "");
+               bool headerBenchmarkdataCoverage, const std::string & extraHeaders="", const std::string &authority = "",
+               std::shared_ptr<HTTP2Connection> http2 = {});
 
   /**
    * Disconnect from server and free memory.
@@ -278,7 +283,8 @@ public:
    * This method may be used to obtain information about how many
    * times a physical connection has been reused to send an additional
    * HTTP request. Note that connections may only be reused if
-   * keep-alive is enabled.
+   * keep-alive is enabled. With HTTP/2, this counts requests sent
+   * on a connection that had already been used.
    *
    * @return connection reuse count
    **/
@@ -349,4 +355,11 @@ public:
    **/
   FetchStatus Fetch(const char *url, std::ostream *file = NULL,
                     bool usePost = false, const char *content = NULL, int contentLen = 0);
+
+private:
+  /**
+   * Perform a request as a stream on the HTTP/2 connection.
+   **/
+  FetchStatus FetchHTTP2(const char *url, std::ostream *file,
+                         bool usePost, const char *content, int contentLen);
 };
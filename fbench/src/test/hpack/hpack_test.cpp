@@ -0,0 +1,108 @@
+// Copyright Vespa.ai. Licensed under the terms of the Apache 2.0 license. See LICENSE in the project root.
+
+#include <httpclient/hpack.h>
+#include <vespa/vespalib/gtest/gtest.h>
+#include <vector>
+
+using Fields = std::vector<std::pair<std::string,std::string>>;
+
+//-----------------------------------------------------------------------------
+
+std::string from_hex(const std::string &hex) {
+    std::string result;
+    for (size_t i = 0; i + 1 < hex.size(); i += 2) {
+        result.push_back(char(std::stoi(hex.substr(i, 2), nullptr, 16)));
+    }
+    return result;
+}
+
+bool decode(hpack::Decoder &decoder, const std::string &hex, Fields &fields) {
+    fields.clear();
+    return decoder.decode(from_hex(hex), [&fields](const std::string &name, const std::string &value)
+                          {
+                              fields.emplace_back(name, value);
+                          });
+}
+
+//-----------------------------------------------------------------------------
+
+TEST(HuffmanTest, rfc_example_is_decoded) {
+    std::string dst;
+    EXPECT_TRUE(hpack::huffman_decode(from_hex("f1e3c2e5f23a6ba0ab90f4ff"), dst));
+    EXPECT_EQ(dst, "www.example.com");
+    dst.clear();
+    EXPECT_TRUE(hpack::huffman_decode(from_hex("a8eb10649cbf"), dst));
+    EXPECT_EQ(dst, "no-cache");
+}
+
+TEST(HuffmanTest, invalid_padding_is_rejected) {
+    std::string dst;
+    // 'a' (00011) followed by zero padding
+    EXPECT_FALSE(hpack::huffman_decode(from_hex("18"), dst));
+    // more than 7 bits of padding
+    dst.clear();
+    EXPECT_FALSE(hpack::huffman_decode(from_hex("1fff"), dst));
+}
+
+TEST(DecoderTest, rfc_requests_with_huffman_coding_are_decoded) {
+    hpack::Decoder decoder;
+    Fields fields;
+    ASSERT_TRUE(decode(decoder, "828684418cf1e3c2e5f23a6ba0ab90f4ff", fields));
+    EXPECT_EQ(fields, Fields({{":method", "GET"}, {":scheme", "http"}, {":path", "/"},
+                              {":authority", "www.example.com"}}));
+    EXPECT_EQ(decoder.table_entries(), 1u);
+    EXPECT_EQ(decoder.table_size(), 57u);
+    ASSERT_TRUE(decode(decoder, "828684be5886a8eb10649cbf", fields));
+    EXPECT_EQ(fields, Fields({{":method", "GET"}, {":scheme", "http"}, {":path", "/"},
+                              {":authority", "www.example.com"}, {"cache-control", "no-cache"}}));
+    EXPECT_EQ(decoder.table_entries(), 2u);
+    EXPECT_EQ(decoder.table_size(), 110u);
+}
+
+TEST(DecoderTest, dynamic_table_is_used_and_resized) {
+    hpack::Decoder decoder;
+    Fields fields;
+    Fields expect({{":status", "200"}, {"content-type", "application/json"}, {"x-yahoo-vespa-totalhitcount", "42"}});
+    ASSERT_TRUE(decode(decoder, "885f8b1d75d0620d263d4c7441ea4093f2b7a1ce73addca8ac6b24e91d1399243db527023432", fields));
+    EXPECT_EQ(fields, expect);
+    ASSERT_TRUE(decode(decoder, "88bfbe", fields));
+    EXPECT_EQ(fields, expect);
+    EXPECT_EQ(decoder.table_entries(), 2u);
+    ASSERT_TRUE(decode(decoder, "208d0093f2b7a1ce73addca8ac6b24e91d1399243db527023137", fields));
+    EXPECT_EQ(fields, Fields({{":status", "404"}, {"x-yahoo-vespa-totalhitcount", "17"}}));
+    EXPECT_EQ(decoder.table_entries(), 0u);
+    EXPECT_EQ(decoder.table_size(), 0u);
+}
+
+TEST(DecoderTest, malformed_blocks_are_rejected) {
+    hpack::Decoder decoder;
+    Fields fields;
+    // index 0 is not valid
+    EXPECT_FALSE(decode(decoder, "80", fields));
+    // index beyond the dynamic table
+    EXPECT_FALSE(decode(decoder, "be", fields));
+    // string length beyond end of block
+    EXPECT_FALSE(decode(decoder, "4005616263", fields));
+    // table size update after first header field
+    EXPECT_FALSE(decode(decoder, "8220", fields));
+    // table size update larger than the settings allow
+    EXPECT_FALSE(decode(decoder, "3fe21f", fields));
+}
+
+TEST(EncoderTest, literals_can_be_decoded) {
+    std::string block;
+    hpack::encode_literal(block, ":method", "POST");
+    hpack::encode_literal(block, ":path", std::string(200, 'x'));
+    hpack::encode_literal(block, "x-yahoo-vespa-benchmarkdata", "true");
+    hpack::Decoder decoder;
+    Fields fields;
+    ASSERT_TRUE(decoder.decode(block, [&fields](const std::string &name, const std::string &value)
+                               {
+                                   fields.emplace_back(name, value);
+                               }));
+    EXPECT_EQ(fields, Fields({{":method", "POST"}, {":path", std::string(200, 'x')},
+                              {"x-yahoo-vespa-benchmarkdata", "true"}}));
+    EXPECT_EQ(decoder.table_entries(), 0u);
+}
+
+GTEST_MAIN_RUN_ALL_TESTS()
@@ -4,6 +4,7 @@
 #include <vespa/fnet/frt/supervisor.h>
 #include <vespa/fnet/frt/target.h>
 #include <vespa/fnet/frt/rpcrequest.h>
+#include <atomic>
 #include <vector>
 
 constexpr size_t ALLOC_LIMIT=1024;
@@ -18,6 +19,17 @@ struct MyBlob : FRT_ISharedBlob
     void subRef() override { --refcnt; }
 };
 
+struct BigBlob : FRT_ISharedBlob
+{
+    std::vector<char> data;
+    std::atomic<int>  refcnt;
+    BigBlob(uint32_t len, char c) : data(len, c), refcnt(1) {}
+    uint32_t getLen() override { return data.size(); }
+    const char *getData() override { return data.data(); }
+    void addRef() override { ++refcnt; }
+    void subRef() override { --refcnt; }
+};
+
 struct Data
 {
     enum {
@@ -268,4 +280,55 @@ TEST("testImplicitShared") {
     target->internal_subref();
 }
 
+struct EchoLength : public FRT_Invokable
+{
+    void RPC_echo(FRT_RPCRequest *req)
+    {
+        FRT_Values &params = *req->GetParams();
+        for (uint32_t i = 0; i < params.GetNumValues(); ++i) {
+            const FRT_DataValue &value = params[i]._data;
+            uint32_t same = 0;
+            while ((same < value._len) && (value._buf[same] == value._buf[0])) {
+                ++same;
+            }
+            req->GetReturn()->AddInt32(same);
+        }
+    }
+};
+
+TEST("require that large shared blobs are sent intact without copying") {
+    fnet::frt::StandaloneFRT frt;
+    FRT_Supervisor & orb = frt.supervisor();
+    EchoLength echo;
+    {
+        FRT_ReflectionBuilder rb(&orb);
+        rb.DefineMethod("echo", "*", "*",
+                        FRT_METHOD(EchoLength::RPC_echo), &echo);
+    }
+    orb.Listen(0);
+    int port = orb.GetListenPort();
+    ASSERT_TRUE(port != 0);
+    char tmp[64];
+    snprintf(tmp, sizeof(tmp), "tcp/localhost:%d", port);
+    FRT_Target *target = orb.GetTarget(tmp);
+    BigBlob small(100, 's');
+    BigBlob large1(3 * 1024 * 1024, 'a');
+    BigBlob large2(64 * 1024, 'b');
+    FRT_RPCRequest *req = orb.AllocRPCRequest();
+    req->SetMethodName("echo");
+    req->GetParams()->AddSharedData(&large1);
+    req->GetParams()->AddSharedData(&small);
+    req->GetParams()->AddSharedData(&large2);
+    target->InvokeSync(req, 30.0);
+    ASSERT_TRUE(req->CheckReturnTypes("iii"));
+    EXPECT_EQUAL(large1.getLen(), req->GetReturn()->GetValue(0)._intval32);
+    EXPECT_EQUAL(small.getLen(), req->GetReturn()->GetValue(1)._intval32);
+    EXPECT_EQUAL(large2.getLen(), req->GetReturn()->GetValue(2)._intval32);
+    req->internal_subref();
+    target->internal_subref();
+    EXPECT_EQUAL(1, large1.refcnt.load());
+    EXPECT_EQUAL(1, small.refcnt.load());
+    EXPECT_EQUAL(1, large2.refcnt.load());
+}
+
 TEST_MAIN() { TEST_RUN_ALL(); }
@@ -0,0 +1,72 @@
+// Copyright Vespa.ai. Licensed under the terms of the Apache 2.0 license. See LICENSE in the project root.
+
+#include <vespa/vespalib/testkit/test_kit.h>
+#include <vespa/fnet/frt/supervisor.h>
+#include <vespa/fnet/frt/target.h>
+#include <vespa/fnet/frt/rpcrequest.h>
+#include <vespa/fnet/transport.h>
+#include <vespa/vespalib/util/stringfmt.h>
+#include <thread>
+
+using namespace vespalib;
+using fnet::frt::StandaloneFRT;
+using vespalib::make_string_short::fmt;
+
+struct Fixture {
+    StandaloneFRT server;
+    StandaloneFRT client;
+    vespalib::string spec;
+    Fixture() : server(), client(), spec() {
+        ASSERT_TRUE(server.supervisor().Listen(0));
+        spec = fmt("tcp/localhost:%u", server.supervisor().GetListenPort());
+    }
+    ~Fixture();
+};
+
+Fixture::~Fixture() = default;
+
+bool wait_connected(FRT_Target *target) {
+    auto until = steady_clock::now() + 60s;
+    while (target->GetConnection()->GetState() != FNET_Connection::FNET_CONNECTED) {
+        if (steady_clock::now() > until) {
+            return false;
+        }
+        std::this_thread::sleep_for(1ms);
+    }
+    return true;
+}
+
+bool ping(FRT_Target *target) {
+    auto *req = FRT_Supervisor::AllocRPCRequest();
+    req->SetMethodName("frt.rpc.ping");
+    target->InvokeSync(req, 60.0);
+    bool ok = !req->IsError();
+    req->internal_subref();
+    return ok;
+}
+
+TEST_F("require that warm connections are connected before use and handed over once", Fixture()) {
+    f1.client.supervisor().Warmup({f1.spec});
+    EXPECT_EQUAL(f1.client.supervisor().GetNumWarmTargets(), 1u);
+    FRT_Target *target = f1.client.supervisor().GetTarget(f1.spec.c_str());
+    EXPECT_EQUAL(f1.client.supervisor().GetNumWarmTargets(), 0u);
+    EXPECT_TRUE(wait_connected(target));
+    EXPECT_TRUE(ping(target));
+    FRT_Target *other = f1.client.supervisor().GetTarget(f1.spec.c_str());
+    EXPECT_TRUE(other != target);
+    EXPECT_TRUE(ping(other));
+    other->internal_subref();
+    target->internal_subref();
+}
+
+TEST_F("require that warmup keeps exactly the given set of specs", Fixture()) {
+    auto &orb = f1.client.supervisor();
+    orb.Warmup({f1.spec, f1.spec});
+    EXPECT_EQUAL(orb.GetNumWarmTargets(), 1u);
+    orb.Warmup({f1.spec, "tcp/localhost:1"});
+    EXPECT_EQUAL(orb.GetNumWarmTargets(), 2u);
+    orb.Warmup({});
+    EXPECT_EQUAL(orb.GetNumWarmTargets(), 0u);
+}
+
+TEST_MAIN() { TEST_RUN_ALL(); }
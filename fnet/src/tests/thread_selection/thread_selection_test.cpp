@@ -1,11 +1,13 @@
 // Copyright Vespa.ai. Licensed under the terms of the Apache 2.0 license. See LICENSE in the project root.
 #include <vespa/vespalib/testkit/test_kit.h>
 #include <vespa/fnet/transport.h>
+#include <vespa/fnet/transport_thread.h>
 #include <vespa/vespalib/util/stringfmt.h>
 #include <thread>
 #include <chrono>
 #include <mutex>
 #include <map>
+#include <set>
 
 struct Fixture {
     std::mutex lock;
@@ -86,4 +88,30 @@ TEST_F("require that selection is stack location sensistive", Fixture(8))
     f1.dump_counts();
 }
 
+TEST("require that connections are handed to the thread pinned to their incoming cpu")
+{
+    FNET_Transport transport(fnet::TransportConfig(4).pin_threads({3, 5}));
+    FNET_TransportThread *on_3 = transport.select_thread_for_cpu(3, nullptr, 0);
+    FNET_TransportThread *on_5 = transport.select_thread_for_cpu(5, nullptr, 0);
+    EXPECT_EQUAL(on_3->cpu(), 3);
+    EXPECT_EQUAL(on_5->cpu(), 5);
+    EXPECT_TRUE(on_3 != on_5);
+    for (size_t i = 0; i < 64; ++i) {
+        EXPECT_EQUAL(transport.select_thread_for_cpu(3, &i, sizeof(i)), on_3);
+    }
+    std::set<FNET_TransportThread *> fallback;
+    for (int cpu: {-1, 0, 4, 100}) {
+        for (size_t i = 0; i < 64; ++i) {
+            fallback.insert(transport.select_thread_for_cpu(cpu, &i, sizeof(i)));
+        }
+    }
+    EXPECT_EQUAL(fallback.size(), 4u);
+}
+
+TEST("require that threads are not pinned by default")
+{
+    FNET_Transport transport(fnet::TransportConfig(2));
+    EXPECT_EQUAL(transport.select_thread_for_cpu(0, nullptr, 0)->cpu(), -1);
+}
+
 TEST_MAIN() { TEST_RUN_ALL(); }
@@ -10,6 +10,7 @@
 #include "transport_thread.h"
 #include "transport.h"
 #include <vespa/vespalib/net/connection_auth_context.h>
+#include <vespa/vespalib/net/socket_options.h>
 #include <vespa/vespalib/net/socket_spec.h>
 
 #include <vespa/log/log.h>
@@ -376,6 +377,7 @@ FNET_Connection::Write()
     bool     broken         = false; // is this conn broken ?
     int      my_errno       = 0;     // sample and preserve errno
     ssize_t  res;                    // single write result
+    size_t   wanted;                 // single write size
 
     FNET_Packet     *packet;
     FNET_Context     context;
@@ -384,7 +386,7 @@ FNET_Connection::Write()
 
         // fill output buffer
 
-        while (_output.GetDataLen() < chunk_size) {
+        while ((_output.GetDataLen() + _external_output.pending()) < chunk_size) {
             if (_myQueue.IsEmpty_NoLock())
                 break;
 
@@ -395,26 +397,37 @@ FNET_Connection::Write()
             packet->Free();
         }
 
-        if (_output.GetDataLen() == 0) {
+        // write data; buffered bytes up to the next external payload,
+        // then the external payload straight from where it lives
+
+        wanted = _external_output.buffered_before_next(_output.GetDataLen());
+        if (wanted > 0) {
+            res = _socket->write(_output.GetData(), wanted);
+            my_errno = errno;
+            writeCnt++;
+            if (res > 0) {
+                _output.DataToDead((uint32_t)res);
+                _external_output.consumed_buffered(res);
+                _output.resetIfEmpty();
+            }
+        } else if (!_external_output.empty()) {
+            wanted = _external_output.next_len();
+            res = _socket->write(_external_output.next_data(), wanted);
+            my_errno = errno;
+            writeCnt++;
+            if (res > 0) {
+                _external_output.consumed_external(res);
+            }
+        } else {
             res = 0;
             break;
         }
-
-        // write data
-
-        res = _socket->write(_output.GetData(), _output.GetDataLen());
-        my_errno = errno;
-        writeCnt++;
-        if (res > 0) {
-            _output.DataToDead((uint32_t)res);
-            _output.resetIfEmpty();
-        }
     } while (res > 0 &&
-             _output.GetDataLen() == 0 &&
-             !_myQueue.IsEmpty_NoLock() &&
+             size_t(res) == wanted &&
+             (_output.GetDataLen() > 0 || !_external_output.empty() || !_myQueue.IsEmpty_NoLock()) &&
              writeCnt < FNET_WRITE_REDO);
 
-    if ((_output.GetDataLen() > 0)) {
+    if ((_output.GetDataLen() > 0) || !_external_output.empty()) {
         ++my_write_work;
     }
 
@@ -486,10 +499,12 @@ FNET_Connection::FNET_Connection(FNET_TransportThread *owner,
       _input(0),
       _queue(256),
       _myQueue(256),
+      _external_output(),
       _output(0),
       _channels(),
       _callbackTarget(nullptr)
 {
+    _output.SetExternalOutput(&_external_output);
     assert(_socket && (_socket->get_fd() >= 0));
     _num_connections.fetch_add(1, std::memory_order_relaxed);
 }
@@ -516,10 +531,12 @@ FNET_Connection::FNET_Connection(FNET_TransportThread *owner,
       _input(0),
       _queue(256),
       _myQueue(256),
+      _external_output(),
       _output(0),
       _channels(),
       _callbackTarget(nullptr)
 {
+    _output.SetExternalOutput(&_external_output);
     _num_connections.fetch_add(1, std::memory_order_relaxed);
 }
 
@@ -751,6 +768,12 @@ FNET_Connection::GetPeerSpec() const
     return vespalib::SocketAddress::peer_address(_socket->get_fd()).spec();
 }
 
+uint32_t
+FNET_Connection::get_smoothed_rtt_us() const
+{
+    return vespalib::SocketOptions::get_smoothed_rtt_us(_socket->get_fd());
+}
+
 const vespalib::net::ConnectionAuthContext&
 FNET_Connection::auth_context() const noexcept
 {
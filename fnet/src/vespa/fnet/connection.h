@@ -87,6 +87,7 @@ private:
     FNET_DataBuffer          _input;           // input buffer
     FNET_PacketQueue_NoLock  _queue;           // outer output queue
     FNET_PacketQueue_NoLock  _myQueue;         // inner output queue
+    fnet::ExternalOutput     _external_output; // large payloads not copied into output buffer
     FNET_DataBuffer          _output;          // output buffer
     FNET_ChannelLookup       _channels;        // channel 'DB'
     FNET_Channel            *_callbackTarget;  // target of current callback
@@ -284,6 +285,13 @@ public:
      */
     vespalib::string GetPeerSpec() const;
 
+    /**
+     * @return the kernel estimate of the round-trip time to our peer
+     *         in microseconds, 0 if not known. Only makes sense to call
+     *         on connected sockets.
+     */
+    uint32_t get_smoothed_rtt_us() const;
+
     /**
      * Does this connection have the ability to accept incoming channels ?
      *
@@ -2,6 +2,7 @@
 
 #pragma once
 
+#include "external_output.h"
 #include <vespa/vespalib/util/compress.h>
 #include <vespa/vespalib/util/alloc.h>
 #include <cassert>
@@ -37,6 +38,7 @@ private:
     char  *_datapt;
     char  *_freept;
     Alloc  _ownedBuf;
+    fnet::ExternalOutput *_external;
 
     FNET_DataBuffer(const FNET_DataBuffer &);
     FNET_DataBuffer &operator=(const FNET_DataBuffer &);
@@ -554,6 +556,44 @@ public:
         _freept += len;
     }
 
+    /**
+     * Make this buffer able to refer to large payloads instead of
+     * copying them (see @ref WriteBytesExternal). Only buffers that
+     * are written directly to a socket should do this; the external
+     * payloads are never visible through the buffer itself.
+     *
+     * @param external where to keep track of external payloads
+     **/
+    void SetExternalOutput(fnet::ExternalOutput *external) { _external = external; }
+
+    /**
+     * @return whether a payload of the given size would be referred
+     *         to rather than copied by @ref WriteBytesExternal.
+     * @param len payload size
+     **/
+    bool WantsExternal(uint32_t len) const {
+        return ((_external != nullptr) && (len >= fnet::ExternalOutput::min_chunk_size));
+    }
+
+    /**
+     * Append bytes to the logical output stream of this buffer
+     * without copying them, keeping the owner alive until the bytes
+     * have been written. Falls back to a plain copy when this buffer
+     * does not want the payload.
+     *
+     * @param src source byte buffer.
+     * @param len number of bytes to write.
+     * @param owner keeps the source bytes alive.
+     **/
+    void WriteBytesExternal(const void *src, uint32_t len, std::shared_ptr<const void> owner)
+    {
+        if (WantsExternal(len)) {
+            _external->add(GetDataLen(), static_cast<const char *>(src), len, std::move(owner));
+        } else {
+            WriteBytes(src, len);
+        }
+    }
+
     /**
      * Read bytes from this buffer.
      *
@@ -0,0 +1,61 @@
+// Copyright Vespa.ai. Licensed under the terms of the Apache 2.0 license. See LICENSE in the project root.
+
+#include "external_output.h"
+#include <cassert>
+
+namespace fnet {
+
+ExternalOutput::ExternalOutput() noexcept
+    : _chunks(),
+      _buffered_before_last(0),
+      _pending(0)
+{
+}
+
+ExternalOutput::~ExternalOutput() = default;
+
+void
+ExternalOutput::add(size_t buffered, const char *data, size_t len, std::shared_ptr<const void> owner)
+{
+    assert(buffered >= _buffered_before_last);
+    if (len == 0) {
+        return;
+    }
+    _chunks.emplace_back(buffered - _buffered_before_last, data, len, std::move(owner));
+    _buffered_before_last = buffered;
+    _pending += len;
+}
+
+void
+ExternalOutput::consumed_buffered(size_t len) noexcept
+{
+    if (!_chunks.empty()) {
+        assert(len <= _chunks.front().bytes_before);
+        _chunks.front().bytes_before -= len;
+        _buffered_before_last -= len;
+    }
+}
+
+void
+ExternalOutput::consumed_external(size_t len)
+{
+    Chunk &chunk = _chunks.front();
+    assert(chunk.bytes_before == 0);
+    assert(len <= chunk.len);
+    chunk.data += len;
+    chunk.len -= len;
+    _pending -= len;
+    if (chunk.len == 0) {
+        _chunks.pop_front();
+    }
+}
+
+void
+ExternalOutput::clear()
+{
+    _chunks.clear();
+    _buffered_before_last = 0;
+    _pending = 0;
+}
+
+}
@@ -0,0 +1,73 @@
+// Copyright Vespa.ai. Licensed under the terms of the Apache 2.0 license. See LICENSE in the project root.
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <memory>
+
+namespace fnet {
+
+/**
+ * Keeps track of large payload chunks that are part of the output
+ * stream of a connection without having been copied into its output
+ * buffer. Each chunk remembers how many buffered bytes precede it
+ * (counted from the previous chunk), which is how the buffered and
+ * external parts of the stream are interleaved when writing. The
+ * owner of each chunk is kept alive until the chunk has been fully
+ * written.
+ **/
+class ExternalOutput
+{
+private:
+    struct Chunk {
+        size_t                      bytes_before;
+        const char                 *data;
+        size_t                      len;
+        std::shared_ptr<const void> owner;
+        Chunk(size_t bytes_before_in, const char *data_in, size_t len_in, std::shared_ptr<const void> owner_in) noexcept
+            : bytes_before(bytes_before_in), data(data_in), len(len_in), owner(std::move(owner_in)) {}
+    };
+    std::deque<Chunk> _chunks;
+    size_t            _buffered_before_last; // buffered bytes preceding the last chunk
+    size_t            _pending;              // external bytes not yet written
+
+public:
+    // payloads smaller than this are cheaper to copy than to reference
+    static constexpr uint32_t min_chunk_size = 16 * 1024;
+
+    ExternalOutput() noexcept;
+    ~ExternalOutput();
+
+    bool empty() const noexcept { return _chunks.empty(); }
+    size_t pending() const noexcept { return _pending; }
+
+    /**
+     * Add a chunk to the output stream after all currently buffered
+     * bytes.
+     *
+     * @param buffered the total number of bytes currently buffered
+     * @param data start of the chunk
+     * @param len size of the chunk
+     * @param owner keeps the chunk data alive until written
+     **/
+    void add(size_t buffered, const char *data, size_t len, std::shared_ptr<const void> owner);
+
+    /**
+     * @return how many of the buffered bytes may be written before the
+     *         next chunk must be written
+     **/
+    size_t buffered_before_next(size_t buffered) const noexcept {
+        return _chunks.empty() ? buffered : _chunks.front().bytes_before;
+    }
+    void consumed_buffered(size_t len) noexcept;
+
+    const char *next_data() const noexcept { return _chunks.front().data; }
+    size_t next_len() const noexcept { return _chunks.front().len; }
+    void consumed_external(size_t len);
+
+    void clear();
+};
+
+}
@@ -21,7 +21,9 @@ FRT_Supervisor::FRT_Supervisor(FNET_Transport *transport)
     : _transport(transport),
       _connector(nullptr),
       _reflectionManager(),
-      _rpcHooks(&_reflectionManager)
+      _rpcHooks(&_reflectionManager),
+      _warmLock(),
+      _warmTargets()
 {
     _rpcHooks.InitRPC(this);
 }
@@ -33,6 +35,9 @@ FRT_Supervisor::~FRT_Supervisor()
     if (_connector != nullptr) {
         _connector->internal_subref();
     }
+    for (const auto &entry : _warmTargets) {
+        entry.second->internal_subref();
+    }
 }
 
 FNET_Scheduler *
@@ -65,7 +70,7 @@ FRT_Supervisor::GetListenPort() const
 
 
 FRT_Target *
-FRT_Supervisor::GetTarget(const char *spec)
+FRT_Supervisor::Connect(const char *spec)
 {
     FNET_TransportThread *thread = _transport->select_thread(spec, strlen(spec));
     return new FRT_Target(thread->GetScheduler(),
@@ -73,6 +78,80 @@ FRT_Supervisor::GetTarget(const char *spec)
 }
 
 
+FRT_Target *
+FRT_Supervisor::GetTarget(const char *spec)
+{
+    FRT_Target *warm = nullptr;
+    {
+        std::lock_guard guard(_warmLock);
+        auto found = _warmTargets.find(spec);
+        if (found != _warmTargets.end()) {
+            warm = found->second;
+            _warmTargets.erase(found);
+        }
+    }
+    if (warm != nullptr) {
+        if (warm->IsValid()) {
+            return warm;
+        }
+        warm->internal_subref();
+    }
+    return Connect(spec);
+}
+
+
+void
+FRT_Supervisor::Warmup(const std::vector<vespalib::string> &specs)
+{
+    std::vector<FRT_Target *> drop;
+    std::vector<vespalib::string> missing;
+    {
+        std::lock_guard guard(_warmLock);
+        std::map<vespalib::string, FRT_Target *> keep;
+        for (const auto &spec : specs) {
+            if (keep.find(spec) != keep.end()) {
+                continue;
+            }
+            auto found = _warmTargets.find(spec);
+            if ((found != _warmTargets.end()) && found->second->IsValid()) {
+                keep.emplace(spec, found->second);
+                _warmTargets.erase(found);
+            } else {
+                missing.push_back(spec);
+                keep.emplace(spec, nullptr);
+            }
+        }
+        for (const auto &entry : _warmTargets) {
+            drop.push_back(entry.second);
+        }
+        _warmTargets.clear();
+        for (const auto &entry : keep) {
+            if (entry.second != nullptr) {
+                _warmTargets.emplace(entry.first, entry.second);
+            }
+        }
+    }
+    for (const auto &spec : missing) {
+        FRT_Target *target = Connect(spec.c_str());
+        std::lock_guard guard(_warmLock);
+        if (!_warmTargets.emplace(spec, target).second) {
+            drop.push_back(target); // raced with another warmup
+        }
+    }
+    for (FRT_Target *target : drop) {
+        target->internal_subref();
+    }
+}
+
+
+size_t
+FRT_Supervisor::GetNumWarmTargets() const
+{
+    std::lock_guard guard(_warmLock);
+    return _warmTargets.size();
+}
+
+
 FRT_Target *
 FRT_Supervisor::Get2WayTarget(const char *spec, FNET_Context connContext)
 {
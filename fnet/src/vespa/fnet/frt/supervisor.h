@@ -9,6 +9,10 @@
 #include <vespa/fnet/ipackethandler.h>
 #include <vespa/fnet/connection.h>
 #include <vespa/fnet/simplepacketstreamer.h>
+#include <vespa/vespalib/stllike/string.h>
+#include <map>
+#include <mutex>
+#include <vector>
 
 namespace fnet { class TransportConfig; }
 class FNET_Transport;
@@ -46,8 +50,11 @@ private:
     FNET_Connector               *_connector;
     FRT_ReflectionManager         _reflectionManager;
     RPCHooks                      _rpcHooks;
+    mutable std::mutex            _warmLock;
+    std::map<vespalib::string, FRT_Target *> _warmTargets;
 
     static FNET_IPacketStreamer *get_packet_streamer();
+    FRT_Target *Connect(const char *spec);
 
 public:
     explicit FRT_Supervisor(FNET_Transport *transport);
@@ -66,6 +73,20 @@ public:
     FRT_Target *GetTarget(const char *spec);
     FRT_Target *Get2WayTarget(const char *spec, FNET_Context connContext = FNET_Context());
     FRT_Target *GetTarget(int port);
+
+    /**
+     * Keep connections to the given specs ready, including any TLS
+     * handshake, before there is traffic to them. A warm connection is
+     * handed over to the first GetTarget call for its spec, after which
+     * the spec is no longer kept warm unless passed here again. Warm
+     * connections to specs not in the given set are closed, and broken
+     * ones are replaced.
+     *
+     * @param specs the connection specs expected to be used soon
+     **/
+    void Warmup(const std::vector<vespalib::string> &specs);
+    size_t GetNumWarmTargets() const;
+
     static FRT_RPCRequest *AllocRPCRequest(FRT_RPCRequest *tradein = nullptr);
 
     struct SchedulerPtr {
@@ -1234,6 +1234,30 @@ error:
 }
 
 
+bool
+FRT_Values::EncodeExternal(FNET_DataBuffer *dst, uint32_t idx)
+{
+    const FRT_DataValue &value = _values[idx]._data;
+    if (!dst->WantsExternal(value._len)) {
+        return false;
+    }
+    // Only blobs shared by the application may outlive these values;
+    // local blobs are released together with the owning request.
+    for (BlobRef *ref = _blobs; ref != nullptr; ref = ref->_next) {
+        FRT_ISharedBlob *blob = ref->_blob;
+        if ((ref->_value == nullptr) && (ref->_idx == idx) && (blob != nullptr) &&
+            (dynamic_cast<LocalBlob *>(blob) == nullptr) &&
+            (value._buf == blob->getData()) && (value._len == blob->getLen()))
+        {
+            blob->addRef();
+            std::shared_ptr<const void> owner(blob->getData(), [blob](const void *) { blob->subRef(); });
+            dst->WriteBytesExternal(value._buf, value._len, std::move(owner));
+            return true;
+        }
+    }
+    return false;
+}
+
 void
 FRT_Values::EncodeCopy(FNET_DataBuffer *dst)
 {
@@ -1352,8 +1376,10 @@ FRT_Values::EncodeCopy(FNET_DataBuffer *dst)
 
         case FRT_VALUE_DATA:
             dst->WriteBytesFast(&(_values[i]._data._len), sizeof(uint32_t));
-            dst->WriteBytesFast(_values[i]._data._buf,
-                                _values[i]._data._len);
+            if (!EncodeExternal(dst, i)) {
+                dst->WriteBytesFast(_values[i]._data._buf,
+                                    _values[i]._data._len);
+            }
             break;
 
         case FRT_VALUE_DATA_ARRAY:
@@ -1502,8 +1528,10 @@ FRT_Values::EncodeBig(FNET_DataBuffer *dst)
 
         case FRT_VALUE_DATA:
             dst->WriteInt32Fast(_values[i]._data._len);
-            dst->WriteBytesFast(_values[i]._data._buf,
-                                _values[i]._data._len);
+            if (!EncodeExternal(dst, i)) {
+                dst->WriteBytesFast(_values[i]._data._buf,
+                                    _values[i]._data._len);
+            }
             break;
 
         case FRT_VALUE_DATA_ARRAY:
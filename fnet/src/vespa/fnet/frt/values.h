@@ -95,6 +95,8 @@ private:
     fnet::BlobRef *_blobs;
     Stash         &_stash;
 
+    bool EncodeExternal(FNET_DataBuffer *dst, uint32_t idx);
+
 public:
     FRT_Values(const FRT_Values &) = delete;
     FRT_Values &operator=(const FRT_Values &) = delete;
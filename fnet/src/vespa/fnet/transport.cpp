@@ -107,7 +107,8 @@ TransportConfig::TransportConfig(int num_threads)
       _resolver(),
       _crypto(),
       _time_tools(),
-      _num_threads(num_threads)
+      _num_threads(num_threads),
+      _cpus()
 {}
 
 TransportConfig::~TransportConfig() = default;
@@ -140,14 +141,25 @@ FNET_Transport::FNET_Transport(const fnet::TransportConfig &cfg)
       _time_tools(cfg.time_tools()),
       _work_pool(std::make_unique<vespalib::ThreadStackExecutor>(1, fnet_work_pool, 1024)),
       _threads(),
+      _cpu_threads(),
       _pool(),
       _config(cfg.config())
 {
     // TODO Temporary logging to track down overspend
     LOG(debug, "FNET_Transport threads=%d from :%s", cfg.num_threads(), vespalib::getStackTrace(0).c_str());
     assert(cfg.num_threads() >= 1);
+    const auto &cpus = cfg.cpus();
     for (size_t i = 0; i < cfg.num_threads(); ++i) {
-        _threads.emplace_back(std::make_unique<FNET_TransportThread>(*this));
+        int cpu = cpus.empty() ? -1 : cpus[i % cpus.size()];
+        _threads.emplace_back(std::make_unique<FNET_TransportThread>(*this, cpu));
+        if (cpu >= 0) {
+            if (size_t(cpu) >= _cpu_threads.size()) {
+                _cpu_threads.resize(cpu + 1, nullptr);
+            }
+            if (_cpu_threads[cpu] == nullptr) {
+                _cpu_threads[cpu] = _threads.back().get();
+            }
+        }
     }
 }
 
@@ -192,6 +204,15 @@ FNET_Transport::select_thread(const void *key, size_t key_len) const
     return _threads[thread_id].get();
 }
 
+FNET_TransportThread *
+FNET_Transport::select_thread_for_cpu(int cpu, const void *key, size_t key_len) const
+{
+    if ((cpu >= 0) && (size_t(cpu) < _cpu_threads.size()) && (_cpu_threads[cpu] != nullptr)) {
+        return _cpu_threads[cpu];
+    }
+    return select_thread(key, key_len);
+}
+
 FNET_Connector *
 FNET_Transport::Listen(const char *spec, FNET_IPacketStreamer *streamer,
                        FNET_IServerAdapter *serverAdapter)
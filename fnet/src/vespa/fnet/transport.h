@@ -61,6 +61,7 @@ public:
 
     const FNET_Config & config() const { return _config; }
     uint32_t num_threads() const { return _num_threads; }
+    const std::vector<int> &cpus() const { return _cpus; }
 
     TransportConfig & events_before_wakeup(uint32_t v) {
         if (v > 1) {
@@ -84,6 +85,18 @@ public:
         _config._drop_empty_buffers = v;
         return *this;
     }
+    // Use io_uring instead of epoll to wait for io-events, if supported
+    TransportConfig &io_uring(bool v) {
+        _config._io_uring = v;
+        return *this;
+    }
+    // Pin transport thread i to cpus[i % cpus.size()]. Incoming
+    // connections are handed to the thread pinned to the cpu that
+    // received their packets (SO_INCOMING_CPU), if any.
+    TransportConfig &pin_threads(std::vector<int> cpus) {
+        _cpus = std::move(cpus);
+        return *this;
+    }
 
 private:
     FNET_Config                 _config;
@@ -91,6 +104,7 @@ private:
     vespalib::CryptoEngine::SP  _crypto;
     fnet::TimeTools::SP         _time_tools;
     uint32_t                    _num_threads;
+    std::vector<int>            _cpus;
 };
 
 } // fnet
@@ -111,6 +125,7 @@ private:
     fnet::TimeTools::SP         _time_tools;
     std::unique_ptr<vespalib::SyncableThreadExecutor> _work_pool;
     Threads                     _threads;
+    std::vector<FNET_TransportThread*> _cpu_threads; // indexed by pinned cpu
     vespalib::ThreadPool        _pool;
     const FNET_Config           _config;
 
@@ -195,6 +210,16 @@ public:
      **/
     FNET_TransportThread *select_thread(const void *key, size_t key_len) const;
 
+    /**
+     * Select the transport thread pinned to the given cpu. If no
+     * transport thread is pinned to the cpu, select one based on the
+     * given key instead (see select_thread).
+     *
+     * @return selected transport thread
+     * @param cpu the cpu to select a thread for, -1 if unknown
+     **/
+    FNET_TransportThread *select_thread_for_cpu(int cpu, const void *key, size_t key_len) const;
+
     /**
      * Add a network listener in an abstract way. The given 'spec'
      * string has the following format: 'type/where'. 'type' specifies
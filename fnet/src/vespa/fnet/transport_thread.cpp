@@ -11,6 +11,7 @@
 #include <vespa/vespalib/net/server_socket.h>
 #include <vespa/vespalib/util/atomic.h>
 #include <vespa/vespalib/util/gate.h>
+#include <vespa/vespalib/util/thread.h>
 #include <csignal>
 
 #include <vespa/log/log.h>
@@ -225,8 +226,9 @@ extern "C" {
 
 } // extern "C"
 
-FNET_TransportThread::FNET_TransportThread(FNET_Transport &owner_in)
+FNET_TransportThread::FNET_TransportThread(FNET_Transport &owner_in, int cpu)
     : _owner(owner_in),
+      _cpu(cpu),
       _now(owner_in.time_tools().current_time()),
       _scheduler(&_now),
       _componentsHead(nullptr),
@@ -234,7 +236,7 @@ FNET_TransportThread::FNET_TransportThread(FNET_Transport &owner_in)
       _componentsTail(nullptr),
       _componentCnt(0),
       _deleteList(nullptr),
-      _selector(),
+      _selector(owner_in.getConfig()._io_uring),
       _queue(),
       _myQueue(),
       _lock(),
@@ -618,6 +620,9 @@ FNET_TransportThread::Main()
 void
 FNET_TransportThread::run()
 {
+    if ((_cpu >= 0) && !vespalib::thread::pin_current_to_cpu(_cpu)) {
+        LOG(warning, "Transport: Run: Could not pin event loop to cpu %d", _cpu);
+    }
     if (!InitEventLoop()) {
         LOG(warning, "Transport: Run: Could not init event loop");
         return;
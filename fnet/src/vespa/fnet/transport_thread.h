@@ -35,6 +35,7 @@ public:
 
 private:
     FNET_Transport          &_owner;          // owning transport layer
+    int                      _cpu;            // cpu to pin the event loop to, -1 if none
     vespalib::steady_time    _now;            // current time sampler
     FNET_Scheduler           _scheduler;      // transport thread scheduler
     FNET_IOComponent        *_componentsHead; // I/O component list head
@@ -188,8 +189,9 @@ public:
      * current thread become the transport thread.
      *
      * @param owner owning transport layer
+     * @param cpu the cpu to pin the event loop to, -1 for none
      **/
-    explicit FNET_TransportThread(FNET_Transport &owner_in);
+    explicit FNET_TransportThread(FNET_Transport &owner_in, int cpu = -1);
 
 
     /**
@@ -206,6 +208,14 @@ public:
      **/
     FNET_Transport &owner() const { return _owner; }
 
+    /**
+     * Obtain the cpu the event loop of this transport thread is
+     * pinned to.
+     *
+     * @return pinned cpu, or -1 if not pinned
+     **/
+    int cpu() const { return _cpu; }
+
     /**
      * Tune the given socket handle to be used as an async transport
      * connection.
@@ -8,7 +8,7 @@
  *
  */
 
-#include <list>
+#include <vector>
 #include <algorithm>
 #include <cmath>
 
@@ -19,13 +19,23 @@
 
 namespace fsa {
 
-// {{{ Detector::detect
+// {{{ detectBatched
 
-void Detector::detect(const NGram &text, Detector::Hits &hits,
-                      unsigned int from, int length) const
+namespace {
+
+/**
+ * Runs one detector state per start position. The active states are kept
+ * in a contiguous vector, and all of them are advanced by one word in a
+ * batch before moving to the next word. States that are no longer valid
+ * are dropped by copying the surviving ones to a second vector, so no
+ * allocation is needed per word once the vectors have grown.
+ */
+template <typename StateType>
+void detectBatched(const FSA &dictionary, const NGram &text, Detector::Hits &hits,
+                   unsigned int from, int length)
 {
-  std::list<FSA::WordCounterState>            detectors;
-  std::list<FSA::WordCounterState>::iterator  det_it;
+  std::vector<StateType> detectors;
+  std::vector<StateType> survivors;
   unsigned int i,to;
 
   to = text.length();
@@ -34,25 +44,30 @@ void Detector::detect(const NGram &text, Detector::Hits &hits,
 
   i=from;
   while(i<to){
-    detectors.push_back(FSA::WordCounterState(_dictionary));
-
-    det_it=detectors.begin();
-    while(det_it!=detectors.end()){
-      det_it->deltaWord(text[i]);
-      if(det_it->isFinal()){
-        hits.add(text, i-det_it->getCounter()+1, det_it->getCounter(), *det_it);
-      }
-
-      if(det_it->isValid())
-        ++det_it;
-      else{
-        det_it=detectors.erase(det_it);
+    detectors.emplace_back(dictionary);
+    survivors.clear();
+    for(auto &det : detectors){
+      det.deltaWord(text[i]);
+      if(det.isFinal()){
+        hits.add(text, i-det.getCounter()+1, det.getCounter(), det);
       }
+      if(det.isValid())
+        survivors.push_back(det);
     }
+    detectors.swap(survivors);
     ++i;
   }
+}
+
+}
+
+// }}}
+// {{{ Detector::detect
 
-  detectors.clear();
+void Detector::detect(const NGram &text, Detector::Hits &hits,
+                      unsigned int from, int length) const
+{
+  detectBatched<FSA::WordCounterState>(_dictionary, text, hits, from, length);
 }
 
 // }}}
@@ -61,35 +76,7 @@ void Detector::detect(const NGram &text, Detector::Hits &hits,
 void Detector::detectWithHash(const NGram &text, Detector::Hits &hits,
                               unsigned int from, int length) const
 {
-  std::list<FSA::HashedWordCounterState>            detectors;
-  std::list<FSA::HashedWordCounterState>::iterator  det_it;
-  unsigned int i,to;
-
-  to = text.length();
-  if(length!=-1 && from+length<to)
-    to=from+length;
-
-  i=from;
-  while(i<to){
-    detectors.push_back(FSA::HashedWordCounterState(_dictionary));
-
-    det_it=detectors.begin();
-    while(det_it!=detectors.end()){
-      det_it->deltaWord(text[i]);
-      if(det_it->isFinal()){
-        hits.add(text, i-det_it->getCounter()+1, det_it->getCounter(), *det_it);
-      }
-
-      if(det_it->isValid())
-        ++det_it;
-      else{
-        det_it=detectors.erase(det_it);
-      }
-    }
-    ++i;
-  }
-
-  detectors.clear();
+  detectBatched<FSA::HashedWordCounterState>(_dictionary, text, hits, from, length);
 }
 
 // }}}
@@ -10,9 +10,24 @@ LOG_SETUP("");
 
 using cloud::config::log::LogdConfig;
 using ns_log::Logger;
+using vespalib::compression::CompressionConfig;
 
 namespace logdemon {
 
+namespace {
+
+CompressionConfig::Type
+derive_compression(LogdConfig::Logserver::Compression compression)
+{
+    switch (compression) {
+    case LogdConfig::Logserver::Compression::LZ4:  return CompressionConfig::LZ4;
+    case LogdConfig::Logserver::Compression::ZSTD: return CompressionConfig::ZSTD;
+    default: return CompressionConfig::NONE;
+    }
+}
+
+}
+
 void
 ConfigSubscriber::configure(std::unique_ptr<LogdConfig> cfg)
 {
@@ -25,6 +40,19 @@ ConfigSubscriber::configure(std::unique_ptr<LogdConfig> cfg)
         _use_logserver = newconf.logserver.use;
         _need_new_forwarder = true;
     }
+    auto compression = derive_compression(newconf.logserver.compression);
+    if (compression != _compression) {
+        _compression = compression;
+        _need_new_forwarder = true;
+    }
+    if (newconf.logserver.maxbytesperrequest > 0) {
+        if (size_t(newconf.logserver.maxbytesperrequest) != _max_bytes_per_request) {
+            _max_bytes_per_request = newconf.logserver.maxbytesperrequest;
+            _need_new_forwarder = true;
+        }
+    } else {
+        LOG(config, "bad logserver.maxbytesperrequest=%d must be positive", newconf.logserver.maxbytesperrequest);
+    }
     _state_port = newconf.stateport;
 
     ForwardMap forwardMap;
@@ -95,6 +123,8 @@ ConfigSubscriber::ConfigSubscriber(const config::ConfigUri& configUri)
       _remove_meg(INT_MAX),
       _remove_age(std::chrono::hours(30*24)),
       _use_logserver(true),
+      _compression(CompressionConfig::NONE),
+      _max_bytes_per_request(RpcForwarder::default_max_bytes_per_request),
       _subscriber(configUri.getContext()),
       _handle(),
       _has_available(false),
@@ -120,8 +150,10 @@ ConfigSubscriber::make_forwarder(Metrics& metrics)
 {
     std::unique_ptr<Forwarder> result;
     if (_use_logserver) {
+        // Level 3 gives fast (non-HC) lz4 and the default zstd level, keeping logd cpu usage low
         result = std::make_unique<RpcForwarder>(metrics, _forward_filter, _server.supervisor(), _logserver_host,
-                                                _logserver_rpc_port, 60.0, 100);
+                                                _logserver_rpc_port, 60.0, 100, _max_bytes_per_request,
+                                                CompressionConfig(_compression, 3, 90));
     } else {
         result = std::make_unique<EmptyForwarder>(metrics);
     }
@@ -6,6 +6,7 @@
 #include <vespa/config/subscription/configsubscriber.h>
 #include <vespa/config/subscription/configuri.h>
 #include <vespa/fnet/frt/supervisor.h>
+#include <vespa/vespalib/util/compressionconfig.h>
 #include <vespa/vespalib/util/time.h>
 
 namespace logdemon {
@@ -26,6 +27,8 @@ private:
     int _remove_meg;
     vespalib::duration _remove_age;
     bool _use_logserver;
+    vespalib::compression::CompressionConfig::Type _compression;
+    size_t _max_bytes_per_request;
     config::ConfigSubscriber _subscriber;
     config::ConfigHandle<cloud::config::log::LogdConfig>::UP _handle;
     bool _has_available;
@@ -6,6 +6,7 @@
 #include "rpc_forwarder.h"
 #include <vespa/log/exceptions.h>
 #include <vespa/vespalib/util/buffer.h>
+#include <vespa/vespalib/util/compressor.h>
 #include <vespa/vespalib/util/stringfmt.h>
 #include <vespa/fnet/frt/rpcrequest.h>
 #include <vespa/fnet/frt/supervisor.h>
@@ -17,6 +18,7 @@ LOG_SETUP(".logd.rpc_forwarder");
 
 using ns_log::BadLogLineException;
 using ns_log::LogMessage;
+using vespalib::compression::CompressionConfig;
 using vespalib::make_string;
 
 namespace logdemon {
@@ -56,13 +58,17 @@ RpcForwarder::ping_logserver()
 
 RpcForwarder::RpcForwarder(Metrics& metrics, const ForwardMap& forward_filter, FRT_Supervisor& supervisor,
                            const vespalib::string &hostname, int rpc_port,
-                           double rpc_timeout_secs, size_t max_messages_per_request)
+                           double rpc_timeout_secs, size_t max_messages_per_request,
+                           size_t max_bytes_per_request, CompressionConfig compression)
     : _metrics(metrics),
       _connection_spec(make_string("tcp/%s:%d", hostname.c_str(), rpc_port)),
       _rpc_timeout_secs(rpc_timeout_secs),
       _max_messages_per_request(max_messages_per_request),
+      _max_bytes_per_request(max_bytes_per_request),
+      _compression(compression),
       _target(supervisor.GetTarget(_connection_spec.c_str())),
       _messages(),
+      _pending_bytes(0),
       _bad_lines(0),
       _forward_filter(forward_filter)
 {
@@ -74,25 +80,32 @@ RpcForwarder::~RpcForwarder() = default;
 namespace {
 
 void
-encode_log_request(const ProtoConverter::ProtoLogRequest& src, FRT_RPCRequest& dst)
+encode_log_request(const ProtoConverter::ProtoLogRequest& src, CompressionConfig compression, FRT_RPCRequest& dst)
 {
     dst.SetMethodName("vespa.logserver.archiveLogMessages");
     auto buf = src.SerializeAsString();
+    // Falls back to no compression (type 0) if the batch does not compress well enough
+    vespalib::compression::Compress compressed(compression, buf.data(), buf.size());
     auto& params = *dst.GetParams();
-    params.AddInt8(0); // '0' indicates no compression
+    params.AddInt8(compressed.type());
     params.AddInt32(buf.size());
-    params.AddData(buf.data(), buf.size());
+    params.AddData(compressed.data(), compressed.size());
 }
 
 bool
 decode_log_response(FRT_RPCRequest& src, ProtoConverter::ProtoLogResponse& dst)
 {
     auto& values = *src.GetReturn();
-    uint8_t encoding = values[0]._intval8;
-    assert(encoding == 0); // Not using compression
+    auto encoding = CompressionConfig::toType(values[0]._intval8);
     uint32_t uncompressed_size = values[1]._intval32;
-    (void) uncompressed_size;
-    return dst.ParseFromArray(values[2]._data._buf, values[2]._data._len);
+    try {
+        vespalib::compression::Decompress decompressed(encoding, uncompressed_size,
+                                                       values[2]._data._buf, values[2]._data._len);
+        return dst.ParseFromArray(decompressed.data(), decompressed.size());
+    } catch (std::exception &e) {
+        LOG(debug, "Failed to decompress response from logserver: %s", e.what());
+        return false;
+    }
 }
 
 bool
@@ -121,7 +134,8 @@ RpcForwarder::forwardLine(std::string_view line)
     _metrics.countLine(ns_log::Logger::logLevelNames[message.level()], message.service());
     if (should_forward_log_message(message, _forward_filter)) {
         _messages.push_back(std::move(message));
-        if (_messages.size() == _max_messages_per_request) {
+        _pending_bytes += line.size();
+        if ((_messages.size() >= _max_messages_per_request) || (_pending_bytes >= _max_bytes_per_request)) {
             flush();
         }
     }
@@ -136,7 +150,7 @@ RpcForwarder::flush()
     ProtoConverter::ProtoLogRequest proto_request;
     ProtoConverter::log_messages_to_proto(_messages, proto_request);
     GuardedRequest request;
-    encode_log_request(proto_request, *request);
+    encode_log_request(proto_request, _compression, *request);
     _target->InvokeSync(request.get(), _rpc_timeout_secs);
     if (!request->CheckReturnTypes("bix")) {
         auto error_msg = make_string("Error in rpc reply from logserver ('%s'): '%s'",
@@ -151,6 +165,7 @@ RpcForwarder::flush()
         throw DecodeException(error_msg);
     }
     _messages.clear();
+    _pending_bytes = 0;
 }
 
 int
@@ -6,6 +6,7 @@
 #include "proto_converter.h"
 #include <vespa/log/log_message.h>
 #include <vespa/fnet/frt/target.h>
+#include <vespa/vespalib/util/compressionconfig.h>
 #include <memory>
 #include <vector>
 
@@ -24,6 +25,9 @@ using RpcTargetGuard = std::unique_ptr<FRT_Target, RpcTargetSubRef>;
 
 /**
  * Implementation of the Forwarder interface that uses RPC to send protobuf encoded log messages to the logserver.
+ *
+ * Messages are sent in batches bounded by both number of messages and (uncompressed) bytes,
+ * and each batch is compressed according to the given compression config.
  */
 class RpcForwarder : public Forwarder {
 private:
@@ -31,17 +35,24 @@ private:
     vespalib::string _connection_spec;
     double _rpc_timeout_secs;
     size_t _max_messages_per_request;
+    size_t _max_bytes_per_request;
+    vespalib::compression::CompressionConfig _compression;
     RpcTargetGuard _target;
     std::vector<ns_log::LogMessage> _messages;
+    size_t _pending_bytes;
     int _bad_lines;
     ForwardMap _forward_filter;
 
     void ping_logserver();
 
 public:
+    static constexpr size_t default_max_bytes_per_request = 1024 * 1024;
+
     RpcForwarder(Metrics& metrics, const ForwardMap& forward_filter, FRT_Supervisor& supervisor,
                  const vespalib::string& logserver_host, int logserver_rpc_port,
-                 double rpc_timeout_secs, size_t max_messages_per_request);
+                 double rpc_timeout_secs, size_t max_messages_per_request,
+                 size_t max_bytes_per_request = default_max_bytes_per_request,
+                 vespalib::compression::CompressionConfig compression = vespalib::compression::CompressionConfig());
     ~RpcForwarder() override;
 
     // Implements Forwarder
@@ -7,10 +7,12 @@
 #include <vespa/vespalib/metrics/dummy_metrics_manager.h>
 #include <vespa/fnet/frt/supervisor.h>
 #include <vespa/fnet/frt/rpcrequest.h>
+#include <vespa/vespalib/util/compressor.h>
 
 
 
 using namespace logdemon;
+using vespalib::compression::CompressionConfig;
 using vespalib::metrics::DummyMetricsManager;
 
 void
@@ -23,13 +25,15 @@ encode_log_response(const ProtoConverter::ProtoLogResponse& src, FRT_Values& dst
 }
 
 bool
-decode_log_request(FRT_Values& src, ProtoConverter::ProtoLogRequest& dst)
+decode_log_request(FRT_Values& src, ProtoConverter::ProtoLogRequest& dst, std::vector<uint8_t>& encodings)
 {
     uint8_t encoding = src[0]._intval8;
-    assert(encoding == 0);
+    encodings.push_back(encoding);
     uint32_t uncompressed_size = src[1]._intval32;
-    assert(uncompressed_size == src[2]._data._len);
-    return dst.ParseFromArray(src[2]._data._buf, src[2]._data._len);
+    vespalib::compression::Decompress decompressed(CompressionConfig::toType(encoding), uncompressed_size,
+                                                   src[2]._data._buf, src[2]._data._len);
+    assert(uncompressed_size == decompressed.size());
+    return dst.ParseFromArray(decompressed.data(), decompressed.size());
 }
 
 std::string garbage("garbage");
@@ -38,6 +42,7 @@ struct RpcServer : public FRT_Invokable {
     fnet::frt::StandaloneFRT server;
     int request_count;
     std::vector<std::string> messages;
+    std::vector<uint8_t> encodings;
     bool reply_with_error;
     bool reply_with_proto_response;
 
@@ -49,7 +54,7 @@ public:
     }
     void rpc_archive_log_messages(FRT_RPCRequest* request) {
         ProtoConverter::ProtoLogRequest proto_request;
-        ASSERT_TRUE(decode_log_request(*request->GetParams(), proto_request));
+        ASSERT_TRUE(decode_log_request(*request->GetParams(), proto_request, encodings));
         ++request_count;
         for (const auto& message : proto_request.log_messages()) {
             messages.push_back(message.payload());
@@ -74,6 +79,7 @@ RpcServer::RpcServer()
     : server(),
       request_count(0),
       messages(),
+      encodings(),
       reply_with_error(false),
       reply_with_proto_response(true)
 {
@@ -128,11 +134,13 @@ struct RpcForwarderTest : public ::testing::Test {
     Metrics metrics;
     ClientSupervisor supervisor;
     RpcForwarder forwarder;
-    RpcForwarderTest()
+    RpcForwarderTest(size_t max_bytes_per_request = RpcForwarder::default_max_bytes_per_request,
+                     CompressionConfig compression = CompressionConfig())
         : server(),
           metrics_mgr(std::make_shared<MockMetricsManager>()),
           metrics(metrics_mgr),
-          forwarder(metrics, make_forward_filter(), supervisor.get(), "localhost", server.get_listen_port(), 60.0, 3)
+          forwarder(metrics, make_forward_filter(), supervisor.get(), "localhost", server.get_listen_port(), 60.0, 3,
+                    max_bytes_per_request, compression)
     {
     }
     void forward_line(const std::string& payload) {
@@ -250,5 +258,48 @@ TEST_F(RpcForwarderTest, throws_when_rpc_reply_does_not_contain_proto_response)
     EXPECT_THROW(flush(), logdemon::DecodeException);
 }
 
+TEST_F(RpcForwarderTest, sends_uncompressed_rpc_by_default)
+{
+    forward_line("a");
+    flush();
+    expect_messages(1, {"a"});
+    EXPECT_EQ(std::vector<uint8_t>({CompressionConfig::NONE}), server.encodings);
+}
+
+struct RpcForwarderMaxBytesTest : public RpcForwarderTest {
+    RpcForwarderMaxBytesTest() : RpcForwarderTest(make_log_line("info", "a").size() * 2) {}
+};
+
+TEST_F(RpcForwarderMaxBytesTest, automatically_sends_rpc_when_max_bytes_limit_is_reached)
+{
+    forward_line("a");
+    expect_messages();
+    forward_line("b");
+    expect_messages(1, {"a", "b"});
+}
+
+struct RpcForwarderCompressionTest : public RpcForwarderTest {
+    RpcForwarderCompressionTest() : RpcForwarderTest(RpcForwarder::default_max_bytes_per_request,
+                                                     CompressionConfig(CompressionConfig::ZSTD, 3, 90)) {}
+};
+
+TEST_F(RpcForwarderCompressionTest, sends_compressed_rpc_when_log_messages_compress_well)
+{
+    std::string payload(1000, 'x');
+    forward_line(payload);
+    forward_line(payload);
+    flush();
+    expect_messages(1, {payload, payload});
+    EXPECT_EQ(std::vector<uint8_t>({CompressionConfig::ZSTD}), server.encodings);
+}
+
+TEST_F(RpcForwarderCompressionTest, sends_uncompressed_rpc_when_log_messages_do_not_compress)
+{
+    forward_line("a");
+    flush();
+    expect_messages(1, {"a"});
+    EXPECT_EQ(std::vector<uint8_t>({CompressionConfig::NONE}), server.encodings);
+}
+
 GTEST_MAIN_RUN_ALL_TESTS()
 
@@ -1,6 +1,8 @@
 // Copyright Vespa.ai. Licensed under the terms of the Apache 2.0 license. See LICENSE in the project root.
 package ai.vespa.logserver.protocol;
 
+import com.yahoo.compress.CompressionType;
+import com.yahoo.compress.Compressor;
 import com.yahoo.jrt.DataValue;
 import com.yahoo.jrt.ErrorCode;
 import com.yahoo.jrt.Int32Value;
@@ -10,6 +12,7 @@ import com.yahoo.jrt.Request;
 import com.yahoo.logserver.LogDispatcher;
 import com.yahoo.security.tls.Capability;
 
+import java.util.Optional;
 import java.util.concurrent.Executor;
 import java.util.concurrent.Executors;
 import java.util.logging.Level;
@@ -35,7 +38,7 @@ public class ArchiveLogMessagesMethod {
         this.method = new Method(METHOD_NAME, "bix", "bix", this::log)
                 .requireCapabilities(Capability.LOGSERVER_API)
                 .methodDesc("Archive log messages")
-                .paramDesc(0, "compressionType", "Compression type (0=raw)")
+                .paramDesc(0, "compressionType", "Compression type (0=raw, 6=lz4, 7=zstd)")
                 .paramDesc(1, "uncompressedSize", "Uncompressed size")
                 .paramDesc(2, "logRequest", "Log request encoded with protobuf")
                 .returnDesc(0, "compressionType", "Compression type (0=raw)")
@@ -53,6 +56,8 @@ public class ArchiveLogMessagesMethod {
     }
 
     private static class ArchiveLogMessagesTask implements Runnable {
+        private static final Compressor compressor = new Compressor();
+
         final Request rpcRequest;
         final LogDispatcher logDispatcher;
 
@@ -64,14 +69,20 @@ public class ArchiveLogMessagesMethod {
         @Override
         public void run() {
             try {
-                byte compressionType = rpcRequest.parameters().get(0).asInt8();
-                if (compressionType != 0) {
-                    rpcRequest.setError(ErrorCode.METHOD_FAILED, "Invalid compression type: " + compressionType);
+                byte compressionTypeCode = rpcRequest.parameters().get(0).asInt8();
+                CompressionType compressionType;
+                try {
+                    compressionType = CompressionType.valueOf(compressionTypeCode);
+                } catch (IllegalArgumentException e) {
+                    rpcRequest.setError(ErrorCode.METHOD_FAILED, "Invalid compression type: " + compressionTypeCode);
                     rpcRequest.returnRequest();
                     return;
                 }
                 int uncompressedSize = rpcRequest.parameters().get(1).asInt32();
-                byte[] logRequestPayload = rpcRequest.parameters().get(2).asData();
+                byte[] payload = rpcRequest.parameters().get(2).asData();
+                byte[] logRequestPayload = compressionType.isCompressed()
+                        ? compressor.decompress(compressionType, payload, 0, uncompressedSize, Optional.of(payload.length))
+                        : payload;
                 if (uncompressedSize != logRequestPayload.length) {
                     rpcRequest.setError(ErrorCode.METHOD_FAILED, String.format("Invalid uncompressed size: got %d while data is of size %d ", uncompressedSize, logRequestPayload.length));
                     rpcRequest.returnRequest();
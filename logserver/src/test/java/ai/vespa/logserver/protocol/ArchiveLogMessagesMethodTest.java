@@ -1,6 +1,8 @@
 // Copyright Vespa.ai. Licensed under the terms of the Apache 2.0 license. See LICENSE in the project root.
 package ai.vespa.logserver.protocol;
 
+import com.yahoo.compress.CompressionType;
+import com.yahoo.compress.Compressor;
 import com.yahoo.jrt.DataValue;
 import com.yahoo.jrt.Int32Value;
 import com.yahoo.jrt.Int8Value;
@@ -53,6 +55,21 @@ public class ArchiveLogMessagesMethodTest {
         verify(logDispatcher).flush();
     }
 
+    @Test
+    public void server_dispatches_log_messages_from_compressed_log_request() {
+        List<LogMessage> messages = List.of(MESSAGE_1, MESSAGE_2);
+        LogDispatcher logDispatcher = mock(LogDispatcher.class);
+        try (RpcServer server = new RpcServer(0)) {
+            server.addMethod(new ArchiveLogMessagesMethod(logDispatcher).methodDefinition());
+            server.start();
+            try (TestClient client = new TestClient(server.listenPort())) {
+                client.logMessages(messages, CompressionType.ZSTD);
+            }
+        }
+        verify(logDispatcher).handle(new ArrayList<>(messages));
+        verify(logDispatcher).flush();
+    }
+
     private static class TestClient implements AutoCloseable {
 
         private final Supervisor supervisor;
@@ -64,11 +81,16 @@ public class ArchiveLogMessagesMethodTest {
         }
 
         void logMessages(List<LogMessage> messages) {
+            logMessages(messages, CompressionType.NONE);
+        }
+
+        void logMessages(List<LogMessage> messages, CompressionType compressionType) {
             byte[] requestPayload = ProtobufSerialization.toLogRequest(messages);
+            Compressor.Compression compressed = new Compressor().compress(compressionType, requestPayload);
             Request request = new Request(ArchiveLogMessagesMethod.METHOD_NAME);
-            request.parameters().add(new Int8Value((byte)0));
-            request.parameters().add(new Int32Value(requestPayload.length));
-            request.parameters().add(new DataValue(requestPayload));
+            request.parameters().add(new Int8Value(compressed.type().getCode()));
+            request.parameters().add(new Int32Value(compressed.uncompressedSize()));
+            request.parameters().add(new DataValue(compressed.data()));
             target.invokeSync(request, Duration.ofSeconds(30));
             Values returnValues = request.returnValues();
             assertEquals(3, returnValues.size());
@@ -1,12 +1,15 @@
 // Copyright Vespa.ai. Licensed under the terms of the Apache 2.0 license. See LICENSE in the project root.
 
 #include <vespa/messagebus/testlib/receptor.h>
+#include <vespa/messagebus/testlib/simplemessage.h>
 #include <vespa/messagebus/testlib/simpleprotocol.h>
 #include <vespa/messagebus/testlib/simplereply.h>
 #include <vespa/messagebus/testlib/slobrok.h>
 #include <vespa/messagebus/testlib/testserver.h>
 #include <vespa/messagebus/network/rpcsendv2.h>
 #include <vespa/vespalib/testkit/testapp.h>
+#include <vespa/vespalib/util/stringfmt.h>
+#include <set>
 
 #include <vespa/log/log.h>
 LOG_SETUP("sendadapter_test");
@@ -224,4 +227,48 @@ TEST("test that we can send between multiple versions") {
     TEST_DO(testSendAdapters(data, {vespalib::Version(6, 149), vespalib::Version(9, 999)}));
 }
 
+TEST("test that messages sent within the batch window are all delivered and replied to") {
+    Slobrok slobrok;
+    TestServer srcServer(MessageBusParams().setRetryPolicy(IRetryPolicy::SP()).addProtocol(std::make_shared<SimpleProtocol>()),
+                         RPCNetworkParams(slobrok.config()).setBatchWindow(50ms).setMaxBatchSize(8));
+    TestServer dstServer(MessageBusParams().addProtocol(std::make_shared<SimpleProtocol>()),
+                         RPCNetworkParams(slobrok.config()).setIdentity(Identity("dst")));
+    Receptor srcHandler;
+    Receptor dstHandler;
+    SourceSession::UP srcSession = srcServer.mb.createSourceSession(SourceSessionParams().setReplyHandler(srcHandler)
+                                                                                          .setThrottlePolicy(IThrottlePolicy::SP()));
+    DestinationSession::UP dstSession = dstServer.mb.createDestinationSession(
+            DestinationSessionParams().setName("session").setMessageHandler(dstHandler));
+    ASSERT_TRUE(srcServer.waitSlobrok("dst/session", 1u));
+    ASSERT_TRUE(srcServer.net.getSendBatcher() != nullptr);
+    EXPECT_TRUE(dstServer.net.getSendBatcher() == nullptr);
+
+    constexpr uint32_t numMessages = 20;
+    for (uint32_t i = 0; i < numMessages; ++i) {
+        EXPECT_TRUE(srcSession->send(std::make_unique<SimpleMessage>(vespalib::make_string("msg%u", i)),
+                                     Route::parse("dst/session")).isAccepted());
+    }
+    std::set<vespalib::string> received;
+    for (uint32_t i = 0; i < numMessages; ++i) {
+        Message::UP msg = dstHandler.getMessage(TIMEOUT_SECS);
+        ASSERT_TRUE(msg);
+        const vespalib::string &value = dynamic_cast<SimpleMessage&>(*msg).getValue();
+        received.insert(value);
+        auto reply = std::make_unique<SimpleReply>("re:" + value);
+        reply->swapState(*msg);
+        dstSession->reply(std::move(reply));
+    }
+    EXPECT_EQUAL(numMessages, received.size());
+    std::set<vespalib::string> replied;
+    for (uint32_t i = 0; i < numMessages; ++i) {
+        Reply::UP reply = srcHandler.getReply(TIMEOUT_SECS);
+        ASSERT_TRUE(reply);
+        EXPECT_FALSE(reply->hasErrors());
+        replied.insert(dynamic_cast<SimpleReply&>(*reply).getValue());
+    }
+    EXPECT_EQUAL(numMessages, replied.size());
+    EXPECT_TRUE(replied.count("re:msg0") == 1);
+    EXPECT_TRUE(replied.count("re:msg19") == 1);
+}
+
 TEST_MAIN() { TEST_RUN_ALL(); }
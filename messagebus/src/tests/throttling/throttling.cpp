@@ -3,6 +3,7 @@
 #include <vespa/vespalib/testkit/testapp.h>
 #include <vespa/messagebus/destinationsession.h>
 #include <vespa/messagebus/dynamicthrottlepolicy.h>
+#include <vespa/messagebus/latencygradientthrottlepolicy.h>
 #include <vespa/messagebus/routablequeue.h>
 #include <vespa/messagebus/routing/routingspec.h>
 #include <vespa/messagebus/sourcesession.h>
@@ -74,6 +75,7 @@ bool waitPending(SourceSession& session, uint32_t size)
 class Test : public vespalib::TestApp {
 private:
     uint32_t getWindowSize(DynamicThrottlePolicy &policy, DynamicTimer &timer, uint32_t maxPending);
+    uint32_t getWindowSize(std::vector<LatencyGradientThrottlePolicy*> policies, DynamicTimer &timer, uint32_t capacity);
 
 protected:
     void testMaxPendingCount();
@@ -83,6 +85,8 @@ protected:
     void testIdleTimePeriod();
     void testMinWindowSize();
     void testMaxWindowSize();
+    void testLatencyGradientWindowSize();
+    void testSharedLatencyGradientController();
 
 public:
     int Main() override;
@@ -100,6 +104,8 @@ Test::Main()
     testIdleTimePeriod();    TEST_FLUSH();
     testMinWindowSize();     TEST_FLUSH();
     testMaxWindowSize();     TEST_FLUSH();
+    testLatencyGradientWindowSize();      TEST_FLUSH();
+    testSharedLatencyGradientController(); TEST_FLUSH();
 
     TEST_DONE();
 }
@@ -337,6 +343,93 @@ Test::testMaxWindowSize()
 
 }
 
+void
+Test::testLatencyGradientWindowSize()
+{
+    auto ptr = std::make_unique<DynamicTimer>();
+    auto* timer = ptr.get();
+    LatencyGradientThrottlePolicy policy(std::make_shared<LatencyGradientThrottlePolicy::Controller>(std::move(ptr)));
+
+    // step changes in destination capacity; the window should settle just above it every time
+    double windowSize = getWindowSize({&policy}, *timer, 100);
+    ASSERT_TRUE(windowSize >= 100 && windowSize <= 130);
+
+    windowSize = getWindowSize({&policy}, *timer, 200);
+    ASSERT_TRUE(windowSize >= 200 && windowSize <= 260);
+
+    windowSize = getWindowSize({&policy}, *timer, 50);
+    ASSERT_TRUE(windowSize >= 50 && windowSize <= 65);
+
+    windowSize = getWindowSize({&policy}, *timer, 500);
+    ASSERT_TRUE(windowSize >= 500 && windowSize <= 650);
+
+    windowSize = getWindowSize({&policy}, *timer, 100);
+    ASSERT_TRUE(windowSize >= 100 && windowSize <= 130);
+    EXPECT_EQUAL(100.0, policy.getController().getBaseLatency());
+}
+
+void
+Test::testSharedLatencyGradientController()
+{
+    auto ptr = std::make_unique<DynamicTimer>();
+    auto* timer = ptr.get();
+    auto controller = std::make_shared<LatencyGradientThrottlePolicy::Controller>(std::move(ptr));
+    LatencyGradientThrottlePolicy policyA(controller);
+    LatencyGradientThrottlePolicy policyB(controller);
+
+    double windowSize = getWindowSize({&policyA, &policyB}, *timer, 200);
+    ASSERT_TRUE(windowSize >= 200 && windowSize <= 260);
+    EXPECT_EQUAL(policyA.getMaxPendingCount(), policyB.getMaxPendingCount());
+
+    SimpleMessage msg("foo");
+    uint32_t numPending = 0;
+    while (policyA.canSend(msg, numPending)) {
+        policyA.processMessage(msg);
+        ++numPending;
+    }
+    EXPECT_EQUAL(policyA.getMaxPendingCount(), numPending);
+    EXPECT_FALSE(policyB.canSend(msg, 0));
+}
+
+/**
+ * Simulates a destination that handles up to capacity messages in parallel, each taking 100ms; any
+ * messages beyond that are queued. Every round sends as much as the policies allow (alternating between
+ * them), then delivers all the replies.
+ */
+uint32_t
+Test::getWindowSize(std::vector<LatencyGradientThrottlePolicy*> policies, DynamicTimer &timer, uint32_t capacity)
+{
+    SimpleMessage msg("foo");
+    SimpleReply reply("bar");
+
+    for (uint32_t i = 0; i < 200; ++i) {
+        std::vector<uint32_t> numPending(policies.size(), 0);
+        std::vector<std::pair<LatencyGradientThrottlePolicy*, Context>> pending;
+        bool sent = true;
+        while (sent) {
+            sent = false;
+            for (size_t p = 0; p < policies.size(); ++p) {
+                if (policies[p]->canSend(msg, numPending[p])) {
+                    policies[p]->processMessage(msg);
+                    pending.emplace_back(policies[p], msg.getContext());
+                    ++numPending[p];
+                    sent = true;
+                }
+            }
+        }
+        uint64_t tripTime = (pending.size() <= capacity) ? 100 : (100 * pending.size()) / capacity;
+        timer._millis += tripTime;
+
+        for (const auto &entry : pending) {
+            reply.setContext(entry.second);
+            entry.first->processReply(reply);
+        }
+    }
+    uint32_t ret = policies[0]->getMaxPendingCount();
+    fprintf(stderr, "getWindowSize() = %u\n", ret);
+    return ret;
+}
+
 uint32_t
 Test::getWindowSize(DynamicThrottlePolicy &policy, DynamicTimer &timer, uint32_t maxPending)
 {
@@ -0,0 +1,250 @@
+// Copyright Vespa.ai. Licensed under the terms of the Apache 2.0 license. See LICENSE in the project root.
+#include "latencygradientthrottlepolicy.h"
+#include "message.h"
+#include "steadytimer.h"
+#include <algorithm>
+#include <climits>
+#include <cmath>
+
+#include <vespa/log/log.h>
+LOG_SETUP(".latencygradientthrottlepolicy");
+
+namespace mbus {
+
+LatencyGradientThrottlePolicy::Controller::Controller()
+    : Controller(std::make_unique<SteadyTimer>())
+{ }
+
+LatencyGradientThrottlePolicy::Controller::Controller(ITimer::UP timer) :
+    _lock(),
+    _timer(std::move(timer)),
+    _pendingCount(0),
+    _timeOfLastMessage(_timer->getMilliTime()),
+    _idleTimePeriod(60000),
+    _windowSize(20),
+    _minWindowSize(1),
+    _maxWindowSize(INT_MAX),
+    _queueThreshold(0.1),
+    _smoothing(0.5),
+    _errorBackOff(0.8),
+    _baseLatency(0),
+    _probeInterval(100),
+    _windowsUntilProbe(_probeInterval),
+    _probeRestoreWindowSize(0),
+    _probeStartTime(0),
+    _probing(false),
+    _numSamples(0),
+    _numErrors(0),
+    _latencySum(0)
+{ }
+
+LatencyGradientThrottlePolicy::Controller::~Controller() = default;
+
+LatencyGradientThrottlePolicy::Controller &
+LatencyGradientThrottlePolicy::Controller::setMinWindowSize(double min)
+{
+    std::lock_guard guard(_lock);
+    _minWindowSize = std::max(1.0, min);
+    _windowSize = std::max(_minWindowSize, _windowSize);
+    return *this;
+}
+
+LatencyGradientThrottlePolicy::Controller &
+LatencyGradientThrottlePolicy::Controller::setMaxWindowSize(double max)
+{
+    std::lock_guard guard(_lock);
+    _maxWindowSize = max;
+    _windowSize = std::min(_maxWindowSize, _windowSize);
+    return *this;
+}
+
+LatencyGradientThrottlePolicy::Controller &
+LatencyGradientThrottlePolicy::Controller::setQueueThreshold(double threshold)
+{
+    std::lock_guard guard(_lock);
+    _queueThreshold = threshold;
+    return *this;
+}
+
+LatencyGradientThrottlePolicy::Controller &
+LatencyGradientThrottlePolicy::Controller::setSmoothing(double smoothing)
+{
+    std::lock_guard guard(_lock);
+    _smoothing = std::max(0.0, std::min(1.0, smoothing));
+    return *this;
+}
+
+LatencyGradientThrottlePolicy::Controller &
+LatencyGradientThrottlePolicy::Controller::setErrorBackOff(double backOff)
+{
+    std::lock_guard guard(_lock);
+    _errorBackOff = std::max(0.0, std::min(1.0, backOff));
+    return *this;
+}
+
+LatencyGradientThrottlePolicy::Controller &
+LatencyGradientThrottlePolicy::Controller::setProbeInterval(uint32_t interval)
+{
+    std::lock_guard guard(_lock);
+    _probeInterval = interval;
+    _windowsUntilProbe = interval;
+    return *this;
+}
+
+LatencyGradientThrottlePolicy::Controller &
+LatencyGradientThrottlePolicy::Controller::setIdleTimePeriod(uint64_t period)
+{
+    std::lock_guard guard(_lock);
+    _idleTimePeriod = period;
+    return *this;
+}
+
+double
+LatencyGradientThrottlePolicy::Controller::getWindowSize() const
+{
+    std::lock_guard guard(_lock);
+    return _windowSize;
+}
+
+double
+LatencyGradientThrottlePolicy::Controller::getBaseLatency() const
+{
+    std::lock_guard guard(_lock);
+    return _baseLatency;
+}
+
+uint32_t
+LatencyGradientThrottlePolicy::Controller::getPendingCount() const
+{
+    std::lock_guard guard(_lock);
+    return _pendingCount;
+}
+
+bool
+LatencyGradientThrottlePolicy::Controller::canSend()
+{
+    std::lock_guard guard(_lock);
+    uint64_t time = _timer->getMilliTime();
+    if (time - _timeOfLastMessage > _idleTimePeriod) {
+        _windowSize = std::max(_minWindowSize, std::min(_windowSize, _pendingCount + _minWindowSize));
+        LOG(debug, "Idle time exceeded; WindowSize = %.2f", _windowSize);
+    }
+    _timeOfLastMessage = time;
+    return _pendingCount < static_cast<uint32_t>(_windowSize);
+}
+
+uint64_t
+LatencyGradientThrottlePolicy::Controller::messageSent()
+{
+    std::lock_guard guard(_lock);
+    ++_pendingCount;
+    return _timer->getMilliTime();
+}
+
+void
+LatencyGradientThrottlePolicy::Controller::replyReceived(uint64_t timeSent, bool ok)
+{
+    std::lock_guard guard(_lock);
+    if (_pendingCount > 0) {
+        --_pendingCount;
+    }
+    // only the low 32 bits of the send time survive the message context
+    uint32_t sent = static_cast<uint32_t>(timeSent);
+    if (_probing && (static_cast<int32_t>(sent - _probeStartTime) < 0)) {
+        return; // sent before the window was halved; would not see an empty pipe
+    }
+    uint32_t latency = static_cast<uint32_t>(_timer->getMilliTime()) - sent;
+    _latencySum += std::max(1u, latency);
+    ++_numSamples;
+    if (!ok) {
+        ++_numErrors;
+    }
+    if (_numSamples >= static_cast<uint32_t>(_windowSize)) {
+        updateWindow();
+    }
+}
+
+void
+LatencyGradientThrottlePolicy::Controller::updateWindow()
+{
+    double latency = _latencySum / _numSamples;
+    uint32_t numErrors = _numErrors;
+    _latencySum = 0;
+    _numSamples = 0;
+    _numErrors = 0;
+
+    if (_probing) {
+        // the window was halved for this round; take its latency as the latency of an empty pipe
+        _baseLatency = latency;
+        _windowSize = _probeRestoreWindowSize;
+        _probing = false;
+        _windowsUntilProbe = _probeInterval;
+        LOG(debug, "Probed BaseLatency = %.2f, WindowSize = %.2f", _baseLatency, _windowSize);
+        return;
+    }
+    if ((_baseLatency == 0) || (latency < _baseLatency)) {
+        _baseLatency = latency;
+    }
+    if (numErrors > 0) {
+        _windowSize *= _errorBackOff;
+    } else {
+        double queued = _windowSize * (1.0 - (_baseLatency / latency));
+        double low = std::max(2.0, _queueThreshold * _windowSize);
+        if (queued < low) {
+            _windowSize += std::sqrt(_windowSize);
+        } else if (queued > 2 * low) {
+            double target = (_windowSize * _baseLatency / latency) + low;
+            _windowSize = (_windowSize * (1.0 - _smoothing)) + (target * _smoothing);
+        }
+        LOG(debug, "WindowSize = %.2f, Latency = %.2f, BaseLatency = %.2f, Queued = %.2f",
+            _windowSize, latency, _baseLatency, queued);
+    }
+    _windowSize = std::max(_minWindowSize, std::min(_maxWindowSize, _windowSize));
+    if ((_probeInterval > 0) && (--_windowsUntilProbe == 0)) {
+        _probing = true;
+        _probeStartTime = static_cast<uint32_t>(_timer->getMilliTime());
+        _probeRestoreWindowSize = _windowSize;
+        _windowSize = std::max(_minWindowSize, _windowSize / 2);
+    }
+}
+
+LatencyGradientThrottlePolicy::LatencyGradientThrottlePolicy()
+    : LatencyGradientThrottlePolicy(std::make_shared<Controller>())
+{ }
+
+LatencyGradientThrottlePolicy::LatencyGradientThrottlePolicy(Controller::SP controller)
+    : StaticThrottlePolicy(),
+      _controller(std::move(controller))
+{ }
+
+LatencyGradientThrottlePolicy::~LatencyGradientThrottlePolicy() = default;
+
+bool
+LatencyGradientThrottlePolicy::canSend(const Message &msg, uint32_t pendingCount)
+{
+    if (!StaticThrottlePolicy::canSend(msg, pendingCount)) {
+        return false;
+    }
+    return _controller->canSend();
+}
+
+void
+LatencyGradientThrottlePolicy::processMessage(Message &msg)
+{
+    StaticThrottlePolicy::processMessage(msg);
+    uint64_t timeSent = _controller->messageSent();
+    // the static policy keeps the message size in the context; keep the send time next to it
+    uint64_t size = msg.getContext().value.UINT64;
+    msg.setContext(Context(size | (timeSent << 32)));
+}
+
+void
+LatencyGradientThrottlePolicy::processReply(Reply &reply)
+{
+    uint64_t value = reply.getContext().value.UINT64;
+    reply.setContext(Context(value & 0xffffffff));
+    StaticThrottlePolicy::processReply(reply);
+    _controller->replyReceived(value >> 32, !reply.hasErrors());
+}
+
+} // namespace mbus
@@ -0,0 +1,173 @@
+// Copyright Vespa.ai. Licensed under the terms of the Apache 2.0 license. See LICENSE in the project root.
+#pragma once
+
+#include "itimer.h"
+#include "staticthrottlepolicy.h"
+#include <mutex>
+
+namespace mbus {
+
+/**
+ * This is an implementation of the {@link ThrottlePolicy} that sizes the window of pending messages by
+ * looking at how reply latency changes with the window, in the spirit of TCP Vegas and BBR, instead of
+ * searching for the window with the best throughput like {@link DynamicThrottlePolicy} does.
+ *
+ * The lowest latency seen is taken as the latency of an empty pipe. Comparing it to the latency of the
+ * last window of replies gives an estimate of how many messages are queued at the destination. The window
+ * grows while that estimate is small, holds while it is moderate and shrinks towards the window that would
+ * empty the queue once it grows too large. Replies with errors are treated as a congestion signal. Every
+ * now and then the window is halved for a single round in order to re-measure the latency of an empty
+ * pipe.
+ *
+ * The window is kept by a {@link Controller} that may be shared by the policies of several {@link
+ * SourceSession}s sending to the same destination; the window then limits their total number of pending
+ * messages.
+ *
+ * <b>NOTE:</b> By context, "pending" is refering to the number of sent messages that have not been replied to
+ * yet.
+ */
+class LatencyGradientThrottlePolicy : public StaticThrottlePolicy {
+public:
+    /**
+     * Holds the window and the latency measurements. Thread safe.
+     */
+    class Controller {
+    private:
+        mutable std::mutex _lock;
+        ITimer::UP _timer;
+        uint32_t   _pendingCount;
+        uint64_t   _timeOfLastMessage;
+        uint64_t   _idleTimePeriod;
+        double     _windowSize;
+        double     _minWindowSize;
+        double     _maxWindowSize;
+        double     _queueThreshold;
+        double     _smoothing;
+        double     _errorBackOff;
+        double     _baseLatency;
+        uint32_t   _probeInterval;
+        uint32_t   _windowsUntilProbe;
+        double     _probeRestoreWindowSize;
+        uint32_t   _probeStartTime;
+        bool       _probing;
+        uint32_t   _numSamples;
+        uint32_t   _numErrors;
+        double     _latencySum;
+
+        void updateWindow();
+
+    public:
+        using SP = std::shared_ptr<Controller>;
+
+        Controller();
+        explicit Controller(ITimer::UP timer);
+        ~Controller();
+
+        /**
+         * Sets the minimum number of pending messages allowed at any time.
+         *
+         * @param min The min to set.
+         * @return This, to allow chaining.
+         */
+        Controller &setMinWindowSize(double min);
+
+        /**
+         * Sets the maximum number of pending messages allowed at any time.
+         *
+         * @param max The max to set.
+         * @return This, to allow chaining.
+         */
+        Controller &setMaxWindowSize(double max);
+
+        /**
+         * Sets the estimated number of queued messages (relative to the window size) below which the
+         * window grows. The window shrinks when twice this many messages are estimated to be queued.
+         *
+         * @param threshold The fraction of the window size to set.
+         * @return This, to allow chaining.
+         */
+        Controller &setQueueThreshold(double threshold);
+
+        /**
+         * Sets how far towards its target the window moves when shrinking, in the [0, 1] range.
+         *
+         * @param smoothing The smoothing to set.
+         * @return This, to allow chaining.
+         */
+        Controller &setSmoothing(double smoothing);
+
+        /**
+         * Sets the factor the window is multiplied with after a round of replies containing errors.
+         *
+         * @param backOff The back off to set.
+         * @return This, to allow chaining.
+         */
+        Controller &setErrorBackOff(double backOff);
+
+        /**
+         * Sets the number of rounds between each time the latency of an empty pipe is re-measured.
+         *
+         * @param interval The number of rounds.
+         * @return This, to allow chaining.
+         */
+        Controller &setProbeInterval(uint32_t interval);
+
+        /**
+         * Sets the idle time period. If nothing is sent throughout this time period, the window will
+         * retract.
+         *
+         * @param period The time period to set, in milliseconds.
+         * @return This, to allow chaining.
+         */
+        Controller &setIdleTimePeriod(uint64_t period);
+
+        double getWindowSize() const;
+        double getBaseLatency() const;
+        uint32_t getPendingCount() const;
+
+        bool canSend();
+        uint64_t messageSent();
+        void replyReceived(uint64_t timeSent, bool ok);
+    };
+
+private:
+    Controller::SP _controller;
+
+public:
+    /**
+     * Convenience typedefs.
+     */
+    using UP = std::unique_ptr<LatencyGradientThrottlePolicy>;
+    using SP = std::shared_ptr<LatencyGradientThrottlePolicy>;
+
+    /**
+     * Constructs a new instance of this policy with a controller of its own.
+     */
+    LatencyGradientThrottlePolicy();
+
+    /**
+     * Constructs a new instance of this policy using the given controller, which may be shared with
+     * other policies.
+     *
+     * @param controller The controller to use.
+     */
+    explicit LatencyGradientThrottlePolicy(Controller::SP controller);
+
+    ~LatencyGradientThrottlePolicy() override;
+
+    Controller &getController() { return *_controller; }
+
+    /**
+     * Returns the current window size, which limits the number of pending messages across all policies
+     * sharing the controller of this.
+     *
+     * @return The max limit.
+     */
+    uint32_t getMaxPendingCount() const { return (uint32_t)_controller->getWindowSize(); }
+
+    bool canSend(const Message &msg, uint32_t pendingCount) override;
+    void processMessage(Message &msg) override;
+    void processReply(Reply &reply) override;
+};
+
+} // namespace mbus
@@ -1,6 +1,7 @@
 // Copyright Vespa.ai. Licensed under the terms of the Apache 2.0 license. See LICENSE in the project root.
 #include "rpcnetwork.h"
 #include "rpcservicepool.h"
+#include "rpcsendbatcher.h"
 #include "rpcsendv2.h"
 #include "rpctargetpool.h"
 #include "rpcnetworkparams.h"
@@ -105,6 +106,9 @@ RPCNetwork::RPCNetwork(const RPCNetworkParams &params) :
     _targetPoolTask(std::make_unique<TargetPoolTask>(_scheduler, *_targetPool)),
     _servicePool(std::make_unique<RPCServicePool>(*_mirror, 4_Ki)),
     _sendV2(std::make_unique<RPCSendV2>()),
+    _sendBatcher((params.getBatchWindow() > duration::zero())
+                 ? std::make_unique<RPCSendBatcher>(*_orb, _scheduler, params.getBatchWindow(), params.getMaxBatchSize())
+                 : std::unique_ptr<RPCSendBatcher>()),
     _sendAdapters(),
     _compressionConfig(params.getCompressionConfig()),
     _required_capabilities(params.required_capabilities())
@@ -388,6 +392,9 @@ RPCNetwork::shutdown()
 {
     // Unschedule any pending target pool flush task that may race with shutdown target flushing
     _scheduler.Kill(_targetPoolTask.get());
+    if (_sendBatcher) {
+        _sendBatcher->close();
+    }
     _transport->ShutDown(true);
 }
 
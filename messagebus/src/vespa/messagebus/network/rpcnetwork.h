@@ -24,6 +24,7 @@ namespace slobrok {
 
 namespace mbus {
 
+class RPCSendBatcher;
 class RPCServicePool;
 class RPCTargetPool;
 class RPCNetworkParams;
@@ -66,6 +67,7 @@ private:
     std::unique_ptr<FNET_Task>                         _targetPoolTask;
     std::unique_ptr<RPCServicePool>                    _servicePool;
     std::unique_ptr<RPCSendAdapter>                    _sendV2;
+    std::unique_ptr<RPCSendBatcher>                    _sendBatcher;
     SendAdapterMap                                     _sendAdapters;
     CompressionConfig                                  _compressionConfig;
     CapabilitySet                                      _required_capabilities;
@@ -186,6 +188,14 @@ public:
      */
     FRT_Supervisor &getSupervisor() { return *_orb; }
 
+    /**
+     * Returns the batcher that coalesces sends to the same target, or null if
+     * batching is disabled.
+     *
+     * @return The batcher.
+     */
+    RPCSendBatcher *getSendBatcher() { return _sendBatcher.get(); }
+
     /**
      * Deliver an error reply to the recipients of a {@link SendContext} in a
      * way that avoids entanglement.
@@ -2,6 +2,7 @@
 #pragma once
 
 #include "identity.h"
+#include <vespa/messagebus/common.h>
 #include <vespa/slobrok/cfg.h>
 #include <vespa/vespalib/net/tls/capability_set.h>
 #include <vespa/vespalib/util/compressionconfig.h>
@@ -26,6 +27,8 @@ private:
     uint32_t          _events_before_wakeup;
     bool              _tcpNoDelay;
     double            _connectionExpireSecs;
+    duration          _batchWindow;
+    uint32_t          _maxBatchSize;
     CompressionConfig _compressionConfig;
     CapabilitySet     _required_capabilities;
 
@@ -140,6 +143,51 @@ public:
         return *this;
     }
 
+    /**
+     * Returns for how long a message may be held back in order to send it in the same rpc as other
+     * messages to the same target. Zero disables batching.
+     *
+     * @return The batch window.
+     */
+    duration getBatchWindow() const {
+        return _batchWindow;
+    }
+
+    /**
+     * Sets for how long a message may be held back in order to send it in the same rpc as other
+     * messages to the same target. The window is rounded up to the resolution of the network
+     * scheduler. Zero disables batching.
+     *
+     * @param window The batch window.
+     * @return This, to allow chaining.
+     */
+    RPCNetworkParams &setBatchWindow(duration window) {
+        _batchWindow = window;
+        return *this;
+    }
+
+    /**
+     * Returns the number of messages at which a batch is sent without waiting for the batch window
+     * to expire.
+     *
+     * @return The number of messages.
+     */
+    uint32_t getMaxBatchSize() const {
+        return _maxBatchSize;
+    }
+
+    /**
+     * Sets the number of messages at which a batch is sent without waiting for the batch window to
+     * expire.
+     *
+     * @param size The number of messages.
+     * @return This, to allow chaining.
+     */
+    RPCNetworkParams &setMaxBatchSize(uint32_t size) {
+        _maxBatchSize = size;
+        return *this;
+    }
+
     /**
      * Returns the maximum input buffer size allowed for the underlying FNET connection.
      *
@@ -3,6 +3,7 @@
 #include "rpcsend.h"
 #include "rpcsend_private.h"
 #include "rpcserviceaddress.h"
+#include "rpctarget.h"
 #include <vespa/messagebus/network/rpcnetwork.h>
 #include <vespa/messagebus/tracelevel.h>
 #include <vespa/messagebus/emptyreply.h>
@@ -93,6 +94,10 @@ RPCSend::handleDiscard(Context ctx)
     ReplyContext::UP tmp(static_cast<ReplyContext*>(ctx.value.PTR));
     FRT_RPCRequest &req = tmp->getRequest();
     FNET_Channel *chn = req.GetContext()._value.CHANNEL;
+    if (chn == nullptr) {
+        req.Return(); // owned by whoever unpacked it, see doRequest()
+        return;
+    }
     req.internal_subref();
     chn->Free();
 }
@@ -141,10 +146,16 @@ RPCSend::send(RoutingNode &recipient, const vespalib::Version &version,
     } else {
         SendContext *ptr = ctx.release();
         req->SetContext(FNET_Context(ptr));
-        address.getTarget().getFRTTarget().InvokeAsync(req, vespalib::to_s(ptr->getTimeout()), this);
+        invokeAsync(address.getTarget(), req, ptr->getTimeout());
     }
 }
 
+void
+RPCSend::invokeAsync(RPCTarget &target, FRT_RPCRequest *req, duration timeout)
+{
+    target.getFRTTarget().InvokeAsync(req, vespalib::to_s(timeout), this);
+}
+
 void
 RPCSend::RequestDone(FRT_RPCRequest *req)
 {
@@ -19,6 +19,7 @@ class Error;
 class Route;
 class Message;
 class RPCServiceAddress;
+class RPCTarget;
 class IProtocol;
 
 class PayLoadFiller
@@ -66,6 +67,14 @@ protected:
 
     void send(RoutingNode &recipient, const vespalib::Version &version,
               const PayLoadFiller & filler, duration timeRemaining);
+    /**
+     * Invokes an encoded request on the given target, with this as the waiter.
+     *
+     * @param target  The target to invoke the request on.
+     * @param req     The request to invoke.
+     * @param timeout The timeout of the request.
+     */
+    virtual void invokeAsync(RPCTarget &target, FRT_RPCRequest *req, duration timeout);
     std::unique_ptr<Reply> decode(vespalib::stringref protocol, const vespalib::Version & version,
                                   BlobRef payload, Error & error) const;
     /**
@@ -77,13 +86,21 @@ protected:
      * @param err        The error to reply with.
      */
     void replyError(FRT_RPCRequest *req, const vespalib::Version &version, uint32_t traceLevel, const Error &err);
+    /**
+     * Decodes the message of the given request and delivers it to the owner of the network. The
+     * request is returned once the message has been replied to. A request without a channel in its
+     * context is not owned by the network; it is returned without any return values if the message
+     * is discarded.
+     *
+     * @param req The request to handle.
+     */
+    void doRequest(FRT_RPCRequest *req);
 public:
     RPCSend();
     ~RPCSend();
 
     void invoke(FRT_RPCRequest *req);
 private:
-    void doRequest(FRT_RPCRequest *req);
     void doRequestDone(FRT_RPCRequest *req);
     void doHandleReply(std::unique_ptr<Reply> reply);
     void attach(RPCNetwork &net, CapabilitySet required_capabilities) final override;
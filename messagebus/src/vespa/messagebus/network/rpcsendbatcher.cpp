@@ -0,0 +1,187 @@
+// Copyright Vespa.ai. Licensed under the terms of the Apache 2.0 license. See LICENSE in the project root.
+#include "rpcsendbatcher.h"
+#include <vespa/fnet/frt/error.h>
+#include <vespa/fnet/frt/rpcrequest.h>
+#include <vespa/fnet/frt/supervisor.h>
+#include <vespa/fnet/scheduler.h>
+#include <algorithm>
+#include <cassert>
+
+#include <vespa/log/log.h>
+LOG_SETUP(".rpcsendbatcher");
+
+namespace mbus {
+
+const char *RPCSendBatcher::METHOD_NAME   = "mbus.slime.batch";
+const char *RPCSendBatcher::METHOD_PARAMS = "BIX";
+const char *RPCSendBatcher::METHOD_RETURN = "BIX";
+
+RPCSendBatcher::FlushTask::FlushTask(FNET_Scheduler &scheduler, RPCSendBatcher &owner)
+    : FNET_Task(&scheduler),
+      _owner(owner)
+{ }
+
+RPCSendBatcher::FlushTask::~FlushTask()
+{
+    Kill();
+}
+
+void
+RPCSendBatcher::FlushTask::PerformTask()
+{
+    _owner.flush();
+}
+
+RPCSendBatcher::RPCSendBatcher(FRT_Supervisor &orb, FNET_Scheduler &scheduler, duration window, uint32_t maxBatchSize)
+    : _lock(),
+      _orb(orb),
+      _task(scheduler, *this),
+      _window(window),
+      _maxBatchSize(std::max(1u, maxBatchSize)),
+      _batches(),
+      _closed(false)
+{ }
+
+RPCSendBatcher::~RPCSendBatcher()
+{
+    _task.Kill();
+    assert(_batches.empty());
+}
+
+void
+RPCSendBatcher::invokeAsync(RPCTarget &target, FRT_RPCRequest *req, duration timeout, FRT_IRequestWait *waiter)
+{
+    if (!target.acceptsBatch()) {
+        target.getFRTTarget().InvokeAsync(req, vespalib::to_s(timeout), waiter);
+        return;
+    }
+    Batch full;
+    bool first = false;
+    {
+        std::lock_guard guard(_lock);
+        if (_closed) {
+            full.target = target.shared_from_this();
+            full.entries.push_back({req, timeout, waiter});
+        } else {
+            first = _batches.empty();
+            Batch &batch = _batches[&target];
+            if (!batch.target) {
+                batch.target = target.shared_from_this();
+            }
+            batch.entries.push_back({req, timeout, waiter});
+            if (batch.entries.size() >= _maxBatchSize) {
+                full = std::move(batch);
+                _batches.erase(&target);
+            }
+        }
+    }
+    if (full.target) {
+        send(std::move(full));
+    }
+    if (first) {
+        if (_window < FNET_Scheduler::tick_ms) {
+            _task.ScheduleNow(); // next event loop iteration
+        } else {
+            _task.Schedule(vespalib::to_s(_window));
+        }
+    }
+}
+
+void
+RPCSendBatcher::flush()
+{
+    BatchMap batches;
+    {
+        std::lock_guard guard(_lock);
+        batches.swap(_batches);
+    }
+    for (auto &entry : batches) {
+        send(std::move(entry.second));
+    }
+}
+
+void
+RPCSendBatcher::close()
+{
+    _task.Kill();
+    {
+        std::lock_guard guard(_lock);
+        _closed = true;
+    }
+    flush();
+}
+
+void
+RPCSendBatcher::send(Batch batch)
+{
+    uint32_t numEntries = batch.entries.size();
+    if ((numEntries == 1) || !batch.target->acceptsBatch()) {
+        for (const Entry &entry : batch.entries) {
+            batch.target->getFRTTarget().InvokeAsync(entry.request, vespalib::to_s(entry.timeout), entry.waiter);
+        }
+        return;
+    }
+    FRT_RPCRequest *req = _orb.AllocRPCRequest();
+    req->SetMethodName(METHOD_NAME);
+    FRT_Values &args = *req->GetParams();
+    uint8_t *encodings = args.AddInt8Array(numEntries);
+    uint32_t *sizes = args.AddInt32Array(numEntries);
+    FRT_DataValue *payloads = args.AddDataArray(numEntries);
+    duration timeout = duration::zero();
+    for (uint32_t i = 0; i < numEntries; ++i) {
+        // the last three parameters of a request are its encoding, decoded size and payload
+        const FRT_Values &params = *batch.entries[i].request->GetParams();
+        encodings[i] = params[3]._intval8;
+        sizes[i] = params[4]._intval32;
+        args.SetData(&payloads[i], params[5]._data._buf, params[5]._data._len);
+        timeout = std::max(timeout, batch.entries[i].timeout);
+    }
+    auto *ctx = new Batch(std::move(batch));
+    req->SetContext(FNET_Context(ctx));
+    ctx->target->getFRTTarget().InvokeAsync(req, vespalib::to_s(timeout), this);
+}
+
+void
+RPCSendBatcher::RequestDone(FRT_RPCRequest *req)
+{
+    std::unique_ptr<Batch> batch(static_cast<Batch*>(req->GetContext()._value.VOIDP));
+    uint32_t numEntries = batch->entries.size();
+    if (req->GetErrorCode() == FRTE_RPC_NO_SUCH_METHOD) {
+        LOG(debug, "Target does not accept batches of messages (%s); sending one by one.", req->GetErrorMessage());
+        batch->target->rejectedBatch();
+        for (const Entry &entry : batch->entries) {
+            batch->target->getFRTTarget().InvokeAsync(entry.request, vespalib::to_s(entry.timeout), entry.waiter);
+        }
+    } else if (req->CheckReturnTypes(METHOD_RETURN) &&
+               ((*req->GetReturn())[0]._int8_array._len == numEntries) &&
+               ((*req->GetReturn())[1]._int32_array._len == numEntries) &&
+               ((*req->GetReturn())[2]._data_array._len == numEntries))
+    {
+        const FRT_Values &ret = *req->GetReturn();
+        for (uint32_t i = 0; i < numEntries; ++i) {
+            const Entry &entry = batch->entries[i];
+            FRT_Values &values = *entry.request->GetReturn();
+            // place holders for auxillary data, as returned for a single request
+            values.AddInt8(0);
+            values.AddInt32(0);
+            values.AddData("", 0);
+            values.AddInt8(ret[0]._int8_array._pt[i]);
+            values.AddInt32(ret[1]._int32_array._pt[i]);
+            const FRT_DataValue &payload = ret[2]._data_array._pt[i];
+            values.AddData(payload._buf, payload._len);
+            entry.waiter->RequestDone(entry.request);
+        }
+    } else {
+        for (const Entry &entry : batch->entries) {
+            if (req->IsError()) {
+                entry.request->SetError(req->GetErrorCode(), req->GetErrorMessage());
+            } else {
+                entry.request->SetError(FRTE_RPC_WRONG_RETURN);
+            }
+            entry.waiter->RequestDone(entry.request);
+        }
+    }
+    req->internal_subref();
+}
+
+} // namespace mbus
@@ -0,0 +1,103 @@
+// Copyright Vespa.ai. Licensed under the terms of the Apache 2.0 license. See LICENSE in the project root.
+#pragma once
+
+#include "rpctarget.h"
+#include <vespa/messagebus/common.h>
+#include <vespa/fnet/frt/invoker.h>
+#include <vespa/fnet/task.h>
+#include <map>
+#include <mutex>
+#include <vector>
+
+class FNET_Scheduler;
+class FRT_Supervisor;
+
+namespace mbus {
+
+/**
+ * Coalesces the requests sent to the same target within a short window into a
+ * single rpc. This trades a little latency for fewer and larger writes when a
+ * node sends many small messages to many other nodes.
+ *
+ * Each request must already be encoded by {@link RPCSendV2}; a batch carries the
+ * encoding, the decoded size and the payload of every request in it as three
+ * parallel arrays, and the receiver answers with the replies in the same order
+ * once all of them are ready. When the batch returns, the return values of each
+ * request are filled in and it is handed to its waiter as if it had been sent on
+ * its own. If the target does not know the batch method, the requests are resent
+ * one by one and the target is never sent a batch again.
+ */
+class RPCSendBatcher : public FRT_IRequestWait {
+private:
+    struct Entry {
+        FRT_RPCRequest   *request;
+        duration          timeout;
+        FRT_IRequestWait *waiter;
+    };
+    struct Batch {
+        RPCTarget::SP      target;
+        std::vector<Entry> entries;
+    };
+    class FlushTask : public FNET_Task {
+        RPCSendBatcher &_owner;
+    public:
+        FlushTask(FNET_Scheduler &scheduler, RPCSendBatcher &owner);
+        ~FlushTask() override;
+        void PerformTask() override;
+    };
+    using BatchMap = std::map<RPCTarget*, Batch>;
+
+    std::mutex      _lock;
+    FRT_Supervisor &_orb;
+    FlushTask       _task;
+    duration        _window;
+    uint32_t        _maxBatchSize;
+    BatchMap        _batches;
+    bool            _closed;
+
+    void send(Batch batch);
+
+public:
+    static const char *METHOD_NAME;
+    static const char *METHOD_PARAMS;
+    static const char *METHOD_RETURN;
+
+    /**
+     * Constructs a batcher that holds requests back for at most the given window.
+     *
+     * @param orb          The supervisor to allocate batch requests from.
+     * @param scheduler    The scheduler that runs the flush task.
+     * @param window       The longest time a request is held back.
+     * @param maxBatchSize The number of requests at which a batch is sent at once.
+     */
+    RPCSendBatcher(FRT_Supervisor &orb, FNET_Scheduler &scheduler, duration window, uint32_t maxBatchSize);
+    RPCSendBatcher(const RPCSendBatcher &) = delete;
+    RPCSendBatcher &operator=(const RPCSendBatcher &) = delete;
+    ~RPCSendBatcher() override;
+
+    /**
+     * Queues a request for the given target. The waiter is notified exactly once,
+     * just like for {@link FRT_Target#InvokeAsync}.
+     *
+     * @param target  The target to send to.
+     * @param req     The encoded request.
+     * @param timeout The timeout of the request.
+     * @param waiter  The waiter to notify once the request is done.
+     */
+    void invokeAsync(RPCTarget &target, FRT_RPCRequest *req, duration timeout, FRT_IRequestWait *waiter);
+
+    /**
+     * Sends all queued batches at once.
+     */
+    void flush();
+
+    /**
+     * Sends all queued batches and makes later requests bypass the batcher.
+     */
+    void close();
+
+    // Implements FRT_IRequestWait.
+    void RequestDone(FRT_RPCRequest *req) override;
+};
+
+} // namespace mbus
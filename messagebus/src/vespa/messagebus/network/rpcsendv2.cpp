@@ -2,7 +2,10 @@
 
 #include "rpcsendv2.h"
 #include "rpcnetwork.h"
+#include "rpcsendbatcher.h"
 #include "rpcserviceaddress.h"
+#include <vespa/fnet/channel.h>
+#include <vespa/fnet/frt/error.h>
 #include <vespa/fnet/frt/reflection.h>
 #include <vespa/fnet/frt/require_capabilities.h>
 #include <vespa/messagebus/emptyreply.h>
@@ -77,6 +80,17 @@ RPCSendV2::build(FRT_ReflectionBuilder & builder, CapabilitySet required_capabil
     builder.ReturnDesc("body_decoded_size", "Uncompressed body blob size");
     builder.ReturnDesc("body_payload", "The reply body blob in slime.");
     builder.RequestAccessFilter(FRT_RequireCapabilities::of(required_capabilities));
+
+    builder.DefineMethod(RPCSendBatcher::METHOD_NAME, RPCSendBatcher::METHOD_PARAMS, RPCSendBatcher::METHOD_RETURN,
+                         FRT_METHOD(RPCSendV2::invokeBatch), this);
+    builder.MethodDesc("Send a batch of message bus slime requests and get their replies back, in the same order.");
+    builder.ParamDesc("header_encodings", "0=raw, 6=lz4, for each message");
+    builder.ParamDesc("header_decoded_sizes", "Uncompressed header blob size, for each message");
+    builder.ParamDesc("header_payloads", "The message header blob in slime, for each message");
+    builder.ReturnDesc("header_encodings", "0=raw, 6=lz4, for each reply");
+    builder.ReturnDesc("header_decoded_sizes", "Uncompressed header blob size, for each reply");
+    builder.ReturnDesc("header_payloads", "The reply header blob in slime, for each reply");
+    builder.RequestAccessFilter(FRT_RequireCapabilities::of(required_capabilities));
 }
 
 const char *
@@ -187,6 +201,114 @@ private:
 
 }
 
+namespace {
+
+/**
+ * Holds a request carrying a batch of messages while the requests it was unpacked into are being
+ * handled. The batch is returned once all of them have been returned.
+ */
+class BatchReturn {
+private:
+    struct Slot : FRT_IReturnHandler {
+        BatchReturn *_owner = nullptr;
+        void HandleReturn() override { _owner->returned(); }
+        FNET_Connection *GetConnection() override { return _owner->_req.GetConnection(); }
+    };
+    FRT_RPCRequest               &_req;
+    std::vector<FRT_RPCRequest*>  _requests;
+    std::vector<Slot>             _slots;
+    std::atomic<uint32_t>         _pending;
+
+public:
+    BatchReturn(FRT_RPCRequest &req, std::vector<FRT_RPCRequest*> requests)
+        : _req(req),
+          _requests(std::move(requests)),
+          _slots(_requests.size()),
+          _pending(_requests.size())
+    {
+        for (uint32_t i = 0; i < _requests.size(); ++i) {
+            _slots[i]._owner = this;
+            _requests[i]->SetReturnHandler(&_slots[i]);
+        }
+    }
+
+    void returned() {
+        if (_pending.fetch_sub(1, std::memory_order_acq_rel) != 1) {
+            return;
+        }
+        bool discarded = false;
+        for (FRT_RPCRequest *req : _requests) {
+            if (req->GetReturn()->GetNumValues() == 0) {
+                discarded = true;
+            }
+        }
+        if (discarded) {
+            FNET_Channel *chn = _req.GetContext()._value.CHANNEL;
+            _req.internal_subref();
+            chn->Free();
+        } else {
+            uint32_t numReplies = _requests.size();
+            FRT_Values &ret = *_req.GetReturn();
+            uint8_t *encodings = ret.AddInt8Array(numReplies);
+            uint32_t *sizes = ret.AddInt32Array(numReplies);
+            FRT_DataValue *payloads = ret.AddDataArray(numReplies);
+            for (uint32_t i = 0; i < numReplies; ++i) {
+                const FRT_Values &reply = *_requests[i]->GetReturn();
+                encodings[i] = reply[3]._intval8;
+                sizes[i] = reply[4]._intval32;
+                ret.SetData(&payloads[i], reply[5]._data._buf, reply[5]._data._len);
+            }
+            _req.Return();
+        }
+        for (FRT_RPCRequest *req : _requests) {
+            req->internal_subref();
+        }
+        delete this;
+    }
+};
+
+}
+
+void
+RPCSendV2::invokeAsync(RPCTarget &target, FRT_RPCRequest *req, duration timeout)
+{
+    RPCSendBatcher *batcher = _net->getSendBatcher();
+    if (batcher != nullptr) {
+        batcher->invokeAsync(target, req, timeout, this);
+    } else {
+        RPCSend::invokeAsync(target, req, timeout);
+    }
+}
+
+void
+RPCSendV2::invokeBatch(FRT_RPCRequest *req)
+{
+    const FRT_Values &args = *req->GetParams();
+    uint32_t numMessages = args[0]._int8_array._len;
+    if ((numMessages == 0) || (args[1]._int32_array._len != numMessages) || (args[2]._data_array._len != numMessages)) {
+        req->SetError(FRTE_RPC_WRONG_PARAMS, "The arrays of a batch must be non-empty and of equal length.");
+        return;
+    }
+    req->Detach();
+    std::vector<FRT_RPCRequest*> requests;
+    requests.reserve(numMessages);
+    for (uint32_t i = 0; i < numMessages; ++i) {
+        FRT_RPCRequest *msgReq = _net->allocRequest();
+        FRT_Values &params = *msgReq->GetParams();
+        params.AddInt8(CompressionConfig::NONE);
+        params.AddInt32(0);
+        params.AddData("", 0);
+        params.AddInt8(args[0]._int8_array._pt[i]);
+        params.AddInt32(args[1]._int32_array._pt[i]);
+        params.AddData(args[2]._data_array._pt[i]._buf, args[2]._data_array._pt[i]._len);
+        requests.push_back(msgReq);
+    }
+    new BatchReturn(*req, requests); // deletes self once all requests are returned
+    for (FRT_RPCRequest *msgReq : requests) {
+        doRequest(msgReq);
+    }
+}
+
 std::unique_ptr<RPCSend::Params>
 RPCSendV2::toParams(const FRT_Values &args) const
 {
@@ -19,6 +19,8 @@ private:
     std::unique_ptr<Reply> createReply(const FRT_Values & response, const string & serviceName,
                                        Error & error, vespalib::Trace & trace) const override;
     void createResponse(FRT_Values & ret, const string & version, Reply & reply, Blob payload) const override;
+    void invokeAsync(RPCTarget &target, FRT_RPCRequest *req, duration timeout) override;
+    void invokeBatch(FRT_RPCRequest *req);
 };
 
 } // namespace mbus
@@ -12,7 +12,8 @@ RPCTarget::RPCTarget(const string &spec, FRT_Supervisor &orb, ctor_tag)
     _target(*_orb.GetTarget(spec.c_str())),
     _state(VERSION_NOT_RESOLVED),
     _version(),
-    _versionHandlers()
+    _versionHandlers(),
+    _acceptsBatch(true)
 {
     // empty
 }
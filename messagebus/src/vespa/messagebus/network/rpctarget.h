@@ -57,6 +57,7 @@ private:
     std::atomic<ResolveState>  _state;
     Version_UP                 _version;
     HandlerList                _versionHandlers;
+    std::atomic<bool>          _acceptsBatch;
 
     struct ctor_tag {};
 public:
@@ -116,6 +117,19 @@ public:
      */
     const vespalib::Version &getVersion() const { return *_version; }
 
+    /**
+     * Returns whether this target may be sent batches of messages. This is
+     * assumed until a batch is rejected by the target.
+     *
+     * @return False if the target does not know how to receive a batch.
+     */
+    bool acceptsBatch() const { return _acceptsBatch.load(std::memory_order_relaxed); }
+
+    /**
+     * Marks this target as not being able to receive batches of messages.
+     */
+    void rejectedBatch() { _acceptsBatch.store(false, std::memory_order_relaxed); }
+
     // Implements FRT_IRequestWait.
     void RequestDone(FRT_RPCRequest *req) override;
 };
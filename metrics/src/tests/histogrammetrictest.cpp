@@ -0,0 +1,141 @@
+// Copyright Vespa.ai. Licensed under the terms of the Apache 2.0 license. See LICENSE in the project root.
+
+#include <vespa/metrics/histogrammetric.h>
+#include <vespa/metrics/jsonwriter.h>
+#include <vespa/metrics/metricset.h>
+#include <vespa/vespalib/gtest/gtest.h>
+#include <vespa/vespalib/stllike/asciistream.h>
+#include <cmath>
+#include <thread>
+#include <vector>
+
+namespace metrics {
+
+namespace {
+
+void expect_within_accuracy(double expected, double actual) {
+    EXPECT_NEAR(expected, actual, expected * HistogramMetric::relative_accuracy * 1.01);
+}
+
+}
+
+TEST(HistogramMetricTest, bucket_value_is_within_relative_accuracy_of_values_in_bucket)
+{
+    for (double v : {2e-6, 1e-5, 0.00123, 0.5, 1.0, 7.3, 1234.5, 1e6}) {
+        size_t bucket = HistogramMetric::bucket_of(v);
+        EXPECT_LT(bucket, HistogramMetric::num_buckets - 1);
+        expect_within_accuracy(v, HistogramMetric::bucket_value(bucket));
+    }
+    EXPECT_EQ(0u, HistogramMetric::bucket_of(0.0));
+    EXPECT_EQ(0u, HistogramMetric::bucket_of(-1.0));
+    EXPECT_EQ(HistogramMetric::num_buckets - 1, HistogramMetric::bucket_of(1e300));
+}
+
+TEST(HistogramMetricTest, tracks_average_min_max_and_percentiles)
+{
+    HistogramMetric m("latency", {}, "description");
+    EXPECT_FALSE(m.used());
+    EXPECT_EQ(0.0, m.getQuantile(0.5));
+    for (int i = 1; i <= 1000; ++i) {
+        m.addValue(i * 0.001);
+    }
+    EXPECT_TRUE(m.used());
+    EXPECT_EQ(1000u, m.getCount());
+    EXPECT_NEAR(0.5005, m.getAverage(), 1e-9);
+    EXPECT_DOUBLE_EQ(0.001, m.getMinimum());
+    EXPECT_DOUBLE_EQ(1.0, m.getMaximum());
+    EXPECT_DOUBLE_EQ(1.0, m.getLast());
+    expect_within_accuracy(0.5, m.getQuantile(0.5));
+    expect_within_accuracy(0.9, m.getQuantile(0.9));
+    expect_within_accuracy(0.99, m.getQuantile(0.99));
+    EXPECT_DOUBLE_EQ(0.001, m.getQuantile(0.0));
+    EXPECT_DOUBLE_EQ(1.0, m.getQuantile(1.0));
+    expect_within_accuracy(0.99, m.getDoubleValue("p99"));
+    EXPECT_EQ(1000, m.getLongValue("count"));
+
+    auto percentiles = m.getPercentiles();
+    ASSERT_EQ(5u, percentiles.size());
+    EXPECT_EQ("p50", percentiles[0].first);
+    EXPECT_EQ("p999", percentiles[4].first);
+
+    m.reset();
+    EXPECT_FALSE(m.used());
+    EXPECT_EQ(0.0, m.getAverage());
+    EXPECT_EQ(0.0, m.getQuantile(0.99));
+}
+
+TEST(HistogramMetricTest, non_finite_values_are_ignored)
+{
+    HistogramMetric m("latency", {}, "description");
+    m.addValue(std::nan(""));
+    m.addValue(INFINITY);
+    EXPECT_EQ(0u, m.getCount());
+}
+
+TEST(HistogramMetricTest, snapshot_and_sum_merge_buckets)
+{
+    MetricSet set("set", {}, "");
+    HistogramMetric m("latency", {}, "description", &set);
+    for (int i = 0; i < 90; ++i) {
+        m.addValue(0.01);
+    }
+    std::vector<Metric::UP> owner;
+    std::unique_ptr<MetricSet> snapshot(set.clone(owner, Metric::INACTIVE, nullptr, true));
+    snapshot->reset();
+    set.addToSnapshot(*snapshot, owner);
+    set.reset();
+    for (int i = 0; i < 10; ++i) {
+        m.addValue(1.0);
+    }
+    set.addToSnapshot(*snapshot, owner);
+
+    auto& copy = static_cast<const HistogramMetric&>(*snapshot->getMetric("latency"));
+    EXPECT_EQ(100u, copy.getCount());
+    EXPECT_DOUBLE_EQ(0.01, copy.getMinimum());
+    EXPECT_DOUBLE_EQ(1.0, copy.getMaximum());
+    expect_within_accuracy(0.01, copy.getQuantile(0.5));
+    expect_within_accuracy(1.0, copy.getQuantile(0.95));
+
+    HistogramMetric sum(copy, nullptr);
+    sum += m;
+    EXPECT_EQ(110u, sum.getCount());
+    expect_within_accuracy(1.0, sum.getQuantile(0.9));
+}
+
+TEST(HistogramMetricTest, json_output_includes_percentiles)
+{
+    HistogramMetric m("latency", {}, "description");
+    m.addValue(0.25);
+    vespalib::asciistream as;
+    vespalib::JsonStream stream(as, true);
+    JsonWriter writer(stream);
+    m.visit(writer);
+    stream.finalize();
+    std::string json = as.str();
+    EXPECT_NE(std::string::npos, json.find("\"p50\":0.25")) << json;
+    EXPECT_NE(std::string::npos, json.find("\"p999\":0.25")) << json;
+}
+
+TEST(HistogramMetricTest, concurrent_updates_are_not_lost)
+{
+    HistogramMetric m("latency", {}, "description");
+    constexpr size_t num_threads = 8;
+    constexpr size_t num_values = 10000;
+    std::vector<std::thread> threads;
+    for (size_t t = 0; t < num_threads; ++t) {
+        threads.emplace_back([&m, t]() {
+            for (size_t i = 0; i < num_values; ++i) {
+                m.addValue(0.001 * (t + 1));
+            }
+        });
+    }
+    for (auto& thread : threads) {
+        thread.join();
+    }
+    EXPECT_EQ(num_threads * num_values, m.getCount());
+    EXPECT_DOUBLE_EQ(0.001, m.getMinimum());
+    EXPECT_DOUBLE_EQ(0.008, m.getMaximum());
+    EXPECT_NEAR(0.0045, m.getAverage(), 1e-9);
+}
+
+}
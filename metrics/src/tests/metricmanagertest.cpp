@@ -9,6 +9,7 @@
 #include <vespa/vespalib/gtest/gtest.h>
 #include <vespa/vespalib/stllike/asciistream.h>
 #include <vespa/vespalib/util/size_literals.h>
+#include <vespa/vespalib/util/stringfmt.h>
 #include <vespa/vespalib/util/time.h>
 #include <vespa/vespalib/data/simple_buffer.h>
 #include <vespa/vespalib/util/atomic.h>
@@ -647,6 +648,43 @@ TEST_F(MetricManagerTest, test_json_output)
     EXPECT_NE(total, normal);
 }
 
+TEST_F(MetricManagerTest, snapshot_rendering_is_cached_until_next_snapshot)
+{
+    auto timerImpl = std::make_unique<FakeTimer>(1000);
+    FakeTimer & timer = *timerImpl;
+    MetricManager mm(std::move(timerImpl));
+    TestMetricSet mySet;
+    {
+        MetricLockGuard lockGuard(mm.getMetricLock());
+        mm.registerMetric(lockGuard, mySet.set);
+    }
+    mm.init(ConfigUri("raw:"
+                      "consumer[1]\n"
+                      "consumer[0].name snapper\n"
+                      "consumer[0].tags[1]\n"
+                      "consumer[0].tags[0] snaptest\n"), false);
+    takeSnapshots(mm, 1000);
+
+    size_t renders = 0;
+    auto renderer = [&renders](const MetricLockGuard &) {
+        ++renders;
+        return vespalib::make_string("render %zu", renders);
+    };
+    EXPECT_EQ("render 1", mm.getCachedSnapshotRendering("a", renderer));
+    EXPECT_EQ("render 1", mm.getCachedSnapshotRendering("a", renderer));
+    EXPECT_EQ("render 2", mm.getCachedSnapshotRendering("b", renderer));
+    EXPECT_EQ(2u, renders);
+
+    timer.set_time(1300);
+    takeSnapshots(mm, 1300);
+    EXPECT_EQ("render 3", mm.getCachedSnapshotRendering("a", renderer));
+    EXPECT_EQ("render 3", mm.getCachedSnapshotRendering("a", renderer));
+
+    mm.reset(system_time(vespalib::from_s<system_time::duration>(1300)));
+    EXPECT_EQ("render 4", mm.getCachedSnapshotRendering("a", renderer));
+    EXPECT_EQ(4u, renders);
+}
+
 namespace {
 
 struct MetricSnapshotTestFixture
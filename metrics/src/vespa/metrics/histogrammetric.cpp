@@ -0,0 +1,415 @@
+// Copyright Vespa.ai. Licensed under the terms of the Apache 2.0 license. See LICENSE in the project root.
+
+#include "histogrammetric.h"
+#include "memoryconsumption.h"
+#include <vespa/vespalib/util/exceptions.h>
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <ostream>
+
+namespace metrics {
+
+namespace {
+
+const double gamma_value = (1.0 + HistogramMetric::relative_accuracy) / (1.0 - HistogramMetric::relative_accuracy);
+const double log_gamma = std::log(gamma_value);
+
+// (name, quantile) of the percentiles reported
+const std::array<std::pair<const char *, double>, 5> percentiles = {{
+    {"p50", 0.50}, {"p90", 0.90}, {"p95", 0.95}, {"p99", 0.99}, {"p999", 0.999}
+}};
+
+std::atomic<uint32_t> next_thread_shard(0);
+
+size_t thread_shard() noexcept {
+    thread_local size_t shard = next_thread_shard.fetch_add(1, std::memory_order_relaxed) % HistogramMetric::num_shards;
+    return shard;
+}
+
+void update_min(std::atomic<double>& target, double value) noexcept {
+    double old = target.load(std::memory_order_relaxed);
+    while (value < old && !target.compare_exchange_weak(old, value, std::memory_order_relaxed)) {}
+}
+
+void update_max(std::atomic<double>& target, double value) noexcept {
+    double old = target.load(std::memory_order_relaxed);
+    while (value > old && !target.compare_exchange_weak(old, value, std::memory_order_relaxed)) {}
+}
+
+}
+
+HistogramMetricValues::HistogramMetricValues()
+    : _count(0), _total(0), _min(0), _max(0), _last(0), _percentiles()
+{}
+
+HistogramMetricValues::~HistogramMetricValues() = default;
+
+double
+HistogramMetricValues::getDoubleValue(stringref id) const
+{
+    if (id == "last" || id == "value") return _last;
+    if (id == "average") return (_count > 0) ? (_total / _count) : 0.0;
+    if (id == "count") return _count;
+    if (id == "total") return _total;
+    if (id == "min") return _min;
+    if (id == "max") return _max;
+    for (const auto& p : _percentiles) {
+        if (id == p.first) return p.second;
+    }
+    throw vespalib::IllegalArgumentException(
+            "No value " + vespalib::string(id) + " in histogram metric.", VESPA_STRLOC);
+}
+
+uint64_t
+HistogramMetricValues::getLongValue(stringref id) const
+{
+    if (id == "count") return _count;
+    return static_cast<uint64_t>(getDoubleValue(id));
+}
+
+void
+HistogramMetricValues::output(const std::string& id, std::ostream& out) const
+{
+    if (id == "count") {
+        out << _count;
+    } else {
+        out << getDoubleValue(id);
+    }
+}
+
+void
+HistogramMetricValues::output(const std::string& id, vespalib::JsonStream& stream) const
+{
+    if (id == "count") {
+        stream << _count;
+    } else {
+        stream << getDoubleValue(id);
+    }
+}
+
+HistogramMetric::Shard::Shard() noexcept
+    : count(0),
+      total(0.0),
+      min(std::numeric_limits<double>::max()),
+      max(std::numeric_limits<double>::lowest()),
+      last(0.0),
+      buckets()
+{
+}
+
+void
+HistogramMetric::Shard::reset() noexcept
+{
+    count.store(0, std::memory_order_relaxed);
+    total.store(0.0, std::memory_order_relaxed);
+    min.store(std::numeric_limits<double>::max(), std::memory_order_relaxed);
+    max.store(std::numeric_limits<double>::lowest(), std::memory_order_relaxed);
+    last.store(0.0, std::memory_order_relaxed);
+    for (auto& bucket : buckets) {
+        bucket.store(0, std::memory_order_relaxed);
+    }
+}
+
+HistogramMetric::Merged::Merged() noexcept
+    : count(0),
+      total(0.0),
+      min(std::numeric_limits<double>::max()),
+      max(std::numeric_limits<double>::lowest()),
+      last(0.0),
+      buckets()
+{
+}
+
+double
+HistogramMetric::Merged::quantile(double q) const noexcept
+{
+    if (count == 0) {
+        return 0.0;
+    }
+    uint64_t rank = static_cast<uint64_t>(q * (count - 1));
+    uint64_t seen = 0;
+    for (size_t i = 0; i < buckets.size(); ++i) {
+        seen += buckets[i];
+        if (seen > rank) {
+            double value = (i == 0) ? min : bucket_value(i);
+            return std::clamp(value, min, max);
+        }
+    }
+    return max;
+}
+
+size_t
+HistogramMetric::bucket_of(double value) noexcept
+{
+    if (!(value > min_trackable_value)) {
+        return 0;
+    }
+    double idx = std::ceil(std::log(value / min_trackable_value) / log_gamma);
+    return std::min(static_cast<size_t>(std::max(idx, 1.0)), num_buckets - 1);
+}
+
+double
+HistogramMetric::bucket_value(size_t bucket) noexcept
+{
+    if (bucket == 0) {
+        return min_trackable_value;
+    }
+    // midpoint (relative) of (min * gamma^(bucket-1), min * gamma^bucket]
+    return min_trackable_value * std::pow(gamma_value, bucket) * 2.0 / (1.0 + gamma_value);
+}
+
+HistogramMetric::HistogramMetric(const String& name, Tags dimensions, const String& description, MetricSet* owner)
+    : AbstractValueMetric(name, std::move(dimensions), description, owner),
+      _shards()
+{
+}
+
+HistogramMetric::HistogramMetric(const HistogramMetric& other, MetricSet* owner)
+    : AbstractValueMetric(other, owner),
+      _shards()
+{
+    if (other.used()) {
+        add(other.merge());
+    }
+}
+
+HistogramMetric::~HistogramMetric()
+{
+    for (auto& shard : _shards) {
+        delete shard.load(std::memory_order_relaxed);
+    }
+}
+
+HistogramMetric::Shard&
+HistogramMetric::shard(size_t idx)
+{
+    Shard* shard = _shards[idx].load(std::memory_order_acquire);
+    if (shard == nullptr) {
+        auto fresh = std::make_unique<Shard>();
+        if (_shards[idx].compare_exchange_strong(shard, fresh.get(), std::memory_order_acq_rel)) {
+            shard = fresh.release();
+        }
+    }
+    return *shard;
+}
+
+HistogramMetric::Shard&
+HistogramMetric::my_shard()
+{
+    return shard(thread_shard());
+}
+
+void
+HistogramMetric::addValue(double value)
+{
+    if (!std::isfinite(value)) {
+        logNonFiniteValueWarning();
+        return;
+    }
+    Shard& s = my_shard();
+    s.buckets[bucket_of(value)].fetch_add(1, std::memory_order_relaxed);
+    s.total.fetch_add(value, std::memory_order_relaxed);
+    update_min(s.min, value);
+    update_max(s.max, value);
+    s.last.store(value, std::memory_order_relaxed);
+    s.count.fetch_add(1, std::memory_order_relaxed);
+}
+
+HistogramMetric::Merged
+HistogramMetric::merge() const
+{
+    Merged result;
+    for (const auto& entry : _shards) {
+        const Shard* s = entry.load(std::memory_order_acquire);
+        if (s == nullptr) {
+            continue;
+        }
+        uint64_t count = s->count.load(std::memory_order_relaxed);
+        if (count == 0) {
+            continue;
+        }
+        result.count += count;
+        result.total += s->total.load(std::memory_order_relaxed);
+        result.min = std::min(result.min, s->min.load(std::memory_order_relaxed));
+        result.max = std::max(result.max, s->max.load(std::memory_order_relaxed));
+        result.last = s->last.load(std::memory_order_relaxed);
+        for (size_t i = 0; i < num_buckets; ++i) {
+            result.buckets[i] += s->buckets[i].load(std::memory_order_relaxed);
+        }
+    }
+    return result;
+}
+
+void
+HistogramMetric::add(const Merged& values)
+{
+    if (values.count == 0) {
+        return;
+    }
+    Shard& s = shard(0);
+    for (size_t i = 0; i < num_buckets; ++i) {
+        if (values.buckets[i] != 0) {
+            s.buckets[i].fetch_add(values.buckets[i], std::memory_order_relaxed);
+        }
+    }
+    s.total.fetch_add(values.total, std::memory_order_relaxed);
+    update_min(s.min, values.min);
+    update_max(s.max, values.max);
+    s.last.store(values.last, std::memory_order_relaxed);
+    s.count.fetch_add(values.count, std::memory_order_relaxed);
+}
+
+uint64_t
+HistogramMetric::getCount() const
+{
+    uint64_t count = 0;
+    for (const auto& entry : _shards) {
+        const Shard* s = entry.load(std::memory_order_acquire);
+        if (s != nullptr) {
+            count += s->count.load(std::memory_order_relaxed);
+        }
+    }
+    return count;
+}
+
+double HistogramMetric::getTotal() const { return merge().total; }
+double HistogramMetric::getLast() const { return merge().last; }
+
+double
+HistogramMetric::getAverage() const
+{
+    Merged values = merge();
+    return (values.count > 0) ? (values.total / values.count) : 0.0;
+}
+
+double
+HistogramMetric::getMinimum() const
+{
+    Merged values = merge();
+    return (values.count > 0) ? values.min : 0.0;
+}
+
+double
+HistogramMetric::getMaximum() const
+{
+    Merged values = merge();
+    return (values.count > 0) ? values.max : 0.0;
+}
+
+double
+HistogramMetric::getQuantile(double quantile) const
+{
+    return merge().quantile(quantile);
+}
+
+HistogramMetric&
+HistogramMetric::operator+=(const HistogramMetric& other)
+{
+    add(other.merge());
+    return *this;
+}
+
+MetricValueClass::UP
+HistogramMetric::getValues() const
+{
+    Merged merged = merge();
+    auto values = std::make_unique<HistogramMetricValues>();
+    values->_count = merged.count;
+    if (merged.count > 0) {
+        values->_total = merged.total;
+        values->_min = merged.min;
+        values->_max = merged.max;
+        values->_last = merged.last;
+    }
+    for (const auto& p : percentiles) {
+        values->_percentiles.emplace_back(p.first, merged.quantile(p.second));
+    }
+    return values;
+}
+
+std::vector<std::pair<vespalib::string, double>>
+HistogramMetric::getPercentiles() const
+{
+    Merged merged = merge();
+    std::vector<std::pair<vespalib::string, double>> result;
+    for (const auto& p : percentiles) {
+        result.emplace_back(p.first, merged.quantile(p.second));
+    }
+    return result;
+}
+
+void
+HistogramMetric::reset()
+{
+    for (auto& entry : _shards) {
+        Shard* s = entry.load(std::memory_order_acquire);
+        if (s != nullptr) {
+            s->reset();
+        }
+    }
+}
+
+void
+HistogramMetric::print(std::ostream& out, bool verbose, const std::string&, uint64_t) const
+{
+    Merged values = merge();
+    if (values.count == 0 && !verbose) return;
+    out << getName() << " average=" << ((values.count == 0) ? 0.0 : (values.total / values.count))
+        << " last=" << values.last;
+    if (values.count > 0) {
+        out << " min=" << values.min << " max=" << values.max;
+    }
+    out << " count=" << values.count << " total=" << values.total;
+    for (const auto& p : percentiles) {
+        out << " " << p.first << "=" << values.quantile(p.second);
+    }
+}
+
+int64_t
+HistogramMetric::getLongValue(stringref id) const
+{
+    auto values = getValues();
+    if (id == "count") return static_cast<int64_t>(values->getLongValue(id));
+    return static_cast<int64_t>(values->getDoubleValue(id));
+}
+
+double
+HistogramMetric::getDoubleValue(stringref id) const
+{
+    return getValues()->getDoubleValue(id);
+}
+
+void
+HistogramMetric::addMemoryUsage(MemoryConsumption& mc) const
+{
+    ++mc._valueMetricCount;
+    mc._valueMetricMeta += sizeof(HistogramMetric) - sizeof(Metric);
+    for (const auto& entry : _shards) {
+        if (entry.load(std::memory_order_relaxed) != nullptr) {
+            mc._valueMetricValues += sizeof(Shard);
+        }
+    }
+    Metric::addMemoryUsage(mc);
+}
+
+void
+HistogramMetric::printDebug(std::ostream& out, const std::string& indent) const
+{
+    out << "count=" << getCount() << " ";
+    Metric::printDebug(out, indent);
+}
+
+void
+HistogramMetric::addToPart(Metric& other) const
+{
+    static_cast<HistogramMetric&>(other).add(merge());
+}
+
+void
+HistogramMetric::addToSnapshot(Metric& other, std::vector<Metric::UP>&) const
+{
+    static_cast<HistogramMetric&>(other).add(merge());
+}
+
+} // metrics
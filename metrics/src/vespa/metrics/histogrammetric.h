@@ -0,0 +1,122 @@
+// Copyright Vespa.ai. Licensed under the terms of the Apache 2.0 license. See LICENSE in the project root.
+/**
+ * @class metrics::HistogramMetric
+ * @ingroup metrics
+ *
+ * @brief Creates a metric measuring the distribution of a value.
+ *
+ * A histogram metric reports the same values as an average value metric
+ * (average, sum, count, min, max, last), and in addition a set of
+ * percentiles (p50, p90, p95, p99, p999) of the values added.
+ *
+ * Values are counted in logarithmically sized buckets (DDSketch layout),
+ * giving a relative accuracy of about 2% for percentiles of positive values
+ * between 1e-6 and 1e9. Values at or below 1e-6 share a single bucket.
+ *
+ * Adding values is lock-free. To avoid concurrent updates from many threads
+ * contending on the same cache lines, an active metric spreads its updates
+ * over a number of shards, each thread always using the same shard. Shards
+ * are allocated on first use and merged when the metric is added to a
+ * snapshot or summed with other metrics. Inactive copies (snapshots) only
+ * use a single shard.
+ */
+
+#pragma once
+
+#include "valuemetric.h"
+#include <array>
+#include <atomic>
+
+namespace metrics {
+
+struct HistogramMetricValues : MetricValueClass {
+    uint64_t _count;
+    double _total, _min, _max, _last;
+    std::vector<std::pair<vespalib::string, double>> _percentiles;
+
+    HistogramMetricValues();
+    ~HistogramMetricValues() override;
+    double getDoubleValue(stringref id) const override;
+    uint64_t getLongValue(stringref id) const override;
+    void output(const std::string& id, std::ostream& out) const override;
+    void output(const std::string& id, vespalib::JsonStream& stream) const override;
+};
+
+class HistogramMetric : public AbstractValueMetric {
+public:
+    static constexpr double relative_accuracy = 0.02;
+    static constexpr double min_trackable_value = 1e-6;
+    static constexpr size_t num_buckets = 880;
+    static constexpr size_t num_shards = 16;
+
+    HistogramMetric(const String& name, Tags dimensions, const String& description, MetricSet* owner = nullptr);
+    HistogramMetric(const HistogramMetric& other, MetricSet* owner);
+    ~HistogramMetric() override;
+
+    void addValue(double value);
+    void set(double value) { addValue(value); }
+
+    uint64_t getCount() const;
+    double getTotal() const;
+    double getAverage() const;
+    double getMinimum() const;
+    double getMaximum() const;
+    double getLast() const;
+    /** Returns the estimated value at the given quantile (0.0 - 1.0); 0 if unused. */
+    double getQuantile(double quantile) const;
+
+    // Bucket layout, exposed for testing.
+    static size_t bucket_of(double value) noexcept;
+    static double bucket_value(size_t bucket) noexcept;
+
+    HistogramMetric* clone(std::vector<Metric::UP>&, CopyType, MetricSet* owner, bool) const override {
+        return new HistogramMetric(*this, owner);
+    }
+    HistogramMetric& operator+=(const HistogramMetric& other);
+
+    MetricValueClass::UP getValues() const override;
+    std::vector<std::pair<vespalib::string, double>> getPercentiles() const override;
+    bool inUse(const MetricValueClass& v) const override {
+        return (static_cast<const HistogramMetricValues&>(v)._count != 0);
+    }
+    bool summedAverage() const override { return false; }
+    bool used() const override { return (getCount() != 0); }
+
+    void reset() override;
+    void print(std::ostream&, bool verbose, const std::string& indent, uint64_t secondsPassed) const override;
+    int64_t getLongValue(stringref id) const override;
+    double getDoubleValue(stringref id) const override;
+    void addMemoryUsage(MemoryConsumption&) const override;
+    void printDebug(std::ostream&, const std::string& indent) const override;
+    void addToPart(Metric&) const override;
+    void addToSnapshot(Metric&, std::vector<Metric::UP>&) const override;
+
+private:
+    struct Shard {
+        std::atomic<uint64_t> count;
+        std::atomic<double>   total;
+        std::atomic<double>   min;
+        std::atomic<double>   max;
+        std::atomic<double>   last;
+        std::array<std::atomic<uint32_t>, num_buckets> buckets;
+        Shard() noexcept;
+        void reset() noexcept;
+    };
+    // Merged view of all shards
+    struct Merged {
+        uint64_t count;
+        double total, min, max, last;
+        std::array<uint64_t, num_buckets> buckets;
+        Merged() noexcept;
+        double quantile(double q) const noexcept;
+    };
+
+    std::array<std::atomic<Shard*>, num_shards> _shards;
+
+    Shard& shard(size_t idx);
+    Shard& my_shard();
+    Merged merge() const;
+    void add(const Merged& values);
+};
+
+} // metrics
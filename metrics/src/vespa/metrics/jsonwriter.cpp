@@ -145,6 +145,9 @@ JsonWriter::visitValueMetric(const AbstractValueMetric& m, bool)
     values->output("max", _stream);
     _stream << "last";
     values->output("last", _stream);
+    for (const auto& percentile : m.getPercentiles()) {
+        _stream << percentile.first << percentile.second;
+    }
     _stream << End();
     writeCommonPostfix(m);
     return true;
@@ -87,6 +87,9 @@ MetricManager::MetricManager(std::unique_ptr<Timer> timer)
       _lastProcessedTime(),
       _snapshotUnsetMetrics(false),
       _consumerConfigChanged(false),
+      _snapshotGeneration(0),
+      _renderCacheLock(),
+      _renderCache(),
       _metricManagerMetrics("metricmanager", {}, "Metrics for the metric manager upkeep tasks", nullptr),
       _periodicHookLatency("periodichooklatency", {}, "Time in ms used to update a single periodic hook", &_metricManagerMetrics),
       _snapshotHookLatency("snapshothooklatency", {}, "Time in ms used to update a single snapshot hook", &_metricManagerMetrics),
@@ -402,6 +405,34 @@ MetricManager::handleMetricsAltered(const MetricLockGuard & guard)
     LOG(debug, "Setting new consumer config. Clearing dirty flag");
     _consumerConfig.swap(configMap);
     _consumerConfigChanged = false;
+    invalidateSnapshotRenderings(guard);
+}
+
+void
+MetricManager::invalidateSnapshotRenderings(const MetricLockGuard & guard)
+{
+    assertMetricLockLocked(guard);
+    _snapshotGeneration.fetch_add(1, std::memory_order_release);
+}
+
+vespalib::string
+MetricManager::getCachedSnapshotRendering(const vespalib::string& key, const SnapshotRenderer& renderer) const
+{
+    uint64_t generation = _snapshotGeneration.load(std::memory_order_acquire);
+    {
+        std::lock_guard guard(_renderCacheLock);
+        auto found = _renderCache.find(key);
+        if ((found != _renderCache.end()) && (found->second.first == generation)) {
+            return *found->second.second;
+        }
+    }
+    MetricLockGuard sync(_waiter);
+    // Generation is only bumped with the metric lock held, so it matches what we render
+    generation = _snapshotGeneration.load(std::memory_order_relaxed);
+    auto rendered = std::make_shared<const vespalib::string>(renderer(sync));
+    std::lock_guard guard(_renderCacheLock);
+    _renderCache[key] = std::make_pair(generation, rendered);
+    return *rendered;
 }
 
 namespace {
@@ -697,12 +728,13 @@ MetricManager::reset(system_time currentTime)
     time_point preTime = _timer->getTimeInMilliSecs();
     // Resetting implies visiting metrics, which needs to grab metric lock
     // to avoid conflict with adding/removal of metrics
-    std::lock_guard waiterLock(_waiter);
+    MetricLockGuard waiterLock(_waiter);
     _activeMetrics.reset(currentTime);
     for (const auto & snapshot : _snapshots) {
         snapshot->reset(currentTime);
     }
     _totalMetrics->reset(currentTime);
+    invalidateSnapshotRenderings(waiterLock);
     time_point postTime = _timer->getTimeInMilliSecs();
     _resetLatency.addValue(count_ms(postTime - preTime));
 }
@@ -801,6 +833,7 @@ MetricManager::takeSnapshots(const MetricLockGuard & guard, system_time timeToPr
     _activeMetrics.addToSnapshot(*_totalMetrics, false, timeToProcess);
     _activeMetrics.reset(timeToProcess);
     _snapshots[0]->tag_current_as_assigned();
+    invalidateSnapshotRenderings(guard);
     LOG(debug, "After snapshotting, active metrics goes from %s to %s, and 5 minute metrics goes from %s to %s.",
         to_string(_activeMetrics.getFromTime()).c_str(), to_string(_activeMetrics.getToTime()).c_str(),
         to_string(firstTarget.getFromTime()).c_str(), to_string(firstTarget.getToTime()).c_str());
@@ -53,6 +53,7 @@
 #include <vespa/metrics/config-metricsmanager.h>
 #include <vespa/config/subscription/configsubscriber.h>
 #include <vespa/config/subscription/configuri.h>
+#include <functional>
 #include <map>
 #include <list>
 #include <thread>
@@ -108,6 +109,11 @@ private:
     // upgrading
     bool _snapshotUnsetMetrics;
     bool _consumerConfigChanged;
+    // Bumped (with metric lock held) whenever snapshot content or consumer
+    // config changes, invalidating cached snapshot renderings.
+    std::atomic<uint64_t> _snapshotGeneration;
+    mutable std::mutex _renderCacheLock;
+    mutable std::map<vespalib::string, std::pair<uint64_t, std::shared_ptr<const vespalib::string>>> _renderCache;
 
     MetricSet _metricManagerMetrics;
     LongAverageMetric _periodicHookLatency;
@@ -122,6 +128,8 @@ private:
     bool stop_requested() const { return _stop_requested.load(std::memory_order_relaxed); }
     
 public:
+    using SnapshotRenderer = std::function<vespalib::string(const MetricLockGuard&)>;
+
     MetricManager();
     explicit MetricManager(std::unique_ptr<Timer> timer);
     ~MetricManager();
@@ -209,6 +217,17 @@ public:
     void visit(const MetricLockGuard & guard, const MetricSnapshot&,
                MetricVisitor&, const std::string& consumer) const;
 
+    /**
+     * Get the output of a snapshot renderer (typically writing the snapshot
+     * of the shortest period for a given consumer), cached per key until the
+     * next snapshot is taken or metrics are reset or altered. The renderer is
+     * only called, with the metric lock held, when there is no valid cached
+     * output, so consumers polling more often than the snapshot period do not
+     * contend with the snapshot thread and metric registration on the metric
+     * lock. Must not be called while holding the metric lock.
+     */
+    vespalib::string getCachedSnapshotRendering(const vespalib::string& key, const SnapshotRenderer& renderer) const;
+
     /**
      * The metric lock protects against changes in metric structure. After
      * metric manager init, you need to take this lock if you want to add or
@@ -291,6 +310,7 @@ private:
     void updateSnapshotMetrics(const MetricLockGuard & guard);
 
     void handleMetricsAltered(const MetricLockGuard & guard);
+    void invalidateSnapshotRenderings(const MetricLockGuard & guard);
 
     using SnapSpec = std::pair<time_point::duration, std::string>;
     static std::vector<SnapSpec> createSnapshotPeriods( const MetricsmanagerConfig& config);
@@ -9,18 +9,19 @@ namespace metrics {
 vespalib::string
 StateApiAdapter::getMetrics(const vespalib::string &consumer)
 {
-    MetricLockGuard guard(_manager.getMetricLock());
-    auto periods = _manager.getSnapshotPeriods(guard);
-    if (periods.empty() || !_manager.any_snapshots_taken(guard)) {
-        return ""; // no configuration or snapshots yet
-    }
-    const MetricSnapshot &snapshot(_manager.getMetricSnapshot(guard, periods[0]));
-    vespalib::asciistream json;
-    vespalib::JsonStream stream(json);
-    metrics::JsonWriter metricJsonWriter(stream);
-    _manager.visit(guard, snapshot, metricJsonWriter, consumer);
-    stream.finalize();
-    return json.str();
+    return _manager.getCachedSnapshotRendering("state_api:" + consumer, [this, &consumer](const MetricLockGuard &guard) {
+        auto periods = _manager.getSnapshotPeriods(guard);
+        if (periods.empty() || !_manager.any_snapshots_taken(guard)) {
+            return vespalib::string(); // no configuration or snapshots yet
+        }
+        const MetricSnapshot &snapshot(_manager.getMetricSnapshot(guard, periods[0]));
+        vespalib::asciistream json;
+        vespalib::JsonStream stream(json);
+        metrics::JsonWriter metricJsonWriter(stream);
+        _manager.visit(guard, snapshot, metricJsonWriter, consumer);
+        stream.finalize();
+        return vespalib::string(json.str());
+    });
 }
 
 vespalib::string
@@ -16,6 +16,8 @@
 #include "valuemetricvalues.h"
 #include "metric.h"
 #include <cmath>
+#include <utility>
+#include <vector>
 
 namespace metrics {
 
@@ -26,6 +28,11 @@ struct AbstractValueMetric : public Metric {
     virtual MetricValueClass::UP getValues() const = 0;
     virtual bool inUse(const MetricValueClass& v) const = 0;
     virtual bool summedAverage() const = 0;
+    /**
+     * Estimated percentiles of the values added, as (name, value) pairs, for
+     * metrics tracking the value distribution. Empty for plain value metrics.
+     */
+    virtual std::vector<std::pair<vespalib::string, double>> getPercentiles() const { return {}; }
 
 protected:
     AbstractValueMetric(const String& name, Tags dimensions,
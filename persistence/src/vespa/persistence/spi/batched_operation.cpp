@@ -0,0 +1,46 @@
+// Copyright Vespa.ai. Licensed under the terms of the Apache 2.0 license. See LICENSE in the project root.
+
+#include "batched_operation.h"
+#include <vespa/document/fieldvalue/document.h>
+#include <vespa/document/update/documentupdate.h>
+
+namespace storage::spi {
+
+BatchedOperation::BatchedOperation(Type type_, Timestamp timestamp_, OperationComplete::UP onComplete_) noexcept
+    : type(type_),
+      timestamp(timestamp_),
+      document(),
+      update(),
+      id(),
+      onComplete(std::move(onComplete_))
+{}
+
+BatchedOperation::BatchedOperation(BatchedOperation&&) noexcept = default;
+BatchedOperation& BatchedOperation::operator=(BatchedOperation&&) noexcept = default;
+BatchedOperation::~BatchedOperation() = default;
+
+BatchedOperation
+BatchedOperation::make_put(Timestamp timestamp, DocumentSP doc, OperationComplete::UP onComplete)
+{
+    BatchedOperation op(Type::PUT, timestamp, std::move(onComplete));
+    op.document = std::move(doc);
+    return op;
+}
+
+BatchedOperation
+BatchedOperation::make_update(Timestamp timestamp, DocumentUpdateSP upd, OperationComplete::UP onComplete)
+{
+    BatchedOperation op(Type::UPDATE, timestamp, std::move(onComplete));
+    op.update = std::move(upd);
+    return op;
+}
+
+BatchedOperation
+BatchedOperation::make_remove_if_found(Timestamp timestamp, const document::DocumentId& id, OperationComplete::UP onComplete)
+{
+    BatchedOperation op(Type::REMOVE_IF_FOUND, timestamp, std::move(onComplete));
+    op.id = id;
+    return op;
+}
+
+}
@@ -0,0 +1,37 @@
+// Copyright Vespa.ai. Licensed under the terms of the Apache 2.0 license. See LICENSE in the project root.
+#pragma once
+
+#include "operationcomplete.h"
+#include "types.h"
+#include <vespa/document/base/documentid.h>
+
+namespace storage::spi {
+
+/**
+ * A single put, update or remove in a batch of feed operations given to
+ * PersistenceProvider::feedBatchAsync(). Each operation is completed
+ * through its own callback, with the same result type as the
+ * corresponding single-document operation.
+ */
+struct BatchedOperation {
+    enum class Type : uint8_t { PUT, UPDATE, REMOVE_IF_FOUND };
+
+    Type                  type;
+    Timestamp             timestamp;
+    DocumentSP            document; // PUT only
+    DocumentUpdateSP      update;   // UPDATE only
+    document::DocumentId  id;       // REMOVE_IF_FOUND only
+    OperationComplete::UP onComplete;
+
+    BatchedOperation(Type type_, Timestamp timestamp_, OperationComplete::UP onComplete_) noexcept;
+    BatchedOperation(BatchedOperation&&) noexcept;
+    BatchedOperation& operator=(BatchedOperation&&) noexcept;
+    ~BatchedOperation();
+
+    static BatchedOperation make_put(Timestamp timestamp, DocumentSP doc, OperationComplete::UP onComplete);
+    static BatchedOperation make_update(Timestamp timestamp, DocumentUpdateSP upd, OperationComplete::UP onComplete);
+    static BatchedOperation make_remove_if_found(Timestamp timestamp, const document::DocumentId& id,
+                                                 OperationComplete::UP onComplete);
+};
+
+}
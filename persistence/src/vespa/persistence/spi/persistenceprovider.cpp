@@ -1,6 +1,7 @@
 // Copyright Vespa.ai. Licensed under the terms of the Apache 2.0 license. See LICENSE in the project root.
 
 #include "persistenceprovider.h"
+#include "batched_operation.h"
 #include "catchresult.h"
 #include <future>
 
@@ -66,4 +67,21 @@ PersistenceProvider::update(const Bucket& bucket, Timestamp timestamp, DocumentU
     return dynamic_cast<const UpdateResult &>(*future.get());
 }
 
+void
+PersistenceProvider::feedBatchAsync(const Bucket& bucket, std::vector<BatchedOperation> ops) {
+    for (auto& op : ops) {
+        switch (op.type) {
+        case BatchedOperation::Type::PUT:
+            putAsync(bucket, op.timestamp, std::move(op.document), std::move(op.onComplete));
+            break;
+        case BatchedOperation::Type::UPDATE:
+            updateAsync(bucket, op.timestamp, std::move(op.update), std::move(op.onComplete));
+            break;
+        case BatchedOperation::Type::REMOVE_IF_FOUND:
+            removeIfFoundAsync(bucket, op.timestamp, op.id, std::move(op.onComplete));
+            break;
+        }
+    }
+}
+
 }
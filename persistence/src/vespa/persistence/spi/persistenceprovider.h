@@ -17,6 +17,7 @@ namespace vespalib { class IDestructorCallback; }
 namespace storage::spi {
 
 class IResourceUsageListener;
+struct BatchedOperation;
 struct BucketExecutor;
 struct DocTypeGidAndTimestamp;
 
@@ -218,6 +219,16 @@ struct PersistenceProvider
      */
     virtual void updateAsync(const Bucket&, Timestamp timestamp, DocumentUpdateSP update, OperationComplete::UP) = 0;
 
+    /**
+     * Applies a batch of puts, updates and removes (with removeIfFound()
+     * semantics) to documents in the given bucket, in the given order.
+     * Each operation is completed through its own callback. Providers
+     * that can apply several operations cheaper than one at a time should
+     * override this; the default implementation feeds each operation
+     * through putAsync(), updateAsync() or removeIfFoundAsync().
+     */
+    virtual void feedBatchAsync(const Bucket&, std::vector<BatchedOperation> ops);
+
     /**
      * Retrieves the latest version of the document specified by the
      * document id. If no versions were found, or the document was removed,
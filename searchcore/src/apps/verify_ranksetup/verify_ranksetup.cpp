@@ -105,8 +105,9 @@ class VerifyRankSetup
 private:
     std::vector<search::fef::Message> _messages;
     SearchMode _searchMode;
+    vespalib::string *_plans;
 
-    bool verifyIndexEnv(const search::fef::IIndexEnvironment &indexEnv);
+    bool verifyIndexEnv(const search::fef::IIndexEnvironment &indexEnv, vespalib::string &plan);
 
     bool verifyConfig(const VerifyRanksetupConfig &myCfg,
                       const VsmfieldsConfig &vsmFieldsCcfg,
@@ -118,7 +119,7 @@ private:
                       const OnnxModelsConfig &modelsCfg);
 
 public:
-    explicit VerifyRankSetup(SearchMode mode);
+    VerifyRankSetup(SearchMode mode, vespalib::string *plans);
     ~VerifyRankSetup();
     [[nodiscard]] const std::vector<search::fef::Message> & getMessages() const { return _messages; }
     bool verify(const std::string & configId);
@@ -164,15 +165,16 @@ DummyRankingAssetsRepo::getConstant(const vespalib::string &name) const {
     return {};
 }
 
-VerifyRankSetup::VerifyRankSetup(SearchMode mode)
+VerifyRankSetup::VerifyRankSetup(SearchMode mode, vespalib::string *plans)
     : _messages(),
-      _searchMode(mode)
+      _searchMode(mode),
+      _plans(plans)
 { }
 
 VerifyRankSetup::~VerifyRankSetup() = default;
 
 bool
-VerifyRankSetup::verifyIndexEnv(const search::fef::IIndexEnvironment &indexEnv) {
+VerifyRankSetup::verifyIndexEnv(const search::fef::IIndexEnvironment &indexEnv, vespalib::string &plan) {
     search::fef::BlueprintFactory factory;
     search::features::setup_search_features(factory);
     search::fef::test::setup_fef_test_plugin(factory);
@@ -195,6 +197,9 @@ VerifyRankSetup::verifyIndexEnv(const search::fef::IIndexEnvironment &indexEnv)
     for (const auto & i : rankSetup.getDumpFeatures()) {
         ok = verifyFeature(factory, indexEnv, i, "dump features", _messages) && ok;
     }
+    if (ok && (_plans != nullptr) && rankSetup.compile()) {
+        plan = rankSetup.dump_plan();
+    }
     return ok;
 }
 
@@ -240,9 +245,13 @@ VerifyRankSetup::verifyConfig(const VerifyRanksetupConfig &myCfg,
             properties.add(j.name, j.value);
         }
         auto indexEnvP = factory(properties);
-        if (verifyIndexEnv(*indexEnvP)) {
+        vespalib::string plan;
+        if (verifyIndexEnv(*indexEnvP, plan)) {
             _messages.emplace_back(search::fef::Level::INFO,
                                    fmt("rank profile '%s': pass", profile.name.c_str()));
+            if (!plan.empty()) {
+                _plans->append(fmt("rank profile '%s':\n%s", profile.name.c_str(), plan.c_str()));
+            }
         } else {
             _messages.emplace_back(search::fef::Level::ERROR,
                                    fmt("rank profile '%s': FAIL", profile.name.c_str()));
@@ -296,8 +305,8 @@ VerifyRankSetup::verify(const std::string & configid)
 }
 
 std::pair<bool, std::vector<search::fef::Message>>
-verifyRankSetup(const char * configId, SearchMode mode) {
-    VerifyRankSetup verifier{mode};
+verifyRankSetup(const char * configId, SearchMode mode, vespalib::string *plans) {
+    VerifyRankSetup verifier{mode, plans};
     bool ok = verifier.verify(configId);
 
     return {ok, verifier.getMessages()};
@@ -6,4 +6,6 @@
 
 enum class SearchMode { INDEXED, STREAMING };
 
-std::pair<bool, std::vector<search::fef::Message>> verifyRankSetup(const char * configId, SearchMode mode);
+// The execution plan of each verified rank profile is appended to plans when given
+std::pair<bool, std::vector<search::fef::Message>> verifyRankSetup(const char * configId, SearchMode mode,
+                                                                   vespalib::string *plans = nullptr);
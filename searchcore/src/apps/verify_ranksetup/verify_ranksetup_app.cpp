@@ -16,7 +16,9 @@ public:
 int
 App::usage()
 {
-    fprintf(stderr, "Usage: vespa-verify-ranksetup <config-id>\n");
+    fprintf(stderr, "Usage: vespa-verify-ranksetup <config-id> [-S] [-p]\n");
+    fprintf(stderr, "  -S : verify for streaming search\n");
+    fprintf(stderr, "  -p : dump the execution plan of each rank profile\n");
     return 1;
 }
 
@@ -39,19 +41,29 @@ int
 App::main(int argc, char **argv)
 {
     SearchMode mode = SearchMode::INDEXED;
-    if (argc == 3 && (strcmp("-S", argv[2]) == 0)) {
-        mode = SearchMode::STREAMING;
-        --argc;
+    bool dump_plan = false;
+    for (int i = 2; i < argc; ++i) {
+        if (strcmp("-S", argv[i]) == 0) {
+            mode = SearchMode::STREAMING;
+        } else if (strcmp("-p", argv[i]) == 0) {
+            dump_plan = true;
+        } else {
+            return usage();
+        }
     }
-    if (argc != 2) {
+    if (argc < 2) {
         return usage();
     }
 
-    auto [ok, messages] = verifyRankSetup(argv[1], mode);
+    vespalib::string plans;
+    auto [ok, messages] = verifyRankSetup(argv[1], mode, dump_plan ? &plans : nullptr);
 
     for (const auto & msg : messages) {
         VLOG(toLogLevel(msg.first), "%s", msg.second.c_str());
     }
+    if (dump_plan) {
+        fprintf(stdout, "%s", plans.c_str());
+    }
     return ok ? 0 : 1;
 }
 
@@ -0,0 +1,685 @@
+// Copyright Vespa.ai. Licensed under the terms of the Apache 2.0 license. See LICENSE in the project root.
+
+#include <vespa/config-bucketspaces.h>
+#include <vespa/config/helper/configgetter.hpp>
+#include <vespa/config/subscription/sourcespec.h>
+#include <vespa/document/bucket/fixed_bucket_spaces.h>
+#include <vespa/document/config/config-documenttypes.h>
+#include <vespa/document/repo/document_type_repo_factory.h>
+#include <vespa/document/repo/documenttyperepo.h>
+#include <vespa/fileacquirer/config-filedistributorrpc.h>
+#include <vespa/persistence/spi/bucket.h>
+#include <vespa/persistence/spi/bucketinfo.h>
+#include <vespa/persistence/spi/result.h>
+#include <vespa/searchcore/proton/matching/matcher.h>
+#include <vespa/searchcore/proton/matching/matching_stats.h>
+#include <vespa/searchcore/proton/matching/querylimiter.h>
+#include <vespa/searchcore/proton/metrics/metricswireservice.h>
+#include <vespa/searchcore/proton/server/bootstrapconfig.h>
+#include <vespa/searchcore/proton/server/documentdb.h>
+#include <vespa/searchcore/proton/server/documentdbconfigmanager.h>
+#include <vespa/searchcore/proton/server/fileconfigmanager.h>
+#include <vespa/searchcore/proton/server/matchers.h>
+#include <vespa/searchcore/proton/server/persistencehandlerproxy.h>
+#include <vespa/searchcore/proton/test/dummydbowner.h>
+#include <vespa/searchcore/proton/test/mock_shared_threading_service.h>
+#include <vespa/searchcore/proton/test/resulthandler.h>
+#include <vespa/searchlib/attribute/interlock.h>
+#include <vespa/searchlib/common/tunefileinfo.h>
+#include <vespa/searchlib/engine/docsumreply.h>
+#include <vespa/searchlib/engine/docsumrequest.h>
+#include <vespa/searchlib/engine/proto_converter.h>
+#include <vespa/searchlib/engine/searchreply.h>
+#include <vespa/searchlib/engine/searchrequest.h>
+#include <vespa/searchlib/index/dummyfileheadercontext.h>
+#include <vespa/searchlib/transactionlog/translogserver.h>
+#include <vespa/vespalib/stllike/asciistream.h>
+#include <vespa/vespalib/util/count_down_latch.h>
+#include <vespa/vespalib/util/signalhandler.h>
+#include <vespa/vespalib/util/simple_thread_bundle.h>
+#include <vespa/vespalib/util/stringfmt.h>
+#include <vespa/vespalib/util/threadstackexecutor.h>
+#include <vespa/vespalib/util/time.h>
+#include <arpa/inet.h>
+#include <linux/perf_event.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#include <array>
+#include <atomic>
+#include <cmath>
+#include <cstring>
+#include <fstream>
+#include <getopt.h>
+#include <filesystem>
+#include <iostream>
+#include <mutex>
+#include <thread>
+
+#include <vespa/log/log.h>
+LOG_SETUP("vespa-query-bm");
+
+using namespace std::chrono_literals;
+
+using cloud::config::filedistribution::FiledistributorrpcConfig;
+using document::DocumentTypeRepoFactory;
+using proton::BootstrapConfig;
+using proton::DocTypeName;
+using proton::DocumentDB;
+using proton::matching::MatchingStats;
+using search::engine::DocsumRequest;
+using search::engine::ProtoConverter;
+using search::engine::SearchRequest;
+using search::index::DummyFileHeaderContext;
+using search::transactionlog::TransLogServer;
+using vespa::config::content::core::BucketspacesConfig;
+using vespa::config::search::core::ProtonConfigBuilder;
+using vespalib::HwInfo;
+
+namespace {
+
+class BMParams {
+    vespalib::string _base_dir;
+    vespalib::string _doc_type;
+    vespalib::string _query_file;
+    vespalib::string _summary_class;
+    uint32_t         _client_threads;
+    uint32_t         _match_threads;
+    uint32_t         _passes;
+    int              _tls_port;
+public:
+    BMParams()
+        : _base_dir(),
+          _doc_type(),
+          _query_file(),
+          _summary_class(),
+          _client_threads(1),
+          _match_threads(1),
+          _passes(1),
+          _tls_port(9017)
+    {
+    }
+    const vespalib::string& get_base_dir() const { return _base_dir; }
+    const vespalib::string& get_doc_type() const { return _doc_type; }
+    const vespalib::string& get_query_file() const { return _query_file; }
+    const vespalib::string& get_summary_class() const { return _summary_class; }
+    uint32_t get_client_threads() const { return _client_threads; }
+    uint32_t get_match_threads() const { return _match_threads; }
+    uint32_t get_passes() const { return _passes; }
+    int get_tls_port() const { return _tls_port; }
+    void set_base_dir(vespalib::stringref value) { _base_dir = value; }
+    void set_doc_type(vespalib::stringref value) { _doc_type = value; }
+    void set_query_file(vespalib::stringref value) { _query_file = value; }
+    void set_summary_class(vespalib::stringref value) { _summary_class = value; }
+    void set_client_threads(uint32_t value) { _client_threads = value; }
+    void set_match_threads(uint32_t value) { _match_threads = value; }
+    void set_passes(uint32_t value) { _passes = value; }
+    void set_tls_port(int value) { _tls_port = value; }
+    bool check() const;
+};
+
+bool
+BMParams::check() const
+{
+    if (_base_dir.empty()) {
+        std::cerr << "Missing base dir" << std::endl;
+        return false;
+    }
+    if (_doc_type.empty()) {
+        std::cerr << "Missing document type" << std::endl;
+        return false;
+    }
+    if (_query_file.empty()) {
+        std::cerr << "Missing query file" << std::endl;
+        return false;
+    }
+    if (_client_threads < 1) {
+        std::cerr << "Too few client threads: " << _client_threads << std::endl;
+        return false;
+    }
+    if (_match_threads < 1) {
+        std::cerr << "Too few match threads: " << _match_threads << std::endl;
+        return false;
+    }
+    if (_passes < 1) {
+        std::cerr << "Too few passes: " << _passes << std::endl;
+        return false;
+    }
+    return true;
+}
+
+/*
+ * Latency histogram with power of two buckets, bucket i counts samples
+ * in [2^i, 2^(i+1)) microseconds (bucket 0 also counts shorter samples).
+ */
+class LatencyHistogram {
+    static constexpr size_t num_buckets = 32;
+    std::array<uint64_t, num_buckets> _buckets;
+    uint64_t                          _count;
+    double                            _sum_us;
+    double                            _max_us;
+
+    static double bucket_limit_us(size_t bucket) { return std::ldexp(1.0, bucket + 1); }
+public:
+    LatencyHistogram()
+        : _buckets(),
+          _count(0),
+          _sum_us(0.0),
+          _max_us(0.0)
+    {
+    }
+    void add(double time_s, uint64_t count = 1) {
+        double time_us = time_s * 1e6;
+        size_t bucket = (time_us < 2.0) ? 0 : std::min(size_t(std::log2(time_us)), num_buckets - 1);
+        _buckets[bucket] += count;
+        _count += count;
+        _sum_us += time_us * count;
+        _max_us = std::max(_max_us, time_us);
+    }
+    void merge(const LatencyHistogram& rhs) {
+        for (size_t i = 0; i < num_buckets; ++i) {
+            _buckets[i] += rhs._buckets[i];
+        }
+        _count += rhs._count;
+        _sum_us += rhs._sum_us;
+        _max_us = std::max(_max_us, rhs._max_us);
+    }
+    // Returns the upper limit of the bucket containing the given percentile
+    double percentile_us(double percentile) const {
+        uint64_t wanted = std::ceil(_count * percentile / 100.0);
+        uint64_t seen = 0;
+        for (size_t i = 0; i < num_buckets; ++i) {
+            seen += _buckets[i];
+            if (seen >= wanted && seen > 0) {
+                return std::min(bucket_limit_us(i), _max_us);
+            }
+        }
+        return _max_us;
+    }
+    void report(const vespalib::string& name) const;
+};
+
+void
+LatencyHistogram::report(const vespalib::string& name) const
+{
+    if (_count == 0) {
+        LOG(info, "%-14s: no samples", name.c_str());
+        return;
+    }
+    LOG(info, "%-14s: count=%" PRIu64 ", avg=%.1fus, p50<=%.0fus, p90<=%.0fus, p99<=%.0fus, max=%.1fus",
+        name.c_str(), _count, _sum_us / _count, percentile_us(50), percentile_us(90), percentile_us(99), _max_us);
+    vespalib::asciistream os;
+    for (size_t i = 0; i < num_buckets; ++i) {
+        if (_buckets[i] != 0) {
+            os << " <" << uint64_t(bucket_limit_us(i)) << "us:" << _buckets[i];
+        }
+    }
+    LOG(info, "%-14s:%s", name.c_str(), os.str().c_str());
+}
+
+enum Phase {
+    QUERY_SETUP,
+    MATCH,
+    SECOND_PHASE,
+    GROUPING,
+    SEARCH,
+    DOCSUM,
+    NUM_PHASES
+};
+
+const char *phase_names[NUM_PHASES] = { "query setup", "match", "second phase", "grouping", "search", "docsum" };
+
+struct PhaseHistograms {
+    std::array<LatencyHistogram, NUM_PHASES> phases;
+
+    void add_matching_stats(const MatchingStats& stats) {
+        size_t count = stats.queries();
+        if (count == 0) {
+            return;
+        }
+        phases[QUERY_SETUP].add(stats.querySetupTimeAvg(), count);
+        phases[MATCH].add(stats.matchTimeAvg(), count);
+        phases[SECOND_PHASE].add(stats.rerankTimeAvg(), count);
+        phases[GROUPING].add(stats.groupingTimeAvg(), count);
+    }
+    void merge(const PhaseHistograms& rhs) {
+        for (size_t i = 0; i < NUM_PHASES; ++i) {
+            phases[i].merge(rhs.phases[i]);
+        }
+    }
+};
+
+/*
+ * Hardware counters for the process, opened before any other threads are
+ * started and inherited by all threads created later (match threads,
+ * summary threads, ...). Unavailable counters are reported as such.
+ */
+class HwCounters {
+    struct Counter {
+        const char* name;
+        uint32_t    config;
+        int         fd;
+    };
+    std::vector<Counter> _counters;
+public:
+    HwCounters();
+    ~HwCounters();
+    std::vector<uint64_t> read() const;
+    void report(const std::vector<uint64_t>& before, const std::vector<uint64_t>& after, uint64_t queries) const;
+};
+
+HwCounters::HwCounters()
+    : _counters({{"cycles", PERF_COUNT_HW_CPU_CYCLES, -1},
+                 {"instructions", PERF_COUNT_HW_INSTRUCTIONS, -1},
+                 {"cache-misses", PERF_COUNT_HW_CACHE_MISSES, -1},
+                 {"branch-misses", PERF_COUNT_HW_BRANCH_MISSES, -1}})
+{
+    for (auto& counter : _counters) {
+        perf_event_attr attr{};
+        attr.type = PERF_TYPE_HARDWARE;
+        attr.size = sizeof(attr);
+        attr.config = counter.config;
+        attr.inherit = 1;
+        attr.exclude_kernel = 1;
+        attr.exclude_hv = 1;
+        counter.fd = syscall(SYS_perf_event_open, &attr, 0, -1, -1, 0);
+        if (counter.fd < 0) {
+            LOG(warning, "Hardware counter '%s' is not available: %s", counter.name, strerror(errno));
+        }
+    }
+}
+
+HwCounters::~HwCounters()
+{
+    for (auto& counter : _counters) {
+        if (counter.fd >= 0) {
+            close(counter.fd);
+        }
+    }
+}
+
+std::vector<uint64_t>
+HwCounters::read() const
+{
+    std::vector<uint64_t> result;
+    for (auto& counter : _counters) {
+        uint64_t value = 0;
+        if (counter.fd < 0 || ::read(counter.fd, &value, sizeof(value)) != sizeof(value)) {
+            value = 0;
+        }
+        result.push_back(value);
+    }
+    return result;
+}
+
+void
+HwCounters::report(const std::vector<uint64_t>& before, const std::vector<uint64_t>& after, uint64_t queries) const
+{
+    for (size_t i = 0; i < _counters.size(); ++i) {
+        if (_counters[i].fd < 0) {
+            continue;
+        }
+        uint64_t delta = after[i] - before[i];
+        LOG(info, "%-14s: total=%" PRIu64 ", per query=%.0f", _counters[i].name, delta,
+            (queries > 0) ? double(delta) / queries : 0.0);
+    }
+}
+
+/*
+ * Captured query log: a sequence of serialized protobuf search requests
+ * (as sent from the dispatcher), each prefixed by its size as a 4 byte
+ * integer in network byte order.
+ */
+std::vector<ProtoConverter::ProtoSearchRequest>
+read_query_log(const vespalib::string& file_name)
+{
+    std::vector<ProtoConverter::ProtoSearchRequest> result;
+    std::ifstream is(file_name, std::ios::binary);
+    if (!is) {
+        LOG(error, "Could not open query file '%s'", file_name.c_str());
+        return result;
+    }
+    std::vector<char> buf;
+    uint32_t size_n;
+    while (is.read(reinterpret_cast<char*>(&size_n), sizeof(size_n))) {
+        buf.resize(ntohl(size_n));
+        if (!is.read(buf.data(), buf.size())) {
+            LOG(warning, "Truncated query %zu in '%s'", result.size(), file_name.c_str());
+            break;
+        }
+        auto& proto = result.emplace_back();
+        if (!proto.ParseFromArray(buf.data(), buf.size())) {
+            LOG(warning, "Could not decode query %zu in '%s'", result.size() - 1, file_name.c_str());
+            result.pop_back();
+        }
+    }
+    return result;
+}
+
+class ActiveStateHandler : public proton::IGenericResultHandler {
+    vespalib::CountDownLatch& _latch;
+public:
+    explicit ActiveStateHandler(vespalib::CountDownLatch& latch) : _latch(latch) { }
+    ~ActiveStateHandler() override;
+    void handle(const storage::spi::Result& result) override {
+        if (result.hasError()) {
+            LOG(warning, "Could not activate bucket: %s", result.getErrorMessage().c_str());
+        }
+        _latch.countDown();
+    }
+};
+
+ActiveStateHandler::~ActiveStateHandler() = default;
+
+}
+
+class Benchmark {
+    BMParams                               _params;
+    HwCounters                             _hw_counters; // opened before the other members start threads
+    DocTypeName                            _doc_type_name;
+    document::BucketSpace                  _bucket_space;
+    DummyFileHeaderContext                 _file_header_context;
+    vespalib::string                       _tls_spec;
+    proton::matching::QueryLimiter         _query_limiter;
+    proton::DummyWireService               _metrics_wire_service;
+    vespalib::ThreadStackExecutor          _summary_executor;
+    proton::MockSharedThreadingService     _shared_service;
+    TransLogServer                         _tls;
+    proton::DummyDBOwner                   _document_db_owner;
+    std::shared_ptr<DocumentDB>            _document_db;
+    std::vector<ProtoConverter::ProtoSearchRequest> _queries;
+    std::atomic<uint64_t>                  _hits;
+    std::atomic<uint64_t>                  _docsums;
+
+    void load_document_db();
+    void activate_buckets();
+    void run_client(uint32_t thread_id, PhaseHistograms& histograms);
+public:
+    explicit Benchmark(const BMParams& params);
+    ~Benchmark();
+    bool run();
+};
+
+Benchmark::Benchmark(const BMParams& params)
+    : _params(params),
+      _hw_counters(),
+      _doc_type_name(params.get_doc_type()),
+      _bucket_space(document::FixedBucketSpaces::default_space()),
+      _file_header_context(),
+      _tls_spec(vespalib::make_string("tcp/localhost:%d", params.get_tls_port())),
+      _query_limiter(),
+      _metrics_wire_service(),
+      _summary_executor(8),
+      _shared_service(_summary_executor),
+      _tls(_shared_service.transport(), "tls", params.get_tls_port(), params.get_base_dir(), _file_header_context),
+      _document_db_owner(),
+      _document_db(),
+      _queries(),
+      _hits(0),
+      _docsums(0)
+{
+}
+
+Benchmark::~Benchmark()
+{
+    if (_document_db) {
+        _document_db->close();
+    }
+}
+
+void
+Benchmark::load_document_db()
+{
+    // Use the latest config snapshot saved by the document db
+    vespalib::string config_dir = _params.get_base_dir() + "/" + _doc_type_name.getName() + "/config";
+    proton::FileConfigManager config_store(_shared_service.transport(), config_dir, "", _doc_type_name.getName());
+    vespalib::string snap_dir = vespalib::make_string("%s/config-%" PRIu64, config_dir.c_str(), config_store.getBestSerialNum());
+    config::DirSpec spec(snap_dir);
+    auto document_types = config::ConfigGetter<DocumenttypesConfig>::getConfig("", spec);
+    auto repo = DocumentTypeRepoFactory::make(*document_types);
+    auto proton_cfg = std::make_shared<ProtonConfigBuilder>();
+    auto bootstrap_config = std::make_shared<BootstrapConfig>(1,
+                                                              std::move(document_types),
+                                                              std::move(repo),
+                                                              std::move(proton_cfg),
+                                                              std::make_shared<FiledistributorrpcConfig>(),
+                                                              std::make_shared<BucketspacesConfig>(),
+                                                              std::make_shared<search::TuneFileDocumentDB>(), HwInfo());
+    proton::DocumentDBConfigHelper mgr(spec, _doc_type_name.getName());
+    mgr.forwardConfig(bootstrap_config);
+    mgr.nextGeneration(_shared_service.transport(), 0ms);
+    LOG(info, "Loading document db '%s' from '%s'", _doc_type_name.getName().c_str(), _params.get_base_dir().c_str());
+    _document_db = DocumentDB::create(_params.get_base_dir(), mgr.getConfig(), _tls_spec, _query_limiter, _doc_type_name,
+                                      _bucket_space, *bootstrap_config->getProtonConfigSP(), _document_db_owner,
+                                      _shared_service, _tls,
+                                      _metrics_wire_service, _file_header_context,
+                                      std::make_shared<search::attribute::Interlock>(),
+                                      std::make_unique<proton::FileConfigManager>(_shared_service.transport(), config_dir, "",
+                                                                                  _doc_type_name.getName()),
+                                      std::make_shared<vespalib::ThreadStackExecutor>(16), HwInfo());
+    _document_db->start();
+    _document_db->waitForOnlineState();
+}
+
+void
+Benchmark::activate_buckets()
+{
+    // Bucket active state is normally set by the cluster controller, activate all to make the documents searchable
+    proton::PersistenceHandlerProxy handler(_document_db);
+    proton::test::BucketIdListResultHandler buckets;
+    handler.handleListBuckets(buckets);
+    const auto& list = buckets.getList();
+    vespalib::CountDownLatch latch(list.size());
+    for (const auto& bucket_id : list) {
+        storage::spi::Bucket bucket(document::Bucket(_bucket_space, bucket_id));
+        handler.handleSetActiveState(bucket, storage::spi::BucketInfo::ACTIVE, std::make_shared<ActiveStateHandler>(latch));
+    }
+    latch.await();
+    LOG(info, "Activated %zu buckets", list.size());
+}
+
+void
+Benchmark::run_client(uint32_t thread_id, PhaseHistograms& histograms)
+{
+    vespalib::SimpleThreadBundle thread_bundle(_params.get_match_threads());
+    auto matchers = _document_db->getReadySubDB()->getMatchers();
+    bool single_client = (_params.get_client_threads() == 1);
+    for (uint32_t pass = 0; pass < _params.get_passes(); ++pass) {
+        for (size_t i = thread_id; i < _queries.size(); i += _params.get_client_threads()) {
+            const auto& proto = _queries[i];
+            SearchRequest request;
+            ProtoConverter::search_request_from_proto(proto, request);
+            vespalib::Timer timer;
+            auto reply = _document_db->match(request, thread_bundle);
+            histograms.phases[SEARCH].add(vespalib::to_s(timer.elapsed()));
+            _hits += reply->hits.size();
+            if (single_client) {
+                // Per query phase times, observing the stats resets them
+                histograms.add_matching_stats(matchers->lookup(request.ranking)->getStats());
+            }
+            if (!_params.get_summary_class().empty() && !reply->hits.empty()) {
+                DocsumRequest docsum_request;
+                docsum_request.resultClassName = _params.get_summary_class();
+                docsum_request.ranking = request.ranking;
+                docsum_request.location = request.location;
+                docsum_request.stackDump = request.stackDump;
+                for (const auto& hit : reply->hits) {
+                    docsum_request.hits.emplace_back(hit.gid);
+                }
+                timer = vespalib::Timer();
+                auto docsum_reply = _document_db->getDocsums(docsum_request);
+                histograms.phases[DOCSUM].add(vespalib::to_s(timer.elapsed()));
+                _docsums += docsum_request.hits.size();
+            }
+        }
+    }
+}
+
+bool
+Benchmark::run()
+{
+    _queries = read_query_log(_params.get_query_file());
+    if (_queries.empty()) {
+        LOG(error, "No queries in '%s'", _params.get_query_file().c_str());
+        return false;
+    }
+    load_document_db();
+    activate_buckets();
+    auto matchers = _document_db->getReadySubDB()->getMatchers();
+    matchers->getStats(); // reset stats from startup
+    LOG(info, "--------------------------------");
+    LOG(info, "Replaying %zu queries, passes=%u, client threads=%u, match threads=%u",
+        _queries.size(), _params.get_passes(), _params.get_client_threads(), _params.get_match_threads());
+    std::vector<PhaseHistograms> client_histograms(_params.get_client_threads());
+    auto counters_before = _hw_counters.read();
+    vespalib::Timer timer;
+    std::vector<std::thread> clients;
+    for (uint32_t i = 0; i < _params.get_client_threads(); ++i) {
+        clients.emplace_back([this, i, &client_histograms]() { run_client(i, client_histograms[i]); });
+    }
+    for (auto& client : clients) {
+        client.join();
+    }
+    double elapsed_s = vespalib::to_s(timer.elapsed());
+    auto counters_after = _hw_counters.read();
+    PhaseHistograms histograms;
+    for (const auto& client : client_histograms) {
+        histograms.merge(client);
+    }
+    if (_params.get_client_threads() > 1) {
+        // Per query phase times are not separable with concurrent clients, use the average of all queries
+        histograms.add_matching_stats(matchers->getStats());
+    }
+    uint64_t queries = uint64_t(_queries.size()) * _params.get_passes();
+    LOG(info, "Replayed %" PRIu64 " queries in %.3f s, %8.2f queries/s, %" PRIu64 " hits, %" PRIu64 " docsums",
+        queries, elapsed_s, queries / elapsed_s, _hits.load(), _docsums.load());
+    for (size_t i = 0; i < NUM_PHASES; ++i) {
+        histograms.phases[i].report(phase_names[i]);
+    }
+    _hw_counters.report(counters_before, counters_after, queries);
+    LOG(info, "--------------------------------");
+    return true;
+}
+
+class App
+{
+    BMParams _bm_params;
+public:
+    App();
+    ~App();
+    void usage();
+    bool get_options(int argc, char **argv);
+    int main(int argc, char **argv);
+};
+
+App::App()
+    : _bm_params()
+{
+}
+
+App::~App() = default;
+
+void
+App::usage()
+{
+    std::cerr <<
+        "vespa-query-bm version 0.0\n"
+        "\n"
+        "Replays a captured query log against a document db loaded from disk.\n"
+        "The document db directory is used in place, run it on a copy.\n"
+        "\n"
+        "USAGE:\n";
+    std::cerr <<
+        "vespa-query-bm\n"
+        "--base-dir dir (directory with the document db and tls directories)\n"
+        "--doc-type type\n"
+        "--query-file file (size prefixed protobuf search requests)\n"
+        "[--client-threads threads]\n"
+        "[--match-threads threads]\n"
+        "[--passes passes]\n"
+        "[--summary-class class (fetch docsums for the hits)]\n"
+        "[--tls-port port]" << std::endl;
+}
+
+bool
+App::get_options(int argc, char **argv)
+{
+    int c;
+    int long_opt_index = 0;
+    static struct option long_opts[] = {
+        { "base-dir", 1, nullptr, 0 },
+        { "client-threads", 1, nullptr, 0 },
+        { "doc-type", 1, nullptr, 0 },
+        { "match-threads", 1, nullptr, 0 },
+        { "passes", 1, nullptr, 0 },
+        { "query-file", 1, nullptr, 0 },
+        { "summary-class", 1, nullptr, 0 },
+        { "tls-port", 1, nullptr, 0 },
+        { nullptr, 0, nullptr, 0 }
+    };
+    enum longopts_enum {
+        LONGOPT_BASE_DIR,
+        LONGOPT_CLIENT_THREADS,
+        LONGOPT_DOC_TYPE,
+        LONGOPT_MATCH_THREADS,
+        LONGOPT_PASSES,
+        LONGOPT_QUERY_FILE,
+        LONGOPT_SUMMARY_CLASS,
+        LONGOPT_TLS_PORT
+    };
+    optind = 1;
+    while ((c = getopt_long(argc, argv, "", long_opts, &long_opt_index)) != -1) {
+        switch (c) {
+        case 0:
+            switch(long_opt_index) {
+            case LONGOPT_BASE_DIR:
+                _bm_params.set_base_dir(optarg);
+                break;
+            case LONGOPT_CLIENT_THREADS:
+                _bm_params.set_client_threads(atoi(optarg));
+                break;
+            case LONGOPT_DOC_TYPE:
+                _bm_params.set_doc_type(optarg);
+                break;
+            case LONGOPT_MATCH_THREADS:
+                _bm_params.set_match_threads(atoi(optarg));
+                break;
+            case LONGOPT_PASSES:
+                _bm_params.set_passes(atoi(optarg));
+                break;
+            case LONGOPT_QUERY_FILE:
+                _bm_params.set_query_file(optarg);
+                break;
+            case LONGOPT_SUMMARY_CLASS:
+                _bm_params.set_summary_class(optarg);
+                break;
+            case LONGOPT_TLS_PORT:
+                _bm_params.set_tls_port(atoi(optarg));
+                break;
+            default:
+                return false;
+            }
+            break;
+        default:
+            return false;
+        }
+    }
+    return _bm_params.check();
+}
+
+int
+App::main(int argc, char **argv)
+{
+    if (!get_options(argc, argv)) {
+        usage();
+        return 1;
+    }
+    Benchmark bm(_bm_params);
+    return bm.run() ? 0 : 1;
+}
+
+int main(int argc, char **argv) {
+    vespalib::SignalHandler::PIPE.ignore();
+    DummyFileHeaderContext::setCreator("vespa-query-bm");
+    App app;
+    return app.main(argc, argv);
+}
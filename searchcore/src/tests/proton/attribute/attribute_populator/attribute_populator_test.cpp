@@ -76,7 +76,7 @@ struct Fixture
     AttributeManager::SP _mgr;
     std::unique_ptr<AttributePopulator> _pop;
     DocContext _ctx;
-    Fixture()
+    explicit Fixture(uint32_t commitBatchDocs = 1)
         : _testDir(TEST_DIR),
           _fileHeader(),
           _attributeFieldWriter(),
@@ -89,7 +89,7 @@ struct Fixture
           _ctx()
     {
         _mgr->addAttribute({ "a1", AVConfig(AVBasicType::INT32)}, CREATE_SERIAL_NUM);
-        _pop = std::make_unique<AttributePopulator>(_mgr, 1, "test", CREATE_SERIAL_NUM);
+        _pop = std::make_unique<AttributePopulator>(_mgr, 1, "test", CREATE_SERIAL_NUM, commitBatchDocs);
     }
     AttributeGuard::UP getAttr() {
         return _mgr->getAttribute("a1");
@@ -114,6 +114,26 @@ TEST_F("require that reprocess with document populates attribute", Fixture)
     EXPECT_EQUAL(CREATE_SERIAL_NUM, attr->get()->getStatus().getLastSyncToken());
 }
 
+TEST_F("require that reprocess commits documents in batches", Fixture(2))
+{
+    AttributeGuard::UP attr = f.getAttr();
+    f._pop->handleExisting(5, f._ctx.create(0, 33));
+    EXPECT_EQUAL(6u, attr->get()->getNumDocs());
+    EXPECT_EQUAL(1u, attr->get()->getCommittedDocIdLimit());
+
+    f._pop->handleExisting(6, f._ctx.create(1, 44));
+    EXPECT_EQUAL(7u, attr->get()->getCommittedDocIdLimit());
+    EXPECT_EQUAL(33, attr->get()->getInt(5));
+    EXPECT_EQUAL(44, attr->get()->getInt(6));
+
+    f._pop->handleExisting(7, f._ctx.create(2, 55));
+    EXPECT_EQUAL(7u, attr->get()->getCommittedDocIdLimit());
+    f._pop->done();
+    EXPECT_EQUAL(8u, attr->get()->getCommittedDocIdLimit());
+    EXPECT_EQUAL(55, attr->get()->getInt(7));
+    EXPECT_EQUAL(CREATE_SERIAL_NUM, attr->get()->getStatus().getLastSyncToken());
+}
+
 TEST_MAIN()
 {
     std::filesystem::remove_all(std::filesystem::path(TEST_DIR));
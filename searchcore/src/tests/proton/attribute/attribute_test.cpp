@@ -501,6 +501,100 @@ TEST_F(AttributeWriterTest, handles_update)
     }
 }
 
+TEST_F(AttributeWriterTest, batches_updates_until_commit)
+{
+    auto a1 = addAttribute("a1");
+    allocAttributeWriter();
+    fillAttribute(a1, 1, 10, 1);
+    fillAttribute(a1, 1, 10, 1);
+
+    DocBuilder db([](auto& header) { header.addField("a1", DataType::T_INT); });
+    DocumentUpdate upd1(db.get_repo(), db.get_document_type(), DocumentId("id:ns:searchdocument::1"));
+    upd1.addUpdate(FieldUpdate(upd1.getType().getField("a1"))
+                   .addUpdate(std::make_unique<ArithmeticValueUpdate>(ArithmeticValueUpdate::Add, 5)));
+    DocumentUpdate upd2(db.get_repo(), db.get_document_type(), DocumentId("id:ns:searchdocument::2"));
+    upd2.addUpdate(FieldUpdate(upd2.getType().getField("a1"))
+                   .addUpdate(std::make_unique<ArithmeticValueUpdate>(ArithmeticValueUpdate::Mul, 3)));
+
+    DummyFieldUpdateCallback onUpdate;
+    _aw->update(3, upd1, 1, emptyCallback, onUpdate);
+    _aw->update(4, upd2, 2, emptyCallback, onUpdate);
+    _aw->update(5, upd1, 2, emptyCallback, onUpdate);
+    EXPECT_EQ(0u, _attributeFieldWriter->getExecuteCnt());
+    commit(5);
+    // one task for the batched updates and one for the commit
+    EXPECT_EQ(2u, _attributeFieldWriter->getExecuteCnt());
+
+    attribute::IntegerContent ibuf;
+    ibuf.fill(*a1, 1);
+    EXPECT_EQ(15u, ibuf[0]);
+    ibuf.fill(*a1, 2);
+    EXPECT_EQ(35u, ibuf[0]);
+}
+
+TEST_F(AttributeWriterTest, dispatches_pending_updates_without_commit)
+{
+    auto a1 = addAttribute("a1");
+    allocAttributeWriter();
+    fillAttribute(a1, 1, 10, 1);
+
+    DocBuilder db([](auto& header) { header.addField("a1", DataType::T_INT); });
+    DocumentUpdate upd(db.get_repo(), db.get_document_type(), DocumentId("id:ns:searchdocument::1"));
+    upd.addUpdate(FieldUpdate(upd.getType().getField("a1"))
+                  .addUpdate(std::make_unique<ArithmeticValueUpdate>(ArithmeticValueUpdate::Add, 5)));
+
+    DummyFieldUpdateCallback onUpdate;
+    _aw->update(2, upd, 1, emptyCallback, onUpdate);
+    EXPECT_EQ(0u, _attributeFieldWriter->getExecuteCnt());
+    _aw->dispatchPendingUpdates();
+    EXPECT_EQ(1u, _attributeFieldWriter->getExecuteCnt());
+    _aw->dispatchPendingUpdates();
+    EXPECT_EQ(1u, _attributeFieldWriter->getExecuteCnt());
+    EXPECT_EQ(1u, a1->getStatus().getLastSyncToken());
+}
+
+TEST_F(AttributeWriterTest, spreads_updates_to_sharded_attribute_over_lid_ranges)
+{
+    setup(4);
+    AVConfig cfg(AVBasicType::INT32);
+    cfg.set_write_shards(3);
+    auto a1 = addAttribute({"a1", cfg});
+    fillAttribute(a1, 1, 2100, 10, 1);
+    allocAttributeWriter();
+
+    DocBuilder db([](auto& header) { header.addField("a1", DataType::T_INT); });
+    auto make_update = [&db](std::unique_ptr<ValueUpdate> value_update) {
+        auto upd = std::make_unique<DocumentUpdate>(db.get_repo(), db.get_document_type(), DocumentId("id:ns:searchdocument::1"));
+        upd->addUpdate(FieldUpdate(upd->getType().getField("a1")).addUpdate(std::move(value_update)));
+        return upd;
+    };
+    auto add = make_update(std::make_unique<ArithmeticValueUpdate>(ArithmeticValueUpdate::Add, 5));
+    auto mul = make_update(std::make_unique<ArithmeticValueUpdate>(ArithmeticValueUpdate::Mul, 3));
+    auto assign = make_update(std::make_unique<AssignValueUpdate>(std::make_unique<IntFieldValue>(7)));
+
+    DummyFieldUpdateCallback onUpdate;
+    _aw->update(2, *add, 1, emptyCallback, onUpdate);
+    _aw->update(3, *mul, 1025, emptyCallback, onUpdate);
+    _aw->update(4, *assign, 2049, emptyCallback, onUpdate);
+    _aw->update(5, *add, 1, emptyCallback, onUpdate);
+    remove(6, 1025);
+    _aw->update(7, *assign, 1025, emptyCallback, onUpdate);
+    commit(7);
+
+    auto history = _attributeFieldWriter->getExecuteHistory();
+    std::sort(history.begin(), history.end());
+    history.erase(std::unique(history.begin(), history.end()), history.end());
+    EXPECT_EQ(4u, history.size());
+    attribute::IntegerContent ibuf;
+    ibuf.fill(*a1, 1);
+    EXPECT_EQ(20u, ibuf[0]);
+    ibuf.fill(*a1, 1025);
+    EXPECT_EQ(7u, ibuf[0]);
+    ibuf.fill(*a1, 2049);
+    EXPECT_EQ(7u, ibuf[0]);
+    EXPECT_EQ(7u, a1->getStatus().getLastSyncToken());
+}
+
 TEST_F(AttributeWriterTest, handles_predicate_update)
 {
     auto a1 = addAttribute({"a1", AVConfig(AVBasicType::PREDICATE)});
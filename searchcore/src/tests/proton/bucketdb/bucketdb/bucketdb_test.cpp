@@ -248,6 +248,9 @@ TEST_F("require that remove batch works", Fixture)
     auto state4 = f.get(make_bucket_id(5));
     EXPECT_EQUAL(1200u, state4.getReadyDocSizes());
     EXPECT_EQUAL(2u, state4.getReadyCount());
+    BucketState expected_state3;
+    expected_state3.add(make_gid(4, 2), Timestamp(11), 104, SDT::READY);
+    EXPECT_EQUAL(expected_state3.getChecksum(), state3.getChecksum());
     f.remove(make_gid(4, 2), Timestamp(11), 104, SDT::READY);
     f.remove(make_gid(5, 4), Timestamp(13), 200, SDT::READY);
     f.remove(make_gid(5, 6), Timestamp(15), 1000, SDT::READY);
@@ -598,6 +598,39 @@ TEST_F("Test that single value attribute with complex attribute field results in
     TEST_DO(checkSelect(cs, f.db().getDoc(3u), Result::False));
 }
 
+TEST_F("Test that attribute compared against document independent value is compiled", TestFixture)
+{
+    MyDB &db(*f._db);
+    db.addDoc(1u, "id:ns:test::1", "hello", "null", 45, 37);
+    db.addDoc(2u, "id:ns:test::2", "gotcha", "foo", 3, 25);
+    db.addDoc(3u, "id:ns:test::3", "gotcha", "foo", noIntVal, noIntVal);
+
+    CachedSelect::SP cs = f.testParse("test.aa < 40 + 5", "test");
+    EXPECT_TRUE(cs->createSession()->hasCompiledPreDocOnlySelect());
+    TEST_DO(checkSelect(cs, 1u, Result::False,   false));
+    TEST_DO(checkSelect(cs, 2u, Result::True,    true));
+    TEST_DO(checkSelect(cs, 3u, Result::Invalid, false));
+
+    cs = f.testParse("45 <= test.aa", "test");
+    EXPECT_TRUE(cs->createSession()->hasCompiledPreDocOnlySelect());
+    TEST_DO(checkSelect(cs, 1u, Result::True,    true));
+    TEST_DO(checkSelect(cs, 2u, Result::False,   false));
+    TEST_DO(checkSelect(cs, 3u, Result::Invalid, false));
+
+    cs = f.testParse("test.aa < now() - 86400", "test");
+    EXPECT_TRUE(cs->createSession()->hasCompiledPreDocOnlySelect());
+    TEST_DO(checkSelect(cs, 1u, Result::True,    true));
+    TEST_DO(checkSelect(cs, 2u, Result::True,    true));
+
+    cs = f.testParse("test.aa != 3.5", "test");
+    EXPECT_TRUE(cs->createSession()->hasCompiledPreDocOnlySelect());
+    TEST_DO(checkSelect(cs, 1u, Result::True,    true));
+    TEST_DO(checkSelect(cs, 2u, Result::True,    true));
+
+    cs = f.testParse("test.aa < 45 and test.aa > 3", "test");
+    EXPECT_FALSE(cs->createSession()->hasCompiledPreDocOnlySelect());
+}
+
 TEST_F("Test performance when using attributes", TestFixture)
 {
     MyDB &db(*f._db);
@@ -2,6 +2,7 @@
 
 #include <vespa/searchcore/proton/test/dummydbowner.h>
 #include <vespa/searchcore/proton/attribute/attribute_writer.h>
+#include <vespa/searchcore/proton/docsummary/docsum_cache.h>
 #include <vespa/searchcore/proton/docsummary/docsumcontext.h>
 #include <vespa/searchcore/proton/docsummary/documentstoreadapter.h>
 #include <vespa/searchcore/proton/documentmetastore/documentmetastore.h>
@@ -540,6 +541,28 @@ TEST("requireThatDocsumRequestIsProcessed")
     EXPECT_TRUE(assertSlime("{docsums:[ {docsum:{a:20}}, {docsum:{a:40}}, {} ]}", *rep));
 }
 
+TEST("requireThatDocsumsCanBeFilledInParallel")
+{
+    BuildContext bc([](auto& header) { header.addField("a", DataType::T_INT); });
+    DBContext dc(bc.get_repo_sp(), getDocTypeName());
+    for (uint32_t lid = 1; lid <= 5; ++lid) {
+        auto doc = bc.make_document("id:ns:searchdocument::" + std::to_string(lid));
+        doc->setValue("a", IntFieldValue(lid * 10));
+        dc.put(*doc, lid);
+    }
+
+    DocsumRequest req;
+    req.resultClassName = "class1";
+    req.propertiesMap.lookupCreate(search::MapNames::RANK).add("vespa.summary.hits_per_task", "2");
+    req.hits.emplace_back(gid4);
+    req.hits.emplace_back(gid2);
+    req.hits.emplace_back(gid9);
+    req.hits.emplace_back(gid1);
+    req.hits.emplace_back(gid3);
+    DocsumReply::UP rep = dc._ddb->getDocsums(req);
+    EXPECT_TRUE(assertSlime("{docsums:[ {docsum:{a:40}}, {docsum:{a:20}}, {}, {docsum:{a:10}}, {docsum:{a:30}} ]}", *rep));
+}
+
 TEST("requireThatRewritersAreUsed")
 {
     BuildContext bc([](auto& header)
@@ -934,6 +957,30 @@ TEST_F("requireThatRawFieldsWorks", Fixture)
     }
 }
 
+TEST("requireThatDocsumCacheOnlyServesDocsumsOfUnchangedDocuments")
+{
+    DocsumCache cache(1_Mi);
+    ResultClass res_class("class0");
+    DocsumCache::Key key{GlobalId::parse("0x000000000000000000000001"), &res_class};
+    DocsumCache::Key other_class_key{key.gid, nullptr};
+    vespalib::Slime docsum;
+    docsum.setObject().setString("title", "foo");
+    vespalib::Slime cached;
+    EXPECT_FALSE(cache.lookup(key, 1, 1000, cached));
+    cache.insert(key, 1, 1000, docsum.get());
+    EXPECT_LESS(0u, cache.size_bytes());
+    EXPECT_TRUE(cache.lookup(key, 1, 1000, cached));
+    EXPECT_EQUAL("foo", cached.get()["title"].asString().make_string());
+    EXPECT_FALSE(cache.lookup(other_class_key, 1, 1000, cached));
+    // changed document (new timestamp) drops the cached docsum
+    EXPECT_FALSE(cache.lookup(key, 1, 1001, cached));
+    EXPECT_FALSE(cache.lookup(key, 1, 1000, cached));
+    EXPECT_EQUAL(0u, cache.size_bytes());
+    // document moved to another lid
+    cache.insert(key, 1, 1000, docsum.get());
+    EXPECT_FALSE(cache.lookup(key, 2, 1000, cached));
+}
+
 Fixture::Fixture()
     : _summaryCfg(),
       _resultCfg()
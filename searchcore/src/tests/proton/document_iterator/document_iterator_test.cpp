@@ -18,7 +18,9 @@
 #include <vespa/persistence/spi/result.h>
 #include <vespa/persistence/spi/test.h>
 #include <vespa/vespalib/objects/nbostream.h>
+#include <vespa/vespalib/util/stringfmt.h>
 #include <vespa/vespalib/testkit/test_kit.h>
+#include <optional>
 #include <unordered_set>
 
 #include <vespa/log/log.h>
@@ -282,6 +284,56 @@ struct PairDR : DocumentRetrieverBaseForTest {
     }
 };
 
+struct StoreOrderDR : DocumentRetrieverBaseForTest {
+    document::DocumentTypeRepo          repo;
+    std::vector<Document::UP>           documents;
+    Bucket                              bucket;
+    mutable std::vector<LidVector>      visited_slices;
+    std::optional<DocumentIdT>          reused_lid;
+
+    StoreOrderDR(size_t num_docs, Bucket b)
+        : repo(), documents(), bucket(b), visited_slices(), reused_lid()
+    {
+        for (size_t i(0); i < num_docs; i++) {
+            documents.push_back(make_doc(DocumentId(vespalib::make_string("id:ns:document::%zu", i))));
+        }
+    }
+    ~StoreOrderDR() override;
+    const document::DocumentTypeRepo &getDocumentTypeRepo() const override { return repo; }
+    void getBucketMetaData(const Bucket &b, DocumentMetaData::Vector &result) const override {
+        if (b == bucket) {
+            for (size_t i(0); i < documents.size(); i++) {
+                result.push_back(DocumentMetaData(i + 1, Timestamp(i + 1), bucket, documents[i]->getId().getGlobalId(), false));
+            }
+        }
+    }
+    DocumentMetaData getDocumentMetaData(const document::DocumentId &) const override { return DocumentMetaData(); }
+    document::Document::UP getFullDocument(DocumentIdT lid) const override {
+        if ((lid == 0) || (lid > documents.size())) {
+            return {};
+        }
+        if (reused_lid && (*reused_lid == lid)) {
+            return make_doc(DocumentId("id:ns:document::reused"));
+        }
+        return Document::UP(documents[lid - 1]->clone());
+    }
+    void visitDocuments(const LidVector &lids, search::IDocumentVisitor &visitor, ReadConsistency readConsistency) const override {
+        visited_slices.push_back(lids);
+        DocumentRetrieverBaseForTest::visitDocuments(lids, visitor, readConsistency);
+    }
+    // Pretend that the documents are stored in reverse lid order
+    void sortLidsInStorageOrder(LidVector &lids) const override {
+        std::sort(lids.begin(), lids.end(), std::greater<>());
+    }
+    CachedSelect::SP parseSelect(const vespalib::string &selection) const override {
+        auto res = std::make_shared<CachedSelect>();
+        res->set(selection, repo);
+        return res;
+    }
+};
+
+StoreOrderDR::~StoreOrderDR() = default;
+
 size_t getSize(const document::Document &doc) {
     vespalib::nbostream tmp;
     doc.serialize(tmp);
@@ -683,6 +735,43 @@ TEST("require that maxBytes splits iteration results for meta-data only iteratio
     EXPECT_EQUAL(0u, res3.getEntries().size());
 }
 
+TEST("require that streamed documents are read in storage order in slices bounded by maxBytes") {
+    auto retriever = std::make_shared<StoreOrderDR>(1000, bucket(5));
+    DocumentIterator itr(bucket(5), std::make_shared<document::AllFields>(), selectAll(), newestV(), -1, false,
+                         storage::spi::ReadConsistency::STRONG, true);
+    itr.add(retriever);
+    size_t doc_size = getSize(*make_doc(DocumentId("id:ns:document::999")));
+    IterateResult res1 = itr.iterate(doc_size);
+    EXPECT_TRUE(!res1.isCompleted());
+    ASSERT_EQUAL(1u, retriever->visited_slices.size());
+    EXPECT_LESS(retriever->visited_slices[0].size(), 1000u);
+    EXPECT_EQUAL(1000u, retriever->visited_slices[0][0]);
+    EXPECT_EQUAL(retriever->visited_slices[0].size(), res1.getEntries().size());
+    TEST_DO(checkEntry(res1, 0, *make_doc(DocumentId("id:ns:document::999")), Timestamp(1000)));
+
+    size_t total = res1.getEntries().size();
+    bool completed = false;
+    while (!completed) {
+        IterateResult res = itr.iterate(largeNum);
+        total += res.getEntries().size();
+        completed = res.isCompleted();
+    }
+    EXPECT_EQUAL(1000u, total);
+}
+
+TEST("require that streamed documents are skipped if their lid has been reused") {
+    auto retriever = std::make_shared<StoreOrderDR>(3, bucket(5));
+    DocumentIterator itr(bucket(5), std::make_shared<document::AllFields>(), selectAll(), newestV(), -1, false,
+                         storage::spi::ReadConsistency::STRONG, true);
+    itr.add(retriever);
+    retriever->reused_lid = 2;
+    IterateResult res = itr.iterate(largeNum);
+    EXPECT_TRUE(res.isCompleted());
+    ASSERT_EQUAL(2u, res.getEntries().size());
+    TEST_DO(checkEntry(res, 0, *make_doc(DocumentId("id:ns:document::2")), Timestamp(3)));
+    TEST_DO(checkEntry(res, 1, *make_doc(DocumentId("id:ns:document::0")), Timestamp(1)));
+}
+
 TEST("require that at least one document is returned by visit") {
     DocumentIterator itr(bucket(5), std::make_shared<document::AllFields>(), selectAll(), newestV(), -1, false);
     itr.add(doc("id:ns:document::1", Timestamp(2), bucket(5)));
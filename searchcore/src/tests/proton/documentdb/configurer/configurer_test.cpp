@@ -42,6 +42,7 @@
 #include <vespa/vespalib/util/testclock.h>
 #include <vespa/vespalib/util/threadstackexecutor.h>
 #include <filesystem>
+#include <fstream>
 
 using namespace config;
 using namespace document;
@@ -378,6 +379,39 @@ createConfig(const Schema::SP &schema)
             repo(createRepo()).build();
 }
 
+DocumentDBConfig::SP
+createRankConfig(const Schema::SP &schema, const vespalib::string &b_first_phase, const vespalib::string &expression_path)
+{
+    RankProfilesConfigBuilder builder;
+    builder.rankprofile.resize(2);
+    auto &a = builder.rankprofile[0];
+    a.name = "a";
+    a.fef.property.resize(2);
+    a.fef.property[0].name = "vespa.rank.firstphase";
+    a.fef.property[0].value = "rankingExpression(foo)";
+    a.fef.property[1].name = "rankingExpression(foo).expressionName";
+    a.fef.property[1].value = "my_expr";
+    auto &b = builder.rankprofile[1];
+    b.name = "b";
+    b.fef.property.resize(1);
+    b.fef.property[0].name = "vespa.rank.firstphase";
+    b.fef.property[0].value = b_first_phase;
+    auto expressions = make_shared<search::fef::RankingExpressions>();
+    expressions->add("my_expr", expression_path);
+    return test::DocumentDBConfigBuilder(0, schema, "client", DOC_TYPE).
+            repo(createRepo()).
+            rankProfiles(make_shared<RankProfilesConfig>(builder)).
+            rankingExpressions(expressions).build();
+}
+
+vespalib::string
+writeExpression(const vespalib::string &name, const vespalib::string &expression)
+{
+    vespalib::string path = BASE_DIR + "/" + name;
+    std::ofstream(path) << expression;
+    return path;
+}
+
 struct SearchViewComparer
 {
     SearchView::SP _old;
@@ -664,6 +698,64 @@ TEST_F("require that we can reconfigure matchers", Fixture)
     }
 }
 
+TEST_F("require that matchers for unchanged rank profiles are reused", Fixture)
+{
+    auto expr1 = writeExpression("expr1", "1+1");
+    auto expr2 = writeExpression("expr2", "2+2");
+    auto schema = f._views.getViewPtrs().fv->getSchema();
+    ReconfigParams params(CCR().setRankProfilesChanged(true).setRankingExpressionsChanged(true));
+    auto config1 = createRankConfig(schema, "value(1)", expr1);
+    f.reconfigure(*config1, *config1, params, f._resolver, 0);
+    auto m1 = f._views.getViewPtrs().sv->getMatchers();
+
+    auto config2 = createRankConfig(schema, "value(2)", expr1);
+    f.reconfigure(*config2, *config1, params, f._resolver, 0);
+    auto m2 = f._views.getViewPtrs().sv->getMatchers();
+    EXPECT_NOT_EQUAL(m1.get(), m2.get());
+    EXPECT_EQUAL(m1->lookup("a").get(), m2->lookup("a").get());
+    EXPECT_NOT_EQUAL(m1->lookup("b").get(), m2->lookup("b").get());
+
+    auto config3 = createRankConfig(schema, "value(2)", expr2);
+    f.reconfigure(*config3, *config2, params, f._resolver, 0);
+    auto m3 = f._views.getViewPtrs().sv->getMatchers();
+    EXPECT_NOT_EQUAL(m2->lookup("a").get(), m3->lookup("a").get());
+    EXPECT_EQUAL(m2->lookup("b").get(), m3->lookup("b").get());
+
+    f.reconfigure(*config3, *config3, ReconfigParams(CCR().setRankProfilesChanged(true).setSchemaChanged(true)), f._resolver, 0);
+    auto m4 = f._views.getViewPtrs().sv->getMatchers();
+    EXPECT_NOT_EQUAL(m3->lookup("a").get(), m4->lookup("a").get());
+    EXPECT_NOT_EQUAL(m3->lookup("b").get(), m4->lookup("b").get());
+}
+
+TEST_F("require that lazy rank profiles are set up on first use", Fixture)
+{
+    RankProfilesConfigBuilder builder;
+    builder.rankprofile.resize(2);
+    for (auto &profile : builder.rankprofile) {
+        profile.fef.property.resize(2);
+        profile.fef.property[0].name = "vespa.matching.lazy_setup";
+        profile.fef.property[0].value = "true";
+        profile.fef.property[1].name = "vespa.rank.firstphase";
+    }
+    builder.rankprofile[0].name = "good";
+    builder.rankprofile[0].fef.property[1].value = "value(1)";
+    builder.rankprofile[1].name = "bad";
+    builder.rankprofile[1].fef.property[1].value = "no_such_feature";
+    auto config = test::DocumentDBConfigBuilder(0, f._views.getViewPtrs().fv->getSchema(), "client", DOC_TYPE).
+            repo(createRepo()).rankProfiles(make_shared<RankProfilesConfig>(builder)).build();
+    // setup of the bad rank profile would fail here if done eagerly
+    f.reconfigure(*config, *config, ReconfigParams(CCR().setRankProfilesChanged(true)), f._resolver, 0);
+    auto matchers = f._views.getViewPtrs().sv->getMatchers();
+    auto good = matchers->lookup("good");
+    ASSERT_TRUE(good);
+    EXPECT_EQUAL(good.get(), matchers->lookup("good").get());
+    EXPECT_EQUAL("value(1)", good->get_index_env().getProperties().lookup("vespa.rank.firstphase").get());
+    auto bad = matchers->lookup("bad");
+    ASSERT_TRUE(bad);
+    EXPECT_NOT_EQUAL(good.get(), bad.get());
+    EXPECT_EQUAL(bad.get(), matchers->lookup("bad").get());
+}
+
 TEST("require that attribute manager (imported attributes) should change when imported fields has changed")
 {
     ReconfigParams params(CCR().setImportedFieldsChanged(true));
@@ -1066,6 +1066,7 @@ TEST_F("require that underlying components are explorable", StoreOnlyExplorerFix
     EXPECT_TRUE(f._explorer.get_child("attribute").get() == nullptr);
     EXPECT_TRUE(f._explorer.get_child("attributewriter").get() == nullptr);
     EXPECT_TRUE(f._explorer.get_child("index").get() == nullptr);
+    EXPECT_TRUE(f._explorer.get_child("matchers").get() == nullptr);
 }
 
 TEST_F("require that underlying components are explorable", FastAccessExplorerFixture)
@@ -1074,14 +1075,16 @@ TEST_F("require that underlying components are explorable", FastAccessExplorerFi
     EXPECT_TRUE(f._explorer.get_child("attribute").get() != nullptr);
     EXPECT_TRUE(f._explorer.get_child("attributewriter").get() != nullptr);
     EXPECT_TRUE(f._explorer.get_child("index").get() == nullptr);
+    EXPECT_TRUE(f._explorer.get_child("matchers").get() == nullptr);
 }
 
 TEST_F("require that underlying components are explorable", SearchableExplorerFixture)
 {
-    assertExplorer({"attribute", "attributewriter", "index"}, f._explorer);
+    assertExplorer({"attribute", "attributewriter", "index", "matchers"}, f._explorer);
     EXPECT_TRUE(f._explorer.get_child("attribute").get() != nullptr);
     EXPECT_TRUE(f._explorer.get_child("attributewriter").get() != nullptr);
     EXPECT_TRUE(f._explorer.get_child("index").get() != nullptr);
+    EXPECT_TRUE(f._explorer.get_child("matchers").get() != nullptr);
 }
 
 TEST_MAIN()
@@ -4,6 +4,7 @@
 #include <vespa/document/fieldvalue/document.h>
 #include <vespa/document/fieldvalue/stringfieldvalue.h>
 #include <vespa/document/repo/configbuilder.h>
+#include <vespa/document/update/assignvalueupdate.h>
 #include <vespa/document/update/documentupdate.h>
 #include <vespa/searchcore/proton/attribute/i_attribute_writer.h>
 #include <vespa/searchcore/proton/attribute/ifieldupdatecallback.h>
@@ -392,6 +393,7 @@ struct MyAttributeWriter : public IAttributeWriter
         ++_commitCount;
         _tracer.traceCommit(attributeAdapterTypeName, param.lastSerialNum());
     }
+    void dispatchPendingUpdates() override { }
     void drain(OnWriteDoneType onDone) override {
         (void) onDone;
     }
@@ -469,6 +471,11 @@ struct DocumentContext
         const document::Field &field = builder.get_document_type().getField(fieldName);
         upd->addUpdate(document::FieldUpdate(field));
     }
+    void addAssignUpdate(DocBuilder &builder, const vespalib::string &fieldName) {
+        const document::Field &field = builder.get_document_type().getField(fieldName);
+        upd->addUpdate(document::FieldUpdate(field).addUpdate(
+                std::make_unique<document::AssignValueUpdate>(field.getDataType().createFieldValue())));
+    }
     document::GlobalId gid() const { return doc->getId().getGlobalId(); }
 };
 
@@ -1078,7 +1085,7 @@ TEST_F("require that heartbeat propagates to index- and attributeadapter",
 }
 
 template <typename Fixture>
-void putDocumentAndUpdate(Fixture &f, const vespalib::string &fieldName)
+void putDocumentAndUpdate(Fixture &f, const vespalib::string &fieldName, bool assign = false)
 {
     DocumentContext dc1 = f.doc1();
     f.putAndWait(dc1);
@@ -1086,7 +1093,11 @@ void putDocumentAndUpdate(Fixture &f, const vespalib::string &fieldName)
     EXPECT_EQUAL(1u, f.msa._store._lastSyncToken);
 
     DocumentContext dc2("id:ns:searchdocument::1", 20, f.getBuilder());
-    dc2.addFieldUpdate(f.getBuilder(), fieldName);
+    if (assign) {
+        dc2.addAssignUpdate(f.getBuilder(), fieldName);
+    } else {
+        dc2.addFieldUpdate(f.getBuilder(), fieldName);
+    }
     f.updateAndWait(dc2);
     f.forceCommitAndWait();
 }
@@ -1105,7 +1116,7 @@ template <typename Fixture>
 void requireThatUpdateUpdatesAttributeAndDocumentStore(Fixture &f,
                                                        const vespalib::string &fieldName)
 {
-    putDocumentAndUpdate(f, fieldName);
+    putDocumentAndUpdate(f, fieldName, true);
 
     EXPECT_EQUAL(2u, f.msa._store._lastSyncToken); // document store updated
     assertAttributeUpdate(2u, DocumentId("id:ns:searchdocument::1"), 1, f.maw);
@@ -1131,6 +1142,15 @@ TEST_F("require that update to non fast-access attribute also updates document s
     requireThatUpdateUpdatesAttributeAndDocumentStore(f, "a1");
 }
 
+TEST_F("require that update not changing the document does not rewrite document store",
+        FastAccessFeedViewFixture)
+{
+    putDocumentAndUpdate(f, "a1");
+
+    EXPECT_EQUAL(1u, f.msa._store._lastSyncToken); // document store not updated
+    assertAttributeUpdate(2u, DocumentId("id:ns:searchdocument::1"), 1, f.maw);
+}
+
 TEST_F("require that update() to fast-access predicate attribute updates attribute and document store",
        FastAccessFeedViewFixture)
 {
@@ -56,6 +56,21 @@ TEST_F(JobTest, job_returns_false_when_multiple_move_operations_or_compaction_ar
     assertJobContext(4, 7, 3, 7, 1);
 }
 
+TEST_F(JobTest, multiple_documents_are_moved_in_each_run_when_configured)
+{
+    init_with_max_docs_to_move_per_run(2);
+    setupThreeDocumentsToCompact();
+    EXPECT_FALSE(run());
+    sync();
+    EXPECT_EQ(2u, _handler->_handleMoveCnt);
+    EXPECT_EQ(2u, _storer._moveCnt);
+    EXPECT_EQ(3u, _handler->_moveToLid);
+    EXPECT_FALSE(run()); // moves last document and ends scan
+    assertJobContext(4, 7, 3, 0, 0);
+    compact();
+    assertJobContext(4, 7, 3, 7, 1);
+}
+
 TEST_F(JobTest, job_document_is_not_moved_if_meta_has_changed)
 {
     setupThreeDocumentsToCompact();
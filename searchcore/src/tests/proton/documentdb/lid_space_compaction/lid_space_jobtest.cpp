@@ -34,7 +34,8 @@ JobTestBase::JobTestBase()
       _diskMemUsageNotifier(),
       _handler(),
       _storer(),
-      _job()
+      _job(),
+      _maxDocsToMovePerRun(1)
 {
     init(ALLOWED_LID_BLOAT, ALLOWED_LID_BLOAT_FACTOR, RESOURCE_LIMIT_FACTOR, JOB_DELAY, false, MAX_OUTSTANDING_MOVE_OPS);
 }
@@ -49,7 +50,7 @@ JobTestBase::init(uint32_t allowedLidBloat,
 {
     _handler = std::make_shared<MyHandler>(maxOutstandingMoveOps != MAX_OUTSTANDING_MOVE_OPS, true);
     DocumentDBLidSpaceCompactionConfig compactCfg(interval, allowedLidBloat, allowedLidBloatFactor,
-                                                  REMOVE_BATCH_BLOCK_RATE, REMOVE_BLOCK_RATE, false);
+                                                  REMOVE_BATCH_BLOCK_RATE, REMOVE_BLOCK_RATE, false, _maxDocsToMovePerRun);
     BlockableMaintenanceJobConfig blockableCfg(resourceLimitFactor, maxOutstandingMoveOps);
 
     _job.reset();
@@ -197,6 +198,11 @@ JobTest::init_with_node_retired(bool retired) {
     init(ALLOWED_LID_BLOAT, ALLOWED_LID_BLOAT_FACTOR, RESOURCE_LIMIT_FACTOR, JOB_DELAY, retired);
 }
 
+void
+JobTest::init_with_max_docs_to_move_per_run(uint32_t maxDocsToMovePerRun) {
+    _maxDocsToMovePerRun = maxDocsToMovePerRun;
+    init(ALLOWED_LID_BLOAT, ALLOWED_LID_BLOAT_FACTOR);
+}
 
 JobDisabledByRemoveOpsTest::JobDisabledByRemoveOpsTest() : JobTest() {}
 JobDisabledByRemoveOpsTest::~JobDisabledByRemoveOpsTest() = default;
@@ -18,6 +18,7 @@ struct JobTestBase : public ::testing::Test {
     std::shared_ptr<MyHandler> _handler;
     MyStorer _storer;
     std::shared_ptr<BlockableMaintenanceJob> _job;
+    uint32_t _maxDocsToMovePerRun;
     JobTestBase();
     ~JobTestBase() override;
     void init(uint32_t allowedLidBloat,
@@ -65,6 +66,7 @@ struct JobTest : public JobTestBase {
               uint32_t maxOutstandingMoveOps = MAX_OUTSTANDING_MOVE_OPS);
     void init_with_interval(vespalib::duration interval);
     void init_with_node_retired(bool retired);
+    void init_with_max_docs_to_move_per_run(uint32_t maxDocsToMovePerRun);
 };
 
 class JobDisabledByRemoveOpsTest : public JobTest {
@@ -370,7 +370,8 @@ public:
                            _mcCfg->getAttributeUsageSampleInterval(),
                            _mcCfg->getBlockableJobConfig(),
                            _mcCfg->getFlushConfig(),
-                           _mcCfg->getBucketMoveConfig());
+                           _mcCfg->getBucketMoveConfig(),
+                           _mcCfg->getNearestNeighborIndexMaintenanceConfig());
         _mcCfg = newCfg;
         forwardMaintenanceConfig();
     }
@@ -387,7 +388,8 @@ public:
                            _mcCfg->getAttributeUsageSampleInterval(),
                            _mcCfg->getBlockableJobConfig(),
                            _mcCfg->getFlushConfig(),
-                           _mcCfg->getBucketMoveConfig());
+                           _mcCfg->getBucketMoveConfig(),
+                           _mcCfg->getNearestNeighborIndexMaintenanceConfig());
         _mcCfg = newCfg;
         forwardMaintenanceConfig();
     }
@@ -402,7 +404,24 @@ public:
                            _mcCfg->getAttributeUsageSampleInterval(),
                            _mcCfg->getBlockableJobConfig(),
                            _mcCfg->getFlushConfig(),
-                           _mcCfg->getBucketMoveConfig());
+                           _mcCfg->getBucketMoveConfig(),
+                           _mcCfg->getNearestNeighborIndexMaintenanceConfig());
+        _mcCfg = newCfg;
+        forwardMaintenanceConfig();
+    }
+
+    void setNearestNeighborIndexMaintenanceConfig(const NearestNeighborIndexMaintenanceConfig &cfg) {
+        auto newCfg = std::make_shared<DocumentDBMaintenanceConfig>(
+                           _mcCfg->getPruneRemovedDocumentsConfig(),
+                           _mcCfg->getHeartBeatConfig(),
+                           _mcCfg->getVisibilityDelay(),
+                           _mcCfg->getLidSpaceCompactionConfig(),
+                           _mcCfg->getAttributeUsageFilterConfig(),
+                           _mcCfg->getAttributeUsageSampleInterval(),
+                           _mcCfg->getBlockableJobConfig(),
+                           _mcCfg->getFlushConfig(),
+                           _mcCfg->getBucketMoveConfig(),
+                           cfg);
         _mcCfg = newCfg;
         forwardMaintenanceConfig();
     }
@@ -997,17 +1016,25 @@ TEST_F("require that lid space compaction jobs can be disabled", MaintenanceCont
     f.forwardMaintenanceConfig();
     {
         auto jobs = f._mc.getJobList();
-        EXPECT_EQUAL(7u, jobs.size());
+        EXPECT_EQUAL(8u, jobs.size());
         EXPECT_TRUE(containsJob(jobs, "lid_space_compaction.searchdocument.my_sub_db"));
     }
     f.setLidSpaceCompactionConfig(DocumentDBLidSpaceCompactionConfig::createDisabled());
     {
         auto jobs = f._mc.getJobList();
-        EXPECT_EQUAL(4u, jobs.size());
+        EXPECT_EQUAL(5u, jobs.size());
         EXPECT_FALSE(containsJob(jobs, "lid_space_compaction.searchdocument.my_sub_db"));
     }
 }
 
+TEST_F("require that nearest neighbor index maintenance job can be disabled", MaintenanceControllerFixture)
+{
+    f.forwardMaintenanceConfig();
+    EXPECT_TRUE(containsJob(f._mc.getJobList(), "nearest_neighbor_index_maintenance.searchdocument"));
+    f.setNearestNeighborIndexMaintenanceConfig(NearestNeighborIndexMaintenanceConfig(0s, 10000, 100, 100));
+    EXPECT_FALSE(containsJob(f._mc.getJobList(), "nearest_neighbor_index_maintenance.searchdocument"));
+}
+
 void
 assertPruneRemovedDocumentsConfig(vespalib::duration expDelay, vespalib::duration expInterval, vespalib::duration interval, MaintenanceControllerFixture &f)
 {
@@ -771,7 +771,7 @@ struct UserDocFixture {
     BucketId bid2;
     BucketId bid3;
     bucketdb::BucketDBHandler _bucketDBHandler;
-    UserDocFixture();
+    explicit UserDocFixture(bool bucketTimestampIndex = false);
     ~UserDocFixture();
     void addGlobalId(const GlobalId &gid, uint32_t expLid, uint32_t timestampConst = 100) {
         uint32_t actLid = addGid(dms, gid, Timestamp(expLid + timestampConst));
@@ -783,9 +783,10 @@ struct UserDocFixture {
     void addGlobalIds(size_t numGids=7) __attribute__((noinline));
 };
 
-UserDocFixture::UserDocFixture()
+UserDocFixture::UserDocFixture(bool bucketTimestampIndex)
     : _bucketDB(createBucketDB()),
-      dms(_bucketDB), gids(), bid1(), bid2(), bid3(),
+      dms(_bucketDB, DocumentMetaStore::getFixedName(), search::GrowStrategy(), SubDbType::READY, false, bucketTimestampIndex),
+      gids(), bid1(), bid2(), bid3(),
       _bucketDBHandler(*_bucketDB)
 {
     _bucketDBHandler.addDocumentMetaStore(&dms, 0);
@@ -851,6 +852,40 @@ TEST(DocumentMetaStoreTest, can_retrieve_list_of_meta_data_from_bucket_id)
     }
 }
 
+TEST(DocumentMetaStoreTest, meta_data_in_timestamp_range_is_retrieved_from_bucket_timestamp_index)
+{
+    UserDocFixture f(true);
+    EXPECT_TRUE(f.dms.has_bucket_timestamp_index());
+    f.dms.constructFreeList();
+    f.addGlobalIds();
+    {
+        DocumentMetaData::Vector result;
+        f.dms.getMetaDataInRange(f.bid1, 102, 104, result);
+        EXPECT_EQ(2u, result.size());
+        assertMetaData(DocumentMetaData(2, Timestamp(102), f.bid1, f.gids[1]), result[0]);
+        assertMetaData(DocumentMetaData(4, Timestamp(104), f.bid1, f.gids[3]), result[1]);
+    }
+    f.putGlobalId(f.gids[0], 1, 200); // new timestamp 201
+    f.dms.remove(4, 0u);
+    f.dms.commit();
+    {
+        DocumentMetaData::Vector result;
+        f.dms.getMetaDataInRange(f.bid1, 101, 104, result);
+        EXPECT_EQ(1u, result.size());
+        assertMetaData(DocumentMetaData(2, Timestamp(102), f.bid1, f.gids[1]), result[0]);
+    }
+    {
+        DocumentMetaData::Vector result;
+        f.dms.getMetaDataInRange(f.bid1, 150, std::numeric_limits<uint64_t>::max(), result);
+        EXPECT_EQ(1u, result.size());
+        assertMetaData(DocumentMetaData(1, Timestamp(201), f.bid1, f.gids[0]), result[0]);
+    }
+    std::vector<uint32_t> lids;
+    f.dms.getLids(f.bid2, lids);
+    EXPECT_EQ((std::vector<uint32_t>{3, 6, 7}), lids);
+    f.dms.removes_complete({4});
+}
+
 TEST(DocumentMetaStoreTest, bucket_state_can_be_updated)
 {
     UserDocFixture f;
@@ -1966,6 +2001,40 @@ TEST(DocumentMetaStoreTest, multiple_lids_can_be_removed_with_removeBatch)
     dms.removes_complete({1, 3});
 }
 
+TEST(DocumentMetaStoreTest, gid_hash_index_follows_put_remove_and_move)
+{
+    DocumentMetaStore dms(createBucketDB(), DocumentMetaStore::getFixedName(), search::GrowStrategy(),
+                          SubDbType::READY, true);
+    EXPECT_TRUE(dms.has_gid_hash_index());
+    dms.constructFreeList();
+    for (uint32_t lid = 1; lid <= 5; ++lid) {
+        addLid(dms, lid);
+    }
+    for (uint32_t lid = 1; lid <= 5; ++lid) {
+        assertLidGidFound(lid, dms);
+    }
+    // Put of existing gid updates meta data in place
+    EXPECT_EQ(3u, addGid(dms, createGid(3), Timestamp(100)));
+    EXPECT_EQ(Timestamp(100), dms.getMetaData(createGid(3)).timestamp);
+    EXPECT_TRUE(dms.inspectExisting(createGid(3), 0u).ok());
+    EXPECT_FALSE(dms.inspectExisting(createGid(6), 0u).ok());
+
+    removeLid(dms, 2);
+    dms.removeBatch({4}, 6);
+    dms.commit();
+    dms.removes_complete({4});
+    assertLidGidNotFound(2, dms);
+    assertLidGidNotFound(4, dms);
+    dms.move(5u, 2u, 0u);
+    dms.commit();
+    dms.removes_complete({5u});
+    uint32_t lid = 0u;
+    EXPECT_TRUE(dms.getLid(createGid(5), lid));
+    EXPECT_EQ(2u, lid);
+    assertLidGidFound(1, dms);
+    assertLidGidFound(3, dms);
+}
+
 TEST(DocumentMetaStoreTest, serialize_for_sort)
 {
     DocumentMetaStore dms(createBucketDB());
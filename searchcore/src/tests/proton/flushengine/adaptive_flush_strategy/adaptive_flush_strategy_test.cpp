@@ -0,0 +1,168 @@
+// Copyright Vespa.ai. Licensed under the terms of the Apache 2.0 license. See LICENSE in the project root.
+
+#include <vespa/searchcore/proton/flushengine/active_flush_stats.h>
+#include <vespa/searchcore/proton/flushengine/adaptive_flush_strategy.h>
+#include <vespa/searchcore/proton/flushengine/flushcontext.h>
+#include <vespa/searchcore/proton/flushengine/tls_stats_map.h>
+#include <vespa/searchcore/proton/test/dummy_flush_handler.h>
+#include <vespa/searchcore/proton/test/dummy_flush_target.h>
+#include <vespa/vespalib/data/slime/slime.h>
+#include <vespa/vespalib/gtest/gtest.h>
+#include <vespa/vespalib/util/size_literals.h>
+
+using namespace proton;
+using search::SerialNum;
+using searchcorespi::IFlushTarget;
+using vespalib::steady_time;
+using vespalib::system_time;
+
+using Config = AdaptiveFlushStrategy::Config;
+using MemoryGain = IFlushTarget::MemoryGain;
+using StringList = std::vector<vespalib::string>;
+
+struct MyFlushTarget : public test::DummyFlushTarget {
+    int64_t     memory;
+    uint64_t    bytes_to_write;
+    system_time last_flush_time;
+    bool        urgent;
+    MyFlushTarget(const vespalib::string &name, int64_t memory_in, uint64_t bytes_to_write_in,
+                  system_time last_flush_time_in, bool urgent_in) noexcept
+        : test::DummyFlushTarget(name),
+          memory(memory_in),
+          bytes_to_write(bytes_to_write_in),
+          last_flush_time(last_flush_time_in),
+          urgent(urgent_in)
+    {
+    }
+    MemoryGain getApproxMemoryGain() const override { return MemoryGain(memory, 0); }
+    uint64_t getApproxBytesToWriteToDisk() const override { return bytes_to_write; }
+    system_time getLastFlushTime() const override { return last_flush_time; }
+    bool needUrgentFlush() const override { return urgent; }
+};
+
+class AdaptiveFlushStrategyTest : public ::testing::Test {
+protected:
+    system_time                     _start_time;
+    steady_time                     _steady_now;
+    system_time                     _system_now;
+    IFlushHandler::SP               _handler;
+    std::vector<std::shared_ptr<MyFlushTarget>> _targets;
+    flushengine::ActiveFlushStats   _active_flushes;
+
+    AdaptiveFlushStrategyTest();
+    ~AdaptiveFlushStrategyTest() override;
+
+    MyFlushTarget &add(const vespalib::string &name, int64_t memory, uint64_t bytes_to_write, bool urgent = false) {
+        _targets.push_back(std::make_shared<MyFlushTarget>(name, memory, bytes_to_write, _start_time, urgent));
+        return *_targets.back();
+    }
+    void advance(vespalib::duration delta) {
+        _steady_now += delta;
+        _system_now += delta;
+    }
+    StringList flush_targets(const AdaptiveFlushStrategy &strategy) {
+        FlushContext::List contexts;
+        for (const auto &target : _targets) {
+            contexts.push_back(std::make_shared<FlushContext>(_handler, target, 0));
+        }
+        flushengine::TlsStatsMap::Map map;
+        map[_handler->getName()] = flushengine::TlsStats();
+        flushengine::TlsStatsMap tls_stats(std::move(map));
+        auto result = strategy.getFlushTargets(contexts, tls_stats, _active_flushes, _steady_now, _system_now);
+        StringList names;
+        for (const auto &ctx : result) {
+            names.push_back(ctx->getTarget()->getName());
+        }
+        return names;
+    }
+};
+
+AdaptiveFlushStrategyTest::AdaptiveFlushStrategyTest()
+    : _start_time(std::chrono::hours(1000)),
+      _steady_now(),
+      _system_now(_start_time),
+      _handler(std::make_shared<test::DummyFlushHandler>("handler")),
+      _targets(),
+      _active_flushes()
+{
+}
+
+AdaptiveFlushStrategyTest::~AdaptiveFlushStrategyTest() = default;
+
+Config
+make_config(uint64_t max_memory)
+{
+    Config config;
+    config.maxGlobalMemory = max_memory;
+    config.diskWriteBytesPerSecond = 1_Mi;
+    config.maxWriteAmplification = 2.0;
+    config.earlyFlushPressure = 0.5;
+    config.rateSmoothingFactor = 1.0;
+    return config;
+}
+
+TEST_F(AdaptiveFlushStrategyTest, only_forced_targets_are_returned_without_pressure)
+{
+    add("t1", 10_Mi, 1_Mi);
+    add("t2", 10_Mi, 1_Mi, true);
+    AdaptiveFlushStrategy strategy(make_config(1_Gi), _start_time);
+    EXPECT_EQ(StringList({"t2"}), flush_targets(strategy));
+    advance(std::chrono::hours(25));
+    EXPECT_EQ(StringList({"t2", "t1"}), flush_targets(strategy));
+}
+
+TEST_F(AdaptiveFlushStrategyTest, all_targets_are_returned_by_score_when_memory_limit_is_reached)
+{
+    add("t1", 100_Mi, 50_Mi);
+    add("t2", 300_Mi, 10_Mi);
+    add("t3", 200_Mi, 500_Mi);
+    AdaptiveFlushStrategy strategy(make_config(500_Mi), _start_time);
+    EXPECT_EQ(StringList({"t2", "t1", "t3"}), flush_targets(strategy));
+}
+
+TEST_F(AdaptiveFlushStrategyTest, only_targets_with_low_write_amplification_are_flushed_early)
+{
+    add("t1", 100_Mi, 150_Mi);
+    add("t2", 100_Mi, 500_Mi);
+    add("t3", 100_Mi, 10_Mi);
+    AdaptiveFlushStrategy strategy(make_config(500_Mi), _start_time);
+    EXPECT_EQ(StringList({"t3", "t1"}), flush_targets(strategy));
+}
+
+TEST_F(AdaptiveFlushStrategyTest, projected_memory_growth_triggers_flush_before_limit_is_reached)
+{
+    auto &target = add("t1", 100_Mi, 100_Mi);
+    AdaptiveFlushStrategy strategy(make_config(1_Gi), _start_time);
+    EXPECT_EQ(StringList(), flush_targets(strategy));
+    advance(std::chrono::seconds(10));
+    target.memory = 300_Mi;
+    // 20 MiB/s growth over the 100s it takes to write the target gives 2300 MiB
+    EXPECT_EQ(StringList({"t1"}), flush_targets(strategy));
+    auto prediction = strategy.get_prediction();
+    EXPECT_DOUBLE_EQ(20.0 * 1_Mi, prediction.memoryGrowthRate);
+    EXPECT_DOUBLE_EQ(2300.0 * 1_Mi, prediction.predictedMemory);
+    EXPECT_GT(prediction.pressure, 1.0);
+    advance(std::chrono::seconds(10));
+    target.memory = 10_Mi;
+    // memory was freed by a flush; the growth rate is kept
+    flush_targets(strategy);
+    EXPECT_DOUBLE_EQ(20.0 * 1_Mi, strategy.get_prediction().memoryGrowthRate);
+}
+
+TEST_F(AdaptiveFlushStrategyTest, predictions_are_reported_as_slime)
+{
+    add("t1", 100_Mi, 10_Mi);
+    AdaptiveFlushStrategy strategy(make_config(1_Gi), _start_time);
+    flush_targets(strategy);
+    vespalib::Slime slime;
+    strategy.report_state(slime.setObject());
+    const auto &root = slime.get();
+    EXPECT_EQ("adaptive", root["name"].asString().make_string());
+    EXPECT_EQ(static_cast<int64_t>(100_Mi), root["totalMemory"].asLong());
+    EXPECT_DOUBLE_EQ(10.0, root["flushDuration"].asDouble());
+    EXPECT_EQ(1u, root["targets"].children());
+    EXPECT_EQ("handler.t1", root["targets"][0]["name"].asString().make_string());
+    EXPECT_DOUBLE_EQ(0.1, root["targets"][0]["writeAmplification"].asDouble());
+}
+
+GTEST_MAIN_RUN_ALL_TESTS()
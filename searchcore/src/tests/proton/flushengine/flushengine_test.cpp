@@ -1,6 +1,7 @@
 // Copyright Vespa.ai. Licensed under the terms of the Apache 2.0 license. See LICENSE in the project root.
 
 #include <vespa/searchcore/proton/flushengine/active_flush_stats.h>
+#include <vespa/searchcore/proton/flushengine/adaptive_flush_strategy.h>
 #include <vespa/searchcore/proton/flushengine/cachedflushtarget.h>
 #include <vespa/searchcore/proton/flushengine/flush_engine_explorer.h>
 #include <vespa/searchcore/proton/flushengine/flushengine.h>
@@ -65,6 +66,18 @@ class SimpleTlsStatsFactory : public flushengine::ITlsStatsFactory
     }
 };
 
+class HandlerTlsStatsFactory : public flushengine::ITlsStatsFactory
+{
+    vespalib::string _name;
+public:
+    explicit HandlerTlsStatsFactory(const vespalib::string &name) : _name(name) { }
+    flushengine::TlsStatsMap create() override {
+        vespalib::hash_map<vespalib::string, flushengine::TlsStats> map;
+        map[_name] = flushengine::TlsStats(0, 1, 1);
+        return flushengine::TlsStatsMap(std::move(map));
+    }
+};
+
 class SimpleHandler;
 
 class WrappedFlushTask : public searchcorespi::FlushTask
@@ -304,6 +317,19 @@ public:
     }
 };
 
+class MemoryTarget : public SimpleTarget {
+    int64_t _memoryGain;
+public:
+    MemoryTarget(const vespalib::string &name, int64_t memoryGain)
+        : SimpleTarget(name, 0),
+          _memoryGain(memoryGain)
+    { }
+
+    MemoryGain getApproxMemoryGain() const override {
+        return MemoryGain(_memoryGain, 0);
+    }
+};
+
 class AssertedTarget : public SimpleTarget {
 public:
     mutable bool _mgain;
@@ -876,6 +902,60 @@ TEST_F("require that oldest serial is updated when finishing priority flush stra
     EXPECT_EQUAL(20u, handler->_oldestSerial);
 }
 
+struct AdaptiveFixture
+{
+    std::shared_ptr<AdaptiveFlushStrategy> strategy;
+    FlushEngine engine;
+
+    static AdaptiveFlushStrategy::Config make_config(uint64_t maxGlobalMemory) {
+        AdaptiveFlushStrategy::Config config;
+        config.maxGlobalMemory = maxGlobalMemory;
+        return config;
+    }
+
+    explicit AdaptiveFixture(uint64_t maxGlobalMemory)
+        : strategy(std::make_shared<AdaptiveFlushStrategy>(make_config(maxGlobalMemory))),
+          engine(std::make_shared<HandlerTlsStatsFactory>("handler"), strategy, 2, 1ms)
+    { }
+
+    void wait_for_prediction(size_t expTargets) {
+        for (int pass = 0; pass < 600; ++pass) {
+            if (strategy->get_prediction().targets.size() == expTargets) {
+                break;
+            }
+            std::this_thread::sleep_for(10ms);
+        }
+        EXPECT_EQUAL(expTargets, strategy->get_prediction().targets.size());
+    }
+};
+
+TEST_F("require that adaptive strategy flushes all targets when memory limit is reached", AdaptiveFixture(1000))
+{
+    auto big = std::make_shared<MemoryTarget>("big", 800);
+    auto small = std::make_shared<MemoryTarget>("small", 400);
+    auto handler = std::make_shared<SimpleHandler>(Targets({big, small}), "handler");
+    f.engine.putFlushHandler(DocTypeName("handler"), handler);
+    f.engine.start();
+
+    EXPECT_TRUE(big->_taskDone.await(LONG_TIMEOUT));
+    EXPECT_TRUE(small->_taskDone.await(LONG_TIMEOUT));
+    EXPECT_LESS_EQUAL(1.0, f.strategy->get_prediction().pressure);
+}
+
+TEST_F("require that adaptive strategy does not flush targets below memory limit", AdaptiveFixture(1000))
+{
+    auto big = std::make_shared<MemoryTarget>("big", 300);
+    auto small = std::make_shared<MemoryTarget>("small", 200);
+    auto handler = std::make_shared<SimpleHandler>(Targets({big, small}), "handler");
+    f.engine.putFlushHandler(DocTypeName("handler"), handler);
+    f.engine.start();
+
+    TEST_DO(f.wait_for_prediction(2));
+    EXPECT_APPROX(0.5, f.strategy->get_prediction().pressure, 0.01);
+    EXPECT_FALSE(big->_initDone.await(100ms));
+    EXPECT_FALSE(small->_initDone.await(SHORT_TIMEOUT));
+}
+
 TEST("the oldest start time is tracked per flush handler in ActiveFlushStats")
 {
     using seconds = std::chrono::seconds;
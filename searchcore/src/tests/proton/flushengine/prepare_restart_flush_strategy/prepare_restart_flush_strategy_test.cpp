@@ -324,6 +324,14 @@ TEST_F("require that expensive to replay target is flushed", FlushStrategyFixtur
     TEST_DO(assertFlushContexts("[foo,baz]", targets));
 }
 
+TEST_F("require that all non-GC targets are flushed when configured to flush all", FlushStrategyFixture(Config(2.0, 0.0, 4.0, true)))
+{
+    // the best strategy would be flushing 0 targets (see above)
+    FlushContext::List targets = f.getFlushTargets(ContextsBuilder().
+            add("foo", 10, 167).addGC("bar", 11, 167).add("baz", 12, 167).build(), f._tlsStatsMap);
+    TEST_DO(assertFlushContexts("[foo,baz]", targets));
+}
+
 TEST_MAIN()
 {
     TEST_RUN_ALL();
@@ -120,6 +120,8 @@ struct IndexManagerTest : public ::testing::Test {
     TransportAndExecutorService _service;
     std::unique_ptr<IndexManager> _index_manager;
     std::optional<bool> _interleaved_features;
+    uint32_t _memory_index_push_shards;
+    uint32_t _memory_index_compress_min_docs;
     DocBuilder _builder;
 
     IndexManagerTest()
@@ -129,6 +131,8 @@ struct IndexManagerTest : public ::testing::Test {
           _service(1),
           _index_manager(),
           _interleaved_features(),
+          _memory_index_push_shards(1),
+          _memory_index_compress_min_docs(0),
           _builder(add_fields)
     {
         removeTestData();
@@ -253,7 +257,10 @@ void
 IndexManagerTest::resetIndexManager(SerialNum serial_num)
 {
     _index_manager.reset();
-    _index_manager = std::make_unique<IndexManager>(index_dir, IndexConfig(), getSchema(_interleaved_features), serial_num,
+    _index_manager = std::make_unique<IndexManager>(index_dir,
+                             IndexConfig(WarmupConfig(), 2, 0, 0, 0, 1, 0, false, _memory_index_push_shards,
+                                         _memory_index_compress_min_docs),
+                             getSchema(_interleaved_features), serial_num,
                              _reconfigurer, _service.write(), _service.shared(),
                              TuneFileIndexManager(), TuneFileAttributes(), _fileHeaderContext);
     _serial_num = std::max(serial_num, _index_manager->getFlushedSerialNum());
@@ -906,6 +913,42 @@ TEST_F(IndexManagerTest, field_length_info_is_loaded_from_disk_index_during_star
     expect_field_length_info(1, 2, *as_memory_index(*sources, 1));
 }
 
+TEST_F(IndexManagerTest, memory_index_with_push_shards_is_flushed)
+{
+    _memory_index_push_shards = 4;
+    resetIndexManager();
+    for (uint32_t i = 0; i < 10; ++i) {
+        addDocument(docid + i);
+    }
+    auto sources = get_source_collection();
+    ASSERT_EQ(1, sources->getSourceCount());
+    expect_field_length_info(1, 10, *as_memory_index(*sources, 0));
+
+    flushIndexManager();
+
+    sources = get_source_collection();
+    ASSERT_EQ(2, sources->getSourceCount());
+    expect_field_length_info(1, 10, *as_disk_index(*sources, 0));
+}
+
+TEST_F(IndexManagerTest, memory_index_with_posting_list_compression_is_flushed)
+{
+    _memory_index_compress_min_docs = 4;
+    resetIndexManager();
+    for (uint32_t i = 0; i < 10; ++i) {
+        addDocument(docid + i);
+    }
+    auto sources = get_source_collection();
+    ASSERT_EQ(1, sources->getSourceCount());
+    expect_field_length_info(1, 10, *as_memory_index(*sources, 0));
+
+    flushIndexManager();
+
+    sources = get_source_collection();
+    ASSERT_EQ(2, sources->getSourceCount());
+    expect_field_length_info(1, 10, *as_disk_index(*sources, 0));
+}
+
 TEST_F(IndexManagerTest, fusion_can_be_stopped)
 {
     resetIndexManager();
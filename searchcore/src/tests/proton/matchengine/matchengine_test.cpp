@@ -3,6 +3,7 @@
 #include <vespa/vespalib/data/slime/slime.h>
 #include <vespa/searchlib/engine/docsumreply.h>
 #include <vespa/vespalib/testkit/test_kit.h>
+#include <vespa/vespalib/coro/completion.h>
 #include <mutex>
 #include <condition_variable>
 #include <chrono>
@@ -146,6 +147,17 @@ TEST("requireThatBundlesAreUsed")
     EXPECT_EQUAL(5u, handler->bundleSize);
 }
 
+TEST("require that searches can be performed as coroutines")
+{
+    MatchEngine engine(1, 1, 7);
+    engine.setNodeUp(true);
+    engine.putSearchHandler(DocTypeName("foo"), std::make_shared<MySearchHandler>(3));
+    SearchReply::UP reply = vespalib::coro::sync_wait(engine.search_async(SearchRequest::Source(new SearchRequest())));
+    ASSERT_TRUE(reply);
+    EXPECT_EQUAL(3u, reply->hits.size());
+    EXPECT_EQUAL(7u, reply->getDistributionKey());
+}
+
 TEST("requireThatHandlersCanBeRemoved")
 {
     MatchEngine engine(1, 1, 7);
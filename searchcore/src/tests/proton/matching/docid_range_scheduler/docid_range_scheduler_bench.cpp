@@ -139,6 +139,23 @@ struct AdaptiveSchedulerFactory : public SchedulerFactory {
     }
 };
 
+struct NumaSchedulerFactory : public SchedulerFactory {
+    size_t num_threads;
+    size_t num_nodes;
+    size_t tasks_per_thread;
+    NumaSchedulerFactory(size_t num_threads_in, size_t num_nodes_in, size_t tasks_per_thread_in)
+        : num_threads(num_threads_in), num_nodes(num_nodes_in), tasks_per_thread(tasks_per_thread_in) {}
+    vespalib::string desc() const override {
+        return make_string("numa(threads:%zu,nodes:%zu,tasks_per_thread:%zu)", num_threads, num_nodes, tasks_per_thread);
+    }
+    DocidRangeScheduler::UP create(uint32_t docid_limit) const override {
+        // threads are assigned to nodes in consecutive blocks
+        auto node_of_thread = [n = num_nodes, t = num_threads](size_t thread_id) { return (thread_id * n) / t; };
+        return std::make_unique<NumaDocidRangeScheduler>(num_threads, std::vector<size_t>(num_nodes, 1), node_of_thread,
+                                                         tasks_per_thread, docid_limit);
+    }
+};
+
 struct SchedulerList {
     std::vector<SchedulerFactory::UP> factory_list;
     SchedulerList(size_t num_threads) : factory_list() {
@@ -152,6 +169,8 @@ struct SchedulerList {
         factory_list.push_back(std::make_unique<AdaptiveSchedulerFactory>(num_threads, 100));
         factory_list.push_back(std::make_unique<AdaptiveSchedulerFactory>(num_threads, 10));
         factory_list.push_back(std::make_unique<AdaptiveSchedulerFactory>(num_threads, 1));
+        factory_list.push_back(std::make_unique<NumaSchedulerFactory>(num_threads, 2, 4));
+        factory_list.push_back(std::make_unique<NumaSchedulerFactory>(num_threads, 2, 64));
     }
 };
 
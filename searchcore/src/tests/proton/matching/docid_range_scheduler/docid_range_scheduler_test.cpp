@@ -3,6 +3,7 @@
 #include <vespa/vespalib/testkit/test_kit.h>
 #include <vespa/vespalib/testkit/time_bomb.h>
 #include <vespa/searchcore/proton/matching/docid_range_scheduler.h>
+#include <vespa/vespalib/util/numa_topology.h>
 
 using namespace proton::matching;
 using vespalib::TimeBomb;
@@ -143,6 +144,120 @@ TEST("require that the task scheduler protects against documents underflow") {
 
 //-----------------------------------------------------------------------------
 
+// worker threads assigned to nodes in consecutive blocks
+NumaDocidRangeScheduler::NodeResolver fixed_nodes(std::vector<size_t> thread_node) {
+    return [thread_node](size_t thread_id) { return thread_node[thread_id]; };
+}
+
+TEST("require that the numa scheduler splits the docid space according to node weights") {
+    NumaDocidRangeScheduler scheduler(4, {3, 1}, fixed_nodes({0, 0, 0, 1}), 1, 17);
+    EXPECT_EQUAL(scheduler.num_nodes(), 2u);
+    TEST_DO(verify_range(scheduler.node_range(0), DocidRange(1, 13)));
+    TEST_DO(verify_range(scheduler.node_range(1), DocidRange(13, 17)));
+    TEST_DO(verify_range(scheduler.first_range(3), DocidRange(13, 17)));
+    TEST_DO(verify_range(scheduler.first_range(0), DocidRange(1, 5)));
+}
+
+TEST("require that the numa scheduler treats nodes without weight as having weight 1") {
+    NumaDocidRangeScheduler scheduler(2, {0, 0}, fixed_nodes({0, 1}), 2, 9);
+    TEST_DO(verify_range(scheduler.node_range(0), DocidRange(1, 5)));
+    TEST_DO(verify_range(scheduler.node_range(1), DocidRange(5, 9)));
+}
+
+TEST("require that the numa scheduler acts as expected") {
+    NumaDocidRangeScheduler scheduler(4, {1, 1}, fixed_nodes({0, 0, 1, 1}), 2, 17);
+    EXPECT_EQUAL(scheduler.unassigned_size(), 16u);
+    TEST_DO(verify_range(scheduler.first_range(0), DocidRange(1, 3)));
+    TEST_DO(verify_range(scheduler.first_range(1), DocidRange(3, 5)));
+    TEST_DO(verify_range(scheduler.first_range(2), DocidRange(9, 11)));
+    TEST_DO(verify_range(scheduler.first_range(3), DocidRange(11, 13)));
+    TEST_DO(verify_range(scheduler.next_range(0), DocidRange(5, 7)));
+    TEST_DO(verify_range(scheduler.next_range(0), DocidRange(7, 9)));
+    EXPECT_EQUAL(scheduler.unassigned_size(), 4u);
+    // node 0 has no more work; steal the last task of node 1
+    TEST_DO(verify_range(scheduler.next_range(0), DocidRange(15, 17)));
+    TEST_DO(verify_range(scheduler.next_range(2), DocidRange(13, 15)));
+    TEST_DO(verify_range(scheduler.next_range(3), DocidRange()));
+    TEST_DO(verify_range(scheduler.next_range(1), DocidRange()));
+    EXPECT_EQUAL(scheduler.unassigned_size(), 0u);
+    EXPECT_EQUAL(scheduler.total_size(0), 8u);
+    EXPECT_EQUAL(scheduler.total_size(1), 2u);
+    EXPECT_EQUAL(scheduler.total_size(2), 4u);
+    EXPECT_EQUAL(scheduler.total_size(3), 2u);
+    EXPECT_EQUAL(scheduler.local_ranges(0), 3u);
+    EXPECT_EQUAL(scheduler.stolen_ranges(0), 1u);
+    EXPECT_EQUAL(scheduler.local_ranges(1), 1u);
+    EXPECT_EQUAL(scheduler.stolen_ranges(1), 0u);
+    EXPECT_EQUAL(scheduler.local_ranges(2), 2u);
+    EXPECT_EQUAL(scheduler.stolen_ranges(2), 0u);
+    EXPECT_EQUAL(scheduler.local_ranges(3), 1u);
+    EXPECT_EQUAL(scheduler.stolen_ranges(3), 0u);
+}
+
+TEST("require that the numa scheduler steals from the node with the most work left") {
+    NumaDocidRangeScheduler scheduler(3, {1, 1, 1}, fixed_nodes({0, 1, 2}), 2, 13);
+    TEST_DO(verify_range(scheduler.first_range(0), DocidRange(1, 3)));
+    TEST_DO(verify_range(scheduler.next_range(0), DocidRange(3, 5)));
+    TEST_DO(verify_range(scheduler.first_range(1), DocidRange(5, 7)));
+    TEST_DO(verify_range(scheduler.next_range(0), DocidRange(11, 13)));
+    TEST_DO(verify_range(scheduler.next_range(0), DocidRange(7, 9)));
+    TEST_DO(verify_range(scheduler.next_range(0), DocidRange(9, 11)));
+    TEST_DO(verify_range(scheduler.next_range(0), DocidRange()));
+    EXPECT_EQUAL(scheduler.local_ranges(0), 2u);
+    EXPECT_EQUAL(scheduler.stolen_ranges(0), 3u);
+}
+
+TEST("require that the numa scheduler gives work from the node the thread is currently running on") {
+    std::vector<size_t> thread_node = {0, 1};
+    NumaDocidRangeScheduler scheduler(2, {1, 1}, [&thread_node](size_t thread_id) { return thread_node[thread_id]; }, 2, 9);
+    TEST_DO(verify_range(scheduler.first_range(0), DocidRange(1, 3)));
+    thread_node[0] = 1; // thread 0 migrated to node 1
+    TEST_DO(verify_range(scheduler.next_range(0), DocidRange(5, 7)));
+    TEST_DO(verify_range(scheduler.first_range(1), DocidRange(7, 9)));
+    thread_node[1] = 0; // thread 1 migrated to node 0
+    TEST_DO(verify_range(scheduler.next_range(1), DocidRange(3, 5)));
+    TEST_DO(verify_range(scheduler.next_range(0), DocidRange()));
+    EXPECT_EQUAL(scheduler.local_ranges(0), 2u);
+    EXPECT_EQUAL(scheduler.local_ranges(1), 2u);
+    EXPECT_EQUAL(scheduler.stolen_ranges(0), 0u);
+    EXPECT_EQUAL(scheduler.stolen_ranges(1), 0u);
+}
+
+TEST("require that the numa scheduler folds topology nodes beyond the node limit") {
+    vespalib::NumaTopology topology({{0}, {1, 2}, {3}, {4}});
+    auto scheduler = NumaDocidRangeScheduler::make(5, topology, 2, 1, 11);
+    EXPECT_EQUAL(scheduler->num_nodes(), 2u);
+    // node 0 gets the cpus of nodes 0 and 2, node 1 those of nodes 1 and 3
+    TEST_DO(verify_range(scheduler->node_range(0), DocidRange(1, 5)));
+    TEST_DO(verify_range(scheduler->node_range(1), DocidRange(5, 11)));
+}
+
+TEST("require that the numa scheduler made from a topology uses the node of the current cpu") {
+    std::vector<size_t> low;
+    std::vector<size_t> high;
+    for (size_t cpu = 0; cpu < 2048; ++cpu) {
+        high.push_back(cpu + 2048);
+        low.push_back(cpu);
+    }
+    // the test thread is running on one of the low cpus, which belong to node 1
+    vespalib::NumaTopology topology({high, low});
+    auto scheduler = NumaDocidRangeScheduler::make(2, topology, 2, 2, 9);
+    TEST_DO(verify_range(scheduler->first_range(0), DocidRange(5, 7)));
+    TEST_DO(verify_range(scheduler->next_range(0), DocidRange(7, 9)));
+    EXPECT_EQUAL(scheduler->local_ranges(0), 2u);
+}
+
+TEST("require that the numa scheduler protects against documents underflow") {
+    NumaDocidRangeScheduler scheduler(2, {1, 1}, fixed_nodes({0, 1}), 2, 0);
+    EXPECT_EQUAL(scheduler.total_size(0), 0u);
+    EXPECT_EQUAL(scheduler.total_size(1), 0u);
+    EXPECT_EQUAL(scheduler.unassigned_size(), 0u);
+    TEST_DO(verify_range(scheduler.first_range(0), DocidRange(1,1)));
+    TEST_DO(verify_range(scheduler.first_range(1), DocidRange(1,1)));
+}
+
+//-----------------------------------------------------------------------------
+
 TEST("require that the adaptive scheduler starts by dividing the docid space equally") {
     AdaptiveDocidRangeScheduler scheduler(4, 1, 16);
     EXPECT_EQUAL(scheduler.total_size(0), 4u);
@@ -207,4 +207,13 @@ TEST_MT_F("require that second phase work is evenly distributed among search thr
     }
 }
 
+TEST_MT_F("require that first phase threshold is shared among search threads", 4, MatchLoopCommunicator(num_threads, 5)) {
+    auto &threshold = f1.first_phase_threshold();
+    threshold.publish(thread_id * 10.0);
+    TEST_BARRIER();
+    EXPECT_EQUAL(30.0, threshold.get());
+    EXPECT_FALSE(threshold.publish(20.0));
+    EXPECT_EQUAL(30.0, threshold.get());
+}
+
 TEST_MAIN() { TEST_RUN_ALL(); }
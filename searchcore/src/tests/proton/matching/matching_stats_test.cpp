@@ -275,6 +275,22 @@ TEST("requireThatSoftDoomIsSetAndAdded") {
     EXPECT_EQUAL(0.5, stats2.softDoomFactor());  // Not affected by add
 }
 
+TEST("requireThatLocalAndStolenRangesAddUp") {
+    MatchingStats stats;
+    stats.merge_partition(MatchingStats::Partition().localRanges(3).stolenRanges(1), 0);
+    stats.merge_partition(MatchingStats::Partition().localRanges(4).stolenRanges(0), 1);
+    EXPECT_EQUAL(7u, stats.localRanges());
+    EXPECT_EQUAL(1u, stats.stolenRanges());
+    EXPECT_EQUAL(3u, stats.getPartition(0).localRanges());
+    EXPECT_EQUAL(1u, stats.getPartition(0).stolenRanges());
+    MatchingStats all;
+    all.add(stats).add(stats);
+    EXPECT_EQUAL(14u, all.localRanges());
+    EXPECT_EQUAL(2u, all.stolenRanges());
+    EXPECT_EQUAL(8u, all.getPartition(1).localRanges());
+    EXPECT_EQUAL(0u, all.getPartition(1).stolenRanges());
+}
+
 TEST("requireThatSoftDoomFacorIsComputedCorrectlyForDownAdjustment") {
     MatchingStats stats;
     EXPECT_EQUAL(0ul, stats.softDoomed());
@@ -7,13 +7,18 @@
 #include <vespa/searchcore/proton/matching/match_tools.h>
 #include <vespa/searchcore/proton/matching/matcher.h>
 #include <vespa/searchcore/proton/matching/querynodes.h>
+#include <vespa/searchcore/proton/matching/result_cache.h>
+#include <vespa/searchcore/proton/matching/query_memory_estimate.h>
+#include <vespa/searchcore/proton/matching/stash_pool.h>
 #include <vespa/searchcore/proton/matching/sessionmanager.h>
 #include <vespa/searchcore/proton/matching/viewresolver.h>
 #include <vespa/searchcore/proton/test/bucketfactory.h>
+#include <vespa/searchcommon/attribute/config.h>
 #include <vespa/searchlib/aggregation/aggregation.h>
 #include <vespa/searchlib/aggregation/grouping.h>
 #include <vespa/searchlib/aggregation/perdocexpression.h>
 #include <vespa/searchlib/attribute/extendableattributes.h>
+#include <vespa/searchlib/attribute/singlenumericattribute.h>
 #include <vespa/searchlib/engine/docsumreply.h>
 #include <vespa/searchlib/engine/docsumrequest.h>
 #include <vespa/searchlib/engine/searchreply.h>
@@ -35,6 +40,7 @@
 #include <vespa/vespalib/testkit/testapp.h>
 #include <vespa/vespalib/util/featureset.h>
 #include <vespa/vespalib/util/simple_thread_bundle.h>
+#include <vespa/vespalib/util/size_literals.h>
 #include <vespa/vespalib/util/testclock.h>
 #include <vespa/vespalib/stllike/asciistream.h>
 #include <initializer_list>
@@ -218,6 +224,19 @@ struct MyWorld {
         }
     }
 
+    // Single value attribute with value = docid whose attribute feature can read values in batches
+    void add_batchable_attribute(const vespalib::string &name) {
+        search::attribute::Config cfg(search::attribute::BasicType::INT32);
+        auto *attr = new search::SingleValueNumericAttribute<search::IntegerAttributeTemplate<int32_t>>(name, cfg);
+        attr->addDocs(NUM_DOCS);
+        for (uint32_t i = 0; i < NUM_DOCS; ++i) {
+            attr->update(i, i);
+        }
+        attr->commit();
+        schema.addAttributeField(Schema::AttributeField(name, DataType::INT32));
+        attributeContext.add(attr);
+    }
+
     void set_property(const vespalib::string &name, const vespalib::string &value) {
         Properties cfg;
         cfg.add(name, value);
@@ -392,6 +411,28 @@ struct MyWorld {
         return match_tools->match_data().get_termwise_limit();
     }
 
+    uint32_t get_first_phase_batch_size() {
+        Matcher::SP matcher = createMatcher();
+        SearchRequest::SP request = createSimpleRequest("f1", "spread");
+        search::fef::Properties overrides;
+        auto mtf = matcher->create_match_tools_factory(*request, searchContext, attributeContext, metaStore, overrides,
+                                                       ttb(), nullptr, searchContext.getDocIdLimit(), true);
+        MatchTools::UP match_tools = mtf->createMatchTools();
+        match_tools->setup_first_phase(nullptr);
+        return match_tools->first_phase_batch_size();
+    }
+
+    size_t get_first_phase_max_batch_size() {
+        Matcher::SP matcher = createMatcher();
+        SearchRequest::SP request = createSimpleRequest("f1", "spread");
+        search::fef::Properties overrides;
+        auto mtf = matcher->create_match_tools_factory(*request, searchContext, attributeContext, metaStore, overrides,
+                                                       ttb(), nullptr, searchContext.getDocIdLimit(), true);
+        MatchTools::UP match_tools = mtf->createMatchTools();
+        match_tools->setup_first_phase(nullptr);
+        return match_tools->rank_program().max_batch_size();
+    }
+
     SearchReply::UP performSearch(const SearchRequest & req, size_t threads) {
         Matcher::SP matcher = createMatcher();
         SearchSession::OwnershipBundle owned_objects({std::make_unique<MockAttributeContext>(),
@@ -590,6 +631,60 @@ TEST("require that ranking is performed (multi-threaded)") {
     }
 }
 
+TEST("require that batched first phase ranking gives the same result (multi-threaded)") {
+    for (size_t threads = 1; threads <= 16; ++threads) {
+        MyWorld world;
+        world.basicSetup();
+        world.set_property(indexproperties::matching::FirstPhaseBatchSize::NAME, "4");
+        world.basicResults();
+        EXPECT_EQUAL(4u, world.get_first_phase_batch_size());
+        SearchRequest::SP request = MyWorld::createSimpleRequest("f1", "spread");
+        SearchReply::UP reply = world.performSearch(*request, threads);
+        EXPECT_EQUAL(9u, world.matchingStats.docsMatched());
+        EXPECT_EQUAL(9u, world.matchingStats.docsRanked());
+        ASSERT_TRUE(reply->hits.size() == 9u);
+        EXPECT_EQUAL(document::DocumentId("id:ns:searchdocument::900").getGlobalId(),  reply->hits[0].gid);
+        EXPECT_EQUAL(900.0, reply->hits[0].metric);
+        EXPECT_EQUAL(document::DocumentId("id:ns:searchdocument::800").getGlobalId(),  reply->hits[1].gid);
+        EXPECT_EQUAL(800.0, reply->hits[1].metric);
+        EXPECT_EQUAL(document::DocumentId("id:ns:searchdocument::100").getGlobalId(),  reply->hits[8].gid);
+        EXPECT_EQUAL(100.0, reply->hits[8].metric);
+    }
+}
+
+TEST("require that first phase ranking evaluates batches of hits together (multi-threaded)") {
+    for (size_t threads = 1; threads <= 16; ++threads) {
+        MyWorld world;
+        world.basicSetup();
+        world.add_batchable_attribute("a4");
+        world.set_property(indexproperties::rank::FirstPhase::NAME, "attribute(a4)");
+        // the batch size of the rank program is used when not set explicitly
+        world.set_property(indexproperties::eval::AttributeBatchSize::NAME, "3");
+        world.basicResults();
+        EXPECT_EQUAL(3u, world.get_first_phase_max_batch_size());
+        EXPECT_EQUAL(3u, world.get_first_phase_batch_size());
+        SearchRequest::SP request = MyWorld::createSimpleRequest("f1", "spread");
+        SearchReply::UP reply = world.performSearch(*request, threads);
+        EXPECT_EQUAL(9u, world.matchingStats.docsMatched());
+        EXPECT_EQUAL(9u, world.matchingStats.docsRanked());
+        ASSERT_TRUE(reply->hits.size() == 9u);
+        for (size_t i = 0; i < 9u; ++i) {
+            uint32_t docid = 900 - (i * 100);
+            EXPECT_EQUAL(document::DocumentId(vespalib::make_string("id:ns:searchdocument::%u", docid)).getGlobalId(), reply->hits[i].gid);
+            EXPECT_EQUAL(double(docid), reply->hits[i].metric);
+        }
+    }
+}
+
+TEST("require that first phase ranking is not batched when rank program uses match data") {
+    MyWorld world;
+    world.basicSetup();
+    world.set_property(indexproperties::rank::FirstPhase::NAME, "matches(f1)");
+    world.set_property(indexproperties::matching::FirstPhaseBatchSize::NAME, "4");
+    world.basicResults();
+    EXPECT_EQUAL(0u, world.get_first_phase_batch_size());
+}
+
 TEST("require that re-ranking is performed (multi-threaded)") {
     for (size_t threads = 1; threads <= 16; ++threads) {
         MyWorld world;
@@ -932,6 +1027,57 @@ TEST("require that getSummaryFeatures prefers cached query setup") {
     EXPECT_EQUAL(2.0, count_f1_matches(*fs)); // "foo" has two hits
 }
 
+TEST("require that summary features can be calculated as part of matching") {
+    MyWorld world;
+    world.basicSetup();
+    world.basicResults();
+    SearchRequest::SP request = MyWorld::createSimpleRequest("f1", "foo");
+    request->propertiesMap.lookupCreate(search::MapNames::CACHES).add("query", "true");
+    request->propertiesMap.lookupCreate(search::MapNames::RANK).add("vespa.summary.precompute_features", "true");
+    request->sessionId.push_back('a');
+    SearchReply::UP reply = world.performSearch(*request, 2);
+    EXPECT_EQUAL(3u, reply->hits.size());
+    SearchSession::SP session = world.sessionManager->pickSearch("a");
+    ASSERT_TRUE(session);
+    FeatureSet::SP precomputed = session->get_summary_features();
+    ASSERT_TRUE(precomputed);
+    EXPECT_EQUAL(5u, precomputed->numFeatures());
+    EXPECT_EQUAL(3u, precomputed->numDocs());
+
+    auto docsum_request = MyWorld::create_docsum_request("", {30, 10});
+    docsum_request->sessionId = request->sessionId;
+    docsum_request->propertiesMap.lookupCreate(search::MapNames::CACHES).add("query", "true");
+    FeatureSet::SP fs = world.getSummaryFeatures(*docsum_request);
+    EXPECT_EQUAL(precomputed.get(), fs.get());
+    const auto *f = fs->getFeaturesByDocId(30);
+    ASSERT_TRUE(f);
+    EXPECT_EQUAL(30, f[0].as_double());
+    EXPECT_EQUAL(1, f[1].as_double());
+    EXPECT_EQUAL(100, f[4].as_double());
+
+    // falls back to calculating the features when a hit is not covered
+    docsum_request = MyWorld::create_docsum_request("", {30, 15});
+    docsum_request->sessionId = request->sessionId;
+    docsum_request->propertiesMap.lookupCreate(search::MapNames::CACHES).add("query", "true");
+    fs = world.getSummaryFeatures(*docsum_request);
+    EXPECT_NOT_EQUAL(precomputed.get(), fs.get());
+    EXPECT_EQUAL(2u, fs->numDocs());
+    EXPECT_EQUAL(1.0, count_f1_matches(*fs));
+}
+
+TEST("require that summary features are not calculated as part of matching by default") {
+    MyWorld world;
+    world.basicSetup();
+    world.basicResults();
+    SearchRequest::SP request = MyWorld::createSimpleRequest("f1", "foo");
+    request->propertiesMap.lookupCreate(search::MapNames::CACHES).add("query", "true");
+    request->sessionId.push_back('a');
+    world.performSearch(*request, 1);
+    SearchSession::SP session = world.sessionManager->pickSearch("a");
+    ASSERT_TRUE(session);
+    EXPECT_FALSE(session->get_summary_features());
+}
+
 TEST("require that match params are set up straight with ranking on") {
     MatchParams p(10, 2, 4, 0.7, 0, 1, true, true);
     ASSERT_EQUAL(10u, p.numDocs);
@@ -1186,6 +1332,15 @@ TEST_F("attribute blueprint params are extracted from query", AttributeBlueprint
     EXPECT_EQUAL(FMA::DfaExplicit, params.fuzzy_matching_algorithm);
 }
 
+TEST_F("filter first threshold is extracted from rank profile and query", AttributeBlueprintParamsFixture(0.2, 0.8, 5.0, FMA::DfaTable))
+{
+    EXPECT_EQUAL(0.0, f.extract().filter_first_threshold);
+    f.rank_setup.set_filter_first_threshold(0.05);
+    EXPECT_EQUAL(0.05, f.extract().filter_first_threshold);
+    f.rank_properties.add(FilterFirstThreshold::NAME, "0.1");
+    EXPECT_EQUAL(0.1, f.extract().filter_first_threshold);
+}
+
 TEST_F("global filter params are scaled with active hit ratio", AttributeBlueprintParamsFixture(0.2, 0.8, 5.0, FMA::DfaTable))
 {
     auto params = f.extract(5, 10);
@@ -1193,4 +1348,108 @@ TEST_F("global filter params are scaled with active hit ratio", AttributeBluepri
     EXPECT_EQUAL(0.48, params.global_filter_upper_limit);
 }
 
+TEST("require that result cache key is independent of property order") {
+    SearchRequest::SP a = MyWorld::createSimpleRequest("f1", "spread");
+    SearchRequest::SP b = MyWorld::createSimpleRequest("f1", "spread");
+    a->propertiesMap.lookupCreate(MapNames::RANK).add("foo", "1");
+    a->propertiesMap.lookupCreate(MapNames::FEATURE).add("bar", "2");
+    b->propertiesMap.lookupCreate(MapNames::FEATURE).add("bar", "2");
+    b->propertiesMap.lookupCreate(MapNames::RANK).add("foo", "1");
+    EXPECT_EQUAL(ResultCache::make_key(*a), ResultCache::make_key(*b));
+    b->offset = 10;
+    EXPECT_NOT_EQUAL(ResultCache::make_key(*a), ResultCache::make_key(*b));
+    b->offset = a->offset;
+    b->propertiesMap.lookupCreate(MapNames::RANK).add("foo", "2");
+    EXPECT_NOT_EQUAL(ResultCache::make_key(*a), ResultCache::make_key(*b));
+    EXPECT_TRUE(ResultCache::is_cacheable(*a));
+    a->sessionId.push_back('x');
+    EXPECT_FALSE(ResultCache::is_cacheable(*a));
+}
+
+TEST("require that cached results are only used while documents are unchanged") {
+    MyWorld world;
+    world.basicSetup();
+    world.basicResults();
+    SearchRequest::SP request = MyWorld::createSimpleRequest("f1", "spread");
+    SearchReply::UP reply = world.performSearch(*request, 1);
+    ASSERT_TRUE(ResultCache::is_complete(*reply, reply->coverage.getActive()));
+    ResultCache cache(10, 60s);
+    vespalib::string key = ResultCache::make_key(*request);
+    vespalib::steady_time now = vespalib::steady_clock::now();
+    cache.insert(key, 5, 9, now, *reply, 10ms);
+    auto cached = cache.lookup(key, 5, 9, now);
+    ASSERT_TRUE(cached.reply);
+    EXPECT_EQUAL(reply->totalHitCount, cached.reply->totalHitCount);
+    ASSERT_EQUAL(reply->hits.size(), cached.reply->hits.size());
+    EXPECT_EQUAL(reply->hits[0].gid, cached.reply->hits[0].gid);
+    EXPECT_EQUAL(vespalib::count_ms(10ms), vespalib::count_ms(cached.match_time));
+    EXPECT_FALSE(cache.lookup(key, 5, 9, now + 61s).reply);
+    cache.insert(key, 5, 9, now, *reply, 10ms);
+    EXPECT_FALSE(cache.lookup(key, 5, 8, now).reply);
+    cache.insert(key, 5, 9, now, *reply, 10ms);
+    EXPECT_FALSE(cache.lookup(key, 6, 9, now).reply);
+    EXPECT_EQUAL(0u, cache.size());
+}
+
+TEST("require that stash pool reuses cleared stashes up to a limit") {
+    StashPool pool(4_Ki, 1);
+    auto s1 = pool.obtain();
+    auto s2 = pool.obtain();
+    EXPECT_EQUAL(4_Ki, s1.get_chunk_size());
+    s1.create<int>(5);
+    pool.release(std::move(s1));
+    pool.release(std::move(s2));
+    EXPECT_EQUAL(1u, pool.size());
+    auto s3 = pool.obtain();
+    EXPECT_EQUAL(0u, pool.size());
+    // memory is kept, objects are gone
+    EXPECT_EQUAL(sizeof(vespalib::stash::Chunk), s3.count_used());
+}
+
+TEST("require that query memory estimate scales with match threads") {
+    QueryMemoryEstimate memory;
+    memory.docid_limit = 80000;
+    memory.heap_size = 100;
+    memory.array_size = 1000;
+    memory.query_size = 10;
+    memory.est_hits = 500;
+    size_t single = memory.bytes();
+    size_t single_hit_collector = memory.hit_collector_bytes();
+    EXPECT_EQUAL(10u * QueryMemoryEstimate::bytes_per_query_byte * 2, memory.query_bytes());
+    EXPECT_EQUAL(0u, memory.grouping_bytes());
+    memory.num_threads = 4;
+    EXPECT_EQUAL(4 * single_hit_collector, memory.hit_collector_bytes());
+    EXPECT_GREATER(memory.bytes(), single);
+    size_t no_bitvector = memory.hit_collector_bytes();
+    memory.est_hits = 5000;
+    EXPECT_EQUAL(no_bitvector + 4 * 10000u, memory.hit_collector_bytes());
+    memory.has_grouping = true;
+    memory.max_groups_per_thread = 100;
+    EXPECT_EQUAL(100u * QueryMemoryEstimate::bytes_per_group * 4, memory.grouping_bytes());
+}
+
+TEST("require that query limiter rejects queries exceeding the memory budget") {
+    QueryLimiter limiter;
+    auto unlimited = limiter.reserve_memory(1_Mi);
+    EXPECT_TRUE(unlimited);
+    unlimited.reset();
+    limiter.configure_memory(100);
+    {
+        // a single query is always admitted
+        auto big = limiter.reserve_memory(1000);
+        EXPECT_TRUE(big);
+        EXPECT_FALSE(limiter.reserve_memory(1));
+    }
+    EXPECT_EQUAL(0u, limiter.reserved_memory());
+    auto t1 = limiter.reserve_memory(60);
+    auto t2 = limiter.reserve_memory(40);
+    EXPECT_TRUE(t1);
+    EXPECT_TRUE(t2);
+    EXPECT_EQUAL(100u, limiter.reserved_memory());
+    EXPECT_FALSE(limiter.reserve_memory(1));
+    t1.reset();
+    EXPECT_TRUE(limiter.reserve_memory(60));
+    EXPECT_EQUAL(40u, limiter.reserved_memory());
+}
+
 TEST_MAIN() { TEST_RUN_ALL(); }
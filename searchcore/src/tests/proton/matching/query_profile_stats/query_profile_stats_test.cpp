@@ -0,0 +1,87 @@
+// Copyright Vespa.ai. Licensed under the terms of the Apache 2.0 license. See LICENSE in the project root.
+
+#include <vespa/searchcore/proton/matching/query_profile_stats.h>
+#include <vespa/vespalib/data/slime/slime.h>
+#include <vespa/vespalib/gtest/gtest.h>
+#include <vespa/vespalib/util/execution_profiler.h>
+
+using proton::matching::QueryProfileStats;
+using vespalib::ExecutionProfiler;
+using vespalib::Slime;
+
+using Sample = QueryProfileStats::Sample;
+
+void run_task(ExecutionProfiler &profiler, const vespalib::string &name) {
+    profiler.start(profiler.resolve(name));
+    profiler.complete();
+}
+
+TEST(QueryProfileStatsTest, iterator_tasks_are_tracked_by_type_and_operation) {
+    ExecutionProfiler profiler(-1);
+    run_task(profiler, "/AndSearchStrict/seek");
+    run_task(profiler, "/0/TermSearch/seek");
+    run_task(profiler, "/1/TermSearch/seek");
+    run_task(profiler, "/1/TermSearch/unpack");
+    Sample sample;
+    sample.add_match_profile(profiler);
+    const auto &entries = sample.entries();
+    ASSERT_EQ(3u, entries.size());
+    EXPECT_EQ(1u, entries.find("match/AndSearchStrict/seek")->second.count);
+    EXPECT_EQ(2u, entries.find("match/TermSearch/seek")->second.count);
+    EXPECT_EQ(1u, entries.find("match/TermSearch/unpack")->second.count);
+}
+
+TEST(QueryProfileStatsTest, feature_tasks_are_tracked_per_phase) {
+    ExecutionProfiler profiler(-1);
+    run_task(profiler, "rankingExpression(foo)");
+    run_task(profiler, "attribute(bar)");
+    Sample sample;
+    sample.add_rank_profile("first_phase", profiler);
+    const auto &entries = sample.entries();
+    ASSERT_EQ(2u, entries.size());
+    EXPECT_TRUE(entries.find("first_phase/function foo") != entries.end());
+    EXPECT_TRUE(entries.find("first_phase/rank feature attribute(bar)") != entries.end());
+}
+
+TEST(QueryProfileStatsTest, samples_are_aggregated_into_histograms) {
+    QueryProfileStats stats;
+    Sample fast;
+    fast.add("match/TermSearch/seek", 10, 50us);
+    Sample slow;
+    slow.add("match/TermSearch/seek", 1000, 50ms);
+    slow.add("match/AndSearch/seek", 5, 5ms);
+    stats.add(fast);
+    stats.add(fast);
+    stats.add(slow);
+    EXPECT_EQ(3u, stats.sampled_queries());
+    auto tasks = stats.tasks();
+    ASSERT_EQ(2u, tasks.size());
+    const auto &term = tasks["match/TermSearch/seek"];
+    EXPECT_EQ(3u, term.queries);
+    EXPECT_EQ(1020u, term.count);
+    EXPECT_DOUBLE_EQ(50.1, term.total_time_ms);
+    EXPECT_DOUBLE_EQ(50.0, term.max_time_ms);
+    EXPECT_EQ(2u, term.histogram[1]);
+    EXPECT_EQ(1u, term.histogram[4]);
+    const auto &and_task = tasks["match/AndSearch/seek"];
+    EXPECT_EQ(1u, and_task.queries);
+    EXPECT_EQ(1u, and_task.histogram[3]);
+}
+
+TEST(QueryProfileStatsTest, tasks_are_reported_by_total_time) {
+    QueryProfileStats stats;
+    Sample sample;
+    sample.add("match/AndSearch/seek", 5, 5ms);
+    sample.add("match/TermSearch/seek", 1000, 50ms);
+    stats.add(sample);
+    Slime slime;
+    stats.report(slime.setObject());
+    EXPECT_EQ(1, slime["sampled_queries"].asLong());
+    EXPECT_EQ(QueryProfileStats::bucket_limits_ms.size(), slime["bucket_limits_ms"].entries());
+    ASSERT_EQ(2u, slime["tasks"].entries());
+    EXPECT_EQ("match/TermSearch/seek", slime["tasks"][0]["name"].asString().make_string());
+    EXPECT_EQ("match/AndSearch/seek", slime["tasks"][1]["name"].asString().make_string());
+    EXPECT_EQ(QueryProfileStats::num_buckets, slime["tasks"][0]["histogram"].entries());
+}
+
+GTEST_MAIN_RUN_ALL_TESTS()
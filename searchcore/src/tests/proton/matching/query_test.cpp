@@ -2,6 +2,7 @@
 // Unit tests for query.
 
 #include <vespa/searchcore/proton/matching/fakesearchcontext.h>
+#include <vespa/searchcore/proton/matching/global_filter_cache.h>
 #include <vespa/searchcore/proton/matching/matchdatareservevisitor.h>
 #include <vespa/searchcore/proton/matching/blueprintbuilder.h>
 #include <vespa/searchcore/proton/matching/query.h>
@@ -10,6 +11,7 @@
 #include <vespa/searchcore/proton/matching/termdataextractor.h>
 #include <vespa/searchcore/proton/matching/viewresolver.h>
 #include <vespa/searchcore/proton/matching/sameelementmodifier.h>
+#include <vespa/searchcore/proton/matching/term_stats_cache.h>
 #include <vespa/searchlib/features/utils.h>
 #include <vespa/searchlib/fef/itermfielddata.h>
 #include <vespa/searchlib/fef/matchdata.h>
@@ -29,6 +31,7 @@
 #include <vespa/searchlib/parsequery/stackdumpiterator.h>
 #include <vespa/document/datatype/positiondatatype.h>
 #include <vespa/vespalib/stllike/asciistream.h>
+#include <vespa/vespalib/util/size_literals.h>
 #include <vespa/vespalib/util/thread_bundle.h>
 #include <vespa/vespalib/testkit/testapp.h>
 #include <vespa/searchlib/query/tree/querytreecreator.h>
@@ -820,6 +823,48 @@ TEST("requireThatNoDocsGiveZeroDocFrequency") {
     EXPECT_EQUAL(0.0, node.field(0).getDocFreq());
 }
 
+TEST("requireThatCachedGlobalTermStatsOverrideLocalDocFrequency") {
+    auto term_stats = std::make_shared<TermStatsCache>();
+    term_stats->set(field, string_term, TermStatsCache::Stats(25, 1000));
+    term_stats->set(resolved_field1, string_term, TermStatsCache::Stats(500, 1000));
+    EXPECT_EQUAL(2u, term_stats->size());
+    EXPECT_FALSE(term_stats->lookup(field, prefix_term).has_value());
+
+    FakeSearchContext context;
+    FakeRequestContext requestContext;
+    context.setLimit(doc_count + 1);
+    context.setTermStats(term_stats);
+
+    auto build_term = [&](const vespalib::string &term, const ViewResolver &resolver,
+                          const search::fef::IIndexEnvironment &idx_env) {
+        auto node = std::make_unique<ProtonStringTerm>(term, field, string_id, string_weight);
+        node->resolve(resolver, idx_env);
+        MatchDataLayout mdl;
+        MatchDataReserveVisitor reserve_visitor(mdl);
+        node->accept(reserve_visitor);
+        Blueprint::UP blueprint = BlueprintBuilder::build(requestContext, *node, context);
+        return node;
+    };
+
+    auto cached = build_term(string_term, ViewResolver(), plain_index_env);
+    EXPECT_EQUAL(25u, cached->field(0).get_matching_doc_count());
+    EXPECT_EQUAL(1000u, cached->field(0).get_total_doc_count());
+    EXPECT_APPROX(0.025, cached->field(0).getDocFreq(), 1.0e-6);
+
+    auto not_cached = build_term(prefix_term, ViewResolver(), plain_index_env);
+    EXPECT_EQUAL(0u, not_cached->field(0).get_matching_doc_count());
+    EXPECT_EQUAL(uint32_t(doc_count), not_cached->field(0).get_total_doc_count());
+
+    // statistics must be present for all fields searched
+    auto partly_cached = build_term(string_term, getViewResolver(), resolved_index_env);
+    ASSERT_EQUAL(2u, partly_cached->numFields());
+    EXPECT_EQUAL(0u, partly_cached->field(0).get_matching_doc_count());
+    term_stats->update({{resolved_field2, string_term, TermStatsCache::Stats(200, 2000)}});
+    auto fully_cached = build_term(string_term, getViewResolver(), resolved_index_env);
+    EXPECT_EQUAL(500u, fully_cached->field(0).get_matching_doc_count());
+    EXPECT_EQUAL(2000u, fully_cached->field(1).get_total_doc_count());
+}
+
 TEST("requireThatWeakAndBlueprintsAreCreatedCorrectly") {
     using search::queryeval::WeakAndBlueprint;
 
@@ -1115,6 +1160,72 @@ TEST("global_filter_is_calculated_and_handled")
     }
 }
 
+TEST("global_filter_is_cached_until_document_meta_store_changes")
+{
+    using namespace std::literals::chrono_literals;
+    auto result = SimpleResult().addHit(3).addHit(5).addHit(7);
+    auto other_result = SimpleResult().addHit(2).addHit(4).addHit(6);
+    uint32_t docid_limit = 10;
+    GlobalFilterCache cache(1_Mi, 0s, 60s);
+    GlobalFilterCache::Key key(GlobalFilterCache::make_key("query", ""), 1, 9, docid_limit);
+    std::shared_ptr<const GlobalFilter> cached;
+    { // filter is calculated and added to cache
+        GlobalFilterBlueprint bp(result, true);
+        EXPECT_TRUE(Query::handle_global_filter(bp, docid_limit, 0, 0.3, ttb(), nullptr, &cache, &key));
+        EXPECT_TRUE(bp.filter->check(3));
+        EXPECT_EQUAL(1u, cache.size());
+        cached = bp.filter;
+    }
+    { // cached filter is used for the same key
+        GlobalFilterBlueprint bp(other_result, true);
+        EXPECT_TRUE(Query::handle_global_filter(bp, docid_limit, 0, 0.3, ttb(), nullptr, &cache, &key));
+        EXPECT_EQUAL(cached.get(), bp.filter.get());
+        EXPECT_TRUE(bp.filter->check(3));
+        EXPECT_FALSE(bp.filter->check(2));
+    }
+    { // filter is recalculated when the document meta store generation changes
+        GlobalFilterCache::Key changed(key.query, 2, 9, docid_limit);
+        GlobalFilterBlueprint bp(other_result, true);
+        EXPECT_TRUE(Query::handle_global_filter(bp, docid_limit, 0, 0.3, ttb(), nullptr, &cache, &changed));
+        EXPECT_NOT_EQUAL(cached.get(), bp.filter.get());
+        EXPECT_TRUE(bp.filter->check(2));
+        EXPECT_FALSE(bp.filter->check(3));
+    }
+}
+
+TEST("global_filter_cache_entries_are_invalidated")
+{
+    using namespace std::literals::chrono_literals;
+    auto filter = GlobalFilter::create(std::vector<uint32_t>{3, 5, 7}, 10);
+    auto now = vespalib::steady_clock::now();
+    GlobalFilterCache::Key key(GlobalFilterCache::make_key("query", ""), 1, 9, 10);
+    {
+        GlobalFilterCache cache(1_Mi, 10ms, 60s);
+        EXPECT_FALSE(cache.insert(key, now, filter, 5ms));
+        EXPECT_EQUAL(0u, cache.size());
+        EXPECT_TRUE(cache.insert(key, now, filter, 10ms));
+        EXPECT_EQUAL(filter.get(), cache.lookup(key, now).get());
+        EXPECT_LESS_EQUAL(GlobalFilterCache::memory_used(*filter), cache.memory_used());
+    }
+    for (const auto& changed : {GlobalFilterCache::Key(key.query, 2, 9, 10),
+                                GlobalFilterCache::Key(key.query, 1, 8, 10),
+                                GlobalFilterCache::Key(key.query, 1, 9, 11)})
+    {
+        GlobalFilterCache cache(1_Mi, 0s, 60s);
+        EXPECT_TRUE(cache.insert(key, now, filter, 0s));
+        EXPECT_FALSE(cache.lookup(changed, now));
+        EXPECT_FALSE(cache.lookup(key, now));
+    }
+    {
+        GlobalFilterCache cache(1_Mi, 0s, 60s);
+        EXPECT_TRUE(cache.insert(key, now, filter, 0s));
+        EXPECT_TRUE(cache.lookup(key, now + 60s));
+        EXPECT_FALSE(cache.lookup(key, now + 61s));
+        EXPECT_EQUAL(0u, cache.size());
+    }
+    EXPECT_NOT_EQUAL(GlobalFilterCache::make_key("query", ""), GlobalFilterCache::make_key("query", "(2,10,10,0,0,1,0)"));
+}
+
 }  // namespace
 }  // namespace proton::matching
 
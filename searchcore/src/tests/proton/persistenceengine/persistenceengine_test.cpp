@@ -9,6 +9,7 @@
 #include <vespa/document/fieldvalue/stringfieldvalue.h>
 #include <vespa/document/update/documentupdate.h>
 #include <vespa/document/update/assignvalueupdate.h>
+#include <vespa/persistence/spi/catchresult.h>
 #include <vespa/persistence/spi/documentselection.h>
 #include <vespa/persistence/spi/test.h>
 #include <vespa/searchcore/proton/persistenceengine/ipersistenceengineowner.h>
@@ -161,6 +162,7 @@ struct MyHandler : public IPersistenceHandler, IBucketFreezer {
     const Document              *document;
     std::multiset<uint64_t>      frozen;
     std::multiset<uint64_t>      was_frozen;
+    std::vector<size_t>          feed_batch_sizes;
     DocTypeName                  _doc_type_name;
 
     MyHandler(const DocTypeName &type_name)
@@ -182,6 +184,7 @@ struct MyHandler : public IPersistenceHandler, IBucketFreezer {
           document(nullptr),
           frozen(),
           was_frozen(),
+          feed_batch_sizes(),
           _doc_type_name(type_name)
     {
     }
@@ -229,6 +232,23 @@ struct MyHandler : public IPersistenceHandler, IBucketFreezer {
         handle(token, bucket, timestamp, DocumentId());
     }
 
+    void handleFeedBatch(const Bucket& bucket, std::vector<FeedBatchEntry> entries) override {
+        feed_batch_sizes.push_back(entries.size());
+        for (auto& entry : entries) {
+            switch (entry.op.type) {
+            case storage::spi::BatchedOperation::Type::PUT:
+                handlePut(std::move(entry.token), bucket, entry.op.timestamp, std::move(entry.op.document));
+                break;
+            case storage::spi::BatchedOperation::Type::UPDATE:
+                handleUpdate(std::move(entry.token), bucket, entry.op.timestamp, std::move(entry.op.update));
+                break;
+            case storage::spi::BatchedOperation::Type::REMOVE_IF_FOUND:
+                handleRemove(std::move(entry.token), bucket, entry.op.timestamp, entry.op.id);
+                break;
+            }
+        }
+    }
+
     void handleListBuckets(IBucketIdListResultHandler &resultHandler) override {
         resultHandler.handle(BucketIdListResult(BucketId::List(bucketList.begin(), bucketList.end())));
     }
@@ -577,6 +597,35 @@ TEST_F("require that remove is NOT rejected if resource limit is reached", Simpl
 }
 
 
+TEST_F("require that feed batches are split per handler and completed per operation", SimpleFixture)
+{
+    using storage::spi::BatchedOperation;
+    using storage::spi::CatchResult;
+    f.hset.handler2.setExistingTimestamp(tstamp2);
+    std::vector<std::unique_ptr<CatchResult>> catchers;
+    std::vector<std::future<std::unique_ptr<Result>>> results;
+    for (size_t i = 0; i < 4; ++i) {
+        catchers.push_back(std::make_unique<CatchResult>());
+        results.push_back(catchers.back()->future_result());
+    }
+    std::vector<BatchedOperation> ops;
+    ops.push_back(BatchedOperation::make_put(tstamp1, doc1, std::move(catchers[0])));
+    ops.push_back(BatchedOperation::make_update(tstamp2, upd2, std::move(catchers[1])));
+    ops.push_back(BatchedOperation::make_remove_if_found(tstamp3, docId3, std::move(catchers[2])));
+    ops.push_back(BatchedOperation::make_remove_if_found(tstamp3, docId1, std::move(catchers[3])));
+    f.engine.feedBatchAsync(bucket1, std::move(ops));
+
+    EXPECT_EQUAL(Result(), *results[0].get());
+    auto update_result = results[1].get();
+    EXPECT_EQUAL(tstamp2, dynamic_cast<const UpdateResult &>(*update_result).getExistingTimestamp());
+    EXPECT_EQUAL(Result(Result::ErrorType::PERMANENT_ERROR, "No handler for document type 'type3'"), *results[2].get());
+    EXPECT_FALSE(dynamic_cast<const RemoveResult &>(*results[3].get()).wasFound());
+    EXPECT_EQUAL(std::vector<size_t>({2}), f.hset.handler1.feed_batch_sizes);
+    EXPECT_EQUAL(std::vector<size_t>({1}), f.hset.handler2.feed_batch_sizes);
+    TEST_DO(assertHandler(bucket1, tstamp3, docId1, f.hset.handler1));
+    TEST_DO(assertHandler(bucket1, tstamp2, docId2, f.hset.handler2));
+}
+
 TEST_F("require that listBuckets() is routed to handlers and merged", SimpleFixture)
 {
     f.hset.prepareListBuckets();
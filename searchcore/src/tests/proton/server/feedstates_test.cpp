@@ -16,6 +16,7 @@
 #include <vespa/searchlib/common/serialnum.h>
 #include <vespa/vespalib/objects/nbostream.h>
 #include <vespa/vespalib/util/foreground_thread_executor.h>
+#include <vespa/vespalib/util/threadstackexecutor.h>
 #include <vespa/vespalib/testkit/testapp.h>
 #include <vespa/vespalib/util/buffer.h>
 
@@ -27,6 +28,7 @@ using document::DocumentId;
 using document::DocumentTypeRepo;
 using document::TestDocRepo;
 using search::transactionlog::Packet;
+using search::transactionlog::client::RPC;
 using search::SerialNum;
 using storage::spi::Timestamp;
 using vespalib::ConstBufferRef;
@@ -66,6 +68,7 @@ struct MyIncSerialNum : IIncSerialNum {
 
 struct Fixture
 {
+    vespalib::ThreadStackExecutor decode_executor;
     MyFeedView feed_view1;
     MyFeedView feed_view2;
     IFeedView *feed_view_ptr;
@@ -77,12 +80,13 @@ struct Fixture
     MyIncSerialNum _inc_serial_num;
     ReplayTransactionLogState state;
 
-    Fixture();
+    Fixture(bool parallel_decode = false);
     ~Fixture();
 };
 
-Fixture::Fixture()
-    : feed_view1(),
+Fixture::Fixture(bool parallel_decode)
+    : decode_executor(2),
+      feed_view1(),
       feed_view2(),
       feed_view_ptr(&feed_view1),
       replay_config(),
@@ -91,11 +95,16 @@ Fixture::Fixture()
       _bucketDBHandler(_bucketDB),
       _replay_throttling_policy({}),
       _inc_serial_num(9u),
-      state("doctypename", feed_view_ptr, _bucketDBHandler, replay_config, config_store, _replay_throttling_policy, _inc_serial_num)
+      state("doctypename", feed_view_ptr, _bucketDBHandler, replay_config, config_store, _replay_throttling_policy, _inc_serial_num,
+            parallel_decode ? &decode_executor : nullptr)
 {
 }
 Fixture::~Fixture() = default;
 
+struct ParallelDecodeFixture : Fixture {
+    ParallelDecodeFixture() : Fixture(true) {}
+};
+
 
 struct RemoveOperationContext
 {
@@ -141,6 +150,39 @@ TEST_F("require that active FeedView can change during replay", Fixture)
     EXPECT_EQUAL(1, f.feed_view2.remove_handled);
 }
 
+TEST_F("require that active FeedView can change during replay with parallel decoding", ParallelDecodeFixture)
+{
+    ForegroundThreadExecutor executor;
+    {
+        RemoveOperationContext opCtx(10);
+        auto wrap = std::make_shared<PacketWrapper>(*opCtx.packet, nullptr);
+        f.state.receive(wrap, executor);
+        EXPECT_EQUAL(RPC::OK, wrap->result);
+    }
+    EXPECT_EQUAL(1, f.feed_view1.remove_handled);
+    EXPECT_EQUAL(0, f.feed_view2.remove_handled);
+    // decoded with the document type repo of feed_view1, decoded again when replayed
+    f.feed_view_ptr = &f.feed_view2;
+    {
+        RemoveOperationContext opCtx(11);
+        auto wrap = std::make_shared<PacketWrapper>(*opCtx.packet, nullptr);
+        f.state.receive(wrap, executor);
+    }
+    EXPECT_EQUAL(1, f.feed_view1.remove_handled);
+    EXPECT_EQUAL(1, f.feed_view2.remove_handled);
+}
+
+TEST_F("require that replay progress is tracked with parallel decoding", ParallelDecodeFixture)
+{
+    RemoveOperationContext opCtx(10);
+    TlsReplayProgress progress("test", 5, 15);
+    auto wrap = std::make_shared<PacketWrapper>(*opCtx.packet, &progress);
+    ForegroundThreadExecutor executor;
+
+    f.state.receive(wrap, executor);
+    EXPECT_EQUAL(10u, progress.getCurrent());
+}
+
 TEST_F("require that replay progress is tracked", Fixture)
 {
     RemoveOperationContext opCtx(10);
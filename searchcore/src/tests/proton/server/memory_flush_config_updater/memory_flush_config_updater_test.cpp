@@ -237,4 +237,43 @@ TEST_F("require that more disk bloat is allowed while node state is retired or m
     TEST_DO(f.assertStrategyDiskConfig(DEFAULT_DISK_BLOAT, DEFAULT_DISK_BLOAT));
 }
 
+struct AdaptiveFixture
+{
+    std::shared_ptr<AdaptiveFlushStrategy> strategy;
+    MemoryFlushConfigUpdater updater;
+    AdaptiveFixture()
+        : strategy(std::make_shared<AdaptiveFlushStrategy>(make_adaptive_config())),
+          updater(strategy, getDefaultConfig(), defaultMemory)
+    {}
+    static AdaptiveFlushStrategy::Config make_adaptive_config() {
+        ProtonConfig::Flush flush;
+        flush.memory = getDefaultConfig();
+        flush.adaptive.maxwriteamplification = 2.0;
+        return MemoryFlushConfigUpdater::convertAdaptiveConfig(flush, defaultMemory);
+    }
+    void assertStrategyConfig(uint64_t expMaxGlobalMemory, uint64_t expMaxGlobalTlsSize) {
+        EXPECT_EQUAL(expMaxGlobalMemory, strategy->getConfig().maxGlobalMemory);
+        EXPECT_EQUAL(expMaxGlobalTlsSize, strategy->getConfig().maxGlobalTlsSize);
+    }
+};
+
+TEST_F("require that adaptive strategy gets limits from memory flush config", AdaptiveFixture)
+{
+    TEST_DO(f.assertStrategyConfig(4, 20));
+    EXPECT_EQUAL(2.0, f.strategy->getConfig().maxWriteAmplification);
+    f.updater.setConfig(getConfig(6, 3, 30));
+    TEST_DO(f.assertStrategyConfig(6, 30));
+    EXPECT_EQUAL(2.0, f.strategy->getConfig().maxWriteAmplification);
+}
+
+TEST_F("require that adaptive strategy uses conservative limits when above resource limits", AdaptiveFixture)
+{
+    f.updater.notifyDiskMemUsage(DiskMemUsageState(aboveLimit(), aboveLimit()));
+    TEST_DO(f.assertStrategyConfig(2, 12));
+    f.updater.notifyDiskMemUsage(DiskMemUsageState(belowLimit(), belowLimit()));
+    TEST_DO(f.assertStrategyConfig(2, 12));
+    f.updater.notifyDiskMemUsage(DiskMemUsageState(ResourceUsageState(0.7, 0.5), ResourceUsageState(0.7, 0.5)));
+    TEST_DO(f.assertStrategyConfig(4, 20));
+}
+
 TEST_MAIN() { TEST_RUN_ALL(); }
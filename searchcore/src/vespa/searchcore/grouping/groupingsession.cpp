@@ -20,7 +20,9 @@ GroupingSession::GroupingSession(const SessionId &sessionId,
     : _sessionId(sessionId),
       _mgrContext(std::make_unique<GroupingContext>(groupingContext)),
       _groupingManager(std::make_unique<GroupingManager>(*_mgrContext)),
-      _timeOfDoom(groupingContext.getTimeOfDoom())
+      _timeOfDoom(groupingContext.getTimeOfDoom()),
+      _maxGroupsPerThread(0),
+      _sampleRate(1.0)
 {
     init(groupingContext, attrCtx);
 }
@@ -72,6 +74,14 @@ GroupingSession::createThreadContext(size_t thread_id, const IAttributeContext &
         GroupingManager man(*ctx);
         man.init(attrCtx);
     }
+    for (const auto & grouping : ctx->getGroupingList()) {
+        if (_maxGroupsPerThread > 0) {
+            grouping->setGroupLimit(_maxGroupsPerThread);
+        }
+        if (_sampleRate < 1.0 && grouping->getTopN() < 0) {
+            grouping->setSampleRate(_sampleRate);
+        }
+    }
     return ctx;
 }
 
@@ -31,6 +31,8 @@ private:
     std::unique_ptr<GroupingManager> _groupingManager;
     GroupingMap                      _groupingMap;
     vespalib::steady_time            _timeOfDoom;
+    uint32_t                         _maxGroupsPerThread;
+    double                           _sampleRate;
 
 public:
     using UP = std::unique_ptr<GroupingSession>;
@@ -73,6 +75,24 @@ public:
      **/
     void prepareThreadContextCreation(size_t num_threads);
 
+    /**
+     * Limit the number of groups each thread context may create per
+     * grouping level, bounding the memory used by the partial
+     * grouping tree of each thread. 0 means no limit.
+     *
+     * @param maxGroupsPerThread group limit per level and thread
+     **/
+    void setMaxGroupsPerThread(uint32_t maxGroupsPerThread) { _maxGroupsPerThread = maxGroupsPerThread; }
+
+    /**
+     * Approximate grouping by only aggregating a sample of the hits
+     * in each thread context. Groupings limited to the top N hits are
+     * not sampled. 1.0 means exact grouping.
+     *
+     * @param sampleRate fraction of hits to aggregate
+     **/
+    void setSampleRate(double sampleRate) { _sampleRate = sampleRate; }
+
     /**
      * Create a grouping context to be used by a single thread when
      * performing multi-threaded grouping. Thread 0 will get a
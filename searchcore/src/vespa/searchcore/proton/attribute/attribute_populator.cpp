@@ -7,6 +7,7 @@
 #include <vespa/vespalib/util/destructor_callbacks.h>
 #include <vespa/vespalib/util/gate.h>
 #include <vespa/searchlib/attribute/attributevector.h>
+#include <algorithm>
 #include <cassert>
 
 #include <vespa/log/log.h>
@@ -54,12 +55,15 @@ AttributePopulator::getNames() const
 AttributePopulator::AttributePopulator(const proton::IAttributeManager::SP &mgr,
                                        search::SerialNum initSerialNum,
                                        const vespalib::string &subDbName,
-                                       search::SerialNum configSerialNum)
+                                       search::SerialNum configSerialNum,
+                                       uint32_t commitBatchDocs)
     : _writer(mgr),
       _initSerialNum(initSerialNum),
       _currSerialNum(initSerialNum),
       _configSerialNum(configSerialNum),
-      _subDbName(subDbName)
+      _subDbName(subDbName),
+      _commitBatchDocs(std::max(commitBatchDocs, 1u)),
+      _uncommittedDocs(0)
 {
     if (LOG_WOULD_LOG(event)) {
         EventLogger::populateAttributeStart(getNames());
@@ -74,18 +78,30 @@ AttributePopulator::~AttributePopulator()
 }
 
 void
-AttributePopulator::handleExisting(uint32_t lid, const std::shared_ptr<document::Document> &doc)
+AttributePopulator::commit(search::SerialNum serialNum)
 {
-    search::SerialNum serialNum(nextSerialNum());
-    _writer.put(serialNum, *doc, lid, std::make_shared<PopulateDoneContext>(doc));
     vespalib::Gate gate;
     _writer.forceCommit(serialNum, std::make_shared<vespalib::GateCallback>(gate));
     gate.await();
+    _uncommittedDocs = 0;
+}
+
+void
+AttributePopulator::handleExisting(uint32_t lid, const std::shared_ptr<document::Document> &doc)
+{
+    search::SerialNum serialNum(nextSerialNum());
+    _writer.put(serialNum, *doc, lid, std::make_shared<PopulateDoneContext>(doc));
+    if (++_uncommittedDocs >= _commitBatchDocs) {
+        commit(serialNum);
+    }
 }
 
 void
 AttributePopulator::done()
 {
+    if (_uncommittedDocs > 0) {
+        commit(_currSerialNum - 1);
+    }
     auto mgr = _writer.getAttributeManager();
     auto flushTargets = mgr->getFlushTargets();
     for (const auto &flushTarget : flushTargets) {
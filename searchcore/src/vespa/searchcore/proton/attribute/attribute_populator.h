@@ -9,6 +9,10 @@ namespace proton {
 
 /**
  * Class used to populate attribute vectors based on visiting the content of a document store.
+ *
+ * Documents are committed in batches of commitBatchDocs. Larger batches let the attribute
+ * writer prepare expensive updates (e.g. nearest neighbor index inserts) for several documents
+ * in parallel before they are completed in order by the commit.
  */
 class AttributePopulator : public IReprocessingReader
 {
@@ -18,8 +22,11 @@ private:
     search::SerialNum _currSerialNum;
     search::SerialNum _configSerialNum;
     vespalib::string  _subDbName;
+    uint32_t          _commitBatchDocs;
+    uint32_t          _uncommittedDocs;
 
     search::SerialNum nextSerialNum();
+    void commit(search::SerialNum serialNum);
 
     std::vector<vespalib::string> getNames() const;
 
@@ -29,7 +36,8 @@ public:
     AttributePopulator(const proton::IAttributeManager::SP &mgr,
                        search::SerialNum initSerialNum,
                        const vespalib::string &subDbName,
-                       search::SerialNum configSerialNum);
+                       search::SerialNum configSerialNum,
+                       uint32_t commitBatchDocs = 1);
     ~AttributePopulator() override;
 
     const IAttributeWriter &getWriter() const { return _writer; }
@@ -4,6 +4,7 @@
 #include "attribute_executor.h"
 #include <vespa/searchcommon/attribute/config.h>
 #include <vespa/searchlib/attribute/attributevector.h>
+#include <vespa/searchlib/attribute/bitvector_filter_cache.h>
 #include <vespa/searchlib/attribute/distance_metric_utils.h>
 #include <vespa/searchlib/attribute/i_enum_store.h>
 #include <vespa/searchlib/attribute/i_enum_store_dictionary.h>
@@ -18,6 +19,7 @@ using search::AttributeVector;
 using search::IEnumStore;
 using search::StateExplorerUtils;
 using search::attribute::BasicType;
+using search::attribute::BitVectorFilterCache;
 using search::attribute::CollectionType;
 using search::attribute::Config;
 using search::attribute::DistanceMetricUtils;
@@ -108,6 +110,20 @@ convertPostingBaseToSlime(const IPostingListAttributeBase &postingBase, Cursor &
     convertMemoryUsageToSlime(memory_usage.bitvectors, cursor.setObject("bitvectors"));
 }
 
+void
+convert_filter_cache_to_slime(const BitVectorFilterCache &cache, Cursor &object)
+{
+    auto stats = cache.get_stats();
+    object.setLong("max_bytes", cache.max_bytes());
+    object.setLong("hits", stats.hits);
+    object.setLong("misses", stats.misses);
+    object.setLong("inserts", stats.inserts);
+    object.setLong("invalidations", stats.invalidations);
+    object.setLong("elements", stats.elements);
+    object.setLong("compressed_elements", stats.compressed_elements);
+    object.setLong("memory_used", stats.memory_used);
+}
+
 vespalib::string
 type_to_string(const Config& cfg)
 {
@@ -180,6 +196,10 @@ AttributeVectorExplorer::get_state_helper(const AttributeVector& attr, const ves
         if (postingBase) {
             convertPostingBaseToSlime(*postingBase, object.setObject("posting_store"));
         }
+        const auto* filter_cache = attr.get_filter_cache();
+        if (filter_cache) {
+            convert_filter_cache_to_slime(*filter_cache, object.setObject("filter_cache"));
+        }
         const auto* tensor_attr = attr.asTensorAttribute();
         if (tensor_attr) {
             ObjectInserter tensor_inserter(object, "tensor");
@@ -15,10 +15,12 @@
 #include <vespa/searchlib/attribute/imported_attribute_vector.h>
 #include <vespa/searchlib/tensor/prepare_result.h>
 #include <vespa/vespalib/stllike/hash_map.hpp>
+#include <vespa/vespalib/util/count_down_latch.h>
 #include <vespa/vespalib/util/cpu_usage.h>
 #include <vespa/vespalib/util/destructor_callbacks.h>
 #include <vespa/vespalib/util/gate.h>
 #include <vespa/vespalib/util/idestructorcallback.h>
+#include <algorithm>
 #include <future>
 
 #include <vespa/log/log.h>
@@ -30,6 +32,7 @@ using namespace search;
 using ExecutorId = vespalib::ISequencedTaskExecutor::ExecutorId;
 using search::attribute::ImportedAttributeVector;
 using search::tensor::PrepareResult;
+using vespalib::CountDownLatch;
 using vespalib::CpuUsage;
 using vespalib::GateCallback;
 using vespalib::ISequencedTaskExecutor;
@@ -59,7 +62,8 @@ AttributeWriter::WriteField::WriteField(AttributeVector &attribute)
     : _fieldPath(),
       _attribute(attribute),
       _structFieldAttribute(false),
-      _use_two_phase_put(use_two_phase_put_for_attribute(attribute))
+      _use_two_phase_put(use_two_phase_put_for_attribute(attribute)),
+      _layout_slot(DocumentFieldLayout::npos)
 {
     const vespalib::string &name = attribute.getName();
     _structFieldAttribute = search::attribute::isStructFieldAttribute(name);
@@ -87,6 +91,8 @@ AttributeWriter::WriteContext::WriteContext(ExecutorId executorId) noexcept
       _fields(),
       _data_type(nullptr),
       _two_phase_put_field_path(),
+      _layout(),
+      _layout_values(),
       _hasStructFieldAttribute(false),
       _use_two_phase_put(false)
 {
@@ -121,19 +127,36 @@ AttributeWriter::WriteContext::consider_build_field_paths(const Document& doc) c
     if (_data_type != data_type) {
         _data_type = data_type;
         auto& doc_type = doc.getType();
+        std::vector<vespalib::string> layout_fields;
         for (auto &field : _fields) {
             field.buildFieldPath(doc_type);
+            if ((field.getFieldPath().size() == 1) && !field.isStructFieldAttribute()) {
+                layout_fields.push_back(field.getAttribute().getName());
+            }
         }
         if (_use_two_phase_put) {
             _two_phase_put_field_path = std::make_shared<const FieldPath>(_fields[0].getFieldPath());
+        } else {
+            _layout = std::make_unique<const DocumentFieldLayout>(doc_type, layout_fields);
+            _layout_values = _layout->make_values();
+            for (auto &field : _fields) {
+                field.set_layout_slot(_layout->slot(field.getAttribute().getName()));
+            }
         }
     }
 }
 
+bool
+AttributeWriter::WriteContext::decode_layout_fields(const Document& doc) const
+{
+    return _layout && (_layout->num_slots() > 0) && _layout->decode(doc, _layout_values);
+}
+
 AttributeWriter::AttributeWithInfo::AttributeWithInfo()
     : attribute(),
       executor_id(),
-      use_two_phase_put_for_assign_updates(false)
+      use_two_phase_put_for_assign_updates(false),
+      sharded(nullptr)
 {
 }
 
@@ -141,7 +164,8 @@ AttributeWriter::AttributeWithInfo::AttributeWithInfo(search::AttributeVector* a
                                                       ExecutorId executor_id_in)
     : attribute(attribute_in),
       executor_id(executor_id_in),
-      use_two_phase_put_for_assign_updates(use_two_phase_put_for_attribute(*attribute_in))
+      use_two_phase_put_for_assign_updates(use_two_phase_put_for_attribute(*attribute_in)),
+      sharded(nullptr)
 {
 }
 
@@ -157,11 +181,11 @@ ensureLidSpace(SerialNum serialNum, DocumentIdT lid, AttributeVector &attr)
 }
 
 void
-applyPutToAttribute(SerialNum serialNum, const FieldValue::UP &fieldValue, DocumentIdT lid,
+applyPutToAttribute(SerialNum serialNum, const FieldValue *fieldValue, DocumentIdT lid,
                     AttributeVector &attr, AttributeWriter::OnWriteDoneType)
 {
     ensureLidSpace(serialNum, lid, attr);
-    if (fieldValue.get()) {
+    if (fieldValue != nullptr) {
         AttributeUpdater::handleValue(attr, lid, *fieldValue);
     } else {
         attr.clearDoc(lid);
@@ -219,15 +243,6 @@ applyRemoveToAttribute(SerialNum serialNum, DocumentIdT lid,
     attr.clearDoc(lid);
 }
 
-void
-applyUpdateToAttribute(SerialNum serialNum, const FieldUpdate &fieldUpd,
-                       DocumentIdT lid, AttributeVector &attr)
-{
-    ensureLidSpace(serialNum, lid, attr);
-    AttributeUpdater::handleUpdate(attr, lid, fieldUpd);
-    attr.commitIfChangeVectorTooLarge();
-}
-
 void
 applyReplayDone(uint32_t docIdLimit, AttributeVector &attr)
 {
@@ -275,32 +290,125 @@ applyCompactLidSpace(uint32_t wantedLidLimit, SerialNum serialNum, AttributeVect
     }
 }
 
-using AttrUpdates = std::vector<std::pair<AttributeVector *, const FieldUpdate *>>;
+struct AttrUpdate {
+    AttributeVector   *attr;
+    const FieldUpdate *update;
+    SerialNum          serialNum;
+    DocumentIdT        lid;
+};
+
+using AttrUpdates = std::vector<AttrUpdate>;
 
+/*
+ * Applies field updates from one or more document updates. The updates are grouped
+ * by attribute vector (keeping the order of the updates to each attribute vector),
+ * and lid space and change vector size are handled once per attribute vector.
+ */
 struct BatchUpdateTask : public vespalib::Executor::Task {
 
-    BatchUpdateTask(SerialNum serialNum, DocumentIdT lid)
+    BatchUpdateTask()
         : vespalib::Executor::Task(),
-          _serialNum(serialNum),
-          _lid(lid),
-          _onWriteDone()
+          _updates(),
+          _onWriteDone(),
+          _lastSerialNum(0)
     { }
     ~BatchUpdateTask() override;
 
+    void add(SerialNum serialNum, DocumentIdT lid, AttributeVector &attr, const FieldUpdate &fieldUpd,
+             const AttributeWriter::OnWriteDoneType &onWriteDone)
+    {
+        _updates.push_back({&attr, &fieldUpd, serialNum, lid});
+        if (_onWriteDone.empty() || _lastSerialNum != serialNum) {
+            _onWriteDone.push_back(onWriteDone);
+            _lastSerialNum = serialNum;
+        }
+    }
+
     void run() override {
-        for (const auto & update : _updates) {
-            applyUpdateToAttribute(_serialNum, *update.second, _lid, *update.first);
+        std::stable_sort(_updates.begin(), _updates.end(),
+                         [](const AttrUpdate &lhs, const AttrUpdate &rhs) { return lhs.attr < rhs.attr; });
+        for (auto itr = _updates.begin(); itr != _updates.end(); ) {
+            AttributeVector &attr = *itr->attr;
+            auto end = std::find_if(itr, _updates.end(), [&attr](const AttrUpdate &update) { return update.attr != &attr; });
+            applyUpdatesToAttribute(itr, end, attr);
+            itr = end;
+        }
+    }
+
+    static void applyUpdatesToAttribute(AttrUpdates::const_iterator begin, AttrUpdates::const_iterator end,
+                                        AttributeVector &attr)
+    {
+        DocumentIdT maxLid = 0;
+        SerialNum maxSerialNum = 0;
+        for (auto itr = begin; itr != end; ++itr) {
+            maxLid = std::max(maxLid, itr->lid);
+            maxSerialNum = std::max(maxSerialNum, itr->serialNum);
         }
+        ensureLidSpace(maxSerialNum, maxLid, attr);
+        for (auto itr = begin; itr != end; ++itr) {
+            AttributeUpdater::handleUpdate(attr, itr->lid, *itr->update);
+        }
+        attr.commitIfChangeVectorTooLarge();
     }
 
-    SerialNum                        _serialNum;
-    DocumentIdT                      _lid;
-    AttrUpdates                      _updates;
-    vespalib::IDestructorCallback::SP  _onWriteDone;
+    size_t size() const noexcept { return _updates.size(); }
+
+    AttrUpdates                                     _updates;
+    std::vector<vespalib::IDestructorCallback::SP>  _onWriteDone;
+    SerialNum                                       _lastSerialNum;
 };
 
 BatchUpdateTask::~BatchUpdateTask() = default;
 
+/*
+ * Applies field updates directly to the values of a single value numeric attribute,
+ * for lids in the lid ranges handled by one write shard.
+ */
+struct ShardUpdateTask : public vespalib::Executor::Task {
+
+    explicit ShardUpdateTask(AttributeVector &attr)
+        : vespalib::Executor::Task(),
+          _attr(attr),
+          _updates(),
+          _onWriteDone(),
+          _lastSerialNum(0)
+    { }
+    ~ShardUpdateTask() override;
+
+    void add(SerialNum serialNum, DocumentIdT lid, const FieldUpdate &fieldUpd,
+             const AttributeWriter::OnWriteDoneType &onWriteDone)
+    {
+        _updates.emplace_back(lid, &fieldUpd);
+        if (_onWriteDone.empty() || _lastSerialNum != serialNum) {
+            _onWriteDone.push_back(onWriteDone);
+            _lastSerialNum = serialNum;
+        }
+    }
+
+    void run() override {
+        for (const auto &update : _updates) {
+            for (const auto &valueUpd : update.second->getUpdates()) {
+                if (!_attr.apply_direct(update.first, *valueUpd)) {
+                    LOG(warning, "Failed to apply %s directly to docId %u in attribute vector '%s'",
+                        valueUpd->className(), update.first, _attr.getName().c_str());
+                }
+            }
+        }
+    }
+
+    size_t size() const noexcept { return _updates.size(); }
+
+    AttributeVector                                          &_attr;
+    std::vector<std::pair<DocumentIdT, const FieldUpdate *>>  _updates;
+    std::vector<vespalib::IDestructorCallback::SP>            _onWriteDone;
+    SerialNum                                                 _lastSerialNum;
+};
+
+ShardUpdateTask::~ShardUpdateTask() = default;
+
+// Max number of field updates batched before they are handed over to the write threads
+constexpr size_t max_batched_updates = 256;
+
 class FieldContext
 {
     vespalib::string   _name;
@@ -366,14 +474,20 @@ void
 PutTask::run()
 {
     _wc.consider_build_field_paths(_doc);
+    // Primitive top level fields are decoded into values reused across puts instead of allocated per put
+    bool use_layout = _allAttributes && _wc.decode_layout_fields(_doc);
     DocumentFieldExtractor field_extractor(_doc);
     const auto &fields = _wc.getFields();
-    for (auto field : fields) {
+    for (const auto &field : fields) {
         if (_allAttributes || field.isStructFieldAttribute()) {
             AttributeVector &attr = field.getAttribute();
             if (attr.getStatus().getLastSyncToken() < _serialNum) {
-                auto fv = field_extractor.getFieldValue(field.getFieldPath());
-                applyPutToAttribute(_serialNum, fv, _lid, attr, _onWriteDone);
+                if (use_layout && (field.layout_slot() != DocumentFieldLayout::npos)) {
+                    applyPutToAttribute(_serialNum, _wc.get_layout_value(field), _lid, attr, _onWriteDone);
+                } else {
+                    auto fv = field_extractor.getFieldValue(field.getFieldPath());
+                    applyPutToAttribute(_serialNum, fv.get(), _lid, attr, _onWriteDone);
+                }
             }
         }
     }
@@ -590,6 +704,165 @@ CommitTask::run()
 
 }
 
+/*
+ * Field updates not yet handed over to the write threads, one batch per write thread.
+ */
+class AttributeWriter::BatchedUpdates {
+    std::vector<std::unique_ptr<BatchUpdateTask>> _tasks;
+    size_t                                        _numUpdates;
+public:
+    explicit BatchedUpdates(uint32_t numExecutors)
+        : _tasks(numExecutors),
+          _numUpdates(0)
+    { }
+    ~BatchedUpdates();
+    void add(ExecutorId id, SerialNum serialNum, DocumentIdT lid, AttributeVector &attr,
+             const FieldUpdate &fieldUpd, const OnWriteDoneType &onWriteDone)
+    {
+        auto &task = _tasks[id.getId()];
+        if (!task) {
+            task = std::make_unique<BatchUpdateTask>();
+        }
+        task->add(serialNum, lid, attr, fieldUpd, onWriteDone);
+        ++_numUpdates;
+    }
+    bool empty() const noexcept { return _numUpdates == 0; }
+    bool full() const noexcept { return _numUpdates >= max_batched_updates; }
+    void flush(ExecutorId id, ISequencedTaskExecutor &executor) {
+        auto &task = _tasks[id.getId()];
+        if (task) {
+            _numUpdates -= task->size();
+            executor.executeTask(id, std::move(task));
+        }
+    }
+    void flush(ISequencedTaskExecutor &executor) {
+        for (uint32_t id(0); id < _tasks.size() && !empty(); ++id) {
+            flush(ExecutorId(id), executor);
+        }
+    }
+};
+
+AttributeWriter::BatchedUpdates::~BatchedUpdates() = default;
+
+/*
+ * Single value numeric attribute where partial updates are applied directly by several
+ * write threads (shards), each handling every num_shards'th range of 2^lid_range_bits lids
+ * so writers don't share cache lines. Other writes, commit and lid space changes are
+ * applied by the write thread owning the attribute.
+ *
+ * When switching between the owning thread and the shards, barrier tasks block the threads
+ * taking over until the threads handing over have drained, keeping writes to a document in
+ * feed order. The owning thread commits pending changes before handing over. Shards always
+ * use other threads than the owning thread, and a barrier only waits for tasks scheduled
+ * before itself, so barriers can not deadlock.
+ */
+class AttributeWriter::ShardedAttribute {
+    static constexpr uint32_t lid_range_bits = 10;
+
+    AttributeVector                              &_attr;
+    ExecutorId                                    _executorId;
+    std::vector<ExecutorId>                       _shardIds;
+    std::vector<std::unique_ptr<ShardUpdateTask>> _tasks;
+    // Lids below this limit are known to be in the lid space of the attribute
+    uint32_t                                      _lidLimit;
+    bool                                          _shardsActive;
+
+    uint32_t get_shard(DocumentIdT lid) const noexcept { return (lid >> lid_range_bits) % _shardIds.size(); }
+public:
+    ShardedAttribute(AttributeVector &attr, ExecutorId executorId, uint32_t numShards, ISequencedTaskExecutor &executor)
+        : _attr(attr),
+          _executorId(executorId),
+          _shardIds(),
+          _tasks(numShards),
+          _lidLimit(attr.getCommittedDocIdLimit()),
+          _shardsActive(false)
+    {
+        for (uint32_t i = 0; i < numShards; ++i) {
+            _shardIds.push_back(executor.get_alternate_executor_id(executorId, 1 + i));
+        }
+    }
+    ~ShardedAttribute();
+
+    bool can_apply(DocumentIdT lid, const FieldUpdate &fieldUpd) const {
+        if (lid >= _lidLimit) {
+            return false;
+        }
+        for (const auto &valueUpd : fieldUpd.getUpdates()) {
+            auto type = valueUpd->getType();
+            if (type != ValueUpdate::Assign && type != ValueUpdate::Arithmetic && type != ValueUpdate::Clear) {
+                return false;
+            }
+        }
+        return true;
+    }
+
+    bool shards_active() const noexcept { return _shardsActive; }
+
+    // The owning thread must not have pending updates when this is called.
+    void activate_shards(ISequencedTaskExecutor &executor) {
+        auto latch = std::make_shared<CountDownLatch>(1);
+        executor.execute(_executorId, [&attr = _attr, latch]() {
+            attr.commit();
+            latch->countDown();
+        });
+        for (auto id : _shardIds) {
+            executor.execute(id, [latch]() { latch->await(); });
+        }
+        _shardsActive = true;
+    }
+
+    void add(SerialNum serialNum, DocumentIdT lid, const FieldUpdate &fieldUpd,
+             const OnWriteDoneType &onWriteDone, ISequencedTaskExecutor &executor)
+    {
+        uint32_t shard = get_shard(lid);
+        auto &task = _tasks[shard];
+        if (!task) {
+            task = std::make_unique<ShardUpdateTask>(_attr);
+        }
+        task->add(serialNum, lid, fieldUpd, onWriteDone);
+        if (task->size() >= max_batched_updates) {
+            executor.executeTask(_shardIds[shard], std::move(task));
+        }
+    }
+
+    void sync(ISequencedTaskExecutor &executor) {
+        if (!_shardsActive) {
+            return;
+        }
+        auto latch = std::make_shared<CountDownLatch>(_shardIds.size());
+        for (uint32_t shard = 0; shard < _shardIds.size(); ++shard) {
+            if (_tasks[shard]) {
+                executor.executeTask(_shardIds[shard], std::move(_tasks[shard]));
+            }
+            executor.execute(_shardIds[shard], [latch]() { latch->countDown(); });
+        }
+        executor.execute(_executorId, [latch]() { latch->await(); });
+        _shardsActive = false;
+    }
+
+    void grow_lid_limit(DocumentIdT lid) noexcept { _lidLimit = std::max(_lidLimit, lid + 1); }
+    void set_lid_limit(uint32_t lidLimit) noexcept { _lidLimit = lidLimit; }
+    void shrink_lid_limit(uint32_t lidLimit) noexcept { _lidLimit = std::min(_lidLimit, lidLimit); }
+};
+
+AttributeWriter::ShardedAttribute::~ShardedAttribute() = default;
+
+void
+AttributeWriter::flushBatchedUpdates()
+{
+    if (!_batchedUpdates->empty()) {
+        _batchedUpdates->flush(_attributeFieldWriter);
+    }
+}
+
+void
+AttributeWriter::syncShardedAttributes()
+{
+    for (auto &sharded : _shardedAttributes) {
+        sharded->sync(_attributeFieldWriter);
+    }
+}
+
 void
 AttributeWriter::setupWriteContexts()
 {
@@ -626,6 +899,13 @@ void
 AttributeWriter::internalPut(SerialNum serialNum, const Document &doc, DocumentIdT lid,
                              bool allAttributes, OnWriteDoneType onWriteDone)
 {
+    syncShardedAttributes();
+    flushBatchedUpdates();
+    if (allAttributes) {
+        for (auto &sharded : _shardedAttributes) {
+            sharded->grow_lid_limit(lid);
+        }
+    }
     for (const auto &wc : _writeContexts) {
         if (allAttributes && wc.use_two_phase_put()) {
             assert(wc.getFields().size() == 1);
@@ -646,6 +926,8 @@ AttributeWriter::internalPut(SerialNum serialNum, const Document &doc, DocumentI
 void
 AttributeWriter::internalRemove(SerialNum serialNum, DocumentIdT lid, OnWriteDoneType onWriteDone)
 {
+    syncShardedAttributes();
+    flushBatchedUpdates();
     for (const auto &wc : _writeContexts) {
         auto removeTask = std::make_unique<RemoveTask>(wc, serialNum, lid, onWriteDone);
         _attributeFieldWriter.executeTask(wc.getExecutorId(), std::move(removeTask));
@@ -658,7 +940,9 @@ AttributeWriter::AttributeWriter(proton::IAttributeManager::SP mgr)
       _shared_executor(_mgr->get_shared_executor()),
       _writeContexts(),
       _hasStructFieldAttribute(false),
-      _attrMap()
+      _attrMap(),
+      _batchedUpdates(std::make_unique<BatchedUpdates>(_attributeFieldWriter.getNumExecutors())),
+      _shardedAttributes()
 {
     setupWriteContexts();
     setupAttributeMapping();
@@ -667,8 +951,16 @@ AttributeWriter::AttributeWriter(proton::IAttributeManager::SP mgr)
 void AttributeWriter::setupAttributeMapping() {
     for (auto attr : getWritableAttributes()) {
         vespalib::stringref name = attr->getName();
-        _attrMap[name] = AttributeWithInfo(attr, _attributeFieldWriter.getExecutorIdFromName(attr->getNamePrefix()));
-    }    
+        auto &info = _attrMap[name];
+        info = AttributeWithInfo(attr, _attributeFieldWriter.getExecutorIdFromName(attr->getNamePrefix()));
+        // Shards use other write threads than the one owning the attribute
+        uint32_t numShards = std::min(attr->getConfig().write_shards(), _attributeFieldWriter.getNumExecutors() - 1);
+        if (numShards > 1 && attr->supports_direct_updates()) {
+            _shardedAttributes.push_back(std::make_unique<ShardedAttribute>(*attr, info.executor_id, numShards,
+                                                                            _attributeFieldWriter));
+            info.sharded = _shardedAttributes.back().get();
+        }
+    }
 }
 
 
@@ -680,6 +972,8 @@ AttributeWriter::~AttributeWriter() {
 
 void
 AttributeWriter::drain(OnWriteDoneType onDone) {
+    syncShardedAttributes();
+    flushBatchedUpdates();
 
     for (const auto &wc : _writeContexts) {
         _attributeFieldWriter.executeLambda(wc.getExecutorId(), [onDone] () { (void) onDone; });
@@ -724,6 +1018,8 @@ AttributeWriter::remove(SerialNum serialNum, DocumentIdT lid, OnWriteDoneType on
 void
 AttributeWriter::remove(const LidVector &lidsToRemove, SerialNum serialNum, OnWriteDoneType onWriteDone)
 {
+    syncShardedAttributes();
+    flushBatchedUpdates();
     for (const auto &writeCtx : _writeContexts) {
         auto removeTask = std::make_unique<BatchRemoveTask>(writeCtx, serialNum, lidsToRemove, onWriteDone);
         _attributeFieldWriter.executeTask(writeCtx.getExecutorId(), std::move(removeTask));
@@ -754,14 +1050,6 @@ AttributeWriter::update(SerialNum serialNum, const DocumentUpdate &upd, Document
                         OnWriteDoneType onWriteDone, IFieldUpdateCallback & onUpdate)
 {
     LOG(debug, "Inspecting update for document %d.", lid);
-    std::vector<std::unique_ptr<BatchUpdateTask>> args;
-    uint32_t numExecutors = _attributeFieldWriter.getNumExecutors();
-    args.reserve(numExecutors);
-    for (uint32_t i(0); i < numExecutors; i++) {
-        args.emplace_back(std::make_unique<BatchUpdateTask>(serialNum, lid));
-        args.back()->_updates.reserve((2*upd.getUpdates().size())/numExecutors);
-    }
-
     for (const auto &fupd : upd.getUpdates()) {
         LOG(debug, "Retrieving guard for attribute vector '%s'.", fupd.getField().getName().data());
         auto found = _attrMap.find(fupd.getField().getName());
@@ -776,32 +1064,44 @@ AttributeWriter::update(SerialNum serialNum, const DocumentUpdate &upd, Document
         if (__builtin_expect(attrp->getStatus().getLastSyncToken() >= serialNum, false)) {
             continue;
         }
+        ShardedAttribute *sharded = found->second.sharded;
+        if (sharded != nullptr) {
+            if (sharded->can_apply(lid, fupd)) {
+                if (!sharded->shards_active()) {
+                    _batchedUpdates->flush(found->second.executor_id, _attributeFieldWriter);
+                    sharded->activate_shards(_attributeFieldWriter);
+                }
+                sharded->add(serialNum, lid, fupd, onWriteDone, _attributeFieldWriter);
+                continue;
+            }
+            sharded->sync(_attributeFieldWriter);
+            sharded->grow_lid_limit(lid);
+        }
         if (found->second.use_two_phase_put_for_assign_updates && is_single_assign_update(fupd)) {
             auto prepare_task = std::make_unique<PreparePutTask>(serialNum, lid, *attrp, get_single_assign_update_field_value(fupd));
             auto complete_task = std::make_unique<CompletePutTask>(*prepare_task, onWriteDone);
             LOG(debug, "About to handle assign update as two phase put for docid %u in attribute vector '%s'",
                 lid, attrp->getName().c_str());
+            _batchedUpdates->flush(found->second.executor_id, _attributeFieldWriter);
             _shared_executor.execute(CpuUsage::wrap(std::move(prepare_task), CpuUsage::Category::WRITE));
             _attributeFieldWriter.executeTask(found->second.executor_id, std::move(complete_task));
         } else {
-            args[found->second.executor_id.getId()]->_updates.emplace_back(attrp, &fupd);
+            // NOTE: The lifetime of the field update will be ensured by keeping the document update alive
+            // in a operation done context object.
+            _batchedUpdates->add(found->second.executor_id, serialNum, lid, *attrp, fupd, onWriteDone);
             LOG(debug, "About to apply update for docId %u in attribute vector '%s'.", lid, attrp->getName().c_str());
         }
     }
-    // NOTE: The lifetime of the field update will be ensured by keeping the document update alive
-    // in a operation done context object.
-    for (uint32_t id(0); id < args.size(); id++) {
-        if ( ! args[id]->_updates.empty()) {
-            args[id]->_onWriteDone = onWriteDone;
-            _attributeFieldWriter.executeTask(ExecutorId(id), std::move(args[id]));
-        }
+    if (_batchedUpdates->full()) {
+        flushBatchedUpdates();
     }
-
 }
 
 void
 AttributeWriter::heartBeat(SerialNum serialNum, OnWriteDoneType onDone)
 {
+    syncShardedAttributes();
+    flushBatchedUpdates();
     for (auto entry : _attrMap) {
         _attributeFieldWriter.execute(entry.second.executor_id,[serialNum, attr=entry.second.attribute, onDone]() {
             (void) onDone;
@@ -814,6 +1114,8 @@ AttributeWriter::heartBeat(SerialNum serialNum, OnWriteDoneType onDone)
 void
 AttributeWriter::forceCommit(const CommitParam & param, OnWriteDoneType onWriteDone)
 {
+    syncShardedAttributes();
+    flushBatchedUpdates();
     if (_mgr->getImportedAttributes() != nullptr) {
         std::vector<std::shared_ptr<ImportedAttributeVector>> importedAttrs;
         _mgr->getImportedAttributes()->getAll(importedAttrs);
@@ -829,9 +1131,20 @@ AttributeWriter::forceCommit(const CommitParam & param, OnWriteDoneType onWriteD
 }
 
 
+void
+AttributeWriter::dispatchPendingUpdates()
+{
+    flushBatchedUpdates();
+}
+
 void
 AttributeWriter::onReplayDone(uint32_t docIdLimit)
 {
+    syncShardedAttributes();
+    flushBatchedUpdates();
+    for (auto &sharded : _shardedAttributes) {
+        sharded->set_lid_limit(docIdLimit);
+    }
     vespalib::Gate gate;
     {
         auto on_write_done = std::make_shared<GateCallback>(gate);
@@ -851,6 +1164,11 @@ AttributeWriter::onReplayDone(uint32_t docIdLimit)
 void
 AttributeWriter::compactLidSpace(uint32_t wantedLidLimit, SerialNum serialNum)
 {
+    syncShardedAttributes();
+    flushBatchedUpdates();
+    for (auto &sharded : _shardedAttributes) {
+        sharded->shrink_lid_limit(wantedLidLimit);
+    }
     vespalib::Gate gate;
     {
         auto on_write_done = std::make_shared<GateCallback>(gate);
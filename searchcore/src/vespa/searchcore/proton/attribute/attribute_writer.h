@@ -4,6 +4,7 @@
 #include "i_attribute_manager.h"
 #include "i_attribute_writer.h"
 #include <vespa/document/base/fieldpath.h>
+#include <vespa/document/fieldvalue/document_field_layout.h>
 #include <vespa/vespalib/util/isequencedtaskexecutor.h>
 #include <vespa/vespalib/stllike/hash_map.h>
 
@@ -14,6 +15,16 @@ namespace proton {
 /**
  * Concrete attribute writer that handles writes in form of put, update and remove
  * to the attribute vectors managed by the underlying attribute manager.
+ *
+ * Partial updates from consecutive document updates are batched per write thread and
+ * applied grouped by attribute vector. The batch is handed over to the write threads
+ * when it is full and before any other write operation, commit or drain. In normal feed
+ * this means that a partial update is applied at the latest by the next commit initiated
+ * by the feed handler, which is also what the operation is acked on.
+ *
+ * Partial updates to single value numeric attributes configured with more than one
+ * write shard are applied directly by several write threads, each handling disjoint
+ * lid ranges, while all other writes to the attribute stay in its own write thread.
  */
 class AttributeWriter : public IAttributeWriter
 {
@@ -27,6 +38,7 @@ private:
     vespalib::ISequencedTaskExecutor &_attributeFieldWriter;
     vespalib::Executor& _shared_executor;
     using ExecutorId = vespalib::ISequencedTaskExecutor::ExecutorId;
+    class ShardedAttribute;
 public:
     /**
      * Represents an attribute vector for a field and details about how to write to it.
@@ -36,12 +48,15 @@ public:
         AttributeVector &_attribute;
         bool             _structFieldAttribute; // in array/map of struct
         bool             _use_two_phase_put;
+        mutable uint32_t _layout_slot; // slot in the write context field layout, or npos
     public:
         WriteField(AttributeVector &attribute);
         ~WriteField();
         AttributeVector &getAttribute() const { return _attribute; }
         const FieldPath &getFieldPath() const { return _fieldPath; }
         void buildFieldPath(const DocumentType &docType) const;
+        uint32_t layout_slot() const noexcept { return _layout_slot; }
+        void set_layout_slot(uint32_t slot) const noexcept { _layout_slot = slot; }
         bool isStructFieldAttribute() const { return _structFieldAttribute; }
         bool use_two_phase_put() const { return _use_two_phase_put; }
     };
@@ -54,6 +69,9 @@ public:
         std::vector<WriteField> _fields;
         mutable const DataType* _data_type;
         mutable std::shared_ptr<const FieldPath> _two_phase_put_field_path;
+        // Layout of the primitive top level fields, decoded into values reused by all puts in this context
+        mutable std::unique_ptr<const document::DocumentFieldLayout> _layout;
+        mutable document::DocumentFieldLayout::Values _layout_values;
         bool _hasStructFieldAttribute;
         // When this is true, the context only contains a single field.
         bool _use_two_phase_put;
@@ -69,23 +87,37 @@ public:
         bool hasStructFieldAttribute() const { return _hasStructFieldAttribute; }
         bool use_two_phase_put() const { return _use_two_phase_put; }
         std::shared_ptr<const FieldPath> get_two_phase_put_field_path() const noexcept { return _two_phase_put_field_path; }
+        /**
+         * Decode the fields in the field layout of this context from the given document.
+         * Only to be called from the write thread of this context.
+         */
+        bool decode_layout_fields(const Document &doc) const;
+        const FieldValue *get_layout_value(const WriteField &field) const noexcept {
+            return _layout_values.get(field.layout_slot());
+        }
     };
 
     struct AttributeWithInfo {
         search::AttributeVector* attribute;
         ExecutorId executor_id;
         bool use_two_phase_put_for_assign_updates;
+        ShardedAttribute* sharded;
 
         AttributeWithInfo();
         AttributeWithInfo(search::AttributeVector* attribute_in,
                           ExecutorId executor_id_in);
     };
 private:
+    class BatchedUpdates;
     using AttrMap = vespalib::hash_map<vespalib::string, AttributeWithInfo>;
     std::vector<WriteContext> _writeContexts;
     bool                      _hasStructFieldAttribute;
     AttrMap                   _attrMap;
+    std::unique_ptr<BatchedUpdates> _batchedUpdates;
+    std::vector<std::unique_ptr<ShardedAttribute>> _shardedAttributes;
 
+    void flushBatchedUpdates();
+    void syncShardedAttributes();
     void setupWriteContexts();
     void setupAttributeMapping();
     void internalPut(SerialNum serialNum, const Document &doc, DocumentIdT lid,
@@ -115,6 +147,7 @@ public:
         return _mgr;
     }
     void forceCommit(const CommitParam & param, OnWriteDoneType onWriteDone) override;
+    void dispatchPendingUpdates() override;
 
     void onReplayDone(uint32_t docIdLimit) override;
     bool hasStructFieldAttribute() const override;
@@ -11,6 +11,7 @@
 #include <vespa/searchlib/attribute/attributememorysavetarget.h>
 #include <vespa/searchlib/attribute/attributevector.h>
 #include <vespa/searchcommon/attribute/config.h>
+#include <vespa/vespalib/util/io_scheduler.h>
 #include <vespa/vespalib/util/isequencedtaskexecutor.h>
 #include <vespa/vespalib/util/stringfmt.h>
 #include <filesystem>
@@ -38,8 +39,11 @@ private:
     std::unique_ptr<search::AttributeSaver>   _saver;
     uint64_t                                  _syncToken;
     vespalib::string                          _flushFile;
+    // Snapshot with the files that a delta save is applied on top of, empty for a full save.
+    vespalib::string                          _deltaBaseDir;
 
     bool saveAttribute(); // not updating snap info.
+    bool linkDeltaBaseFiles();
 public:
     Flusher(FlushableAttribute & fattr, uint64_t syncToken, AttributeDirectory::Writer &writer);
     ~Flusher() override;
@@ -61,13 +65,44 @@ FlushableAttribute::Flusher::Flusher(FlushableAttribute & fattr, SerialNum syncT
       _saveTarget(),
       _saver(),
       _syncToken(syncToken),
-      _flushFile("")
+      _flushFile(""),
+      _deltaBaseDir()
 {
     fattr._attr->commit(CommitParam(syncToken));
     AttributeVector &attr = *_fattr._attr;
     // Called by attribute field writer executor
     _flushFile = writer.getSnapshotDir(_syncToken) + "/" + attr.getName();
-    _saver = attr.initSave(_flushFile);
+    uint32_t maxDeltaSaves = attr.getConfig().max_delta_saves();
+    uint64_t baseSerial = attr.get_delta_save_base_serial_num();
+    if (maxDeltaSaves > 0 && baseSerial != 0 && baseSerial == _fattr.getFlushedSerialNum()) {
+        // Save only the changes when the previous snapshot has few enough deltas that together
+        // are at most half the size of its .dat file, otherwise compact with a full save.
+        vespalib::string baseDir = writer.getSnapshotDir(baseSerial);
+        std::error_code base_ec;
+        auto baseSize = std::filesystem::file_size(std::filesystem::path(baseDir + "/" + attr.getName() + ".dat"), base_ec);
+        std::error_code ec;
+        uint32_t numDeltas = 0;
+        uint64_t deltaBytes = 0;
+        for (;;) {
+            auto size = std::filesystem::file_size(std::filesystem::path(baseDir + "/" + attr.getName() + ".delta." +
+                                                                         std::to_string(numDeltas + 1) + ".dat"), ec);
+            if (ec) {
+                break;
+            }
+            ++numDeltas;
+            deltaBytes += size;
+        }
+        if (!base_ec && numDeltas < maxDeltaSaves && deltaBytes < baseSize / 2) {
+            _saver = attr.init_delta_save(_flushFile + ".delta." + std::to_string(numDeltas + 1),
+                                          baseSize / 2 - deltaBytes);
+            if (_saver) {
+                _deltaBaseDir = baseDir;
+            }
+        }
+    }
+    if (!_saver) {
+        _saver = attr.initSave(_flushFile);
+    }
     if (!_saver) {
         // New style background save not available, use old style save.
         attr.save(_saveTarget, _flushFile);
@@ -79,6 +114,7 @@ FlushableAttribute::Flusher::~Flusher() = default;
 bool
 FlushableAttribute::Flusher::saveAttribute()
 {
+    vespalib::IoScheduler::MyClass my_io_class(vespalib::IoScheduler::Class::FLUSH);
     std::filesystem::create_directory(std::filesystem::path(vespalib::dirname(_flushFile)));
     SerialNumFileHeaderContext fileHeaderContext(_fattr._fileHeaderContext, _syncToken);
     bool saveSuccess = true;
@@ -99,6 +135,27 @@ FlushableAttribute::Flusher::saveAttribute()
     return saveSuccess;
 }
 
+bool
+FlushableAttribute::Flusher::linkDeltaBaseFiles()
+{
+    // Hard links keep the files alive when the previous snapshot is removed.
+    std::filesystem::path dir(vespalib::dirname(_flushFile));
+    vespalib::string prefix = _fattr._attr->getName() + ".";
+    std::error_code ec;
+    for (const auto &entry : std::filesystem::directory_iterator(std::filesystem::path(_deltaBaseDir), ec)) {
+        auto name = entry.path().filename().string();
+        if (name.compare(0, prefix.size(), prefix) == 0) {
+            std::filesystem::create_hard_link(entry.path(), dir / name, ec);
+            if (ec) {
+                LOG(warning, "Could not link '%s' into '%s': %s",
+                    entry.path().c_str(), dir.c_str(), ec.message().c_str());
+                return false;
+            }
+        }
+    }
+    return !ec;
+}
+
 bool
 FlushableAttribute::Flusher::flush(AttributeDirectory::Writer &writer)
 {
@@ -107,6 +164,10 @@ FlushableAttribute::Flusher::flush(AttributeDirectory::Writer &writer)
         LOG(warning, "Could not write attribute vector '%s' to disk", _flushFile.c_str());
         return false;
     }
+    if (!_deltaBaseDir.empty() && !linkDeltaBaseFiles()) {
+        LOG(warning, "Could not reuse files from '%s' for attribute vector '%s'", _deltaBaseDir.c_str(), _flushFile.c_str());
+        return false;
+    }
     writer.markValidSnapshot(_syncToken);
     writer.setLastFlushTime(search::FileKit::getModificationTime(vespalib::dirname(_flushFile)));
     return true;
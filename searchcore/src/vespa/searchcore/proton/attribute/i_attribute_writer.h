@@ -62,6 +62,12 @@ public:
      */
     virtual void forceCommit(const CommitParam & param, OnWriteDoneType onWriteDone) = 0;
 
+    /**
+     * Hand over partial updates batched by this writer to the write threads, without
+     * committing the underlying attribute vectors.
+     */
+    virtual void dispatchPendingUpdates() = 0;
+
     virtual void onReplayDone(uint32_t docIdLimit) = 0;
     virtual bool hasStructFieldAttribute() const = 0;
     virtual void drain(OnWriteDoneType onWriteDone) = 0;
@@ -105,7 +105,7 @@ BucketDB::remove_batch(const std::vector<RemoveBatchEntry> &removed, SubDbType s
             state = &_map[entry.get_bucket_id()];
             prev_bucket_id = entry.get_bucket_id();
         }
-        state->remove(entry.get_gid(), entry.get_timestamp(), entry.get_doc_size(), sub_db_type);
+        state->remove(entry.get_checksum(), entry.get_doc_size(), sub_db_type);
         if (state->isActive() && sub_db_type != SubDbType::REMOVED) {
             subActive(1);
         }
@@ -63,6 +63,17 @@ BucketState::addChecksum(BucketChecksum a, BucketChecksum b) {
     abort();
 }
 
+uint64_t
+BucketState::calcChecksum(const GlobalId &gid, const Timestamp &timestamp) {
+    switch (_checksumType) {
+        case ChecksumAggregator::ChecksumType::LEGACY:
+            return LegacyChecksumAggregator::calc(gid, timestamp);
+        case ChecksumAggregator::ChecksumType::XXHASH64:
+            return XXH64ChecksumAggregator::calc(gid, timestamp);
+    }
+    abort();
+}
+
 void
 BucketState::add(const GlobalId &gid, const Timestamp &timestamp, uint32_t docSize, SubDbType subDbType)
 {
@@ -84,6 +95,12 @@ BucketState::add(const GlobalId &gid, const Timestamp &timestamp, uint32_t docSi
 
 void
 BucketState::remove(const GlobalId &gid, const Timestamp &timestamp, uint32_t docSize, SubDbType subDbType)
+{
+    remove((subDbType != SubDbType::REMOVED) ? calcChecksum(gid, timestamp) : 0u, docSize, subDbType);
+}
+
+void
+BucketState::remove(uint64_t checksum, uint32_t docSize, SubDbType subDbType)
 {
     assert(subDbType < SubDbType::COUNT);
     uint32_t subDbTypeIdx = toIdx(subDbType);
@@ -92,10 +109,10 @@ BucketState::remove(const GlobalId &gid, const Timestamp &timestamp, uint32_t do
     if (subDbType != SubDbType::REMOVED) {
         switch (_checksumType) {
             case ChecksumAggregator::ChecksumType::LEGACY:
-                _ch._legacy = LegacyChecksumAggregator::removeDoc(gid, timestamp, _ch._legacy);
+                _ch._legacy = LegacyChecksumAggregator::remove(static_cast<uint32_t>(checksum), _ch._legacy);
                 break;
             case ChecksumAggregator::ChecksumType::XXHASH64:
-                _ch._xxh64 = XXH64ChecksumAggregator::update(gid, timestamp, _ch._xxh64);
+                _ch._xxh64 = XXH64ChecksumAggregator::update(checksum, _ch._xxh64);
                 break;
         }
     }
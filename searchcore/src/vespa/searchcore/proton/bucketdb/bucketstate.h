@@ -43,9 +43,13 @@ public:
     ~BucketState();
 
     static BucketChecksum addChecksum(BucketChecksum a, BucketChecksum b);
+    // Checksum contribution of a single document, using the configured checksum type.
+    static uint64_t calcChecksum(const GlobalId &gid, const Timestamp &timestamp);
 
     void add(const GlobalId &gid, const Timestamp &timestamp, uint32_t docSize, SubDbType subDbType);
     void remove(const GlobalId &gid, const Timestamp &timestamp, uint32_t docSize, SubDbType subDbType);
+    // Remove document with checksum contribution already calculated by calcChecksum()
+    void remove(uint64_t checksum, uint32_t docSize, SubDbType subDbType);
 
     void modify(const GlobalId &gid,
                 const Timestamp &oldTimestamp, uint32_t oldDocSize,
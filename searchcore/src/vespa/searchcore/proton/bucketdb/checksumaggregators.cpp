@@ -44,6 +44,11 @@ compute(const GlobalId &gid, const Timestamp &timestamp) {
 
 }
 
+uint32_t
+LegacyChecksumAggregator::calc(const GlobalId &gid, const Timestamp &timestamp) {
+    return calcChecksum(gid, timestamp);
+}
+
 uint32_t
 LegacyChecksumAggregator::addDoc(const GlobalId &gid, const Timestamp &timestamp, uint32_t checkSum) {
     return add(calcChecksum(gid, timestamp), checkSum);
@@ -54,6 +59,11 @@ LegacyChecksumAggregator::removeDoc(const GlobalId &gid, const Timestamp &timest
     return remove(calcChecksum(gid, timestamp), checkSum);
 }
 
+uint64_t
+XXH64ChecksumAggregator::calc(const GlobalId &gid, const Timestamp &timestamp) {
+    return compute(gid, timestamp);
+}
+
 uint64_t
 XXH64ChecksumAggregator::update(const GlobalId &gid, const Timestamp &timestamp, uint64_t checkSum) {
     return update(compute(gid, timestamp), checkSum);
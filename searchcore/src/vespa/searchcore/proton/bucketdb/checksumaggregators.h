@@ -9,6 +9,7 @@ namespace proton::bucketdb {
  **/
 class LegacyChecksumAggregator : public ChecksumAggregator {
 public:
+    static uint32_t calc(const GlobalId &gid, const Timestamp &timestamp);
     static uint32_t addDoc(const GlobalId &gid, const Timestamp &timestamp, uint32_t checkSum);
     static uint32_t removeDoc(const GlobalId &gid, const Timestamp &timestamp, uint32_t checkSum);
     static uint32_t add(uint32_t checksum, uint32_t aggr) { return aggr + checksum; }
@@ -21,6 +22,7 @@ public:
  **/
 class XXH64ChecksumAggregator : public ChecksumAggregator {
 public:
+    static uint64_t calc(const GlobalId &gid, const Timestamp &timestamp);
     static uint64_t update(const GlobalId &gid, const Timestamp &timestamp, uint64_t checkSum);
     static uint64_t update(uint64_t a, uint64_t b) { return a ^ b; }
     static BucketChecksum get(uint64_t checkSum) {
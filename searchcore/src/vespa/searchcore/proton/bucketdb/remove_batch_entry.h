@@ -2,6 +2,7 @@
 
 #pragma once
 
+#include "bucketstate.h"
 #include <vespa/document/base/globalid.h>
 #include <vespa/document/bucket/bucketid.h>
 #include <vespa/persistence/spi/types.h>
@@ -11,19 +12,27 @@ namespace proton::bucketdb {
 
 /*
  * Class containing meta data for a single document being removed from
- * bucket db.
+ * bucket db. The checksum contribution of the document (see
+ * BucketState::calcChecksum) is calculated before the bucket db lock is
+ * taken. It is ignored when removing from the removed sub db.
  */
 class RemoveBatchEntry {
     document::GlobalId      _gid;
     document::BucketId      _bucket_id;
     storage::spi::Timestamp _timestamp;
     uint32_t                _doc_size;
+    uint64_t                _checksum;
 public:
-    RemoveBatchEntry(const document::GlobalId& gid, const document::BucketId& bucket_id, const storage::spi::Timestamp& timestamp, uint32_t doc_size) noexcept
+    RemoveBatchEntry(const document::GlobalId& gid, const document::BucketId& bucket_id, const storage::spi::Timestamp& timestamp, uint32_t doc_size, uint64_t checksum) noexcept
         : _gid(gid),
           _bucket_id(bucket_id),
           _timestamp(timestamp),
-          _doc_size(doc_size)
+          _doc_size(doc_size),
+          _checksum(checksum)
+    {
+    }
+    RemoveBatchEntry(const document::GlobalId& gid, const document::BucketId& bucket_id, const storage::spi::Timestamp& timestamp, uint32_t doc_size)
+        : RemoveBatchEntry(gid, bucket_id, timestamp, doc_size, BucketState::calcChecksum(gid, timestamp))
     {
     }
 
@@ -31,6 +40,7 @@ public:
     const document::BucketId& get_bucket_id() const noexcept { return _bucket_id; }
     const storage::spi::Timestamp& get_timestamp() const noexcept { return _timestamp; }
     uint32_t get_doc_size() const noexcept { return _doc_size; }
+    uint64_t get_checksum() const noexcept { return _checksum; }
 };
 
 }
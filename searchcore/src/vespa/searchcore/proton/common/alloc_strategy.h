@@ -20,11 +20,15 @@ protected:
     const search::GrowStrategy       _grow_strategy;
     const CompactionStrategy         _compaction_strategy;
     const uint32_t                   _amortize_count;
+    const bool                       _gid_hash_index;
+    const bool                       _bucket_timestamp_index;
 
 public:
     AllocStrategy(const search::GrowStrategy& grow_strategy,
                   const CompactionStrategy& compaction_strategy,
-                  uint32_t amortize_count);
+                  uint32_t amortize_count,
+                  bool gid_hash_index = false,
+                  bool bucket_timestamp_index = false);
 
     AllocStrategy();
     ~AllocStrategy();
@@ -36,6 +40,10 @@ public:
     const search::GrowStrategy& get_grow_strategy() const noexcept { return _grow_strategy; }
     const CompactionStrategy& get_compaction_strategy() const noexcept { return _compaction_strategy; }
     uint32_t get_amortize_count() const noexcept { return _amortize_count; }
+    // Whether the document meta store keeps a gid -> lid hash index for point lookups
+    bool get_gid_hash_index() const noexcept { return _gid_hash_index; }
+    // Whether the document meta store keeps an index ordered by bucket and timestamp
+    bool get_bucket_timestamp_index() const noexcept { return _bucket_timestamp_index; }
 };
 
 std::ostream& operator<<(std::ostream& os, const AllocStrategy&alloc_strategy);
@@ -2,9 +2,11 @@
 
 #include "cachedselect.h"
 #include "attributefieldvaluenode.h"
+#include "compiled_attribute_compare.h"
 #include "select_utils.h"
 #include "selectcontext.h"
 #include "selectpruner.h"
+#include <vespa/document/select/compiled_selection.h>
 #include <vespa/document/select/parser.h>
 #include <vespa/searchlib/attribute/attributevector.h>
 #include <vespa/searchlib/attribute/attribute_read_guard.h>
@@ -15,6 +17,7 @@ namespace proton {
 
 using search::AttributeVector;
 using search::AttributeGuard;
+using document::select::CompiledSelection;
 using document::select::FieldValueNode;
 using search::attribute::CollectionType;
 using search::attribute::BasicType;
@@ -122,19 +125,30 @@ AttrVisitor::visitFieldValueNode(const FieldValueNode &expr)
 
 CachedSelect::Session::Session(std::unique_ptr<document::select::Node> docSelect,
                                std::unique_ptr<document::select::Node> preDocOnlySelect,
-                               std::unique_ptr<document::select::Node> preDocSelect)
+                               std::unique_ptr<document::select::Node> preDocSelect,
+                               std::shared_ptr<const CompiledSelection> compiledDocSelect)
     : _docSelect(std::move(docSelect)),
       _preDocOnlySelect(std::move(preDocOnlySelect)),
-      _preDocSelect(std::move(preDocSelect))
+      _preDocSelect(std::move(preDocSelect)),
+      _compiledPreDocOnlySelect(_preDocOnlySelect ? CompiledAttributeCompare::compile(*_preDocOnlySelect) : nullptr),
+      _compiledDocSelect(std::move(compiledDocSelect))
 {
 }
 
+CachedSelect::Session::~Session() = default;
+
 bool
 CachedSelect::Session::contains(const SelectContext &context) const
 {
     if (_preDocSelect && (_preDocSelect->contains(context) == document::select::Result::False)) {
         return false;
     }
+    if (_compiledPreDocOnlySelect) {
+        auto matches = _compiledPreDocOnlySelect->matches(context);
+        if (matches.has_value()) {
+            return matches.value();
+        }
+    }
     return (!_preDocOnlySelect) ||
             (_preDocOnlySelect && (_preDocOnlySelect->contains(context) == document::select::Result::True));
 }
@@ -142,8 +156,13 @@ CachedSelect::Session::contains(const SelectContext &context) const
 bool
 CachedSelect::Session::contains(const document::Document &doc) const
 {
-    return (_preDocOnlySelect) ||
-            (_docSelect && (_docSelect->contains(doc) == document::select::Result::True));
+    if (_preDocOnlySelect) {
+        return true;
+    }
+    if (_compiledDocSelect) {
+        return (_compiledDocSelect->contains(doc) == document::select::Result::True);
+    }
+    return (_docSelect && (_docSelect->contains(doc) == document::select::Result::True));
 }
 
 const document::select::Node &
@@ -187,6 +206,7 @@ CachedSelect::setPreDocumentSelect(const search::IAttributeManager &attrMgr,
 CachedSelect::CachedSelect()
     : _attributes(),
       _docSelect(),
+      _compiledDocSelect(),
       _fieldNodes(0u),
       _attrFieldNodes(0u),
       _svAttrFieldNodes(0u),
@@ -209,6 +229,7 @@ CachedSelect::set(const vespalib::string &selection,
     } catch (document::select::ParsingFailedException &) {
         _docSelect.reset(nullptr);
     }
+    _compiledDocSelect = _docSelect ? CompiledSelection::compile(*_docSelect, repo) : nullptr;
     _allFalse = !_docSelect;
     _allTrue = false;
     _allInvalid = false;
@@ -236,6 +257,7 @@ CachedSelect::set(const vespalib::string &selection,
                             true);
     docsPruner.process(*parsed);
     setDocumentSelect(docsPruner);
+    _compiledDocSelect = _docSelect ? CompiledSelection::compile(*_docSelect, repo) : nullptr;
     if (amgr == nullptr || _attrFieldNodes == 0u) {
         return;
     }
@@ -255,7 +277,8 @@ CachedSelect::createSession() const
 {
     return std::make_unique<Session>((_docSelect ? _docSelect->clone() : NodeUP()),
                                      (_preDocOnlySelect ? _preDocOnlySelect->clone() : NodeUP()),
-                                     (_preDocSelect ? _preDocSelect->clone() : NodeUP()));
+                                     (_preDocSelect ? _preDocSelect->clone() : NodeUP()),
+                                     _compiledDocSelect);
 }
 
 }
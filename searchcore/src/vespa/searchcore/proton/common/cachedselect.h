@@ -9,7 +9,10 @@
 namespace document {
     class DocumentTypeRepo;
     class Document;
-    namespace select { class Node; }
+    namespace select {
+        class CompiledSelection;
+        class Node;
+    }
 }
 namespace search {
     class AttributeVector;
@@ -20,6 +23,7 @@ namespace search::attribute { class ReadableAttributeVector; }
 
 namespace proton {
 
+class CompiledAttributeCompare;
 class SelectContext;
 class SelectPruner;
 
@@ -37,14 +41,21 @@ public:
         std::unique_ptr<document::select::Node> _docSelect;
         std::unique_ptr<document::select::Node> _preDocOnlySelect;
         std::unique_ptr<document::select::Node> _preDocSelect;
+        // Compiled _preDocOnlySelect when it is a simple attribute comparison
+        std::unique_ptr<CompiledAttributeCompare> _compiledPreDocOnlySelect;
+        // Compiled _docSelect, shared by all sessions
+        std::shared_ptr<const document::select::CompiledSelection> _compiledDocSelect;
 
     public:
         Session(std::unique_ptr<document::select::Node> docSelect,
                 std::unique_ptr<document::select::Node> preDocOnlySelect,
-                std::unique_ptr<document::select::Node> preDocSelect);
+                std::unique_ptr<document::select::Node> preDocSelect,
+                std::shared_ptr<const document::select::CompiledSelection> compiledDocSelect);
+        ~Session();
         bool contains(const SelectContext &context) const;
         bool contains(const document::Document &doc) const;
         const document::select::Node &selectNode() const;
+        bool hasCompiledPreDocOnlySelect() const noexcept { return static_cast<bool>(_compiledPreDocOnlySelect); }
     };
 
     using AttributeVectors = std::vector<std::shared_ptr<search::attribute::ReadableAttributeVector>>;
@@ -55,6 +66,7 @@ private:
 
     // Pruned selection expression, specific for a document type
     std::unique_ptr<document::select::Node> _docSelect;
+    std::shared_ptr<const document::select::CompiledSelection> _compiledDocSelect;
     uint32_t _fieldNodes;
     uint32_t _attrFieldNodes;
     uint32_t _svAttrFieldNodes;
@@ -97,6 +109,7 @@ public:
     const std::unique_ptr<document::select::Node> &docSelect() const { return _docSelect; }
     const std::unique_ptr<document::select::Node> &preDocOnlySelect() const { return _preDocOnlySelect; }
     const std::unique_ptr<document::select::Node> &preDocSelect() const { return _preDocSelect; }
+    const std::shared_ptr<const document::select::CompiledSelection> &compiledDocSelect() const { return _compiledDocSelect; }
 
     void set(const vespalib::string &selection,
              const document::DocumentTypeRepo &repo);
@@ -0,0 +1,163 @@
+// Copyright Vespa.ai. Licensed under the terms of the Apache 2.0 license. See LICENSE in the project root.
+
+#include "compiled_attribute_compare.h"
+#include "attributefieldvaluenode.h"
+#include "selectcontext.h"
+#include <vespa/document/select/compare.h>
+#include <vespa/document/select/context.h>
+#include <vespa/document/select/operator.h>
+#include <vespa/document/select/value.h>
+#include <vespa/document/select/valuenodes.h>
+#include <vespa/searchcommon/attribute/iattributevector.h>
+
+namespace proton {
+
+using document::select::ArithmeticValueNode;
+using document::select::Compare;
+using document::select::CurrentTimeValueNode;
+using document::select::FloatValue;
+using document::select::FloatValueNode;
+using document::select::FunctionOperator;
+using document::select::IntegerValue;
+using document::select::IntegerValueNode;
+using document::select::Operator;
+using document::select::ValueNode;
+using Op = CompiledAttributeCompare::Op;
+
+namespace {
+
+std::optional<Op>
+to_op(const Operator &op) noexcept
+{
+    if (&op == &FunctionOperator::LT)  { return Op::LT; }
+    if (&op == &FunctionOperator::LEQ) { return Op::LEQ; }
+    if (&op == &FunctionOperator::GT)  { return Op::GT; }
+    if (&op == &FunctionOperator::GEQ) { return Op::GEQ; }
+    if (&op == &FunctionOperator::EQ)  { return Op::EQ; }
+    if (&op == &FunctionOperator::NE)  { return Op::NE; }
+    return std::nullopt;
+}
+
+// Op to use when the operands trade places, i.e. "a < b" becomes "b > a".
+Op
+mirrored(Op op) noexcept
+{
+    switch (op) {
+    case Op::LT:  return Op::GT;
+    case Op::LEQ: return Op::GEQ;
+    case Op::GT:  return Op::LT;
+    case Op::GEQ: return Op::LEQ;
+    default:      return op;
+    }
+}
+
+bool
+is_document_independent(const ValueNode &node)
+{
+    if (dynamic_cast<const IntegerValueNode *>(&node) != nullptr ||
+        dynamic_cast<const FloatValueNode *>(&node) != nullptr ||
+        dynamic_cast<const CurrentTimeValueNode *>(&node) != nullptr)
+    {
+        return true;
+    }
+    const auto *arithmetic = dynamic_cast<const ArithmeticValueNode *>(&node);
+    return (arithmetic != nullptr) &&
+           is_document_independent(arithmetic->getLeft()) &&
+           is_document_independent(arithmetic->getRight());
+}
+
+template <typename T>
+bool
+compare(T lhs, Op op, T rhs) noexcept
+{
+    switch (op) {
+    case Op::LT:  return lhs < rhs;
+    case Op::LEQ: return lhs <= rhs;
+    case Op::GT:  return lhs > rhs;
+    case Op::GEQ: return lhs >= rhs;
+    case Op::EQ:  return lhs == rhs;
+    case Op::NE:  return lhs != rhs;
+    }
+    return false;
+}
+
+}
+
+CompiledAttributeCompare::CompiledAttributeCompare(uint32_t attr_guard_index, Op op, int64_t value) noexcept
+    : _attr_guard_index(attr_guard_index),
+      _op(op),
+      _integer(true),
+      _int_value(value),
+      _float_value(value)
+{
+}
+
+CompiledAttributeCompare::CompiledAttributeCompare(uint32_t attr_guard_index, Op op, double value) noexcept
+    : _attr_guard_index(attr_guard_index),
+      _op(op),
+      _integer(false),
+      _int_value(0),
+      _float_value(value)
+{
+}
+
+std::unique_ptr<CompiledAttributeCompare>
+CompiledAttributeCompare::compile(const document::select::Node &node)
+{
+    const auto *cmp = dynamic_cast<const Compare *>(&node);
+    if (cmp == nullptr) {
+        return {};
+    }
+    auto op = to_op(cmp->getOperator());
+    if ( ! op) {
+        return {};
+    }
+    const auto *attr = dynamic_cast<const AttributeFieldValueNode *>(&cmp->getLeft());
+    const ValueNode *other = &cmp->getRight();
+    if (attr == nullptr) {
+        attr = dynamic_cast<const AttributeFieldValueNode *>(&cmp->getRight());
+        other = &cmp->getLeft();
+        op = mirrored(*op);
+    }
+    if ((attr == nullptr) || !is_document_independent(*other)) {
+        return {};
+    }
+    document::select::Context context;
+    auto value = other->getValue(context);
+    if (const auto *int_value = dynamic_cast<const IntegerValue *>(value.get())) {
+        return std::make_unique<CompiledAttributeCompare>(attr->attr_guard_index(), *op, int_value->getValue());
+    }
+    if (const auto *float_value = dynamic_cast<const FloatValue *>(value.get())) {
+        return std::make_unique<CompiledAttributeCompare>(attr->attr_guard_index(), *op, float_value->getValue());
+    }
+    return {};
+}
+
+std::optional<bool>
+CompiledAttributeCompare::matches(const SelectContext &context) const
+{
+    using search::attribute::IAttributeVector;
+    const auto &attr = context.guarded_attribute_at_index(_attr_guard_index);
+    uint32_t docId = context._docId;
+    if (attr.isIntegerType()) {
+        if (attr.isUndefined(docId)) {
+            return std::nullopt;
+        }
+        IAttributeVector::largeint_t value(0);
+        attr.get(docId, &value, 1);
+        return _integer
+            ? compare<int64_t>(value, _op, _int_value)
+            : compare<double>(value, _op, _float_value);
+    }
+    if (attr.isFloatingPointType()) {
+        if (attr.isUndefined(docId)) {
+            return std::nullopt;
+        }
+        double value(0);
+        attr.get(docId, &value, 1);
+        return compare<double>(value, _op, _float_value);
+    }
+    return std::nullopt;
+}
+
+}
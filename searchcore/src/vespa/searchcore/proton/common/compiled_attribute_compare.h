@@ -0,0 +1,48 @@
+// Copyright Vespa.ai. Licensed under the terms of the Apache 2.0 license. See LICENSE in the project root.
+#pragma once
+
+#include <cstdint>
+#include <memory>
+#include <optional>
+
+namespace document::select { class Node; }
+
+namespace proton {
+
+class SelectContext;
+
+/**
+ * Compiled form of a selection expression comparing a single value numeric
+ * attribute against a value that does not depend on the document, e.g.
+ * "music.timestamp < now() - 86400" as typically used for garbage collection.
+ *
+ * The document independent side is evaluated once when compiling, and each
+ * lid is matched by reading the attribute value directly instead of
+ * interpreting the expression tree and allocating values for every lid.
+ */
+class CompiledAttributeCompare {
+public:
+    enum class Op { LT, LEQ, GT, GEQ, EQ, NE };
+private:
+    uint32_t _attr_guard_index;
+    Op       _op;
+    bool     _integer;
+    int64_t  _int_value;
+    double   _float_value;
+public:
+    CompiledAttributeCompare(uint32_t attr_guard_index, Op op, int64_t value) noexcept;
+    CompiledAttributeCompare(uint32_t attr_guard_index, Op op, double value) noexcept;
+
+    /**
+     * Returns nullptr if the expression is not a comparison of the supported form.
+     */
+    static std::unique_ptr<CompiledAttributeCompare> compile(const document::select::Node &node);
+
+    /**
+     * Returns no value when the attribute is not numeric or has no value for
+     * the lid, leaving it to the interpreted expression to decide.
+     */
+    std::optional<bool> matches(const SelectContext &context) const;
+};
+
+}
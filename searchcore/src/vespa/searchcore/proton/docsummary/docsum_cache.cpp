@@ -0,0 +1,101 @@
+// Copyright Vespa.ai. Licensed under the terms of the Apache 2.0 license. See LICENSE in the project root.
+
+#include "docsum_cache.h"
+#include <vespa/vespalib/data/simple_buffer.h>
+#include <vespa/vespalib/data/slime/binary_format.h>
+#include <vespa/vespalib/data/slime/inject.h>
+#include <vespa/vespalib/data/slime/slime.h>
+#include <vespa/vespalib/stllike/cache.hpp>
+
+using vespalib::SimpleBuffer;
+using vespalib::Slime;
+using vespalib::slime::BinaryFormat;
+using vespalib::slime::SlimeInserter;
+
+namespace proton {
+
+namespace {
+
+struct Value {
+    uint32_t                            lid;
+    uint64_t                            timestamp;
+    // binary encoded slime of the docsum
+    std::shared_ptr<const SimpleBuffer> data;
+    Value() noexcept : lid(0), timestamp(0), data() {}
+    Value(uint32_t lid_in, uint64_t timestamp_in, std::shared_ptr<const SimpleBuffer> data_in) noexcept
+        : lid(lid_in), timestamp(timestamp_in), data(std::move(data_in))
+    {}
+};
+
+struct KeyHash {
+    size_t operator() (const DocsumCache::Key &key) const noexcept {
+        return document::GlobalId::hash()(key.gid) ^ std::hash<const void *>()(key.res_class);
+    }
+};
+
+struct ByteSize {
+    size_t operator() (const Value &value) const noexcept { return value.data ? value.data->get().size : 0; }
+};
+
+using CacheParams = vespalib::CacheParam<
+        vespalib::LruParam<DocsumCache::Key, Value, KeyHash>,
+        vespalib::NullStore<DocsumCache::Key, Value>,
+        vespalib::zero<DocsumCache::Key>,
+        ByteSize
+>;
+
+// Nothing is read from or written through to a backing store
+CacheParams::BackingStore null_store;
+
+}
+
+class DocsumCache::Cache : public vespalib::cache<CacheParams> {
+public:
+    explicit Cache(size_t max_bytes) : vespalib::cache<CacheParams>(null_store, max_bytes) { }
+};
+
+DocsumCache::DocsumCache(size_t max_bytes)
+    : _cache(std::make_unique<Cache>(max_bytes))
+{
+}
+
+DocsumCache::~DocsumCache() = default;
+
+bool
+DocsumCache::lookup(const Key &key, uint32_t lid, uint64_t timestamp, Slime &docsum)
+{
+    Value value = _cache->read(key);
+    if ( ! value.data) {
+        return false;
+    }
+    if ((value.lid != lid) || (value.timestamp != timestamp)) {
+        _cache->invalidate(key);
+        return false;
+    }
+    BinaryFormat::decode(value.data->get(), docsum);
+    return true;
+}
+
+void
+DocsumCache::insert(const Key &key, uint32_t lid, uint64_t timestamp, const vespalib::slime::Inspector &docsum)
+{
+    Slime copy;
+    vespalib::slime::inject(docsum, SlimeInserter(copy));
+    auto data = std::make_shared<SimpleBuffer>();
+    BinaryFormat::encode(copy, *data);
+    _cache->write(key, Value(lid, timestamp, std::move(data)));
+}
+
+vespalib::CacheStats
+DocsumCache::get_stats() const
+{
+    return _cache->get_stats();
+}
+
+size_t
+DocsumCache::size_bytes() const
+{
+    return _cache->sizeBytes();
+}
+
+}
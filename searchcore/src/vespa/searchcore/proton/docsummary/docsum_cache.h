@@ -0,0 +1,56 @@
+// Copyright Vespa.ai. Licensed under the terms of the Apache 2.0 license. See LICENSE in the project root.
+#pragma once
+
+#include <vespa/document/base/globalid.h>
+#include <vespa/vespalib/stllike/cache_stats.h>
+#include <memory>
+
+namespace search::docsummary { class ResultClass; }
+namespace vespalib { class Slime; }
+namespace vespalib::slime { struct Inspector; }
+
+namespace proton {
+
+/**
+ * Size bounded cache of rendered document summaries, keyed on global
+ * id and summary class. Each entry remembers the lid and document meta
+ * store timestamp of the document it was rendered from, and is only
+ * used while the document is unchanged. A cache belongs to a single
+ * summary setup, so a new summary config generation starts with an
+ * empty cache.
+ *
+ * Only summary classes without query dependent fields should be
+ * cached, see ResultClass::is_query_dependent().
+ **/
+class DocsumCache {
+public:
+    struct Key {
+        document::GlobalId                         gid;
+        const search::docsummary::ResultClass     *res_class;
+        bool operator==(const Key &rhs) const noexcept {
+            return (gid == rhs.gid) && (res_class == rhs.res_class);
+        }
+    };
+private:
+    class Cache;
+    std::unique_ptr<Cache> _cache;
+public:
+    explicit DocsumCache(size_t max_bytes);
+    DocsumCache(const DocsumCache &) = delete;
+    DocsumCache & operator=(const DocsumCache &) = delete;
+    ~DocsumCache();
+
+    /**
+     * Decode the cached docsum for the given document into 'docsum' if
+     * it was rendered from the document with the given lid and timestamp.
+     * Stale entries are dropped.
+     *
+     * @return true if the docsum was found
+     **/
+    bool lookup(const Key &key, uint32_t lid, uint64_t timestamp, vespalib::Slime &docsum);
+    void insert(const Key &key, uint32_t lid, uint64_t timestamp, const vespalib::slime::Inspector &docsum);
+    vespalib::CacheStats get_stats() const;
+    size_t size_bytes() const;
+};
+
+}
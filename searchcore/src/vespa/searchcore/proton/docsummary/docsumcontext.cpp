@@ -1,14 +1,20 @@
 // Copyright Vespa.ai. Licensed under the terms of the Apache 2.0 license. See LICENSE in the project root.
 #include "docsumcontext.h"
+#include "docsum_cache.h"
 #include <vespa/searchcore/proton/matching/matcher.h>
 #include <vespa/document/datatype/positiondatatype.h>
 #include <vespa/searchlib/queryeval/begin_and_end_id.h>
 #include <vespa/searchlib/attribute/iattributemanager.h>
+#include <vespa/searchlib/common/idocumentmetastore.h>
 #include <vespa/searchlib/common/location.h>
 #include <vespa/searchlib/common/matching_elements.h>
+#include <vespa/vespalib/data/slime/inject.h>
 #include <vespa/vespalib/data/slime/slime.h>
+#include <vespa/vespalib/util/executor.h>
+#include <vespa/vespalib/util/lambdatask.h>
 #include <vespa/vespalib/util/size_literals.h>
 #include <vespa/vespalib/util/stringfmt.h>
+#include <condition_variable>
 
 #include <vespa/log/log.h>
 LOG_SETUP(".proton.docsummary.docsumcontext");
@@ -23,6 +29,7 @@ using vespalib::slime::Cursor;
 using vespalib::slime::Symbol;
 using vespalib::slime::Inserter;
 using vespalib::slime::ObjectSymbolInserter;
+using vespalib::slime::ArrayInserter;
 using vespalib::Slime;
 using vespalib::make_string;
 using namespace search;
@@ -43,8 +50,62 @@ Memory TYPE("type");
 Memory MESSAGE("message");
 Memory TIMEOUT("timeout");
 
+// Number of documents read together from the document store.
+constexpr size_t PREFETCH_BATCH_SIZE = 64;
+
+/**
+ * Hands out chunks to the requesting thread and the helper tasks. Helper
+ * tasks starting after all chunks are handed out do nothing, so the
+ * requesting thread only waits for chunks actually being filled.
+ **/
+class ChunkDispenser {
+    std::mutex              _lock;
+    std::condition_variable _cond;
+    size_t                  _next;
+    size_t                  _num;
+    size_t                  _active;
+public:
+    explicit ChunkDispenser(size_t num) noexcept : _lock(), _cond(), _next(0), _num(num), _active(0) {}
+    bool claim(size_t & idx) {
+        std::lock_guard guard(_lock);
+        if (_next == _num) {
+            return false;
+        }
+        idx = _next++;
+        ++_active;
+        return true;
+    }
+    void done() {
+        std::lock_guard guard(_lock);
+        if ((--_active == 0) && (_next == _num)) {
+            _cond.notify_all();
+        }
+    }
+    void wait() {
+        std::unique_lock guard(_lock);
+        _cond.wait(guard, [this]() { return (_active == 0) && (_next == _num); });
+    }
+};
+
 }
 
+struct DocsumContext::Chunk {
+    size_t                     begin;
+    size_t                     end;
+    GetDocsumsState            state;
+    IDocsumStore::UP           store; // not set when all fields are generated
+    Slime                      slime;
+    uint32_t                   num_ok;
+    Chunk(GetDocsumsStateCallback & callback, size_t begin_in, size_t end_in, IDocsumStore::UP store_in)
+        : begin(begin_in),
+          end(end_in),
+          state(callback),
+          store(std::move(store_in)),
+          slime(),
+          num_ok(0)
+    { }
+};
+
 void
 DocsumContext::initState()
 {
@@ -57,11 +118,139 @@ DocsumContext::initState()
     }
 }
 
+bool
+DocsumContext::useDocsumCache(const ResolveClassInfo & rci, const GetDocsumsState & state) const
+{
+    return (_docsumCache != nullptr) && (_metaStore != nullptr) && (rci.res_class != nullptr) &&
+           !rci.res_class->is_query_dependent() && state._args.get_fields().empty();
+}
+
+void
+DocsumContext::lookupCachedDocsums(const ResolveClassInfo & rci, size_t begin, size_t end,
+                                   std::vector<uint64_t> & timestamps, std::vector<std::unique_ptr<Slime>> & cached)
+{
+    const std::vector<uint32_t> & docIds = _docsumState._docsumbuf;
+    timestamps.assign(end - begin, 0);
+    cached.resize(end - begin);
+    for (size_t i(begin); i < end; i++) {
+        uint32_t docId = docIds[i];
+        if (docId == search::endDocId) {
+            continue;
+        }
+        const document::GlobalId & gid = _request.hits[i].gid;
+        search::DocumentMetaData meta = _metaStore->getMetaData(gid);
+        if (!meta.valid() || (meta.lid != docId)) {
+            continue;
+        }
+        timestamps[i - begin] = meta.timestamp;
+        auto docsum = std::make_unique<Slime>();
+        if (_docsumCache->lookup(DocsumCache::Key{gid, rci.res_class}, docId, meta.timestamp, *docsum)) {
+            cached[i - begin] = std::move(docsum);
+        }
+    }
+}
+
+uint32_t
+DocsumContext::fillDocsums(const ResolveClassInfo & rci, GetDocsumsState & state, IDocsumStore & docsumStore,
+                           size_t begin, size_t end, Cursor & array, const Symbol & docsumSym)
+{
+    const std::vector<uint32_t> & docIds = _docsumState._docsumbuf;
+    const bool prefetch = (rci.res_class != nullptr) && !rci.all_fields_generated;
+    const bool use_cache = useDocsumCache(rci, state);
+    std::vector<uint64_t> timestamps; // of cacheable hits, 0 if not cacheable
+    std::vector<std::unique_ptr<Slime>> cached;
+    if (use_cache) {
+        lookupCachedDocsums(rci, begin, end, timestamps, cached);
+    }
+    std::vector<uint32_t> batch;
+    uint32_t num_ok(0);
+    for (size_t i(begin); i < end; i++) {
+        uint32_t docId = docIds[i];
+        if (_request.expired() ) { break; }
+        if (prefetch && (((i - begin) % PREFETCH_BATCH_SIZE) == 0)) {
+            batch.clear();
+            for (size_t j(i); j < std::min(end, i + PREFETCH_BATCH_SIZE); j++) {
+                if ((docIds[j] != search::endDocId) && !(use_cache && cached[j - begin])) {
+                    batch.push_back(docIds[j]);
+                }
+            }
+            docsumStore.prefetch_documents(batch);
+        }
+        Cursor &docSumC = array.addObject();
+        ObjectSymbolInserter inserter(docSumC, docsumSym);
+        if (use_cache && cached[i - begin]) {
+            vespalib::slime::inject(cached[i - begin]->get(), inserter);
+        } else if ((docId != search::endDocId) && rci.res_class != nullptr) {
+            _docsumWriter.insertDocsum(rci, docId, state, docsumStore, inserter);
+            if (use_cache && (timestamps[i - begin] != 0) && docSumC[docsumSym].valid()) {
+                _docsumCache->insert(DocsumCache::Key{_request.hits[i].gid, rci.res_class}, docId,
+                                     timestamps[i - begin], docSumC[docsumSym]);
+            }
+        }
+        num_ok++;
+    }
+    return num_ok;
+}
+
+void
+DocsumContext::fillChunk(const ResolveClassInfo & rci, Chunk & chunk)
+{
+    chunk.state._args.initFromDocsumRequest(_request);
+    chunk.state._docsumbuf.assign(_docsumState._docsumbuf.begin() + chunk.begin,
+                                  _docsumState._docsumbuf.begin() + chunk.end);
+    chunk.state._omit_summary_features = _docsumState._omit_summary_features;
+    _docsumWriter.initState(_attrMgr, chunk.state, rci);
+    Cursor & array = chunk.slime.setArray();
+    IDocsumStore & store = chunk.store ? *chunk.store : *_docsumStore;
+    chunk.num_ok = fillDocsums(rci, chunk.state, store, chunk.begin, chunk.end,
+                               array, chunk.slime.insert(DOCSUM));
+}
+
+uint32_t
+DocsumContext::fillDocsumsParallel(const ResolveClassInfo & rci, size_t hitsPerTask, Cursor & array, const Symbol & docsumSym)
+{
+    const size_t numHits = _docsumState._docsumbuf.size();
+    std::vector<std::unique_ptr<Chunk>> chunks;
+    for (size_t begin(0); begin < numHits; begin += hitsPerTask) {
+        // The document store is never used when all fields are generated (e.g. attribute only summary classes)
+        auto store = rci.all_fields_generated ? IDocsumStore::UP() : _summarySetup.createDocsumStore();
+        chunks.push_back(std::make_unique<Chunk>(*this, begin, std::min(numHits, begin + hitsPerTask), std::move(store)));
+    }
+    auto dispenser = std::make_shared<ChunkDispenser>(chunks.size());
+    auto fill = [this, &rci, &chunks](ChunkDispenser & work) {
+        size_t idx;
+        while (work.claim(idx)) {
+            fillChunk(rci, *chunks[idx]);
+            work.done();
+        }
+    };
+    vespalib::Executor & executor = _summarySetup.get_docsum_executor();
+    for (size_t i(1); i < chunks.size(); i++) {
+        // Rejected tasks are ignored, the chunks are then filled by this thread.
+        executor.execute(vespalib::makeLambdaTask([dispenser, fill]() { fill(*dispenser); }));
+    }
+    fill(*dispenser);
+    dispenser->wait();
+    uint32_t num_ok(0);
+    for (const auto & chunk : chunks) {
+        const auto & docsums = chunk->slime.get();
+        for (size_t i(0); i < chunk->num_ok; i++) {
+            Cursor & docSumC = array.addObject();
+            vespalib::slime::inject(docsums[i][DOCSUM], ObjectSymbolInserter(docSumC, docsumSym));
+        }
+        num_ok += chunk->num_ok;
+        if (chunk->num_ok != (chunk->end - chunk->begin)) {
+            break; // timed out, keep the docsums in front of the first missing one
+        }
+    }
+    return num_ok;
+}
+
 vespalib::Slime::UP
 DocsumContext::createSlimeReply()
 {
-    IDocsumWriter::ResolveClassInfo rci = _docsumWriter.resolveClassInfo(_docsumState._args.getResultClassName(),
-                                                                         _docsumState._args.get_fields());
+    ResolveClassInfo rci = _docsumWriter.resolveClassInfo(_docsumState._args.getResultClassName(),
+                                                          _docsumState._args.get_fields());
     _docsumWriter.initState(_attrMgr, _docsumState, rci);
     const size_t estimatedChunkSize(std::min(0x200000ul, _docsumState._docsumbuf.size()*0x400ul));
     auto response = std::make_unique<vespalib::Slime>(Slime::Params(estimatedChunkSize));
@@ -69,15 +258,15 @@ DocsumContext::createSlimeReply()
     Cursor & array = root.setArray(DOCSUMS);
     const Symbol docsumSym = response->insert(DOCSUM);
     _docsumState._omit_summary_features = (rci.res_class == nullptr) || rci.res_class->omit_summary_features();
+    const size_t hitsPerTask = (_matcher && (rci.res_class != nullptr))
+                               ? _matcher->get_summary_hits_per_task(_request.propertiesMap.rankProperties())
+                               : 0;
     uint32_t num_ok(0);
-    for (uint32_t docId : _docsumState._docsumbuf) {
-        if (_request.expired() ) { break; }
-        Cursor &docSumC = array.addObject();
-        ObjectSymbolInserter inserter(docSumC, docsumSym);
-        if ((docId != search::endDocId) && rci.res_class != nullptr) {
-            _docsumWriter.insertDocsum(rci, docId, _docsumState, _docsumStore, inserter);
-        }
-        num_ok++;
+    if ((hitsPerTask > 0) && (_docsumState._docsumbuf.size() > hitsPerTask)) {
+        _parallel = true;
+        num_ok = fillDocsumsParallel(rci, hitsPerTask, array, docsumSym);
+    } else {
+        num_ok = fillDocsums(rci, _docsumState, *_docsumStore, 0, _docsumState._docsumbuf.size(), array, docsumSym);
     }
     if (num_ok != _docsumState._docsumbuf.size()) {
         const uint32_t numTimedOut = _docsumState._docsumbuf.size() - num_ok;
@@ -90,23 +279,34 @@ DocsumContext::createSlimeReply()
     return response;
 }
 
-DocsumContext::DocsumContext(const DocsumRequest & request, IDocsumWriter & docsumWriter,
-                             IDocsumStore & docsumStore, std::shared_ptr<Matcher> matcher,
+DocsumContext::DocsumContext(const DocsumRequest & request, ISummaryManager::ISummarySetup & summarySetup,
+                             std::shared_ptr<Matcher> matcher,
                              ISearchContext & searchCtx, IAttributeContext & attrCtx,
-                             const IAttributeManager & attrMgr, SessionManager & sessionMgr) :
+                             const IAttributeManager & attrMgr, SessionManager & sessionMgr,
+                             const search::IDocumentMetaStore * metaStore) :
     _request(request),
-    _docsumWriter(docsumWriter),
-    _docsumStore(docsumStore),
+    _summarySetup(summarySetup),
+    _docsumWriter(summarySetup.getDocsumWriter()),
+    _docsumStore(summarySetup.createDocsumStore()),
     _matcher(std::move(matcher)),
     _searchCtx(searchCtx),
     _attrCtx(attrCtx),
     _attrMgr(attrMgr),
     _docsumState(*this),
-    _sessionMgr(sessionMgr)
+    _sessionMgr(sessionMgr),
+    _metaStore(metaStore),
+    _docsumCache(summarySetup.get_docsum_cache()),
+    _lock(),
+    _parallel(false),
+    _summaryFeatures(),
+    _rankFeatures(),
+    _matching_elements()
 {
     initState();
 }
 
+DocsumContext::~DocsumContext() = default;
+
 DocsumReply::UP
 DocsumContext::getDocsums()
 {
@@ -116,9 +316,12 @@ DocsumContext::getDocsums()
 void
 DocsumContext::fillSummaryFeatures(search::docsummary::GetDocsumsState& state)
 {
-    assert(&_docsumState == &state);
     if (_matcher->canProduceSummaryFeatures()) {
-        state._summaryFeatures = _matcher->getSummaryFeatures(_request, _searchCtx, _attrCtx, _sessionMgr);
+        std::lock_guard guard(_lock);
+        if ( ! _summaryFeatures) {
+            _summaryFeatures = _matcher->getSummaryFeatures(_request, _searchCtx, _attrCtx, _sessionMgr);
+        }
+        state._summaryFeatures = _summaryFeatures;
     }
     state._summaryFeaturesCached = false;
 }
@@ -126,19 +329,29 @@ DocsumContext::fillSummaryFeatures(search::docsummary::GetDocsumsState& state)
 void
 DocsumContext::fillRankFeatures(search::docsummary::GetDocsumsState& state)
 {
-    assert(&_docsumState == &state);
     // check if we are allowed to run
     if ( ! state._args.dumpFeatures()) {
         return;
     }
-    state._rankFeatures = _matcher->getRankFeatures(_request, _searchCtx, _attrCtx, _sessionMgr);
+    std::lock_guard guard(_lock);
+    if ( ! _rankFeatures) {
+        _rankFeatures = _matcher->getRankFeatures(_request, _searchCtx, _attrCtx, _sessionMgr);
+    }
+    state._rankFeatures = _rankFeatures;
 }
 
 std::unique_ptr<MatchingElements>
 DocsumContext::fill_matching_elements(const MatchingElementsFields &fields)
 {
     if (_matcher) {
-        return _matcher->get_matching_elements(_request, _searchCtx, _attrCtx, _sessionMgr, fields);
+        if ( ! _parallel) {
+            return _matcher->get_matching_elements(_request, _searchCtx, _attrCtx, _sessionMgr, fields);
+        }
+        std::lock_guard guard(_lock);
+        if ( ! _matching_elements) {
+            _matching_elements = _matcher->get_matching_elements(_request, _searchCtx, _attrCtx, _sessionMgr, fields);
+        }
+        return std::make_unique<MatchingElements>(*_matching_elements);
     }
     return std::make_unique<MatchingElements>();
 }
@@ -1,14 +1,25 @@
 // Copyright Vespa.ai. Licensed under the terms of the Apache 2.0 license. See LICENSE in the project root.
 #pragma once
 
+#include "isummarymanager.h"
 #include <vespa/searchsummary/docsummary/docsumstate.h>
 #include <vespa/searchsummary/docsummary/docsumstore.h>
 #include <vespa/searchsummary/docsummary/docsumwriter.h>
 #include <vespa/searchlib/engine/docsumrequest.h>
 #include <vespa/searchlib/engine/docsumreply.h>
+#include <mutex>
+
+namespace search { struct IDocumentMetaStore; }
+namespace vespalib { class Slime; }
+namespace vespalib::slime {
+    struct Cursor;
+    class Symbol;
+}
 
 namespace proton {
 
+class DocsumCache;
+
 namespace matching {
     class Matcher;
     class ISearchContext;
@@ -18,33 +29,67 @@ namespace matching {
 /**
  * The DocsumContext class is responsible for performing a docsum request and
  * creating a docsum reply.
+ *
+ * When the hits per task for the rank profile is set and the request has more
+ * hits than that, the hit list is split into chunks filled in parallel using the
+ * docsum executor of the summary setup. Each chunk has its own state and document
+ * store, and writes its docsums into a separate slime which is copied into the
+ * reply in hit order. The requesting thread fills chunks as well, so progress
+ * does not depend on the executor having idle threads.
+ *
+ * When the summary setup has a docsum cache and the summary class has no query
+ * dependent fields, docsums are served from the cache as long as the document
+ * meta store timestamp of the hit is unchanged, and rendered docsums are added
+ * to the cache.
  **/
 class DocsumContext : public search::docsummary::GetDocsumsStateCallback {
 private:
+    struct Chunk;
+    using ResolveClassInfo = search::docsummary::IDocsumWriter::ResolveClassInfo;
+
     const search::engine::DocsumRequest  & _request;
+    ISummaryManager::ISummarySetup       & _summarySetup;
     search::docsummary::IDocsumWriter    & _docsumWriter;
-    search::docsummary::IDocsumStore     & _docsumStore;
+    search::docsummary::IDocsumStore::UP   _docsumStore;
     std::shared_ptr<matching::Matcher>     _matcher;
     matching::ISearchContext             & _searchCtx;
     search::attribute::IAttributeContext & _attrCtx;
     const search::IAttributeManager      & _attrMgr;
     search::docsummary::GetDocsumsState    _docsumState;
     matching::SessionManager             & _sessionMgr;
+    const search::IDocumentMetaStore     * _metaStore;
+    DocsumCache                          * _docsumCache;
+    // features and matching elements are calculated once and shared between chunk states
+    std::mutex                                  _lock;
+    bool                                        _parallel;
+    std::shared_ptr<vespalib::FeatureSet>       _summaryFeatures;
+    std::shared_ptr<vespalib::FeatureSet>       _rankFeatures;
+    std::unique_ptr<search::MatchingElements>   _matching_elements;
 
     void initState();
+    bool useDocsumCache(const ResolveClassInfo & rci, const search::docsummary::GetDocsumsState & state) const;
+    void lookupCachedDocsums(const ResolveClassInfo & rci, size_t begin, size_t end, std::vector<uint64_t> & timestamps,
+                             std::vector<std::unique_ptr<vespalib::Slime>> & cached);
+    uint32_t fillDocsums(const ResolveClassInfo & rci, search::docsummary::GetDocsumsState & state,
+                         search::docsummary::IDocsumStore & docsumStore, size_t begin, size_t end,
+                         vespalib::slime::Cursor & array, const vespalib::slime::Symbol & docsumSym);
+    uint32_t fillDocsumsParallel(const ResolveClassInfo & rci, size_t hitsPerTask,
+                                 vespalib::slime::Cursor & array, const vespalib::slime::Symbol & docsumSym);
+    void fillChunk(const ResolveClassInfo & rci, Chunk & chunk);
     std::unique_ptr<vespalib::Slime> createSlimeReply();
 
 public:
     using UP = std::unique_ptr<DocsumContext>;
 
     DocsumContext(const search::engine::DocsumRequest & request,
-                  search::docsummary::IDocsumWriter & docsumWriter,
-                  search::docsummary::IDocsumStore & docsumStore,
+                  ISummaryManager::ISummarySetup & summarySetup,
                   std::shared_ptr<matching::Matcher> matcher,
                   matching::ISearchContext & searchCtx,
                   search::attribute::IAttributeContext & attrCtx,
                   const search::IAttributeManager & attrMgr,
-                  matching::SessionManager & sessionMgr);
+                  matching::SessionManager & sessionMgr,
+                  const search::IDocumentMetaStore * metaStore = nullptr);
+    ~DocsumContext() override;
 
     search::engine::DocsumReply::UP getDocsums();
 
@@ -26,7 +26,10 @@ DocumentStoreAdapter::
 DocumentStoreAdapter(const search::IDocumentStore & docStore,
                      const DocumentTypeRepo &repo)
     : _docStore(docStore),
-      _repo(repo)
+      _repo(repo),
+      _prefetchedIds(),
+      _prefetched(),
+      _nextPrefetched(0)
 {
 }
 
@@ -35,7 +38,12 @@ DocumentStoreAdapter::~DocumentStoreAdapter() = default;
 std::unique_ptr<const IDocsumStoreDocument>
 DocumentStoreAdapter::get_document(uint32_t docId)
 {
-    auto document = _docStore.read(docId, _repo);
+    search::IDocumentStore::DocumentUP document;
+    if ((_nextPrefetched < _prefetched.size()) && (_prefetchedIds[_nextPrefetched] == docId)) {
+        document = std::move(_prefetched[_nextPrefetched++]);
+    } else {
+        document = _docStore.read(docId, _repo);
+    }
     if ( ! document) {
         LOG(debug, "Did not find summary document for docId %u. Returning empty docsum", docId);
         return {};
@@ -44,4 +52,12 @@ DocumentStoreAdapter::get_document(uint32_t docId)
     return std::make_unique<DocsumStoreDocument>(std::move(document));
 }
 
+void
+DocumentStoreAdapter::prefetch_documents(const std::vector<uint32_t> &docIds)
+{
+    _prefetchedIds = docIds;
+    _prefetched = _docStore.read_batch(docIds, _repo);
+    _nextPrefetched = 0;
+}
+
 } // namespace proton
@@ -12,6 +12,9 @@ class DocumentStoreAdapter : public search::docsummary::IDocsumStore
 private:
     const search::IDocumentStore           & _docStore;
     const document::DocumentTypeRepo       & _repo;
+    std::vector<uint32_t>                    _prefetchedIds;
+    std::vector<search::IDocumentStore::DocumentUP> _prefetched;
+    size_t                                   _nextPrefetched;
 
 public:
     DocumentStoreAdapter(const search::IDocumentStore &docStore,
@@ -19,6 +22,7 @@ public:
     ~DocumentStoreAdapter();
 
     std::unique_ptr<const search::docsummary::IDocsumStoreDocument> get_document(uint32_t docId) override;
+    void prefetch_documents(const std::vector<uint32_t> &docIds) override;
 };
 
 } // namespace proton
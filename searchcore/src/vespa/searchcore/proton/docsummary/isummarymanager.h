@@ -10,9 +10,12 @@
 
 namespace document { class DocumentTypeRepo; }
 namespace search::index { class Schema; }
+namespace vespalib { class Executor; }
 
 namespace proton {
 
+class DocsumCache;
+
 /**
  * Interface for a summary manager.
  */
@@ -36,6 +39,15 @@ public:
         virtual search::docsummary::IDocsumWriter &getDocsumWriter() const = 0;
         virtual const search::docsummary::ResultConfig &getResultConfig() = 0;
         virtual search::docsummary::IDocsumStore::UP createDocsumStore() = 0;
+        /**
+         * Executor used to fill the docsums of a single request in parallel.
+         */
+        virtual vespalib::Executor &get_docsum_executor() const = 0;
+        /**
+         * Cache of rendered docsums for summary classes without query dependent fields.
+         * nullptr if disabled.
+         */
+        virtual DocsumCache *get_docsum_cache() const = 0;
     };
 
     using UP = std::unique_ptr<ISummaryManager>;
@@ -1,6 +1,7 @@
 // Copyright Vespa.ai. Licensed under the terms of the Apache 2.0 license. See LICENSE in the project root.
 
 #include "summarymanager.h"
+#include "docsum_cache.h"
 #include "documentstoreadapter.h"
 #include "summarycompacttarget.h"
 #include "summaryflushtarget.h"
@@ -84,14 +85,17 @@ SummarySetup(const vespalib::string & baseDir, const SummaryConfig & summaryCfg,
              const JuniperrcConfig & juniperCfg,
              search::IAttributeManager::SP attributeMgr, search::IDocumentStore::SP docStore,
              std::shared_ptr<const DocumentTypeRepo> repo,
-             const search::index::Schema& schema)
+             const search::index::Schema& schema,
+             vespalib::Executor &docsum_executor)
     : _docsumWriter(),
       _wordFolder(std::make_unique<Fast_NormalizeWordFolder>()),
       _juniperProps(juniperCfg),
       _juniperConfig(),
       _attributeMgr(std::move(attributeMgr)),
       _docStore(std::move(docStore)),
-      _repo(std::move(repo))
+      _repo(std::move(repo)),
+      _docsum_executor(docsum_executor),
+      _docsum_cache()
 {
     _juniperConfig = std::make_unique<juniper::Juniper>(&_juniperProps, _wordFolder.get());
     auto resultConfig = std::make_unique<ResultConfig>();
@@ -109,8 +113,13 @@ SummarySetup(const vespalib::string & baseDir, const SummaryConfig & summaryCfg,
     docsum_field_writer_factory.reset();
 
     _docsumWriter = std::make_unique<DynamicDocsumWriter>(std::move(resultConfig));
+    if (summaryCfg.renderedcache.maxbytes > 0) {
+        _docsum_cache = std::make_unique<DocsumCache>(summaryCfg.renderedcache.maxbytes);
+    }
 }
 
+SummaryManager::SummarySetup::~SummarySetup() = default;
+
 IDocsumStore::UP
 SummaryManager::SummarySetup::createDocsumStore()
 {
@@ -125,7 +134,7 @@ SummaryManager::createSummarySetup(const SummaryConfig & summaryCfg,
                                    const search::index::Schema& schema)
 {
     return std::make_shared<SummarySetup>(_baseDir, summaryCfg,
-                                          juniperCfg, attributeMgr, _docStore, repo, schema);
+                                          juniperCfg, attributeMgr, _docStore, repo, schema, _shared_executor);
 }
 
 SummaryManager::SummaryManager(vespalib::Executor &shared_executor, const LogDocumentStore::Config & storeConfig,
@@ -134,7 +143,8 @@ SummaryManager::SummaryManager(vespalib::Executor &shared_executor, const LogDoc
                                const FileHeaderContext &fileHeaderContext, search::transactionlog::SyncProxy &tlSyncer,
                                search::IBucketizer::SP bucketizer)
     : _baseDir(baseDir),
-      _docStore()
+      _docStore(),
+      _shared_executor(shared_executor)
 {
     _docStore = std::make_shared<LogDocumentStore>(shared_executor, baseDir, storeConfig, growStrategy, tuneFileSummary,
                                                    fileHeaderContext, tlSyncer, std::move(bucketizer));
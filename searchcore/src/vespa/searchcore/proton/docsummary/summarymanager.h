@@ -29,6 +29,8 @@ public:
         search::IAttributeManager::SP         _attributeMgr;
         search::IDocumentStore::SP            _docStore;
         const std::shared_ptr<const document::DocumentTypeRepo>  _repo;
+        vespalib::Executor                   &_docsum_executor;
+        std::unique_ptr<DocsumCache>          _docsum_cache;
     public:
         SummarySetup(const vespalib::string & baseDir,
                      const SummaryConfig & summaryCfg,
@@ -36,12 +38,16 @@ public:
                      search::IAttributeManager::SP attributeMgr,
                      search::IDocumentStore::SP docStore,
                      std::shared_ptr<const document::DocumentTypeRepo> repo,
-                     const search::index::Schema& schema);
+                     const search::index::Schema& schema,
+                     vespalib::Executor &docsum_executor);
+        ~SummarySetup() override;
 
         search::docsummary::IDocsumWriter & getDocsumWriter() const override { return *_docsumWriter; }
         const search::docsummary::ResultConfig & getResultConfig() override { return *_docsumWriter->GetResultConfig(); }
 
         search::docsummary::IDocsumStore::UP createDocsumStore() override;
+        vespalib::Executor &get_docsum_executor() const override { return _docsum_executor; }
+        DocsumCache *get_docsum_cache() const override { return _docsum_cache.get(); }
 
         const search::IAttributeManager * getAttributeManager() const override { return _attributeMgr.get(); }
         const juniper::Juniper * getJuniper() const override { return _juniperConfig.get(); }
@@ -50,6 +56,7 @@ public:
 private:
     vespalib::string               _baseDir;
     std::shared_ptr<search::IDocumentStore> _docStore;
+    vespalib::Executor            &_shared_executor;
 
 public:
     using SP = std::shared_ptr<SummaryManager>;
@@ -0,0 +1,43 @@
+// Copyright Vespa.ai. Licensed under the terms of the Apache 2.0 license. See LICENSE in the project root.
+
+#pragma once
+
+#include <cstdint>
+#include <tuple>
+
+namespace proton::documentmetastore {
+
+/*
+ * Key in the optional bucket timestamp index of the document meta store.
+ * Entries are ordered by bucket (the bucket id with unused bits stripped,
+ * i.e. including the number of used bits), then by timestamp and lid,
+ * so all documents in a bucket within a timestamp range are adjacent.
+ */
+class BucketTimestampKey {
+    uint64_t _bucket;
+    uint64_t _timestamp;
+    uint32_t _lid;
+
+public:
+    BucketTimestampKey() noexcept
+        : _bucket(0u),
+          _timestamp(0u),
+          _lid(0u)
+    {
+    }
+    BucketTimestampKey(uint64_t bucket, uint64_t timestamp, uint32_t lid) noexcept
+        : _bucket(bucket),
+          _timestamp(timestamp),
+          _lid(lid)
+    {
+    }
+
+    uint64_t get_bucket() const noexcept { return _bucket; }
+    uint64_t get_timestamp() const noexcept { return _timestamp; }
+    uint32_t get_lid() const noexcept { return _lid; }
+    bool operator<(const BucketTimestampKey &rhs) const noexcept {
+        return std::tie(_bucket, _timestamp, _lid) < std::tie(rhs._bucket, rhs._timestamp, rhs._lid);
+    }
+};
+
+}
@@ -5,6 +5,7 @@
 #include "operation_listener.h"
 #include "search_context.h"
 #include "document_meta_store_versions.h"
+#include "gid_hash_comparator.h"
 #include <vespa/searchcore/proton/bucketdb/bucketsessionbase.h>
 #include <vespa/searchcore/proton/bucketdb/joinbucketssession.h>
 #include <vespa/searchcore/proton/bucketdb/remove_batch_entry.h>
@@ -23,6 +24,7 @@
 #include <vespa/vespalib/btree/btreenodestore.hpp>
 #include <vespa/vespalib/btree/btreeroot.hpp>
 #include <vespa/vespalib/datastore/buffer_type.hpp>
+#include <vespa/vespalib/datastore/sharded_hash_map.h>
 #include <vespa/vespalib/util/exceptions.h>
 #include <vespa/vespalib/util/rcuvector.hpp>
 #include <vespa/fastos/file.h>
@@ -34,6 +36,8 @@ using document::BucketId;
 using document::GlobalId;
 using proton::bucketdb::BucketState;
 using proton::bucketdb::RemoveBatchEntry;
+using proton::documentmetastore::BucketTimestampKey;
+using proton::documentmetastore::GidHashComparator;
 using proton::documentmetastore::GidToLidMapKey;
 using search::AttributeVector;
 using search::FileReader;
@@ -53,6 +57,8 @@ using vespalib::GenerationHeldBase;
 using vespalib::IllegalStateException;
 using vespalib::MemoryUsage;
 using vespalib::btree::BTreeNoLeafData;
+using vespalib::datastore::EntryRef;
+using vespalib::datastore::ShardedHashMap;
 using vespalib::make_string;
 
 namespace proton {
@@ -182,6 +188,11 @@ DocumentMetaStore::insert(GidToLidMapKey key, const RawDocumentMetaData &metaDat
     ensureSpace(lid);
     _metaDataStore[lid] = metaData;
     _gidToLidMap.insert(_gid_to_lid_map_write_itr, key, BTreeNoLeafData());
+    if (_gidToLidHash) {
+        std::function<EntryRef(void)> insert_entry([lid]() { return EntryRef(lid); });
+        _gidToLidHash->add(_gidToLidHash->get_default_comparator(), EntryRef(lid), insert_entry);
+    }
+    add_to_bucket_timestamp_index(lid);
     // flush writes to meta store rcu vector before new entry is visible
     // from frozen root or lid based scan
     std::atomic_thread_fence(std::memory_order_release);
@@ -198,12 +209,65 @@ DocumentMetaStore::insert(GidToLidMapKey key, const RawDocumentMetaData &metaDat
     updateCommittedDocIdLimit();
 }
 
+std::unique_ptr<ShardedHashMap>
+DocumentMetaStore::make_gid_to_lid_hash() const
+{
+    return std::make_unique<ShardedHashMap>(std::make_unique<GidHashComparator>(_metaDataStore));
+}
+
+DocumentMetaStore::DocId
+DocumentMetaStore::find_lid_in_hash(const GlobalId &gid) const
+{
+    GidHashComparator comp(_metaDataStore, gid);
+    auto kv = static_cast<const ShardedHashMap &>(*_gidToLidHash).find(comp, EntryRef());
+    return (kv != nullptr) ? kv->first.load_acquire().ref() : 0u;
+}
+
+void
+DocumentMetaStore::remove_from_hash(DocId lid)
+{
+    if (_gidToLidHash) {
+        auto kv = _gidToLidHash->remove(_gidToLidHash->get_default_comparator(), EntryRef(lid));
+        assert(kv != nullptr && kv->first.load_relaxed().ref() == lid);
+        (void) kv;
+    }
+}
+
+BucketTimestampKey
+DocumentMetaStore::make_bucket_timestamp_key(DocId lid, const RawDocumentMetaData &metaData) noexcept
+{
+    return {metaData.getBucketId().getId(), metaData.getTimestamp().getValue(), lid};
+}
+
+void
+DocumentMetaStore::add_to_bucket_timestamp_index(DocId lid)
+{
+    if (_bucketTimestampIndex) {
+        bool inserted = _bucketTimestampIndex->insert(make_bucket_timestamp_key(lid, _metaDataStore[lid]), BTreeNoLeafData());
+        assert(inserted);
+        (void) inserted;
+    }
+}
+
+void
+DocumentMetaStore::remove_from_bucket_timestamp_index(DocId lid)
+{
+    if (_bucketTimestampIndex) {
+        bool removed = _bucketTimestampIndex->remove(make_bucket_timestamp_key(lid, _metaDataStore[lid]));
+        assert(removed);
+        (void) removed;
+    }
+}
+
 bool
 DocumentMetaStore::consider_compact_gid_to_lid_map()
 {
     if (_gidToLidMap.getAllocator().getNodeStore().has_held_buffers()) {
         return false;
     }
+    if (_bucketTimestampIndex && _bucketTimestampIndex->getAllocator().getNodeStore().has_held_buffers()) {
+        return false;
+    }
     return _should_compact_gid_to_lid_map;
 }
 
@@ -214,6 +278,9 @@ DocumentMetaStore::onCommit()
         incGeneration();
         _changesSinceCommit = 0;
         _gidToLidMap.compact_worst(getConfig().getCompactionStrategy());
+        if (_bucketTimestampIndex) {
+            _bucketTimestampIndex->compact_worst(getConfig().getCompactionStrategy());
+        }
         _gid_to_lid_map_write_itr_prepare_serial_num = 0u;
         _gid_to_lid_map_write_itr.begin(_gidToLidMap.getRoot());
         incGeneration();
@@ -234,6 +301,15 @@ DocumentMetaStore::onUpdateStat()
     auto gid_to_lid_map_memory_usage = _gidToLidMap.getMemoryUsage();
     _should_compact_gid_to_lid_map = compaction_strategy.should_compact_memory(gid_to_lid_map_memory_usage);
     usage.merge(gid_to_lid_map_memory_usage);
+    if (_gidToLidHash) {
+        usage.merge(_gidToLidHash->get_memory_usage());
+    }
+    if (_bucketTimestampIndex) {
+        auto bucket_timestamp_index_memory_usage = _bucketTimestampIndex->getMemoryUsage();
+        _should_compact_gid_to_lid_map = _should_compact_gid_to_lid_map ||
+                                         compaction_strategy.should_compact_memory(bucket_timestamp_index_memory_usage);
+        usage.merge(bucket_timestamp_index_memory_usage);
+    }
     // the free lists are not taken into account here
     updateStatistics(_metaDataStore.size(),
                      _metaDataStore.size(),
@@ -248,6 +324,13 @@ DocumentMetaStore::before_inc_generation(generation_t current_gen)
 {
     _gidToLidMap.getAllocator().freeze();
     _gidToLidMap.getAllocator().assign_generation(current_gen);
+    if (_gidToLidHash) {
+        _gidToLidHash->assign_generation(current_gen);
+    }
+    if (_bucketTimestampIndex) {
+        _bucketTimestampIndex->getAllocator().freeze();
+        _bucketTimestampIndex->getAllocator().assign_generation(current_gen);
+    }
     getGenerationHolder().assign_generation(current_gen);
     updateStat(false);
 }
@@ -256,6 +339,12 @@ void
 DocumentMetaStore::reclaim_memory(generation_t oldest_used_gen)
 {
     _gidToLidMap.getAllocator().reclaim_memory(oldest_used_gen);
+    if (_gidToLidHash) {
+        _gidToLidHash->reclaim_memory(oldest_used_gen);
+    }
+    if (_bucketTimestampIndex) {
+        _bucketTimestampIndex->getAllocator().reclaim_memory(oldest_used_gen);
+    }
     _lidAlloc.reclaim_memory(oldest_used_gen);
     getGenerationHolder().reclaim(oldest_used_gen);
 }
@@ -281,6 +370,10 @@ DocumentMetaStore::readNextDoc(documentmetastore::Reader & reader, TreeType::Bui
     meta.setDocSize(reader.getNextDocSize());
     meta.setTimestamp(reader.getNextTimestamp());
     treeBuilder.insert(GidToLidMapKey(lid, meta.getGid()), BTreeNoLeafData());
+    if (_gidToLidHash) {
+        std::function<EntryRef(void)> insert_entry([lid]() { return EntryRef(lid); });
+        _gidToLidHash->add(_gidToLidHash->get_default_comparator(), EntryRef(lid), insert_entry);
+    }
     assert(!validLid(lid));
     _lidAlloc.registerLid(lid);
     return lid;
@@ -291,6 +384,9 @@ DocumentMetaStore::onLoad(vespalib::Executor *)
 {
     documentmetastore::Reader reader(LoadUtils::openDAT(*this));
     unload();
+    if (_gidToLidHash) {
+        _gidToLidHash = make_gid_to_lid_hash();
+    }
     size_t numElems = reader.getNumElems();
     size_t docIdLimit = reader.getDocIdLimit();
     _metaDataStore.unsafe_reserve(std::max(numElems, docIdLimit));
@@ -298,6 +394,10 @@ DocumentMetaStore::onLoad(vespalib::Executor *)
     assert(docIdLimit > 0); // lid 0 is reserved
     ensureSpace(docIdLimit - 1);
 
+    std::vector<BucketTimestampKey> bucketTimestampKeys;
+    if (_bucketTimestampIndex) {
+        bucketTimestampKeys.reserve(numElems);
+    }
     // insert gids (already sorted)
     if (numElems > 0) {
         DocId lid = readNextDoc(reader, treeBuilder);
@@ -305,9 +405,15 @@ DocumentMetaStore::onLoad(vespalib::Executor *)
         BucketId prevId(meta->getBucketId());
         BucketState state;
         state.add(meta->getGid(), meta->getTimestamp(), meta->getDocSize(), _subDbType);
+        if (_bucketTimestampIndex) {
+            bucketTimestampKeys.push_back(make_bucket_timestamp_key(lid, *meta));
+        }
         for (size_t i = 1; i < numElems; ++i) {
             lid = readNextDoc(reader, treeBuilder);
             meta = &_metaDataStore[lid];
+            if (_bucketTimestampIndex) {
+                bucketTimestampKeys.push_back(make_bucket_timestamp_key(lid, *meta));
+            }
             BucketId bucketId = meta->getBucketId();
             if (prevId != bucketId) {
                 _bucketDB->takeGuard()->add(prevId, state);
@@ -322,6 +428,16 @@ DocumentMetaStore::onLoad(vespalib::Executor *)
     _gidToLidMap.getAllocator().freeze(); // create initial frozen tree
     generation_t generation = getGenerationHandler().getCurrentGeneration();
     _gidToLidMap.getAllocator().assign_generation(generation);
+    if (_bucketTimestampIndex) {
+        std::sort(bucketTimestampKeys.begin(), bucketTimestampKeys.end());
+        BucketTimestampIndex::Builder indexBuilder(_bucketTimestampIndex->getAllocator());
+        for (const auto &key : bucketTimestampKeys) {
+            indexBuilder.insert(key, BTreeNoLeafData());
+        }
+        _bucketTimestampIndex->assign(indexBuilder);
+        _bucketTimestampIndex->getAllocator().freeze();
+        _bucketTimestampIndex->getAllocator().assign_generation(generation);
+    }
 
     setNumDocs(_metaDataStore.size());
     setCommittedDocIdLimit(_metaDataStore.size());
@@ -357,6 +473,7 @@ DocumentMetaStore::updateMetaDataAndBucketDB(const GlobalId &gid,
                                              const RawDocumentMetaData &newMetaData)
 {
     RawDocumentMetaData &oldMetaData = _metaDataStore[lid];
+    remove_from_bucket_timestamp_index(lid);
     _bucketDB->takeGuard()->modify(gid,
                      oldMetaData.getBucketId().stripUnused(),
                      oldMetaData.getTimestamp(), oldMetaData.getDocSize(),
@@ -367,6 +484,7 @@ DocumentMetaStore::updateMetaDataAndBucketDB(const GlobalId &gid,
     oldMetaData.setDocSize(newMetaData.getDocSize());
     std::atomic_thread_fence(std::memory_order_release);
     oldMetaData.setTimestamp(newMetaData.getTimestamp());
+    add_to_bucket_timestamp_index(lid);
 }
 
 
@@ -417,10 +535,14 @@ DocumentMetaStore::DocumentMetaStore(BucketDBOwnerSP bucketDB, const vespalib::s
 DocumentMetaStore::DocumentMetaStore(BucketDBOwnerSP bucketDB,
                                      const vespalib::string &name,
                                      const GrowStrategy &grow,
-                                     SubDbType subDbType)
+                                     SubDbType subDbType,
+                                     bool gidHashIndex,
+                                     bool bucketTimestampIndex)
     : DocumentMetaStoreAttribute(name),
       _metaDataStore(grow, getGenerationHolder()),
       _gidToLidMap(),
+      _gidToLidHash(),
+      _bucketTimestampIndex(),
       _gid_to_lid_map_write_itr(vespalib::datastore::EntryRef(), _gidToLidMap.getAllocator()),
       _gid_to_lid_map_write_itr_prepare_serial_num(0u),
       _lidAlloc(_metaDataStore.size(), _metaDataStore.capacity(), getGenerationHolder()),
@@ -432,6 +554,14 @@ DocumentMetaStore::DocumentMetaStore(BucketDBOwnerSP bucketDB,
       _op_listener(),
       _should_compact_gid_to_lid_map(false)
 {
+    if (gidHashIndex) {
+        _gidToLidHash = make_gid_to_lid_hash();
+    }
+    if (bucketTimestampIndex) {
+        _bucketTimestampIndex = std::make_unique<BucketTimestampIndex>();
+        _bucketTimestampIndex->getAllocator().freeze();
+        _bucketTimestampIndex->getAllocator().assign_generation(getGenerationHandler().getCurrentGeneration());
+    }
     ensureSpace(0);         // lid 0 is reserved
     setCommittedDocIdLimit(1u);         // lid 0 is reserved
     _gidToLidMap.getAllocator().freeze(); // create initial frozen tree
@@ -453,6 +583,17 @@ DocumentMetaStore::Result
 DocumentMetaStore::inspectExisting(const GlobalId &gid, uint64_t prepare_serial_num)
 {
     Result res;
+    if (_gidToLidHash) {
+        // The b-tree write iterator is left unpositioned, later operations must seek it
+        _gid_to_lid_map_write_itr_prepare_serial_num = 0u;
+        DocId lid = find_lid_in_hash(gid);
+        if (lid != 0u) {
+            res.setLid(lid);
+            res.fillPrev(_metaDataStore[lid].getTimestamp());
+            res.markSuccess();
+        }
+        return res;
+    }
     KeyComp comp(gid, get_unbound_meta_data_view());
     auto find_key = GidToLidMapKey::make_find_key(gid);
     auto& itr = _gid_to_lid_map_write_itr;
@@ -472,18 +613,28 @@ DocumentMetaStore::inspect(const GlobalId &gid, uint64_t prepare_serial_num)
 {
     assert(_lidAlloc.isFreeListConstructed());
     Result res;
-    KeyComp comp(gid, get_unbound_meta_data_view());
-    auto find_key = GidToLidMapKey::make_find_key(gid);
-    auto& itr = _gid_to_lid_map_write_itr;
-    itr.lower_bound(_gidToLidMap.getRoot(), find_key, comp);
-    _gid_to_lid_map_write_itr_prepare_serial_num = prepare_serial_num;
-    bool found = itr.valid() && !comp(find_key, itr.getKey());
-    if (!found) {
+    DocId lid = 0u;
+    if (_gidToLidHash) {
+        lid = find_lid_in_hash(gid);
+        _gid_to_lid_map_write_itr_prepare_serial_num = 0u;
+    }
+    if (lid == 0u) {
+        // Position the b-tree write iterator for the insert done by put()
+        KeyComp comp(gid, get_unbound_meta_data_view());
+        auto find_key = GidToLidMapKey::make_find_key(gid);
+        auto& itr = _gid_to_lid_map_write_itr;
+        itr.lower_bound(_gidToLidMap.getRoot(), find_key, comp);
+        _gid_to_lid_map_write_itr_prepare_serial_num = prepare_serial_num;
+        if (itr.valid() && !comp(find_key, itr.getKey())) {
+            lid = itr.getKey().get_lid();
+        }
+    }
+    if (lid == 0u) {
         DocId myLid = peekFreeLid();
         res.setLid(myLid);
         res.markSuccess();
     } else {
-        res.setLid(itr.getKey().get_lid());
+        res.setLid(lid);
         res.fillPrev(_metaDataStore[res.getLid()].getTimestamp());
         res.markSuccess();
     }
@@ -499,11 +650,16 @@ DocumentMetaStore::put(const GlobalId &gid, const BucketId &bucketId, Timestamp
     KeyComp comp(metaData, get_unbound_meta_data_view());
     auto find_key = GidToLidMapKey::make_find_key(gid);
     auto& itr = _gid_to_lid_map_write_itr;
-    if (prepare_serial_num == 0u || _gid_to_lid_map_write_itr_prepare_serial_num != prepare_serial_num) {
-        itr.lower_bound(_gidToLidMap.getRoot(), find_key, comp);
+    DocId found_lid = _gidToLidHash ? find_lid_in_hash(gid) : 0u;
+    if (found_lid == 0u) {
+        if (prepare_serial_num == 0u || _gid_to_lid_map_write_itr_prepare_serial_num != prepare_serial_num) {
+            itr.lower_bound(_gidToLidMap.getRoot(), find_key, comp);
+        }
+        if (itr.valid() && !comp(find_key, itr.getKey())) {
+            found_lid = itr.getKey().get_lid();
+        }
     }
-    bool found = itr.valid() && !comp(find_key, itr.getKey());
-    if (!found) {
+    if (found_lid == 0u) {
         if (validLid(lid)) {
             throw IllegalStateException(
                     make_string(
@@ -525,7 +681,7 @@ DocumentMetaStore::put(const GlobalId &gid, const BucketId &bucketId, Timestamp
         insert(GidToLidMapKey(lid, find_key.get_gid_key()), metaData);
         res.setLid(lid);
         res.markSuccess();
-    } else if (lid != itr.getKey().get_lid()) {
+    } else if (lid != found_lid) {
         throw IllegalStateException(
                 make_string(
                         "document meta data store"
@@ -535,7 +691,7 @@ DocumentMetaStore::put(const GlobalId &gid, const BucketId &bucketId, Timestamp
                         " gid found, but using another lid '%u'",
                         lid,
                         gid.toString().c_str(),
-                        itr.getKey().get_lid()));
+                        found_lid));
     } else {
         res.setLid(lid);
         res.fillPrev(_metaDataStore[lid].getTimestamp());
@@ -552,6 +708,7 @@ DocumentMetaStore::updateMetaData(DocId lid, const BucketId &bucketId, Timestamp
         return false;
     }
     RawDocumentMetaData &metaData = _metaDataStore[lid];
+    remove_from_bucket_timestamp_index(lid);
     _bucketDB->takeGuard()->modify(metaData.getGid(),
                      metaData.getBucketId().stripUnused(),
                      metaData.getTimestamp(),
@@ -563,6 +720,7 @@ DocumentMetaStore::updateMetaData(DocId lid, const BucketId &bucketId, Timestamp
     metaData.setBucketId(bucketId);
     std::atomic_thread_fence(std::memory_order_release);
     metaData.setTimestamp(storage::spi::Timestamp(timestamp));
+    add_to_bucket_timestamp_index(lid);
     return true;
 }
 
@@ -584,6 +742,8 @@ DocumentMetaStore::removeInternal(DocId lid, uint64_t prepare_serial_num)
                         lid, gid.toString().c_str()));
     }
     _gidToLidMap.remove(itr);
+    remove_from_hash(lid);
+    remove_from_bucket_timestamp_index(lid);
     _lidAlloc.unregisterLid(lid);
     return _metaDataStore[lid];
 }
@@ -633,6 +793,14 @@ DocumentMetaStore::move(DocId fromLid, DocId toLid, uint64_t prepare_serial_num)
     assert(itr.getKey().get_lid() == fromLid);
     _gidToLidMap.thaw(itr);
     itr.writeKey(GidToLidMapKey(toLid, find_key.get_gid_key()));
+    if (_gidToLidHash) {
+        // Both lids map to the same gid, so the entry stays in place and readers never miss it
+        auto kv = _gidToLidHash->find(_gidToLidHash->get_default_comparator(), EntryRef(fromLid));
+        assert(kv != nullptr);
+        kv->first.store_release(EntryRef(toLid));
+    }
+    remove_from_bucket_timestamp_index(fromLid);
+    add_to_bucket_timestamp_index(toLid);
     _lidAlloc.moveLidEnd(fromLid, toLid);
     _changesSinceCommit++;
 }
@@ -664,6 +832,8 @@ DocumentMetaStore::remove_batch_internal_btree(std::vector<LidAndRawDocumentMeta
                             lid, gid.toString().c_str()));
         }
         _gidToLidMap.remove(itr);
+        remove_from_hash(lid);
+        remove_from_bucket_timestamp_index(lid);
     }
 }
 
@@ -684,10 +854,12 @@ DocumentMetaStore::removeBatch(const std::vector<DocId> &lidsToRemove, const uin
     {
         std::vector<RemoveBatchEntry> bdb_removed;
         bdb_removed.reserve(removed.size());
+        bool need_checksum = (_subDbType != SubDbType::REMOVED);
         for (const auto& lid_and_meta : removed) {
             auto& meta = lid_and_meta.second;
             bdb_removed.emplace_back(meta.getGid(), meta.getBucketId().stripUnused(),
-                                     meta.getTimestamp(), meta.getDocSize());
+                                     meta.getTimestamp(), meta.getDocSize(),
+                                     need_checksum ? BucketState::calcChecksum(meta.getGid(), meta.getTimestamp()) : 0u);
         }
         bucketdb::Guard bucketGuard = _bucketDB->takeGuard();
         bucketGuard->remove_batch(bdb_removed, _subDbType);
@@ -727,6 +899,14 @@ DocumentMetaStore::getGidEvenIfMoved(DocId lid, GlobalId &gid) const
 bool
 DocumentMetaStore::getLid(const GlobalId &gid, DocId &lid) const
 {
+    if (_gidToLidHash) {
+        DocId found_lid = find_lid_in_hash(gid);
+        if (found_lid == 0u) {
+            return false;
+        }
+        lid = found_lid;
+        return true;
+    }
     GlobalId value(gid);
     KeyComp comp(value, acquire_unbound_meta_data_view());
     auto find_key = GidToLidMapKey::make_find_key(gid);
@@ -779,6 +959,34 @@ DocumentMetaStore::getMetaData(const BucketId &bucketId,
     }
 }
 
+void
+DocumentMetaStore::getMetaDataInRange(const BucketId &bucketId, uint64_t fromTimestamp, uint64_t toTimestamp,
+                                      search::DocumentMetaData::Vector &result) const
+{
+    if (!_bucketTimestampIndex) {
+        search::IDocumentMetaStore::getMetaDataInRange(bucketId, fromTimestamp, toTimestamp, result);
+        return;
+    }
+    uint64_t bucket = bucketId.getId();
+    auto itr = _bucketTimestampIndex->getFrozenView().lowerBound(BucketTimestampKey(bucket, fromTimestamp, 0u));
+    for (; itr.valid() && itr.getKey().get_bucket() == bucket && itr.getKey().get_timestamp() <= toTimestamp; ++itr) {
+        DocId lid = itr.getKey().get_lid();
+        if (validLid(lid)) {
+            // Meta data might have changed after the frozen view was made
+            const RawDocumentMetaData &rawData = getRawMetaData(lid);
+            if (bucketId.getUsedBits() != rawData.getBucketUsedBits()) {
+                continue;
+            }
+            uint64_t timestamp = rawData.getTimestamp().getValue();
+            std::atomic_thread_fence(std::memory_order_acquire);
+            if (timestamp < fromTimestamp || timestamp > toTimestamp) {
+                continue;
+            }
+            result.emplace_back(lid, timestamp, rawData.getBucketId(), rawData.getGid(), _subDbType == SubDbType::REMOVED);
+        }
+    }
+}
+
 LidUsageStats
 DocumentMetaStore::getLidUsageStats() const
 {
@@ -846,6 +1054,15 @@ void
 DocumentMetaStore::getLids(const BucketId &bucketId, std::vector<DocId> &lids)
 {
     // Called by writer thread
+    if (_bucketTimestampIndex) {
+        uint64_t bucket = bucketId.getId();
+        auto itr = _bucketTimestampIndex->lowerBound(BucketTimestampKey(bucket, 0u, 0u));
+        for (; itr.valid() && itr.getKey().get_bucket() == bucket; ++itr) {
+            assert(validLid(itr.getKey().get_lid()));
+            lids.push_back(itr.getKey().get_lid());
+        }
+        return;
+    }
     TreeType::Iterator itr = lowerBound(bucketId);
     TreeType::Iterator end = upperBound(bucketId);
     for (; itr != end; ++itr) {
@@ -895,13 +1112,17 @@ DocumentMetaStore::handleSplit(const bucketdb::SplitBucketSession &session)
                 t2.setUsedBits(target2.getUsedBits());
             }
             if (target1.valid() && t1 == target1) {
+                remove_from_bucket_timestamp_index(lid);
                 metaData.setBucketUsedBits(target1.getUsedBits());
+                add_to_bucket_timestamp_index(lid);
                 deltas._delta1.add(metaData.getGid(),
                                    metaData.getTimestamp(),
                                    metaData.getDocSize(),
                                    _subDbType);
             } else if (target2.valid() && t2 == target2) {
+                remove_from_bucket_timestamp_index(lid);
                 metaData.setBucketUsedBits(target2.getUsedBits());
+                add_to_bucket_timestamp_index(lid);
                 deltas._delta2.add(metaData.getGid(),
                                    metaData.getTimestamp(),
                                    metaData.getDocSize(),
@@ -931,10 +1152,14 @@ DocumentMetaStore::handleJoin(const bucketdb::JoinBucketsSession &session)
         assert(BucketId::validUsedBits(metaData.getBucketUsedBits()));
         BucketId s(metaData.getBucketId());
         if (source1.valid() && s == source1) {
+            remove_from_bucket_timestamp_index(lid);
             metaData.setBucketUsedBits(target.getUsedBits());
+            add_to_bucket_timestamp_index(lid);
             deltas._delta1.add(metaData.getGid(), metaData.getTimestamp(), metaData.getDocSize(), _subDbType);
         } else if (source2.valid() && s == source2) {
+            remove_from_bucket_timestamp_index(lid);
             metaData.setBucketUsedBits(target.getUsedBits());
+            add_to_bucket_timestamp_index(lid);
             deltas._delta2.add(metaData.getGid(), metaData.getTimestamp(), metaData.getDocSize(), _subDbType);
         }
     }
@@ -2,6 +2,7 @@
 
 #pragma once
 
+#include "bucket_timestamp_key.h"
 #include "document_meta_store_adapter.h"
 #include "documentmetastoreattribute.h"
 #include "lid_allocator.h"
@@ -12,6 +13,8 @@
 #include <vespa/searchcommon/common/growstrategy.h>
 #include <vespa/vespalib/util/rcuvector.h>
 
+namespace vespalib::datastore { class ShardedHashMap; }
+
 namespace proton::bucketdb {
     class SplitBucketSession;
     class JoinBucketsSession;
@@ -65,9 +68,15 @@ private:
     using TreeType =  vespalib::btree::BTree<documentmetastore::GidToLidMapKey, vespalib::btree::BTreeNoLeafData,
                                              vespalib::btree::NoAggregated, const KeyComp &>;
     using LidAndRawDocumentMetaData = std::pair<uint32_t, RawDocumentMetaData>;
+    // Optional secondary index ordered by (bucket, timestamp, lid)
+    using BucketTimestampIndex = vespalib::btree::BTree<documentmetastore::BucketTimestampKey, vespalib::btree::BTreeNoLeafData,
+                                                        vespalib::btree::NoAggregated, std::less<documentmetastore::BucketTimestampKey>>;
 
     MetaDataStore       _metaDataStore;
     TreeType            _gidToLidMap;
+    // Optional gid -> lid hash index, used for point lookups instead of _gidToLidMap
+    std::unique_ptr<vespalib::datastore::ShardedHashMap> _gidToLidHash;
+    std::unique_ptr<BucketTimestampIndex> _bucketTimestampIndex;
     Iterator            _gid_to_lid_map_write_itr; // Iterator used for all updates of _gidToLidMap
     SerialNum           _gid_to_lid_map_write_itr_prepare_serial_num;
     documentmetastore::LidAllocator _lidAlloc;
@@ -86,6 +95,13 @@ private:
 
     const GlobalId & getRawGid(DocId lid) const { return getRawMetaData(lid).getGid(); }
 
+    std::unique_ptr<vespalib::datastore::ShardedHashMap> make_gid_to_lid_hash() const;
+    DocId find_lid_in_hash(const GlobalId &gid) const;
+    void remove_from_hash(DocId lid);
+    static documentmetastore::BucketTimestampKey make_bucket_timestamp_key(DocId lid, const RawDocumentMetaData &metaData) noexcept;
+    void add_to_bucket_timestamp_index(DocId lid);
+    void remove_from_bucket_timestamp_index(DocId lid);
+
     bool consider_compact_gid_to_lid_map();
     void onCommit() override;
     void onUpdateStat() override;
@@ -151,7 +167,9 @@ public:
     DocumentMetaStore(BucketDBOwnerSP bucketDB,
                       const vespalib::string & name,
                       const search::GrowStrategy & grow,
-                      SubDbType subDbType = SubDbType::READY);
+                      SubDbType subDbType = SubDbType::READY,
+                      bool gidHashIndex = false,
+                      bool bucketTimestampIndex = false);
     ~DocumentMetaStore() override;
 
     /**
@@ -189,6 +207,8 @@ public:
     bool validLid(DocId lid) const override { return validLidFast(lid); }
     void removeBatch(const std::vector<DocId> &lidsToRemove, DocId docIdLimit) override;
     const RawDocumentMetaData & getRawMetaData(DocId lid) const override { return _metaDataStore.acquire_elem_ref(lid); }
+    bool has_gid_hash_index() const noexcept { return static_cast<bool>(_gidToLidHash); }
+    bool has_bucket_timestamp_index() const noexcept { return static_cast<bool>(_bucketTimestampIndex); }
 
     /**
      * Implements search::IDocumentMetaStore
@@ -198,6 +218,8 @@ public:
     bool getLid(const GlobalId & gid, DocId &lid) const override;
     search::DocumentMetaData getMetaData(const GlobalId &gid) const override;
     void getMetaData(const BucketId &bucketId, search::DocumentMetaData::Vector &result) const override;
+    void getMetaDataInRange(const BucketId &bucketId, uint64_t fromTimestamp, uint64_t toTimestamp,
+                            search::DocumentMetaData::Vector &result) const override;
     DocId   getNumUsedLids() const override { return _lidAlloc.getNumUsedLids(); }
     DocId getNumActiveLids() const override { return _lidAlloc.getNumActiveLids(); }
     search::LidUsageStats getLidUsageStats() const override;
@@ -0,0 +1,40 @@
+// Copyright Vespa.ai. Licensed under the terms of the Apache 2.0 license. See LICENSE in the project root.
+
+#include "gid_hash_comparator.h"
+#include <vespa/vespalib/stllike/hash_fun.h>
+
+namespace proton::documentmetastore {
+
+GidHashComparator::GidHashComparator(const MetaDataStore &metaDataStore, const document::GlobalId &gid)
+    : _metaDataStore(metaDataStore),
+      _gid(gid)
+{
+}
+
+GidHashComparator::GidHashComparator(const MetaDataStore &metaDataStore)
+    : GidHashComparator(metaDataStore, document::GlobalId())
+{
+}
+
+GidHashComparator::~GidHashComparator() = default;
+
+bool
+GidHashComparator::less(const EntryRef lhs, const EntryRef rhs) const noexcept
+{
+    return document::GlobalId::BucketOrderCmp()(getGid(lhs), getGid(rhs));
+}
+
+bool
+GidHashComparator::equal(const EntryRef lhs, const EntryRef rhs) const noexcept
+{
+    return getGid(lhs) == getGid(rhs);
+}
+
+size_t
+GidHashComparator::hash(const EntryRef rhs) const noexcept
+{
+    // The leading bytes of a gid are location bits shared by documents in the same group
+    return vespalib::xxhash::xxh3_64(getGid(rhs).get(), document::GlobalId::LENGTH);
+}
+
+}
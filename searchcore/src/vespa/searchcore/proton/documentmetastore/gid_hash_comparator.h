@@ -0,0 +1,44 @@
+// Copyright Vespa.ai. Licensed under the terms of the Apache 2.0 license. See LICENSE in the project root.
+
+#pragma once
+
+#include "raw_document_meta_data.h"
+#include <vespa/document/base/globalid.h>
+#include <vespa/vespalib/datastore/entry_comparator.h>
+#include <vespa/vespalib/util/rcuvector.h>
+
+namespace proton::documentmetastore {
+
+/**
+ * Comparator used by the optional gid -> lid hash index. Keys in the
+ * hash index are lids wrapped in entry refs, and the gid for a lid is
+ * found in the metadata store. An invalid entry ref maps to the gid
+ * given to the constructor (used for lookups).
+ **/
+class GidHashComparator : public vespalib::datastore::EntryComparator
+{
+public:
+    using MetaDataStore = vespalib::RcuVectorBase<RawDocumentMetaData>;
+private:
+    using EntryRef = vespalib::datastore::EntryRef;
+
+    const MetaDataStore      &_metaDataStore;
+    const document::GlobalId  _gid;
+
+    const document::GlobalId &getGid(const EntryRef ref) const noexcept {
+        if (ref.valid()) {
+            return _metaDataStore.acquire_elem_ref(ref.ref()).getGid();
+        }
+        return _gid;
+    }
+public:
+    GidHashComparator(const MetaDataStore &metaDataStore, const document::GlobalId &gid);
+    explicit GidHashComparator(const MetaDataStore &metaDataStore);
+    ~GidHashComparator() override;
+
+    bool less(const EntryRef lhs, const EntryRef rhs) const noexcept override;
+    bool equal(const EntryRef lhs, const EntryRef rhs) const noexcept override;
+    size_t hash(const EntryRef rhs) const noexcept override;
+};
+
+}
@@ -0,0 +1,297 @@
+// Copyright Vespa.ai. Licensed under the terms of the Apache 2.0 license. See LICENSE in the project root.
+
+#include "adaptive_flush_strategy.h"
+#include "active_flush_stats.h"
+#include "tls_stats_map.h"
+#include <vespa/vespalib/data/slime/cursor.h>
+#include <vespa/vespalib/stllike/hash_set.h>
+#include <vespa/vespalib/util/size_literals.h>
+#include <algorithm>
+#include <cinttypes>
+
+#include <vespa/log/log.h>
+LOG_SETUP(".proton.flushengine.adaptive_flush_strategy");
+
+using search::SerialNum;
+using searchcorespi::IFlushTarget;
+using proton::flushengine::TlsStats;
+using vespalib::slime::Cursor;
+
+namespace proton {
+
+namespace {
+
+uint64_t
+estimate_needed_tls_size(const TlsStats &tlsStats, SerialNum flushedSerialNum)
+{
+    if (flushedSerialNum < tlsStats.getFirstSerial()) {
+        return tlsStats.getNumBytes();
+    }
+    int64_t numEntries = tlsStats.getLastSerial() - tlsStats.getFirstSerial() + 1;
+    if (numEntries <= 0 || flushedSerialNum >= tlsStats.getLastSerial()) {
+        return 0u;
+    }
+    double bytesPerEntry = static_cast<double>(tlsStats.getNumBytes()) / numEntries;
+    return bytesPerEntry * (tlsStats.getLastSerial() - flushedSerialNum);
+}
+
+double
+ratio(double value, uint64_t limit)
+{
+    return (limit > 0) ? (value / limit) : 0.0;
+}
+
+bool
+too_much_disk_bloat(const IFlushTarget::DiskGain &gain, double diskBloatFactor)
+{
+    int64_t size = std::max(INT64_C(100000000), std::max(gain.getBefore(), gain.getAfter()));
+    return gain.gain() > diskBloatFactor * size;
+}
+
+struct Candidate {
+    FlushContext::SP ctx;
+    bool             urgent;
+    bool             forced;
+    double           writeAmplification;
+    double           score;
+    vespalib::system_time lastFlushTime;
+};
+
+}
+
+AdaptiveFlushStrategy::Config::Config()
+    : maxGlobalMemory(4000_Mi),
+      maxGlobalTlsSize(20_Gi),
+      diskBloatFactor(0.2),
+      maxTimeGain(std::chrono::hours(24)),
+      diskWriteBytesPerSecond(100_Mi),
+      maxWriteAmplification(4.0),
+      earlyFlushPressure(0.7),
+      rateSmoothingFactor(0.3)
+{
+}
+
+AdaptiveFlushStrategy::Prediction::Prediction()
+    : memoryGrowthRate(0.0),
+      tlsGrowthRate(0.0),
+      totalMemory(0),
+      totalTlsSize(0),
+      flushDuration(),
+      predictedMemory(0.0),
+      predictedTlsSize(0.0),
+      pressure(0.0),
+      targets()
+{
+}
+
+AdaptiveFlushStrategy::Prediction::~Prediction() = default;
+
+AdaptiveFlushStrategy::RateModel::RateModel()
+    : hasSample(false),
+      sampleTime(),
+      memory(0),
+      tlsSize(0),
+      memoryRate(0.0),
+      tlsRate(0.0)
+{
+}
+
+AdaptiveFlushStrategy::AdaptiveFlushStrategy()
+    : AdaptiveFlushStrategy(Config())
+{
+}
+
+AdaptiveFlushStrategy::AdaptiveFlushStrategy(const Config &config)
+    : AdaptiveFlushStrategy(config, vespalib::system_clock::now())
+{
+}
+
+AdaptiveFlushStrategy::AdaptiveFlushStrategy(const Config &config, vespalib::system_time startTime)
+    : _config(config),
+      _startTime(startTime),
+      _lock(),
+      _rates(),
+      _prediction()
+{
+}
+
+AdaptiveFlushStrategy::~AdaptiveFlushStrategy() = default;
+
+void
+AdaptiveFlushStrategy::setConfig(const Config &config)
+{
+    std::lock_guard guard(_lock);
+    _config = config;
+}
+
+AdaptiveFlushStrategy::Config
+AdaptiveFlushStrategy::getConfig() const
+{
+    std::lock_guard guard(_lock);
+    return _config;
+}
+
+void
+AdaptiveFlushStrategy::update_rates(const Config &config, vespalib::steady_time now, uint64_t totalMemory, uint64_t totalTlsSize) const
+{
+    RateModel &rates = _rates;
+    if (rates.hasSample && now > rates.sampleTime) {
+        double elapsed = vespalib::to_s(now - rates.sampleTime);
+        double alpha = config.rateSmoothingFactor;
+        // A decrease means that memory was freed by a flush or the TLS was pruned.
+        // The growth in that interval is unknown, so the current rate is kept.
+        if (totalMemory >= rates.memory) {
+            double sample = (totalMemory - rates.memory) / elapsed;
+            rates.memoryRate = alpha * sample + (1.0 - alpha) * rates.memoryRate;
+        }
+        if (totalTlsSize >= rates.tlsSize) {
+            double sample = (totalTlsSize - rates.tlsSize) / elapsed;
+            rates.tlsRate = alpha * sample + (1.0 - alpha) * rates.tlsRate;
+        }
+    }
+    if (!rates.hasSample || now > rates.sampleTime) {
+        rates.hasSample = true;
+        rates.sampleTime = now;
+        rates.memory = totalMemory;
+        rates.tlsSize = totalTlsSize;
+    }
+}
+
+FlushContext::List
+AdaptiveFlushStrategy::getFlushTargets(const FlushContext::List &targetList,
+                                       const flushengine::TlsStatsMap &tlsStatsMap,
+                                       const flushengine::ActiveFlushStats &active_flushes) const
+{
+    return getFlushTargets(targetList, tlsStatsMap, active_flushes,
+                           vespalib::steady_clock::now(), vespalib::system_clock::now());
+}
+
+FlushContext::List
+AdaptiveFlushStrategy::getFlushTargets(const FlushContext::List &targetList,
+                                       const flushengine::TlsStatsMap &tlsStatsMap,
+                                       const flushengine::ActiveFlushStats &active_flushes,
+                                       vespalib::steady_time steady_now,
+                                       vespalib::system_time system_now) const
+{
+    const Config config = getConfig();
+    std::vector<Candidate> candidates;
+    candidates.reserve(targetList.size());
+    vespalib::hash_set<const void *> visitedHandlers;
+    uint64_t totalMemory = 0;
+    uint64_t totalTlsSize = 0;
+    uint64_t totalBytesToWrite = 0;
+    for (const auto &ctx : targetList) {
+        const IFlushTarget &target = *ctx->getTarget();
+        const IFlushHandler &handler = *ctx->getHandler();
+        const TlsStats &tlsStats = tlsStatsMap.getTlsStats(handler.getName());
+        vespalib::system_time lastFlushTime = target.getLastFlushTime();
+        // TLS of a handler with an active flush that started before the last flush of this target
+        // will soon be pruned, and should not add to the pressure.
+        auto oldest_start_time = active_flushes.oldest_start_time(handler.getName());
+        if (!oldest_start_time.has_value() || lastFlushTime < oldest_start_time.value()) {
+            if (visitedHandlers.insert(&handler).second) {
+                totalTlsSize += tlsStats.getNumBytes();
+            }
+        }
+        uint64_t memoryGain = std::max(INT64_C(0), target.getApproxMemoryGain().gain());
+        uint64_t bytesToWrite = target.getApproxBytesToWriteToDisk();
+        uint64_t tlsGain = estimate_needed_tls_size(tlsStats, target.getFlushedSerialNum());
+        totalMemory += memoryGain;
+        totalBytesToWrite += bytesToWrite;
+        vespalib::duration age = system_now - ((lastFlushTime > vespalib::system_time()) ? lastFlushTime : _startTime);
+        Candidate candidate;
+        candidate.ctx = ctx;
+        candidate.urgent = target.needUrgentFlush();
+        candidate.forced = candidate.urgent ||
+                           too_much_disk_bloat(target.getApproxDiskGain(), config.diskBloatFactor) ||
+                           (age >= config.maxTimeGain);
+        candidate.writeAmplification = static_cast<double>(bytesToWrite) / std::max(UINT64_C(1), memoryGain + tlsGain);
+        double benefit = ratio(memoryGain, config.maxGlobalMemory) + ratio(tlsGain, config.maxGlobalTlsSize);
+        double writeSeconds = bytesToWrite / config.diskWriteBytesPerSecond;
+        candidate.score = benefit / (1.0 + writeSeconds);
+        candidate.lastFlushTime = lastFlushTime;
+        candidates.push_back(std::move(candidate));
+    }
+
+    std::lock_guard guard(_lock);
+    update_rates(config, steady_now, totalMemory, totalTlsSize);
+    Prediction prediction;
+    prediction.memoryGrowthRate = _rates.memoryRate;
+    prediction.tlsGrowthRate = _rates.tlsRate;
+    prediction.totalMemory = totalMemory;
+    prediction.totalTlsSize = totalTlsSize;
+    double flushSeconds = totalBytesToWrite / config.diskWriteBytesPerSecond;
+    prediction.flushDuration = vespalib::from_s(flushSeconds);
+    prediction.predictedMemory = totalMemory + _rates.memoryRate * flushSeconds;
+    prediction.predictedTlsSize = totalTlsSize + _rates.tlsRate * flushSeconds;
+    prediction.pressure = std::max(ratio(prediction.predictedMemory, config.maxGlobalMemory),
+                                   ratio(prediction.predictedTlsSize, config.maxGlobalTlsSize));
+
+    std::sort(candidates.begin(), candidates.end(), [](const Candidate &lhs, const Candidate &rhs) {
+        if (lhs.forced != rhs.forced) {
+            return lhs.forced;
+        }
+        if (lhs.urgent != rhs.urgent) {
+            return lhs.urgent;
+        }
+        if (lhs.forced) {
+            return lhs.lastFlushTime < rhs.lastFlushTime;
+        }
+        return lhs.score > rhs.score;
+    });
+    FlushContext::List result;
+    for (const auto &candidate : candidates) {
+        bool selected = candidate.forced ||
+                        (prediction.pressure >= 1.0) ||
+                        ((prediction.pressure >= config.earlyFlushPressure) &&
+                         (candidate.writeAmplification <= config.maxWriteAmplification));
+        const IFlushTarget &target = *candidate.ctx->getTarget();
+        prediction.targets.push_back({candidate.ctx->getName(),
+                                      static_cast<uint64_t>(std::max(INT64_C(0), target.getApproxMemoryGain().gain())),
+                                      target.getApproxBytesToWriteToDisk(),
+                                      candidate.writeAmplification, candidate.score, candidate.forced});
+        if (selected) {
+            result.push_back(candidate.ctx);
+        }
+    }
+    LOG(debug, "getFlushTargets(): totalMemory(%" PRIu64 "), totalTlsSize(%" PRIu64 "), memoryRate(%f), tlsRate(%f), "
+        "flushDuration(%fs), pressure(%f), %zu of %zu targets selected",
+        totalMemory, totalTlsSize, _rates.memoryRate, _rates.tlsRate, flushSeconds, prediction.pressure,
+        result.size(), candidates.size());
+    _prediction = std::move(prediction);
+    return result;
+}
+
+AdaptiveFlushStrategy::Prediction
+AdaptiveFlushStrategy::get_prediction() const
+{
+    std::lock_guard guard(_lock);
+    return _prediction;
+}
+
+void
+AdaptiveFlushStrategy::report_state(Cursor &object) const
+{
+    Prediction prediction = get_prediction();
+    object.setString("name", "adaptive");
+    object.setDouble("memoryGrowthRate", prediction.memoryGrowthRate);
+    object.setDouble("tlsGrowthRate", prediction.tlsGrowthRate);
+    object.setLong("totalMemory", prediction.totalMemory);
+    object.setLong("totalTlsSize", prediction.totalTlsSize);
+    object.setDouble("flushDuration", vespalib::to_s(prediction.flushDuration));
+    object.setDouble("predictedMemory", prediction.predictedMemory);
+    object.setDouble("predictedTlsSize", prediction.predictedTlsSize);
+    object.setDouble("pressure", prediction.pressure);
+    Cursor &targets = object.setArray("targets");
+    for (const auto &target : prediction.targets) {
+        Cursor &entry = targets.addObject();
+        entry.setString("name", target.name);
+        entry.setLong("memoryGain", target.memoryGain);
+        entry.setLong("bytesToWrite", target.bytesToWrite);
+        entry.setDouble("writeAmplification", target.writeAmplification);
+        entry.setDouble("score", target.score);
+        entry.setBool("forced", target.forced);
+    }
+}
+
+} // namespace proton
@@ -0,0 +1,118 @@
+// Copyright Vespa.ai. Licensed under the terms of the Apache 2.0 license. See LICENSE in the project root.
+#pragma once
+
+#include "iflushstrategy.h"
+#include <vespa/vespalib/stllike/string.h>
+#include <vespa/vespalib/util/time.h>
+#include <mutex>
+#include <vector>
+
+namespace proton {
+
+/**
+ * Flush strategy that models the cost of each flush target against the
+ * projected memory and transaction log growth caused by the current feed rate.
+ *
+ * The feed rate is estimated from how total memory gain and TLS size change
+ * between calls (smoothed). Growth is projected over the time it would take to
+ * write all candidate targets to disk, giving the predicted pressure relative
+ * to the global memory and TLS limits:
+ *   - pressure >= 1: all targets are returned, ordered by benefit per cost.
+ *   - pressure >= earlyFlushPressure: only targets with low write amplification
+ *     (bytes written per byte of memory freed) are returned, which spreads
+ *     flushing out in time instead of flushing everything when a limit is hit.
+ *   - otherwise only targets needing urgent flush, targets with too much disk
+ *     bloat and targets older than maxTimeGain are returned.
+ */
+class AdaptiveFlushStrategy : public IFlushStrategy
+{
+public:
+    struct Config
+    {
+        uint64_t           maxGlobalMemory;
+        uint64_t           maxGlobalTlsSize;
+        double             diskBloatFactor;
+        vespalib::duration maxTimeGain;
+        /// Expected disk write throughput (bytes/s) when flushing.
+        double             diskWriteBytesPerSecond;
+        /// Max bytes written per byte of memory freed for early flushes.
+        double             maxWriteAmplification;
+        /// Predicted pressure where cheap targets are flushed early.
+        double             earlyFlushPressure;
+        /// Weight of the newest sample when smoothing the feed rate.
+        double             rateSmoothingFactor;
+        Config();
+        bool operator==(const Config &rhs) const noexcept = default;
+    };
+
+    /**
+     * Prediction made by the last call to getFlushTargets().
+     */
+    struct Prediction
+    {
+        struct Target {
+            vespalib::string name;
+            uint64_t         memoryGain;
+            uint64_t         bytesToWrite;
+            double           writeAmplification;
+            double           score;
+            bool             forced;
+        };
+        double              memoryGrowthRate;
+        double              tlsGrowthRate;
+        uint64_t            totalMemory;
+        uint64_t            totalTlsSize;
+        vespalib::duration  flushDuration;
+        double              predictedMemory;
+        double              predictedTlsSize;
+        double              pressure;
+        std::vector<Target> targets;
+        Prediction();
+        ~Prediction();
+    };
+
+private:
+    struct RateModel {
+        bool                 hasSample;
+        vespalib::steady_time sampleTime;
+        uint64_t             memory;
+        uint64_t             tlsSize;
+        double               memoryRate;
+        double               tlsRate;
+        RateModel();
+    };
+
+    Config                _config;
+    vespalib::system_time _startTime;
+    mutable std::mutex    _lock;
+    mutable RateModel     _rates;
+    mutable Prediction    _prediction;
+
+    void update_rates(const Config &config, vespalib::steady_time now, uint64_t totalMemory, uint64_t totalTlsSize) const;
+
+public:
+    AdaptiveFlushStrategy();
+    explicit AdaptiveFlushStrategy(const Config &config);
+    AdaptiveFlushStrategy(const Config &config, vespalib::system_time startTime);
+    ~AdaptiveFlushStrategy() override;
+
+    FlushContext::List getFlushTargets(const FlushContext::List &targetList,
+                                       const flushengine::TlsStatsMap &tlsStatsMap,
+                                       const flushengine::ActiveFlushStats &active_flushes) const override;
+
+    /**
+     * Same as above, using the given time as now. Used by unit tests.
+     */
+    FlushContext::List getFlushTargets(const FlushContext::List &targetList,
+                                       const flushengine::TlsStatsMap &tlsStatsMap,
+                                       const flushengine::ActiveFlushStats &active_flushes,
+                                       vespalib::steady_time steady_now,
+                                       vespalib::system_time system_now) const;
+
+    void report_state(vespalib::slime::Cursor &object) const override;
+    Prediction get_prediction() const;
+    void setConfig(const Config &config);
+    Config getConfig() const;
+};
+
+} // namespace proton
@@ -71,6 +71,7 @@ FlushEngineExplorer::get_state(const Inserter &inserter, bool full) const
         FlushContext::List allTargets = _engine.getTargetList(true);
         sortTargetList(allTargets);
         convertToSlime(allTargets, now, object.setArray("allTargets"));
+        _engine._strategy->report_state(object.setObject("strategy"));
     }
 }
 
@@ -4,6 +4,8 @@
 #include "iflushhandler.h"
 #include "flushcontext.h"
 
+namespace vespalib::slime { struct Cursor; }
+
 namespace proton {
 
 namespace flushengine {
@@ -35,6 +37,12 @@ public:
     virtual FlushContext::List getFlushTargets(const FlushContext::List& targetList,
                                                const flushengine::TlsStatsMap& tlsStatsMap,
                                                const flushengine::ActiveFlushStats& active_flushes) const = 0;
+
+    /**
+     * Reports the internal state of the strategy (e.g. predictions used when
+     * selecting targets) for state explorers. Default is to report nothing.
+     */
+    virtual void report_state(vespalib::slime::Cursor& object) const { (void) object; }
 protected:
     IFlushStrategy() = default;
 };
@@ -21,10 +21,12 @@ using FlushTargetCandidatesList = std::vector<FlushTargetCandidates::UP>;
 
 PrepareRestartFlushStrategy::Config::Config(double tlsReplayByteCost_,
                                             double tlsReplayOperationCost_,
-                                            double flushTargetWriteCost_)
+                                            double flushTargetWriteCost_,
+                                            bool flushAll_)
     : tlsReplayByteCost(tlsReplayByteCost_),
       tlsReplayOperationCost(tlsReplayOperationCost_),
-      flushTargetWriteCost(flushTargetWriteCost_)
+      flushTargetWriteCost(flushTargetWriteCost_),
+      flushAll(flushAll_)
 {
 }
 
@@ -109,6 +111,12 @@ findBestTargetsToFlush(const FlushContext::List &unsortedFlushContexts,
     }
     sortByOldestFlushedSerialNumber(candidates);
 
+    if (cfg.flushAll) {
+        FlushTargetCandidates allSet(candidates, candidates.size(), tlsStats, cfg);
+        LOG(info, "findBestTargetsToFlush(): Flushing all targets: flushTargets=[%s], flushTargetsWriteCost=%f",
+            toString(allSet.getCandidates()).c_str(), allSet.getFlushTargetsWriteCost());
+        return allSet.getCandidates();
+    }
     FlushTargetCandidates bestSet(candidates, 0, tlsStats, cfg);
     for (size_t numCandidates = 1; numCandidates <= candidates.size(); ++numCandidates) {
         FlushTargetCandidates nextSet(candidates, numCandidates, tlsStats, cfg);
@@ -15,6 +15,9 @@ namespace proton {
  *
  * The cost of replaying the transaction log is: the number of bytes to replay * a replay speed factor.
  * The cost of flushing a flush target is: the number of bytes to write * a write speed factor.
+ *
+ * When configured to flush all, every (non-GC) flush target is flushed so that nothing is left
+ * to replay from the transaction log after the restart.
  */
 class PrepareRestartFlushStrategy : public IFlushStrategy
 {
@@ -24,9 +27,11 @@ public:
         double tlsReplayByteCost;
         double tlsReplayOperationCost;
         double flushTargetWriteCost;
+        bool   flushAll;
         Config(double tlsReplayByteCost_,
                double tlsReplayOperationCost_,
-               double flushTargetWriteCost_);
+               double flushTargetWriteCost_,
+               bool flushAll_ = false);
     };
 
 private:
@@ -12,10 +12,14 @@ namespace proton {
 
 DiskIndexWrapper::DiskIndexWrapper(const vespalib::string &indexDir,
                                    const TuneFileSearch &tuneFileSearch,
-                                   size_t cacheSize)
+                                   size_t cacheSize,
+                                   std::shared_ptr<search::diskindex::HotWords> hotWords,
+                                   std::shared_ptr<search::diskindex::PostingListCache> postingListCache)
     : _index(indexDir, cacheSize),
       _serialNum(0)
 {
+    _index.set_hot_words(std::move(hotWords));
+    _index.set_posting_list_cache(std::move(postingListCache));
     bool setupIndexOk = _index.setup(tuneFileSearch);
     assert(setupIndexOk);
     (void) setupIndexOk;
@@ -24,10 +28,14 @@ DiskIndexWrapper::DiskIndexWrapper(const vespalib::string &indexDir,
 
 DiskIndexWrapper::DiskIndexWrapper(const DiskIndexWrapper &oldIndex,
                                    const TuneFileSearch &tuneFileSearch,
-                                   size_t cacheSize)
+                                   size_t cacheSize,
+                                   std::shared_ptr<search::diskindex::HotWords> hotWords,
+                                   std::shared_ptr<search::diskindex::PostingListCache> postingListCache)
     : _index(oldIndex._index.getIndexDir(), cacheSize),
       _serialNum(0)
 {
+    _index.set_hot_words(std::move(hotWords));
+    _index.set_posting_list_cache(std::move(postingListCache));
     bool setupIndexOk = _index.setup(tuneFileSearch, oldIndex._index);
     assert(setupIndexOk);
     (void) setupIndexOk;
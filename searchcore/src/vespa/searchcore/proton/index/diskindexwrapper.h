@@ -16,11 +16,19 @@ private:
 public:
     DiskIndexWrapper(const vespalib::string &indexDir,
                      const search::TuneFileSearch &tuneFileSearch,
-                     size_t cacheSize);
+                     size_t cacheSize,
+                     std::shared_ptr<search::diskindex::HotWords> hotWords,
+                     std::shared_ptr<search::diskindex::PostingListCache> postingListCache);
 
     DiskIndexWrapper(const DiskIndexWrapper &oldIndex,
                      const search::TuneFileSearch &tuneFileSearch,
-                     size_t cacheSize);
+                     size_t cacheSize,
+                     std::shared_ptr<search::diskindex::HotWords> hotWords,
+                     std::shared_ptr<search::diskindex::PostingListCache> postingListCache);
+
+    size_t prefetch(const std::vector<search::diskindex::HotWords::Entry> &words) {
+        return _index.prefetch(words);
+    }
 
     std::unique_ptr<search::queryeval::Blueprint>
     createBlueprint(const IRequestContext & requestContext, const FieldSpec &field, const Node &term) override {
@@ -6,9 +6,16 @@
 #include <vespa/searchcorespi/index/indexmaintainerconfig.h>
 #include <vespa/searchlib/common/serialnumfileheadercontext.h>
 #include <vespa/searchlib/diskindex/fusion.h>
+#include <vespa/searchlib/diskindex/hot_words.h>
+#include <vespa/searchlib/diskindex/posting_list_cache.h>
 #include <vespa/searchlib/index/schemautil.h>
 
+#include <vespa/log/log.h>
+LOG_SETUP(".proton.index.indexmanager");
+
 using search::diskindex::Fusion;
+using search::diskindex::HotWords;
+using search::diskindex::PostingListCache;
 using search::common::FileHeaderContext;
 using search::common::SerialNumFileHeaderContext;
 using search::index::Schema;
@@ -30,35 +37,77 @@ namespace proton::index {
 IndexManager::MaintainerOperations::MaintainerOperations(const FileHeaderContext &fileHeaderContext,
                                                          const TuneFileIndexManager &tuneFileIndexManager,
                                                          size_t cacheSize,
-                                                         IThreadingService &threadingService)
+                                                         IThreadingService &threadingService,
+                                                         const vespalib::string &baseDir,
+                                                         size_t maxHotWords,
+                                                         size_t postingListCacheSize,
+                                                         uint32_t flushMaxConcurrentFields,
+                                                         size_t fusionMaxMergeMemory,
+                                                         bool fusionBlockDocIds,
+                                                         uint32_t memoryIndexPushShards,
+                                                         uint32_t memoryIndexCompressMinDocs)
     : _cacheSize(cacheSize),
+      _maxHotWords(maxHotWords),
+      _hotWordsFileName(baseDir + "/hot-words"),
+      _hotWords(),
+      _postingListCache(),
+      _flushMaxConcurrentFields(flushMaxConcurrentFields),
+      _fusionMaxMergeMemory(fusionMaxMergeMemory),
+      _fusionBlockDocIds(fusionBlockDocIds),
+      _memoryIndexPushShards(memoryIndexPushShards),
+      _memoryIndexCompressMinDocs(memoryIndexCompressMinDocs),
       _fileHeaderContext(fileHeaderContext),
       _tuneFileIndexing(tuneFileIndexManager._indexing),
       _tuneFileSearch(tuneFileIndexManager._search),
       _threadingService(threadingService)
 {
+    if (_maxHotWords > 0) {
+        _hotWords = std::make_shared<HotWords>(_maxHotWords);
+        _hotWords->add(HotWords::load(_hotWordsFileName));
+    }
+    if (postingListCacheSize > 0) {
+        _postingListCache = std::make_shared<PostingListCache>(postingListCacheSize);
+    }
 }
 
+IndexManager::MaintainerOperations::~MaintainerOperations() = default;
+
 IMemoryIndex::SP
 IndexManager::MaintainerOperations::createMemoryIndex(const Schema& schema,
                                                       const IFieldLengthInspector& inspector,
                                                       SerialNum serialNum)
 {
     return std::make_shared<MemoryIndexWrapper>(schema, inspector, _fileHeaderContext, _tuneFileIndexing,
-                                                _threadingService, serialNum);
+                                                _threadingService, _flushMaxConcurrentFields,
+                                                _memoryIndexPushShards, _memoryIndexCompressMinDocs, serialNum);
 }
 
 IDiskIndex::SP
 IndexManager::MaintainerOperations::loadDiskIndex(const vespalib::string &indexDir)
 {
-    return std::make_shared<DiskIndexWrapper>(indexDir, _tuneFileSearch, _cacheSize);
+    auto index = std::make_shared<DiskIndexWrapper>(indexDir, _tuneFileSearch, _cacheSize, _hotWords, _postingListCache);
+    if (_hotWords) {
+        // Newly loaded index files are cold, both after a restart and after flush or fusion
+        size_t prefetched = index->prefetch(_hotWords->get_hottest(_maxHotWords));
+        LOG(debug, "Prefetched %zu hot posting lists of disk index '%s'", prefetched, indexDir.c_str());
+        saveHotWords();
+    }
+    return index;
 }
 
 IDiskIndex::SP
 IndexManager::MaintainerOperations::reloadDiskIndex(const IDiskIndex &oldIndex)
 {
     return std::make_shared<DiskIndexWrapper>(dynamic_cast<const DiskIndexWrapper &>(oldIndex),
-                                              _tuneFileSearch, _cacheSize);
+                                              _tuneFileSearch, _cacheSize, _hotWords, _postingListCache);
+}
+
+void
+IndexManager::MaintainerOperations::saveHotWords() const
+{
+    if (_hotWords && (_hotWords->size() > 0)) {
+        _hotWords->save(_hotWordsFileName);
+    }
 }
 
 bool
@@ -72,6 +121,8 @@ IndexManager::MaintainerOperations::runFusion(const Schema &schema,
     SerialNumFileHeaderContext fileHeaderContext(_fileHeaderContext, serialNum);
     Fusion fusion(schema, outputDir, sources, selectorArray,
                   _tuneFileIndexing, fileHeaderContext);
+    fusion.set_max_merge_memory(_fusionMaxMergeMemory);
+    fusion.set_block_docid_pos_index_format(_fusionBlockDocIds);
     return fusion.merge(_threadingService.shared(), std::move(flush_token));
 }
 
@@ -86,14 +137,20 @@ IndexManager::IndexManager(const vespalib::string &baseDir,
                            const search::TuneFileIndexManager &tuneFileIndexManager,
                            const search::TuneFileAttributes &tuneFileAttributes,
                            const FileHeaderContext &fileHeaderContext) :
-    _operations(fileHeaderContext, tuneFileIndexManager, indexConfig.cacheSize, threadingService),
+    _operations(fileHeaderContext, tuneFileIndexManager, indexConfig.cacheSize, threadingService,
+                baseDir, indexConfig.hotWords, indexConfig.postingListCacheSize,
+                indexConfig.flushMaxConcurrentFields, indexConfig.fusionMaxMergeMemory, indexConfig.fusionBlockDocIds,
+                indexConfig.memoryIndexPushShards, indexConfig.memoryIndexCompressMinDocs),
     _maintainer(IndexMaintainerConfig(baseDir, indexConfig.warmup, indexConfig.maxFlushed, schema, serialNum, tuneFileAttributes),
                 IndexMaintainerContext(threadingService, reconfigurer, fileHeaderContext, warmupExecutor),
                 _operations)
 {
 }
 
-IndexManager::~IndexManager() = default;
+IndexManager::~IndexManager()
+{
+    _operations.saveHotWords();
+}
 
 void
 IndexManager::compactLidSpace(uint32_t lidLimit, SerialNum serialNum)
@@ -7,20 +7,49 @@
 #include <vespa/searchcorespi/index/ithreadingservice.h>
 #include <vespa/searchcorespi/index/warmupconfig.h>
 
+namespace search::diskindex {
+class HotWords;
+class PostingListCache;
+}
+
 namespace proton::index {
 
 struct IndexConfig {
     using WarmupConfig = searchcorespi::index::WarmupConfig;
     IndexConfig() : IndexConfig(WarmupConfig(), 2, 0) { }
-    IndexConfig(WarmupConfig warmup_, size_t maxFlushed_, size_t cacheSize_)
+    IndexConfig(WarmupConfig warmup_, size_t maxFlushed_, size_t cacheSize_, size_t hotWords_ = 0,
+                size_t postingListCacheSize_ = 0, uint32_t flushMaxConcurrentFields_ = 1,
+                size_t fusionMaxMergeMemory_ = 0, bool fusionBlockDocIds_ = false,
+                uint32_t memoryIndexPushShards_ = 1, uint32_t memoryIndexCompressMinDocs_ = 0)
         : warmup(warmup_),
           maxFlushed(maxFlushed_),
-          cacheSize(cacheSize_)
+          cacheSize(cacheSize_),
+          hotWords(hotWords_),
+          postingListCacheSize(postingListCacheSize_),
+          flushMaxConcurrentFields(flushMaxConcurrentFields_),
+          fusionMaxMergeMemory(fusionMaxMergeMemory_),
+          fusionBlockDocIds(fusionBlockDocIds_),
+          memoryIndexPushShards(memoryIndexPushShards_),
+          memoryIndexCompressMinDocs(memoryIndexCompressMinDocs_)
     { }
 
     const WarmupConfig warmup;
     const size_t       maxFlushed;
     const size_t       cacheSize;
+    // Number of hot words to record and prefetch when loading disk indexes, 0 disables
+    const size_t       hotWords;
+    // Max bytes of posting lists cached across disk indexes, 0 disables
+    const size_t       postingListCacheSize;
+    // Max number of fields written in parallel when flushing a memory index
+    const uint32_t     flushMaxConcurrentFields;
+    // Max estimated bytes used by field mergers running in parallel during fusion, 0 means no limit
+    const size_t       fusionMaxMergeMemory;
+    // Store posting list docids in bit-packed blocks in disk indexes written by fusion
+    const bool         fusionBlockDocIds;
+    // Number of shards each field dictionary in a memory index is split into for parallel pushing
+    const uint32_t     memoryIndexPushShards;
+    // Min docs added to a memory index posting list before it is compressed, 0 disables
+    const uint32_t     memoryIndexCompressMinDocs;
 };
 
 /**
@@ -37,6 +66,15 @@ public:
         using IDiskIndex = searchcorespi::index::IDiskIndex;
         using IMemoryIndex = searchcorespi::index::IMemoryIndex;
         const size_t _cacheSize;
+        const size_t _maxHotWords;
+        const vespalib::string _hotWordsFileName;
+        std::shared_ptr<search::diskindex::HotWords> _hotWords;
+        std::shared_ptr<search::diskindex::PostingListCache> _postingListCache;
+        const uint32_t _flushMaxConcurrentFields;
+        const size_t _fusionMaxMergeMemory;
+        const bool _fusionBlockDocIds;
+        const uint32_t _memoryIndexPushShards;
+        const uint32_t _memoryIndexCompressMinDocs;
         const search::common::FileHeaderContext &_fileHeaderContext;
         const search::TuneFileIndexing _tuneFileIndexing;
         const search::TuneFileSearch _tuneFileSearch;
@@ -46,7 +84,16 @@ public:
         MaintainerOperations(const search::common::FileHeaderContext &fileHeaderContext,
                              const search::TuneFileIndexManager &tuneFileIndexManager,
                              size_t cacheSize,
-                             searchcorespi::index::IThreadingService &threadingService);
+                             searchcorespi::index::IThreadingService &threadingService,
+                             const vespalib::string &baseDir,
+                             size_t maxHotWords,
+                             size_t postingListCacheSize,
+                             uint32_t flushMaxConcurrentFields,
+                             size_t fusionMaxMergeMemory,
+                             bool fusionBlockDocIds,
+                             uint32_t memoryIndexPushShards,
+                             uint32_t memoryIndexCompressMinDocs);
+        ~MaintainerOperations() override;
 
         IMemoryIndex::SP createMemoryIndex(const Schema& schema,
                                            const IFieldLengthInspector& inspector,
@@ -58,6 +105,7 @@ public:
                        const SelectorArray &docIdSelector,
                        search::SerialNum lastSerialNum,
                        std::shared_ptr<search::IFlushToken> flush_token) override;
+        void saveHotWords() const;
     };
 
 private:
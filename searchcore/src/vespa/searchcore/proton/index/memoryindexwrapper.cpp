@@ -5,6 +5,7 @@
 #include <vespa/searchlib/common/serialnumfileheadercontext.h>
 #include <vespa/searchlib/diskindex/indexbuilder.h>
 #include <vespa/vespalib/util/exceptions.h>
+#include <vespa/vespalib/util/io_scheduler.h>
 
 using search::SerialNum;
 using search::TuneFileIndexing;
@@ -22,24 +23,31 @@ MemoryIndexWrapper::MemoryIndexWrapper(const search::index::Schema& schema,
                                        const search::common::FileHeaderContext& fileHeaderContext,
                                        const TuneFileIndexing& tuneFileIndexing,
                                        searchcorespi::index::IThreadingService& threadingService,
+                                       uint32_t flushMaxConcurrentFields,
+                                       uint32_t numPushShards,
+                                       uint32_t postingListCompressMinDocs,
                                        search::SerialNum serialNum)
     : _index(schema, inspector, threadingService.field_writer(),
-             threadingService.field_writer()),
+             threadingService.field_writer(), numPushShards),
       _serialNum(serialNum),
       _fileHeaderContext(fileHeaderContext),
-      _tuneFileIndexing(tuneFileIndexing)
+      _tuneFileIndexing(tuneFileIndexing),
+      _flushExecutor(threadingService.shared()),
+      _flushMaxConcurrentFields(flushMaxConcurrentFields)
 {
+    _index.set_posting_list_compression(postingListCompressMinDocs);
 }
 
 void
 MemoryIndexWrapper::flushToDisk(const vespalib::string &flushDir, uint32_t docIdLimit, SerialNum serialNum)
 {
+    vespalib::IoScheduler::MyClass my_io_class(vespalib::IoScheduler::Class::FLUSH);
     const uint64_t numWords = _index.getNumWords();
     _index.freeze(); // TODO(geirst): is this needed anymore?
     IndexBuilder indexBuilder(_index.getSchema(), flushDir, docIdLimit);
     SerialNumFileHeaderContext fileHeaderContext(_fileHeaderContext, serialNum);
     indexBuilder.open(numWords, *this, _tuneFileIndexing, fileHeaderContext);
-    _index.dump(indexBuilder);
+    _index.dump(indexBuilder, _flushExecutor, _flushMaxConcurrentFields);
     indexBuilder.close();
 }
 
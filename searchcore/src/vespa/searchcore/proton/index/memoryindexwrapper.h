@@ -23,6 +23,8 @@ private:
     std::atomic<SerialNum> _serialNum;
     const search::common::FileHeaderContext &_fileHeaderContext;
     const search::TuneFileIndexing _tuneFileIndexing;
+    vespalib::Executor &_flushExecutor;
+    const uint32_t _flushMaxConcurrentFields;
 
 public:
     MemoryIndexWrapper(const search::index::Schema& schema,
@@ -30,6 +32,9 @@ public:
                        const search::common::FileHeaderContext& fileHeaderContext,
                        const search::TuneFileIndexing& tuneFileIndexing,
                        searchcorespi::index::IThreadingService& threadingService,
+                       uint32_t flushMaxConcurrentFields,
+                       uint32_t numPushShards,
+                       uint32_t postingListCompressMinDocs,
                        SerialNum serialNum);
 
     /**
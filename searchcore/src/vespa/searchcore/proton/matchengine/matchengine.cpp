@@ -5,6 +5,8 @@
 #include <vespa/vespalib/data/slime/cursor.h>
 #include <vespa/vespalib/data/smart_buffer.h>
 #include <vespa/vespalib/data/slime/binary_format.h>
+#include <vespa/vespalib/coro/completion.h>
+#include <vespa/vespalib/coro/schedule.h>
 #include <vespa/vespalib/util/size_literals.h>
 #include <vespa/vespalib/util/cpu_usage.h>
 
@@ -15,29 +17,13 @@ LOG_SETUP(".proton.matchengine.matchengine");
 using search::engine::SearchRequest;
 using search::engine::SearchReply;
 using search::engine::SearchClient;
+using vespalib::coro::Lazy;
+using vespalib::coro::Received;
 
 using namespace search::fef::indexproperties;
 
 namespace {
 
-class SearchTask : public vespalib::Executor::Task {
-private:
-    proton::MatchEngine   &_engine;
-    SearchRequest::Source  _request;
-    SearchClient          &_client;
-
-public:
-    SearchTask(proton::MatchEngine &engine, SearchRequest::Source request, SearchClient &client)
-        : _engine(engine),
-          _request(std::move(request)),
-          _client(client)
-    { }
-
-    void run() override {
-        _client.searchDone(_engine.performSearch(std::move(_request)));
-    }
-};
-
 VESPA_THREAD_STACK_TAG(match_engine_executor)
 VESPA_THREAD_STACK_TAG(match_engine_thread_bundle)
 
@@ -48,7 +34,7 @@ namespace proton {
 using namespace vespalib::slime;
 using vespalib::CpuUsage;
 
-MatchEngine::MatchEngine(size_t numThreads, size_t threadsPerSearch, uint32_t distributionKey, bool async)
+MatchEngine::MatchEngine(size_t numThreads, size_t threadsPerSearch, uint32_t distributionKey, bool async, uint32_t maxSpins)
     : _lock(),
       _distributionKey(distributionKey),
       _async(async),
@@ -58,7 +44,7 @@ MatchEngine::MatchEngine(size_t numThreads, size_t threadsPerSearch, uint32_t di
       _executor(std::max(size_t(1), numThreads / threadsPerSearch),
                 CpuUsage::wrap(match_engine_executor, CpuUsage::Category::READ)),
       _threadBundlePool(std::max(size_t(1), threadsPerSearch),
-                        CpuUsage::wrap(match_engine_thread_bundle, CpuUsage::Category::READ)),
+                        CpuUsage::wrap(match_engine_thread_bundle, CpuUsage::Category::READ), maxSpins),
       _nodeUp(false),
       _nodeMaintenance(false)
 {
@@ -109,20 +95,34 @@ MatchEngine::search(SearchRequest::Source request, SearchClient &client)
 {
     // We continue to allow searches if the node is in Maintenance mode
     if (_closed.load(std::memory_order_relaxed) || (!_nodeUp && !_nodeMaintenance.load(std::memory_order_relaxed))) {
-        auto ret = std::make_unique<SearchReply>();
-        ret->setDistributionKey(_distributionKey);
-
         // TODO: Notify closed.
 
-        return ret;
+        return make_empty_reply();
     }
     if (_async) {
-        _executor.execute(std::make_unique<SearchTask>(*this, std::move(request), client));
+        vespalib::coro::async_wait(search_async(std::move(request)), [this, &client](Received<SearchReply::UP> result) {
+            client.searchDone(result.has_value() ? std::move(result).get_value() : make_empty_reply());
+        });
         return {};
     }
     return performSearch(std::move(request));
 }
 
+Lazy<SearchReply::UP>
+MatchEngine::search_async(SearchRequest::Source request)
+{
+    co_await vespalib::coro::schedule(_executor);
+    co_return performSearch(std::move(request));
+}
+
+SearchReply::UP
+MatchEngine::make_empty_reply() const
+{
+    auto ret = std::make_unique<SearchReply>();
+    ret->setDistributionKey(_distributionKey);
+    return ret;
+}
+
 std::unique_ptr<SearchReply>
 MatchEngine::doSearch(const SearchRequest & searchRequest) {
     if (searchRequest.expired()) {
@@ -6,6 +6,7 @@
 #include <vespa/searchcore/proton/common/handlermap.hpp>
 #include <vespa/searchcore/proton/common/statusreport.h>
 #include <vespa/searchlib/engine/searchapi.h>
+#include <vespa/vespalib/coro/lazy.h>
 #include <vespa/vespalib/net/http/state_explorer.h>
 #include <vespa/vespalib/util/threadstackexecutor.h>
 #include <vespa/vespalib/util/simple_thread_bundle.h>
@@ -29,6 +30,7 @@ private:
     std::atomic<bool>                  _nodeMaintenance;
 
     std::unique_ptr<search::engine::SearchReply> doSearch(const search::engine::SearchRequest & searchRequest);
+    std::unique_ptr<search::engine::SearchReply> make_empty_reply() const;
 public:
     /**
      * Convenience typedefs.
@@ -48,8 +50,12 @@ public:
      * @param threadsPerSearch number of threads used for each search
      * @param distributionKey distributionkey of this node.
      * @param async if query is dispatched to threadpool
+     * @param maxSpins how long threads used for a single search may spin before blocking
      */
-    MatchEngine(size_t numThreads, size_t threadsPerSearch, uint32_t distributionKey, bool async);
+    MatchEngine(size_t numThreads, size_t threadsPerSearch, uint32_t distributionKey, bool async, uint32_t maxSpins);
+    MatchEngine(size_t numThreads, size_t threadsPerSearch, uint32_t distributionKey, bool async)
+        : MatchEngine(numThreads, threadsPerSearch, distributionKey, async, 0)
+    {}
     MatchEngine(size_t numThreads, size_t threadsPerSearch, uint32_t distributionKey)
         : MatchEngine(numThreads, threadsPerSearch, distributionKey, true)
     {}
@@ -125,6 +131,19 @@ public:
     std::unique_ptr<search::engine::SearchReply>
     performSearch(search::engine::SearchRequest::Source req);
 
+    /**
+     * Performs the given search request as a coroutine that moves
+     * itself to the internal worker threads before searching. Nothing
+     * happens until the returned value is awaited, which lets the
+     * search be composed with other asynchronous steps without
+     * dedicating a thread to waiting for it. Fails with
+     * ScheduleFailedException if the worker threads are shut down.
+     *
+     * @param req The search request to perform.
+     */
+    vespalib::coro::Lazy<std::unique_ptr<search::engine::SearchReply>>
+    search_async(search::engine::SearchRequest::Source req);
+
     /** obtain current online status */
     bool isOnline() const;
 
@@ -3,6 +3,7 @@
 #include "blueprintbuilder.h"
 #include "querynodes.h"
 #include "same_element_builder.h"
+#include "term_stats_cache.h"
 #include <vespa/searchcorespi/index/indexsearchable.h>
 #include <vespa/searchlib/query/tree/customtypevisitor.h>
 #include <vespa/searchlib/queryeval/leaf_blueprints.h>
@@ -10,6 +11,8 @@
 #include <vespa/searchlib/queryeval/equiv_blueprint.h>
 #include <vespa/searchlib/queryeval/get_weight_from_node.h>
 #include <vespa/vespalib/util/issue.h>
+#include <algorithm>
+#include <limits>
 
 using namespace search::queryeval;
 using search::query::Node;
@@ -126,6 +129,29 @@ private:
         n.setDocumentFrequency(_result->getState().estimate().estHits, _context.getDocIdLimit());
     }
 
+    // Use cached global statistics for the document frequency of the term if present for all its fields
+    void apply_term_stats(ProtonStringTerm &n) {
+        const TermStatsCache *term_stats = _context.getTermStats();
+        if ((term_stats == nullptr) || (n.numFields() == 0)) {
+            return;
+        }
+        TermStatsCache::Stats global;
+        for (size_t i = 0; i < n.numFields(); ++i) {
+            auto stats = term_stats->lookup(n.field(i).getName(), n.getTerm());
+            if (!stats.has_value()) {
+                return;
+            }
+            global.matching_doc_count = std::max(global.matching_doc_count, stats->matching_doc_count);
+            global.total_doc_count = std::max(global.total_doc_count, stats->total_doc_count);
+        }
+        if (global.total_doc_count > 0) {
+            uint64_t limit = std::numeric_limits<uint32_t>::max() - 1;
+            uint64_t total = std::min(global.total_doc_count, limit);
+            uint64_t matching = std::min(global.matching_doc_count, total);
+            n.setDocumentFrequency(matching, total + 1);
+        }
+    }
+
 protected:
     void visit(ProtonAnd &n)         override { buildIntermediate(new AndBlueprint(), n); }
     void visit(ProtonAndNot &n)      override { buildIntermediate(new AndNotBlueprint(), n); }
@@ -146,7 +172,7 @@ protected:
     void visit(ProtonLocationTerm &n)    override { buildTerm(n); }
     void visit(ProtonPrefixTerm &n)      override { buildTerm(n); }
     void visit(ProtonRangeTerm &n)       override { buildTerm(n); }
-    void visit(ProtonStringTerm &n)      override { buildTerm(n); }
+    void visit(ProtonStringTerm &n)      override { buildTerm(n); apply_term_stats(n); }
     void visit(ProtonSubstringTerm &n)   override { buildTerm(n); }
     void visit(ProtonSuffixTerm &n)      override { buildTerm(n); }
     void visit(ProtonPredicateQuery &n)  override { buildTerm(n); }
@@ -1,6 +1,7 @@
 // Copyright Vespa.ai. Licensed under the terms of the Apache 2.0 license. See LICENSE in the project root.
 
 #include "docid_range_scheduler.h"
+#include <vespa/vespalib/util/numa_topology.h>
 #include <cassert>
 
 namespace proton::matching {
@@ -164,4 +165,91 @@ AdaptiveDocidRangeScheduler::share_range(size_t thread_id, DocidRange todo)
 
 //-----------------------------------------------------------------------------
 
+DocidRange
+NumaDocidRangeScheduler::next_task(size_t thread_id)
+{
+    size_t node_id = _node_of_thread(thread_id) % _nodes.size();
+    std::lock_guard<std::mutex> guard(_lock);
+    Node *node = &_nodes[node_id];
+    DocidRange work;
+    if (node->tasks_left() > 0) {
+        work = _splitter.get(node->next_task++);
+        ++_local[thread_id];
+    } else {
+        for (Node &victim: _nodes) {
+            if (victim.tasks_left() > node->tasks_left()) {
+                node = &victim;
+            }
+        }
+        if (node->tasks_left() == 0) {
+            return DocidRange();
+        }
+        work = _splitter.get(--node->end_task);
+        ++_stolen[thread_id];
+    }
+    _assigned[thread_id] += work.size();
+    size_t todo = _unassigned.load(std::memory_order_relaxed);
+    _unassigned.store(clamped_sub(todo, work.size()), std::memory_order_relaxed);
+    return work;
+}
+
+NumaDocidRangeScheduler::NumaDocidRangeScheduler(size_t num_threads, const std::vector<size_t> &node_weights,
+                                                 NodeResolver node_of_thread, size_t tasks_per_thread,
+                                                 uint32_t docid_limit)
+    : _lock(),
+      _splitter(DocidRange(1, docid_limit), std::max(num_threads, size_t(1)) * std::max(tasks_per_thread, size_t(1))),
+      _nodes(),
+      _node_of_thread(std::move(node_of_thread)),
+      _assigned(num_threads, 0),
+      _local(num_threads, 0),
+      _stolen(num_threads, 0),
+      _unassigned(0)
+{
+    size_t num_tasks = std::max(num_threads, size_t(1)) * std::max(tasks_per_thread, size_t(1));
+    size_t num_nodes = std::max(node_weights.size(), size_t(1));
+    auto weight_of = [&](size_t node) noexcept {
+        return (node < node_weights.size()) ? std::max(node_weights[node], size_t(1)) : size_t(1);
+    };
+    size_t total_weight = 0;
+    for (size_t node = 0; node < num_nodes; ++node) {
+        total_weight += weight_of(node);
+    }
+    // each node owns a consecutive block of tasks in proportion to its weight
+    _nodes.reserve(num_nodes);
+    size_t acc_weight = 0;
+    size_t begin_task = 0;
+    for (size_t node = 0; node < num_nodes; ++node) {
+        acc_weight += weight_of(node);
+        size_t end_task = (num_tasks * acc_weight) / total_weight;
+        _nodes.emplace_back(begin_task, end_task);
+        begin_task = end_task;
+    }
+    _unassigned.store(_splitter.full_range().size(), std::memory_order_relaxed);
+}
+
+NumaDocidRangeScheduler::~NumaDocidRangeScheduler() = default;
+
+std::unique_ptr<NumaDocidRangeScheduler>
+NumaDocidRangeScheduler::make(size_t num_threads, const vespalib::NumaTopology &topology,
+                              size_t max_nodes, size_t tasks_per_thread, uint32_t docid_limit)
+{
+    size_t num_nodes = std::clamp(max_nodes, size_t(1), topology.num_nodes());
+    std::vector<size_t> weights(num_nodes, 0);
+    for (size_t node = 0; node < topology.num_nodes(); ++node) {
+        weights[node % num_nodes] += topology.num_cpus(node);
+    }
+    auto node_of_thread = [&topology, num_nodes](size_t) noexcept {
+        return topology.current_node() % num_nodes;
+    };
+    return std::make_unique<NumaDocidRangeScheduler>(num_threads, weights, node_of_thread, tasks_per_thread, docid_limit);
+}
+
+DocidRange
+NumaDocidRangeScheduler::node_range(size_t node) const
+{
+    return DocidRange(_splitter.get(_nodes[node].next_task).begin, _splitter.get(_nodes[node].end_task).begin);
+}
+
+//-----------------------------------------------------------------------------
+
 }
@@ -7,8 +7,12 @@
 #include <condition_variable>
 #include <atomic>
 #include <algorithm>
+#include <functional>
+#include <memory>
 #include <vector>
 
+namespace vespalib { class NumaTopology; }
+
 #define VESPA_DLL_LOCAL  __attribute__ ((visibility("hidden")))
 
 namespace proton::matching {
@@ -103,6 +107,12 @@ public:
  * will return the remaining work to be done by the thread calling
  * it. The returned range is guaranteed to be a prefix of the range
  * passed as input to the 'share_range' function.
+ *
+ * The 'local_ranges' and 'stolen_ranges' functions report how many of
+ * the ranges assigned to the given worker came from the part of the
+ * docid space owned by the worker versus the part owned by other
+ * workers. Schedulers without any notion of ownership report 0 for
+ * both.
  **/
 struct DocidRangeScheduler {
     using UP = std::unique_ptr<DocidRangeScheduler>;
@@ -112,6 +122,8 @@ struct DocidRangeScheduler {
     virtual size_t unassigned_size() const = 0;
     virtual IdleObserver make_idle_observer() const = 0;
     virtual DocidRange share_range(size_t thread_id, DocidRange todo) = 0;
+    virtual size_t local_ranges(size_t thread_id) const = 0;
+    virtual size_t stolen_ranges(size_t thread_id) const = 0;
     virtual ~DocidRangeScheduler() {}
 };
 
@@ -133,6 +145,8 @@ public:
     size_t unassigned_size() const override { return 0; }
     IdleObserver make_idle_observer() const override { return IdleObserver(); }
     DocidRange share_range(size_t, DocidRange todo) override { return todo; }
+    size_t local_ranges(size_t) const override { return 0; }
+    size_t stolen_ranges(size_t) const override { return 0; }
 };
 
 /**
@@ -160,6 +174,8 @@ public:
     size_t unassigned_size() const override { return _unassigned.load(std::memory_order_relaxed); }
     IdleObserver make_idle_observer() const override { return IdleObserver(); }
     DocidRange share_range(size_t, DocidRange todo) override { return todo; }
+    size_t local_ranges(size_t) const override { return 0; }
+    size_t stolen_ranges(size_t) const override { return 0; }
 };
 
 /**
@@ -199,6 +215,66 @@ public:
     size_t unassigned_size() const override { return 0; }
     IdleObserver make_idle_observer() const override { return IdleObserver(_num_idle); }
     DocidRange share_range(size_t, DocidRange todo) override;
+    size_t local_ranges(size_t) const override { return 0; }
+    size_t stolen_ranges(size_t) const override { return 0; }
+};
+
+/**
+ * A NUMA aware scheduler dividing the total docid space into
+ * num_threads * tasks_per_thread tasks of equal size, where each
+ * NUMA node owns a consecutive part of the tasks in proportion to its
+ * weight (typically its number of cpus). Each time a worker asks for
+ * work, it is given the next task (in increasing docid order) owned
+ * by the node it is currently running on, as reported by the node
+ * resolver. Threads are not pinned, so a worker may move between
+ * nodes while matching. When the current node has no tasks left, the
+ * worker steals the last task from the node with the most tasks left,
+ * letting the workers of that node continue with their own tasks
+ * undisturbed for as long as possible.
+ **/
+class NumaDocidRangeScheduler : public DocidRangeScheduler
+{
+public:
+    // Returns the NUMA node the given worker thread is currently running on
+    using NodeResolver = std::function<size_t(size_t thread_id)>;
+private:
+    struct Node {
+        size_t next_task;
+        size_t end_task;
+        Node(size_t begin_task, size_t end_task_in) noexcept
+            : next_task(begin_task), end_task(end_task_in) {}
+        size_t tasks_left() const noexcept { return (end_task - next_task); }
+    };
+    std::mutex          _lock;
+    DocidRangeSplitter  _splitter;
+    std::vector<Node>   _nodes;
+    NodeResolver        _node_of_thread;
+    std::vector<size_t> _assigned;
+    std::vector<size_t> _local;
+    std::vector<size_t> _stolen;
+    std::atomic<size_t> _unassigned;
+
+    VESPA_DLL_LOCAL DocidRange next_task(size_t thread_id);
+public:
+    NumaDocidRangeScheduler(size_t num_threads, const std::vector<size_t> &node_weights, NodeResolver node_of_thread,
+                            size_t tasks_per_thread, uint32_t docid_limit);
+    ~NumaDocidRangeScheduler() override;
+    // Schedules across the nodes of the given topology, weighted by their number of
+    // cpus. Nodes beyond 'max_nodes' are folded onto the first ones. The topology
+    // must outlive the scheduler.
+    static std::unique_ptr<NumaDocidRangeScheduler> make(size_t num_threads, const vespalib::NumaTopology &topology,
+                                                         size_t max_nodes, size_t tasks_per_thread, uint32_t docid_limit);
+    size_t num_nodes() const { return _nodes.size(); }
+    // the docids initially owned by the given node
+    DocidRange node_range(size_t node) const;
+    DocidRange first_range(size_t thread_id) override { return next_task(thread_id); }
+    DocidRange next_range(size_t thread_id) override { return next_task(thread_id); }
+    size_t total_size(size_t thread_id) const override { return _assigned[thread_id]; }
+    size_t unassigned_size() const override { return _unassigned.load(std::memory_order_relaxed); }
+    IdleObserver make_idle_observer() const override { return IdleObserver(); }
+    DocidRange share_range(size_t, DocidRange todo) override { return todo; }
+    size_t local_ranges(size_t thread_id) const override { return _local[thread_id]; }
+    size_t stolen_ranges(size_t thread_id) const override { return _stolen[thread_id]; }
 };
 
 }
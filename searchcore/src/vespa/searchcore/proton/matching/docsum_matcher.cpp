@@ -147,12 +147,21 @@ DocsumMatcher::~DocsumMatcher() {
     }
 }
 
-FeatureSet::UP
+FeatureSet::SP
 DocsumMatcher::get_summary_features() const
 {
     if (!_mtf) {
         return std::make_unique<FeatureSet>();
     }
+    if (_from_session) {
+        const auto &precomputed = _from_session->get_summary_features();
+        if (precomputed && precomputed->contains(_docs)) {
+            if (auto onSummaryTask = _mtf->createOnSummaryTask()) {
+                onSummaryTask->run(_docs);
+            }
+            return precomputed;
+        }
+    }
     return get_feature_set(*_mtf, _docs, true);
 }
 
@@ -38,7 +38,7 @@ public:
 
     using UP = std::unique_ptr<DocsumMatcher>;
 
-    FeatureSet::UP get_summary_features() const;
+    FeatureSet::SP get_summary_features() const;
     FeatureSet::UP get_rank_features() const;
     MatchingElements::UP get_matching_elements(const MatchingElementsFields &fields) const;
 };
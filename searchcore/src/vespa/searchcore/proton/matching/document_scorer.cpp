@@ -27,7 +27,8 @@ extractScoreFeature(const RankProgram &rankProgram)
 
 DocumentScorer::DocumentScorer(RankProgram &rankProgram,
                                SearchIterator &searchItr)
-    : _searchItr(searchItr),
+    : _rankProgram(rankProgram),
+      _searchItr(searchItr),
       _scoreFeature(extractScoreFeature(rankProgram))
 {
 }
@@ -40,10 +41,38 @@ DocumentScorer::score(TaggedHits &hits)
     }
     auto sort_on_docid = [](const TaggedHit &a, const TaggedHit &b){ return (a.first.first < b.first.first); };
     std::sort(hits.begin(), hits.end(), sort_on_docid);
+    size_t batch_size = _rankProgram.max_batch_size();
+    if (batch_size > 1) {
+        score_batched(hits, batch_size);
+        return;
+    }
     _searchItr.initRange(hits.front().first.first, hits.back().first.first + 1);
     for (auto &hit: hits) {
         hit.first.second = doScore(hit.first.first);
     }
 }
 
+void
+DocumentScorer::score_batched(TaggedHits &hits, size_t batch_size)
+{
+    // each batch is visited twice; first to collect inputs for the
+    // batched executors, then to calculate the score of each hit.
+    for (size_t begin = 0; begin < hits.size(); begin += batch_size) {
+        size_t end = std::min(hits.size(), begin + batch_size);
+        uint32_t first_docid = hits[begin].first.first;
+        uint32_t last_docid = hits[end - 1].first.first;
+        _searchItr.initRange(first_docid, last_docid + 1);
+        for (size_t i = begin; i < end; ++i) {
+            uint32_t docid = hits[i].first.first;
+            _searchItr.unpack(docid);
+            _rankProgram.add_to_batch(docid);
+        }
+        _rankProgram.execute_batch();
+        _searchItr.initRange(first_docid, last_docid + 1);
+        for (size_t i = begin; i < end; ++i) {
+            hits[i].first.second = doScore(hits[i].first.first);
+        }
+    }
+}
+
 }
@@ -20,14 +20,17 @@ namespace proton::matching {
  */
 class DocumentScorer
 {
+public:
+    using TaggedHit = IMatchLoopCommunicator::TaggedHit;
+    using TaggedHits = IMatchLoopCommunicator::TaggedHits;
 private:
+    search::fef::RankProgram &_rankProgram;
     search::queryeval::SearchIterator &_searchItr;
     search::fef::LazyValue _scoreFeature;
 
-public:
-    using TaggedHit = IMatchLoopCommunicator::TaggedHit;
-    using TaggedHits = IMatchLoopCommunicator::TaggedHits;
+    void score_batched(TaggedHits &hits, size_t batch_size);
 
+public:
     DocumentScorer(search::fef::RankProgram &rankProgram,
                    search::queryeval::SearchIterator &searchItr);
 
@@ -11,6 +11,7 @@
 #include <vespa/searchlib/fef/rank_program.h>
 #include <vespa/searchlib/fef/utils.h>
 #include <vespa/searchlib/queryeval/searchiterator.h>
+#include <algorithm>
 
 using vespalib::Doom;
 using vespalib::FeatureSet;
@@ -69,51 +70,35 @@ struct FirstChunk : MyChunk {
     void run() override { calculate_features(search, resolver); }
 };
 
+using SetupProgram = void (MatchTools::*)();
+
 struct LaterChunk : MyChunk {
     const MatchToolsFactory &mtf;
+    SetupProgram setup_program;
     LaterChunk(const std::pair<uint32_t,uint32_t> *begin_in,
                const std::pair<uint32_t,uint32_t> *end_in,
                FeatureValues &result_in,
                const Doom &doom_in,
-               const MatchToolsFactory &mtf_in)
+               const MatchToolsFactory &mtf_in,
+               SetupProgram setup_program_in)
       : MyChunk(begin_in, end_in, result_in, doom_in),
-        mtf(mtf_in) {}
+        mtf(mtf_in),
+        setup_program(setup_program_in) {}
     void run() override {
         auto tools = mtf.createMatchTools();
-        tools->setup_match_features();
+        ((*tools).*setup_program)();
         FeatureResolver resolver(tools->rank_program().get_seeds(false));
         calculate_features(tools->search(), resolver);
     }
 };
 
-} // unnamed
-
-FeatureSet::UP
-ExtractFeatures::get_feature_set(SearchIterator &search, RankProgram &rank_program, const std::vector<uint32_t> &docs,
-                                 const Doom &doom, const StringStringMap &renames)
-{
-    FeatureResolver resolver(rank_program.get_seeds(false));
-    auto result = std::make_unique<FeatureSet>(FefUtils::extract_feature_names(resolver, renames), docs.size());
-    if (!docs.empty()) {
-        search.initRange(docs.front(), docs.back()+1);
-        for (uint32_t docid: docs) {
-            if (doom.hard_doom()) {
-                return result;
-            }
-            search.unpack(docid);
-            auto *dst = result->getFeaturesByIndex(result->addDocId(docid));
-            FefUtils::extract_feature_values(resolver, docid, dst);
-        }
-    }
-    return result;
-}
-
 FeatureValues
-ExtractFeatures::get_match_features(const MatchToolsFactory &mtf, const OrderedDocs &docs, ThreadBundle &thread_bundle)
+get_feature_values(const MatchToolsFactory &mtf, const OrderedDocs &docs, ThreadBundle &thread_bundle,
+                   SetupProgram setup_program, bool &hard_doomed)
 {
     FeatureValues result;
     auto tools = mtf.createMatchTools();
-    tools->setup_match_features();
+    ((*tools).*setup_program)();
     FeatureResolver resolver(tools->rank_program().get_seeds(false));
     result.names = FefUtils::extract_feature_names(resolver, mtf.get_feature_rename_map());
     result.values.resize(result.names.size() * docs.size());
@@ -131,12 +116,61 @@ ExtractFeatures::get_match_features(const MatchToolsFactory &mtf, const OrderedD
         if (i == 0) {
             chunks.push_back(std::make_unique<FirstChunk>(&docs[idx], &docs[idx + chunk_size], result, tools->getDoom(), tools->search(), resolver));
         } else {
-            chunks.push_back(std::make_unique<LaterChunk>(&docs[idx], &docs[idx + chunk_size], result, tools->getDoom(), mtf));
+            chunks.push_back(std::make_unique<LaterChunk>(&docs[idx], &docs[idx + chunk_size], result, tools->getDoom(), mtf, setup_program));
         }
         idx += chunk_size;
     }
     assert(idx == docs.size());
     thread_bundle.run(chunks);
+    hard_doomed = tools->getDoom().hard_doom();
+    return result;
+}
+
+} // unnamed
+
+FeatureSet::UP
+ExtractFeatures::get_feature_set(SearchIterator &search, RankProgram &rank_program, const std::vector<uint32_t> &docs,
+                                 const Doom &doom, const StringStringMap &renames)
+{
+    FeatureResolver resolver(rank_program.get_seeds(false));
+    auto result = std::make_unique<FeatureSet>(FefUtils::extract_feature_names(resolver, renames), docs.size());
+    if (!docs.empty()) {
+        search.initRange(docs.front(), docs.back()+1);
+        for (uint32_t docid: docs) {
+            if (doom.hard_doom()) {
+                return result;
+            }
+            search.unpack(docid);
+            auto *dst = result->getFeaturesByIndex(result->addDocId(docid));
+            FefUtils::extract_feature_values(resolver, docid, dst);
+        }
+    }
+    return result;
+}
+
+FeatureValues
+ExtractFeatures::get_match_features(const MatchToolsFactory &mtf, const OrderedDocs &docs, ThreadBundle &thread_bundle)
+{
+    bool hard_doomed = false;
+    return get_feature_values(mtf, docs, thread_bundle, &MatchTools::setup_match_features, hard_doomed);
+}
+
+FeatureSet::UP
+ExtractFeatures::get_summary_features(const MatchToolsFactory &mtf, const OrderedDocs &docs, ThreadBundle &thread_bundle)
+{
+    bool hard_doomed = false;
+    auto values = get_feature_values(mtf, docs, thread_bundle, &MatchTools::setup_summary, hard_doomed);
+    if (hard_doomed) {
+        // some documents may be missing their features
+        return {};
+    }
+    auto result = std::make_unique<FeatureSet>(values.names, docs.size());
+    size_t num_features = values.names.size();
+    for (const auto &doc: docs) {
+        auto *dst = result->getFeaturesByIndex(result->addDocId(doc.first));
+        auto *src = &values.values[doc.second * num_features];
+        std::move(src, src + num_features, dst);
+    }
     return result;
 }
 
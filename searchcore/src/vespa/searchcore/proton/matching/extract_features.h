@@ -37,6 +37,12 @@ struct ExtractFeatures {
      * Extract match features using multiple threads.
      **/
     static FeatureValues get_match_features(const MatchToolsFactory &mtf, const OrderedDocs &docs, ThreadBundle &thread_bundle);
+
+    /**
+     * Extract summary features using multiple threads. The result is
+     * empty if the calculation was aborted by hard doom.
+     **/
+    static FeatureSet::UP get_summary_features(const MatchToolsFactory &mtf, const OrderedDocs &docs, ThreadBundle &thread_bundle);
 };
 
 }
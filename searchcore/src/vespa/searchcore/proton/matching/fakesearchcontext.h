@@ -30,6 +30,7 @@ private:
     IndexCollection::SP                    _indexes;
     FakeSearchable                         _attrSearchable;
     uint32_t                               _docIdLimit;
+    std::shared_ptr<const TermStatsCache>  _termStats;
 
 public:
     FakeSearchContext(size_t initialNumDocs=0);
@@ -45,6 +46,11 @@ public:
         return *this;
     }
 
+    FakeSearchContext &setTermStats(std::shared_ptr<const TermStatsCache> termStats) {
+        _termStats = std::move(termStats);
+        return *this;
+    }
+
     FakeSearchable &attr() { return _attrSearchable; }
 
     FakeIndexSearchable &idx(uint32_t i) {
@@ -65,6 +71,10 @@ public:
     uint32_t getDocIdLimit() override {
         return _docIdLimit;
     }
+
+    const TermStatsCache *getTermStats() override {
+        return _termStats.get();
+    }
     virtual const vespalib::Doom & getDoom() const { return _doom; }
 };
 
@@ -0,0 +1,79 @@
+// Copyright Vespa.ai. Licensed under the terms of the Apache 2.0 license. See LICENSE in the project root.
+
+#include "global_filter_cache.h"
+#include <vespa/searchlib/queryeval/global_filter.h>
+#include <vespa/vespalib/objects/nbostream.h>
+#include <vespa/vespalib/stllike/cache.hpp>
+
+using search::queryeval::GlobalFilter;
+
+namespace proton::matching {
+
+size_t
+GlobalFilterCache::EntrySize::operator()(const Entry &entry) const noexcept
+{
+    return entry.filter ? memory_used(*entry.filter) : 0;
+}
+
+GlobalFilterCache::GlobalFilterCache(size_t max_bytes, vespalib::duration min_cost, vespalib::duration max_age)
+    : _store(),
+      _cache(_store, max_bytes),
+      _min_cost(min_cost),
+      _max_age(max_age)
+{
+}
+
+GlobalFilterCache::~GlobalFilterCache() = default;
+
+vespalib::string
+GlobalFilterCache::make_key(vespalib::stringref stack_dump, vespalib::stringref location)
+{
+    vespalib::nbostream os;
+    os << location << stack_dump;
+    return {os.data(), os.size()};
+}
+
+size_t
+GlobalFilterCache::memory_used(const GlobalFilter &filter)
+{
+    size_t result = sizeof(GlobalFilter);
+    if (filter.is_active()) {
+        result += filter.size() / 8;
+    }
+    return result;
+}
+
+std::shared_ptr<GlobalFilter>
+GlobalFilterCache::lookup(const Key &key, vespalib::steady_time now)
+{
+    Entry entry = _cache.read(key.query);
+    if (!entry.filter) {
+        return {};
+    }
+    if ((entry.generation != key.generation) || (entry.num_active_lids != key.num_active_lids) ||
+        (entry.docid_limit != key.docid_limit) || ((now - entry.created) > _max_age))
+    {
+        _cache.invalidate(key.query);
+        return {};
+    }
+    return std::move(entry.filter);
+}
+
+bool
+GlobalFilterCache::insert(const Key &key, vespalib::steady_time now, std::shared_ptr<GlobalFilter> filter,
+                          vespalib::duration cost)
+{
+    if (!filter || (cost < _min_cost)) {
+        return false;
+    }
+    Entry entry;
+    entry.filter = std::move(filter);
+    entry.generation = key.generation;
+    entry.num_active_lids = key.num_active_lids;
+    entry.docid_limit = key.docid_limit;
+    entry.created = now;
+    _cache.write(key.query, std::move(entry));
+    return true;
+}
+
+}
@@ -0,0 +1,81 @@
+// Copyright Vespa.ai. Licensed under the terms of the Apache 2.0 license. See LICENSE in the project root.
+
+#pragma once
+
+#include <vespa/vespalib/stllike/cache.h>
+#include <vespa/vespalib/stllike/string.h>
+#include <vespa/vespalib/util/time.h>
+#include <memory>
+
+namespace search::queryeval { class GlobalFilter; }
+
+namespace proton::matching {
+
+/**
+ * Memory bounded LRU cache of global filters for a single rank
+ * profile, keyed on the query tree and location of the query. Query
+ * tensors are passed as rank properties and are not part of the key,
+ * so nearest neighbor queries with the same filter terms share the
+ * cached filter.
+ *
+ * Like ResultCache, each entry remembers the generation and the number
+ * of active documents of the document meta store, and the docid limit,
+ * when the filter was calculated, and is only used while all are
+ * unchanged and the entry is younger than the max age. Filters are only
+ * admitted if calculating them took at least the min cost.
+ **/
+class GlobalFilterCache
+{
+public:
+    using GlobalFilter = search::queryeval::GlobalFilter;
+
+    struct Key {
+        vespalib::string query;
+        uint64_t         generation;
+        uint32_t         num_active_lids;
+        uint32_t         docid_limit;
+        Key(vespalib::string query_in, uint64_t generation_in, uint32_t num_active_lids_in, uint32_t docid_limit_in)
+            : query(std::move(query_in)),
+              generation(generation_in),
+              num_active_lids(num_active_lids_in),
+              docid_limit(docid_limit_in)
+        {}
+    };
+private:
+    struct Entry {
+        std::shared_ptr<GlobalFilter> filter;
+        uint64_t                      generation;
+        uint32_t                      num_active_lids;
+        uint32_t                      docid_limit;
+        vespalib::steady_time         created;
+        Entry() noexcept : filter(), generation(0), num_active_lids(0), docid_limit(0), created() {}
+    };
+    struct EntrySize {
+        size_t operator()(const Entry &entry) const noexcept;
+    };
+    using Cache = vespalib::cache<vespalib::CacheParam<vespalib::LruParam<vespalib::string, Entry>,
+                                                       vespalib::NullStore<vespalib::string, Entry>,
+                                                       vespalib::zero<vespalib::string>, EntrySize>>;
+    vespalib::NullStore<vespalib::string, Entry> _store;
+    Cache                                        _cache;
+    vespalib::duration                           _min_cost;
+    vespalib::duration                           _max_age;
+public:
+    GlobalFilterCache(size_t max_bytes, vespalib::duration min_cost, vespalib::duration max_age);
+    GlobalFilterCache(const GlobalFilterCache &) = delete;
+    GlobalFilterCache & operator =(const GlobalFilterCache &) = delete;
+    ~GlobalFilterCache();
+
+    static vespalib::string make_key(vespalib::stringref stack_dump, vespalib::stringref location);
+    // Approximate memory used by the given filter
+    static size_t memory_used(const GlobalFilter &filter);
+
+    std::shared_ptr<GlobalFilter> lookup(const Key &key, vespalib::steady_time now);
+    // Returns whether the filter was admitted
+    bool insert(const Key &key, vespalib::steady_time now, std::shared_ptr<GlobalFilter> filter,
+                vespalib::duration cost);
+    size_t size() const { return _cache.size(); }
+    size_t memory_used() const { return _cache.sizeBytes(); }
+};
+
+}
@@ -3,6 +3,7 @@
 #pragma once
 
 #include <vespa/searchlib/queryeval/scores.h>
+#include <vespa/searchlib/queryeval/shared_score_threshold.h>
 #include <vespa/searchlib/queryeval/sorted_hit_sequence.h>
 #include <utility>
 #include <cstddef>
@@ -19,6 +20,7 @@ struct IMatchLoopCommunicator {
     using Hits = std::vector<Hit>;
     using TaggedHit = std::pair<Hit,size_t>;
     using TaggedHits = std::vector<TaggedHit>;
+    using SharedScoreThreshold = search::queryeval::SharedScoreThreshold;
     struct Matches {
         size_t hits;
         size_t docs;
@@ -32,6 +34,8 @@ struct IMatchLoopCommunicator {
     virtual double estimate_match_frequency(const Matches &matches) = 0;
     virtual TaggedHits get_second_phase_work(SortedHitSequence sortedHits, size_t thread_id) = 0;
     virtual std::pair<Hits,RangePair> complete_second_phase(TaggedHits my_results, size_t thread_id) = 0;
+    // First phase score threshold shared by all match threads, used without rendezvous
+    virtual SharedScoreThreshold &first_phase_threshold() = 0;
     virtual ~IMatchLoopCommunicator() {}
 };
 
@@ -43,6 +43,10 @@ extract_virtual_fields(const std::vector<search::fef::FieldInfo>& fields)
 
 namespace proton::matching {
 
+UsedRankingAssets::UsedRankingAssets() = default;
+UsedRankingAssets::UsedRankingAssets(const UsedRankingAssets &) = default;
+UsedRankingAssets::~UsedRankingAssets() = default;
+
 void
 IndexEnvironment::extractFields(const search::index::Schema &schema)
 {
@@ -109,7 +113,9 @@ IndexEnvironment::IndexEnvironment(uint32_t distributionKey,
     _fields(),
     _motivation(UNKNOWN),
     _rankingAssetsRepo(rankingAssetsRepo),
-    _distributionKey(distributionKey)
+    _distributionKey(distributionKey),
+    _usedAssetsLock(),
+    _usedAssets()
 {
     _tableManager.addFactory(std::make_shared<search::fef::FunctionTableFactory>(256));
     extractFields(schema);
@@ -161,6 +167,43 @@ IndexEnvironment::hintFeatureMotivation(FeatureMotivation motivation) const {
     _motivation = motivation;
 }
 
+vespalib::eval::ConstantValue::UP
+IndexEnvironment::getConstantValue(const vespalib::string &name) const
+{
+    {
+        std::lock_guard guard(_usedAssetsLock);
+        _usedAssets.constants.insert(name);
+    }
+    return _rankingAssetsRepo.getConstant(name);
+}
+
+vespalib::string
+IndexEnvironment::getRankingExpression(const vespalib::string &name) const
+{
+    {
+        std::lock_guard guard(_usedAssetsLock);
+        _usedAssets.expressions.insert(name);
+    }
+    return _rankingAssetsRepo.getExpression(name);
+}
+
+const search::fef::OnnxModel *
+IndexEnvironment::getOnnxModel(const vespalib::string &name) const
+{
+    {
+        std::lock_guard guard(_usedAssetsLock);
+        _usedAssets.onnx_models.insert(name);
+    }
+    return _rankingAssetsRepo.getOnnxModel(name);
+}
+
+UsedRankingAssets
+IndexEnvironment::getUsedRankingAssets() const
+{
+    std::lock_guard guard(_usedAssetsLock);
+    return _usedAssets;
+}
+
 IndexEnvironment::~IndexEnvironment() = default;
 
 }
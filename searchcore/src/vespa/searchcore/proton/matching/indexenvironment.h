@@ -9,9 +9,23 @@
 #include <vespa/searchlib/fef/tablemanager.h>
 #include <vespa/searchcommon/common/schema.h>
 #include <vespa/eval/eval/value_cache/constant_value.h>
+#include <mutex>
+#include <set>
 
 namespace proton::matching {
 
+/**
+ * Names of the ranking assets looked up through an index environment.
+ **/
+struct UsedRankingAssets {
+    std::set<vespalib::string> constants;
+    std::set<vespalib::string> expressions;
+    std::set<vespalib::string> onnx_models;
+    UsedRankingAssets();
+    UsedRankingAssets(const UsedRankingAssets &);
+    ~UsedRankingAssets();
+};
+
 /**
  * Index environment implementation for the proton matching pipeline.
  **/
@@ -26,6 +40,8 @@ private:
     mutable FeatureMotivation              _motivation;
     const search::fef::IRankingAssetsRepo& _rankingAssetsRepo;
     uint32_t                               _distributionKey;
+    mutable std::mutex                     _usedAssetsLock;
+    mutable UsedRankingAssets              _usedAssets;
 
 
     /**
@@ -63,16 +79,15 @@ public:
     void hintFeatureMotivation(FeatureMotivation motivation) const override;
     uint32_t getDistributionKey() const override { return _distributionKey; }
 
-    vespalib::eval::ConstantValue::UP getConstantValue(const vespalib::string &name) const override {
-        return _rankingAssetsRepo.getConstant(name);
-    }
-    vespalib::string getRankingExpression(const vespalib::string &name) const override {
-        return _rankingAssetsRepo.getExpression(name);
-    }
+    vespalib::eval::ConstantValue::UP getConstantValue(const vespalib::string &name) const override;
+    vespalib::string getRankingExpression(const vespalib::string &name) const override;
+    const search::fef::OnnxModel *getOnnxModel(const vespalib::string &name) const override;
 
-    const search::fef::OnnxModel *getOnnxModel(const vespalib::string &name) const override {
-        return _rankingAssetsRepo.getOnnxModel(name);
-    }
+    /**
+     * Returns the names of all constants, expressions and onnx models
+     * looked up through this index environment so far.
+     **/
+    UsedRankingAssets getUsedRankingAssets() const;
 };
 
 }
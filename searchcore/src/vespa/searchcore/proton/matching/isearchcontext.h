@@ -9,6 +9,8 @@ namespace searchcorespi { class IndexSearchable; }
 
 namespace proton::matching {
 
+class TermStatsCache;
+
 /**
  * Interface used to expose searchable data to the matching
  * pipeline. Ownership of the objects exposed through this interface
@@ -54,6 +56,15 @@ public:
      **/
     virtual uint32_t getDocIdLimit() = 0;
 
+    /**
+     * Obtain the cached global term statistics. When present for a
+     * query term, these override the locally estimated document
+     * frequency of the term.
+     *
+     * @return term statistics, or nullptr if none are available
+     **/
+    virtual const TermStatsCache *getTermStats() = 0;
+
     /**
      * Deleting the context will trigger cleanup in the
      * implementation.
@@ -9,14 +9,26 @@ MatchLoopCommunicator::MatchLoopCommunicator(size_t threads, size_t topN)
     : MatchLoopCommunicator(threads, topN, std::unique_ptr<IDiversifier>())
 {}
 MatchLoopCommunicator::MatchLoopCommunicator(size_t threads, size_t topN, std::unique_ptr<IDiversifier> diversifier)
-    : _best_scores(),
+    : MatchLoopCommunicator(threads, topN, std::move(diversifier), 0, nullptr)
+{}
+MatchLoopCommunicator::MatchLoopCommunicator(size_t threads, size_t topN, std::unique_ptr<IDiversifier> diversifier,
+                                             uint32_t max_spins, vespalib::AdaptiveSpin *spin)
+    : _first_phase_threshold(),
+      _best_scores(),
       _best_dropped(),
-      _estimate_match_frequency(threads),
-      _get_second_phase_work(threads, topN, _best_scores, _best_dropped, std::move(diversifier)),
-      _complete_second_phase(threads, topN, _best_scores, _best_dropped)
+      _estimate_match_frequency(threads, max_spins, spin),
+      _get_second_phase_work(threads, topN, _best_scores, _best_dropped, std::move(diversifier), max_spins, spin),
+      _complete_second_phase(threads, topN, _best_scores, _best_dropped, max_spins, spin)
 {}
 MatchLoopCommunicator::~MatchLoopCommunicator() = default;
 
+vespalib::LockStats &
+MatchLoopCommunicator::lock_stats()
+{
+    static vespalib::LockStats &stats = vespalib::LockStats::get("proton.match_loop_communicator");
+    return stats;
+}
+
 void
 MatchLoopCommunicator::EstimateMatchFrequency::mingle()
 {
@@ -34,8 +46,8 @@ MatchLoopCommunicator::EstimateMatchFrequency::mingle()
     }
 }
 
-MatchLoopCommunicator::GetSecondPhaseWork::GetSecondPhaseWork(size_t n, size_t topN_in, Range &best_scores_in, BestDropped &best_dropped_in, std::unique_ptr<IDiversifier> diversifier)
-    : vespalib::Rendezvous<SortedHitSequence, TaggedHits, true>(n),
+MatchLoopCommunicator::GetSecondPhaseWork::GetSecondPhaseWork(size_t n, size_t topN_in, Range &best_scores_in, BestDropped &best_dropped_in, std::unique_ptr<IDiversifier> diversifier, uint32_t max_spins, vespalib::AdaptiveSpin *spin)
+    : vespalib::Rendezvous<SortedHitSequence, TaggedHits, true>(n, &lock_stats(), max_spins, spin),
       topN(topN_in),
       best_scores(best_scores_in),
       best_dropped(best_dropped_in),
@@ -16,8 +16,10 @@ private:
         bool valid = false;
         search::feature_t score = 0.0;
     };
+    static vespalib::LockStats &lock_stats();
     struct EstimateMatchFrequency : vespalib::Rendezvous<Matches, double> {
-        EstimateMatchFrequency(size_t n) : vespalib::Rendezvous<Matches, double>(n) {}
+        EstimateMatchFrequency(size_t n, uint32_t max_spins, vespalib::AdaptiveSpin *spin)
+            : vespalib::Rendezvous<Matches, double>(n, &lock_stats(), max_spins, spin) {}
         void mingle() override;
     };
     struct GetSecondPhaseWork : vespalib::Rendezvous<SortedHitSequence, TaggedHits, true> {
@@ -25,7 +27,7 @@ private:
         Range &best_scores;
         BestDropped &best_dropped;
         std::unique_ptr<IDiversifier> _diversifier;
-        GetSecondPhaseWork(size_t n, size_t topN_in, Range &best_scores_in, BestDropped &best_dropped_in, std::unique_ptr<IDiversifier>);
+        GetSecondPhaseWork(size_t n, size_t topN_in, Range &best_scores_in, BestDropped &best_dropped_in, std::unique_ptr<IDiversifier>, uint32_t max_spins, vespalib::AdaptiveSpin *spin);
         ~GetSecondPhaseWork() override;
         void mingle() override;
         template<typename Q, typename F>
@@ -45,12 +47,13 @@ private:
         size_t topN;
         const Range &best_scores;
         const BestDropped &best_dropped;
-        CompleteSecondPhase(size_t n, size_t topN_in, const Range &best_scores_in, const BestDropped &best_dropped_in)
-            : vespalib::Rendezvous<TaggedHits, std::pair<Hits,RangePair>, true>(n),
+        CompleteSecondPhase(size_t n, size_t topN_in, const Range &best_scores_in, const BestDropped &best_dropped_in, uint32_t max_spins, vespalib::AdaptiveSpin *spin)
+            : vespalib::Rendezvous<TaggedHits, std::pair<Hits,RangePair>, true>(n, &lock_stats(), max_spins, spin),
               topN(topN_in), best_scores(best_scores_in), best_dropped(best_dropped_in) {}
         void mingle() override;
     };
 
+    SharedScoreThreshold   _first_phase_threshold;
     Range                  _best_scores;
     BestDropped            _best_dropped;
     EstimateMatchFrequency _estimate_match_frequency;
@@ -60,6 +63,10 @@ private:
 public:
     MatchLoopCommunicator(size_t threads, size_t topN);
     MatchLoopCommunicator(size_t threads, size_t topN, std::unique_ptr<IDiversifier>);
+    // max_spins: how long threads waiting for each other may spin before blocking
+    // spin: spin budget kept across queries (by the thread bundle), or nullptr to start from scratch
+    MatchLoopCommunicator(size_t threads, size_t topN, std::unique_ptr<IDiversifier>, uint32_t max_spins,
+                          vespalib::AdaptiveSpin *spin);
     ~MatchLoopCommunicator();
 
     double estimate_match_frequency(const Matches &matches) override {
@@ -73,6 +80,8 @@ public:
     std::pair<Hits,RangePair> complete_second_phase(TaggedHits my_results, size_t thread_id) override {
         return _complete_second_phase.rendezvous(std::move(my_results), thread_id);
     }
+
+    SharedScoreThreshold &first_phase_threshold() override { return _first_phase_threshold; }
 };
 
 }
@@ -11,6 +11,7 @@
 #include <vespa/searchlib/engine/searchreply.h>
 #include <vespa/vespalib/util/thread_bundle.h>
 #include <vespa/vespalib/util/issue.h>
+#include <vespa/vespalib/util/numa_topology.h>
 #include <vespa/vespalib/data/slime/inserter.h>
 #include <vespa/vespalib/data/slime/cursor.h>
 
@@ -44,11 +45,24 @@ struct TimedMatchLoopCommunicator final : IMatchLoopCommunicator {
         elapsed = timer.elapsed();
         return result;
     }
+    SharedScoreThreshold &first_phase_threshold() override {
+        return communicator.first_phase_threshold();
+    }
 };
 
+// number of tasks each thread's part of the docid space is split into when scheduling per NUMA node
+constexpr size_t NUMA_TASKS_PER_THREAD = 4;
+
 DocidRangeScheduler::UP
-createScheduler(uint32_t numThreads, uint32_t numSearchPartitions, uint32_t numDocs)
+createScheduler(uint32_t numThreads, uint32_t numSearchPartitions, uint32_t numNumaNodes, uint32_t numDocs)
 {
+    if ((numNumaNodes > 1) && (numThreads > 1)) {
+        const auto &topology = vespalib::NumaTopology::system();
+        if (topology.num_nodes() > 1) {
+            size_t tasks_per_thread = std::max(NUMA_TASKS_PER_THREAD, size_t(numSearchPartitions / numThreads));
+            return NumaDocidRangeScheduler::make(numThreads, topology, numNumaNodes, tasks_per_thread, numDocs);
+        }
+    }
     if (numSearchPartitions == 0) {
         return std::make_unique<AdaptiveDocidRangeScheduler>(numThreads, 1, numDocs);
     }
@@ -59,12 +73,19 @@ createScheduler(uint32_t numThreads, uint32_t numSearchPartitions, uint32_t numD
 }
 
 template <class FullResult>
-auto make_reply(const MatchToolsFactory &mtf, ResultProcessor &processor, ThreadBundle &bundle, FullResult full_result) {
-    if (mtf.has_match_features()) {
+auto make_reply(const MatchToolsFactory &mtf, ResultProcessor &processor, ThreadBundle &bundle, FullResult full_result,
+                bool precompute_summary_features) {
+    bool has_match_features = mtf.has_match_features();
+    if (has_match_features || precompute_summary_features) {
         auto docs = processor.extract_docid_ordering(*full_result);
         auto reply = processor.makeReply(std::move(std::move(full_result)));
         if ((docs.size() > 0) && reply->_reply) {
-            reply->_reply->match_features = ExtractFeatures::get_match_features(mtf, docs, bundle);
+            if (has_match_features) {
+                reply->_reply->match_features = ExtractFeatures::get_match_features(mtf, docs, bundle);
+            }
+            if (precompute_summary_features) {
+                reply->_summary_features = ExtractFeatures::get_summary_features(mtf, docs, bundle);
+            }
         }
         return reply;
     } else {
@@ -81,13 +102,17 @@ MatchMaster::match(search::engine::Trace & trace,
                    const MatchToolsFactory &mtf,
                    ResultProcessor &resultProcessor,
                    uint32_t distributionKey,
-                   uint32_t numSearchPartitions)
+                   uint32_t numSearchPartitions,
+                   uint32_t numNumaNodes,
+                   bool precompute_summary_features,
+                   QueryProfileStats *profile_stats)
 {
     vespalib::Timer query_latency_time;
     vespalib::DualMergeDirector mergeDirector(threadBundle.size());
-    MatchLoopCommunicator communicator(threadBundle.size(), params.heapSize, mtf.createDiversifier(params.heapSize));
+    MatchLoopCommunicator communicator(threadBundle.size(), params.heapSize, mtf.createDiversifier(params.heapSize),
+                                       threadBundle.max_spins(), threadBundle.sync_spin());
     TimedMatchLoopCommunicator timedCommunicator(communicator);
-    DocidRangeScheduler::UP scheduler = createScheduler(threadBundle.size(), numSearchPartitions, params.numDocs);
+    DocidRangeScheduler::UP scheduler = createScheduler(threadBundle.size(), numSearchPartitions, numNumaNodes, params.numDocs);
 
     std::vector<MatchThread::UP> threadState;
     for (size_t i = 0; i < threadBundle.size(); ++i) {
@@ -95,17 +120,23 @@ MatchMaster::match(search::engine::Trace & trace,
             ? static_cast<IMatchLoopCommunicator&>(timedCommunicator)
             : static_cast<IMatchLoopCommunicator&>(communicator);
         threadState.emplace_back(std::make_unique<MatchThread>(i, threadBundle.size(), params, mtf, com, *scheduler,
-                                                               resultProcessor, mergeDirector, distributionKey, trace));
+                                                               resultProcessor, mergeDirector, distributionKey, trace,
+                                                               (profile_stats != nullptr)));
     }
     resultProcessor.prepareThreadContextCreation(threadBundle.size());
     threadBundle.run(threadState);
-    auto reply = make_reply(mtf, resultProcessor, threadBundle, threadState[0]->extract_result());
+    auto reply = make_reply(mtf, resultProcessor, threadBundle, threadState[0]->extract_result(),
+                            precompute_summary_features);
     double query_time_s = vespalib::to_s(query_latency_time.elapsed());
     double rerank_time_s = vespalib::to_s(timedCommunicator.elapsed);
     double match_time_s = 0.0;
     auto inserter = trace.make_inserter("query_execution"_ssv);
+    QueryProfileStats::Sample profile_sample;
     for (size_t i = 0; i < threadState.size(); ++i) {
         const MatchThread & matchThread = *threadState[i];
+        if (profile_stats != nullptr) {
+            matchThread.add_profile(profile_sample);
+        }
         match_time_s = std::max(match_time_s, matchThread.get_match_time());
         _stats.merge_partition(matchThread.get_thread_stats(), i);
         inserter.handle_thread(matchThread.getTrace());
@@ -119,6 +150,10 @@ MatchMaster::match(search::engine::Trace & trace,
     if (mtf.match_limiter().was_limited()) {
         _stats.limited_queries(1);        
     }
+    if (profile_stats != nullptr) {
+        profile_stats->add(profile_sample);
+        _stats.profiled_queries(1);
+    }
     return reply;
 }
 
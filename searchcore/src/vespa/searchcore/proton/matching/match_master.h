@@ -12,6 +12,7 @@ namespace search::engine { class Trace; }
 namespace proton::matching {
 
 class MatchToolsFactory;
+class QueryProfileStats;
 struct MatchParams;
 
 /**
@@ -30,7 +31,10 @@ public:
                                       const MatchToolsFactory &mtf,
                                       ResultProcessor &resultProcessor,
                                       uint32_t distributionKey,
-                                      uint32_t numSearchPartitions);
+                                      uint32_t numSearchPartitions,
+                                      uint32_t numNumaNodes,
+                                      bool precompute_summary_features,
+                                      QueryProfileStats *profile_stats = nullptr);
 
     static MatchingStats getStats(MatchMaster && rhs) { return std::move(rhs._stats); }
 };
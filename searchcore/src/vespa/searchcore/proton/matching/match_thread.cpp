@@ -105,9 +105,13 @@ MatchThread::Context::Context(double rankDropLimit, MatchTools &tools, HitCollec
       _score_feature(get_score_feature(tools.rank_program())),
       _rankDropLimit(rankDropLimit),
       _hits(hits),
+      _rank_program(tools.rank_program()),
       _doom(tools.getDoom()),
+      _batch_size(tools.first_phase_batch_size()),
+      _batch(),
       dropped()
 {
+    _batch.reserve(_batch_size);
 }
 
 template <MatchThread::RankDropLimitE use_rank_drop_limit>
@@ -129,6 +133,30 @@ MatchThread::Context::rankHit(uint32_t docId) {
     }
 }
 
+template <MatchThread::RankDropLimitE use_rank_drop_limit>
+void
+MatchThread::Context::rankBatch() {
+    // let executors supporting it evaluate the hits together first
+    size_t max_batch_size = _rank_program.max_batch_size();
+    if (max_batch_size > 0) {
+        for (size_t begin = 0; begin < _batch.size(); begin += max_batch_size) {
+            size_t end = std::min(_batch.size(), begin + max_batch_size);
+            for (size_t i = begin; i < end; ++i) {
+                _rank_program.add_to_batch(_batch[i]);
+            }
+            _rank_program.execute_batch();
+            for (size_t i = begin; i < end; ++i) {
+                rankHit<use_rank_drop_limit>(_batch[i]);
+            }
+        }
+    } else {
+        for (uint32_t docId : _batch) {
+            rankHit<use_rank_drop_limit>(docId);
+        }
+    }
+    _batch.clear();
+}
+
 //-----------------------------------------------------------------------------
 
 double
@@ -180,18 +208,60 @@ MatchThread::try_share(DocidRange &docid_range, uint32_t next_docid) {
     return false;
 }
 
+// Without ranking or match limiting, hits are collected a block at a
+// time to avoid a virtual seek call per hit.
+template <bool do_share_work>
+uint32_t
+MatchThread::inner_unranked_match_loop(Context &context, MatchTools &tools, DocidRange &docid_range)
+{
+    constexpr uint32_t hit_block_size = 256;
+    uint32_t hit_block[hit_block_size];
+    SearchIterator &search = tools.search();
+    search.initRange(docid_range.begin, docid_range.end);
+    uint32_t docId = docid_range.begin;
+    while ((docId < docid_range.end) && !context.atSoftDoom()) {
+        uint32_t num_hits = search.fill_hits(docId, docid_range.end, hit_block, hit_block_size);
+        for (uint32_t i = 0; i < num_hits; ++i) {
+            context.addHit(hit_block[i]);
+        }
+        context.matches += num_hits;
+        if (num_hits < hit_block_size) {
+            if (context.atSoftDoom()) {
+                // a scanning iterator may have given up, see SearchIterator::set_soft_doom
+                return (num_hits > 0) ? (hit_block[num_hits - 1] + 1) : docId;
+            }
+            return docid_range.end;
+        }
+        docId = hit_block[num_hits - 1] + 1;
+        if (do_share_work && any_idle() && try_share(docid_range, docId)) {
+            search.initRange(docid_range.begin, docid_range.end);
+            docId = docid_range.begin;
+        }
+    }
+    return docId;
+}
+
 template <typename Strategy, bool do_rank, bool do_limit, bool do_share_work,
           MatchThread::RankDropLimitE use_rank_drop_limit>
 uint32_t
 MatchThread::inner_match_loop(Context &context, MatchTools &tools, DocidRange &docid_range)
 {
+    if constexpr (!do_rank && !do_limit) {
+        return inner_unranked_match_loop<do_share_work>(context, tools, docid_range);
+    }
     SearchIterator *search = &tools.search();
     search->initRange(docid_range.begin, docid_range.end);
     uint32_t docId = search->seekFirst(docid_range.begin);
+    uint32_t covered_end = docid_range.begin;
     while ((docId < docid_range.end) && !context.atSoftDoom()) {
+        covered_end = docId + 1;
         if (do_rank) {
             search->unpack(docId);
-            context.rankHit<use_rank_drop_limit>(docId);
+            if (context.batched_ranking()) {
+                context.batchHit<use_rank_drop_limit>(docId);
+            } else {
+                context.rankHit<use_rank_drop_limit>(docId);
+            }
         } else {
             context.addHit(docId);
         }
@@ -201,11 +271,19 @@ MatchThread::inner_match_loop(Context &context, MatchTools &tools, DocidRange &d
             docId = search->seekFirst(docId + 1);
         } else if (do_share_work && any_idle() && try_share(docid_range, docId + 1)) {
             search->initRange(docid_range.begin, docid_range.end);
+            covered_end = docid_range.begin;
             docId = search->seekFirst(docid_range.begin);
         } else {
             docId = Strategy::seek_next(*search, docId + 1);
         }
     }
+    if (do_rank) {
+        context.rankBatch<use_rank_drop_limit>();
+    }
+    if ((docId >= docid_range.end) && context.atSoftDoom()) {
+        // a scanning iterator may have given up, see SearchIterator::set_soft_doom
+        return covered_end;
+    }
     return docId;
 }
 
@@ -244,6 +322,8 @@ MatchThread::match_loop(MatchTools &tools, HitCollector &hits)
     thread_stats.docsCovered(docsCovered);
     thread_stats.docsMatched(matches);
     thread_stats.softDoomed(softDoomed);
+    thread_stats.localRanges(scheduler.local_ranges(thread_id));
+    thread_stats.stolenRanges(scheduler.stolen_ranges(thread_id));
     if (softDoomed) {
         thread_stats.doomOvertime(overtime);
     }
@@ -368,6 +448,10 @@ MatchThread::findMatches(MatchTools &tools)
         tools.tag_search_as_changed();
     }
     HitCollector hits(matchParams.numDocs, matchParams.arraySize);
+    if ((num_threads > 1) && !matchToolsFactory.should_diversify() && !resultProcessor.has_sort_or_grouping()) {
+        // Hits below the threshold cannot be among the best hits, as another thread has arraySize better hits.
+        hits.set_shared_threshold(&communicator.first_phase_threshold());
+    }
     trace->addEvent(4, "Start match and first phase rank");
     /**
      * All, or none of the threads in the bundle must execute the match loop.
@@ -434,7 +518,8 @@ MatchThread::MatchThread(size_t thread_id_in,
                          ResultProcessor &rp,
                          vespalib::DualMergeDirector &md,
                          uint32_t distributionKey,
-                         const Trace &parent_trace)
+                         const Trace &parent_trace,
+                         bool sample_profile)
   : thread_id(thread_id_in),
     num_threads(num_threads_in),
     matchParams(mp),
@@ -468,6 +553,19 @@ MatchThread::MatchThread(size_t thread_id_in,
             second_phase_profiler = std::make_unique<vespalib::ExecutionProfiler>(depth);
         }
     }
+    if (sample_profile) {
+        // flat profiling has less overhead and is what we aggregate anyway
+        constexpr int32_t flat_depth = -1;
+        if (!match_profiler) {
+            match_profiler = std::make_unique<vespalib::ExecutionProfiler>(flat_depth);
+        }
+        if (!first_phase_profiler) {
+            first_phase_profiler = std::make_unique<vespalib::ExecutionProfiler>(flat_depth);
+        }
+        if (!second_phase_profiler) {
+            second_phase_profiler = std::make_unique<vespalib::ExecutionProfiler>(flat_depth);
+        }
+    }
 }
 
 void
@@ -504,6 +602,9 @@ MatchThread::run()
     trace->addEvent(4, "Start thread merge");
     mergeDirector.dualMerge(thread_id, *resultContext->result, resultContext->groupingSource);
     trace->addEvent(4, "MatchThread::run Done");
+    if (trace->getLevel() == 0) {
+        return;
+    }
     if (match_profiler) {
         match_profiler->report(trace->createCursor("match_profiling"));
     }
@@ -517,6 +618,20 @@ MatchThread::run()
     }
 }
 
+void
+MatchThread::add_profile(QueryProfileStats::Sample &sample) const
+{
+    if (match_profiler) {
+        sample.add_match_profile(*match_profiler);
+    }
+    if (first_phase_profiler) {
+        sample.add_rank_profile("first_phase", *first_phase_profiler);
+    }
+    if (second_phase_profiler) {
+        sample.add_rank_profile("second_phase", *second_phase_profiler);
+    }
+}
+
 std::unique_ptr<PartialResult>
 MatchThread::extract_result() {
     return std::move(resultContext->result);
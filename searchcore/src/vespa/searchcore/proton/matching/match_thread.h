@@ -5,6 +5,7 @@
 #include "i_match_loop_communicator.h"
 #include "match_params.h"
 #include "matching_stats.h"
+#include "query_profile_stats.h"
 #include "result_processor.h"
 #include "docid_range_scheduler.h"
 #include <vespa/vespalib/util/runnable.h>
@@ -77,6 +78,16 @@ private:
                 uint32_t num_threads) __attribute__((noinline));
         template <RankDropLimitE use_rank_drop_limit>
         void rankHit(uint32_t docId);
+        bool batched_ranking() const { return _batch_size > 0; }
+        template <RankDropLimitE use_rank_drop_limit>
+        void batchHit(uint32_t docId) {
+            _batch.push_back(docId);
+            if (_batch.size() >= _batch_size) {
+                rankBatch<use_rank_drop_limit>();
+            }
+        }
+        template <RankDropLimitE use_rank_drop_limit>
+        void rankBatch();
         void addHit(uint32_t docId) { _hits.addHit(docId, search::zero_rank_value); }
         bool isBelowLimit() const { return matches < _matches_limit; }
         bool    isAtLimit() const { return matches == _matches_limit; }
@@ -88,7 +99,10 @@ private:
         LazyValue       _score_feature;
         double          _rankDropLimit;
         HitCollector   &_hits;
+        RankProgram    &_rank_program;
         const Doom      _doom;
+        uint32_t        _batch_size;
+        std::vector<uint32_t> _batch;
     public:
         std::vector<uint32_t> dropped;
     };
@@ -99,6 +113,9 @@ private:
     bool any_idle() const { return (idle_observer.get() > 0); }
     bool try_share(DocidRange &docid_range, uint32_t next_docid) __attribute__((noinline));
 
+    template <bool do_share_work>
+    uint32_t inner_unranked_match_loop(Context &context, MatchTools &tools, DocidRange &docid_range) __attribute__((noinline));
+
     template <typename Strategy, bool do_rank, bool do_limit, bool do_share_work, RankDropLimitE use_rank_drop_limit>
     uint32_t inner_match_loop(Context &context, MatchTools &tools, DocidRange &docid_range) __attribute__((noinline));
 
@@ -131,13 +148,15 @@ public:
                 ResultProcessor &rp,
                 vespalib::DualMergeDirector &md,
                 uint32_t distributionKey,
-                const Trace &parent_trace);
+                const Trace &parent_trace,
+                bool sample_profile);
     void run() override;
     const MatchingStats::Partition &get_thread_stats() const { return thread_stats; }
     double get_match_time() const { return match_time_s; }
     std::unique_ptr<PartialResult> extract_result();
     const Trace & getTrace() const { return *trace; }
     const UniqueIssues &get_issues() const { return my_issues; }
+    void add_profile(QueryProfileStats::Sample &sample) const;
 };
 
 }
@@ -12,6 +12,7 @@
 #include <vespa/searchlib/fef/ranksetup.h>
 #include <vespa/vespalib/util/issue.h>
 #include <vespa/vespalib/util/thread_bundle.h>
+#include <optional>
 
 using search::queryeval::IDiversifier;
 using search::attribute::diversity::DiversityFilter;
@@ -73,24 +74,28 @@ extractDiversityParams(const RankSetup &rankSetup, const Properties &rankPropert
 } // namespace proton::matching::<unnamed>
 
 void
-MatchTools::setup(std::unique_ptr<RankProgram> rank_program, ExecutionProfiler *profiler, double termwise_limit)
+MatchTools::setup(RankProgram &rank_program, ExecutionProfiler *profiler, double termwise_limit)
 {
     if (_search) {
-        _match_data->soft_reset();
+        _match_data.soft_reset();
     }
-    _rank_program = std::move(rank_program);
+    if (_rank_program != nullptr) {
+        // all rank programs are owned by _stash, so the previous one outlives this one
+        rank_program.reuse_constants_from(*_rank_program);
+    }
+    _rank_program = &rank_program;
     HandleRecorder recorder;
     {
         HandleRecorder::Binder bind(recorder);
-        _rank_program->setup(*_match_data, _queryEnv, _featureOverrides, profiler);
+        _rank_program->setup(_match_data, _queryEnv, _featureOverrides, profiler);
     }
     bool can_reuse_search = (allow_reuse_search() &&
                              _search && !_search_has_changed &&
                              contains_all(_used_handles, recorder.get_handles()));
     if (!can_reuse_search) {
-        recorder.tag_match_data(*_match_data);
-        _match_data->set_termwise_limit(termwise_limit);
-        _search = _query.createSearch(*_match_data);
+        recorder.tag_match_data(_match_data);
+        _match_data.set_termwise_limit(termwise_limit);
+        _search = _query.createSearch(_match_data);
         _used_handles = std::move(recorder).steal_handles();
         _search_has_changed = false;
     }
@@ -103,23 +108,33 @@ MatchTools::MatchTools(QueryLimiter & queryLimiter,
                        const QueryEnvironment & queryEnv,
                        const MatchDataLayout & mdl,
                        const RankSetup & rankSetup,
-                       const Properties & featureOverrides)
+                       const Properties & featureOverrides,
+                       StashPool * stash_pool)
     : _queryLimiter(queryLimiter),
+      _stash_pool(stash_pool),
       _doom(doom),
       _query(query),
       _match_limiter(match_limiter_in),
       _queryEnv(queryEnv),
       _rankSetup(rankSetup),
       _featureOverrides(featureOverrides),
-      _match_data(mdl.createMatchData()),
-      _rank_program(),
+      _stash(stash_pool ? stash_pool->obtain() : vespalib::Stash()),
+      _match_data(mdl.createMatchData(_stash)),
+      _rank_program(nullptr),
       _search(),
       _used_handles(),
       _search_has_changed(false)
 {
 }
 
-MatchTools::~MatchTools() = default;
+MatchTools::~MatchTools()
+{
+    if (_stash_pool != nullptr) {
+        // the search iterator may refer to match data in the stash
+        _search.reset();
+        _stash_pool->release(std::move(_stash));
+    }
+}
 
 bool
 MatchTools::has_second_phase_rank() const {
@@ -129,32 +144,47 @@ MatchTools::has_second_phase_rank() const {
 void
 MatchTools::setup_first_phase(ExecutionProfiler *profiler)
 {
-    setup(_rankSetup.create_first_phase_program(), profiler,
+    setup(_rankSetup.create_first_phase_program(_stash), profiler,
           TermwiseLimit::lookup(_queryEnv.getProperties(), _rankSetup.get_termwise_limit()));
 }
 
+uint32_t
+MatchTools::first_phase_batch_size() const
+{
+    if (!_used_handles.empty()) {
+        // The rank program reads match data, which is only valid for the last unpacked hit.
+        return 0;
+    }
+    uint32_t batch_size = FirstPhaseBatchSize::lookup(_queryEnv.getProperties(), _rankSetup.get_first_phase_batch_size());
+    if (batch_size == 0) {
+        // Executors configured for batched evaluation (e.g. GBDT or ONNX models) decide the size
+        batch_size = _rank_program->max_batch_size();
+    }
+    return batch_size;
+}
+
 void
 MatchTools::setup_second_phase(ExecutionProfiler *profiler)
 {
-    setup(_rankSetup.create_second_phase_program(), profiler);
+    setup(_rankSetup.create_second_phase_program(_stash), profiler);
 }
 
 void
 MatchTools::setup_match_features()
 {
-    setup(_rankSetup.create_match_program(), nullptr);
+    setup(_rankSetup.create_match_program(_stash), nullptr);
 }
 
 void
 MatchTools::setup_summary()
 {
-    setup(_rankSetup.create_summary_program(), nullptr);
+    setup(_rankSetup.create_summary_program(_stash), nullptr);
 }
 
 void
 MatchTools::setup_dump()
 {
-    setup(_rankSetup.create_dump_program(), nullptr);
+    setup(_rankSetup.create_dump_program(_stash), nullptr);
 }
 
 //-----------------------------------------------------------------------------
@@ -176,7 +206,9 @@ MatchToolsFactory(QueryLimiter               & queryLimiter,
                   vespalib::ThreadBundle     & thread_bundle,
                   const search::IDocumentMetaStoreContext::IReadGuard::SP * metaStoreReadGuard,
                   uint32_t                     maxNumHits,
-                  bool                         is_search)
+                  bool                         is_search,
+                  std::shared_ptr<StashPool>   stash_pool,
+                  GlobalFilterCache          * global_filter_cache)
     : _queryLimiter(queryLimiter),
       _attribute_blueprint_params(extract_attribute_blueprint_params(rankSetup, rankProperties, metaStore.getNumActiveLids(), searchContext.getDocIdLimit())),
       _query(),
@@ -188,6 +220,7 @@ MatchToolsFactory(QueryLimiter               & queryLimiter,
       _rankSetup(rankSetup),
       _featureOverrides(featureOverrides),
       _diversityParams(),
+      _stash_pool(std::move(stash_pool)),
       _valid(false)
 {
     if (doom.soft_doom()) return;
@@ -209,9 +242,16 @@ MatchToolsFactory(QueryLimiter               & queryLimiter,
         double hitRate = std::min(1.0, double(maxNumHits)/double(searchContext.getDocIdLimit()));
         _query.fetchPostings(ExecuteInfo::create(is_search, hitRate, _requestContext.getDoom(), thread_bundle));
         if (is_search) {
+            std::optional<GlobalFilterCache::Key> filter_cache_key;
+            if (global_filter_cache != nullptr) {
+                filter_cache_key.emplace(GlobalFilterCache::make_key(queryStack, location),
+                                         metaStore.getCurrentGeneration(), metaStore.getNumActiveLids(),
+                                         searchContext.getDocIdLimit());
+            }
             _query.handle_global_filter(_requestContext, searchContext.getDocIdLimit(),
                                         _attribute_blueprint_params.global_filter_lower_limit,
-                                        _attribute_blueprint_params.global_filter_upper_limit, trace, sort_by_cost);
+                                        _attribute_blueprint_params.global_filter_upper_limit, trace, sort_by_cost,
+                                        global_filter_cache, filter_cache_key ? &*filter_cache_key : nullptr);
         }
         _query.freeze();
         trace.addEvent(5, "Prepare shared state for multi-threaded rank executors");
@@ -244,7 +284,8 @@ MatchToolsFactory::createMatchTools() const
 {
     assert(_valid);
     return std::make_unique<MatchTools>(_queryLimiter, _requestContext.getDoom(), _query,
-                                        *_match_limiter, _queryEnv, _mdl, _rankSetup, _featureOverrides);
+                                        *_match_limiter, _queryEnv, _mdl, _rankSetup, _featureOverrides,
+                                        _stash_pool.get());
 }
 
 std::unique_ptr<IDiversifier>
@@ -323,6 +364,13 @@ MatchToolsFactory::has_match_features() const
     return _rankSetup.has_match_features();
 }
 
+bool
+MatchToolsFactory::precompute_summary_features() const
+{
+    return !_rankSetup.getSummaryFeatures().empty() &&
+           summary::PrecomputeFeatures::check(_queryEnv.getProperties(), _rankSetup.precompute_summary_features());
+}
+
 const StringStringMap &
 MatchToolsFactory::get_feature_rename_map() const
 {
@@ -336,6 +384,7 @@ MatchToolsFactory::extract_attribute_blueprint_params(const RankSetup& rank_setu
     double lower_limit = GlobalFilterLowerLimit::lookup(rank_properties, rank_setup.get_global_filter_lower_limit());
     double upper_limit = GlobalFilterUpperLimit::lookup(rank_properties, rank_setup.get_global_filter_upper_limit());
     double target_hits_max_adjustment_factor = TargetHitsMaxAdjustmentFactor::lookup(rank_properties, rank_setup.get_target_hits_max_adjustment_factor());
+    double filter_first_threshold = FilterFirstThreshold::lookup(rank_properties, rank_setup.get_filter_first_threshold());
     auto fuzzy_matching_algorithm = FuzzyAlgorithm::lookup(rank_properties, rank_setup.get_fuzzy_matching_algorithm());
 
     // Note that we count the reserved docid 0 as active.
@@ -345,6 +394,7 @@ MatchToolsFactory::extract_attribute_blueprint_params(const RankSetup& rank_setu
     return {lower_limit * active_hit_ratio,
             upper_limit * active_hit_ratio,
             target_hits_max_adjustment_factor,
+            filter_first_threshold,
             fuzzy_matching_algorithm};
 }
 
@@ -10,12 +10,14 @@
 #include "match_phase_limiter.h"
 #include "handlerecorder.h"
 #include "requestcontext.h"
+#include "stash_pool.h"
 #include <vespa/searchcommon/attribute/i_attribute_functor.h>
 #include <vespa/searchlib/queryeval/blueprint.h>
 #include <vespa/searchlib/common/idocumentmetastore.h>
 #include <vespa/searchlib/common/stringmap.h>
 #include <vespa/searchlib/queryeval/idiversifier.h>
 #include <vespa/vespalib/util/doom.h>
+#include <vespa/vespalib/util/stash.h>
 
 namespace vespalib { class ExecutionProfiler; }
 namespace vespalib { struct ThreadBundle; }
@@ -41,18 +43,21 @@ private:
     using RankSetup = search::fef::RankSetup;
     using ExecutionProfiler = vespalib::ExecutionProfiler;
     QueryLimiter                    &_queryLimiter;
+    StashPool                       *_stash_pool;
     const vespalib::Doom             _doom;
     const Query                     &_query;
     MaybeMatchPhaseLimiter          &_match_limiter;
     const QueryEnvironment          &_queryEnv;
     const RankSetup                 &_rankSetup;
     const Properties                &_featureOverrides;
-    std::unique_ptr<MatchData>       _match_data;
-    std::unique_ptr<RankProgram>     _rank_program;
+    // Owns match data and rank programs; all released together when matching is done
+    vespalib::Stash                  _stash;
+    MatchData                       &_match_data;
+    RankProgram                     *_rank_program;
     std::unique_ptr<SearchIterator>  _search;
     HandleRecorder::HandleMap        _used_handles;
     bool                             _search_has_changed;
-    void setup(std::unique_ptr<RankProgram>, ExecutionProfiler *profiler, double termwise_limit = 1.0);
+    void setup(RankProgram &rank_program, ExecutionProfiler *profiler, double termwise_limit = 1.0);
 public:
     using UP = std::unique_ptr<MatchTools>;
     MatchTools(const MatchTools &) = delete;
@@ -64,19 +69,23 @@ public:
                const QueryEnvironment &queryEnv,
                const MatchDataLayout &mdl,
                const RankSetup &rankSetup,
-               const Properties &featureOverrides);
+               const Properties &featureOverrides,
+               StashPool *stash_pool);
     ~MatchTools();
     const vespalib::Doom &getDoom() const { return _doom; }
     QueryLimiter & getQueryLimiter() { return _queryLimiter; }
     MaybeMatchPhaseLimiter &match_limiter() { return _match_limiter; }
     bool has_second_phase_rank() const;
-    const MatchData &match_data() const { return *_match_data; }
+    const MatchData &match_data() const { return _match_data; }
     RankProgram &rank_program() { return *_rank_program; }
     SearchIterator &search() { return *_search; }
     std::unique_ptr<SearchIterator> borrow_search() { return std::move(_search); }
     void give_back_search(std::unique_ptr<SearchIterator> search_in) { _search = std::move(search_in); }
     void tag_search_as_changed() { _search_has_changed = true; }
     void setup_first_phase(ExecutionProfiler *profiler);
+    // Number of hits to collect before ranking them, 0 if each hit must be ranked when matched.
+    // Must be called after setup_first_phase.
+    uint32_t first_phase_batch_size() const;
     void setup_second_phase(ExecutionProfiler *profiler);
     void setup_match_features();
     void setup_summary();
@@ -130,6 +139,7 @@ private:
     const RankSetup                  & _rankSetup;
     const Properties                 & _featureOverrides;
     DiversityParams                    _diversityParams;
+    std::shared_ptr<StashPool>         _stash_pool;
     bool                               _valid;
 
     std::unique_ptr<AttributeOperationTask>
@@ -155,7 +165,9 @@ public:
                       vespalib::ThreadBundle &thread_bundle,
                       const search::IDocumentMetaStoreContext::IReadGuard::SP * metaStoreReadGuard,
                       uint32_t maxNumHits,
-                      bool is_search);
+                      bool is_search,
+                      std::shared_ptr<StashPool> stash_pool,
+                      GlobalFilterCache *global_filter_cache = nullptr);
     ~MatchToolsFactory();
     bool valid() const { return _valid; }
     const MaybeMatchPhaseLimiter &match_limiter() const { return *_match_limiter; }
@@ -165,6 +177,7 @@ public:
     search::queryeval::Blueprint::HitEstimate estimate() const { return _query.estimate(); }
     bool has_first_phase_rank() const;
     bool has_match_features() const;
+    bool precompute_summary_features() const;
     bool hasOnMatchTask() const;
     std::unique_ptr<AttributeOperationTask> createOnMatchTask() const;
     std::unique_ptr<AttributeOperationTask> createOnFirstPhaseTask() const;
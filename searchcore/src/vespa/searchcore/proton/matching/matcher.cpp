@@ -6,6 +6,7 @@
 #include "match_context.h"
 #include "match_tools.h"
 #include "match_params.h"
+#include "query_memory_estimate.h"
 #include "sessionmanager.h"
 #include <vespa/searchcore/grouping/groupingcontext.h>
 #include <vespa/searchcore/proton/bucketdb/bucket_db_owner.h>
@@ -17,7 +18,9 @@
 #include <vespa/searchlib/fef/ranksetup.h>
 #include <vespa/searchlib/fef/test/plugin/setup.h>
 #include <vespa/searchlib/common/allocatedbitvector.h>
+#include <vespa/vespalib/data/slime/cursor.h>
 #include <vespa/vespalib/data/slime/inserter.h>
+#include <vespa/vespalib/util/size_literals.h>
 #include <cinttypes>
 
 #include <vespa/log/log.h>
@@ -87,6 +90,8 @@ public:
     void run(vespalib::Runnable* const* targets, size_t cnt) override {
         _threadBundle.run(targets, cnt);
     }
+    uint32_t max_spins() const override { return _threadBundle.max_spins(); }
+    vespalib::AdaptiveSpin *sync_spin() override { return _threadBundle.sync_spin(); }
 private:
     vespalib::ThreadBundle &_threadBundle;
     const uint32_t          _maxThreads;
@@ -127,7 +132,13 @@ Matcher::Matcher(const search::index::Schema &schema, Properties props, const st
     _startTime(my_clock::now()),
     _now_ref(now_ref),
     _queryLimiter(queryLimiter),
-    _distributionKey(distributionKey)
+    _distributionKey(distributionKey),
+    _profile_sample_rate(ProfileSampleRate::lookup(_indexEnv.getProperties())),
+    _profile_query_count(0),
+    _profile_stats(),
+    _result_cache(),
+    _global_filter_cache(),
+    _stash_pool(std::make_shared<StashPool>(16_Ki, 64))
 {
     search::features::setup_search_features(_blueprintFactory);
     search::fef::test::setup_fef_test_plugin(_blueprintFactory);
@@ -137,6 +148,17 @@ Matcher::Matcher(const search::index::Schema &schema, Properties props, const st
         throw vespalib::IllegalArgumentException(fmt("failed to compile rank setup :\n%s",
                                                      _rankSetup->getJoinedWarnings().c_str()), VESPA_STRLOC);
     }
+    uint32_t result_cache_max_entries = ResultCacheMaxEntries::lookup(_indexEnv.getProperties());
+    if (result_cache_max_entries > 0) {
+        _result_cache = std::make_unique<ResultCache>(result_cache_max_entries,
+                                                      vespalib::from_s(ResultCacheMaxAge::lookup(_indexEnv.getProperties())));
+    }
+    uint64_t global_filter_cache_max_bytes = GlobalFilterCacheMaxBytes::lookup(_indexEnv.getProperties());
+    if (global_filter_cache_max_bytes > 0) {
+        _global_filter_cache = std::make_unique<GlobalFilterCache>(global_filter_cache_max_bytes,
+                                                                   vespalib::from_s(GlobalFilterCacheMinCost::lookup(_indexEnv.getProperties())),
+                                                                   vespalib::from_s(GlobalFilterCacheMaxAge::lookup(_indexEnv.getProperties())));
+    }
 }
 
 Matcher::~Matcher() = default;
@@ -150,6 +172,24 @@ Matcher::getStats()
     return stats;
 }
 
+void
+Matcher::report_result_cache_hit(vespalib::duration saved_time)
+{
+    MatchingStats my_stats;
+    my_stats.result_cache_hits(1).result_cache_saved_time(vespalib::to_s(saved_time));
+    std::lock_guard<std::mutex> guard(_statsLock);
+    _stats.add(my_stats);
+}
+
+void
+Matcher::report_memory_rejected_query()
+{
+    MatchingStats my_stats;
+    my_stats.memory_rejected_queries(1);
+    std::lock_guard<std::mutex> guard(_statsLock);
+    _stats.add(my_stats);
+}
+
 std::unique_ptr<MatchToolsFactory>
 Matcher::create_match_tools_factory(const search::engine::Request &request, ISearchContext &searchContext,
                                     IAttributeContext &attrContext, const search::IDocumentMetaStore &metaStore,
@@ -176,7 +216,8 @@ Matcher::create_match_tools_factory(const search::engine::Request &request, ISea
                                                request.trace(), request.getStackRef(), request.location,
                                                _viewResolver, metaStore, _indexEnv, *_rankSetup,
                                                rankProperties, feature_overrides, thread_bundle,
-                                               metaStoreReadGuard, maxHits, is_search);
+                                               metaStoreReadGuard, maxHits, is_search, _stash_pool,
+                                               _global_filter_cache.get());
 }
 
 size_t
@@ -295,18 +336,63 @@ Matcher::match(const SearchRequest &request, vespalib::ThreadBundle &threadBundl
 
         ResultProcessor rp(attrContext, metaStore, sessionMgr, groupingContext, sessionId,
                            request.sortSpec, params.offset, params.hits);
+        uint32_t maxGroupsPerThread = MaxGroupsPerThread::lookup(rankProperties, _rankSetup->getMaxGroupsPerThread());
+        rp.set_max_groups_per_thread(maxGroupsPerThread);
+        uint32_t approximateGroupingHits = ApproximateGroupingHits::lookup(rankProperties, _rankSetup->getApproximateGroupingHits());
+        double groupingSampleRate = 1.0;
+        if (!groupingContext.empty() && (approximateGroupingHits > 0) && (mtf->estimate().estHits > approximateGroupingHits)) {
+            groupingSampleRate = double(approximateGroupingHits) / mtf->estimate().estHits;
+            rp.set_grouping_sample_rate(groupingSampleRate);
+        }
 
         size_t numThreadsPerSearch = computeNumThreadsPerSearch(mtf->estimate(), rankProperties);
+        QueryMemoryEstimate memory;
+        memory.docid_limit = searchContext.getDocIdLimit();
+        memory.num_threads = numThreadsPerSearch;
+        memory.heap_size = heapSize;
+        memory.array_size = arraySize;
+        memory.est_hits = mtf->estimate().estHits;
+        memory.query_size = request.getStackRef().size();
+        memory.has_grouping = !groupingContext.empty();
+        memory.max_groups_per_thread = maxGroupsPerThread;
+        auto memoryToken = _queryLimiter.reserve_memory(memory.bytes());
+        if (!memoryToken && (numThreadsPerSearch > 1)) {
+            // most of the memory is per match thread; degrade to a single thread before rejecting
+            numThreadsPerSearch = 1;
+            memory.num_threads = 1;
+            memoryToken = _queryLimiter.reserve_memory(memory.bytes());
+        }
+        if (!memoryToken) {
+            vespalib::Issue::report("Search request rejected: estimated memory use of %zu bytes exceeds the query memory budget",
+                                    memory.bytes());
+            report_memory_rejected_query();
+            return reply;
+        }
         LimitedThreadBundleWrapper limitedThreadBundle(threadBundle, numThreadsPerSearch);
         MatchMaster master;
         uint32_t numParts = NumSearchPartitions::lookup(rankProperties, _rankSetup->getNumSearchPartitions());
+        uint32_t numNumaNodes = NumNumaNodes::lookup(rankProperties, _rankSetup->getNumNumaNodes());
         if (limitedThreadBundle.size() > 1) {
             attrContext.enableMultiThreadSafe();
         }
+        bool sample_profile = (_profile_sample_rate > 0) &&
+                              ((_profile_query_count.fetch_add(1, std::memory_order_relaxed) % _profile_sample_rate) == 0);
+        bool precompute_summary_features = shouldCacheSearchSession && mtf->precompute_summary_features();
         ResultProcessor::Result::UP result = master.match(request.trace(), params, limitedThreadBundle, *mtf, rp,
-                                                          _distributionKey, numParts);
+                                                          _distributionKey, numParts, numNumaNodes,
+                                                          precompute_summary_features,
+                                                          sample_profile ? &_profile_stats : nullptr);
         my_stats = MatchMaster::getStats(std::move(master));
+        my_stats.query_memory(memory.bytes());
         reply = std::move(result->_reply);
+        if (groupingSampleRate < 1.0) {
+            if (auto *cursor = request.trace().maybeCreateCursor(4, "approximate_grouping")) {
+                cursor->setDouble("sample_rate", groupingSampleRate);
+                cursor->setLong("total_hits", reply->totalHitCount);
+                cursor->setDouble("count_error_bound",
+                                  search::aggregation::Grouping::countErrorBound(reply->totalHitCount, groupingSampleRate));
+            }
+        }
         Coverage & coverage = reply->coverage;
         updateCoverage(coverage, mtf->match_limiter(), my_stats, metaStore, bucketdb);
 
@@ -317,6 +403,7 @@ Matcher::match(const SearchRequest &request, vespalib::ThreadBundle &threadBundl
         if (shouldCacheSearchSession && ((result->_numFs4Hits != 0) || shouldCacheGroupingSession)) {
             auto session = std::make_shared<SearchSession>(sessionId, request.getStartTime(), request.getTimeOfDoom(),
                                                            std::move(mtf), std::move(owned_objects));
+            session->set_summary_features(std::move(result->_summary_features));
             session->releaseEnumGuards();
             sessionMgr.insert(std::move(session));
         }
@@ -426,4 +513,9 @@ Matcher::canProduceSummaryFeatures() const {
     return ! _rankSetup->getSummaryFeatures().empty();
 }
 
+uint32_t
+Matcher::get_summary_hits_per_task(const Properties &rankProperties) const {
+    return summary::HitsPerTask::lookup(rankProperties, _rankSetup->get_summary_hits_per_task());
+}
+
 }
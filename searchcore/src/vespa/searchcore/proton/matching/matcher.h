@@ -3,10 +3,14 @@
 #pragma once
 
 #include "docsum_matcher.h"
+#include "global_filter_cache.h"
 #include "indexenvironment.h"
 #include "matching_stats.h"
+#include "query_profile_stats.h"
 #include "querylimiter.h"
+#include "result_cache.h"
 #include "search_session.h"
+#include "stash_pool.h"
 #include "viewresolver.h"
 #include <vespa/searchcommon/attribute/i_attribute_functor.h>
 #include <vespa/searchlib/common/matching_elements_fields.h>
@@ -69,11 +73,18 @@ private:
     const std::atomic<steady_time> &_now_ref;
     QueryLimiter                   &_queryLimiter;
     uint32_t                        _distributionKey;
+    uint32_t                        _profile_sample_rate;
+    std::atomic<uint64_t>           _profile_query_count;
+    QueryProfileStats               _profile_stats;
+    std::unique_ptr<ResultCache>    _result_cache;
+    std::unique_ptr<GlobalFilterCache> _global_filter_cache;
+    std::shared_ptr<StashPool>      _stash_pool;
 
     size_t computeNumThreadsPerSearch(search::queryeval::Blueprint::HitEstimate hits,
                                       const Properties & rankProperties) const;
     void updateStats(const MatchingStats & stats, const search::engine::Request & request,
                      const Coverage & coverage, bool isDoomExplicit);
+    void report_memory_rejected_query();
 public:
     using SP = std::shared_ptr<Matcher>;
 
@@ -96,6 +107,11 @@ public:
 
     const search::fef::IIndexEnvironment &get_index_env() const { return _indexEnv; }
 
+    /**
+     * The ranking assets the rank setup of this matcher depends on.
+     **/
+    UsedRankingAssets get_used_ranking_assets() const { return _indexEnv.getUsedRankingAssets(); }
+
     /**
      * Observe and reset stats for this object.
      *
@@ -103,6 +119,35 @@ public:
      **/
     MatchingStats getStats();
 
+    /**
+     * Profiling information aggregated across the queries sampled
+     * for profiling (see indexproperties::matching::ProfileSampleRate).
+     * Unlike the matching stats, this is not reset when observed.
+     **/
+    const QueryProfileStats &get_profile_stats() const { return _profile_stats; }
+
+    /**
+     * Cache of query results for this rank profile, or nullptr if
+     * result caching is disabled (see
+     * indexproperties::matching::ResultCacheMaxEntries).
+     **/
+    ResultCache *get_result_cache() const noexcept { return _result_cache.get(); }
+
+    /**
+     * Cache of global filters for this rank profile, or nullptr if
+     * global filter caching is disabled (see
+     * indexproperties::matching::GlobalFilterCacheMaxBytes).
+     **/
+    GlobalFilterCache *get_global_filter_cache() const noexcept { return _global_filter_cache.get(); }
+
+    /**
+     * Account for a query served from the result cache instead of
+     * being matched.
+     *
+     * @param saved_time the time it took to produce the cached result
+     **/
+    void report_result_cache_hit(vespalib::duration saved_time);
+
     /**
      * Create the low-level tools needed to perform matching. This
      * function is exposed for testing purposes.
@@ -183,6 +228,13 @@ public:
      * @return true if this rankprofile has summary-features enabled
      **/
     bool canProduceSummaryFeatures() const;
+
+    /**
+     * @return the number of hits filled by each task when filling
+     *         docsums in parallel, 0 if they should be filled by the
+     *         requesting thread only
+     **/
+    uint32_t get_summary_hits_per_task(const Properties &rankProperties) const;
 };
 
 }
@@ -22,11 +22,16 @@ constexpr double MAX_CHANGE_FACTOR = 5;
 MatchingStats::MatchingStats(double prev_soft_doom_factor) noexcept
     : _queries(0),
       _limited_queries(0),
+      _profiled_queries(0),
+      _result_cache_hits(0),
+      _memory_rejected_queries(0),
       _docidSpaceCovered(0),
       _docsMatched(0),
       _docsRanked(0),
       _docsReRanked(0),
       _softDoomed(0),
+      _localRanges(0),
+      _stolenRanges(0),
       _doomOvertime(),
       _softDoomFactor(prev_soft_doom_factor),
       _querySetupTime(),
@@ -34,6 +39,8 @@ MatchingStats::MatchingStats(double prev_soft_doom_factor) noexcept
       _matchTime(),
       _groupingTime(),
       _rerankTime(),
+      _result_cache_saved_time(),
+      _query_memory(),
       _partitions()
 { }
 
@@ -48,6 +55,8 @@ MatchingStats::merge_partition(const Partition &partition, size_t id)
     _docsMatched += partition.docsMatched();
     _docsRanked += partition.docsRanked();
     _docsReRanked += partition.docsReRanked();
+    _localRanges += partition.localRanges();
+    _stolenRanges += partition.stolenRanges();
     _doomOvertime.add(partition._doomOvertime);
     if (partition.softDoomed()) {
         _softDoomed = 1;
@@ -61,12 +70,17 @@ MatchingStats::add(const MatchingStats &rhs) noexcept
 {
     _queries += rhs._queries;
     _limited_queries += rhs._limited_queries;
+    _profiled_queries += rhs._profiled_queries;
+    _result_cache_hits += rhs._result_cache_hits;
+    _memory_rejected_queries += rhs._memory_rejected_queries;
 
     _docidSpaceCovered += rhs._docidSpaceCovered;
     _docsMatched += rhs._docsMatched;
     _docsRanked += rhs._docsRanked;
     _docsReRanked += rhs._docsReRanked;
     _softDoomed += rhs.softDoomed();
+    _localRanges += rhs._localRanges;
+    _stolenRanges += rhs._stolenRanges;
     _doomOvertime.add(rhs._doomOvertime);
 
     _querySetupTime.add(rhs._querySetupTime);
@@ -74,6 +88,8 @@ MatchingStats::add(const MatchingStats &rhs) noexcept
     _matchTime.add(rhs._matchTime);
     _groupingTime.add(rhs._groupingTime);
     _rerankTime.add(rhs._rerankTime);
+    _result_cache_saved_time.add(rhs._result_cache_saved_time);
+    _query_memory.add(rhs._query_memory);
     for (size_t id = 0; id < rhs.getNumPartitions(); ++id) {
         get_writable_partition(_partitions, id).add(rhs.getPartition(id));
     }
@@ -63,6 +63,8 @@ public:
         size_t _docsRanked;
         size_t _docsReRanked;
         size_t _softDoomed;
+        size_t _localRanges;
+        size_t _stolenRanges;
         Avg    _doomOvertime;
         Avg    _active_time;
         Avg    _wait_time;
@@ -74,6 +76,8 @@ public:
               _docsRanked(0),
               _docsReRanked(0),
               _softDoomed(0),
+              _localRanges(0),
+              _stolenRanges(0),
               _doomOvertime(),
               _active_time(),
               _wait_time() { }
@@ -88,6 +92,10 @@ public:
         size_t docsReRanked() const noexcept { return _docsReRanked; }
         Partition &softDoomed(bool v) noexcept { _softDoomed += v ? 1 : 0; return *this; }
         size_t softDoomed() const noexcept { return _softDoomed; }
+        Partition &localRanges(size_t value) noexcept { _localRanges = value; return *this; }
+        size_t localRanges() const noexcept { return _localRanges; }
+        Partition &stolenRanges(size_t value) noexcept { _stolenRanges = value; return *this; }
+        size_t stolenRanges() const noexcept { return _stolenRanges; }
         Partition & doomOvertime(vespalib::duration overtime) noexcept { _doomOvertime.set(vespalib::to_s(overtime)); return *this; }
         vespalib::duration doomOvertime() const noexcept { return vespalib::from_s(_doomOvertime.max()); }
 
@@ -108,6 +116,8 @@ public:
             _docsRanked += rhs._docsRanked;
             _docsReRanked += rhs._docsReRanked;
             _softDoomed += rhs._softDoomed;
+            _localRanges += rhs._localRanges;
+            _stolenRanges += rhs._stolenRanges;
             _doomOvertime.add(rhs._doomOvertime);
 
             _active_time.add(rhs._active_time);
@@ -119,11 +129,16 @@ public:
 private:
     size_t                 _queries;
     size_t                 _limited_queries;
+    size_t                 _profiled_queries;
+    size_t                 _result_cache_hits;
+    size_t                 _memory_rejected_queries;
     size_t                 _docidSpaceCovered;
     size_t                 _docsMatched;
     size_t                 _docsRanked;
     size_t                 _docsReRanked;
     size_t                 _softDoomed;
+    size_t                 _localRanges;
+    size_t                 _stolenRanges;
     Avg                    _doomOvertime;
     using SoftDoomFactor = vespalib::datastore::AtomicValueWrapper<double>;
     SoftDoomFactor         _softDoomFactor;
@@ -132,6 +147,8 @@ private:
     Avg                    _matchTime;
     Avg                    _groupingTime;
     Avg                    _rerankTime;
+    Avg                    _result_cache_saved_time;
+    Avg                    _query_memory;
     std::vector<Partition> _partitions;
 
 public:
@@ -150,6 +167,15 @@ public:
     MatchingStats &limited_queries(size_t value) { _limited_queries = value; return *this; }
     size_t limited_queries() const { return _limited_queries; }
 
+    MatchingStats &profiled_queries(size_t value) { _profiled_queries = value; return *this; }
+    size_t profiled_queries() const { return _profiled_queries; }
+
+    MatchingStats &result_cache_hits(size_t value) { _result_cache_hits = value; return *this; }
+    size_t result_cache_hits() const { return _result_cache_hits; }
+
+    MatchingStats &memory_rejected_queries(size_t value) { _memory_rejected_queries = value; return *this; }
+    size_t memory_rejected_queries() const { return _memory_rejected_queries; }
+
     MatchingStats &docidSpaceCovered(size_t value) { _docidSpaceCovered = value; return *this; }
     size_t docidSpaceCovered() const { return _docidSpaceCovered; }
 
@@ -165,6 +191,12 @@ public:
     MatchingStats &softDoomed(size_t value) { _softDoomed = value; return *this; }
     size_t softDoomed() const { return _softDoomed; }
 
+    MatchingStats &localRanges(size_t value) { _localRanges = value; return *this; }
+    size_t localRanges() const { return _localRanges; }
+
+    MatchingStats &stolenRanges(size_t value) { _stolenRanges = value; return *this; }
+    size_t stolenRanges() const { return _stolenRanges; }
+
     vespalib::duration doomOvertime() const { return vespalib::from_s(_doomOvertime.max()); }
 
     MatchingStats &softDoomFactor(double value) { _softDoomFactor.store_relaxed(value); return *this; }
@@ -201,6 +233,20 @@ public:
     double rerankTimeMin() const { return _rerankTime.min(); }
     double rerankTimeMax() const { return _rerankTime.max(); }
 
+    // matching time saved by serving a query from the result cache
+    MatchingStats &result_cache_saved_time(double time_s) { _result_cache_saved_time.set(time_s); return *this; }
+    double result_cache_saved_time_avg() const { return _result_cache_saved_time.avg(); }
+    size_t result_cache_saved_time_count() const { return _result_cache_saved_time.count(); }
+    double result_cache_saved_time_min() const { return _result_cache_saved_time.min(); }
+    double result_cache_saved_time_max() const { return _result_cache_saved_time.max(); }
+
+    // estimated memory (bytes) used by a query, see QueryMemoryEstimate
+    MatchingStats &query_memory(size_t bytes) { _query_memory.set(bytes); return *this; }
+    double query_memory_avg() const { return _query_memory.avg(); }
+    size_t query_memory_count() const { return _query_memory.count(); }
+    double query_memory_min() const { return _query_memory.min(); }
+    double query_memory_max() const { return _query_memory.max(); }
+
     // used to merge in stats from each match thread
     MatchingStats &merge_partition(const Partition &partition, size_t id);
     size_t getNumPartitions() const { return _partitions.size(); }
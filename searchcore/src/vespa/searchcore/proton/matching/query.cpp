@@ -213,10 +213,11 @@ Query::fetchPostings(const ExecuteInfo & executeInfo)
 void
 Query::handle_global_filter(const IRequestContext & requestContext, uint32_t docid_limit,
                             double global_filter_lower_limit, double global_filter_upper_limit,
-                            search::engine::Trace& trace, bool sort_by_cost)
+                            search::engine::Trace& trace, bool sort_by_cost,
+                            GlobalFilterCache* filter_cache, const GlobalFilterCache::Key* filter_cache_key)
 {
     if (!handle_global_filter(*_blueprint, docid_limit, global_filter_lower_limit, global_filter_upper_limit,
-                              requestContext.thread_bundle(), &trace))
+                              requestContext.thread_bundle(), &trace, filter_cache, filter_cache_key))
     {
         return;
     }
@@ -231,7 +232,8 @@ Query::handle_global_filter(const IRequestContext & requestContext, uint32_t doc
 bool
 Query::handle_global_filter(Blueprint& blueprint, uint32_t docid_limit,
                             double global_filter_lower_limit, double global_filter_upper_limit,
-                            vespalib::ThreadBundle &thread_bundle, search::engine::Trace* trace)
+                            vespalib::ThreadBundle &thread_bundle, search::engine::Trace* trace,
+                            GlobalFilterCache* filter_cache, const GlobalFilterCache::Key* filter_cache_key)
 {
     using search::queryeval::GlobalFilter;
     double estimated_hit_ratio = blueprint.getState().hit_ratio(docid_limit);
@@ -253,7 +255,22 @@ Query::handle_global_filter(Blueprint& blueprint, uint32_t docid_limit,
             trace->addEvent(5, vespalib::make_string("Calculate global filter (estimated_hit_ratio (%f) <= upper_limit (%f))",
                                                      estimated_hit_ratio, global_filter_upper_limit));
         }
-        global_filter = GlobalFilter::create(blueprint, docid_limit, thread_bundle, trace);
+        bool use_cache = (filter_cache != nullptr) && (filter_cache_key != nullptr);
+        if (use_cache) {
+            global_filter = filter_cache->lookup(*filter_cache_key, vespalib::steady_clock::now());
+            if (global_filter && trace && trace->shouldTrace(5)) {
+                trace->addEvent(5, "Use cached global filter");
+            }
+        }
+        if (!global_filter) {
+            vespalib::Timer timer;
+            global_filter = GlobalFilter::create(blueprint, docid_limit, thread_bundle, trace);
+            if (use_cache && filter_cache->insert(*filter_cache_key, vespalib::steady_clock::now(), global_filter,
+                                                  timer.elapsed()) && trace && trace->shouldTrace(5))
+            {
+                trace->addEvent(5, "Add global filter to cache");
+            }
+        }
         if (!global_filter->is_active() && trace && trace->shouldTrace(5)) {
             trace->addEvent(5, "Global filter matches everything");
         }
@@ -2,6 +2,7 @@
 
 #pragma once
 
+#include "global_filter_cache.h"
 #include <vespa/searchlib/common/geo_location_spec.h>
 #include <vespa/searchlib/fef/itermdata.h>
 #include <vespa/searchlib/fef/matchdatalayout.h>
@@ -108,7 +109,9 @@ public:
 
     void handle_global_filter(const IRequestContext & requestContext, uint32_t docid_limit,
                               double global_filter_lower_limit, double global_filter_upper_limit,
-                              search::engine::Trace& trace, bool sort_by_cost);
+                              search::engine::Trace& trace, bool sort_by_cost,
+                              GlobalFilterCache* filter_cache = nullptr,
+                              const GlobalFilterCache::Key* filter_cache_key = nullptr);
 
     /**
      * Calculates and handles the global filter if needed by the blueprint tree.
@@ -118,6 +121,8 @@ public:
      *     Nothing is done.
      * 2) estimated_hit_ratio <= global_filter_upper_limit:
      *     Calculate the global filter and set it on the blueprint.
+     *     If a filter cache and key are given, a cached filter is used
+     *     when valid, and a calculated filter is offered to the cache.
      * 3) estimated_hit_ratio > global_filter_upper_limit:
      *     Set a "match all filter" on the blueprint.
      *
@@ -125,7 +130,9 @@ public:
      */
     static bool handle_global_filter(Blueprint& blueprint, uint32_t docid_limit,
                                      double global_filter_lower_limit, double global_filter_upper_limit,
-                                     vespalib::ThreadBundle &thread_bundle, search::engine::Trace* trace);
+                                     vespalib::ThreadBundle &thread_bundle, search::engine::Trace* trace,
+                                     GlobalFilterCache* filter_cache = nullptr,
+                                     const GlobalFilterCache::Key* filter_cache_key = nullptr);
 
     void freeze();
 
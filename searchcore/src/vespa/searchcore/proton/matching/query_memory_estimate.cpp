@@ -0,0 +1,38 @@
+// Copyright Vespa.ai. Licensed under the terms of the Apache 2.0 license. See LICENSE in the project root.
+
+#include "query_memory_estimate.h"
+#include <algorithm>
+#include <utility>
+
+namespace proton::matching {
+
+size_t
+QueryMemoryEstimate::query_bytes() const noexcept
+{
+    return query_size * bytes_per_query_byte * (1 + num_threads);
+}
+
+size_t
+QueryMemoryEstimate::hit_collector_bytes() const noexcept
+{
+    // see search::HitCollector: a heap of ranked hits, an array of
+    // docids and a bitvector over all docs when the array overflows
+    size_t per_thread = (size_t(heap_size) * sizeof(std::pair<uint32_t, double>)) +
+                        (size_t(std::max(heap_size, array_size)) * sizeof(uint32_t));
+    if (est_hits > std::max(heap_size, array_size)) {
+        per_thread += (docid_limit / 8);
+    }
+    return per_thread * num_threads;
+}
+
+size_t
+QueryMemoryEstimate::grouping_bytes() const noexcept
+{
+    if (!has_grouping) {
+        return 0;
+    }
+    size_t groups = (max_groups_per_thread > 0) ? std::min(max_groups_per_thread, est_hits) : est_hits;
+    return groups * bytes_per_group * num_threads;
+}
+
+}
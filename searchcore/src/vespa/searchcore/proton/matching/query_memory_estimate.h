@@ -0,0 +1,42 @@
+// Copyright Vespa.ai. Licensed under the terms of the Apache 2.0 license. See LICENSE in the project root.
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+namespace proton::matching {
+
+/**
+ * Rough upper bound of the memory used while matching a query, known
+ * before matching starts. Covers the query tree (blueprints shared by
+ * all match threads and one iterator tree per thread), the hit
+ * collector of each match thread and grouping. Used for admission
+ * control against the query memory budget in QueryLimiter, and
+ * reported in the matching metrics.
+ **/
+struct QueryMemoryEstimate {
+    // memory used per byte of serialized query for blueprints and iterators
+    static constexpr size_t bytes_per_query_byte = 64;
+    static constexpr size_t bytes_per_group = 256;
+
+    uint32_t docid_limit;
+    uint32_t num_threads;
+    uint32_t heap_size;
+    uint32_t array_size;
+    uint32_t est_hits;
+    size_t   query_size;
+    bool     has_grouping;
+    uint32_t max_groups_per_thread; // 0 means no limit
+
+    QueryMemoryEstimate() noexcept
+        : docid_limit(0), num_threads(1), heap_size(0), array_size(0), est_hits(0),
+          query_size(0), has_grouping(false), max_groups_per_thread(0)
+    {}
+    size_t query_bytes() const noexcept;
+    size_t hit_collector_bytes() const noexcept;
+    size_t grouping_bytes() const noexcept;
+    size_t bytes() const noexcept { return query_bytes() + hit_collector_bytes() + grouping_bytes(); }
+};
+
+}
@@ -0,0 +1,149 @@
+// Copyright Vespa.ai. Licensed under the terms of the Apache 2.0 license. See LICENSE in the project root.
+
+#include "query_profile_stats.h"
+#include <vespa/searchlib/fef/blueprintresolver.h>
+#include <vespa/vespalib/data/slime/cursor.h>
+#include <vespa/vespalib/util/execution_profiler.h>
+#include <algorithm>
+#include <vector>
+
+using search::fef::BlueprintResolver;
+using vespalib::ExecutionProfiler;
+
+namespace proton::matching {
+
+namespace {
+
+double as_ms(vespalib::duration d) {
+    return (vespalib::count_ns(d) / 1000000.0);
+}
+
+vespalib::string strip_path(const vespalib::string &name) {
+    auto op = name.rfind('/');
+    if ((op == vespalib::string::npos) || (op == 0)) {
+        return name;
+    }
+    auto cls = name.rfind('/', op - 1);
+    return (cls == vespalib::string::npos) ? name : name.substr(cls + 1);
+}
+
+}
+
+QueryProfileStats::Sample::Sample() = default;
+QueryProfileStats::Sample::~Sample() = default;
+
+void
+QueryProfileStats::Sample::add(const vespalib::string &task, size_t count, vespalib::duration self_time)
+{
+    auto &entry = _entries[task];
+    entry.count += count;
+    entry.self_time += self_time;
+}
+
+void
+QueryProfileStats::Sample::add_match_profile(const ExecutionProfiler &profiler)
+{
+    profiler.visit_tasks([&](ExecutionProfiler::TaskId task, size_t count, vespalib::duration self_time)
+                         {
+                             add("match/" + strip_path(profiler.name_of(task)), count, self_time);
+                         });
+}
+
+void
+QueryProfileStats::Sample::add_rank_profile(const vespalib::string &phase, const ExecutionProfiler &profiler)
+{
+    profiler.visit_tasks([&](ExecutionProfiler::TaskId task, size_t count, vespalib::duration self_time)
+                         {
+                             add(phase + "/" + BlueprintResolver::describe_feature(profiler.name_of(task)),
+                                 count, self_time);
+                         });
+}
+
+QueryProfileStats::Task::Task() noexcept
+    : queries(0),
+      count(0),
+      total_time_ms(0.0),
+      max_time_ms(0.0),
+      histogram()
+{
+}
+
+void
+QueryProfileStats::Task::add(size_t count_in, double time_ms) noexcept
+{
+    ++queries;
+    count += count_in;
+    total_time_ms += time_ms;
+    max_time_ms = std::max(max_time_ms, time_ms);
+    size_t bucket = std::upper_bound(bucket_limits_ms.begin(), bucket_limits_ms.end(), time_ms) - bucket_limits_ms.begin();
+    ++histogram[bucket];
+}
+
+QueryProfileStats::QueryProfileStats()
+    : _lock(),
+      _sampled_queries(0),
+      _tasks()
+{
+}
+
+QueryProfileStats::~QueryProfileStats() = default;
+
+void
+QueryProfileStats::add(const Sample &sample)
+{
+    std::lock_guard guard(_lock);
+    ++_sampled_queries;
+    for (const auto &[name, entry] : sample.entries()) {
+        _tasks[name].add(entry.count, as_ms(entry.self_time));
+    }
+}
+
+size_t
+QueryProfileStats::sampled_queries() const
+{
+    std::lock_guard guard(_lock);
+    return _sampled_queries;
+}
+
+QueryProfileStats::TaskMap
+QueryProfileStats::tasks() const
+{
+    std::lock_guard guard(_lock);
+    return _tasks;
+}
+
+void
+QueryProfileStats::report(vespalib::slime::Cursor &obj) const
+{
+    std::lock_guard guard(_lock);
+    obj.setLong("sampled_queries", _sampled_queries);
+    auto &limits = obj.setArray("bucket_limits_ms");
+    for (double limit : bucket_limits_ms) {
+        limits.addDouble(limit);
+    }
+    std::vector<const TaskMap::value_type *> sorted;
+    sorted.reserve(_tasks.size());
+    for (const auto &entry : _tasks) {
+        sorted.push_back(&entry);
+    }
+    std::sort(sorted.begin(), sorted.end(), [](const auto *a, const auto *b) {
+        return (a->second.total_time_ms > b->second.total_time_ms);
+    });
+    auto &arr = obj.setArray("tasks");
+    for (const auto *entry : sorted) {
+        const Task &task = entry->second;
+        auto &task_obj = arr.addObject();
+        task_obj.setString("name", entry->first);
+        task_obj.setLong("queries", task.queries);
+        task_obj.setLong("count", task.count);
+        task_obj.setDouble("total_time_ms", task.total_time_ms);
+        task_obj.setDouble("avg_time_ms", task.total_time_ms / task.queries);
+        task_obj.setDouble("max_time_ms", task.max_time_ms);
+        auto &histogram = task_obj.setArray("histogram");
+        for (size_t bucket_count : task.histogram) {
+            histogram.addLong(bucket_count);
+        }
+    }
+}
+
+}
@@ -0,0 +1,80 @@
+// Copyright Vespa.ai. Licensed under the terms of the Apache 2.0 license. See LICENSE in the project root.
+
+#pragma once
+
+#include <vespa/vespalib/stllike/string.h>
+#include <vespa/vespalib/util/time.h>
+#include <array>
+#include <map>
+#include <mutex>
+
+namespace vespalib { class ExecutionProfiler; }
+namespace vespalib::slime { struct Cursor; }
+
+namespace proton::matching {
+
+/**
+ * Profiling information aggregated across the sampled queries of a
+ * rank profile. The time spent in each task (iterator type and
+ * operation when matching, feature executor when ranking) is
+ * collected for each sampled query, and the per-query time of each
+ * task is tracked in a histogram.
+ **/
+class QueryProfileStats
+{
+public:
+    /**
+     * Time spent per task in a single sampled query, combined across
+     * all match threads.
+     **/
+    class Sample {
+    public:
+        struct Entry {
+            size_t             count;
+            vespalib::duration self_time;
+            Entry() noexcept : count(0), self_time(vespalib::duration::zero()) {}
+        };
+        using Map = std::map<vespalib::string, Entry>;
+    private:
+        Map _entries;
+    public:
+        Sample();
+        ~Sample();
+        void add(const vespalib::string &task, size_t count, vespalib::duration self_time);
+        // iterator tasks named '<path>/<class>/<operation>' are tracked as '<class>/<operation>'
+        void add_match_profile(const vespalib::ExecutionProfiler &profiler);
+        void add_rank_profile(const vespalib::string &phase, const vespalib::ExecutionProfiler &profiler);
+        const Map &entries() const noexcept { return _entries; }
+    };
+
+    // upper limits (in ms) of the histogram buckets, the last bucket is unbounded
+    static constexpr std::array<double, 6> bucket_limits_ms = {0.01, 0.1, 1.0, 10.0, 100.0, 1000.0};
+    static constexpr size_t num_buckets = bucket_limits_ms.size() + 1;
+
+    struct Task {
+        size_t                          queries;
+        size_t                          count;
+        double                          total_time_ms;
+        double                          max_time_ms;
+        std::array<size_t, num_buckets> histogram;
+        Task() noexcept;
+        void add(size_t count_in, double time_ms) noexcept;
+    };
+    using TaskMap = std::map<vespalib::string, Task>;
+
+private:
+    mutable std::mutex _lock;
+    size_t             _sampled_queries;
+    TaskMap            _tasks;
+
+public:
+    QueryProfileStats();
+    ~QueryProfileStats();
+    void add(const Sample &sample);
+    size_t sampled_queries() const;
+    TaskMap tasks() const;
+    // tasks are reported ordered by total time, most expensive first
+    void report(vespalib::slime::Cursor &obj) const;
+};
+
+}
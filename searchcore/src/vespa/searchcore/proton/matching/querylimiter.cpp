@@ -15,6 +15,11 @@ QueryLimiter::LimitedToken::~LimitedToken()
     _limiter.releaseToken();
 }
 
+QueryLimiter::MemoryToken::~MemoryToken()
+{
+    _limiter.release_memory(_bytes);
+}
+
 void
 QueryLimiter::grabToken(const Doom & doom)
 {
@@ -36,13 +41,22 @@ QueryLimiter::releaseToken()
     _cond.notify_one();
 }
 
+void
+QueryLimiter::release_memory(size_t bytes)
+{
+    std::lock_guard<std::mutex> guard(_lock);
+    _reservedMemory -= bytes;
+}
+
 QueryLimiter::QueryLimiter() :
     _lock(),
     _cond(),
     _activeThreads(0),
+    _reservedMemory(0),
     _maxThreads(-1),
     _coverage(1.0),
-    _minHits(std::numeric_limits<uint32_t>::max())
+    _minHits(std::numeric_limits<uint32_t>::max()),
+    _maxMemory(0)
 {
 }
 
@@ -71,4 +85,29 @@ QueryLimiter::getToken(const Doom & doom, uint32_t numDocs, uint32_t numHits, bo
     return std::make_unique<NoLimitToken>();
 }
 
+void
+QueryLimiter::configure_memory(size_t maxBytes)
+{
+    _maxMemory.store(maxBytes, std::memory_order_relaxed);
+}
+
+QueryLimiter::Token::UP
+QueryLimiter::reserve_memory(size_t bytes)
+{
+    size_t max_memory = _maxMemory.load(std::memory_order_relaxed);
+    std::lock_guard<std::mutex> guard(_lock);
+    if ((max_memory > 0) && (_reservedMemory > 0) && (_reservedMemory + bytes > max_memory)) {
+        return {};
+    }
+    _reservedMemory += bytes;
+    return std::make_unique<MemoryToken>(*this, bytes);
+}
+
+size_t
+QueryLimiter::reserved_memory() const
+{
+    std::lock_guard<std::mutex> guard(_lock);
+    return _reservedMemory;
+}
+
 }
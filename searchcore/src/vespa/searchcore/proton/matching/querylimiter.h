@@ -23,6 +23,22 @@ public:
     QueryLimiter();
     void configure(int maxThreads, double coverage, uint32_t minHits);
     Token::UP getToken(const Doom & doom, uint32_t numDocs, uint32_t numHits, bool hasSorting, bool hasGrouping);
+
+    /**
+     * Set the total amount of memory (bytes) that may be reserved by
+     * concurrent queries. 0 means no limit.
+     **/
+    void configure_memory(size_t maxBytes);
+
+    /**
+     * Reserve memory for a query for as long as the returned token
+     * lives. Returns nullptr if the reservation would exceed the
+     * configured budget. A query is always admitted when nothing else
+     * is reserved, so a single query larger than the budget can still
+     * run on an otherwise idle node.
+     **/
+    Token::UP reserve_memory(size_t bytes);
+    size_t reserved_memory() const;
 private:
     class NoLimitToken : public Token {
     };
@@ -35,16 +51,29 @@ private:
         LimitedToken & operator =(const NoLimitToken &) = delete;
         ~LimitedToken() override;
     };
+    class MemoryToken : public Token {
+    private:
+        QueryLimiter & _limiter;
+        size_t         _bytes;
+    public:
+        MemoryToken(QueryLimiter & limiter, size_t bytes) noexcept : _limiter(limiter), _bytes(bytes) {}
+        MemoryToken(const MemoryToken &) = delete;
+        MemoryToken & operator =(const MemoryToken &) = delete;
+        ~MemoryToken() override;
+    };
     void grabToken(const Doom & doom);
     void releaseToken();
-    std::mutex              _lock;
+    void release_memory(size_t bytes);
+    mutable std::mutex      _lock;
     std::condition_variable _cond;
     int _activeThreads;
+    size_t _reservedMemory;
 
     // These are updated asynchronously at reconfig.
     std::atomic<int>      _maxThreads;
     std::atomic<double>   _coverage;
     std::atomic<uint32_t> _minHits;
+    std::atomic<size_t>   _maxMemory;
 
     [[nodiscard]] int get_max_threads() const noexcept { return _maxThreads.load(std::memory_order_relaxed); }
     [[nodiscard]] double get_coverage() const noexcept { return _coverage.load(std::memory_order_relaxed); }
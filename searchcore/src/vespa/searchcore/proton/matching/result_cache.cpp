@@ -0,0 +1,119 @@
+// Copyright Vespa.ai. Licensed under the terms of the Apache 2.0 license. See LICENSE in the project root.
+
+#include "result_cache.h"
+#include <vespa/searchlib/engine/searchreply.h>
+#include <vespa/searchlib/engine/searchrequest.h>
+#include <vespa/vespalib/objects/nbostream.h>
+#include <vespa/vespalib/stllike/lrucache_map.hpp>
+#include <algorithm>
+
+using search::engine::SearchReply;
+using search::engine::SearchRequest;
+using search::fef::IPropertiesVisitor;
+using search::fef::Properties;
+using search::fef::Property;
+
+namespace proton::matching {
+
+namespace {
+
+void
+append(vespalib::nbostream &os, const std::vector<char> &data)
+{
+    os << vespalib::stringref(data.data(), data.size());
+}
+
+struct PropertiesSerializer : IPropertiesVisitor {
+    vespalib::nbostream &os;
+    explicit PropertiesSerializer(vespalib::nbostream &os_in) noexcept : os(os_in) {}
+    void visitProperty(const Property::Value &key, const Property &values) override {
+        os << key << values.size();
+        for (uint32_t i = 0; i < values.size(); ++i) {
+            os << values.getAt(i);
+        }
+    }
+};
+
+}
+
+ResultCache::ResultCache(size_t max_entries, vespalib::duration max_age)
+    : _lock(),
+      _cache(max_entries),
+      _max_age(max_age)
+{
+}
+
+ResultCache::~ResultCache() = default;
+
+bool
+ResultCache::is_cacheable(const SearchRequest &request)
+{
+    return request.sessionId.empty() && !request.dumpFeatures && (request.trace().getLevel() == 0);
+}
+
+bool
+ResultCache::is_complete(const SearchReply &reply, uint32_t num_active_lids)
+{
+    return !reply.coverage.wasDegradedByTimeout() && (reply.coverage.getActive() == num_active_lids);
+}
+
+vespalib::string
+ResultCache::make_key(const SearchRequest &request)
+{
+    vespalib::nbostream os;
+    os << request.ranking << request.offset << request.maxhits << request.sortSpec << request.location;
+    append(os, request.groupSpec);
+    append(os, request.stackDump);
+    std::vector<std::pair<vespalib::stringref, const Properties *>> namespaces;
+    namespaces.reserve(request.propertiesMap.size());
+    for (const auto &entry : request.propertiesMap) {
+        namespaces.emplace_back(entry.first, &entry.second);
+    }
+    std::sort(namespaces.begin(), namespaces.end(),
+              [](const auto &a, const auto &b) noexcept { return a.first < b.first; });
+    PropertiesSerializer serializer(os);
+    for (const auto &[name, props] : namespaces) {
+        os << name << props->numKeys();
+        props->visitProperties(serializer);
+    }
+    return {os.data(), os.size()};
+}
+
+ResultCache::CachedResult
+ResultCache::lookup(const vespalib::string &key, SerialNum serial_num, uint32_t num_active_lids,
+                    vespalib::steady_time now)
+{
+    CachedResult result;
+    std::lock_guard guard(_lock);
+    Entry *entry = _cache.findAndRef(key);
+    if (entry == nullptr) {
+        return result;
+    }
+    if ((entry->serial_num != serial_num) || (entry->num_active_lids != num_active_lids) ||
+        ((now - entry->created) > _max_age))
+    {
+        _cache.erase(key);
+        return result;
+    }
+    result.reply = std::make_unique<SearchReply>(*entry->reply);
+    result.match_time = entry->match_time;
+    return result;
+}
+
+void
+ResultCache::insert(const vespalib::string &key, SerialNum serial_num, uint32_t num_active_lids,
+                    vespalib::steady_time now, const SearchReply &reply, vespalib::duration match_time)
+{
+    auto copy = std::make_shared<const SearchReply>(reply);
+    std::lock_guard guard(_lock);
+    _cache[key] = Entry{std::move(copy), serial_num, num_active_lids, now, match_time};
+}
+
+size_t
+ResultCache::size()
+{
+    std::lock_guard guard(_lock);
+    return _cache.size();
+}
+
+}
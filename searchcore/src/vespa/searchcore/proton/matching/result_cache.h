@@ -0,0 +1,85 @@
+// Copyright Vespa.ai. Licensed under the terms of the Apache 2.0 license. See LICENSE in the project root.
+
+#pragma once
+
+#include <vespa/searchlib/common/serialnum.h>
+#include <vespa/vespalib/stllike/lrucache_map.h>
+#include <vespa/vespalib/stllike/string.h>
+#include <vespa/vespalib/util/time.h>
+#include <memory>
+#include <mutex>
+
+namespace search::engine {
+    class SearchRequest;
+    class SearchReply;
+}
+
+namespace proton::matching {
+
+/**
+ * LRU cache of query results (hits, sort data, grouping and coverage)
+ * for a single rank profile, keyed on the normalized query request.
+ *
+ * Each entry remembers the last serial number and the number of
+ * active documents of the document meta store when the result was
+ * produced, and is only used while both are unchanged and the entry
+ * is younger than the configured max age.
+ **/
+class ResultCache
+{
+public:
+    using SearchReply = search::engine::SearchReply;
+    using SearchRequest = search::engine::SearchRequest;
+    using SerialNum = search::SerialNum;
+
+    struct CachedResult {
+        std::unique_ptr<SearchReply> reply;
+        // time spent producing the cached result
+        vespalib::duration           match_time;
+        CachedResult() noexcept : reply(), match_time(vespalib::duration::zero()) {}
+    };
+private:
+    struct Entry {
+        std::shared_ptr<const SearchReply> reply;
+        SerialNum                          serial_num;
+        uint32_t                           num_active_lids;
+        vespalib::steady_time              created;
+        vespalib::duration                 match_time;
+    };
+    using Cache = vespalib::lrucache_map<vespalib::LruParam<vespalib::string, Entry>>;
+    std::mutex         _lock;
+    Cache              _cache;
+    vespalib::duration _max_age;
+public:
+    ResultCache(size_t max_entries, vespalib::duration max_age);
+    ResultCache(const ResultCache &) = delete;
+    ResultCache & operator =(const ResultCache &) = delete;
+    ~ResultCache();
+
+    /**
+     * Requests that use sessions, tracing or feature dumping are
+     * never cached.
+     **/
+    static bool is_cacheable(const SearchRequest &request);
+
+    /**
+     * Only results covering all active documents, as seen when the
+     * lookup was made, are cached.
+     **/
+    static bool is_complete(const SearchReply &reply, uint32_t num_active_lids);
+
+    /**
+     * Serialize everything in the request affecting the result into
+     * a cache key. Property namespaces are ordered by name, so the
+     * key does not depend on the order properties were added.
+     **/
+    static vespalib::string make_key(const SearchRequest &request);
+
+    CachedResult lookup(const vespalib::string &key, SerialNum serial_num, uint32_t num_active_lids,
+                        vespalib::steady_time now);
+    void insert(const vespalib::string &key, SerialNum serial_num, uint32_t num_active_lids,
+                vespalib::steady_time now, const SearchReply &reply, vespalib::duration match_time);
+    size_t size();
+};
+
+}
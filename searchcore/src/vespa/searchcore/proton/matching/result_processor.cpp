@@ -8,6 +8,7 @@
 #include <vespa/searchcore/grouping/groupingcontext.h>
 #include <vespa/searchlib/uca/ucaconverter.h>
 #include <vespa/searchlib/engine/searchreply.h>
+#include <vespa/vespalib/util/featureset.h>
 
 #include <vespa/log/log.h>
 LOG_SETUP(".proton.matching.result_processor");
@@ -21,7 +22,8 @@ namespace proton::matching {
 
 ResultProcessor::Result::Result(std::unique_ptr<search::engine::SearchReply> reply, size_t numFs4Hits)
     : _reply(std::move(reply)),
-      _numFs4Hits(numFs4Hits)
+      _numFs4Hits(numFs4Hits),
+      _summary_features()
 { }
 
 ResultProcessor::Result::~Result() = default;
@@ -80,6 +82,22 @@ ResultProcessor::ResultProcessor(IAttributeContext &attrContext,
 
 ResultProcessor::~ResultProcessor() = default;
 
+void
+ResultProcessor::set_max_groups_per_thread(uint32_t max_groups_per_thread)
+{
+    if (_groupingSession) {
+        _groupingSession->setMaxGroupsPerThread(max_groups_per_thread);
+    }
+}
+
+void
+ResultProcessor::set_grouping_sample_rate(double sample_rate)
+{
+    if (_groupingSession) {
+        _groupingSession->setSampleRate(sample_rate);
+    }
+}
+
 void
 ResultProcessor::prepareThreadContextCreation(size_t num_threads)
 {
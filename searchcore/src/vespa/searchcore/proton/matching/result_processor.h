@@ -17,6 +17,8 @@ namespace search {
     class BitVector;
 }
 
+namespace vespalib { class FeatureSet; }
+
 namespace proton::matching {
 
 class SessionManager;
@@ -78,6 +80,8 @@ public:
         ~Result();
         std::unique_ptr<SearchReply> _reply;
         size_t _numFs4Hits;
+        // summary features of the returned hits, when calculated as part of matching
+        std::unique_ptr<vespalib::FeatureSet> _summary_features;
     };
 
 private:
@@ -101,6 +105,10 @@ public:
                     size_t offset, size_t hits);
     ~ResultProcessor();
 
+    // Sorting and grouping use the rank scores of hits that are not among the best hits
+    bool has_sort_or_grouping() const noexcept { return !_sortSpec.empty() || bool(_groupingSession); }
+    void set_max_groups_per_thread(uint32_t max_groups_per_thread);
+    void set_grouping_sample_rate(double sample_rate);
     void prepareThreadContextCreation(size_t num_threads);
     std::unique_ptr<Context> createThreadContext(const vespalib::Doom & hardDoom, size_t thread_id, uint32_t distributionKey);
     std::vector<std::pair<uint32_t,uint32_t>> extract_docid_ordering(const PartialResult &result) const;
@@ -10,6 +10,7 @@
 #include <memory>
 
 namespace search::fef { class Properties; }
+namespace vespalib { class FeatureSet; }
 
 namespace proton::matching {
 
@@ -42,6 +43,7 @@ private:
     vespalib::steady_time _time_of_doom;
     OwnershipBundle       _owned_objects;
     std::unique_ptr<MatchToolsFactory> _match_tools_factory;
+    std::shared_ptr<vespalib::FeatureSet> _summary_features;
 
 public:
     using SP = std::shared_ptr<SearchSession>;
@@ -64,6 +66,15 @@ public:
     vespalib::steady_time getTimeOfDoom() const { return _time_of_doom; }
 
     MatchToolsFactory &getMatchToolsFactory() { return *_match_tools_factory; }
+
+    /**
+     * Summary features of the returned hits, calculated as part of
+     * matching. Not set unless requested by the rank profile or query.
+     */
+    void set_summary_features(std::shared_ptr<vespalib::FeatureSet> summary_features) {
+        _summary_features = std::move(summary_features);
+    }
+    const std::shared_ptr<vespalib::FeatureSet> &get_summary_features() const { return _summary_features; }
 };
 
 }
@@ -5,6 +5,7 @@
 #include <vespa/vespalib/stllike/hash_map.hpp>
 #include <vespa/vespalib/util/lambdatask.h>
 #include <vespa/vespalib/util/foreground_thread_executor.h>
+#include <vespa/vespalib/util/lock_stats.h>
 #include <mutex>
 #include <algorithm>
 
@@ -21,7 +22,9 @@ struct SessionCacheBase {
 protected:
     Stats _stats;
     mutable std::mutex _lock;
+    vespalib::LockStats &_lockStats;
 
+    SessionCacheBase() : _stats(), _lock(), _lockStats(vespalib::LockStats::get("proton.session_manager")) {}
     void entryDropped(const SessionId &id);
     ~SessionCacheBase() {}
 };
@@ -34,7 +37,7 @@ struct SessionCache : SessionCacheBase {
     SessionCache(uint32_t max_size) : _cache(max_size) {}
 
     void insert(EntryUP session) {
-        std::lock_guard<std::mutex> guard(_lock);
+        auto guard = _lockStats.lock(_lock);
         const SessionId &id(session->getSessionId());
         if (_cache.size() >= _cache.capacity()) {
             entryDropped(id);
@@ -43,7 +46,7 @@ struct SessionCache : SessionCacheBase {
         _stats.numInsert++;
     }
     EntryUP pick(const SessionId & id) {
-        std::lock_guard<std::mutex> guard(_lock);
+        auto guard = _lockStats.lock(_lock);
         EntryUP ret;
         if (_cache.hasKey(id)) {
             _stats.numPick++;
@@ -54,7 +57,7 @@ struct SessionCache : SessionCacheBase {
     }
     std::vector<EntryUP> stealTimedOutSessions(vespalib::steady_time currentTime) {
         std::vector<EntryUP> toDestruct;
-        std::lock_guard<std::mutex> guard(_lock);
+        auto guard = _lockStats.lock(_lock);
         toDestruct.reserve(_cache.size());
         for (auto it(_cache.begin()), mt(_cache.end()); it != mt;) {
             auto &session = *it;
@@ -69,14 +72,14 @@ struct SessionCache : SessionCacheBase {
         return toDestruct;
     }
     Stats getStats() {
-        std::lock_guard<std::mutex> guard(_lock);
+        auto guard = _lockStats.lock(_lock);
         Stats stats = _stats;
         stats.numCached = _cache.size();
         _stats = Stats();
         return stats;
     }
     bool empty() const {
-        std::lock_guard<std::mutex> guard(_lock);
+        auto guard = _lockStats.lock(_lock);
         return _cache.empty();
     }
 };
@@ -87,13 +90,13 @@ struct SessionMap : SessionCacheBase {
     vespalib::hash_map<SessionId, EntrySP> _map;
 
     void insert(EntrySP session) {
-        std::lock_guard<std::mutex> guard(_lock);
+        auto guard = _lockStats.lock(_lock);
         const SessionId &id(session->getSessionId());
         _map.insert(std::make_pair(id, session));
         _stats.numInsert++;
     }
     EntrySP pick(const SessionId & id) {
-        std::lock_guard<std::mutex> guard(_lock);
+        auto guard = _lockStats.lock(_lock);
         auto it = _map.find(id);
         if (it != _map.end()) {
             _stats.numPick++;
@@ -104,7 +107,7 @@ struct SessionMap : SessionCacheBase {
     std::vector<EntrySP> stealTimedOutSessions(vespalib::steady_time currentTime) {
         std::vector<EntrySP> toDestruct;
         std::vector<SessionId> keys;
-        std::lock_guard<std::mutex> guard(_lock);
+        auto guard = _lockStats.lock(_lock);
         keys.reserve(_map.size());
         toDestruct.reserve(_map.size());
         for (auto & it : _map) {
@@ -122,23 +125,23 @@ struct SessionMap : SessionCacheBase {
         return toDestruct;
     }
     Stats getStats() {
-        std::lock_guard<std::mutex> guard(_lock);
+        auto guard = _lockStats.lock(_lock);
         Stats stats = _stats;
         stats.numCached = _map.size();
         _stats = Stats();
         return stats;
     }
     size_t size() const {
-        std::lock_guard<std::mutex> guard(_lock);
+        auto guard = _lockStats.lock(_lock);
         return _map.size();
     }
     bool empty() const {
-        std::lock_guard<std::mutex> guard(_lock);
+        auto guard = _lockStats.lock(_lock);
         return _map.empty();
     }
     template <typename F>
     void each(F f) const {
-        std::lock_guard<std::mutex> guard(_lock);
+        auto guard = _lockStats.lock(_lock);
         for (const auto &entry: _map) {
             f(*entry.second);
         }
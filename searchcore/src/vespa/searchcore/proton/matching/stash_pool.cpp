@@ -0,0 +1,46 @@
+// Copyright Vespa.ai. Licensed under the terms of the Apache 2.0 license. See LICENSE in the project root.
+
+#include "stash_pool.h"
+
+namespace proton::matching {
+
+StashPool::StashPool(size_t chunk_size, size_t max_pooled)
+    : _lock(),
+      _stashes(),
+      _chunk_size(chunk_size),
+      _max_pooled(max_pooled)
+{
+}
+
+StashPool::~StashPool() = default;
+
+vespalib::Stash
+StashPool::obtain()
+{
+    std::lock_guard guard(_lock);
+    if (_stashes.empty()) {
+        return vespalib::Stash(_chunk_size);
+    }
+    vespalib::Stash stash(std::move(_stashes.back()));
+    _stashes.pop_back();
+    return stash;
+}
+
+void
+StashPool::release(vespalib::Stash stash)
+{
+    stash.clear();
+    std::lock_guard guard(_lock);
+    if (_stashes.size() < _max_pooled) {
+        _stashes.push_back(std::move(stash));
+    }
+}
+
+size_t
+StashPool::size() const
+{
+    std::lock_guard guard(_lock);
+    return _stashes.size();
+}
+
+}
@@ -0,0 +1,37 @@
+// Copyright Vespa.ai. Licensed under the terms of the Apache 2.0 license. See LICENSE in the project root.
+
+#pragma once
+
+#include <vespa/vespalib/util/stash.h>
+#include <mutex>
+#include <vector>
+
+namespace proton::matching {
+
+/**
+ * Pool of stashes holding the match data and rank programs of a
+ * match thread. A stash given back to the pool is cleared, running
+ * the destructors of all objects in it, but keeps one chunk of memory
+ * that is reused by the next query. This avoids allocating and
+ * freeing the same memory for every query of a rank profile.
+ *
+ * The rank programs themselves are not reused, since feature
+ * executors keep query specific state from setup.
+ **/
+class StashPool {
+private:
+    mutable std::mutex           _lock;
+    std::vector<vespalib::Stash> _stashes;
+    const size_t                 _chunk_size;
+    const size_t                 _max_pooled;
+public:
+    StashPool(size_t chunk_size, size_t max_pooled);
+    StashPool(const StashPool &) = delete;
+    StashPool & operator=(const StashPool &) = delete;
+    ~StashPool();
+    vespalib::Stash obtain();
+    void release(vespalib::Stash stash);
+    size_t size() const;
+};
+
+}
@@ -0,0 +1,68 @@
+// Copyright Vespa.ai. Licensed under the terms of the Apache 2.0 license. See LICENSE in the project root.
+
+#include "term_stats_cache.h"
+#include <vespa/vespalib/stllike/hash_map.hpp>
+#include <mutex>
+
+namespace proton::matching {
+
+vespalib::string
+TermStatsCache::make_key(vespalib::stringref field, vespalib::stringref term)
+{
+    vespalib::string key(field);
+    key.push_back('\0');
+    key.append(term);
+    return key;
+}
+
+TermStatsCache::TermStatsCache()
+    : _lock(),
+      _stats()
+{
+}
+
+TermStatsCache::~TermStatsCache() = default;
+
+void
+TermStatsCache::set(vespalib::stringref field, vespalib::stringref term, Stats stats)
+{
+    std::unique_lock guard(_lock);
+    _stats[make_key(field, term)] = stats;
+}
+
+void
+TermStatsCache::update(const std::vector<Entry> &entries)
+{
+    std::unique_lock guard(_lock);
+    for (const auto &entry : entries) {
+        _stats[make_key(entry.field, entry.term)] = entry.stats;
+    }
+}
+
+void
+TermStatsCache::clear()
+{
+    std::unique_lock guard(_lock);
+    _stats.clear();
+}
+
+std::optional<TermStatsCache::Stats>
+TermStatsCache::lookup(vespalib::stringref field, vespalib::stringref term) const
+{
+    vespalib::string key = make_key(field, term);
+    std::shared_lock guard(_lock);
+    auto itr = _stats.find(key);
+    if (itr == _stats.end()) {
+        return std::nullopt;
+    }
+    return itr->second;
+}
+
+size_t
+TermStatsCache::size() const
+{
+    std::shared_lock guard(_lock);
+    return _stats.size();
+}
+
+}
@@ -0,0 +1,64 @@
+// Copyright Vespa.ai. Licensed under the terms of the Apache 2.0 license. See LICENSE in the project root.
+
+#pragma once
+
+#include <vespa/vespalib/stllike/hash_map.h>
+#include <vespa/vespalib/stllike/string.h>
+#include <optional>
+#include <shared_mutex>
+#include <vector>
+
+namespace proton::matching {
+
+/**
+ * In-memory cache of global (content cluster wide) document frequency
+ * statistics for query terms, keyed on field name and term. When a
+ * query term has statistics for all the fields it searches, these are
+ * used instead of the local hit estimate when setting the document
+ * frequency seen by rank features (bm25, nativeRank, ...), so that
+ * term significance is consistent across content nodes without an
+ * extra query round-trip.
+ *
+ * The statistics are pushed into the cache from the outside; the
+ * cache is shared by all generations of matchers for a document type.
+ **/
+class TermStatsCache
+{
+public:
+    struct Stats {
+        uint64_t matching_doc_count;
+        uint64_t total_doc_count;
+        Stats() noexcept : matching_doc_count(0), total_doc_count(0) {}
+        Stats(uint64_t matching_doc_count_in, uint64_t total_doc_count_in) noexcept
+            : matching_doc_count(matching_doc_count_in),
+              total_doc_count(total_doc_count_in)
+        {}
+        bool operator==(const Stats &rhs) const noexcept = default;
+    };
+    struct Entry {
+        vespalib::string field;
+        vespalib::string term;
+        Stats            stats;
+    };
+private:
+    using Map = vespalib::hash_map<vespalib::string, Stats>;
+    mutable std::shared_mutex _lock;
+    Map                       _stats;
+
+    static vespalib::string make_key(vespalib::stringref field, vespalib::stringref term);
+public:
+    TermStatsCache();
+    TermStatsCache(const TermStatsCache &) = delete;
+    TermStatsCache & operator =(const TermStatsCache &) = delete;
+    ~TermStatsCache();
+
+    void set(vespalib::stringref field, vespalib::stringref term, Stats stats);
+    // Replaces the statistics for the given terms, keeping all others.
+    void update(const std::vector<Entry> &entries);
+    void clear();
+    [[nodiscard]] std::optional<Stats> lookup(vespalib::stringref field, vespalib::stringref term) const;
+    [[nodiscard]] size_t size() const;
+    [[nodiscard]] bool empty() const { return size() == 0; }
+};
+
+}
@@ -8,7 +8,9 @@ using Entry = AttributeMetrics::Entry;
 
 AttributeMetrics::Entry::Entry(const vespalib::string &attrName)
     : metrics::MetricSet("attribute", {{"field", attrName}}, "Metrics for a given attribute vector", nullptr),
-      memoryUsage(this)
+      memoryUsage(this),
+      compactionPending("compaction_pending", {}, "The number of documents not yet visited by an ongoing "
+                        "compaction of the attribute vector (0 when no compaction is ongoing)", this)
 {
 }
 
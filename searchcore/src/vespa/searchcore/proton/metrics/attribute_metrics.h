@@ -3,6 +3,7 @@
 #pragma once
 
 #include "memory_usage_metrics.h"
+#include <vespa/metrics/valuemetric.h>
 #include <map>
 
 namespace proton {
@@ -13,6 +14,7 @@ public:
     struct Entry : public metrics::MetricSet {
         using SP = std::shared_ptr<Entry>;
         MemoryUsageMetrics memoryUsage;
+        metrics::LongValueMetric compactionPending;
         Entry(const vespalib::string &attrName);
     };
 private:
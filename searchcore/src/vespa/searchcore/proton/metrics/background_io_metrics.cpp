@@ -0,0 +1,45 @@
+// Copyright Vespa.ai. Licensed under the terms of the Apache 2.0 license. See LICENSE in the project root.
+
+#include "background_io_metrics.h"
+
+using vespalib::IoScheduler;
+
+namespace proton {
+
+BackgroundIoMetrics::ClassMetrics::ClassMetrics(const std::string &name, metrics::MetricSet *parent)
+    : metrics::MetricSet(name, {}, "Disk bandwidth used by a class of background work", parent),
+      bytes("bytes", {}, "Number of bytes written", this),
+      throttled("throttled", {}, "Number of writes that had to wait for disk bandwidth", this),
+      wait_time("wait_time", {}, "Time spent waiting for disk bandwidth (in ms)", this)
+{
+}
+
+BackgroundIoMetrics::ClassMetrics::~ClassMetrics() = default;
+
+BackgroundIoMetrics::BackgroundIoMetrics(metrics::MetricSet *parent)
+    : metrics::MetricSet("background_io", {}, "Disk bandwidth used by background work (flush, fusion, compaction, merge)", parent),
+      classes(),
+      last_stats()
+{
+    for (size_t i = 0; i < IoScheduler::num_classes; ++i) {
+        classes.push_back(std::make_unique<ClassMetrics>(IoScheduler::name_of(static_cast<IoScheduler::Class>(i)), this));
+    }
+}
+
+BackgroundIoMetrics::~BackgroundIoMetrics() = default;
+
+void
+BackgroundIoMetrics::update(const IoScheduler::Stats &stats)
+{
+    for (size_t i = 0; i < IoScheduler::num_classes; ++i) {
+        const auto &cur = stats[i];
+        const auto &last = last_stats[i];
+        auto &metrics = *classes[i];
+        metrics.bytes.inc(cur.bytes - last.bytes);
+        metrics.throttled.inc(cur.throttled - last.throttled);
+        metrics.wait_time.inc(vespalib::count_ms(cur.wait_time - last.wait_time));
+    }
+    last_stats = stats;
+}
+
+}
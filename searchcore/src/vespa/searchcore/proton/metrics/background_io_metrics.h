@@ -0,0 +1,37 @@
+// Copyright Vespa.ai. Licensed under the terms of the Apache 2.0 license. See LICENSE in the project root.
+
+#pragma once
+
+#include <vespa/metrics/metricset.h>
+#include <vespa/metrics/countmetric.h>
+#include <vespa/vespalib/util/io_scheduler.h>
+#include <memory>
+#include <vector>
+
+namespace proton {
+
+/**
+ * Metrics for the disk bandwidth used by background work, per class
+ * of work in the node-wide vespalib::IoScheduler.
+ */
+struct BackgroundIoMetrics : metrics::MetricSet
+{
+    struct ClassMetrics : metrics::MetricSet {
+        metrics::LongCountMetric bytes;
+        metrics::LongCountMetric throttled;
+        metrics::LongCountMetric wait_time;
+
+        ClassMetrics(const std::string &name, metrics::MetricSet *parent);
+        ~ClassMetrics() override;
+    };
+
+    std::vector<std::unique_ptr<ClassMetrics>> classes;
+    vespalib::IoScheduler::Stats               last_stats;
+
+    explicit BackgroundIoMetrics(metrics::MetricSet *parent);
+    ~BackgroundIoMetrics() override;
+
+    void update(const vespalib::IoScheduler::Stats &stats);
+};
+
+}
@@ -33,7 +33,8 @@ ContentProtonMetrics::ContentProtonMetrics()
       transactionLog(this),
       resourceUsage(this),
       executor(this),
-      sessionCache(this)
+      sessionCache(this),
+      backgroundIo(this)
 {
 }
 
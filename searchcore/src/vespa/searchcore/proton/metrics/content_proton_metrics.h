@@ -2,6 +2,7 @@
 
 #pragma once
 
+#include "background_io_metrics.h"
 #include "executor_metrics.h"
 #include "resource_usage_metrics.h"
 #include "trans_log_server_metrics.h"
@@ -46,6 +47,7 @@ struct ContentProtonMetrics : metrics::MetricSet
     ResourceUsageMetrics resourceUsage;
     ProtonExecutorMetrics executor;
     SessionCacheMetrics sessionCache;
+    BackgroundIoMetrics backgroundIo;
 
     ContentProtonMetrics();
     ~ContentProtonMetrics() override;
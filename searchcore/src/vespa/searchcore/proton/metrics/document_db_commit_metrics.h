@@ -1,6 +1,7 @@
 // Copyright Vespa.ai. Licensed under the terms of the Apache 2.0 license. See LICENSE in the project root.
 #pragma once
 
+#include <vespa/metrics/histogrammetric.h>
 #include <vespa/metrics/metricset.h>
 #include <vespa/metrics/valuemetric.h>
 
@@ -12,7 +13,7 @@ namespace proton {
 struct DocumentDBCommitMetrics : metrics::MetricSet
 {
     metrics::DoubleAverageMetric operations;
-    metrics::DoubleAverageMetric latency;
+    metrics::HistogramMetric     latency;
 
     DocumentDBCommitMetrics(metrics::MetricSet* parent);
     ~DocumentDBCommitMetrics() override;
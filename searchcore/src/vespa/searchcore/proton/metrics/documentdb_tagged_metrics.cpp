@@ -146,13 +146,20 @@ DocumentDBTaggedMetrics::MatchingMetrics::RankProfileMetrics::RankProfileMetrics
       docsReRanked("docs_reranked", {}, "Number of documents re-ranked (second phase)", this),
       queries("queries", {}, "Number of queries executed", this),
       limitedQueries("limited_queries", {}, "Number of queries limited in match phase", this),
+      profiledQueries("profiled_queries", {}, "Number of queries sampled for profiling", this),
+      resultCacheHits("result_cache_hits", {}, "Number of queries served from the result cache", this),
+      memoryRejectedQueries("memory_rejected_queries", {}, "Number of queries rejected by the query memory budget", this),
       softDoomedQueries("soft_doomed_queries", {}, "Number of queries hitting the soft timeout", this),
+      localRanges("local_ranges", {}, "Number of docid ranges taken from the part of the docid space owned by the NUMA node of the match thread", this),
+      stolenRanges("stolen_ranges", {}, "Number of docid ranges stolen from the part of the docid space owned by another NUMA node", this),
       softDoomFactor("soft_doom_factor", {}, "Factor used to compute soft-timeout", this),
       matchTime("match_time", {}, "Average time (sec) for matching a query (1st phase)", this),
       groupingTime("grouping_time", {}, "Average time (sec) spent on grouping", this),
       rerankTime("rerank_time", {}, "Average time (sec) spent on 2nd phase ranking", this),
       querySetupTime("query_setup_time", {}, "Average time (sec) spent setting up and tearing down queries", this),
-      queryLatency("query_latency", {}, "Total average latency (sec) when matching and ranking a query", this)
+      queryLatency("query_latency", {}, "Total average latency (sec) when matching and ranking a query", this),
+      resultCacheSavedTime("result_cache_saved_time", {}, "Average matching time (sec) saved by serving a query from the result cache", this),
+      queryMemory("query_memory", {}, "Average estimated memory (bytes) used when matching a query", this)
 {
     softDoomFactor.set(MatchingStats::INITIAL_SOFT_DOOM_FACTOR);
     for (size_t i = 0; i < numDocIdPartitions; ++i) {
@@ -168,6 +175,8 @@ DocumentDBTaggedMetrics::MatchingMetrics::RankProfileMetrics::DocIdPartition::Do
       docsMatched("docs_matched", {}, "Number of documents matched", this),
       docsRanked("docs_ranked", {}, "Number of documents ranked (first phase)", this),
       docsReRanked("docs_reranked", {}, "Number of documents re-ranked (second phase)", this),
+      localRanges("local_ranges", {}, "Number of docid ranges taken from the part of the docid space owned by the NUMA node of the match thread", this),
+      stolenRanges("stolen_ranges", {}, "Number of docid ranges stolen from the part of the docid space owned by another NUMA node", this),
       activeTime("active_time", {}, "Time (sec) spent doing actual work", this),
       waitTime("wait_time", {}, "Time (sec) spent waiting for other external threads and resources", this)
 { }
@@ -180,6 +189,8 @@ DocumentDBTaggedMetrics::MatchingMetrics::RankProfileMetrics::DocIdPartition::up
     docsMatched.inc(stats.docsMatched());
     docsRanked.inc(stats.docsRanked());
     docsReRanked.inc(stats.docsReRanked());
+    localRanges.inc(stats.localRanges());
+    stolenRanges.inc(stats.stolenRanges());
     activeTime.addValueBatch(stats.active_time_avg(), stats.active_time_count(),
                              stats.active_time_min(), stats.active_time_max());
     waitTime.addValueBatch(stats.wait_time_avg(), stats.wait_time_count(),
@@ -195,7 +206,12 @@ DocumentDBTaggedMetrics::MatchingMetrics::RankProfileMetrics::update(const metri
     docsReRanked.inc(stats.docsReRanked());
     queries.inc(stats.queries());
     limitedQueries.inc(stats.limited_queries());
+    profiledQueries.inc(stats.profiled_queries());
+    resultCacheHits.inc(stats.result_cache_hits());
+    memoryRejectedQueries.inc(stats.memory_rejected_queries());
     softDoomedQueries.inc(stats.softDoomed());
+    localRanges.inc(stats.localRanges());
+    stolenRanges.inc(stats.stolenRanges());
     softDoomFactor.set(stats.softDoomFactor());
     matchTime.addValueBatch(stats.matchTimeAvg(), stats.matchTimeCount(),
                             stats.matchTimeMin(), stats.matchTimeMax());
@@ -207,6 +223,10 @@ DocumentDBTaggedMetrics::MatchingMetrics::RankProfileMetrics::update(const metri
                                       stats.querySetupTimeMin(), stats.querySetupTimeMax());
     queryLatency.addValueBatch(stats.queryLatencyAvg(), stats.queryLatencyCount(),
                                stats.queryLatencyMin(), stats.queryLatencyMax());
+    resultCacheSavedTime.addValueBatch(stats.result_cache_saved_time_avg(), stats.result_cache_saved_time_count(),
+                                       stats.result_cache_saved_time_min(), stats.result_cache_saved_time_max());
+    queryMemory.addValueBatch(stats.query_memory_avg(), stats.query_memory_count(),
+                              stats.query_memory_min(), stats.query_memory_max());
     if (stats.getNumPartitions() > 0) {
         for (size_t i = partitions.size(); i < stats.getNumPartitions(); ++i) {
             // This loop is to handle live reconfigs that changes how many partitions(number of threads) might be used per query.
@@ -124,6 +124,8 @@ struct DocumentDBTaggedMetrics : metrics::MetricSet
                 metrics::LongCountMetric docsMatched;
                 metrics::LongCountMetric docsRanked;
                 metrics::LongCountMetric docsReRanked;
+                metrics::LongCountMetric localRanges;
+                metrics::LongCountMetric stolenRanges;
                 metrics::DoubleAverageMetric activeTime;
                 metrics::DoubleAverageMetric waitTime;
 
@@ -140,13 +142,20 @@ struct DocumentDBTaggedMetrics : metrics::MetricSet
             metrics::LongCountMetric     docsReRanked;
             metrics::LongCountMetric     queries;
             metrics::LongCountMetric     limitedQueries;
+            metrics::LongCountMetric     profiledQueries;
+            metrics::LongCountMetric     resultCacheHits;
+            metrics::LongCountMetric     memoryRejectedQueries;
             metrics::LongCountMetric     softDoomedQueries;
+            metrics::LongCountMetric     localRanges;
+            metrics::LongCountMetric     stolenRanges;
             metrics::DoubleValueMetric   softDoomFactor;
             metrics::DoubleAverageMetric matchTime;
             metrics::DoubleAverageMetric groupingTime;
             metrics::DoubleAverageMetric rerankTime;
             metrics::DoubleAverageMetric querySetupTime;
             metrics::DoubleAverageMetric queryLatency;
+            metrics::DoubleAverageMetric resultCacheSavedTime;
+            metrics::DoubleAverageMetric queryMemory;
             DocIdPartitions              partitions;
 
             RankProfileMetrics(const vespalib::string &name,
@@ -14,6 +14,14 @@ ExecutorMetrics::update(const vespalib::ExecutorStats &stats)
     saturation.set(stats.get_saturation());
     const auto & qSize = stats.queueSize;
     queueSize.addValueBatch(qSize.average(), qSize.count(), qSize.min(), qSize.max());
+    const auto & hw = stats.hwCounters;
+    if (hw.cycles > 0) {
+        cycles.inc(hw.cycles);
+        instructions.inc(hw.instructions);
+        llcMisses.inc(hw.llc_misses);
+        branchMisses.inc(hw.branch_misses);
+        ipc.set(hw.ipc());
+    }
 }
 
 ExecutorMetrics::ExecutorMetrics(const std::string &name, metrics::MetricSet *parent)
@@ -25,7 +33,12 @@ ExecutorMetrics::ExecutorMetrics(const std::string &name, metrics::MetricSet *pa
       saturation("saturation", {}, "Ratio indicating how saturated the worker threads has been. "
                                    "For most executors this ratio is equal to utilization, but for others (e.g SequencedTaskExecutor) "
                                    " a higher saturation than utilization indicates a bottleneck in a subset of the worker threads.", this),
-      queueSize("queuesize", {}, "Size of task queue", this)
+      queueSize("queuesize", {}, "Size of task queue", this),
+      cycles("cycles", {}, "Number of cpu cycles spent by the worker threads (when hardware counters are enabled)", this),
+      instructions("instructions", {}, "Number of instructions retired by the worker threads (when hardware counters are enabled)", this),
+      llcMisses("llc_misses", {}, "Number of last level cache misses in the worker threads (when hardware counters are enabled)", this),
+      branchMisses("branch_misses", {}, "Number of branch mispredictions in the worker threads (when hardware counters are enabled)", this),
+      ipc("ipc", {}, "Instructions per cycle for the worker threads (when hardware counters are enabled)", this)
 {
 }
 
@@ -17,6 +17,11 @@ struct ExecutorMetrics : metrics::MetricSet
     metrics::DoubleValueMetric util;
     metrics::DoubleValueMetric saturation;
     metrics::LongAverageMetric queueSize;
+    metrics::LongCountMetric   cycles;
+    metrics::LongCountMetric   instructions;
+    metrics::LongCountMetric   llcMisses;
+    metrics::LongCountMetric   branchMisses;
+    metrics::DoubleValueMetric ipc;
 
     void update(const vespalib::ExecutorStats &stats);
     ExecutorMetrics(const std::string &name, metrics::MetricSet *parent);
@@ -23,6 +23,12 @@ CommitAndWaitDocumentRetriever::getBucketMetaData(const Bucket &bucket, search::
     return _retriever->getBucketMetaData(bucket, result);
 }
 
+void
+CommitAndWaitDocumentRetriever::getBucketMetaDataInRange(const Bucket &bucket, uint64_t fromTimestamp, uint64_t toTimestamp,
+                                                         search::DocumentMetaData::Vector &result) const {
+    _retriever->getBucketMetaDataInRange(bucket, fromTimestamp, toTimestamp, result);
+}
+
 search::DocumentMetaData
 CommitAndWaitDocumentRetriever::getDocumentMetaData(const document::DocumentId &id) const {
     return _retriever->getDocumentMetaData(id);
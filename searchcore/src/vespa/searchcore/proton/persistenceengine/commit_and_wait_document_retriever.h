@@ -23,10 +23,13 @@ public:
 
     const document::DocumentTypeRepo &getDocumentTypeRepo() const override;
     void getBucketMetaData(const Bucket &bucket, search::DocumentMetaData::Vector &result) const override;
+    void getBucketMetaDataInRange(const Bucket &bucket, uint64_t fromTimestamp, uint64_t toTimestamp,
+                                  search::DocumentMetaData::Vector &result) const override;
     search::DocumentMetaData getDocumentMetaData(const document::DocumentId &id) const override;
     DocumentUP getFullDocument(search::DocumentIdT lid) const override;
     DocumentUP getPartialDocument(search::DocumentIdT lid, const document::DocumentId & docId, const document::FieldSet & fieldSet) const override;
     void visitDocuments(const LidVector &lids, search::IDocumentVisitor &visitor, ReadConsistency readConsistency) const override;
+    void sortLidsInStorageOrder(LidVector &lids) const override { _retriever->sortLidsInStorageOrder(lids); }
     CachedSelect::SP parseSelect(const vespalib::string &selection) const override;
     ReadGuard getReadGuard() const override;
     uint32_t getDocIdLimit() const override;
@@ -28,6 +28,11 @@ namespace proton {
 
 namespace {
 
+using LidIndexMap = vespalib::hash_map<uint32_t, uint32_t>;
+
+// Number of lids read from the document store at a time when streaming documents.
+constexpr size_t STREAM_SLICE_LIDS = 256;
+
 std::unique_ptr<DocEntry>
 createDocEntry(Timestamp timestamp, bool removed) {
     return DocEntry::create(timestamp, removed ? DocumentMetaEnum::REMOVE_ENTRY : DocumentMetaEnum::NONE);
@@ -54,6 +59,19 @@ createDocEntry(Timestamp timestamp, bool removed, Document::UP doc, ssize_t defa
 
 } // namespace proton::<unnamed>
 
+struct DocumentIterator::PendingSource {
+    const IDocumentRetriever         * source;
+    search::DocumentMetaData::Vector   metaData;
+    LidIndexMap                        lidIndexMap;
+    IDocumentRetriever::LidVector      lids;
+    size_t                             nextLid;
+
+    explicit PendingSource(const IDocumentRetriever & source_in)
+        : source(&source_in), metaData(), lidIndexMap(), lids(), nextLid(0)
+    { }
+    bool done() const noexcept { return nextLid >= lids.size(); }
+};
+
 bool
 DocumentIterator::checkMeta(const search::DocumentMetaData &meta) const
 {
@@ -76,13 +94,26 @@ DocumentIterator::checkMeta(const search::DocumentMetaData &meta) const
     return true;
 }
 
+void
+DocumentIterator::getBucketMetaData(const IDocumentRetriever & source, search::DocumentMetaData::Vector & metaData) const
+{
+    // Narrow the meta data lookup to the selected timestamps, checkMeta() still does the exact filtering
+    const auto & subset = _selection.getTimestampSubset();
+    if (!subset.empty()) {
+        source.getBucketMetaDataInRange(_bucket, subset.front(), subset.back(), metaData);
+    } else {
+        source.getBucketMetaDataInRange(_bucket, _selection.getFromTimestamp(), _selection.getToTimestamp(), metaData);
+    }
+}
+
 DocumentIterator::DocumentIterator(const storage::spi::Bucket &bucket,
                                    document::FieldSet::SP fields,
                                    const storage::spi::Selection &selection,
                                    storage::spi::IncludedVersions versions,
                                    ssize_t defaultSerializedSize,
                                    bool ignoreMaxBytes,
-                                   ReadConsistency readConsistency)
+                                   ReadConsistency readConsistency,
+                                   bool streamDocuments)
     : _bucket(bucket),
       _selection(selection),
       _versions(versions),
@@ -91,10 +122,13 @@ DocumentIterator::DocumentIterator(const storage::spi::Bucket &bucket,
       _readConsistency(readConsistency),
       _metaOnly(_fields->getType() == document::FieldSet::Type::NONE),
       _ignoreMaxBytes((readConsistency == ReadConsistency::WEAK) && ignoreMaxBytes),
+      _streamDocuments(streamDocuments && !_metaOnly && !_ignoreMaxBytes),
       _fetchedData(false),
       _sources(),
       _nextItem(0),
-      _list()
+      _list(),
+      _pending(),
+      _nextPending(0)
 {
 }
 
@@ -115,6 +149,9 @@ DocumentIterator::add(IDocumentRetriever::SP retriever)
 IterateResult
 DocumentIterator::iterate(size_t maxBytes)
 {
+    if (_streamDocuments) {
+        return iterateStreamed(maxBytes);
+    }
     if ( ! _fetchedData ) {
         for (const auto & source : _sources) {
             fetchCompleteSource(source.first, *source.second, _list);
@@ -205,8 +242,6 @@ private:
     std::unique_ptr<SelectContext> _selectCxt;
 };
 
-using LidIndexMap = vespalib::hash_map<uint32_t, uint32_t>;
-
 class MatchVisitor : public search::IDocumentVisitor
 {
 public:
@@ -219,12 +254,18 @@ public:
         _fields(fields),
         _list(list),
         _defaultSerializedSize(defaultSerializedSize),
-        _allowVisitCaching(false)
+        _allowVisitCaching(false),
+        _requireSameGid(false)
     { }
     MatchVisitor & allowVisitCaching(bool allow) { _allowVisitCaching = allow; return *this; }
+    // The lid may have been reused for another document since its meta data was fetched.
+    MatchVisitor & requireSameGid(bool require) { _requireSameGid = require; return *this; }
     void visit(uint32_t lid, document::Document::UP doc) override {
         const search::DocumentMetaData & meta = _metaData[_lidIndexMap[lid]];
         assert(lid == meta.lid);
+        if (_requireSameGid && doc && (doc->getId().getGlobalId() != meta.gid)) {
+            return;
+        }
         if (_matcher.match(meta, doc.get())) {
             if (doc && _fields) {
                 document::FieldSet::stripFields(*doc, *_fields);
@@ -245,6 +286,7 @@ private:
     IterateResult::List                    & _list;
     size_t                                   _defaultSerializedSize;
     bool                                     _allowVisitCaching;
+    bool                                     _requireSameGid;
 };
 
 }
@@ -256,7 +298,7 @@ DocumentIterator::fetchCompleteSource(const DocTypeName & doc_type_name,
 {
     IDocumentRetriever::ReadGuard sourceReadGuard(source.getReadGuard());
     search::DocumentMetaData::Vector metaData;
-    source.getBucketMetaData(_bucket, metaData);
+    getBucketMetaData(source, metaData);
     if (metaData.empty()) {
         return;
     }
@@ -296,4 +338,78 @@ DocumentIterator::fetchCompleteSource(const DocTypeName & doc_type_name,
 
 }
 
+void
+DocumentIterator::prepareStreamedSource(const IDocumentRetriever & source)
+{
+    IDocumentRetriever::ReadGuard sourceReadGuard(source.getReadGuard());
+    PendingSource pending(source);
+    getBucketMetaData(source, pending.metaData);
+    if (pending.metaData.empty()) {
+        return;
+    }
+    Matcher matcher(source, _metaOnly, _selection.getDocumentSelection().getDocumentSelection());
+    if (matcher.willAlwaysFail()) {
+        return;
+    }
+    pending.lidIndexMap.resize(3*pending.metaData.size());
+    pending.lids.reserve(pending.metaData.size());
+    for (size_t i(0); i < pending.metaData.size(); i++) {
+        const search::DocumentMetaData & meta = pending.metaData[i];
+        if (checkMeta(meta) && matcher.match(meta)) {
+            pending.lids.emplace_back(meta.lid);
+            pending.lidIndexMap[meta.lid] = i;
+        }
+    }
+    if (pending.lids.empty()) {
+        return;
+    }
+    source.sortLidsInStorageOrder(pending.lids);
+    LOG(debug, "streaming %zu of %zu documents in storage order", pending.lids.size(), pending.metaData.size());
+    _pending.push_back(std::move(pending));
+}
+
+void
+DocumentIterator::streamFromSource(PendingSource & pending, size_t maxBytes, IterateResult::List & list, size_t & listBytes)
+{
+    const IDocumentRetriever & source = *pending.source;
+    IDocumentRetriever::ReadGuard sourceReadGuard(source.getReadGuard());
+    Matcher matcher(source, _metaOnly, _selection.getDocumentSelection().getDocumentSelection());
+    MatchVisitor visitor(matcher, pending.metaData, pending.lidIndexMap, _fields.get(), list, _defaultSerializedSize);
+    // Slices are not revisited, so they would only push hot documents out of the visit cache.
+    visitor.allowVisitCaching(false).requireSameGid(true);
+    IDocumentRetriever::LidVector slice;
+    while ( ! pending.done() && ((listBytes < maxBytes) || list.empty())) {
+        size_t count = std::min(STREAM_SLICE_LIDS, pending.lids.size() - pending.nextLid);
+        slice.assign(pending.lids.begin() + pending.nextLid, pending.lids.begin() + pending.nextLid + count);
+        pending.nextLid += count;
+        size_t first = list.size();
+        source.visitDocuments(slice, visitor, _readConsistency);
+        for (size_t i(first); i < list.size(); i++) {
+            listBytes += list[i]->getSize();
+        }
+    }
+}
+
+IterateResult
+DocumentIterator::iterateStreamed(size_t maxBytes)
+{
+    if ( ! _fetchedData ) {
+        for (const auto & source : _sources) {
+            prepareStreamedSource(*source.second);
+        }
+        _fetchedData = true;
+    }
+    IterateResult::List results;
+    size_t listBytes(0);
+    while ((_nextPending < _pending.size()) && ((listBytes < maxBytes) || results.empty())) {
+        PendingSource & pending = _pending[_nextPending];
+        streamFromSource(pending, maxBytes, results, listBytes);
+        if (pending.done()) {
+            pending = PendingSource(*pending.source);
+            _nextPending++;
+        }
+    }
+    return IterateResult(std::move(results), _nextPending >= _pending.size());
+}
+
 }
@@ -20,6 +20,7 @@ class DocumentIterator
 private:
     using ReadConsistency = storage::spi::ReadConsistency;
     using DocTypeNameAndRetriever = std::pair<DocTypeName, IDocumentRetriever::SP>;
+    struct PendingSource;
 
     const storage::spi::Bucket            _bucket;;
     const storage::spi::Selection         _selection;
@@ -29,23 +30,38 @@ private:
     const ReadConsistency                 _readConsistency;
     const bool                            _metaOnly;
     const bool                            _ignoreMaxBytes;
+    const bool                            _streamDocuments;
     bool                                  _fetchedData;
     std::vector<DocTypeNameAndRetriever>  _sources;
     size_t                                _nextItem;
     storage::spi::IterateResult::List     _list;
+    std::vector<PendingSource>            _pending;
+    size_t                                _nextPending;
 
 
     [[nodiscard]] bool checkMeta(const search::DocumentMetaData &meta) const;
+    void getBucketMetaData(const IDocumentRetriever & source, search::DocumentMetaData::Vector & metaData) const;
     void fetchCompleteSource(const DocTypeName & doc_type_name,
                              const IDocumentRetriever & source,
                              storage::spi::IterateResult::List & list);
+    void prepareStreamedSource(const IDocumentRetriever & source);
+    void streamFromSource(PendingSource & pending, size_t maxBytes,
+                          storage::spi::IterateResult::List & list, size_t & listBytes);
+    storage::spi::IterateResult iterateStreamed(size_t maxBytes);
     [[nodiscard]] bool isWeakRead() const { return _readConsistency == ReadConsistency::WEAK; }
 
 public:
+    /**
+     * With streamDocuments the documents are not all read up front. The matching lids of each
+     * source are instead ordered as laid out in the document store and read in slices for each
+     * call to iterate(), until maxBytes is reached. This keeps memory bounded for large buckets
+     * and gives close to sequential reads when exporting or reindexing all documents.
+     * It does not apply to meta data only iteration or when maxBytes is ignored.
+     */
     DocumentIterator(const storage::spi::Bucket &bucket, document::FieldSet::SP fields,
                      const storage::spi::Selection &selection, storage::spi::IncludedVersions versions,
                      ssize_t defaultSerializedSize, bool ignoreMaxBytes,
-                     ReadConsistency readConsistency=ReadConsistency::STRONG);
+                     ReadConsistency readConsistency=ReadConsistency::STRONG, bool streamDocuments=false);
     ~DocumentIterator();
     void add(const DocTypeName & doc_type_name, IDocumentRetriever::SP retriever);
     void add(IDocumentRetriever::SP retriever);
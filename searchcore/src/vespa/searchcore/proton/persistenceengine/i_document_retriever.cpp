@@ -21,6 +21,19 @@ IDocumentRetriever::getPartialDocument(search::DocumentIdT lid, const document::
     return doc;
 }
 
+void
+IDocumentRetriever::getBucketMetaDataInRange(const storage::spi::Bucket &bucket, uint64_t fromTimestamp, uint64_t toTimestamp,
+                                             search::DocumentMetaData::Vector &result) const
+{
+    search::DocumentMetaData::Vector all;
+    getBucketMetaData(bucket, all);
+    for (const auto &meta : all) {
+        if (meta.timestamp >= fromTimestamp && meta.timestamp <= toTimestamp) {
+            result.push_back(meta);
+        }
+    }
+}
+
 void
 DocumentRetrieverBaseForTest::visitDocuments(const LidVector &lids, search::IDocumentVisitor &visitor, ReadConsistency readConsistency) const {
     (void) readConsistency;
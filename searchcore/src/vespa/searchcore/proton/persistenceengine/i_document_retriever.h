@@ -34,6 +34,12 @@ public:
 
     virtual const document::DocumentTypeRepo & getDocumentTypeRepo() const = 0;
     virtual void getBucketMetaData(const storage::spi::Bucket &bucket, search::DocumentMetaData::Vector &result) const = 0;
+    /**
+     * Gets meta data for documents in the bucket with timestamp in [fromTimestamp, toTimestamp].
+     * The default filters the result of getBucketMetaData().
+     */
+    virtual void getBucketMetaDataInRange(const storage::spi::Bucket &bucket, uint64_t fromTimestamp, uint64_t toTimestamp,
+                                          search::DocumentMetaData::Vector &result) const;
     virtual search::DocumentMetaData getDocumentMetaData(const document::DocumentId &id) const = 0;
     /**
      * Extracts the full document based on the LID
@@ -52,6 +58,12 @@ public:
      * @param Visitor to receive callback for each document found.
      */
     virtual void visitDocuments(const LidVector &lids, search::IDocumentVisitor &visitor, ReadConsistency readConsistency) const = 0;
+    /**
+     * Reorder the lids in the order the documents are stored, so that visiting them
+     * in consecutive slices reads the document store mostly sequentially.
+     * The default keeps the given order.
+     */
+    virtual void sortLidsInStorageOrder(LidVector &) const { }
 
     virtual CachedSelect::SP parseSelect(const vespalib::string &selection) const = 0;
 
@@ -4,6 +4,7 @@
 #include "i_document_retriever.h"
 #include "resulthandler.h"
 #include <vespa/searchcore/proton/common/feedtoken.h>
+#include <vespa/persistence/spi/batched_operation.h>
 
 namespace document {
     class Document;
@@ -30,6 +31,17 @@ public:
     using SP = std::shared_ptr<IPersistenceHandler>;
     // Note that you can not move away the handlers in the vector.
     using RetrieversSP = std::shared_ptr<std::vector<IDocumentRetriever::SP> >;
+    /**
+     * A put, update or remove in a batch given to handleFeedBatch(). The
+     * completion callback of the operation has been moved into the token.
+     */
+    struct FeedBatchEntry {
+        FeedToken                      token;
+        storage::spi::BatchedOperation op;
+        FeedBatchEntry(FeedToken token_, storage::spi::BatchedOperation op_) noexcept
+            : token(std::move(token_)), op(std::move(op_))
+        {}
+    };
     IPersistenceHandler(const IPersistenceHandler &) = delete;
     IPersistenceHandler & operator = (const IPersistenceHandler &) = delete;
 
@@ -52,6 +64,10 @@ public:
     virtual void handleRemoveByGid(FeedToken token, const storage::spi::Bucket &bucket,
                                    storage::spi::Timestamp timestamp,
                                    vespalib::stringref doc_type, const document::GlobalId& gid) = 0;
+    /**
+     * Handles puts, updates and removes for documents in the same bucket, in order.
+     */
+    virtual void handleFeedBatch(const storage::spi::Bucket &bucket, std::vector<FeedBatchEntry> entries) = 0;
 
     virtual void handleListBuckets(IBucketIdListResultHandler &resultHandler) = 0;
     virtual void handleSetClusterState(const storage::spi::ClusterState &calc, IGenericResultHandler &resultHandler) = 0;
@@ -11,6 +11,7 @@
 #include <vespa/document/update/documentupdate.h>
 #include <vespa/document/util/feed_reject_helper.h>
 #include <vespa/document/base/exceptions.h>
+#include <algorithm>
 #include <thread>
 
 #include <vespa/log/log.h>
@@ -18,6 +19,7 @@ LOG_SETUP(".proton.persistenceengine.persistenceengine");
 
 using document::Document;
 using document::DocumentId;
+using storage::spi::BatchedOperation;
 using storage::spi::BucketChecksum;
 using storage::spi::BucketExecutor;
 using storage::spi::BucketTask;
@@ -217,10 +219,11 @@ PersistenceEngine::getHandlerSnapshot(const WriteGuard &, document::BucketSpace
 }
 
 PersistenceEngine::PersistenceEngine(IPersistenceEngineOwner &owner, const IResourceWriteFilter &writeFilter, IDiskMemUsageNotifier& disk_mem_usage_notifier,
-                                     ssize_t defaultSerializedSize, bool ignoreMaxBytes)
+                                     ssize_t defaultSerializedSize, bool ignoreMaxBytes, bool streamDocuments)
     : AbstractPersistenceProvider(),
       _defaultSerializedSize(defaultSerializedSize),
       _ignoreMaxBytes(ignoreMaxBytes),
+      _streamDocuments(streamDocuments),
       _handlers(),
       _lock(),
       _iterators(),
@@ -347,28 +350,42 @@ PersistenceEngine::getBucketInfo(const Bucket& b) const
 }
 
 
-void
-PersistenceEngine::putAsync(const Bucket &bucket, Timestamp ts, storage::spi::DocumentSP doc, OperationComplete::UP onComplete)
+IPersistenceHandler *
+PersistenceEngine::put_handler(const ReadGuard & guard, const Bucket &bucket, Timestamp ts, const Document &doc,
+                               OperationComplete &onComplete) const
 {
     if (!_writeFilter.acceptWriteOperation()) {
         IResourceWriteFilter::State state = _writeFilter.getAcceptState();
         if (!state.acceptWriteOperation()) {
-            return onComplete->onComplete(std::make_unique<Result>(Result::ErrorType::RESOURCE_EXHAUSTED,
-                    fmt("Put operation rejected for document '%s': '%s'", doc->getId().toString().c_str(), state.message().c_str())));
+            onComplete.onComplete(std::make_unique<Result>(Result::ErrorType::RESOURCE_EXHAUSTED,
+                    fmt("Put operation rejected for document '%s': '%s'", doc.getId().toString().c_str(), state.message().c_str())));
+            return nullptr;
         }
     }
-    ReadGuard rguard(_rwMutex);
-    DocTypeName docType(doc->getType());
+    DocTypeName docType(doc.getType());
     LOG(spam, "putAsync(%s, %" PRIu64 ", (\"%s\", \"%s\"))", bucket.toString().c_str(), static_cast<uint64_t>(ts.getValue()),
-        docType.toString().c_str(), doc->getId().toString().c_str());
-    if (!doc->getId().hasDocType()) {
-        return onComplete->onComplete(std::make_unique<Result>(Result::ErrorType::PERMANENT_ERROR,
-                    fmt("Old id scheme not supported in elastic mode (%s)", doc->getId().toString().c_str())));
+        docType.toString().c_str(), doc.getId().toString().c_str());
+    if (!doc.getId().hasDocType()) {
+        onComplete.onComplete(std::make_unique<Result>(Result::ErrorType::PERMANENT_ERROR,
+                    fmt("Old id scheme not supported in elastic mode (%s)", doc.getId().toString().c_str())));
+        return nullptr;
     }
-    IPersistenceHandler * handler = getHandler(rguard, bucket.getBucketSpace(), docType);
+    IPersistenceHandler * handler = getHandler(guard, bucket.getBucketSpace(), docType);
     if (!handler) {
-        return onComplete->onComplete(std::make_unique<Result>(Result::ErrorType::PERMANENT_ERROR,
+        onComplete.onComplete(std::make_unique<Result>(Result::ErrorType::PERMANENT_ERROR,
                     fmt("No handler for document type '%s'", docType.toString().c_str())));
+        return nullptr;
+    }
+    return handler;
+}
+
+void
+PersistenceEngine::putAsync(const Bucket &bucket, Timestamp ts, storage::spi::DocumentSP doc, OperationComplete::UP onComplete)
+{
+    ReadGuard rguard(_rwMutex);
+    IPersistenceHandler * handler = put_handler(rguard, bucket, ts, *doc, *onComplete);
+    if (!handler) {
+        return;
     }
     auto transportContext = std::make_shared<AsyncTransportContext>(1, std::move(onComplete));
     handler->handlePut(feedtoken::make(std::move(transportContext)), bucket, ts, std::move(doc));
@@ -412,21 +429,34 @@ PersistenceEngine::removeAsyncMulti(const Bucket& b, std::vector<storage::spi::I
     }
 }
 
-void
-PersistenceEngine::removeAsyncSingle(const Bucket& b, Timestamp t, const DocumentId& id, OperationComplete::UP onComplete)
+IPersistenceHandler *
+PersistenceEngine::remove_handler(const ReadGuard & guard, const Bucket &b, Timestamp t, const DocumentId &id,
+                                  OperationComplete &onComplete) const
 {
-    ReadGuard rguard(_rwMutex);
     LOG(spam, "remove(%s, %" PRIu64 ", \"%s\")", b.toString().c_str(),
         static_cast<uint64_t>(t.getValue()), id.toString().c_str());
     if (!id.hasDocType()) {
-        return onComplete->onComplete(std::make_unique<RemoveResult>(Result::ErrorType::PERMANENT_ERROR,
+        onComplete.onComplete(std::make_unique<RemoveResult>(Result::ErrorType::PERMANENT_ERROR,
                     fmt("Old id scheme not supported in elastic mode (%s)", id.toString().c_str())));
+        return nullptr;
     }
     DocTypeName docType(id.getDocType());
-    IPersistenceHandler * handler = getHandler(rguard, b.getBucketSpace(), docType);
+    IPersistenceHandler * handler = getHandler(guard, b.getBucketSpace(), docType);
     if (!handler) {
-        return onComplete->onComplete(std::make_unique<RemoveResult>(Result::ErrorType::PERMANENT_ERROR,
+        onComplete.onComplete(std::make_unique<RemoveResult>(Result::ErrorType::PERMANENT_ERROR,
                     fmt("No handler for document type '%s'", docType.toString().c_str())));
+        return nullptr;
+    }
+    return handler;
+}
+
+void
+PersistenceEngine::removeAsyncSingle(const Bucket& b, Timestamp t, const DocumentId& id, OperationComplete::UP onComplete)
+{
+    ReadGuard rguard(_rwMutex);
+    IPersistenceHandler * handler = remove_handler(rguard, b, t, id, *onComplete);
+    if (!handler) {
+        return;
     }
     auto transportContext = std::make_shared<AsyncTransportContext>(1, std::move(onComplete));
     handler->handleRemove(feedtoken::make(std::move(transportContext)), b, t, id);
@@ -453,55 +483,105 @@ PersistenceEngine::removeByGidAsync(const Bucket& b, std::vector<storage::spi::D
     }
 }
 
-void
-PersistenceEngine::updateAsync(const Bucket& b, Timestamp t, DocumentUpdate::SP upd, OperationComplete::UP onComplete)
+IPersistenceHandler *
+PersistenceEngine::update_handler(const ReadGuard & guard, const Bucket &b, Timestamp t, DocumentUpdate &upd,
+                                  OperationComplete &onComplete) const
 {
     if (!_writeFilter.acceptWriteOperation()) {
         IResourceWriteFilter::State state = _writeFilter.getAcceptState();
-        if (!state.acceptWriteOperation() && document::FeedRejectHelper::mustReject(*upd)) {
-            return onComplete->onComplete(std::make_unique<UpdateResult>(Result::ErrorType::RESOURCE_EXHAUSTED,
-                    fmt("Update operation rejected for document '%s': '%s'", upd->getId().toString().c_str(), state.message().c_str())));
+        if (!state.acceptWriteOperation() && document::FeedRejectHelper::mustReject(upd)) {
+            onComplete.onComplete(std::make_unique<UpdateResult>(Result::ErrorType::RESOURCE_EXHAUSTED,
+                    fmt("Update operation rejected for document '%s': '%s'", upd.getId().toString().c_str(), state.message().c_str())));
+            return nullptr;
         }
     }
     try {
-        upd->eagerDeserialize();
+        upd.eagerDeserialize();
     } catch (document::FieldNotFoundException & e) {
-        return onComplete->onComplete(std::make_unique<UpdateResult>(Result::ErrorType::TRANSIENT_ERROR,
+        onComplete.onComplete(std::make_unique<UpdateResult>(Result::ErrorType::TRANSIENT_ERROR,
                     fmt("Update operation rejected for document '%s' of type '%s': 'Field not found'",
-                        upd->getId().toString().c_str(), upd->getType().getName().c_str())));
+                        upd.getId().toString().c_str(), upd.getType().getName().c_str())));
+        return nullptr;
     } catch (document::DocumentTypeNotFoundException & e) {
-        return onComplete->onComplete(std::make_unique<UpdateResult>(Result::ErrorType::TRANSIENT_ERROR,
+        onComplete.onComplete(std::make_unique<UpdateResult>(Result::ErrorType::TRANSIENT_ERROR,
                     fmt("Update operation rejected for document '%s' of type '%s'.",
-                        upd->getId().toString().c_str(), e.getDocumentTypeName().c_str())));
-
+                        upd.getId().toString().c_str(), e.getDocumentTypeName().c_str())));
+        return nullptr;
     } catch (document::WrongTensorTypeException &e) {
-        return onComplete->onComplete(std::make_unique<UpdateResult>(Result::ErrorType::TRANSIENT_ERROR,
+        onComplete.onComplete(std::make_unique<UpdateResult>(Result::ErrorType::TRANSIENT_ERROR,
                     fmt("Update operation rejected for document '%s' of type '%s': 'Wrong tensor type: %s'",
-                        upd->getId().toString().c_str(), upd->getType().getName().c_str(), e.getMessage().c_str())));
+                        upd.getId().toString().c_str(), upd.getType().getName().c_str(), e.getMessage().c_str())));
+        return nullptr;
     }
-    ReadGuard rguard(_rwMutex);
-    DocTypeName docType(upd->getType());
+    DocTypeName docType(upd.getType());
     LOG(spam, "update(%s, %" PRIu64 ", (\"%s\", \"%s\"), createIfNonExistent='%s')",
         b.toString().c_str(), static_cast<uint64_t>(t.getValue()), docType.toString().c_str(),
-        upd->getId().toString().c_str(), (upd->getCreateIfNonExistent() ? "true" : "false"));
-    if (!upd->getId().hasDocType()) {
-        return onComplete->onComplete(std::make_unique<UpdateResult>(Result::ErrorType::PERMANENT_ERROR,
-                    fmt("Old id scheme not supported in elastic mode (%s)", upd->getId().toString().c_str())));
-    }
-    if (upd->getId().getDocType() != docType.getName()) {
-        return onComplete->onComplete(std::make_unique<UpdateResult>(Result::ErrorType::PERMANENT_ERROR,
-                    fmt("Update operation rejected due to bad id (%s, %s)", upd->getId().toString().c_str(), docType.getName().c_str())));
+        upd.getId().toString().c_str(), (upd.getCreateIfNonExistent() ? "true" : "false"));
+    if (!upd.getId().hasDocType()) {
+        onComplete.onComplete(std::make_unique<UpdateResult>(Result::ErrorType::PERMANENT_ERROR,
+                    fmt("Old id scheme not supported in elastic mode (%s)", upd.getId().toString().c_str())));
+        return nullptr;
+    }
+    if (upd.getId().getDocType() != docType.getName()) {
+        onComplete.onComplete(std::make_unique<UpdateResult>(Result::ErrorType::PERMANENT_ERROR,
+                    fmt("Update operation rejected due to bad id (%s, %s)", upd.getId().toString().c_str(), docType.getName().c_str())));
+        return nullptr;
+    }
+    IPersistenceHandler * handler = getHandler(guard, b.getBucketSpace(), docType);
+    if (handler == nullptr) {
+        onComplete.onComplete(std::make_unique<UpdateResult>(Result::ErrorType::PERMANENT_ERROR,
+                    fmt("No handler for document type '%s'", docType.toString().c_str())));
+        return nullptr;
     }
-    IPersistenceHandler * handler = getHandler(rguard, b.getBucketSpace(), docType);
+    return handler;
+}
 
+void
+PersistenceEngine::updateAsync(const Bucket& b, Timestamp t, DocumentUpdate::SP upd, OperationComplete::UP onComplete)
+{
+    ReadGuard rguard(_rwMutex);
+    IPersistenceHandler * handler = update_handler(rguard, b, t, *upd, *onComplete);
     if (handler == nullptr) {
-        return onComplete->onComplete(std::make_unique<UpdateResult>(Result::ErrorType::PERMANENT_ERROR,
-                    fmt("No handler for document type '%s'", docType.toString().c_str())));
+        return;
     }
     auto transportContext = std::make_shared<AsyncTransportContext>(1, std::move(onComplete));
     handler->handleUpdate(feedtoken::make(std::move(transportContext)), b, t, std::move(upd));
 }
 
+void
+PersistenceEngine::feedBatchAsync(const Bucket& b, std::vector<BatchedOperation> ops)
+{
+    ReadGuard rguard(_rwMutex);
+    // Operations are grouped per handler (document type), keeping their order within each group.
+    std::vector<std::pair<IPersistenceHandler *, std::vector<IPersistenceHandler::FeedBatchEntry>>> batches;
+    for (auto& op : ops) {
+        IPersistenceHandler * handler = nullptr;
+        switch (op.type) {
+        case BatchedOperation::Type::PUT:
+            handler = put_handler(rguard, b, op.timestamp, *op.document, *op.onComplete);
+            break;
+        case BatchedOperation::Type::UPDATE:
+            handler = update_handler(rguard, b, op.timestamp, *op.update, *op.onComplete);
+            break;
+        case BatchedOperation::Type::REMOVE_IF_FOUND:
+            handler = remove_handler(rguard, b, op.timestamp, op.id, *op.onComplete);
+            break;
+        }
+        if (handler == nullptr) {
+            continue;
+        }
+        auto batch = std::find_if(batches.begin(), batches.end(), [handler](const auto& elem) { return elem.first == handler; });
+        if (batch == batches.end()) {
+            batch = batches.emplace(batches.end(), handler, std::vector<IPersistenceHandler::FeedBatchEntry>());
+        }
+        auto transportContext = std::make_shared<AsyncTransportContext>(1, std::move(op.onComplete));
+        batch->second.emplace_back(feedtoken::make(std::move(transportContext)), std::move(op));
+    }
+    for (auto& [handler, entries] : batches) {
+        handler->handleFeedBatch(b, std::move(entries));
+    }
+}
+
 
 PersistenceEngine::GetResult
 PersistenceEngine::get(const Bucket& b, const document::FieldSet& fields, const DocumentId& did, Context& context) const
@@ -542,7 +622,7 @@ PersistenceEngine::createIterator(const Bucket &bucket, FieldSetSP fields, const
     auto snap = getSafeHandlerSnapshot(rguard, bucket.getBucketSpace());
 
     auto entry = std::make_unique<IteratorEntry>(context.getReadConsistency(), bucket, std::move(fields), selection,
-                                                 versions, _defaultSerializedSize, _ignoreMaxBytes);
+                                                 versions, _defaultSerializedSize, _ignoreMaxBytes, _streamDocuments);
     for (; snap.handlers().valid(); snap.handlers().next()) {
         auto *handler = snap.handlers().get();
         IPersistenceHandler::RetrieversSP retrievers = handler->getDocumentRetrievers(context.getReadConsistency());
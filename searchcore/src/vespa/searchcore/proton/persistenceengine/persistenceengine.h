@@ -43,15 +43,17 @@ private:
     using OperationComplete = storage::spi::OperationComplete;
     using BucketExecutor = storage::spi::BucketExecutor;
     using BucketTask = storage::spi::BucketTask;
+    using BatchedOperation = storage::spi::BatchedOperation;
 
     struct IteratorEntry {
         PersistenceHandlerSequence  handler_sequence;
         DocumentIterator it;
         bool in_use;
         IteratorEntry(storage::spi::ReadConsistency readConsistency, const Bucket &b, FieldSetSP f,
-                      const Selection &s, IncludedVersions v, ssize_t defaultSerializedSize, bool ignoreMaxBytes)
+                      const Selection &s, IncludedVersions v, ssize_t defaultSerializedSize, bool ignoreMaxBytes,
+                      bool streamDocuments)
             : handler_sequence(),
-              it(b, std::move(f), s, v, defaultSerializedSize, ignoreMaxBytes, readConsistency),
+              it(b, std::move(f), s, v, defaultSerializedSize, ignoreMaxBytes, readConsistency, streamDocuments),
               in_use(false) {}
     };
     struct BucketSpaceHash {
@@ -65,6 +67,7 @@ private:
 
     const ssize_t                           _defaultSerializedSize;
     const bool                              _ignoreMaxBytes;
+    const bool                              _streamDocuments;
     PersistenceHandlerMap                   _handlers;
     mutable std::mutex                      _lock;
     Iterators                               _iterators;
@@ -91,11 +94,18 @@ private:
     std::shared_ptr<BucketExecutor> get_bucket_executor() noexcept { return _bucket_executor.lock(); }
     void removeAsyncSingle(const Bucket&, Timestamp, const document::DocumentId &id, OperationComplete::UP);
     void removeAsyncMulti(const Bucket&, std::vector<storage::spi::IdAndTimestamp> ids, OperationComplete::UP);
+    // Returns the handler for the operation, or nullptr after completing it with an error
+    IPersistenceHandler * put_handler(const ReadGuard & guard, const Bucket &, Timestamp, const document::Document &,
+                                      OperationComplete &onComplete) const;
+    IPersistenceHandler * update_handler(const ReadGuard & guard, const Bucket &, Timestamp, DocumentUpdate &,
+                                         OperationComplete &onComplete) const;
+    IPersistenceHandler * remove_handler(const ReadGuard & guard, const Bucket &, Timestamp, const document::DocumentId &,
+                                         OperationComplete &onComplete) const;
 public:
     using UP = std::unique_ptr<PersistenceEngine>;
 
     PersistenceEngine(IPersistenceEngineOwner &owner, const IResourceWriteFilter &writeFilter, IDiskMemUsageNotifier &disk_mem_usage_notifier,
-                      ssize_t defaultSerializedSize, bool ignoreMaxBytes);
+                      ssize_t defaultSerializedSize, bool ignoreMaxBytes, bool streamDocuments = false);
     ~PersistenceEngine() override;
 
     IPersistenceHandler::SP putHandler(const WriteGuard &, document::BucketSpace bucketSpace, const DocTypeName &docType, const IPersistenceHandler::SP &handler);
@@ -111,6 +121,7 @@ public:
     void removeAsync(const Bucket&, std::vector<storage::spi::IdAndTimestamp> ids, OperationComplete::UP) override;
     void removeByGidAsync(const Bucket&, std::vector<storage::spi::DocTypeGidAndTimestamp> ids, std::unique_ptr<OperationComplete>) override;
     void updateAsync(const Bucket&, Timestamp, storage::spi::DocumentUpdateSP, OperationComplete::UP) override;
+    void feedBatchAsync(const Bucket&, std::vector<BatchedOperation> ops) override;
     GetResult get(const Bucket&, const document::FieldSet&, const document::DocumentId&, Context&) const override;
     CreateIteratorResult
     createIterator(const Bucket &bucket, FieldSetSP, const Selection &, IncludedVersions, Context &context) override;
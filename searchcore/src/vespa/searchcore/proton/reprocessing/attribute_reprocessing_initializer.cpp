@@ -27,6 +27,7 @@ using ARIConfig = AttributeReprocessingInitializer::Config;
 namespace {
 
 constexpr search::SerialNum ATTRIBUTE_INIT_SERIAL = 1;
+constexpr uint32_t ATTRIBUTE_POPULATE_COMMIT_BATCH_DOCS = 1000;
 
 const char *
 toStr(bool value)
@@ -70,7 +71,7 @@ getAttributesToPopulate(const ARIConfig &newCfg,
     if (!attrsToPopulate.empty()) {
         return std::make_shared<AttributePopulator>
                 (std::make_shared<FilterAttributeManager>(attrsToPopulate, newCfg.getAttrMgr()),
-                 ATTRIBUTE_INIT_SERIAL, subDbName, serialNum);
+                 ATTRIBUTE_INIT_SERIAL, subDbName, serialNum, ATTRIBUTE_POPULATE_COMMIT_BATCH_DOCS);
     }
     return IReprocessingReader::SP();
 }
@@ -239,6 +239,14 @@ CombiningFeedView::forceCommit(const CommitParam & param, DoneCallback onDone)
     }
 }
 
+void
+CombiningFeedView::dispatchPendingUpdates()
+{
+    for (const auto &view : _views) {
+        view->dispatchPendingUpdates();
+    }
+}
+
 void
 CombiningFeedView::
 handlePruneRemovedDocuments(const PruneRemovedDocumentsOperation &pruneOp, DoneCallback onDone)
@@ -59,6 +59,8 @@ public:
 
     ~CombiningFeedView() override;
 
+    void dispatchPendingUpdates() override;
+
     const std::shared_ptr<const document::DocumentTypeRepo> & getDocumentTypeRepo() const override;
 
     /**
@@ -1,6 +1,7 @@
 // Copyright Vespa.ai. Licensed under the terms of the Apache 2.0 license. See LICENSE in the project root.
 
 #include "document_db_maintenance_config.h"
+#include <algorithm>
 
 namespace proton {
 
@@ -50,6 +51,7 @@ DocumentDBLidSpaceCompactionConfig::DocumentDBLidSpaceCompactionConfig() noexcep
       _allowedLidBloatFactor(1.0),
       _remove_batch_block_rate(0.5),
       _remove_block_rate(100),
+      _max_docs_to_move_per_run(1),
       _disabled(false)
 {
 }
@@ -59,13 +61,15 @@ DocumentDBLidSpaceCompactionConfig::DocumentDBLidSpaceCompactionConfig(vespalib:
                                                                        double allowedLidBloatFactor,
                                                                        double remove_batch_block_rate,
                                                                        double remove_block_rate,
-                                                                       bool disabled) noexcept
+                                                                       bool disabled,
+                                                                       uint32_t max_docs_to_move_per_run) noexcept
     : _delay(std::min(MAX_DELAY_SEC, interval)),
       _interval(interval),
       _allowedLidBloat(allowedLidBloat),
       _allowedLidBloatFactor(allowedLidBloatFactor),
       _remove_batch_block_rate(remove_batch_block_rate),
       _remove_block_rate(remove_block_rate),
+      _max_docs_to_move_per_run(std::max(1u, max_docs_to_move_per_run)),
       _disabled(disabled)
 {
 }
@@ -85,6 +89,7 @@ DocumentDBLidSpaceCompactionConfig::operator==(const DocumentDBLidSpaceCompactio
            _interval == rhs._interval &&
            _allowedLidBloat == rhs._allowedLidBloat &&
            _allowedLidBloatFactor == rhs._allowedLidBloatFactor &&
+           _max_docs_to_move_per_run == rhs._max_docs_to_move_per_run &&
            _disabled == rhs._disabled;
 }
 
@@ -120,6 +125,31 @@ BucketMoveConfig::operator==(const BucketMoveConfig &rhs) const noexcept
     return _maxDocsToMovePerBucket == rhs._maxDocsToMovePerBucket;
 }
 
+NearestNeighborIndexMaintenanceConfig::NearestNeighborIndexMaintenanceConfig() noexcept
+    : NearestNeighborIndexMaintenanceConfig(60s, 10000, 100, 100)
+{}
+
+NearestNeighborIndexMaintenanceConfig::NearestNeighborIndexMaintenanceConfig(vespalib::duration interval,
+                                                                             uint32_t nodesToCheck,
+                                                                             uint32_t nodesToProbe,
+                                                                             uint32_t maxRepairs) noexcept
+    : _delay(std::min(MAX_DELAY_SEC, interval)),
+      _interval(interval),
+      _nodesToCheck(nodesToCheck),
+      _nodesToProbe(nodesToProbe),
+      _maxRepairs(maxRepairs)
+{}
+
+bool
+NearestNeighborIndexMaintenanceConfig::operator==(const NearestNeighborIndexMaintenanceConfig &rhs) const noexcept
+{
+    return _delay == rhs._delay &&
+           _interval == rhs._interval &&
+           _nodesToCheck == rhs._nodesToCheck &&
+           _nodesToProbe == rhs._nodesToProbe &&
+           _maxRepairs == rhs._maxRepairs;
+}
+
 DocumentDBMaintenanceConfig::DocumentDBMaintenanceConfig() noexcept
     : _pruneRemovedDocuments(),
       _heartBeat(),
@@ -129,7 +159,8 @@ DocumentDBMaintenanceConfig::DocumentDBMaintenanceConfig() noexcept
       _attributeUsageSampleInterval(60s),
       _blockableJobConfig(),
       _flushConfig(),
-      _bucketMoveConfig()
+      _bucketMoveConfig(),
+      _nearestNeighborIndexMaintenance()
 { }
 
 DocumentDBMaintenanceConfig::~DocumentDBMaintenanceConfig() = default;
@@ -143,7 +174,8 @@ DocumentDBMaintenanceConfig(const DocumentDBPruneConfig &pruneRemovedDocuments,
                             vespalib::duration attributeUsageSampleInterval,
                             const BlockableMaintenanceJobConfig &blockableJobConfig,
                             const DocumentDBFlushConfig &flushConfig,
-                            const BucketMoveConfig & bucketMoveconfig) noexcept
+                            const BucketMoveConfig & bucketMoveconfig,
+                            const NearestNeighborIndexMaintenanceConfig &nearestNeighborIndexMaintenance) noexcept
     : _pruneRemovedDocuments(pruneRemovedDocuments),
       _heartBeat(heartBeat),
       _visibilityDelay(visibilityDelay),
@@ -152,7 +184,8 @@ DocumentDBMaintenanceConfig(const DocumentDBPruneConfig &pruneRemovedDocuments,
       _attributeUsageSampleInterval(attributeUsageSampleInterval),
       _blockableJobConfig(blockableJobConfig),
       _flushConfig(flushConfig),
-      _bucketMoveConfig(bucketMoveconfig)
+      _bucketMoveConfig(bucketMoveconfig),
+      _nearestNeighborIndexMaintenance(nearestNeighborIndexMaintenance)
 { }
 
 bool
@@ -168,7 +201,8 @@ operator==(const DocumentDBMaintenanceConfig &rhs) const noexcept
         _attributeUsageSampleInterval == rhs._attributeUsageSampleInterval &&
         _blockableJobConfig == rhs._blockableJobConfig &&
         _flushConfig == rhs._flushConfig &&
-        _bucketMoveConfig == rhs._bucketMoveConfig;
+        _bucketMoveConfig == rhs._bucketMoveConfig &&
+        _nearestNeighborIndexMaintenance == rhs._nearestNeighborIndexMaintenance;
 }
 
 } // namespace proton
@@ -50,6 +50,7 @@ private:
     double               _allowedLidBloatFactor;
     double               _remove_batch_block_rate;
     double               _remove_block_rate;
+    uint32_t             _max_docs_to_move_per_run;
     bool                 _disabled;
 
 public:
@@ -59,7 +60,8 @@ public:
                                        double allowwedLidBloatFactor,
                                        double remove_batch_block_rate,
                                        double remove_block_rate,
-                                       bool disabled) noexcept;
+                                       bool disabled,
+                                       uint32_t max_docs_to_move_per_run = 1) noexcept;
 
     static DocumentDBLidSpaceCompactionConfig createDisabled() noexcept;
     bool operator==(const DocumentDBLidSpaceCompactionConfig &rhs) const noexcept;
@@ -69,6 +71,7 @@ public:
     double getAllowedLidBloatFactor() const noexcept { return _allowedLidBloatFactor; }
     double get_remove_batch_block_rate() const noexcept { return _remove_batch_block_rate; }
     double get_remove_block_rate() const noexcept { return _remove_block_rate; }
+    uint32_t get_max_docs_to_move_per_run() const noexcept { return _max_docs_to_move_per_run; }
     bool isDisabled() const noexcept { return _disabled; }
 };
 
@@ -96,6 +99,26 @@ private:
     uint32_t  _maxDocsToMovePerBucket;
 };
 
+class NearestNeighborIndexMaintenanceConfig {
+private:
+    vespalib::duration _delay;
+    vespalib::duration _interval;
+    uint32_t           _nodesToCheck;
+    uint32_t           _nodesToProbe;
+    uint32_t           _maxRepairs;
+public:
+    NearestNeighborIndexMaintenanceConfig() noexcept;
+    NearestNeighborIndexMaintenanceConfig(vespalib::duration interval, uint32_t nodesToCheck,
+                                          uint32_t nodesToProbe, uint32_t maxRepairs) noexcept;
+    bool operator==(const NearestNeighborIndexMaintenanceConfig &rhs) const noexcept;
+    vespalib::duration getDelay() const noexcept { return _delay; }
+    vespalib::duration getInterval() const noexcept { return _interval; }
+    uint32_t getNodesToCheck() const noexcept { return _nodesToCheck; }
+    uint32_t getNodesToProbe() const noexcept { return _nodesToProbe; }
+    uint32_t getMaxRepairs() const noexcept { return _maxRepairs; }
+    bool isDisabled() const noexcept { return (_interval <= vespalib::duration::zero()) || (_nodesToCheck == 0); }
+};
+
 class DocumentDBMaintenanceConfig
 {
 public:
@@ -111,6 +134,7 @@ private:
     BlockableMaintenanceJobConfig         _blockableJobConfig;
     DocumentDBFlushConfig                 _flushConfig;
     BucketMoveConfig                      _bucketMoveConfig;
+    NearestNeighborIndexMaintenanceConfig _nearestNeighborIndexMaintenance;
 
 public:
     DocumentDBMaintenanceConfig() noexcept;
@@ -122,7 +146,9 @@ public:
                                 vespalib::duration attributeUsageSampleInterval,
                                 const BlockableMaintenanceJobConfig &blockableJobConfig,
                                 const DocumentDBFlushConfig &flushConfig,
-                                const BucketMoveConfig & bucketMoveconfig) noexcept;
+                                const BucketMoveConfig & bucketMoveconfig,
+                                const NearestNeighborIndexMaintenanceConfig &nearestNeighborIndexMaintenance =
+                                        NearestNeighborIndexMaintenanceConfig()) noexcept;
 
     DocumentDBMaintenanceConfig(const DocumentDBMaintenanceConfig &) = delete;
     DocumentDBMaintenanceConfig & operator = (const DocumentDBMaintenanceConfig &) = delete;
@@ -153,6 +179,9 @@ public:
     }
     const DocumentDBFlushConfig &getFlushConfig() const noexcept { return _flushConfig; }
     const BucketMoveConfig & getBucketMoveConfig() const noexcept  { return _bucketMoveConfig; }
+    const NearestNeighborIndexMaintenanceConfig &getNearestNeighborIndexMaintenanceConfig() const noexcept {
+        return _nearestNeighborIndexMaintenance;
+    }
 };
 
 } // namespace proton
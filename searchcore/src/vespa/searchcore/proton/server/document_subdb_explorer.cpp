@@ -1,6 +1,7 @@
 // Copyright Vespa.ai. Licensed under the terms of the Apache 2.0 license. See LICENSE in the project root.
 
 #include "document_subdb_explorer.h"
+#include "matchers_explorer.h"
 #include <vespa/searchcore/proton/attribute/attribute_manager_explorer.h>
 #include <vespa/searchcore/proton/attribute/attribute_writer_explorer.h>
 #include <vespa/searchcore/proton/docsummary/document_store_explorer.h>
@@ -20,6 +21,7 @@ const vespalib::string DOCUMENT_STORE = "documentstore";
 const vespalib::string ATTRIBUTE = "attribute";
 const vespalib::string ATTRIBUTE_WRITER = "attributewriter";
 const vespalib::string INDEX = "index";
+const vespalib::string MATCHERS = "matchers";
 
 }
 
@@ -48,6 +50,9 @@ DocumentSubDBExplorer::get_children_names() const
     if (_subDb.getIndexManager()) {
         children.push_back(INDEX);
     }
+    if (_subDb.getMatchers()) {
+        children.push_back(MATCHERS);
+    }
     return children;
 }
 
@@ -76,6 +81,11 @@ DocumentSubDBExplorer::get_child(vespalib::stringref name) const
         if (idxMgr) {
             return std::make_unique<IndexManagerExplorer>(std::move(idxMgr));
         }
+    } else if (name == MATCHERS) {
+        auto matchers = _subDb.getMatchers();
+        if (matchers) {
+            return std::make_unique<MatchersExplorer>(std::move(matchers));
+        }
     }
     return {};
 }
@@ -74,7 +74,10 @@ namespace {
 
 index::IndexConfig
 makeIndexConfig(const ProtonConfig::Index & cfg) {
-    return {WarmupConfig(vespalib::from_s(cfg.warmup.time), cfg.warmup.unpack), size_t(cfg.maxflushed), size_t(cfg.cache.size)};
+    return {WarmupConfig(vespalib::from_s(cfg.warmup.time), cfg.warmup.unpack), size_t(cfg.maxflushed), size_t(cfg.cache.size),
+            size_t(cfg.warmup.hotwords), size_t(cfg.cache.postinglist.maxbytes),
+            uint32_t(cfg.flush.maxconcurrentfields), size_t(cfg.fusion.maxmergememory), cfg.fusion.blockdocids,
+            uint32_t(cfg.memory.pushshards), uint32_t(cfg.memory.postinglistcompression.mindocs)};
 }
 
 ReplayThrottlingPolicy
@@ -231,6 +234,7 @@ DocumentDB::DocumentDB(const vespalib::string &baseDir,
 
     _feedHandler->init(_config_store->getOldestSerialNum());
     _feedHandler->setBucketDBHandler(&_subDBs.getBucketDBHandler());
+    _feedHandler->set_commit_latency_metric(&_metrics.feeding.commit.latency);
     saveInitialConfig(configSnapshot);
     resumeSaveConfig();
     SerialNum configSerial = _config_store->getPrevValidSerial(_feedHandler->getPrunedSerialNum() + 1);
@@ -81,10 +81,12 @@ struct TempAttributeMetric
 {
     MemoryUsage memoryUsage;
     uint64_t    bitVectors;
+    uint64_t    compactionPending;
 
     TempAttributeMetric()
         : memoryUsage(),
-          bitVectors(0)
+          bitVectors(0),
+          compactionPending(0)
     {}
 };
 
@@ -109,13 +111,15 @@ isNotReadySubDB(const IDocumentSubDB *subDb, const DocumentSubDBCollection &subD
 
 void
 fillTempAttributeMetrics(TempAttributeMetrics &metrics, const vespalib::string &attrName,
-                         const MemoryUsage &memoryUsage, uint32_t bitVectors)
+                         const MemoryUsage &memoryUsage, uint32_t bitVectors, uint64_t compactionPending)
 {
     metrics.total.memoryUsage.merge(memoryUsage);
     metrics.total.bitVectors += bitVectors;
+    metrics.total.compactionPending += compactionPending;
     TempAttributeMetric &m = metrics.attrs[attrName];
     m.memoryUsage.merge(memoryUsage);
     m.bitVectors += bitVectors;
+    m.compactionPending += compactionPending;
 }
 
 void
@@ -136,9 +140,10 @@ fillTempAttributeMetrics(TempAttributeMetrics &totalMetrics,
                 const search::attribute::Status &status = attr->getStatus();
                 MemoryUsage memoryUsage(status.getAllocated(), status.getUsed(), status.getDead(), status.getOnHold());
                 uint32_t bitVectors = status.getBitVectors();
-                fillTempAttributeMetrics(totalMetrics, attr->getName(), memoryUsage, bitVectors);
+                uint64_t compactionPending = status.getCompactionPending();
+                fillTempAttributeMetrics(totalMetrics, attr->getName(), memoryUsage, bitVectors, compactionPending);
                 if (subMetrics != nullptr) {
-                    fillTempAttributeMetrics(*subMetrics, attr->getName(), memoryUsage, bitVectors);
+                    fillTempAttributeMetrics(*subMetrics, attr->getName(), memoryUsage, bitVectors, compactionPending);
                 }
             }
         }
@@ -152,6 +157,7 @@ updateAttributeMetrics(AttributeMetrics &metrics, const TempAttributeMetrics &tm
         auto entry = metrics.get(attr.first);
         if (entry) {
             entry->memoryUsage.update(attr.second.memoryUsage);
+            entry->compactionPending.set(attr.second.compactionPending);
         }
     }
 }
@@ -285,10 +291,7 @@ update_feeding_metrics(DocumentDBFeedingMetrics& metrics, FeedHandlerStats stats
         double max_operations = delta_stats.get_max_operations().value_or(0);
         double avg_operations = ((double) delta_stats.get_operations()) / commits;
         metrics.commit.operations.addValueBatch(avg_operations, commits, min_operations, max_operations);
-        double min_latency = delta_stats.get_min_latency().value_or(0.0);
-        double max_latency = delta_stats.get_max_latency().value_or(0.0);
-        double avg_latency = delta_stats.get_total_latency() / commits;
-        metrics.commit.latency.addValueBatch(avg_latency, commits, min_latency, max_latency);
+        // commit latency is added to its histogram metric by the feed handler as each commit completes
     }
 }
 
@@ -130,7 +130,8 @@ buildMaintenanceConfig(const BootstrapConfig::SP &bootstrapConfig,
                     proton.lidspacecompaction.allowedlidbloatfactor,
                     proton.lidspacecompaction.removebatchblockrate,
                     proton.lidspacecompaction.removeblockrate,
-                    isDocumentTypeGlobal),
+                    isDocumentTypeGlobal,
+                    proton.lidspacecompaction.maxdocstomoveperrun),
             AttributeUsageFilterConfig(
                     proton.writefilter.attribute.addressSpaceLimit),
             vespalib::from_s(proton.writefilter.sampleinterval),
@@ -138,7 +139,12 @@ buildMaintenanceConfig(const BootstrapConfig::SP &bootstrapConfig,
                     proton.maintenancejobs.resourcelimitfactor,
                     proton.maintenancejobs.maxoutstandingmoveops),
             DocumentDBFlushConfig(proton.index.maxflushed,proton.index.maxflushedretired),
-            BucketMoveConfig(proton.bucketmove.maxdocstomoveperbucket));
+            BucketMoveConfig(proton.bucketmove.maxdocstomoveperbucket),
+            NearestNeighborIndexMaintenanceConfig(
+                    vespalib::from_s(proton.nearestneighbor.maintenance.interval),
+                    proton.nearestneighbor.maintenance.nodestocheck,
+                    proton.nearestneighbor.maintenance.nodestoprobe,
+                    proton.nearestneighbor.maintenance.maxrepairs));
 }
 
 template<typename T>
@@ -185,7 +191,10 @@ deriveConfig(const ProtonConfig::Summary & summary, const vespalib::HwInfo & hwI
     logConfig.setMaxFileSize(log.maxfilesize)
             .setMaxNumLids(log.maxnumlids)
             .setMaxBucketSpread(log.maxbucketspread).setMinFileSizeFactor(log.minfilesizefactor)
+            .setDictionarySize(chunk.dictionary.maxbytes)
             .compactCompression(deriveCompression(log.compact.compression))
+            .setCompactStepBytes(log.compact.stepbytes)
+            .setMaxCompactBytesPerSecond(log.compact.maxbytespersecond)
             .setFileConfig(fileConfig);
     return {config, logConfig};
 }
@@ -248,8 +257,9 @@ build_alloc_config(const vespalib::HwInfo & hwInfo, const ProtonConfig& proton_c
             : alloc_config.initialnumdocs;
     auto& distribution_config = proton_config.distribution;
     search::GrowStrategy grow_strategy(target_numdocs, alloc_config.growfactor, alloc_config.growbias, target_numdocs, alloc_config.multivaluegrowfactor);
-    CompactionStrategy compaction_strategy(alloc_config.maxDeadBytesRatio, alloc_config.maxDeadAddressSpaceRatio, alloc_config.maxCompactBuffers, alloc_config.activeBuffersRatio);
-    return AllocConfig(AllocStrategy(grow_strategy, compaction_strategy, alloc_config.amortizecount),
+    CompactionStrategy compaction_strategy(alloc_config.maxDeadBytesRatio, alloc_config.maxDeadAddressSpaceRatio, alloc_config.maxCompactBuffers, alloc_config.activeBuffersRatio, alloc_config.maxCompactionMovesPerStep);
+    return AllocConfig(AllocStrategy(grow_strategy, compaction_strategy, alloc_config.amortizecount,
+                                     alloc_config.gidhashindex, alloc_config.buckettimestampindex),
                        distribution_config.redundancy, distribution_config.searchablecopies);
 }
 
@@ -35,6 +35,14 @@ DocumentRetrieverBase::getBucketMetaData(const storage::spi::Bucket &bucket,
     _meta_store.getReadGuard()->get().getMetaData(bucket, result);
 }
 
+void
+DocumentRetrieverBase::getBucketMetaDataInRange(const storage::spi::Bucket &bucket,
+                                                uint64_t fromTimestamp, uint64_t toTimestamp,
+                                                search::DocumentMetaData::Vector &result) const
+{
+    _meta_store.getReadGuard()->get().getMetaDataInRange(bucket, fromTimestamp, toTimestamp, result);
+}
+
 search::DocumentMetaData
 DocumentRetrieverBase::getDocumentMetaData(const DocumentId &id) const {
     return _meta_store.getReadGuard()->get().getMetaData(id.getGlobalId());
@@ -38,6 +38,8 @@ public:
 
     const document::DocumentTypeRepo &getDocumentTypeRepo() const override { return _repo; }
     void getBucketMetaData(const storage::spi::Bucket &bucket, search::DocumentMetaData::Vector &result) const override;
+    void getBucketMetaDataInRange(const storage::spi::Bucket &bucket, uint64_t fromTimestamp, uint64_t toTimestamp,
+                                  search::DocumentMetaData::Vector &result) const override;
     search::DocumentMetaData getDocumentMetaData(const document::DocumentId &id) const override;
     CachedSelect::SP parseSelect(const vespalib::string &selection) const override;
     ReadGuard getReadGuard() const override { return _meta_store.getReadGuard(); }
@@ -78,6 +78,12 @@ FastAccessFeedView::handleCompactLidSpace(const CompactLidSpaceOperation &op, Do
     Parent::handleCompactLidSpace(op, onDone);
 }
 
+void
+FastAccessFeedView::dispatchPendingUpdates()
+{
+    _attributeWriter->dispatchPendingUpdates();
+}
+
 void
 FastAccessFeedView::internalForceCommit(const CommitParam & param, OnForceCommitDoneType onCommitDone)
 {
@@ -63,6 +63,7 @@ public:
     }
 
     void handleCompactLidSpace(const CompactLidSpaceOperation &op, DoneCallback onDone) override;
+    void dispatchPendingUpdates() override;
 };
 
 } // namespace proton
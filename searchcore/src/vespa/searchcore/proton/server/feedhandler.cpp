@@ -20,6 +20,7 @@
 #include <vespa/searchcorespi/index/ithreadingservice.h>
 #include <vespa/vespalib/util/destructor_callbacks.h>
 #include <vespa/searchlib/transactionlog/client_session.h>
+#include <vespa/metrics/histogrammetric.h>
 #include <vespa/vespalib/util/atomic.h>
 #include <vespa/vespalib/util/exceptions.h>
 #include <vespa/vespalib/util/lambdatask.h>
@@ -434,7 +435,8 @@ FeedHandler::FeedHandler(IThreadingService &writeService,
       _allowSync(false),
       _heart_beat_time(vespalib::steady_time()),
       _stats_lock(),
-      _stats()
+      _stats(),
+      _commit_latency_metric(nullptr)
 { }
 
 
@@ -475,7 +477,8 @@ FeedHandler::replayTransactionLog(SerialNum flushedIndexMgrSerial, SerialNum flu
     assert(_activeFeedView);
     assert(_bucketDBHandler);
     auto state = make_shared<ReplayTransactionLogState>
-                          (getDocTypeName(), _activeFeedView, *_bucketDBHandler, _replayConfig, config_store, replay_throttling_policy, *this);
+                          (getDocTypeName(), _activeFeedView, *_bucketDBHandler, _replayConfig, config_store, replay_throttling_policy, *this,
+                           &_writeService.shared());
     changeFeedState(state);
     // Resurrected attribute vector might cause oldestFlushedSerial to
     // be lower than _prunedSerialNum, so don't warn for now.
@@ -528,6 +531,9 @@ FeedHandler::onCommitDone(size_t numOperations, vespalib::steady_time start_time
     }
     vespalib::steady_time now = vespalib::steady_clock::now();
     auto latency = vespalib::to_s(now - start_time);
+    if (_commit_latency_metric != nullptr) {
+        _commit_latency_metric->addValue(latency);
+    }
     std::lock_guard guard(_stats_lock);
     _stats.add_commit(numOperations, latency);
 }
@@ -756,6 +762,17 @@ FeedHandler::handleOperation(FeedToken token, FeedOperation::UP op)
     }));
 }
 
+void
+FeedHandler::handleOperations(FeedOperationBatch ops)
+{
+    // See handleOperation() regarding the use of blocking_master_execute().
+    _writeService.blocking_master_execute(makeLambdaTask([this, ops = std::move(ops)]() mutable {
+        for (auto& [token, op] : ops) {
+            doHandleOperation(std::move(token), std::move(op));
+        }
+    }));
+}
+
 IDocumentMoveHandler::MoveResult
 FeedHandler::handleMove(MoveOperation &op, vespalib::IDestructorCallback::SP moveDoneCtx)
 {
@@ -19,6 +19,7 @@
 
 namespace searchcorespi::index { struct IThreadingService; }
 namespace document { class DocumentTypeRepo; }
+namespace metrics { class HistogramMetric; }
 
 namespace proton {
 struct ConfigStore;
@@ -60,6 +61,7 @@ private:
     using BucketId =  document::BucketId;
     using FeedStateSP = std::shared_ptr<FeedState>;
     using FeedOperationUP = std::unique_ptr<FeedOperation>;
+    using FeedOperationBatch = std::vector<std::pair<FeedToken, FeedOperationUP>>;
     using ReadGuard = std::shared_lock<std::shared_mutex>;
     using WriteGuard = std::unique_lock<std::shared_mutex>;
     using IThreadingService = searchcorespi::index::IThreadingService;
@@ -97,6 +99,7 @@ private:
     std::atomic<vespalib::steady_time>     _heart_beat_time;
     mutable std::mutex                     _stats_lock;
     mutable FeedHandlerStats               _stats;
+    metrics::HistogramMetric              *_commit_latency_metric;
 
     /**
      * Delayed handling of feed operations, in master write thread.
@@ -213,6 +216,14 @@ public:
         _bucketDBHandler = bucketDBHandler;
     }
 
+    /**
+     * Set the histogram metric that each commit latency (in seconds) is added to
+     * when the commit completes. Must be set before feeding starts.
+     */
+    void set_commit_latency_metric(metrics::HistogramMetric *metric) {
+        _commit_latency_metric = metric;
+    }
+
     // Must only be called from writer thread:
     void setSerialNum(SerialNum serialNum) { _serialNum.store(serialNum, std::memory_order_relaxed); }
     SerialNum inc_serial_num() override {
@@ -238,6 +249,11 @@ public:
 
     void performOperation(FeedToken token, FeedOperationUP op);
     void handleOperation(FeedToken token, FeedOperationUP op);
+    /**
+     * Handles the operations in a single master thread task, so that they are
+     * appended to the transaction log and committed together.
+     */
+    void handleOperations(FeedOperationBatch ops);
 
     MoveResult handleMove(MoveOperation &op, std::shared_ptr<vespalib::IDestructorCallback> moveDoneCtx) override;
     void heartBeat() override;
@@ -87,7 +87,13 @@ public:
     ~TransactionLogReplayPacketHandler() override = default;
 
     FeedToken make_replay_feed_token(const FeedOperation& op) {
-        SharedOperationThrottler::Token throttler_token = _throttler->blocking_acquire_one();
+        SharedOperationThrottler::Token throttler_token = _throttler->try_acquire_one();
+        if (!throttler_token.valid()) {
+            // The attribute writer batches partial updates, hand them over to the
+            // write threads so that their tokens are released while we are blocked.
+            _feed_view_ptr->dispatchPendingUpdates();
+            throttler_token = _throttler->blocking_acquire_one();
+        }
         return _replay_feed_token_factory->make_replay_feed_token(std::move(throttler_token), op);
     }
 
@@ -147,6 +153,64 @@ public:
     }
 };
 
+/**
+ * Copy of a packet received from the transaction log, with the
+ * document operations deserialized ahead of replay.
+ */
+struct DecodedPacket {
+    std::vector<char>                                 buf;
+    std::vector<Packet::Entry>                        entries;
+    // nullptr for entries that are deserialized when replayed
+    std::vector<std::unique_ptr<FeedOperation>>       ops;
+    std::shared_ptr<const document::DocumentTypeRepo> repo;
+    TlsReplayProgress                                *progress;
+    vespalib::Gate                                    decoded;
+
+    DecodedPacket(const Packet &packet, TlsReplayProgress *progress_in,
+                  std::shared_ptr<const document::DocumentTypeRepo> repo_in);
+    ~DecodedPacket();
+    void decode();
+};
+
+DecodedPacket::DecodedPacket(const Packet &packet, TlsReplayProgress *progress_in,
+                             std::shared_ptr<const document::DocumentTypeRepo> repo_in)
+    : buf(packet.getHandle().data(), packet.getHandle().data() + packet.getHandle().size()),
+      entries(),
+      ops(),
+      repo(std::move(repo_in)),
+      progress(progress_in),
+      decoded()
+{
+    entries.reserve(packet.size());
+    vespalib::nbostream_longlivedbuf handle(buf.data(), buf.size());
+    while ( !handle.empty() ) {
+        entries.emplace_back();
+        entries.back().deserialize(handle);
+    }
+}
+
+DecodedPacket::~DecodedPacket() = default;
+
+void
+DecodedPacket::decode()
+{
+    // Called in decode executor thread.
+    ops.reserve(entries.size());
+    for (const auto &entry : entries) {
+        if ( ! repo) {
+            ops.emplace_back();
+            continue;
+        }
+        try {
+            ops.push_back(ReplayPacketDispatcher::decodeEntry(entry, *repo));
+        } catch (const std::exception &) {
+            // Deserialized again (and failing properly) when replayed
+            ops.emplace_back();
+        }
+    }
+    decoded.countDown();
+}
+
 class PacketDispatcher {
 public:
     PacketDispatcher(IReplayPacketHandler *packet_handler)
@@ -154,8 +218,10 @@ public:
     {}
 
     void handlePacket(PacketWrapper & wrap);
+    void handleDecodedPacket(DecodedPacket &decoded);
 private:
     void handleEntry(const Packet::Entry &entry);
+    void handleDecodedEntry(FeedOperation &op);
     IReplayPacketHandler *_packet_handler;
 };
 
@@ -175,6 +241,36 @@ PacketDispatcher::handlePacket(PacketWrapper & wrap)
     wrap.gate.countDown();
 }
 
+void
+PacketDispatcher::handleDecodedPacket(DecodedPacket &decoded)
+{
+    decoded.decoded.await();
+    for (size_t i = 0; i < decoded.entries.size(); ++i) {
+        const auto &entry = decoded.entries[i];
+        auto &op = decoded.ops[i];
+        // The active feed view (and its document type repo) might have changed since the packet was decoded
+        if (op && (decoded.repo.get() == &_packet_handler->getDeserializeRepo())) {
+            handleDecodedEntry(*op);
+        } else {
+            handleEntry(entry);
+        }
+        op.reset();
+        if (decoded.progress != nullptr) {
+            handleProgress(*decoded.progress, entry.serial());
+        }
+    }
+}
+
+void
+PacketDispatcher::handleDecodedEntry(FeedOperation &op) {
+    // Called by handleDecodedPacket() in executor thread.
+    auto entry_serial_num = op.getSerialNum();
+    _packet_handler->check_serial_num(entry_serial_num);
+    ReplayPacketDispatcher dispatcher(*_packet_handler);
+    dispatcher.replayDecoded(op);
+    _packet_handler->optionalCommit(entry_serial_num);
+}
+
 void
 PacketDispatcher::handleEntry(const Packet::Entry &entry) {
     // Called by handlePacket() in executor thread.
@@ -196,20 +292,67 @@ ReplayTransactionLogState::ReplayTransactionLogState(
         IReplayConfig &replay_config,
         FeedConfigStore &config_store,
         const ReplayThrottlingPolicy &replay_throttling_policy,
-        IIncSerialNum& inc_serial_num)
+        IIncSerialNum& inc_serial_num,
+        Executor *decode_executor)
     : FeedState(REPLAY_TRANSACTION_LOG),
       _doc_type_name(name),
-      _packet_handler(std::make_unique<TransactionLogReplayPacketHandler>(feed_view_ptr, bucketDBHandler, replay_config, config_store, replay_throttling_policy, inc_serial_num))
+      _feed_view_ptr(feed_view_ptr),
+      _packet_handler(std::make_unique<TransactionLogReplayPacketHandler>(feed_view_ptr, bucketDBHandler, replay_config, config_store, replay_throttling_policy, inc_serial_num)),
+      _decode_executor(decode_executor),
+      _lock(),
+      _cond(),
+      _pending_packets(0),
+      _decode_repo(feed_view_ptr->getDocumentTypeRepo())
 { }
 
 ReplayTransactionLogState::~ReplayTransactionLogState() = default;
 
+std::shared_ptr<const document::DocumentTypeRepo>
+ReplayTransactionLogState::get_decode_repo()
+{
+    std::lock_guard guard(_lock);
+    return _decode_repo;
+}
+
+void
+ReplayTransactionLogState::acquire_pending()
+{
+    std::unique_lock guard(_lock);
+    _cond.wait(guard, [this]() { return _pending_packets < max_pending_packets; });
+    ++_pending_packets;
+}
+
+void
+ReplayTransactionLogState::release_pending(std::shared_ptr<const document::DocumentTypeRepo> decode_repo)
+{
+    std::lock_guard guard(_lock);
+    _decode_repo = std::move(decode_repo);
+    --_pending_packets;
+    _cond.notify_all();
+}
+
 void
 ReplayTransactionLogState::receive(const PacketWrapper::SP &wrap, Executor &executor) {
-    executor.execute(makeLambdaTask([this, wrap = wrap] () {
+    if (_decode_executor == nullptr) {
+        executor.execute(makeLambdaTask([this, wrap = wrap] () {
+            PacketDispatcher dispatcher(_packet_handler.get());
+            dispatcher.handlePacket(*wrap);
+        }));
+        return;
+    }
+    // Document operations are decoded using the document type repo of the feed view active when
+    // the latest replayed packet completed, operations decoded with a stale repo are decoded again.
+    auto decoded = std::make_shared<DecodedPacket>(wrap->packet, wrap->progress, get_decode_repo());
+    acquire_pending();
+    _decode_executor->execute(makeLambdaTask([decoded] () { decoded->decode(); }));
+    executor.execute(makeLambdaTask([this, decoded] () {
         PacketDispatcher dispatcher(_packet_handler.get());
-        dispatcher.handlePacket(*wrap);
+        dispatcher.handleDecodedPacket(*decoded);
+        release_pending(_feed_view_ptr->getDocumentTypeRepo());
     }));
+    // The packet has been copied, the next one can be received before this one is replayed
+    wrap->result = RPC::OK;
+    wrap->gate.countDown();
 }
 
 }  // namespace proton
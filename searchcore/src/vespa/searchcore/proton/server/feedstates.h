@@ -7,6 +7,8 @@
 #include "packetwrapper.h"
 #include "ireplaypackethandler.h"
 #include <vespa/searchcore/proton/common/commit_time_tracker.h>
+#include <condition_variable>
+#include <mutex>
 
 namespace proton {
 
@@ -44,10 +46,28 @@ public:
 /**
  * The feed handler is replaying the transaction log.
  * Replayed messages from the transaction log are sent to the active feed view.
+ *
+ * When given a decode executor, document operations in received
+ * packets are deserialized in parallel using that executor while
+ * earlier packets are replayed, and the packets are replayed in order
+ * by the executor given to receive. The number of packets in this
+ * pipeline is bounded.
  */
 class ReplayTransactionLogState : public FeedState {
+    static constexpr uint32_t max_pending_packets = 32;
+
     vespalib::string _doc_type_name;
+    IFeedView *& _feed_view_ptr;
     std::unique_ptr<IReplayPacketHandler> _packet_handler;
+    vespalib::Executor *_decode_executor;
+    std::mutex _lock;
+    std::condition_variable _cond;
+    uint32_t _pending_packets;
+    std::shared_ptr<const document::DocumentTypeRepo> _decode_repo;
+
+    std::shared_ptr<const document::DocumentTypeRepo> get_decode_repo();
+    void acquire_pending();
+    void release_pending(std::shared_ptr<const document::DocumentTypeRepo> decode_repo);
 
 public:
     ReplayTransactionLogState(const vespalib::string &name,
@@ -56,7 +76,8 @@ public:
             IReplayConfig &replay_config,
             FeedConfigStore &config_store,
             const ReplayThrottlingPolicy &replay_throttling_policy,
-            IIncSerialNum &inc_serial_num);
+            IIncSerialNum &inc_serial_num,
+            vespalib::Executor *decode_executor = nullptr);
 
     ~ReplayTransactionLogState() override;
     void handleOperation(FeedToken, FeedOperationUP op) override {
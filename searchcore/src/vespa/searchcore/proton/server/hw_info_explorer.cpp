@@ -2,6 +2,7 @@
 
 #include "hw_info_explorer.h"
 #include <vespa/vespalib/data/slime/cursor.h>
+#include <vespa/vespalib/util/hw_counters.h>
 
 namespace proton {
 
@@ -25,6 +26,9 @@ HwInfoExplorer::get_state(const vespalib::slime::Inserter& inserter, bool full)
 
         auto& cpu = object.setObject("cpu");
         cpu.setLong("cores", _info.cpu().cores());
+        auto& counters = cpu.setObject("counters");
+        counters.setBool("enabled", vespalib::ThreadHwCounters::enabled());
+        counters.setBool("available", vespalib::ThreadHwCounters::available());
     }
 }
 
@@ -39,6 +39,7 @@ class IReplayConfig;
 class ISearchHandler;
 class ISummaryAdapter;
 class ISummaryManager;
+class Matchers;
 class PendingLidTrackerBase;
 class ReconfigParams;
 class RemoveDocumentsOperation;
@@ -127,6 +128,8 @@ public:
     virtual std::unique_ptr<IDocumentRetriever> getDocumentRetriever() = 0;
 
     virtual matching::MatchingStats getMatcherStats(const vespalib::string &rankProfile) const = 0;
+    // The matchers used by the search view, or nullptr if this sub database is not searchable
+    virtual std::shared_ptr<Matchers> getMatchers() const = 0;
     virtual void close() = 0;
     virtual std::shared_ptr<IDocumentDBReference> getDocumentDBReference() = 0;
     virtual void tearDownReferences(IDocumentDBReferenceResolver &resolver) = 0;
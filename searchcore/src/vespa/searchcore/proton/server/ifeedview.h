@@ -62,6 +62,11 @@ public:
     virtual void handleMove(const MoveOperation &putOp, DoneCallback onDone) = 0;
     virtual void heartBeat(search::SerialNum serialNum, DoneCallback onDone) = 0;
     virtual void forceCommit(const CommitParam & param, DoneCallback onDone) = 0;
+    /**
+     * Hand over write operations batched by the feed view (e.g. partial updates to
+     * attributes) to the write threads, without committing.
+     */
+    virtual void dispatchPendingUpdates() = 0;
     virtual void handlePruneRemovedDocuments(const PruneRemovedDocumentsOperation & pruneOp, DoneCallback onDone) = 0;
     virtual void handleCompactLidSpace(const CompactLidSpaceOperation &op, DoneCallback onDone) = 0;
     void forceCommit(CommitParam param) { forceCommit(param, IDestructorCallbackSP()); }
@@ -71,14 +71,15 @@ private:
 bool
 CompactionJob::scanDocuments(const LidUsageStats &stats)
 {
-    if (_scanItr->valid()) {
+    for (uint32_t i = 0; i < _cfg.get_max_docs_to_move_per_run() && _scanItr->valid(); ++i) {
         DocumentMetaData document = getNextDocument(stats);
-        if (document.valid()) {
-            Bucket metaBucket(document::Bucket(_bucketSpace, document.bucketId));
-            _bucketExecutor.execute(metaBucket, std::make_unique<MoveTask>(shared_from_this(), document, getLimiter().beginOperation()));
-            if (isBlocked(BlockedReason::OUTSTANDING_OPS)) {
-                return true;
-            }
+        if (!document.valid()) {
+            break;
+        }
+        Bucket metaBucket(document::Bucket(_bucketSpace, document.bucketId));
+        _bucketExecutor.execute(metaBucket, std::make_unique<MoveTask>(shared_from_this(), document, getLimiter().beginOperation()));
+        if (isBlocked(BlockedReason::OUTSTANDING_OPS)) {
+            return true;
         }
     }
     return false;
@@ -96,12 +97,38 @@ CompactionJob::moveDocument(std::shared_ptr<CompactionJob> job, const search::Do
     // Early detection and force md5 calculation outside of master thread
     if (metaThen.gid != op->getDocument()->getId().getGlobalId()) return;
 
-    auto & master = job->_master;
     if (job->stopped()) return;
-    master.execute(makeLambdaTask([self=std::move(job), meta=metaThen, moveOp=std::move(op), onDone=std::move(context)]() mutable {
-        if (self->stopped()) return;
-        self->completeMove(meta, std::move(moveOp), std::move(onDone));
-    }));
+    if (job->addPendingMove(metaThen, std::move(op), std::move(context))) {
+        auto & master = job->_master;
+        master.execute(makeLambdaTask([self=std::move(job)]() {
+            self->completePendingMoves();
+        }));
+    }
+}
+
+bool
+CompactionJob::addPendingMove(const search::DocumentMetaData & metaThen, std::unique_ptr<MoveOperation> moveOp,
+                              std::shared_ptr<IDestructorCallback> onDone)
+{
+    std::lock_guard guard(_pendingMovesLock);
+    bool first = _pendingMoves.empty();
+    _pendingMoves.push_back({metaThen, std::move(moveOp), std::move(onDone)});
+    // Only the first pending move schedules a task in the master thread, later moves are completed by the same task.
+    return first;
+}
+
+void
+CompactionJob::completePendingMoves()
+{
+    std::vector<PendingMove> moves;
+    {
+        std::lock_guard guard(_pendingMovesLock);
+        moves.swap(_pendingMoves);
+    }
+    if (stopped()) return;
+    for (auto & move : moves) {
+        completeMove(move.meta, std::move(move.op), std::move(move.onDone));
+    }
 }
 
 void
@@ -150,7 +177,9 @@ CompactionJob::CompactionJob(const DocumentDBLidSpaceCompactionConfig &config,
       _master(master),
       _bucketExecutor(bucketExecutor),
       _dbRetainer(std::move(dbRetainer)),
-      _bucketSpace(bucketSpace)
+      _bucketSpace(bucketSpace),
+      _pendingMovesLock(),
+      _pendingMoves()
 {
     _diskMemUsageNotifier.addDiskMemUsageListener(this);
     _clusterStateChangedNotifier.addClusterStateChangedHandler(this);
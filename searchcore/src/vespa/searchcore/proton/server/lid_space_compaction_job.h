@@ -10,6 +10,8 @@
 #include <vespa/searchlib/common/idocumentmetastore.h>
 #include <vespa/vespalib/util/retain_guard.h>
 #include <atomic>
+#include <mutex>
+#include <vector>
 
 namespace storage::spi { struct BucketExecutor; }
 namespace searchcorespi::index { struct IThreadService; }
@@ -29,6 +31,9 @@ namespace proton::lidspace {
 /**
  * Moves documents from higher lids to lower lids. It uses a BucketExecutor that ensures that the bucket
  * is locked for changes while the document is moved.
+ *
+ * Up to 'maxDocsToMovePerRun' documents are scheduled for move in each run. Moves that are ready
+ * are batched up and completed by a single task in the master thread.
  */
 class CompactionJob : public BlockableMaintenanceJob,
                       public IDiskMemUsageListener,
@@ -39,6 +44,11 @@ private:
     using BucketExecutor = storage::spi::BucketExecutor;
     using IDestructorCallback = vespalib::IDestructorCallback;
     using IThreadService = searchcorespi::index::IThreadService;
+    struct PendingMove {
+        search::DocumentMetaData             meta;
+        std::unique_ptr<MoveOperation>       op;
+        std::shared_ptr<IDestructorCallback> onDone;
+    };
     const DocumentDBLidSpaceCompactionConfig      _cfg;
     std::shared_ptr<ILidSpaceCompactionHandler>   _handler;
     IOperationStorer                             &_opStorer;
@@ -52,6 +62,8 @@ private:
     BucketExecutor                               &_bucketExecutor;
     vespalib::RetainGuard                         _dbRetainer;
     document::BucketSpace                         _bucketSpace;
+    std::mutex                                    _pendingMovesLock;
+    std::vector<PendingMove>                      _pendingMoves;
 
     bool hasTooMuchLidBloat(const search::LidUsageStats &stats) const;
     bool shouldRestartScanDocuments(const search::LidUsageStats &stats) const;
@@ -63,6 +75,9 @@ private:
     bool scanDocuments(const search::LidUsageStats &stats);
     static void moveDocument(std::shared_ptr<CompactionJob> job, const search::DocumentMetaData & metaThen,
                              std::shared_ptr<IDestructorCallback> onDone);
+    bool addPendingMove(const search::DocumentMetaData & metaThen, std::unique_ptr<MoveOperation> moveOp,
+                        std::shared_ptr<IDestructorCallback> onDone);
+    void completePendingMoves();
     void completeMove(const search::DocumentMetaData & metaThen, std::unique_ptr<MoveOperation> moveOp,
                       std::shared_ptr<IDestructorCallback> onDone);
     class MoveTask;
@@ -6,6 +6,7 @@
 #include "job_tracked_maintenance_job.h"
 #include "lid_space_compaction_job.h"
 #include "lid_space_compaction_handler.h"
+#include "nearest_neighbor_index_maintenance_job.h"
 #include "pruneremoveddocumentsjob.h"
 #include "sample_attribute_usage_job.h"
 
@@ -113,6 +114,13 @@ MaintenanceJobsInjector::injectJobs(MaintenanceController &controller,
                         moveHandler, bucketModifiedHandler, clusterStateChangedNotifier, bucketStateChangedNotifier,
                         calc, jobTrackers, diskMemUsageNotifier);
 
+    if (!config.getNearestNeighborIndexMaintenanceConfig().isDisabled()) {
+        controller.registerJob(
+                std::make_unique<NearestNeighborIndexMaintenanceJob>(readyAttributeManager,
+                                                                     config.getNearestNeighborIndexMaintenanceConfig(),
+                                                                     docTypeName));
+    }
+
     controller.registerJob(
             std::make_unique<SampleAttributeUsageJob>(std::move(readyAttributeManager),
                                                       std::move(notReadyAttributeManager),
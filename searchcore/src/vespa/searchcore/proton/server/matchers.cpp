@@ -2,11 +2,17 @@
 
 #include "matchers.h"
 #include <vespa/searchcore/proton/matching/matcher.h>
+#include <vespa/searchcore/proton/matching/term_stats_cache.h>
+#include <vespa/searchcommon/common/schema.h>
 #include <vespa/searchlib/fef/onnx_models.h>
 #include <vespa/searchlib/fef/ranking_expressions.h>
+#include <vespa/vespalib/data/slime/cursor.h>
+#include <vespa/vespalib/util/exceptions.h>
 #include <vespa/vespalib/util/issue.h>
 #include <vespa/vespalib/util/stringfmt.h>
 #include <vespa/vespalib/stllike/hash_map.hpp>
+#include <algorithm>
+#include <mutex>
 
 namespace proton {
 
@@ -16,25 +22,143 @@ using matching::Matcher;
 using matching::MatchingStats;
 using namespace vespalib::make_string_short;
 
+class Matchers::LazyMatcher {
+private:
+    vespalib::string                                      _name;
+    std::shared_ptr<const search::index::Schema>          _schema;
+    search::fef::Properties                               _properties;
+    const std::atomic<vespalib::steady_time>             &_now_ref;
+    matching::QueryLimiter                               &_queryLimiter;
+    std::shared_ptr<const search::fef::RankingAssetsRepo> _ranking_assets_repo;
+    uint32_t                                              _distributionKey;
+    std::mutex                                            _lock;
+    std::atomic<bool>                                     _done;
+    std::shared_ptr<Matcher>                              _matcher;
+public:
+    LazyMatcher(const vespalib::string &name, std::shared_ptr<const search::index::Schema> schema,
+                search::fef::Properties properties, const std::atomic<vespalib::steady_time> &now_ref,
+                matching::QueryLimiter &queryLimiter,
+                std::shared_ptr<const search::fef::RankingAssetsRepo> ranking_assets_repo,
+                uint32_t distributionKey)
+        : _name(name),
+          _schema(std::move(schema)),
+          _properties(std::move(properties)),
+          _now_ref(now_ref),
+          _queryLimiter(queryLimiter),
+          _ranking_assets_repo(std::move(ranking_assets_repo)),
+          _distributionKey(distributionKey),
+          _lock(),
+          _done(false),
+          _matcher()
+    { }
+
+    std::shared_ptr<Matcher> get() {
+        if (_done.load(std::memory_order_acquire)) {
+            return _matcher;
+        }
+        std::lock_guard guard(_lock);
+        if (!_done.load(std::memory_order_relaxed)) {
+            try {
+                _matcher = std::make_shared<Matcher>(*_schema, std::move(_properties), _now_ref, _queryLimiter,
+                                                     *_ranking_assets_repo, _distributionKey);
+            } catch (const vespalib::Exception &e) {
+                vespalib::Issue::report(fmt("Failed to set up rank-profile '%s': %s", _name.c_str(), e.getMessage().c_str()));
+            }
+            _schema.reset();
+            _done.store(true, std::memory_order_release);
+        }
+        return _matcher;
+    }
+
+    std::shared_ptr<Matcher> peek() const {
+        return _done.load(std::memory_order_acquire) ? _matcher : std::shared_ptr<Matcher>();
+    }
+};
+
+std::shared_ptr<Matcher>
+Matchers::Profile::get() const
+{
+    return lazy ? lazy->get() : matcher;
+}
+
+std::shared_ptr<Matcher>
+Matchers::Profile::peek() const
+{
+    return lazy ? lazy->peek() : matcher;
+}
+
 Matchers::Matchers(const std::atomic<vespalib::steady_time> & now_ref,
                    matching::QueryLimiter &queryLimiter,
                    const search::fef::RankingAssetsRepo &rankingAssetsRepo)
     : _rpmap(),
-      _ranking_assets_repo(rankingAssetsRepo),
+      _now_ref(now_ref),
+      _queryLimiter(queryLimiter),
+      _ranking_assets_repo(std::make_shared<search::fef::RankingAssetsRepo>(rankingAssetsRepo)),
       _fallback(std::make_shared<Matcher>(search::index::Schema(), search::fef::Properties(), now_ref, queryLimiter,
-                                          _ranking_assets_repo, -1)),
-      _default()
+                                          *_ranking_assets_repo, -1)),
+      _default(),
+      _term_stats(std::make_shared<matching::TermStatsCache>())
 { }
 
 Matchers::~Matchers() = default;
 
+void
+Matchers::add(const vespalib::string &name, Profile profile)
+{
+    if ((name == "default") || ! (_default.matcher || _default.lazy)) {
+        _default = profile;
+    }
+    _rpmap[name] = std::move(profile);
+}
+
 void
 Matchers::add(const vespalib::string &name, std::shared_ptr<Matcher> matcher)
 {
-    if ((name == "default") || ! _default) {
-        _default = matcher;
+    add(name, Profile{std::move(matcher), {}, _ranking_assets_repo});
+}
+
+void
+Matchers::add_lazy(const vespalib::string &name, std::shared_ptr<const search::index::Schema> schema,
+                   search::fef::Properties properties, uint32_t distributionKey)
+{
+    auto lazy = std::make_shared<LazyMatcher>(name, std::move(schema), std::move(properties), _now_ref, _queryLimiter,
+                                              _ranking_assets_repo, distributionKey);
+    add(name, Profile{{}, std::move(lazy), _ranking_assets_repo});
+}
+
+std::shared_ptr<Matcher>
+Matchers::get_or_fallback(const Profile &profile) const
+{
+    auto matcher = profile.get();
+    return matcher ? matcher : _fallback;
+}
+
+bool
+Matchers::try_reuse(const vespalib::string &name, const search::fef::Properties &properties, const Matchers &old)
+{
+    auto found = old._rpmap.find(name);
+    if (found == old._rpmap.end()) {
+        return false;
+    }
+    const Profile &profile = found->second;
+    auto matcher = profile.peek();
+    if (!matcher || !(matcher->get_index_env().getProperties() == properties)) {
+        return false;
+    }
+    const auto &old_assets = *profile.ranking_assets_repo;
+    const auto &new_assets = *_ranking_assets_repo;
+    auto used = matcher->get_used_ranking_assets();
+    for (const auto &constant : used.constants) {
+        if (!old_assets.sameConstant(constant, new_assets)) return false;
+    }
+    for (const auto &expression : used.expressions) {
+        if (!old_assets.sameExpression(expression, new_assets)) return false;
+    }
+    for (const auto &model : used.onnx_models) {
+        if (!old_assets.sameOnnxModel(model, new_assets)) return false;
     }
-    _rpmap[name] = std::move(matcher);
+    add(name, profile);
+    return true;
 }
 
 MatchingStats
@@ -42,7 +166,9 @@ Matchers::getStats() const
 {
     MatchingStats stats;
     for (const auto & entry : _rpmap) {
-        stats.add(entry.second->getStats());
+        if (auto matcher = entry.second.peek()) {
+            stats.add(matcher->getStats());
+        }
     }
     return stats;
 }
@@ -51,7 +177,8 @@ MatchingStats
 Matchers::getStats(const vespalib::string &name) const
 {
     auto it = _rpmap.find(name);
-    return it != _rpmap.end() ? it->second->getStats() : MatchingStats();
+    auto matcher = (it != _rpmap.end()) ? it->second.peek() : std::shared_ptr<Matcher>();
+    return matcher ? matcher->getStats() : MatchingStats();
 }
 
 std::shared_ptr<Matcher>
@@ -59,15 +186,37 @@ Matchers::lookup(const vespalib::string &name) const
 {
     auto found = _rpmap.find(name);
     if (found == _rpmap.end()) {
-        if (_default) {
+        if (_default.matcher || _default.lazy) {
             vespalib::Issue::report(fmt("Failed to find rank-profile '%s'. Falling back to 'default'", name.c_str()));
-            return _default;
+            return get_or_fallback(_default);
         } else {
             vespalib::Issue::report(fmt("Failed to find rank-profile '%s'. Most likely a configuration issue.", name.c_str()));
             return _fallback;
         }
     }
-    return found->second;
+    return get_or_fallback(found->second);
+}
+
+void
+Matchers::report_profile_stats(vespalib::slime::Cursor &obj, bool full) const
+{
+    std::vector<vespalib::string> names;
+    for (const auto & entry : _rpmap) {
+        auto matcher = entry.second.peek();
+        if (matcher && matcher->get_profile_stats().sampled_queries() > 0) {
+            names.push_back(entry.first);
+        }
+    }
+    std::sort(names.begin(), names.end());
+    for (const auto & name : names) {
+        const auto & stats = _rpmap.find(name)->second.peek()->get_profile_stats();
+        auto & rank_profile = obj.setObject(name);
+        if (full) {
+            stats.report(rank_profile);
+        } else {
+            rank_profile.setLong("sampled_queries", stats.sampled_queries());
+        }
+    }
 }
 
 } // namespace proton
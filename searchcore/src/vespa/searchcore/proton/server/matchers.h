@@ -6,20 +6,44 @@
 #include <vespa/searchlib/fef/ranking_assets_repo.h>
 #include <vespa/vespalib/stllike/hash_map.h>
 
+namespace search::fef { class Properties; }
+namespace search::index { class Schema; }
+namespace vespalib::slime { struct Cursor; }
+
 namespace proton {
 
 namespace matching {
     class Matcher;
     class QueryLimiter;
+    class TermStatsCache;
 }
 
 class Matchers {
 private:
-    using Map = vespalib::hash_map<vespalib::string, std::shared_ptr<matching::Matcher>>;
-    Map                                  _rpmap;
-    const search::fef::RankingAssetsRepo _ranking_assets_repo;
-    std::shared_ptr<matching::Matcher>   _fallback;
-    std::shared_ptr<matching::Matcher>   _default;
+    class LazyMatcher;
+    struct Profile {
+        // nullptr for rank profiles that are set up on first use
+        std::shared_ptr<matching::Matcher> matcher;
+        std::shared_ptr<LazyMatcher> lazy;
+        // The ranking assets the matcher was set up with; older than ours if reused from a previous generation
+        std::shared_ptr<const search::fef::RankingAssetsRepo> ranking_assets_repo;
+
+        // Returns the matcher, setting it up if needed. nullptr if setup failed.
+        std::shared_ptr<matching::Matcher> get() const;
+        // Returns the matcher if it has been set up, otherwise nullptr.
+        std::shared_ptr<matching::Matcher> peek() const;
+    };
+    using Map = vespalib::hash_map<vespalib::string, Profile>;
+    Map                                                   _rpmap;
+    const std::atomic<vespalib::steady_time>             &_now_ref;
+    matching::QueryLimiter                               &_queryLimiter;
+    std::shared_ptr<const search::fef::RankingAssetsRepo> _ranking_assets_repo;
+    std::shared_ptr<matching::Matcher>                    _fallback;
+    Profile                                               _default;
+    std::shared_ptr<matching::TermStatsCache>             _term_stats;
+
+    void add(const vespalib::string &name, Profile profile);
+    std::shared_ptr<matching::Matcher> get_or_fallback(const Profile &profile) const;
 public:
     using SP = std::shared_ptr<Matchers>;
     Matchers(const std::atomic<vespalib::steady_time> & now_ref,
@@ -29,10 +53,31 @@ public:
     Matchers & operator =(const Matchers &) = delete;
     ~Matchers();
     void add(const vespalib::string &name, std::shared_ptr<matching::Matcher> matcher);
+    /**
+     * Add a rank profile whose matcher is set up on first lookup, so that
+     * the ranking constants and onnx models it uses are only loaded when
+     * needed. If setup fails, the issue is reported and the fallback
+     * matcher is used.
+     */
+    void add_lazy(const vespalib::string &name, std::shared_ptr<const search::index::Schema> schema,
+                  search::fef::Properties properties, uint32_t distributionKey);
+    /**
+     * Reuse the matcher for the given rank profile from an older generation if it was
+     * set up with the same properties and all ranking assets it depends on are unchanged.
+     * The caller must ensure that the schema is unchanged.
+     *
+     * @return true if the matcher was reused and added to this
+     */
+    bool try_reuse(const vespalib::string &name, const search::fef::Properties &properties, const Matchers &old);
     matching::MatchingStats getStats() const;
     matching::MatchingStats getStats(const vespalib::string &name) const;
     std::shared_ptr<matching::Matcher> lookup(const vespalib::string &name) const;
-    const search::fef::RankingAssetsRepo& get_ranking_assets_repo() const noexcept { return _ranking_assets_repo; }
+    // Reports the aggregated profiling information of rank profiles with sampled queries
+    void report_profile_stats(vespalib::slime::Cursor &obj, bool full) const;
+    const search::fef::RankingAssetsRepo& get_ranking_assets_repo() const noexcept { return *_ranking_assets_repo; }
+    // Global term statistics used by all rank profiles. Shared with older generations on reconfig.
+    const std::shared_ptr<matching::TermStatsCache>& get_term_stats() const noexcept { return _term_stats; }
+    void share_term_stats(const Matchers &old) { _term_stats = old._term_stats; }
 };
 
 } // namespace proton
@@ -0,0 +1,27 @@
+// Copyright Vespa.ai. Licensed under the terms of the Apache 2.0 license. See LICENSE in the project root.
+
+#include "matchers_explorer.h"
+#include "matchers.h"
+#include <vespa/vespalib/data/slime/cursor.h>
+#include <vespa/vespalib/data/slime/inserter.h>
+
+using vespalib::slime::Cursor;
+using vespalib::slime::Inserter;
+
+namespace proton {
+
+MatchersExplorer::MatchersExplorer(std::shared_ptr<Matchers> matchers)
+    : _matchers(std::move(matchers))
+{
+}
+
+MatchersExplorer::~MatchersExplorer() = default;
+
+void
+MatchersExplorer::get_state(const Inserter& inserter, bool full) const
+{
+    Cursor& object = inserter.insertObject();
+    _matchers->report_profile_stats(object.setObject("profiling"), full);
+}
+
+}
@@ -0,0 +1,28 @@
+// Copyright Vespa.ai. Licensed under the terms of the Apache 2.0 license. See LICENSE in the project root.
+
+#pragma once
+
+#include <vespa/vespalib/net/http/state_explorer.h>
+#include <memory>
+
+namespace proton {
+
+class Matchers;
+
+/**
+ * Class used to explore the profiling information aggregated by the
+ * matchers of a sub database (one entry per rank profile with sampled
+ * queries).
+ */
+class MatchersExplorer : public vespalib::StateExplorer {
+private:
+    std::shared_ptr<Matchers> _matchers;
+
+public:
+    MatchersExplorer(std::shared_ptr<Matchers> matchers);
+    ~MatchersExplorer() override;
+
+    void get_state(const vespalib::slime::Inserter& inserter, bool full) const override;
+};
+
+}
@@ -13,6 +13,7 @@
 LOG_SETUP(".proton.server.matchview");
 
 using proton::matching::MatchContext;
+using proton::matching::ResultCache;
 using proton::matching::SearchSession;
 using search::AttributeGuard;
 using search::AttributeVector;
@@ -58,7 +59,7 @@ MatchView::getMatcher(const vespalib::string & rankProfile) const
 
 MatchContext
 MatchView::createContext() const {
-    auto searchCtx = std::make_unique<SearchContext>(_indexSearchable, _docIdLimit.get());
+    auto searchCtx = std::make_unique<SearchContext>(_indexSearchable, _docIdLimit.get(), _matchers->get_term_stats());
     return {_attrMgr->createContext(), std::move(searchCtx)};
 }
 
@@ -67,14 +68,34 @@ MatchView::match(std::shared_ptr<const ISearchHandler> searchHandler, const Sear
                  vespalib::ThreadBundle &threadBundle) const
 {
     Matcher::SP matcher = getMatcher(req.ranking);
+    ResultCache *result_cache = ResultCache::is_cacheable(req) ? matcher->get_result_cache() : nullptr;
+    vespalib::string cache_key;
+    search::SerialNum serial_num = 0;
+    uint32_t num_active_lids = 0;
+    if (result_cache != nullptr) {
+        cache_key = ResultCache::make_key(req);
+        serial_num = _metaStore->get().getLastSerialNum();
+        num_active_lids = _metaStore->get().getNumActiveLids();
+        auto cached = result_cache->lookup(cache_key, serial_num, num_active_lids, vespalib::steady_clock::now());
+        if (cached.reply) {
+            matcher->report_result_cache_hit(cached.match_time);
+            return std::move(cached.reply);
+        }
+    }
     SearchSession::OwnershipBundle owned_objects(createContext(), std::move(searchHandler));
     owned_objects.readGuard = _metaStore->getReadGuard();
     ISearchContext & search_ctx = owned_objects.context.getSearchContext();
     IAttributeContext & attribute_ctx = owned_objects.context.getAttributeContext();
     const search::IDocumentMetaStore & dms = owned_objects.readGuard->get();
     const bucketdb::BucketDBOwner & bucketDB = _metaStore->get().getBucketDB();
-    return matcher->match(req, threadBundle, search_ctx, attribute_ctx,
-                          _sessionMgr, dms, bucketDB, std::move(owned_objects));
+    vespalib::Timer match_time;
+    auto reply = matcher->match(req, threadBundle, search_ctx, attribute_ctx,
+                                _sessionMgr, dms, bucketDB, std::move(owned_objects));
+    if ((result_cache != nullptr) && ResultCache::is_complete(*reply, num_active_lids)) {
+        result_cache->insert(cache_key, serial_num, num_active_lids, vespalib::steady_clock::now(),
+                             *reply, match_time.elapsed());
+    }
+    return reply;
 }
 
 } // namespace proton
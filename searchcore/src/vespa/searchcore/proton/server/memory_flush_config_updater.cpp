@@ -78,6 +78,10 @@ MemoryFlushConfigUpdater::updateFlushStrategy(const LockGuard &guard, const char
     MemoryFlush::Config newConfig = convertConfig(_currConfig, _memory);
     considerUseConservativeDiskMode(guard, newConfig);
     considerUseConservativeMemoryMode(guard, newConfig);
+    if (_adaptiveFlushStrategy) {
+        updateAdaptiveFlushStrategy(newConfig, why);
+        return;
+    }
     MemoryFlush::Config currentConfig = _flushStrategy->getConfig();
     if ( currentConfig != newConfig ) {
         _flushStrategy->setConfig(newConfig);
@@ -90,11 +94,30 @@ MemoryFlushConfigUpdater::updateFlushStrategy(const LockGuard &guard, const char
     }
 }
 
+void
+MemoryFlushConfigUpdater::updateAdaptiveFlushStrategy(const MemoryFlush::Config &limits, const char * why)
+{
+    AdaptiveFlushStrategy::Config currentConfig = _adaptiveFlushStrategy->getConfig();
+    AdaptiveFlushStrategy::Config newConfig = currentConfig;
+    newConfig.maxGlobalMemory = limits.maxGlobalMemory;
+    newConfig.maxGlobalTlsSize = limits.maxGlobalTlsSize;
+    newConfig.diskBloatFactor = limits.diskBloatFactor;
+    newConfig.maxTimeGain = limits.maxTimeGain;
+    if ( !(currentConfig == newConfig) ) {
+        _adaptiveFlushStrategy->setConfig(newConfig);
+        LOG(info, "Due to %s (conservative-disk=%d, conservative-memory=%d, retired-or-maintenance=%d) adaptive flush config updated to "
+                  "disk-bloat(%1.2f), max-tls-size(%" PRIu64 "),max-global-memory(%" PRIu64 ")",
+            why, _useConservativeDiskMode, _useConservativeMemoryMode, _node_retired_or_maintenance,
+            newConfig.diskBloatFactor, newConfig.maxGlobalTlsSize, newConfig.maxGlobalMemory);
+    }
+}
+
 MemoryFlushConfigUpdater::MemoryFlushConfigUpdater(const MemoryFlush::SP &flushStrategy,
                                                    const ProtonConfig::Flush::Memory &config,
                                                    const vespalib::HwInfo::Memory &memory)
     : _mutex(),
       _flushStrategy(flushStrategy),
+      _adaptiveFlushStrategy(),
       _currConfig(config),
       _memory(memory),
       _currState(),
@@ -104,6 +127,23 @@ MemoryFlushConfigUpdater::MemoryFlushConfigUpdater(const MemoryFlush::SP &flushS
 {
 }
 
+MemoryFlushConfigUpdater::MemoryFlushConfigUpdater(const std::shared_ptr<AdaptiveFlushStrategy> &flushStrategy,
+                                                   const ProtonConfig::Flush::Memory &config,
+                                                   const vespalib::HwInfo::Memory &memory)
+    : _mutex(),
+      _flushStrategy(),
+      _adaptiveFlushStrategy(flushStrategy),
+      _currConfig(config),
+      _memory(memory),
+      _currState(),
+      _useConservativeDiskMode(false),
+      _useConservativeMemoryMode(false),
+      _node_retired_or_maintenance(false)
+{
+}
+
+MemoryFlushConfigUpdater::~MemoryFlushConfigUpdater() = default;
+
 void
 MemoryFlushConfigUpdater::setConfig(const ProtonConfig::Flush::Memory &newConfig)
 {
@@ -164,4 +204,19 @@ MemoryFlushConfigUpdater::convertConfig(const ProtonConfig::Flush::Memory &confi
                                vespalib::from_s(config.maxage.time));
 }
 
+AdaptiveFlushStrategy::Config
+MemoryFlushConfigUpdater::convertAdaptiveConfig(const ProtonConfig::Flush &config, const vespalib::HwInfo::Memory &memory)
+{
+    MemoryFlush::Config limits = convertConfig(config.memory, memory);
+    AdaptiveFlushStrategy::Config result;
+    result.maxGlobalMemory = limits.maxGlobalMemory;
+    result.maxGlobalTlsSize = limits.maxGlobalTlsSize;
+    result.diskBloatFactor = limits.diskBloatFactor;
+    result.maxTimeGain = limits.maxTimeGain;
+    result.diskWriteBytesPerSecond = config.adaptive.diskwritebandwidth;
+    result.maxWriteAmplification = config.adaptive.maxwriteamplification;
+    result.earlyFlushPressure = config.adaptive.earlyflushpressure;
+    return result;
+}
+
 } // namespace proton
@@ -4,6 +4,7 @@
 
 #include "i_disk_mem_usage_listener.h"
 #include "memoryflush.h"
+#include <vespa/searchcore/proton/flushengine/adaptive_flush_strategy.h>
 #include <vespa/config-proton.h>
 #include <vespa/vespalib/util/hw_info.h>
 #include <mutex>
@@ -13,6 +14,8 @@ namespace proton {
 /**
  * Class that listens to changes in disk and memory usage and
  * updates the config used by memory flush strategy accordingly if we reach one of the resource limits.
+ * When used with the adaptive flush strategy, the resulting global memory and TLS size
+ * limits, disk bloat factor and max age are applied to that strategy instead.
  */
 class MemoryFlushConfigUpdater : public IDiskMemUsageListener
 {
@@ -23,6 +26,7 @@ private:
 
     Mutex                       _mutex;
     MemoryFlush::SP             _flushStrategy;
+    std::shared_ptr<AdaptiveFlushStrategy> _adaptiveFlushStrategy;
     ProtonConfig::Flush::Memory _currConfig;
     vespalib::HwInfo::Memory    _memory;
     DiskMemUsageState           _currState;
@@ -35,6 +39,7 @@ private:
     void considerUseConservativeMemoryMode(const LockGuard &guard, MemoryFlush::Config &newConfig);
     void considerUseRelaxedDiskMode(const LockGuard &guard, MemoryFlush::Config &newConfig);
     void updateFlushStrategy(const LockGuard &guard, const char * why);
+    void updateAdaptiveFlushStrategy(const MemoryFlush::Config &limits, const char * why);
 
 public:
     using UP = std::unique_ptr<MemoryFlushConfigUpdater>;
@@ -42,12 +47,18 @@ public:
     MemoryFlushConfigUpdater(const MemoryFlush::SP &flushStrategy,
                              const ProtonConfig::Flush::Memory &config,
                              const vespalib::HwInfo::Memory &memory);
+    MemoryFlushConfigUpdater(const std::shared_ptr<AdaptiveFlushStrategy> &flushStrategy,
+                             const ProtonConfig::Flush::Memory &config,
+                             const vespalib::HwInfo::Memory &memory);
+    ~MemoryFlushConfigUpdater() override;
     void setConfig(const ProtonConfig::Flush::Memory &newConfig);
     void set_node_retired_or_maintenance(bool value);
     void notifyDiskMemUsage(DiskMemUsageState newState) override;
 
     static MemoryFlush::Config convertConfig(const ProtonConfig::Flush::Memory &config,
                                              const vespalib::HwInfo::Memory &memory);
+    static AdaptiveFlushStrategy::Config convertAdaptiveConfig(const ProtonConfig::Flush &config,
+                                                               const vespalib::HwInfo::Memory &memory);
 };
 
 } // namespace proton
@@ -29,6 +29,7 @@ public:
 
     document::Document::UP getFullDocument(search::DocumentIdT lid) const override;
     void visitDocuments(const LidVector & lids, search::IDocumentVisitor & visitor, ReadConsistency) const override;
+    void sortLidsInStorageOrder(LidVector & lids) const override { _doc_store.sortLidsInStorageOrder(lids); }
 };
 }  // namespace proton
 
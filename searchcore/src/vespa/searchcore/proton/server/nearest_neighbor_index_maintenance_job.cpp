@@ -0,0 +1,73 @@
+// Copyright Vespa.ai. Licensed under the terms of the Apache 2.0 license. See LICENSE in the project root.
+
+#include "nearest_neighbor_index_maintenance_job.h"
+#include <vespa/searchcore/proton/attribute/i_attribute_manager.h>
+#include <vespa/searchcommon/attribute/i_attribute_functor.h>
+#include <vespa/searchlib/tensor/tensor_attribute.h>
+#include <vespa/vespalib/util/destructor_callbacks.h>
+
+#include <vespa/log/log.h>
+LOG_SETUP(".proton.server.nearest_neighbor_index_maintenance_job");
+
+using search::tensor::TensorAttribute;
+
+namespace proton {
+
+namespace {
+
+class MaintainNearestNeighborIndex : public search::attribute::IAttributeFunctor
+{
+    const NearestNeighborIndexMaintenanceConfig _config;
+    const vespalib::string                      _docTypeName;
+public:
+    MaintainNearestNeighborIndex(const NearestNeighborIndexMaintenanceConfig &config,
+                                 const vespalib::string &docTypeName)
+        : _config(config),
+          _docTypeName(docTypeName)
+    {}
+    void operator()(search::attribute::IAttributeVector &attributeVector) override {
+        // Executed by attribute writer thread
+        auto tensorAttribute = dynamic_cast<TensorAttribute *>(&attributeVector);
+        if (tensorAttribute == nullptr || tensorAttribute->nearest_neighbor_index() == nullptr) {
+            return;
+        }
+        auto stats = tensorAttribute->maintain_nearest_neighbor_index(_config.getNodesToCheck(),
+                                                                      _config.getNodesToProbe(),
+                                                                      _config.getMaxRepairs());
+        LOG(debug, "Maintained nearest neighbor index of '%s.%s': checked=%u, degraded=%u, repaired=%u, "
+            "probed=%u, recall=%.3f", _docTypeName.c_str(), tensorAttribute->getName().c_str(),
+            stats.checked_nodes, stats.degraded_nodes, stats.repaired_nodes, stats.probed_nodes,
+            stats.probe_recall());
+    }
+};
+
+}
+
+NearestNeighborIndexMaintenanceJob::
+NearestNeighborIndexMaintenanceJob(IAttributeManagerSP attributeManager,
+                                   const NearestNeighborIndexMaintenanceConfig &config,
+                                   const vespalib::string &docTypeName)
+    : IMaintenanceJob("nearest_neighbor_index_maintenance." + docTypeName, config.getDelay(), config.getInterval()),
+      _attributeManager(std::move(attributeManager)),
+      _config(config),
+      _docTypeName(docTypeName),
+      _running(std::make_shared<std::atomic<bool>>(false))
+{
+}
+
+NearestNeighborIndexMaintenanceJob::~NearestNeighborIndexMaintenanceJob() = default;
+
+bool
+NearestNeighborIndexMaintenanceJob::run()
+{
+    if (_running->exchange(true)) {
+        // Previous run is still queued in the attribute writer threads
+        return true;
+    }
+    auto onDone = vespalib::makeSharedLambdaCallback([running = _running]() { running->store(false); });
+    _attributeManager->asyncForEachAttribute(std::make_shared<MaintainNearestNeighborIndex>(_config, _docTypeName),
+                                             std::move(onDone));
+    return true;
+}
+
+} // namespace proton
@@ -0,0 +1,42 @@
+// Copyright Vespa.ai. Licensed under the terms of the Apache 2.0 license. See LICENSE in the project root.
+
+#pragma once
+
+#include "i_maintenance_job.h"
+#include "document_db_maintenance_config.h"
+#include <atomic>
+
+namespace proton {
+
+struct IAttributeManager;
+
+/**
+ * Job that checks the health of the graphs of the nearest neighbor
+ * indexes of tensor attributes, and repairs nodes left with too few
+ * neighbors or not found when searching after heavy removes and
+ * updates (see NearestNeighborIndex::maintain_graph()).
+ *
+ * The work is done in the attribute writer threads, with a bounded
+ * number of nodes checked and repaired per index in each run. A run
+ * is skipped if the previous one is still queued or running.
+ */
+class NearestNeighborIndexMaintenanceJob : public IMaintenanceJob
+{
+    using IAttributeManagerSP = std::shared_ptr<IAttributeManager>;
+
+    IAttributeManagerSP                         _attributeManager;
+    const NearestNeighborIndexMaintenanceConfig _config;
+    const vespalib::string                      _docTypeName;
+    std::shared_ptr<std::atomic<bool>>          _running;
+
+public:
+    NearestNeighborIndexMaintenanceJob(IAttributeManagerSP attributeManager,
+                                       const NearestNeighborIndexMaintenanceConfig &config,
+                                       const vespalib::string &docTypeName);
+    ~NearestNeighborIndexMaintenanceJob() override;
+
+    bool run() override;
+    void onStop() override { }
+};
+
+} // namespace proton
@@ -12,6 +12,7 @@
 #include <vespa/searchcore/proton/feedoperation/updateoperation.h>
 #include <vespa/document/update/documentupdate.h>
 
+using storage::spi::BatchedOperation;
 using storage::spi::Bucket;
 using storage::spi::Timestamp;
 
@@ -61,6 +62,30 @@ PersistenceHandlerProxy::handleRemoveByGid(FeedToken token, const storage::spi::
     _feedHandler.handleOperation(std::move(token), std::move(op));
 }
 
+void
+PersistenceHandlerProxy::handleFeedBatch(const Bucket &bucket, std::vector<FeedBatchEntry> entries)
+{
+    const document::BucketId bucket_id = bucket.getBucketId().stripUnused();
+    FeedHandler::FeedOperationBatch ops;
+    ops.reserve(entries.size());
+    for (auto& entry : entries) {
+        FeedOperation::UP op;
+        switch (entry.op.type) {
+        case BatchedOperation::Type::PUT:
+            op = std::make_unique<PutOperation>(bucket_id, entry.op.timestamp, std::move(entry.op.document));
+            break;
+        case BatchedOperation::Type::UPDATE:
+            op = std::make_unique<UpdateOperation>(bucket_id, entry.op.timestamp, std::move(entry.op.update));
+            break;
+        case BatchedOperation::Type::REMOVE_IF_FOUND:
+            op = std::make_unique<RemoveOperationWithDocId>(bucket_id, entry.op.timestamp, entry.op.id);
+            break;
+        }
+        ops.emplace_back(std::move(entry.token), std::move(op));
+    }
+    _feedHandler.handleOperations(std::move(ops));
+}
+
 void
 PersistenceHandlerProxy::handleListBuckets(IBucketIdListResultHandler &resultHandler)
 {
@@ -38,6 +38,7 @@ public:
     void handleRemoveByGid(FeedToken token, const storage::spi::Bucket &bucket,
                            storage::spi::Timestamp timestamp,
                            vespalib::stringref doc_type, const document::GlobalId& gid) override;
+    void handleFeedBatch(const storage::spi::Bucket &bucket, std::vector<FeedBatchEntry> entries) override;
 
     void handleListBuckets(IBucketIdListResultHandler &resultHandler) override;
     void handleSetClusterState(const storage::spi::ClusterState &calc, IGenericResultHandler &resultHandler) override;
@@ -24,6 +24,7 @@
 #include <vespa/fnet/transport.h>
 #include <vespa/metrics/updatehook.h>
 #include <vespa/searchcore/proton/attribute/i_attribute_usage_listener.h>
+#include <vespa/searchcore/proton/flushengine/adaptive_flush_strategy.h>
 #include <vespa/searchcore/proton/flushengine/flush_engine_explorer.h>
 #include <vespa/searchcore/proton/flushengine/flushengine.h>
 #include <vespa/searchcore/proton/flushengine/tls_stats_factory.h>
@@ -37,15 +38,20 @@
 #include <vespa/searchcore/proton/common/scheduled_forward_executor.h>
 #include <vespa/searchlib/attribute/interlock.h>
 #include <vespa/searchlib/common/packets.h>
+#include <vespa/searchlib/queryeval/flow_cost_table.h>
 #include <vespa/searchlib/transactionlog/trans_log_server_explorer.h>
 #include <vespa/searchlib/transactionlog/translogserverapp.h>
 #include <vespa/searchlib/util/fileheadertk.h>
+#include <vespa/vespalib/data/slime/cursor.h>
 #include <vespa/vespalib/io/fileutil.h>
 #include <vespa/vespalib/net/http/state_server.h>
 #include <vespa/vespalib/util/blockingthreadstackexecutor.h>
 #include <vespa/vespalib/util/cpu_usage.h>
 #include <vespa/vespalib/util/host_name.h>
+#include <vespa/vespalib/util/hw_counters.h>
+#include <vespa/vespalib/util/io_scheduler.h>
 #include <vespa/vespalib/util/lambdatask.h>
+#include <vespa/vespalib/util/lock_stats.h>
 #include <vespa/vespalib/util/mmap_file_allocator_factory.h>
 #include <vespa/vespalib/util/random.h>
 #include <vespa/vespalib/util/sequencedtaskexecutor.h>
@@ -64,6 +70,7 @@ using CpuCategory = vespalib::CpuUsage::Category;
 
 using document::DocumentTypeRepo;
 using search::engine::MonitorReply;
+using search::queryeval::FlowCostTable;
 using search::transactionlog::DomainStats;
 using vespa::config::search::core::ProtonConfig;
 using vespa::config::search::core::internal::InternalProtonType;
@@ -111,6 +118,7 @@ setFS4Compression(const ProtonConfig & proton)
     fs4.SetCompressionLimit(proton.packetcompresslimit);
     fs4.SetCompressionLevel(proton.packetcompresslevel);
     fs4.SetCompressionType(convert(proton.packetcompresstype));
+    fs4.SetAdaptiveCompression(proton.packetcompressadaptive);
 }
 
 DiskMemUsageSampler::Config
@@ -293,6 +301,9 @@ Proton::init(const BootstrapConfig::SP & configSnapshot)
     ensureWritableDir(protonConfig.basedir);
     const vespalib::HwInfo & hwInfo = configSnapshot->getHwInfo();
     _hw_info = hwInfo;
+    // must be set before the executors to be counted are created
+    vespalib::ThreadHwCounters::set_enabled(protonConfig.hwinfo.cpu.counters);
+    vespalib::LockStats::set_enabled(protonConfig.lockstats.enabled);
     _numThreadsPerSearch = std::min(hwInfo.cpu().cores(), uint32_t(protonConfig.numthreadspersearch));
 
     setBucketCheckSumType(protonConfig);
@@ -305,7 +316,8 @@ Proton::init(const BootstrapConfig::SP & configSnapshot)
     _matchEngine = std::make_unique<MatchEngine>(protonConfig.numsearcherthreads,
                                                  getNumThreadsPerSearch(),
                                                  protonConfig.distributionkey,
-                                                 protonConfig.search.async);
+                                                 protonConfig.search.async,
+                                                 protonConfig.search.spinwait.maxspins);
     _matchEngine->set_issue_forwarding(protonConfig.forwardIssues);
     _distributionKey = protonConfig.distributionkey;
     _summaryEngine = std::make_unique<SummaryEngine>(protonConfig.numsummarythreads, protonConfig.docsum.async);
@@ -323,6 +335,14 @@ Proton::init(const BootstrapConfig::SP & configSnapshot)
         strategy = memoryFlush;
         break;
     }
+    case ProtonConfig::Flush::Strategy::ADAPTIVE: {
+        auto adaptiveFlush = std::make_shared<AdaptiveFlushStrategy>(
+                MemoryFlushConfigUpdater::convertAdaptiveConfig(flush, hwInfo.memory()), vespalib::system_clock::now());
+        _memoryFlushConfigUpdater = std::make_unique<MemoryFlushConfigUpdater>(adaptiveFlush, flush.memory, hwInfo.memory());
+        _diskMemUsageSampler->notifier().addDiskMemUsageListener(_memoryFlushConfigUpdater.get());
+        strategy = adaptiveFlush;
+        break;
+    }
     case ProtonConfig::Flush::Strategy::SIMPLE:
     default:
         strategy = std::make_shared<SimpleFlush>();
@@ -342,13 +362,17 @@ Proton::init(const BootstrapConfig::SP & configSnapshot)
     _persistenceEngine = std::make_unique<PersistenceEngine>(*this, _diskMemUsageSampler->writeFilter(),
                                                              _diskMemUsageSampler->notifier(),
                                                              protonConfig.visit.defaultserializedsize,
-                                                             protonConfig.visit.ignoremaxbytes);
+                                                             protonConfig.visit.ignoremaxbytes,
+                                                             protonConfig.visit.streamdocuments);
     _shared_service = std::make_unique<SharedThreadingService>(
             SharedThreadingServiceConfig::make(protonConfig, hwInfo.cpu()), _transport, *_persistenceEngine);
     _scheduler = std::make_unique<ScheduledForwardExecutor>(_transport, _shared_service->shared());
     _diskMemUsageSampler->setConfig(diskMemUsageSamplerConfig(protonConfig, hwInfo), *_scheduler);
 
     vespalib::string fileConfigId;
+    if (protonConfig.compiledFunctionCache.enabled) {
+        vespalib::eval::CompileCache::set_object_cache_dir(protonConfig.basedir + "/compiled_functions");
+    }
     _compile_cache_executor_binding = vespalib::eval::CompileCache::bind(_shared_service->shared_raw());
 
     InitializeThreadsCalculator calc(hwInfo.cpu(), protonConfig.basedir, protonConfig.initialize.threads);
@@ -370,6 +394,7 @@ Proton::init(const BootstrapConfig::SP & configSnapshot)
     _metricsEngine->start(_configUri);
     _stateServer = std::make_unique<vespalib::StateServer>(protonConfig.httpport, _healthAdapter,
                                                            _metricsEngine->metrics_producer(), *this);
+    _stateServer->set_response_cache_ttl(vespalib::from_s(protonConfig.http.response.cache.ttl));
     _customComponentBindToken = _stateServer->repo().bind(CUSTOM_COMPONENT_API_PATH, _genericStateHandler);
     _customComponentRootToken = _stateServer->repo().add_root_resource(CUSTOM_COMPONENT_API_PATH);
 
@@ -382,6 +407,15 @@ Proton::init(const BootstrapConfig::SP & configSnapshot)
     _sessionPruneHandle = _scheduler->scheduleAtFixedRate(makeLambdaTask([&]() {
         _sessionManager->pruneTimedOutSessions(vespalib::steady_clock::now(), _shared_service->shared());
     }), pruneSessionsInterval, pruneSessionsInterval);
+#ifdef __linux__
+    vespalib::duration mallocTrimInterval = vespalib::from_s(protonConfig.malloc.trim.interval);
+    if (mallocTrimInterval > vespalib::duration::zero()) {
+        // Hand heap memory freed by e.g. flushed memory indexes back to the OS
+        _mallocTrimHandle = _scheduler->scheduleAtFixedRate(makeLambdaTask([]() {
+            malloc_trim(0);
+        }), mallocTrimInterval, mallocTrimInterval);
+    }
+#endif
     _isInitializing = false;
     _protonConfigurer.setAllowReconfig(true);
     _initComplete = true;
@@ -405,6 +439,9 @@ Proton::applyConfig(const BootstrapConfig::SP & configSnapshot)
     _queryLimiter.configure(protonConfig.search.memory.limiter.maxthreads,
                             protonConfig.search.memory.limiter.mincoverage,
                             protonConfig.search.memory.limiter.minhits);
+    _queryLimiter.configure_memory(protonConfig.search.memory.limiter.maxquerymemory);
+    applyFlowCostTable(protonConfig.search.flowcosttable);
+    vespalib::IoScheduler::instance().set_bandwidth(protonConfig.backgroundIo.bandwidth, protonConfig.backgroundIo.burst);
     const std::shared_ptr<const DocumentTypeRepo> repo = configSnapshot->getDocumentTypeRepoSP();
 
     _diskMemUsageSampler->setConfig(diskMemUsageSamplerConfig(protonConfig, configSnapshot->getHwInfo()), *_scheduler);
@@ -414,6 +451,19 @@ Proton::applyConfig(const BootstrapConfig::SP & configSnapshot)
     }
 }
 
+void
+Proton::applyFlowCostTable(const vespalib::string &file_name)
+{
+    FlowCostTable::SP table;
+    if (!file_name.empty()) {
+        table = FlowCostTable::load(file_name);
+        if (table) {
+            LOG(info, "Using flow cost table '%s' with %zu entries", file_name.c_str(), table->entries().size());
+        }
+    }
+    FlowCostTable::set_global(std::move(table));
+}
+
 std::shared_ptr<DocumentDBConfigOwner>
 Proton::addDocumentDB(const DocTypeName &docTypeName,
                       document::BucketSpace bucketSpace,
@@ -471,6 +521,7 @@ Proton::~Proton()
         _diskMemUsageSampler->notifier().removeDiskMemUsageListener(_memoryFlushConfigUpdater.get());
     }
     _sessionPruneHandle.reset();
+    _mallocTrimHandle.reset();
     if (_diskMemUsageSampler) {
         _diskMemUsageSampler->close();
     }
@@ -837,6 +888,7 @@ Proton::updateMetrics(const metrics::MetricLockGuard &)
         metrics.resourceUsage.cpu_util.compact.set(cpu_util[CpuCategory::COMPACT]);
         metrics.resourceUsage.cpu_util.other.set(cpu_util[CpuCategory::OTHER]);
         updateSessionCacheMetrics(metrics, session_manager());
+        metrics.backgroundIo.update(vespalib::IoScheduler::instance().get_stats());
     }
     {
         ContentProtonMetrics::ProtonExecutorMetrics &metrics = _metricsEngine->root().executor;
@@ -944,6 +996,8 @@ const vespalib::string RESOURCE_USAGE = "resourceusage";
 const vespalib::string THREAD_POOLS = "threadpools";
 const vespalib::string HW_INFO = "hwinfo";
 const vespalib::string SESSION = "session";
+const vespalib::string FLOW_COST_TABLE = "flowcosttable";
+const vespalib::string LOCK_STATS = "lockstats";
 
 
 struct StateExplorerProxy : vespalib::StateExplorer {
@@ -979,6 +1033,48 @@ struct DocumentDBMapExplorer : vespalib::StateExplorer {
     }
 };
 
+struct FlowCostTableExplorer : vespalib::StateExplorer {
+    void get_state(const vespalib::slime::Inserter &inserter, bool) const override {
+        auto &object = inserter.insertObject();
+        auto table = FlowCostTable::get_global();
+        auto &entries = object.setArray("entries");
+        if (table) {
+            for (const auto &[name, entry] : table->entries()) {
+                auto &cursor = entries.addObject();
+                cursor.setString("class_name", name);
+                cursor.setDouble("cost", entry.cost);
+                cursor.setDouble("strict_cost", entry.strict_cost);
+            }
+        }
+    }
+};
+
+struct LockStatsExplorer : vespalib::StateExplorer {
+    void get_state(const vespalib::slime::Inserter &inserter, bool full) const override {
+        auto &object = inserter.insertObject();
+        object.setBool("enabled", vespalib::LockStats::enabled());
+        auto &locks = object.setArray("locks");
+        for (const auto &stats : vespalib::LockStats::snapshot_all()) {
+            auto &cursor = locks.addObject();
+            cursor.setString("name", stats.name);
+            cursor.setLong("acquisitions", stats.acquisitions);
+            cursor.setLong("contended", stats.contended);
+            cursor.setDouble("total_wait_ms", vespalib::count_ns(stats.total_wait) / 1e6);
+            cursor.setDouble("max_wait_ms", vespalib::count_ns(stats.max_wait) / 1e6);
+            if (full) {
+                auto &histogram = cursor.setArray("wait_histogram");
+                for (size_t i = 0; i < stats.histogram.size(); ++i) {
+                    if (stats.histogram[i] > 0) {
+                        auto &bucket = histogram.addObject();
+                        bucket.setLong("below_us", vespalib::count_us(vespalib::LockStats::Snapshot::bucket_limit(i)));
+                        bucket.setLong("count", stats.histogram[i]);
+                    }
+                }
+            }
+        }
+    }
+};
+
 } // namespace proton::<unnamed>
 
 void
@@ -989,7 +1085,7 @@ Proton::get_state(const vespalib::slime::Inserter &, bool) const
 std::vector<vespalib::string>
 Proton::get_children_names() const
 {
-    return {DOCUMENT_DB, THREAD_POOLS, MATCH_ENGINE, FLUSH_ENGINE, TLS_NAME, HW_INFO, RESOURCE_USAGE, SESSION};
+    return {DOCUMENT_DB, THREAD_POOLS, MATCH_ENGINE, FLUSH_ENGINE, TLS_NAME, HW_INFO, RESOURCE_USAGE, SESSION, FLOW_COST_TABLE, LOCK_STATS};
 }
 
 std::unique_ptr<vespalib::StateExplorer>
@@ -1018,6 +1114,10 @@ Proton::get_child(vespalib::stringref name) const
         return std::make_unique<HwInfoExplorer>(_hw_info);
     } else if (name == SESSION) {
         return std::make_unique<matching::SessionManagerExplorer>(*_sessionManager);
+    } else if (name == FLOW_COST_TABLE) {
+        return std::make_unique<FlowCostTableExplorer>();
+    } else if (name == LOCK_STATS) {
+        return std::make_unique<LockStatsExplorer>();
     }
     return {};
 }
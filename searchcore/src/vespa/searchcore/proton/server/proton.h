@@ -117,6 +117,7 @@ private:
     std::unique_ptr<SharedThreadingService>   _shared_service;
     std::unique_ptr<matching::SessionManager> _sessionManager;
     IScheduledExecutor::Handle                _sessionPruneHandle;
+    IScheduledExecutor::Handle                _mallocTrimHandle;
     std::unique_ptr<ScheduledForwardExecutor> _scheduler;
     vespalib::eval::CompileCache::ExecutorBinding::UP _compile_cache_executor_binding;
     matching::QueryLimiter          _queryLimiter;
@@ -151,6 +152,7 @@ private:
     // Returns true if the node is up in _any_ bucket space
     bool updateNodeUp(BucketSpace bucketSpace, bool nodeUpInBucketSpace);
     void closeDocumentDBs(vespalib::ThreadStackExecutorBase & executor);
+    static void applyFlowCostTable(const vespalib::string &file_name);
 public:
     using UP = std::unique_ptr<Proton>;
     using SP = std::shared_ptr<Proton>;
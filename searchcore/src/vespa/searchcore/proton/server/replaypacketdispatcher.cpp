@@ -15,10 +15,42 @@ ReplayPacketDispatcher::replay(OperationType &op, vespalib::nbostream &is, const
 {
     op.deserialize(is, _handler.getDeserializeRepo());
     op.setSerialNum(entry.serial());
+    dispatch(op);
+}
+
+template <typename OperationType>
+void
+ReplayPacketDispatcher::dispatch(OperationType &op)
+{
     store(op);
     _handler.replay(op);
 }
 
+namespace {
+
+void
+checkFullyConsumed(const vespalib::nbostream &is, const search::transactionlog::Packet::Entry &entry)
+{
+    if ( ! is.empty()) {
+        throw document::DeserializeException
+            (make_string("Too much data in packet entry (type id '%u', %ld bytes)",
+                         entry.type(), is.size()));
+    }
+}
+
+template <typename OperationType>
+std::unique_ptr<FeedOperation>
+decode(std::unique_ptr<OperationType> op, vespalib::nbostream &is, const search::transactionlog::Packet::Entry &entry,
+       const document::DocumentTypeRepo &repo)
+{
+    op->deserialize(is, repo);
+    op->setSerialNum(entry.serial());
+    checkFullyConsumed(is, entry);
+    return op;
+}
+
+}
+
 
 ReplayPacketDispatcher::ReplayPacketDispatcher(IReplayPacketHandler &handler)
     : _handler(handler)
@@ -88,10 +120,44 @@ ReplayPacketDispatcher::replayEntry(const Packet::Entry &entry)
         throw IllegalStateException
             (make_string("Got packet entry with unknown type id '%u' from TLS", entry.type()));
     }
-    if ( ! is.empty()) {
-        throw document::DeserializeException
-            (make_string("Too much data in packet entry (type id '%u', %ld bytes)",
-                         entry.type(), is.size()));
+    checkFullyConsumed(is, entry);
+}
+
+std::unique_ptr<FeedOperation>
+ReplayPacketDispatcher::decodeEntry(const Packet::Entry &entry, const document::DocumentTypeRepo &repo)
+{
+    vespalib::nbostream is(entry.data().c_str(), entry.data().size());
+    switch (entry.type()) {
+    case FeedOperation::PUT:
+        return decode(std::make_unique<PutOperation>(), is, entry, repo);
+    case FeedOperation::REMOVE:
+        return decode(std::make_unique<RemoveOperationWithDocId>(), is, entry, repo);
+    case FeedOperation::REMOVE_GID:
+        return decode(std::make_unique<RemoveOperationWithGid>(), is, entry, repo);
+    case FeedOperation::UPDATE:
+        return decode(std::make_unique<UpdateOperation>(static_cast<FeedOperation::Type>(entry.type())), is, entry, repo);
+    default:
+        return {};
+    }
+}
+
+void
+ReplayPacketDispatcher::replayDecoded(FeedOperation &op)
+{
+    switch (op.getType()) {
+    case FeedOperation::PUT:
+        dispatch(static_cast<PutOperation &>(op));
+        break;
+    case FeedOperation::REMOVE:
+    case FeedOperation::REMOVE_GID:
+        dispatch(static_cast<RemoveOperation &>(op));
+        break;
+    case FeedOperation::UPDATE:
+        dispatch(static_cast<UpdateOperation &>(op));
+        break;
+    default:
+        throw IllegalStateException
+            (make_string("Got decoded operation with unexpected type id '%u'", op.getType()));
     }
 }
 
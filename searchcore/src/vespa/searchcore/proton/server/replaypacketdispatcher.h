@@ -4,6 +4,7 @@
 
 #include "ireplaypackethandler.h"
 #include <vespa/searchlib/transactionlog/common.h>
+#include <memory>
 
 namespace proton {
 
@@ -21,6 +22,8 @@ private:
 
     template <typename OperationType>
     void replay(OperationType &op, vespalib::nbostream &is, const Packet::Entry &entry);
+    template <typename OperationType>
+    void dispatch(OperationType &op);
 
 protected:
     virtual void store(const FeedOperation &op);
@@ -30,6 +33,16 @@ public:
     virtual ~ReplayPacketDispatcher();
 
     void replayEntry(const Packet::Entry &entry);
+
+    /**
+     * Deserializes document operations (put, remove and update) so
+     * that this can be done ahead of replay, outside the thread
+     * replaying the operations. Returns nullptr for other entry types,
+     * these must be replayed using replayEntry.
+     */
+    static std::unique_ptr<FeedOperation> decodeEntry(const Packet::Entry &entry, const document::DocumentTypeRepo &repo);
+    // Replays an operation returned by decodeEntry
+    void replayDecoded(FeedOperation &op);
 };
 
 } // namespace proton
@@ -16,8 +16,12 @@
 #include <vespa/searchcore/proton/common/indexschema_inspector.h>
 #include <vespa/searchcore/proton/reference/i_document_db_reference_resolver.h>
 #include <vespa/searchcore/proton/reprocessing/attribute_reprocessing_initializer.h>
+#include <vespa/searchlib/fef/indexproperties.h>
 #include <vespa/eval/eval/llvm/compile_cache.h>
 
+#include <vespa/log/log.h>
+LOG_SETUP(".proton.server.searchable_doc_subdb_configurer");
+
 using namespace vespa::config::search;
 using namespace config;
 using search::index::Schema;
@@ -111,7 +115,8 @@ SearchableDocSubDBConfigurer(const std::shared_ptr<ISummaryManager>& summaryMgr,
 SearchableDocSubDBConfigurer::~SearchableDocSubDBConfigurer() = default;
 
 std::shared_ptr<Matchers>
-SearchableDocSubDBConfigurer::createMatchers(const DocumentDBConfig& new_config_snapshot)
+SearchableDocSubDBConfigurer::createMatchers(const DocumentDBConfig& new_config_snapshot,
+                                             const Matchers* old_matchers)
 {
     auto& schema = new_config_snapshot.getSchemaSP();
     auto& cfg = new_config_snapshot.getRankProfilesConfig();
@@ -121,17 +126,32 @@ SearchableDocSubDBConfigurer::createMatchers(const DocumentDBConfig& new_config_
                                                               new_config_snapshot.getOnnxModelsSP());
     auto newMatchers = std::make_shared<Matchers>(_now_ref, _queryLimiter, ranking_assets_repo_source);
     auto& ranking_assets_repo = newMatchers->get_ranking_assets_repo();
+    size_t reused = 0;
+    size_t lazy = 0;
     for (const auto &profile : cfg.rankprofile) {
         vespalib::string name = profile.name;
         search::fef::Properties properties;
         for (const auto &property : profile.fef.property) {
             properties.add(property.name, property.value);
         }
+        if ((old_matchers != nullptr) && newMatchers->try_reuse(name, properties, *old_matchers)) {
+            ++reused;
+            continue;
+        }
+        if (search::fef::indexproperties::matching::LazySetup::check(properties)) {
+            newMatchers->add_lazy(name, schema, std::move(properties), _distributionKey);
+            ++lazy;
+            continue;
+        }
         // schema instance only used during call.
         auto profptr = std::make_shared<Matcher>(*schema, std::move(properties), _now_ref, _queryLimiter,
                                                  ranking_assets_repo, _distributionKey);
         newMatchers->add(name, std::move(profptr));
     }
+    if ((old_matchers != nullptr) || (lazy > 0)) {
+        LOG(info, "%s: Reused %zu and deferred setup of %zu of %zu rank profiles",
+            _subDbName.c_str(), reused, lazy, cfg.rankprofile.size());
+    }
     return newMatchers;
 }
 
@@ -153,9 +173,15 @@ SearchableDocSubDBConfigurer::prepare_reconfig(const DocumentDBConfig& new_confi
 {
     auto old_matchers = _searchView.get()->getMatchers();
     auto old_attribute_manager = _searchView.get()->getAttributeManager();
-    auto reconfig = std::make_unique<DocumentSubDBReconfig>(std::move(old_matchers), old_attribute_manager);
+    auto reconfig = std::make_unique<DocumentSubDBReconfig>(old_matchers, old_attribute_manager);
     if (reconfig_params.shouldMatchersChange()) {
-        reconfig->set_matchers(createMatchers(new_config_snapshot));
+        // Rank setups depend on the fields in the schema, so only unchanged rank profiles with the same schema can be reused
+        bool reuse = old_matchers && !reconfig_params.shouldSchemaChange();
+        auto new_matchers = createMatchers(new_config_snapshot, reuse ? old_matchers.get() : nullptr);
+        if (old_matchers) {
+            new_matchers->share_term_stats(*old_matchers);
+        }
+        reconfig->set_matchers(std::move(new_matchers));
     }
     if (reconfig_params.shouldAttributeManagerChange()) {
         auto attr_spec = attr_spec_factory.create(new_config_snapshot.getAttributesConfig(), docid_limit, serial_num);
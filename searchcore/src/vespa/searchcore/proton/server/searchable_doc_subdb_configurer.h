@@ -77,7 +77,13 @@ public:
                                  uint32_t distributionKey);
     ~SearchableDocSubDBConfigurer();
 
-    std::shared_ptr<Matchers> createMatchers(const DocumentDBConfig& new_config_snapshot);
+    /**
+     * Create matchers for all rank profiles in the given config. Matchers in
+     * old_matchers (if given) are reused for rank profiles that are unchanged.
+     * Only pass old matchers set up with the same schema.
+     */
+    std::shared_ptr<Matchers> createMatchers(const DocumentDBConfig& new_config_snapshot,
+                                             const Matchers* old_matchers = nullptr);
 
     void reconfigureIndexSearchable();
 
@@ -321,6 +321,13 @@ SearchableDocSubDB::getMatcherStats(const vespalib::string &rankProfile) const
     return _rSearchView.get()->getMatcherStats(rankProfile);
 }
 
+std::shared_ptr<Matchers>
+SearchableDocSubDB::getMatchers() const
+{
+    auto search_view = _rSearchView.get();
+    return search_view ? search_view->getMatchers() : std::shared_ptr<Matchers>();
+}
+
 void
 SearchableDocSubDB::close()
 {
@@ -24,10 +24,18 @@ uint32_t SearchContext::getDocIdLimit()
     return _docIdLimit;
 }
 
-SearchContext::SearchContext(const std::shared_ptr<IndexSearchable> &indexSearchable, uint32_t docIdLimit)
+const matching::TermStatsCache *
+SearchContext::getTermStats()
+{
+    return _termStats.get();
+}
+
+SearchContext::SearchContext(const std::shared_ptr<IndexSearchable> &indexSearchable, uint32_t docIdLimit,
+                             std::shared_ptr<const matching::TermStatsCache> termStats)
     : _indexSearchable(indexSearchable),
       _attributeBlueprintFactory(),
-      _docIdLimit(docIdLimit)
+      _docIdLimit(docIdLimit),
+      _termStats(std::move(termStats))
 {
 }
 
@@ -19,13 +19,17 @@ private:
     std::shared_ptr<IndexSearchable>  _indexSearchable;
     search::AttributeBlueprintFactory _attributeBlueprintFactory;
     uint32_t                          _docIdLimit;
+    /// Global term statistics, may be nullptr.
+    std::shared_ptr<const matching::TermStatsCache> _termStats;
 
     IndexSearchable &getIndexes() override;
     Searchable &getAttributes() override;
     uint32_t getDocIdLimit() override;
+    const matching::TermStatsCache *getTermStats() override;
 
 public:
-    SearchContext(const std::shared_ptr<IndexSearchable> &indexSearchable, uint32_t docIdLimit);
+    SearchContext(const std::shared_ptr<IndexSearchable> &indexSearchable, uint32_t docIdLimit,
+                  std::shared_ptr<const matching::TermStatsCache> termStats = {});
     ~SearchContext() override;
 };
 
@@ -124,11 +124,10 @@ SearchView::getDocsumsInternal(const DocsumRequest & req)
     uint64_t startGeneration = readGuard->get().getCurrentGeneration();
 
     convertGidsToLids(req, metaStore, _matchView->getDocIdLimit().get());
-    auto store(_summarySetup->createDocsumStore());
     auto mctx = _matchView->createContext();
-    auto ctx = std::make_unique<DocsumContext>(req, _summarySetup->getDocsumWriter(), *store, _matchView->getMatcher(req.ranking),
+    auto ctx = std::make_unique<DocsumContext>(req, *_summarySetup, _matchView->getMatcher(req.ranking),
                                                mctx.getSearchContext(), mctx.getAttributeContext(),
-                                               *_summarySetup->getAttributeManager(), getSessionManager());
+                                               *_summarySetup->getAttributeManager(), getSessionManager(), &metaStore);
     SearchView::InternalDocsumReply reply(ctx->getDocsums(), true);
     uint64_t endGeneration = readGuard->get().getCurrentGeneration();
     if (startGeneration != endGeneration) {
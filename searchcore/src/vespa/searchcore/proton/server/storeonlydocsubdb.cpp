@@ -261,7 +261,9 @@ createDocumentMetaStoreInitializer(const AllocStrategy& alloc_strategy,
     // initializers to get hold of document meta store instance in
     // their constructors.
     *result = std::make_shared<DocumentMetaStoreInitializerResult>
-              (std::make_shared<DocumentMetaStore>(_bucketDB, attrFileName, grow, _subDbType), tuneFile);
+              (std::make_shared<DocumentMetaStore>(_bucketDB, attrFileName, grow, _subDbType,
+                                                   alloc_strategy.get_gid_hash_index(),
+                                                   alloc_strategy.get_bucket_timestamp_index()), tuneFile);
     return std::make_shared<documentmetastore::DocumentMetaStoreInitializer>
         (baseDir, getSubDbName(), _docTypeName.toString(), (*result)->documentMetaStore());
 }
@@ -563,6 +565,12 @@ StoreOnlyDocSubDB::getMatcherStats(const vespalib::string &rankProfile) const
     return {};
 }
 
+std::shared_ptr<Matchers>
+StoreOnlyDocSubDB::getMatchers() const
+{
+    return {};
+}
+
 void
 StoreOnlyDocSubDB::close()
 {
@@ -14,6 +14,8 @@
 #include <vespa/document/repo/documenttyperepo.h>
 #include <vespa/document/datatype/documenttype.h>
 #include <vespa/document/fieldvalue/document.h>
+#include <vespa/document/update/documentupdate.h>
+#include <vespa/vespalib/objects/nbostream.h>
 #include <vespa/vespalib/util/cpu_usage.h>
 #include <vespa/vespalib/util/destructor_callbacks.h>
 #include <vespa/vespalib/util/exceptions.h>
@@ -56,6 +58,42 @@ createUpdateDoneContext(FeedToken token, IPendingLidTracker::Token uncommitted,
     return std::make_shared<UpdateDoneContext>(std::move(token), std::move(uncommitted), upd);
 }
 
+/*
+ * Serialized values of the fields touched by the given update, used to
+ * detect updates that leave the document unchanged. Returns an empty
+ * vector if that can not be determined (field path updates).
+ */
+std::vector<vespalib::nbostream>
+serializeUpdatedFields(const Document &doc, const DocumentUpdate &upd)
+{
+    std::vector<vespalib::nbostream> result;
+    if (!upd.getFieldPathUpdates().empty()) {
+        return result;
+    }
+    result.reserve(upd.getUpdates().size());
+    for (const auto &fieldUpdate : upd.getUpdates()) {
+        auto value = doc.getValue(fieldUpdate.getField());
+        result.push_back(value ? value->serialize() : vespalib::nbostream());
+    }
+    return result;
+}
+
+bool
+sameSerializedFields(const std::vector<vespalib::nbostream> &lhs, const std::vector<vespalib::nbostream> &rhs)
+{
+    if (lhs.empty() || (lhs.size() != rhs.size())) {
+        return false;
+    }
+    for (size_t i = 0; i < lhs.size(); ++i) {
+        if ((lhs[i].size() != rhs[i].size()) ||
+            (memcmp(lhs[i].peek(), rhs[i].peek(), lhs[i].size()) != 0))
+        {
+            return false;
+        }
+    }
+    return true;
+}
+
 void setPrev(DocumentOperation &op, const documentmetastore::IStore::Result &result,
              uint32_t subDbId, bool markedAsRemoved)
 {
@@ -228,6 +266,11 @@ StoreOnlyFeedView::forceCommit(const CommitParam & param, DoneCallback onDone)
                                                                     onDone));
 }
 
+void
+StoreOnlyFeedView::dispatchPendingUpdates()
+{
+}
+
 void
 StoreOnlyFeedView::internalForceCommit(const CommitParam & param, OnForceCommitDoneType onCommitDone)
 {
@@ -513,8 +556,14 @@ StoreOnlyFeedView::makeUpdatedDocument(bool useDocStore, Lid lid, const Document
         if (update.getId() == prevDoc->getId()) {
             newDoc = std::move(prevDoc);
             if (useDocStore) {
+                auto before = serializeUpdatedFields(*newDoc, update);
                 update.applyTo(*newDoc);
-                newDoc->serialize(newStream);
+                if (sameSerializedFields(before, serializeUpdatedFields(*newDoc, update))) {
+                    // Update did not change the document, no need to rewrite it in the document store.
+                    LOG(spam, "makeUpdatedDocument: lid(%u) unchanged, skipping document store write", lid);
+                } else {
+                    newDoc->serialize(newStream);
+                }
             }
         } else {
             // Replaying, document removed and lid reused before summary
@@ -220,6 +220,7 @@ public:
     void handleMove(const MoveOperation &putOp, DoneCallback doneCtx) override;
     void heartBeat(search::SerialNum serialNum, DoneCallback onDone) override;
     void forceCommit(const CommitParam & param, DoneCallback onDone) override;
+    void dispatchPendingUpdates() override;
 
     /**
      * Prune lids present in operation.  Caller must call doneSegment()
@@ -93,6 +93,9 @@ struct DummyDocumentSubDb : public IDocumentSubDB
     matching::MatchingStats getMatcherStats(const vespalib::string &) const override {
         return matching::MatchingStats();
     }
+    std::shared_ptr<Matchers> getMatchers() const override {
+        return {};
+    }
     std::shared_ptr<IDocumentDBReference> getDocumentDBReference() override {
         return std::shared_ptr<IDocumentDBReference>();
     }
@@ -33,6 +33,7 @@ struct DummyFeedView : public IFeedView
     void handlePruneRemovedDocuments(const PruneRemovedDocumentsOperation &, DoneCallback) override {}
     void handleCompactLidSpace(const CompactLidSpaceOperation &, DoneCallback) override {}
     void forceCommit(const CommitParam &, DoneCallback) override { }
+    void dispatchPendingUpdates() override { }
 };
 
 }
@@ -0,0 +1,76 @@
+// Copyright Vespa.ai. Licensed under the terms of the Apache 2.0 license. See LICENSE in the project root.
+
+#include <vespa/searchlib/attribute/array_iterator.h>
+#include <vespa/vespalib/gtest/gtest.h>
+#include <vector>
+
+using search::AttributePosting;
+using search::ArrayIterator;
+
+namespace {
+
+std::vector<AttributePosting> make_postings(uint32_t count, uint32_t stride)
+{
+    std::vector<AttributePosting> postings;
+    for (uint32_t i = 0; i < count; ++i) {
+        postings.emplace_back(1 + i * stride, vespalib::btree::BTreeNoLeafData());
+    }
+    return postings;
+}
+
+uint32_t expected_key(const std::vector<AttributePosting> &postings, uint32_t docid)
+{
+    for (const auto &posting : postings) {
+        if (posting._key >= docid) {
+            return posting._key;
+        }
+    }
+    return 0;
+}
+
+}
+
+TEST(ArrayIteratorTest, seek_finds_first_key_not_less_than_docid)
+{
+    for (uint32_t count : {0u, 1u, 7u, 8u, 9u, 100u, 1000u}) {
+        SCOPED_TRACE("count=" + std::to_string(count));
+        auto postings = make_postings(count, 3);
+        uint32_t limit = 1 + count * 3 + 2;
+        for (uint32_t stride : {1u, 2u, 5u, 40u, 1000u}) {
+            ArrayIterator<AttributePosting> itr;
+            itr.set(postings.data(), postings.data() + postings.size());
+            for (uint32_t docid = 1; docid < limit; docid += stride) {
+                itr.linearSeek(docid);
+                uint32_t expect = expected_key(postings, docid);
+                if (expect == 0) {
+                    EXPECT_FALSE(itr.valid());
+                    break;
+                }
+                ASSERT_TRUE(itr.valid());
+                EXPECT_EQ(expect, itr.getKey());
+            }
+        }
+    }
+}
+
+TEST(ArrayIteratorTest, gallop_seek_handles_all_targets)
+{
+    auto postings = make_postings(300, 2);
+    for (uint32_t start = 0; start < postings.size(); start += 37) {
+        for (uint32_t docid = postings[start]._key; docid < 605; docid += 7) {
+            ArrayIterator<AttributePosting> itr;
+            itr.set(postings.data(), postings.data() + postings.size());
+            itr.linearSeek(postings[start]._key);
+            itr.gallopSeek(docid);
+            uint32_t expect = expected_key(postings, docid);
+            if (expect == 0) {
+                EXPECT_FALSE(itr.valid());
+            } else {
+                ASSERT_TRUE(itr.valid());
+                EXPECT_EQ(expect, itr.getKey());
+            }
+        }
+    }
+}
+
+GTEST_MAIN_RUN_ALL_TESTS()
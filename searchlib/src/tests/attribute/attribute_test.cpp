@@ -3,11 +3,14 @@
 #include <vespa/searchlib/attribute/address_space_components.h>
 #include <vespa/searchlib/attribute/attribute.h>
 #include <vespa/searchlib/attribute/attributefactory.h>
+#include <vespa/searchlib/attribute/attributefilesavetarget.h>
 #include <vespa/searchlib/attribute/attributeguard.h>
 #include <vespa/searchlib/attribute/attributememorysavetarget.h>
+#include <vespa/searchlib/attribute/attributesaver.h>
 #include <vespa/searchlib/attribute/multistringattribute.h>
 #include <vespa/searchlib/attribute/predicate_attribute.h>
 #include <vespa/searchlib/attribute/singlestringattribute.h>
+#include <vespa/searchlib/common/serialnumfileheadercontext.h>
 #include <vespa/searchlib/index/dummyfileheadercontext.h>
 #include <vespa/searchlib/test/weighted_type_test_utils.h>
 #include <vespa/searchlib/util/randomgenerator.h>
@@ -290,6 +293,8 @@ protected:
 
     int test_paged_attribute(const vespalib::string& name, const vespalib::string& swapfile, const search::attribute::Config& cfg);
     void test_paged_attributes();
+    void test_paged_single_value_attribute_load();
+    void test_delta_save();
 
 public:
     AttributeTest();
@@ -941,8 +946,8 @@ AttributeTest::testSingle()
         {
             AttributePtr ptr = createAttribute("sv-string", Config(BasicType::STRING, CollectionType::SINGLE));
             ptr->updateStat(true);
-            EXPECT_EQ(116528u + sizeof_large_string_entry, ptr->getStatus().getAllocated());
-            EXPECT_EQ(52844u + sizeof_large_string_entry, ptr->getStatus().getUsed());
+            EXPECT_EQ(116684u + sizeof_large_string_entry, ptr->getStatus().getAllocated());
+            EXPECT_EQ(53524u + sizeof_large_string_entry, ptr->getStatus().getUsed());
             addDocs(ptr, numDocs);
             testSingle<StringAttribute, string, string>(ptr, values);
         }
@@ -951,8 +956,8 @@ AttributeTest::testSingle()
             cfg.setFastSearch(true);
             AttributePtr ptr = createAttribute("sv-fs-string", cfg);
             ptr->updateStat(true);
-            EXPECT_EQ(344848u + sizeof_large_string_entry, ptr->getStatus().getAllocated());
-            EXPECT_EQ(104556u + sizeof_large_string_entry, ptr->getStatus().getUsed());
+            EXPECT_EQ(345004u + sizeof_large_string_entry, ptr->getStatus().getAllocated());
+            EXPECT_EQ(105236u + sizeof_large_string_entry, ptr->getStatus().getUsed());
             addDocs(ptr, numDocs);
             testSingle<StringAttribute, string, string>(ptr, values);
         }
@@ -1134,8 +1139,8 @@ AttributeTest::testArray()
         {
             AttributePtr ptr = createAttribute("a-string", Config(BasicType::STRING, CollectionType::ARRAY));
             ptr->updateStat(true);
-            EXPECT_EQ(410256u + sizeof_large_string_entry, ptr->getStatus().getAllocated());
-            EXPECT_EQ(308936u + sizeof_large_string_entry, ptr->getStatus().getUsed());
+            EXPECT_EQ(410412u + sizeof_large_string_entry, ptr->getStatus().getAllocated());
+            EXPECT_EQ(309616u + sizeof_large_string_entry, ptr->getStatus().getUsed());
             addDocs(ptr, numDocs);
             testArray<StringAttribute, string>(ptr, values);
         }
@@ -1144,8 +1149,8 @@ AttributeTest::testArray()
             cfg.setFastSearch(true);
             AttributePtr ptr = createAttribute("afs-string", cfg);
             ptr->updateStat(true);
-            EXPECT_EQ(660464u + sizeof_large_string_entry, ptr->getStatus().getAllocated());
-            EXPECT_EQ(360668u + sizeof_large_string_entry, ptr->getStatus().getUsed());
+            EXPECT_EQ(660620u + sizeof_large_string_entry, ptr->getStatus().getAllocated());
+            EXPECT_EQ(361348u + sizeof_large_string_entry, ptr->getStatus().getUsed());
             addDocs(ptr, numDocs);
             testArray<StringAttribute, string>(ptr, values);
         }
@@ -2407,6 +2412,111 @@ AttributeTest::test_paged_attributes()
     fs::remove_all(fs::path(basedir));
 }
 
+void
+AttributeTest::test_paged_single_value_attribute_load()
+{
+    vespalib::string basedir("mmap-file-allocator-factory-dir");
+    vespalib::alloc::MmapFileAllocatorFactory::instance().setup(basedir);
+    search::attribute::Config cfg(BasicType::INT64, CollectionType::SINGLE);
+    cfg.setPaged(true);
+    constexpr uint32_t num_docs = 5000;
+    {
+        auto av = createAttribute("int64-sv-paged", cfg);
+        addClearedDocs(av, num_docs);
+        auto &v = dynamic_cast<IntegerAttribute &>(*av);
+        for (uint32_t lid = 1; lid < num_docs; ++lid) {
+            EXPECT_TRUE(v.update(lid, lid * 7));
+        }
+        av->commit();
+        EXPECT_TRUE(av->save());
+    }
+    {
+        // Values are used directly from the mapped .dat file, updates are kept in memory
+        auto av = createAttribute("int64-sv-paged", cfg);
+        EXPECT_TRUE(av->load());
+        EXPECT_EQ(num_docs, av->getNumDocs());
+        EXPECT_EQ(7, av->getInt(1));
+        EXPECT_EQ(7 * int64_t(num_docs - 1), av->getInt(num_docs - 1));
+        auto &v = dynamic_cast<IntegerAttribute &>(*av);
+        EXPECT_TRUE(v.update(10, 3));
+        av->commit();
+        EXPECT_EQ(3, av->getInt(10));
+        // Growing the lid space moves the values out of the mapping
+        AttributeVector::DocId docId;
+        EXPECT_TRUE(av->addDoc(docId));
+        EXPECT_EQ(num_docs, docId);
+        EXPECT_TRUE(v.update(docId, 11));
+        av->commit();
+        EXPECT_EQ(3, av->getInt(10));
+        EXPECT_EQ(77, av->getInt(11));
+        EXPECT_EQ(11, av->getInt(docId));
+        EXPECT_TRUE(av->save());
+    }
+    {
+        auto av = createAttribute("int64-sv-paged", cfg);
+        EXPECT_TRUE(av->load());
+        EXPECT_EQ(num_docs + 1, av->getNumDocs());
+        EXPECT_EQ(3, av->getInt(10));
+        EXPECT_EQ(77, av->getInt(11));
+        EXPECT_EQ(11, av->getInt(num_docs));
+    }
+    vespalib::alloc::MmapFileAllocatorFactory::instance().setup("");
+    fs::remove_all(fs::path(basedir));
+}
+
+void
+AttributeTest::test_delta_save()
+{
+    search::attribute::Config cfg(BasicType::INT32, CollectionType::SINGLE);
+    cfg.set_max_delta_saves(2);
+    constexpr uint32_t num_docs = 5000;
+    auto save_delta = [](AttributeVector &av, uint32_t k, uint64_t serial_num, size_t max_size) {
+        av.commit(CommitParam(serial_num));
+        auto saver = av.init_delta_save(baseFileName("int32-sv-delta") + ".delta." + std::to_string(k), max_size);
+        if (!saver) {
+            return false;
+        }
+        search::common::SerialNumFileHeaderContext header_context(DummyFileHeaderContext(), serial_num);
+        AttributeFileSaveTarget save_target(TuneFileAttributes(), header_context);
+        return saver->save(save_target);
+    };
+    {
+        auto av = createAttribute("int32-sv-delta", cfg);
+        addClearedDocs(av, num_docs);
+        auto &v = dynamic_cast<IntegerAttribute &>(*av);
+        for (uint32_t lid = 1; lid < num_docs; ++lid) {
+            EXPECT_TRUE(v.update(lid, lid));
+        }
+        av->commit(CommitParam(10));
+        EXPECT_EQ(0u, av->get_delta_save_base_serial_num());
+        EXPECT_TRUE(av->save());
+        EXPECT_EQ(10u, av->get_delta_save_base_serial_num());
+        EXPECT_TRUE(v.update(1, 100));
+        EXPECT_TRUE(v.update(4000, 200));
+        // Too large delta, changes are kept for the next delta save
+        EXPECT_FALSE(save_delta(*av, 1, 11, 100));
+        EXPECT_EQ(10u, av->get_delta_save_base_serial_num());
+        EXPECT_TRUE(save_delta(*av, 1, 12, 16_Ki));
+        EXPECT_EQ(12u, av->get_delta_save_base_serial_num());
+        EXPECT_TRUE(v.update(4000, 300));
+        AttributeVector::DocId docId;
+        EXPECT_TRUE(av->addDoc(docId));
+        EXPECT_TRUE(v.update(docId, 400));
+        EXPECT_TRUE(save_delta(*av, 2, 13, 16_Ki));
+    }
+    {
+        auto av = createAttribute("int32-sv-delta", cfg);
+        EXPECT_TRUE(av->load());
+        EXPECT_EQ(num_docs + 1, av->getNumDocs());
+        EXPECT_EQ(100, av->getInt(1));
+        EXPECT_EQ(2, av->getInt(2));
+        EXPECT_EQ(300, av->getInt(4000));
+        EXPECT_EQ(4001, av->getInt(4001));
+        EXPECT_EQ(400, av->getInt(num_docs));
+        EXPECT_EQ(13u, av->get_delta_save_base_serial_num());
+    }
+}
+
 void testNamePrefix() {
     Config cfg(BasicType::INT32, CollectionType::SINGLE);
     AttributeVector::SP vFlat = createAttribute("sfsint32_pc", cfg);
@@ -2559,6 +2669,16 @@ TEST_F(AttributeTest, paged_attributes)
     test_paged_attributes();
 }
 
+TEST_F(AttributeTest, paged_single_value_attribute_is_loaded_from_mapped_file)
+{
+    test_paged_single_value_attribute_load();
+}
+
+TEST_F(AttributeTest, delta_saves_are_applied_on_load)
+{
+    test_delta_save();
+}
+
 }
 
 void
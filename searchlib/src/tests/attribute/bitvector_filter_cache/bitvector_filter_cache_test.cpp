@@ -0,0 +1,295 @@
+// Copyright Vespa.ai. Licensed under the terms of the Apache 2.0 license. See LICENSE in the project root.
+
+#include <vespa/searchcommon/attribute/config.h>
+#include <vespa/searchcommon/attribute/search_context_params.h>
+#include <vespa/searchlib/attribute/attributefactory.h>
+#include <vespa/searchlib/attribute/bitvector_filter_cache.h>
+#include <vespa/searchlib/attribute/search_context.h>
+#include <vespa/searchlib/attribute/stringbase.h>
+#include <vespa/searchlib/common/bitvector.h>
+#include <vespa/searchlib/common/compressedbitvector.h>
+#include <vespa/searchlib/fef/termfieldmatchdata.h>
+#include <vespa/searchlib/query/query_term_simple.h>
+#include <vespa/searchlib/queryeval/executeinfo.h>
+#include <vespa/searchlib/queryeval/searchiterator.h>
+#include <vespa/vespalib/gtest/gtest.h>
+#include <vespa/vespalib/util/size_literals.h>
+#include <algorithm>
+
+using search::AttributeFactory;
+using search::AttributeVector;
+using search::BitVector;
+using search::QueryTermSimple;
+using search::StringAttribute;
+using search::attribute::BasicType;
+using search::attribute::BitVectorFilterCache;
+using search::attribute::CollectionType;
+using search::attribute::Config;
+using search::attribute::SearchContextParams;
+using search::fef::TermFieldMatchData;
+using search::queryeval::ExecuteInfo;
+
+using DocIds = std::vector<uint32_t>;
+
+using BitVectorSP = BitVectorFilterCache::BitVectorSP;
+
+namespace {
+
+constexpr uint32_t docid_limit = 1000;
+// Room for two entries
+const size_t max_bytes = 2 * BitVector::numBytes(docid_limit) + 150;
+
+// Dense enough to never be compressed
+BitVectorSP
+make_bv()
+{
+    BitVectorSP bv = BitVector::create(docid_limit);
+    bv->setInterval(1, docid_limit);
+    bv->invalidateCachedCount();
+    return bv;
+}
+
+}
+
+class BitVectorFilterCacheTest : public ::testing::Test {
+protected:
+    BitVectorFilterCache cache;
+
+    BitVectorFilterCacheTest()
+        : ::testing::Test(),
+          cache(max_bytes)
+    {
+    }
+    ~BitVectorFilterCacheTest() override;
+
+    // Insert until admitted, returning the number of attempts
+    uint32_t insert_until_admitted(const vespalib::string &term, uint64_t generation, size_t cost, BitVectorSP bv) {
+        uint32_t attempts = 1;
+        while (!cache.insert(term, generation, docid_limit, cost, bv)) {
+            ++attempts;
+        }
+        return attempts;
+    }
+};
+
+BitVectorFilterCacheTest::~BitVectorFilterCacheTest() = default;
+
+TEST_F(BitVectorFilterCacheTest, bit_vector_is_admitted_when_term_is_seen_often_enough)
+{
+    auto bv = make_bv();
+    EXPECT_FALSE(cache.insert("foo", 1, docid_limit, docid_limit, bv));
+    EXPECT_FALSE(cache.find("foo", 1, docid_limit));
+    EXPECT_TRUE(cache.insert("foo", 1, docid_limit, docid_limit, bv));
+    EXPECT_EQ(bv, cache.find("foo", 1, docid_limit).bit_vector);
+    auto stats = cache.get_stats();
+    EXPECT_EQ(1u, stats.hits);
+    EXPECT_EQ(2u, stats.misses);
+    EXPECT_EQ(1u, stats.inserts);
+    EXPECT_EQ(1u, stats.elements);
+    EXPECT_LT(0u, stats.memory_used);
+}
+
+TEST_F(BitVectorFilterCacheTest, cheap_terms_must_be_seen_more_often)
+{
+    EXPECT_EQ(BitVectorFilterCache::MIN_SEEN, insert_until_admitted("foo", 1, docid_limit / 2, make_bv()));
+    EXPECT_EQ(10u, insert_until_admitted("bar", 1, docid_limit / 10, make_bv()));
+}
+
+TEST_F(BitVectorFilterCacheTest, bit_vector_is_only_used_for_same_generation_and_docid_limit)
+{
+    auto bv = make_bv();
+    insert_until_admitted("foo", 2, docid_limit, bv);
+    EXPECT_EQ(bv, cache.find("foo", 2, docid_limit).bit_vector);
+    EXPECT_FALSE(cache.find("foo", 1, docid_limit));
+    EXPECT_FALSE(cache.find("foo", 3, docid_limit));
+    EXPECT_FALSE(cache.find("foo", 2, docid_limit + 1));
+}
+
+TEST_F(BitVectorFilterCacheTest, entries_are_dropped_when_inserting_for_newer_generation)
+{
+    insert_until_admitted("foo", 1, docid_limit, make_bv());
+    insert_until_admitted("bar", 2, docid_limit, make_bv());
+    EXPECT_FALSE(cache.find("foo", 1, docid_limit));
+    auto stats = cache.get_stats();
+    EXPECT_EQ(1u, stats.elements);
+    EXPECT_EQ(1u, stats.invalidations);
+    // Bit vectors computed for older generations are not admitted
+    EXPECT_FALSE(cache.insert("baz", 1, docid_limit, docid_limit, make_bv()));
+    EXPECT_FALSE(cache.insert("baz", 1, docid_limit, docid_limit, make_bv()));
+}
+
+TEST_F(BitVectorFilterCacheTest, least_recently_used_entry_is_evicted)
+{
+    auto foo = make_bv();
+    auto bar = make_bv();
+    insert_until_admitted("foo", 1, docid_limit, foo);
+    insert_until_admitted("bar", 1, docid_limit, bar);
+    insert_until_admitted("baz", 1, docid_limit, make_bv());
+    auto stats = cache.get_stats();
+    EXPECT_GE(max_bytes, stats.memory_used);
+    EXPECT_GT(3u, stats.elements);
+    EXPECT_FALSE(cache.find("foo", 1, docid_limit));
+    EXPECT_TRUE(cache.find("baz", 1, docid_limit));
+}
+
+TEST_F(BitVectorFilterCacheTest, found_entry_becomes_most_recently_used)
+{
+    auto foo = make_bv();
+    insert_until_admitted("foo", 1, docid_limit, foo);
+    insert_until_admitted("bar", 1, docid_limit, make_bv());
+    EXPECT_EQ(foo, cache.find("foo", 1, docid_limit).bit_vector);
+    insert_until_admitted("baz", 1, docid_limit, make_bv());
+    EXPECT_EQ(foo, cache.find("foo", 1, docid_limit).bit_vector);
+    EXPECT_FALSE(cache.find("bar", 1, docid_limit));
+    EXPECT_TRUE(cache.find("baz", 1, docid_limit));
+}
+
+TEST(BitVectorFilterCacheCompressionTest, sparse_bit_vector_is_stored_compressed)
+{
+    constexpr uint32_t large_docid_limit = 100000;
+    BitVectorFilterCache large_cache(1_Mi);
+    BitVectorSP sparse = BitVector::create(large_docid_limit);
+    sparse->setBit(10);
+    sparse->setBit(500);
+    sparse->setBit(70000);
+    sparse->invalidateCachedCount();
+    EXPECT_FALSE(large_cache.insert("foo", 1, large_docid_limit, large_docid_limit, sparse));
+    EXPECT_TRUE(large_cache.insert("foo", 1, large_docid_limit, large_docid_limit, sparse));
+    auto cached = large_cache.find("foo", 1, large_docid_limit);
+    EXPECT_EQ(nullptr, cached.bit_vector);
+    ASSERT_NE(nullptr, cached.compressed);
+    EXPECT_EQ(3u, cached.compressed->countTrueBits());
+    EXPECT_TRUE(cached.compressed->testBit(70000));
+    auto stats = large_cache.get_stats();
+    EXPECT_EQ(1u, stats.compressed_elements);
+    EXPECT_GT(BitVector::numBytes(large_docid_limit), stats.memory_used);
+}
+
+TEST_F(BitVectorFilterCacheTest, dense_bit_vector_is_not_compressed)
+{
+    auto bv = make_bv();
+    insert_until_admitted("foo", 1, docid_limit, bv);
+    EXPECT_EQ(bv, cache.find("foo", 1, docid_limit).bit_vector);
+    EXPECT_EQ(nullptr, cache.find("foo", 1, docid_limit).compressed);
+    EXPECT_EQ(0u, cache.get_stats().compressed_elements);
+}
+
+TEST_F(BitVectorFilterCacheTest, disabling_cache_drops_entries)
+{
+    insert_until_admitted("foo", 1, docid_limit, make_bv());
+    EXPECT_TRUE(cache.enabled());
+    cache.set_max_bytes(0);
+    EXPECT_FALSE(cache.enabled());
+    EXPECT_FALSE(cache.find("foo", 1, docid_limit));
+    EXPECT_FALSE(cache.insert("foo", 1, docid_limit, docid_limit, make_bv()));
+    EXPECT_FALSE(cache.insert("foo", 1, docid_limit, docid_limit, make_bv()));
+    EXPECT_EQ(0u, cache.get_stats().memory_used);
+}
+
+// Every 40th document has one of two sparse values
+constexpr uint32_t large_docid_limit = 100000;
+constexpr uint32_t sparse_stride = 40;
+
+class FilterCacheSearchContextTest : public ::testing::Test {
+protected:
+    std::shared_ptr<AttributeVector> attr;
+
+    explicit FilterCacheSearchContextTest(uint32_t num_docs = docid_limit)
+        : ::testing::Test(),
+          attr()
+    {
+        Config cfg(BasicType::STRING, CollectionType::ARRAY, true);
+        cfg.set_filter_cache_max_bytes(1_Mi);
+        attr = AttributeFactory::createAttribute("tags", cfg);
+        attr->addDocs(num_docs);
+        auto &string_attr = dynamic_cast<StringAttribute &>(*attr);
+        for (uint32_t docid = 1; docid < num_docs; ++docid) {
+            string_attr.append(docid, "foo" + std::to_string(docid % 10), 1);
+            string_attr.append(docid, "bar", 1);
+            if (docid % sparse_stride == 0) {
+                string_attr.append(docid, "rare" + std::to_string(docid % 2), 1);
+            }
+        }
+        attr->commit();
+    }
+    ~FilterCacheSearchContextTest() override;
+
+    DocIds search_prefix(const vespalib::string &prefix) const {
+        auto ctx = attr->getSearch(std::make_unique<QueryTermSimple>(prefix, QueryTermSimple::Type::PREFIXTERM),
+                                   SearchContextParams());
+        ctx->fetchPostings(ExecuteInfo::TRUE);
+        TermFieldMatchData tfmd;
+        auto itr = ctx->createIterator(&tfmd, true);
+        itr->initRange(1, attr->getCommittedDocIdLimit());
+        DocIds result;
+        for (uint32_t docid = itr->seekFirst(1); !itr->isAtEnd(); docid = itr->seekNext(docid + 1)) {
+            result.push_back(docid);
+        }
+        return result;
+    }
+    BitVectorFilterCache::Stats stats() const { return attr->get_filter_cache()->get_stats(); }
+};
+
+FilterCacheSearchContextTest::~FilterCacheSearchContextTest() = default;
+
+TEST_F(FilterCacheSearchContextTest, repeated_prefix_search_is_served_from_cache)
+{
+    auto exp = search_prefix("foo");
+    EXPECT_EQ(docid_limit - 1, exp.size());
+    EXPECT_EQ(exp, search_prefix("foo"));
+    EXPECT_EQ(0u, stats().hits);
+    EXPECT_EQ(1u, stats().inserts);
+    EXPECT_EQ(exp, search_prefix("foo"));
+    EXPECT_EQ(1u, stats().hits);
+    EXPECT_EQ(2u, stats().misses);
+    EXPECT_EQ(1u, stats().elements);
+}
+
+TEST_F(FilterCacheSearchContextTest, cached_bit_vector_is_not_used_after_generation_change)
+{
+    search_prefix("foo");
+    search_prefix("foo");
+    EXPECT_EQ(1u, stats().inserts);
+    attr->clearDoc(5);
+    attr->commit();
+    auto result = search_prefix("foo");
+    EXPECT_EQ(docid_limit - 2, result.size());
+    EXPECT_EQ(result.end(), std::find(result.begin(), result.end(), 5u));
+    EXPECT_EQ(0u, stats().hits);
+    EXPECT_EQ(3u, stats().misses);
+    // Admitting the bit vector for the new generation drops the stale entry
+    EXPECT_EQ(result, search_prefix("foo"));
+    EXPECT_EQ(2u, stats().inserts);
+    EXPECT_EQ(1u, stats().invalidations);
+    EXPECT_EQ(1u, stats().elements);
+    EXPECT_EQ(result, search_prefix("foo"));
+    EXPECT_EQ(1u, stats().hits);
+}
+
+class CompressedFilterCacheSearchContextTest : public FilterCacheSearchContextTest {
+protected:
+    CompressedFilterCacheSearchContextTest()
+        : FilterCacheSearchContextTest(large_docid_limit)
+    {
+    }
+    ~CompressedFilterCacheSearchContextTest() override;
+};
+
+CompressedFilterCacheSearchContextTest::~CompressedFilterCacheSearchContextTest() = default;
+
+TEST_F(CompressedFilterCacheSearchContextTest, sparse_prefix_search_is_served_from_compressed_cache_entry)
+{
+    auto exp = search_prefix("rare");
+    EXPECT_EQ((large_docid_limit - 1) / sparse_stride, exp.size());
+    // Sparse terms must be seen more often before they are admitted
+    for (uint32_t i = 0; i < large_docid_limit && stats().inserts == 0; ++i) {
+        EXPECT_EQ(exp, search_prefix("rare"));
+    }
+    EXPECT_EQ(1u, stats().inserts);
+    EXPECT_EQ(1u, stats().compressed_elements);
+    EXPECT_EQ(0u, stats().hits);
+    EXPECT_EQ(exp, search_prefix("rare"));
+    EXPECT_EQ(1u, stats().hits);
+}
+
+GTEST_MAIN_RUN_ALL_TESTS()
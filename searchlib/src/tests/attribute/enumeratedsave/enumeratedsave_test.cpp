@@ -23,6 +23,8 @@
 #include <vespa/vespalib/util/compress.h>
 #include <vespa/vespalib/util/memory.h>
 #include <vespa/vespalib/stllike/asciistream.h>
+#include <filesystem>
+#include <map>
 #include <limits>
 #include <cmath>
 
@@ -91,6 +93,7 @@ private:
     MemAttrFileWriter _idxWriter;
     MemAttrFileWriter _weightWriter;
     MemAttrFileWriter _udatWriter;
+    std::map<vespalib::string, MemAttrFileWriter> _writers;
 
 public:
     using SP = std::shared_ptr<MemAttr>;
@@ -109,13 +112,11 @@ public:
 
     bool setup_writer(const vespalib::string& file_suffix,
                       const vespalib::string& desc) override {
-        (void) file_suffix;
         (void) desc;
-        abort();
+        return _writers.try_emplace(file_suffix).second;
     }
     IAttributeFileWriter& get_writer(const vespalib::string& file_suffix) override {
-        (void) file_suffix;
-        abort();
+        return _writers.at(file_suffix);
     }
 
     bool bufEqual(const Buffer &lhs, const Buffer &rhs) const;
@@ -568,9 +569,12 @@ EnumeratedSaveTest::saveBoth(AttributePtr v)
 {
     EXPECT_TRUE(v->save());
     vespalib::string basename = v->getBaseFileName();
-    AttributePtr v2 = make(v->getConfig(), basename, true);
+    Config cfg(v->getConfig());
+    cfg.set_save_posting_lists(true);
+    AttributePtr v2 = make(cfg, basename, true);
     EXPECT_TRUE(v2->load());
     EXPECT_TRUE(v2->save(basename + "_e"));
+    EXPECT_EQUAL(v2->hasPostings(), std::filesystem::exists(std::filesystem::path(basename + "_e.pst")));
 
     search::AttributeMemorySaveTarget ms;
     search::TuneFileAttributes tune;
@@ -118,6 +118,28 @@ TEST_F("Single-valued integer attribute values can be retrieved via reference",
     EXPECT_EQUAL(5678, f.get_imported_attr()->getInt(DocId(3)));
 }
 
+TEST_F("Batches of single-valued values can be retrieved via reference", Fixture)
+{
+    reset_with_single_value_reference_mappings<IntegerAttribute, int32_t>(
+            f, BasicType::INT32,
+            {{DocId(1), dummy_gid(7), DocId(7), 5678},
+             {DocId(2), dummy_gid(3), DocId(3), 1234},
+             {DocId(4), dummy_gid(7), DocId(7), 5678}});
+
+    auto guard = f.get_imported_attr();
+    std::vector<DocId> docids{DocId(4), DocId(3), DocId(1), DocId(2), DocId(4)};
+    std::vector<IAttributeVector::largeint_t> ints(docids.size());
+    guard->get_ints(docids, ints.data());
+    std::vector<double> floats(docids.size());
+    guard->get_floats(docids, floats.data());
+    for (size_t i = 0; i < docids.size(); ++i) {
+        EXPECT_EQUAL(guard->getInt(docids[i]), ints[i]);
+        EXPECT_EQUAL(guard->getFloat(docids[i]), floats[i]);
+    }
+    EXPECT_EQUAL(5678, ints[0]);
+    EXPECT_EQUAL(1234, ints[3]);
+}
+
 TEST_F("getValueCount() is 1 for mapped single value attribute", Fixture)
 {
     reset_with_single_value_reference_mappings<IntegerAttribute, int32_t>(
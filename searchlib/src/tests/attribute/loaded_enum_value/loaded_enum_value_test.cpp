@@ -0,0 +1,57 @@
+// Copyright Vespa.ai. Licensed under the terms of the Apache 2.0 license. See LICENSE in the project root.
+
+#include <vespa/searchlib/attribute/loadedenumvalue.h>
+#include <vespa/vespalib/gtest/gtest.h>
+#include <vespa/vespalib/util/threadstackexecutor.h>
+#include <random>
+
+using search::attribute::LoadedEnumAttribute;
+using search::attribute::LoadedEnumAttributeVector;
+using search::attribute::sortLoadedByEnum;
+
+namespace {
+
+LoadedEnumAttributeVector
+make_loaded(size_t num_values, uint32_t num_enums, uint32_t seed)
+{
+    std::mt19937 gen(seed);
+    std::uniform_int_distribution<uint32_t> enum_dist(0, num_enums - 1);
+    LoadedEnumAttributeVector loaded;
+    for (size_t i = 0; i < num_values; ++i) {
+        // skewed towards low enum values to get buckets of different sizes
+        uint32_t e = std::min(enum_dist(gen), enum_dist(gen));
+        uint32_t docid = gen() % 100000;
+        // values with equal enum and docid have equal weight, as in arrays
+        loaded.emplace_back(e, docid, int32_t((e + docid) % 7) - 3);
+    }
+    return loaded;
+}
+
+bool
+same(const LoadedEnumAttributeVector &lhs, const LoadedEnumAttributeVector &rhs)
+{
+    return std::equal(lhs.begin(), lhs.end(), rhs.begin(), rhs.end(), [](const auto &a, const auto &b) {
+        return (a.getEnum() == b.getEnum()) && (a.getDocId() == b.getDocId()) && (a.getWeight() == b.getWeight());
+    });
+}
+
+}
+
+TEST(LoadedEnumValueTest, parallel_sort_gives_same_result_as_sequential_sort)
+{
+    vespalib::ThreadStackExecutor executor(4);
+    for (size_t num_values : {0, 1, 5, 1000, 100000}) {
+        for (uint32_t num_enums : {1, 2, 17, 5000}) {
+            for (size_t num_parts : {1, 2, 3, 16}) {
+                SCOPED_TRACE(testing::Message() << "values=" << num_values << ", enums=" << num_enums << ", parts=" << num_parts);
+                auto expect = make_loaded(num_values, num_enums, num_values + num_enums);
+                auto actual = expect;
+                sortLoadedByEnum(expect);
+                sortLoadedByEnum(actual, num_enums, executor, num_parts);
+                EXPECT_TRUE(same(expect, actual));
+            }
+        }
+    }
+}
+
+GTEST_MAIN_RUN_ALL_TESTS()
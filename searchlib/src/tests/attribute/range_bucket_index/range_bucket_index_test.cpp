@@ -0,0 +1,328 @@
+// Copyright Vespa.ai. Licensed under the terms of the Apache 2.0 license. See LICENSE in the project root.
+
+#include <vespa/searchcommon/attribute/config.h>
+#include <vespa/searchlib/attribute/attributefactory.h>
+#include <vespa/searchlib/attribute/integerbase.h>
+#include <vespa/searchlib/attribute/range_bucket_index.h>
+#include <vespa/searchlib/attribute/search_context.h>
+#include <vespa/searchlib/common/bitvector.h>
+#include <vespa/searchlib/fef/termfieldmatchdata.h>
+#include <vespa/searchlib/query/query_term_simple.h>
+#include <vespa/searchlib/queryeval/executeinfo.h>
+#include <vespa/searchlib/queryeval/searchiterator.h>
+#include <vespa/searchcommon/attribute/search_context_params.h>
+#include <vespa/vespalib/gtest/gtest.h>
+#include <limits>
+#include <random>
+
+using search::AttributeFactory;
+using search::AttributeVector;
+using search::BitVector;
+using search::IntegerAttribute;
+using search::QueryTermSimple;
+using search::attribute::BasicType;
+using search::attribute::CollectionType;
+using search::attribute::Config;
+using search::attribute::RangeBucketIndex;
+using search::attribute::SearchContextParams;
+using search::fef::TermFieldMatchData;
+using search::queryeval::ExecuteInfo;
+using vespalib::GenerationHolder;
+
+using DocIds = std::vector<uint32_t>;
+
+namespace {
+
+constexpr int64_t undefined = std::numeric_limits<int64_t>::min();
+
+}
+
+class RangeBucketIndexTest : public ::testing::Test {
+protected:
+    GenerationHolder     gen_holder;
+    RangeBucketIndex     index;
+    std::vector<int64_t> values; // undefined if no value
+
+    RangeBucketIndexTest()
+        : ::testing::Test(),
+          gen_holder(),
+          index(4, 3, undefined, gen_holder),
+          values(1000, undefined)
+    {
+        index.resize(values.size(), values.size());
+    }
+    ~RangeBucketIndexTest() override;
+
+    void set(uint32_t docid, int64_t value) {
+        int64_t old_value = values[docid];
+        values[docid] = value;
+        index.move(docid, (old_value != undefined) ? &old_value : nullptr, &value);
+    }
+    void commit() {
+        index.commit(values.size(), [this](uint32_t docid, int64_t &value) {
+            value = values[docid];
+            return value != undefined;
+        });
+        gen_holder.assign_generation(0);
+        gen_holder.reclaim(1);
+    }
+    DocIds brute_force(int64_t lo, int64_t hi) const {
+        DocIds result;
+        for (uint32_t docid = 0; docid < values.size(); ++docid) {
+            if (values[docid] != undefined && values[docid] >= lo && values[docid] <= hi) {
+                result.push_back(docid);
+            }
+        }
+        return result;
+    }
+    DocIds search(int64_t lo, int64_t hi) const {
+        auto cover = index.cover(lo, hi);
+        auto bv = BitVector::create(values.size());
+        for (const BitVector *bucket : cover.bit_vectors) {
+            bv->orWith(*bucket);
+        }
+        int64_t prev_end = lo - 1;
+        for (const auto &gap : cover.gaps) {
+            EXPECT_LE(lo, gap.first);
+            EXPECT_LE(gap.first, gap.second);
+            EXPECT_LE(gap.second, hi);
+            EXPECT_LT(prev_end, gap.first);
+            prev_end = gap.second;
+            for (uint32_t docid : brute_force(gap.first, gap.second)) {
+                EXPECT_FALSE(bv->testBit(docid));
+                bv->setBit(docid);
+            }
+        }
+        DocIds result;
+        bv->foreach_truebit([&result](uint32_t docid) { result.push_back(docid); });
+        return result;
+    }
+};
+
+RangeBucketIndexTest::~RangeBucketIndexTest()
+{
+    gen_holder.reclaim_all();
+}
+
+TEST_F(RangeBucketIndexTest, dense_bucket_gets_bit_vector)
+{
+    for (uint32_t docid = 1; docid < 128; ++docid) {
+        set(docid, 16 + (docid % 16));
+    }
+    commit();
+    EXPECT_TRUE(index.cover(16, 31).bit_vectors.empty());
+    set(128, 20);
+    commit();
+    auto cover = index.cover(16, 31);
+    ASSERT_EQ(1u, cover.bit_vectors.size());
+    EXPECT_EQ(128u, cover.bit_vectors[0]->countTrueBits());
+    EXPECT_TRUE(cover.gaps.empty());
+    // Buckets must be inside the range
+    cover = index.cover(17, 31);
+    EXPECT_TRUE(cover.bit_vectors.empty());
+    EXPECT_EQ((std::vector<RangeBucketIndex::ValueRange>{{17, 31}}), cover.gaps);
+    cover = index.cover(0, 40);
+    EXPECT_EQ(1u, cover.bit_vectors.size());
+    EXPECT_EQ((std::vector<RangeBucketIndex::ValueRange>{{0, 15}, {32, 40}}), cover.gaps);
+    EXPECT_EQ(brute_force(0, 40), search(0, 40));
+}
+
+TEST_F(RangeBucketIndexTest, sparse_bucket_drops_bit_vector)
+{
+    for (uint32_t docid = 1; docid <= 200; ++docid) {
+        set(docid, 40);
+    }
+    commit();
+    EXPECT_EQ(1u, index.cover(32, 47).bit_vectors.size());
+    for (uint32_t docid = 1; docid <= 136; ++docid) {
+        set(docid, 100);
+    }
+    commit();
+    // 64 documents left is not below the threshold
+    auto cover = index.cover(32, 47);
+    ASSERT_EQ(1u, cover.bit_vectors.size());
+    EXPECT_EQ(64u, cover.bit_vectors[0]->countTrueBits());
+    set(137, 100);
+    commit();
+    EXPECT_TRUE(index.cover(32, 47).bit_vectors.empty());
+    EXPECT_EQ(1u, index.cover(96, 111).bit_vectors.size());
+    EXPECT_EQ(brute_force(0, 200), search(0, 200));
+}
+
+TEST_F(RangeBucketIndexTest, largest_buckets_inside_range_are_used)
+{
+    // 2 documents per value, giving 512 documents per level 1 bucket (256 values)
+    for (uint32_t docid = 1; docid < values.size(); ++docid) {
+        set(docid, docid / 2);
+    }
+    commit();
+    auto cover = index.cover(0, 255);
+    ASSERT_EQ(1u, cover.bit_vectors.size());
+    EXPECT_EQ(511u, cover.bit_vectors[0]->countTrueBits());
+    // Level 0 buckets (16 values) are sparse
+    cover = index.cover(0, 15);
+    EXPECT_TRUE(cover.bit_vectors.empty());
+    cover = index.cover(10, 600);
+    EXPECT_EQ(1u, cover.bit_vectors.size());
+    EXPECT_EQ((std::vector<RangeBucketIndex::ValueRange>{{10, 255}, {512, 600}}), cover.gaps);
+    EXPECT_EQ(brute_force(10, 600), search(10, 600));
+}
+
+TEST_F(RangeBucketIndexTest, default_value_is_not_indexed)
+{
+    RangeBucketIndex zero_default(4, 3, 0, gen_holder);
+    zero_default.resize(values.size(), values.size());
+    int64_t zero = 0;
+    int64_t one = 1;
+    for (uint32_t docid = 1; docid <= 200; ++docid) {
+        zero_default.move(docid, nullptr, (docid % 2) ? &zero : &one);
+    }
+    zero_default.commit(values.size(), [](uint32_t, int64_t &) { return false; });
+    EXPECT_TRUE(zero_default.cover(0, 15).bit_vectors.empty());
+    EXPECT_TRUE(zero_default.cover(0, 4095).bit_vectors.empty());
+}
+
+TEST_F(RangeBucketIndexTest, rebuild_indexes_all_values)
+{
+    for (uint32_t docid = 1; docid < values.size(); ++docid) {
+        values[docid] = docid / 2;
+    }
+    index.rebuild(values.size(), [this](uint32_t docid, int64_t &value) {
+        value = values[docid];
+        return value != undefined;
+    });
+    EXPECT_EQ(1u, index.cover(0, 255).bit_vectors.size());
+    EXPECT_EQ(brute_force(3, 700), search(3, 700));
+    set(1, 700);
+    commit();
+    EXPECT_EQ(brute_force(3, 700), search(3, 700));
+}
+
+TEST_F(RangeBucketIndexTest, result_matches_brute_force_after_random_updates)
+{
+    std::mt19937 gen(42);
+    std::uniform_int_distribution<uint32_t> docid_dist(1, values.size() - 1);
+    std::uniform_int_distribution<int64_t> value_dist(-2000, 2000);
+    uint32_t covered_by_buckets = 0;
+    for (uint32_t round = 0; round < 20; ++round) {
+        for (uint32_t i = 0; i < 300; ++i) {
+            uint32_t docid = docid_dist(gen);
+            // Skew values to get both dense and sparse buckets
+            int64_t value = (i % 3 == 0) ? value_dist(gen) : (value_dist(gen) % 100);
+            set(docid, value);
+        }
+        commit();
+        for (uint32_t i = 0; i < 20; ++i) {
+            int64_t lo = value_dist(gen);
+            int64_t hi = lo + (value_dist(gen) + 2000);
+            SCOPED_TRACE(std::to_string(lo) + "-" + std::to_string(hi));
+            EXPECT_EQ(brute_force(lo, hi), search(lo, hi));
+            covered_by_buckets += index.cover(lo, hi).bit_vectors.empty() ? 0 : 1;
+        }
+    }
+    EXPECT_LT(100u, covered_by_buckets);
+    EXPECT_EQ(brute_force(std::numeric_limits<int64_t>::min() + 1, std::numeric_limits<int64_t>::max()),
+              search(std::numeric_limits<int64_t>::min() + 1, std::numeric_limits<int64_t>::max()));
+}
+
+class RangeBucketAttributeTest : public ::testing::Test {
+protected:
+    std::shared_ptr<AttributeVector> attr;
+    std::vector<int64_t>             values;
+
+    RangeBucketAttributeTest()
+        : ::testing::Test(),
+          attr(),
+          values()
+    {
+        Config cfg(BasicType::INT64, CollectionType::SINGLE, true);
+        cfg.set_range_bucket_levels(3);
+        cfg.set_range_bucket_bits(4);
+        attr = AttributeFactory::createAttribute("timestamp", cfg);
+        attr->addDocs(20000);
+        values.resize(attr->getNumDocs(), undefined);
+    }
+    ~RangeBucketAttributeTest() override;
+
+    void set(uint32_t docid, int64_t value) {
+        auto &int_attr = dynamic_cast<IntegerAttribute &>(*attr);
+        EXPECT_TRUE(int_attr.update(docid, value));
+        values[docid] = value;
+    }
+    void clear(uint32_t docid) {
+        attr->clearDoc(docid);
+        values[docid] = undefined;
+    }
+    DocIds brute_force(int64_t lo, int64_t hi) const {
+        DocIds result;
+        for (uint32_t docid = 1; docid < values.size(); ++docid) {
+            if (values[docid] != undefined && values[docid] >= lo && values[docid] <= hi) {
+                result.push_back(docid);
+            }
+        }
+        return result;
+    }
+    DocIds search(int64_t lo, int64_t hi) const {
+        vespalib::string term = "[" + std::to_string(lo) + ";" + std::to_string(hi) + "]";
+        auto ctx = attr->getSearch(std::make_unique<QueryTermSimple>(term, QueryTermSimple::Type::WORD),
+                                   SearchContextParams());
+        ctx->fetchPostings(ExecuteInfo::TRUE);
+        TermFieldMatchData tfmd;
+        auto itr = ctx->createIterator(&tfmd, true);
+        itr->initRange(1, attr->getCommittedDocIdLimit());
+        DocIds result;
+        for (uint32_t docid = itr->seekFirst(1); !itr->isAtEnd(); docid = itr->seekNext(docid + 1)) {
+            result.push_back(docid);
+        }
+        return result;
+    }
+    size_t buckets_used(int64_t lo, int64_t hi) const {
+        return attr->get_range_bucket_index()->cover(lo, hi).bit_vectors.size();
+    }
+};
+
+RangeBucketAttributeTest::~RangeBucketAttributeTest() = default;
+
+TEST_F(RangeBucketAttributeTest, range_bucket_index_is_only_used_by_single_value_integer_attributes)
+{
+    EXPECT_NE(nullptr, attr->get_range_bucket_index());
+    Config cfg(BasicType::DOUBLE, CollectionType::SINGLE, true);
+    cfg.set_range_bucket_levels(3);
+    EXPECT_EQ(nullptr, AttributeFactory::createAttribute("double", cfg)->get_range_bucket_index());
+    cfg = Config(BasicType::INT64, CollectionType::ARRAY, true);
+    cfg.set_range_bucket_levels(3);
+    EXPECT_EQ(nullptr, AttributeFactory::createAttribute("array", cfg)->get_range_bucket_index());
+    cfg = Config(BasicType::INT64, CollectionType::SINGLE, true);
+    EXPECT_EQ(nullptr, AttributeFactory::createAttribute("disabled", cfg)->get_range_bucket_index());
+}
+
+TEST_F(RangeBucketAttributeTest, range_search_matches_brute_force_while_values_change)
+{
+    std::mt19937 gen(17);
+    std::uniform_int_distribution<uint32_t> docid_dist(1, values.size() - 1);
+    std::uniform_int_distribution<int64_t> value_dist(1700000000, 1700100000);
+    for (uint32_t docid = 1; docid < values.size(); ++docid) {
+        set(docid, value_dist(gen));
+    }
+    attr->commit();
+    EXPECT_LT(0u, buckets_used(1700000000, 1700100000));
+    for (uint32_t round = 0; round < 5; ++round) {
+        for (uint32_t i = 0; i < 2000; ++i) {
+            uint32_t docid = docid_dist(gen);
+            if (i % 10 == 0) {
+                clear(docid);
+            } else {
+                set(docid, value_dist(gen));
+            }
+        }
+        attr->commit();
+        for (uint32_t i = 0; i < 10; ++i) {
+            int64_t lo = value_dist(gen);
+            int64_t hi = lo + (value_dist(gen) - 1700000000) / 2;
+            SCOPED_TRACE(std::to_string(lo) + "-" + std::to_string(hi));
+            EXPECT_EQ(brute_force(lo, hi), search(lo, hi));
+        }
+    }
+}
+
+GTEST_MAIN_RUN_ALL_TESTS()
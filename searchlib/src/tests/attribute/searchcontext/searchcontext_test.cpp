@@ -1420,12 +1420,16 @@ SearchContextTest::testRegexSearch(const vespalib::string& name, const Config& c
     auto attr = AttributeBuilder(name, cfg).
             fill({"abc1def", "abc2Def", "abc2def", "abc4def", "abc5def", "abc6def"}).get();
 
-    std::vector<const char *> terms = { "abc", "bc2de", "^abc1def.*bar" };
+    std::vector<const char *> terms = { "abc", "bc2de", "^abc1def.*bar", "^abc[2-4]d", "^ABC[15]", "^(abc1|abc6)def$", "^abc[^2-5]" };
     std::vector<DocSet> expected;
     DocSet empty;
     expected.emplace_back(DocSet{1, 2, 3, 4, 5, 6}); // "abc"
     expected.emplace_back(DocSet{2, 3});             // "bc2de"
     expected.emplace_back(empty);                    // "^abc1def.*bar"
+    expected.emplace_back(DocSet{2, 3, 4});          // "^abc[2-4]d"
+    expected.emplace_back(DocSet{1, 5});             // "^ABC[15]"
+    expected.emplace_back(DocSet{1, 6});             // "^(abc1|abc6)def$"
+    expected.emplace_back(DocSet{1, 6});             // "^abc[^2-5]"
 
     for (uint32_t i = 0; i < terms.size(); ++i) {
         performSearch(*attr, terms[i], expected[i], TermType::REGEXP);
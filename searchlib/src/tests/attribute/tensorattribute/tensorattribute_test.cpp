@@ -2,6 +2,9 @@
 
 #include <vespa/searchlib/attribute/attribute_read_guard.h>
 #include <vespa/searchlib/attribute/attributeguard.h>
+#include <vespa/searchlib/fef/termfieldmatchdata.h>
+#include <vespa/searchlib/fef/termfieldmatchdataarray.h>
+#include <vespa/searchlib/queryeval/executeinfo.h>
 #include <vespa/searchlib/queryeval/nearest_neighbor_blueprint.h>
 #include <vespa/searchlib/tensor/default_nearest_neighbor_index_factory.h>
 #include <vespa/searchlib/tensor/dense_tensor_attribute.h>
@@ -23,9 +26,11 @@
 #include <vespa/vespalib/test/insertion_operators.h>
 #include <vespa/vespalib/testkit/test_kit.h>
 #include <vespa/vespalib/util/mmap_file_allocator_factory.h>
+#include <vespa/vespalib/util/simple_thread_bundle.h>
 #include <vespa/searchlib/util/bufferwriter.h>
 #include <vespa/vespalib/util/threadstackexecutor.h>
 #include <vespa/document/base/exceptions.h>
+#include <vespa/document/update/tensor_update.h>
 #include <vespa/eval/eval/fast_value.h>
 #include <vespa/eval/eval/simple_value.h>
 #include <vespa/eval/eval/tensor_spec.h>
@@ -297,6 +302,12 @@ public:
         (void) header;
         return std::make_unique<MockIndexLoader>(_index_value, file);
     }
+    std::unique_ptr<NearestNeighborIndexSaver> make_quantized_vectors_saver() const override {
+        return {};
+    }
+    bool load_quantized_vectors(const search::fileutil::LoadedBuffer&) override {
+        return false;
+    }
     std::vector<Neighbor> find_top_k(uint32_t k,
                                      const search::tensor::BoundDistanceFunction &df,
                                      uint32_t explore_k,
@@ -312,7 +323,8 @@ public:
     }
     std::vector<Neighbor> find_top_k_with_filter(uint32_t k,
                                                  const search::tensor::BoundDistanceFunction &df,
-                                                 const GlobalFilter& filter, uint32_t explore_k,
+                                                 const GlobalFilter& filter, bool filter_first,
+                                                 uint32_t explore_k,
                                                  const vespalib::Doom& doom,
                                                  double distance_threshold) const override
     {
@@ -320,6 +332,7 @@ public:
         (void) df;
         (void) explore_k;
         (void) filter;
+        (void) filter_first;
         (void) doom;
         (void) distance_threshold;
         return {};
@@ -532,6 +545,12 @@ struct Fixture {
         _attr->commit();
     }
 
+    void update_tensor(uint32_t docid, const document::TensorUpdate& update) {
+        ensureSpace(docid);
+        _tensorAttr->update_tensor(docid, update, false);
+        _attr->commit();
+    }
+
     generation_t get_current_gen() const {
         return _attr->getCurrentGeneration();
     }
@@ -1142,6 +1161,32 @@ TEST_F("nearest neighbor index is NOT updated when tensor value is unchanged", D
     }
 }
 
+class ReplaceTensorUpdate : public document::TensorUpdate {
+    TensorSpec _spec;
+public:
+    explicit ReplaceTensorUpdate(TensorSpec spec) : _spec(std::move(spec)) {}
+    std::unique_ptr<Value> apply_to(const Value&, const ValueBuilderFactory& factory) const override {
+        return value_from_spec(_spec, factory);
+    }
+};
+
+TEST_F("nearest neighbor index is only updated by update_tensor() when tensor cells change", DenseTensorAttributeMockIndex)
+{
+    auto& index = f.mock_index();
+    f.set_tensor(1, vec_2d(3, 5));
+    index.clear();
+
+    f.update_tensor(1, ReplaceTensorUpdate(vec_2d(3, 5)));
+    index.expect_empty_remove();
+    index.expect_empty_add();
+    f.assertGetTensor(vec_2d(3, 5), 1);
+
+    f.update_tensor(1, ReplaceTensorUpdate(vec_2d(7, 5)));
+    index.expect_remove(1, {3, 5});
+    index.expect_add(1, {7, 5});
+    f.assertGetTensor(vec_2d(7, 5), 1);
+}
+
 TEST_F("clearDoc() updates nearest neighbor index", DenseTensorAttributeMockIndex)
 {
     auto& index = f.mock_index();
@@ -1325,7 +1370,7 @@ public:
             std::make_unique<DistanceCalculator>(this->as_dense_tensor(),
                                                  create_query_tensor(vec_2d(17, 42))),
             3, approximate, 5, 100100.25,
-            global_filter_lower_limit, 1.0, target_hits_max_adjustment_factor, vespalib::Doom::never());
+            global_filter_lower_limit, 1.0, target_hits_max_adjustment_factor, 0.0, vespalib::Doom::never());
         EXPECT_EQUAL(11u, bp->getState().estimate().estHits);
         EXPECT_EQUAL(100100.25 * 100100.25, bp->get_distance_threshold());
         return bp;
@@ -1418,6 +1463,34 @@ TEST_F("NN blueprint handles strong filter triggering exact search", NearestNeig
     EXPECT_EQUAL(NNBA::EXACT_FALLBACK, bp->get_algorithm());
 }
 
+TEST_F("NN blueprint calculates exact top k among documents in strong filter", NearestNeighborBlueprintFixture)
+{
+    auto bp = f.make_blueprint(true, 0.5);
+    auto filter = search::BitVector::create(1,11);
+    filter->setBit(3);
+    filter->setBit(5);
+    filter->setBit(7);
+    filter->setBit(10);
+    filter->invalidateCachedCount();
+    auto strong_filter = GlobalFilter::create(std::move(filter));
+    bp->set_global_filter(*strong_filter, 0.6);
+    EXPECT_EQUAL(NNBA::EXACT_FALLBACK, bp->get_algorithm());
+    vespalib::SimpleThreadBundle thread_bundle(2);
+    bp->fetchPostings(search::queryeval::ExecuteInfo::create(true, 1.0, vespalib::Doom::never(), thread_bundle));
+    search::fef::TermFieldMatchData tfmd;
+    search::fef::TermFieldMatchDataArray tfmda;
+    tfmda.add(&tfmd);
+    auto itr = bp->createLeafSearch(tfmda, true);
+    itr->initRange(1, 11);
+    std::vector<uint32_t> hits;
+    for (uint32_t docid = 1; docid < 11; ++docid) {
+        if (itr->seek(docid)) {
+            hits.push_back(docid);
+        }
+    }
+    EXPECT_EQUAL(std::vector<uint32_t>({3, 5, 7}), hits);
+}
+
 TEST_F("NN blueprint wants global filter when having index", NearestNeighborBlueprintFixture)
 {
     auto bp = f.make_blueprint();
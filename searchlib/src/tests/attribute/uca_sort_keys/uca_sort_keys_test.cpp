@@ -0,0 +1,219 @@
+// Copyright Vespa.ai. Licensed under the terms of the Apache 2.0 license. See LICENSE in the project root.
+
+#include <vespa/searchcommon/attribute/config.h>
+#include <vespa/searchlib/attribute/attributefactory.h>
+#include <vespa/searchlib/attribute/stringbase.h>
+#include <vespa/searchlib/attribute/uca_sort_keys.h>
+#include <vespa/searchlib/common/converters.h>
+#include <vespa/searchlib/uca/ucaconverter.h>
+#include <vespa/vespalib/gtest/gtest.h>
+#include <cstring>
+
+using search::AttributeFactory;
+using search::AttributeVector;
+using search::StringAttribute;
+using search::attribute::BasicType;
+using search::attribute::CollectionType;
+using search::attribute::Config;
+using search::attribute::UcaSortKeyParams;
+using search::attribute::UcaSortKeys;
+using search::common::BlobConverter;
+using search::common::LowercaseConverter;
+using search::uca::UcaConverter;
+using vespalib::ConstBufferRef;
+using vespalib::GenerationHolder;
+
+using Blob = std::vector<uint8_t>;
+
+namespace {
+
+Blob
+to_blob(ConstBufferRef buf)
+{
+    auto data = static_cast<const uint8_t*>(buf.data());
+    return {data, data + buf.size()};
+}
+
+Blob
+convert(const BlobConverter& bc, const char* value)
+{
+    return to_blob(bc.convert(ConstBufferRef(value, strlen(value) + 1)));
+}
+
+}
+
+class UcaSortKeysTest : public ::testing::Test {
+protected:
+    GenerationHolder gen_holder;
+    UcaSortKeys      keys;
+    UcaConverter     converter;
+
+    UcaSortKeysTest()
+        : ::testing::Test(),
+          gen_holder(),
+          keys(UcaSortKeyParams("en", "TERTIARY"), vespalib::GrowStrategy(), gen_holder),
+          converter("en", "TERTIARY")
+    {
+    }
+    ~UcaSortKeysTest() override;
+
+    Blob get(uint32_t docid) { return to_blob(keys.get(docid)); }
+    void reclaim() {
+        keys.assign_generation(1);
+        gen_holder.assign_generation(1);
+        keys.reclaim_memory(2);
+        gen_holder.reclaim(2);
+    }
+};
+
+UcaSortKeysTest::~UcaSortKeysTest()
+{
+    gen_holder.reclaim_all();
+}
+
+TEST_F(UcaSortKeysTest, stored_key_is_collation_key_of_value)
+{
+    keys.set(3, "Banana");
+    EXPECT_EQ(convert(converter, "Banana"), get(3));
+    EXPECT_EQ('\0', get(3).back());
+    keys.set(3, "apple");
+    EXPECT_EQ(convert(converter, "apple"), get(3));
+}
+
+TEST_F(UcaSortKeysTest, no_key_is_stored_for_docs_without_value)
+{
+    keys.set(3, "Banana");
+    EXPECT_EQ(Blob(), get(0));
+    EXPECT_EQ(Blob(), get(2));
+    EXPECT_EQ(Blob(), get(4));
+    EXPECT_EQ(Blob(), get(1000));
+}
+
+TEST_F(UcaSortKeysTest, identical_keys_are_stored_once)
+{
+    keys.set(1, "Banana");
+    keys.set(2, "Banana");
+    keys.set(3, "apple");
+    EXPECT_EQ(2u, keys.get_num_unique_keys());
+    keys.set(2, "apple");
+    EXPECT_EQ(2u, keys.get_num_unique_keys());
+    keys.set(1, "apple");
+    EXPECT_EQ(1u, keys.get_num_unique_keys());
+    reclaim();
+    EXPECT_EQ(convert(converter, "apple"), get(1));
+}
+
+TEST_F(UcaSortKeysTest, shrink_removes_keys_beyond_docid_limit)
+{
+    keys.set(1, "Banana");
+    keys.set(5, "apple");
+    keys.shrink(3);
+    reclaim();
+    EXPECT_EQ(1u, keys.get_num_unique_keys());
+    EXPECT_EQ(convert(converter, "Banana"), get(1));
+    EXPECT_EQ(Blob(), get(5));
+}
+
+TEST_F(UcaSortKeysTest, matches_converter_with_same_locale_and_strength)
+{
+    EXPECT_TRUE(keys.matches(UcaConverter("en", "TERTIARY")));
+    EXPECT_FALSE(keys.matches(UcaConverter("en", "")));
+    EXPECT_FALSE(keys.matches(UcaConverter("en", "PRIMARY")));
+    EXPECT_FALSE(keys.matches(UcaConverter("nb", "TERTIARY")));
+    EXPECT_FALSE(keys.matches(LowercaseConverter()));
+}
+
+TEST(UcaSortKeysParamsTest, empty_strength_matches_primary)
+{
+    GenerationHolder gen_holder;
+    UcaSortKeys keys(UcaSortKeyParams("en", "PRIMARY"), vespalib::GrowStrategy(), gen_holder);
+    EXPECT_TRUE(keys.matches(UcaConverter("en", "")));
+    EXPECT_TRUE(keys.matches(UcaConverter("en", "PRIMARY")));
+}
+
+class UcaSortKeysAttributeTest : public ::testing::TestWithParam<bool> {
+protected:
+    std::shared_ptr<AttributeVector> attr;
+    StringAttribute*                 string_attr;
+
+    UcaSortKeysAttributeTest()
+        : ::testing::TestWithParam<bool>(),
+          attr(),
+          string_attr(nullptr)
+    {
+        Config cfg(BasicType::STRING, CollectionType::SINGLE, GetParam());
+        cfg.set_uca_sort_keys({UcaSortKeyParams("en", "PRIMARY")});
+        attr = AttributeFactory::createAttribute("s", cfg);
+        string_attr = dynamic_cast<StringAttribute*>(attr.get());
+        attr->addReservedDoc();
+        attr->addDocs(10);
+        attr->commit();
+    }
+    ~UcaSortKeysAttributeTest() override;
+
+    void set(uint32_t docid, const vespalib::string& value) {
+        string_attr->update(docid, value);
+        attr->commit();
+    }
+    Blob serialize(uint32_t docid, const BlobConverter& bc, bool asc) {
+        Blob blob(1000);
+        long written = asc
+            ? attr->serializeForAscendingSort(docid, blob.data(), blob.size(), &bc)
+            : attr->serializeForDescendingSort(docid, blob.data(), blob.size(), &bc);
+        EXPECT_GT(written, 0);
+        blob.resize(std::max(0l, written));
+        return blob;
+    }
+    static Blob invert(Blob blob) {
+        for (auto& c : blob) {
+            c = 0xff - c;
+        }
+        return blob;
+    }
+};
+
+UcaSortKeysAttributeTest::~UcaSortKeysAttributeTest() = default;
+
+TEST_P(UcaSortKeysAttributeTest, sort_blobs_match_collated_values)
+{
+    set(1, "Banana");
+    set(2, "apple");
+    set(3, "Banana");
+    set(1, "cherry");
+    string_attr->clearDoc(3);
+    attr->commit();
+    for (auto strength : {"", "PRIMARY", "TERTIARY"}) {
+        UcaConverter converter("en", strength);
+        EXPECT_EQ(convert(converter, "cherry"), serialize(1, converter, true));
+        EXPECT_EQ(convert(converter, "apple"), serialize(2, converter, true));
+        EXPECT_EQ(convert(converter, ""), serialize(3, converter, true));
+        EXPECT_EQ(convert(converter, ""), serialize(4, converter, true));
+        EXPECT_EQ(invert(convert(converter, "cherry")), serialize(1, converter, false));
+        EXPECT_EQ(invert(convert(converter, "apple")), serialize(2, converter, false));
+    }
+}
+
+TEST_P(UcaSortKeysAttributeTest, sort_blobs_match_collated_values_after_shrink_and_regrow)
+{
+    set(8, "Banana");
+    set(9, "apple");
+    string_attr->clearDoc(8);
+    string_attr->clearDoc(9);
+    attr->commit();
+    attr->incGeneration();
+    attr->compactLidSpace(8);
+    attr->commit();
+    attr->incGeneration();
+    attr->shrinkLidSpace();
+    EXPECT_EQ(8u, attr->getNumDocs());
+    attr->addDocs(4);
+    attr->commit();
+    set(9, "cherry");
+    UcaConverter converter("en", "");
+    EXPECT_EQ(convert(converter, ""), serialize(8, converter, true));
+    EXPECT_EQ(convert(converter, "cherry"), serialize(9, converter, true));
+}
+
+INSTANTIATE_TEST_SUITE_P(FastSearch, UcaSortKeysAttributeTest, ::testing::Bool());
+
+GTEST_MAIN_RUN_ALL_TESTS()
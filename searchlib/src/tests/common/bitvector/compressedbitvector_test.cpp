@@ -0,0 +1,167 @@
+// Copyright Vespa.ai. Licensed under the terms of the Apache 2.0 license. See LICENSE in the project root.
+
+#include <vespa/searchlib/common/bitvector.h>
+#include <vespa/searchlib/common/compressedbitvector.h>
+#include <vespa/searchlib/common/compressedbitvectoriterator.h>
+#include <vespa/searchlib/fef/termfieldmatchdata.h>
+#include <vespa/vespalib/gtest/gtest.h>
+#include <random>
+
+using search::BitVector;
+using search::CompressedBitVector;
+using search::CompressedBitVectorIterator;
+using search::fef::TermFieldMatchData;
+
+namespace {
+
+constexpr uint32_t docid_limit = 5 * CompressedBitVector::CHUNK_SIZE + 1234;
+
+// Chunks are dense, sparse or empty depending on chunk number and seed,
+// to get both bitmap and array containers and chunks without containers.
+std::vector<uint32_t>
+make_docids(uint32_t seed)
+{
+    std::mt19937 rnd(seed);
+    std::vector<uint32_t> docids;
+    for (uint32_t docid = 1; docid < docid_limit; ++docid) {
+        uint32_t chunk = docid >> CompressedBitVector::CHUNK_BITS;
+        uint32_t one_in = ((chunk + seed) % 3 == 0) ? 2 : ((chunk + seed) % 3 == 1) ? 50 : 0;
+        if ((one_in != 0) && (rnd() % one_in == 0)) {
+            docids.push_back(docid);
+        }
+    }
+    return docids;
+}
+
+BitVector::UP
+make_bv(const std::vector<uint32_t> &docids)
+{
+    auto bv = BitVector::create(docid_limit);
+    for (uint32_t docid : docids) {
+        bv->setBit(docid);
+    }
+    bv->invalidateCachedCount();
+    return bv;
+}
+
+std::vector<uint32_t>
+as_vector(const CompressedBitVector &cbv)
+{
+    std::vector<uint32_t> result;
+    cbv.foreach_truebit([&result](uint32_t docid) { result.push_back(docid); });
+    return result;
+}
+
+std::vector<uint32_t>
+as_vector(const BitVector &bv)
+{
+    std::vector<uint32_t> result;
+    bv.foreach_truebit([&result](uint32_t docid) { result.push_back(docid); });
+    return result;
+}
+
+}
+
+TEST(CompressedBitVectorTest, empty_vector_has_no_bits_set)
+{
+    CompressedBitVector cbv(docid_limit);
+    EXPECT_EQ(docid_limit, cbv.size());
+    EXPECT_EQ(0u, cbv.countTrueBits());
+    EXPECT_EQ(0u, cbv.numContainers());
+    EXPECT_FALSE(cbv.testBit(7));
+    EXPECT_EQ(docid_limit, cbv.getNextTrueBit(0));
+}
+
+TEST(CompressedBitVectorTest, bits_can_be_tested_and_iterated)
+{
+    auto docids = make_docids(1);
+    auto cbv = CompressedBitVector::create(docids, docid_limit);
+    EXPECT_EQ(docids.size(), cbv.countTrueBits());
+    EXPECT_EQ(4u, cbv.numContainers());
+    EXPECT_EQ(docids, as_vector(cbv));
+    auto bv = make_bv(docids);
+    EXPECT_EQ(cbv, CompressedBitVector::create(*bv));
+    size_t hint = 0;
+    for (uint32_t docid = 0; docid < docid_limit; ++docid) {
+        ASSERT_EQ(bv->testBit(docid), cbv.testBit(docid)) << docid;
+        ASSERT_EQ(std::min(bv->getNextTrueBit(docid), docid_limit), cbv.getNextTrueBit(docid, hint)) << docid;
+    }
+}
+
+TEST(CompressedBitVectorTest, dense_chunks_use_less_memory_than_bitmap)
+{
+    auto docids = make_docids(2);
+    auto cbv = CompressedBitVector::create(docids, docid_limit);
+    EXPECT_GT(BitVector::numBytes(docid_limit), cbv.getMemoryUsage().usedBytes());
+}
+
+TEST(CompressedBitVectorTest, and_and_or_match_bit_vector)
+{
+    auto docids_a = make_docids(3);
+    auto docids_b = make_docids(4);
+    auto bv_and = make_bv(docids_a);
+    auto bv_or = make_bv(docids_a);
+    auto bv_b = make_bv(docids_b);
+    bv_and->andWith(*bv_b);
+    bv_or->orWith(*bv_b);
+    auto cbv_and = CompressedBitVector::create(docids_a, docid_limit);
+    auto cbv_or = cbv_and;
+    auto cbv_b = CompressedBitVector::create(docids_b, docid_limit);
+    cbv_and.andWith(cbv_b);
+    cbv_or.orWith(cbv_b);
+    EXPECT_EQ(as_vector(*bv_and), as_vector(cbv_and));
+    EXPECT_EQ(as_vector(*bv_or), as_vector(cbv_or));
+    EXPECT_EQ(bv_and->countTrueBits(), cbv_and.countTrueBits());
+    EXPECT_EQ(bv_or->countTrueBits(), cbv_or.countTrueBits());
+    EXPECT_EQ(cbv_and, CompressedBitVector::create(*bv_and));
+    EXPECT_EQ(cbv_or, CompressedBitVector::create(*bv_or));
+}
+
+TEST(CompressedBitVectorTest, can_be_or_ed_and_and_ed_into_partial_bit_vector)
+{
+    auto docids_a = make_docids(5);
+    auto docids_b = make_docids(6);
+    auto cbv = CompressedBitVector::create(docids_a, docid_limit);
+    uint32_t begin = CompressedBitVector::CHUNK_SIZE + 1000;
+    uint32_t end = docid_limit - 100;
+    auto all_b = make_bv(docids_b);
+    auto all_a = make_bv(docids_a);
+    auto expect_or = BitVector::create(*all_b, begin, end);
+    auto expect_and = BitVector::create(*all_b, begin, end);
+    expect_or->orWith(*BitVector::create(*all_a, begin, end));
+    expect_and->andWith(*BitVector::create(*all_a, begin, end));
+
+    auto result_or = BitVector::create(*all_b, begin, end);
+    auto result_and = BitVector::create(*all_b, begin, end);
+    cbv.orInto(*result_or);
+    cbv.andInto(*result_and);
+    EXPECT_EQ(as_vector(*expect_or), as_vector(*result_or));
+    EXPECT_EQ(as_vector(*expect_and), as_vector(*result_and));
+    EXPECT_EQ(expect_or->countTrueBits(), result_or->countTrueBits());
+    EXPECT_EQ(expect_and->countTrueBits(), result_and->countTrueBits());
+}
+
+TEST(CompressedBitVectorTest, iterator_finds_same_hits_as_strict_and_non_strict)
+{
+    auto docids = make_docids(7);
+    auto cbv = CompressedBitVector::create(docids, docid_limit);
+    TermFieldMatchData tfmd;
+    for (bool strict : {false, true}) {
+        auto itr = CompressedBitVectorIterator::create(&cbv, docid_limit, tfmd, strict);
+        itr->initRange(1, docid_limit);
+        std::vector<uint32_t> hits;
+        for (uint32_t docid = 1; !itr->isAtEnd(docid); ) {
+            if (itr->seek(docid)) {
+                hits.push_back(docid);
+                itr->unpack(docid);
+                EXPECT_EQ(docid, tfmd.getDocId());
+            }
+            docid = std::max(docid + 1, itr->getDocId());
+        }
+        EXPECT_EQ(docids, hits) << "strict=" << strict;
+        itr->initRange(1, docid_limit);
+        EXPECT_EQ(docids, as_vector(*itr->get_hits(1)));
+    }
+}
+
+GTEST_MAIN_RUN_ALL_TESTS()
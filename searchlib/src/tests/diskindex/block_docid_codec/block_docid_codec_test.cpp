@@ -0,0 +1,132 @@
+// Copyright Vespa.ai. Licensed under the terms of the Apache 2.0 license. See LICENSE in the project root.
+
+#include <vespa/searchlib/diskindex/block_docid_codec.h>
+#include <vespa/vespalib/gtest/gtest.h>
+#include <algorithm>
+#include <random>
+
+using search::diskindex::BlockDocIdDecoder;
+using search::diskindex::BlockDocIdEncoder;
+
+namespace {
+
+constexpr uint32_t BLOCK_SIZE = BlockDocIdEncoder::BLOCK_SIZE;
+
+std::vector<uint32_t>
+make_docids(uint32_t num_docs, uint32_t max_gap, uint32_t seed)
+{
+    std::mt19937 rnd(seed);
+    std::vector<uint32_t> docids;
+    uint32_t docid = 0;
+    for (uint32_t i = 0; i < num_docs; ++i) {
+        docid += 1 + (rnd() % max_gap);
+        docids.push_back(docid);
+    }
+    return docids;
+}
+
+std::vector<uint8_t>
+encode(const std::vector<uint32_t> &docids)
+{
+    std::vector<uint8_t> buf;
+    BlockDocIdEncoder::encode(docids, buf);
+    return buf;
+}
+
+std::vector<uint32_t>
+decode_all(const std::vector<uint8_t> &buf, uint32_t num_docs)
+{
+    BlockDocIdDecoder decoder;
+    decoder.setup(buf.data(), num_docs);
+    std::vector<uint32_t> result;
+    for (uint32_t docid = decoder.seek(0); docid != BlockDocIdDecoder::END; docid = decoder.next()) {
+        result.push_back(docid);
+    }
+    return result;
+}
+
+}
+
+TEST(BlockDocIdCodecTest, blocks_can_be_packed_and_unpacked_for_all_bit_widths)
+{
+    std::mt19937 rnd(42);
+    for (uint32_t bits = 0; bits <= 32; ++bits) {
+        std::vector<uint32_t> values(BLOCK_SIZE);
+        for (auto &value : values) {
+            value = (bits == 0) ? 0 : (rnd() >> (32 - bits));
+        }
+        std::vector<uint32_t> packed(BLOCK_SIZE);
+        std::vector<uint32_t> unpacked(BLOCK_SIZE, 17);
+        BlockDocIdEncoder::pack_block(values.data(), bits, packed.data());
+        BlockDocIdDecoder::unpack_block(packed.data(), bits, unpacked.data());
+        EXPECT_EQ(values, unpacked) << "bits=" << bits;
+    }
+}
+
+TEST(BlockDocIdCodecTest, docids_survive_round_trip)
+{
+    for (uint32_t num_docs : {0u, 1u, BLOCK_SIZE - 1, BLOCK_SIZE, BLOCK_SIZE + 1, 10 * BLOCK_SIZE + 17}) {
+        for (uint32_t max_gap : {1u, 7u, 1000u, 1000000u}) {
+            auto docids = make_docids(num_docs, max_gap, num_docs + max_gap);
+            EXPECT_EQ(docids, decode_all(encode(docids), num_docs)) << "num_docs=" << num_docs << ", max_gap=" << max_gap;
+        }
+    }
+}
+
+TEST(BlockDocIdCodecTest, docid_zero_and_large_docids_are_handled)
+{
+    std::vector<uint32_t> docids;
+    for (uint32_t i = 0; i < BLOCK_SIZE + 3; ++i) {
+        docids.push_back(i * 0x1000000u);
+    }
+    docids.push_back(UINT32_MAX - 1);
+    EXPECT_EQ(docids, decode_all(encode(docids), docids.size()));
+}
+
+TEST(BlockDocIdCodecTest, seek_finds_first_docid_not_below_target)
+{
+    auto docids = make_docids(20 * BLOCK_SIZE + 5, 50, 1);
+    auto buf = encode(docids);
+    for (uint32_t step : {1u, 13u, 700u, 30000u}) {
+        BlockDocIdDecoder decoder;
+        decoder.setup(buf.data(), docids.size());
+        for (uint32_t target = 0; target < docids.back() + 10; target += step) {
+            auto itr = std::lower_bound(docids.begin(), docids.end(), target);
+            uint32_t expected = (itr != docids.end()) ? *itr : BlockDocIdDecoder::END;
+            ASSERT_EQ(expected, decoder.seek(target)) << "target=" << target << ", step=" << step;
+            EXPECT_EQ(expected, decoder.get_docid());
+            if (expected != BlockDocIdDecoder::END) {
+                EXPECT_EQ(itr - docids.begin(), decoder.get_ordinal());
+            }
+        }
+    }
+}
+
+TEST(BlockDocIdCodecTest, encoding_can_start_after_previous_docid)
+{
+    auto docids = make_docids(3 * BLOCK_SIZE + 9, 5, 4);
+    uint32_t prev = 1000000;
+    for (auto &docid : docids) {
+        docid += prev;
+    }
+    std::vector<uint8_t> buf;
+    BlockDocIdEncoder::encode(docids, buf, prev);
+    // The first delta is relative to prev, keeping the first block narrow
+    EXPECT_GT(docids.size() + 100, buf.size());
+    BlockDocIdDecoder decoder;
+    decoder.setup(buf.data(), docids.size(), prev);
+    std::vector<uint32_t> result;
+    for (uint32_t docid = decoder.seek(prev + 1); docid != BlockDocIdDecoder::END; docid = decoder.next()) {
+        result.push_back(docid);
+    }
+    EXPECT_EQ(docids, result);
+}
+
+TEST(BlockDocIdCodecTest, dense_docids_use_few_bits)
+{
+    auto docids = make_docids(100 * BLOCK_SIZE, 2, 3);
+    // 1 bit per docid and a small header per block
+    EXPECT_GT(docids.size() / 8 + 100 * 4, encode(docids).size());
+}
+
+GTEST_MAIN_RUN_ALL_TESTS()
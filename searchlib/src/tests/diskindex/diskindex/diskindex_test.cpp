@@ -17,6 +17,7 @@
 #include <vespa/searchlib/test/fakedata/fpfactory.h>
 #include <vespa/vespalib/gtest/gtest.h>
 #include <vespa/vespalib/stllike/asciistream.h>
+#include <vespa/vespalib/util/size_literals.h>
 #include <filesystem>
 #include <set>
 
@@ -24,6 +25,8 @@ using search::BitVector;
 using search::BitVectorIterator;
 using search::diskindex::DiskIndex;
 using search::diskindex::DiskTermBlueprint;
+using search::diskindex::HotWords;
+using search::diskindex::PostingListCache;
 using search::diskindex::TestDiskIndex;
 using search::diskindex::ZcRareWordPosOccIterator;
 using search::fef::TermFieldMatchDataArray;
@@ -128,6 +131,7 @@ protected:
     void build_index(const IOSettings& io_settings, const EmptySettings& empty_settings);
     void test_empty_settings(const EmptySettings& empty_settings);
     void test_io_settings(const IOSettings& io_settings);
+    void require_that_hot_words_are_recorded_and_prefetched();
 public:
     DiskIndexTest();
     ~DiskIndexTest();
@@ -385,6 +389,25 @@ DiskIndexTest::build_index(const IOSettings& io_settings, const EmptySettings& e
     openIndex(name.str(), io_settings._use_directio, io_settings._use_mmap, empty_settings._empty_field, empty_settings._empty_doc, empty_settings._empty_word);
 }
 
+void
+DiskIndexTest::require_that_hot_words_are_recorded_and_prefetched()
+{
+    auto hot_words = std::make_shared<HotWords>(10);
+    _index->set_hot_words(hot_words);
+    uint32_t f1(_schema.getIndexFieldId("f1"));
+    _index->lookup(std::vector<uint32_t>{f1}, "w1");
+    _index->lookup(std::vector<uint32_t>{f1}, "w1");
+    _index->lookup(std::vector<uint32_t>{f1}, "wnot");
+    auto hottest = hot_words->get_hottest(10);
+    ASSERT_EQ(2u, hottest.size());
+    EXPECT_EQ("f1", hottest[0].field);
+    EXPECT_EQ("w1", hottest[0].word);
+    EXPECT_EQ(2u, hottest[0].count);
+    EXPECT_EQ(1u, _index->prefetch(hottest));
+    EXPECT_EQ(0u, _index->prefetch({HotWords::Entry("unknown", "w1", 1)}));
+    _index->set_hot_words({});
+}
+
 void
 DiskIndexTest::test_empty_settings(const EmptySettings& empty_settings)
 {
@@ -403,6 +426,7 @@ DiskIndexTest::test_io_settings(const IOSettings& io_settings)
     requireThatWeCanReadBitVector();
     requireThatBlueprintIsCreated();
     requireThatBlueprintCanCreateSearchIterators();
+    require_that_hot_words_are_recorded_and_prefetched();
 }
 
 TEST_F(DiskIndexTest, empty_settings_empty_field_empty_doc_empty_word)
@@ -465,6 +489,131 @@ TEST_F(DiskIndexTest, search_iterators_conformance)
     requireThatSearchIteratorsConforms();
 }
 
+TEST(HotWordsTest, hottest_words_are_ordered_by_count)
+{
+    HotWords hot_words(3);
+    for (int i = 0; i < 3; ++i) {
+        hot_words.record("f", "c");
+    }
+    hot_words.record("f", "a");
+    hot_words.record("g", "b");
+    hot_words.record("g", "b");
+    auto hottest = hot_words.get_hottest(2);
+    ASSERT_EQ(2u, hottest.size());
+    EXPECT_EQ("c", hottest[0].word);
+    EXPECT_EQ(3u, hottest[0].count);
+    EXPECT_EQ("g", hottest[1].field);
+    EXPECT_EQ("b", hottest[1].word);
+}
+
+TEST(HotWordsTest, counts_are_aged_to_make_room_for_new_words)
+{
+    HotWords hot_words(2);
+    hot_words.record("f", "a");
+    hot_words.record("f", "b");
+    hot_words.record("f", "b");
+    hot_words.record("f", "c");
+    EXPECT_EQ(2u, hot_words.size());
+    hot_words.record("f", "c");
+    // ageing halved the counts, dropping 'a'
+    auto hottest = hot_words.get_hottest(2);
+    ASSERT_EQ(1u, hottest.size());
+    EXPECT_EQ("b", hottest[0].word);
+    EXPECT_EQ(1u, hottest[0].count);
+    hot_words.record("f", "c");
+    EXPECT_EQ(2u, hot_words.size());
+}
+
+TEST(HotWordsTest, hot_words_can_be_saved_and_loaded)
+{
+    HotWords hot_words(10);
+    hot_words.record("f", "a");
+    hot_words.record("f", "a");
+    hot_words.record("g", "b");
+    ASSERT_TRUE(hot_words.save("index/hot-words"));
+    auto loaded = HotWords::load("index/hot-words");
+    ASSERT_EQ(2u, loaded.size());
+    EXPECT_EQ("a", loaded[0].word);
+    EXPECT_EQ(2u, loaded[0].count);
+    EXPECT_EQ("g", loaded[1].field);
+    HotWords restored(10);
+    restored.add(loaded);
+    EXPECT_EQ(2u, restored.get_hottest(1)[0].count);
+    EXPECT_TRUE(HotWords::load("index/no-such-file").empty());
+}
+
+PostingListCache::Entry
+make_cached_posting_list(size_t bytes, int &loads)
+{
+    ++loads;
+    auto handle = std::make_shared<PostingListHandle>();
+    handle->_allocMem = malloc(bytes);
+    handle->_allocSize = bytes;
+    PostingListCache::Entry entry;
+    entry.posting_list = std::move(handle);
+    return entry;
+}
+
+TEST(PostingListCacheTest, entries_are_admitted_by_read_count_and_size)
+{
+    PostingListCache cache(1_Mi, 64_Ki);
+    int loads = 0;
+    PostingListCache::Key small(1, 0, 10, false);
+    PostingListCache::Key large(1, 0, 11, false);
+    auto load_small = [&loads]() { return make_cached_posting_list(1_Ki, loads); };
+    auto load_large = [&loads]() { return make_cached_posting_list(40_Ki, loads); };
+    // A word read once is not admitted, however large
+    EXPECT_TRUE(cache.get(large, load_large).posting_list);
+    EXPECT_EQ(0u, cache.size());
+    EXPECT_EQ(1u, cache.rejected());
+    cache.get(large, load_large);
+    EXPECT_EQ(1u, cache.size());
+    EXPECT_EQ(2, loads);
+    EXPECT_TRUE(cache.get(large, load_large).posting_list);
+    EXPECT_EQ(2, loads);
+    // A small posting list must be read many times to be worth caching
+    for (int i = 0; i < 5; ++i) {
+        cache.get(small, load_small);
+    }
+    EXPECT_EQ(1u, cache.size());
+    auto stats = cache.get_stats();
+    EXPECT_EQ(1u, stats.hits);
+    EXPECT_EQ(7u, stats.misses);
+}
+
+TEST(PostingListCacheTest, memory_used_is_bounded)
+{
+    PostingListCache cache(100_Ki, 0);
+    int loads = 0;
+    for (uint64_t word = 0; word < 10; ++word) {
+        PostingListCache::Key key(1, 0, word, false);
+        auto load = [&loads]() { return make_cached_posting_list(30_Ki, loads); };
+        cache.get(key, load);
+        cache.get(key, load);
+    }
+    EXPECT_EQ(20, loads);
+    // Evicting happens before the last entry is accounted
+    EXPECT_GE(131_Ki, cache.memory_used());
+    EXPECT_GE(4u, cache.size());
+    EXPECT_LE(3u, cache.size());
+}
+
+TEST(PostingListCacheTest, entries_are_separate_per_index)
+{
+    PostingListCache cache(1_Mi, 0);
+    int loads = 0;
+    auto load = [&loads]() { return make_cached_posting_list(1_Ki, loads); };
+    uint64_t first_index = cache.make_index_id();
+    uint64_t second_index = cache.make_index_id();
+    EXPECT_NE(first_index, second_index);
+    cache.get(PostingListCache::Key(first_index, 0, 10, false), load);
+    cache.get(PostingListCache::Key(first_index, 0, 10, false), load);
+    cache.get(PostingListCache::Key(second_index, 0, 10, false), load);
+    EXPECT_EQ(3, loads);
+    cache.get(PostingListCache::Key(first_index, 0, 10, false), load);
+    EXPECT_EQ(3, loads);
+}
+
 }
 
 int
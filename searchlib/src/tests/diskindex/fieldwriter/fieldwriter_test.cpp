@@ -70,6 +70,7 @@ namespace fieldwriter {
 
 uint32_t minSkipDocs = 64;
 uint32_t minChunkDocs = 256_Ki;
+bool encodeBlockDocIds = false;
 
 vespalib::string dirprefix = "index/";
 
@@ -209,7 +210,7 @@ WrappedFieldWriter::open()
     fileHeaderContext.disableFileName();
     _fieldWriter = std::make_unique<FieldWriter>(_docIdLimit, _numWordIds, _namepref);
     _fieldWriter->open(minSkipDocs, minChunkDocs,
-                       _dynamicK, _encode_interleaved_features,
+                       _dynamicK, _encode_interleaved_features, encodeBlockDocIds,
                        _schema, _indexId,
                        FieldLengthInfo(4.5, 42),
                        tuneFileWrite, fileHeaderContext);
@@ -643,6 +644,15 @@ testFieldWriterVariants(FakeWordSet &wordSet,
     testFieldWriterVariant(wordSet, docIdLimit, "newchunk4", true, false, verbose);
     testFieldWriterVariant(wordSet, docIdLimit, "newchunk5", false, false, verbose);
     testFieldWriterVariant(wordSet, docIdLimit, "newchunkcf4", true, true, verbose);
+    encodeBlockDocIds = true;
+    enableSkip();
+    testFieldWriterVariant(wordSet, docIdLimit, "newblock4", true, false, verbose);
+    testFieldWriterVariant(wordSet, docIdLimit, "newblock5", false, false, verbose);
+    testFieldWriterVariant(wordSet, docIdLimit, "newblockcf4", true, true, verbose);
+    enableSkipChunks();
+    testFieldWriterVariant(wordSet, docIdLimit, "newblockchunk4", true, false, verbose);
+    testFieldWriterVariant(wordSet, docIdLimit, "newblockchunkcf4", true, true, verbose);
+    encodeBlockDocIds = false;
 }
 
 
@@ -659,6 +669,9 @@ testFieldWriterVariantsWithHighLids(FakeWordSet &wordSet, uint32_t docIdLimit,
     enableSkipChunks();
     testFieldWriterVariant(wordSet, docIdLimit, "hlidchunk4", true, false, verbose);
     testFieldWriterVariant(wordSet, docIdLimit, "hlidchunk5", false, false, verbose);
+    encodeBlockDocIds = true;
+    testFieldWriterVariant(wordSet, docIdLimit, "hlidblockchunk4", true, false, verbose);
+    encodeBlockDocIds = false;
 }
 
 int
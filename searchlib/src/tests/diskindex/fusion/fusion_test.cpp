@@ -76,6 +76,8 @@ class FusionTest : public ::testing::Test
 protected:
     Schema _schema;
     bool   _force_small_merge_chunk;
+    size_t _max_merge_memory;
+    uint32_t _max_concurrent_field_mergers;
     const Schema & getSchema() const { return _schema; }
 
     void requireThatFusionIsWorking(const vespalib::string &prefix, bool directio, bool readmmap, bool force_short_merge_chunk);
@@ -497,7 +499,10 @@ FusionTest::try_merge_simple_indexes(const vespalib::string &dump_dir, const std
     SelectorArray selector(20, 0);
     Fusion fusion(_schema, dump_dir, sources, selector, tuneFileIndexing, fileHeaderContext);
     fusion.set_force_small_merge_chunk(_force_small_merge_chunk);
-    return fusion.merge(executor, flush_token);
+    fusion.set_max_merge_memory(_max_merge_memory);
+    bool result = fusion.merge(executor, flush_token);
+    _max_concurrent_field_mergers = fusion.get_max_concurrent_field_mergers();
+    return result;
 }
 
 void
@@ -509,7 +514,9 @@ FusionTest::merge_simple_indexes(const vespalib::string &dump_dir, const std::ve
 FusionTest::FusionTest()
     : ::testing::Test(),
       _schema(make_schema(false)),
-      _force_small_merge_chunk(false)
+      _force_small_merge_chunk(false),
+      _max_merge_memory(0),
+      _max_concurrent_field_mergers(0)
 {
 }
 
@@ -561,6 +568,21 @@ TEST_F(FusionTest, require_that_average_field_length_is_preserved)
     clean_field_length_testdirs();
 }
 
+TEST_F(FusionTest, require_that_fusion_with_merge_memory_limit_is_working)
+{
+    clean_field_length_testdirs();
+    // Only room for one field merger at a time
+    _max_merge_memory = 1;
+    make_simple_index("fldump2", MockFieldLengthInspector());
+    make_simple_index("fldump3", MyMockFieldLengthInspector());
+    merge_simple_indexes("fldump4", {"fldump2", "fldump3"});
+    EXPECT_EQ(1u, _max_concurrent_field_mergers);
+    DiskIndex disk_index("fldump4");
+    ASSERT_TRUE(disk_index.setup(TuneFileSearch()));
+    EXPECT_EQ(3.5, disk_index.get_field_length_info("f0").get_average_field_length());
+    clean_field_length_testdirs();
+}
+
 void
 FusionTest::reconstruct_interleaved_features()
 {
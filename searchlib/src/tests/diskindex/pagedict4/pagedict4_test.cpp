@@ -586,6 +586,16 @@ testWords(const std::string &logname,
                                rOffsetAndCounts);
             assert(!lres);
             assert(checkWordNum == wordNum + 1);
+
+            checkWord = "bad";
+            lres = drr->findLowerBound(i->_word, checkWord);
+            assert(lres);
+            assert(checkWord == i->_word);
+            lres = drr->findLowerBound(missWord, checkWord);
+            assert(lres == (i + 1 != ie));
+            if (lres) {
+                assert(checkWord == (i + 1)->_word);
+            }
         }
 
         checkWordNum = 0;
@@ -600,6 +610,13 @@ testWords(const std::string &logname,
         assert(!lres);
         (void) lres;
         LOG(info, "Lookup beyond dict EOF gave wordnum %d", (int) checkWordNum);
+        lres = drr->findLowerBound(notfoundword, checkWord);
+        assert(!lres);
+        if (!myrand.empty()) {
+            lres = drr->findLowerBound("", checkWord);
+            assert(lres);
+            assert(checkWord == myrand.front()._word);
+        }
 
         if (firstWordForcedCommon) {
             if (!emptyWord) {
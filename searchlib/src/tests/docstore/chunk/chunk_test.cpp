@@ -8,12 +8,15 @@
 #include <vespa/searchlib/docstore/chunkformats.h>
 #include <vespa/vespalib/objects/hexdump.h>
 #include <vespa/vespalib/stllike/string.h>
+#include <vespa/vespalib/util/stringfmt.h>
+#include <vespa/vespalib/util/zstd_dictionary.h>
 #include <zstd.h>
 
 LOG_SETUP("chunk_test");
 
 using namespace search;
 using vespalib::compression::CompressionConfig;
+using vespalib::compression::ZStdDictionary;
 
 TEST("require that Chunk obey limits")
 {
@@ -100,4 +103,46 @@ TEST("require that V2 can create and handle lz4, zstd, and none") {
     verifyChunkCompression(CompressionConfig::ZSTD, MY_LONG_STRING, strlen(MY_LONG_STRING), zstd_compressed_length);
 }
 
+vespalib::string make_document(size_t i) {
+    return vespalib::make_string("{\"title\":\"Document number %zu\",\"category\":\"category-%zu\","
+                                 "\"description\":\"A small document sharing most of its structure with the others.\"}",
+                                 i, i % 7);
+}
+
+Chunk::UP make_chunk(size_t first_doc, size_t num_docs) {
+    auto chunk = std::make_unique<Chunk>(0, Chunk::Config(0x10000));
+    for (size_t i = first_doc; i < first_doc + num_docs; ++i) {
+        vespalib::string doc = make_document(i);
+        chunk->append(i, {doc.data(), doc.size()});
+    }
+    return chunk;
+}
+
+TEST("require that chunk can be compressed with zstd dictionary") {
+    ZStdDictionary::Samples samples(1024 * 1024);
+    for (size_t i = 0; i < 1000; ++i) {
+        vespalib::string doc = make_document(i);
+        samples.add({doc.data(), doc.size()});
+    }
+    auto dictionary = ZStdDictionary::train(samples, 4096, 9);
+    ASSERT_TRUE(dictionary);
+    CompressionConfig cfg(CompressionConfig::ZSTD);
+    vespalib::DataBuffer with_dictionary;
+    make_chunk(5000, 3)->pack(7, with_dictionary, cfg, dictionary.get());
+    vespalib::DataBuffer without_dictionary;
+    make_chunk(5000, 3)->pack(7, without_dictionary, cfg);
+    EXPECT_LESS(with_dictionary.getDataLen(), without_dictionary.getDataLen());
+
+    Chunk chunk(0, with_dictionary.getData(), with_dictionary.getDataLen(), dictionary.get());
+    EXPECT_EQUAL(3u, chunk.count());
+    vespalib::string doc = make_document(5001);
+    vespalib::ConstBufferRef buf = chunk.getLid(5001);
+    EXPECT_EQUAL(doc, vespalib::string(buf.c_str(), buf.size()));
+    EXPECT_EXCEPTION(Chunk(0, with_dictionary.getData(), with_dictionary.getDataLen()),
+                     ChunkException, "Chunk is compressed with unknown dictionary");
+    // Chunks compressed without a dictionary are still readable
+    Chunk plain(0, without_dictionary.getData(), without_dictionary.getDataLen(), dictionary.get());
+    EXPECT_EQUAL(3u, plain.count());
+}
+
 TEST_MAIN() { TEST_RUN_ALL(); }
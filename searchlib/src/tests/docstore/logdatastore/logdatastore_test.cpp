@@ -7,6 +7,7 @@
 #include <vespa/document/fieldvalue/stringfieldvalue.h>
 #include <vespa/document/fieldvalue/document.h>
 #include <vespa/searchlib/docstore/chunkformats.h>
+#include <vespa/searchlib/docstore/compacter.h>
 #include <vespa/searchlib/docstore/logdocumentstore.h>
 #include <vespa/searchlib/docstore/storebybucket.h>
 #include <vespa/searchlib/docstore/visitcache.h>
@@ -475,6 +476,18 @@ public:
     void verifyDoc(const Document & doc, uint32_t id) {
         EXPECT_TRUE(doc == *_inserted[id]);
     }
+    void verifyReadBatch(const std::vector<uint32_t> & lids) {
+        auto docs = _datastore->read_batch(lids, _repo);
+        ASSERT_EQUAL(lids.size(), docs.size());
+        for (size_t i(0); i < lids.size(); i++) {
+            if (_inserted.find(lids[i]) != _inserted.end()) {
+                ASSERT_TRUE(docs[i]);
+                verifyDoc(*docs[i], lids[i]);
+            } else {
+                EXPECT_FALSE(docs[i]);
+            }
+        }
+    }
     void verifyVisit(const std::vector<uint32_t> & lids, bool allowCaching) {
         verifyVisit(lids, lids, allowCaching);
     }
@@ -625,6 +638,23 @@ TEST("test the invalidate cache strategy") {
     TEST_DO(verifyCacheStats(ds.getCacheStats(), 0, 3, 1, 241));
 }
 
+TEST("test that documents can be read in batch") {
+    VisitCacheStore vcs(DocumentStore::Config::UpdateStrategy::INVALIDATE);
+    IDocumentStore & ds = vcs.getStore();
+    for (size_t i(1); i <= 100; i++) {
+        vcs.write(i);
+    }
+    vcs.verifyRead(7);
+    TEST_DO(verifyCacheStats(ds.getCacheStats(), 0, 1, 1, 241));
+    vcs.verifyReadBatch({3, 7, 101, 3});
+    TEST_DO(verifyCacheStats(ds.getCacheStats(), 1, 4, 2, 454));
+    vcs.verifyReadBatch({7, 3});
+    TEST_DO(verifyCacheStats(ds.getCacheStats(), 3, 4, 2, 454));
+    vcs.remove(3);
+    vcs.recreate();
+    vcs.verifyReadBatch({100, 1, 3, 50, 50, 7});
+}
+
 TEST("test that the integrated visit cache works.") {
     VisitCacheStore vcs(DocumentStore::Config::UpdateStrategy::INVALIDATE);
     IDocumentStore & ds = vcs.getStore();
@@ -967,6 +997,17 @@ TEST("require that lid space can be compacted and entries from old files skipped
     }
 }
 
+TEST_F("require that lids can be sorted in storage order", Fixture)
+{
+    f.write(100);
+    f.writeUntilNewChunk(10);
+    f.write(5);
+    LogDataStore::LidVector lids = {5, 7, 100, 10};
+    f.store.sortLidsInStorageOrder(lids);
+    // Lid 7 has no data and is placed last
+    EXPECT_EQUAL((LogDataStore::LidVector{100, 10, 5, 7}), lids);
+}
+
 TEST_F("require that getLid() is protected by docIdLimit", Fixture)
 {
     f.write(1);
@@ -1058,6 +1099,38 @@ TEST("require that config equality operator detects inequality") {
     EXPECT_FALSE(C() == C().setMinFileSizeFactor(0.3));
     EXPECT_FALSE(C() == C().setFileConfig(WriteableFileChunk::Config({}, 70)));
     EXPECT_FALSE(C() == C().compactCompression({CompressionConfig::ZSTD}));
+    EXPECT_FALSE(C() == C().setCompactStepBytes(1_Mi));
+    EXPECT_FALSE(C() == C().setMaxCompactBytesPerSecond(10_Mi));
+}
+
+TEST("require that compaction debt counts both bloat and bucket spread") {
+    EXPECT_EQUAL(0.0, LogDataStore::compactionDebt(0, 0, 1.0));
+    EXPECT_EQUAL(0.0, LogDataStore::compactionDebt(1000, 0, 1.0));
+    EXPECT_EQUAL(0.25, LogDataStore::compactionDebt(1000, 250, 1.0));
+    EXPECT_EQUAL(0.5, LogDataStore::compactionDebt(1000, 0, 2.0));
+    // Only live data suffers from read amplification
+    EXPECT_EQUAL(0.625, LogDataStore::compactionDebt(1000, 250, 2.0));
+    // A file with moderate bloat but badly spread buckets is worse than one with only slightly more bloat
+    EXPECT_GREATER(LogDataStore::compactionDebt(1000, 200, 4.0), LogDataStore::compactionDebt(1000, 300, 1.0));
+}
+
+TEST("require that compaction pacer completes steps and limits rate") {
+    CompactionPacer unlimited(100, 0);
+    for (size_t i(0); i < 25; i++) {
+        unlimited.written(10);
+    }
+    EXPECT_EQUAL(2u, unlimited.getNumSteps());
+    EXPECT_EQUAL(250u, unlimited.getBytesWritten());
+    unlimited.finish();
+    EXPECT_EQUAL(3u, unlimited.getNumSteps());
+
+    vespalib::steady_time start = vespalib::steady_clock::now();
+    CompactionPacer limited(1000, 20000);
+    for (size_t i(0); i < 4; i++) {
+        limited.written(1000);
+    }
+    EXPECT_EQUAL(4u, limited.getNumSteps());
+    EXPECT_GREATER_EQUAL(vespalib::steady_clock::now() - start, 200ms);
 }
 
 TEST_MAIN() {
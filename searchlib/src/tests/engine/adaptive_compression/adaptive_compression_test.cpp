@@ -0,0 +1,62 @@
+// Copyright Vespa.ai. Licensed under the terms of the Apache 2.0 license. See LICENSE in the project root.
+
+#include <vespa/searchlib/engine/adaptive_compression.h>
+#include <vespa/vespalib/gtest/gtest.h>
+
+using search::engine::AdaptiveCompression;
+using CompressionConfig = AdaptiveCompression::CompressionConfig;
+
+const CompressionConfig base(CompressionConfig::LZ4, 3, 80, 1024);
+constexpr uint32_t mid_rtt = 2000;
+
+TEST(AdaptiveCompressionTest, require_that_configured_compression_is_used_when_link_is_unknown) {
+    AdaptiveCompression adaptive;
+    EXPECT_EQ(base, adaptive.select(base, 0, 100000));
+    EXPECT_EQ(base, adaptive.select(base, mid_rtt, 100000));
+}
+
+TEST(AdaptiveCompressionTest, require_that_disabled_or_small_payloads_are_left_alone) {
+    AdaptiveCompression adaptive;
+    CompressionConfig none(CompressionConfig::NONE, 0, 80, 1024);
+    EXPECT_EQ(none, adaptive.select(none, 50000, 100000));
+    EXPECT_EQ(base, adaptive.select(base, 50000, 100));
+}
+
+TEST(AdaptiveCompressionTest, require_that_near_links_compress_only_large_payloads_fast) {
+    AdaptiveCompression adaptive;
+    EXPECT_EQ(CompressionConfig::NONE, adaptive.select(base, 100, 10000).type);
+    auto large = adaptive.select(base, 100, AdaptiveCompression::near_min_size);
+    EXPECT_EQ(CompressionConfig::LZ4, large.type);
+    EXPECT_EQ(0u, large.compressionLevel);
+}
+
+TEST(AdaptiveCompressionTest, require_that_far_links_compress_harder) {
+    AdaptiveCompression adaptive;
+    auto config = adaptive.select(base, AdaptiveCompression::far_rtt_us, 10000);
+    EXPECT_EQ(CompressionConfig::ZSTD, config.type);
+    EXPECT_EQ(AdaptiveCompression::far_zstd_level, config.compressionLevel);
+    EXPECT_EQ(base.threshold, config.threshold);
+    EXPECT_EQ(base.minSize, config.minSize);
+}
+
+TEST(AdaptiveCompressionTest, require_that_incompressible_payloads_are_mostly_not_compressed) {
+    AdaptiveCompression adaptive;
+    for (int i = 0; i < 32; ++i) {
+        adaptive.report(10000, 10000);
+    }
+    EXPECT_GE(adaptive.ratio_permille(), AdaptiveCompression::poor_ratio_permille);
+    uint32_t compressed = 0;
+    for (uint32_t i = 0; i < 2 * AdaptiveCompression::probe_interval; ++i) {
+        if (adaptive.select(base, mid_rtt, 10000).useCompression()) {
+            ++compressed;
+        }
+    }
+    EXPECT_EQ(2u, compressed);
+    for (int i = 0; i < 32; ++i) {
+        adaptive.report(10000, 2000);
+    }
+    EXPECT_LT(adaptive.ratio_permille(), AdaptiveCompression::poor_ratio_permille);
+    EXPECT_EQ(base, adaptive.select(base, mid_rtt, 10000));
+}
+
+GTEST_MAIN_RUN_ALL_TESTS()
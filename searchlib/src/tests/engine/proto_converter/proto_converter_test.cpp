@@ -211,6 +211,13 @@ TEST_F(SearchRequestTest, require_that_query_tree_blob_is_converted) {
     EXPECT_EQ(std::string(&request.stackDump[0], request.stackDump.size()), "query-tree-blob");
 }
 
+TEST_F(SearchRequestTest, require_that_columnar_match_features_is_converted) {
+    EXPECT_FALSE(request.columnar_match_features);
+    proto.set_columnar_match_features(true);
+    convert();
+    EXPECT_TRUE(request.columnar_match_features);
+}
+
 //-----------------------------------------------------------------------------
 
 struct SearchReplyTest : ProtoConverterTest {
@@ -348,6 +355,46 @@ TEST_F(SearchReplyTest, require_that_match_features_are_converted) {
     EXPECT_EQ(proto.hits(2).match_features(1).tensor(), "data3");
 }
 
+TEST_F(SearchReplyTest, require_that_match_features_can_be_converted_to_columns) {
+    fill_hits();
+    fill_match_features();
+    reply.request = std::make_unique<SearchRequest>();
+    reply.request->columnar_match_features = true;
+    convert();
+    ASSERT_EQ(proto.match_feature_names_size(), 2);
+    EXPECT_EQ(proto.match_feature_names(0), "my_double");
+    EXPECT_EQ(proto.match_feature_names(1), "my_data");
+    ASSERT_EQ(proto.match_feature_columns_size(), 2);
+    const auto &numbers = proto.match_feature_columns(0);
+    ASSERT_EQ(numbers.numbers_size(), 3);
+    EXPECT_EQ(numbers.tensors_size(), 0);
+    EXPECT_EQ(numbers.numbers(0), 10.0);
+    EXPECT_EQ(numbers.numbers(1), 20.0);
+    EXPECT_EQ(numbers.numbers(2), 30.0);
+    const auto &tensors = proto.match_feature_columns(1);
+    EXPECT_EQ(tensors.numbers_size(), 0);
+    ASSERT_EQ(tensors.tensors_size(), 3);
+    EXPECT_EQ(tensors.tensors(0), "data1");
+    EXPECT_EQ(tensors.tensors(1), "data2");
+    EXPECT_EQ(tensors.tensors(2), "data3");
+    for (const auto &hit: proto.hits()) {
+        EXPECT_EQ(hit.match_features_size(), 0);
+    }
+}
+
+TEST_F(SearchReplyTest, require_that_mixed_match_feature_columns_fall_back_to_per_hit_encoding) {
+    fill_hits();
+    fill_match_features();
+    reply.match_features.values[2].set_data("data4");
+    reply.request = std::make_unique<SearchRequest>();
+    reply.request->columnar_match_features = true;
+    convert();
+    EXPECT_EQ(proto.match_feature_columns_size(), 0);
+    ASSERT_EQ(proto.hits(1).match_features_size(), 2);
+    EXPECT_EQ(proto.hits(1).match_features(0).tensor(), "data4");
+    EXPECT_EQ(proto.hits(2).match_features(0).number(), 30.0);
+}
+
 TEST_F(SearchReplyTest, require_that_grouping_blob_is_converted) {
     vespalib::string tmp("grouping-result");
     reply.groupResult.assign(tmp.begin(), tmp.end());
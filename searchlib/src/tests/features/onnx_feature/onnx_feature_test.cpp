@@ -29,6 +29,7 @@ std::string source_dir = get_source_dir();
 std::string vespa_dir = source_dir + "/" + "../../../../..";
 std::string simple_model = vespa_dir + "/" + "eval/src/tests/tensor/onnx_wrapper/simple.onnx";
 std::string dynamic_model = vespa_dir + "/" + "eval/src/tests/tensor/onnx_wrapper/dynamic.onnx";
+std::string probe_model = vespa_dir + "/" + "eval/src/tests/tensor/onnx_wrapper/probe_model.onnx";
 std::string strange_names_model = source_dir + "/" + "strange_names.onnx";
 std::string fragile_model = source_dir + "/" + "fragile.onnx";
 
@@ -175,6 +176,35 @@ TEST_F(OnnxFeatureTest, fragile_model_can_be_evaluated) {
     EXPECT_EQ(get(3), TensorSpec::from_expr("tensor<float>(d0[2]):[6,15]"));
 }
 
+TEST_F(OnnxFeatureTest, onnx_model_can_be_calculated_in_batches) {
+    indexEnv.getProperties().add(indexproperties::eval::OnnxBatchSize::NAME, "4");
+    add_expr("in1", "tensor<float>(a[1],b[3]):[[docid,2,3]]");
+    add_expr("in2", "tensor<float>(a[1],b[3]):[[4,5,6]]");
+    add_onnx(OnnxModel("probe", probe_model));
+    compile(onnx_feature("probe"));
+    EXPECT_EQ(program.max_batch_size(), 4u);
+    program.add_to_batch(1);
+    program.add_to_batch(2);
+    program.add_to_batch(3);
+    program.execute_batch();
+    EXPECT_EQ(get(1), TensorSpec::from_expr("tensor<float>(d0[1],d1[3]):[[5,7,9]]"));
+    EXPECT_EQ(get(2), TensorSpec::from_expr("tensor<float>(d0[1],d1[3]):[[6,7,9]]"));
+    EXPECT_EQ(get(3), TensorSpec::from_expr("tensor<float>(d0[1],d1[3]):[[7,7,9]]"));
+    // documents outside the batch are evaluated one by one
+    EXPECT_EQ(get(5), TensorSpec::from_expr("tensor<float>(d0[1],d1[3]):[[9,7,9]]"));
+}
+
+TEST_F(OnnxFeatureTest, onnx_model_without_batch_dimension_is_not_batched) {
+    indexEnv.getProperties().add(indexproperties::eval::OnnxBatchSize::NAME, "4");
+    add_expr("query_tensor", "tensor<float>(a[1],b[4]):[[docid,2,3,4]]");
+    add_expr("attribute_tensor", "tensor<float>(a[4],b[1]):[[5],[6],[7],[8]]");
+    add_expr("bias_tensor", "tensor<float>(a[1],b[1]):[[9]]");
+    add_onnx(OnnxModel("simple", simple_model));
+    compile(onnx_feature("simple"));
+    EXPECT_EQ(program.max_batch_size(), 0u);
+    EXPECT_EQ(get(1), TensorSpec("tensor<float>(d0[1],d1[1])").add({{"d0",0},{"d1",0}}, 79.0));
+}
+
 struct MyIssues : Issue::Handler {
     std::vector<vespalib::string> list;
     Issue::Binding capture;
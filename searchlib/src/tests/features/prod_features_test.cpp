@@ -277,6 +277,33 @@ Test::testAttribute()
         ASSERT_TRUE(ft.setup());
         ASSERT_TRUE(ft.execute(exp));
     }
+    { // single attributes read in batches
+        RankResult exp;
+        exp.addScore("attribute(sint)", 10).
+            addScore("attribute(slong)", 20).
+            addScore("attribute(sbyte)", 37).
+            addScore("attribute(sfloat)", 60.5f).
+            addScore("attribute(sdouble)", 67.5f).
+            addScore("attribute(udefint)", search::attribute::getUndefined<feature_t>());
+
+        FtFeatureTest ft(_factory, exp.getKeys());
+        ft.getIndexEnv().getProperties().add(indexproperties::eval::AttributeBatchSize::NAME, "4");
+        ft.getIndexEnv().getBuilder()
+            .addField(FieldType::ATTRIBUTE, CollectionType::SINGLE, "sint")
+            .addField(FieldType::ATTRIBUTE, CollectionType::SINGLE, "slong")
+            .addField(FieldType::ATTRIBUTE, CollectionType::SINGLE, "sbyte")
+            .addField(FieldType::ATTRIBUTE, CollectionType::SINGLE, "sfloat")
+            .addField(FieldType::ATTRIBUTE, CollectionType::SINGLE, "sdouble")
+            .addField(FieldType::ATTRIBUTE, CollectionType::SINGLE, "udefint");
+        setupForAttributeTest(ft);
+        ASSERT_TRUE(ft.setup());
+        EXPECT_EQUAL(4u, ft.getRankProgram().max_batch_size());
+        ft.getRankProgram().add_to_batch(1);
+        ft.getRankProgram().execute_batch();
+        ASSERT_TRUE(ft.execute(exp));
+        // hits already consumed from the batch are read one by one
+        ASSERT_TRUE(ft.execute(exp));
+    }
     { // array attributes
         RankResult exp;
         exp.addScore("attribute(aint)", 0).
@@ -1,9 +1,12 @@
 // Copyright Vespa.ai. Licensed under the terms of the Apache 2.0 license. See LICENSE in the project root.
 #include <vespa/vespalib/testkit/test_kit.h>
+#include <vespa/vespalib/test/insertion_operators.h>
 
 #include <vespa/eval/eval/value_type.h>
 #include <vespa/searchlib/fef/feature_type.h>
+#include <vespa/searchlib/fef/featurenamebuilder.h>
 #include <vespa/searchlib/fef/featurenameparser.h>
+#include <vespa/searchlib/fef/indexproperties.h>
 #include <vespa/searchlib/features/rankingexpressionfeature.h>
 #include <vespa/searchlib/fef/test/dummy_dependency_handler.h>
 #include <vespa/searchlib/fef/test/indexenvironment.h>
@@ -68,13 +71,14 @@ struct SetupResult {
     DummyDependencyHandler deps;
     bool setup_ok;
     SetupResult(const TypeMap &object_inputs, const vespalib::string &expression,
-                const vespalib::string &expression_name = "");
+                const vespalib::string &expression_name = "", bool lift_query_constants = false);
     ~SetupResult();
 };
 
 SetupResult::SetupResult(const TypeMap &object_inputs,
                          const vespalib::string &expression,
-                         const vespalib::string &expression_name)
+                         const vespalib::string &expression_name,
+                         bool lift_query_constants)
     : stash(), index_env(), query_env(&index_env), rank(make_replacer()), deps(rank), setup_ok(false)
 {
     rank.setName("self");
@@ -88,6 +92,9 @@ SetupResult::SetupResult(const TypeMap &object_inputs,
         index_env.addRankingExpression(expression_name, expression);
         index_env.getProperties().add("self.expressionName", expression_name);
     }
+    if (lift_query_constants) {
+        index_env.getProperties().add(indexproperties::eval::LiftQueryConstants::NAME, "true");
+    }
     Blueprint &bp = rank;
     setup_ok = bp.setup(index_env, params);
     EXPECT_TRUE(!deps.accept_type_mismatch);
@@ -175,4 +182,46 @@ TEST_F("require that replaced expressions create the appropriate executor", Setu
     EXPECT_TRUE(dynamic_cast<DummyExecutor*>(&executor) != nullptr);
 }
 
+vespalib::string lifted(const vespalib::string &expr) {
+    return FeatureNameBuilder().baseName("rankingExpression").parameter(expr).buildName();
+}
+
+void verify_lifted_inputs(TypeMap object_inputs, const vespalib::string &expression,
+                          const std::vector<vespalib::string> &expect, const FeatureType &expect_type)
+{
+    for (const auto &input: expect) {
+        if (vespalib::starts_with(input, "rankingExpression(") && expect_type.is_object()) {
+            object_inputs[input] = expect_type.type().to_spec();
+        }
+    }
+    SetupResult result(object_inputs, expression, "", true);
+    EXPECT_TRUE(result.setup_ok);
+    EXPECT_EQUAL(result.deps.input, expect);
+}
+
+TEST("require that tensor subexpressions using only query and constant features can be lifted") {
+    TypeMap inputs = {{"query(q)", "tensor(x[3])"}, {"constant(w)", "tensor(x[3])"}, {"attribute(a)", "tensor(x[3])"}};
+    auto expr = "reduce((query(q)*constant(w))*attribute(a),sum)";
+    TEST_DO(verify_lifted_inputs(inputs, expr,
+                                 {"query(q)", "constant(w)", "attribute(a)", lifted("(query(q)*constant(w))")},
+                                 FeatureType::object(ValueType::from_spec("tensor(x[3])"))));
+    TEST_DO(verify_lifted_inputs(inputs, "reduce(query(q)*constant(w),sum)+reduce(attribute(a),sum)",
+                                 {"query(q)", "constant(w)", "attribute(a)", lifted("reduce((query(q)*constant(w)),sum)")},
+                                 FeatureType::number()));
+}
+
+TEST("require that expressions are not lifted when it would not help") {
+    TypeMap inputs = {{"query(q)", "tensor(x[3])"}, {"attribute(a)", "tensor(x[3])"}};
+    TEST_DO(verify_lifted_inputs(inputs, "reduce(query(q)*attribute(a),sum)", {"query(q)", "attribute(a)"}, FeatureType::number()));
+    TEST_DO(verify_lifted_inputs(inputs, "reduce(query(q)*query(q),sum)", {"query(q)"}, FeatureType::number()));
+    TEST_DO(verify_lifted_inputs(inputs, "reduce(attribute(a)*(query(s)+1),sum)", {"attribute(a)", "query(s)"}, FeatureType::number()));
+}
+
+TEST("require that query constants are not lifted by default") {
+    TypeMap inputs = {{"query(q)", "tensor(x[3])"}, {"constant(w)", "tensor(x[3])"}, {"attribute(a)", "tensor(x[3])"}};
+    SetupResult result(inputs, "reduce((query(q)*constant(w))*attribute(a),sum)");
+    EXPECT_TRUE(result.setup_ok);
+    EXPECT_EQUAL(result.deps.input, std::vector<vespalib::string>({"query(q)", "constant(w)", "attribute(a)"}));
+}
+
 TEST_MAIN() { TEST_RUN_ALL(); }
@@ -241,6 +241,22 @@ TEST("test stuff") {
             p.add("vespa.eval.use_fast_forest", "true");
             EXPECT_EQUAL(eval::UseFastForest::check(p), true);
         }
+        { // vespa.eval.lift_query_constants
+            EXPECT_EQUAL(eval::LiftQueryConstants::NAME, vespalib::string("vespa.eval.lift_query_constants"));
+            EXPECT_EQUAL(eval::LiftQueryConstants::DEFAULT_VALUE, false);
+            Properties p;
+            EXPECT_EQUAL(eval::LiftQueryConstants::check(p), false);
+            p.add("vespa.eval.lift_query_constants", "true");
+            EXPECT_EQUAL(eval::LiftQueryConstants::check(p), true);
+        }
+        { // vespa.eval.fast_forest_batch_size
+            EXPECT_EQUAL(eval::FastForestBatchSize::NAME, vespalib::string("vespa.eval.fast_forest_batch_size"));
+            EXPECT_EQUAL(eval::FastForestBatchSize::DEFAULT_VALUE, 0u);
+            Properties p;
+            EXPECT_EQUAL(eval::FastForestBatchSize::lookup(p), 0u);
+            p.add("vespa.eval.fast_forest_batch_size", "64");
+            EXPECT_EQUAL(eval::FastForestBatchSize::lookup(p), 64u);
+        }
         { // vespa.rank.firstphase
             EXPECT_EQUAL(rank::FirstPhase::NAME, vespalib::string("vespa.rank.firstphase"));
             EXPECT_EQUAL(rank::FirstPhase::DEFAULT_VALUE, vespalib::string("nativeRank"));
@@ -277,6 +293,22 @@ TEST("test stuff") {
             p.add("vespa.dump.ignoredefaultfeatures", "true");
             EXPECT_TRUE(dump::IgnoreDefaultFeatures::check(p));
         }
+        { // vespa.summary.hits_per_task
+            EXPECT_EQUAL(summary::HitsPerTask::NAME, vespalib::string("vespa.summary.hits_per_task"));
+            EXPECT_EQUAL(summary::HitsPerTask::DEFAULT_VALUE, 0u);
+            Properties p;
+            EXPECT_EQUAL(summary::HitsPerTask::lookup(p), 0u);
+            p.add("vespa.summary.hits_per_task", "32");
+            EXPECT_EQUAL(summary::HitsPerTask::lookup(p), 32u);
+        }
+        { // vespa.summary.precompute_features
+            EXPECT_EQUAL(summary::PrecomputeFeatures::NAME, vespalib::string("vespa.summary.precompute_features"));
+            EXPECT_FALSE(summary::PrecomputeFeatures::DEFAULT_VALUE);
+            Properties p;
+            EXPECT_FALSE(summary::PrecomputeFeatures::check(p));
+            p.add("vespa.summary.precompute_features", "true");
+            EXPECT_TRUE(summary::PrecomputeFeatures::check(p));
+        }
         { // vespa.matching.termwise_limit
             EXPECT_EQUAL(matching::TermwiseLimit::NAME, vespalib::string("vespa.matching.termwise_limit"));
             EXPECT_EQUAL(matching::TermwiseLimit::DEFAULT_VALUE, 1.0);
@@ -0,0 +1,107 @@
+// Copyright Vespa.ai. Licensed under the terms of the Apache 2.0 license. See LICENSE in the project root.
+
+#include <vespa/searchlib/features/valuefeature.h>
+#include <vespa/searchlib/features/rankingexpressionfeature.h>
+#include <vespa/searchlib/fef/blueprintfactory.h>
+#include <vespa/searchlib/fef/matchdatalayout.h>
+#include <vespa/searchlib/fef/rank_program.h>
+#include <vespa/searchlib/fef/test/indexenvironment.h>
+#include <vespa/searchlib/fef/test/queryenvironment.h>
+#include <vespa/searchlib/fef/test/plugin/sum.h>
+#include <vespa/vespalib/gtest/gtest.h>
+#include <vespa/vespalib/util/stash.h>
+#include <cstdio>
+
+/*
+ * Counts heap allocations done while setting up the match data and rank
+ * programs needed by a single match thread for a typical query, with and
+ * without a per query stash.
+ */
+
+extern "C" void *__libc_malloc(size_t size);
+extern "C" void *__libc_calloc(size_t nmemb, size_t size);
+extern "C" void *__libc_realloc(void *ptr, size_t size);
+extern "C" void __libc_free(void *ptr);
+
+namespace {
+size_t num_allocations = 0;
+}
+
+extern "C" void *malloc(size_t size) { ++num_allocations; return __libc_malloc(size); }
+extern "C" void *calloc(size_t nmemb, size_t size) { ++num_allocations; return __libc_calloc(nmemb, size); }
+extern "C" void *realloc(void *ptr, size_t size) { ++num_allocations; return __libc_realloc(ptr, size); }
+extern "C" void free(void *ptr) { __libc_free(ptr); }
+
+using namespace search::fef;
+using namespace search::fef::test;
+using namespace search::features;
+
+constexpr size_t num_term_fields = 16;
+constexpr size_t num_queries = 1000;
+
+struct Setup {
+    BlueprintFactory factory;
+    IndexEnvironment index_env;
+    std::vector<BlueprintResolver::SP> resolvers;
+    MatchDataLayout mdl;
+    Setup() : factory(), index_env(), resolvers(), mdl() {
+        factory.addPrototype(std::make_shared<RankingExpressionBlueprint>());
+        factory.addPrototype(std::make_shared<SumBlueprint>());
+        factory.addPrototype(std::make_shared<ValueBlueprint>());
+        auto &props = index_env.getProperties();
+        props.add("rankingExpression(first).rankingScript", "value(1)+value(2)*sum(value(3),value(4))");
+        props.add("rankingExpression(second).rankingScript", "rankingExpression(first)*value(5)+value(6)");
+        props.add("rankingExpression(summary).rankingScript", "value(7)+value(8)");
+        for (const char *seed: {"rankingExpression(first)", "rankingExpression(second)", "rankingExpression(summary)"}) {
+            auto resolver = std::make_shared<BlueprintResolver>(factory, index_env);
+            resolver->addSeed(seed);
+            EXPECT_TRUE(resolver->compile());
+            resolvers.push_back(std::move(resolver));
+        }
+        for (size_t i = 0; i < num_term_fields; ++i) {
+            mdl.allocTermField(i % 4);
+        }
+    }
+    ~Setup();
+};
+
+Setup::~Setup() = default;
+
+size_t count_heap_allocations(Setup &setup) {
+    QueryEnvironment query_env(&setup.index_env);
+    size_t before = num_allocations;
+    for (size_t q = 0; q < num_queries; ++q) {
+        auto md = setup.mdl.createMatchData();
+        for (const auto &resolver: setup.resolvers) {
+            auto program = std::make_unique<RankProgram>(resolver);
+            program->setup(*md, query_env);
+        }
+    }
+    return num_allocations - before;
+}
+
+size_t count_stash_allocations(Setup &setup) {
+    QueryEnvironment query_env(&setup.index_env);
+    size_t before = num_allocations;
+    for (size_t q = 0; q < num_queries; ++q) {
+        vespalib::Stash stash;
+        auto &md = setup.mdl.createMatchData(stash);
+        for (const auto &resolver: setup.resolvers) {
+            auto &program = stash.create<RankProgram>(resolver);
+            program.setup(md, query_env);
+        }
+    }
+    return num_allocations - before;
+}
+
+TEST(RankProgramAllocationBenchmark, per_query_stash_reduces_allocations)
+{
+    Setup setup;
+    size_t heap = count_heap_allocations(setup);
+    size_t stash = count_stash_allocations(setup);
+    fprintf(stderr, "allocations per query: heap=%.1f stash=%.1f\n",
+            double(heap) / num_queries, double(stash) / num_queries);
+    EXPECT_LT(stash, heap);
+}
+
+GTEST_MAIN_RUN_ALL_TESTS()
@@ -2,6 +2,7 @@
 #include <vespa/vespalib/testkit/test_kit.h>
 #include <vespa/vespalib/stllike/string.h>
 #include <vespa/vespalib/util/stringfmt.h>
+#include <vespa/searchlib/features/queryfeature.h>
 #include <vespa/searchlib/features/valuefeature.h>
 #include <vespa/searchlib/features/rankingexpressionfeature.h>
 #include <vespa/searchlib/fef/blueprintfactory.h>
@@ -84,6 +85,7 @@ struct Fixture {
         factory.addPrototype(Blueprint::SP(new DocidBlueprint()));
         factory.addPrototype(Blueprint::SP(new DoubleBlueprint()));
         factory.addPrototype(Blueprint::SP(new ImpureValueBlueprint()));
+        factory.addPrototype(Blueprint::SP(new QueryBlueprint()));
         factory.addPrototype(Blueprint::SP(new RankingExpressionBlueprint()));
         factory.addPrototype(Blueprint::SP(new SumBlueprint()));
         factory.addPrototype(Blueprint::SP(new TrackingBlueprint(track_cnt)));        
@@ -98,6 +100,20 @@ struct Fixture {
         indexEnv.getProperties().add(indexproperties::eval::UseFastForest::NAME, "true");
         return *this;
     }
+    Fixture &fast_forest_batch_size(uint32_t value) {
+        indexEnv.getProperties().add(indexproperties::eval::FastForestBatchSize::NAME,
+                                     vespalib::make_string("%u", value));
+        return *this;
+    }
+    Fixture &lift_query_constants() {
+        indexEnv.getProperties().add(indexproperties::eval::LiftQueryConstants::NAME, "true");
+        return *this;
+    }
+    Fixture &query_tensor(const vespalib::string &name, const vespalib::string &type, const vespalib::string &value) {
+        indexEnv.getProperties().add("vespa.type.query." + name, type);
+        indexEnv.getProperties().add("query(" + name + ")", value);
+        return *this;
+    }
     Fixture &add_expr(const vespalib::string &name, const vespalib::string &expr) {
         vespalib::string feature_name = expr_feature(name);
         vespalib::string expr_name = feature_name + ".rankingScript";
@@ -261,6 +277,40 @@ TEST_F("require that re-used features are only calculated once", Fixture()) {
     EXPECT_EQUAL(f1.track_cnt, 2u);
 }
 
+TEST_F("require that constants can be reused from another rank program", Fixture()) {
+    f1.add("track(mysum(value(10),value(5)))").compile();
+    EXPECT_EQUAL(f1.track_cnt, 1u);
+    auto other_resolver = std::make_shared<BlueprintResolver>(f1.factory, f1.indexEnv);
+    other_resolver->addSeed("mysum(track(mysum(value(10),value(5))),track(docid))");
+    ASSERT_TRUE(other_resolver->compile());
+    RankProgram other(other_resolver);
+    other.reuse_constants_from(f1.program);
+    QueryEnvironment queryEnv(&f1.indexEnv);
+    other.setup(*f1.match_data, queryEnv);
+    EXPECT_EQUAL(f1.track_cnt, 1u);
+    EXPECT_EQUAL(4u, other.num_reused_constants());
+    EXPECT_EQUAL(7u, other.num_executors());
+    EXPECT_EQUAL(4u, count_const_features(other));
+    auto seeds = other.get_seeds();
+    EXPECT_EQUAL(17.0, seeds.resolve(0).as_number(2));
+    EXPECT_EQUAL(f1.track_cnt, 2u);
+}
+
+TEST_F("require that overridden constants are not reused from another rank program", Fixture()) {
+    f1.add("value(10)").compile();
+    auto other_resolver = std::make_shared<BlueprintResolver>(f1.factory, f1.indexEnv);
+    other_resolver->addSeed("value(10)");
+    ASSERT_TRUE(other_resolver->compile());
+    RankProgram other(other_resolver);
+    other.reuse_constants_from(f1.program);
+    Properties overrides;
+    overrides.add("value(10)", "20");
+    QueryEnvironment queryEnv(&f1.indexEnv);
+    other.setup(*f1.match_data, queryEnv, overrides);
+    EXPECT_EQUAL(0u, other.num_reused_constants());
+    EXPECT_EQUAL(20.0, other.get_seeds().resolve(0).as_number(1));
+}
+
 TEST_F("require that overrides of const features work for multiple documents", Fixture()) {
     f1.add("mysum(value(1),docid)").override("value(1)", 10.0).compile();
     EXPECT_EQUAL(3u, f1.program.num_executors());
@@ -395,6 +445,36 @@ TEST_F("require that fast-forest gbdt evaluation is pure", Fixture()) {
     EXPECT_EQUAL(f1.final_executor_name(), "search::features::FastForestExecutor");
 }
 
+TEST_F("require that fast-forest gbdt evaluation can be batched", Fixture()) {
+    f1.use_fast_forest().fast_forest_batch_size(4).add_expr("rank", "if(ivalue(1)<2,1,2)+if(ivalue(2)<1,10,20)").compile();
+    EXPECT_EQUAL(f1.final_executor_name(), "search::features::FastForestExecutor");
+    EXPECT_EQUAL(f1.program.max_batch_size(), 4u);
+    f1.program.add_to_batch(1);
+    f1.program.add_to_batch(2);
+    f1.program.execute_batch();
+    EXPECT_EQUAL(f1.get(1), 21.0);
+    EXPECT_EQUAL(f1.get(2), 21.0);
+    // documents outside the batch are evaluated one by one
+    EXPECT_EQUAL(f1.get(3), 21.0);
+}
+
+TEST_FF("require that query constant tensor subexpressions are evaluated once", Fixture(), Fixture()) {
+    for (Fixture *f: {&f1, &f2}) {
+        f->query_tensor("q", "tensor(x[3])", "tensor(x[3]):[1,2,3]")
+            .query_tensor("w", "tensor(x[3])", "tensor(x[3]):[4,5,6]");
+    }
+    vespalib::string expr("reduce(query(q)*query(w),sum)*ivalue(2)");
+    f1.add_expr("rank", expr).compile();
+    f2.lift_query_constants().add_expr("rank", expr).compile();
+    EXPECT_EQUAL(4u, f1.program.num_executors());
+    EXPECT_EQUAL(5u, f2.program.num_executors());
+    EXPECT_EQUAL(2u, count_const_features(f1.program));
+    EXPECT_EQUAL(3u, count_const_features(f2.program));
+    EXPECT_EQUAL(64.0, f1.get(1));
+    EXPECT_EQUAL(64.0, f2.get(1));
+    EXPECT_EQUAL(64.0, f2.get(2));
+}
+
 TEST_F("require that rank program can be profiled", Fixture()) {
     ExecutionProfiler profiler(64);
     f1.add("mysum(value(10),ivalue(5))").compile(&profiler);
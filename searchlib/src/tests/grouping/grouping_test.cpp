@@ -3,17 +3,22 @@
 #include <vespa/vespalib/testkit/testapp.h>
 #include <vespa/searchlib/aggregation/perdocexpression.h>
 #include <vespa/searchlib/aggregation/aggregation.h>
+#include <vespa/searchlib/aggregation/columnar_grouper.h>
 #include <vespa/searchlib/attribute/extendableattributes.h>
 #include <vespa/searchlib/attribute/attributemanager.h>
 #include <vespa/searchlib/aggregation/hitsaggregationresult.h>
 #include <vespa/searchlib/aggregation/fs4hit.h>
 #include <vespa/searchlib/aggregation/predicates.h>
 #include <vespa/searchlib/expression/fixedwidthbucketfunctionnode.h>
+#include <vespa/searchlib/test/attribute_builder.h>
 #include <vespa/searchlib/test/make_attribute_map_lookup_node.h>
 #include <vespa/searchcommon/common/undefinedvalues.h>
+#include <vespa/vespalib/objects/nboserializer.h>
 #include <algorithm>
 #include <cmath>
 #include <iostream>
+#include <limits>
+#include <map>
 
 #include <vespa/log/log.h>
 LOG_SETUP("grouping_test");
@@ -23,6 +28,7 @@ using namespace search;
 using namespace search::aggregation;
 using namespace search::attribute;
 using namespace search::expression;
+using search::attribute::test::AttributeBuilder;
 using search::expression::test::makeAttributeMapLookupNode;
 
 namespace {
@@ -563,6 +569,47 @@ TEST("testAggregationMaxGroups")
     }
 }
 
+TEST("require that the group limit caps the groups created per level")
+{
+    AggregationContext ctx;
+    ctx.add(IntAttrBuilder("attr").add(5).add(10).add(15).sp());
+    ctx.result().add(0).add(1).add(2);
+
+    Grouping baseRequest = Grouping().addLevel(createGL(MU<AttributeNode>("attr")));
+
+    Group grp1 = Group().addChild(Group().setId(Int64ResultNode(5)));
+    Group grp2 = grp1.unchain().addChild(Group().setId(Int64ResultNode(10)));
+    Group grp3 = grp2.unchain().addChild(Group().setId(Int64ResultNode(15)));
+
+    {
+        Grouping request = baseRequest;
+        request.setGroupLimit(1);
+        EXPECT_TRUE(testAggregation(ctx, request, grp1));
+    }
+    {
+        Grouping request = baseRequest;
+        request.setGroupLimit(2);
+        EXPECT_TRUE(testAggregation(ctx, request, grp2));
+    }
+    { // maxgroups is still honored below the limit
+        Grouping request = baseRequest;
+        request.levels()[0].setMaxGroups(1);
+        request.setGroupLimit(2);
+        EXPECT_TRUE(testAggregation(ctx, request, grp1));
+    }
+    { // the limit is local and not serialized
+        Grouping request = baseRequest;
+        request.setGroupLimit(1);
+        vespalib::nbostream os;
+        vespalib::NBOSerializer nos(os);
+        request.serialize(nos);
+        Grouping copy;
+        copy.deserialize(nos);
+        EXPECT_EQUAL(std::numeric_limits<uint64_t>::max(), copy.levels()[0].getGroupLimit());
+        EXPECT_TRUE(testAggregation(ctx, copy, grp3));
+    }
+}
+
 TEST("Verify that groups are sorted by group id")
 {
     AggregationContext ctx;
@@ -584,6 +631,35 @@ TEST("Verify that groups are sorted by group id")
     EXPECT_TRUE(testAggregation(ctx, request, expect));
 }
 
+TEST("Verify that string groups keyed on enum handles get string ids")
+{
+    AggregationContext ctx;
+    ctx.add(AttributeBuilder("enum", Config(BasicType::STRING)).fill({"b", "a", "c", "a", "b"}).get());
+    ctx.add(StringAttrBuilder("ext").add("").add("b").add("a").add("c").add("a").add("b").sp());
+    ctx.add(IntAttrBuilder("weight").add(0).add(1).add(2).add(4).add(8).add(16).sp());
+    ctx.result().add(1).add(2).add(3).add(4).add(5);
+
+    Group expect;
+    expect.addChild(Group().setId(StringResultNode("a"))
+                           .addResult(SumAggregationResult().setExpression(MU<AttributeNode>("weight"))
+                                                            .setResult(Int64ResultNode(10))))
+          .addChild(Group().setId(StringResultNode("b"))
+                           .addResult(SumAggregationResult().setExpression(MU<AttributeNode>("weight"))
+                                                            .setResult(Int64ResultNode(17))))
+          .addChild(Group().setId(StringResultNode("c"))
+                           .addResult(SumAggregationResult().setExpression(MU<AttributeNode>("weight"))
+                                                            .setResult(Int64ResultNode(4))));
+
+    // "ext" has no enum store and falls back to grouping on the string values
+    for (const char *name : {"enum", "ext"}) {
+        auto node = MU<AttributeNode>(name);
+        node->enableEnumOptimization(true);
+        Grouping request;
+        request.addLevel(createGL(std::move(node), MU<AttributeNode>("weight")));
+        EXPECT_TRUE(testAggregation(ctx, request, expect));
+    }
+}
+
 TEST("Verify that groups are tagged with the appropriate rank value")
 {
     AggregationContext ctx;
@@ -1625,6 +1701,146 @@ TEST("testCount")
     EXPECT_TRUE(testAggregation(ctx, request, expect));
 }
 
+TEST("require that sampled grouping scales counts and sums")
+{
+    AggregationContext ctx;
+    IntAttrBuilder attr("attr");
+    for (uint32_t i = 0; i < 1000; ++i) {
+        attr.add(i % 2);
+        ctx.result().add(i);
+    }
+    ctx.add(attr.sp());
+
+    Grouping request;
+    request.setRoot(Group().addResult(CountAggregationResult().setExpression(MU<ConstantNode>(MU<Int64ResultNode>(0))))
+                           .addResult(SumAggregationResult().setExpression(MU<AttributeNode>("attr"))));
+    request.setSampleRate(0.25);
+
+    size_t sampled = 0;
+    for (uint32_t i = 0; i < 1000; ++i) {
+        if (request.isSampled(i)) {
+            ++sampled;
+        }
+    }
+    Grouping tmp = request;
+    ctx.setup(tmp);
+    tmp.aggregate(ctx.result().hits(), ctx.result().size());
+    const auto & count = static_cast<const CountAggregationResult &>(tmp.getRoot().getAggregationResult(0));
+    const auto & sum = static_cast<const SumAggregationResult &>(tmp.getRoot().getAggregationResult(1));
+    EXPECT_EQUAL(uint64_t(sampled * 4), count.getCount());
+    double bound = Grouping::countErrorBound(1000, 0.25);
+    EXPECT_TRUE(std::abs(int64_t(count.getCount()) - 1000) <= bound);
+    EXPECT_TRUE(std::abs(sum.getSum().getInteger() - 500) <= bound);
+    EXPECT_EQUAL(0.0, Grouping::countErrorBound(1000, 1.0));
+}
+
+TEST("require that sampling raises the precision of ordered levels")
+{
+    Grouping request = Grouping().addLevel(createGL(10, MU<AttributeNode>("attr")))
+                                 .addLevel(createGL(MU<AttributeNode>("attr")));
+    request.setSampleRate(0.25);
+    EXPECT_EQUAL(20, int(request.levels()[0].getPrecision()));
+    EXPECT_EQUAL(-1, int(request.levels()[1].getPrecision()));
+    EXPECT_EQUAL(10, int(request.levels()[0].getMaxGroups()));
+}
+
+GroupingLevel
+createColumnarGL(size_t maxGroups) {
+    GroupingLevel l;
+    l.setMaxGroups(maxGroups);
+    l.setExpression(MU<AttributeNode>("key"));
+    l.addResult(CountAggregationResult().setExpression(MU<ConstantNode>(MU<Int64ResultNode>(0))));
+    l.addResult(SumAggregationResult().setExpression(MU<AttributeNode>("ival")));
+    l.addResult(SumAggregationResult().setExpression(MU<AttributeNode>("fval")));
+    l.addResult(AverageAggregationResult().setExpression(MU<AttributeNode>("ival")));
+    l.addResult(AverageAggregationResult().setExpression(MU<AttributeNode>("fval")));
+    return l;
+}
+
+TEST("require that single level attribute grouping uses the columnar grouper")
+{
+    AggregationContext ctx;
+    IntAttrBuilder key("key");
+    IntAttrBuilder ival("ival");
+    FloatAttrBuilder fval("fval");
+    constexpr uint32_t numDocs = 1000;
+    for (uint32_t docid = 0; docid < numDocs; ++docid) {
+        key.add(docid % 7);
+        ival.add(int64_t(docid) * 3 - 500);
+        fval.add(docid * 0.1);
+        ctx.result().add(docid, docid % 13);
+    }
+    ctx.add(key.sp());
+    ctx.add(ival.sp());
+    ctx.add(fval.sp());
+    ctx.add(IntArrayAttrBuilder("array").add(std::vector<int64_t>{1, 2}).sp());
+
+    for (size_t maxGroups : {size_t(-1), size_t(3)}) {
+        struct Expect {
+            uint64_t count = 0;
+            int64_t  isum = 0;
+            double   fsum = 0.0;
+            double   rank = 0.0;
+        };
+        std::map<int64_t, Expect> expect;
+        for (uint32_t i = 0; i < ctx.result().size(); ++i) {
+            const RankedHit &hit = ctx.result().hits()[i];
+            int64_t k = hit.getDocId() % 7;
+            if ((expect.find(k) == expect.end()) && (expect.size() >= std::min(maxGroups, size_t(7)))) {
+                continue;
+            }
+            Expect &e = expect[k];
+            ++e.count;
+            e.isum += int64_t(hit.getDocId()) * 3 - 500;
+            e.fsum += hit.getDocId() * 0.1;
+            e.rank = std::max(e.rank, hit.getRank());
+        }
+        Grouping request;
+        request.setLastLevel(1).addLevel(createColumnarGL(maxGroups));
+        ctx.setup(request);
+        request.preAggregate(!request.needResort());
+        EXPECT_TRUE(ColumnarGrouper::create(request) != nullptr);
+        request.postAggregate();
+        request.aggregate(ctx.result().hits(), ctx.result().size());
+        const Group &root = request.getRoot();
+        ASSERT_EQUAL(expect.size(), root.getChildrenSize());
+        for (uint32_t i = 0; i < root.getChildrenSize(); ++i) {
+            const Group &group = root.getChild(i);
+            int64_t k = group.getId().getInteger();
+            ASSERT_TRUE(expect.find(k) != expect.end());
+            const Expect &e = expect[k];
+            EXPECT_EQUAL(e.rank, group.getRank());
+            EXPECT_EQUAL(e.count, static_cast<const CountAggregationResult &>(group.getAggregationResult(0)).getCount());
+            EXPECT_EQUAL(e.isum, static_cast<const SumAggregationResult &>(group.getAggregationResult(1)).getSum().getInteger());
+            EXPECT_EQUAL(e.fsum, static_cast<const SumAggregationResult &>(group.getAggregationResult(2)).getSum().getFloat());
+            const auto &iavg = static_cast<const AverageAggregationResult &>(group.getAggregationResult(3));
+            EXPECT_EQUAL(e.isum, iavg.getSum().getInteger());
+            EXPECT_EQUAL(e.count, iavg.getCount());
+            const auto &favg = static_cast<const AverageAggregationResult &>(group.getAggregationResult(4));
+            EXPECT_EQUAL(e.fsum, favg.getSum().getFloat());
+            EXPECT_EQUAL(e.count, favg.getCount());
+        }
+    }
+    { // multi value attributes are handled by the generic engine
+        Grouping request;
+        request.setLastLevel(1).addLevel(createGL(MU<AttributeNode>("array"), MU<AttributeNode>("ival")));
+        ctx.setup(request);
+        request.preAggregate(false);
+        EXPECT_TRUE(ColumnarGrouper::create(request) == nullptr);
+        request.postAggregate();
+    }
+    { // as are aggregations other than count, sum and avg
+        Grouping request;
+        request.setLastLevel(1).addLevel(std::move(GroupingLevel()
+                                                           .setExpression(MU<AttributeNode>("key"))
+                                                           .addResult(MaxAggregationResult().setExpression(MU<AttributeNode>("ival")))));
+        ctx.setup(request);
+        request.preAggregate(false);
+        EXPECT_TRUE(ColumnarGrouper::create(request) == nullptr);
+        request.postAggregate();
+    }
+}
+
 TEST("testFS4HitCollection")
 {
     { // aggregation
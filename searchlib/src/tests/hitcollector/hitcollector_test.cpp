@@ -552,4 +552,28 @@ TEST("require that hits can be added out of order only after passing array limit
     TEST_DO(checkResult(*rs, nullptr));
 }
 
+TEST("require that hits below shared threshold are not ranked") {
+    SharedScoreThreshold threshold;
+    HitCollector first(100, 5);
+    HitCollector second(100, 5);
+    first.set_shared_threshold(&threshold);
+    second.set_shared_threshold(&threshold);
+    for (uint32_t i = 0; i < 10; ++i) {
+        first.addHit(i, 100 + i);
+    }
+    EXPECT_EQUAL(105.0, threshold.get());
+    for (uint32_t i = 50; i < 60; ++i) {
+        second.addHit(i, i);
+    }
+    // Hits 55-59 could not displace the first ranked hits as they score below the threshold
+    std::unique_ptr<ResultSet> rs = second.getResultSet();
+    std::vector<RankedHit> expRh;
+    for (uint32_t i = 50; i < 55; ++i) {
+        expRh.emplace_back(i, i);
+    }
+    TEST_DO(checkResult(*rs, expRh));
+    EXPECT_EQUAL(10u, rs->getNumHits());
+    EXPECT_EQUAL(105.0, threshold.get());
+}
+
 TEST_MAIN() { TEST_RUN_ALL(); }
@@ -0,0 +1,129 @@
+// Copyright Vespa.ai. Licensed under the terms of the Apache 2.0 license. See LICENSE in the project root.
+
+#include <vespa/searchlib/memoryindex/compressed_posting_list.h>
+#include <vespa/vespalib/datastore/entryref.h>
+#include <vespa/vespalib/gtest/gtest.h>
+#include <vector>
+
+using namespace search::memoryindex;
+using vespalib::datastore::EntryRef;
+
+namespace {
+
+struct Entry {
+    uint32_t doc_id;
+    uint32_t features;
+    uint16_t num_occs;
+    uint16_t field_length;
+};
+
+std::vector<Entry>
+make_entries(uint32_t num_docs, uint32_t stride)
+{
+    std::vector<Entry> result;
+    for (uint32_t i = 0; i < num_docs; ++i) {
+        uint32_t doc_id = 1 + i * stride;
+        result.push_back({doc_id, doc_id * 10, static_cast<uint16_t>(1 + i % 7), static_cast<uint16_t>(100 + i % 300)});
+    }
+    return result;
+}
+
+template <bool interleaved_features>
+std::vector<uint8_t>
+build(const std::vector<Entry>& entries)
+{
+    CompressedPostingListBuilder<interleaved_features> builder;
+    for (const auto& entry : entries) {
+        builder.add(entry.doc_id, EntryRef(entry.features), entry.num_occs, entry.field_length);
+    }
+    EXPECT_EQ(entries.size(), builder.num_docs());
+    return builder.finish();
+}
+
+}
+
+template <bool interleaved_features>
+void
+assert_round_trip(const std::vector<Entry>& entries)
+{
+    auto block = build<interleaved_features>(entries);
+    EXPECT_EQ(0u, block.size() % 4);
+    EXPECT_EQ(block.size(), CompressedPostingListFormat::byte_size(block.data()));
+    EXPECT_EQ(entries.size(), CompressedPostingListFormat::num_docs(block.data()));
+    CompressedPostingListReader<interleaved_features> reader;
+    reader.setup(block.data());
+    EXPECT_EQ(entries.size(), reader.size());
+    for (const auto& entry : entries) {
+        ASSERT_TRUE(reader.valid());
+        EXPECT_EQ(entry.doc_id, reader.get_doc_id());
+        EXPECT_EQ(entry.features, reader.get_features().ref());
+        if constexpr (interleaved_features) {
+            EXPECT_EQ(entry.num_occs, reader.get_num_occs());
+            EXPECT_EQ(entry.field_length, reader.get_field_length());
+        }
+        reader.next();
+    }
+    EXPECT_FALSE(reader.valid());
+}
+
+TEST(CompressedPostingListTest, empty_block_has_no_documents)
+{
+    auto block = build<false>({});
+    CompressedPostingListReader<false> reader;
+    reader.setup(block.data());
+    EXPECT_FALSE(reader.valid());
+    EXPECT_EQ(0u, reader.size());
+    EXPECT_FALSE(reader.contains(1));
+}
+
+TEST(CompressedPostingListTest, entries_can_be_read_back)
+{
+    assert_round_trip<false>(make_entries(1, 1));
+    assert_round_trip<false>(make_entries(200, 3));
+    assert_round_trip<false>(make_entries(300, 100000));
+}
+
+TEST(CompressedPostingListTest, interleaved_features_can_be_read_back)
+{
+    assert_round_trip<true>(make_entries(1, 1));
+    assert_round_trip<true>(make_entries(200, 3));
+}
+
+TEST(CompressedPostingListTest, seek_uses_skip_entries_across_groups)
+{
+    auto entries = make_entries(1000, 5);
+    auto block = build<false>(entries);
+    CompressedPostingListReader<false> reader;
+    reader.setup(block.data());
+    reader.seek(1);
+    EXPECT_EQ(1u, reader.get_doc_id());
+    reader.seek(2);
+    EXPECT_EQ(6u, reader.get_doc_id());
+    reader.seek(64 * 5 + 1);
+    EXPECT_EQ(64 * 5 + 1, reader.get_doc_id());
+    reader.seek(2000);
+    EXPECT_EQ(2001u, reader.get_doc_id());
+    EXPECT_EQ(2001u * 10, reader.get_features().ref());
+    reader.seek(1000);
+    EXPECT_EQ(2001u, reader.get_doc_id());
+    reader.seek(entries.back().doc_id);
+    ASSERT_TRUE(reader.valid());
+    EXPECT_EQ(entries.back().doc_id, reader.get_doc_id());
+    reader.seek(entries.back().doc_id + 1);
+    EXPECT_FALSE(reader.valid());
+}
+
+TEST(CompressedPostingListTest, contains_does_not_move_reader)
+{
+    auto block = build<true>(make_entries(500, 2));
+    CompressedPostingListReader<true> reader;
+    reader.setup(block.data());
+    reader.seek(401);
+    EXPECT_TRUE(reader.contains(1));
+    EXPECT_TRUE(reader.contains(999));
+    EXPECT_FALSE(reader.contains(2));
+    EXPECT_FALSE(reader.contains(1000));
+    EXPECT_EQ(401u, reader.get_doc_id());
+}
+
+GTEST_MAIN_RUN_ALL_TESTS()
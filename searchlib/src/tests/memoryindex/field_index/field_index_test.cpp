@@ -19,6 +19,7 @@
 #include <vespa/searchlib/memoryindex/field_inverter.h>
 #include <vespa/searchlib/memoryindex/ordered_field_index_inserter.h>
 #include <vespa/searchlib/memoryindex/posting_iterator.h>
+#include <vespa/searchlib/memoryindex/sharded_field_index.h>
 #include <vespa/searchlib/queryeval/iterators.h>
 #include <vespa/searchlib/test/doc_builder.h>
 #include <vespa/searchlib/test/schema_builder.h>
@@ -30,6 +31,10 @@
 #include <vespa/vespalib/util/gate.h>
 #include <vespa/vespalib/util/destructor_callbacks.h>
 #include <vespa/vespalib/util/sequencedtaskexecutor.h>
+#include <vespa/vespalib/util/threadstackexecutor.h>
+#include <functional>
+#include <map>
+#include <mutex>
 #include <unordered_set>
 
 #include <vespa/vespalib/gtest/gtest.h>
@@ -66,21 +71,31 @@ namespace memoryindex {
 using test::WrapInserter;
 using NormalFieldIndex = FieldIndex<false>;
 
-class MyBuilder : public IndexBuilder {
+class MyFieldBuilder : public FieldIndexBuilder {
 private:
+    std::function<void(const std::string &)> _done;
     std::stringstream _ss;
     bool              _insideWord;
-    bool              _insideField;
     bool              _firstWord;
-    bool              _firstField;
     bool              _firstDoc;
 
 public:
-    explicit MyBuilder(const Schema &schema);
-    ~MyBuilder() override;
+    MyFieldBuilder(uint32_t fieldId, std::function<void(const std::string &)> done)
+        : _done(std::move(done)),
+          _ss(),
+          _insideWord(false),
+          _firstWord(true),
+          _firstDoc(true)
+    {
+        _ss << "f=" << fieldId << "[";
+    }
+    ~MyFieldBuilder() override {
+        assert(!_insideWord);
+        _ss << "]";
+        _done(_ss.str());
+    }
 
     void startWord(vespalib::stringref word) override {
-        assert(_insideField);
         assert(!_insideWord);
         if (!_firstWord)
             _ss << ",";
@@ -96,22 +111,6 @@ public:
         _insideWord = false;
     }
 
-    void startField(uint32_t fieldId) override {
-        assert(!_insideField);
-        if (!_firstField) _ss << ",";
-        _ss << "f=" << fieldId << "[";
-        _firstWord = true;
-        _insideField = true;
-    }
-
-    void endField() override {
-        assert(_insideField);
-        assert(!_insideWord);
-        _ss << "]";
-        _firstField = false;
-        _insideField = false;
-    }
-
     void add_document(const DocIdAndFeatures &features) override {
         assert(_insideWord);
         if (!_firstDoc) {
@@ -140,20 +139,49 @@ public:
         _ss << "]";
         _firstDoc = false;
     }
+};
 
-    std::string toStr() const {
-        return _ss.str();
+/*
+ * Index builder that renders the dumped fields as a string, ordered by
+ * field id so the result does not depend on whether fields are dumped
+ * in parallel.
+ */
+class MyBuilder : public IndexBuilder {
+private:
+    std::mutex                      _lock;
+    std::map<uint32_t, std::string> _fields;
+
+public:
+    explicit MyBuilder(const Schema &schema);
+    ~MyBuilder() override;
+
+    std::unique_ptr<FieldIndexBuilder> startField(uint32_t fieldId) override {
+        std::lock_guard guard(_lock);
+        assert(_fields.find(fieldId) == _fields.end());
+        _fields[fieldId] = "";
+        return std::make_unique<MyFieldBuilder>(fieldId, [this, fieldId](const std::string &str) {
+            std::lock_guard done_guard(_lock);
+            _fields[fieldId] = str;
+        });
+    }
+
+    std::string toStr() {
+        std::lock_guard guard(_lock);
+        std::string result;
+        for (const auto &field : _fields) {
+            if (!result.empty()) {
+                result += ",";
+            }
+            result += field.second;
+        }
+        return result;
     }
 };
 
 MyBuilder::MyBuilder(const Schema &schema)
     : IndexBuilder(schema),
-      _ss(),
-      _insideWord(false),
-      _insideField(false),
-      _firstWord(true),
-      _firstField(true),
-      _firstDoc(true)
+      _lock(),
+      _fields()
 {}
 MyBuilder::~MyBuilder() = default;
 
@@ -657,6 +685,82 @@ TYPED_TEST(FieldIndexTest, require_that_posting_iterator_is_working)
     }
 }
 
+std::string
+dump_field_index(IFieldIndex& field_index)
+{
+    std::string result;
+    {
+        MyFieldBuilder builder(0, [&result](const std::string& str) { result = str; });
+        field_index.dump(builder);
+    }
+    return result;
+}
+
+TEST(ShardedFieldIndexTest, dump_gives_sorted_words_and_same_postings_as_unsharded_field_index)
+{
+    Schema schema(make_all_index_schema(make_single_add_fields()));
+    NormalFieldIndex idx(schema, 0);
+    ShardedFieldIndex<false> sharded_idx(schema, 0, FieldLengthInfo(), 4);
+    std::vector<vespalib::string> words({"golf", "alpha", "echo", "hotel", "charlie", "bravo", "foxtrot", "delta"});
+    std::unordered_set<uint32_t> used_shards;
+    uint32_t word_num = 0;
+    for (const auto& word : words) {
+        ++word_num;
+        uint32_t shard = get_word_shard(word, sharded_idx.get_num_shards());
+        used_shards.insert(shard);
+        for (auto* field_index : std::vector<IFieldIndex*>({&idx, &sharded_idx.get_shard_index(shard)})) {
+            WrapInserter(*field_index).rewind().word(word).
+                add(word_num, getFeatures(4, 1)).
+                add(word_num + 10, getFeatures(5, word_num % 3 + 1)).
+                add(30, getFeatures(6, 1)).flush();
+        }
+    }
+    EXPECT_LT(1u, used_shards.size());
+    idx.commit();
+    sharded_idx.commit();
+    EXPECT_EQ(idx.getNumUniqueWords(), sharded_idx.getNumUniqueWords());
+    auto exp = dump_field_index(idx);
+    EXPECT_EQ(0u, exp.find("f=0[w=alpha[d=2[e=0,w=1,l=4[0]],d=12[e=0,w=1,l=5[0,1,2]],d=30[e=0,w=1,l=6[0]]],w=bravo["));
+    EXPECT_EQ(exp, dump_field_index(sharded_idx));
+}
+
+TEST(CompressedFieldIndexTest, compact_and_dump_of_compressed_posting_lists_with_removes)
+{
+    Schema schema(make_all_index_schema(make_single_add_fields()));
+    NormalFieldIndex idx(schema, 0);
+    NormalFieldIndex plain_idx(schema, 0);
+    idx.set_posting_list_compression(4);
+    for (auto* field_index : {&idx, &plain_idx}) {
+        WrapInserter inserter(*field_index);
+        inserter.word("a");
+        for (uint32_t docid = 1; docid <= 8; ++docid) {
+            inserter.add(docid, getFeatures(docid + 3, docid % 3 + 1));
+        }
+        inserter.word("b").add(1, getFeatures(4, 1)).add(2, getFeatures(5, 2)).
+            word("c").add(1, getFeatures(4, 1)).add(2, getFeatures(5, 1)).
+            add(3, getFeatures(6, 1)).add(4, getFeatures(7, 2)).flush();
+        field_index->commit();
+        // Recompresses "c", leaving docs 4 and 10 in its compressed block
+        WrapInserter(*field_index).rewind().word("a").remove(2).remove(5).
+            word("c").remove(1).remove(2).remove(3).add(10, getFeatures(8, 1)).flush();
+        field_index->commit();
+        // Leaves only tombstones for the documents in the compressed block of "c"
+        WrapInserter(*field_index).rewind().word("c").remove(4).remove(10).flush();
+        field_index->commit();
+    }
+    EXPECT_EQ(0u, idx.find("a").getKey());
+    EXPECT_EQ(1u, idx.find("b").getKey());
+    EXPECT_EQ(0u, idx.find("c").getKey());
+    EXPECT_TRUE(assertPostingList("[1,3,4,6,7,8]", plain_idx.find("a")));
+    EXPECT_FALSE(plain_idx.find("c").valid());
+    auto exp = dump_field_index(plain_idx);
+    EXPECT_EQ(std::string::npos, exp.find("w=c"));
+    EXPECT_EQ(exp, dump_field_index(idx));
+    idx.compactFeatures();
+    idx.commit();
+    EXPECT_EQ(exp, dump_field_index(idx));
+}
+
 struct FieldIndexInterleavedFeaturesTest : public FieldIndexTest<FieldIndex<true>> {
     SimpleMatchData match_data;
     FieldIndexInterleavedFeaturesTest()
@@ -827,17 +931,17 @@ TEST_F(FieldIndexCollectionTest, require_that_basic_dumping_to_index_builder_is_
 {
     MyBuilder b(schema);
     WordDocElementWordPosFeatures wpf;
-    b.startField(4);
-    b.startWord("a");
+    auto fb = b.startField(4);
+    fb->startWord("a");
     DocIdAndFeatures features;
     features.set_doc_id(2);
     features.elements().emplace_back(0, 10, 20);
     features.elements().back().setNumOccs(2);
     features.word_positions().emplace_back(1);
     features.word_positions().emplace_back(3);
-    b.add_document(features);
-    b.endWord();
-    b.endField();
+    fb->add_document(features);
+    fb->endWord();
+    fb.reset();
     EXPECT_EQ("f=4[w=a[d=2[e=0,w=10,l=20[1,3]]]]", b.toStr());
 }
 
@@ -875,6 +979,24 @@ TEST_F(FieldIndexCollectionTest, require_that_dumping_of_multiple_fields_to_inde
               b.toStr());
 }
 
+TEST_F(FieldIndexCollectionTest, require_that_parallel_dumping_gives_same_result_as_sequential_dumping)
+{
+    WrapInserter(fic, 1).word("a").add(5, getFeatures(2, 1)).
+            add(7, getFeatures(3, 2)).
+            word("b").add(5, getFeatures(12, 2)).flush();
+    WrapInserter(fic, 2).word("a").add(5, getFeatures(4, 1)).flush();
+    WrapInserter(fic, 3).word("c").add(7, getFeatures(10, 1)).flush();
+    MyBuilder expected(schema);
+    fic.dump(expected);
+    vespalib::ThreadStackExecutor executor(4);
+    for (uint32_t max_concurrent_fields : {0u, 1u, 2u, 4u, 8u}) {
+        SCOPED_TRACE(max_concurrent_fields);
+        MyBuilder b(schema);
+        fic.dump(b, executor, max_concurrent_fields);
+        EXPECT_EQ(expected.toStr(), b.toStr());
+    }
+}
+
 TEST_F(FieldIndexCollectionTest, require_that_dumping_words_with_no_docs_to_index_builder_is_working)
 {
     WrapInserter(fic, 0).word("a").add(2, getFeatures(2, 1)).
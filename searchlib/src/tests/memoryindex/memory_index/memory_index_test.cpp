@@ -39,6 +39,7 @@ using search::index::FieldLengthInfo;
 using search::index::IFieldLengthInspector;
 using search::query::Node;
 using search::query::SimplePhrase;
+using search::query::SimpleFuzzyTerm;
 using search::query::SimpleStringTerm;
 using search::test::DocBuilder;
 using search::test::SchemaBuilder;
@@ -109,6 +110,7 @@ struct Index {
     bool         add_space;
 
     Index(const MySetup &setup);
+    Index(const MySetup &setup, uint32_t num_push_shards);
     ~Index();
     void closeField() {
         if (!currentField.empty()) {
@@ -166,10 +168,15 @@ VESPA_THREAD_STACK_TAG(invert_executor)
 VESPA_THREAD_STACK_TAG(push_executor)
 
 Index::Index(const MySetup &setup)
+    : Index(setup, 1)
+{
+}
+
+Index::Index(const MySetup &setup, uint32_t num_push_shards)
     : _executor(1),
       _invertThreads(SequencedTaskExecutor::create(invert_executor, 2)),
       _pushThreads(SequencedTaskExecutor::create(push_executor, 2)),
-      index(setup.make_all_index_schema(), setup, *_invertThreads, *_pushThreads),
+      index(setup.make_all_index_schema(), setup, *_invertThreads, *_pushThreads, num_push_shards),
       builder([&setup](auto& header) { setup.add_fields(header); }),
       sfb(builder),
       builder_doc(),
@@ -277,6 +284,10 @@ SimpleStringTerm makeTerm(const std::string &term) {
     return SimpleStringTerm(term, "field", 0, search::query::Weight(0));
 }
 
+SimpleFuzzyTerm makeFuzzyTerm(const std::string &term, uint32_t max_edits, uint32_t prefix_length) {
+    return SimpleFuzzyTerm(term, "field", 0, search::query::Weight(0), max_edits, prefix_length);
+}
+
 Node::UP makePhrase(const std::string &term1, const std::string &term2) {
     auto phrase = std::make_unique<SimplePhrase>("field", 0, search::query::Weight(0));
     phrase->append(std::make_unique<SimpleStringTerm>(makeTerm(term1)));
@@ -372,6 +383,114 @@ TEST(MemoryIndexTest, require_that_documents_can_be_removed_and_updated)
                             index.index, title, makeTerm(foo)));
 }
 
+TEST(MemoryIndexTest, require_that_sharded_field_index_handles_adds_removes_and_updates)
+{
+    Index index(MySetup().field(title).field(body), 4);
+    std::vector<std::string> words{"alpha", "bravo", "charlie", "delta", "echo", "foxtrot", foo, bar};
+
+    for (uint32_t docid = 1; docid <= 4; ++docid) {
+        index.doc(docid).field(title);
+        for (auto& word : words) {
+            index.add(word);
+        }
+        index.field(body).add(foo).commit();
+    }
+    index.remove(2);
+    index.doc(3).field(title).add(bar).add(foo).field(body).add(bar).commit();
+
+    EXPECT_TRUE(verifyResult(FakeResult()
+                            .doc(1).len(8).pos(6)
+                            .doc(3).len(2).pos(1)
+                            .doc(4).len(8).pos(6),
+                            index.index, title, makeTerm(foo)));
+    for (uint32_t pos = 0; pos < 6; ++pos) {
+        EXPECT_TRUE(verifyResult(FakeResult()
+                                .doc(1).len(8).pos(pos)
+                                .doc(4).len(8).pos(pos),
+                                index.index, title, makeTerm(words[pos])));
+    }
+    EXPECT_TRUE(verifyResult(FakeResult()
+                            .doc(1).len(1).pos(0)
+                            .doc(4).len(1).pos(0),
+                            index.index, body, makeTerm(foo)));
+    EXPECT_TRUE(verifyResult(FakeResult()
+                            .doc(3).len(1).pos(0),
+                            index.index, body, makeTerm(bar)));
+}
+
+void
+verify_fuzzy_search(uint32_t num_push_shards)
+{
+    Index index(MySetup().field(title), num_push_shards);
+    index.doc(1).field(title).add("fooo").commit();
+    index.doc(2).field(title).add(bar).add("foa").commit();
+    index.doc(3).field(title).add("fxxx").commit();
+    index.doc(4).field(title).add(foo).commit();
+    index.doc(5).field(title).add("xoo").commit();
+
+    EXPECT_TRUE(verifyResult(FakeResult()
+                            .doc(1).len(1).pos(0)
+                            .doc(2).len(2).pos(1)
+                            .doc(4).len(1).pos(0)
+                            .doc(5).len(1).pos(0),
+                            index.index, title, makeFuzzyTerm(foo, 1, 0)));
+    EXPECT_TRUE(verifyResult(FakeResult()
+                            .doc(1).len(1).pos(0)
+                            .doc(2).len(2).pos(1)
+                            .doc(4).len(1).pos(0),
+                            index.index, title, makeFuzzyTerm(foo, 1, 1)));
+    EXPECT_TRUE(verifyResult(FakeResult()
+                            .doc(4).len(1).pos(0),
+                            index.index, title, makeFuzzyTerm(foo, 0, 0)));
+    EXPECT_TRUE(verifyResult(FakeResult()
+                            .doc(5).len(1).pos(0),
+                            index.index, title, makeFuzzyTerm("xoo", 2, 1)));
+    EXPECT_TRUE(verifyResult(FakeResult(),
+                            index.index, title, makeFuzzyTerm("zzzzz", 2, 0)));
+}
+
+TEST(MemoryIndexTest, fuzzy_term_is_expanded_through_the_dictionary)
+{
+    verify_fuzzy_search(1);
+}
+
+TEST(MemoryIndexTest, fuzzy_term_is_expanded_through_all_dictionary_shards)
+{
+    verify_fuzzy_search(4);
+}
+
+TEST(MemoryIndexTest, require_that_compressed_posting_lists_handle_adds_removes_and_updates)
+{
+    Index index(MySetup().field(title).field(body));
+    index.index.set_posting_list_compression(4);
+
+    for (uint32_t docid = 1; docid <= 10; ++docid) {
+        index.doc(docid).field(title).add(foo).field(body).add(bar).commit();
+    }
+    index.remove(2);
+    index.remove(9);
+    index.doc(5).field(title).add(bar).add(foo).field(body).add(bar).commit();
+
+    FakeResult expect;
+    for (uint32_t docid : {1, 3, 4, 5, 6, 7, 8, 10}) {
+        if (docid == 5) {
+            expect.doc(docid).len(2).pos(1);
+        } else {
+            expect.doc(docid).len(1).pos(0);
+        }
+    }
+    EXPECT_TRUE(verifyResult(expect, index.index, title, makeTerm(foo)));
+    EXPECT_TRUE(verifyResult(FakeResult().doc(5).len(2).pos(0),
+                             index.index, title, makeTerm(bar)));
+    for (uint32_t docid = 11; docid <= 20; ++docid) {
+        index.doc(docid).field(title).add(foo).commit();
+    }
+    for (uint32_t docid = 11; docid <= 20; ++docid) {
+        expect.doc(docid).len(1).pos(0);
+    }
+    EXPECT_TRUE(verifyResult(expect, index.index, title, makeTerm(foo)));
+}
+
 // test the fake field source here, to make sure it acts similar to
 // the memory index field source.
 TEST(MemoryIndexTest, test_fake_searchable)
@@ -23,7 +23,7 @@ TEST("require that empty interval list gives invalid ref") {
     ASSERT_FALSE(ref.valid());
 }
 
-Interval single_buf;
+Interval decode_buf[PredicateIntervalStore::MAX_PACKED_INTERVALS];
 
 template <typename IntervalT>
 void testInsertAndRetrieve(const std::vector<IntervalT> &interval_list) {
@@ -38,8 +38,8 @@ void testInsertAndRetrieve(const std::vector<IntervalT> &interval_list) {
     ASSERT_TRUE(ref.valid());
 
     uint32_t size;
-    IntervalT single;
-    const IntervalT *intervals = store.get(ref, size, &single);
+    IntervalT buf[PredicateIntervalStore::MAX_PACKED_INTERVALS];
+    const IntervalT *intervals = store.get(ref, size, buf);
     EXPECT_EQUAL(interval_list.size(), size);
     ASSERT_TRUE(intervals);
     for (size_t i = 0; i < interval_list.size(); ++i) {
@@ -75,7 +75,7 @@ TEST("require that multiple multi-interval entries can be retrieved") {
     ASSERT_TRUE(ref.valid());
 
     uint32_t size;
-    const Interval *intervals = store.get(ref, size, &single_buf);
+    const Interval *intervals = store.get(ref, size, decode_buf);
     EXPECT_EQUAL(2u, size);
     ASSERT_TRUE(intervals);
     EXPECT_EQUAL(3u, intervals[0].interval);
@@ -110,7 +110,7 @@ TEST("require that entries can be removed and reused") {
                                         {6}, {7}, {8}, {9}, {10}});
     ASSERT_EQUAL(ref2.ref(), ref4.ref());
 
-    const Interval *intervals = store.get(ref4, size, &single_buf);
+    const Interval *intervals = store.get(ref4, size, decode_buf);
     EXPECT_EQUAL(9u, size);
     EXPECT_EQUAL(2u, intervals[0].interval);
     EXPECT_EQUAL(10u, intervals[8].interval);
@@ -124,13 +124,39 @@ TEST("require that single interval entries are optimized") {
     ASSERT_EQUAL(0x0001ffffu, ref.ref());
 
     uint32_t size;
-    const Interval *intervals = store.get(ref, size, &single_buf);
-    ASSERT_EQUAL(intervals, &single_buf);
-    EXPECT_EQUAL(0x0001ffffu, single_buf.interval);
+    const Interval *intervals = store.get(ref, size, decode_buf);
+    ASSERT_EQUAL(intervals, decode_buf);
+    EXPECT_EQUAL(0x0001ffffu, decode_buf[0].interval);
 
     store.remove(ref);  // Should do nothing
 }
 
+TEST("require that short entries with small intervals are packed") {
+    testInsertAndRetrieve<Interval>({{0x00010001}, {0x00020003}});
+    testInsertAndRetrieve<Interval>({{0x00010001}, {0x00020003}, {0x000000ff}});
+    testInsertAndRetrieve<Interval>({{0x00ff00fe}, {0x00030002}, {0x00020001}, {0x00010000}});
+    PredicateIntervalStore store;
+    auto before = store.getMemoryUsage().usedBytes();
+    auto ref = store.insert<Interval>({{0x00010001}, {0x00020002}, {0x00030003}, {0x00040004}});
+    EXPECT_EQUAL(2u, ref.ref() >> 24);  // size in words
+    EXPECT_EQUAL(before + 2 * sizeof(uint32_t), store.getMemoryUsage().usedBytes());
+    auto ref2 = store.insert<Interval>({{0x00010001}, {0x00020002}, {0x00030003}, {0x00040004}});
+    EXPECT_EQUAL(ref.ref(), ref2.ref());
+}
+
+TEST("require that entries with large or many intervals are not packed") {
+    testInsertAndRetrieve<Interval>({{0x00010100}, {0x00020002}});
+    testInsertAndRetrieve<Interval>({{0x01000001}, {0x00020002}});
+    std::vector<Interval> intervals;
+    for (uint32_t i = 1; i <= PredicateIntervalStore::MAX_PACKED_INTERVALS + 1; ++i) {
+        intervals.emplace_back((i << 16) | i);
+    }
+    testInsertAndRetrieve<Interval>(intervals);
+    PredicateIntervalStore store;
+    auto ref = store.insert<Interval>({{0x00010100}, {0x00020002}});
+    EXPECT_EQUAL(2u, ref.ref() >> 24);
+}
+
 TEST("require that interval refs are reused for identical data.") {
     PredicateIntervalStore store;
     auto ref = store.insert<Interval>({{0x00010001}, {0x0002ffff}});
@@ -141,7 +167,7 @@ TEST("require that interval refs are reused for identical data.") {
     EXPECT_EQUAL(ref.ref(), ref2.ref());
 
     uint32_t size;
-    const Interval *intervals = store.get(ref, size, &single_buf);
+    const Interval *intervals = store.get(ref, size, decode_buf);
     EXPECT_EQUAL(0x00010001u, intervals[0].interval);
     EXPECT_EQUAL(0x0002ffffu, intervals[1].interval);
 }
@@ -4,6 +4,7 @@
 #include <vespa/searchlib/parsequery/parse.h>
 #include <vespa/searchlib/parsequery/stackdumpiterator.h>
 #include <vespa/searchlib/query/tree/simplequery.h>
+#include <vespa/searchlib/query/tree/string_term_vector.h>
 #include <vespa/searchlib/util/rawbuf.h>
 #include <vespa/vespalib/testkit/testapp.h>
 
@@ -105,4 +106,26 @@ TEST("require that PredicateQueryItem stack dump item can be read") {
 
 }  // namespace
 
+TEST("require that multi term strings are packed and zero terminated") {
+    StringTermVector terms(3);
+    terms.addTerm("foo");
+    terms.addTerm("");
+    terms.addTerm("42");
+    ASSERT_EQUAL(3u, terms.size());
+    EXPECT_EQUAL("foo", terms.getAsString(0).first);
+    EXPECT_EQUAL("", terms.getAsString(1).first);
+    EXPECT_EQUAL("42", terms.getAsString(2).first);
+    EXPECT_EQUAL('\0', terms.getAsString(0).first.data()[3]);
+    EXPECT_EQUAL(42, terms.getAsInteger(2).first);
+
+    SimpleWeightedSetTerm ws(2, "view", 0, Weight(1));
+    ws.addTerm("a", Weight(3));
+    ws.addTerm("bcd", Weight(5));
+    EXPECT_EQUAL("a", ws.getAsString(0).first);
+    EXPECT_EQUAL(3, ws.getAsString(0).second.percent());
+    EXPECT_EQUAL("bcd", ws.getAsString(1).first);
+    EXPECT_EQUAL(5, ws.getAsString(1).second.percent());
+    EXPECT_EQUAL('\0', ws.getAsString(1).first.data()[3]);
+}
+
 TEST_MAIN() { TEST_RUN_ALL(); }
@@ -0,0 +1,324 @@
+// Copyright Vespa.ai. Licensed under the terms of the Apache 2.0 license. See LICENSE in the project root.
+
+// Measures the per-document cost of strict and non-strict evaluation
+// of the most common leaf iterator types on this machine and writes a
+// flow cost table that can be loaded by proton (see FlowCostTable).
+
+#include <vespa/searchcommon/attribute/config.h>
+#include <vespa/searchlib/attribute/attribute_blueprint_factory.h>
+#include <vespa/searchlib/attribute/attributecontext.h>
+#include <vespa/searchlib/fef/matchdata.h>
+#include <vespa/searchlib/fef/matchdatalayout.h>
+#include <vespa/searchlib/fef/termfieldmatchdata.h>
+#include <vespa/searchlib/fef/termfieldmatchdataarray.h>
+#include <vespa/searchlib/query/tree/simplequery.h>
+#include <vespa/searchlib/queryeval/blueprint.h>
+#include <vespa/searchlib/queryeval/fake_requestcontext.h>
+#include <vespa/searchlib/queryeval/field_spec.h>
+#include <vespa/searchlib/queryeval/flow_cost_table.h>
+#include <vespa/searchlib/test/attribute_builder.h>
+#include <vespa/searchlib/test/fakedata/fakeposting.h>
+#include <vespa/searchlib/test/fakedata/fakeword.h>
+#include <vespa/searchlib/test/fakedata/fakewordset.h>
+#include <vespa/searchlib/test/fakedata/fpfactory.h>
+#include <vespa/searchlib/test/mock_attribute_manager.h>
+#include <vespa/vespalib/util/benchmark_timer.h>
+#include <vespa/vespalib/util/rand48.h>
+#include <vespa/vespalib/util/stringfmt.h>
+#include <fstream>
+#include <functional>
+#include <iostream>
+#include <unistd.h>
+
+using search::AttributeVector;
+using search::attribute::BasicType;
+using search::attribute::CollectionType;
+using search::attribute::Config;
+using search::attribute::test::AttributeBuilder;
+using search::attribute::test::MockAttributeManager;
+using search::fef::MatchData;
+using search::fef::MatchDataLayout;
+using search::fef::TermFieldMatchData;
+using search::fef::TermFieldMatchDataArray;
+using search::query::SimpleStringTerm;
+using search::query::Weight;
+using search::queryeval::Blueprint;
+using search::queryeval::ExecuteInfo;
+using search::queryeval::FakeRequestContext;
+using search::queryeval::FieldSpec;
+using search::queryeval::FlowCostTable;
+using search::queryeval::SearchIterator;
+using vespalib::BenchmarkTimer;
+
+using namespace search::fakedata;
+
+namespace {
+
+const std::vector<double> hit_ratios = {0.001, 0.01, 0.1, 0.5};
+
+using IteratorFactory = std::function<std::unique_ptr<SearchIterator>(bool strict)>;
+
+struct Sample {
+    double hit_ratio;
+    double non_strict_ns;    // per document
+    double strict_ns;        // per document
+};
+
+struct Measured {
+    vespalib::string    key;
+    std::vector<Sample> samples;
+};
+
+uint32_t
+non_strict_scan(SearchIterator &itr, uint32_t docid_limit)
+{
+    uint32_t hits = 0;
+    itr.initRange(1, docid_limit);
+    for (uint32_t docid = 1; docid < docid_limit; ++docid) {
+        if (itr.seek(docid)) {
+            ++hits;
+        }
+    }
+    return hits;
+}
+
+uint32_t
+strict_scan(SearchIterator &itr, uint32_t docid_limit)
+{
+    uint32_t hits = 0;
+    itr.initRange(1, docid_limit);
+    for (itr.seek(1); !itr.isAtEnd(); itr.seek(itr.getDocId() + 1)) {
+        ++hits;
+    }
+    return hits;
+}
+
+Sample
+measure(const IteratorFactory &factory, double hit_ratio, uint32_t docid_limit, double budget)
+{
+    auto non_strict_itr = factory(false);
+    auto strict_itr = factory(true);
+    uint32_t non_strict_hits = 0;
+    uint32_t strict_hits = 0;
+    double non_strict_s = BenchmarkTimer::benchmark([&]() { non_strict_hits = non_strict_scan(*non_strict_itr, docid_limit); }, budget);
+    double strict_s = BenchmarkTimer::benchmark([&]() { strict_hits = strict_scan(*strict_itr, docid_limit); }, budget);
+    if (non_strict_hits != strict_hits) {
+        fprintf(stderr, "warning: strict (%u) and non-strict (%u) hit counts differ\n", strict_hits, non_strict_hits);
+    }
+    double ns_per_doc = 1e9 / docid_limit;
+    return {hit_ratio, non_strict_s * ns_per_doc, strict_s * ns_per_doc};
+}
+
+// Average non-strict cost and strict cost per hit ratio (least squares fit through origin)
+std::pair<double, double>
+fit(const std::vector<Sample> &samples)
+{
+    double non_strict_sum = 0.0;
+    double strict_dot = 0.0;
+    double ratio_dot = 0.0;
+    for (const auto &sample : samples) {
+        non_strict_sum += sample.non_strict_ns;
+        strict_dot += sample.strict_ns * sample.hit_ratio;
+        ratio_dot += sample.hit_ratio * sample.hit_ratio;
+    }
+    return {non_strict_sum / samples.size(), strict_dot / ratio_dot};
+}
+
+class Calibration {
+    uint32_t                 _num_docs;
+    double                   _budget;
+    vespalib::Rand48         _rnd;
+    std::vector<Measured>    _measured;
+
+    void measure_fake_posting(const vespalib::string &key, const std::string &posting_type);
+    void measure_attribute(bool fast_search);
+public:
+    Calibration(uint32_t num_docs, double budget);
+    ~Calibration();
+    void run();
+    std::unique_ptr<FlowCostTable> make_table() const;
+    void print_samples() const;
+};
+
+Calibration::Calibration(uint32_t num_docs, double budget)
+    : _num_docs(num_docs),
+      _budget(budget),
+      _rnd(),
+      _measured()
+{
+    _rnd.srand48(32);
+}
+
+Calibration::~Calibration() = default;
+
+void
+Calibration::measure_fake_posting(const vespalib::string &key, const std::string &posting_type)
+{
+    FakeWordSet word_set(false, false);
+    std::unique_ptr<FPFactory> factory(getFPFactory(posting_type, word_set.getSchema()));
+    if (!factory) {
+        fprintf(stderr, "Unknown posting type '%s'\n", posting_type.c_str());
+        return;
+    }
+    Measured measured{key, {}};
+    uint32_t docid_limit = _num_docs + 1;
+    for (double hit_ratio : hit_ratios) {
+        uint32_t word_docs = std::max(1u, uint32_t(hit_ratio * _num_docs));
+        FakeWord word(docid_limit, word_docs, word_docs / 2, "word", _rnd,
+                      word_set.getFieldsParams(), word_set.getPackedIndex());
+        std::vector<const FakeWord *> words;
+        words.push_back(&word);
+        factory->setup(words);
+        auto posting = factory->make(word);
+        TermFieldMatchData tfmd;
+        TermFieldMatchDataArray tfmda;
+        tfmda.add(&tfmd);
+        // posting list iterators are always strict
+        auto make_iterator = [&](bool) { return posting->createIterator(tfmda); };
+        measured.samples.push_back(measure(make_iterator, hit_ratio, docid_limit, _budget));
+    }
+    _measured.push_back(std::move(measured));
+}
+
+void
+Calibration::measure_attribute(bool fast_search)
+{
+    // value i + 1 is used by a fraction hit_ratios[i] of the documents
+    std::vector<int32_t> values(_num_docs, 0);
+    for (auto &value : values) {
+        double draw = _rnd.lrand48() / double(1ul << 31);
+        for (size_t i = 0; i < hit_ratios.size(); ++i) {
+            if (draw < hit_ratios[i]) {
+                value = i + 1;
+                break;
+            }
+            draw -= hit_ratios[i];
+        }
+    }
+    Config cfg(BasicType::INT32, CollectionType::SINGLE);
+    cfg.setFastSearch(fast_search);
+    auto attr = AttributeBuilder("field", cfg).fill(values).get();
+    MockAttributeManager mgr;
+    mgr.addAttribute(attr);
+    search::AttributeContext attr_ctx(mgr);
+    FakeRequestContext request_ctx(&attr_ctx);
+    search::AttributeBlueprintFactory source;
+    MatchDataLayout mdl;
+    auto handle = mdl.allocTermField(0);
+    auto md = mdl.createMatchData();
+    uint32_t docid_limit = attr->getCommittedDocIdLimit();
+    Measured measured{"", {}};
+    for (size_t i = 0; i < hit_ratios.size(); ++i) {
+        SimpleStringTerm term(vespalib::make_string("%zu", i + 1), "field", 0, Weight(0));
+        auto make_iterator = [&](bool strict) {
+            auto bp = source.createBlueprint(request_ctx, FieldSpec("field", 0, handle), term);
+            bp->setDocIdLimit(docid_limit);
+            bp->fetchPostings(ExecuteInfo::createForTest(strict));
+            if (measured.key.empty() && bp->asLeaf() != nullptr && bp->asLeaf()->flow_cost_key() != nullptr) {
+                measured.key = bp->asLeaf()->flow_cost_key();
+            }
+            return bp->createSearch(*md, strict);
+        };
+        measured.samples.push_back(measure(make_iterator, hit_ratios[i], docid_limit, _budget));
+    }
+    _measured.push_back(std::move(measured));
+}
+
+void
+Calibration::run()
+{
+    measure_fake_posting(FlowCostTable::disk_term_key, "Zc4SkipPosOccBE");
+    measure_fake_posting(FlowCostTable::memory_term_key, "MemTreeOcc");
+    measure_attribute(true);
+    measure_attribute(false);
+}
+
+std::unique_ptr<FlowCostTable>
+Calibration::make_table() const
+{
+    auto table = std::make_unique<FlowCostTable>();
+    if (_measured.empty() || _measured[0].key != FlowCostTable::disk_term_key) {
+        return table;
+    }
+    // Costs are normalized to a non-strict disk index term costing 1.0
+    double unit = fit(_measured[0].samples).first;
+    if (!(unit > 0.0)) {
+        return table;
+    }
+    for (const auto &measured : _measured) {
+        if (measured.key.empty()) {
+            continue;
+        }
+        auto [cost, strict_cost] = fit(measured.samples);
+        table->add(measured.key, std::max(cost / unit, 0.001), std::max(strict_cost / unit, 0.001));
+    }
+    return table;
+}
+
+void
+Calibration::print_samples() const
+{
+    for (const auto &measured : _measured) {
+        fprintf(stderr, "%s\n", measured.key.empty() ? "(no flow cost key)" : measured.key.c_str());
+        for (const auto &sample : measured.samples) {
+            fprintf(stderr, "  hit ratio %6.3f: non-strict %8.3f ns/doc, strict %8.3f ns/doc\n",
+                    sample.hit_ratio, sample.non_strict_ns, sample.strict_ns);
+        }
+    }
+}
+
+void
+usage()
+{
+    fprintf(stderr, "Usage: flow_cost_calibration [-d <numDocs>] [-b <budget seconds>] [-o <output file>]\n");
+}
+
+}
+
+int
+main(int argc, char **argv)
+{
+    uint32_t num_docs = 1000000;
+    double budget = 0.5;
+    std::string output;
+    int c;
+    while ((c = getopt(argc, argv, "d:b:o:")) != -1) {
+        switch (c) {
+        case 'd':
+            num_docs = atoi(optarg);
+            break;
+        case 'b':
+            budget = atof(optarg);
+            break;
+        case 'o':
+            output = optarg;
+            break;
+        default:
+            usage();
+            return 1;
+        }
+    }
+    if (num_docs < 1000) {
+        fprintf(stderr, "Too few documents: %u\n", num_docs);
+        return 1;
+    }
+    Calibration calibration(num_docs, budget);
+    calibration.run();
+    calibration.print_samples();
+    auto table = calibration.make_table();
+    if (table->empty()) {
+        fprintf(stderr, "Calibration failed\n");
+        return 1;
+    }
+    if (output.empty()) {
+        table->write(std::cout);
+    } else {
+        std::ofstream file(output);
+        table->write(file);
+        if (!file.good()) {
+            fprintf(stderr, "Could not write '%s'\n", output.c_str());
+            return 1;
+        }
+    }
+    return 0;
+}
@@ -0,0 +1,99 @@
+// Copyright Vespa.ai. Licensed under the terms of the Apache 2.0 license. See LICENSE in the project root.
+
+#include <vespa/searchlib/queryeval/flow_cost_table.h>
+#include <vespa/searchlib/queryeval/leaf_blueprints.h>
+#include <vespa/searchlib/queryeval/simpleresult.h>
+#include <vespa/vespalib/gtest/gtest.h>
+#include <sstream>
+
+using namespace search::queryeval;
+
+const vespalib::string simple_key("simple");
+
+struct KeyedBlueprint : SimpleBlueprint {
+    explicit KeyedBlueprint(const SimpleResult &result) : SimpleBlueprint(result) {}
+    const char *flow_cost_key() const noexcept override { return simple_key.c_str(); }
+};
+
+Blueprint::UP make_optimized_leaf() {
+    SimpleResult result;
+    for (uint32_t docid = 1; docid <= 10; ++docid) {
+        result.addHit(docid);
+    }
+    auto leaf = std::make_unique<KeyedBlueprint>(result);
+    leaf->setDocIdLimit(100);
+    return Blueprint::optimize(std::move(leaf));
+}
+
+TEST(FlowCostTableTest, table_can_be_written_and_read) {
+    FlowCostTable table;
+    table.add(simple_key, 2.5, 0.75);
+    table.add("other", 1.5, 3.0);
+    std::stringstream ss;
+    table.write(ss);
+    FlowCostTable copy;
+    EXPECT_TRUE(copy.read(ss));
+    ASSERT_EQ(2u, copy.entries().size());
+    const auto *entry = copy.lookup("other");
+    ASSERT_TRUE(entry != nullptr);
+    EXPECT_EQ(1.5, entry->cost);
+    EXPECT_EQ(3.0, entry->strict_cost);
+    EXPECT_TRUE(copy.lookup("unknown") == nullptr);
+}
+
+TEST(FlowCostTableTest, malformed_table_is_rejected) {
+    FlowCostTable table;
+    std::istringstream missing_key("1.0 2.0\n");
+    EXPECT_FALSE(table.read(missing_key));
+    std::istringstream bad_cost("foo 2.0 simple\n");
+    EXPECT_FALSE(table.read(bad_cost));
+    std::istringstream zero_cost("0.0 2.0 simple\n");
+    EXPECT_FALSE(table.read(zero_cost));
+    std::istringstream comments("# comment\n\n1.0 2.0 simple\n");
+    EXPECT_TRUE(table.read(comments));
+}
+
+TEST(FlowCostTableTest, default_costs_are_used_without_table) {
+    auto bp = make_optimized_leaf();
+    EXPECT_DOUBLE_EQ(0.1, bp->estimate());
+    EXPECT_DOUBLE_EQ(1.0, bp->cost());
+    EXPECT_DOUBLE_EQ(0.1, bp->strict_cost());
+}
+
+TEST(FlowCostTableTest, global_table_is_used_by_optimize) {
+    auto table = std::make_shared<FlowCostTable>();
+    table->add(simple_key, 2.0, 3.0);
+    FlowCostTable::set_global(table);
+    auto bp = make_optimized_leaf();
+    FlowCostTable::set_global({});
+    EXPECT_DOUBLE_EQ(2.0, bp->cost());
+    EXPECT_DOUBLE_EQ(0.3, bp->strict_cost());
+    EXPECT_TRUE(FlowCostTable::current() == nullptr);
+}
+
+TEST(FlowCostTableTest, leafs_without_flow_cost_key_use_default_costs) {
+    FlowCostTable table;
+    table.add(simple_key, 2.0, 3.0);
+    FlowCostTable::Binding bind_table(&table);
+    SimpleResult result;
+    result.addHit(1);
+    SimpleBlueprint leaf(result);
+    EXPECT_TRUE(leaf.flow_cost_key() == nullptr);
+    EXPECT_DOUBLE_EQ(1.0, leaf.calculate_cost());
+}
+
+TEST(FlowCostTableTest, bindings_can_be_nested) {
+    FlowCostTable outer;
+    FlowCostTable inner;
+    {
+        FlowCostTable::Binding bind_outer(&outer);
+        {
+            FlowCostTable::Binding bind_inner(&inner);
+            EXPECT_EQ(&inner, FlowCostTable::current());
+        }
+        EXPECT_EQ(&outer, FlowCostTable::current());
+    }
+    EXPECT_TRUE(FlowCostTable::current() == nullptr);
+}
+
+GTEST_MAIN_RUN_ALL_TESTS()
@@ -0,0 +1,107 @@
+// Copyright Vespa.ai. Licensed under the terms of the Apache 2.0 license. See LICENSE in the project root.
+
+#include <vespa/searchlib/queryeval/fuzzy_term_expander.h>
+#include <vespa/vespalib/fuzzy/fuzzy_matcher.h>
+#include <vespa/vespalib/gtest/gtest.h>
+#include <set>
+
+using search::queryeval::FuzzyTermExpander;
+using vespalib::FuzzyMatcher;
+
+using StringVector = std::vector<vespalib::string>;
+
+struct Dictionary {
+    std::set<std::string> words;
+    size_t                lookups;
+
+    Dictionary(std::initializer_list<std::string> words_in) : words(words_in), lookups(0) {}
+
+    StringVector expand(const vespalib::string& term, uint32_t max_edits, uint32_t prefix_length) {
+        FuzzyTermExpander expander(term, max_edits, prefix_length);
+        StringVector result;
+        std::string last_key;
+        lookups = 0;
+        expander.expand([&](const std::string& key, vespalib::string& word) {
+                            EXPECT_TRUE(lookups == 0 || last_key < key);
+                            last_key = key;
+                            ++lookups;
+                            auto itr = words.lower_bound(key);
+                            if (itr == words.end()) {
+                                return false;
+                            }
+                            word = *itr;
+                            return true;
+                        },
+                        [&](const vespalib::string& word) { result.push_back(word); });
+        return result;
+    }
+
+    StringVector brute_force(const vespalib::string& term, uint32_t max_edits, uint32_t prefix_length) const {
+        FuzzyMatcher matcher(std::string_view(term.data(), term.size()), max_edits, prefix_length, true);
+        StringVector result;
+        for (const auto& word : words) {
+            if (matcher.isMatch(word)) {
+                result.emplace_back(word);
+            }
+        }
+        return result;
+    }
+};
+
+TEST(FuzzyTermExpanderTest, words_within_max_edits_are_found)
+{
+    Dictionary dict({"bar", "fo", "foa", "foo", "foobar", "fooo", "fxxx", "xoo", "zoom"});
+    EXPECT_EQ(StringVector({"fo", "foa", "foo", "fooo", "xoo"}), dict.expand("foo", 1, 0));
+    EXPECT_EQ(StringVector({"fo", "foa", "foo", "fooo", "xoo", "zoom"}), dict.expand("foo", 2, 0));
+    EXPECT_EQ(StringVector({"foo"}), dict.expand("foo", 0, 0));
+    EXPECT_EQ(StringVector(), dict.expand("qqqqqqq", 2, 0));
+}
+
+TEST(FuzzyTermExpanderTest, prefix_is_locked)
+{
+    Dictionary dict({"bar", "fo", "foa", "foo", "foobar", "fooo", "fxxx", "xoo", "zoom"});
+    EXPECT_EQ(StringVector({"fo", "foa", "foo", "fooo"}), dict.expand("foo", 1, 1));
+    EXPECT_EQ(StringVector({"foo", "fooo"}), dict.expand("foo", 1, 3));
+    EXPECT_EQ(StringVector({"xoo"}), dict.expand("xoo", 2, 1));
+    // Term shorter than the prefix must match exactly
+    EXPECT_EQ(StringVector({"foo"}), dict.expand("foo", 2, 4));
+}
+
+TEST(FuzzyTermExpanderTest, unsupported_max_edits_falls_back_to_exact_lookup)
+{
+    Dictionary dict({"foa", "foo", "fooo"});
+    EXPECT_EQ(StringVector({"foo"}), dict.expand("foo", 3, 0));
+    EXPECT_EQ(StringVector(), dict.expand("fob", 3, 0));
+}
+
+TEST(FuzzyTermExpanderTest, result_matches_brute_force_scan_of_dictionary)
+{
+    Dictionary dict({"", "a", "ab", "abc", "abcd", "abd", "ac", "b", "ba", "bab", "bc", "bcd", "c", "cab",
+                     "dab", "\xc3\xa6\xc3\xb8\xc3\xa5", "\xc3\xa6\xc3\xb8", "\xc3\xa6z", "\xc3\xb8\xc3\xa5"});
+    for (const char* term : {"ab", "abc", "bc", "\xc3\xa6\xc3\xb8\xc3\xa5", "\xc3\xa6\xc3\xa5"}) {
+        for (uint32_t max_edits : {1, 2}) {
+            for (uint32_t prefix_length : {0, 1, 2}) {
+                SCOPED_TRACE(vespalib::string(term) + " " + std::to_string(max_edits) + " " + std::to_string(prefix_length));
+                EXPECT_EQ(dict.brute_force(term, max_edits, prefix_length), dict.expand(term, max_edits, prefix_length));
+            }
+        }
+    }
+}
+
+TEST(FuzzyTermExpanderTest, dictionary_is_skipped_using_successor_strings)
+{
+    Dictionary dict({});
+    for (char c1 = 'a'; c1 <= 'z'; ++c1) {
+        for (char c2 = 'a'; c2 <= 'z'; ++c2) {
+            for (char c3 = 'a'; c3 <= 'z'; ++c3) {
+                dict.words.insert(std::string({c1, c2, c3, 'x', 'y', 'z'}));
+            }
+        }
+    }
+    auto result = dict.expand("mmmxyz", 1, 0);
+    EXPECT_EQ(dict.brute_force("mmmxyz", 1, 0), result);
+    EXPECT_EQ(76u, result.size());
+    EXPECT_LT(dict.lookups, dict.words.size() / 20);
+}
+
+GTEST_MAIN_RUN_ALL_TESTS()
@@ -41,6 +41,12 @@ void verify(const GlobalFilter &filter, uint32_t nth = 11, uint32_t limit = 100)
         }
     }
     EXPECT_EQ(filter.count(), my_count);
+    uint32_t docid = filter.next_hit(1);
+    for (size_t i = nth; i < limit; i += nth) {
+        EXPECT_EQ(docid, i);
+        docid = filter.next_hit(docid + 1);
+    }
+    EXPECT_EQ(docid, limit);
 }
 
 TEST(GlobalFilterTest, create_can_make_test_filter) {
@@ -135,6 +141,7 @@ TEST(GlobalFilterTest, multi_bitvector_filter_with_no_vectors) {
     EXPECT_TRUE(filter->is_active());
     EXPECT_EQ(filter->size(), 1);
     EXPECT_EQ(filter->count(), 0);
+    EXPECT_EQ(filter->next_hit(1), 1);
 }
 
 TEST(GlobalFilterTest, multi_bitvector_filter_requires_no_gaps) {
@@ -324,6 +324,35 @@ void expect_at_end(SearchIterator& itr, uint32_t docid) {
     EXPECT_TRUE(itr.isAtEnd());
 }
 
+TEST(NearestNeighborIteratorTest, require_that_strict_scan_gives_up_when_soft_doomed) {
+    Fixture fixture(denseSpecDouble);
+    fixture.ensureSpace(10000);
+    fixture.setTensor(1, 3.0, 4.0);
+    fixture.setTensor(9000, 3.0, 4.0);
+    fixture.setFilter({1, 9000});
+    auto qtv = createTensor(denseSpecDouble, 0.0, 0.0);
+    auto md = MatchData::makeTestInstance(2, 2);
+    NearestNeighborDistanceHeap dh(2);
+    std::atomic<vespalib::steady_time> now(vespalib::steady_time(std::chrono::seconds(10)));
+    vespalib::Doom doom(now, vespalib::steady_time(std::chrono::seconds(1)), vespalib::steady_time(std::chrono::seconds(20)), true);
+    for (bool doomed : {false, true}) {
+        auto search = NearestNeighborIterator::create(true, *md->resolveTermField(0),
+                                                      std::make_unique<DistanceCalculator>(*fixture._attr, *qtv),
+                                                      dh, *fixture._global_filter);
+        if (doomed) {
+            search->set_soft_doom(doom);
+        }
+        search->initRange(1, fixture._attr->getNumDocs());
+        EXPECT_EQ(search->seekFirst(1), 1u);
+        if (doomed) {
+            search->seekFirst(2);
+            EXPECT_TRUE(search->isAtEnd());
+        } else {
+            EXPECT_EQ(search->seekFirst(2), 9000u);
+        }
+    }
+}
+
 TEST(NnsIndexIteratorTest, require_that_iterator_works_as_expected) {
     std::vector<NnsIndexIterator::Hit> hits{{2,4.0}, {3,9.0}, {5,1.0}, {8,16.0}, {9,36.0}};
     auto md = MatchData::makeTestInstance(2, 2);
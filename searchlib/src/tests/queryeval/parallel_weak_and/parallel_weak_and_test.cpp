@@ -728,4 +728,53 @@ TEST(ParallelWeakAndTest, verify_search_iterator_conformance)
     }
 }
 
+std::vector<uint32_t>
+collect_hits(SearchIterator &itr, uint32_t docid_limit)
+{
+    std::vector<uint32_t> hits;
+    itr.initRange(1, docid_limit);
+    for (uint32_t docid = 1; !itr.isAtEnd(docid); ) {
+        if (itr.seek(docid)) {
+            hits.push_back(docid);
+            itr.unpack(docid);
+        }
+        docid = std::max(docid + 1, itr.getDocId());
+    }
+    return hits;
+}
+
+TEST(ParallelWeakAndTest, block_max_pruning_gives_same_hits_as_without_block_max_scores)
+{
+    constexpr uint32_t docid_limit = 2000;
+    DocumentWeightAttributeHelper helper;
+    helper.add_docs(docid_limit);
+    // Only the even docs in [1000, 1100) have a high weight and can score above the threshold.
+    std::vector<uint32_t> expect;
+    for (uint32_t docid = 1; docid < docid_limit; ++docid) {
+        if ((docid % 2) == 0) {
+            bool high = (docid >= 1000 && docid < 1100);
+            helper.set_doc(docid, 0, high ? 100 : 1);
+            if (high) {
+                expect.push_back(docid);
+            }
+        } else {
+            helper.set_doc(docid, 1, 2);
+        }
+    }
+    std::vector<int32_t> weights = {1, 1};
+    std::vector<IDirectPostingStore::LookupResult> dict_entries;
+    for (const char *term : {"0", "1"}) {
+        dict_entries.push_back(helper.dww().lookup(term, helper.dww().get_dictionary_snapshot()));
+    }
+    for (bool use_dww : {false, true}) {
+        for (bool strict : {false, true}) {
+            DummyHeap heap;
+            TermFieldMatchData tfmd;
+            MatchParams match_params(heap, 50, 1.0, 1);
+            auto itr = create_wand(use_dww, tfmd, match_params, weights, dict_entries, helper.dww(), strict);
+            EXPECT_EQ(expect, collect_hits(*itr, docid_limit)) << "use_dww=" << use_dww << ", strict=" << strict;
+        }
+    }
+}
+
 GTEST_MAIN_RUN_ALL_TESTS()
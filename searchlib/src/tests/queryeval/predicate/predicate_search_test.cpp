@@ -115,6 +115,21 @@ TEST("Require that the skipping is efficient") {
     EXPECT_EQUAL(33u, skip->next());
 }
 
+TEST("require that skipping handles feature counts above 127") {
+    MF min_feature(100, 200);
+    CV kv(100, 150);
+    min_feature[3] = 3;
+    kv[70] = 200;
+    min_feature[90] = 128;
+    kv[99] = 255;
+    SkipMinFeature::UP skip = SkipMinFeature::create(&min_feature[0], &kv[0], kv.size());
+    EXPECT_EQUAL(3u, skip->next());
+    EXPECT_EQUAL(70u, skip->next());
+    EXPECT_EQUAL(90u, skip->next());
+    EXPECT_EQUAL(99u, skip->next());
+    EXPECT_EQUAL(UINT32_MAX, skip->next());
+}
+
 TEST("require that empty search yields no results") {
     vector<PredicatePostingList::UP> posting_lists;
     MF mf(3); CV cv(3); IR ir(3, 0xffff);
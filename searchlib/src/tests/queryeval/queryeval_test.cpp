@@ -18,6 +18,7 @@
 #include <vespa/searchlib/queryeval/isourceselector.h>
 #include <vespa/searchlib/query/query_term_simple.h>
 #include <vespa/searchlib/attribute/singleboolattribute.h>
+#include <vespa/searchlib/common/bitvectoriterator.h>
 #include <vespa/searchcommon/common/growstrategy.h>
 #include <vespa/searchlib/fef/fef.h>
 #include <vespa/vespalib/data/slime/slime.h>
@@ -304,6 +305,79 @@ private:
     void doSeek(uint32_t docid) override { (void) docid; }
 };
 
+std::vector<uint32_t> fill_all_hits(SearchIterator &search, uint32_t begin_id, uint32_t end_id, uint32_t block_size) {
+    std::vector<uint32_t> result;
+    std::vector<uint32_t> block(block_size);
+    search.initRange(begin_id, end_id);
+    uint32_t docid = begin_id;
+    for (;;) {
+        uint32_t num_hits = search.fill_hits(docid, end_id, block.data(), block_size);
+        result.insert(result.end(), block.begin(), block.begin() + num_hits);
+        if (num_hits < block_size) {
+            return result;
+        }
+        EXPECT_EQ(block[num_hits - 1], search.getDocId());
+        docid = block[num_hits - 1] + 1;
+    }
+}
+
+std::vector<uint32_t> seek_all_hits(SearchIterator &search, uint32_t begin_id, uint32_t end_id) {
+    std::vector<uint32_t> result;
+    search.initRange(begin_id, end_id);
+    for (uint32_t docid = search.seekFirst(begin_id); docid < end_id; docid = search.seekNext(docid + 1)) {
+        result.push_back(docid);
+    }
+    return result;
+}
+
+void verify_fill_hits(SearchIterator &search) {
+    for (uint32_t block_size : {1u, 2u, 3u, 256u}) {
+        SCOPED_TRACE("block_size=" + std::to_string(block_size));
+        EXPECT_EQ(seek_all_hits(search, 1, 100), fill_all_hits(search, 1, 100, block_size));
+        EXPECT_EQ(seek_all_hits(search, 6, 31), fill_all_hits(search, 6, 31, block_size));
+    }
+}
+
+TEST(QueryEvalTest, fill_hits_matches_seeking_one_document_at_a_time)
+{
+    SimpleResult a;
+    SimpleResult b;
+    a.addHit(5).addHit(10).addHit(16).addHit(30).addHit(31).addHit(52);
+    b.addHit(3).addHit(5).addHit(17).addHit(30).addHit(52).addHit(99);
+    {
+        SimpleSearch search(a);
+        verify_fill_hits(search);
+    }
+    MatchData::UP md(MatchData::makeTestInstance(100, 10));
+    for (bool is_and : {true, false}) {
+        std::unique_ptr<IntermediateBlueprint> bp;
+        if (is_and) {
+            bp = std::make_unique<AndBlueprint>();
+        } else {
+            bp = std::make_unique<OrBlueprint>();
+        }
+        bp->addChild(std::make_unique<SimpleBlueprint>(a));
+        bp->addChild(std::make_unique<SimpleBlueprint>(b));
+        bp->fetchPostings(ExecuteInfo::TRUE);
+        auto search = bp->createSearch(*md, true);
+        SCOPED_TRACE(search->getClassName());
+        verify_fill_hits(*search);
+    }
+    {
+        auto bv = BitVector::create(100);
+        for (uint32_t docid : {3, 5, 17, 30, 31, 52, 99}) {
+            bv->setBit(docid);
+        }
+        bv->invalidateCachedCount();
+        TermFieldMatchData tfmd;
+        for (bool inverted : {false, true}) {
+            auto search = search::BitVectorIterator::create(bv.get(), 100, tfmd, true, inverted);
+            SCOPED_TRACE(search->getClassName());
+            verify_fill_hits(*search);
+        }
+    }
+}
+
 struct MultiSearchRemoveTest {
     static SearchIterator::UP remove(MultiSearch &ms, size_t idx) { return ms.remove(idx); }
 };
@@ -11,6 +11,7 @@
 #include <vespa/searchlib/query/weight.h>
 #include <vespa/vespalib/util/testclock.h>
 #include <vespa/vespalib/testkit/testapp.h>
+#include <limits>
 
 #include <vespa/log/log.h>
 LOG_SETUP("simple_phrase_test");
@@ -48,6 +49,7 @@ class Test : public vespalib::TestApp {
     void requireThatIteratorFindsLongPhrase(bool useBlueprint);
     void requireThatStrictIteratorFindsNextMatch(bool useBlueprint);
     void requireThatPhrasesAreUnpacked(bool useBlueprint, bool unpack_normal_features, bool unpack_interleaved_features);
+    void requireThatPhrasesDoNotMatchAcrossElements(bool useBlueprint);
     void requireThatTermsCanBeEvaluatedInPriorityOrder();
     void requireThatBlueprintExposesFieldWithEstimate();
     void requireThatBlueprintForcesPositionDataOnChildren();
@@ -68,6 +70,7 @@ Test::Main()
     TEST_DO(requireThatPhrasesAreUnpacked(false, true, true));
     TEST_DO(requireThatPhrasesAreUnpacked(false, false, false));
     TEST_DO(requireThatPhrasesAreUnpacked(false, false, true));
+    TEST_DO(requireThatPhrasesDoNotMatchAcrossElements(false));
     TEST_DO(requireThatTermsCanBeEvaluatedInPriorityOrder());
 
     TEST_DO(requireThatIteratorFindsSimplePhrase(true));
@@ -77,6 +80,7 @@ Test::Main()
     TEST_DO(requireThatPhrasesAreUnpacked(true, true, true));
     TEST_DO(requireThatPhrasesAreUnpacked(true, false, false));
     TEST_DO(requireThatPhrasesAreUnpacked(true, false, true));
+    TEST_DO(requireThatPhrasesDoNotMatchAcrossElements(true));
     TEST_DO(requireThatBlueprintExposesFieldWithEstimate());
     TEST_DO(requireThatBlueprintForcesPositionDataOnChildren());
 
@@ -259,6 +263,24 @@ void Test::requireThatPhrasesAreUnpacked(bool useBlueprint, bool unpack_normal_f
     }
 }
 
+void Test::requireThatPhrasesDoNotMatchAcrossElements(bool useBlueprint) {
+    PhraseSearchTest test;
+    test.addTerm("foo", FakeResult()
+                 .doc(doc_match).elem(0).pos(std::numeric_limits<uint32_t>::max()).elem(1).pos(3)
+                 .doc(doc_no_match).elem(0).pos(std::numeric_limits<uint32_t>::max()).elem(1).pos(7));
+    test.addTerm("bar", FakeResult()
+                 .doc(doc_match).elem(1).pos(0).pos(4)
+                 .doc(doc_no_match).elem(1).pos(0).pos(4));
+    test.fetchPostings(useBlueprint);
+    unique_ptr<SearchIterator> search(test.createSearch(useBlueprint));
+    EXPECT_TRUE(search->seek(doc_match));
+    search->unpack(doc_match);
+    ASSERT_EQUAL(1, std::distance(test.tmd().begin(), test.tmd().end()));
+    EXPECT_EQUAL(1u, test.tmd().begin()->getElementId());
+    EXPECT_EQUAL(3u, test.tmd().begin()->getPosition());
+    EXPECT_TRUE(!search->seek(doc_no_match));
+}
+
 void Test::requireThatTermsCanBeEvaluatedInPriorityOrder() {
     vector<uint32_t> order;
     order.push_back(2);
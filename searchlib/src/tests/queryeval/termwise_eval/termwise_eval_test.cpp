@@ -665,6 +665,38 @@ TEST(TermwiseEvalTest, require_that_andnot_can_be_partially_termwise_with_first_
 
 //-----------------------------------------------------------------------------
 
+std::vector<uint32_t> make_hits(uint32_t begin, uint32_t end) {
+    std::vector<uint32_t> hits;
+    for (uint32_t docid = begin; docid < end; ++docid) {
+        hits.push_back(docid);
+    }
+    return hits;
+}
+
+Blueprint::UP make_optimized_or(const std::vector<uint32_t> &hits1, const std::vector<uint32_t> &hits2) {
+    auto my_or = std::make_unique<OrBlueprint>();
+    my_or->addChild(UP(new MyBlueprint(hits1, true, 1)));
+    my_or->addChild(UP(new MyBlueprint(hits2, true, 2)));
+    my_or->setDocIdLimit(100);
+    return Blueprint::optimize(std::move(my_or));
+}
+
+TEST(TermwiseEvalTest, require_that_negative_termwise_limit_uses_flow_statistics)
+{
+    auto md = make_match_data();
+    md->set_termwise_limit(-1.0);
+    md->resolveTermField(1)->tagAsNotNeeded();
+    md->resolveTermField(2)->tagAsNotNeeded();
+    auto dense_or = make_optimized_or(make_hits(1, 41), make_hits(41, 81));
+    auto sparse_or = make_optimized_or({1}, {2});
+    // non-strict children checked for most documents are cheaper to evaluate termwise
+    EXPECT_TRUE(dense_or->createSearch(*md, false)->asString().find("TermwiseSearch") != vespalib::string::npos);
+    // strict children are already evaluated in a single pass
+    EXPECT_TRUE(dense_or->createSearch(*md, true)->asString().find("TermwiseSearch") == vespalib::string::npos);
+    // sparse children are not worth a bitvector
+    EXPECT_TRUE(sparse_or->createSearch(*md, false)->asString().find("TermwiseSearch") == vespalib::string::npos);
+}
+
 TEST(TermwiseEvalTest, require_that_termwise_blueprint_helper_calculates_unpack_info_correctly)
 {
     OrBlueprint my_or;
@@ -237,6 +237,7 @@ private:
     void testCfgValueBlueprint();
     void testCompilation();
     void testRankSetup();
+    void testDegradationAttributeFromFirstPhase();
     bool testExecution(const vespalib::string & initRank, feature_t initScore,
                        const vespalib::string & finalRank = "", feature_t finalScore = 0.0f, uint32_t docId = 1);
     bool testExecution(const RankEnvironment &rankEnv,
@@ -496,6 +497,23 @@ RankSetupTest::testCompilation()
         rs.setFirstPhaseRank(fmt("chain(cycle,%d,2)", BlueprintResolver::MAX_TRACE_SIZE + 1));
         EXPECT_TRUE(!rs.compile());
     }
+    { // execution plan
+        RankSetup rs(_factory, _indexEnv);
+        rs.setFirstPhaseRank("mysum(value(2),value(3))");
+        rs.setSecondPhaseRank("mysum(value(2),value(3),value(4))");
+        EXPECT_TRUE(rs.compile());
+        EXPECT_EQUAL("first-phase: 3 executors, 0 shared\n"
+                     "  #0 value(2)\n"
+                     "  #1 value(3)\n"
+                     "  #2 mysum(value(2),value(3)) <- #0 #1\n"
+                     "  seed mysum(value(2),value(3)) = #2\n"
+                     "second-phase: 4 executors, 2 shared\n"
+                     "  #0 value(2) (shared)\n"
+                     "  #1 value(3) (shared)\n"
+                     "  #2 value(4)\n"
+                     "  #3 mysum(value(2),value(3),value(4)) <- #0 #1 #2\n"
+                     "  seed mysum(value(2),value(3),value(4)) = #3\n", rs.dump_plan());
+    }
 }
 
 void RankSetupTest::testRankSetup()
@@ -510,6 +528,7 @@ void RankSetupTest::testRankSetup()
     env.getProperties().add(dump::Feature::NAME, "bar");
     env.getProperties().add(matching::NumThreadsPerSearch::NAME, "3");
     env.getProperties().add(matching::MinHitsPerThread::NAME, "8");
+    env.getProperties().add(matching::NumNumaNodes::NAME, "2");
     env.getProperties().add(matchphase::DegradationAttribute::NAME, "mystaticrankattr");
     env.getProperties().add(matchphase::DegradationAscendingOrder::NAME, "true");
     env.getProperties().add(matchphase::DegradationMaxHits::NAME, "12345");
@@ -536,6 +555,8 @@ void RankSetupTest::testRankSetup()
     env.getProperties().add(matching::GlobalFilterLowerLimit::NAME, "0.3");
     env.getProperties().add(matching::GlobalFilterUpperLimit::NAME, "0.7");
     env.getProperties().add(matching::TargetHitsMaxAdjustmentFactor::NAME, "5.0");
+    env.getProperties().add(matching::FilterFirstThreshold::NAME, "0.05");
+    env.getProperties().add(matching::FirstPhaseBatchSize::NAME, "16");
     env.getProperties().add(matching::FuzzyAlgorithm::NAME, "dfa_implicit");
 
     RankSetup rs(_factory, env);
@@ -552,6 +573,7 @@ void RankSetupTest::testRankSetup()
     EXPECT_EQUAL(rs.getDumpFeatures()[1], vespalib::string("bar"));
     EXPECT_EQUAL(rs.getNumThreadsPerSearch(), 3u);
     EXPECT_EQUAL(rs.getMinHitsPerThread(), 8u);
+    EXPECT_EQUAL(rs.getNumNumaNodes(), 2u);
     EXPECT_EQUAL(rs.getDegradationAttribute(), "mystaticrankattr");
     EXPECT_EQUAL(rs.isDegradationOrderAscending(), true);
     EXPECT_EQUAL(rs.getDegradationMaxHits(), 12345u);
@@ -578,9 +600,42 @@ void RankSetupTest::testRankSetup()
     EXPECT_EQUAL(rs.get_global_filter_lower_limit(), 0.3);
     EXPECT_EQUAL(rs.get_global_filter_upper_limit(), 0.7);
     EXPECT_EQUAL(rs.get_target_hits_max_adjustment_factor(), 5.0);
+    EXPECT_EQUAL(rs.get_filter_first_threshold(), 0.05);
+    EXPECT_EQUAL(rs.get_first_phase_batch_size(), 16u);
     EXPECT_EQUAL(rs.get_fuzzy_matching_algorithm(), vespalib::FuzzyMatchingAlgorithm::DfaImplicit);
 }
 
+void
+RankSetupTest::testDegradationAttributeFromFirstPhase()
+{
+    using namespace search::fef::indexproperties;
+    auto configure = [this](const vespalib::string &first_phase, const vespalib::string &script,
+                            const vespalib::string &attribute, bool from_first_phase) {
+        IndexEnvironment env;
+        env.getProperties().add(rank::FirstPhase::NAME, first_phase);
+        if (!script.empty()) {
+            env.getProperties().add("rankingExpression(firstphase).rankingScript", script);
+        }
+        if (!attribute.empty()) {
+            env.getProperties().add(matchphase::DegradationAttribute::NAME, attribute);
+        }
+        env.getProperties().add(matchphase::DegradationAscendingOrder::NAME, "true");
+        env.getProperties().add(matchphase::DegradationAttributeFromFirstPhase::NAME, from_first_phase ? "true" : "false");
+        RankSetup rs(_factory, env);
+        rs.configure();
+        return std::make_pair(rs.getDegradationAttribute(), rs.isDegradationOrderAscending());
+    };
+    EXPECT_EQUAL(configure("attribute(popularity)", "", "", false).first, "");
+    EXPECT_EQUAL(configure("attribute(popularity)", "", "", true).first, "popularity");
+    EXPECT_FALSE(configure("attribute(popularity)", "", "", true).second);
+    EXPECT_EQUAL(configure("rankingExpression(firstphase)", " attribute(popularity)\n", "", true).first, "popularity");
+    EXPECT_EQUAL(configure("rankingExpression(firstphase)", "attribute(popularity)*2", "", true).first, "");
+    EXPECT_EQUAL(configure("attribute(popularity).count", "", "", true).first, "");
+    EXPECT_EQUAL(configure("nativeRank", "", "", true).first, "");
+    EXPECT_EQUAL(configure("attribute(popularity)", "", "age", true).first, "age");
+    EXPECT_TRUE(configure("attribute(popularity)", "", "age", true).second);
+}
+
 bool
 RankSetupTest::testExecution(const vespalib::string & initRank, feature_t initScore,
                              const vespalib::string & finalRank, feature_t finalScore, uint32_t docId)
@@ -981,6 +1036,7 @@ RankSetupTest::Main()
 
     testCompilation();
     testRankSetup();
+    testDegradationAttributeFromFirstPhase();
     testExecution();
     testFeatureDump();
     testFeatureNormalization();
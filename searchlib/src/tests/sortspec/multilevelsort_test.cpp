@@ -66,6 +66,7 @@ private:
 public:
     MultilevelSortTest() { srand(time(nullptr)); }
     void testSort();
+    void testTopKSort();
 };
 
 template<typename T>
@@ -374,12 +375,59 @@ void MultilevelSortTest::testSort()
 
 }
 
+void MultilevelSortTest::testTopKSort()
+{
+    uint32_t num = 5000;
+    uint32_t topn = 100;
+    Config cfg(BasicType::INT32, CollectionType::SINGLE);
+    AttributePtr attr = AttributeFactory::createAttribute("int32", cfg);
+    fill<int32_t>(dynamic_cast<IntegerAttribute *>(attr.get()), num, 64);
+    attr->commit();
+
+    search::uca::UcaConverterFactory ucaFactory;
+    for (bool asc : {true, false}) {
+        std::vector<RankedHit> hits;
+        for (uint32_t i = 0; i < num; ++i) {
+            hits.emplace_back(i, getRandomValue<uint32_t>());
+        }
+        std::vector<RankedHit> expected(hits);
+        uint32_t attrType = asc ? FastS_SortSpec::ASC_VECTOR : FastS_SortSpec::DESC_VECTOR;
+
+        FastS_SortSpec full("no-metastore", 7, vespalib::Doom::never(), ucaFactory);
+        full._vectors.emplace_back(attrType, attr.get(), nullptr);
+        full._vectors.emplace_back(FastS_SortSpec::ASC_DOCID, nullptr, nullptr);
+        full.sortResults(&expected[0], num, num);
+
+        FastS_SortSpec topk("no-metastore", 7, vespalib::Doom::never(), ucaFactory);
+        topk._vectors.emplace_back(attrType, attr.get(), nullptr);
+        topk._vectors.emplace_back(FastS_SortSpec::ASC_DOCID, nullptr, nullptr);
+        EXPECT_TRUE(topk.useTopKSelection(num, topn));
+        topk.sortResults(&hits[0], num, topn);
+        EXPECT_TRUE(topk._sortDataArray.size() >= topn);
+        EXPECT_TRUE(topk._sortDataArray.size() < num);
+        for (uint32_t i = 0; i < topn; ++i) {
+            EXPECT_EQUAL(expected[i].getDocId(), hits[i].getDocId());
+            auto actual_ref = topk.getSortRef(i);
+            auto expected_ref = full.getSortRef(i);
+            ASSERT_EQUAL(expected_ref.second, actual_ref.second);
+            EXPECT_EQUAL(0, memcmp(expected_ref.first, actual_ref.first, actual_ref.second));
+        }
+        EXPECT_FALSE(topk.useTopKSelection(num, num / 2));
+    }
+}
+
 TEST("require that all sort methods behave the same")
 {
     MultilevelSortTest test;
     test.testSort();
 }
 
+TEST("require that top-k sorting gives the same top hits as a full sort")
+{
+    MultilevelSortTest test;
+    test.testTopKSort();
+}
+
 TEST("test that [docid] translates to [lid][paritionid]") {
     search::uca::UcaConverterFactory ucaFactory;
     FastS_SortSpec asc("no-metastore", 7, vespalib::Doom::never(), ucaFactory);
@@ -11,9 +11,12 @@
 #include <vespa/searchlib/tensor/hnsw_index_saver.h>
 #include <vespa/searchlib/tensor/random_level_generator.h>
 #include <vespa/searchlib/tensor/inv_log_level_generator.h>
+#include <vespa/searchlib/tensor/nearest_neighbor_index_saver.h>
+#include <vespa/searchlib/tensor/quantized_vector_store.h>
 #include <vespa/searchlib/tensor/subspace_type.h>
 #include <vespa/searchlib/tensor/vector_bundle.h>
 #include <vespa/searchlib/queryeval/global_filter.h>
+#include <vespa/searchlib/util/fileutil.h>
 #include <vespa/vespalib/datastore/compaction_spec.h>
 #include <vespa/vespalib/datastore/compaction_strategy.h>
 #include <vespa/vespalib/gtest/gtest.h>
@@ -37,6 +40,8 @@ using vespalib::eval::get_cell_type;
 using vespalib::eval::ValueType;
 using vespalib::datastore::CompactionSpec;
 using vespalib::datastore::CompactionStrategy;
+using search::attribute::DistanceMetric;
+using search::attribute::VectorQuantization;
 using search::queryeval::GlobalFilter;
 using search::test::VectorBufferReader;
 using search::test::VectorBufferWriter;
@@ -88,6 +93,7 @@ class HnswIndexTest : public ::testing::Test {
 public:
     FloatVectors vectors;
     std::shared_ptr<GlobalFilter> global_filter;
+    bool filter_first;
     LevelGenerator* level_generator;
     GenerationHandler gen_handler;
     std::unique_ptr<IndexType> index;
@@ -96,6 +102,7 @@ public:
     HnswIndexTest()
         : vectors(),
           global_filter(GlobalFilter::create()),
+          filter_first(false),
           level_generator(),
           gen_handler(),
           index(),
@@ -114,12 +121,17 @@ public:
                 vespalib::eval::CellType::FLOAT);
     }
 
-    void init(bool heuristic_select_neighbors) {
+    void init(bool heuristic_select_neighbors, VectorQuantization quantization = VectorQuantization::None) {
         auto generator = std::make_unique<LevelGenerator>();
         level_generator = generator.get();
+        std::unique_ptr<QuantizedVectorStore> quantized_vectors;
+        if (quantization != VectorQuantization::None) {
+            quantized_vectors = std::make_unique<QuantizedVectorStore>(quantization, DistanceMetric::Euclidean, 2);
+        }
         index = std::make_unique<IndexType>(vectors, dff(),
                                             std::move(generator),
-                                            HnswIndexConfig(5, 2, 10, 0, heuristic_select_neighbors));
+                                            HnswIndexConfig(5, 2, 10, 0, heuristic_select_neighbors),
+                                            std::move(quantized_vectors));
     }
     void add_document(uint32_t docid, uint32_t max_level = 0) {
         level_generator->level = max_level;
@@ -176,7 +188,7 @@ public:
         vespalib::eval::TypedCells qv_cells(qv_ref);
         auto df = index->distance_function_factory().for_query_vector(qv_cells);
         auto got_by_docid = (global_filter->is_active()) ?
-                            index->find_top_k_with_filter(k, *df, *global_filter, explore_k, _doom->get_doom(), 10000.0) :
+                            index->find_top_k_with_filter(k, *df, *global_filter, filter_first, explore_k, _doom->get_doom(), 10000.0) :
                             index->find_top_k(k, *df, explore_k, _doom->get_doom(), 10000.0);
         std::vector<uint32_t> act;
         act.reserve(got_by_docid.size());
@@ -219,7 +231,7 @@ public:
         EXPECT_LE(rv[0].distance, rv[1].distance);
         double thr = (rv[0].distance + rv[1].distance) * 0.5;
         auto got_by_docid = (global_filter->is_active())
-            ? index->find_top_k_with_filter(k, *df, *global_filter, k, _doom->get_doom(), thr)
+            ? index->find_top_k_with_filter(k, *df, *global_filter, filter_first, k, _doom->get_doom(), thr)
             : index->find_top_k(k, *df, k, _doom->get_doom(), thr);
         EXPECT_EQ(got_by_docid.size(), 1);
         EXPECT_EQ(got_by_docid[0].docid, index->get_docid(rv[0].nodeid));
@@ -349,6 +361,21 @@ TYPED_TEST(HnswIndexTest, 2d_vectors_inserted_in_level_0_graph_with_simple_selec
     this->expect_top_3(2, {});
 }
 
+TYPED_TEST(HnswIndexTest, filter_first_search_skips_past_nodes_not_matching_filter)
+{
+    this->init(false);
+    for (uint32_t docid = 1; docid < 8; ++docid) {
+        this->add_document(docid);
+    }
+    this->filter_first = true;
+    this->set_filter({2,3,6});
+    this->expect_top_3_by_docid("{7,2}", {7, 2}, {2, 3, 6});
+    // Neither 5 nor 7 is linked from the entry point (1).
+    this->set_filter({5,7});
+    this->expect_top_3_by_docid("{7,2} two hops", {7, 2}, {5, 7});
+    this->expect_top_3_by_docid("{0,3} two hops", {0, 3}, {5, 7});
+}
+
 TYPED_TEST(HnswIndexTest, 2d_vectors_inserted_and_removed)
 {
     this->init(false);
@@ -528,6 +555,50 @@ TYPED_TEST(HnswIndexTest, manual_insert)
     this->expect_levels(5, {{1,2}, {4}});
 }
 
+TYPED_TEST(HnswIndexTest, graph_maintenance_repairs_orphaned_nodes)
+{
+    this->init(true);
+
+    for (uint32_t docid = 1; docid < 9; ++docid) {
+        this->add_document(docid);
+    }
+    std::vector<uint32_t> nbl;
+    HnswTestNode orphan{nbl};
+    this->index->set_node(9, orphan);
+    this->commit();
+    this->expect_level_0(9, {});
+    EXPECT_EQ(8, this->index->count_reachable_nodes().first);
+
+    auto stats = this->index->maintain_graph(100, 0, 10);
+    this->commit();
+    EXPECT_EQ(9, stats.checked_nodes);
+    EXPECT_EQ(1, stats.degraded_nodes);
+    EXPECT_EQ(1, stats.repaired_nodes);
+    EXPECT_FALSE(this->index->get_node(9).level(0).empty());
+    EXPECT_TRUE(this->index->check_link_symmetry());
+    EXPECT_EQ(9, this->index->count_reachable_nodes().first);
+
+    stats = this->index->maintain_graph(100, 100, 10);
+    EXPECT_EQ(9, stats.checked_nodes);
+    EXPECT_EQ(0, stats.degraded_nodes);
+    EXPECT_EQ(9, stats.probed_nodes);
+    EXPECT_EQ(1.0, stats.probe_recall());
+}
+
+TYPED_TEST(HnswIndexTest, graph_maintenance_continues_where_previous_step_stopped)
+{
+    this->init(true);
+
+    for (uint32_t docid = 1; docid < 10; ++docid) {
+        this->add_document(docid);
+    }
+    this->remove_document(5);
+    EXPECT_EQ(4, this->index->maintain_graph(4, 0, 0).checked_nodes);
+    EXPECT_EQ(4, this->index->maintain_graph(4, 0, 0).checked_nodes);
+    // Wraps around to the start after the last node
+    EXPECT_EQ(8, this->index->maintain_graph(100, 0, 0).checked_nodes);
+}
+
 TYPED_TEST(HnswIndexTest, memory_is_reclaimed_when_doing_changes_to_graph)
 {
     this->init(false);
@@ -786,6 +857,83 @@ TYPED_TEST(HnswIndexTest, hnsw_graph_can_be_saved_and_loaded)
     this->check_savetest_index("after load");
 }
 
+TYPED_TEST(HnswIndexTest, quantized_traversal_is_rescored_with_full_precision)
+{
+    this->init(true, VectorQuantization::Int8);
+    auto mem_1 = this->memory_usage();
+    for (uint32_t docid = 1; docid < 10; ++docid) {
+        this->add_document(docid);
+    }
+    EXPECT_GT(this->memory_usage().usedBytes(), mem_1.usedBytes());
+    this->expect_top_3_by_docid("{2.2,2.4}", {2.2, 2.4}, {1, 2, 3});
+    this->expect_top_3_by_docid("{7,3}", {7, 3}, {5, 6, 9});
+    this->expect_top_3_by_docid("{1,3}", {1, 3}, {3, 4, 8});
+    this->set_filter({2,3,4,6});
+    this->expect_top_3_by_docid("{7,3} with filter", {7, 3}, {2, 3, 6});
+}
+
+TEST(QuantizedVectorStoreTest, int8_codes_use_scale_from_first_vector)
+{
+    QuantizedVectorStore store(VectorQuantization::Int8, DistanceMetric::Euclidean, 4);
+    EXPECT_EQ(4, store.code_size());
+    std::vector<float> first{1.0, -0.5, 0.25, 0.0};
+    std::vector<float> second{4.0, -4.0, 1.0, 0.5};
+    store.set_vector(1, vespalib::eval::TypedCells(vespalib::ConstArrayRef<float>(first)));
+    store.set_vector(2, vespalib::eval::TypedCells(vespalib::ConstArrayRef<float>(second)));
+    auto codes_1 = store.get_codes(1).unsafe_typify<vespalib::eval::Int8Float>();
+    auto codes_2 = store.get_codes(2).unsafe_typify<vespalib::eval::Int8Float>();
+    EXPECT_EQ(64, codes_1[0].get_bits());
+    EXPECT_EQ(-32, codes_1[1].get_bits());
+    EXPECT_EQ(16, codes_1[2].get_bits());
+    EXPECT_EQ(0, codes_1[3].get_bits());
+    EXPECT_EQ(127, codes_2[0].get_bits());
+    EXPECT_EQ(-127, codes_2[1].get_bits());
+    EXPECT_EQ(64, codes_2[2].get_bits());
+    EXPECT_EQ(32, codes_2[3].get_bits());
+}
+
+TEST(QuantizedVectorStoreTest, binary_codes_keep_sign_bits)
+{
+    QuantizedVectorStore store(VectorQuantization::Binary, DistanceMetric::Angular, 10);
+    EXPECT_EQ(2, store.code_size());
+    std::vector<float> vector{1.0, -1.0, 1.0, 1.0, -1.0, -1.0, -1.0, 1.0, 1.0, -1.0};
+    store.set_vector(1, vespalib::eval::TypedCells(vespalib::ConstArrayRef<float>(vector)));
+    auto codes = store.get_codes(1).unsafe_typify<vespalib::eval::Int8Float>();
+    EXPECT_EQ(int8_t(0b10110001), codes[0].get_bits());
+    EXPECT_EQ(int8_t(0b10), codes[1].get_bits());
+    auto df = store.make_traversal_function(vespalib::eval::TypedCells(vespalib::ConstArrayRef<float>(vector)));
+    EXPECT_EQ(0.0, df->calc(store.get_codes(1)));
+}
+
+TEST(QuantizedVectorStoreTest, codes_can_be_saved_and_loaded)
+{
+    QuantizedVectorStore store(VectorQuantization::Int8, DistanceMetric::Euclidean, 4);
+    std::vector<float> first{1.0, -0.5, 0.25, 0.0};
+    std::vector<float> second{4.0, -4.0, 1.0, 0.5};
+    store.set_vector(1, vespalib::eval::TypedCells(vespalib::ConstArrayRef<float>(first)));
+    store.set_vector(2, vespalib::eval::TypedCells(vespalib::ConstArrayRef<float>(second)));
+    VectorBufferWriter writer;
+    store.make_saver(3)->save(writer);
+    search::fileutil::LoadedBuffer buf(writer.output.data(), writer.output.size());
+    QuantizedVectorStore binary_store(VectorQuantization::Binary, DistanceMetric::Euclidean, 4);
+    EXPECT_FALSE(binary_store.load(buf));
+    QuantizedVectorStore loaded(VectorQuantization::Int8, DistanceMetric::Euclidean, 4);
+    EXPECT_TRUE(loaded.load(buf));
+    for (uint32_t nodeid = 1; nodeid < 3; ++nodeid) {
+        auto exp_codes = store.get_codes(nodeid).unsafe_typify<vespalib::eval::Int8Float>();
+        auto act_codes = loaded.get_codes(nodeid).unsafe_typify<vespalib::eval::Int8Float>();
+        for (uint32_t i = 0; i < 4; ++i) {
+            EXPECT_EQ(exp_codes[i].get_bits(), act_codes[i].get_bits());
+        }
+    }
+    // Scale from the first vector is kept for later vectors
+    std::vector<int8_t> exp_third(4);
+    std::vector<int8_t> act_third(4);
+    store.quantize(vespalib::eval::TypedCells(vespalib::ConstArrayRef<float>(second)), exp_third.data());
+    loaded.quantize(vespalib::eval::TypedCells(vespalib::ConstArrayRef<float>(second)), act_third.data());
+    EXPECT_EQ(exp_third, act_third);
+}
+
 using HnswMultiIndexTest = HnswIndexTest<HnswIndex<HnswIndexType::MULTI>>;
 
 namespace {
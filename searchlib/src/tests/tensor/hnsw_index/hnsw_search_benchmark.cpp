@@ -0,0 +1,185 @@
+// Copyright Vespa.ai. Licensed under the terms of the Apache 2.0 license. See LICENSE in the project root.
+
+#include <vespa/eval/eval/typed_cells.h>
+#include <vespa/eval/eval/value_type.h>
+#include <vespa/searchlib/queryeval/global_filter.h>
+#include <vespa/searchlib/tensor/distance_function_factory.h>
+#include <vespa/searchlib/tensor/doc_vector_access.h>
+#include <vespa/searchlib/tensor/hnsw_index.h>
+#include <vespa/searchlib/tensor/inv_log_level_generator.h>
+#include <vespa/searchlib/tensor/subspace_type.h>
+#include <vespa/searchlib/tensor/vector_bundle.h>
+#include <vespa/vespalib/gtest/gtest.h>
+#include <vespa/vespalib/util/doom.h>
+#include <vespa/vespalib/util/generationhandler.h>
+#include <vespa/vespalib/util/time.h>
+#include <cstdio>
+#include <cstdlib>
+#include <fstream>
+#include <random>
+
+using namespace search::tensor;
+using search::attribute::DistanceMetric;
+using search::queryeval::GlobalFilter;
+using vespalib::eval::CellType;
+using vespalib::eval::TypedCells;
+using vespalib::eval::ValueType;
+
+/**
+ * Micro-benchmark measuring queries/sec for hnsw searches on a SIFT-style dataset.
+ *
+ * If $HOME/sift/sift_base.fvecs exists, the first num_docs vectors from that file
+ * are used, otherwise clustered synthetic vectors with the same shape
+ * (128 dimensions, small non-negative values) are generated.
+ * Run the benchmark on builds before and after a change to compare the numbers.
+ */
+
+namespace {
+
+constexpr uint32_t num_dims = 128;
+constexpr uint32_t num_docs = 100000;
+constexpr uint32_t num_queries = 2000;
+constexpr uint32_t num_clusters = 100;
+constexpr uint32_t target_hits = 10;
+constexpr uint32_t explore_additional_hits = 90;
+
+SubspaceType subspace_type(ValueType::make_type(CellType::FLOAT, {{"dims", num_dims}}));
+
+class BenchmarkVectors : public DocVectorAccess {
+    std::vector<float> _cells;
+public:
+    BenchmarkVectors(uint32_t num_vectors) : _cells(size_t(num_vectors) * num_dims) {}
+    float* vector_ptr(uint32_t idx) { return &_cells[size_t(idx) * num_dims]; }
+    const float* vector_ptr(uint32_t idx) const { return &_cells[size_t(idx) * num_dims]; }
+    TypedCells get_vector(uint32_t docid, uint32_t) const override {
+        return TypedCells(vespalib::ConstArrayRef<float>(vector_ptr(docid), num_dims));
+    }
+    VectorBundle get_vectors(uint32_t docid) const override {
+        return VectorBundle(vector_ptr(docid), 1, subspace_type);
+    }
+};
+
+bool
+read_sift_vectors(BenchmarkVectors& vectors, uint32_t num_vectors)
+{
+    const char* home = getenv("HOME");
+    if (home == nullptr) {
+        return false;
+    }
+    std::string file_name = std::string(home) + "/sift/sift_base.fvecs";
+    std::ifstream file(file_name, std::ios::binary);
+    if (!file) {
+        return false;
+    }
+    for (uint32_t i = 1; i < num_vectors; ++i) {
+        int32_t dims = 0;
+        file.read(reinterpret_cast<char*>(&dims), sizeof(dims));
+        if (!file || dims != int32_t(num_dims)) {
+            return false;
+        }
+        file.read(reinterpret_cast<char*>(vectors.vector_ptr(i)), num_dims * sizeof(float));
+    }
+    fprintf(stderr, "using %u vectors from %s\n", num_vectors - 1, file_name.c_str());
+    return bool(file);
+}
+
+void
+generate_vectors(BenchmarkVectors& vectors, uint32_t num_vectors, std::mt19937& rnd)
+{
+    std::uniform_real_distribution<float> center_dist(0.0, 100.0);
+    std::normal_distribution<float> noise(0.0, 10.0);
+    std::vector<float> centers(num_clusters * num_dims);
+    for (auto& cell : centers) {
+        cell = center_dist(rnd);
+    }
+    for (uint32_t i = 0; i < num_vectors; ++i) {
+        const float* center = &centers[(rnd() % num_clusters) * num_dims];
+        float* v = vectors.vector_ptr(i);
+        for (uint32_t d = 0; d < num_dims; ++d) {
+            v[d] = std::max(0.0f, std::round(center[d] + noise(rnd)));
+        }
+    }
+}
+
+}
+
+class HnswSearchBenchmark : public ::testing::Test {
+protected:
+    BenchmarkVectors vectors;
+    BenchmarkVectors queries;
+    vespalib::GenerationHandler gen_handler;
+    std::unique_ptr<HnswIndex<HnswIndexType::SINGLE>> index;
+
+    HnswSearchBenchmark()
+        : vectors(num_docs),
+          queries(num_queries),
+          gen_handler(),
+          index()
+    {
+        std::mt19937 rnd(42);
+        if (!read_sift_vectors(vectors, num_docs)) {
+            generate_vectors(vectors, num_docs, rnd);
+        }
+        // Queries are perturbed copies of document vectors, following the same distribution.
+        std::normal_distribution<float> noise(0.0, 5.0);
+        for (uint32_t i = 0; i < num_queries; ++i) {
+            const float* src = vectors.vector_ptr(1 + (rnd() % (num_docs - 1)));
+            float* dst = queries.vector_ptr(i);
+            for (uint32_t d = 0; d < num_dims; ++d) {
+                dst[d] = std::max(0.0f, src[d] + noise(rnd));
+            }
+        }
+        index = std::make_unique<HnswIndex<HnswIndexType::SINGLE>>(vectors,
+                                                                   make_distance_function_factory(DistanceMetric::Euclidean, CellType::FLOAT),
+                                                                   std::make_unique<InvLogLevelGenerator>(16),
+                                                                   HnswIndexConfig(32, 16, 200, 10, true));
+        auto before = vespalib::steady_clock::now();
+        for (uint32_t docid = 1; docid < num_docs; ++docid) {
+            index->add_document(docid);
+            if ((docid % 1000) == 0) {
+                commit();
+            }
+        }
+        commit();
+        fprintf(stderr, "built index with %u documents in %.2f seconds\n", num_docs - 1,
+                vespalib::to_s(vespalib::steady_clock::now() - before));
+    }
+    ~HnswSearchBenchmark() override;
+
+    void commit() {
+        index->assign_generation(gen_handler.getCurrentGeneration());
+        gen_handler.incGeneration();
+        index->reclaim_memory(gen_handler.get_oldest_used_generation());
+    }
+
+    void run_queries(const vespalib::string& label, const GlobalFilter* filter, bool filter_first) {
+        auto doom = vespalib::Doom::never();
+        size_t total_hits = 0;
+        auto before = vespalib::steady_clock::now();
+        for (uint32_t i = 0; i < num_queries; ++i) {
+            auto df = index->distance_function_factory().for_query_vector(queries.get_vector(i, 0));
+            auto hits = (filter != nullptr)
+                ? index->find_top_k_with_filter(target_hits, *df, *filter, filter_first, target_hits + explore_additional_hits, doom, 1e30)
+                : index->find_top_k(target_hits, *df, target_hits + explore_additional_hits, doom, 1e30);
+            total_hits += hits.size();
+        }
+        double elapsed_s = vespalib::to_s(vespalib::steady_clock::now() - before);
+        fprintf(stderr, "%s: %.1f queries/sec (%zu hits)\n", label.c_str(), num_queries / elapsed_s, total_hits);
+    }
+};
+
+HnswSearchBenchmark::~HnswSearchBenchmark() = default;
+
+TEST_F(HnswSearchBenchmark, queries_per_second)
+{
+    run_queries("no filter", nullptr, false);
+    std::vector<uint32_t> docids;
+    for (uint32_t docid = 1; docid < num_docs; docid += 20) {
+        docids.push_back(docid);
+    }
+    auto filter = GlobalFilter::create(docids, num_docs);
+    run_queries("5% filter", filter.get(), false);
+    run_queries("5% filter (filter first)", filter.get(), true);
+}
+
+GTEST_MAIN_RUN_ALL_TESTS()
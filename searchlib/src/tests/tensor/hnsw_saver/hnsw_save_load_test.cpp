@@ -213,4 +213,19 @@ TYPED_TEST(CopyGraphTest, later_changes_ignored)
     this->expect_copy_as_populated();
 }
 
+TYPED_TEST(CopyGraphTest, only_nodes_changed_after_snapshot_are_preserved)
+{
+    populate(this->original);
+    auto snapshot = this->original.make_snapshot();
+    EXPECT_EQ(7, snapshot->num_nodes());
+    modify(this->original);
+    // Nodes 1, 2, 4 and 6 are changed, node 7 is added after the snapshot was taken
+    EXPECT_EQ(4, snapshot->num_preserved());
+    EXPECT_EQ(1, this->original.snapshots.size());
+    snapshot->release();
+    this->original.set_link_array(1, 0, V{4});
+    EXPECT_EQ(0, this->original.snapshots.size());
+    EXPECT_EQ(4, snapshot->num_preserved());
+}
+
 GTEST_MAIN_RUN_ALL_TESTS()
@@ -8,6 +8,7 @@
 #include <vespa/vespalib/gtest/gtest.h>
 #include <vespa/vespalib/stllike/asciistream.h>
 #include <vespa/vespalib/stllike/hash_set.h>
+#include <algorithm>
 
 using search::tensor::TensorBufferStore;
 using vespalib::datastore::EntryRef;
@@ -208,4 +209,45 @@ TEST_F(TensorBufferStoreTest, buffer_handles_range_of_subspaces)
     }
 }
 
+TEST_F(TensorBufferStoreTest, identical_subspaces_are_shared_when_deduplicated)
+{
+    const vespalib::string mixed_type_spec("tensor(x{},y[2])");
+    auto mixed_type = ValueType::from_spec(mixed_type_spec);
+    TensorBufferStore store(mixed_type, {}, 4, true);
+    auto dedup_subspaces = store.get_dedup_subspaces();
+    ASSERT_NE(nullptr, dedup_subspaces);
+    auto spec1 = TensorSpec(mixed_type_spec).add({{"x", "a"}, {"y", 0}}, 1.5).add({{"x", "a"}, {"y", 1}}, 2.5)
+                                            .add({{"x", "b"}, {"y", 0}}, 1.5).add({{"x", "b"}, {"y", 1}}, 2.5);
+    auto spec2 = TensorSpec(mixed_type_spec).add({{"x", "c"}, {"y", 0}}, 1.5).add({{"x", "c"}, {"y", 1}}, 2.5)
+                                            .add({{"x", "d"}, {"y", 0}}, 3.5).add({{"x", "d"}, {"y", 1}}, 4.5);
+    auto ref1 = store.store_tensor(*value_from_spec(spec1, FastValueBuilderFactory::get()));
+    auto ref2 = store.store_tensor(*value_from_spec(spec2, FastValueBuilderFactory::get()));
+    EXPECT_EQ(2u, dedup_subspaces->num_unique_subspaces());
+    EXPECT_EQ(spec1, TensorSpec::from_value(*store.get_tensor(ref1)));
+    EXPECT_EQ(spec2, TensorSpec::from_value(*store.get_tensor(ref2)));
+    std::vector<double> values;
+    auto vectors = store.get_vectors(ref2);
+    EXPECT_EQ(2, vectors.subspaces());
+    for (uint32_t subspace = 0; subspace < 2; ++subspace) {
+        auto cells = vectors.cells(subspace).typify<double>();
+        values.insert(values.end(), cells.begin(), cells.end());
+    }
+    std::sort(values.begin(), values.end());
+    EXPECT_EQ((std::vector<double>{1.5, 2.5, 3.5, 4.5}), values);
+    vespalib::nbostream encoded;
+    store.encode_stored_tensor(ref1, encoded);
+    auto ref3 = store.store_encoded_tensor(encoded);
+    EXPECT_EQ(spec1, TensorSpec::from_value(*store.get_tensor(ref3)));
+    EXPECT_EQ(2u, dedup_subspaces->num_unique_subspaces());
+    store.holdTensor(ref2);
+    store.assign_generation(1);
+    store.reclaim_memory(2);
+    EXPECT_EQ(1u, dedup_subspaces->num_unique_subspaces());
+    store.holdTensor(ref1);
+    store.holdTensor(ref3);
+    store.assign_generation(2);
+    store.reclaim_memory(3);
+    EXPECT_EQ(0u, dedup_subspaces->num_unique_subspaces());
+}
+
 GTEST_MAIN_RUN_ALL_TESTS()
@@ -1,6 +1,7 @@
 // Copyright Vespa.ai. Licensed under the terms of the Apache 2.0 license. See LICENSE in the project root.
 #include <vespa/searchlib/transactionlog/translogclient.h>
 #include <vespa/searchlib/transactionlog/translogserver.h>
+#include <vespa/searchlib/transactionlog/domainpart.h>
 #include <vespa/searchlib/test/directory_handler.h>
 #include <vespa/vespalib/testkit/testapp.h>
 #include <vespa/vespalib/objects/identifiable.h>
@@ -12,6 +13,7 @@
 #include <vespa/fnet/transport.h>
 #include <vespa/fastos/file.h>
 #include <thread>
+#include <sys/stat.h>
 
 #include <vespa/log/log.h>
 LOG_SETUP("translogclient_test");
@@ -34,8 +36,9 @@ bool createDomainTest(TransLogClient & tls, const vespalib::string & name, size_
 std::unique_ptr<Session> openDomainTest(TransLogClient & tls, const vespalib::string & name);
 bool fillDomainTest(Session * s1, const vespalib::string & name);
 void fillDomainTest(Session * s1, size_t numPackets, size_t numEntries);
-void fillDomainTest(Session * s1, size_t numPackets, size_t numEntries, size_t entrySize);
+void fillDomainTest(Session * s1, size_t numPackets, size_t numEntries, size_t entrySize, SerialNum firstSerial = 1);
 uint32_t countFiles(const std::string& dir);
+size_t allocatedBytes(const std::string& fileName);
 void checkFilledDomainTest(Session &s1, size_t numEntries);
 bool visitDomainTest(TransLogClient & tls, Session * s1, const vespalib::string & name);
 void createAndFillDomain(const vespalib::string & dir, const vespalib::string & name, Encoding encoding, size_t preExistingDomains);
@@ -372,9 +375,9 @@ fillDomainTest(TransLogServer & tls, const vespalib::string & domain, size_t num
 }
 
 void
-fillDomainTest(Session * s1, size_t numPackets, size_t numEntries, size_t entrySize)
+fillDomainTest(Session * s1, size_t numPackets, size_t numEntries, size_t entrySize, SerialNum firstSerial)
 {
-    size_t value(0);
+    size_t value(firstSerial - 1);
     std::vector<char> entryBuffer(entrySize);
     for(size_t i=0; i < numPackets; i++) {
         std::unique_ptr<Packet> p(new Packet(DEFAULT_PACKET_SIZE));
@@ -403,6 +406,16 @@ countFiles(const std::string& dir)
     return res;
 }
 
+size_t
+allocatedBytes(const std::string& fileName)
+{
+    struct stat st;
+    if (stat(fileName.c_str(), &st) != 0) {
+        return 0;
+    }
+    return st.st_blocks * 512;
+}
+
 void
 checkFilledDomainTest(Session &s1, size_t numEntries)
 {
@@ -791,6 +804,30 @@ TEST("test sending a lot of data both sync and async") {
 }
 
 
+TEST("test that batched commits with fsync on commit are acked and visitable") {
+    const unsigned int NUM_PACKETS = 200;
+    const unsigned int NUM_ENTRIES = 50;
+    const unsigned int TOTAL_NUM_ENTRIES = NUM_PACKETS * NUM_ENTRIES;
+    const vespalib::string BATCHED("batched-fsync");
+    test::DirectoryHandler testDir("test14");
+    DummyFileHeaderContext fileHeaderContext;
+    TLS tlss(testDir.getDir(), 18377, ".", fileHeaderContext, createDomainConfig(0x20000).setFSyncOnCommit(true));
+    TransLogClient tls(tlss.transport, "tcp/localhost:18377");
+    createDomainTest(tls, BATCHED, 0);
+    auto s1 = openDomainTest(tls, BATCHED);
+    fillDomainTest(tlss.tls, BATCHED, NUM_PACKETS, NUM_ENTRIES);
+    SerialNum syncedTo(0);
+    EXPECT_TRUE(s1->sync(TOTAL_NUM_ENTRIES, syncedTo));
+    EXPECT_EQUAL(syncedTo, TOTAL_NUM_ENTRIES);
+    CallBackManyTest ca(2);
+    auto visitor = tls.createVisitor(BATCHED, ca);
+    ASSERT_TRUE(visitor);
+    ASSERT_TRUE( visitor->visit(2, TOTAL_NUM_ENTRIES) );
+    ASSERT_TRUE( ca.wait_for_eof() );
+    EXPECT_EQUAL(ca._count, TOTAL_NUM_ENTRIES);
+    EXPECT_EQUAL(ca._value, TOTAL_NUM_ENTRIES);
+}
+
 TEST("testErase") {
     const unsigned int NUM_PACKETS = 1000;
     const unsigned int NUM_ENTRIES = 100;
@@ -1000,4 +1037,49 @@ TEST("test truncation after short read") {
     EXPECT_EQUAL(2u, countFiles(dir));
 }
 
+TEST("test that the active domain part preallocates disk space and releases it when closed") {
+    test::DirectoryHandler testDir("test13");
+    DummyFileHeaderContext fileHeaderContext;
+    vespalib::string fileName = DomainPart::partFileName(testDir.getDir(), "prealloc", 1);
+    DomainPart part("prealloc", testDir.getDir(), 1, fileHeaderContext, false, 1_Mi);
+    FastOS_File file(fileName.c_str());
+    EXPECT_EQUAL(int64_t(part.byteSize()), file.getSize());
+    EXPECT_LESS(part.byteSize(), 1_Mi);
+    EXPECT_GREATER_EQUAL(allocatedBytes(fileName), 1_Mi);
+    part.close();
+    EXPECT_EQUAL(int64_t(part.byteSize()), file.getSize());
+    EXPECT_LESS(allocatedBytes(fileName), 1_Mi);
+}
+
+TEST("test that erased domain parts are recycled as new parts") {
+    const unsigned int NUM_PACKETS = 17;
+    const unsigned int ENTRYSIZE = 4080;
+    test::DirectoryHandler topdir("test14");
+    vespalib::string domain("recycle");
+    vespalib::string dir(topdir.getDir() + "/" + domain);
+    vespalib::string recycledName(dir + "/recycle-recycled");
+    DummyFileHeaderContext fileHeaderContext;
+    TLS tlss(topdir.getDir(), 18377, ".", fileHeaderContext, createDomainConfig(0x10000));
+    TransLogClient tls(tlss.transport, "tcp/localhost:18377");
+
+    createDomainTest(tls, domain, 0);
+    auto s1 = openDomainTest(tls, domain);
+    fillDomainTest(s1.get(), NUM_PACKETS, 1, ENTRYSIZE);
+    EXPECT_EQUAL(2u, countFiles(dir));
+    // Erasing the first part leaves its file emptied, but with its disk space reserved
+    ASSERT_TRUE(s1->erase(NUM_PACKETS));
+    EXPECT_EQUAL(2u, countFiles(dir));
+    FastOS_File recycled(recycledName.c_str());
+    EXPECT_EQUAL(0, recycled.getSize());
+    EXPECT_GREATER_EQUAL(allocatedBytes(recycledName), 0x10000u);
+    // The next part takes over the recycled file
+    fillDomainTest(s1.get(), NUM_PACKETS, 1, ENTRYSIZE, NUM_PACKETS + 1);
+    EXPECT_EQUAL(2u, countFiles(dir));
+    EXPECT_EQUAL(0u, allocatedBytes(recycledName));
+    SerialNum b(0), e(0);
+    size_t c(0);
+    EXPECT_TRUE(s1->status(b, e, c));
+    EXPECT_EQUAL(e, 2u * NUM_PACKETS);
+}
+
 TEST_MAIN() { TEST_RUN_ALL(); }
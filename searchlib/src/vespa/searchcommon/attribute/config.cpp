@@ -23,15 +23,24 @@ Config::Config(BasicType bt, CollectionType ct, bool fastSearch_) noexcept
       _fastAccess(false),
       _mutable(false),
       _paged(false),
+      _save_posting_lists(false),
+      _dedup_tensor_subspaces(false),
       _distance_metric(DistanceMetric::Euclidean),
+      _memory_placement(),
       _match(Match::UNCASED),
       _dictionary(),
       _maxUnCommittedMemory(MAX_UNCOMMITTED_MEMORY),
+      _filter_cache_max_bytes(0),
+      _range_bucket_levels(0),
+      _range_bucket_bits(0),
+      _write_shards(1),
+      _max_delta_saves(0),
       _growStrategy(),
       _compactionStrategy(),
       _predicateParams(),
       _tensorType(vespalib::eval::ValueType::error_type()),
-      _hnsw_index_params()
+      _hnsw_index_params(),
+      _uca_sort_keys()
 {
 }
 
@@ -51,7 +60,15 @@ Config::operator==(const Config &b) const noexcept
            _fastAccess == b._fastAccess &&
            _mutable == b._mutable &&
            _paged == b._paged &&
+           _save_posting_lists == b._save_posting_lists &&
+           _dedup_tensor_subspaces == b._dedup_tensor_subspaces &&
+           _memory_placement == b._memory_placement &&
            _maxUnCommittedMemory == b._maxUnCommittedMemory &&
+           _filter_cache_max_bytes == b._filter_cache_max_bytes &&
+           _range_bucket_levels == b._range_bucket_levels &&
+           _range_bucket_bits == b._range_bucket_bits &&
+           _write_shards == b._write_shards &&
+           _max_delta_saves == b._max_delta_saves &&
            _match == b._match &&
            _dictionary == b._dictionary &&
            _growStrategy == b._growStrategy &&
@@ -60,7 +77,8 @@ Config::operator==(const Config &b) const noexcept
            (_basicType.type() != BasicType::Type::TENSOR ||
             _tensorType == b._tensorType) &&
             _distance_metric == b._distance_metric &&
-            _hnsw_index_params == b._hnsw_index_params;
+            _hnsw_index_params == b._hnsw_index_params &&
+            _uca_sort_keys == b._uca_sort_keys;
 }
 
 Config&
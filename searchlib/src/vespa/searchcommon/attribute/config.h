@@ -6,11 +6,14 @@
 #include "collectiontype.h"
 #include "hnsw_index_params.h"
 #include "predicate_params.h"
+#include "uca_sort_key_params.h"
 #include <vespa/searchcommon/common/growstrategy.h>
 #include <vespa/searchcommon/common/dictionary_config.h>
 #include <vespa/eval/eval/value_type.h>
 #include <vespa/vespalib/datastore/compaction_strategy.h>
+#include <vespa/vespalib/util/memory_placement.h>
 #include <optional>
+#include <vector>
 
 namespace search::attribute {
 
@@ -23,6 +26,7 @@ class Config {
 public:
     enum class Match : uint8_t { CASED, UNCASED };
     using CompactionStrategy = vespalib::datastore::CompactionStrategy;
+    using MemoryPlacement = vespalib::alloc::MemoryPlacement;
     Config() noexcept;
     Config(BasicType bt) noexcept : Config(bt, CollectionType::SINGLE) { }
     Config(BasicType bt, CollectionType ct) noexcept : Config(bt, ct, false) { }
@@ -37,6 +41,11 @@ public:
     CollectionType collectionType()       const noexcept { return _type; }
     bool fastSearch()                     const noexcept { return _fastSearch; }
     bool paged()                          const noexcept { return _paged; }
+    /**
+     * Placement (huge pages, numa node) of the memory backing large allocations
+     * in the attribute vector. Ignored for paged attributes.
+     */
+    const MemoryPlacement & memory_placement() const noexcept { return _memory_placement; }
     const PredicateParams &predicateParams() const noexcept { return _predicateParams; }
     const vespalib::eval::ValueType & tensorType() const noexcept { return _tensorType; }
     DistanceMetric distance_metric() const noexcept { return _distance_metric; }
@@ -84,6 +93,7 @@ public:
     Config & setIsFilter(bool isFilter) { _isFilter = isFilter; return *this; }
     Config & setMutable(bool isMutable) { _mutable = isMutable; return *this; }
     Config & setPaged(bool paged_in) { _paged = paged_in; return *this; }
+    Config & set_memory_placement(const MemoryPlacement & placement) { _memory_placement = placement; return *this; }
     Config & setFastAccess(bool v) { _fastAccess = v; return *this; }
     Config & setGrowStrategy(const GrowStrategy &gs) { _growStrategy = gs; return *this; }
     Config & setCompactionStrategy(const CompactionStrategy &compactionStrategy) {
@@ -98,6 +108,62 @@ public:
     uint64_t getMaxUnCommittedMemory() const noexcept { return _maxUnCommittedMemory; }
     Config & setMaxUnCommittedMemory(uint64_t value) { _maxUnCommittedMemory = value; return *this; }
 
+    /**
+     * Max memory used for caching bitvectors of frequently repeated filter
+     * terms (ranges, prefixes) on fast-search attributes. 0 disables the cache.
+     */
+    uint64_t filter_cache_max_bytes() const noexcept { return _filter_cache_max_bytes; }
+    Config & set_filter_cache_max_bytes(uint64_t value) { _filter_cache_max_bytes = value; return *this; }
+
+    /**
+     * Number of levels of value bucket bitvectors maintained for range terms
+     * on single value integer attributes with fast-search, where the lowest
+     * level buckets span 2^range_bucket_bits values and each level above
+     * spans 16 buckets of the level below. 0 levels disables the index.
+     */
+    uint32_t range_bucket_levels() const noexcept { return _range_bucket_levels; }
+    uint32_t range_bucket_bits() const noexcept { return _range_bucket_bits; }
+    Config & set_range_bucket_levels(uint32_t value) { _range_bucket_levels = value; return *this; }
+    Config & set_range_bucket_bits(uint32_t value) { _range_bucket_bits = value; return *this; }
+
+    /**
+     * Whether posting lists of enumerated fast-search attributes are saved
+     * to a separate file, letting load skip regrouping values per posting list.
+     */
+    bool save_posting_lists() const noexcept { return _save_posting_lists; }
+    Config & set_save_posting_lists(bool value) { _save_posting_lists = value; return *this; }
+
+    /**
+     * Whether identical dense subspaces of mixed tensors are stored once and
+     * shared between documents and between subspaces of the same document.
+     */
+    bool dedup_tensor_subspaces() const noexcept { return _dedup_tensor_subspaces; }
+    Config & set_dedup_tensor_subspaces(bool value) { _dedup_tensor_subspaces = value; return *this; }
+
+    /**
+     * Locales for which single value string attributes keep a precomputed
+     * uca sort key per document, used instead of collating the value when
+     * sorting on uca(attribute,locale,strength) with a matching locale.
+     */
+    const std::vector<UcaSortKeyParams> & uca_sort_keys() const noexcept { return _uca_sort_keys; }
+    Config & set_uca_sort_keys(std::vector<UcaSortKeyParams> value) { _uca_sort_keys = std::move(value); return *this; }
+
+    /**
+     * Number of write threads applying partial updates to disjoint lid ranges
+     * of the attribute concurrently. Only used for attributes supporting
+     * direct updates (single value numeric without fast-search).
+     */
+    uint32_t write_shards() const noexcept { return _write_shards; }
+    Config & set_write_shards(uint32_t value) { _write_shards = value; return *this; }
+
+    /**
+     * Max number of consecutive saves that only write the values changed
+     * since the previous save. Only used for single value numeric attributes
+     * without fast-search. 0 disables delta saves.
+     */
+    uint32_t max_delta_saves() const noexcept { return _max_delta_saves; }
+    Config & set_max_delta_saves(uint32_t value) { _max_delta_saves = value; return *this; }
+
 private:
     BasicType      _basicType;
     CollectionType _type;
@@ -106,15 +172,24 @@ private:
     bool           _fastAccess : 1;
     bool           _mutable : 1;
     bool           _paged : 1;
+    bool           _save_posting_lists : 1;
+    bool           _dedup_tensor_subspaces : 1;
     DistanceMetric                 _distance_metric;
+    MemoryPlacement                _memory_placement;
     Match                          _match;
     DictionaryConfig               _dictionary;
     uint64_t                       _maxUnCommittedMemory;
+    uint64_t                       _filter_cache_max_bytes;
+    uint32_t                       _range_bucket_levels;
+    uint32_t                       _range_bucket_bits;
+    uint32_t                       _write_shards;
+    uint32_t                       _max_delta_saves;
     GrowStrategy                   _growStrategy;
     CompactionStrategy             _compactionStrategy;
     PredicateParams                _predicateParams;
     vespalib::eval::ValueType      _tensorType;
     std::optional<HnswIndexParams> _hnsw_index_params;
+    std::vector<UcaSortKeyParams>  _uca_sort_keys;
 };
 
 }
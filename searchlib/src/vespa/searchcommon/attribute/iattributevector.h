@@ -8,6 +8,7 @@
 #include <vespa/vespalib/datastore/atomic_entry_ref.h>
 #include <vespa/vespalib/util/arrayref.h>
 #include <ostream>
+#include <string_view>
 #include <vector>
 
 namespace search {
@@ -128,6 +129,32 @@ public:
      **/
     virtual double getFloat(DocId doc)   const = 0;
 
+    /**
+     * Returns the first value stored for each of the given documents as an integer.
+     * Attributes that can read a batch of documents cheaper than one document
+     * at a time (e.g. imported attributes) override this.
+     *
+     * @param docids document identifiers
+     * @param values output buffer with room for one value per document
+     **/
+    virtual void get_ints(vespalib::ConstArrayRef<DocId> docids, largeint_t *values) const {
+        for (size_t i = 0; i < docids.size(); ++i) {
+            values[i] = getInt(docids[i]);
+        }
+    }
+
+    /**
+     * Returns the first value stored for each of the given documents as a floating point number.
+     *
+     * @param docids document identifiers
+     * @param values output buffer with room for one value per document
+     **/
+    virtual void get_floats(vespalib::ConstArrayRef<DocId> docids, double *values) const {
+        for (size_t i = 0; i < docids.size(); ++i) {
+            values[i] = getFloat(docids[i]);
+        }
+    }
+
     /**
      * Return raw value.
      *
@@ -135,6 +162,15 @@ public:
      */
     virtual vespalib::ConstArrayRef<char> get_raw(DocId doc) const = 0;
 
+    /**
+     * Returns a view of the string (or raw) value stored for the given document
+     * without copying it. The view is valid as long as a read guard is held.
+     */
+    std::string_view get_string_view(DocId doc) const {
+        auto raw = get_raw(doc);
+        return {raw.data(), raw.size()};
+    }
+
     /**
      * Returns the first value stored for the given document as an enum value.
      *
@@ -20,7 +20,8 @@ Status::Status()
       _lastSyncToken        (0),
       _updates              (0),
       _nonIdempotentUpdates (0),
-      _bitVectors(0)
+      _bitVectors(0),
+      _compactionPending(0)
 {
 }
 
@@ -37,7 +38,8 @@ Status::Status(const Status& rhs)
       _lastSyncToken(rhs.getLastSyncToken()),
       _updates(rhs._updates),
       _nonIdempotentUpdates(rhs._nonIdempotentUpdates),
-      _bitVectors(load_relaxed(rhs._bitVectors))
+      _bitVectors(load_relaxed(rhs._bitVectors)),
+      _compactionPending(load_relaxed(rhs._compactionPending))
 {
 }
 
@@ -57,6 +59,7 @@ Status::operator=(const Status& rhs)
     _updates = rhs._updates;
     _nonIdempotentUpdates = rhs._nonIdempotentUpdates;
     store_relaxed(_bitVectors, load_relaxed(rhs._bitVectors));
+    store_relaxed(_compactionPending, load_relaxed(rhs._compactionPending));
     return *this;
 }
 
@@ -30,6 +30,8 @@ public:
     uint64_t getUpdateCount()              const { return _updates; }
     uint64_t getNonIdempotentUpdateCount() const { return _nonIdempotentUpdates; }
     uint32_t getBitVectors() const { return _bitVectors.load(std::memory_order_relaxed); }
+    // Number of documents not yet visited by an ongoing incremental compaction.
+    uint64_t getCompactionPending()        const { return _compactionPending.load(std::memory_order_relaxed); }
 
     void setNumDocs(uint64_t v)                  { _numDocs.store(v, std::memory_order_relaxed); }
     void incNumDocs()                            { _numDocs.store(_numDocs.load(std::memory_order_relaxed) + 1u,
@@ -39,6 +41,7 @@ public:
     void incNonIdempotentUpdates(uint64_t v = 1) { _nonIdempotentUpdates += v; }
     void incBitVectors() { _bitVectors.store(getBitVectors() + 1, std::memory_order_relaxed); }
     void decBitVectors() { _bitVectors.store(getBitVectors() - 1, std::memory_order_relaxed); }
+    void setCompactionPending(uint64_t v)        { _compactionPending.store(v, std::memory_order_relaxed); }
 
     static vespalib::string
     createName(vespalib::stringref index, vespalib::stringref attr);
@@ -56,6 +59,7 @@ private:
     uint64_t _updates;
     uint64_t _nonIdempotentUpdates;
     std::atomic<uint32_t> _bitVectors;
+    std::atomic<uint64_t> _compactionPending;
 };
 
 }
@@ -0,0 +1,33 @@
+// Copyright Vespa.ai. Licensed under the terms of the Apache 2.0 license. See LICENSE in the project root.
+
+#pragma once
+
+#include <vespa/vespalib/stllike/string.h>
+
+namespace search::attribute {
+
+/**
+ * Locale and collation strength of uca sort keys precomputed by a string attribute,
+ * matching the arguments of uca(attribute,locale,strength) in the sort spec.
+ */
+class UcaSortKeyParams {
+private:
+    vespalib::string _locale;
+    vespalib::string _strength;
+
+public:
+    UcaSortKeyParams(vespalib::stringref locale_in, vespalib::stringref strength_in)
+        : _locale(locale_in),
+          _strength(strength_in)
+    {}
+
+    const vespalib::string& locale() const noexcept { return _locale; }
+    // Empty means the default strength (PRIMARY)
+    const vespalib::string& strength() const noexcept { return _strength; }
+
+    bool operator==(const UcaSortKeyParams& rhs) const noexcept {
+        return (_locale == rhs._locale) && (_strength == rhs._strength);
+    }
+};
+
+}
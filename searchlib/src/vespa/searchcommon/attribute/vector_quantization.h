@@ -0,0 +1,15 @@
+// Copyright Vespa.ai. Licensed under the terms of the Apache 2.0 license. See LICENSE in the project root.
+
+#pragma once
+
+#include <cstdint>
+
+namespace search::attribute {
+
+/**
+ * Quantization used for the compact vector codes an hnsw index can keep
+ * alongside the full-precision vectors for graph traversal.
+ */
+enum class VectorQuantization : uint8_t { None, Int8, Binary };
+
+}
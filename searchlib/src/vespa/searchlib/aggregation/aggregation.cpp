@@ -267,6 +267,11 @@ MinAggregationResult::onReset()
     _min->setMax();
 }
 
+AverageAggregationResult::AverageAggregationResult(NumericResultNode::UP sum, uint64_t count)
+    : AggregationResult(),
+      _sum(sum.release()),
+      _count(count)
+{ }
 AverageAggregationResult::~AverageAggregationResult() = default;
 
 void
@@ -12,6 +12,7 @@ public:
     using NumericResultNode = expression::NumericResultNode;
     DECLARE_AGGREGATIONRESULT(AverageAggregationResult);
     AverageAggregationResult() : _sum(), _count(0) {}
+    AverageAggregationResult(NumericResultNode::UP sum, uint64_t count);
     ~AverageAggregationResult() override;
     void visitMembers(vespalib::ObjectVisitor &visitor) const override;
     const NumericResultNode & getAverage() const;
@@ -0,0 +1,359 @@
+// Copyright Vespa.ai. Licensed under the terms of the Apache 2.0 license. See LICENSE in the project root.
+
+#include "columnar_grouper.h"
+#include "grouping.h"
+#include "averageaggregationresult.h"
+#include "countaggregationresult.h"
+#include "sumaggregationresult.h"
+#include <vespa/searchcommon/attribute/iattributevector.h>
+#include <vespa/searchlib/expression/attributenode.h>
+#include <vespa/searchlib/expression/constantnode.h>
+#include <vespa/searchlib/expression/floatresultnode.h>
+#include <vespa/searchlib/expression/integerresultnode.h>
+#include <vespa/vespalib/stllike/hash_map.hpp>
+#include <cassert>
+#include <cmath>
+#include <limits>
+#include <optional>
+
+using search::attribute::BasicType;
+using search::attribute::IAttributeVector;
+using search::expression::AttributeNode;
+using search::expression::ConstantNode;
+using search::expression::ExpressionNode;
+using search::expression::FloatResultNode;
+using search::expression::Int64ResultNode;
+using search::expression::IntegerResultNode;
+using search::expression::NumericResultNode;
+using search::expression::ResultNode;
+
+namespace search::aggregation {
+
+namespace {
+
+enum class Kind { COUNT, SUM, AVERAGE };
+
+struct Column {
+    Kind                     kind;
+    const IAttributeVector * attribute; // nullptr for count
+    bool                     attributeIsFloat;
+    bool                     sumIsFloat;
+};
+
+struct Plan {
+    GroupingLevel          * level;
+    const IAttributeVector * keyAttribute;
+    bool                     collect;
+    std::vector<Column>      columns;
+};
+
+/**
+ * Returns the attribute if the node is a plain attribute lookup on a
+ * single value numeric attribute, otherwise nullptr.
+ **/
+const IAttributeVector *
+singleValueNumericAttribute(ExpressionNode *node)
+{
+    if ((node == nullptr) || (node->getClass().id() != AttributeNode::classId)) {
+        return nullptr;
+    }
+    auto &attrNode = static_cast<AttributeNode &>(*node);
+    const IAttributeVector *attr = attrNode.getAttribute();
+    if ((attr == nullptr) || attr->hasMultiValue() || (attrNode.getCurrentIndex() != nullptr)) {
+        return nullptr;
+    }
+    if ((attr->isIntegerType() && (attr->getBasicType() != BasicType::BOOL)) || attr->isFloatingPointType()) {
+        return attr;
+    }
+    return nullptr;
+}
+
+std::optional<Column>
+makeColumn(AggregationResult &aggr)
+{
+    auto classId = aggr.getClass().id();
+    if (classId == CountAggregationResult::classId) {
+        ExpressionNode *expr = aggr.getExpression();
+        if ((expr != nullptr) && (expr->getClass().id() != ConstantNode::classId) &&
+            (singleValueNumericAttribute(expr) == nullptr))
+        {
+            return std::nullopt;
+        }
+        if ((expr != nullptr) && (expr->getResult() != nullptr) && expr->getResult()->isMultiValue()) {
+            return std::nullopt;
+        }
+        return Column{Kind::COUNT, nullptr, false, false};
+    }
+    if ((classId != SumAggregationResult::classId) && (classId != AverageAggregationResult::classId)) {
+        return std::nullopt;
+    }
+    // The attribute is only wired (and the sum prepared) after configureStaticStuff().
+    const IAttributeVector *attr = singleValueNumericAttribute(aggr.getExpression());
+    if (attr == nullptr) {
+        return std::nullopt;
+    }
+    Kind kind = (classId == SumAggregationResult::classId) ? Kind::SUM : Kind::AVERAGE;
+    const NumericResultNode *sum = (kind == Kind::SUM)
+                                   ? &static_cast<const SumAggregationResult &>(aggr).getSum()
+                                   : &static_cast<const AverageAggregationResult &>(aggr).getSum();
+    bool sumIsFloat = sum->inherits(FloatResultNode::classId);
+    if (!sumIsFloat && !(sum->inherits(IntegerResultNode::classId) && attr->isIntegerType())) {
+        return std::nullopt;
+    }
+    return Column{kind, attr, attr->isFloatingPointType(), sumIsFloat};
+}
+
+std::optional<Plan>
+makePlan(Grouping &grouping)
+{
+    if ((grouping.getLevels().size() != 1) || (grouping.getFirstLevel() != 0) ||
+        (grouping.getRoot().getAggrSize() != 0) || (grouping.getRoot().getChildrenSize() != 0))
+    {
+        return std::nullopt;
+    }
+    GroupingLevel &level = grouping.levels()[0];
+    ExpressionNode *keyExpr = level.getExpression().getRoot();
+    const IAttributeVector *keyAttr = singleValueNumericAttribute(keyExpr);
+    if ((keyAttr == nullptr) || !keyAttr->isIntegerType() || (level.getExpression().getResult() == nullptr) ||
+        !level.getExpression().getResult()->inherits(IntegerResultNode::classId))
+    {
+        return std::nullopt;
+    }
+    Group &prototype = level.groupPrototype();
+    if (prototype.getChildrenSize() != 0) {
+        return std::nullopt;
+    }
+    Plan plan{&level, keyAttr, grouping.getLastLevel() > 0, {}};
+    if (plan.collect) {
+        plan.columns.reserve(prototype.getAggrSize());
+        for (uint32_t i = 0; i < prototype.getAggrSize(); ++i) {
+            auto column = makeColumn(prototype.getAggregationResult(i));
+            if (!column) {
+                return std::nullopt;
+            }
+            plan.columns.push_back(*column);
+        }
+    }
+    return plan;
+}
+
+RawRank
+sanitize(RawRank rank)
+{
+    return std::isnan(rank) ? -HUGE_VAL : rank;
+}
+
+/**
+ * Flat aggregation state for all groups, in the order the groups were first seen.
+ **/
+class Aggregator
+{
+    struct Sum {
+        uint64_t integer; // wraps around like the integer result nodes
+        double   floating;
+    };
+    const Plan                         &_plan;
+    vespalib::hash_map<int64_t, uint32_t> _groupIndex;
+    std::vector<int64_t>                _keys;
+    std::vector<RawRank>                _ranks;
+    std::vector<uint64_t>               _counts;
+    std::vector<Sum>                    _sums;   // _plan.columns.size() entries per group
+    std::vector<int64_t>                _batchKeys;
+    std::vector<Sum>                    _batchValues;
+    std::vector<int64_t>                _batchInts;
+    std::vector<double>                 _batchFloats;
+
+    uint32_t lookup(int64_t key, HitRank rank);
+    void readBatch(const uint32_t *docIds, uint32_t numDocs);
+public:
+    explicit Aggregator(const Plan &plan);
+    ~Aggregator();
+    void aggregateBatch(const uint32_t *docIds, const HitRank *ranks, uint32_t numDocs);
+    void insertGroups(Group &root) const;
+};
+
+Aggregator::Aggregator(const Plan &plan)
+    : _plan(plan),
+      _groupIndex(),
+      _keys(),
+      _ranks(),
+      _counts(),
+      _sums(),
+      _batchKeys(ColumnarGrouper::batch_size),
+      _batchValues(ColumnarGrouper::batch_size * plan.columns.size()),
+      _batchInts(ColumnarGrouper::batch_size),
+      _batchFloats(ColumnarGrouper::batch_size)
+{
+}
+
+Aggregator::~Aggregator() = default;
+
+constexpr uint32_t no_group = std::numeric_limits<uint32_t>::max();
+
+uint32_t
+Aggregator::lookup(int64_t key, HitRank rank)
+{
+    auto found = _groupIndex.find(key);
+    if (found != _groupIndex.end()) {
+        uint32_t group = found->second;
+        _ranks[group] = sanitize(std::max(_ranks[group], static_cast<RawRank>(rank)));
+        return group;
+    }
+    if (!_plan.level->allowMoreGroups(_keys.size())) {
+        return no_group;
+    }
+    uint32_t group = _keys.size();
+    _groupIndex[key] = group;
+    _keys.push_back(key);
+    _ranks.push_back(sanitize(rank));
+    _counts.push_back(0);
+    _sums.resize(_sums.size() + _plan.columns.size(), Sum{0, 0.0});
+    return group;
+}
+
+void
+Aggregator::readBatch(const uint32_t *docIds, uint32_t numDocs)
+{
+    // Batch reads let imported attributes resolve and read parent documents once per batch
+    vespalib::ConstArrayRef<uint32_t> docids(docIds, numDocs);
+    _plan.keyAttribute->get_ints(docids, _batchKeys.data());
+    size_t numColumns = _plan.columns.size();
+    for (size_t c = 0; c < numColumns; ++c) {
+        const Column &column = _plan.columns[c];
+        if (column.kind == Kind::COUNT) {
+            continue;
+        }
+        const IAttributeVector &attr = *column.attribute;
+        Sum *values = &_batchValues[c * ColumnarGrouper::batch_size];
+        if (column.attributeIsFloat) {
+            attr.get_floats(docids, _batchFloats.data());
+            for (uint32_t i = 0; i < numDocs; ++i) {
+                values[i].floating = _batchFloats[i];
+            }
+        } else {
+            attr.get_ints(docids, _batchInts.data());
+            if (column.sumIsFloat) {
+                for (uint32_t i = 0; i < numDocs; ++i) {
+                    values[i].floating = static_cast<double>(_batchInts[i]);
+                }
+            } else {
+                for (uint32_t i = 0; i < numDocs; ++i) {
+                    values[i].integer = _batchInts[i];
+                }
+            }
+        }
+    }
+}
+
+void
+Aggregator::aggregateBatch(const uint32_t *docIds, const HitRank *ranks, uint32_t numDocs)
+{
+    assert(numDocs <= ColumnarGrouper::batch_size);
+    readBatch(docIds, numDocs);
+    size_t numColumns = _plan.columns.size();
+    for (uint32_t i = 0; i < numDocs; ++i) {
+        uint32_t group = lookup(_batchKeys[i], ranks[i]);
+        if ((group == no_group) || !_plan.collect) {
+            continue;
+        }
+        ++_counts[group];
+        Sum *sums = &_sums[group * numColumns];
+        for (size_t c = 0; c < numColumns; ++c) {
+            const Column &column = _plan.columns[c];
+            if (column.kind == Kind::COUNT) {
+                continue;
+            }
+            const Sum &value = _batchValues[c * ColumnarGrouper::batch_size + i];
+            if (column.sumIsFloat) {
+                sums[c].floating += value.floating;
+            } else {
+                sums[c].integer += value.integer;
+            }
+        }
+    }
+}
+
+void
+Aggregator::insertGroups(Group &root) const
+{
+    const GroupingLevel &level = *_plan.level;
+    std::unique_ptr<ResultNode> id(level.getExpression().getResult()->clone());
+    size_t numColumns = _plan.columns.size();
+    for (uint32_t group = 0; group < _keys.size(); ++group) {
+        id->set(Int64ResultNode(_keys[group]));
+        Group *child = root.groupSingle(*id, _ranks[group], level);
+        assert(child != nullptr);
+        if (!_plan.collect) {
+            continue;
+        }
+        for (size_t c = 0; c < numColumns; ++c) {
+            const Column &column = _plan.columns[c];
+            const Sum &sum = _sums[group * numColumns + c];
+            auto makeSum = [&]() -> NumericResultNode::UP {
+                if (column.sumIsFloat) {
+                    return std::make_unique<FloatResultNode>(sum.floating);
+                }
+                return std::make_unique<Int64ResultNode>(static_cast<int64_t>(sum.integer));
+            };
+            AggregationResult &result = child->getAggregationResult(c);
+            switch (column.kind) {
+            case Kind::COUNT:
+                result.merge(CountAggregationResult(_counts[group]));
+                break;
+            case Kind::SUM:
+                result.merge(SumAggregationResult(makeSum()));
+                break;
+            case Kind::AVERAGE:
+                result.merge(AverageAggregationResult(makeSum(), _counts[group]));
+                break;
+            }
+        }
+    }
+}
+
+}
+
+struct ColumnarGrouper::State {
+    Plan       plan;
+    Aggregator aggregator;
+    explicit State(Plan && plan_in)
+        : plan(std::move(plan_in)),
+          aggregator(plan)
+    { }
+};
+
+std::unique_ptr<ColumnarGrouper>
+ColumnarGrouper::create(Grouping &grouping)
+{
+    auto plan = makePlan(grouping);
+    if (!plan) {
+        return {};
+    }
+    return std::make_unique<ColumnarGrouper>(std::make_unique<State>(std::move(*plan)));
+}
+
+ColumnarGrouper::ColumnarGrouper(std::unique_ptr<State> state)
+    : _state(std::move(state)),
+      _docIds(batch_size),
+      _ranks(batch_size),
+      _numBuffered(0)
+{
+}
+
+ColumnarGrouper::~ColumnarGrouper() = default;
+
+void
+ColumnarGrouper::flush()
+{
+    _state->aggregator.aggregateBatch(_docIds.data(), _ranks.data(), _numBuffered);
+    _numBuffered = 0;
+}
+
+void
+ColumnarGrouper::finish(Group &root)
+{
+    flush();
+    _state->aggregator.insertGroups(root);
+}
+
+}
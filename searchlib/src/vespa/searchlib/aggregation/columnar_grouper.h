@@ -0,0 +1,61 @@
+// Copyright Vespa.ai. Licensed under the terms of the Apache 2.0 license. See LICENSE in the project root.
+#pragma once
+
+#include <vespa/searchlib/common/hitrank.h>
+#include <memory>
+#include <vector>
+
+namespace search::aggregation {
+
+class Group;
+class Grouping;
+
+/**
+ * Fast path for the common single level grouping request: grouping on a
+ * single value integer attribute, collecting count(), sum() and avg() of
+ * single value numeric attributes (or nothing at all).
+ *
+ * Instead of evaluating the expression trees per hit, hits are buffered and
+ * handled in batches. Group keys and values are read directly from the
+ * attribute vectors into flat arrays and aggregated into a flat hash table.
+ * The groups are inserted into the grouping tree by finish(), giving the
+ * same tree as the generic engine.
+ **/
+class ColumnarGrouper
+{
+public:
+    static constexpr uint32_t batch_size = 256;
+    struct State;
+
+    /**
+     * Returns a grouper for the given grouping (after preAggregate()), or
+     * nullptr if the generic engine must be used.
+     **/
+    static std::unique_ptr<ColumnarGrouper> create(Grouping &grouping);
+
+    explicit ColumnarGrouper(std::unique_ptr<State> state);
+    ~ColumnarGrouper();
+
+    void add(uint32_t docId, HitRank rank) {
+        _docIds[_numBuffered] = docId;
+        _ranks[_numBuffered] = rank;
+        if (++_numBuffered == batch_size) {
+            flush();
+        }
+    }
+
+    /**
+     * Aggregates buffered hits and inserts the groups into the root group.
+     **/
+    void finish(Group &root);
+
+private:
+    void flush();
+
+    std::unique_ptr<State> _state;
+    std::vector<uint32_t>  _docIds;
+    std::vector<HitRank>   _ranks;
+    uint32_t               _numBuffered;
+};
+
+}
@@ -1,7 +1,10 @@
 // Copyright Vespa.ai. Licensed under the terms of the Apache 2.0 license. See LICENSE in the project root.
 
 #include "grouping.h"
+#include "columnar_grouper.h"
+#include "countaggregationresult.h"
 #include "hitsaggregationresult.h"
+#include "sumaggregationresult.h"
 #include <vespa/searchlib/expression/stringresultnode.h>
 #include <vespa/searchlib/expression/enumresultnode.h>
 #include <vespa/searchlib/expression/resultvector.h>
@@ -12,6 +15,8 @@
 #include <vespa/vespalib/objects/serializer.hpp>
 #include <vespa/vespalib/objects/deserializer.hpp>
 #include <vespa/searchlib/common/idocumentmetastore.h>
+#include <algorithm>
+#include <cmath>
 
 #include <vespa/log/log.h>
 LOG_SETUP(".searchlib.aggregation.grouping");
@@ -116,6 +121,31 @@ struct ResolveCurrentIndex : vespalib::ObjectOperation, vespalib::ObjectPredicat
     }
 };
 
+class SampledResultScaler : public vespalib::ObjectOperation, public vespalib::ObjectPredicate
+{
+private:
+    double _factor;
+public:
+    explicit SampledResultScaler(double factor) : _factor(factor) { }
+    void execute(vespalib::Identifiable &obj) override {
+        if (obj.getClass().id() == CountAggregationResult::classId) {
+            auto & count = static_cast<CountAggregationResult &>(obj);
+            count.setCount(std::llround(count.getCount() * _factor));
+        } else {
+            ResultNode & sum = static_cast<SumAggregationResult &>(obj).getResult();
+            if (sum.inherits(IntegerResultNode::classId)) {
+                sum.set(Int64ResultNode(std::llround(sum.getInteger() * _factor)));
+            } else {
+                sum.set(FloatResultNode(sum.getFloat() * _factor));
+            }
+        }
+    }
+    bool check(const vespalib::Identifiable &obj) const override {
+        return (obj.getClass().id() == CountAggregationResult::classId) ||
+               (obj.getClass().id() == SumAggregationResult::classId);
+    }
+};
+
 } // namespace search::aggregation::<unnamed>
 
 IMPLEMENT_IDENTIFIABLE_NS2(search, aggregation, Grouping, vespalib::Identifiable);
@@ -128,11 +158,39 @@ Grouping::Grouping() noexcept
       _firstLevel(0),
       _lastLevel(0),
       _levels(),
-      _root()
+      _root(),
+      _columnar(),
+      _sampleRate(1.0),
+      _sampleThreshold(UINT64_C(1) << 32)
+{ }
+
+Grouping::Grouping(const Grouping & rhs)
+    : vespalib::Identifiable(rhs),
+      _id(rhs._id),
+      _valid(rhs._valid),
+      _all(rhs._all),
+      _topN(rhs._topN),
+      _firstLevel(rhs._firstLevel),
+      _lastLevel(rhs._lastLevel),
+      _levels(rhs._levels),
+      _root(rhs._root),
+      _columnar(),
+      _sampleRate(rhs._sampleRate),
+      _sampleThreshold(rhs._sampleThreshold)
 { }
 
-Grouping::Grouping(const Grouping &) = default;
-Grouping & Grouping::operator = (const Grouping &) = default;
+Grouping &
+Grouping::operator = (const Grouping & rhs)
+{
+    if (this != &rhs) {
+        Grouping tmp(rhs);
+        *this = std::move(tmp);
+    }
+    return *this;
+}
+
+Grouping::Grouping(Grouping &&) noexcept = default;
+Grouping & Grouping::operator = (Grouping &&) noexcept = default;
 Grouping::~Grouping() = default;
 
 void
@@ -145,6 +203,39 @@ Grouping::selectMembers(const vespalib::ObjectPredicate &predicate,
     selectGroups(predicate, operation, _root, _firstLevel, _lastLevel, 0);
 }
 
+Grouping &
+Grouping::setGroupLimit(uint64_t groupLimit)
+{
+    for (GroupingLevel & level : _levels) {
+        level.setGroupLimit(groupLimit);
+    }
+    return *this;
+}
+
+Grouping &
+Grouping::setSampleRate(double rate)
+{
+    _sampleRate = std::clamp(rate, 0.0, 1.0);
+    _sampleThreshold = static_cast<uint64_t>(std::ldexp(_sampleRate, 32));
+    if (_sampleRate < 1.0) {
+        for (GroupingLevel & level : _levels) {
+            if (level.getPrecision() > 0) {
+                level.setPresicion(std::ceil(level.getPrecision() / std::sqrt(_sampleRate)));
+            }
+        }
+    }
+    return *this;
+}
+
+double
+Grouping::countErrorBound(double estimatedCount, double sampleRate)
+{
+    if (sampleRate <= 0.0 || sampleRate >= 1.0) {
+        return 0.0;
+    }
+    return 1.96 * std::sqrt(estimatedCount * (1.0 - sampleRate) / sampleRate);
+}
+
 void
 Grouping::prune(const Grouping & b)
 {
@@ -177,6 +268,7 @@ Grouping::preAggregate(bool isOrdered)
         _levels[i].prepare(this, i, isOrdered);
     }
     _root.preAggregate();
+    _columnar = ColumnarGrouper::create(*this);
 }
 
 void
@@ -195,6 +287,10 @@ void
 Grouping::postProcess()
 {
     postAggregate();
+    if (_sampleRate < 1.0) {
+        SampledResultScaler scaler(1.0 / _sampleRate);
+        selectGroups(scaler, scaler, _root, _firstLevel, _lastLevel, 0);
+    }
     postMerge();
     bool hasEnums(false);
     for (size_t i(0), m(_levels.size()); !hasEnums && (i < m); i++) {
@@ -232,7 +328,14 @@ Grouping::aggregate(const RankedHit * rankedHit, unsigned int len)
 void
 Grouping::aggregate(DocId docId, HitRank rank)
 {
-    _root.aggregate(*this, 0, docId, rank);
+    if (!isSampled(docId)) {
+        return;
+    }
+    if (_columnar) {
+        _columnar->add(docId, rank);
+    } else {
+        _root.aggregate(*this, 0, docId, rank);
+    }
 }
 
 void
@@ -251,6 +354,10 @@ Grouping::convertToGlobalId(const search::IDocumentMetaStore &metaStore)
 void
 Grouping::postAggregate()
 {
+    if (_columnar) {
+        _columnar->finish(_root);
+        _columnar.reset();
+    }
     _root.postAggregate();
 }
 
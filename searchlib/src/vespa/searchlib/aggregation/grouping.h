@@ -11,6 +11,8 @@ namespace search {
 
 namespace search::aggregation {
 
+class ColumnarGrouper;
+
 /**
  * This class represents a top-level grouping request.
  **/
@@ -29,6 +31,9 @@ private:
     uint32_t                 _lastLevel;  // last processing level this iteration
     GroupingLevelList        _levels;     // grouping parameters per level
     Group                    _root;       // the grouping tree
+    std::unique_ptr<ColumnarGrouper> _columnar; // fast path used between preAggregate and postAggregate, if supported
+    double                   _sampleRate;      // fraction of hits aggregated (local, not serialized)
+    uint64_t                 _sampleThreshold; // docid hash limit for sampled hits
 public:
     DECLARE_IDENTIFIABLE_NS2(search, aggregation, Grouping);
     DECLARE_NBO_SERIALIZE;
@@ -36,8 +41,8 @@ public:
     Grouping() noexcept;
     Grouping(const Grouping &);
     Grouping & operator = (const Grouping &);
-    Grouping(Grouping &&) noexcept = default;
-    Grouping & operator = (Grouping &&) noexcept = default;
+    Grouping(Grouping &&) noexcept;
+    Grouping & operator = (Grouping &&) noexcept;
     ~Grouping() override;
 
     Grouping unchain() const { return *this; }
@@ -50,6 +55,26 @@ public:
     Grouping &setLastLevel(unsigned int level)  { _lastLevel = level;       return *this; }
     Grouping &addLevel(GroupingLevel && level)  { _levels.push_back(std::move(level)); return *this; }
     Grouping &setRoot(const Group &root_)       { _root = root_;            return *this; }
+    Grouping &setGroupLimit(uint64_t groupLimit);
+    /**
+     * Only aggregate a deterministic sample of the hits, selected by
+     * hashing the docid, and scale counts and sums back up by the
+     * inverse rate. The precision of ordered levels is raised by
+     * 1/sqrt(rate) since sampling noise can reorder groups near the
+     * cut-off. Must be called once, before aggregation.
+     *
+     * @param rate fraction of hits to aggregate, in (0, 1]
+     **/
+    Grouping &setSampleRate(double rate);
+    double getSampleRate() const noexcept { return _sampleRate; }
+    bool isSampled(DocId docId) const noexcept {
+        return (static_cast<uint32_t>(docId * 2654435761u) < _sampleThreshold);
+    }
+    /**
+     * Half-width of the 95% confidence interval of a count estimated
+     * from hits sampled at the given rate.
+     **/
+    static double countErrorBound(double estimatedCount, double sampleRate);
 
     unsigned int getId()     const noexcept { return _id; }
     bool valid()             const noexcept { return _valid; }
@@ -4,6 +4,7 @@
 #include "grouping.h"
 #include <vespa/searchlib/expression/resultvector.h>
 #include <vespa/searchlib/expression/current_index_setup.h>
+#include <limits>
 
 namespace search::aggregation {
 
@@ -16,6 +17,7 @@ IMPLEMENT_IDENTIFIABLE_NS2(search, aggregation, GroupingLevel, vespalib::Identif
 GroupingLevel::GroupingLevel() noexcept
     : _maxGroups(-1),
       _precision(-1),
+      _groupLimit(std::numeric_limits<uint64_t>::max()),
       _isOrdered(false),
       _frozen(false),
       _currentIndex(),
@@ -77,6 +77,7 @@ private:
     };
     int64_t        _maxGroups;
     int64_t        _precision;
+    uint64_t       _groupLimit;
     bool           _isOrdered;
     bool           _frozen;
     CurrentIndex   _currentIndex;
@@ -105,6 +106,12 @@ public:
     }
     GroupingLevel & freeze() { _frozen = true; return *this; }
     GroupingLevel &setPresicion(int64_t precision) { _precision = precision; return *this; }
+    /**
+     * Cap the number of groups created at this level when aggregating,
+     * independent of ordering. Not serialized; used to bound the memory
+     * used by each match thread's partial grouping tree.
+     **/
+    GroupingLevel &setGroupLimit(uint64_t groupLimit) { _groupLimit = groupLimit; return *this; }
     GroupingLevel &setExpression(ExpressionNode::UP root) { _classify = std::move(root); return *this; }
     GroupingLevel &addResult(ExpressionNode::UP result) { _collect.addResult(std::move(result)); return *this; }
     GroupingLevel &addResult(const ExpressionNode & result) { return addResult(ExpressionNode::UP(result.clone())); }
@@ -114,8 +121,11 @@ public:
 
     int64_t getMaxGroups() const noexcept { return _maxGroups; }
     int64_t getPrecision() const noexcept { return _precision; }
+    uint64_t getGroupLimit() const noexcept { return _groupLimit; }
     bool        isFrozen() const noexcept { return _frozen; }
-    bool    allowMoreGroups(size_t sz) const noexcept { return (!_frozen && (!_isOrdered || (sz < (uint64_t)_precision))); }
+    bool    allowMoreGroups(size_t sz) const noexcept {
+        return (!_frozen && (sz < _groupLimit) && (!_isOrdered || (sz < (uint64_t)_precision)));
+    }
     const ExpressionTree & getExpression() const { return _classify; }
     ExpressionTree & getExpression() { return _classify; }
     const       Group &getGroupPrototype() const { return _collect; }
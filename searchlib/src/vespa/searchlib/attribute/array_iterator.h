@@ -26,10 +26,39 @@ public:
 
     bool valid() const { return _cur != _end; }
 
+    /**
+     * Seek to the first entry with key >= docId. The next few entries are
+     * checked linearly, since short skips are the common case. Longer
+     * skips, as seen when a sparse term drives a strict AND over a long
+     * posting array, continue with a galloping search.
+     */
     void linearSeek(uint32_t docId) {
-        while (_cur != _end && _cur->_key < docId) {
-            ++_cur;
+        for (uint32_t i = 0; i < linear_seek_limit; ++i, ++_cur) {
+            if (_cur == _end || _cur->_key >= docId) {
+                return;
+            }
         }
+        gallopSeek(docId);
+    }
+
+    /**
+     * Seek to the first entry with key >= docId by probing at
+     * exponentially increasing distances, then doing a binary search
+     * within the last interval.
+     */
+    void gallopSeek(uint32_t docId) {
+        const P *lo = _cur;
+        const P *hi = _end;
+        for (size_t step = 1; size_t(_end - lo) > step; step *= 2) {
+            if (lo[step]._key >= docId) {
+                hi = lo + step;
+                break;
+            }
+            lo += step + 1;
+        }
+        P keyWrap;
+        keyWrap._key = docId;
+        _cur = std::lower_bound<const P *, P>(lo, hi, keyWrap);
     }
 
     uint32_t getKey() const { return _cur->_key; }
@@ -53,6 +82,8 @@ public:
         std::swap(_begin, rhs._begin);
     }
 protected:
+    static constexpr uint32_t linear_seek_limit = 8;
+
     const P *_cur;
     const P *_end;
     const P *_begin;
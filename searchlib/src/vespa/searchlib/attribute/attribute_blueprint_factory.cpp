@@ -25,6 +25,7 @@
 #include <vespa/searchlib/queryeval/emptysearch.h>
 #include <vespa/searchlib/queryeval/field_spec.hpp>
 #include <vespa/searchlib/queryeval/filter_wrapper.h>
+#include <vespa/searchlib/queryeval/flow_cost_table.h>
 #include <vespa/searchlib/queryeval/get_weight_from_node.h>
 #include <vespa/searchlib/queryeval/intermediate_blueprints.h>
 #include <vespa/searchlib/queryeval/leaf_blueprints.h>
@@ -80,6 +81,7 @@ using search::queryeval::FieldSpec;
 using search::queryeval::FieldSpecBase;
 using search::queryeval::FieldSpecBaseList;
 using search::queryeval::FilterWrapper;
+using search::queryeval::FlowCostTable;
 using search::queryeval::IRequestContext;
 using search::queryeval::NoUnpack;
 using search::queryeval::OrLikeSearch;
@@ -129,9 +131,18 @@ private:
     // as only a few ISearchContext implementations exposes the query term.
     vespalib::string _query_term;
     ISearchContext::UP _search_context;
+    const vespalib::Doom *_soft_doom;
     enum Type {INT, FLOAT, OTHER};
     Type _type;
 
+    SearchIteratorUP create_iterator(fef::TermFieldMatchData *tfmd, bool strict) const {
+        auto search = _search_context->createIterator(tfmd, strict);
+        if (_soft_doom != nullptr) {
+            search->set_soft_doom(*_soft_doom);
+        }
+        return search;
+    }
+
 public:
     AttributeFieldBlueprint(FieldSpecBase field, const IAttributeVector &attribute,
                             const string &query_stack, const SearchContextParams &params);
@@ -139,15 +150,18 @@ public:
                             QueryTermSimple::UP term, const SearchContextParams &params);
     ~AttributeFieldBlueprint() override;
 
+    // let scanning iterators give up when soft doomed
+    void set_soft_doom(const vespalib::Doom &doom) { _soft_doom = &doom; }
+
     SearchIteratorUP createLeafSearch(const TermFieldMatchDataArray &tfmda, bool strict) const override {
         assert(tfmda.size() == 1);
-        return _search_context->createIterator(tfmda[0], strict);
+        return create_iterator(tfmda[0], strict);
     }
 
     SearchIterator::UP createSearch(fef::MatchData &md, bool strict) const override {
         const State &state = getState();
         assert(state.numFields() == 1);
-        return _search_context->createIterator(state.field(0).resolve(md), strict);
+        return create_iterator(state.field(0).resolve(md), strict);
     }
 
     SearchIteratorUP createFilterSearch(bool strict, FilterConstraint constraint) const override {
@@ -167,6 +181,10 @@ public:
         return _search_context.get();
     }
     bool getRange(vespalib::string &from, vespalib::string &to) const override;
+
+    const char *flow_cost_key() const noexcept override {
+        return _attr.getIsFastSearch() ? FlowCostTable::attribute_fast_search_term_key : FlowCostTable::attribute_term_key;
+    }
 };
 
 AttributeFieldBlueprint::~AttributeFieldBlueprint() = default;
@@ -182,6 +200,7 @@ AttributeFieldBlueprint::AttributeFieldBlueprint(FieldSpecBase field, const IAtt
       _attr(attribute),
       _query_term(term->getTermString()),
       _search_context(attribute.createSearchContext(std::move(term), params)),
+      _soft_doom(nullptr),
       _type(OTHER)
 {
     uint32_t estHits = _search_context->approximateHits();
@@ -532,7 +551,9 @@ public:
         SearchContextParams scParams = createContextParams(_field.isFilter());
         scParams.fuzzy_matching_algorithm(getRequestContext().get_attribute_blueprint_params().fuzzy_matching_algorithm);
         const string stack = StackDumpCreator::create(n);
-        setResult(std::make_unique<AttributeFieldBlueprint>(_field, _attr, stack, scParams));
+        auto bp = std::make_unique<AttributeFieldBlueprint>(_field, _attr, stack, scParams);
+        bp->set_soft_doom(getRequestContext().getDoom());
+        setResult(std::move(bp));
     }
 
     void visitLocation(LocationTerm &node) {
@@ -686,6 +707,7 @@ public:
                                                                             params.global_filter_lower_limit,
                                                                             params.global_filter_upper_limit,
                                                                             params.target_hits_max_adjustment_factor,
+                                                                            params.filter_first_threshold,
                                                                             getRequestContext().getDoom()));
         } catch (const vespalib::IllegalArgumentException& ex) {
             return fail_nearest_neighbor_term(n, ex.getMessage());
@@ -15,15 +15,18 @@ struct AttributeBlueprintParams
     double global_filter_lower_limit;
     double global_filter_upper_limit;
     double target_hits_max_adjustment_factor;
+    double filter_first_threshold;
     vespalib::FuzzyMatchingAlgorithm fuzzy_matching_algorithm;
 
     AttributeBlueprintParams(double global_filter_lower_limit_in,
                              double global_filter_upper_limit_in,
                              double target_hits_max_adjustment_factor_in,
+                             double filter_first_threshold_in,
                              vespalib::FuzzyMatchingAlgorithm fuzzy_matching_algorithm_in)
         : global_filter_lower_limit(global_filter_lower_limit_in),
           global_filter_upper_limit(global_filter_upper_limit_in),
           target_hits_max_adjustment_factor(target_hits_max_adjustment_factor_in),
+          filter_first_threshold(filter_first_threshold_in),
           fuzzy_matching_algorithm(fuzzy_matching_algorithm_in)
     {
     }
@@ -32,6 +35,7 @@ struct AttributeBlueprintParams
         : AttributeBlueprintParams(fef::indexproperties::matching::GlobalFilterLowerLimit::DEFAULT_VALUE,
                                    fef::indexproperties::matching::GlobalFilterUpperLimit::DEFAULT_VALUE,
                                    fef::indexproperties::matching::TargetHitsMaxAdjustmentFactor::DEFAULT_VALUE,
+                                   fef::indexproperties::matching::FilterFirstThreshold::DEFAULT_VALUE,
                                    fef::indexproperties::matching::FuzzyAlgorithm::DEFAULT_VALUE)
     {
     }
@@ -9,6 +9,7 @@
 #include <vespa/searchlib/util/file_settings.h>
 #include <vespa/vespalib/data/databuffer.h>
 #include <vespa/vespalib/data/fileheader.h>
+#include <vespa/vespalib/util/io_scheduler.h>
 #include <vespa/vespalib/util/size_literals.h>
 
 #include <vespa/log/log.h>
@@ -26,6 +27,7 @@ writeDirectIOAligned(FastOS_FileInterface &file, const void *buf, size_t length)
 {
     const char * data(static_cast<const char *>(buf));
     size_t remaining(length);
+    vespalib::IoScheduler::throttle(length);
     for (size_t maxChunk(2_Mi); maxChunk >= FileSettings::DIRECTIO_ALIGNMENT; maxChunk >>= 1) {
         for ( ; remaining > maxChunk; remaining -= maxChunk, data += maxChunk) {
             file.WriteBuf(data, maxChunk);
@@ -32,14 +32,17 @@ protected:
     const attribute::ISearchContext & _baseSearchCtx;
     fef::TermFieldMatchData         * _matchData;
     fef::TermFieldMatchDataPosition * _matchPosition;
+    const vespalib::Doom            * _soft_doom; // only used when scanning strictly
 
 public:
     AttributeIteratorBase(const attribute::ISearchContext &baseSearchCtx, fef::TermFieldMatchData *matchData)
         : _baseSearchCtx(baseSearchCtx),
           _matchData(matchData),
-          _matchPosition(_matchData->populate_fixed())
+          _matchPosition(_matchData->populate_fixed()),
+          _soft_doom(nullptr)
     { }
     Trinary is_strict() const override { return Trinary::False; }
+    void set_soft_doom(const vespalib::Doom &doom) override { _soft_doom = &doom; }
 };
 
 
@@ -138,6 +141,7 @@ private:
     using AttributeIteratorT<SC>::setAtEnd;
     using AttributeIteratorT<SC>::isAtEnd;
     using AttributeIteratorT<SC>::_weight;
+    using AttributeIteratorT<SC>::_soft_doom;
     using Trinary=vespalib::Trinary;
     void doSeek(uint32_t docId) override;
     Trinary is_strict() const override { return Trinary::True; }
@@ -156,6 +160,7 @@ private:
     using FilterAttributeIteratorT<SC>::setDocId;
     using FilterAttributeIteratorT<SC>::setAtEnd;
     using FilterAttributeIteratorT<SC>::isAtEnd;
+    using FilterAttributeIteratorT<SC>::_soft_doom;
     using Trinary=vespalib::Trinary;
     void doSeek(uint32_t docId) override;
     Trinary is_strict() const override { return Trinary::True; }
@@ -434,6 +434,9 @@ AttributeIteratorStrict<SC>::doSeek(uint32_t docId)
             setDocId(nextId);
             return;
         }
+        if (this->soft_doomed(_soft_doom, nextId)) {
+            break;
+        }
     }
     setAtEnd();
 }
@@ -447,6 +450,9 @@ FilterAttributeIteratorStrict<SC>::doSeek(uint32_t docId)
             setDocId(nextId);
             return;
         }
+        if (this->soft_doomed(_soft_doom, nextId)) {
+            break;
+        }
     }
     setAtEnd();
 }
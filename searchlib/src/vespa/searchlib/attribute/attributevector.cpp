@@ -5,6 +5,7 @@
 #include "attribute_read_guard.h"
 #include "attributefilesavetarget.h"
 #include "attributesaver.h"
+#include "bitvector_filter_cache.h"
 #include "floatbase.h"
 #include "interlock.h"
 #include "ipostinglistattributebase.h"
@@ -22,6 +23,7 @@
 #include <vespa/searchlib/util/file_settings.h>
 #include <vespa/vespalib/util/jsonwriter.h>
 #include <vespa/vespalib/util/exceptions.h>
+#include <vespa/vespalib/util/memory_placement_allocator.h>
 #include <vespa/vespalib/util/mmap_file_allocator_factory.h>
 #include <vespa/vespalib/util/size_literals.h>
 #include <thread>
@@ -73,6 +75,9 @@ make_memory_allocator(const vespalib::string& name, const search::attribute::Con
     if (allow_paged(config)) {
         return vespalib::alloc::MmapFileAllocatorFactory::instance().make_memory_allocator(name);
     }
+    if (!config.memory_placement().is_default()) {
+        return std::make_unique<vespalib::alloc::MemoryPlacementAllocator>(config.memory_placement());
+    }
     return {};
 }
 
@@ -101,7 +106,8 @@ AttributeVector::AttributeVector(vespalib::stringref baseFileName, const Config
       _loaded(false),
       _isUpdateableInMemoryOnly(attribute::isUpdateableInMemoryOnly(getName(), getConfig())),
       _nextStatUpdateTime(),
-      _memory_allocator(make_memory_allocator(_baseFileName.getAttributeName(), c))
+      _memory_allocator(make_memory_allocator(_baseFileName.getAttributeName(), c)),
+      _filter_cache(std::make_unique<attribute::BitVectorFilterCache>(c.filter_cache_max_bytes()))
 {
 }
 
@@ -403,6 +409,8 @@ AttributeVector::apply(DocId doc, const MapValueUpdate &map) {
 }
 
 
+bool AttributeVector::apply_direct(DocId, const ValueUpdate &) { return false; }
+
 bool AttributeVector::applyWeight(DocId, const FieldValue &, const ArithmeticValueUpdate &) { return false; }
 
 bool AttributeVector::applyWeight(DocId, const FieldValue&, const AssignValueUpdate&) { return false; }
@@ -549,6 +557,19 @@ AttributeVector::onInitSave(vespalib::stringref)
     return std::unique_ptr<AttributeSaver>();
 }
 
+std::unique_ptr<AttributeSaver>
+AttributeVector::init_delta_save(vespalib::stringref fileName, size_t max_size)
+{
+    commit();
+    return on_init_delta_save(fileName, max_size);
+}
+
+std::unique_ptr<AttributeSaver>
+AttributeVector::on_init_delta_save(vespalib::stringref, size_t)
+{
+    return std::unique_ptr<AttributeSaver>();
+}
+
 bool
 AttributeVector::hasActiveEnumGuards()
 {
@@ -716,6 +737,8 @@ AttributeVector::update_config(const Config& cfg)
 {
     commit(true);
     _config->setGrowStrategy(cfg.getGrowStrategy());
+    _config->set_filter_cache_max_bytes(cfg.filter_cache_max_bytes());
+    _filter_cache->set_max_bytes(cfg.filter_cache_max_bytes());
     if (cfg.getCompactionStrategy() == _config->getCompactionStrategy()) {
         return;
     }
@@ -726,6 +749,12 @@ AttributeVector::update_config(const Config& cfg)
     drain_hold(1_Mi); // Wait until 1MiB or less on hold
 }
 
+attribute::BitVectorFilterCache *
+AttributeVector::get_filter_cache() const noexcept
+{
+    return _filter_cache->enabled() ? _filter_cache.get() : nullptr;
+}
+
 vespalib::alloc::Alloc
 AttributeVector::get_initial_alloc()
 {
@@ -26,6 +26,7 @@ namespace document {
     class AssignValueUpdate;
     class MapValueUpdate;
     class FieldValue;
+    class ValueUpdate;
 }
 
 namespace vespalib {
@@ -57,9 +58,11 @@ namespace search {
 
     namespace attribute {
         class AttributeHeader;
+        class BitVectorFilterCache;
         class IPostingListSearchContext;
         class IPostingListAttributeBase;
         class Interlock;
+        class RangeBucketIndex;
         class InterlockGuard;
         class SearchContext;
         class MultiValueMappingBase;
@@ -140,6 +143,7 @@ public:
     EnumModifier getEnumModifier();
 protected:
     ValueModifier getValueModifier();
+    void divideByZeroWarning();
 
     void updateCommittedDocIdLimit() {
         if (_uncommittedDocIdLimit != 0) {
@@ -283,6 +287,10 @@ public:
 
     const Config &getConfig() const noexcept { return *_config; }
     void update_config(const Config& cfg);
+    // Cache of merged posting lists for frequent filter terms, nullptr if disabled.
+    attribute::BitVectorFilterCache *get_filter_cache() const noexcept;
+    // Value bucket bit vectors for range terms, nullptr if not maintained by this attribute.
+    virtual const attribute::RangeBucketIndex *get_range_bucket_index() const noexcept { return nullptr; }
     const attribute::BaseName & getBaseFileName() const { return _baseFileName; }
     void setBaseFileName(vespalib::stringref name) { _baseFileName = name; }
     bool isUpdateableInMemoryOnly() const { return _isUpdateableInMemoryOnly; }
@@ -382,6 +390,19 @@ public:
     virtual bool addDocs(uint32_t numDocs);
     bool apply(DocId doc, const MapValueUpdate &map);
 
+    /**
+     * Applies an assign, arithmetic or clear value update directly to the
+     * stored value of the given document, bypassing the change vector. The
+     * value is visible to readers at once. Writers handling disjoint sets of
+     * documents may call this concurrently, but not concurrently with any
+     * other write, commit or lid space change to this attribute.
+     *
+     * Returns false if the update was not applied, i.e. the attribute or the
+     * kind of update is not supported or the document is outside the lid space.
+     */
+    virtual bool supports_direct_updates() const noexcept { return false; }
+    virtual bool apply_direct(DocId doc, const document::ValueUpdate &update);
+
 ////// Search API
 
     const IDocidPostingStore* as_docid_posting_store() const override;
@@ -405,7 +426,6 @@ private:
      * @param docIdLimit
      */
     virtual void onAddDocs(DocId docIdLimit) = 0;
-    void divideByZeroWarning();
     virtual bool applyWeight(DocId doc, const FieldValue &fv, const ArithmeticValueUpdate &wAdjust);
     virtual bool applyWeight(DocId doc, const FieldValue& fv, const document::AssignValueUpdate& wAdjust);
     virtual void onSave(IAttributeSaveTarget & saveTarget);
@@ -430,6 +450,7 @@ private:
     bool                                  _isUpdateableInMemoryOnly;
     vespalib::steady_time                 _nextStatUpdateTime;
     std::shared_ptr<vespalib::alloc::MemoryAllocator> _memory_allocator;
+    std::unique_ptr<attribute::BitVectorFilterCache> _filter_cache;
 
     /// Clean up [0, firstUsed>
     virtual void reclaim_memory(generation_t oldest_used_gen);
@@ -489,6 +510,20 @@ public:
     std::unique_ptr<AttributeSaver> initSave(vespalib::stringref fileName);
 
     virtual std::unique_ptr<AttributeSaver> onInitSave(vespalib::stringref fileName);
+
+    /**
+     * Initializes a save of only the values changed since the previous save
+     * (or load), to be applied on top of the files from that save when loading.
+     * Returns nullptr if not supported, or if the delta would be larger than
+     * max_size bytes, in which case the changes are still tracked.
+     */
+    std::unique_ptr<AttributeSaver> init_delta_save(vespalib::stringref fileName, size_t max_size);
+    virtual std::unique_ptr<AttributeSaver> on_init_delta_save(vespalib::stringref fileName, size_t max_size);
+    /**
+     * Returns the serial number of the save (or load) that changes are tracked
+     * relative to for delta saves, 0 if changes are not tracked.
+     */
+    virtual uint64_t get_delta_save_base_serial_num() const noexcept { return 0; }
     virtual uint64_t getEstimatedSaveByteSize() const;
 
     static bool isEnumerated(const vespalib::GenericHeader &header);
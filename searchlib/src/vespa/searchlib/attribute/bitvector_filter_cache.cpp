@@ -0,0 +1,207 @@
+// Copyright Vespa.ai. Licensed under the terms of the Apache 2.0 license. See LICENSE in the project root.
+
+#include "bitvector_filter_cache.h"
+#include <vespa/searchlib/common/bitvector.h>
+#include <vespa/searchlib/common/compressedbitvector.h>
+#include <vespa/vespalib/stllike/hash_map.hpp>
+#include <vespa/vespalib/stllike/lrucache_map.hpp>
+
+namespace search::attribute {
+
+BitVectorFilterCache::Cache::Cache()
+    : LruMap(UNLIMITED),
+      _max_bytes(0),
+      _memory_used(0),
+      _compressed_elements(0)
+{
+}
+
+BitVectorFilterCache::Cache::~Cache() = default;
+
+bool
+BitVectorFilterCache::Cache::removeOldest(const value_type &v)
+{
+    if (_memory_used <= _max_bytes) {
+        return false;
+    }
+    _memory_used -= v.second._value.bytes;
+    if (v.second._value.filter.compressed) {
+        --_compressed_elements;
+    }
+    return true;
+}
+
+void
+BitVectorFilterCache::Cache::add(const vespalib::string &term, Entry entry)
+{
+    // Evicts least recently used entries until the new entry fits.
+    _memory_used += entry.bytes;
+    if (entry.filter.compressed) {
+        ++_compressed_elements;
+    }
+    insert(term, std::move(entry));
+}
+
+void
+BitVectorFilterCache::Cache::remove(const vespalib::string &term)
+{
+    const Entry &entry = get(term);
+    _memory_used -= entry.bytes;
+    if (entry.filter.compressed) {
+        --_compressed_elements;
+    }
+    erase(term);
+}
+
+void
+BitVectorFilterCache::Cache::clear()
+{
+    while (!empty()) {
+        erase(begin());
+    }
+    _memory_used = 0;
+    _compressed_elements = 0;
+}
+
+BitVectorFilterCache::BitVectorFilterCache(size_t max_bytes)
+    : _lock(),
+      _max_bytes(max_bytes),
+      _cache(),
+      _seen(),
+      _generation(0),
+      _stats()
+{
+    _cache.set_max_bytes(max_bytes);
+}
+
+BitVectorFilterCache::~BitVectorFilterCache() = default;
+
+void
+BitVectorFilterCache::set_max_bytes(size_t max_bytes)
+{
+    std::lock_guard guard(_lock);
+    _max_bytes.store(max_bytes, std::memory_order_relaxed);
+    _cache.set_max_bytes(max_bytes);
+    if (max_bytes == 0) {
+        drop_entries();
+        _seen.clear();
+    } else if (_cache.memory_used() > max_bytes) {
+        drop_entries();
+    }
+}
+
+BitVectorFilterCache::CachedFilter
+BitVectorFilterCache::find(const vespalib::string &term, generation_t generation, uint32_t docid_limit)
+{
+    std::lock_guard guard(_lock);
+    if (!_cache.hasKey(term)) {
+        return {};
+    }
+    // operator[] moves the entry to the head of the LRU list, findAndRef() only
+    // does that when the number of elements is limited.
+    const Entry &entry = _cache[term];
+    if ((entry.generation == generation) && (entry.docid_limit == docid_limit)) {
+        ++_stats.hits;
+        return entry.filter;
+    }
+    return {};
+}
+
+bool
+BitVectorFilterCache::admit(const vespalib::string &term, uint32_t docid_limit, size_t cost)
+{
+    auto itr = _seen.find(term);
+    if (itr == _seen.end()) {
+        if (_seen.size() >= MAX_TRACKED_TERMS) {
+            _seen.clear();
+        }
+        itr = _seen.insert(std::make_pair(term, Seen{0, 0})).first;
+    }
+    Seen &seen = itr->second;
+    ++seen.count;
+    seen.cost += cost;
+    if ((seen.count < MIN_SEEN) || (seen.cost < docid_limit)) {
+        return false;
+    }
+    _seen.erase(term);
+    return true;
+}
+
+void
+BitVectorFilterCache::drop_entries()
+{
+    _stats.invalidations += _cache.size();
+    _cache.clear();
+}
+
+BitVectorFilterCache::CachedFilter
+BitVectorFilterCache::make_filter(BitVectorSP bit_vector, size_t &bytes)
+{
+    size_t bv_bytes = BitVector::numBytes(bit_vector->size());
+    // Array containers use 16 bits per hit, so only sparse bit vectors can shrink
+    if (size_t(bit_vector->countTrueBits()) * 32 < bit_vector->size()) {
+        auto compressed = std::make_shared<const CompressedBitVector>(CompressedBitVector::create(*bit_vector));
+        size_t compressed_bytes = compressed->getMemoryUsage().allocatedBytes();
+        if (compressed_bytes * 2 < bv_bytes) {
+            bytes = compressed_bytes;
+            return {{}, std::move(compressed)};
+        }
+    }
+    bytes = bv_bytes;
+    return {std::move(bit_vector), {}};
+}
+
+bool
+BitVectorFilterCache::insert(const vespalib::string &term, generation_t generation, uint32_t docid_limit,
+                             size_t cost, BitVectorSP bit_vector)
+{
+    size_t max_bytes = _max_bytes.load(std::memory_order_relaxed);
+    size_t max_entry_bytes = BitVector::numBytes(bit_vector->size()) + term.size() + sizeof(Entry);
+    {
+        std::lock_guard guard(_lock);
+        ++_stats.misses;
+        if ((generation < _generation) || (max_entry_bytes > max_bytes) || !admit(term, docid_limit, cost)) {
+            return false;
+        }
+    }
+    // Compress outside the lock, the bit vector is not modified after being offered
+    size_t bytes = 0;
+    CachedFilter filter = make_filter(std::move(bit_vector), bytes);
+    bytes += term.size() + sizeof(Entry);
+    std::lock_guard guard(_lock);
+    if (generation < _generation) {
+        return false;
+    }
+    if (generation > _generation) {
+        drop_entries();
+        _generation = generation;
+    }
+    if (_cache.hasKey(term)) {
+        // Computed by another query at the same time, or for another docid limit.
+        _cache.remove(term);
+    }
+    _cache.add(term, Entry{std::move(filter), generation, docid_limit, bytes});
+    ++_stats.inserts;
+    return true;
+}
+
+BitVectorFilterCache::Stats
+BitVectorFilterCache::get_stats() const
+{
+    std::lock_guard guard(_lock);
+    Stats stats = _stats;
+    stats.elements = _cache.size();
+    stats.compressed_elements = _cache.compressed_elements();
+    stats.memory_used = _cache.memory_used();
+    return stats;
+}
+
+void
+BitVectorFilterCache::clear()
+{
+    std::lock_guard guard(_lock);
+    drop_entries();
+    _seen.clear();
+}
+
+}
@@ -0,0 +1,138 @@
+// Copyright Vespa.ai. Licensed under the terms of the Apache 2.0 license. See LICENSE in the project root.
+
+#pragma once
+
+#include <vespa/vespalib/stllike/hash_map.h>
+#include <vespa/vespalib/stllike/lrucache_map.h>
+#include <vespa/vespalib/stllike/string.h>
+#include <vespa/vespalib/util/generationhandler.h>
+#include <atomic>
+#include <memory>
+#include <mutex>
+
+namespace search {
+class BitVector;
+class CompressedBitVector;
+}
+namespace search::attribute {
+
+/**
+ * Class that caches the merged posting lists (as bit vectors) of frequently
+ * repeated filter terms (numeric ranges, prefixes, etc.) on a fast-search
+ * attribute, to avoid merging the same posting lists for each query.
+ *
+ * Each entry is tagged with the attribute generation and committed docid limit
+ * it was computed for, and is only used by search contexts created at the
+ * same generation. A term is admitted when it has been seen MIN_SEEN times,
+ * and the posting list entries merged for it so far add up to at least one
+ * per document (the number of bits in the cached bit vector). All entries are
+ * dropped when a bit vector for a newer generation is inserted, and the least
+ * recently used ones are evicted to stay within max bytes. Lowering max bytes
+ * below the memory used drops all entries.
+ *
+ * Sparse results (typically terms matching a few percent of the documents) are
+ * stored as a CompressedBitVector when that uses less than half the memory of
+ * the bit vector, letting the cache hold many more of them.
+ */
+class BitVectorFilterCache {
+public:
+    using BitVectorSP = std::shared_ptr<BitVector>;
+    using CompressedBitVectorSP = std::shared_ptr<const CompressedBitVector>;
+    using generation_t = vespalib::GenerationHandler::generation_t;
+    static constexpr uint32_t MIN_SEEN = 2;
+    static constexpr size_t MAX_TRACKED_TERMS = 4096;
+
+    struct Stats {
+        size_t hits;
+        size_t misses;
+        size_t inserts;
+        size_t invalidations;
+        size_t elements;
+        size_t compressed_elements;
+        size_t memory_used;
+        Stats() noexcept
+            : hits(0), misses(0), inserts(0), invalidations(0), elements(0), compressed_elements(0), memory_used(0)
+        {}
+    };
+
+    /**
+     * A cached result, either as a bit vector or as a compressed bit vector.
+     */
+    struct CachedFilter {
+        BitVectorSP           bit_vector;
+        CompressedBitVectorSP compressed;
+        explicit operator bool() const noexcept { return bit_vector || compressed; }
+    };
+
+private:
+    struct Entry {
+        CachedFilter filter;
+        generation_t generation;
+        uint32_t     docid_limit;
+        size_t       bytes;
+    };
+    struct Seen {
+        uint32_t count;
+        size_t   cost;
+    };
+    using LruMap = vespalib::lrucache_map<vespalib::LruParam<vespalib::string, Entry>>;
+    /**
+     * LRU map evicting the least recently used entries on insert
+     * until the memory used is within max bytes.
+     */
+    class Cache : public LruMap {
+        size_t _max_bytes;
+        size_t _memory_used;
+        size_t _compressed_elements;
+    public:
+        Cache();
+        ~Cache() override;
+        bool removeOldest(const value_type &v) override;
+        void clear();
+        void add(const vespalib::string &term, Entry entry);
+        void remove(const vespalib::string &term);
+        void set_max_bytes(size_t max_bytes) noexcept { _max_bytes = max_bytes; }
+        size_t memory_used() const noexcept { return _memory_used; }
+        size_t compressed_elements() const noexcept { return _compressed_elements; }
+    };
+    using SeenTerms = vespalib::hash_map<vespalib::string, Seen>;
+
+    mutable std::mutex  _lock;
+    std::atomic<size_t> _max_bytes;
+    Cache               _cache;
+    SeenTerms           _seen;
+    generation_t        _generation;
+    Stats               _stats;
+
+    bool admit(const vespalib::string &term, uint32_t docid_limit, size_t cost);
+    void drop_entries();
+    static CachedFilter make_filter(BitVectorSP bit_vector, size_t &bytes);
+public:
+    explicit BitVectorFilterCache(size_t max_bytes);
+    ~BitVectorFilterCache();
+    bool enabled() const noexcept { return _max_bytes.load(std::memory_order_relaxed) > 0; }
+    size_t max_bytes() const noexcept { return _max_bytes.load(std::memory_order_relaxed); }
+    void set_max_bytes(size_t max_bytes);
+
+    /**
+     * Returns the cached result for the given term, or an empty one if there is none
+     * computed for the given generation and docid limit. The returned bit vectors
+     * are shared and must not be modified.
+     */
+    CachedFilter find(const vespalib::string &term, generation_t generation, uint32_t docid_limit);
+
+    /**
+     * Offer a bit vector computed for the given term at the given generation,
+     * where cost is the number of posting list entries merged to compute it.
+     * Called each time a bit vector is computed after find() returned nullptr,
+     * which is counted as a miss. Returns true if it was admitted to the cache.
+     * A sparse bit vector is compressed when admitted, and the caller keeps using
+     * its own copy.
+     */
+    bool insert(const vespalib::string &term, generation_t generation, uint32_t docid_limit,
+                size_t cost, BitVectorSP bit_vector);
+    Stats get_stats() const;
+    void clear();
+};
+
+}
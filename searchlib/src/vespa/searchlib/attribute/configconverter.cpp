@@ -2,6 +2,7 @@
 
 #include "configconverter.h"
 #include <vespa/searchcommon/attribute/config.h>
+#include <algorithm>
 
 using namespace vespa::config::search;
 
@@ -92,6 +93,65 @@ convertMatch(AttributesConfig::Attribute::Match match_cfg) {
     assert(false);
 }
 
+vespalib::stringref
+convert_strength(AttributesConfig::Attribute::Ucasortkeys::Strength strength_cfg) {
+    using Strength = AttributesConfig::Attribute::Ucasortkeys::Strength;
+    switch (strength_cfg) {
+        case Strength::PRIMARY:
+            return "PRIMARY";
+        case Strength::SECONDARY:
+            return "SECONDARY";
+        case Strength::TERTIARY:
+            return "TERTIARY";
+        case Strength::QUATERNARY:
+            return "QUATERNARY";
+        case Strength::IDENTICAL:
+            return "IDENTICAL";
+    }
+    assert(false);
+}
+
+std::vector<UcaSortKeyParams>
+convert_uca_sort_keys(const std::vector<AttributesConfig::Attribute::Ucasortkeys> & uca_sort_keys_cfg) {
+    std::vector<UcaSortKeyParams> result;
+    result.reserve(uca_sort_keys_cfg.size());
+    for (const auto & elem : uca_sort_keys_cfg) {
+        result.emplace_back(elem.locale, convert_strength(elem.strength));
+    }
+    return result;
+}
+
+vespalib::alloc::MemoryPlacement
+convert_memory_placement(const AttributesConfig::Attribute::Memory & memory_cfg) {
+    using HugePages = vespalib::alloc::MemoryPlacement::HugePages;
+    HugePages huge_pages = HugePages::DEFAULT;
+    switch (memory_cfg.hugepages) {
+        case AttributesConfig::Attribute::Memory::Hugepages::DEFAULT:
+            huge_pages = HugePages::DEFAULT;
+            break;
+        case AttributesConfig::Attribute::Memory::Hugepages::TRANSPARENT:
+            huge_pages = HugePages::TRANSPARENT;
+            break;
+        case AttributesConfig::Attribute::Memory::Hugepages::EXPLICIT:
+            huge_pages = HugePages::EXPLICIT;
+            break;
+    }
+    return {huge_pages, std::max(memory_cfg.numanode, vespalib::alloc::MemoryPlacement::NO_NUMA_NODE)};
+}
+
+VectorQuantization
+convert_quantization(AttributesConfig::Attribute::Index::Hnsw::Quantization quantization_cfg) {
+    switch (quantization_cfg) {
+        case AttributesConfig::Attribute::Index::Hnsw::Quantization::NONE:
+            return VectorQuantization::None;
+        case AttributesConfig::Attribute::Index::Hnsw::Quantization::INT8:
+            return VectorQuantization::Int8;
+        case AttributesConfig::Attribute::Index::Hnsw::Quantization::BINARY:
+            return VectorQuantization::Binary;
+    }
+    assert(false);
+}
+
 }
 
 Config
@@ -108,7 +168,16 @@ ConfigConverter::convert(const AttributesConfig::Attribute & cfg)
     retval.setFastAccess(cfg.fastaccess);
     retval.setMutable(cfg.ismutable);
     retval.setPaged(cfg.paged);
+    retval.set_memory_placement(convert_memory_placement(cfg.memory));
     retval.setMaxUnCommittedMemory(cfg.maxuncommittedmemory);
+    retval.set_filter_cache_max_bytes(cfg.filtercache.maxbytes);
+    retval.set_range_bucket_levels(cfg.rangebuckets.levels);
+    retval.set_range_bucket_bits(cfg.rangebuckets.bits);
+    retval.set_save_posting_lists(cfg.savepostinglists);
+    retval.set_write_shards(cfg.writeshards);
+    retval.set_max_delta_saves(cfg.maxdeltasaves);
+    retval.set_dedup_tensor_subspaces(cfg.dedupsubspaces);
+    retval.set_uca_sort_keys(convert_uca_sort_keys(cfg.ucasortkeys));
     predicateParams.setArity(cfg.arity);
     predicateParams.setBounds(cfg.lowerbound, cfg.upperbound);
     predicateParams.setDensePostingListThreshold(cfg.densepostinglistthreshold);
@@ -144,7 +213,8 @@ ConfigConverter::convert(const AttributesConfig::Attribute & cfg)
     if (cfg.index.hnsw.enabled) {
         retval.set_hnsw_index_params(HnswIndexParams(cfg.index.hnsw.maxlinkspernode,
                                                      cfg.index.hnsw.neighborstoexploreatinsert,
-                                                     dm, cfg.index.hnsw.multithreadedindexing));
+                                                     dm, cfg.index.hnsw.multithreadedindexing,
+                                                     convert_quantization(cfg.index.hnsw.quantization)));
     }
     if (retval.basicType().type() == BasicType::Type::TENSOR) {
         if (!cfg.tensortype.empty()) {
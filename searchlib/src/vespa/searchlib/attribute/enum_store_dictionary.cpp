@@ -29,7 +29,14 @@ EnumStoreDictionary<BTreeDictionaryT, HashDictionaryT>::remove_unused_values(con
 
 template <typename BTreeDictionaryT, typename HashDictionaryT>
 EnumStoreDictionary<BTreeDictionaryT, HashDictionaryT>::EnumStoreDictionary(IEnumStore& enumStore, std::unique_ptr<EntryComparator> compare)
-    : ParentUniqueStoreDictionary(std::move(compare)),
+    : EnumStoreDictionary(enumStore, std::move(compare), {})
+{
+}
+
+template <typename BTreeDictionaryT, typename HashDictionaryT>
+EnumStoreDictionary<BTreeDictionaryT, HashDictionaryT>::EnumStoreDictionary(IEnumStore& enumStore, std::unique_ptr<EntryComparator> compare,
+                                                                             std::shared_ptr<vespalib::alloc::MemoryAllocator> memory_allocator)
+    : ParentUniqueStoreDictionary(std::move(compare), std::move(memory_allocator)),
       _enumStore(enumStore)
 {
 }
@@ -483,7 +490,13 @@ EnumStoreDictionary<BTreeDictionaryT, HashDictionaryT>::get_posting_dictionary()
 }
 
 EnumStoreFoldedDictionary::EnumStoreFoldedDictionary(IEnumStore& enumStore, std::unique_ptr<EntryComparator> compare, std::unique_ptr<EntryComparator> folded_compare)
-    : EnumStoreDictionary<EnumPostingTree>(enumStore, std::move(compare)),
+    : EnumStoreFoldedDictionary(enumStore, std::move(compare), std::move(folded_compare), {})
+{
+}
+
+EnumStoreFoldedDictionary::EnumStoreFoldedDictionary(IEnumStore& enumStore, std::unique_ptr<EntryComparator> compare, std::unique_ptr<EntryComparator> folded_compare,
+                                                     std::shared_ptr<vespalib::alloc::MemoryAllocator> memory_allocator)
+    : EnumStoreDictionary<EnumPostingTree>(enumStore, std::move(compare), std::move(memory_allocator)),
       _folded_compare(std::move(folded_compare))
 {
 }
@@ -37,6 +37,8 @@ private:
 
 public:
     EnumStoreDictionary(IEnumStore& enumStore, std::unique_ptr<EntryComparator> compare);
+    EnumStoreDictionary(IEnumStore& enumStore, std::unique_ptr<EntryComparator> compare,
+                        std::shared_ptr<vespalib::alloc::MemoryAllocator> memory_allocator);
 
     ~EnumStoreDictionary() override;
 
@@ -77,6 +79,8 @@ private:
 
 public:
     EnumStoreFoldedDictionary(IEnumStore& enumStore, std::unique_ptr<EntryComparator> compare, std::unique_ptr<EntryComparator> folded_compare);
+    EnumStoreFoldedDictionary(IEnumStore& enumStore, std::unique_ptr<EntryComparator> compare, std::unique_ptr<EntryComparator> folded_compare,
+                              std::shared_ptr<vespalib::alloc::MemoryAllocator> memory_allocator);
     ~EnumStoreFoldedDictionary() override;
     vespalib::datastore::UniqueStoreAddResult add(const EntryComparator& comp, std::function<EntryRef(void)> insertEntry) override;
     void remove(const EntryComparator& comp, EntryRef ref) override;
@@ -3,11 +3,20 @@
 #include "enum_store_loaders.h"
 #include "i_enum_store.h"
 #include "i_enum_store_dictionary.h"
+#include "posting_lists_file.h"
 #include <vespa/vespalib/util/array.hpp>
+#include <vespa/vespalib/util/size_literals.h>
 #include <algorithm>
 
 namespace search::enumstore {
 
+namespace {
+
+constexpr size_t parallel_sort_min_values = 1_Mi;
+constexpr size_t parallel_sort_parts = 16;
+
+}
+
 EnumeratedLoaderBase::EnumeratedLoaderBase(IEnumStore& store)
     : _store(store),
       _indexes(),
@@ -101,12 +110,29 @@ EnumeratedPostingsLoader::EnumeratedPostingsLoader(IEnumStore& store)
     : EnumeratedLoaderBase(store),
       _loaded_enums(),
       _posting_indexes(),
-      _has_btree_dictionary(_store.get_dictionary().get_has_btree_dictionary())
+      _has_btree_dictionary(_store.get_dictionary().get_has_btree_dictionary()),
+      _executor(nullptr)
 {
 }
 
 EnumeratedPostingsLoader::~EnumeratedPostingsLoader() = default;
 
+void
+EnumeratedPostingsLoader::sort_loaded_enums()
+{
+    if ((_executor != nullptr) && (_loaded_enums.size() >= parallel_sort_min_values)) {
+        attribute::sortLoadedByEnum(_loaded_enums, _indexes.size(), *_executor, parallel_sort_parts);
+    } else {
+        attribute::sortLoadedByEnum(_loaded_enums);
+    }
+}
+
+bool
+EnumeratedPostingsLoader::load_posting_lists_file(const fileutil::LoadedBuffer& buf, uint64_t num_values)
+{
+    return attribute::load_posting_lists_file(buf, _indexes.size(), num_values, _enum_value_remapping, _loaded_enums);
+}
+
 bool
 EnumeratedPostingsLoader::is_folded_change(Index lhs, Index rhs) const
 {
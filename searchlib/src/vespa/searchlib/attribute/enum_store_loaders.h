@@ -6,6 +6,8 @@
 #include "loadedenumvalue.h"
 
 namespace search { class IEnumStore; }
+namespace search::fileutil { class LoadedBuffer; }
+namespace vespalib { class Executor; }
 
 namespace search::enumstore {
 
@@ -66,6 +68,7 @@ private:
     attribute::LoadedEnumAttributeVector _loaded_enums;
     EntryRefVector                       _posting_indexes;
     bool                                 _has_btree_dictionary;
+    vespalib::Executor*                  _executor;
 
 public:
     EnumeratedPostingsLoader(IEnumStore& store);
@@ -78,9 +81,11 @@ public:
     void reserve_loaded_enums(size_t num_values) {
         _loaded_enums.reserve(num_values);
     }
-    void sort_loaded_enums() {
-        attribute::sortLoadedByEnum(_loaded_enums);
-    }
+    // loaded enums are sorted in parallel using the executor (if set) when there are many of them
+    void set_executor(vespalib::Executor* executor) noexcept { _executor = executor; }
+    void sort_loaded_enums();
+    // fills loaded enums, already sorted, from a saved posting lists file if it matches the loaded values
+    bool load_posting_lists_file(const fileutil::LoadedBuffer& buf, uint64_t num_values);
     bool is_folded_change(Index lhs, Index rhs) const;
     void set_ref_count(Index idx, uint32_t ref_count);
     vespalib::ArrayRef<EntryRef> initialize_empty_posting_indexes();
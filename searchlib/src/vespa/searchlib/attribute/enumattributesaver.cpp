@@ -8,9 +8,11 @@
 
 namespace search {
 
-EnumAttributeSaver::EnumAttributeSaver(IEnumStore &enumStore)
+EnumAttributeSaver::EnumAttributeSaver(IEnumStore &enumStore, bool save_posting_lists)
     : _enumStore(enumStore),
-      _enumerator(enumStore.make_enumerator())
+      _enumerator(enumStore.make_enumerator()),
+      _unique_value_count(0),
+      _posting_lists(save_posting_lists ? std::make_unique<attribute::PostingListsFileWriter>() : nullptr)
 {
 }
 
@@ -23,11 +25,30 @@ EnumAttributeSaver::writeUdat(IAttributeSaveTarget &saveTarget)
         auto udatWriter = saveTarget.udatWriter().allocBufferWriter();
         _enumerator->foreach_key([&](const vespalib::datastore::AtomicEntryRef& idx){
             _enumStore.write_value(*udatWriter, idx.load_acquire());
+            ++_unique_value_count;
         });
         udatWriter->flush();
     }
 }
 
+bool
+EnumAttributeSaver::setup_posting_lists_writer(IAttributeSaveTarget &saveTarget)
+{
+    return !_posting_lists ||
+           saveTarget.setup_writer(attribute::PostingListsFileWriter::file_suffix(),
+                                   "Binary data file for posting lists");
+}
+
+void
+EnumAttributeSaver::write_posting_lists(IAttributeSaveTarget &saveTarget)
+{
+    if (_posting_lists) {
+        auto writer = saveTarget.get_writer(attribute::PostingListsFileWriter::file_suffix()).allocBufferWriter();
+        _posting_lists->write(*writer, _unique_value_count);
+        _posting_lists.reset();
+    }
+}
+
 }  // namespace search
 
 namespace vespalib::datastore {
@@ -3,6 +3,7 @@
 #pragma once
 
 #include "i_enum_store.h"
+#include "posting_lists_file.h"
 #include <vespa/vespalib/datastore/unique_store_enumerator.h>
 
 namespace search {
@@ -12,7 +13,8 @@ class IAttributeSaveTarget;
 /**
  * Helper class for saving an enumerated multivalue attribute.
  *
- * It handles writing to the udat file.
+ * It handles writing to the udat file, and to the pst file when
+ * posting lists are saved.
  */
 class EnumAttributeSaver
 {
@@ -22,12 +24,18 @@ public:
 private:
     const IEnumStore  &_enumStore;
     std::unique_ptr<Enumerator> _enumerator;
+    uint32_t                    _unique_value_count;
+    std::unique_ptr<attribute::PostingListsFileWriter> _posting_lists;
 
 public:
-    EnumAttributeSaver(IEnumStore &enumStore);
+    EnumAttributeSaver(IEnumStore &enumStore, bool save_posting_lists);
     ~EnumAttributeSaver();
 
     void writeUdat(IAttributeSaveTarget &saveTarget);
+    bool setup_posting_lists_writer(IAttributeSaveTarget &saveTarget);
+    // nullptr unless posting lists are saved
+    attribute::PostingListsFileWriter *get_posting_lists() { return _posting_lists.get(); }
+    void write_posting_lists(IAttributeSaveTarget &saveTarget);
     const IEnumStore &getEnumStore() const { return _enumStore; }
     Enumerator &get_enumerator() { return *_enumerator; }
     void clear() { _enumerator->clear(); }
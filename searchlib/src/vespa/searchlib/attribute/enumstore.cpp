@@ -35,25 +35,26 @@ EnumStoreT<const char*>::load_unique_value(const void* src, size_t available, In
 std::unique_ptr<vespalib::datastore::IUniqueStoreDictionary>
 make_enum_store_dictionary(IEnumStore &store, bool has_postings, const DictionaryConfig & dict_cfg,
                            std::unique_ptr<EntryComparator> compare,
-                           std::unique_ptr<EntryComparator> folded_compare)
+                           std::unique_ptr<EntryComparator> folded_compare,
+                           std::shared_ptr<vespalib::alloc::MemoryAllocator> memory_allocator)
 {
     using NoBTreeDictionary = vespalib::datastore::NoBTreeDictionary;
     using ShardedHashMap = vespalib::datastore::ShardedHashMap;
     if (has_postings) {
         if (folded_compare) {
-            return std::make_unique<EnumStoreFoldedDictionary>(store, std::move(compare), std::move(folded_compare));
+            return std::make_unique<EnumStoreFoldedDictionary>(store, std::move(compare), std::move(folded_compare), std::move(memory_allocator));
         } else {
             switch (dict_cfg.getType()) {
             case DictionaryConfig::Type::HASH:
-                return std::make_unique<EnumStoreDictionary<NoBTreeDictionary, ShardedHashMap>>(store, std::move(compare));
+                return std::make_unique<EnumStoreDictionary<NoBTreeDictionary, ShardedHashMap>>(store, std::move(compare), std::move(memory_allocator));
             case DictionaryConfig::Type::BTREE_AND_HASH:
-                return std::make_unique<EnumStoreDictionary<EnumPostingTree, ShardedHashMap>>(store, std::move(compare));
+                return std::make_unique<EnumStoreDictionary<EnumPostingTree, ShardedHashMap>>(store, std::move(compare), std::move(memory_allocator));
             default:
-                return std::make_unique<EnumStoreDictionary<EnumPostingTree>>(store, std::move(compare));
+                return std::make_unique<EnumStoreDictionary<EnumPostingTree>>(store, std::move(compare), std::move(memory_allocator));
             }
         }
     } else {
-        return std::make_unique<EnumStoreDictionary<EnumTree>>(store, std::move(compare));
+        return std::make_unique<EnumStoreDictionary<EnumTree>>(store, std::move(compare), std::move(memory_allocator));
     }
 }
 
@@ -40,7 +40,8 @@ make_enum_store_comparator(const DataStore& data_store, const DictionaryConfig&
 std::unique_ptr<vespalib::datastore::IUniqueStoreDictionary>
 make_enum_store_dictionary(IEnumStore &store, bool has_postings, const search::DictionaryConfig & dict_cfg,
                            std::unique_ptr<EntryComparator> compare,
-                           std::unique_ptr<EntryComparator> folded_compare);
+                           std::unique_ptr<EntryComparator> folded_compare,
+                           std::shared_ptr<vespalib::alloc::MemoryAllocator> memory_allocator);
 
 template <typename EntryT>
 void EnumStoreT<EntryT>::free_value_if_unused(Index idx, IndexList& unused)
@@ -85,7 +86,7 @@ EnumStoreT<EntryT>::load_unique_value(const void* src, size_t available, Index&
 
 template <typename EntryT>
 EnumStoreT<EntryT>::EnumStoreT(bool has_postings, const DictionaryConfig& dict_cfg, std::shared_ptr<vespalib::alloc::MemoryAllocator> memory_allocator, EntryType default_value)
-    : _store(std::move(memory_allocator), [&dict_cfg](const auto& data_store) { return make_enum_store_comparator<ComparatorType>(data_store, dict_cfg); }),
+    : _store(memory_allocator, [&dict_cfg](const auto& data_store) { return make_enum_store_comparator<ComparatorType>(data_store, dict_cfg); }),
       _dict(),
       _is_folded(dict_cfg.getMatch() == DictionaryConfig::Match::UNCASED),
       _foldedComparator(make_optionally_folded_comparator(is_folded())),
@@ -95,7 +96,8 @@ EnumStoreT<EntryT>::EnumStoreT(bool has_postings, const DictionaryConfig& dict_c
 {
     _store.set_dictionary(make_enum_store_dictionary(*this, has_postings, dict_cfg,
                                                      allocate_comparator(),
-                                                     allocate_optionally_folded_comparator(is_folded())));
+                                                     allocate_optionally_folded_comparator(is_folded()),
+                                                     std::move(memory_allocator)));
     _dict = static_cast<IEnumStoreDictionary*>(&_store.get_dictionary());
     setup_default_value_ref();
 }
@@ -53,6 +53,50 @@ double ImportedAttributeVectorReadGuard::getFloat(DocId doc) const {
     return _target_attribute.getFloat(getTargetLid(doc));
 }
 
+template <typename T, typename GetTargetValues>
+void
+ImportedAttributeVectorReadGuard::get_batch(vespalib::ConstArrayRef<DocId> docids, T *values, GetTargetValues get_target_values) const
+{
+    // Map all lids before touching the target attribute, then read each distinct
+    // target lid once and in ascending order (many children often share a parent).
+    std::vector<std::pair<uint32_t, uint32_t>> targets; // (target lid, index in docids)
+    targets.reserve(docids.size());
+    for (uint32_t i = 0; i < docids.size(); ++i) {
+        targets.emplace_back(getTargetLid(docids[i]), i);
+    }
+    std::sort(targets.begin(), targets.end());
+    std::vector<DocId> target_lids;
+    target_lids.reserve(targets.size());
+    for (const auto& target : targets) {
+        if (target_lids.empty() || target_lids.back() != target.first) {
+            target_lids.push_back(target.first);
+        }
+    }
+    std::vector<T> target_values(target_lids.size());
+    get_target_values(target_lids, target_values.data());
+    size_t pos = 0;
+    for (const auto& target : targets) {
+        if (target_lids[pos] != target.first) {
+            ++pos;
+        }
+        values[target.second] = target_values[pos];
+    }
+}
+
+void
+ImportedAttributeVectorReadGuard::get_ints(vespalib::ConstArrayRef<DocId> docids, largeint_t *values) const
+{
+    get_batch(docids, values, [this](vespalib::ConstArrayRef<DocId> target_lids, largeint_t *target_values)
+              { _target_attribute.get_ints(target_lids, target_values); });
+}
+
+void
+ImportedAttributeVectorReadGuard::get_floats(vespalib::ConstArrayRef<DocId> docids, double *values) const
+{
+    get_batch(docids, values, [this](vespalib::ConstArrayRef<DocId> target_lids, double *target_values)
+              { _target_attribute.get_floats(target_lids, target_values); });
+}
+
 vespalib::ConstArrayRef<char>
 ImportedAttributeVectorReadGuard::get_raw(DocId doc) const
 {
@@ -42,6 +42,8 @@ public:
     uint32_t getMaxValueCount() const override;
     largeint_t getInt(DocId doc) const override;
     double getFloat(DocId doc) const override;
+    void get_ints(vespalib::ConstArrayRef<DocId> docids, largeint_t *values) const override;
+    void get_floats(vespalib::ConstArrayRef<DocId> docids, double *values) const override;
     vespalib::ConstArrayRef<char> get_raw(DocId doc) const override;
     EnumHandle getEnum(DocId doc) const override;
     uint32_t get(DocId docId, largeint_t *buffer, uint32_t sz) const override;
@@ -100,6 +102,9 @@ private:
     vespalib::GenerationHandler::Guard   _reference_attribute_guard;
     std::unique_ptr<attribute::AttributeReadGuard> _target_attribute_guard;
     const ReferenceAttribute            &_reference_attribute;
+
+    template <typename T, typename GetTargetValues>
+    void get_batch(vespalib::ConstArrayRef<DocId> docids, T *values, GetTargetValues get_target_values) const;
 protected:
     const IAttributeVector              &_target_attribute;
 
@@ -4,6 +4,7 @@
 #include "i_enum_store.h"
 #include "loadedenumvalue.h"
 #include "multi_value_mapping.h"
+#include "posting_lists_file.h"
 #include <vespa/fastos/file.h>
 #include <vespa/searchcommon/attribute/multivalue.h>
 #include <vespa/searchlib/util/fileutil.h>
@@ -79,6 +80,13 @@ LoadUtils::loadUDAT(const AttributeVector& attr)
     return loadFile(attr, "udat");
 }
 
+LoadedBufferUP
+LoadUtils::loadPostingLists(const AttributeVector& attr)
+{
+    const auto suffix = PostingListsFileWriter::file_suffix();
+    return file_exists(attr, suffix) ? loadFile(attr, suffix) : LoadedBufferUP();
+}
+
 
 #define INSTANTIATE_ARRAY(ValueType, Saver) \
 template uint32_t loadFromEnumeratedMultiValue(MultiValueMapping<ValueType>&, ReaderBase &, vespalib::ConstArrayRef<atomic_utils::NonAtomicValue_t<ValueType>>, vespalib::ConstArrayRef<uint32_t>, Saver)
@@ -100,6 +108,7 @@ INSTANTIATE_SINGLE_ARRAY_WSET(ValueType, NoSaveLoadedEnum)
 
 INSTANTIATE_ENUM(SaveLoadedEnum); // posting lists
 INSTANTIATE_ENUM(SaveEnumHist);   // no posting lists but still enumerated
+INSTANTIATE_ENUM(NoSaveLoadedEnum); // posting lists loaded from separate file
 INSTANTIATE_VALUE(int8_t);
 INSTANTIATE_VALUE(int16_t);
 INSTANTIATE_VALUE(int32_t);
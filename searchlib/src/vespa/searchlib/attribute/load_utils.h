@@ -38,6 +38,8 @@ public:
     static LoadedBufferUP loadIDX(const AttributeVector& attr);
     static LoadedBufferUP loadWeight(const AttributeVector& attr);
     static LoadedBufferUP loadUDAT(const AttributeVector& attr);
+    // nullptr if posting lists were not saved
+    static LoadedBufferUP loadPostingLists(const AttributeVector& attr);
 };
 
 /**
@@ -2,19 +2,98 @@
 
 #include "loadedenumvalue.h"
 #include <vespa/searchlib/common/sort.h>
+#include <vespa/vespalib/util/count_down_latch.h>
+#include <vespa/vespalib/util/cpu_usage.h>
+#include <vespa/vespalib/util/executor.h>
+#include <vespa/vespalib/util/lambdatask.h>
+#include <algorithm>
+
+using vespalib::CpuUsage;
 
 namespace search::attribute {
 
+namespace {
+
 void
-sortLoadedByEnum(LoadedEnumAttributeVector &loaded)
+sort_range(LoadedEnumAttribute *data, size_t size)
 {
     ShiftBasedRadixSorter<LoadedEnumAttribute,
         LoadedEnumAttribute::EnumRadix,
         LoadedEnumAttribute::EnumCompare, 56>::
         radix_sort(LoadedEnumAttribute::EnumRadix(),
                    LoadedEnumAttribute::EnumCompare(),
-                   loaded.data(), loaded.size(), 16);
+                   data, size, 16);
 }
 
+template <typename Func>
+void
+run_parts(vespalib::Executor &executor, size_t num_parts, Func func)
+{
+    vespalib::CountDownLatch latch(num_parts);
+    for (size_t part = 0; part < num_parts; ++part) {
+        auto task = vespalib::makeLambdaTask([&func, &latch, part]() {
+            func(part);
+            latch.countDown();
+        });
+        executor.execute(CpuUsage::wrap(std::move(task), CpuUsage::Category::SETUP));
+    }
+    latch.await();
 }
 
+}
+
+void
+sortLoadedByEnum(LoadedEnumAttributeVector &loaded)
+{
+    sort_range(loaded.data(), loaded.size());
+}
+
+void
+sortLoadedByEnum(LoadedEnumAttributeVector &loaded, uint32_t num_enums, vespalib::Executor &executor, size_t num_parts)
+{
+    size_t size = loaded.size();
+    if (num_parts < 2 || num_enums < 2 || size < num_parts) {
+        sortLoadedByEnum(loaded);
+        return;
+    }
+    // Values are partitioned into buckets of consecutive enum values
+    // (chunks of the input are counted and scattered in parallel), then
+    // each bucket is sorted on its own.
+    auto bucket_of = [num_enums, num_parts](const LoadedEnumAttribute &value) {
+        assert(value.getEnum() < num_enums);
+        return (static_cast<uint64_t>(value.getEnum()) * num_parts) / num_enums;
+    };
+    auto chunk_begin = [size, num_parts](size_t chunk) { return (size * chunk) / num_parts; };
+    std::vector<size_t> offsets(num_parts * num_parts, 0); // [chunk][bucket]
+    run_parts(executor, num_parts, [&](size_t chunk) {
+        size_t *counts = &offsets[chunk * num_parts];
+        for (size_t i = chunk_begin(chunk); i < chunk_begin(chunk + 1); ++i) {
+            ++counts[bucket_of(loaded[i])];
+        }
+    });
+    std::vector<size_t> bucket_begin(num_parts + 1, 0);
+    size_t pos = 0;
+    for (size_t bucket = 0; bucket < num_parts; ++bucket) {
+        bucket_begin[bucket] = pos;
+        for (size_t chunk = 0; chunk < num_parts; ++chunk) {
+            size_t count = offsets[(chunk * num_parts) + bucket];
+            offsets[(chunk * num_parts) + bucket] = pos;
+            pos += count;
+        }
+    }
+    bucket_begin[num_parts] = pos;
+    assert(pos == size);
+    LoadedEnumAttributeVector scattered(size);
+    run_parts(executor, num_parts, [&](size_t chunk) {
+        size_t *next = &offsets[chunk * num_parts];
+        for (size_t i = chunk_begin(chunk); i < chunk_begin(chunk + 1); ++i) {
+            scattered[next[bucket_of(loaded[i])]++] = loaded[i];
+        }
+    });
+    run_parts(executor, num_parts, [&](size_t bucket) {
+        sort_range(scattered.data() + bucket_begin[bucket], bucket_begin[bucket + 1] - bucket_begin[bucket]);
+    });
+    loaded.swap(scattered);
+}
+
+}
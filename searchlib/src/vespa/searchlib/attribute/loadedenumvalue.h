@@ -7,6 +7,8 @@
 #include <cassert>
 #include <limits>
 
+namespace vespalib { class Executor; }
+
 namespace search::attribute {
 
 /**
@@ -139,4 +141,13 @@ public:
 
 void sortLoadedByEnum(LoadedEnumAttributeVector &loaded);
 
+/**
+ * Sort loaded values by enum (and docid) using the given executor.
+ * The values are partitioned into num_parts buckets of consecutive
+ * enum values in parallel, using a temporary copy of the values, and
+ * the buckets are then sorted in parallel. All enum values must be
+ * less than num_enums.
+ */
+void sortLoadedByEnum(LoadedEnumAttributeVector &loaded, uint32_t num_enums, vespalib::Executor &executor, size_t num_parts);
+
 }
@@ -32,6 +32,8 @@ private:
     using ConstArrayRef = vespalib::ConstArrayRef<ElemT>;
 
     ArrayStore _store;
+    std::unique_ptr<vespalib::datastore::ICompactionContext> _compaction_context; // ongoing compaction, if any
+    size_t _compaction_position; // next doc id to be visited by ongoing compaction
 public:
     MultiValueMapping(const MultiValueMapping &) = delete;
     MultiValueMapping & operator = (const MultiValueMapping &) = delete;
@@ -65,13 +67,22 @@ public:
     vespalib::MemoryUsage getArrayStoreMemoryUsage() const override;
     vespalib::MemoryUsage update_stat(const CompactionStrategy& compaction_strategy);
     bool consider_compact(const CompactionStrategy &compactionStrategy) {
-        if (_store.consider_compact()) {
+        if (_compaction_context || _store.consider_compact()) {
             compact_worst(compactionStrategy);
             return true;
         }
         return false;
     }
+    /*
+     * Starts compacting the worst buffers unless a compaction is already ongoing, then performs
+     * one compaction step, moving at most compaction_strategy.get_max_moves_per_step() arrays.
+     * The compacted buffers are held when all documents have been visited.
+     */
     void compact_worst(const CompactionStrategy& compaction_strategy);
+    // Number of documents not yet visited by ongoing compaction. Should be called from writer only.
+    size_t get_compaction_pending() {
+        return (_compaction_context && _compaction_position < _indices.size()) ? (_indices.size() - _compaction_position) : 0;
+    }
     bool has_free_lists_enabled() const { return _store.has_free_lists_enabled(); }
     // Set compaction spec. Only used by unit tests.
     void set_compaction_spec(vespalib::datastore::CompactionSpec compaction_spec) noexcept { _store.set_compaction_spec(compaction_spec); }
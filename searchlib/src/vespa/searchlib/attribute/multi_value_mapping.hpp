@@ -13,7 +13,9 @@ MultiValueMapping<ElemT,RefT>::MultiValueMapping(const vespalib::datastore::Arra
                                                   const vespalib::GrowStrategy &gs,
                                                   std::shared_ptr<vespalib::alloc::MemoryAllocator> memory_allocator)
   : MultiValueMappingBase(gs, ArrayStore::getGenerationHolderLocation(_store), memory_allocator),
-    _store(storeCfg, std::move(memory_allocator), ArrayStoreTypeMapper(storeCfg.max_type_id(), array_store_grow_factor, max_buffer_size))
+    _store(storeCfg, std::move(memory_allocator), ArrayStoreTypeMapper(storeCfg.max_type_id(), array_store_grow_factor, max_buffer_size)),
+    _compaction_context(),
+    _compaction_position(0)
 {
 }
 
@@ -45,9 +47,18 @@ template <typename ElemT, typename RefT>
 void
 MultiValueMapping<ElemT,RefT>::compact_worst(const CompactionStrategy& compaction_strategy)
 {
-    vespalib::datastore::ICompactionContext::UP compactionContext(_store.compact_worst(compaction_strategy));
-    if (compactionContext) {
-        compactionContext->compact(vespalib::ArrayRef<AtomicEntryRef>(&_indices[0], _indices.size()));
+    if (!_compaction_context) {
+        _compaction_context = _store.compact_worst(compaction_strategy);
+        _compaction_position = 0;
+        if (!_compaction_context) {
+            return;
+        }
+    }
+    _compaction_position = _compaction_context->compact_step(vespalib::ArrayRef<AtomicEntryRef>(&_indices[0], _indices.size()),
+                                                             _compaction_position,
+                                                             compaction_strategy.get_max_moves_per_step());
+    if (_compaction_position >= _indices.size()) {
+        _compaction_context.reset();
     }
 }
 
@@ -98,6 +98,17 @@ MultiValueEnumAttribute<B, M>::load_enumerated_data(ReaderBase& attrReader,
                                                     enumstore::EnumeratedPostingsLoader& loader,
                                                     size_t num_values)
 {
+    auto posting_lists = attribute::LoadUtils::loadPostingLists(*this);
+    if (posting_lists && loader.load_posting_lists_file(*posting_lists, num_values)) {
+        posting_lists.reset();
+        uint32_t maxvc = attribute::loadFromEnumeratedMultiValue(this->_mvMapping, attrReader,
+                                                                 vespalib::ConstArrayRef<EnumIndex>(loader.get_enum_indexes()),
+                                                                 loader.get_enum_value_remapping(),
+                                                                 attribute::NoSaveLoadedEnum());
+        loader.free_enum_value_remapping();
+        this->checkSetMaxValueCount(maxvc);
+        return;
+    }
     loader.reserve_loaded_enums(num_values);
     uint32_t maxvc = attribute::loadFromEnumeratedMultiValue(this->_mvMapping, attrReader,
                                                              vespalib::ConstArrayRef<EnumIndex>(loader.get_enum_indexes()),
@@ -190,6 +201,7 @@ MultiValueEnumAttribute<B, M>::onUpdateStat()
     mergeMemoryStats(total);
     this->updateStatistics(this->_mvMapping.getTotalValueCnt(), this->_enumStore.get_num_uniques(), total.allocatedBytes(),
                      total.usedBytes(), total.deadBytes(), total.allocatedBytesOnHold());
+    this->getStatus().setCompactionPending(this->_mvMapping.get_compaction_pending());
 }
 
 template <typename B, typename M>
@@ -221,7 +233,8 @@ MultiValueEnumAttribute<B, M>::onInitSave(vespalib::stringref fileName)
 {
     auto guard = this->getGenerationHandler().takeGuard();
     return std::make_unique<MultiValueEnumAttributeSaver<WeightedIndex>>
-        (std::move(guard), this->createAttributeHeader(fileName), this->_mvMapping, this->_enumStore);
+        (std::move(guard), this->createAttributeHeader(fileName), this->_mvMapping, this->_enumStore,
+         this->hasPostings() && this->getConfig().save_posting_lists());
 }
 
 } // namespace search
@@ -80,10 +80,11 @@ MultiValueEnumAttributeSaver<MultiValueT>::
 MultiValueEnumAttributeSaver(GenerationHandler::Guard &&guard,
                              const attribute::AttributeHeader &header,
                              const MultiValueMapping &mvMapping,
-                             IEnumStore &enumStore)
+                             IEnumStore &enumStore,
+                             bool save_posting_lists)
     : Parent(std::move(guard), header, mvMapping),
       _mvMapping(mvMapping),
-      _enumSaver(enumStore),
+      _enumSaver(enumStore, save_posting_lists),
       _enum_store(enumStore),
       _compaction_count(enumStore.get_compaction_count())
 {
@@ -105,19 +106,32 @@ bool
 MultiValueEnumAttributeSaver<MultiValueT>::
 onSave(IAttributeSaveTarget &saveTarget)
 {
+    if (!_enumSaver.setup_posting_lists_writer(saveTarget)) {
+        return false;
+    }
     bool compaction_broke_save = false;
     CountWriter countWriter(saveTarget);
     WeightWriter<multivalue::is_WeightedValue_v<MultiValueType>> weightWriter(saveTarget);
     DatWriter datWriter(saveTarget, _enumSaver.get_enumerator(),
                         [this]() { return compaction_interferred(); });
     _enumSaver.writeUdat(saveTarget);
-    _enumSaver.get_enumerator().enumerateValues();
+    auto &enumerator = _enumSaver.get_enumerator();
+    auto *posting_lists = _enumSaver.get_posting_lists();
+    enumerator.enumerateValues();
     for (uint32_t docId = 0; docId < _frozenIndices.size(); ++docId) {
         vespalib::datastore::EntryRef idx = _frozenIndices[docId];
         vespalib::ConstArrayRef<MultiValueType> handle(_mvMapping.getDataForIdx(idx));
         countWriter.writeCount(handle.size());
         weightWriter.writeWeights(handle);
         datWriter.writeValues(handle);
+        if (posting_lists != nullptr) {
+            for (const auto &value : handle) {
+                uint32_t enumValue = enumerator.map_entry_ref_to_enum_value_or_zero(multivalue::get_value_ref(value).load_acquire());
+                if (enumValue != 0u) {
+                    posting_lists->add(enumValue - 1, docId, multivalue::get_weight(value));
+                }
+            }
+        }
         if (((docId % 0x1000) == 0) && compaction_interferred()) {
             compaction_broke_save = true;
             break;
@@ -130,6 +144,8 @@ onSave(IAttributeSaveTarget &saveTarget)
     }
     if (compaction_broke_save) {
         LOG(warning, "Aborted save of attribute vector to '%s' due to compaction of unique values", get_file_name().c_str());
+    } else {
+        _enumSaver.write_posting_lists(saveTarget);
     }
     return !compaction_broke_save;
 }
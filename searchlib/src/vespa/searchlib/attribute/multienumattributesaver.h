@@ -35,7 +35,8 @@ public:
     MultiValueEnumAttributeSaver(GenerationHandler::Guard &&guard,
                                  const attribute::AttributeHeader &header,
                                  const MultiValueMapping &mvMapping,
-                                 IEnumStore &enumStore);
+                                 IEnumStore &enumStore,
+                                 bool save_posting_lists);
     ~MultiValueEnumAttributeSaver() override;
 };
 
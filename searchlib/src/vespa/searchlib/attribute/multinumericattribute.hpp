@@ -81,6 +81,7 @@ void MultiValueNumericAttribute<B, M>::onUpdateStat()
     usage.merge(this->getChangeVectorMemoryUsage());
     this->updateStatistics(this->_mvMapping.getTotalValueCnt(), this->_mvMapping.getTotalValueCnt(), usage.allocatedBytes(),
                            usage.usedBytes(), usage.deadBytes(), usage.allocatedBytesOnHold());
+    this->getStatus().setCompactionPending(this->_mvMapping.get_compaction_pending());
 }
 
 
@@ -49,7 +49,7 @@ public:
 
     bool onLoad(vespalib::Executor *executor) override;
 
-    bool onLoadEnumerated(ReaderBase &attrReader);
+    bool onLoadEnumerated(ReaderBase &attrReader, vespalib::Executor *executor);
 
     std::unique_ptr<attribute::SearchContext>
     getSearch(QueryTermSimpleUP term, const attribute::SearchContextParams & params) const override;
@@ -43,7 +43,7 @@ template <typename B, typename M>
 MultiValueNumericPostingAttribute<B, M>::MultiValueNumericPostingAttribute(const vespalib::string & name,
                                                                            const AttributeVector::Config & cfg)
     : MultiValueNumericEnumAttribute<B, M>(name, cfg),
-      PostingParent(*this, this->getEnumStore()),
+      PostingParent(*this, this->getEnumStore(), this->get_memory_allocator()),
       _posting_store_adapter(this->get_posting_store(), this->_enumStore, this->getIsFilter())
 {
 }
@@ -13,7 +13,7 @@ namespace search {
 template <typename B, typename T>
 MultiValueStringPostingAttributeT<B, T>::MultiValueStringPostingAttributeT(const vespalib::string & name, const AttributeVector::Config & c)
     : MultiValueStringAttributeT<B, T>(name, c),
-      PostingParent(*this, this->getEnumStore()),
+      PostingParent(*this, this->getEnumStore(), this->get_memory_allocator()),
       _posting_store_adapter(this->get_posting_store(), this->_enumStore, this->getIsFilter())
 {
 }
@@ -4,6 +4,8 @@
 
 #include "i_direct_posting_store.h"
 #include <vespa/searchlib/queryeval/begin_and_end_id.h>
+#include <limits>
+#include <type_traits>
 
 namespace search {
 
@@ -42,6 +44,20 @@ public:
         return _children[ref].getData();
     }
 
+    // Max weight in the posting list block (b-tree leaf node) the child is positioned in
+    int32_t get_block_max_weight(ref_t ref) const {
+        if constexpr (std::is_same_v<IteratorType, DocidWithWeightIterator>) {
+            return _children[ref].getLeafAggregated().getMax();
+        } else {
+            return std::numeric_limits<int32_t>::max();
+        }
+    }
+
+    // Last docid in the posting list block the child is positioned in
+    uint32_t get_block_end(ref_t ref) const {
+        return _children[ref].getLeafLastKey();
+    }
+
     std::unique_ptr<BitVector> get_hits(uint32_t begin_id, uint32_t end_id);
     void or_hits_into(BitVector &result, uint32_t begin_id);
 
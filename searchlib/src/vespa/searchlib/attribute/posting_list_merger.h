@@ -33,6 +33,8 @@ public:
 
     void reserveArray(uint32_t postingsCount, size_t postingsSize);
     void allocBitVector();
+    // Use an already merged bit vector, e.g. from a cache. It must not be modified.
+    void setBitVector(std::shared_ptr<BitVector> bitVector) noexcept { _bitVector = std::move(bitVector); }
     void merge();
     bool hasArray() const noexcept { return _arrayValid; }
     bool hasBitVector() const noexcept { return static_cast<bool>(_bitVector); }
@@ -0,0 +1,102 @@
+// Copyright Vespa.ai. Licensed under the terms of the Apache 2.0 license. See LICENSE in the project root.
+
+#include "posting_lists_file.h"
+#include <vespa/searchlib/util/bufferwriter.h>
+#include <vespa/searchlib/util/fileutil.h>
+#include <cassert>
+#include <cstring>
+
+namespace search::attribute {
+
+namespace {
+
+struct SavedPosting {
+    uint32_t docid;
+    int32_t  weight;
+};
+
+template <typename T>
+T read_at(const char* pos) noexcept {
+    T value;
+    memcpy(&value, pos, sizeof(T));
+    return value;
+}
+
+}
+
+PostingListsFileWriter::PostingListsFileWriter()
+    : _values()
+{
+}
+
+PostingListsFileWriter::~PostingListsFileWriter() = default;
+
+vespalib::string
+PostingListsFileWriter::file_suffix()
+{
+    return "pst";
+}
+
+void
+PostingListsFileWriter::write(BufferWriter& writer, uint32_t num_enums)
+{
+    std::vector<uint32_t> counts(num_enums, 0);
+    for (const auto& value : _values) {
+        assert(value.getEnum() < num_enums);
+        ++counts[value.getEnum()];
+    }
+    writer.write(&num_enums, sizeof(num_enums));
+    writer.write(counts.data(), counts.size() * sizeof(uint32_t));
+    // Stable counting scatter keeps docid order within each enum value
+    std::vector<uint64_t> offsets(num_enums, 0);
+    uint64_t offset = 0;
+    for (uint32_t e = 0; e < num_enums; ++e) {
+        offsets[e] = offset;
+        offset += counts[e];
+    }
+    std::vector<SavedPosting, vespalib::allocator_large<SavedPosting>> postings(_values.size());
+    for (const auto& value : _values) {
+        postings[offsets[value.getEnum()]++] = SavedPosting{value.getDocId(), value.getWeight()};
+    }
+    LoadedEnumAttributeVector().swap(_values);
+    writer.write(postings.data(), postings.size() * sizeof(SavedPosting));
+    writer.flush();
+}
+
+bool
+load_posting_lists_file(const fileutil::LoadedBuffer& buf, uint32_t num_enums, uint64_t num_values,
+                        vespalib::ConstArrayRef<uint32_t> enum_value_remapping,
+                        LoadedEnumAttributeVector& loaded)
+{
+    loaded.clear();
+    const char* pos = buf.c_str();
+    size_t counts_size = sizeof(uint32_t) * (1 + uint64_t(num_enums));
+    if ((buf.size() != counts_size + num_values * sizeof(SavedPosting)) ||
+        (read_at<uint32_t>(pos) != num_enums)) {
+        return false;
+    }
+    const char* counts = pos + sizeof(uint32_t);
+    uint64_t total = 0;
+    for (uint32_t e = 0; e < num_enums; ++e) {
+        total += read_at<uint32_t>(counts + e * sizeof(uint32_t));
+    }
+    if (total != num_values) {
+        return false;
+    }
+    loaded.reserve(num_values);
+    const char* postings = pos + counts_size;
+    for (uint32_t e = 0; e < num_enums; ++e) {
+        uint32_t count = read_at<uint32_t>(counts + e * sizeof(uint32_t));
+        uint32_t enum_value = enum_value_remapping.empty() ? e : enum_value_remapping[e];
+        for (uint32_t i = 0; i < count; ++i, postings += sizeof(SavedPosting)) {
+            auto posting = read_at<SavedPosting>(postings);
+            loaded.emplace_back(enum_value, posting.docid, posting.weight);
+        }
+    }
+    if (!enum_value_remapping.empty()) {
+        sortLoadedByEnum(loaded);
+    }
+    return true;
+}
+
+}
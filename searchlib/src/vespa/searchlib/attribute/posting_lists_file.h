@@ -0,0 +1,43 @@
+// Copyright Vespa.ai. Licensed under the terms of the Apache 2.0 license. See LICENSE in the project root.
+
+#pragma once
+
+#include "loadedenumvalue.h"
+#include <vespa/vespalib/stllike/string.h>
+
+namespace search { class BufferWriter; }
+namespace search::fileutil { class LoadedBuffer; }
+
+namespace search::attribute {
+
+/**
+ * Collects the values of an enumerated attribute while it is saved and
+ * writes them grouped by enum value, i.e. one group per posting list.
+ * Loading the file gives the values in the order that is otherwise
+ * produced by sorting them after reading the data file.
+ *
+ * Layout after the file header: number of enum values, number of
+ * values for each enum value, then (docid, weight) for all values,
+ * grouped by enum value and in docid order within each group.
+ */
+class PostingListsFileWriter {
+    LoadedEnumAttributeVector _values;
+public:
+    PostingListsFileWriter();
+    ~PostingListsFileWriter();
+    static vespalib::string file_suffix();
+    // values must be added in docid order
+    void add(uint32_t e, uint32_t docid, int32_t weight) { _values.emplace_back(e, docid, weight); }
+    void write(BufferWriter& writer, uint32_t num_enums);
+};
+
+/**
+ * Fills loaded with the values from a saved posting lists file, sorted
+ * by enum value and docid. Returns false (leaving loaded empty) if the
+ * file does not match the given number of unique values and values.
+ */
+bool load_posting_lists_file(const fileutil::LoadedBuffer& buf, uint32_t num_enums, uint64_t num_values,
+                             vespalib::ConstArrayRef<uint32_t> enum_value_remapping,
+                             LoadedEnumAttributeVector& loaded);
+
+}
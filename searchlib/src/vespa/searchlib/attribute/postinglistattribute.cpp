@@ -13,10 +13,11 @@ using attribute::LoadedNumericValue;
 template <typename P>
 PostingListAttributeBase<P>::
 PostingListAttributeBase(AttributeVector &attr,
-                         IEnumStore &enumStore)
+                         IEnumStore &enumStore,
+                         std::shared_ptr<vespalib::alloc::MemoryAllocator> memory_allocator)
     : attribute::IPostingListAttributeBase(),
       _posting_store(enumStore.get_dictionary(), attr.getStatus(),
-                     attr.getConfig()),
+                     attr.getConfig(), std::move(memory_allocator)),
       _attr(attr),
       _dictionary(enumStore.get_dictionary())
 { }
@@ -69,13 +70,13 @@ PostingListAttributeBase<P>::handle_load_posting_lists_and_update_enum_store(enu
             if (loader.is_folded_change(enum_indexes[posting_enum], enum_indexes[preve])) {
                 postings.removeDups();
                 newIndex = EntryRef();
-                _posting_store.apply(newIndex,
-                                   postings._additions.data(),
-                                   postings._additions.data() +
-                                   postings._additions.size(),
-                                   postings._removals.data(),
-                                   postings._removals.data() +
-                                   postings._removals.size());
+                _posting_store.bulk_merge(newIndex,
+                                          postings._additions.data(),
+                                          postings._additions.data() +
+                                          postings._additions.size(),
+                                          postings._removals.data(),
+                                          postings._removals.data() +
+                                          postings._removals.size());
                 posting_indexes[posting_enum] = newIndex;
                 postings.clear();
                 posting_enum = elem.getEnum();
@@ -91,11 +92,11 @@ PostingListAttributeBase<P>::handle_load_posting_lists_and_update_enum_store(enu
     loader.set_ref_count(enum_indexes[preve], refCount);
     postings.removeDups();
     newIndex = EntryRef();
-    _posting_store.apply(newIndex,
-                       postings._additions.data(),
-                       postings._additions.data() + postings._additions.size(),
-                       postings._removals.data(),
-                       postings._removals.data() + postings._removals.size());
+    _posting_store.bulk_merge(newIndex,
+                              postings._additions.data(),
+                              postings._additions.data() + postings._additions.size(),
+                              postings._removals.data(),
+                              postings._removals.data() + postings._removals.size());
     posting_indexes[posting_enum] = newIndex;
     loader.build_dictionary();
     loader.free_unused_values();
@@ -112,11 +113,21 @@ PostingListAttributeBase<P>::updatePostings(PostingMap &changePost,
         change.removeDups();
         auto updater= [this, &change](EntryRef posting_idx) -> EntryRef
                       {
-                          _posting_store.apply(posting_idx,
-                                             change._additions.data(),
-                                             change._additions.data() + change._additions.size(),
-                                             change._removals.data(),
-                                             change._removals.data() + change._removals.size());
+                          // A batch that at least doubles the posting list would split
+                          // nodes over and over when applied entry by entry.
+                          if (change._additions.size() >= _posting_store.size(posting_idx)) {
+                              _posting_store.bulk_merge(posting_idx,
+                                                        change._additions.data(),
+                                                        change._additions.data() + change._additions.size(),
+                                                        change._removals.data(),
+                                                        change._removals.data() + change._removals.size());
+                          } else {
+                              _posting_store.apply(posting_idx,
+                                                   change._additions.data(),
+                                                   change._additions.data() + change._additions.size(),
+                                                   change._removals.data(),
+                                                   change._removals.data() + change._removals.size());
+                          }
                           return posting_idx;
                       };
         _dictionary.update_posting_list(idx, cmp, updater);
@@ -197,8 +208,9 @@ template <typename P, typename LoadedVector, typename LoadedValueType,
           typename EnumStoreType>
 PostingListAttributeSubBase<P, LoadedVector, LoadedValueType, EnumStoreType>::
 PostingListAttributeSubBase(AttributeVector &attr,
-                            EnumStore &enumStore)
-    : Parent(attr, enumStore),
+                            EnumStore &enumStore,
+                            std::shared_ptr<vespalib::alloc::MemoryAllocator> memory_allocator)
+    : Parent(attr, enumStore, std::move(memory_allocator)),
       _es(enumStore)
 {
 }
@@ -50,7 +50,8 @@ protected:
     AttributeVector &_attr;
     IEnumStoreDictionary& _dictionary;
 
-    PostingListAttributeBase(AttributeVector &attr, IEnumStore &enumStore);
+    PostingListAttributeBase(AttributeVector &attr, IEnumStore &enumStore,
+                             std::shared_ptr<vespalib::alloc::MemoryAllocator> memory_allocator);
     ~PostingListAttributeBase() override;
 
     virtual void updatePostings(PostingMap & changePost) = 0;
@@ -101,7 +102,8 @@ private:
     EnumStore &_es;
 
 public:
-    PostingListAttributeSubBase(AttributeVector &attr, EnumStore &enumStore);
+    PostingListAttributeSubBase(AttributeVector &attr, EnumStore &enumStore,
+                                std::shared_ptr<vespalib::alloc::MemoryAllocator> memory_allocator);
     ~PostingListAttributeSubBase() override;
 
     void handle_load_posting_lists(LoadedVector &loaded);
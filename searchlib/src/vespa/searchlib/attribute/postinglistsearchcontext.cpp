@@ -4,17 +4,36 @@
 #include "attributeiterators.hpp"
 #include "diversity.hpp"
 #include <vespa/vespalib/btree/btreeiterator.hpp>
+#include <atomic>
 
 namespace search::attribute {
 
 using vespalib::btree::BTreeNode;
 
+namespace {
+
+/*
+ * The generation is read before the dictionary is frozen, so the frozen
+ * dictionary is at least as new as the generation the filter cache uses.
+ */
+BitVectorFilterCache::generation_t
+acquire_generation(BitVectorFilterCache::generation_t generation)
+{
+    std::atomic_thread_fence(std::memory_order_acquire);
+    return generation;
+}
+
+}
+
 PostingListSearchContext::
 PostingListSearchContext(const IEnumStoreDictionary& dictionary, bool has_btree_dictionary, uint32_t docIdLimit,
-                         uint64_t numValues, bool hasWeight, bool useBitVector, const ISearchContext &baseSearchCtx)
+                         uint64_t numValues, bool hasWeight, bool useBitVector, const ISearchContext &baseSearchCtx,
+                         BitVectorFilterCache* filter_cache, generation_t generation)
     : _dictionary(dictionary),
       _baseSearchCtx(baseSearchCtx),
       _bv(nullptr),
+      _filter_cache(filter_cache),
+      _generation(acquire_generation(generation)),
       _frozenDictionary(has_btree_dictionary ? _dictionary.get_posting_dictionary().getFrozenView() : FrozenDictionary()),
       _lowerDictItr(has_btree_dictionary ? DictionaryConstIterator(BTreeNode::Ref(), _frozenDictionary.getAllocator()) : DictionaryConstIterator()),
       _upperDictItr(has_btree_dictionary ? DictionaryConstIterator(BTreeNode::Ref(), _frozenDictionary.getAllocator()) : DictionaryConstIterator()),
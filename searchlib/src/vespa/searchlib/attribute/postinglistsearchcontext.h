@@ -2,11 +2,13 @@
 
 #pragma once
 
+#include "bitvector_filter_cache.h"
 #include "enumstore.h"
 #include "postinglisttraits.h"
 #include "postingstore.h"
 #include "ipostinglistsearchcontext.h"
 #include "posting_list_merger.h"
+#include "range_bucket_index.h"
 #include <vespa/searchcommon/attribute/search_context_params.h>
 #include <vespa/searchcommon/common/range.h>
 #include <vespa/searchlib/query/query_term_ucs4.h>
@@ -15,6 +17,7 @@
 #include <vespa/vespalib/util/regexp.h>
 #include <regex>
 #include <optional>
+#include <type_traits>
 
 namespace search::attribute {
 
@@ -34,11 +37,14 @@ protected:
     using FrozenDictionary = Dictionary::FrozenView;
     using EntryRef = vespalib::datastore::EntryRef;
     using EnumIndex = IEnumStore::Index;
+    using generation_t = BitVectorFilterCache::generation_t;
     static constexpr uint32_t max_posting_lists_to_count = 1000;
 
     const IEnumStoreDictionary&   _dictionary;
     const ISearchContext&         _baseSearchCtx;
     const BitVector*              _bv; // bitvector if _useBitVector has been set
+    BitVectorFilterCache*         _filter_cache; // nullptr if disabled
+    generation_t                  _generation; // attribute generation when the dictionary was frozen
     const FrozenDictionary        _frozenDictionary;
     DictionaryConstIterator       _lowerDictItr;
     DictionaryConstIterator       _upperDictItr;
@@ -53,7 +59,8 @@ protected:
     mutable std::optional<size_t> _estimated_hits; // Snapshot of size of posting lists in range
 
     PostingListSearchContext(const IEnumStoreDictionary& dictionary, bool has_btree_dictionary, uint32_t docIdLimit,
-                             uint64_t numValues, bool hasWeight, bool useBitVector, const ISearchContext &baseSearchCtx);
+                             uint64_t numValues, bool hasWeight, bool useBitVector, const ISearchContext &baseSearchCtx,
+                             BitVectorFilterCache* filter_cache, generation_t generation);
 
     ~PostingListSearchContext() override;
 
@@ -74,6 +81,12 @@ protected:
     }
     virtual bool use_posting_lists_when_non_strict(const queryeval::ExecuteInfo& info) const = 0;
 
+    /**
+     * Returns the key used for the merged posting lists in the filter cache,
+     * or an empty string if they should not be cached.
+     */
+    virtual vespalib::string filter_cache_key() const { return {}; }
+
     /**
      * Calculates the estimated number of hits when _uniqueValues >= 2,
      * by looking at the posting lists in the range [lower, upper>.
@@ -100,15 +113,21 @@ protected:
      * Synthetic posting lists for range search, in array or bitvector form
      */
     PostingListMerger<DataT> _merger;
+    /*
+     * Synthetic posting lists for range search found compressed in the filter cache
+     */
+    BitVectorFilterCache::CompressedBitVectorSP _compressed_bv;
 
     PostingListSearchContextT(const IEnumStoreDictionary& dictionary, uint32_t docIdLimit, uint64_t numValues,
                               bool hasWeight, const PostingStore& posting_store,
-                              bool useBitVector, const ISearchContext &baseSearchCtx);
+                              bool useBitVector, const ISearchContext &baseSearchCtx,
+                              BitVectorFilterCache* filter_cache, generation_t generation);
     ~PostingListSearchContextT() override;
 
     void lookupSingle();
     virtual void fillArray();
     virtual void fillBitVector(const ExecuteInfo &);
+    void add_posting_list_to_bit_vector(EntryRef pidx);
 
     void fetchPostings(const ExecuteInfo & strict) override;
     // this will be called instead of the fetchPostings function in some cases
@@ -138,6 +157,7 @@ protected:
     using EntryRef = vespalib::datastore::EntryRef;
     using PostingStore = typename Parent::PostingStore;
     using ExecuteInfo = queryeval::ExecuteInfo;
+    using generation_t = typename Parent::generation_t;
     using Parent::_docIdLimit;
     using Parent::_lowerDictItr;
     using Parent::_merger;
@@ -152,7 +172,8 @@ protected:
 
     PostingListFoldedSearchContextT(const IEnumStoreDictionary& dictionary, uint32_t docIdLimit, uint64_t numValues,
                                     bool hasWeight, const PostingStore& posting_store,
-                                    bool useBitVector, const ISearchContext &baseSearchCtx);
+                                    bool useBitVector, const ISearchContext &baseSearchCtx,
+                                    BitVectorFilterCache* filter_cache, generation_t generation);
     ~PostingListFoldedSearchContextT() override;
 
     size_t calc_estimated_hits_in_range() const override;
@@ -195,6 +216,7 @@ private:
         return use_dictionary_entry(it);
     }
     bool use_posting_lists_when_non_strict(const ExecuteInfo& info) const override;
+    vespalib::string filter_cache_key() const override;
 public:
     StringPostingSearchContext(BaseSC&& base_sc, bool useBitVector, const AttrT &toBeSearched);
 };
@@ -238,6 +260,9 @@ private:
 
     bool use_posting_lists_when_non_strict(const ExecuteInfo& info) const override;
     size_t calc_estimated_hits_in_range() const override;
+    vespalib::string filter_cache_key() const override;
+    void fillBitVector(const ExecuteInfo & exec_info) override;
+    void fill_bit_vector_from_range_buckets(const RangeBucketIndex::Cover & cover);
 
 public:
     NumericPostingSearchContext(BaseSC&& base_sc, const Params & params, const AttrT &toBeSearched);
@@ -255,7 +280,9 @@ PostingSearchContext(BaseSC&& base_sc, bool useBitVector, const AttrT &toBeSearc
               toBeSearched.hasWeightedSetType(),
               toBeSearched.get_posting_store(),
               useBitVector,
-              *this),
+              *this,
+              toBeSearched.get_filter_cache(),
+              toBeSearched.getCurrentGeneration()),
       _toBeSearched(toBeSearched),
       _enumStore(_toBeSearched.getEnumStore())
 {
@@ -391,6 +418,59 @@ NumericPostingSearchContext<BaseSC, AttrT, DataT>::calc_estimated_hits_in_range(
     return exact_sum + estimated_sum;
 }
 
+template <typename BaseSC, typename AttrT, typename DataT>
+vespalib::string
+NumericPostingSearchContext<BaseSC, AttrT, DataT>::filter_cache_key() const
+{
+    // The range has been narrowed to the first and last dictionary values in it,
+    // so equivalent ranges share an entry.
+    vespalib::string key("n");
+    key.append(reinterpret_cast<const char *>(&_low), sizeof(_low));
+    key.append(reinterpret_cast<const char *>(&_high), sizeof(_high));
+    return key;
+}
+
+template <typename BaseSC, typename AttrT, typename DataT>
+void
+NumericPostingSearchContext<BaseSC, AttrT, DataT>::fillBitVector(const ExecuteInfo & exec_info)
+{
+    if constexpr (std::is_integral_v<BaseType>) {
+        const RangeBucketIndex *range_buckets = _toBeSearched.get_range_bucket_index();
+        if (range_buckets != nullptr && this->_lowerDictItr != this->_upperDictItr) {
+            // _low and _high have been narrowed to the first and last dictionary values in the range
+            auto cover = range_buckets->cover(_low, _high);
+            if (!cover.bit_vectors.empty()) {
+                fill_bit_vector_from_range_buckets(cover);
+                return;
+            }
+        }
+    }
+    PostingListSearchContextT<DataT>::fillBitVector(exec_info);
+}
+
+template <typename BaseSC, typename AttrT, typename DataT>
+void
+NumericPostingSearchContext<BaseSC, AttrT, DataT>::fill_bit_vector_from_range_buckets(const RangeBucketIndex::Cover & cover)
+{
+    BitVector &bv = *this->_merger.getBitVector();
+    for (const BitVector *bucket : cover.bit_vectors) {
+        bv.orWith(*bucket);
+    }
+    // Merge the posting lists of the values in the gaps between the buckets
+    auto it = this->_lowerDictItr;
+    for (const auto &gap : cover.gaps) {
+        if (it.valid() && int64_t(_enumStore.get_value(it.getKey().load_acquire())) < gap.first) {
+            auto comp = _enumStore.make_comparator(static_cast<BaseType>(gap.first));
+            it.seek(vespalib::datastore::AtomicEntryRef(), comp);
+        }
+        for (; it.valid() && it != this->_upperDictItr &&
+               int64_t(_enumStore.get_value(it.getKey().load_acquire())) <= gap.second; ++it)
+        {
+            this->add_posting_list_to_bit_vector(it.getData().load_acquire());
+        }
+    }
+}
+
 extern template class PostingListSearchContextT<vespalib::btree::BTreeNoLeafData>;
 extern template class PostingListSearchContextT<int32_t>;
 extern template class PostingListFoldedSearchContextT<vespalib::btree::BTreeNoLeafData>;
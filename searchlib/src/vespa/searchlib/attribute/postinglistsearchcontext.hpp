@@ -10,7 +10,9 @@
 #include "posting_list_traverser.h"
 #include <vespa/searchlib/queryeval/emptysearch.h>
 #include <vespa/searchlib/common/bitvectoriterator.h>
+#include <vespa/searchlib/common/compressedbitvectoriterator.h>
 #include <vespa/searchlib/common/growablebitvector.h>
+#include <vespa/vespalib/util/stringfmt.h>
 
 
 using search::queryeval::EmptySearch;
@@ -21,10 +23,13 @@ namespace search::attribute {
 template <typename DataT>
 PostingListSearchContextT<DataT>::
 PostingListSearchContextT(const IEnumStoreDictionary& dictionary, uint32_t docIdLimit, uint64_t numValues, bool hasWeight,
-                          const PostingStore& posting_store, bool useBitVector, const ISearchContext &searchContext)
-    : PostingListSearchContext(dictionary, dictionary.get_has_btree_dictionary(), docIdLimit, numValues, hasWeight, useBitVector, searchContext),
+                          const PostingStore& posting_store, bool useBitVector, const ISearchContext &searchContext,
+                          BitVectorFilterCache* filter_cache, generation_t generation)
+    : PostingListSearchContext(dictionary, dictionary.get_has_btree_dictionary(), docIdLimit, numValues, hasWeight, useBitVector, searchContext,
+                               filter_cache, generation),
       _posting_store(posting_store),
-      _merger(docIdLimit)
+      _merger(docIdLimit),
+      _compressed_bv()
 {
 }
 
@@ -66,6 +71,13 @@ PostingListSearchContextT<DataT>::fillArray()
     _merger.merge();
 }
 
+template <typename DataT>
+void
+PostingListSearchContextT<DataT>::add_posting_list_to_bit_vector(EntryRef pidx)
+{
+    _merger.addToBitVector(PostingListTraverser<PostingStore>(_posting_store, pidx));
+}
+
 template <typename DataT>
 struct PostingListSearchContextT<DataT>::FillPart : public vespalib::Runnable {
     FillPart(const vespalib::Doom & doom, const PostingStore& posting_store, const DictionaryConstIterator & from,
@@ -167,18 +179,34 @@ PostingListSearchContextT<DataT>::fetchPostings(const ExecuteInfo & exec_info)
     //
     // The threshold for when to use array merging is therefore 0.0025 (0.08 / 32).
     constexpr float threshold_for_using_array = 0.0025;
-    if (!_merger.merge_done() && _uniqueValues >= 2u && this->_dictionary.get_has_btree_dictionary()) {
+    if (!_merger.merge_done() && !_compressed_bv && _uniqueValues >= 2u && this->_dictionary.get_has_btree_dictionary()) {
         if (exec_info.is_strict() || use_posting_lists_when_non_strict(exec_info)) {
+            vespalib::string cache_key = (_filter_cache != nullptr) ? filter_cache_key() : vespalib::string();
+            if (!cache_key.empty()) {
+                auto cached = _filter_cache->find(cache_key, _generation, _docIdLimit);
+                if (cached.bit_vector) {
+                    _merger.setBitVector(std::move(cached.bit_vector));
+                    return;
+                }
+                if (cached.compressed) {
+                    _compressed_bv = std::move(cached.compressed);
+                    return;
+                }
+            }
             size_t sum = estimated_hits_in_range();
             //TODO Honour soft_doom and forward it to merge code
             if (sum < (_docIdLimit * threshold_for_using_array)) {
                 _merger.reserveArray(_uniqueValues, sum);
                 fillArray();
+                _merger.merge();
             } else {
                 _merger.allocBitVector();
                 fillBitVector(exec_info);
+                _merger.merge();
+                if (!cache_key.empty()) {
+                    _filter_cache->insert(cache_key, _generation, _docIdLimit, sum, _merger.getBitVectorSP());
+                }
             }
-            _merger.merge();
         }
     }
 }
@@ -211,6 +239,9 @@ createPostingIterator(fef::TermFieldMatchData *matchData, bool strict)
     if (_uniqueValues == 0u) {
         return std::make_unique<EmptySearch>();
     }
+    if (_compressed_bv) {
+        return CompressedBitVectorIterator::create(_compressed_bv.get(), _docIdLimit, *matchData, strict);
+    }
     if (_merger.hasArray() || _merger.hasBitVector()) { // synthetic results are available
         if (!_merger.emptyArray()) {
             assert(_merger.hasArray());
@@ -348,8 +379,10 @@ template <typename DataT>
 PostingListFoldedSearchContextT<DataT>::
 PostingListFoldedSearchContextT(const IEnumStoreDictionary& dictionary, uint32_t docIdLimit, uint64_t numValues,
                                 bool hasWeight, const PostingStore& posting_store,
-                                bool useBitVector, const ISearchContext &searchContext)
-    : Parent(dictionary, docIdLimit, numValues, hasWeight, posting_store, useBitVector, searchContext),
+                                bool useBitVector, const ISearchContext &searchContext,
+                                BitVectorFilterCache* filter_cache, generation_t generation)
+    : Parent(dictionary, docIdLimit, numValues, hasWeight, posting_store, useBitVector, searchContext,
+             filter_cache, generation),
       _resume_scan_itr(),
       _posting_indexes()
 {
@@ -473,12 +506,7 @@ template <typename BaseSC, typename AttrT, typename DataT>
 bool
 StringPostingSearchContext<BaseSC, AttrT, DataT>::use_dictionary_entry(PostingListSearchContext::DictionaryConstIterator& it) const {
     if ( this->isRegex() ) {
-        if (this->getRegex().valid() &&
-            this->getRegex().partial_match(_enumStore.get_value(it.getKey().load_acquire()))) {
-            return true;
-        }
-        ++it;
-        return false;
+        return this->is_regex_match(_enumStore.get_value(it.getKey().load_acquire()), it, _enumStore.get_data_store());
     } else if ( this->isCased() ) {
         if (this->match(_enumStore.get_value(it.getKey().load_acquire()))) {
             return true;
@@ -491,6 +519,25 @@ StringPostingSearchContext<BaseSC, AttrT, DataT>::use_dictionary_entry(PostingLi
     return true;
 }
 
+template <typename BaseSC, typename AttrT, typename DataT>
+vespalib::string
+StringPostingSearchContext<BaseSC, AttrT, DataT>::filter_cache_key() const
+{
+    const auto &term = *this->queryTerm();
+    vespalib::string key;
+    if (this->isPrefix()) {
+        key = "p";
+    } else if (this->isRegex()) {
+        key = "r";
+    } else if (this->isFuzzy()) {
+        key = vespalib::make_string("f%zu,%zu,", term.getFuzzyMaxEditDistance(), term.getFuzzyPrefixLength());
+    } else {
+        key = "w";
+    }
+    key.append(term.getTerm());
+    return key;
+}
+
 template <typename BaseSC, typename AttrT, typename DataT>
 bool
 StringPostingSearchContext<BaseSC, AttrT, DataT>::use_posting_lists_when_non_strict(const ExecuteInfo& info) const
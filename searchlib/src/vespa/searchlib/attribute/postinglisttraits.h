@@ -13,7 +13,7 @@ template <>
 class PostingListTraits<vespalib::btree::BTreeNoLeafData>
 {
 private:
-    using BTreeTraits = vespalib::btree::BTreeTraits<64, 16, 8, true>;
+    using BTreeTraits = vespalib::btree::BTreeTraits<64, 16, 8, true, true>;
 public:
     using AggregatedType = vespalib::btree::NoAggregated;
     using AggrCalcType = vespalib::btree::NoAggrCalc;
@@ -27,7 +27,7 @@ template <>
 class PostingListTraits<int32_t>
 {
 private:
-    using BTreeTraits = vespalib::btree::BTreeTraits<32, 16, 9, true>;
+    using BTreeTraits = vespalib::btree::BTreeTraits<32, 16, 9, true, true>;
 public:
     using AggregatedType = vespalib::btree::MinMaxAggregated;
     using AggrCalcType = vespalib::btree::MinMaxAggrCalc;
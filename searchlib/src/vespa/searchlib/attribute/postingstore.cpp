@@ -59,7 +59,14 @@ PostingStoreBase2::resizeBitVectors(uint32_t newSize, uint32_t newCapacity)
 
 template <typename DataT>
 PostingStore<DataT>::PostingStore(IEnumStoreDictionary& dictionary, Status &status, const Config &config)
-    : Parent(false),
+    : PostingStore(dictionary, status, config, {})
+{
+}
+
+template <typename DataT>
+PostingStore<DataT>::PostingStore(IEnumStoreDictionary& dictionary, Status &status, const Config &config,
+                                  std::shared_ptr<vespalib::alloc::MemoryAllocator> memory_allocator)
+    : Parent(false, std::move(memory_allocator)),
       PostingStoreBase2(dictionary, status, config),
       _bvType(1, 1024u, RefType::offsetSize())
 {
@@ -338,6 +345,37 @@ PostingStore<DataT>::apply(BitVector &bv, AddIter a, AddIter ae, RemoveIter r, R
 template <typename DataT>
 void
 PostingStore<DataT>::apply(EntryRef &ref, AddIter a, AddIter ae, RemoveIter r, RemoveIter re)
+{
+    applyChanges(ref, a, ae, r, re, false);
+}
+
+
+template <typename DataT>
+void
+PostingStore<DataT>::bulk_merge(EntryRef &ref, AddIter a, AddIter ae, RemoveIter r, RemoveIter re)
+{
+    if (a == ae && r == re) {
+        return;
+    }
+    applyChanges(ref, a, ae, r, re, true);
+}
+
+
+template <typename DataT>
+void
+PostingStore<DataT>::applyTreeChanges(BTreeType *tree, AddIter a, AddIter ae, RemoveIter r, RemoveIter re, bool bulk)
+{
+    if (bulk) {
+        applyBuildTree(tree, a, ae, r, re, CompareT());
+    } else {
+        applyTree(tree, a, ae, r, re, CompareT());
+    }
+}
+
+
+template <typename DataT>
+void
+PostingStore<DataT>::applyChanges(EntryRef &ref, AddIter a, AddIter ae, RemoveIter r, RemoveIter re, bool bulk)
 {
     if (!ref.valid()) {
         // No old data
@@ -364,7 +402,7 @@ PostingStore<DataT>::apply(EntryRef &ref, AddIter a, AddIter ae, RemoveIter r, R
         if (iRef2.valid()) {
             assert(isBTree(iRef2));
             BTreeType *tree = getWTreeEntry(iRef2);
-            applyTree(tree, a, ae, r, re, CompareT());
+            applyTreeChanges(tree, a, ae, r, re, bulk);
         }
         BitVector *bv = &bve->_bv->writer();
         assert(bv);
@@ -384,7 +422,7 @@ PostingStore<DataT>::apply(EntryRef &ref, AddIter a, AddIter ae, RemoveIter r, R
         }
     } else {
         BTreeType *tree = getWTreeEntry(iRef);
-        applyTree(tree, a, ae, r, re, CompareT());
+        applyTreeChanges(tree, a, ae, r, re, bulk);
         uint32_t docFreq = tree->size(_allocator);
         if (docFreq >= _maxBvDocFreq) {
             makeBitVector(ref);
@@ -89,6 +89,7 @@ public:
     using Parent::applyNewTree;
     using Parent::applyCluster;
     using Parent::applyTree;
+    using Parent::applyBuildTree;
     using Parent::normalizeTree;
     using Parent::getTypeId;
     using Parent::getClusterSize;
@@ -109,6 +110,8 @@ public:
 
 
     PostingStore(IEnumStoreDictionary& dictionary, Status &status, const Config &config);
+    PostingStore(IEnumStoreDictionary& dictionary, Status &status, const Config &config,
+                 std::shared_ptr<vespalib::alloc::MemoryAllocator> memory_allocator);
     ~PostingStore();
 
     bool removeSparseBitVectors() override;
@@ -144,6 +147,13 @@ public:
      * Overlap between additions and removals indicates updates.
      */
     void apply(EntryRef &ref, AddIter a, AddIter ae, RemoveIter r, RemoveIter re);
+
+    /**
+     * Apply multiple changes at once, rebuilding the btree part of the
+     * posting list with full nodes instead of inserting and removing
+     * entries one by one. Used for bulk load and large change batches.
+     */
+    void bulk_merge(EntryRef &ref, AddIter a, AddIter ae, RemoveIter r, RemoveIter re);
     void clear(const EntryRef ref);
     size_t size(const EntryRef ref) const {
         if (!ref.valid())
@@ -209,6 +219,8 @@ public:
     bool consider_compact_worst_btree_nodes(const CompactionStrategy& compaction_strategy);
     bool consider_compact_worst_buffers(const CompactionStrategy& compaction_strategy);
 private:
+    void applyChanges(EntryRef &ref, AddIter a, AddIter ae, RemoveIter r, RemoveIter re, bool bulk);
+    void applyTreeChanges(BTreeType *tree, AddIter a, AddIter ae, RemoveIter r, RemoveIter re, bool bulk);
     size_t internalSize(uint32_t typeId, const RefType & iRef) const;
     size_t internalFrozenSize(uint32_t typeId, const RefType & iRef) const;
 };
@@ -0,0 +1,386 @@
+// Copyright Vespa.ai. Licensed under the terms of the Apache 2.0 license. See LICENSE in the project root.
+
+#include "range_bucket_index.h"
+#include <vespa/searchlib/common/growablebitvector.h>
+#include <vespa/vespalib/stllike/hash_map.hpp>
+#include <algorithm>
+#include <cassert>
+
+using vespalib::GenerationHeldBase;
+
+namespace search::attribute {
+
+namespace {
+
+struct HeldBitVector : public GenerationHeldBase {
+    std::unique_ptr<GrowableBitVector> bit_vector;
+    explicit HeldBitVector(std::unique_ptr<GrowableBitVector> bit_vector_in)
+        : GenerationHeldBase(sizeof(GrowableBitVector) + bit_vector_in->extraByteSize()),
+          bit_vector(std::move(bit_vector_in))
+    {}
+};
+
+template <typename SnapshotT>
+struct HeldSnapshot : public GenerationHeldBase {
+    std::unique_ptr<SnapshotT> snapshot;
+    HeldSnapshot(std::unique_ptr<SnapshotT> snapshot_in, size_t byte_size)
+        : GenerationHeldBase(byte_size),
+          snapshot(std::move(snapshot_in))
+    {}
+};
+
+}
+
+RangeBucketIndex::Cover::Cover() = default;
+RangeBucketIndex::Cover::~Cover() = default;
+
+RangeBucketIndex::WriterLevel::WriterLevel(uint32_t shift_in, int64_t excluded_id_in)
+    : shift(shift_in),
+      excluded_id(excluded_id_in),
+      counts(),
+      bit_vectors(),
+      dirty()
+{
+}
+
+RangeBucketIndex::WriterLevel::WriterLevel(WriterLevel &&) noexcept = default;
+RangeBucketIndex::WriterLevel::~WriterLevel() = default;
+
+RangeBucketIndex::RangeBucketIndex(uint32_t bucket_bits, uint32_t num_levels, int64_t default_value,
+                                   vespalib::GenerationHolder &gen_holder)
+    : _bucket_bits(std::min(bucket_bits, max_shift)),
+      _default_value(default_value),
+      _levels(),
+      _snapshot(),
+      _published(nullptr),
+      _gen_holder(gen_holder),
+      _size(0),
+      _capacity(0),
+      _min_bv_docs(64u),
+      _max_bv_docs(128u)
+{
+    for (uint32_t level = 0; level < num_levels; ++level) {
+        uint32_t shift = _bucket_bits + level * level_bits;
+        if (shift > max_shift) {
+            break;
+        }
+        _levels.emplace_back(shift, default_value >> shift);
+    }
+    _snapshot = std::make_unique<Snapshot>(_levels.size());
+    _published.store(_snapshot.get(), std::memory_order_release);
+}
+
+RangeBucketIndex::~RangeBucketIndex() = default;
+
+bool
+RangeBucketIndex::resize(uint32_t new_size, uint32_t new_capacity)
+{
+    assert(new_capacity >= new_size);
+    new_size = (new_size + 63) & ~63;
+    if (new_size >= new_capacity) {
+        new_size = new_capacity;
+    }
+    if (new_size == _size && new_capacity == _capacity) {
+        return false;
+    }
+    uint32_t old_max_bv_docs = _max_bv_docs;
+    _min_bv_docs = std::max(new_size >> 7, 64u);
+    _max_bv_docs = std::max(new_size >> 6, 128u);
+    _size = new_size;
+    _capacity = new_capacity;
+    bool res = false;
+    for (auto &level : _levels) {
+        for (auto &entry : level.bit_vectors) {
+            GrowableBitVector &bv = *entry.second;
+            if (bv.writer().size() > _size) {
+                bv.shrink(_size);
+                res = true;
+            }
+            if (bv.writer().capacity() < _capacity) {
+                bv.reserve(_capacity);
+                res = true;
+            }
+            if (bv.writer().size() < _size) {
+                bv.extend(_size);
+            }
+            auto count_itr = level.counts.find(entry.first);
+            if (count_itr == level.counts.end() || count_itr->second < _min_bv_docs) {
+                level.dirty.push_back(entry.first);
+            }
+        }
+        if (_max_bv_docs < old_max_bv_docs) {
+            for (const auto &entry : level.counts) {
+                if (entry.second >= _max_bv_docs && entry.second < old_max_bv_docs) {
+                    level.dirty.push_back(entry.first);
+                }
+            }
+        }
+    }
+    return res;
+}
+
+void
+RangeBucketIndex::update_count(WriterLevel &level, int64_t id, bool add)
+{
+    // Only buckets crossing a threshold are marked dirty, resize() handles threshold changes
+    auto itr = level.counts.find(id);
+    if (add) {
+        uint32_t docs = 1;
+        if (itr == level.counts.end()) {
+            level.counts.insert(std::make_pair(id, docs));
+        } else {
+            docs = ++itr->second;
+        }
+        if (docs == _max_bv_docs && wants_bit_vector(level, id, docs)) {
+            level.dirty.push_back(id);
+        }
+    } else {
+        assert(itr != level.counts.end() && itr->second > 0);
+        uint32_t docs = --itr->second;
+        if (docs == 0) {
+            level.counts.erase(id);
+        }
+        if (docs + 1 == _min_bv_docs) {
+            level.dirty.push_back(id);
+        }
+    }
+}
+
+void
+RangeBucketIndex::move(uint32_t docid, const int64_t *old_value, const int64_t *new_value)
+{
+    if (old_value != nullptr && *old_value == _default_value) {
+        old_value = nullptr;
+    }
+    if (new_value != nullptr && *new_value == _default_value) {
+        new_value = nullptr;
+    }
+    for (auto &level : _levels) {
+        if (old_value != nullptr && new_value != nullptr && (*old_value >> level.shift) == (*new_value >> level.shift)) {
+            // Same bucket on this and all levels above
+            break;
+        }
+        if (old_value != nullptr) {
+            int64_t id = *old_value >> level.shift;
+            auto itr = level.bit_vectors.find(id);
+            if (itr != level.bit_vectors.end()) {
+                itr->second->writer().clearBitAndMaintainCount(docid);
+            }
+            update_count(level, id, false);
+        }
+        if (new_value != nullptr) {
+            int64_t id = *new_value >> level.shift;
+            auto itr = level.bit_vectors.find(id);
+            if (itr != level.bit_vectors.end()) {
+                itr->second->writer().setBitAndMaintainCount(docid);
+            }
+            update_count(level, id, true);
+        }
+    }
+}
+
+void
+RangeBucketIndex::hold_bit_vector(std::unique_ptr<GrowableBitVector> bit_vector)
+{
+    _gen_holder.insert(std::make_unique<HeldBitVector>(std::move(bit_vector)));
+}
+
+void
+RangeBucketIndex::publish()
+{
+    auto snapshot = std::make_unique<Snapshot>(_levels.size());
+    for (size_t i = 0; i < _levels.size(); ++i) {
+        auto &level = (*snapshot)[i];
+        for (const auto &entry : _levels[i].bit_vectors) {
+            level.ids.push_back(entry.first);
+            level.bit_vectors.push_back(entry.second.get());
+        }
+    }
+    _published.store(snapshot.get(), std::memory_order_release);
+    size_t held_bytes = sizeof(Snapshot);
+    for (const auto &level : *_snapshot) {
+        held_bytes += sizeof(Level) + level.ids.capacity() * (sizeof(int64_t) + sizeof(const GrowableBitVector *));
+    }
+    _gen_holder.insert(std::make_unique<HeldSnapshot<Snapshot>>(std::move(_snapshot), held_bytes));
+    _snapshot = std::move(snapshot);
+}
+
+bool
+RangeBucketIndex::apply_dirty(uint32_t num_docs, const GetValue &get_value)
+{
+    bool changed = false;
+    std::vector<std::vector<std::pair<int64_t, BitVector *>>> filling(_levels.size());
+    bool need_fill = false;
+    for (size_t i = 0; i < _levels.size(); ++i) {
+        auto &level = _levels[i];
+        std::sort(level.dirty.begin(), level.dirty.end());
+        level.dirty.erase(std::unique(level.dirty.begin(), level.dirty.end()), level.dirty.end());
+        for (int64_t id : level.dirty) {
+            auto count_itr = level.counts.find(id);
+            uint32_t docs = (count_itr != level.counts.end()) ? count_itr->second : 0u;
+            auto bv_itr = level.bit_vectors.find(id);
+            if (bv_itr == level.bit_vectors.end()) {
+                if (wants_bit_vector(level, id, docs)) {
+                    auto bv = std::make_unique<GrowableBitVector>(_size, _capacity, _gen_holder);
+                    filling[i].emplace_back(id, &bv->writer());
+                    level.bit_vectors.emplace(id, std::move(bv));
+                    need_fill = true;
+                }
+            } else if (docs < _min_bv_docs) {
+                hold_bit_vector(std::move(bv_itr->second));
+                level.bit_vectors.erase(bv_itr);
+                changed = true;
+            }
+        }
+        level.dirty.clear();
+    }
+    if (need_fill) {
+        assert(num_docs <= _size);
+        int64_t value = 0;
+        for (uint32_t docid = 0; docid < num_docs; ++docid) {
+            if (!get_value(docid, value) || value == _default_value) {
+                continue;
+            }
+            for (size_t i = 0; i < _levels.size(); ++i) {
+                const auto &level_filling = filling[i];
+                if (level_filling.empty()) {
+                    continue;
+                }
+                int64_t id = value >> _levels[i].shift;
+                auto itr = std::lower_bound(level_filling.begin(), level_filling.end(), id,
+                                            [](const auto &entry, int64_t key) { return entry.first < key; });
+                if (itr != level_filling.end() && itr->first == id) {
+                    itr->second->setBit(docid);
+                }
+            }
+        }
+        for (auto &level_filling : filling) {
+            for (auto &entry : level_filling) {
+                entry.second->invalidateCachedCount();
+            }
+        }
+        changed = true;
+    }
+    return changed;
+}
+
+void
+RangeBucketIndex::commit(uint32_t num_docs, const GetValue &get_value)
+{
+    if (apply_dirty(num_docs, get_value)) {
+        publish();
+    }
+}
+
+void
+RangeBucketIndex::rebuild(uint32_t num_docs, const GetValue &get_value)
+{
+    for (auto &level : _levels) {
+        for (auto &entry : level.bit_vectors) {
+            hold_bit_vector(std::move(entry.second));
+        }
+        level.bit_vectors.clear();
+        level.counts.clear();
+        level.dirty.clear();
+    }
+    int64_t value = 0;
+    for (uint32_t docid = 0; docid < num_docs; ++docid) {
+        if (get_value(docid, value) && value != _default_value) {
+            for (auto &level : _levels) {
+                ++level.counts[value >> level.shift];
+            }
+        }
+    }
+    for (auto &level : _levels) {
+        for (const auto &entry : level.counts) {
+            if (wants_bit_vector(level, entry.first, entry.second)) {
+                level.dirty.push_back(entry.first);
+            }
+        }
+    }
+    apply_dirty(num_docs, get_value);
+    publish();
+}
+
+void
+RangeBucketIndex::add_gap(Cover &cover, int64_t lo, int64_t hi)
+{
+    if (!cover.gaps.empty() && cover.gaps.back().second + 1 == lo) {
+        cover.gaps.back().second = hi;
+    } else {
+        cover.gaps.emplace_back(lo, hi);
+    }
+}
+
+void
+RangeBucketIndex::cover_range(const Snapshot &snapshot, int32_t level_idx, int64_t lo, int64_t hi, Cover &cover) const
+{
+    if (level_idx < 0) {
+        add_gap(cover, lo, hi);
+        return;
+    }
+    const Level &level = snapshot[level_idx];
+    uint32_t shift = _bucket_bits + level_idx * level_bits;
+    // First and last bucket fully inside [lo, hi]
+    int64_t first = lo >> shift;
+    int64_t last = hi >> shift;
+    if (bucket_start(first, shift) < lo) {
+        ++first;
+    }
+    if (bucket_end(last, shift) > hi) {
+        --last;
+    }
+    auto itr = std::lower_bound(level.ids.begin(), level.ids.end(), first);
+    if (first > last || itr == level.ids.end() || *itr > last) {
+        cover_range(snapshot, level_idx - 1, lo, hi, cover);
+        return;
+    }
+    if (lo < bucket_start(first, shift)) {
+        cover_range(snapshot, level_idx - 1, lo, bucket_start(first, shift) - 1, cover);
+    }
+    int64_t next = first; // first bucket not covered yet, unless done
+    bool done = false;
+    for (; itr != level.ids.end() && *itr <= last; ++itr) {
+        if (*itr > next) {
+            cover_range(snapshot, level_idx - 1, bucket_start(next, shift), bucket_start(*itr, shift) - 1, cover);
+        }
+        cover.bit_vectors.push_back(&level.bit_vectors[itr - level.ids.begin()]->reader());
+        done = (*itr == last);
+        next = done ? last : (*itr + 1);
+    }
+    if (!done) {
+        cover_range(snapshot, level_idx - 1, bucket_start(next, shift), bucket_end(last, shift), cover);
+    }
+    if (bucket_end(last, shift) < hi) {
+        cover_range(snapshot, level_idx - 1, bucket_end(last, shift) + 1, hi, cover);
+    }
+}
+
+RangeBucketIndex::Cover
+RangeBucketIndex::cover(int64_t lo, int64_t hi) const
+{
+    Cover result;
+    const Snapshot *snapshot = _published.load(std::memory_order_acquire);
+    if (lo <= hi) {
+        cover_range(*snapshot, int32_t(snapshot->size()) - 1, lo, hi, result);
+    }
+    return result;
+}
+
+vespalib::MemoryUsage
+RangeBucketIndex::get_memory_usage() const
+{
+    vespalib::MemoryUsage usage;
+    for (const auto &level : _levels) {
+        usage.incAllocatedBytes(level.counts.getMemoryConsumption());
+        usage.incUsedBytes(level.counts.getMemoryUsed());
+        for (const auto &entry : level.bit_vectors) {
+            size_t bytes = sizeof(GrowableBitVector) + entry.second->extraByteSize();
+            usage.incAllocatedBytes(bytes);
+            usage.incUsedBytes(bytes);
+        }
+    }
+    return usage;
+}
+
+}
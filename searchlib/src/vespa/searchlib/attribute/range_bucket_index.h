@@ -0,0 +1,151 @@
+// Copyright Vespa.ai. Licensed under the terms of the Apache 2.0 license. See LICENSE in the project root.
+
+#pragma once
+
+#include <vespa/vespalib/stllike/hash_map.h>
+#include <vespa/vespalib/util/generationholder.h>
+#include <vespa/vespalib/util/memoryusage.h>
+#include <atomic>
+#include <functional>
+#include <map>
+#include <memory>
+#include <utility>
+#include <vector>
+
+namespace search {
+
+class BitVector;
+class GrowableBitVector;
+
+}
+
+namespace search::attribute {
+
+/**
+ * Multilevel index of bit vectors over power-of-two sized value buckets of a
+ * single value integer attribute with fast-search, used by range terms that
+ * cover many distinct values (e.g. time windows over timestamps) to avoid
+ * merging the posting list of every value in the range.
+ *
+ * Level 0 buckets span 2^bucket_bits values, and each level above spans 16
+ * buckets of the level below. The number of documents in each bucket is
+ * maintained incrementally as values change. Like posting lists in the
+ * posting store, a bucket gets a bit vector when it holds at least 1/64 of
+ * the documents and drops it when below 1/128, so there are at most 128 bit
+ * vectors per level. Documents with the default (undefined) value are not
+ * indexed, and buckets containing that value never get bit vectors.
+ *
+ * A range is covered by the bit vectors of the largest buckets inside it.
+ * The remaining gaps (at the ends of the range and over sparse buckets) must
+ * be filled by the caller from the posting lists of the values in them.
+ *
+ * Bit vectors are updated in place by the writer, like posting list bit
+ * vectors. The set of bit vectors seen by readers is an immutable snapshot
+ * that is replaced when buckets get or drop bit vectors; old snapshots and
+ * dropped bit vectors are held until no reader can access them.
+ */
+class RangeBucketIndex {
+public:
+    static constexpr uint32_t level_bits = 4;
+    static constexpr uint32_t max_shift = 60;
+    // Returns false if the document has no value
+    using GetValue = std::function<bool(uint32_t docid, int64_t &value)>;
+    using ValueRange = std::pair<int64_t, int64_t>;
+
+    /**
+     * Bucket bit vectors and gaps (inclusive value ranges, in increasing
+     * order) that together cover a value range.
+     */
+    struct Cover {
+        std::vector<const BitVector *> bit_vectors;
+        std::vector<ValueRange>        gaps;
+        Cover();
+        ~Cover();
+    };
+
+private:
+    struct Level {
+        std::vector<int64_t>                  ids;
+        std::vector<const GrowableBitVector*> bit_vectors;
+    };
+    using Snapshot = std::vector<Level>;
+    using BucketCounts = vespalib::hash_map<int64_t, uint32_t>;
+    using BucketBitVectors = std::map<int64_t, std::unique_ptr<GrowableBitVector>>;
+    struct WriterLevel {
+        uint32_t         shift;
+        int64_t          excluded_id; // bucket containing the default value
+        BucketCounts     counts;
+        BucketBitVectors bit_vectors;
+        std::vector<int64_t> dirty;   // buckets that may need to get or drop a bit vector
+        WriterLevel(uint32_t shift_in, int64_t excluded_id_in);
+        WriterLevel(WriterLevel &&) noexcept;
+        ~WriterLevel();
+    };
+
+    uint32_t                      _bucket_bits;
+    int64_t                       _default_value;
+    std::vector<WriterLevel>      _levels;
+    std::unique_ptr<Snapshot>     _snapshot;
+    std::atomic<const Snapshot *> _published;
+    vespalib::GenerationHolder   &_gen_holder;
+    uint32_t                      _size;
+    uint32_t                      _capacity;
+    uint32_t                      _min_bv_docs;
+    uint32_t                      _max_bv_docs;
+
+    static int64_t bucket_start(int64_t id, uint32_t shift) noexcept { return int64_t(uint64_t(id) << shift); }
+    static int64_t bucket_end(int64_t id, uint32_t shift) noexcept {
+        return int64_t((uint64_t(id) << shift) | ((uint64_t(1) << shift) - 1));
+    }
+    bool wants_bit_vector(const WriterLevel &level, int64_t id, uint32_t docs) const noexcept {
+        return (id != level.excluded_id) && (docs >= _max_bv_docs);
+    }
+    void update_count(WriterLevel &level, int64_t id, bool add);
+    void hold_bit_vector(std::unique_ptr<GrowableBitVector> bit_vector);
+    bool apply_dirty(uint32_t num_docs, const GetValue &get_value);
+    void publish();
+    void cover_range(const Snapshot &snapshot, int32_t level, int64_t lo, int64_t hi, Cover &cover) const;
+    static void add_gap(Cover &cover, int64_t lo, int64_t hi);
+public:
+    RangeBucketIndex(uint32_t bucket_bits, uint32_t num_levels, int64_t default_value,
+                     vespalib::GenerationHolder &gen_holder);
+    RangeBucketIndex(const RangeBucketIndex &) = delete;
+    RangeBucketIndex & operator=(const RangeBucketIndex &) = delete;
+    ~RangeBucketIndex();
+
+    uint32_t num_levels() const noexcept { return _levels.size(); }
+    uint32_t bucket_bits() const noexcept { return _bucket_bits; }
+
+    /**
+     * Resize bit vectors to follow the docid limit, as done for posting list
+     * bit vectors. Returns true if memory was put on hold.
+     */
+    bool resize(uint32_t new_size, uint32_t new_capacity);
+
+    /**
+     * Move the document from the old to the new value. The old value must be
+     * the one previously added for the document. Bit vectors of buckets are
+     * updated in place, while buckets that get or drop bit vectors are not
+     * visible until commit.
+     */
+    void move(uint32_t docid, const int64_t *old_value, const int64_t *new_value);
+
+    /**
+     * Create and drop bit vectors for buckets changed since the last commit
+     * and publish them to readers. New bit vectors are filled by scanning the
+     * values of all documents below num_docs.
+     */
+    void commit(uint32_t num_docs, const GetValue &get_value);
+
+    // Drop all state and index the values of all documents below num_docs.
+    void rebuild(uint32_t num_docs, const GetValue &get_value);
+
+    /**
+     * Cover the inclusive value range [lo, hi] with bucket bit vectors, as
+     * seen by a reader holding a generation guard.
+     */
+    Cover cover(int64_t lo, int64_t hi) const;
+    vespalib::MemoryUsage get_memory_usage() const;
+};
+
+}
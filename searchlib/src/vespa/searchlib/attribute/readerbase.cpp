@@ -74,6 +74,12 @@ ReaderBase::ReaderBase(AttributeVector &attr)
 
 ReaderBase::~ReaderBase() = default;
 
+vespalib::string
+ReaderBase::getDatFileName() const
+{
+    return _datFile.file().GetFileName();
+}
+
 size_t
 ReaderBase::getEnumCount() const {
     size_t dataSize = _datFile.data_size();
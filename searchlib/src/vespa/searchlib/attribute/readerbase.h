@@ -38,6 +38,8 @@ public:
     const vespalib::GenericHeader &getDatHeader() const {
         return _datFile.header();
     }
+    uint64_t getDatHeaderLen() const { return _datFile.header_len(); }
+    vespalib::string getDatFileName() const;
 protected:
     FileWithHeader _datFile;
 private:
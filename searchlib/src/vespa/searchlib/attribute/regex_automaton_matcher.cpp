@@ -0,0 +1,51 @@
+// Copyright Vespa.ai. Licensed under the terms of the Apache 2.0 license. See LICENSE in the project root.
+
+#include "regex_automaton_matcher.h"
+#include "i_enum_store_dictionary.h"
+#include <cassert>
+
+using vespalib::RegexAutomaton;
+
+namespace search::attribute {
+
+RegexAutomatonMatcher::RegexAutomatonMatcher(RegexAutomaton automaton, bool cased)
+    : _automaton(std::move(automaton)),
+      _successor(),
+      _cased(cased)
+{
+}
+
+RegexAutomatonMatcher::~RegexAutomatonMatcher() = default;
+
+std::unique_ptr<RegexAutomatonMatcher>
+RegexAutomatonMatcher::make(std::string_view pattern, bool cased)
+{
+    auto automaton = RegexAutomaton::build(pattern, cased ? RegexAutomaton::Casing::Cased : RegexAutomaton::Casing::Uncased);
+    if (!automaton.valid()) {
+        return {};
+    }
+    return std::make_unique<RegexAutomatonMatcher>(std::move(automaton), cased);
+}
+
+template <typename DictionaryConstIteratorType>
+void
+RegexAutomatonMatcher::skip_non_match(const char* word, DictionaryConstIteratorType& itr, const DfaStringComparator::DataStoreType& data_store)
+{
+    if (_automaton.is_viable_prefix(word, _successor)) {
+        ++itr;
+        return;
+    }
+    DfaStringComparator cmp(data_store, _successor, _cased);
+    assert(cmp.less(itr.getKey().load_acquire(), vespalib::datastore::EntryRef()));
+    itr.seek(vespalib::datastore::AtomicEntryRef(), cmp);
+}
+
+template
+void
+RegexAutomatonMatcher::skip_non_match(const char* word, EnumPostingTree::ConstIterator& itr, const DfaStringComparator::DataStoreType& data_store);
+
+template
+void
+RegexAutomatonMatcher::skip_non_match(const char* word, EnumTree::ConstIterator& itr, const DfaStringComparator::DataStoreType& data_store);
+
+}
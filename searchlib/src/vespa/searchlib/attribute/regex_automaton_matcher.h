@@ -0,0 +1,44 @@
+// Copyright Vespa.ai. Licensed under the terms of the Apache 2.0 license. See LICENSE in the project root.
+
+#pragma once
+
+#include "dfa_string_comparator.h"
+#include <vespa/vespalib/regex/regex_automaton.h>
+#include <memory>
+#include <string_view>
+
+namespace search::attribute {
+
+/**
+ * Class that uses a RegexAutomaton to skip words in a dictionary that cannot
+ * be matched by a start-anchored regular expression.
+ *
+ * The dictionary iterator is advanced based on the successor string from the
+ * automaton each time the candidate word is _not_ a match, pruning whole
+ * subranges of the dictionary instead of evaluating the regex for every word.
+ */
+class RegexAutomatonMatcher {
+private:
+    vespalib::RegexAutomaton _automaton;
+    std::vector<uint32_t>    _successor;
+    bool                     _cased;
+
+public:
+    RegexAutomatonMatcher(vespalib::RegexAutomaton automaton, bool cased);
+    ~RegexAutomatonMatcher();
+
+    /*
+     * Returns a matcher for the regex pattern, or nullptr if the pattern
+     * does not allow skipping words (e.g. it is not start-anchored).
+     */
+    static std::unique_ptr<RegexAutomatonMatcher> make(std::string_view pattern, bool cased);
+
+    /*
+     * Advances the iterator past the word it is positioned at, which must
+     * not be a match, and past following words that cannot be a match.
+     */
+    template <typename DictionaryConstIteratorType>
+    void skip_non_match(const char* word, DictionaryConstIteratorType& itr, const DfaStringComparator::DataStoreType& data_store);
+};
+
+}
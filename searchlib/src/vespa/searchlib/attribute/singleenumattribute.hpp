@@ -227,6 +227,18 @@ SingleValueEnumAttribute<B>::load_enumerated_data(ReaderBase& attrReader,
                                                   enumstore::EnumeratedPostingsLoader& loader,
                                                   size_t num_values)
 {
+    auto posting_lists = attribute::LoadUtils::loadPostingLists(*this);
+    if (posting_lists && loader.load_posting_lists_file(*posting_lists, num_values)) {
+        posting_lists.reset();
+        attribute::loadFromEnumeratedSingleValue(_enumIndices,
+                                                 getGenerationHolder(),
+                                                 attrReader,
+                                                 loader.get_enum_indexes(),
+                                                 loader.get_enum_value_remapping(),
+                                                 attribute::NoSaveLoadedEnum());
+        loader.free_enum_value_remapping();
+        return;
+    }
     loader.reserve_loaded_enums(num_values);
     attribute::loadFromEnumeratedSingleValue(_enumIndices,
                                              getGenerationHolder(),
@@ -336,7 +348,8 @@ SingleValueEnumAttribute<B>::onInitSave(vespalib::stringref fileName)
         (std::move(guard),
          this->createAttributeHeader(fileName),
          attribute::make_entry_ref_vector_snapshot(this->_enumIndices, this->getCommittedDocIdLimit()),
-         this->_enumStore);
+         this->_enumStore,
+         this->hasPostings() && this->getConfig().save_posting_lists());
 }
 
 } // namespace search
@@ -13,10 +13,11 @@ SingleValueEnumAttributeSaver::
 SingleValueEnumAttributeSaver(GenerationHandler::Guard &&guard,
                               const attribute::AttributeHeader &header,
                               EntryRefVector &&indices,
-                              IEnumStore &enumStore)
+                              IEnumStore &enumStore,
+                              bool save_posting_lists)
     : AttributeSaver(std::move(guard), header),
       _indices(std::move(indices)),
-      _enumSaver(enumStore)
+      _enumSaver(enumStore, save_posting_lists)
 {
 }
 
@@ -25,11 +26,16 @@ SingleValueEnumAttributeSaver::~SingleValueEnumAttributeSaver() = default;
 bool
 SingleValueEnumAttributeSaver::onSave(IAttributeSaveTarget &saveTarget)
 {
+    if (!_enumSaver.setup_posting_lists_writer(saveTarget)) {
+        return false;
+    }
     _enumSaver.writeUdat(saveTarget);
     std::unique_ptr<search::BufferWriter> datWriter(saveTarget.datWriter().allocBufferWriter());
     assert(saveTarget.getEnumerated());
     auto &enumerator = _enumSaver.get_enumerator();
+    auto *posting_lists = _enumSaver.get_posting_lists();
     enumerator.enumerateValues();
+    uint32_t docId = 0;
     for (auto ref : _indices) {
         uint32_t enumValue = enumerator.mapEntryRefToEnumValue(ref);
         assert(enumValue != 0u);
@@ -37,9 +43,14 @@ SingleValueEnumAttributeSaver::onSave(IAttributeSaveTarget &saveTarget)
         // to values >= 1, but file format starts enumeration at 0.
         --enumValue;
         datWriter->write(&enumValue, sizeof(uint32_t));
+        if (posting_lists != nullptr) {
+            posting_lists->add(enumValue, docId, 1);
+        }
+        ++docId;
     }
     datWriter->flush();
     _enumSaver.clear();
+    _enumSaver.write_posting_lists(saveTarget);
     return true;
 }
 
@@ -22,7 +22,8 @@ public:
     SingleValueEnumAttributeSaver(vespalib::GenerationHandler::Guard &&guard,
                                   const attribute::AttributeHeader &header,
                                   attribute::EntryRefVector &&indices,
-                                  IEnumStore &enumStore);
+                                  IEnumStore &enumStore,
+                                  bool save_posting_lists);
 
     ~SingleValueEnumAttributeSaver() override;
 };
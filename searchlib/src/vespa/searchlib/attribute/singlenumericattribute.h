@@ -9,8 +9,13 @@
 #include <vespa/vespalib/util/rcuvector.h>
 #include <limits>
 
+namespace vespalib::alloc { class PrivateFileMappingAllocator; }
+namespace search::fileutil { class LoadedBuffer; }
+
 namespace search {
 
+template <typename T> class PrimitiveReader;
+
 template <typename B>
 class SingleValueNumericAttribute final : public B {
 private:
@@ -27,7 +32,23 @@ private:
 
     using B::getGenerationHolder;
 
+    // Number of values in each chunk of the data vector tracked for delta saves (4 KiB)
+    static constexpr uint32_t lids_per_delta_chunk = 4096 / sizeof(T);
+
+    // Set when the data vector was loaded by mapping the .dat file (paged attributes).
+    std::unique_ptr<vespalib::alloc::PrivateFileMappingAllocator> _file_mapping_allocator;
     DataVector _data;
+    // One bit per chunk of the data vector changed since the last save or load, when
+    // delta saves are enabled. Bits are set concurrently by writers applying direct updates.
+    std::vector<uint64_t> _delta_chunks;
+    uint64_t              _delta_base_serial_num;
+
+    bool onLoadMapped(PrimitiveReader<T> &attrReader, size_t sz);
+    bool load_deltas(uint64_t &serial_num);
+    bool apply_delta(const fileutil::LoadedBuffer &delta);
+    void ensure_delta_chunks(size_t lid_limit);
+    void mark_delta_changed(DocId doc) noexcept;
+    void reset_delta_chunks(uint64_t serial_num);
 
     T getFromEnum(EnumHandle e) const override {
         (void) e;
@@ -59,6 +80,8 @@ public:
     void before_inc_generation(generation_t current_gen) override;
     bool addDoc(DocId & doc) override;
     bool onLoad(vespalib::Executor *executor) override;
+    bool supports_direct_updates() const noexcept override { return true; }
+    bool apply_direct(DocId doc, const document::ValueUpdate &update) override;
 
     bool onLoadEnumerated(ReaderBase &attrReader);
 
@@ -122,6 +145,8 @@ public:
     void clearDocs(DocId lidLow, DocId lidLimit, bool in_shrink_lid_space) override;
     void onShrinkLidSpace() override;
     std::unique_ptr<AttributeSaver> onInitSave(vespalib::stringref fileName) override;
+    std::unique_ptr<AttributeSaver> on_init_delta_save(vespalib::stringref fileName, size_t max_size) override;
+    uint64_t get_delta_save_base_serial_num() const noexcept override { return _delta_base_serial_num; }
 };
 
 }
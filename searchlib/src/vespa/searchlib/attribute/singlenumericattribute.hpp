@@ -11,7 +11,14 @@
 #include "single_numeric_search_context.h"
 #include "valuemodifier.h"
 #include <vespa/searchlib/query/query_term_simple.h>
+#include <vespa/searchlib/util/file_settings.h>
+#include <vespa/searchlib/util/fileutil.h>
 #include <vespa/searchcommon/attribute/config.h>
+#include <vespa/vespalib/data/databuffer.h>
+#include <vespa/vespalib/data/fileheader.h>
+#include <vespa/vespalib/util/private_file_mapping_allocator.h>
+#include <atomic>
+#include <cstring>
 
 namespace search {
 
@@ -26,7 +33,10 @@ template <typename B>
 SingleValueNumericAttribute<B>::
 SingleValueNumericAttribute(const vespalib::string & baseFileName, const AttributeVector::Config & c)
     : B(baseFileName, c),
-      _data(c.getGrowStrategy(), getGenerationHolder(), this->get_initial_alloc())
+      _file_mapping_allocator(),
+      _data(c.getGrowStrategy(), getGenerationHolder(), this->get_initial_alloc()),
+      _delta_chunks(),
+      _delta_base_serial_num(0)
 { }
 
 template <typename B>
@@ -45,6 +55,7 @@ SingleValueNumericAttribute<B>::onCommit()
         // apply updates
         typename B::ValueModifier valueGuard(this->getValueModifier());
         for (const auto & change : this->_changes.getInsertOrder()) {
+            mark_delta_changed(change._doc);
             if (change._type == ChangeBase::UPDATE) {
                 vespalib::atomic::store_ref_relaxed(_data[change._doc], change._data);
             } else if (change._type >= ChangeBase::ADD && change._type <= ChangeBase::DIV) {
@@ -60,6 +71,98 @@ SingleValueNumericAttribute<B>::onCommit()
     this->_changes.clear();
 }
 
+template <typename B>
+bool
+SingleValueNumericAttribute<B>::apply_direct(DocId doc, const document::ValueUpdate &update)
+{
+    if (doc >= B::getNumDocs()) {
+        return false;
+    }
+    T value = _data[doc];
+    switch (update.getType()) {
+    case document::ValueUpdate::Assign: {
+        const auto &assign = static_cast<const document::AssignValueUpdate &>(update);
+        if (!assign.hasValue()) {
+            return true;
+        }
+        if constexpr (std::is_integral_v<T>) {
+            value = assign.getValue().getAsLong();
+        } else {
+            value = assign.getValue().getAsDouble();
+        }
+        break;
+    }
+    case document::ValueUpdate::Arithmetic: {
+        const auto &arithmetic = static_cast<const ArithmeticValueUpdate &>(update);
+        double operand = arithmetic.getOperand();
+        ChangeBase::Type type;
+        switch (arithmetic.getOperator()) {
+        case ArithmeticValueUpdate::Add: type = ChangeBase::ADD; break;
+        case ArithmeticValueUpdate::Sub: type = ChangeBase::SUB; break;
+        case ArithmeticValueUpdate::Mul: type = ChangeBase::MUL; break;
+        case ArithmeticValueUpdate::Div:
+            if ((operand == 0) && this->isIntegerType()) {
+                this->divideByZeroWarning();
+                return true;
+            }
+            type = ChangeBase::DIV;
+            break;
+        default:
+            return false;
+        }
+        value = this->template applyArithmetic<T, typename B::Change::DataType>(value, operand, type);
+        break;
+    }
+    case document::ValueUpdate::Clear:
+        value = this->_defaultValue._data;
+        break;
+    default:
+        return false;
+    }
+    vespalib::atomic::store_ref_relaxed(_data[doc], value);
+    mark_delta_changed(doc);
+    return true;
+}
+
+template <typename B>
+void
+SingleValueNumericAttribute<B>::ensure_delta_chunks(size_t lid_limit)
+{
+    if (this->getConfig().max_delta_saves() == 0) {
+        return;
+    }
+    size_t chunks = (lid_limit + lids_per_delta_chunk - 1) / lids_per_delta_chunk;
+    size_t words = (chunks + 63) / 64;
+    if (words > _delta_chunks.size()) {
+        _delta_chunks.resize(words);
+    }
+}
+
+template <typename B>
+void
+SingleValueNumericAttribute<B>::mark_delta_changed(DocId doc) noexcept
+{
+    size_t chunk = doc / lids_per_delta_chunk;
+    size_t word = chunk / 64;
+    if (word < _delta_chunks.size()) {
+        uint64_t bit = uint64_t(1) << (chunk % 64);
+        std::atomic_ref<uint64_t> ref(_delta_chunks[word]);
+        if ((ref.load(std::memory_order_relaxed) & bit) == 0) {
+            ref.fetch_or(bit);
+        }
+    }
+}
+
+template <typename B>
+void
+SingleValueNumericAttribute<B>::reset_delta_chunks(uint64_t serial_num)
+{
+    for (auto &word : _delta_chunks) {
+        std::atomic_ref<uint64_t>(word).store(0);
+    }
+    _delta_base_serial_num = (this->getConfig().max_delta_saves() > 0) ? serial_num : 0;
+}
+
 template <typename B>
 void
 SingleValueNumericAttribute<B>::onUpdateStat()
@@ -75,6 +178,7 @@ template <typename B>
 void
 SingleValueNumericAttribute<B>::onAddDocs(DocId lidLimit) {
     _data.reserve(lidLimit);
+    ensure_delta_chunks(lidLimit);
 }
 
 template <typename B>
@@ -85,6 +189,8 @@ SingleValueNumericAttribute<B>::addDoc(DocId & doc) {
     std::atomic_thread_fence(std::memory_order_release);
     B::incNumDocs();
     doc = B::getNumDocs() - 1;
+    ensure_delta_chunks(doc + 1);
+    mark_delta_changed(doc);
     this->updateUncommittedDocIdLimit(doc);
     if (incGen) {
         this->incGeneration();
@@ -126,6 +232,26 @@ SingleValueNumericAttribute<B>::onLoadEnumerated(ReaderBase &attrReader)
     return true;
 }
 
+template <typename B>
+bool
+SingleValueNumericAttribute<B>::onLoadMapped(PrimitiveReader<T> &attrReader, size_t sz)
+{
+    // Paged attributes use the values in the .dat file as is, mapped copy-on-write.
+    // Pages that are never updated stay backed by the file and can be evicted under memory pressure,
+    // while updated pages are copied to anonymous memory. A later flush writes a new .dat file.
+    const auto &memory_allocator = this->get_memory_allocator();
+    if (!this->getConfig().paged() || !memory_allocator || (sz == 0) || _file_mapping_allocator) {
+        return false;
+    }
+    auto allocator = std::make_unique<vespalib::alloc::PrivateFileMappingAllocator>(memory_allocator.get());
+    auto buf = allocator->map_file(attrReader.getDatFileName(), attrReader.getDatHeaderLen(), sz * sizeof(T));
+    if (buf.get() == nullptr) {
+        return false;
+    }
+    _file_mapping_allocator = std::move(allocator);
+    _data.replaceVector(vespalib::Array<T>(std::move(buf), sz));
+    return true;
+}
 
 template <typename B>
 bool
@@ -139,24 +265,92 @@ SingleValueNumericAttribute<B>::onLoad(vespalib::Executor *)
     }
 
     this->setCreateSerialNum(attrReader.getCreateSerialNum());
+    const auto &datHeader = attrReader.getDatHeader();
+    uint64_t serial_num = datHeader.hasTag("serialNum") ? datHeader.getTag("serialNum").asInteger() : 0;
 
-    if (attrReader.getEnumerated())
-        return onLoadEnumerated(attrReader);
-    
-    const size_t sz(attrReader.getDataCount());
-    getGenerationHolder().reclaim_all();
-    _data.reset();
-    _data.unsafe_reserve(sz);
-    for (uint32_t i = 0; i < sz; ++i) {
-        _data.push_back(attrReader.getNextData());
-    }
+    if (attrReader.getEnumerated()) {
+        if (!onLoadEnumerated(attrReader)) {
+            return false;
+        }
+    } else {
+        const size_t sz(attrReader.getDataCount());
+        getGenerationHolder().reclaim_all();
+        _data.reset();
+        if (!onLoadMapped(attrReader, sz)) {
+            _data.unsafe_reserve(sz);
+            for (uint32_t i = 0; i < sz; ++i) {
+                _data.push_back(attrReader.getNextData());
+            }
+        }
 
-    B::setNumDocs(sz);
-    B::setCommittedDocIdLimit(sz);
+        B::setNumDocs(sz);
+        B::setCommittedDocIdLimit(sz);
+    }
+    if (!load_deltas(serial_num)) {
+        return false;
+    }
+    ensure_delta_chunks(_data.capacity());
+    reset_delta_chunks(serial_num);
+    return true;
+}
 
+template <typename B>
+bool
+SingleValueNumericAttribute<B>::load_deltas(uint64_t &serial_num)
+{
+    // Delta files written by later flushes are applied in order on top of the .dat file.
+    for (uint32_t k = 1; attribute::LoadUtils::file_exists(*this, "delta." + std::to_string(k) + ".dat"); ++k) {
+        auto delta = attribute::LoadUtils::loadFile(*this, "delta." + std::to_string(k) + ".dat");
+        if (!apply_delta(*delta)) {
+            return false;
+        }
+        const auto &header = delta->getHeader();
+        serial_num = header.hasTag("serialNum") ? header.getTag("serialNum").asInteger() : 0;
+    }
     return true;
 }
 
+template <typename B>
+bool
+SingleValueNumericAttribute<B>::apply_delta(const fileutil::LoadedBuffer &delta)
+{
+    // Layout: num_docs, lids_per_chunk, num_chunks, chunk ids, then the values of each chunk.
+    const char *buf = delta.c_str();
+    size_t size = delta.size();
+    uint32_t fields[3];
+    if (size < sizeof(fields)) {
+        return false;
+    }
+    memcpy(fields, buf, sizeof(fields));
+    uint32_t num_docs = fields[0];
+    uint32_t lids_per_chunk = fields[1];
+    uint32_t num_chunks = fields[2];
+    size_t values_offset = sizeof(fields) + num_chunks * sizeof(uint32_t);
+    if (lids_per_chunk == 0 || size < values_offset) {
+        return false;
+    }
+    _data.ensure_size(num_docs, B::defaultValue());
+    _data.unsafe_resize(num_docs);
+    size_t offset = values_offset;
+    for (uint32_t i = 0; i < num_chunks; ++i) {
+        uint32_t chunk;
+        memcpy(&chunk, buf + sizeof(fields) + i * sizeof(uint32_t), sizeof(chunk));
+        size_t lid_low = size_t(chunk) * lids_per_chunk;
+        if (lid_low >= num_docs) {
+            return false;
+        }
+        size_t count = std::min(size_t(lids_per_chunk), num_docs - lid_low);
+        if (size < offset + count * sizeof(T)) {
+            return false;
+        }
+        memcpy(&_data[lid_low], buf + offset, count * sizeof(T));
+        offset += count * sizeof(T);
+    }
+    B::setNumDocs(num_docs);
+    B::setCommittedDocIdLimit(num_docs);
+    return offset == size;
+}
+
 template <typename B>
 std::unique_ptr<attribute::SearchContext>
 SingleValueNumericAttribute<B>::getSearch(QueryTermSimple::UP qTerm,
@@ -200,7 +394,12 @@ SingleValueNumericAttribute<B>::onShrinkLidSpace()
 {
     uint32_t committedDocIdLimit = this->getCommittedDocIdLimit();
     assert(_data.size() >= committedDocIdLimit);
-    _data.shrink(committedDocIdLimit);
+    if (this->getConfig().write_shards() > 1) {
+        // Keep the buffer, as sharded writers applying direct updates may write to it concurrently.
+        _data.unsafe_resize(committedDocIdLimit);
+    } else {
+        _data.shrink(committedDocIdLimit);
+    }
     this->setNumDocs(committedDocIdLimit);
 }
 
@@ -210,9 +409,62 @@ SingleValueNumericAttribute<B>::onInitSave(vespalib::stringref fileName)
 {
     const uint32_t numDocs(this->getCommittedDocIdLimit());
     assert(numDocs <= _data.size());
+    reset_delta_chunks(this->getStatus().getLastSyncToken());
     return std::make_unique<SingleValueNumericAttributeSaver>
         (this->createAttributeHeader(fileName), &_data[0], numDocs * sizeof(T));
 }
 
+template <typename B>
+std::unique_ptr<AttributeSaver>
+SingleValueNumericAttribute<B>::on_init_delta_save(vespalib::stringref fileName, size_t max_size)
+{
+    if (_delta_base_serial_num == 0) {
+        return {};
+    }
+    const uint32_t numDocs(this->getCommittedDocIdLimit());
+    assert(numDocs <= _data.size());
+    std::vector<uint64_t> changed(_delta_chunks.size());
+    for (size_t i = 0; i < changed.size(); ++i) {
+        changed[i] = std::atomic_ref<uint64_t>(_delta_chunks[i]).exchange(0);
+    }
+    std::vector<uint32_t> chunks;
+    size_t num_values = 0;
+    for (size_t i = 0; i < changed.size(); ++i) {
+        for (uint64_t bits = changed[i]; bits != 0; bits &= (bits - 1)) {
+            uint32_t chunk = i * 64 + __builtin_ctzll(bits);
+            size_t lid_low = size_t(chunk) * lids_per_delta_chunk;
+            if (lid_low < numDocs) {
+                chunks.push_back(chunk);
+                num_values += std::min(size_t(lids_per_delta_chunk), numDocs - lid_low);
+            }
+        }
+    }
+    uint32_t fields[3] = { numDocs, lids_per_delta_chunk, uint32_t(chunks.size()) };
+    size_t size = sizeof(fields) + chunks.size() * sizeof(uint32_t) + num_values * sizeof(T);
+    if (size > max_size) {
+        // Too many changes, keep tracking them until a full save is made.
+        for (size_t i = 0; i < changed.size(); ++i) {
+            std::atomic_ref<uint64_t>(_delta_chunks[i]).fetch_or(changed[i]);
+        }
+        return {};
+    }
+    auto buf = std::make_unique<vespalib::DataBuffer>(size, FileSettings::DIRECTIO_ALIGNMENT);
+    memcpy(buf->getFree(), fields, sizeof(fields));
+    buf->moveFreeToData(sizeof(fields));
+    if (!chunks.empty()) {
+        memcpy(buf->getFree(), chunks.data(), chunks.size() * sizeof(uint32_t));
+        buf->moveFreeToData(chunks.size() * sizeof(uint32_t));
+    }
+    for (uint32_t chunk : chunks) {
+        size_t lid_low = size_t(chunk) * lids_per_delta_chunk;
+        size_t count = std::min(size_t(lids_per_delta_chunk), numDocs - lid_low);
+        memcpy(buf->getFree(), &_data[lid_low], count * sizeof(T));
+        buf->moveFreeToData(count * sizeof(T));
+    }
+    assert(buf->getDataLen() == size);
+    _delta_base_serial_num = this->getStatus().getLastSyncToken();
+    return std::make_unique<SingleValueNumericAttributeSaver>(this->createAttributeHeader(fileName), std::move(buf));
+}
+
 }
 
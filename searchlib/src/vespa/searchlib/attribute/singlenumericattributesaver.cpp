@@ -25,6 +25,13 @@ SingleValueNumericAttributeSaver(const attribute::AttributeHeader &header,
     assert(_buf->getDataLen() == size);
 }
 
+SingleValueNumericAttributeSaver::
+SingleValueNumericAttributeSaver(const attribute::AttributeHeader &header, Buffer buf)
+  : AttributeSaver(vespalib::GenerationHandler::Guard(), header),
+    _buf(std::move(buf))
+{
+}
+
 SingleValueNumericAttributeSaver::~SingleValueNumericAttributeSaver() = default;
 
 bool
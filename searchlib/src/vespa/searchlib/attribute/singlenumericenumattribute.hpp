@@ -78,7 +78,7 @@ SingleValueNumericEnumAttribute<B>::onCommit()
 
 template <typename B>
 bool
-SingleValueNumericEnumAttribute<B>::onLoadEnumerated(ReaderBase &attrReader)
+SingleValueNumericEnumAttribute<B>::onLoadEnumerated(ReaderBase &attrReader, vespalib::Executor *executor)
 {
     auto udatBuffer = attribute::LoadUtils::loadUDAT(*this);
 
@@ -89,6 +89,7 @@ SingleValueNumericEnumAttribute<B>::onLoadEnumerated(ReaderBase &attrReader)
     this->setCommittedDocIdLimit(numDocs);
     if (this->hasPostings()) {
         auto loader = this->getEnumStore().make_enumerated_postings_loader();
+        loader.set_executor(executor);
         loader.load_unique_values(udatBuffer->buffer(), udatBuffer->size());
         loader.build_enum_value_remapping();
         this->load_enumerated_data(attrReader, loader, numValues);
@@ -108,7 +109,7 @@ SingleValueNumericEnumAttribute<B>::onLoadEnumerated(ReaderBase &attrReader)
 
 template <typename B>
 bool
-SingleValueNumericEnumAttribute<B>::onLoad(vespalib::Executor *)
+SingleValueNumericEnumAttribute<B>::onLoad(vespalib::Executor *executor)
 {
     PrimitiveReader<T> attrReader(*this);
     bool ok(attrReader.getHasLoadData());
@@ -124,7 +125,7 @@ SingleValueNumericEnumAttribute<B>::onLoad(vespalib::Executor *)
     this->setCreateSerialNum(attrReader.getCreateSerialNum());
 
     if (attrReader.getEnumerated()) {
-        return onLoadEnumerated(attrReader);
+        return onLoadEnumerated(attrReader, executor);
     }
 
     const uint32_t numDocs(attrReader.getDataCount());
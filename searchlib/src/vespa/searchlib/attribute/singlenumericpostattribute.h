@@ -8,6 +8,8 @@
 #include "postinglistsearchcontext.h"
 #include "singlenumericenumattribute.h"
 
+namespace search::attribute { class RangeBucketIndex; }
+
 namespace search {
 
 /**
@@ -61,6 +63,7 @@ private:
     using DirectPostingStoreAdapterType = attribute::NumericDirectPostingStoreAdapter<IDocidPostingStore,
                                                                                       PostingStore, EnumStore>;
     DirectPostingStoreAdapterType _posting_store_adapter;
+    std::unique_ptr<attribute::RangeBucketIndex> _range_buckets; // nullptr if disabled
 
     void freezeEnumDictionary() override;
     void mergeMemoryStats(vespalib::MemoryUsage & total) override;
@@ -71,6 +74,8 @@ private:
                            PostingMap &changePost);
 
     void applyValueChanges(EnumStoreBatchUpdater& updater) override;
+    void move_in_range_buckets(const std::map<DocId, EnumIndex> &currEnumIndices);
+    void commit_range_buckets(bool rebuild);
 
 public:
     SingleValueNumericPostingAttribute(const vespalib::string & name, const AttributeVector::Config & cfg);
@@ -84,12 +89,12 @@ public:
 
     const IDocidPostingStore* as_docid_posting_store() const override;
 
-    bool onAddDoc(DocId doc) override {
-        return forwardedOnAddDoc(doc, this->_enumIndices.size(), this->_enumIndices.capacity());
-    }
-    void onAddDocs(DocId docIdLimit) override {
-        forwardedOnAddDoc(docIdLimit, this->_enumIndices.size(), this->_enumIndices.capacity());
-    }
+    const attribute::RangeBucketIndex *get_range_bucket_index() const noexcept override { return _range_buckets.get(); }
+
+    bool onAddDoc(DocId doc) override;
+    void onAddDocs(DocId docIdLimit) override;
+    bool onLoad(vespalib::Executor *executor) override;
+    void forwardedShrinkLidSpace(uint32_t newSize) override;
 
     void load_posting_lists(LoadedVector& loaded) override { handle_load_posting_lists(loaded); }
     attribute::IPostingListAttributeBase *getIPostingListAttributeBase() override { return this; }
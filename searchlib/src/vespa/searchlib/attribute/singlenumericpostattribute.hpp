@@ -6,7 +6,9 @@
 #include "enumcomparator.h"
 #include "enumstore.h"
 #include "numeric_direct_posting_store_adapter.hpp"
+#include "range_bucket_index.h"
 #include "singlenumericenumattribute.hpp"
+#include <type_traits>
 
 namespace search {
 
@@ -22,9 +24,16 @@ template <typename B>
 SingleValueNumericPostingAttribute<B>::SingleValueNumericPostingAttribute(const vespalib::string & name,
                                                                           const AttributeVector::Config & c) :
     SingleValueNumericEnumAttribute<B>(name, c),
-    PostingParent(*this, this->getEnumStore()),
-    _posting_store_adapter(this->get_posting_store(), this->_enumStore, this->getIsFilter())
+    PostingParent(*this, this->getEnumStore(), this->get_memory_allocator()),
+    _posting_store_adapter(this->get_posting_store(), this->_enumStore, this->getIsFilter()),
+    _range_buckets()
 {
+    if constexpr (std::is_integral_v<T>) {
+        if (c.range_bucket_levels() > 0) {
+            _range_buckets = std::make_unique<attribute::RangeBucketIndex>(c.range_bucket_bits(), c.range_bucket_levels(),
+                                                                           this->defaultValue(), this->getGenerationHolder());
+        }
+    }
 }
 
 template <typename B>
@@ -40,6 +49,9 @@ SingleValueNumericPostingAttribute<B>::mergeMemoryStats(vespalib::MemoryUsage &
 {
     auto& compaction_strategy = this->getConfig().getCompactionStrategy();
     total.merge(this->_posting_store.update_stat(compaction_strategy));
+    if (_range_buckets) {
+        total.merge(_range_buckets->get_memory_usage());
+    }
 }
 
 template <typename B>
@@ -118,7 +130,93 @@ SingleValueNumericPostingAttribute<B>::applyValueChanges(EnumStoreBatchUpdater&
     makePostingChange(enumStore.get_comparator(), currEnumIndices, changePost);
 
     this->updatePostings(changePost);
+    if (_range_buckets) {
+        move_in_range_buckets(currEnumIndices);
+    }
     SingleValueNumericEnumAttribute<B>::applyValueChanges(updater);
+    if (_range_buckets) {
+        commit_range_buckets(false);
+    }
+}
+
+template <typename B>
+void
+SingleValueNumericPostingAttribute<B>::move_in_range_buckets(const std::map<DocId, EnumIndex> &currEnumIndices)
+{
+    const EnumStore & enumStore = this->getEnumStore();
+    for (const auto& elem : currEnumIndices) {
+        EnumIndex oldIdx = this->_enumIndices[elem.first].load_relaxed();
+        EnumIndex newIdx = elem.second;
+        int64_t oldValue = oldIdx.valid() ? int64_t(enumStore.get_value(oldIdx)) : 0;
+        int64_t newValue = newIdx.valid() ? int64_t(enumStore.get_value(newIdx)) : 0;
+        _range_buckets->move(elem.first, oldIdx.valid() ? &oldValue : nullptr, newIdx.valid() ? &newValue : nullptr);
+    }
+}
+
+template <typename B>
+void
+SingleValueNumericPostingAttribute<B>::commit_range_buckets(bool rebuild)
+{
+    const EnumStore & enumStore = this->getEnumStore();
+    auto get_value = [this, &enumStore](uint32_t docid, int64_t &value) {
+        EnumIndex idx = this->_enumIndices[docid].load_relaxed();
+        if (!idx.valid()) {
+            return false;
+        }
+        value = enumStore.get_value(idx);
+        return true;
+    };
+    uint32_t num_docs = this->_enumIndices.size();
+    if (rebuild) {
+        _range_buckets->rebuild(num_docs, get_value);
+    } else {
+        _range_buckets->commit(num_docs, get_value);
+    }
+}
+
+template <typename B>
+bool
+SingleValueNumericPostingAttribute<B>::onAddDoc(DocId doc)
+{
+    bool res = forwardedOnAddDoc(doc, this->_enumIndices.size(), this->_enumIndices.capacity());
+    if (_range_buckets) {
+        res |= _range_buckets->resize(std::max(size_t(doc) + 1, this->_enumIndices.size()),
+                                      std::max(size_t(doc) + 1, this->_enumIndices.capacity()));
+    }
+    return res;
+}
+
+template <typename B>
+void
+SingleValueNumericPostingAttribute<B>::onAddDocs(DocId docIdLimit)
+{
+    forwardedOnAddDoc(docIdLimit, this->_enumIndices.size(), this->_enumIndices.capacity());
+    if (_range_buckets) {
+        _range_buckets->resize(std::max(size_t(docIdLimit) + 1, this->_enumIndices.size()),
+                               std::max(size_t(docIdLimit) + 1, this->_enumIndices.capacity()));
+    }
+}
+
+template <typename B>
+bool
+SingleValueNumericPostingAttribute<B>::onLoad(vespalib::Executor *executor)
+{
+    bool loaded = SingleValueNumericEnumAttribute<B>::onLoad(executor);
+    if (loaded && _range_buckets) {
+        _range_buckets->resize(this->_enumIndices.size(), this->_enumIndices.capacity());
+        commit_range_buckets(true);
+    }
+    return loaded;
+}
+
+template <typename B>
+void
+SingleValueNumericPostingAttribute<B>::forwardedShrinkLidSpace(uint32_t newSize)
+{
+    PostingParent::forwardedShrinkLidSpace(newSize);
+    if (_range_buckets) {
+        (void) _range_buckets->resize(newSize, newSize);
+    }
 }
 
 template <typename B>
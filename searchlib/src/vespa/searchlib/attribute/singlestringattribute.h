@@ -6,6 +6,8 @@
 #include "singleenumattribute.h"
 #include "stringbase.h"
 
+namespace search::attribute { class UcaSortKeys; }
+
 namespace search {
 
 /**
@@ -30,6 +32,19 @@ protected:
     using WeightedEnum = StringAttribute::WeightedEnum;
     using WeightedString = StringAttribute::WeightedString;
     using generation_t = StringAttribute::generation_t;
+    using EnumStoreBatchUpdater = typename SingleValueEnumAttribute<B>::EnumStoreBatchUpdater;
+
+    void applyValueChanges(EnumStoreBatchUpdater& updater) override;
+    void mergeMemoryStats(vespalib::MemoryUsage & total) override;
+    long onSerializeForAscendingSort(DocId doc, void * serTo, long available, const common::BlobConverter * bc) const override;
+    long onSerializeForDescendingSort(DocId doc, void * serTo, long available, const common::BlobConverter * bc) const override;
+
+private:
+    // Precomputed uca sort keys, one entry per configured locale
+    std::vector<std::unique_ptr<attribute::UcaSortKeys>> _uca_sort_keys;
+
+    long on_serialize_for_sort(DocId doc, void * serTo, long available, const common::BlobConverter * bc, bool asc) const;
+    void rebuild_uca_sort_keys();
 
 public:
     SingleValueStringAttributeT(const vespalib::string & name, const AttributeVector::Config & c);
@@ -37,6 +52,11 @@ public:
     ~SingleValueStringAttributeT();
 
     void freezeEnumDictionary() override;
+    void onCommit() override;
+    bool onLoad(vespalib::Executor *executor) override;
+    void onShrinkLidSpace() override;
+    void reclaim_memory(generation_t oldest_used_gen) override;
+    void before_inc_generation(generation_t current_gen) override;
 
     //-------------------------------------------------------------------------
     // Attribute read API
@@ -6,12 +6,14 @@
 #include "singleenumattribute.hpp"
 #include "attributevector.hpp"
 #include "single_string_enum_hint_search_context.h"
+#include "uca_sort_keys.h"
 #include <vespa/vespalib/text/utf8.h>
 #include <vespa/vespalib/text/lowercase.h>
 #include <vespa/searchcommon/attribute/config.h>
 #include <vespa/searchlib/util/bufferwriter.h>
 #include <vespa/vespalib/util/regexp.h>
 #include <vespa/searchlib/query/query_term_ucs4.h>
+#include <algorithm>
 
 namespace search {
 
@@ -22,8 +24,14 @@ template <typename B>
 SingleValueStringAttributeT<B>::
 SingleValueStringAttributeT(const vespalib::string &name,
                             const AttributeVector::Config & c)
-    : SingleValueEnumAttribute<B>(name, c)
-{ }
+    : SingleValueEnumAttribute<B>(name, c),
+      _uca_sort_keys()
+{
+    for (const auto& params : c.uca_sort_keys()) {
+        _uca_sort_keys.push_back(std::make_unique<attribute::UcaSortKeys>(params, c.getGrowStrategy(),
+                                                                          this->getGenerationHolder()));
+    }
+}
 
 template <typename B>
 SingleValueStringAttributeT<B>::SingleValueStringAttributeT(const vespalib::string &name)
@@ -40,6 +48,144 @@ SingleValueStringAttributeT<B>::freezeEnumDictionary()
     this->getEnumStore().freeze_dictionary();
 }
 
+template <typename B>
+void
+SingleValueStringAttributeT<B>::applyValueChanges(EnumStoreBatchUpdater& updater)
+{
+    if (_uca_sort_keys.empty()) {
+        SingleValueEnumAttribute<B>::applyValueChanges(updater);
+        return;
+    }
+    std::vector<DocId> changed_docs;
+    changed_docs.reserve(this->_changes.size());
+    for (const auto& change : this->_changes.getInsertOrder()) {
+        changed_docs.push_back(change._doc);
+    }
+    SingleValueEnumAttribute<B>::applyValueChanges(updater);
+    std::sort(changed_docs.begin(), changed_docs.end());
+    changed_docs.erase(std::unique(changed_docs.begin(), changed_docs.end()), changed_docs.end());
+    for (DocId doc : changed_docs) {
+        const char *value = this->_enumStore.get_value(this->_enumIndices[doc].load_relaxed());
+        for (auto& keys : _uca_sort_keys) {
+            keys->set(doc, value);
+        }
+    }
+}
+
+template <typename B>
+void
+SingleValueStringAttributeT<B>::rebuild_uca_sort_keys()
+{
+    uint32_t num_docs = this->_enumIndices.size();
+    for (DocId doc = 0; doc < num_docs; ++doc) {
+        EnumIndex idx = this->_enumIndices[doc].load_relaxed();
+        const char *value = idx.valid() ? this->_enumStore.get_value(idx) : StringAttribute::defaultValue();
+        for (auto& keys : _uca_sort_keys) {
+            keys->set(doc, value);
+        }
+    }
+}
+
+template <typename B>
+void
+SingleValueStringAttributeT<B>::mergeMemoryStats(vespalib::MemoryUsage & total)
+{
+    for (const auto& keys : _uca_sort_keys) {
+        total.merge(keys->get_memory_usage());
+    }
+}
+
+template <typename B>
+void
+SingleValueStringAttributeT<B>::onCommit()
+{
+    SingleValueEnumAttribute<B>::onCommit();
+    for (auto& keys : _uca_sort_keys) {
+        if (keys->consider_compact(this->getConfig().getCompactionStrategy())) {
+            this->incGeneration();
+            this->updateStat(true);
+        }
+    }
+}
+
+template <typename B>
+bool
+SingleValueStringAttributeT<B>::onLoad(vespalib::Executor *executor)
+{
+    bool loaded = SingleValueEnumAttribute<B>::onLoad(executor);
+    if (loaded && !_uca_sort_keys.empty()) {
+        rebuild_uca_sort_keys();
+    }
+    return loaded;
+}
+
+template <typename B>
+void
+SingleValueStringAttributeT<B>::onShrinkLidSpace()
+{
+    SingleValueEnumAttribute<B>::onShrinkLidSpace();
+    for (auto& keys : _uca_sort_keys) {
+        keys->shrink(this->getCommittedDocIdLimit());
+    }
+}
+
+template <typename B>
+void
+SingleValueStringAttributeT<B>::reclaim_memory(generation_t oldest_used_gen)
+{
+    for (auto& keys : _uca_sort_keys) {
+        keys->reclaim_memory(oldest_used_gen);
+    }
+    SingleValueEnumAttribute<B>::reclaim_memory(oldest_used_gen);
+}
+
+template <typename B>
+void
+SingleValueStringAttributeT<B>::before_inc_generation(generation_t current_gen)
+{
+    SingleValueEnumAttribute<B>::before_inc_generation(current_gen);
+    for (auto& keys : _uca_sort_keys) {
+        keys->assign_generation(current_gen);
+    }
+}
+
+template <typename B>
+long
+SingleValueStringAttributeT<B>::on_serialize_for_sort(DocId doc, void * serTo, long available,
+                                                      const common::BlobConverter * bc, bool asc) const
+{
+    if (bc != nullptr) {
+        for (const auto& keys : _uca_sort_keys) {
+            if (keys->matches(*bc)) {
+                auto key = keys->get(doc);
+                if (key.size() > 0) {
+                    return StringAttribute::serialize_sort_key(key, serTo, available, asc);
+                }
+                break;
+            }
+        }
+    }
+    return asc
+        ? StringAttribute::onSerializeForAscendingSort(doc, serTo, available, bc)
+        : StringAttribute::onSerializeForDescendingSort(doc, serTo, available, bc);
+}
+
+template <typename B>
+long
+SingleValueStringAttributeT<B>::onSerializeForAscendingSort(DocId doc, void * serTo, long available,
+                                                            const common::BlobConverter * bc) const
+{
+    return on_serialize_for_sort(doc, serTo, available, bc, true);
+}
+
+template <typename B>
+long
+SingleValueStringAttributeT<B>::onSerializeForDescendingSort(DocId doc, void * serTo, long available,
+                                                             const common::BlobConverter * bc) const
+{
+    return on_serialize_for_sort(doc, serTo, available, bc, false);
+}
+
 template <typename B>
 std::unique_ptr<attribute::SearchContext>
 SingleValueStringAttributeT<B>::getSearch(QueryTermSimpleUP qTerm,
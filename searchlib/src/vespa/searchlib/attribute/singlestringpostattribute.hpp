@@ -14,7 +14,7 @@ template <typename B>
 SingleValueStringPostingAttributeT<B>::SingleValueStringPostingAttributeT(const vespalib::string & name,
                                                                           const AttributeVector::Config & c) :
     SingleValueStringAttributeT<B>(name, c),
-    PostingParent(*this, this->getEnumStore()),
+    PostingParent(*this, this->getEnumStore(), this->get_memory_allocator()),
     _posting_store_adapter(this->get_posting_store(), this->_enumStore, this->getIsFilter())
 {
 }
@@ -44,6 +44,7 @@ template <typename B>
 void
 SingleValueStringPostingAttributeT<B>::mergeMemoryStats(vespalib::MemoryUsage & total)
 {
+    SingleValueStringAttributeT<B>::mergeMemoryStats(total);
     auto& compaction_strategy = this->getConfig().getCompactionStrategy();
     total.merge(this->_posting_store.update_stat(compaction_strategy));
 }
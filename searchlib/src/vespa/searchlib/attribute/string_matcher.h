@@ -37,6 +37,11 @@ protected:
     bool is_fuzzy_match(const char* word, DictionaryConstIteratorType& itr, const DfaStringComparator::DataStoreType& data_store) const {
         return _helper.is_fuzzy_match(word, itr, data_store);
     }
+
+    template <typename DictionaryConstIteratorType>
+    bool is_regex_match(const char* word, DictionaryConstIteratorType& itr, const DfaStringComparator::DataStoreType& data_store) const {
+        return _helper.is_regex_match(word, itr, data_store);
+    }
 };
 
 }
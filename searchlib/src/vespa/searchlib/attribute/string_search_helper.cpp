@@ -3,6 +3,7 @@
 #include "string_search_helper.h"
 #include "dfa_fuzzy_matcher.h"
 #include "i_enum_store_dictionary.h"
+#include "regex_automaton_matcher.h"
 #include <vespa/searchlib/query/query_term_ucs4.h>
 #include <vespa/vespalib/text/lowercase.h>
 #include <vespa/vespalib/text/utf8.h>
@@ -37,6 +38,7 @@ StringSearchHelper::StringSearchHelper(QueryTermUCS4 & term, bool cased, vespali
     : _regex(),
       _fuzzyMatcher(),
       _dfa_fuzzy_matcher(),
+      _regex_automaton_matcher(),
       _term(),
       _termLen(),
       _isPrefix(term.isPrefix()),
@@ -48,6 +50,9 @@ StringSearchHelper::StringSearchHelper(QueryTermUCS4 & term, bool cased, vespali
         _regex = (isCased())
                 ? vespalib::Regex::from_pattern(term.getTerm(), vespalib::Regex::Options::None)
                 : vespalib::Regex::from_pattern(term.getTerm(), vespalib::Regex::Options::IgnoreCase);
+        if (_regex.parsed_ok()) {
+            _regex_automaton_matcher = RegexAutomatonMatcher::make(term.getTerm(), isCased());
+        }
     } else if (isFuzzy()) {
         auto max_edit_dist = term.getFuzzyMaxEditDistance();
         _fuzzyMatcher = std::make_unique<vespalib::FuzzyMatcher>(term.getTerm(),
@@ -115,6 +120,21 @@ StringSearchHelper::is_fuzzy_match(const char* word, DictionaryConstIteratorType
     }
 }
 
+template <typename DictionaryConstIteratorType>
+bool
+StringSearchHelper::is_regex_match(const char* word, DictionaryConstIteratorType& itr, const DfaStringComparator::DataStoreType& data_store) const
+{
+    if (getRegex().valid() && getRegex().partial_match(std::string_view(word))) {
+        return true;
+    }
+    if (_regex_automaton_matcher) {
+        _regex_automaton_matcher->skip_non_match(word, itr, data_store);
+    } else {
+        ++itr;
+    }
+    return false;
+}
+
 template
 bool
 StringSearchHelper::is_fuzzy_match(const char*, EnumPostingTree::ConstIterator&, const DfaStringComparator::DataStoreType&) const;
@@ -123,4 +143,12 @@ template
 bool
 StringSearchHelper::is_fuzzy_match(const char*, EnumTree::ConstIterator&, const DfaStringComparator::DataStoreType&) const;
 
+template
+bool
+StringSearchHelper::is_regex_match(const char*, EnumPostingTree::ConstIterator&, const DfaStringComparator::DataStoreType&) const;
+
+template
+bool
+StringSearchHelper::is_regex_match(const char*, EnumTree::ConstIterator&, const DfaStringComparator::DataStoreType&) const;
+
 }
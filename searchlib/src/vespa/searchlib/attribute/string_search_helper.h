@@ -12,6 +12,7 @@ namespace search { class QueryTermUCS4; }
 namespace search::attribute {
 
 class DfaFuzzyMatcher;
+class RegexAutomatonMatcher;
 
 /**
  * Helper class for search context when scanning string fields
@@ -37,11 +38,15 @@ public:
     template <typename DictionaryConstIteratorType>
     bool is_fuzzy_match(const char* word, DictionaryConstIteratorType& itr, const DfaStringComparator::DataStoreType& data_store) const;
 
+    template <typename DictionaryConstIteratorType>
+    bool is_regex_match(const char* word, DictionaryConstIteratorType& itr, const DfaStringComparator::DataStoreType& data_store) const;
+
 private:
     using ucs4_t = uint32_t;
     vespalib::Regex                _regex;
     std::unique_ptr<FuzzyMatcher>  _fuzzyMatcher;
     std::unique_ptr<DfaFuzzyMatcher> _dfa_fuzzy_matcher;
+    std::unique_ptr<RegexAutomatonMatcher> _regex_automaton_matcher;
     std::unique_ptr<ucs4_t[]>      _ucs4;
     const char *                   _term;
     uint32_t                       _termLen; // measured in bytes
@@ -103,6 +103,24 @@ StringAttribute::get(DocId doc, largeint_t * v, uint32_t sz) const
     return n;
 }
 
+long
+StringAttribute::serialize_sort_key(vespalib::ConstBufferRef key, void * serTo, long available, bool asc)
+{
+    if (available < (long)key.size()) {
+        return -1;
+    }
+    if (asc) {
+        memcpy(serTo, key.data(), key.size());
+    } else {
+        auto *dst = static_cast<unsigned char *>(serTo);
+        const auto * src(static_cast<const uint8_t *>(key.data()));
+        for (size_t i(0); i < key.size(); ++i) {
+            dst[i] = 0xff - src[i];
+        }
+    }
+    return key.size();
+}
+
 long
 StringAttribute::onSerializeForAscendingSort(DocId doc, void * serTo, long available, const common::BlobConverter * bc) const
 {
@@ -112,12 +130,7 @@ StringAttribute::onSerializeForAscendingSort(DocId doc, void * serTo, long avail
     if (bc != nullptr) {
         buf = bc->convert(buf);
     }
-    if (available >= (long)buf.size()) {
-        memcpy(serTo, buf.data(), buf.size());
-    } else {
-        return -1;
-    }
-    return buf.size();
+    return serialize_sort_key(buf, serTo, available, true);
 }
 
 long
@@ -129,16 +142,7 @@ StringAttribute::onSerializeForDescendingSort(DocId doc, void * serTo, long avai
     if (bc != nullptr) {
         buf = bc->convert(buf);
     }
-    if (available >= (long)buf.size()) {
-        auto *dst = static_cast<unsigned char *>(serTo);
-        const auto * src(static_cast<const uint8_t *>(buf.data()));
-        for (size_t i(0); i < buf.size(); ++i) {
-            dst[i] = 0xff - src[i];
-        }
-    } else {
-        return -1;
-    }
-    return buf.size();
+    return serialize_sort_key(buf, serTo, available, false);
 }
 
 uint32_t
@@ -174,7 +178,7 @@ StringAttribute::apply(DocId, const ArithmeticValueUpdate & )
 }
 
 bool
-StringAttribute::onLoadEnumerated(ReaderBase &attrReader)
+StringAttribute::onLoadEnumerated(ReaderBase &attrReader, vespalib::Executor *executor)
 {
     auto udatBuffer = attribute::LoadUtils::loadUDAT(*this);
 
@@ -197,6 +201,7 @@ StringAttribute::onLoadEnumerated(ReaderBase &attrReader)
 
     if (hasPostings()) {
         auto loader = this->getEnumStoreBase()->make_enumerated_postings_loader();
+        loader.set_executor(executor);
         loader.load_unique_values(udatBuffer->buffer(), udatBuffer->size());
         loader.build_enum_value_remapping();
         load_enumerated_data(attrReader, loader, numValues);
@@ -214,7 +219,7 @@ StringAttribute::onLoadEnumerated(ReaderBase &attrReader)
 }
 
 bool
-StringAttribute::onLoad(vespalib::Executor *)
+StringAttribute::onLoad(vespalib::Executor *executor)
 {
     ReaderBase attrReader(*this);
     bool ok(attrReader.getHasLoadData());
@@ -230,7 +235,7 @@ StringAttribute::onLoad(vespalib::Executor *)
     setCreateSerialNum(attrReader.getCreateSerialNum());
 
     assert(attrReader.getEnumerated());
-    return onLoadEnumerated(attrReader);
+    return onLoadEnumerated(attrReader, executor);
 }
 
 bool
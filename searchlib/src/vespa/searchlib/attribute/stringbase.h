@@ -65,7 +65,7 @@ protected:
     const Change _defaultValue;
     bool onLoad(vespalib::Executor *executor) override;
 
-    bool onLoadEnumerated(ReaderBase &attrReader);
+    bool onLoadEnumerated(ReaderBase &attrReader, vespalib::Executor *executor);
 
     bool onAddDoc(DocId doc) override;
 
@@ -75,6 +75,8 @@ protected:
     bool has_uncased_matching() const noexcept override;
     long onSerializeForAscendingSort(DocId doc, void * serTo, long available, const common::BlobConverter * bc) const override;
     long onSerializeForDescendingSort(DocId doc, void * serTo, long available, const common::BlobConverter * bc) const override;
+    // Writes an already converted sort key, inverting the bytes for descending order
+    static long serialize_sort_key(vespalib::ConstBufferRef key, void * serTo, long available, bool asc);
 private:
     virtual void load_posting_lists(LoadedVector& loaded);
     virtual void load_enum_store(LoadedVector& loaded);
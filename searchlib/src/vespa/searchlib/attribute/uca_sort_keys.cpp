@@ -0,0 +1,144 @@
+// Copyright Vespa.ai. Licensed under the terms of the Apache 2.0 license. See LICENSE in the project root.
+
+#include "uca_sort_keys.h"
+#include <vespa/searchlib/uca/ucaconverter.h>
+#include <vespa/vespalib/datastore/compaction_spec.h>
+#include <vespa/vespalib/datastore/compaction_strategy.h>
+#include <vespa/vespalib/datastore/unique_store.hpp>
+#include <vespa/vespalib/util/rcuvector.hpp>
+#include <cstring>
+
+using vespalib::ConstBufferRef;
+using vespalib::datastore::CompactionStrategy;
+
+namespace search::attribute {
+
+namespace {
+
+vespalib::stringref
+normalize_strength(vespalib::stringref strength) noexcept
+{
+    return strength.empty() ? vespalib::stringref("PRIMARY") : strength;
+}
+
+}
+
+UcaSortKeys::UcaSortKeys(const UcaSortKeyParams& params, const vespalib::GrowStrategy& grow_strategy,
+                         vespalib::GenerationHolder& gen_holder)
+    : _params(params),
+      _converter(std::make_unique<uca::UcaConverter>(params.locale(), params.strength())),
+      _keys({}),
+      _refs(grow_strategy, gen_holder),
+      _num_docs(0)
+{
+}
+
+UcaSortKeys::~UcaSortKeys() = default;
+
+bool
+UcaSortKeys::matches(const common::BlobConverter& bc) const noexcept
+{
+    auto* uca_converter = dynamic_cast<const uca::UcaConverter*>(&bc);
+    return (uca_converter != nullptr) &&
+           (uca_converter->locale() == _params.locale()) &&
+           (normalize_strength(uca_converter->strength()) == normalize_strength(_params.strength()));
+}
+
+void
+UcaSortKeys::set(uint32_t docid, const char* value)
+{
+    if (docid >= _refs.size()) {
+        _refs.ensure_size(docid + 1);
+        _num_docs.store(_refs.size(), std::memory_order_release);
+    }
+    auto key = _converter->convert(ConstBufferRef(value, std::strlen(value) + 1));
+    EntryRef new_ref;
+    if ((key.size() > 0) && (key.c_str()[key.size() - 1] == '\0')) {
+        new_ref = _keys.add(key.c_str()).ref();
+    }
+    EntryRef old_ref = _refs[docid].load_relaxed();
+    _refs[docid].store_release(new_ref);
+    if (old_ref.valid()) {
+        _keys.remove(old_ref);
+    }
+}
+
+void
+UcaSortKeys::shrink(uint32_t docid_limit)
+{
+    if (docid_limit >= _refs.size()) {
+        return;
+    }
+    _num_docs.store(docid_limit, std::memory_order_release);
+    for (uint32_t docid = docid_limit; docid < _refs.size(); ++docid) {
+        EntryRef ref = _refs[docid].load_relaxed();
+        if (ref.valid()) {
+            _keys.remove(ref);
+        }
+    }
+    _refs.shrink(docid_limit);
+}
+
+ConstBufferRef
+UcaSortKeys::get(uint32_t docid) const noexcept
+{
+    if (docid >= _num_docs.load(std::memory_order_acquire)) {
+        return {};
+    }
+    EntryRef ref = _refs.acquire_elem_ref(docid).load_acquire();
+    if (!ref.valid()) {
+        return {};
+    }
+    const char* key = _keys.get(ref);
+    return {key, std::strlen(key) + 1};
+}
+
+bool
+UcaSortKeys::consider_compact(const CompactionStrategy& compaction_strategy)
+{
+    if (_refs.empty() || _keys.get_data_store().has_held_buffers()) {
+        return false;
+    }
+    auto compaction_spec = compaction_strategy.should_compact(_keys.get_values_memory_usage(),
+                                                              _keys.get_values_address_space_usage());
+    if (!compaction_spec.compact()) {
+        return false;
+    }
+    auto remapper = _keys.compact_worst(compaction_spec, compaction_strategy);
+    if (!remapper) {
+        return false;
+    }
+    remapper->remap(vespalib::ArrayRef<vespalib::datastore::AtomicEntryRef>(&_refs[0], _refs.size()));
+    remapper->done();
+    return true;
+}
+
+void
+UcaSortKeys::assign_generation(generation_t current_gen)
+{
+    _keys.assign_generation(current_gen);
+}
+
+void
+UcaSortKeys::reclaim_memory(generation_t oldest_used_gen)
+{
+    _keys.reclaim_memory(oldest_used_gen);
+}
+
+vespalib::MemoryUsage
+UcaSortKeys::get_memory_usage() const
+{
+    auto result = _refs.getMemoryUsage();
+    result.merge(_keys.getMemoryUsage());
+    return result;
+}
+
+}
+
+namespace vespalib::datastore {
+
+template class UniqueStore<const char*, search::attribute::UcaSortKeys::KeyRefType,
+                           UniqueStoreStringComparator<search::attribute::UcaSortKeys::KeyRefType>,
+                           UniqueStoreStringAllocator<search::attribute::UcaSortKeys::KeyRefType>>;
+
+}
@@ -0,0 +1,79 @@
+// Copyright Vespa.ai. Licensed under the terms of the Apache 2.0 license. See LICENSE in the project root.
+
+#pragma once
+
+#include <vespa/searchcommon/attribute/uca_sort_key_params.h>
+#include <vespa/vespalib/datastore/atomic_entry_ref.h>
+#include <vespa/vespalib/datastore/unique_store.h>
+#include <vespa/vespalib/datastore/unique_store_string_allocator.h>
+#include <vespa/vespalib/datastore/unique_store_string_comparator.h>
+#include <vespa/vespalib/util/buffer.h>
+#include <vespa/vespalib/util/growstrategy.h>
+#include <vespa/vespalib/util/rcuvector.h>
+#include <atomic>
+#include <memory>
+
+namespace search::common { class BlobConverter; }
+namespace search::uca { class UcaConverter; }
+namespace vespalib::datastore { class CompactionStrategy; }
+
+namespace search::attribute {
+
+/**
+ * Precomputed uca sort keys of the documents in a single value string
+ * attribute, for one locale and collation strength.
+ *
+ * The writer recomputes the sort key of a document when its value changes,
+ * so sorting on uca(attribute,locale,strength) only copies the stored key
+ * instead of running the collator for every hit. Each unique sort key is
+ * stored once and documents reference it. ICU sort keys are zero terminated
+ * without other zero bytes, so they are stored as strings.
+ *
+ * Documents without a stored key (never assigned a value, or beyond the
+ * documents seen by the writer) must be collated by the caller.
+ */
+class UcaSortKeys {
+public:
+    using KeyRefType = vespalib::datastore::EntryRefT<22>;
+    using KeyStore = vespalib::datastore::UniqueStore<const char*, KeyRefType,
+                                                      vespalib::datastore::UniqueStoreStringComparator<KeyRefType>,
+                                                      vespalib::datastore::UniqueStoreStringAllocator<KeyRefType>>;
+private:
+    using AtomicEntryRef = vespalib::datastore::AtomicEntryRef;
+    using EntryRef = vespalib::datastore::EntryRef;
+    using generation_t = vespalib::GenerationHandler::generation_t;
+
+    UcaSortKeyParams                        _params;
+    std::unique_ptr<uca::UcaConverter>      _converter; // only used by writer
+    KeyStore                                _keys;
+    vespalib::RcuVectorBase<AtomicEntryRef> _refs;
+    std::atomic<uint32_t>                   _num_docs; // number of refs visible to readers
+
+public:
+    UcaSortKeys(const UcaSortKeyParams& params, const vespalib::GrowStrategy& grow_strategy,
+                vespalib::GenerationHolder& gen_holder);
+    UcaSortKeys(const UcaSortKeys&) = delete;
+    UcaSortKeys& operator=(const UcaSortKeys&) = delete;
+    ~UcaSortKeys();
+
+    const UcaSortKeyParams& params() const noexcept { return _params; }
+    // Whether the given converter produces the sort keys stored here
+    bool matches(const common::BlobConverter& bc) const noexcept;
+
+    // Called by writer when the document got a new value
+    void set(uint32_t docid, const char* value);
+    // Called by writer when the lid space is shrunk
+    void shrink(uint32_t docid_limit);
+
+    // Returns the sort key of the document including the terminating zero byte, or an empty buffer if not stored
+    vespalib::ConstBufferRef get(uint32_t docid) const noexcept;
+
+    // Compacts the key store if needed, returns true if compacted
+    bool consider_compact(const vespalib::datastore::CompactionStrategy& compaction_strategy);
+    void assign_generation(generation_t current_gen);
+    void reclaim_memory(generation_t oldest_used_gen);
+    vespalib::MemoryUsage get_memory_usage() const;
+    uint32_t get_num_unique_keys() const { return _keys.getNumUniques(); }
+};
+
+}
@@ -1503,6 +1503,9 @@ lookup(const SSReader &ssReader,
          */
         _startOffset = l3StartOffset;
         _wordNum = l3WordNum;
+        if (_nextWord != nullptr) {
+            *_nextWord = lastPWord;
+        }
         return false;
     }
 
@@ -1637,6 +1640,9 @@ lookup(const SSReader &ssReader,
     }
     _startOffset = countsStartOffset;
     _wordNum = wordNum;
+    if (_nextWord != nullptr) {
+        *_nextWord = word;
+    }
     // Lookup succeded if word found.
     if (key == word) {
         _counts = counts;
@@ -546,7 +546,7 @@ public:
     StartOffset _startOffset;
     uint64_t _wordNum;
     bool _res;
-    vespalib::string *_nextWord;
+    vespalib::string *_nextWord;    // If set, receives first word >= key
 
 public:
     PageDict4PLookupRes();
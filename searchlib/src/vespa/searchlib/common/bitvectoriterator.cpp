@@ -78,6 +78,7 @@ public:
 private:
     void initRange(uint32_t begin, uint32_t end) override;
     void doSeek(uint32_t docId) override;
+    uint32_t fill_hits(uint32_t docId, uint32_t end_id, uint32_t *hits, uint32_t max_hits) override;
     Trinary is_strict() const override { return Trinary::True; }
     uint32_t getNextBit(uint32_t docId) const noexcept {
         return inverse ? this->_bv.getNextFalseBit(docId) : this->_bv.getNextTrueBit(docId);
@@ -110,6 +111,30 @@ BitVectorIteratorStrictT<inverse>::doSeek(uint32_t docId)
     }
 }
 
+template<bool inverse>
+uint32_t
+BitVectorIteratorStrictT<inverse>::fill_hits(uint32_t docId, uint32_t end_id, uint32_t *hits, uint32_t max_hits)
+{
+    docId = std::max(docId, this->getDocId());
+    end_id = std::min(end_id, this->_docIdLimit);
+    if (docId >= end_id) {
+        return 0;
+    }
+    uint32_t num_hits = 0;
+    for (docId = getNextBit(docId); docId < end_id; docId = getNextBit(docId + 1)) {
+        hits[num_hits++] = docId;
+        if (num_hits == max_hits) {
+            break;
+        }
+    }
+    if (docId >= this->_docIdLimit) {
+        this->setAtEnd();
+    } else {
+        this->setDocId(docId);
+    }
+    return num_hits;
+}
+
 template<bool inverse>
 void
 BitVectorIteratorStrictT<inverse>::initRange(uint32_t begin, uint32_t end)
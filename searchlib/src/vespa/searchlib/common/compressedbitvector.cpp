@@ -0,0 +1,374 @@
+// Copyright Vespa.ai. Licensed under the terms of the Apache 2.0 license. See LICENSE in the project root.
+
+#include "compressedbitvector.h"
+#include "bitvector.h"
+#include <vespa/vespalib/hwaccelrated/iaccelrated.h>
+#include <algorithm>
+#include <cassert>
+
+using vespalib::hwaccelrated::IAccelrated;
+
+namespace search {
+
+namespace {
+
+constexpr uint32_t WORD_BITS = 64;
+constexpr size_t BITMAP_BYTES = CompressedBitVector::BITMAP_WORDS * sizeof(CompressedBitVector::Word);
+
+uint32_t key_of(uint32_t docid) noexcept { return docid >> CompressedBitVector::CHUNK_BITS; }
+uint16_t low_of(uint32_t docid) noexcept { return docid & (CompressedBitVector::CHUNK_SIZE - 1); }
+
+}
+
+CompressedBitVector::Container::Container(uint32_t key_in) noexcept
+    : key(key_in),
+      cardinality(0),
+      array(),
+      bitmap()
+{
+}
+
+bool
+CompressedBitVector::Container::test(uint16_t low) const noexcept
+{
+    if (is_bitmap()) {
+        return (bitmap[low / WORD_BITS] & (Word(1) << (low % WORD_BITS))) != 0;
+    }
+    return std::binary_search(array.begin(), array.end(), low);
+}
+
+void
+CompressedBitVector::Container::to_bitmap()
+{
+    bitmap.assign(BITMAP_WORDS, 0);
+    for (uint16_t low : array) {
+        bitmap[low / WORD_BITS] |= Word(1) << (low % WORD_BITS);
+    }
+    array.clear();
+    array.shrink_to_fit();
+}
+
+void
+CompressedBitVector::Container::normalize()
+{
+    if (is_bitmap()) {
+        if (cardinality <= MAX_ARRAY_SIZE) {
+            array.clear();
+            array.reserve(cardinality);
+            for (uint32_t i = 0; i < BITMAP_WORDS; ++i) {
+                for (Word w = bitmap[i]; w != 0; w &= w - 1) {
+                    array.push_back(i * WORD_BITS + vespalib::Optimized::lsbIdx(w));
+                }
+            }
+            bitmap.clear();
+            bitmap.shrink_to_fit();
+        }
+    } else if (cardinality > MAX_ARRAY_SIZE) {
+        to_bitmap();
+    }
+}
+
+bool
+CompressedBitVector::Container::operator==(const Container &rhs) const noexcept
+{
+    return (key == rhs.key) && (cardinality == rhs.cardinality) && (array == rhs.array) && (bitmap == rhs.bitmap);
+}
+
+CompressedBitVector::CompressedBitVector(Index sz)
+    : _containers(),
+      _sz(sz)
+{
+}
+
+CompressedBitVector::CompressedBitVector(const CompressedBitVector &) = default;
+CompressedBitVector & CompressedBitVector::operator = (const CompressedBitVector &) = default;
+CompressedBitVector::CompressedBitVector(CompressedBitVector &&) noexcept = default;
+CompressedBitVector & CompressedBitVector::operator = (CompressedBitVector &&) noexcept = default;
+CompressedBitVector::~CompressedBitVector() = default;
+
+CompressedBitVector
+CompressedBitVector::create(vespalib::ConstArrayRef<uint32_t> docids, Index sz)
+{
+    CompressedBitVector result(sz);
+    auto itr = docids.begin();
+    while (itr != docids.end()) {
+        uint32_t key = key_of(*itr);
+        auto end = std::find_if(itr, docids.end(), [key](uint32_t docid) noexcept { return key_of(docid) != key; });
+        Container &c = result._containers.emplace_back(key);
+        c.cardinality = end - itr;
+        c.array.reserve(std::min(c.cardinality, MAX_ARRAY_SIZE + 1));
+        for (; itr != end; ++itr) {
+            assert(*itr < sz);
+            c.array.push_back(low_of(*itr));
+        }
+        c.normalize();
+    }
+    return result;
+}
+
+CompressedBitVector
+CompressedBitVector::create(const BitVector &bv)
+{
+    std::vector<uint32_t> docids;
+    docids.reserve(bv.countTrueBits());
+    bv.foreach_truebit([&docids](uint32_t docid) { docids.push_back(docid); });
+    return create(docids, bv.size());
+}
+
+CompressedBitVector::Index
+CompressedBitVector::countTrueBits() const noexcept
+{
+    Index sum = 0;
+    for (const auto &c : _containers) {
+        sum += c.cardinality;
+    }
+    return sum;
+}
+
+bool
+CompressedBitVector::testBit(Index idx) const noexcept
+{
+    uint32_t key = key_of(idx);
+    auto itr = std::lower_bound(_containers.begin(), _containers.end(), key,
+                                [](const Container &c, uint32_t k) noexcept { return c.key < k; });
+    return (itr != _containers.end()) && (itr->key == key) && itr->test(low_of(idx));
+}
+
+CompressedBitVector::Index
+CompressedBitVector::getNextTrueBit(Index start, size_t &hint) const noexcept
+{
+    uint32_t key = key_of(start);
+    if ((hint >= _containers.size()) || (_containers[hint].key > key)) {
+        hint = 0;
+    }
+    auto itr = std::lower_bound(_containers.begin() + hint, _containers.end(), key,
+                                [](const Container &c, uint32_t k) noexcept { return c.key < k; });
+    for (; itr != _containers.end(); ++itr) {
+        hint = itr - _containers.begin();
+        uint32_t low = (itr->key == key) ? low_of(start) : 0;
+        Index base = itr->key << CHUNK_BITS;
+        if (itr->is_bitmap()) {
+            uint32_t i = low / WORD_BITS;
+            Word w = itr->bitmap[i] & (~Word(0) << (low % WORD_BITS));
+            while (w == 0 && ++i < BITMAP_WORDS) {
+                w = itr->bitmap[i];
+            }
+            if (w != 0) {
+                return base + i * WORD_BITS + vespalib::Optimized::lsbIdx(w);
+            }
+        } else {
+            auto pos = std::lower_bound(itr->array.begin(), itr->array.end(), low);
+            if (pos != itr->array.end()) {
+                return base + *pos;
+            }
+        }
+    }
+    return _sz;
+}
+
+CompressedBitVector::Container
+CompressedBitVector::and_containers(const Container &a, const Container &b)
+{
+    Container result(a.key);
+    if (a.is_bitmap() && b.is_bitmap()) {
+        result.bitmap = a.bitmap;
+        const auto &accelerator = IAccelrated::getAccelerator();
+        accelerator.andBit(result.bitmap.data(), b.bitmap.data(), BITMAP_BYTES);
+        result.cardinality = accelerator.populationCount(result.bitmap.data(), BITMAP_WORDS);
+    } else if (a.is_bitmap() || b.is_bitmap()) {
+        const Container &bitmap = a.is_bitmap() ? a : b;
+        const Container &array = a.is_bitmap() ? b : a;
+        result.array.reserve(array.array.size());
+        for (uint16_t low : array.array) {
+            if (bitmap.test(low)) {
+                result.array.push_back(low);
+            }
+        }
+        result.cardinality = result.array.size();
+    } else {
+        result.array.reserve(std::min(a.array.size(), b.array.size()));
+        std::set_intersection(a.array.begin(), a.array.end(), b.array.begin(), b.array.end(),
+                              std::back_inserter(result.array));
+        result.cardinality = result.array.size();
+    }
+    result.normalize();
+    return result;
+}
+
+CompressedBitVector::Container
+CompressedBitVector::or_containers(const Container &a, const Container &b)
+{
+    Container result(a.key);
+    if (a.is_bitmap() || b.is_bitmap()) {
+        const Container &bitmap = a.is_bitmap() ? a : b;
+        const Container &other = a.is_bitmap() ? b : a;
+        result.bitmap = bitmap.bitmap;
+        const auto &accelerator = IAccelrated::getAccelerator();
+        if (other.is_bitmap()) {
+            accelerator.orBit(result.bitmap.data(), other.bitmap.data(), BITMAP_BYTES);
+        } else {
+            for (uint16_t low : other.array) {
+                result.bitmap[low / WORD_BITS] |= Word(1) << (low % WORD_BITS);
+            }
+        }
+        result.cardinality = accelerator.populationCount(result.bitmap.data(), BITMAP_WORDS);
+    } else {
+        result.array.reserve(a.array.size() + b.array.size());
+        std::set_union(a.array.begin(), a.array.end(), b.array.begin(), b.array.end(),
+                       std::back_inserter(result.array));
+        result.cardinality = result.array.size();
+    }
+    result.normalize();
+    return result;
+}
+
+void
+CompressedBitVector::andWith(const CompressedBitVector &right)
+{
+    std::vector<Container> result;
+    auto a = _containers.begin();
+    auto b = right._containers.begin();
+    while (a != _containers.end() && b != right._containers.end()) {
+        if (a->key < b->key) {
+            ++a;
+        } else if (b->key < a->key) {
+            ++b;
+        } else {
+            Container c = and_containers(*a, *b);
+            if (c.cardinality > 0) {
+                result.push_back(std::move(c));
+            }
+            ++a;
+            ++b;
+        }
+    }
+    _containers = std::move(result);
+}
+
+void
+CompressedBitVector::orWith(const CompressedBitVector &right)
+{
+    std::vector<Container> result;
+    result.reserve(std::max(_containers.size(), right._containers.size()));
+    auto a = _containers.begin();
+    auto b = right._containers.begin();
+    while (a != _containers.end() || b != right._containers.end()) {
+        if (b == right._containers.end() || ((a != _containers.end()) && (a->key < b->key))) {
+            result.push_back(std::move(*a++));
+        } else if (a == _containers.end() || (b->key < a->key)) {
+            result.push_back(*b++);
+        } else {
+            result.push_back(or_containers(*a, *b));
+            ++a;
+            ++b;
+        }
+    }
+    _containers = std::move(result);
+    _sz = std::max(_sz, right._sz);
+}
+
+void
+CompressedBitVector::orInto(BitVector &result) const
+{
+    Index start = result.getStartIndex();
+    Index end = result.size();
+    auto *words = static_cast<Word *>(result.getStart());
+    const auto &accelerator = IAccelrated::getAccelerator();
+    for (const auto &c : _containers) {
+        Index base = c.key << CHUNK_BITS;
+        if (base >= end) {
+            break;
+        }
+        if ((base + CHUNK_SIZE) <= start) {
+            continue;
+        }
+        if (c.is_bitmap() && (base >= start) && ((base + CHUNK_SIZE) <= end)) {
+            accelerator.orBit(words + (base / WORD_BITS), c.bitmap.data(), BITMAP_BYTES);
+        } else if (c.is_bitmap()) {
+            for (uint32_t i = 0; i < BITMAP_WORDS; ++i) {
+                for (Word w = c.bitmap[i]; w != 0; w &= w - 1) {
+                    Index docid = base + i * WORD_BITS + vespalib::Optimized::lsbIdx(w);
+                    if ((docid >= start) && (docid < end)) {
+                        result.setBit(docid);
+                    }
+                }
+            }
+        } else {
+            for (uint16_t low : c.array) {
+                Index docid = base + low;
+                if ((docid >= start) && (docid < end)) {
+                    result.setBit(docid);
+                }
+            }
+        }
+    }
+    result.invalidateCachedCount();
+}
+
+void
+CompressedBitVector::andInto(BitVector &result) const
+{
+    Index start = result.getStartIndex();
+    Index end = result.size();
+    auto *words = static_cast<Word *>(result.getStart());
+    const auto &accelerator = IAccelrated::getAccelerator();
+    std::vector<Word> expanded;
+    Index cleared_to = start;
+    for (const auto &c : _containers) {
+        Index base = c.key << CHUNK_BITS;
+        if (base >= end) {
+            break;
+        }
+        Index chunk_end = base + CHUNK_SIZE;
+        if (chunk_end <= start) {
+            continue;
+        }
+        if (cleared_to < base) {
+            result.clearInterval(cleared_to, base);
+        }
+        cleared_to = std::min(chunk_end, end);
+        if ((base >= start) && (chunk_end <= end)) {
+            const Word *bitmap = c.bitmap.data();
+            if (!c.is_bitmap()) {
+                expanded.assign(BITMAP_WORDS, 0);
+                for (uint16_t low : c.array) {
+                    expanded[low / WORD_BITS] |= Word(1) << (low % WORD_BITS);
+                }
+                bitmap = expanded.data();
+            }
+            accelerator.andBit(words + (base / WORD_BITS), bitmap, BITMAP_BYTES);
+        } else {
+            Index from = std::max(base, start);
+            for (Index docid = result.getNextTrueBit(from); docid < cleared_to; docid = result.getNextTrueBit(docid + 1)) {
+                if (!c.test(low_of(docid))) {
+                    result.clearBit(docid);
+                }
+            }
+        }
+    }
+    if (cleared_to < end) {
+        result.clearInterval(cleared_to, end);
+    }
+    result.invalidateCachedCount();
+}
+
+vespalib::MemoryUsage
+CompressedBitVector::getMemoryUsage() const noexcept
+{
+    vespalib::MemoryUsage usage;
+    usage.incAllocatedBytes(_containers.capacity() * sizeof(Container));
+    usage.incUsedBytes(_containers.size() * sizeof(Container));
+    for (const auto &c : _containers) {
+        usage.incAllocatedBytes(c.array.capacity() * sizeof(uint16_t) + c.bitmap.capacity() * sizeof(Word));
+        usage.incUsedBytes(c.array.size() * sizeof(uint16_t) + c.bitmap.size() * sizeof(Word));
+    }
+    return usage;
+}
+
+bool
+CompressedBitVector::operator==(const CompressedBitVector &rhs) const noexcept
+{
+    return (_sz == rhs._sz) && (_containers == rhs._containers);
+}
+
+}
@@ -0,0 +1,129 @@
+// Copyright Vespa.ai. Licensed under the terms of the Apache 2.0 license. See LICENSE in the project root.
+
+#pragma once
+
+#include <vespa/vespalib/util/arrayref.h>
+#include <vespa/vespalib/util/memoryusage.h>
+#include <vespa/vespalib/util/optimized.h>
+#include <cstdint>
+#include <vector>
+
+namespace search {
+
+class BitVector;
+
+/**
+ * Compressed bit vector for sets of document ids that are too dense
+ * for sorted arrays and too sparse for a full bit vector, e.g. terms
+ * matching 0.1-3% of the documents.
+ *
+ * The docid space is split into chunks of 2^16 docids, each with a
+ * container (roaring bitmap layout). A chunk with at most
+ * MAX_ARRAY_SIZE docids stores them as a sorted array of 16-bit
+ * offsets. A denser chunk stores a bitmap of 1024 words. Chunks
+ * without docids have no container. AND and OR on bitmap containers
+ * use the hardware accelerated bit operations also used by BitVector.
+ */
+class CompressedBitVector
+{
+public:
+    using Index = uint32_t;
+    using Word = uint64_t;
+    static constexpr uint32_t CHUNK_BITS = 16;
+    static constexpr Index CHUNK_SIZE = Index(1) << CHUNK_BITS;
+    static constexpr uint32_t BITMAP_WORDS = CHUNK_SIZE / (8 * sizeof(Word));
+    // A bitmap container uses less memory than an array container above this size
+    static constexpr uint32_t MAX_ARRAY_SIZE = 4096;
+
+    explicit CompressedBitVector(Index sz);
+    CompressedBitVector(const CompressedBitVector &);
+    CompressedBitVector & operator = (const CompressedBitVector &);
+    CompressedBitVector(CompressedBitVector &&) noexcept;
+    CompressedBitVector & operator = (CompressedBitVector &&) noexcept;
+    ~CompressedBitVector();
+
+    /**
+     * Create from sorted and unique docids, all less than sz.
+     */
+    static CompressedBitVector create(vespalib::ConstArrayRef<uint32_t> docids, Index sz);
+    static CompressedBitVector create(const BitVector &bv);
+
+    Index size() const noexcept { return _sz; }
+    Index countTrueBits() const noexcept;
+    bool testBit(Index idx) const noexcept;
+
+    /**
+     * Get next bit set (inclusive start), or size() if there is none.
+     * The container hint (initially 0) avoids searching from the first
+     * container when called with increasing start.
+     */
+    Index getNextTrueBit(Index start, size_t &hint) const noexcept;
+    Index getNextTrueBit(Index start) const noexcept {
+        size_t hint = 0;
+        return getNextTrueBit(start, hint);
+    }
+
+    template <typename FunctionType>
+    void foreach_truebit(FunctionType func) const;
+
+    void andWith(const CompressedBitVector &right);
+    // The size becomes the largest of the two sizes
+    void orWith(const CompressedBitVector &right);
+
+    /**
+     * Set the bits in the given bit vector that are set in this one,
+     * limited to the range of the given bit vector.
+     */
+    void orInto(BitVector &result) const;
+    /**
+     * Clear the bits in the given bit vector that are not set in this one.
+     */
+    void andInto(BitVector &result) const;
+
+    size_t numContainers() const noexcept { return _containers.size(); }
+    vespalib::MemoryUsage getMemoryUsage() const noexcept;
+    bool operator == (const CompressedBitVector &rhs) const noexcept;
+
+private:
+    struct Container {
+        uint32_t              key;          // docid >> CHUNK_BITS
+        uint32_t              cardinality;
+        std::vector<uint16_t> array;        // used when not a bitmap
+        std::vector<Word>     bitmap;       // BITMAP_WORDS words, or empty
+        Container(uint32_t key_in) noexcept;
+        bool is_bitmap() const noexcept { return !bitmap.empty(); }
+        bool test(uint16_t low) const noexcept;
+        void to_bitmap();
+        void normalize();
+        bool operator == (const Container &rhs) const noexcept;
+    };
+    static Container and_containers(const Container &a, const Container &b);
+    static Container or_containers(const Container &a, const Container &b);
+
+    std::vector<Container> _containers;    // sorted on key
+    Index                  _sz;
+};
+
+template <typename FunctionType>
+void
+CompressedBitVector::foreach_truebit(FunctionType func) const
+{
+    for (const auto &c : _containers) {
+        Index base = c.key << CHUNK_BITS;
+        if (c.is_bitmap()) {
+            for (uint32_t i = 0; i < BITMAP_WORDS; ++i) {
+                Word w = c.bitmap[i];
+                while (w != 0) {
+                    func(base + i * 64 + vespalib::Optimized::lsbIdx(w));
+                    w &= w - 1;
+                }
+            }
+        } else {
+            for (uint16_t low : c.array) {
+                func(base + low);
+            }
+        }
+    }
+}
+
+}
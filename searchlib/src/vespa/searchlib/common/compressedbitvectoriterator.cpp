@@ -0,0 +1,128 @@
+// Copyright Vespa.ai. Licensed under the terms of the Apache 2.0 license. See LICENSE in the project root.
+
+#include "compressedbitvectoriterator.h"
+#include "bitvector.h"
+#include <vespa/searchlib/fef/termfieldmatchdata.h>
+#include <vespa/searchlib/queryeval/emptysearch.h>
+#include <vespa/vespalib/objects/visit.h>
+
+namespace search {
+
+using fef::TermFieldMatchData;
+using vespalib::Trinary;
+
+CompressedBitVectorIterator::CompressedBitVectorIterator(const CompressedBitVector & bv, uint32_t docIdLimit,
+                                                         TermFieldMatchData & matchData)
+    : _docIdLimit(std::min(docIdLimit, bv.size())),
+      _bv(bv),
+      _tfmd(matchData)
+{
+    _tfmd.reset(0);
+}
+
+void
+CompressedBitVectorIterator::initRange(uint32_t begin, uint32_t end)
+{
+    SearchIterator::initRange(begin, end);
+    if (begin >= _docIdLimit) {
+        setAtEnd();
+    }
+}
+
+void
+CompressedBitVectorIterator::visitMembers(vespalib::ObjectVisitor &visitor) const
+{
+    SearchIterator::visitMembers(visitor);
+    visit(visitor, "docIdLimit", _docIdLimit);
+    visit(visitor, "containers", _bv.numContainers());
+}
+
+void
+CompressedBitVectorIterator::doUnpack(uint32_t docId)
+{
+    _tfmd.resetOnlyDocId(docId);
+}
+
+BitVector::UP
+CompressedBitVectorIterator::get_hits(uint32_t begin_id)
+{
+    BitVector::UP result = BitVector::create(begin_id, getEndId());
+    _bv.orInto(*result);
+    if (begin_id < getDocId()) {
+        result->clearInterval(begin_id, getDocId());
+    }
+    return result;
+}
+
+void
+CompressedBitVectorIterator::or_hits_into(BitVector &result, uint32_t)
+{
+    _bv.orInto(result);
+}
+
+void
+CompressedBitVectorIterator::and_hits_into(BitVector &result, uint32_t)
+{
+    _bv.andInto(result);
+}
+
+namespace {
+
+class CompressedBitVectorIteratorNonStrict : public CompressedBitVectorIterator {
+public:
+    CompressedBitVectorIteratorNonStrict(const CompressedBitVector & bv, uint32_t docIdLimit, TermFieldMatchData & matchData)
+        : CompressedBitVectorIterator(bv, docIdLimit, matchData)
+    {}
+    void doSeek(uint32_t docId) override {
+        if (__builtin_expect(docId >= _docIdLimit, false)) {
+            setAtEnd();
+        } else if (_bv.testBit(docId)) {
+            setDocId(docId);
+        }
+    }
+    Trinary is_strict() const override { return Trinary::False; }
+};
+
+class CompressedBitVectorIteratorStrict : public CompressedBitVectorIterator {
+    size_t _hint;
+public:
+    CompressedBitVectorIteratorStrict(const CompressedBitVector & bv, uint32_t docIdLimit, TermFieldMatchData & matchData)
+        : CompressedBitVectorIterator(bv, docIdLimit, matchData),
+          _hint(0)
+    {}
+    void initRange(uint32_t begin, uint32_t end) override {
+        CompressedBitVectorIterator::initRange(begin, end);
+        _hint = 0;
+        if (!isAtEnd()) {
+            doSeek(begin);
+        }
+    }
+    void doSeek(uint32_t docId) override {
+        if (__builtin_expect(docId < _docIdLimit, true)) {
+            docId = _bv.getNextTrueBit(docId, _hint);
+        }
+        if (__builtin_expect(docId >= _docIdLimit, false)) {
+            setAtEnd();
+        } else {
+            setDocId(docId);
+        }
+    }
+    Trinary is_strict() const override { return Trinary::True; }
+};
+
+}
+
+queryeval::SearchIterator::UP
+CompressedBitVectorIterator::create(const CompressedBitVector *const bv, uint32_t docIdLimit,
+                                    TermFieldMatchData &matchData, bool strict)
+{
+    if (bv == nullptr) {
+        return std::make_unique<queryeval::EmptySearch>();
+    } else if (strict) {
+        return std::make_unique<CompressedBitVectorIteratorStrict>(*bv, docIdLimit, matchData);
+    } else {
+        return std::make_unique<CompressedBitVectorIteratorNonStrict>(*bv, docIdLimit, matchData);
+    }
+}
+
+}
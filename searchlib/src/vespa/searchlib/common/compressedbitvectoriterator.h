@@ -0,0 +1,37 @@
+// Copyright Vespa.ai. Licensed under the terms of the Apache 2.0 license. See LICENSE in the project root.
+
+#pragma once
+
+#include "compressedbitvector.h"
+#include <vespa/searchlib/queryeval/searchiterator.h>
+
+namespace search {
+
+namespace fef { class TermFieldMatchData; }
+
+/**
+ * Search iterator over a CompressedBitVector. Term-at-a-time evaluation
+ * (get_hits, or_hits_into, and_hits_into) works on whole containers.
+ */
+class CompressedBitVectorIterator : public queryeval::SearchIterator
+{
+protected:
+    CompressedBitVectorIterator(const CompressedBitVector & bv, uint32_t docIdLimit, fef::TermFieldMatchData &matchData);
+    void initRange(uint32_t begin, uint32_t end) override;
+
+    uint32_t                    _docIdLimit;
+    const CompressedBitVector & _bv;
+private:
+    void visitMembers(vespalib::ObjectVisitor &visitor) const override;
+    void doUnpack(uint32_t docId) final;
+    std::unique_ptr<BitVector> get_hits(uint32_t begin_id) override;
+    void or_hits_into(BitVector &result, uint32_t begin_id) override;
+    void and_hits_into(BitVector &result, uint32_t begin_id) override;
+    fef::TermFieldMatchData  &_tfmd;
+public:
+    uint32_t getDocIdLimit() const noexcept { return _docIdLimit; }
+    static UP create(const CompressedBitVector *const bv, uint32_t docIdLimit,
+                     fef::TermFieldMatchData &matchData, bool strict);
+};
+
+}
@@ -103,6 +103,23 @@ struct IDocumentMetaStore {
      **/
     virtual void getMetaData(const BucketId &bucketId, DocumentMetaData::Vector &result) const = 0;
 
+    /**
+     * Retrieves meta data for documents contained in the given bucket with
+     * timestamp in the range [fromTimestamp, toTimestamp]. Stores with an
+     * index ordered on bucket and timestamp can skip documents outside the
+     * range, the default implementation filters the result of getMetaData().
+     **/
+    virtual void getMetaDataInRange(const BucketId &bucketId, Timestamp fromTimestamp, Timestamp toTimestamp,
+                                    DocumentMetaData::Vector &result) const {
+        DocumentMetaData::Vector all;
+        getMetaData(bucketId, all);
+        for (const auto &meta : all) {
+            if (meta.timestamp >= fromTimestamp && meta.timestamp <= toTimestamp) {
+                result.push_back(meta);
+            }
+        }
+    }
+
     /**
      * Returns the lid following the largest lid used in the store.
      *
@@ -24,7 +24,8 @@ FS4PersistentPacketStreamer::
 FS4PersistentPacketStreamer()
     : _compressionLimit(0),
       _compressionLevel(9),
-      _compressionType(CompressionConfig::LZ4)
+      _compressionType(CompressionConfig::LZ4),
+      _adaptiveCompression(false)
 { }
 
 //============================================================
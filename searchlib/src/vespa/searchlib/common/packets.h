@@ -20,6 +20,7 @@ class FS4PersistentPacketStreamer {
     std::atomic<unsigned int> _compressionLimit;
     std::atomic<unsigned int> _compressionLevel;
     std::atomic<CompressionConfig::Type> _compressionType;
+    std::atomic<bool> _adaptiveCompression;
 
 public:
     static FS4PersistentPacketStreamer Instance;
@@ -29,7 +30,9 @@ public:
     void SetCompressionLimit(unsigned int limit) { _compressionLimit.store(limit, std::memory_order_relaxed); }
     void SetCompressionLevel(unsigned int level) { _compressionLevel.store(level, std::memory_order_relaxed); }
     void SetCompressionType(CompressionConfig::Type compressionType) { _compressionType.store(compressionType, std::memory_order_relaxed); }
+    void SetAdaptiveCompression(bool adaptive) { _adaptiveCompression.store(adaptive, std::memory_order_relaxed); }
     CompressionConfig::Type getCompressionType() const { return _compressionType.load(std::memory_order_relaxed); }
+    bool getAdaptiveCompression() const { return _adaptiveCompression.load(std::memory_order_relaxed); }
     uint32_t getCompressionLimit() const { return _compressionLimit.load(std::memory_order_relaxed); }
     uint32_t getCompressionLevel() const { return _compressionLevel.load(std::memory_order_relaxed); }
 };
@@ -5,6 +5,7 @@
 #include <vespa/searchcommon/attribute/iattributecontext.h>
 #include <vespa/vespalib/util/array.h>
 #include <vespa/vespalib/util/issue.h>
+#include <algorithm>
 
 using vespalib::Issue;
 
@@ -22,6 +23,8 @@ using namespace vespalib;
 namespace {
 
 constexpr size_t MMAP_LIMIT = 0x2000000;
+// Only select top-k candidates when at most this fraction of the hits is needed.
+constexpr uint32_t TOPK_SELECTION_FACTOR = 4;
 
 template<typename T>
 class RadixHelper
@@ -426,9 +429,67 @@ public:
 };
 
 
+/**
+ * Top-k selection is used when only a small prefix of the hits is needed and
+ * the primary sort key is a single value numeric attribute, which serializes
+ * to at most 8 bytes and can be compared as an unsigned integer.
+ */
+bool
+FastS_SortSpec::useTopKSelection(uint32_t n, uint32_t topn) const
+{
+    if (_vectors.empty() || (topn == 0) || (topn >= n / TOPK_SELECTION_FACTOR)) {
+        return false;
+    }
+    const VectorRef & primary = _vectors[0];
+    if ((primary._type != ASC_VECTOR) && (primary._type != DESC_VECTOR)) {
+        return false;
+    }
+    size_t width = primary._vector->getFixedWidth();
+    return (width > 0) && (width <= sizeof(uint64_t)) && !primary._vector->hasMultiValue();
+}
+
+/**
+ * Move the hits that may end up among the top 'topn' hits to the front of the
+ * array and return their count. Only the primary sort key is read directly
+ * from the attribute to find the k-th best key; all hits with a key at least as
+ * good are candidates, so ties at the threshold are resolved by the full sort.
+ */
+uint32_t
+FastS_SortSpec::selectTopKCandidates(RankedHit a[], uint32_t n, uint32_t topn)
+{
+    const VectorRef & primary = _vectors[0];
+    std::vector<uint64_t, vespalib::allocator_large<uint64_t>> keys(n);
+    for (uint32_t i(0); i < n; ++i) {
+        uint8_t buf[sizeof(uint64_t)] = {};
+        if (primary._type == ASC_VECTOR) {
+            primary._vector->serializeForAscendingSort(a[i].getDocId(), buf, sizeof(buf), primary._converter);
+        } else {
+            primary._vector->serializeForDescendingSort(a[i].getDocId(), buf, sizeof(buf), primary._converter);
+        }
+        uint64_t key = 0;
+        for (uint8_t byte : buf) {
+            key = (key << 8) | byte;
+        }
+        keys[i] = key;
+    }
+    std::vector<uint64_t, vespalib::allocator_large<uint64_t>> selected(keys);
+    std::nth_element(selected.begin(), selected.begin() + (topn - 1), selected.end());
+    uint64_t threshold = selected[topn - 1];
+    uint32_t candidates = 0;
+    for (uint32_t i(0); i < n; ++i) {
+        if (keys[i] <= threshold) {
+            std::swap(a[candidates++], a[i]);
+        }
+    }
+    return candidates;
+}
+
 void
 FastS_SortSpec::sortResults(RankedHit a[], uint32_t n, uint32_t topn)
 {
+    if (useTopKSelection(n, topn)) {
+        n = selectTopKCandidates(a, n, topn);
+    }
     initSortData(a, n);
     {
         SortData * sortData = _sortDataArray.data();
@@ -105,6 +105,8 @@ private:
     SortDataArray            _sortDataArray;
 
     bool Add(search::attribute::IAttributeContext & vecMan, const search::common::SortInfo & sInfo);
+    bool useTopKSelection(uint32_t n, uint32_t topn) const;
+    uint32_t selectTopKCandidates(search::RankedHit a[], uint32_t n, uint32_t topn);
     void initSortData(const search::RankedHit *a, uint32_t n);
     int initSortData(const VectorRef & vec, const search::RankedHit & hit, size_t offset);
 
@@ -7,6 +7,7 @@
 #include <vespa/searchlib/index/bitvectorkeys.h>
 #include <vespa/searchlib/util/file_settings.h>
 #include <vespa/vespalib/data/fileheader.h>
+#include <vespa/vespalib/util/io_scheduler.h>
 #include <vespa/vespalib/util/size_literals.h>
 #include <vespa/fastlib/io/bufferedfile.h>
 #include <cassert>
@@ -117,6 +118,7 @@ BitVectorFileWrite::addWordSingle(uint64_t wordNum, const BitVector &bitVector)
     assert(bitVector.size() == _docIdLimit);
     bitVector.invalidateCachedCount();
     Parent::addWordSingle(wordNum, bitVector.countTrueBits());
+    vespalib::IoScheduler::throttle(bitVector.getFileBytes());
     _datFile->WriteBuf(bitVector.getStart(), bitVector.getFileBytes());
 }
 
@@ -0,0 +1,236 @@
+// Copyright Vespa.ai. Licensed under the terms of the Apache 2.0 license. See LICENSE in the project root.
+
+#include "block_docid_codec.h"
+#include <array>
+#include <cassert>
+#include <cstring>
+#include <utility>
+
+namespace search::diskindex {
+
+namespace {
+
+constexpr uint32_t LANES = BlockDocIdEncoder::LANES;
+constexpr uint32_t SLOTS = BlockDocIdEncoder::BLOCK_SIZE / LANES;
+
+void
+encode_varint(uint32_t num, std::vector<uint8_t> &buf)
+{
+    while (num >= (1u << 7)) {
+        buf.push_back((num & ((1u << 7) - 1)) | (1u << 7));
+        num >>= 7;
+    }
+    buf.push_back(num);
+}
+
+uint32_t
+decode_varint(const uint8_t *&pos)
+{
+    uint32_t num = 0;
+    for (uint32_t shift = 0; ; shift += 7) {
+        uint8_t byte = *pos++;
+        num |= uint32_t(byte & ((1u << 7) - 1)) << shift;
+        if (byte < (1u << 7)) {
+            return num;
+        }
+    }
+}
+
+uint32_t
+bit_width(uint32_t value)
+{
+    return (value == 0) ? 0 : (32 - __builtin_clz(value));
+}
+
+constexpr size_t
+packed_bytes(uint32_t bits)
+{
+    return size_t(bits) * LANES * sizeof(uint32_t);
+}
+
+template <uint32_t BITS>
+void
+unpack(const uint32_t *in, uint32_t *out)
+{
+    if constexpr (BITS == 0) {
+        memset(out, 0, BlockDocIdEncoder::BLOCK_SIZE * sizeof(uint32_t));
+    } else {
+        constexpr uint32_t mask = (BITS == 32) ? UINT32_MAX : ((1u << BITS) - 1);
+        for (uint32_t slot = 0; slot < SLOTS; ++slot) {
+            uint32_t bit = slot * BITS;
+            const uint32_t *word = in + (bit / 32) * LANES;
+            uint32_t offset = bit % 32;
+            if (offset + BITS > 32) {
+                for (uint32_t lane = 0; lane < LANES; ++lane) {
+                    out[slot * LANES + lane] = ((word[lane] >> offset) | (word[lane + LANES] << (32 - offset))) & mask;
+                }
+            } else {
+                for (uint32_t lane = 0; lane < LANES; ++lane) {
+                    out[slot * LANES + lane] = (word[lane] >> offset) & mask;
+                }
+            }
+        }
+    }
+}
+
+using UnpackFunc = void (*)(const uint32_t *, uint32_t *);
+
+template <size_t... BITS>
+constexpr std::array<UnpackFunc, sizeof...(BITS)>
+make_unpack_table(std::index_sequence<BITS...>)
+{
+    return {{ &unpack<BITS>... }};
+}
+
+constexpr auto unpack_table = make_unpack_table(std::make_index_sequence<33>());
+
+}
+
+void
+BlockDocIdEncoder::pack_block(const uint32_t *deltas, uint32_t bits, uint32_t *out)
+{
+    memset(out, 0, packed_bytes(bits));
+    for (uint32_t lane = 0; lane < LANES; ++lane) {
+        uint64_t acc = 0;
+        uint32_t shift = 0;
+        uint32_t word = 0;
+        for (uint32_t slot = 0; slot < SLOTS; ++slot) {
+            acc |= uint64_t(deltas[slot * LANES + lane]) << shift;
+            shift += bits;
+            if (shift >= 32) {
+                out[word * LANES + lane] = acc;
+                acc >>= 32;
+                shift -= 32;
+                ++word;
+            }
+        }
+    }
+}
+
+void
+BlockDocIdEncoder::encode(vespalib::ConstArrayRef<uint32_t> docids, std::vector<uint8_t> &buf, uint32_t prev)
+{
+    uint32_t start_prev = prev;
+    std::array<uint32_t, BLOCK_SIZE> deltas;
+    std::array<uint32_t, BLOCK_SIZE> packed;
+    size_t i = 0;
+    for (; i + BLOCK_SIZE <= docids.size(); i += BLOCK_SIZE) {
+        uint32_t max_delta = 0;
+        for (uint32_t j = 0; j < BLOCK_SIZE; ++j) {
+            uint32_t docid = docids[i + j];
+            deltas[j] = docid - prev - 1;
+            max_delta |= deltas[j];
+            prev = docid;
+        }
+        uint32_t bits = bit_width(max_delta);
+        uint32_t block_prev = (i == 0) ? start_prev : docids[i - 1];
+        encode_varint(prev - block_prev - 1, buf);
+        buf.push_back(bits);
+        pack_block(deltas.data(), bits, packed.data());
+        const uint8_t *packed_start = reinterpret_cast<const uint8_t *>(packed.data());
+        buf.insert(buf.end(), packed_start, packed_start + packed_bytes(bits));
+    }
+    for (; i < docids.size(); ++i) {
+        encode_varint(docids[i] - prev - 1, buf);
+        prev = docids[i];
+    }
+}
+
+BlockDocIdDecoder::BlockDocIdDecoder()
+    : _pos(nullptr),
+      _full_blocks_left(0),
+      _tail_docs(0),
+      _prev_last(UINT32_MAX),
+      _idx(0),
+      _count(0),
+      _buf_ordinal(0),
+      _next_ordinal(0),
+      _buf()
+{
+}
+
+void
+BlockDocIdDecoder::setup(const uint8_t *data, uint32_t num_docs, uint32_t prev)
+{
+    _pos = data;
+    _full_blocks_left = num_docs / BLOCK_SIZE;
+    _tail_docs = num_docs % BLOCK_SIZE;
+    _prev_last = prev;
+    _idx = 0;
+    _count = 0;
+    _buf_ordinal = 0;
+    _next_ordinal = 0;
+}
+
+void
+BlockDocIdDecoder::unpack_block(const uint32_t *in, uint32_t bits, uint32_t *out)
+{
+    assert(bits <= 32);
+    unpack_table[bits](in, out);
+}
+
+void
+BlockDocIdDecoder::decode_block(uint32_t bits)
+{
+    uint32_t packed[BLOCK_SIZE];
+    // Copy to get aligned words, the blocks are not aligned in the file
+    memcpy(packed, _pos, packed_bytes(bits));
+    _pos += packed_bytes(bits);
+    unpack_block(packed, bits, _buf);
+    uint32_t prev = _prev_last;
+    for (uint32_t i = 0; i < BLOCK_SIZE; ++i) {
+        prev += _buf[i] + 1;
+        _buf[i] = prev;
+    }
+    _prev_last = prev;
+    _idx = 0;
+    _count = BLOCK_SIZE;
+    _buf_ordinal = _next_ordinal;
+    _next_ordinal += BLOCK_SIZE;
+}
+
+void
+BlockDocIdDecoder::decode_tail()
+{
+    uint32_t prev = _prev_last;
+    for (uint32_t i = 0; i < _tail_docs; ++i) {
+        prev += decode_varint(_pos) + 1;
+        _buf[i] = prev;
+    }
+    _prev_last = prev;
+    _idx = 0;
+    _count = _tail_docs;
+    _buf_ordinal = _next_ordinal;
+    _next_ordinal += _tail_docs;
+    _tail_docs = 0;
+}
+
+uint32_t
+BlockDocIdDecoder::seek_slow(uint32_t docid)
+{
+    _idx = 0;
+    _count = 0;
+    while (_full_blocks_left > 0) {
+        --_full_blocks_left;
+        uint32_t last = _prev_last + decode_varint(_pos) + 1;
+        uint32_t bits = *_pos++;
+        if (last >= docid) {
+            decode_block(bits);
+            return seek(docid);
+        }
+        // Skip the whole block without unpacking it
+        _pos += packed_bytes(bits);
+        _prev_last = last;
+        _next_ordinal += BLOCK_SIZE;
+    }
+    if (_tail_docs > 0) {
+        decode_tail();
+        if (_buf[_count - 1] >= docid) {
+            return seek(docid);
+        }
+        _count = 0;
+    }
+    return END;
+}
+
+}
@@ -0,0 +1,96 @@
+// Copyright Vespa.ai. Licensed under the terms of the Apache 2.0 license. See LICENSE in the project root.
+
+#pragma once
+
+#include <vespa/vespalib/util/arrayref.h>
+#include <cstdint>
+#include <vector>
+
+namespace search::diskindex {
+
+/**
+ * Codec for sorted docid lists stored in blocks of BLOCK_SIZE docids.
+ *
+ * Each full block has a small header (varint delta of the last docid
+ * in the block and the bit width of the block) followed by the docid
+ * deltas bit-packed with a fixed width in 4 interleaved 32-bit lanes
+ * (value i in lane i % 4).  The lane layout lets the compiler unpack
+ * 4 values per instruction, and the block header makes it possible to
+ * skip a whole block without decoding it.  Remaining docids after the
+ * last full block are stored as varint deltas.
+ *
+ * A delta is docid - prev - 1, with prev starting at -1 (modulo 2^32)
+ * unless another start is given, e.g. the last docid of the previous
+ * chunk of a posting list.
+ */
+class BlockDocIdEncoder
+{
+public:
+    static constexpr uint32_t BLOCK_SIZE = 128;
+    static constexpr uint32_t LANES = 4;
+
+    /*
+     * Append the encoding of the given strictly increasing docids to buf.
+     */
+    static void encode(vespalib::ConstArrayRef<uint32_t> docids, std::vector<uint8_t> &buf, uint32_t prev = UINT32_MAX);
+
+    // Used by encode, exposed for testing.
+    static void pack_block(const uint32_t *deltas, uint32_t bits, uint32_t *out);
+};
+
+/**
+ * Decoder for docid lists encoded by BlockDocIdEncoder.  The encoded
+ * data must outlive the decoder.
+ */
+class BlockDocIdDecoder
+{
+public:
+    static constexpr uint32_t BLOCK_SIZE = BlockDocIdEncoder::BLOCK_SIZE;
+    static constexpr uint32_t END = UINT32_MAX;
+
+    BlockDocIdDecoder();
+    void setup(const uint8_t *data, uint32_t num_docs, uint32_t prev = UINT32_MAX);
+
+    /*
+     * Position at the first docid >= docid and return it, or END if there
+     * is none.  Docid arguments must be non-decreasing between calls.
+     */
+    uint32_t seek(uint32_t docid) {
+        if (__builtin_expect(_idx < _count && _buf[_count - 1] >= docid, true)) {
+            while (_buf[_idx] < docid) {
+                ++_idx;
+            }
+            return _buf[_idx];
+        }
+        return seek_slow(docid);
+    }
+
+    // Docid at the current position, or END.
+    uint32_t get_docid() const { return (_idx < _count) ? _buf[_idx] : END; }
+    // Position of the current docid in the encoded list, only valid when not at END.
+    uint32_t get_ordinal() const { return _buf_ordinal + _idx; }
+    // Advance to the next docid and return it, or END.
+    uint32_t next() {
+        uint32_t docid = get_docid();
+        return (docid == END) ? END : seek(docid + 1);
+    }
+
+    static void unpack_block(const uint32_t *in, uint32_t bits, uint32_t *out);
+
+private:
+    uint32_t seek_slow(uint32_t docid);
+    void decode_block(uint32_t bits);
+    void decode_tail();
+
+    const uint8_t *_pos;
+    uint32_t       _full_blocks_left;
+    uint32_t       _tail_docs;
+    uint32_t       _prev_last;    // last docid in previous block, -1 before first
+    uint32_t       _idx;
+    uint32_t       _count;
+    uint32_t       _buf_ordinal;  // ordinal of _buf[0]
+    uint32_t       _next_ordinal; // ordinal of first docid after _buf
+    uint32_t       _buf[BLOCK_SIZE];
+};
+
+}
@@ -6,6 +6,7 @@
 #include "fileheader.h"
 #include <vespa/searchlib/index/schemautil.h>
 #include <vespa/searchlib/queryeval/create_blueprint_visitor_helper.h>
+#include <vespa/searchlib/queryeval/fuzzy_term_expander.h>
 #include <vespa/searchlib/queryeval/leaf_blueprints.h>
 #include <vespa/searchlib/queryeval/intermediate_blueprints.h>
 #include <vespa/searchlib/util/dirtraverse.h>
@@ -55,7 +56,10 @@ DiskIndex::DiskIndex(const vespalib::string &indexDir, size_t cacheSize)
       _dicts(),
       _tuneFileSearch(),
       _cache(*this, cacheSize),
-      _size(0)
+      _size(0),
+      _hot_words(),
+      _posting_list_cache(),
+      _posting_list_cache_index_id(0)
 {
     calculateSize();
 }
@@ -255,6 +259,11 @@ unite(const DiskIndex::IndexList & indexes, const DiskIndex::LookupResultVector
 DiskIndex::LookupResultVector
 DiskIndex::lookup(const std::vector<uint32_t> & indexes, vespalib::stringref word)
 {
+    if (_hot_words) {
+        for (uint32_t index : indexes) {
+            _hot_words->record(_schema.getIndexField(index).getName(), word);
+        }
+    }
     Key key(indexes, word);
     LookupResultVector result;
     if (_cacheSize > 0) {
@@ -270,6 +279,20 @@ DiskIndex::lookup(const std::vector<uint32_t> & indexes, vespalib::stringref wor
     return result;
 }
 
+void
+DiskIndex::expandFuzzyTerm(uint32_t indexId, const FuzzyTermExpander &expander,
+                           std::vector<vespalib::string> &words)
+{
+    SchemaUtil::IndexIterator it(_schema, indexId);
+    uint32_t fieldId = it.getIndex();
+    if (fieldId >= _dicts.size()) {
+        return;
+    }
+    DictionaryFileRandRead &dict = *_dicts[fieldId];
+    expander.expand([&dict](const std::string &key, vespalib::string &word) { return dict.findLowerBound(key, word); },
+                    [&words](const vespalib::string &word) { words.push_back(word); });
+}
+
 bool
 DiskIndex::read(const Key & key, LookupResultVector & result)
 {
@@ -310,6 +333,65 @@ DiskIndex::readPostingList(const LookupResult &lookupRes) const
     return handle;
 }
 
+void
+DiskIndex::set_posting_list_cache(std::shared_ptr<PostingListCache> cache)
+{
+    _posting_list_cache = std::move(cache);
+    _posting_list_cache_index_id = _posting_list_cache ? _posting_list_cache->make_index_id() : 0;
+}
+
+std::shared_ptr<const index::PostingListHandle>
+DiskIndex::get_posting_list(const LookupResult &lookupRes) const
+{
+    if (!_posting_list_cache) {
+        return readPostingList(lookupRes);
+    }
+    PostingListCache::Key key(_posting_list_cache_index_id, lookupRes.indexId, lookupRes.wordNum, false);
+    auto entry = _posting_list_cache->get(key, [this, &lookupRes]() {
+        PostingListCache::Entry result;
+        result.posting_list = readPostingList(lookupRes);
+        return result;
+    });
+    return entry.posting_list;
+}
+
+std::shared_ptr<const BitVector>
+DiskIndex::get_bit_vector(const LookupResult &lookupRes) const
+{
+    if (!_posting_list_cache) {
+        return readBitVector(lookupRes);
+    }
+    PostingListCache::Key key(_posting_list_cache_index_id, lookupRes.indexId, lookupRes.wordNum, true);
+    auto entry = _posting_list_cache->get(key, [this, &lookupRes]() {
+        PostingListCache::Entry result;
+        result.bit_vector = readBitVector(lookupRes);
+        return result;
+    });
+    return entry.bit_vector;
+}
+
+size_t
+DiskIndex::prefetch(const std::vector<HotWords::Entry> &words)
+{
+    size_t prefetched = 0;
+    for (const auto &entry : words) {
+        uint32_t indexId = _schema.getIndexFieldId(entry.field);
+        if (indexId == Schema::UNKNOWN_FIELD_ID) {
+            continue;
+        }
+        LookupResultVector result;
+        read(Key(IndexList{indexId}, entry.word), result);
+        const LookupResult &lookupRes = result[0];
+        SchemaUtil::IndexIterator it(_schema, indexId);
+        const DiskPostingFile *file = _postingFiles[it.getIndex()].get();
+        if (lookupRes.valid() && (file != nullptr)) {
+            file->prefetchPostingList(lookupRes.bitOffset, lookupRes.counts._bitLength);
+            ++prefetched;
+        }
+    }
+    return prefetched;
+}
+
 BitVector::UP
 DiskIndex::readBitVector(const LookupResult &lookupRes) const
 {
@@ -394,6 +476,22 @@ public:
         }
     }
 
+    void visitFuzzyTerm(FuzzyTerm &n) {
+        const vespalib::string termStr = termAsString(n);
+        FuzzyTermExpander expander(termStr, n.getMaxEditDistance(), n.getPrefixLength());
+        std::vector<vespalib::string> words;
+        _diskIndex.expandFuzzyTerm(_fieldId, expander, words);
+        setResult(make_expanded_term_blueprint(_field, words,
+                                               [this](const vespalib::string &word, const FieldSpec &field) -> Blueprint::UP {
+                                                   const DiskIndex::LookupResult & lookupRes = _cache.lookup(word, _fieldId);
+                                                   if (!lookupRes.valid()) {
+                                                       return std::make_unique<EmptyBlueprint>(field);
+                                                   }
+                                                   bool useBitVector = field.isFilter();
+                                                   return std::make_unique<DiskTermBlueprint>(field, _diskIndex, word, std::make_unique<DiskIndex::LookupResult>(lookupRes), useBitVector);
+                                               }));
+    }
+
     void visit(NumberTerm &n) override {
         handleNumberTermAsText(n);
     }
@@ -409,7 +507,7 @@ public:
     void visit(RegExpTerm &n)    override { visitTerm(n); }
     void visit(PredicateQuery &n) override { not_supported(n); }
     void visit(NearestNeighborTerm &n) override { not_supported(n); }
-    void visit(FuzzyTerm &n)    override { visitTerm(n); }
+    void visit(FuzzyTerm &n)    override { visitFuzzyTerm(n); }
 };
 
 Blueprint::UP
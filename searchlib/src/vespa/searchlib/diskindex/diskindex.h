@@ -3,6 +3,8 @@
 #pragma once
 
 #include "bitvectordictionary.h"
+#include "hot_words.h"
+#include "posting_list_cache.h"
 #include "zcposoccrandread.h"
 #include <vespa/searchlib/index/dictionaryfile.h>
 #include <vespa/searchlib/index/field_length_info.h>
@@ -11,6 +13,8 @@
 #include <vespa/vespalib/stllike/string.h>
 #include <vespa/vespalib/stllike/cache.h>
 
+namespace search::queryeval { class FuzzyTermExpander; }
+
 namespace search::diskindex {
 
 /**
@@ -81,6 +85,9 @@ private:
     TuneFileSearch                         _tuneFileSearch;
     Cache                                  _cache;
     uint64_t                               _size;
+    std::shared_ptr<HotWords>              _hot_words;
+    std::shared_ptr<PostingListCache>      _posting_list_cache;
+    uint64_t                               _posting_list_cache_index_id;
 
     void calculateSize();
     bool loadSchema();
@@ -116,6 +123,35 @@ public:
 
     LookupResultVector lookup(const std::vector<uint32_t> & indexes, vespalib::stringref word);
 
+    /**
+     * Find the words in the dictionary for the given field that match the given fuzzy term.
+     *
+     * @param indexId the id of the field to search the dictionary for.
+     * @param expander the fuzzy term expander used to walk the dictionary.
+     * @param words the vector the matching words are appended to.
+     */
+    void expandFuzzyTerm(uint32_t indexId, const queryeval::FuzzyTermExpander &expander,
+                         std::vector<vespalib::string> &words);
+
+    /**
+     * Record the words looked up in this disk index in the given hot words.
+     */
+    void set_hot_words(std::shared_ptr<HotWords> hot_words) { _hot_words = std::move(hot_words); }
+
+    /**
+     * Share the given cache of posting lists and bit vectors with
+     * other disk indexes. Must be set before the index is searched.
+     */
+    void set_posting_list_cache(std::shared_ptr<PostingListCache> cache);
+
+    /**
+     * Hint the OS to read the posting lists of the given words into the
+     * page cache. Words in fields not in this disk index are ignored.
+     *
+     * @return the number of posting lists prefetched.
+     */
+    size_t prefetch(const std::vector<HotWords::Entry> &words);
+
     /**
      * Read the posting list corresponding to the given lookup result.
      *
@@ -133,6 +169,13 @@ public:
      */
     BitVector::UP readBitVector(const LookupResult &lookupRes) const;
 
+    /**
+     * Get the posting list or bit vector corresponding to the given
+     * lookup result, through the posting list cache if one is set.
+     */
+    std::shared_ptr<const index::PostingListHandle> get_posting_list(const LookupResult &lookupRes) const;
+    std::shared_ptr<const BitVector> get_bit_vector(const LookupResult &lookupRes) const;
+
     std::unique_ptr<queryeval::Blueprint> createBlueprint(const queryeval::IRequestContext & requestContext,
                                                           const queryeval::FieldSpec &field,
                                                           const query::Node &term) override;
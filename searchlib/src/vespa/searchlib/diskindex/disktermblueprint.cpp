@@ -4,6 +4,7 @@
 #include <vespa/searchlib/common/bitvectoriterator.h>
 #include <vespa/searchlib/queryeval/booleanmatchiteratorwrapper.h>
 #include <vespa/searchlib/queryeval/filter_wrapper.h>
+#include <vespa/searchlib/queryeval/flow_cost_table.h>
 #include <vespa/searchlib/queryeval/intermediate_blueprints.h>
 #include <vespa/vespalib/objects/visit.h>
 #include <vespa/vespalib/util/stringfmt.h>
@@ -57,9 +58,9 @@ DiskTermBlueprint::fetchPostings(const queryeval::ExecuteInfo &execInfo)
 {
     (void) execInfo;
     if (!_fetchPostingsDone) {
-        _bitVector = _diskIndex.readBitVector(*_lookupRes);
+        _bitVector = _diskIndex.get_bit_vector(*_lookupRes);
         if (!_useBitVector || !_bitVector) {
-            _postingHandle = _diskIndex.readPostingList(*_lookupRes);
+            _postingHandle = _diskIndex.get_posting_list(*_lookupRes);
         }
     }
     _fetchPostingsDone = true;
@@ -105,4 +106,10 @@ DiskTermBlueprint::visitMembers(vespalib::ObjectVisitor& visitor) const
     visit(visitor, "query_term", _query_term);
 }
 
+const char *
+DiskTermBlueprint::flow_cost_key() const noexcept
+{
+    return queryeval::FlowCostTable::disk_term_key;
+}
+
 } // namespace
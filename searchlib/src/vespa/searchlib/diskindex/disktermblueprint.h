@@ -19,8 +19,8 @@ private:
     DiskIndex::LookupResult::UP      _lookupRes;
     bool                             _useBitVector;
     bool                             _fetchPostingsDone;
-    index::PostingListHandle::UP     _postingHandle;
-    BitVector::UP                    _bitVector;
+    std::shared_ptr<const index::PostingListHandle> _postingHandle;
+    std::shared_ptr<const BitVector> _bitVector;
 
 public:
     /**
@@ -46,6 +46,7 @@ public:
     std::unique_ptr<queryeval::SearchIterator> createFilterSearch(bool strict, FilterConstraint) const override;
 
     void visitMembers(vespalib::ObjectVisitor& visitor) const override;
+    const char *flow_cost_key() const noexcept override;
 };
 
 }
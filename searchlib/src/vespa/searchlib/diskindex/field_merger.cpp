@@ -16,6 +16,7 @@
 #include <vespa/vespalib/io/fileutil.h>
 #include <vespa/vespalib/stllike/asciistream.h>
 #include <vespa/vespalib/util/exceptions.h>
+#include <vespa/vespalib/util/io_scheduler.h>
 #include <filesystem>
 #include <system_error>
 
@@ -322,7 +323,8 @@ FieldMerger::open_field_writer()
     }
     SchemaUtil::IndexIterator index(_fusion_out_index.get_schema(), _id);
     if (!_writer->open(64, 262144, _fusion_out_index.get_dynamic_k_pos_index_format(),
-                       index.use_interleaved_features(), index.getSchema(),
+                       index.use_interleaved_features(), _fusion_out_index.get_block_docid_pos_index_format(),
+                       index.getSchema(),
                        index.getIndex(),
                        field_length_info,
                        _fusion_out_index.get_tune_file_indexing()._write, _fusion_out_index.get_file_header_context())) {
@@ -518,6 +520,7 @@ FieldMerger::merge_field_finish()
 void
 FieldMerger::process_merge_field()
 {
+    vespalib::IoScheduler::MyClass my_io_class(vespalib::IoScheduler::Class::FUSION);
     switch (_state) {
     case State::MERGE_START:
         merge_field_start();
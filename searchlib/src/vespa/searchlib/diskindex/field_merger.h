@@ -24,6 +24,11 @@ class WordNumMapping;
 
 /*
  * Class for merging posting lists for a single field during fusion.
+ *
+ * A field is the unit of parallelism in fusion: the words of a field
+ * are merged in order by a single task at a time, since the posting
+ * file, bit vector file and PageDict4 dictionary writers can only
+ * produce one sequential output for the field.
  */
 class FieldMerger
 {
@@ -7,6 +7,7 @@
 #include <vespa/searchcommon/common/schema.h>
 #include <vespa/vespalib/util/cpu_usage.h>
 #include <vespa/vespalib/util/executor.h>
+#include <algorithm>
 #include <cassert>
 
 using vespalib::CpuUsage;
@@ -19,7 +20,13 @@ FieldMergersState::FieldMergersState(const FusionOutputIndex& fusion_out_index,
       _flush_token(std::move(flush_token)),
       _done(_fusion_out_index.get_schema().getNumIndexFields()),
       _failed(0u),
-      _field_mergers(_fusion_out_index.get_schema().getNumIndexFields())
+      _field_mergers(_fusion_out_index.get_schema().getNumIndexFields()),
+      _lock(),
+      _estimated_memory(_field_mergers.size()),
+      _pending(),
+      _active_memory(0u),
+      _num_active(0u),
+      _max_num_active(0u)
 {
 }
 
@@ -39,6 +46,30 @@ FieldMergersState::alloc_field_merger(uint32_t id)
     return result;
 }
 
+bool
+FieldMergersState::can_start(size_t estimated_memory) const noexcept
+{
+    size_t max_memory = _fusion_out_index.get_max_merge_memory();
+    return (_num_active == 0u) || (max_memory == 0u) || (_active_memory + estimated_memory <= max_memory);
+}
+
+void
+FieldMergersState::start_field_merger(FieldMerger& field_merger, size_t estimated_memory)
+{
+    {
+        std::lock_guard guard(_lock);
+        _estimated_memory[field_merger.get_id()] = estimated_memory;
+        if (!_pending.empty() || !can_start(estimated_memory)) {
+            _pending.push_back(&field_merger);
+            return;
+        }
+        _active_memory += estimated_memory;
+        ++_num_active;
+        _max_num_active = std::max(_max_num_active, _num_active);
+    }
+    schedule_task(field_merger);
+}
+
 void
 FieldMergersState::destroy_field_merger(FieldMerger& field_merger)
 {
@@ -48,6 +79,23 @@ FieldMergersState::destroy_field_merger(FieldMerger& field_merger)
     old_merger = std::move(_field_mergers[id]);
     assert(old_merger.get() == &field_merger);
     old_merger.reset();
+    std::vector<FieldMerger*> started;
+    {
+        std::lock_guard guard(_lock);
+        _active_memory -= _estimated_memory[id];
+        --_num_active;
+        while (!_pending.empty() && can_start(_estimated_memory[_pending.front()->get_id()])) {
+            auto next = _pending.front();
+            _pending.pop_front();
+            _active_memory += _estimated_memory[next->get_id()];
+            ++_num_active;
+            _max_num_active = std::max(_max_num_active, _num_active);
+            started.push_back(next);
+        }
+    }
+    for (auto next : started) {
+        schedule_task(*next);
+    }
     _done.countDown();
 }
 
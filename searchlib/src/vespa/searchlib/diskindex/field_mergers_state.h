@@ -4,6 +4,8 @@
 
 #include <vespa/vespalib/util/count_down_latch.h>
 #include <atomic>
+#include <deque>
+#include <mutex>
 #include <vector>
 
 namespace search { class IFlushToken; }
@@ -17,6 +19,11 @@ class FusionOutputIndex;
 /*
  * This class has ownership of active field mergers until they are
  * done or failed.
+ *
+ * Field mergers are started in the order they are added. When a limit
+ * for merge memory is set, a field merger waits until the estimated
+ * memory used by the running field mergers leaves room for it. At least
+ * one field merger is always running.
  */
 class FieldMergersState {
     const FusionOutputIndex&                  _fusion_out_index;
@@ -25,16 +32,26 @@ class FieldMergersState {
     vespalib::CountDownLatch                  _done;
     std::atomic<uint32_t>                     _failed;
     std::vector<std::unique_ptr<FieldMerger>> _field_mergers;
+    std::mutex                                _lock;
+    std::vector<size_t>                       _estimated_memory; // indexed by field id
+    std::deque<FieldMerger*>                  _pending;
+    size_t                                    _active_memory;
+    uint32_t                                  _num_active;
+    uint32_t                                  _max_num_active;
 
     void destroy_field_merger(FieldMerger& field_merger);
+    bool can_start(size_t estimated_memory) const noexcept;
 public:
     FieldMergersState(const FusionOutputIndex& fusion_out_index, vespalib::Executor& executor, std::shared_ptr<IFlushToken> flush_token);
     ~FieldMergersState();
     FieldMerger& alloc_field_merger(uint32_t id);
     void field_merger_done(FieldMerger& field_merger, bool failed);
     void wait_field_mergers_done();
+    void start_field_merger(FieldMerger& field_merger, size_t estimated_memory);
     void schedule_task(FieldMerger& field_merger);
     uint32_t get_failed() const noexcept { return _failed; }
+    // Max number of field mergers that have been running at the same time
+    uint32_t get_max_num_active() const noexcept { return _max_num_active; }
 };
 
 }
@@ -39,6 +39,7 @@ FieldWriter::open(uint32_t minSkipDocs,
                   uint32_t minChunkDocs,
                   bool dynamicKPosOccFormat,
                   bool encode_interleaved_features,
+                  bool encode_block_docids,
                   const Schema &schema,
                   const uint32_t indexId,
                   const FieldLengthInfo &field_length_info,
@@ -64,6 +65,9 @@ FieldWriter::open(uint32_t minSkipDocs,
     if (encode_interleaved_features) {
         params.set("interleaved_features", encode_interleaved_features);
     }
+    if (encode_block_docids) {
+        params.set("block_docids", encode_block_docids);
+    }
     
     _dictFile = std::make_unique<PageDict4FileSeqWrite>();
     _dictFile->setParams(countParams);
@@ -47,6 +47,7 @@ public:
     bool open(uint32_t minSkipDocs, uint32_t minChunkDocs,
               bool dynamicKPosOccFormat,
               bool encode_interleaved_features,
+              bool encode_block_docids,
               const Schema &schema, uint32_t indexId,
               const index::FieldLengthInfo &field_length_info,
               const TuneFileSeqWrite &tuneFileWrite,
@@ -11,6 +11,8 @@
 #include <vespa/vespalib/util/error.h>
 #include <vespa/vespalib/util/exceptions.h>
 #include <vespa/vespalib/util/lambdatask.h>
+#include <vespa/vespalib/util/size_literals.h>
+#include <algorithm>
 #include <filesystem>
 #include <system_error>
 
@@ -56,6 +58,45 @@ uint32_t calc_trimmed_doc_id_limit(const SelectorArray& selector, const std::vec
     return trimmed_doc_id_limit;
 }
 
+/*
+ * Memory used by a field merger is dominated by the word number mappings,
+ * which are proportional to the number of words in the input dictionaries,
+ * and by the file buffers for each input and the output.
+ */
+constexpr size_t field_merge_file_buffer_memory = 1_Mi;
+
+struct FieldMergeEstimate {
+    uint32_t id;
+    uint64_t input_bytes;
+    size_t   memory;
+    FieldMergeEstimate(uint32_t id_in) noexcept : id(id_in), input_bytes(0), memory(field_merge_file_buffer_memory) { }
+};
+
+FieldMergeEstimate
+estimate_field_merge(const SchemaUtil::IndexIterator &index, const std::vector<FusionInputIndex> &old_indexes)
+{
+    FieldMergeEstimate estimate(index.getIndex());
+    for (const auto &old_index : old_indexes) {
+        if (!index.hasOldFields(old_index.getSchema())) {
+            continue;
+        }
+        std::error_code ec;
+        std::filesystem::directory_iterator dir(std::filesystem::path(old_index.getPath() + "/" + index.getName()), ec);
+        for (; !ec && dir != std::filesystem::directory_iterator(); dir.increment(ec)) {
+            uint64_t size = dir->is_regular_file(ec) ? dir->file_size(ec) : 0u;
+            if (ec) {
+                break;
+            }
+            estimate.input_bytes += size;
+            if (dir->path().filename().string().starts_with("dictionary")) {
+                estimate.memory += size;
+            }
+        }
+        estimate.memory += field_merge_file_buffer_memory;
+    }
+    return estimate;
+}
+
 }
 
 Fusion::Fusion(const Schema& schema, const vespalib::string& dir,
@@ -63,7 +104,8 @@ Fusion::Fusion(const Schema& schema, const vespalib::string& dir,
                const TuneFileIndexing& tuneFileIndexing,
                const FileHeaderContext& fileHeaderContext)
     : _old_indexes(createInputIndexes(sources, selector)),
-      _fusion_out_index(schema, dir, _old_indexes, calc_trimmed_doc_id_limit(selector, sources), tuneFileIndexing, fileHeaderContext)
+      _fusion_out_index(schema, dir, _old_indexes, calc_trimmed_doc_id_limit(selector, sources), tuneFileIndexing, fileHeaderContext),
+      _max_concurrent_field_mergers(0)
 {
 }
 
@@ -74,13 +116,21 @@ Fusion::mergeFields(vespalib::Executor& shared_executor, std::shared_ptr<IFlushT
 {
     FieldMergersState field_mergers_state(_fusion_out_index, shared_executor, flush_token);
     const Schema &schema = getSchema();
+    std::vector<FieldMergeEstimate> estimates;
     for (SchemaUtil::IndexIterator iter(schema); iter.isValid(); ++iter) {
-        auto& field_merger = field_mergers_state.alloc_field_merger(iter.getIndex());
-        field_mergers_state.schedule_task(field_merger);
+        estimates.emplace_back(estimate_field_merge(iter, _old_indexes));
+    }
+    // Start the largest fields first, they determine how long fusion takes.
+    std::stable_sort(estimates.begin(), estimates.end(),
+                     [](const auto &lhs, const auto &rhs) noexcept { return lhs.input_bytes > rhs.input_bytes; });
+    for (const auto &estimate : estimates) {
+        auto& field_merger = field_mergers_state.alloc_field_merger(estimate.id);
+        field_mergers_state.start_field_merger(field_merger, estimate.memory);
     }
     LOG(debug, "Waiting for %u fields", schema.getNumIndexFields());
     field_mergers_state.wait_field_mergers_done();
     LOG(debug, "Done waiting for %u fields", schema.getNumIndexFields());
+    _max_concurrent_field_mergers = field_mergers_state.get_max_num_active();
     return (field_mergers_state.get_failed() == 0u);
 }
 
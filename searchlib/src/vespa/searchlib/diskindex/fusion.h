@@ -33,6 +33,7 @@ private:
 
     std::vector<FusionInputIndex> _old_indexes;
     FusionOutputIndex _fusion_out_index;
+    uint32_t _max_concurrent_field_mergers;
 public:
     Fusion(const Fusion &) = delete;
     Fusion& operator=(const Fusion &) = delete;
@@ -42,8 +43,13 @@ public:
 
     ~Fusion();
     void set_dynamic_k_pos_index_format(bool dynamic_k_pos_index_format) { _fusion_out_index.set_dynamic_k_pos_index_format(dynamic_k_pos_index_format); }
+    // Store docids in posting lists with skip info by BlockDocIdEncoder
+    void set_block_docid_pos_index_format(bool block_docid_pos_index_format) { _fusion_out_index.set_block_docid_pos_index_format(block_docid_pos_index_format); }
     void set_force_small_merge_chunk(bool force_small_merge_chunk) { _fusion_out_index.set_force_small_merge_chunk(force_small_merge_chunk); }
+    void set_max_merge_memory(size_t max_merge_memory) { _fusion_out_index.set_max_merge_memory(max_merge_memory); }
     bool merge(vespalib::Executor& shared_executor, std::shared_ptr<IFlushToken> flush_token);
+    // Max number of field mergers that were running at the same time during merge(), for unit testing
+    uint32_t get_max_concurrent_field_mergers() const noexcept { return _max_concurrent_field_mergers; }
 };
 
 }
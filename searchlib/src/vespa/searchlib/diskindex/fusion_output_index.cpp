@@ -11,7 +11,9 @@ FusionOutputIndex::FusionOutputIndex(const index::Schema& schema, const vespalib
       _old_indexes(std::move(old_indexes)),
       _doc_id_limit(doc_id_limit),
       _dynamic_k_pos_index_format(false),
+      _block_docid_pos_index_format(false),
       _force_small_merge_chunk(false),
+      _max_merge_memory(0),
       _tune_file_indexing(tune_file_indexing),
       _file_header_context(file_header_context)
 {
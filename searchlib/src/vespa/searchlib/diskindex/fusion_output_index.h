@@ -25,7 +25,9 @@ private:
     const std::vector<FusionInputIndex>& _old_indexes;
     const uint32_t                       _doc_id_limit;
     bool                                 _dynamic_k_pos_index_format;
+    bool                                 _block_docid_pos_index_format;
     bool                                 _force_small_merge_chunk;
+    size_t                               _max_merge_memory;
     const TuneFileIndexing&              _tune_file_indexing;
     const common::FileHeaderContext&     _file_header_context;
 public:
@@ -33,13 +35,18 @@ public:
     ~FusionOutputIndex();
 
     void set_dynamic_k_pos_index_format(bool dynamic_k_pos_index_format) { _dynamic_k_pos_index_format = dynamic_k_pos_index_format; }
+    void set_block_docid_pos_index_format(bool block_docid_pos_index_format) { _block_docid_pos_index_format = block_docid_pos_index_format; }
     void set_force_small_merge_chunk(bool force_small_merge_chunk) { _force_small_merge_chunk = force_small_merge_chunk; }
+    // Limit for estimated memory used by concurrent field merges, 0 means no limit
+    void set_max_merge_memory(size_t max_merge_memory) { _max_merge_memory = max_merge_memory; }
     const index::Schema& get_schema() const noexcept { return _schema; }
     const vespalib::string& get_path() const noexcept { return _path; }
     const std::vector<FusionInputIndex>& get_old_indexes() const noexcept { return _old_indexes; }
     uint32_t get_doc_id_limit() const noexcept { return _doc_id_limit; }
     bool get_dynamic_k_pos_index_format() const noexcept { return _dynamic_k_pos_index_format; }
+    bool get_block_docid_pos_index_format() const noexcept { return _block_docid_pos_index_format; }
     bool get_force_small_merge_chunk() const noexcept { return _force_small_merge_chunk; }
+    size_t get_max_merge_memory() const noexcept { return _max_merge_memory; }
     const TuneFileIndexing& get_tune_file_indexing() const noexcept { return _tune_file_indexing; }
     const common::FileHeaderContext& get_file_header_context() const noexcept { return _file_header_context; }
 };
@@ -0,0 +1,172 @@
+// Copyright Vespa.ai. Licensed under the terms of the Apache 2.0 license. See LICENSE in the project root.
+
+#include "hot_words.h"
+#include <vespa/vespalib/objects/nbostream.h>
+#include <vespa/vespalib/stllike/hash_map.hpp>
+#include <vespa/vespalib/util/exceptions.h>
+#include <algorithm>
+#include <filesystem>
+#include <fstream>
+#include <iterator>
+
+#include <vespa/log/log.h>
+LOG_SETUP(".diskindex.hot_words");
+
+namespace search::diskindex {
+
+namespace {
+
+constexpr uint32_t FILE_MAGIC = 0x486f7457; // "HotW"
+constexpr uint32_t FILE_VERSION = 1;
+
+}
+
+vespalib::string
+HotWords::make_key(vespalib::stringref field, vespalib::stringref word)
+{
+    vespalib::string key(field);
+    key.push_back('\0');
+    key.append(word);
+    return key;
+}
+
+HotWords::HotWords(size_t max_words)
+    : _lock(),
+      _counts(),
+      _max_words(max_words),
+      _dropped(0)
+{
+}
+
+HotWords::~HotWords() = default;
+
+void
+HotWords::age()
+{
+    Map aged;
+    for (const auto &entry : _counts) {
+        if (entry.second > 1) {
+            aged[entry.first] = entry.second / 2;
+        }
+    }
+    _counts.swap(aged);
+    _dropped = 0;
+}
+
+void
+HotWords::record(vespalib::stringref field, vespalib::stringref word)
+{
+    vespalib::string key = make_key(field, word);
+    std::lock_guard guard(_lock);
+    auto itr = _counts.find(key);
+    if (itr != _counts.end()) {
+        ++itr->second;
+    } else if (_counts.size() < _max_words) {
+        _counts[key] = 1;
+    } else if (++_dropped >= _max_words) {
+        age();
+    }
+}
+
+void
+HotWords::add(const std::vector<Entry> &entries)
+{
+    std::lock_guard guard(_lock);
+    for (const auto &entry : entries) {
+        vespalib::string key = make_key(entry.field, entry.word);
+        auto itr = _counts.find(key);
+        if (itr != _counts.end()) {
+            itr->second += entry.count;
+        } else if (_counts.size() < _max_words) {
+            _counts[key] = entry.count;
+        }
+    }
+}
+
+std::vector<HotWords::Entry>
+HotWords::get_hottest(size_t max_entries) const
+{
+    std::vector<Entry> result;
+    {
+        std::lock_guard guard(_lock);
+        result.reserve(_counts.size());
+        for (const auto &entry : _counts) {
+            size_t split = entry.first.find('\0');
+            vespalib::stringref key(entry.first);
+            result.emplace_back(key.substr(0, split), key.substr(split + 1), entry.second);
+        }
+    }
+    auto by_count = [](const Entry &a, const Entry &b) noexcept { return a.count > b.count; };
+    if (result.size() > max_entries) {
+        std::nth_element(result.begin(), result.begin() + max_entries, result.end(), by_count);
+        result.resize(max_entries);
+    }
+    std::sort(result.begin(), result.end(), by_count);
+    return result;
+}
+
+size_t
+HotWords::size() const
+{
+    std::lock_guard guard(_lock);
+    return _counts.size();
+}
+
+bool
+HotWords::save(const vespalib::string &file_name) const
+{
+    auto entries = get_hottest(_max_words);
+    vespalib::nbostream os;
+    os << FILE_MAGIC << FILE_VERSION << uint32_t(entries.size());
+    for (const auto &entry : entries) {
+        os << entry.field << entry.word << entry.count;
+    }
+    vespalib::string tmp_file_name = file_name + ".tmp";
+    {
+        std::ofstream file(tmp_file_name.c_str(), std::ios::binary | std::ios::trunc);
+        file.write(os.data(), os.size());
+        if ( ! file.good()) {
+            LOG(warning, "Could not write hot words to '%s'", tmp_file_name.c_str());
+            return false;
+        }
+    }
+    std::error_code ec;
+    std::filesystem::rename(std::filesystem::path(tmp_file_name), std::filesystem::path(file_name), ec);
+    if (ec) {
+        LOG(warning, "Could not rename '%s' to '%s': %s", tmp_file_name.c_str(), file_name.c_str(), ec.message().c_str());
+        return false;
+    }
+    return true;
+}
+
+std::vector<HotWords::Entry>
+HotWords::load(const vespalib::string &file_name)
+{
+    std::vector<Entry> entries;
+    std::ifstream file(file_name.c_str(), std::ios::binary);
+    if ( ! file.good()) {
+        return entries;
+    }
+    std::string data((std::istreambuf_iterator<char>(file)), std::istreambuf_iterator<char>());
+    vespalib::nbostream is(data.data(), data.size());
+    try {
+        uint32_t magic = 0;
+        uint32_t version = 0;
+        uint32_t num_entries = 0;
+        is >> magic >> version >> num_entries;
+        if ((magic != FILE_MAGIC) || (version != FILE_VERSION)) {
+            LOG(warning, "Ignoring hot words file '%s' with unknown format", file_name.c_str());
+            return entries;
+        }
+        entries.resize(num_entries);
+        for (auto &entry : entries) {
+            is >> entry.field >> entry.word >> entry.count;
+        }
+    } catch (const vespalib::IllegalStateException &e) {
+        LOG(warning, "Ignoring corrupt hot words file '%s': %s", file_name.c_str(), e.what());
+        entries.clear();
+    }
+    return entries;
+}
+
+}
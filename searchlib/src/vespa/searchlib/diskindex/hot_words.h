@@ -0,0 +1,61 @@
+// Copyright Vespa.ai. Licensed under the terms of the Apache 2.0 license. See LICENSE in the project root.
+
+#pragma once
+
+#include <vespa/vespalib/stllike/hash_map.h>
+#include <vespa/vespalib/stllike/string.h>
+#include <mutex>
+#include <vector>
+
+namespace search::diskindex {
+
+/**
+ * Bounded record of the (field, word) pairs most frequently looked up
+ * in disk indexes. It is persisted across restarts and used to
+ * prefetch the posting lists of the hottest words when a disk index
+ * is loaded, so the first queries after a restart or a fusion do not
+ * hit a cold page cache.
+ *
+ * When a new word is seen while the record is full, the word is
+ * dropped. Once as many words as the record can hold have been
+ * dropped, all counts are halved and words with a zero count are
+ * removed, making room for words that have become hot.
+ */
+class HotWords {
+public:
+    struct Entry {
+        vespalib::string field;
+        vespalib::string word;
+        uint64_t         count;
+        Entry() noexcept : field(), word(), count(0) {}
+        Entry(vespalib::stringref field_in, vespalib::stringref word_in, uint64_t count_in)
+            : field(field_in), word(word_in), count(count_in)
+        {}
+    };
+private:
+    using Map = vespalib::hash_map<vespalib::string, uint64_t>;
+    mutable std::mutex _lock;
+    Map                _counts;
+    size_t             _max_words;
+    size_t             _dropped;
+
+    static vespalib::string make_key(vespalib::stringref field, vespalib::stringref word);
+    void age();
+public:
+    explicit HotWords(size_t max_words);
+    HotWords(const HotWords &) = delete;
+    HotWords & operator=(const HotWords &) = delete;
+    ~HotWords();
+
+    void record(vespalib::stringref field, vespalib::stringref word);
+    // Add the given counts, e.g. as loaded from a previous run.
+    void add(const std::vector<Entry> &entries);
+    // The hottest words, ordered by descending count.
+    std::vector<Entry> get_hottest(size_t max_entries) const;
+    size_t size() const;
+
+    bool save(const vespalib::string &file_name) const;
+    static std::vector<Entry> load(const vespalib::string &file_name);
+};
+
+}
@@ -59,6 +59,7 @@ private:
     FileHandle      _file;
     const uint32_t  _fieldId;
     const bool      _valid;
+    bool            _started;
 public:
     FieldHandle(const Schema &schema, uint32_t fieldId, IndexBuilder & builder, bool valid) noexcept;
     ~FieldHandle();
@@ -77,6 +78,24 @@ public:
 
     bool getValid() const { return _valid; }
     uint32_t getIndexId() const { return _fieldId; }
+    bool start() noexcept {
+        bool was_started = _started;
+        _started = true;
+        return !was_started;
+    }
+};
+
+class IndexBuilder::FieldIndexBuilder : public index::FieldIndexBuilder {
+private:
+    IndexBuilder &_builder;
+    FieldHandle  &_field;
+    bool          _inWord;
+public:
+    FieldIndexBuilder(IndexBuilder &builder, FieldHandle &field) noexcept;
+    ~FieldIndexBuilder() override;
+    void startWord(vespalib::stringref word) override;
+    void endWord() override;
+    void add_document(const index::DocIdAndFeatures &features) override;
 };
 
 
@@ -100,7 +119,7 @@ FileHandle::open(vespalib::stringref dir,
     _fieldWriter = std::make_shared<FieldWriter>(docIdLimit, numWordIds, dir + "/");
 
     if (!_fieldWriter->open(64, 262144u, false,
-                            index.use_interleaved_features(),
+                            index.use_interleaved_features(), false,
                             index.getSchema(), index.getIndex(),
                             field_length_info,
                             tuneFileWrite, fileHeaderContext)) {
@@ -131,7 +150,8 @@ IndexBuilder::FieldHandle::FieldHandle(const Schema &schema, uint32_t fieldId, I
       _builder(builder),
       _file(),
       _fieldId(fieldId),
-      _valid(valid)
+      _valid(valid),
+      _started(false)
 {
 }
 
@@ -198,70 +218,87 @@ IndexBuilder::extractFields(const Schema &schema, IndexBuilder & builder) {
     return fields;
 }
 
-IndexBuilder::IndexBuilder(const Schema &schema, vespalib::stringref prefix, uint32_t docIdLimit)
-    : index::IndexBuilder(schema),
-      _schema(schema),
-      _fields(extractFields(schema, *this)),
-      _prefix(prefix),
-      _curWord(),
-      _docIdLimit(docIdLimit),
-      _curFieldId(-1),
-      _lowestOKFieldId(0u),
-      _curDocId(noDocId()),
+IndexBuilder::FieldIndexBuilder::FieldIndexBuilder(IndexBuilder &builder, FieldHandle &field) noexcept
+    : _builder(builder),
+      _field(field),
       _inWord(false)
 {
 }
 
-IndexBuilder::~IndexBuilder() = default;
-
-IndexBuilder::FieldHandle &
-IndexBuilder::currentField() {
-    assert(_curFieldId >= 0);
-    assert(_curFieldId < int32_t(_fields.size()));
-    return _fields[_curFieldId];
-}
-void
-IndexBuilder::startField(uint32_t fieldId)
-{
-    assert(_curDocId == noDocId());
-    assert(_curFieldId == -1);
-    assert(fieldId < _fields.size());
-    assert(fieldId >= _lowestOKFieldId);
-    _curFieldId = fieldId;
-}
-
-void
-IndexBuilder::endField()
+IndexBuilder::FieldIndexBuilder::~FieldIndexBuilder()
 {
-    assert(_curDocId == noDocId());
     assert(!_inWord);
-    _lowestOKFieldId = currentField().getIndexId() + 1;
-    _curFieldId = -1;
+    _builder.closeField(_field);
 }
 
 void
-IndexBuilder::startWord(vespalib::stringref word)
+IndexBuilder::FieldIndexBuilder::startWord(vespalib::stringref word)
 {
     assert(!_inWord);
     // TODO: Check sort order
-    _curWord = word;
     _inWord = true;
-    currentField().new_word(word);
+    _field.new_word(word);
 }
 
 void
-IndexBuilder::endWord()
+IndexBuilder::FieldIndexBuilder::endWord()
 {
     assert(_inWord);
-    assert(_curFieldId != -1);
     _inWord = false;
 }
 
 void
-IndexBuilder::add_document(const index::DocIdAndFeatures &features)
+IndexBuilder::FieldIndexBuilder::add_document(const index::DocIdAndFeatures &features)
 {
     assert(_inWord);
-    currentField().add_document(features);
+    _field.add_document(features);
+}
+
+IndexBuilder::IndexBuilder(const Schema &schema, vespalib::stringref prefix, uint32_t docIdLimit)
+    : index::IndexBuilder(schema),
+      _schema(schema),
+      _fields(extractFields(schema, *this)),
+      _prefix(prefix),
+      _docIdLimit(docIdLimit),
+      _numWordIds(0),
+      _field_length_inspector(nullptr),
+      _tuneFileWrite(),
+      _fileHeaderContext(nullptr)
+{
+}
+
+IndexBuilder::~IndexBuilder() = default;
+
+void
+IndexBuilder::openField(FieldHandle &fh)
+{
+    fh.open(_docIdLimit, _numWordIds,
+            _field_length_inspector->get_field_length_info(fh.getName()),
+            _tuneFileWrite, *_fileHeaderContext);
+}
+
+void
+IndexBuilder::closeField(FieldHandle &fh)
+{
+    if (fh.getValid()) {
+        fh.close();
+        vespalib::File::sync(fh.getDir());
+    }
+}
+
+std::unique_ptr<index::FieldIndexBuilder>
+IndexBuilder::startField(uint32_t fieldId)
+{
+    assert(fieldId < _fields.size());
+    assert(_fileHeaderContext != nullptr);
+    FieldHandle &fh = _fields[fieldId];
+    bool first_start = fh.start();
+    assert(first_start);
+    (void) first_start;
+    if (fh.getValid()) {
+        openField(fh);
+    }
+    return std::make_unique<FieldIndexBuilder>(*this, fh);
 }
 
 vespalib::string
@@ -279,8 +316,10 @@ IndexBuilder::open(uint64_t numWordIds,
                    const TuneFileIndexing &tuneFileIndexing,
                    const FileHeaderContext &fileHeaderContext)
 {
-    std::vector<uint32_t> indexes;
-
+    _numWordIds = numWordIds;
+    _field_length_inspector = &field_length_inspector;
+    _tuneFileWrite = tuneFileIndexing._write;
+    _fileHeaderContext = &fileHeaderContext;
     if (!_prefix.empty()) {
         std::filesystem::create_directory(std::filesystem::path(_prefix));
     }
@@ -290,10 +329,6 @@ IndexBuilder::open(uint64_t numWordIds,
             continue;
         }
         std::filesystem::create_directory(std::filesystem::path(fh.getDir()));
-        fh.open(_docIdLimit, numWordIds,
-                field_length_inspector.get_field_length_info(fh.getName()),
-                tuneFileIndexing._write, fileHeaderContext);
-        indexes.push_back(fh.getIndexId());
     }
     vespalib::string schemaFile = appendToPrefix("schema.txt");
     if (!_schema.saveToFile(schemaFile)) {
@@ -307,9 +342,9 @@ IndexBuilder::close()
 {
     // TODO: Filter for text indexes
     for (FieldHandle & fh : _fields) {
-        if (fh.getValid()) {
-            fh.close();
-            vespalib::File::sync(fh.getDir());
+        if (fh.start() && fh.getValid()) {
+            openField(fh);
+            closeField(fh);
         }
     }
     if (!docsummary::DocumentSummary::writeDocIdLimit(_prefix, _docIdLimit)) {
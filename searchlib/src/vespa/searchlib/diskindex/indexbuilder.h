@@ -4,7 +4,6 @@
 
 #include <vespa/searchlib/index/indexbuilder.h>
 #include <vespa/searchlib/common/tunefileinfo.h>
-#include <limits>
 #include <vector>
 
 namespace search::common { class FileHeaderContext; }
@@ -18,6 +17,9 @@ class BitVectorCandidate;
  * Class used to build a disk index for the set of index fields specified in a schema.
  *
  * The resulting disk index consists of field indexes that are independent of each other.
+ * The files of a field are opened when the field is started and closed when its field
+ * index builder is destroyed, so fields can be written in parallel with write buffers
+ * only allocated for the fields being written.
  */
 class IndexBuilder : public index::IndexBuilder {
 public:
@@ -25,40 +27,31 @@ public:
     IndexBuilder(const index::Schema &schema, vespalib::stringref prefix, uint32_t docIdLimit);
     ~IndexBuilder() override;
 
-    void startField(uint32_t fieldId) override;
-    void endField() override;
-    void startWord(vespalib::stringref word) override;
-    void endWord() override;
-    void add_document(const index::DocIdAndFeatures &features) override;
+    std::unique_ptr<index::FieldIndexBuilder> startField(uint32_t fieldId) override;
     vespalib::string appendToPrefix(vespalib::stringref name) const;
 
+    // The field length inspector and file header context must live until close() has returned.
     void open(uint64_t numWordIds, const index::IFieldLengthInspector &field_length_inspector,
               const TuneFileIndexing &tuneFileIndexing,
               const common::FileHeaderContext &fileHandleContext);
 
+    // Writes the fields that were never started as empty fields.
     void close();
 private:
     class FieldHandle;
+    class FieldIndexBuilder;
     const index::Schema      &_schema;
     std::vector<FieldHandle>  _fields;
     const vespalib::string    _prefix;
-    vespalib::string          _curWord;
     const uint32_t            _docIdLimit;
-    int32_t                   _curFieldId;
-    uint32_t                  _lowestOKFieldId;
-    uint32_t                  _curDocId;
-    bool                      _inWord;
+    uint64_t                  _numWordIds;
+    const index::IFieldLengthInspector *_field_length_inspector;
+    TuneFileSeqWrite          _tuneFileWrite;
+    const common::FileHeaderContext *_fileHeaderContext;
 
     static std::vector<IndexBuilder::FieldHandle> extractFields(const index::Schema &schema, IndexBuilder & builder);
-
-    static uint32_t noDocId() {
-        return std::numeric_limits<uint32_t>::max();
-    }
-
-    static uint64_t noWordNumHigh() {
-        return std::numeric_limits<uint64_t>::max();
-    }
-    FieldHandle & currentField();
+    void openField(FieldHandle &fh);
+    void closeField(FieldHandle &fh);
 };
 
 }
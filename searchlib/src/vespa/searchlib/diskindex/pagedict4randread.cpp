@@ -142,6 +142,32 @@ PageDict4RandRead::readPHeader()
 }
 
 
+void
+PageDict4RandRead::lookupPage(const SSLookupRes &ssRes, vespalib::stringref word, PLookupRes &pRes) const
+{
+    SPLookupRes spRes;
+    size_t pageSize = PageDict4PageParams::getPageByteSize();
+    const char *spData = static_cast<const char *>(_spfile->MemoryMapPtr(0));
+    spRes.lookup(*_ssReader,
+                 spData + pageSize * ssRes._sparsePageNum,
+                 word,
+                 ssRes._l6Word,
+                 ssRes._lastWord,
+                 ssRes._l6StartOffset,
+                 ssRes._l6WordNum,
+                 ssRes._pageNum);
+
+    const char *pData = static_cast<const char *>(_pfile->MemoryMapPtr(0));
+    pRes.lookup(*_ssReader,
+                pData + pageSize * spRes._pageNum,
+                word,
+                spRes._l3Word,
+                spRes._lastWord,
+                spRes._l3StartOffset,
+                spRes._l3WordNum);
+}
+
+
 bool
 PageDict4RandRead::lookup(vespalib::stringref word,
                           uint64_t &wordNum,
@@ -163,27 +189,8 @@ PageDict4RandRead::lookup(vespalib::stringref word,
         offsetAndCounts._counts = ssRes._counts;
         return true;
     } else {
-        SPLookupRes spRes;
-        size_t pageSize = PageDict4PageParams::getPageByteSize();
-        const char *spData = static_cast<const char *>(_spfile->MemoryMapPtr(0));
-        spRes.lookup(*_ssReader,
-                     spData + pageSize * ssRes._sparsePageNum,
-                     word,
-                     ssRes._l6Word,
-                     ssRes._lastWord,
-                     ssRes._l6StartOffset,
-                     ssRes._l6WordNum,
-                     ssRes._pageNum);
-
         PLookupRes pRes;
-        const char *pData = static_cast<const char *>(_pfile->MemoryMapPtr(0));
-        pRes.lookup(*_ssReader,
-                    pData + pageSize * spRes._pageNum,
-                    word,
-                    spRes._l3Word,
-                    spRes._lastWord,
-                    spRes._l3StartOffset,
-                    spRes._l3WordNum);
+        lookupPage(ssRes, word, pRes);
         offsetAndCounts._offset = pRes._startOffset._fileOffset;
         offsetAndCounts._accNumDocs = pRes._startOffset._accNumDocs;
         wordNum = pRes._wordNum;
@@ -197,6 +204,24 @@ PageDict4RandRead::lookup(vespalib::stringref word,
 }
 
 
+bool
+PageDict4RandRead::findLowerBound(vespalib::stringref key, vespalib::string &word)
+{
+    SSLookupRes ssRes(_ssReader->lookup(key));
+    if (!ssRes._res) {
+        return false;
+    }
+    if (ssRes._overflow) {
+        word = key;
+    } else {
+        PLookupRes pRes;
+        pRes._nextWord = &word;
+        lookupPage(ssRes, key, pRes);
+    }
+    return true;
+}
+
+
 bool
 PageDict4RandRead::open(const vespalib::string &name,
                         const TuneFileRandRead &tuneFileRead)
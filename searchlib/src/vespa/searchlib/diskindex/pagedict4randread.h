@@ -40,6 +40,7 @@ class PageDict4RandRead : public index::DictionaryFileRandRead
     void readSSHeader();
     void readSPHeader();
     void readPHeader();
+    void lookupPage(const SSLookupRes &ssRes, vespalib::stringref word, PLookupRes &pRes) const;
 public:
     PageDict4RandRead();
     ~PageDict4RandRead();
@@ -47,6 +48,8 @@ public:
     bool lookup(vespalib::stringref word, uint64_t &wordNum,
                 PostingListOffsetAndCounts &offsetAndCounts) override;
 
+    bool findLowerBound(vespalib::stringref key, vespalib::string &word) override;
+
     bool open(const vespalib::string &name, const TuneFileRandRead &tuneFileRead) override;
 
     bool close() override;
@@ -0,0 +1,95 @@
+// Copyright Vespa.ai. Licensed under the terms of the Apache 2.0 license. See LICENSE in the project root.
+
+#include "posting_list_cache.h"
+#include <vespa/vespalib/stllike/cache.hpp>
+
+namespace search::diskindex {
+
+size_t
+PostingListCache::Entry::memory_used() const noexcept
+{
+    size_t result = 0;
+    if (posting_list) {
+        result += sizeof(index::PostingListHandle) + posting_list->_allocSize;
+    }
+    if (bit_vector) {
+        result += sizeof(BitVector) + bit_vector->getFileBytes();
+    }
+    return result;
+}
+
+PostingListCache::PostingListCache(size_t max_bytes, size_t admission_cost)
+    : _store(),
+      _cache(_store, max_bytes),
+      _admission_cost(admission_cost),
+      _next_index_id(1),
+      _lock(),
+      _counters(num_counters, 0),
+      _recorded(0),
+      _misses(0),
+      _rejected(0)
+{
+}
+
+PostingListCache::~PostingListCache() = default;
+
+uint32_t
+PostingListCache::record_read(const Key &key)
+{
+    std::lock_guard guard(_lock);
+    uint8_t &count = _counters[vespalib::hash<Key>()(key) % num_counters];
+    if (count < max_count) {
+        ++count;
+    }
+    uint32_t result = count;
+    if (++_recorded >= (10 * num_counters)) {
+        for (uint8_t &c : _counters) {
+            c /= 2;
+        }
+        _recorded = 0;
+    }
+    return result;
+}
+
+bool
+PostingListCache::admit(const Key &key, const Entry &entry)
+{
+    if (entry.empty() || (entry.posting_list && (entry.posting_list->_allocMem == nullptr))) {
+        // Nothing found, or memory mapped
+        return false;
+    }
+    uint32_t reads = record_read(key);
+    // A word read only once is never admitted
+    return (reads >= 2) && (reads * entry.memory_used() >= _admission_cost);
+}
+
+PostingListCache::Entry
+PostingListCache::get(const Key &key, const Loader &loader)
+{
+    if (_cache.hasKey(key)) {
+        Entry entry = _cache.read(key);
+        if (!entry.empty()) {
+            return entry;
+        }
+        // Evicted since we checked, counted as a miss by the cache
+    } else {
+        _misses.fetch_add(1, std::memory_order_relaxed);
+    }
+    Entry entry = loader();
+    if (admit(key, entry)) {
+        _cache.write(key, entry);
+    } else if (!entry.empty()) {
+        _rejected.fetch_add(1, std::memory_order_relaxed);
+    }
+    return entry;
+}
+
+vespalib::CacheStats
+PostingListCache::get_stats() const
+{
+    vespalib::CacheStats stats = _cache.get_stats();
+    stats.add_extra_misses(_misses.load(std::memory_order_relaxed));
+    return stats;
+}
+
+}
@@ -0,0 +1,110 @@
+// Copyright Vespa.ai. Licensed under the terms of the Apache 2.0 license. See LICENSE in the project root.
+
+#pragma once
+
+#include <vespa/searchlib/common/bitvector.h>
+#include <vespa/searchlib/index/postinglisthandle.h>
+#include <vespa/vespalib/stllike/cache.h>
+#include <vespa/vespalib/stllike/cache_stats.h>
+#include <atomic>
+#include <functional>
+#include <mutex>
+#include <vector>
+
+namespace search::diskindex {
+
+/**
+ * Memory bounded LRU cache of posting lists and bit vectors read from
+ * disk indexes, shared by all queries and all disk indexes of a
+ * document db. Each loaded disk index gets its own index id, so
+ * entries of a disk index that has been switched out are never hit
+ * again and age out of the cache.
+ *
+ * Posting lists that are memory mapped are not cached, as reading
+ * them costs nothing. Other entries are only admitted when the number
+ * of times they have been read recently, multiplied by the bytes read
+ * each time, reaches the admission cost. This keeps a scan of rare
+ * words from evicting the head terms that are read by most queries.
+ * Read counts are estimated with a fixed size table of counters that
+ * are halved regularly, so terms that are no longer hot lose their
+ * advantage. The cache may exceed its max size by the size of the
+ * entry last inserted.
+ */
+class PostingListCache {
+public:
+    struct Key {
+        uint64_t index_id;
+        uint32_t field_id;
+        uint64_t word_num;
+        bool     bit_vector;
+        Key() noexcept : index_id(0), field_id(0), word_num(0), bit_vector(false) {}
+        Key(uint64_t index_id_in, uint32_t field_id_in, uint64_t word_num_in, bool bit_vector_in) noexcept
+            : index_id(index_id_in), field_id(field_id_in), word_num(word_num_in), bit_vector(bit_vector_in)
+        {}
+        uint64_t hash() const noexcept {
+            uint64_t h = (word_num << 1) ^ (bit_vector ? 1 : 0) ^ (uint64_t(field_id) << 32);
+            h ^= index_id * 0x9e3779b97f4a7c15ul;
+            return h ^ (h >> 29);
+        }
+        bool operator==(const Key &rhs) const noexcept {
+            return (index_id == rhs.index_id) && (field_id == rhs.field_id) &&
+                   (word_num == rhs.word_num) && (bit_vector == rhs.bit_vector);
+        }
+    };
+    struct Entry {
+        std::shared_ptr<const index::PostingListHandle> posting_list;
+        std::shared_ptr<const BitVector>                bit_vector;
+        Entry() noexcept : posting_list(), bit_vector() {}
+        bool empty() const noexcept { return !posting_list && !bit_vector; }
+        // Bytes held by the entry, also used as the cost of reading it
+        size_t memory_used() const noexcept;
+    };
+    using Loader = std::function<Entry()>;
+    static constexpr size_t default_admission_cost = 256 * 1024;
+
+private:
+    struct EntrySize {
+        size_t operator()(const Entry &entry) const noexcept { return entry.memory_used(); }
+    };
+    using Cache = vespalib::cache<vespalib::CacheParam<vespalib::LruParam<Key, Entry>,
+                                                       vespalib::NullStore<Key, Entry>,
+                                                       vespalib::zero<Key>, EntrySize>>;
+    static constexpr size_t num_counters = 65536;
+    static constexpr uint8_t max_count = 15;
+
+    vespalib::NullStore<Key, Entry> _store;
+    Cache                           _cache;
+    size_t                          _admission_cost;
+    std::atomic<uint64_t>           _next_index_id;
+    std::mutex                      _lock;
+    std::vector<uint8_t>            _counters;
+    size_t                          _recorded;
+    std::atomic<size_t>             _misses;
+    std::atomic<size_t>             _rejected;
+
+    uint32_t record_read(const Key &key);
+    bool admit(const Key &key, const Entry &entry);
+
+public:
+    PostingListCache(size_t max_bytes, size_t admission_cost = default_admission_cost);
+    PostingListCache(const PostingListCache &) = delete;
+    PostingListCache & operator=(const PostingListCache &) = delete;
+    ~PostingListCache();
+
+    // Allocate the id used in the keys of a newly loaded disk index.
+    uint64_t make_index_id() noexcept { return _next_index_id.fetch_add(1, std::memory_order_relaxed); }
+
+    /**
+     * Get the entry with the given key, using the loader to read it
+     * on a miss. The entry is inserted in the cache if admitted.
+     */
+    Entry get(const Key &key, const Loader &loader);
+
+    size_t size() const { return _cache.size(); }
+    size_t memory_used() const { return _cache.sizeBytes(); }
+    // Misses where the entry read was not admitted in the cache.
+    size_t rejected() const noexcept { return _rejected.load(std::memory_order_relaxed); }
+    vespalib::CacheStats get_stats() const;
+};
+
+}
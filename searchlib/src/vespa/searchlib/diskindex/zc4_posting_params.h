@@ -16,6 +16,7 @@ struct Zc4PostingParams {
     bool     _dynamic_k;
     bool     _encode_features;
     bool     _encode_interleaved_features;
+    bool     _encode_block_docids; // docids in chunks with skip info are stored by BlockDocIdEncoder
 
     Zc4PostingParams(uint32_t min_skip_docs, uint32_t min_chunk_docs, uint32_t doc_id_limit, bool dynamic_k, bool encode_features, bool encode_interleaved_features)
         : _min_skip_docs(min_skip_docs),
@@ -23,7 +24,8 @@ struct Zc4PostingParams {
           _doc_id_limit(doc_id_limit),
           _dynamic_k(dynamic_k),
           _encode_features(encode_features),
-          _encode_interleaved_features(encode_interleaved_features)
+          _encode_interleaved_features(encode_interleaved_features),
+          _encode_block_docids(false)
     {
     }
 };
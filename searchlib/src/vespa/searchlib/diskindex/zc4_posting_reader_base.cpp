@@ -44,7 +44,8 @@ Zc4PostingReaderBase::NoSkipBase::check_end(uint32_t last_doc_id)
 Zc4PostingReaderBase::NoSkip::NoSkip()
     : NoSkipBase(),
       _field_length(1),
-      _num_occs(1)
+      _num_occs(1),
+      _block_decoder()
 {
 }
 
@@ -62,6 +63,29 @@ Zc4PostingReaderBase::NoSkip::read(bool decode_interleaved_features)
     _doc_id_pos = _zc_buf.pos();
 }
 
+void
+Zc4PostingReaderBase::NoSkip::setup_block_doc_ids(uint32_t num_docs)
+{
+    uint32_t block_doc_ids_size = _zc_buf.decode();
+    _block_decoder.setup(_zc_buf._valI, num_docs, _doc_id);
+    _zc_buf._valI += block_doc_ids_size;
+    assert(_zc_buf._valI <= _zc_buf._valE);
+    _block_decoder.seek(_doc_id + 1);
+}
+
+void
+Zc4PostingReaderBase::NoSkip::read_block(bool decode_interleaved_features)
+{
+    _doc_id = _block_decoder.get_docid();
+    assert(_doc_id != BlockDocIdDecoder::END);
+    _block_decoder.next();
+    if (decode_interleaved_features) {
+        _field_length = _zc_buf.decode() + 1;
+        _num_occs = _zc_buf.decode() + 1;
+    }
+    _doc_id_pos = _zc_buf.pos();
+}
+
 void
 Zc4PostingReaderBase::NoSkip::check_not_end(uint32_t last_doc_id)
 {
@@ -201,6 +225,15 @@ Zc4PostingReaderBase::~Zc4PostingReaderBase()
 void
 Zc4PostingReaderBase::read_common_word_doc_id(DecodeContext64Base &decode_context)
 {
+    if (_posting_params._encode_block_docids) {
+        _no_skip.read_block(_posting_params._encode_interleaved_features);
+        if (_residue == 1) {
+            _no_skip.check_end(_last_doc_id);
+        } else {
+            assert(_no_skip.get_doc_id() < _last_doc_id);
+        }
+        return;
+    }
     // Split docid & features.
     if (_no_skip.get_doc_id() >= _l1_skip.get_doc_id()) {
         _no_skip.set_features_pos(decode_context.getReadOffset());
@@ -249,10 +282,17 @@ Zc4PostingReaderBase::read_word_start_with_skip(DecodeContext64Base &decode_cont
     }
     uint32_t prev_doc_id = _no_skip.get_doc_id();
     _no_skip.setup(decode_context, header._doc_ids_size, prev_doc_id);
-    _l1_skip.setup(decode_context, header._l1_skip_size, prev_doc_id, _last_doc_id);
-    _l2_skip.setup(decode_context, header._l2_skip_size, prev_doc_id, _last_doc_id);
-    _l3_skip.setup(decode_context, header._l3_skip_size, prev_doc_id, _last_doc_id);
-    _l4_skip.setup(decode_context, header._l4_skip_size, prev_doc_id, _last_doc_id);
+    if (_posting_params._encode_block_docids) {
+        // L1 skip section holds block start positions, only used by search iterators
+        assert(header._l2_skip_size == 0);
+        _l1_skip.NoSkipBase::setup(decode_context, header._l1_skip_size, prev_doc_id);
+        _no_skip.setup_block_doc_ids(_num_docs);
+    } else {
+        _l1_skip.setup(decode_context, header._l1_skip_size, prev_doc_id, _last_doc_id);
+        _l2_skip.setup(decode_context, header._l2_skip_size, prev_doc_id, _last_doc_id);
+        _l3_skip.setup(decode_context, header._l3_skip_size, prev_doc_id, _last_doc_id);
+        _l4_skip.setup(decode_context, header._l4_skip_size, prev_doc_id, _last_doc_id);
+    }
     if (_has_more || has_more) {
         assert(_last_doc_id == _counts._segments[_chunkNo]._lastDoc);
     }
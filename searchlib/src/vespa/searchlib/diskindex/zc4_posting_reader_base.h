@@ -2,6 +2,7 @@
 
 #pragma once
 
+#include "block_docid_codec.h"
 #include "zc4_posting_params.h"
 #include "zcbuf.h"
 #include <vespa/searchlib/bitcompression/compression.h>
@@ -42,10 +43,13 @@ protected:
     protected:
         uint32_t _field_length;
         uint32_t _num_occs;
+        BlockDocIdDecoder _block_decoder;
     public:
         NoSkip();
         ~NoSkip();
         void read(bool decode_interleaved_features);
+        void setup_block_doc_ids(uint32_t num_docs);
+        void read_block(bool decode_interleaved_features);
         void check_not_end(uint32_t last_doc_id);
         uint32_t get_field_length() const { return _field_length; }
         uint32_t get_num_occs()     const { return _num_occs; }
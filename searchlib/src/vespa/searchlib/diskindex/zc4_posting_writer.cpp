@@ -53,7 +53,11 @@ Zc4PostingWriter<bigEndian>::flush_word_with_skip(bool hasMore)
         e.writeBits((hasMore ? 1 : 0), 1);
     }
 
-    calc_skip_info(_encode_features != nullptr);
+    if (_encode_block_docids) {
+        calc_block_doc_id_info(_encode_features != nullptr);
+    } else {
+        calc_skip_info(_encode_features != nullptr);
+    }
 
     uint32_t docIdsSize = _zcDocIds.size();
     uint32_t l1SkipSize = _l1Skip.size();
@@ -1,6 +1,7 @@
 // Copyright Vespa.ai. Licensed under the terms of the Apache 2.0 license. See LICENSE in the project root.
 
 #include "zc4_posting_writer_base.h"
+#include "block_docid_codec.h"
 #include <vespa/searchlib/index/postinglistcounts.h>
 #include <vespa/searchlib/index/postinglistparams.h>
 #include <cassert>
@@ -208,11 +209,14 @@ Zc4PostingWriterBase::Zc4PostingWriterBase(PostingListCounts &counts)
       _writePos(0),
       _dynamicK(false),
       _encode_interleaved_features(false),
+      _encode_block_docids(false),
       _zcDocIds(),
       _l1Skip(),
       _l2Skip(),
       _l3Skip(),
       _l4Skip(),
+      _block_doc_ids(),
+      _block_buf(),
       _numWords(0),
       _counts(counts),
       _writeContext(sizeof(uint64_t)),
@@ -273,6 +277,56 @@ Zc4PostingWriterBase::calc_skip_info(bool encode_features)
     l4_skip_encoder.write_partial_skip(_l4Skip, doc_id_encoder.get_doc_id());
 }
 
+/*
+ * Block docid layout of a chunk with skip info.  The docids section holds
+ * the size of the block encoded docids, the block encoded docids and then
+ * the interleaved features (if enabled) as zc encoded values per document.
+ * The L1 skip section holds one entry for each block after the first one
+ * with the size of the features and interleaved features in the previous
+ * block, making it possible to unpack a document without decoding the
+ * features for the documents before it in other blocks.  L2-L4 are unused.
+ */
+void
+Zc4PostingWriterBase::calc_block_doc_id_info(bool encode_features)
+{
+    constexpr uint32_t block_size = BlockDocIdEncoder::BLOCK_SIZE;
+    uint32_t prev_doc_id = _counts._segments.empty() ? 0u : _counts._segments.back()._lastDoc;
+    _block_doc_ids.clear();
+    for (const auto &doc_id_and_feature_size : _docIds) {
+        _block_doc_ids.push_back(doc_id_and_feature_size._doc_id);
+    }
+    _block_buf.clear();
+    BlockDocIdEncoder::encode(_block_doc_ids, _block_buf, prev_doc_id);
+    _zcDocIds.encode(_block_buf.size());
+    for (uint8_t byte : _block_buf) {
+        *_zcDocIds._valI++ = byte;
+        _zcDocIds.maybeExpand();
+    }
+    uint32_t block_features_size = 0;
+    uint32_t block_interleaved_start = _zcDocIds.size();
+    uint32_t ordinal = 0;
+    for (const auto &doc_id_and_feature_size : _docIds) {
+        if (ordinal != 0 && (ordinal % block_size) == 0) {
+            if (encode_features) {
+                _l1Skip.encode(block_features_size);
+            }
+            if (_encode_interleaved_features) {
+                _l1Skip.encode(_zcDocIds.size() - block_interleaved_start);
+            }
+            block_features_size = 0;
+            block_interleaved_start = _zcDocIds.size();
+        }
+        block_features_size += doc_id_and_feature_size._features_size;
+        if (_encode_interleaved_features) {
+            assert(doc_id_and_feature_size._field_length > 0);
+            _zcDocIds.encode(doc_id_and_feature_size._field_length - 1);
+            assert(doc_id_and_feature_size._num_occs > 0);
+            _zcDocIds.encode(doc_id_and_feature_size._num_occs - 1);
+        }
+        ++ordinal;
+    }
+}
+
 void
 Zc4PostingWriterBase::clear_skip_info()
 {
@@ -290,6 +344,7 @@ Zc4PostingWriterBase::set_posting_list_params(const PostingListParams &params)
     params.get("minChunkDocs", _minChunkDocs);
     params.get("minSkipDocs", _minSkipDocs);
     params.get("interleaved_features", _encode_interleaved_features);
+    params.get("block_docids", _encode_block_docids);
 }
 
 }
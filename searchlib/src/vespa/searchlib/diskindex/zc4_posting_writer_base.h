@@ -44,11 +44,14 @@ protected:
     uint64_t _writePos; // Bit position for start of current word
     bool _dynamicK;     // Caclulate EG compression parameters ?
     bool _encode_interleaved_features;
+    bool _encode_block_docids;
     ZcBuf _zcDocIds;    // Document id deltas
     ZcBuf _l1Skip;      // L1 skip info
     ZcBuf _l2Skip;      // L2 skip info
     ZcBuf _l3Skip;      // L3 skip info
     ZcBuf _l4Skip;      // L4 skip info
+    std::vector<uint32_t> _block_doc_ids; // Scratch buffers for block encoded docids
+    std::vector<uint8_t> _block_buf;
 
     uint64_t _numWords; // Number of words in file
     index::PostingListCounts &_counts;
@@ -62,6 +65,7 @@ protected:
     Zc4PostingWriterBase(index::PostingListCounts &counts);
     ~Zc4PostingWriterBase();
     void calc_skip_info(bool encode_features);
+    void calc_block_doc_id_info(bool encode_features);
     void clear_skip_info();
 
 public:
@@ -73,8 +77,10 @@ public:
     uint64_t get_num_words() const { return _numWords; }
     bool get_dynamic_k() const { return _dynamicK; }
     bool get_encode_interleaved_features() const { return _encode_interleaved_features; }
+    bool get_encode_block_docids() const { return _encode_block_docids; }
     void set_dynamic_k(bool dynamicK) { _dynamicK = dynamicK; }
     void set_encode_interleaved_features(bool encode_interleaved_features) { _encode_interleaved_features = encode_interleaved_features; }
+    void set_encode_block_docids(bool encode_block_docids) { _encode_block_docids = encode_block_docids; }
     void set_posting_list_params(const index::PostingListParams &params);
 };
 
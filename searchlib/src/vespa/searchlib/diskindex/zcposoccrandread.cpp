@@ -28,6 +28,7 @@ namespace {
 vespalib::string myId4("Zc.4");
 vespalib::string myId5("Zc.5");
 vespalib::string interleaved_features("interleaved_features");
+vespalib::string block_docids("block_docids");
 
 }
 
@@ -150,6 +151,17 @@ ZcPosOccRandRead::readPostingList(const PostingListCounts &counts,
     handle._bitOffsetMem = (startOffset << 3) - _headerBitSize;
 }
 
+void
+ZcPosOccRandRead::prefetchPostingList(uint64_t bitOffset, uint64_t bitLength) const
+{
+    if (bitLength == 0) {
+        return;
+    }
+    uint64_t startOffset = (bitOffset + _headerBitSize) >> 3;
+    uint64_t endOffset = (bitOffset + _headerBitSize + bitLength + 7) >> 3;
+    _file->prefetch(startOffset, endOffset - startOffset);
+}
+
 
 bool
 ZcPosOccRandRead::
@@ -217,6 +229,9 @@ ZcPosOccRandRead::readHeader(const vespalib::string &identifier)
     if (header.hasTag(interleaved_features) && (header.getTag(interleaved_features).asInteger() != 0)) {
         _posting_params._encode_interleaved_features = true;
     }
+    if (header.hasTag(block_docids) && (header.getTag(block_docids).asInteger() != 0)) {
+        _posting_params._encode_block_docids = true;
+    }
     // Read feature decoding specific subheader
     d.readHeader(header, "features.");
     // Align on 64-bit unit
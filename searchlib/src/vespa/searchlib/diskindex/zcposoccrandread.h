@@ -42,6 +42,7 @@ public:
      */
     void readPostingList(const PostingListCounts &counts, uint32_t firstSegment,
                          uint32_t numSegments, PostingListHandle &handle) override;
+    void prefetchPostingList(uint64_t bitOffset, uint64_t bitLength) const override;
 
     bool open(const vespalib::string &name, const TuneFileRandRead &tuneFileRead) override;
     bool close() override;
@@ -18,6 +18,7 @@ namespace {
 vespalib::string myId5("Zc.5");
 vespalib::string myId4("Zc.4");
 vespalib::string interleaved_features("interleaved_features");
+vespalib::string block_docids("block_docids");
 
 }
 
@@ -122,6 +123,7 @@ Zc4PostingSeqRead::getParams(PostingListParams &params)
     }
     params.set("minSkipDocs", _reader.get_posting_params()._min_skip_docs);
     params.set(interleaved_features, _reader.get_posting_params()._encode_interleaved_features);
+    params.set(block_docids, _reader.get_posting_params()._encode_block_docids);
 }
 
 
@@ -168,6 +170,9 @@ Zc4PostingSeqRead::readHeader()
     if (header.hasTag(interleaved_features) && (header.getTag(interleaved_features).asInteger() != 0)) {
        posting_params._encode_interleaved_features = true;
     }
+    if (header.hasTag(block_docids) && (header.getTag(block_docids).asInteger() != 0)) {
+       posting_params._encode_block_docids = true;
+    }
     assert(header.getTag("endian").asString() == "big");
     // Read feature decoding specific subheader
     d.readHeader(header, "features.");
@@ -235,6 +240,7 @@ Zc4PostingSeqWrite::makeHeader(const FileHeaderContext &fileHeaderContext)
     header.putTag(Tag("format.0", myId));
     header.putTag(Tag("format.1", f.getIdentifier()));
     header.putTag(Tag("interleaved_features", _writer.get_encode_interleaved_features() ? 1 : 0));
+    header.putTag(Tag("block_docids", _writer.get_encode_block_docids() ? 1 : 0));
     header.putTag(Tag("numWords", 0));
     header.putTag(Tag("minChunkDocs", _writer.get_min_chunk_docs()));
     header.putTag(Tag("docIdLimit", _writer.get_docid_limit()));
@@ -356,6 +362,7 @@ getParams(PostingListParams &params)
     }
     params.set("minSkipDocs", _writer.get_min_skip_docs());
     params.set(interleaved_features, _writer.get_encode_interleaved_features());
+    params.set(block_docids, _writer.get_encode_block_docids());
 }
 
 
@@ -614,6 +614,229 @@ void ZcPostingIterator<bigEndian>::rewind(Position start)
     _chunkNo = 0;
 }
 
+template <bool bigEndian>
+ZcBlockPostingIterator<bigEndian>::
+ZcBlockPostingIterator(uint32_t minChunkDocs, bool dynamicK,
+                       TermFieldMatchDataArray matchData, Position start, uint32_t docIdLimit,
+                       bool decode_normal_features, bool decode_interleaved_features,
+                       bool unpack_normal_features, bool unpack_interleaved_features)
+    : ZcIteratorBase(std::move(matchData), start, docIdLimit),
+      _decodeContext(nullptr),
+      _doc_ids(),
+      _blocks(),
+      _interleaved_base(nullptr),
+      _interleaved_pos(nullptr),
+      _interleaved_ordinal(0),
+      _features_ordinal(0),
+      _minChunkDocs(minChunkDocs),
+      _dynamicK(dynamicK),
+      _numDocs(0),
+      _lastDocId(0),
+      _featuresSize(0),
+      _hasMore(false),
+      _decode_normal_features(decode_normal_features),
+      _decode_interleaved_features(decode_interleaved_features),
+      _unpack_normal_features(unpack_normal_features),
+      _unpack_interleaved_features(unpack_interleaved_features),
+      _featuresValI(nullptr),
+      _featuresBitOffset(0)
+{ }
+
+template <bool bigEndian>
+ZcBlockPostingIterator<bigEndian>::~ZcBlockPostingIterator() = default;
+
+template <bool bigEndian>
+void
+ZcBlockPostingIterator<bigEndian>::setup_blocks(const uint8_t *valI, uint32_t size)
+{
+    constexpr uint32_t block_size = BlockDocIdDecoder::BLOCK_SIZE;
+    uint32_t num_blocks = (_numDocs + block_size - 1) / block_size;
+    _blocks.clear();
+    _blocks.reserve(num_blocks);
+    _blocks.emplace_back(0, 0);
+    if (size == 0) {
+        // No features in posting list
+        _blocks.resize(num_blocks, _blocks.back());
+        return;
+    }
+    const uint8_t *valE = valI + size;
+    uint64_t features_pos = 0;
+    uint32_t interleaved_pos = 0;
+    for (uint32_t block = 1; block < num_blocks; ++block) {
+        if (_decode_normal_features) {
+            ZCDECODE(valI, features_pos +=);
+        }
+        if (_decode_interleaved_features) {
+            ZCDECODE(valI, interleaved_pos +=);
+        }
+        _blocks.emplace_back(features_pos, interleaved_pos);
+    }
+    assert(valI == valE);
+    (void) valE;
+}
+
+template <bool bigEndian>
+void
+ZcBlockPostingIterator<bigEndian>::readWordStart(uint32_t docIdLimit)
+{
+    using EC = FeatureEncodeContext<bigEndian>;
+    DecodeContextBase &d = *_decodeContext;
+    UC64_DECODECONTEXT_CONSTRUCTOR(o, d._);
+    uint32_t length;
+    uint64_t val64;
+
+    uint32_t prevDocId = _hasMore ? _lastDocId : 0u;
+    UC64_DECODEEXPGOLOMB_NS(o, K_VALUE_ZCPOSTING_NUMDOCS, EC);
+
+    _numDocs = static_cast<uint32_t>(val64) + 1;
+    bool hasMore = false;
+    if (__builtin_expect(_numDocs >= _minChunkDocs, false)) {
+        if (bigEndian) {
+            hasMore = static_cast<int64_t>(oVal) < 0;
+            oVal <<= 1;
+            length = 1;
+        } else {
+            hasMore = (oVal & 1) != 0;
+            oVal >>= 1;
+            length = 1;
+        }
+        UC64_READBITS_NS(o, EC);
+    }
+    uint32_t docIdK = K_VALUE_ZCPOSTING_LASTDOCID;
+    if (_dynamicK) {
+        docIdK = EC::calcDocIdK((_hasMore || hasMore) ? 1 : _numDocs, docIdLimit);
+    }
+    UC64_DECODEEXPGOLOMB_NS(o, K_VALUE_ZCPOSTING_DOCIDSSIZE, EC);
+    uint32_t docIdsSize = val64 + 1;
+    UC64_DECODEEXPGOLOMB_NS(o, K_VALUE_ZCPOSTING_L1SKIPSIZE, EC);
+    uint32_t l1SkipSize = val64;
+    if (l1SkipSize != 0) {
+        UC64_DECODEEXPGOLOMB_NS(o, K_VALUE_ZCPOSTING_L2SKIPSIZE, EC);
+        assert(val64 == 0);
+    }
+    if (_decode_normal_features) {
+        UC64_DECODEEXPGOLOMB_NS(o, K_VALUE_ZCPOSTING_FEATURESSIZE, EC);
+        _featuresSize = val64;
+    }
+    UC64_DECODEEXPGOLOMB_NS(o, docIdK, EC);
+    _lastDocId = docIdLimit - 1 - val64;
+
+    uint64_t bytePad = oPreRead & 7;
+    if (bytePad > 0) {
+        length = bytePad;
+        UC64_READBITS_NS(o, EC);
+    }
+
+    UC64_DECODECONTEXT_STORE(o, d._);
+    assert((d.getBitOffset() & 7) == 0);
+    const uint8_t *bcompr = d.getByteCompr();
+    const uint8_t *valI = bcompr;
+    uint32_t blockDocIdsSize;
+    ZCDECODE(valI, blockDocIdsSize =);
+    _doc_ids.setup(valI, _numDocs, prevDocId);
+    _interleaved_base = _interleaved_pos = valI + blockDocIdsSize;
+    _interleaved_ordinal = 0;
+    bcompr += docIdsSize;
+    setup_blocks(bcompr, l1SkipSize);
+    bcompr += l1SkipSize;
+    d.setByteCompr(bcompr);
+    _hasMore = hasMore;
+    // Save information about start of next chunk
+    _featuresValI = d.getCompr();
+    _featuresBitOffset = d.getBitOffset();
+    _features_ordinal = 0;
+    clearUnpacked();
+    setDocId(_doc_ids.seek(prevDocId + 1));
+}
+
+template <bool bigEndian>
+void
+ZcBlockPostingIterator<bigEndian>::doChunkSkipSeek(uint32_t docId)
+{
+    while (docId > _lastDocId && _hasMore) {
+        // Skip to start of next chunk
+        featureSeek(_featuresSize);
+        readWordStart(getDocIdLimit()); // Read word start for next chunk
+    }
+}
+
+template <bool bigEndian>
+void
+ZcBlockPostingIterator<bigEndian>::doSeek(uint32_t docId)
+{
+    if (__builtin_expect(docId > _lastDocId, false)) {
+        doChunkSkipSeek(docId);
+        if (docId > _lastDocId) {
+            setAtEnd();
+            return;
+        }
+    }
+    uint32_t oDocId = getDocId();
+    uint32_t nDocId = _doc_ids.seek(docId);
+    if (nDocId != oDocId) {
+        setDocId(nDocId);
+        clearUnpacked();
+    }
+}
+
+template <bool bigEndian>
+void
+ZcBlockPostingIterator<bigEndian>::doUnpack(uint32_t docId)
+{
+    if (!_matchData.valid() || getUnpacked()) {
+        return;
+    }
+    assert(docId == getDocId());
+    constexpr uint32_t block_size = BlockDocIdDecoder::BLOCK_SIZE;
+    uint32_t ordinal = _doc_ids.get_ordinal();
+    uint32_t block = ordinal / block_size;
+    if (_decode_normal_features && _unpack_normal_features) {
+        if (block != _features_ordinal / block_size) {
+            featureSeek(_blocks[block]._features_pos);
+            _features_ordinal = block * block_size;
+        }
+        if (ordinal > _features_ordinal) {
+            _decodeContext->skipFeatures(ordinal - _features_ordinal);
+        }
+        _decodeContext->unpackFeatures(_matchData, docId);
+        _features_ordinal = ordinal + 1;
+    } else {
+        _matchData[0]->reset(docId);
+    }
+    if (_decode_interleaved_features && _unpack_interleaved_features) {
+        if (block != _interleaved_ordinal / block_size) {
+            _interleaved_pos = _interleaved_base + _blocks[block]._interleaved_pos;
+            _interleaved_ordinal = block * block_size;
+        }
+        const uint8_t *valI = _interleaved_pos;
+        uint32_t skip_values = 2 * (ordinal - _interleaved_ordinal);
+        for (uint32_t i = 0; i < skip_values; ++i) {
+            while (*valI >= (1 << 7)) {
+                ++valI;
+            }
+            ++valI;
+        }
+        uint32_t field_length;
+        uint32_t num_occs;
+        ZCDECODE(valI, field_length = 1 +);
+        ZCDECODE(valI, num_occs = 1 +);
+        _interleaved_pos = valI;
+        _interleaved_ordinal = ordinal + 1;
+        TermFieldMatchData *tfmd = _matchData[0];
+        tfmd->setFieldLength(field_length);
+        tfmd->setNumOccs(num_occs);
+    }
+    setUnpacked();
+}
+
+template <bool bigEndian>
+void ZcBlockPostingIterator<bigEndian>::rewind(Position start)
+{
+    _decodeContext->setPosition(start);
+    _hasMore = false;
+    _lastDocId = 0;
+}
+
 template class ZcRareWordPostingIterator<false, false>;
 template class ZcRareWordPostingIterator<false, true>;
 template class ZcRareWordPostingIterator<true, false>;
@@ -622,4 +845,7 @@ template class ZcRareWordPostingIterator<true, true>;
 template class ZcPostingIterator<true>;
 template class ZcPostingIterator<false>;
 
+template class ZcBlockPostingIterator<true>;
+template class ZcBlockPostingIterator<false>;
+
 }
@@ -2,9 +2,11 @@
 
 #pragma once
 
+#include "block_docid_codec.h"
 #include <vespa/searchlib/index/postinglistfile.h>
 #include <vespa/searchlib/bitcompression/compression.h>
 #include <vespa/searchlib/queryeval/iterators.h>
+#include <vector>
 
 namespace search::diskindex {
 
@@ -343,6 +345,66 @@ public:
     }
 };
 
+/*
+ * Iterator for posting lists where the docids in each chunk are stored
+ * by BlockDocIdEncoder (see Zc4PostingWriterBase::calc_block_doc_id_info).
+ * Seeking skips whole blocks using the block headers, and features are
+ * located using the block start positions stored in the L1 skip section.
+ */
+template <bool bigEndian>
+class ZcBlockPostingIterator : public ZcIteratorBase
+{
+public:
+    using DecodeContextBase = bitcompression::FeatureDecodeContext<bigEndian>;
+    DecodeContextBase *_decodeContext;
+private:
+    struct BlockStart {
+        uint64_t _features_pos;
+        uint32_t _interleaved_pos;
+        BlockStart(uint64_t features_pos, uint32_t interleaved_pos) noexcept
+            : _features_pos(features_pos),
+              _interleaved_pos(interleaved_pos)
+        {
+        }
+    };
+    BlockDocIdDecoder       _doc_ids;
+    std::vector<BlockStart> _blocks;
+    const uint8_t *_interleaved_base;
+    const uint8_t *_interleaved_pos;
+    uint32_t       _interleaved_ordinal; // Document at _interleaved_pos
+    uint32_t       _features_ordinal;    // Document at feature decode position
+    uint32_t       _minChunkDocs;
+    bool           _dynamicK;
+    uint32_t       _numDocs;
+    uint32_t       _lastDocId;           // Last document in chunk
+    uint64_t       _featuresSize;
+    bool           _hasMore;
+    bool           _decode_normal_features;
+    bool           _decode_interleaved_features;
+    bool           _unpack_normal_features;
+    bool           _unpack_interleaved_features;
+    // Start of current features block, needed for seeks
+    const uint64_t *_featuresValI;
+    int _featuresBitOffset;
+
+    void featureSeek(uint64_t offset) {
+        _decodeContext->_valI = _featuresValI + (_featuresBitOffset + offset) / 64;
+        _decodeContext->setupBits((_featuresBitOffset + offset) & 63);
+    }
+    void setup_blocks(const uint8_t *valI, uint32_t size);
+    VESPA_DLL_LOCAL void doChunkSkipSeek(uint32_t docId);
+public:
+    ZcBlockPostingIterator(uint32_t minChunkDocs, bool dynamicK,
+                           fef::TermFieldMatchDataArray matchData, Position start, uint32_t docIdLimit,
+                           bool decode_normal_features, bool decode_interleaved_features,
+                           bool unpack_normal_features, bool unpack_interleaved_features);
+    ~ZcBlockPostingIterator() override;
+
+    void doSeek(uint32_t docId) override;
+    void doUnpack(uint32_t docId) override;
+    void readWordStart(uint32_t docIdLimit) override;
+    void rewind(Position start) override;
+};
 
 extern template class ZcRareWordPostingIterator<false, false>;
 extern template class ZcRareWordPostingIterator<false, true>;
@@ -352,4 +414,7 @@ extern template class ZcRareWordPostingIterator<true, true>;
 extern template class ZcPostingIterator<true>;
 extern template class ZcPostingIterator<false>;
 
+extern template class ZcBlockPostingIterator<true>;
+extern template class ZcBlockPostingIterator<false>;
+
 }
@@ -3,6 +3,7 @@
 #include "chunkformats.h"
 #include <vespa/vespalib/util/compressor.h>
 #include <vespa/vespalib/util/stringfmt.h>
+#include <vespa/vespalib/util/zstd_dictionary.h>
 
 namespace search {
 
@@ -12,6 +13,29 @@ using vespalib::compression::compress;
 using vespalib::compression::decompress;
 using vespalib::compression::computeMaxCompressedsize;
 using vespalib::compression::CompressionConfig;
+using vespalib::compression::ZStdDictionary;
+
+namespace {
+
+CompressionConfig::Type
+compressWithDictionary(const ZStdDictionary & dictionary, CompressionConfig compression,
+                       const vespalib::ConstBufferRef & org, vespalib::DataBuffer & dest)
+{
+    if (org.size() >= compression.minSize) {
+        dest.ensureFree(computeMaxCompressedsize(CompressionConfig::ZSTD, org.size()));
+        size_t compressedSize(dest.getFreeLen());
+        if (dictionary.compress(org.c_str(), org.size(), dest.getFree(), compressedSize) &&
+            (compressedSize < ((org.size() * compression.threshold)/100)))
+        {
+            dest.moveFreeToData(compressedSize);
+            return CompressionConfig::ZSTD;
+        }
+    }
+    dest.writeBytes(org.c_str(), org.size());
+    return CompressionConfig::NONE;
+}
+
+}
 
 ChunkException::ChunkException(const vespalib::string & msg, vespalib::stringref location) :
     Exception(make_string("Illegal chunk: %s", msg.c_str()), location)
@@ -19,7 +43,8 @@ ChunkException::ChunkException(const vespalib::string & msg, vespalib::stringref
 }
 
 void
-ChunkFormat::pack(uint64_t lastSerial, vespalib::DataBuffer & compressed, CompressionConfig compression)
+ChunkFormat::pack(uint64_t lastSerial, vespalib::DataBuffer & compressed, CompressionConfig compression,
+                  const ZStdDictionary * dictionary)
 {
     vespalib::nbostream & os = _dataBuf;
     os << lastSerial;
@@ -33,7 +58,10 @@ ChunkFormat::pack(uint64_t lastSerial, vespalib::DataBuffer & compressed, Compre
     const size_t oldPos(compressed.getDataLen());
     compressed.writeInt8(compression.type);
     compressed.writeInt32(os.size());
-    CompressionConfig::Type type(compress(compression, vespalib::ConstBufferRef(os.data(), os.size()), compressed, false));
+    vespalib::ConstBufferRef org(os.data(), os.size());
+    CompressionConfig::Type type((dictionary != nullptr) && (compression.type == CompressionConfig::ZSTD)
+                                 ? compressWithDictionary(*dictionary, compression, org, compressed)
+                                 : compress(compression, org, compressed, false));
     if (compression.type != type) {
         compressed.getData()[oldPos] = type;
     }
@@ -67,7 +95,7 @@ ChunkFormat::verifyCompression(uint8_t type)
 }
 
 ChunkFormat::UP
-ChunkFormat::deserialize(const void * buffer, size_t len)
+ChunkFormat::deserialize(const void * buffer, size_t len, const ZStdDictionary * dictionary)
 {
     uint8_t version(0);
     vespalib::nbostream raw(buffer, len);
@@ -82,9 +110,9 @@ ChunkFormat::deserialize(const void * buffer, size_t len)
     raw >> crc32;
     raw.rp(currPos);
     if (version == ChunkFormatV1::VERSION) {
-        return std::make_unique<ChunkFormatV1>(raw, crc32);
+        return std::make_unique<ChunkFormatV1>(raw, crc32, dictionary);
     } else if (version == ChunkFormatV2::VERSION) {
-            return std::make_unique<ChunkFormatV2>(raw, crc32);
+            return std::make_unique<ChunkFormatV2>(raw, crc32, dictionary);
     } else {
         throw ChunkException(make_string("Unknown version %d", version), VESPA_STRLOC);
     }
@@ -109,7 +137,7 @@ ChunkFormat::verifyCrc(const vespalib::nbostream & is, uint32_t expectedCrc) con
 }
 
 void
-ChunkFormat::deserializeBody(vespalib::nbostream & is)
+ChunkFormat::deserializeBody(vespalib::nbostream & is, const ZStdDictionary * dictionary)
 {
     if (includeSerializedSize()) {
         uint32_t serializedSize(0);
@@ -128,7 +156,20 @@ ChunkFormat::deserializeBody(vespalib::nbostream & is)
     // This is a dirty trick to fool some odd sanity checking in DataBuffer::swap
     vespalib::DataBuffer uncompressed(const_cast<char *>(is.peek()), (size_t)0);
     vespalib::ConstBufferRef data(is.peek(), is.size() - sizeof(uint32_t));
-    decompress(CompressionConfig::Type(type), uncompressedLen, data, uncompressed, true);
+    uint32_t dictionaryId = (type == CompressionConfig::ZSTD) ? ZStdDictionary::frameDictionaryId(data.c_str(), data.size()) : 0;
+    if (dictionaryId != 0) {
+        if ((dictionary == nullptr) || (dictionary->id() != dictionaryId)) {
+            throw ChunkException(make_string("Chunk is compressed with unknown dictionary %u", dictionaryId), VESPA_STRLOC);
+        }
+        uncompressed.ensureFree(uncompressedLen);
+        size_t realUncompressedLen(uncompressed.getFreeLen());
+        if ( ! dictionary->decompress(data.c_str(), data.size(), uncompressed.getFree(), realUncompressedLen)) {
+            throw ChunkException(make_string("Failed decompressing chunk with dictionary %u", dictionaryId), VESPA_STRLOC);
+        }
+        uncompressed.moveFreeToData(realUncompressedLen);
+    } else {
+        decompress(CompressionConfig::Type(type), uncompressedLen, data, uncompressed, true);
+    }
     assert(uncompressed.getData() == uncompressed.getDead());
     if (uncompressed.getData() != data.c_str()) {
         const size_t sz(uncompressed.getDataLen());
@@ -7,6 +7,8 @@
 #include <vespa/vespalib/data/databuffer.h>
 #include <vespa/vespalib/util/exception.h>
 
+namespace vespalib::compression { class ZStdDictionary; }
+
 namespace search {
 
 class ChunkException : public vespalib::Exception
@@ -22,6 +24,7 @@ public:
     virtual ~ChunkFormat();
     using UP = std::unique_ptr<ChunkFormat>;
     using CompressionConfig = vespalib::compression::CompressionConfig;
+    using ZStdDictionary = vespalib::compression::ZStdDictionary;
     vespalib::nbostream & getBuffer() { return _dataBuf; }
     const vespalib::nbostream & getBuffer() const { return _dataBuf; }
 
@@ -30,14 +33,17 @@ public:
      * @param lastSerial The last serial number of any entry in the packet.
      * @param compressed The buffer where the serialized data shall be placed.
      * @param compression What kind of compression shall be employed.
+     * @param dictionary Optional dictionary used when compression is ZSTD.
      */
-    void pack(uint64_t lastSerial, vespalib::DataBuffer & compressed, CompressionConfig compression);
+    void pack(uint64_t lastSerial, vespalib::DataBuffer & compressed, CompressionConfig compression,
+              const ZStdDictionary * dictionary = nullptr);
     /**
      * Will deserialize and create a representation of the uncompressed data.
      * param buffer Pointer to the serialized data
      * @param len Length of serialized data
+     * @param dictionary Dictionary needed by chunks compressed with one.
      */
-    static ChunkFormat::UP deserialize(const void * buffer, size_t len);
+    static ChunkFormat::UP deserialize(const void * buffer, size_t len, const ZStdDictionary * dictionary = nullptr);
     /**
      * return the maximum size a packet can have. It allows correct size estimation
      * need for direct io alignment.
@@ -58,8 +64,9 @@ protected:
     /**
      * Will deserialize and uncompress the body.
      * @param the potentially compressed stream.
+     * @param dictionary Dictionary needed by chunks compressed with one.
      */
-    void deserializeBody(vespalib::nbostream & is);
+    void deserializeBody(vespalib::nbostream & is, const ZStdDictionary * dictionary);
     /**
      * Wille compute and check the crc of the incoming stream.
      * Will start 1 byte earlier and stop 4 bytes ahead of end.
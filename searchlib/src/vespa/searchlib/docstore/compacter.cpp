@@ -4,7 +4,9 @@
 #include "logdatastore.h"
 #include <vespa/vespalib/util/size_literals.h>
 #include <vespa/vespalib/util/array.hpp>
+#include <vespa/vespalib/util/io_scheduler.h>
 #include <cassert>
+#include <thread>
 
 #include <vespa/log/log.h>
 LOG_SETUP(".searchlib.docstore.compacter");
@@ -17,11 +19,51 @@ namespace {
     constexpr size_t INITIAL_BACKING_BUFFER_SIZE = 64_Mi;
 }
 
+CompactionPacer::CompactionPacer(size_t stepBytes, size_t maxBytesPerSecond) noexcept
+    : _stepBytes(std::max(stepBytes, size_t(1))),
+      _maxBytesPerSecond(maxBytesPerSecond),
+      _stepBytesWritten(0),
+      _bytesWritten(0),
+      _numSteps(0),
+      _start(vespalib::steady_clock::now())
+{}
+
+void
+CompactionPacer::written(size_t bytes) {
+    _stepBytesWritten += bytes;
+    if (_stepBytesWritten >= _stepBytes) {
+        completeStep();
+    }
+}
+
+void
+CompactionPacer::finish() {
+    if (_stepBytesWritten > 0) {
+        completeStep();
+    }
+}
+
+void
+CompactionPacer::completeStep() {
+    vespalib::IoScheduler::throttle(_stepBytesWritten);
+    _bytesWritten += _stepBytesWritten;
+    _stepBytesWritten = 0;
+    _numSteps++;
+    if (_maxBytesPerSecond > 0) {
+        vespalib::steady_time due = _start + vespalib::from_s(double(_bytesWritten) / _maxBytesPerSecond);
+        vespalib::steady_time now = vespalib::steady_clock::now();
+        if (due > now) {
+            std::this_thread::sleep_for(due - now);
+        }
+    }
+}
+
 void
 Compacter::write(LockGuard guard, uint32_t chunkId, uint32_t lid, ConstBufferRef data) {
     (void) chunkId;
     FileChunk::FileId fileId = _ds.getActiveFileId(guard);
     _ds.write(std::move(guard), fileId, lid, data);
+    _pacer.written(data.size());
 }
 
 BucketIndexStore::BucketIndexStore(size_t maxSignificantBucketBits, uint32_t numPartitions) noexcept
@@ -83,11 +125,13 @@ BucketIndexStore::LidIterator::next() noexcept {
 }
 
 BucketCompacter::BucketCompacter(size_t maxSignificantBucketBits, CompressionConfig compression, LogDataStore & ds,
-                                 Executor & executor, const IBucketizer & bucketizer, FileId source, FileId destination)
+                                 Executor & executor, const IBucketizer & bucketizer, FileId source, FileId destination,
+                                 CompactionPacer & pacer)
     : _sourceFileId(source),
       _destinationFileId(destination),
       _ds(ds),
       _bucketizer(bucketizer),
+      _pacer(pacer),
       _lock(),
       _backingMemory(Alloc::alloc(INITIAL_BACKING_BUFFER_SIZE), &_lock),
       _bucketIndexStore(maxSignificantBucketBits, NUM_PARTITIONS),
@@ -131,6 +175,7 @@ BucketCompacter::close()
         auto partIterator = _bucketIndexStore.createIterator(partId);
         _tmpStore[partId]->drain(*this, *partIterator);
     }
+    _pacer.finish();
     // All partitions using _backingMemory should be destructed before clearing.
     _backingMemory.clear();
 
@@ -150,6 +195,7 @@ BucketCompacter::write(BucketId bucketId, uint32_t chunkId, uint32_t lid, ConstB
     if (_ds.getLid(_lidGuard, lid) == lidInfo) {
         FileId fileId = getDestinationId(guard);
         _ds.write(std::move(guard), fileId, lid, data);
+        _pacer.written(data.size());
     }
 }
 
@@ -5,22 +5,50 @@
 #include "filechunk.h"
 #include "storebybucket.h"
 #include <vespa/vespalib/data/memorydatastore.h>
+#include <vespa/vespalib/util/time.h>
 
 namespace search { class LogDataStore; }
 
 namespace search::docstore {
 
+/**
+ * Splits the data written by a compaction into steps of a bounded size.
+ * When a step is complete it is charged to the node wide io scheduler,
+ * and if a max rate is given the compaction sleeps until it is back
+ * within that rate. This keeps compaction from saturating the disk.
+ * Not thread safe, all writes must come from the compacting thread.
+ */
+class CompactionPacer
+{
+public:
+    CompactionPacer(size_t stepBytes, size_t maxBytesPerSecond) noexcept;
+    void written(size_t bytes);
+    // Charges the last partial step.
+    void finish();
+    size_t getNumSteps() const noexcept { return _numSteps; }
+    size_t getBytesWritten() const noexcept { return _bytesWritten + _stepBytesWritten; }
+private:
+    void completeStep();
+    const size_t          _stepBytes;
+    const size_t          _maxBytesPerSecond;
+    size_t                _stepBytesWritten;
+    size_t                _bytesWritten;
+    size_t                _numSteps;
+    vespalib::steady_time _start;
+};
+
 /**
  * A simple write through implementation of the IWriteData interface.
  */
 class Compacter : public IWriteData
 {
 public:
-    explicit Compacter(LogDataStore & ds) : _ds(ds) { }
+    Compacter(LogDataStore & ds, CompactionPacer & pacer) : _ds(ds), _pacer(pacer) { }
     void write(LockGuard guard, uint32_t chunkId, uint32_t lid, ConstBufferRef data) override;
-    void close() override { }
+    void close() override { _pacer.finish(); }
 private:
-    LogDataStore & _ds;
+    LogDataStore    & _ds;
+    CompactionPacer & _pacer;
 };
 
 class BucketIndexStore : public StoreByBucket::StoreIndex {
@@ -68,7 +96,8 @@ class BucketCompacter : public IWriteData,
 public:
     using FileId = FileChunk::FileId;
     BucketCompacter(size_t maxSignificantBucketBits, CompressionConfig compression, LogDataStore & ds,
-                    Executor & executor, const IBucketizer & bucketizer, FileId source, FileId destination);
+                    Executor & executor, const IBucketizer & bucketizer, FileId source, FileId destination,
+                    CompactionPacer & pacer);
     ~BucketCompacter() override;
     void write(LockGuard guard, uint32_t chunkId, uint32_t lid, ConstBufferRef data) override;
     void write(BucketId bucketId, uint32_t chunkId, uint32_t lid, ConstBufferRef data) override;
@@ -82,6 +111,7 @@ private:
     FileId                                 _destinationFileId;
     LogDataStore                         & _ds;
     const IBucketizer                    & _bucketizer;
+    CompactionPacer                      & _pacer;
     std::mutex                             _lock;
     vespalib::MemoryDataStore              _backingMemory;
     BucketIndexStore                       _bucketIndexStore;
@@ -6,6 +6,7 @@
 #include "value.h"
 #include <vespa/document/fieldvalue/document.h>
 #include <vespa/vespalib/stllike/cache.hpp>
+#include <vespa/vespalib/stllike/hash_map.h>
 #include <vespa/vespalib/data/databuffer.h>
 #include <vespa/vespalib/util/compressor.h>
 #include <vespa/vespalib/util/size_literals.h>
@@ -43,6 +44,61 @@ DocumentVisitorAdapter::visit(uint32_t lid, vespalib::ConstBufferRef buf) {
     }
 }
 
+/**
+ * Positions of the lids in a batch, with the positions of duplicate lids chained together.
+ */
+class LidPositions
+{
+public:
+    static constexpr uint32_t NONE = std::numeric_limits<uint32_t>::max();
+    explicit LidPositions(const IDocumentStore::LidVector & lids);
+    uint32_t first(uint32_t lid) const {
+        auto found = _first.find(lid);
+        return (found != _first.end()) ? found->second : NONE;
+    }
+    uint32_t next(uint32_t pos) const { return _next[pos]; }
+private:
+    vespalib::hash_map<uint32_t, uint32_t> _first;
+    std::vector<uint32_t>                  _next;
+};
+
+LidPositions::LidPositions(const IDocumentStore::LidVector & lids)
+    : _first(lids.size() * 2),
+      _next(lids.size(), NONE)
+{
+    for (size_t i(lids.size()); i-- > 0; ) {
+        auto inserted = _first.insert(std::make_pair(lids[i], uint32_t(i)));
+        if ( ! inserted.second) {
+            _next[i] = inserted.first->second;
+            inserted.first->second = i;
+        }
+    }
+}
+
+/**
+ * Calls func(pos, buf) for every position in the batch of the visited lid.
+ */
+template <typename Func>
+class LidPositionVisitor : public IBufferVisitor
+{
+public:
+    LidPositionVisitor(const LidPositions & positions, Func func)
+        : _positions(positions),
+          _func(std::move(func))
+    { }
+    void visit(uint32_t lid, vespalib::ConstBufferRef buf) override {
+        if (buf.size() == 0) {
+            return;
+        }
+        for (uint32_t pos = _positions.first(lid); pos != LidPositions::NONE; pos = _positions.next(pos)) {
+            _func(pos, buf);
+        }
+    }
+private:
+    const LidPositions & _positions;
+    Func                 _func;
+};
+
 }
 
 using vespalib::nbostream;
@@ -57,6 +113,7 @@ public:
     { }
 
     bool read(DocumentIdT key, Value &value) const;
+    void read(const IDocumentStore::LidVector &lids, std::vector<Value> &values, std::vector<bool> &found) const;
     void visit(const IDocumentStore::LidVector &lids, const DocumentTypeRepo &repo, IDocumentVisitor &visitor) const;
     void write(DocumentIdT, const Value &);
     void erase(DocumentIdT) {}
@@ -86,6 +143,19 @@ BackingStore::read(DocumentIdT key, Value &value) const {
     return found;
 }
 
+void
+BackingStore::read(const IDocumentStore::LidVector &lids, std::vector<Value> &values, std::vector<bool> &found) const {
+    LidPositions positions(lids);
+    CompressionConfig compression = getCompression();
+    LidPositionVisitor visitor(positions, [&values, &found, compression](uint32_t pos, vespalib::ConstBufferRef buf) {
+        vespalib::DataBuffer copy(buf.size());
+        copy.writeBytes(buf.c_str(), buf.size());
+        values[pos].set(std::move(copy), buf.size(), compression);
+        found[pos] = true;
+    });
+    _backingStore.read(lids, visitor);
+}
+
 void
 BackingStore::write(DocumentIdT lid, const Value & value)
 {
@@ -155,6 +225,35 @@ DocumentStore::Config::UpdateStrategy DocumentStore::updateStrategy() const {
     return _updateStrategy.load(std::memory_order_relaxed);
 }
 
+std::vector<IDocumentStore::DocumentUP>
+DocumentStore::read_batch(const LidVector & lids, const DocumentTypeRepo &repo) const
+{
+    std::vector<DocumentUP> docs(lids.size());
+    if (useCache()) {
+        std::vector<Value> values = _cache->read(lids);
+        for (size_t i(0); i < lids.size(); i++) {
+            if (values[i].empty()) {
+                continue;
+            }
+            Value::Result result = values[i].decompressed();
+            if (result.second) {
+                docs[i] = std::make_unique<document::Document>(repo, std::move(result.first));
+            } else {
+                docs[i] = read(lids[i], repo);
+            }
+        }
+    } else {
+        _uncached_lookups.fetch_add(lids.size());
+        LidPositions positions(lids);
+        LidPositionVisitor visitor(positions, [&docs, &repo](uint32_t pos, vespalib::ConstBufferRef buf) {
+            vespalib::nbostream is(buf.c_str(), buf.size());
+            docs[pos] = std::make_unique<document::Document>(repo, is);
+        });
+        _backingStore.read(lids, visitor);
+    }
+    return docs;
+}
+
 void
 DocumentStore::visit(const LidVector & lids, const DocumentTypeRepo &repo, IDocumentVisitor & visitor) const
 {
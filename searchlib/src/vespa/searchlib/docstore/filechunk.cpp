@@ -12,6 +12,7 @@
 #include <vespa/vespalib/objects/nbostream.h>
 #include <vespa/vespalib/util/executor.h>
 #include <vespa/vespalib/util/arrayqueue.hpp>
+#include <vespa/vespalib/util/zstd_dictionary.h>
 #include <vespa/fastos/file.h>
 #include <filesystem>
 #include <future>
@@ -30,6 +31,24 @@ namespace {
 constexpr size_t ALIGNMENT=0x1000;
 constexpr size_t ENTRY_BIAS_SIZE=8;
 const vespalib::string DOC_ID_LIMIT_KEY("docIdLimit");
+// Number of chunks visited in the first round when sampling a file.
+constexpr size_t SAMPLE_CHUNKS = 256;
+// Bounds the memory used for chunks being read at the same time.
+constexpr size_t MAX_CHUNKS_PER_BATCH = 64;
+
+std::shared_ptr<const vespalib::compression::ZStdDictionary>
+readDictionary(const vespalib::string & fileName)
+{
+    FastOS_File file(fileName.c_str());
+    if ( ! file.OpenReadOnly()) {
+        return {};
+    }
+    std::vector<char> content(file.getSize());
+    if (file.Read(content.data(), content.size()) != ssize_t(content.size())) {
+        throw SummaryException("Failed reading dictionary file", file, VESPA_STRLOC);
+    }
+    return std::make_shared<vespalib::compression::ZStdDictionary>(vespalib::ConstBufferRef(content.data(), content.size()));
+}
 
 }
 
@@ -60,6 +79,11 @@ FileChunk::createDatFileName(const vespalib::string & name) {
     return name + ".dat";
 }
 
+vespalib::string
+FileChunk::createDictFileName(const vespalib::string & name) {
+    return name + ".dict";
+}
+
 FileChunk::FileChunk(FileId fileId, NameId nameId, const vespalib::string & baseName,
                      const TuneFileSummary & tune, const IBucketizer * bucketizer)
     : _fileId(fileId),
@@ -77,6 +101,7 @@ FileChunk::FileChunk(FileId fileId, NameId nameId, const vespalib::string & base
       _tune(tune),
       _dataFileName(createDatFileName(_name)),
       _idxFileName(createIdxFileName(_name)),
+      _dictionary(),
       _chunkInfo(),
       _lastPersistedSerialNum(0),
       _dataHeaderLen(0u),
@@ -101,6 +126,7 @@ FileChunk::FileChunk(FileId fileId, NameId nameId, const vespalib::string & base
         } else {
             throw SummaryException("Failed opening idx file", idxFile, VESPA_STRLOC);
         }
+        _dictionary = readDictionary(createDictFileName(_name));
     }
 }
 
@@ -129,6 +155,7 @@ FileChunk::erase()
     _file.reset();
     std::filesystem::remove(std::filesystem::path(_idxFileName));
     std::filesystem::remove(std::filesystem::path(_dataFileName));
+    std::filesystem::remove(std::filesystem::path(createDictFileName(_name)));
 }
 
 void
@@ -316,7 +343,7 @@ FileChunk::appendTo(vespalib::Executor & executor, const IGetLid & db, IWriteDat
             const ChunkInfo & cInfo(_chunkInfo[chunkId]);
             vespalib::DataBuffer whole(0ul, ALIGNMENT);
             FileRandRead::FSP keepAlive(_file->read(cInfo.getOffset(), whole, cInfo.getSize()));
-            promise.set_value(std::make_unique<Chunk>(chunkId, whole.getData(), whole.getDataLen()));
+            promise.set_value(std::make_unique<Chunk>(chunkId, whole.getData(), whole.getDataLen(), _dictionary.get()));
         });
         executor.execute(CpuUsage::wrap(std::move(task), cpu_category));
 
@@ -338,32 +365,48 @@ void
 FileChunk::read(LidInfoWithLidV::const_iterator begin, size_t count, IBufferVisitor & visitor) const
 {
     if (count == 0) { return; }
+    std::vector<ChunkLids> chunks;
     uint32_t prevChunk = begin->getChunkId();
     uint32_t start(0);
     for (size_t i(0); i < count; i++) {
         const LidInfoWithLid & li = *(begin + i);
         if (li.getChunkId() != prevChunk) {
-            ChunkInfo ci = _chunkInfo[prevChunk];
-            read(begin + start, i - start, ci, visitor);
+            chunks.emplace_back(begin + start, i - start, _chunkInfo[prevChunk]);
             prevChunk = li.getChunkId();
             start = i;
         }
     }
-    ChunkInfo ci = _chunkInfo[prevChunk];
-    read(begin + start, count - start, ci, visitor);
+    chunks.emplace_back(begin + start, count - start, _chunkInfo[prevChunk]);
+    read(chunks, visitor);
 }
 
 void
-FileChunk::read(LidInfoWithLidV::const_iterator begin, size_t count, ChunkInfo ci, IBufferVisitor & visitor) const
+FileChunk::read(const std::vector<ChunkLids> & chunks, IBufferVisitor & visitor) const
 {
-    vespalib::DataBuffer whole(0ul, ALIGNMENT);
-    FileRandRead::FSP keepAlive = _file->read(ci.getOffset(), whole, ci.getSize());
-    Chunk chunk(begin->getChunkId(), whole.getData(), whole.getDataLen());
-    for (size_t i(0); i < count; i++) {
-        const LidInfoWithLid & li = *(begin + i);
-        vespalib::ConstBufferRef buf = chunk.getLid(li.getLid());
-        if (buf.size() != 0) {
-            visitor.visit(li.getLid(), buf);
+    std::vector<vespalib::DataBuffer> buffers;
+    std::vector<FileRandRead::Request> requests;
+    for (size_t first(0); first < chunks.size(); first += MAX_CHUNKS_PER_BATCH) {
+        size_t numChunks = std::min(MAX_CHUNKS_PER_BATCH, chunks.size() - first);
+        buffers.clear();
+        requests.clear();
+        buffers.reserve(numChunks);
+        requests.reserve(numChunks);
+        for (size_t i(0); i < numChunks; i++) {
+            const ChunkInfo & ci = chunks[first + i].chunkInfo;
+            buffers.emplace_back(0ul, ALIGNMENT);
+            requests.emplace_back(ci.getOffset(), ci.getSize(), buffers.back());
+        }
+        _file->readBatch(requests);
+        for (size_t i(0); i < numChunks; i++) {
+            const ChunkLids & lids = chunks[first + i];
+            Chunk chunk(lids.begin->getChunkId(), buffers[i].getData(), buffers[i].getDataLen(), _dictionary.get());
+            for (size_t j(0); j < lids.count; j++) {
+                const LidInfoWithLid & li = *(lids.begin + j);
+                vespalib::ConstBufferRef buf = chunk.getLid(li.getLid());
+                if (buf.size() != 0) {
+                    visitor.visit(li.getLid(), buf);
+                }
+            }
         }
     }
 }
@@ -383,7 +426,7 @@ FileChunk::read(uint32_t lid, SubChunkId chunkId, const ChunkInfo & chunkInfo,
 {
     vespalib::DataBuffer whole(0ul, ALIGNMENT);
     FileRandRead::FSP keepAlive(_file->read(chunkInfo.getOffset(), whole, chunkInfo.getSize()));
-    Chunk chunk(chunkId, whole.getData(), whole.getDataLen());
+    Chunk chunk(chunkId, whole.getData(), whole.getDataLen(), _dictionary.get());
     return chunk.read(lid, buffer);
 }
 
@@ -459,7 +502,7 @@ FileChunk::verify(bool reportOnly) const
         vespalib::DataBuffer whole(0ul, ALIGNMENT);
         FileRandRead::FSP keepAlive(_file->read(ci.getOffset(), whole, ci.getSize()));
         try {
-            Chunk chunk(chunkId++, whole.getData(), whole.getDataLen());
+            Chunk chunk(chunkId++, whole.getData(), whole.getDataLen(), _dictionary.get());
             assert(chunk.getLastSerial() >= lastSerial);
             lastSerial = chunk.getLastSerial();
             if (errorInPrev) {
@@ -476,6 +519,26 @@ FileChunk::verify(bool reportOnly) const
     }
 }
 
+void
+FileChunk::sample(ZStdDictionary::Samples & samples) const
+{
+    size_t numChunks = _chunkInfo.size();
+    size_t stride = std::max(size_t(1), numChunks / SAMPLE_CHUNKS);
+    for (size_t start(0); (start < stride) && !samples.full(); start++) {
+        for (size_t chunkId(start); (chunkId < numChunks) && !samples.full(); chunkId += stride) {
+            const ChunkInfo & ci = _chunkInfo[chunkId];
+            vespalib::DataBuffer whole(0ul, ALIGNMENT);
+            FileRandRead::FSP keepAlive(_file->read(ci.getOffset(), whole, ci.getSize()));
+            const Chunk chunk(chunkId, whole.getData(), whole.getDataLen(), _dictionary.get());
+            for (const Chunk::Entry & e : chunk.getLids()) {
+                if ( ! samples.add(vespalib::ConstBufferRef(chunk.getData().data() + e.getNetOffset(), e.netSize()))) {
+                    break;
+                }
+            }
+        }
+    }
+}
+
 uint32_t
 FileChunk::getNumChunks() const
 {
@@ -542,6 +605,8 @@ FileChunk::eraseDatFile(const vespalib::string & name)
 {
     vespalib::string fileName(createDatFileName(name));
     std::filesystem::remove(std::filesystem::path(fileName));
+    // The dictionary is only used by the chunks in the data file.
+    std::filesystem::remove(std::filesystem::path(createDictFileName(name)));
 }
 
 
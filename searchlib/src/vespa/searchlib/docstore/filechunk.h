@@ -12,6 +12,7 @@
 #include <vespa/vespalib/util/generationhandler.h>
 #include <vespa/vespalib/util/memoryusage.h>
 #include <vespa/vespalib/util/time.h>
+#include <vespa/vespalib/util/zstd_dictionary.h>
 
 class FastOS_FileInterface;
 
@@ -105,6 +106,7 @@ public:
     using LidBufferMap = vespalib::hash_map<uint32_t, std::unique_ptr<vespalib::DataBuffer>>;
     using UP = std::unique_ptr<FileChunk>;
     using SubChunkId = uint32_t;
+    using ZStdDictionary = vespalib::compression::ZStdDictionary;
     FileChunk(FileId fileId, NameId nameId, const vespalib::string &baseName, const TuneFileSummary &tune,
               const IBucketizer *bucketizer);
     virtual ~FileChunk();
@@ -163,6 +165,8 @@ public:
     virtual vespalib::system_time getModificationTime() const;
     virtual bool frozen() const { return true; }
     const vespalib::string & getName() const { return _name; }
+    // Dictionary used by chunks compressed with one, loaded from the '.dict' file.
+    const std::shared_ptr<const ZStdDictionary> & getDictionary() const { return _dictionary; }
     void appendTo(vespalib::Executor & executor, const IGetLid & db, IWriteData & dest,
                   uint32_t numChunks, IFileChunkVisitorProgress *visitorProgress,
                   vespalib::CpuUsage::Category cpu_category);
@@ -182,6 +186,12 @@ public:
      * @param reportOnly If set inconsitencies will be written to 'stderr'.
      */
     void verify(bool reportOnly) const;
+    /**
+     * Add the entries of chunks spread evenly across the file to the
+     * given samples until there is no room for more. Used to train a
+     * dictionary for the data in this file.
+     */
+    void sample(ZStdDictionary::Samples & samples) const;
 
     uint32_t      getNumChunks() const;
     size_t       getNumBuckets() const { return _sumNumBuckets; }
@@ -199,6 +209,7 @@ public:
     static void eraseDatFile(const vespalib::string & name);
     static vespalib::string createIdxFileName(const vespalib::string & name);
     static vespalib::string createDatFileName(const vespalib::string & name);
+    static vespalib::string createDictFileName(const vespalib::string & name);
 private:
     class TmpChunkMeta : public ChunkMeta,
                          public std::vector<LidMeta>
@@ -243,7 +254,16 @@ protected:
 
     void setNumUniqueBuckets(size_t numUniqueBuckets) { _numUniqueBuckets = numUniqueBuckets; }
     ssize_t read(uint32_t lid, SubChunkId chunkId, const ChunkInfo & chunkInfo, vespalib::DataBuffer & buffer) const;
-    void read(LidInfoWithLidV::const_iterator begin, size_t count, ChunkInfo ci, IBufferVisitor & visitor) const;
+    struct ChunkLids {
+        ChunkLids(LidInfoWithLidV::const_iterator begin_in, size_t count_in, ChunkInfo chunkInfo_in) noexcept
+            : begin(begin_in), count(count_in), chunkInfo(chunkInfo_in)
+        {}
+        LidInfoWithLidV::const_iterator begin;
+        size_t                          count;
+        ChunkInfo                       chunkInfo;
+    };
+    // The chunks are read in batches, letting the reads of a batch be in flight at the same time.
+    void read(const std::vector<ChunkLids> & chunks, IBufferVisitor & visitor) const;
     static uint32_t readDocIdLimit(vespalib::GenericHeader &header);
     static void writeDocIdLimit(vespalib::GenericHeader &header, uint32_t docIdLimit);
 
@@ -253,6 +273,7 @@ protected:
     TuneFileSummary        _tune;
     vespalib::string       _dataFileName;
     vespalib::string       _idxFileName;
+    std::shared_ptr<const ZStdDictionary> _dictionary;
     ChunkInfoVector        _chunkInfo;
     std::atomic<uint64_t>  _lastPersistedSerialNum;
     uint32_t               _dataHeaderLen;
@@ -14,4 +14,9 @@ IDataStore::~IDataStore()
 {
 }
 
+void
+IDataStore::sortLidsInStorageOrder(LidVector &) const
+{
+}
+
 } // namespace search
@@ -58,6 +58,12 @@ public:
      **/
     virtual ssize_t read(uint32_t lid, vespalib::DataBuffer & buffer) const = 0;
     virtual void read(const LidVector & lids, IBufferVisitor & visitor) const = 0;
+    /**
+     * Reorder the lids to follow how their data is laid out in the store, so that
+     * reading them in consecutive slices gives mostly sequential I/O.
+     * The default keeps the given order.
+     **/
+    virtual void sortLidsInStorageOrder(LidVector & lids) const;
 
     /**
      * Write data to the data store.
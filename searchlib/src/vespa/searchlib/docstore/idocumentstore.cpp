@@ -5,10 +5,23 @@
 
 namespace search {
 
+std::vector<IDocumentStore::DocumentUP>
+IDocumentStore::read_batch(const LidVector & lids, const document::DocumentTypeRepo &repo) const {
+    std::vector<DocumentUP> docs;
+    docs.reserve(lids.size());
+    for (uint32_t lid : lids) {
+        docs.push_back(read(lid, repo));
+    }
+    return docs;
+}
+
 void IDocumentStore::visit(const LidVector & lids, const document::DocumentTypeRepo &repo, IDocumentVisitor & visitor) const {
     for (uint32_t lid : lids) {
         visitor.visit(lid, read(lid, repo));
     }
 }
 
+void IDocumentStore::sortLidsInStorageOrder(LidVector &) const {
+}
+
 } // namespace search
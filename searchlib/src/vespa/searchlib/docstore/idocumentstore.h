@@ -75,7 +75,18 @@ public:
      * @return NULL if there is no document associated with the lid.
      **/
     virtual DocumentUP read(DocumentIdT lid, const document::DocumentTypeRepo &repo) const = 0;
+    /**
+     * Make the Documents for all the given lids, reading them together.
+     * @return the documents in the same order as the lids, NULL where there is no document.
+     **/
+    virtual std::vector<DocumentUP> read_batch(const LidVector & lids, const document::DocumentTypeRepo &repo) const;
     virtual void visit(const LidVector & lidVector, const document::DocumentTypeRepo &repo, IDocumentVisitor & visitor) const;
+    /**
+     * Reorder the lids to follow how the documents are laid out on disk, so that
+     * visiting them in consecutive slices approaches sequential read throughput.
+     * The default keeps the given order.
+     **/
+    virtual void sortLidsInStorageOrder(LidVector & lids) const;
 
     /**
      * Serialize and store a document.
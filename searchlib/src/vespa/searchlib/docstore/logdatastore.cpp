@@ -9,6 +9,7 @@
 #include <vespa/vespalib/util/benchmark_timer.h>
 #include <vespa/vespalib/util/cpu_usage.h>
 #include <vespa/vespalib/util/exceptions.h>
+#include <vespa/vespalib/util/io_scheduler.h>
 #include <vespa/vespalib/util/size_literals.h>
 #include <thread>
 #include <cassert>
@@ -24,6 +25,8 @@ namespace search {
 namespace {
     constexpr size_t DEFAULT_MAX_FILESIZE = 256_Mi;
     constexpr uint32_t DEFAULT_MAX_LIDS_PER_FILE = 1_Mi;
+    // zstd recommends training with about 100 times the dictionary size of samples.
+    constexpr size_t DICTIONARY_SAMPLE_FACTOR = 100;
 }
 
 using common::FileHeaderContext;
@@ -39,6 +42,7 @@ using vespalib::getErrorString;
 using vespalib::getLastErrorString;
 using vespalib::make_string;
 using vespalib::to_string;
+using vespalib::compression::ZStdDictionary;
 
 using CpuCategory = CpuUsage::Category;
 
@@ -47,6 +51,9 @@ LogDataStore::Config::Config()
       _maxBucketSpread(2.5),
       _minFileSizeFactor(0.2),
       _maxNumLids(DEFAULT_MAX_LIDS_PER_FILE),
+      _dictionarySize(0),
+      _compactStepBytes(4_Mi),
+      _maxCompactBytesPerSecond(0),
       _compactCompression(CompressionConfig::LZ4),
       _fileConfig()
 { }
@@ -56,6 +63,9 @@ LogDataStore::Config::operator == (const Config & rhs) const {
     return (_maxBucketSpread == rhs._maxBucketSpread) &&
             (_maxFileSize == rhs._maxFileSize) &&
             (_minFileSizeFactor == rhs._minFileSizeFactor) &&
+            (_dictionarySize == rhs._dictionarySize) &&
+            (_compactStepBytes == rhs._compactStepBytes) &&
+            (_maxCompactBytesPerSecond == rhs._maxCompactBytesPerSecond) &&
             (_compactCompression == rhs._compactCompression) &&
             (_fileConfig == rhs._fileConfig);
 }
@@ -74,13 +84,16 @@ LogDataStore::LogDataStore(vespalib::Executor &executor, const vespalib::string
       _holdFileChunks(),
       _active(0),
       _prevActive(FileId::active()),
+      _updateLock(),
+      _updateLockStats(vespalib::LockStats::get("searchlib.logdatastore.update")),
       _readOnly(readOnly),
       _executor(executor),
       _initFlushSyncToken(0),
       _tlSyncer(tlSyncer),
       _bucketizer(std::move(bucketizer)),
       _currentlyCompacting(),
-      _compactLidSpaceGeneration()
+      _compactLidSpaceGeneration(),
+      _dictionary()
 {
     // Reserve space for 1TB summary in order to avoid locking.
     // Even if we have reserved 16 bits for file id there is no chance that we will even get close to that.
@@ -101,7 +114,7 @@ void LogDataStore::reconfigure(const Config & config) {
 void
 LogDataStore::updateSerialNum()
 {
-    std::unique_lock guard(_updateLock);
+    auto guard = lockUpdate();
     if (getPrevActive(guard) != nullptr) {
         if (getActive(guard).getSerialNum() <
             getPrevActive(guard)->getLastPersistedSerialNum()) {
@@ -122,7 +135,7 @@ void
 LogDataStore::updateLidMap(uint32_t lastFileChunkDocIdLimit)
 {
     uint64_t lastSerialNum(0);
-    std::unique_lock guard(_updateLock);
+    auto guard = lockUpdate();
     for (size_t i = 0; i < _fileChunks.size(); ++i) {
         FileChunk::UP &chunk = _fileChunks[i];
         bool lastChunk = ((i + 1) == _fileChunks.size());
@@ -163,6 +176,26 @@ LogDataStore::read(const LidVector & lids, IBufferVisitor & visitor) const
     fc.read(orderedLids.begin() + start, orderedLids.size() - start, visitor);
 }
 
+void
+LogDataStore::sortLidsInStorageOrder(LidVector & lids) const
+{
+    LidInfoWithLidV orderedLids;
+    orderedLids.reserve(lids.size());
+    GenerationHandler::Guard guard(_genHandler.takeGuard());
+    for (uint32_t lid : lids) {
+        LidInfo li;
+        if (lid < getDocIdLimit()) {
+            li = vespalib::atomic::load_ref_acquire(_lidInfo.acquire_elem_ref(lid));
+        }
+        // Lids without data are given the invalid LidInfo and end up last.
+        orderedLids.emplace_back((!li.empty() && li.valid()) ? li : LidInfo(), lid);
+    }
+    std::stable_sort(orderedLids.begin(), orderedLids.end());
+    for (size_t i(0); i < orderedLids.size(); i++) {
+        lids[i] = orderedLids[i].getLid();
+    }
+}
+
 ssize_t
 LogDataStore::read(uint32_t lid, vespalib::DataBuffer& buffer) const
 {
@@ -185,7 +218,7 @@ LogDataStore::read(uint32_t lid, vespalib::DataBuffer& buffer) const
 void
 LogDataStore::write(uint64_t serialNum, uint32_t lid, const void * buffer, size_t len)
 {
-    std::unique_lock guard(_updateLock);
+    auto guard = lockUpdate();
     WriteableFileChunk & active = getActive(guard);
     write(std::move(guard), active, serialNum,  lid, {buffer, len}, CpuCategory::WRITE);
 }
@@ -241,7 +274,7 @@ LogDataStore::requireSpace(MonitorGuard guard, WriteableFileChunk & active, CpuU
 uint64_t
 LogDataStore::lastSyncToken() const
 {
-    MonitorGuard guard(_updateLock);
+    auto guard = lockUpdate();
     uint64_t lastSerial(getActive(guard).getLastPersistedSerialNum());
     if (lastSerial == 0) {
         const FileChunk * prev = getPrevActive(guard);
@@ -255,7 +288,7 @@ LogDataStore::lastSyncToken() const
 uint64_t
 LogDataStore::tentativeLastSyncToken() const
 {
-    MonitorGuard guard(_updateLock);
+    auto guard = lockUpdate();
     return getActive(guard).getSerialNum();
 }
 
@@ -265,7 +298,7 @@ LogDataStore::getLastFlushTime() const
     if (lastSyncToken() == 0) {
         return {};
     }
-    MonitorGuard guard(_updateLock);
+    auto guard = lockUpdate();
     vespalib::system_time timeStamp(getActive(guard).getModificationTime());
     if (timeStamp == vespalib::system_time()) {
         const FileChunk * prev = getPrevActive(guard);
@@ -280,7 +313,7 @@ LogDataStore::getLastFlushTime() const
 void
 LogDataStore::remove(uint64_t serialNum, uint32_t lid)
 {
-    MonitorGuard guard(_updateLock);
+    auto guard = lockUpdate();
     if (lid < getDocIdLimit()) {
         LidInfo lm = vespalib::atomic::load_ref_relaxed(_lidInfo[lid]);
         if (lm.valid()) {
@@ -317,7 +350,7 @@ LogDataStore::flush(uint64_t syncToken)
     std::unique_ptr<FileChunkHolder> activeHolder;
     assert(syncToken == _initFlushSyncToken);
     {
-        MonitorGuard guard(_updateLock);
+        auto guard = lockUpdate();
         // Note: Feed latency spike
         // This is executed by an IFlushTarget,
         // but is a fundamental part of the WRITE pipeline of the data store.
@@ -340,29 +373,49 @@ LogDataStore::initFlush(uint64_t syncToken)
     return syncToken;
 }
 
+double
+LogDataStore::compactionDebt(uint64_t diskFootprint, uint64_t diskBloat, double bucketSpread) noexcept
+{
+    if (diskFootprint == 0) {
+        return 0.0;
+    }
+    double bloat = std::min(double(diskBloat), double(diskFootprint));
+    // Visiting a bucket spread over N chunks reads N chunks where one would do,
+    // so (1 - 1/N) of the live data read is wasted, just like bloat wastes space.
+    double readAmplification = (bucketSpread > 1.0)
+        ? (double(diskFootprint) - bloat) * (1.0 - 1.0/bucketSpread)
+        : 0.0;
+    return (bloat + readAmplification) / diskFootprint;
+}
+
 std::pair<bool, LogDataStore::FileId>
 LogDataStore::findNextToCompact(bool dueToBloat)
 {
     using CostMap = std::multimap<double, FileId, std::greater<double>>;
     CostMap worst;
-    MonitorGuard guard(_updateLock);
+    auto guard = lockUpdate();
     for (size_t i(0); i < _fileChunks.size(); i++) {
         const auto & fc(_fileChunks[i]);
         if (fc && fc->frozen() && (_currentlyCompacting.find(fc->getNameId()) == _currentlyCompacting.end())) {
             uint64_t usage = fc->getDiskFootprint();
-            if ( ! dueToBloat && _bucketizer) {
-                worst.emplace(fc->getBucketSpread(), FileId(i));
-            } else if (dueToBloat && usage > 0) {
-                double tmp(double(fc->getDiskBloat())/usage);
-                worst.emplace(tmp, FileId(i));
+            if (usage == 0) {
+                continue;
+            }
+            uint64_t bloat = fc->getDiskBloat();
+            double spread = _bucketizer ? fc->getBucketSpread() : 1.0;
+            // Only consider files where compaction pays off the debt that triggered it
+            bool eligible = dueToBloat ? (bloat > 0) : (_bucketizer && (spread > 1.0));
+            if (eligible) {
+                worst.emplace(compactionDebt(usage, bloat, spread), FileId(i));
             }
         }
     }
     if (LOG_WOULD_LOG(debug)) {
         for (const auto & it : worst) {
             const FileChunk & fc = *_fileChunks[it.second.getId()];
-            LOG(debug, "File '%s' has bloat '%2.2f' and bucket-spread '%1.4f numChunks=%d , numBuckets=%ld, numUniqueBuckets=%ld",
-                       fc.getName().c_str(), it.first * 100, fc.getBucketSpread(), fc.getNumChunks(), fc.getNumBuckets(), fc.getNumUniqueBuckets());
+            LOG(debug, "File '%s' has compaction debt '%1.4f', bloat '%2.2f' and bucket-spread '%1.4f numChunks=%d , numBuckets=%ld, numUniqueBuckets=%ld",
+                       fc.getName().c_str(), it.first, 100*fc.getDiskBloat()/double(fc.getDiskFootprint()), fc.getBucketSpread(),
+                       fc.getNumChunks(), fc.getNumBuckets(), fc.getNumUniqueBuckets());
         }
     }
     std::pair<bool, FileId> retval(false, FileId(-1));
@@ -419,7 +472,7 @@ void LogDataStore::flushFileAndWait(MonitorGuard guard, WriteableFileChunk & fil
 }
 
 SerialNum LogDataStore::flushActive(SerialNum syncToken) {
-    MonitorGuard guard(_updateLock);
+    auto guard = lockUpdate();
     WriteableFileChunk &active = getActive(guard);
     // This is executed by an IFlushTarget (via initFlush),
     // but is a fundamental part of the WRITE pipeline of the data store.
@@ -427,7 +480,7 @@ SerialNum LogDataStore::flushActive(SerialNum syncToken) {
 }
 
 void LogDataStore::flushActiveAndWait(SerialNum syncToken) {
-    MonitorGuard guard(_updateLock);
+    auto guard = lockUpdate();
     WriteableFileChunk &active = getActive(guard);
     return flushFileAndWait(std::move(guard), active, syncToken);
 }
@@ -446,37 +499,42 @@ void LogDataStore::setNewFileChunk(const MonitorGuard & guard, FileChunk::UP fil
 
 void LogDataStore::compactFile(FileId fileId)
 {
+    vespalib::IoScheduler::MyClass my_io_class(vespalib::IoScheduler::Class::COMPACTION);
     FileChunk::UP & fc(_fileChunks[fileId.getId()]);
     NameId compactedNameId = fc->getNameId();
     LOG(info, "Compacting file '%s' which has bloat '%2.2f' and bucket-spread '%1.4f",
               fc->getName().c_str(), 100*fc->getDiskBloat()/double(fc->getDiskFootprint()), fc->getBucketSpread());
+    trainDictionary(*fc);
     std::unique_ptr<IWriteData> compacter;
+    docstore::CompactionPacer pacer(_config.getCompactStepBytes(), _config.getMaxCompactBytesPerSecond());
     FileId destinationFileId = FileId::active();
     if (_bucketizer) {
         size_t compacted_size;
         {
-            MonitorGuard guard(_updateLock);
+            auto guard = lockUpdate();
             size_t disk_footprint = fc->getDiskFootprint();
             size_t disk_bloat = fc->getDiskBloat();
             compacted_size = (disk_footprint <= disk_bloat) ? 0u : (disk_footprint - disk_bloat);
         }
         if ( ! shouldCompactToActiveFile(compacted_size)) {
-            MonitorGuard guard(_updateLock);
+            auto guard = lockUpdate();
             destinationFileId = allocateFileId(guard);
             setNewFileChunk(guard, createWritableFile(destinationFileId, fc->getLastPersistedSerialNum(), fc->getNameId().next()));
         }
         size_t numSignificantBucketBits = computeNumberOfSignificantBucketIdBits(*_bucketizer, fc->getFileId());
         compacter = std::make_unique<BucketCompacter>(numSignificantBucketBits, _config.compactCompression(), *this,
-                                                      _executor, *_bucketizer, fc->getFileId(), destinationFileId);
+                                                      _executor, *_bucketizer, fc->getFileId(), destinationFileId, pacer);
     } else {
-        compacter = std::make_unique<docstore::Compacter>(*this);
+        compacter = std::make_unique<docstore::Compacter>(*this, pacer);
     }
 
     fc->appendTo(_executor, *this, *compacter, fc->getNumChunks(), nullptr, CpuCategory::COMPACT);
+    LOG(debug, "Compaction of file '%s' wrote %ld bytes in %ld steps",
+               fc->getName().c_str(), pacer.getBytesWritten(), pacer.getNumSteps());
 
     flushActiveAndWait(0);
     if (!destinationFileId.isActive()) {
-        MonitorGuard guard(_updateLock);
+        auto guard = lockUpdate();
         auto & compactTo = dynamic_cast<WriteableFileChunk &>(*_fileChunks[destinationFileId.getId()]);
         flushFileAndWait(std::move(guard), compactTo, 0);
         compactTo.freeze(CpuCategory::COMPACT);
@@ -486,14 +544,14 @@ void LogDataStore::compactFile(FileId fileId)
     std::this_thread::sleep_for(1s);
     uint64_t currentGeneration;
     {
-        MonitorGuard guard(_updateLock);
+        auto guard = lockUpdate();
         currentGeneration = _genHandler.getCurrentGeneration();
         _genHandler.incGeneration();
     }
     
     FileChunk::UP toDie;
     for (;;) {
-        MonitorGuard guard(_updateLock);
+        auto guard = lockUpdate();
         _genHandler.update_oldest_used_generation();
         if (currentGeneration < _genHandler.get_oldest_used_generation()) {
             if (canFileChunkBeDropped(guard, fc->getFileId())) {
@@ -509,16 +567,38 @@ void LogDataStore::compactFile(FileId fileId)
         std::this_thread::sleep_for(1s);
     }
     toDie->erase();
-    MonitorGuard guard(_updateLock);
+    auto guard = lockUpdate();
     _currentlyCompacting.erase(compactedNameId);
 }
 
+void
+LogDataStore::trainDictionary(const FileChunk & fileChunk)
+{
+    size_t dictionarySize = _config.getDictionarySize();
+    if (dictionarySize == 0) {
+        return;
+    }
+    ZStdDictionary::Samples samples(dictionarySize * DICTIONARY_SAMPLE_FACTOR);
+    fileChunk.sample(samples);
+    int compressionLevel = _config.getFileConfig().getCompression().compressionLevel;
+    auto dictionary = ZStdDictionary::train(samples, dictionarySize, compressionLevel);
+    if ( ! dictionary) {
+        LOG(info, "Could not train dictionary from %zu samples (%zu bytes) in file '%s'",
+                  samples.count(), samples.bytes(), fileChunk.getName().c_str());
+        return;
+    }
+    LOG(info, "Trained dictionary %u of %zu bytes from %zu samples (%zu bytes) in file '%s'",
+              dictionary->id(), dictionary->content().size(), samples.count(), samples.bytes(), fileChunk.getName().c_str());
+    auto guard = lockUpdate();
+    _dictionary = std::move(dictionary);
+}
+
 size_t
 LogDataStore::memoryUsed() const
 {
     size_t sz(memoryMeta());
     {
-        MonitorGuard guard(_updateLock);
+        auto guard = lockUpdate();
         for (const auto & fc : _fileChunks) {
             if (fc) {
                 sz += fc->getMemoryFootprint();
@@ -531,7 +611,7 @@ LogDataStore::memoryUsed() const
 size_t
 LogDataStore::memoryMeta() const
 {
-    MonitorGuard guard(_updateLock);
+    auto guard = lockUpdate();
     size_t sz(_lidInfo.getMemoryUsage().allocatedBytes());
     for (const auto & fc : _fileChunks) {
         if (fc) {
@@ -561,7 +641,7 @@ LogDataStore::allocateFileId(const MonitorGuard & guard)
 size_t
 LogDataStore::getDiskFootprint() const
 {
-    MonitorGuard guard(_updateLock);
+    auto guard = lockUpdate();
     size_t sz(0);
     for (const auto & fc : _fileChunks) {
         if (fc) {
@@ -575,7 +655,7 @@ LogDataStore::getDiskFootprint() const
 size_t
 LogDataStore::getDiskHeaderFootprint() const
 {
-    MonitorGuard guard(_updateLock);
+    auto guard = lockUpdate();
     size_t sz(0);
     for (const auto & fc : _fileChunks) {
         if (fc) {
@@ -589,7 +669,7 @@ double
 LogDataStore::getMaxBucketSpread() const
 {
     double maxSpread(1.0);
-    MonitorGuard guard(_updateLock);
+    auto guard = lockUpdate();
     for (FileId i(0); i < FileId(_fileChunks.size()); i = i.next()) {
         /// Ignore the the active file as it is never considered for reordering until completed and frozen.
         if (i != _active) {
@@ -605,7 +685,7 @@ LogDataStore::getMaxBucketSpread() const
 size_t
 LogDataStore::getDiskBloat() const
 {
-    MonitorGuard guard(_updateLock);
+    auto guard = lockUpdate();
     size_t sz(0);
     for (FileId i(0); i < FileId(_fileChunks.size()); i = i.next()) {
         /// Do not count the holes in the last file as bloat as it is
@@ -656,6 +736,9 @@ LogDataStore::createWritableFile(FileId fileId, SerialNum serialNum, NameId name
     auto file = std::make_unique< WriteableFileChunk>(_executor, fileId, nameId, getBaseDir(), serialNum,docIdLimit,
                                                       _config.getFileConfig(), _tune, _fileHeaderContext,
                                                       _bucketizer.get());
+    if (_dictionary && (_config.getDictionarySize() > 0)) {
+        file->setDictionary(_dictionary);
+    }
     file->enableRead();
     return file;
 }
@@ -781,6 +864,9 @@ LogDataStore::preload()
     }
     _active = FileId(_fileChunks.size() - 1);
     _prevActive = _active.prev();
+    for (auto it(_fileChunks.rbegin()); (it != _fileChunks.rend()) && !_dictionary; ++it) {
+        _dictionary = (*it)->getDictionary();
+    }
 }
 
 uint32_t
@@ -830,7 +916,7 @@ LogDataStore::findIncompleteCompactedFiles(const NameIdSet & partList) {
 LogDataStore::NameIdSet
 LogDataStore::getAllActiveFiles() const {
     NameIdSet files;
-    MonitorGuard guard(_updateLock);
+    auto guard = lockUpdate();
     for (const auto & fc : _fileChunks) {
         if (fc) {
             files.insert(fc->getNameId());
@@ -983,7 +1069,7 @@ LogDataStore::computeNumberOfSignificantBucketIdBits(const IBucketizer & bucketi
 void
 LogDataStore::verify(bool reportOnly) const
 {
-    MonitorGuard guard(_updateLock);
+    auto guard = lockUpdate();
     for (const auto & fc : _fileChunks) {
         if (fc) {
             fc->verify(reportOnly);
@@ -1077,7 +1163,7 @@ LogDataStore::accept(IDataStoreVisitor &visitor,
             internalFlushAll();
             FileChunk::UP toDie;
             {
-                MonitorGuard guard(_updateLock);
+                auto guard = lockUpdate();
                 toDie = std::move(_fileChunks[fcId.getId()]);
             }
             toDie->erase();
@@ -1093,7 +1179,7 @@ double
 LogDataStore::getVisitCost() const
 {
     uint32_t totalChunks = 0;
-    MonitorGuard guard(_updateLock);
+    auto guard = lockUpdate();
     for (const auto &fc : _fileChunks) {
         if (fc) {
             totalChunks += fc->getNumChunks();
@@ -1129,7 +1215,7 @@ LogDataStore::holdFileChunk(const MonitorGuard & guard, FileId fileId)
 void
 LogDataStore::unholdFileChunk(FileId fileId)
 {
-    MonitorGuard guard(_updateLock);
+    auto guard = lockUpdate();
     auto found = _holdFileChunks.find(fileId.getId());
     assert(found != _holdFileChunks.end());
     assert(found->second > 0u);
@@ -1161,7 +1247,7 @@ LogDataStore::getStorageStats() const
 vespalib::MemoryUsage
 LogDataStore::getMemoryUsage() const
 {
-    MonitorGuard guard(_updateLock);
+    auto guard = lockUpdate();
     vespalib::MemoryUsage result;
     result.merge(_lidInfo.getMemoryUsage());
     for (const auto &fileChunk : _fileChunks) {
@@ -1185,7 +1271,7 @@ LogDataStore::getFileChunkStats() const
 {
     std::vector<DataStoreFileChunkStats> result;
     {
-        MonitorGuard guard(_updateLock);
+        auto guard = lockUpdate();
         for (const auto & fc : _fileChunks) {
             if (fc) {
                 result.push_back(fc->getStats());
@@ -1199,7 +1285,7 @@ LogDataStore::getFileChunkStats() const
 void
 LogDataStore::compactLidSpace(uint32_t wantedDocLidLimit)
 {
-    MonitorGuard guard(_updateLock);
+    auto guard = lockUpdate();
     assert(wantedDocLidLimit <= getDocIdLimit());
     for (size_t i = wantedDocLidLimit; i < _lidInfo.size(); ++i) {
         vespalib::atomic::store_ref_release(_lidInfo[i], LidInfo());
@@ -1212,7 +1298,7 @@ LogDataStore::compactLidSpace(uint32_t wantedDocLidLimit)
 bool
 LogDataStore::canShrinkLidSpace() const
 {
-    MonitorGuard guard(_updateLock);
+    auto guard = lockUpdate();
     return canShrinkLidSpace(guard);
 }
 
@@ -1227,7 +1313,7 @@ LogDataStore::canShrinkLidSpace(const MonitorGuard &) const
 size_t
 LogDataStore::getEstimatedShrinkLidSpaceGain() const
 {
-    MonitorGuard guard(_updateLock);
+    auto guard = lockUpdate();
     if (!canShrinkLidSpace(guard)) {
         return 0;
     }
@@ -1238,7 +1324,7 @@ LogDataStore::getEstimatedShrinkLidSpaceGain() const
 void
 LogDataStore::shrinkLidSpace()
 {
-    MonitorGuard guard(_updateLock);
+    auto guard = lockUpdate();
     if (!canShrinkLidSpace(guard)) {
         return;
     }
@@ -13,6 +13,7 @@
 #include <vespa/vespalib/util/compressionconfig.h>
 #include <vespa/vespalib/util/cpu_usage.h>
 #include <vespa/vespalib/util/executor.h>
+#include <vespa/vespalib/util/lock_stats.h>
 #include <vespa/vespalib/util/rcuvector.h>
 
 #include <set>
@@ -48,6 +49,13 @@ public:
         Config & setMaxNumLids(size_t v) { _maxNumLids = v; return *this; }
         Config & setMaxBucketSpread(double v) noexcept { _maxBucketSpread.store_relaxed(v); return *this; }
         Config & setMinFileSizeFactor(double v) { _minFileSizeFactor = v; return *this; }
+        // Max size of the dictionary trained when compacting, 0 disables dictionary compression.
+        Config & setDictionarySize(size_t v) { _dictionarySize = v; return *this; }
+
+        // Compaction writes are paced in steps of this many bytes.
+        Config & setCompactStepBytes(size_t v) { _compactStepBytes = v; return *this; }
+        // Max write rate of a single compaction, 0 means unlimited.
+        Config & setMaxCompactBytesPerSecond(size_t v) { _maxCompactBytesPerSecond = v; return *this; }
 
         Config & compactCompression(CompressionConfig v) { _compactCompression = v; return *this; }
         Config & setFileConfig(WriteableFileChunk::Config v) { _fileConfig = v; return *this; }
@@ -56,6 +64,9 @@ public:
         double getMaxBucketSpread() const noexcept { return _maxBucketSpread.load_relaxed(); }
         double getMinFileSizeFactor() const { return _minFileSizeFactor; }
         uint32_t getMaxNumLids() const { return _maxNumLids; }
+        size_t getDictionarySize() const { return _dictionarySize; }
+        size_t getCompactStepBytes() const { return _compactStepBytes; }
+        size_t getMaxCompactBytesPerSecond() const { return _maxCompactBytesPerSecond; }
 
         CompressionConfig compactCompression() const { return _compactCompression; }
 
@@ -67,6 +78,9 @@ public:
         AtomicValueWrapper<double>  _maxBucketSpread;
         double                      _minFileSizeFactor;
         uint32_t                    _maxNumLids;
+        size_t                      _dictionarySize;
+        size_t                      _compactStepBytes;
+        size_t                      _maxCompactBytesPerSecond;
         CompressionConfig           _compactCompression;
         WriteableFileChunk::Config  _fileConfig;
     };
@@ -97,6 +111,7 @@ public:
     // Implements IDataStore API
     ssize_t read(uint32_t lid, vespalib::DataBuffer & buffer) const override;
     void read(const LidVector & lids, IBufferVisitor & visitor) const override;
+    void sortLidsInStorageOrder(LidVector & lids) const override;
     void write(uint64_t serialNum, uint32_t lid, const void * buffer, size_t len) override;
     void remove(uint64_t serialNum, uint32_t lid) override;
     void flush(uint64_t syncToken) override;
@@ -111,6 +126,13 @@ public:
     size_t getDiskBloat() const override;
     size_t getMaxSpreadAsBloat() const override;
 
+    /**
+     * The fraction of a file that is wasted, counting both space lost to
+     * bloat and reads lost to bucket spread. Files are compacted in order
+     * of decreasing debt, whichever of the two triggered the compaction.
+     */
+    static double compactionDebt(uint64_t diskFootprint, uint64_t diskBloat, double bucketSpread) noexcept;
+
     void compactBloat(uint64_t syncToken) { compactWorst(syncToken, true); }
     void compactSpread(uint64_t syncToken) { compactWorst(syncToken, false);}
 
@@ -147,7 +169,7 @@ public:
     // Implements IGetLid API
     IGetLid::unique_lock getLidGuard(uint32_t lid) const override {
         (void) lid;
-        return IGetLid::unique_lock(_updateLock);
+        return lockUpdate();
     }
 
     // Implements IGetLid API
@@ -160,6 +182,7 @@ public:
         }
     }
     FileId getActiveFileId(const MonitorGuard & guard) const;
+    MonitorGuard lockUpdate() const { return _updateLockStats.lock(_updateLock); }
     bool hasUpdateLock(const MonitorGuard & guard) const {
         return (guard.mutex() == &_updateLock) && guard.owns_lock();
     }
@@ -186,6 +209,7 @@ private:
 
     void compactWorst(uint64_t syncToken, bool compactDiskBloat);
     void compactFile(FileId chunkId);
+    void trainDictionary(const FileChunk & fileChunk);
 
     using LidInfoVector = vespalib::RcuVector<uint64_t>;
     using FileChunkVector = std::vector<FileChunk::UP>;
@@ -256,6 +280,7 @@ private:
     FileId                                   _active;
     FileId                                   _prevActive;
     mutable std::mutex                       _updateLock;
+    vespalib::LockStats                     &_updateLockStats;
     bool                                     _readOnly;
     vespalib::Executor                      &_executor;
     SerialNum                                _initFlushSyncToken;
@@ -263,6 +288,8 @@ private:
     IBucketizer::SP                          _bucketizer;
     NameIdSet                                _currentlyCompacting;
     uint64_t                                 _compactLidSpaceGeneration;
+    // Dictionary used by new files, retrained when compacting. Protected by _updateLock.
+    std::shared_ptr<const FileChunk::ZStdDictionary> _dictionary;
 };
 
 } // namespace search
@@ -5,6 +5,7 @@
 #include <cstddef>
 #include <cstdint>
 #include <memory>
+#include <vector>
 
 class FastOS_FileInterface;
 
@@ -17,7 +18,25 @@ class FileRandRead
 public:
     using FSP = std::shared_ptr<FastOS_FileInterface>;
     virtual ~FileRandRead() = default;
+    /**
+     * A single read in a batch. The buffer is filled as by read() and
+     * keepAlive is what read() would have returned for it.
+     */
+    struct Request {
+        size_t                 offset;
+        size_t                 size;
+        vespalib::DataBuffer * buffer;
+        FSP                    keepAlive;
+        Request(size_t offset_in, size_t size_in, vespalib::DataBuffer & buffer_in) noexcept
+            : offset(offset_in), size(size_in), buffer(&buffer_in), keepAlive()
+        {}
+    };
     virtual FSP read(size_t offset, vespalib::DataBuffer & buffer, size_t sz) = 0;
+    /**
+     * Perform all the given reads, allowing them to be in flight at the same time.
+     * The default performs them one by one.
+     */
+    virtual void readBatch(std::vector<Request> & requests);
     virtual int64_t getSize() const = 0;
 };
 
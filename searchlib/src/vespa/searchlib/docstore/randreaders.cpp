@@ -3,6 +3,7 @@
 #include "randreaders.h"
 #include "summaryexceptions.h"
 #include <vespa/vespalib/data/databuffer.h>
+#include <vespa/vespalib/io/batch_pread.h>
 #include <vespa/fastos/file.h>
 
 #include <vespa/log/log.h>
@@ -10,14 +11,36 @@ LOG_SETUP(".search.docstore.randreaders");
 
 namespace search {
 
+using vespalib::BatchPread;
+
+namespace {
+
+int
+getFileDescriptor(const FastOS_FileInterface & file)
+{
+    return static_cast<const FastOS_File &>(file).getFileDescriptor();
+}
+
+}
+
+void
+FileRandRead::readBatch(std::vector<Request> & requests)
+{
+    for (Request & request : requests) {
+        request.keepAlive = read(request.offset, *request.buffer, request.size);
+    }
+}
+
 DirectIORandRead::DirectIORandRead(const vespalib::string & fileName)
     : _file(std::make_unique<FastOS_File>(fileName.c_str())),
+      _fd(-1),
       _alignment(1),
       _granularity(1),
       _maxChunkSize(0x100000)
 {
     _file->EnableDirectIO();
     if (_file->OpenReadOnly()) {
+        _fd = getFileDescriptor(*_file);
         if (!_file->GetDirectIORestrictions(_alignment, _granularity, _maxChunkSize)) {
             LOG(debug, "Direct IO setup failed for file %s due to %s",
                        _file->GetFileName(), _file->getLastErrorString().c_str());
@@ -47,6 +70,41 @@ DirectIORandRead::read(size_t offset, vespalib::DataBuffer & buffer, size_t sz)
     return FSP();
 }
 
+void
+DirectIORandRead::readBatch(std::vector<Request> & requests)
+{
+    std::vector<BatchPread::Request> reads;
+    std::vector<std::pair<size_t, size_t>> padding;
+    reads.reserve(requests.size());
+    padding.reserve(requests.size());
+    for (const Request & request : requests) {
+        size_t padBefore(0);
+        size_t padAfter(0);
+        bool directio = _file->DirectIOPadding(request.offset, request.size, padBefore, padAfter);
+        vespalib::DataBuffer & buffer = *request.buffer;
+        buffer.clear();
+        buffer.ensureFree(padBefore + request.size + padAfter + _alignment - 1);
+        if (directio) {
+            size_t unAligned = (-reinterpret_cast<size_t>(buffer.getFree()) & (_alignment - 1));
+            buffer.moveFreeToData(unAligned);
+            buffer.moveDataToDead(unAligned);
+        }
+        reads.emplace_back(_fd, buffer.getFree(), padBefore + request.size + padAfter, request.offset - padBefore);
+        padding.emplace_back(padBefore, padAfter);
+    }
+    BatchPread::read(reads);
+    for (size_t i(0); i < requests.size(); i++) {
+        const BatchPread::Request & done = reads[i];
+        if ((done.result < 0) || (size_t(done.result) != done.len)) {
+            // Let the file handle unaligned end of file and report errors.
+            _file->ReadBuf(done.buf, done.len, done.offset);
+        }
+        vespalib::DataBuffer & buffer = *requests[i].buffer;
+        buffer.moveFreeToData(padding[i].first + requests[i].size);
+        buffer.moveDataToDead(padding[i].first);
+    }
+}
+
 
 int64_t
 DirectIORandRead::getSize() const {
@@ -66,11 +124,13 @@ MMapRandRead::MMapRandRead(const vespalib::string & fileName, int mmapFlags, int
 
 
 NormalRandRead::NormalRandRead(const vespalib::string & fileName)
-    : _file(std::make_unique<FastOS_File>(fileName.c_str()))
+    : _file(std::make_unique<FastOS_File>(fileName.c_str())),
+      _fd(-1)
 {
     if ( ! _file->OpenReadOnly()) {
         throw SummaryException("Failed opening data file", *_file, VESPA_STRLOC);
     }
+    _fd = getFileDescriptor(*_file);
 }
 
 FileRandRead::FSP
@@ -160,6 +220,28 @@ NormalRandRead::read(size_t offset, vespalib::DataBuffer & buffer, size_t sz)
     return FSP();
 }
 
+void
+NormalRandRead::readBatch(std::vector<Request> & requests)
+{
+    std::vector<BatchPread::Request> reads;
+    reads.reserve(requests.size());
+    for (const Request & request : requests) {
+        vespalib::DataBuffer & buffer = *request.buffer;
+        buffer.clear();
+        buffer.ensureFree(request.size);
+        reads.emplace_back(_fd, buffer.getFree(), request.size, request.offset);
+    }
+    BatchPread::read(reads);
+    for (size_t i(0); i < requests.size(); i++) {
+        const BatchPread::Request & done = reads[i];
+        if ((done.result < 0) || (size_t(done.result) != done.len)) {
+            // Retry to get the same error as a single read.
+            _file->ReadBuf(done.buf, done.len, done.offset);
+        }
+        requests[i].buffer->moveFreeToData(requests[i].size);
+    }
+}
+
 int64_t
 NormalRandRead::getSize() const
 {
@@ -15,9 +15,11 @@ class DirectIORandRead : public FileRandRead
 public:
     DirectIORandRead(const vespalib::string & fileName);
     FSP read(size_t offset, vespalib::DataBuffer & buffer, size_t sz) override;
+    void readBatch(std::vector<Request> & requests) override;
     int64_t getSize() const override;
 private:
     std::unique_ptr<FastOS_FileInterface>  _file;
+    int                                    _fd;
     size_t                                 _alignment;
     size_t                                 _granularity;
     size_t                                 _maxChunkSize;
@@ -55,9 +57,11 @@ class NormalRandRead : public FileRandRead
 public:
     NormalRandRead(const vespalib::string & fileName);
     FSP read(size_t offset, vespalib::DataBuffer & buffer, size_t sz) override;
+    void readBatch(std::vector<Request> & requests) override;
     int64_t getSize() const override;
 private:
     std::unique_ptr<FastOS_FileInterface>  _file;
+    int                                    _fd;
 };
 
 }
@@ -11,6 +11,8 @@
 #include <vespa/vespalib/stllike/hash_map.hpp>
 #include <vespa/vespalib/util/cpu_usage.h>
 #include <vespa/vespalib/util/lambdatask.h>
+#include <vespa/vespalib/util/zstd_dictionary.h>
+#include <filesystem>
 
 #include <vespa/log/log.h>
 LOG_SETUP(".search.writeablefilechunk");
@@ -110,6 +112,9 @@ WriteableFileChunk(vespalib::Executor &executor,
       _bucketMap(bucketizer)
 {
     _docIdLimit = docIdLimit;
+    if (_dictionary && !_dictionary->canCompress()) {
+        _dictionary = std::make_shared<const ZStdDictionary>(_dictionary->content(), config.getCompression().compressionLevel);
+    }
     if (tune._write.getWantDirectIO()) {
         _dataFile.EnableDirectIO();
     }
@@ -250,11 +255,14 @@ WriteableFileChunk::read(LidInfoWithLidV::const_iterator begin, size_t count, IB
             visitor.visit(entry._lid, vespalib::ConstBufferRef(entry._buf.get(), entry._size));
             entry._buf = vespalib::alloc::Alloc();
         }
+        std::vector<ChunkLids> chunks;
+        chunks.reserve(chunksOnFile.size());
         for (auto & it : chunksOnFile) {
             auto first = find_first(begin, it.first);
             auto last = seek_past(first, begin + count, it.first);
-            FileChunk::read(first, last - first, it.second, visitor);
+            chunks.emplace_back(first, last - first, it.second);
         }
+        FileChunk::read(chunks, visitor);
     } else {
         FileChunk::read(begin, count, visitor);
     }
@@ -295,7 +303,7 @@ WriteableFileChunk::internalFlush(uint32_t chunkId, uint64_t serialNum, CpuUsage
     if (_alignment > 1) {
         tmp->getBuf().ensureFree(active->getMaxPackSize(_config.getCompression()) + _alignment - 1);
     }
-    active->pack(serialNum, tmp->getBuf(), _config.getCompression());
+    active->pack(serialNum, tmp->getBuf(), _config.getCompression(), _dictionary.get());
     tmp->setPayLoad();
     if (_alignment > 1) {
         const size_t padAfter((_alignment - tmp->getPayLoad() % _alignment) % _alignment);
@@ -563,6 +571,33 @@ WriteableFileChunk::getModificationTime() const
     return _modificationTime;
 }
 
+void
+WriteableFileChunk::setDictionary(std::shared_ptr<const ZStdDictionary> dictionary)
+{
+    if (_dictionary || !dictionary) {
+        return;
+    }
+    int compressionLevel = _config.getCompression().compressionLevel;
+    if ( ! dictionary->canCompress() || (dictionary->compressionLevel() != compressionLevel)) {
+        dictionary = std::make_shared<const ZStdDictionary>(dictionary->content(), compressionLevel);
+    }
+    vespalib::string fileName(createDictFileName(getName()));
+    vespalib::string tmpFileName(fileName + ".tmp");
+    {
+        FastOS_File file(tmpFileName.c_str());
+        if ( ! file.OpenWriteOnlyTruncate()) {
+            throw SummaryException("Failed opening dictionary file", file, VESPA_STRLOC);
+        }
+        auto content = dictionary->content();
+        if ( ! file.CheckedWrite(content.c_str(), content.size()) || ! file.Sync() || ! file.Close()) {
+            throw SummaryException("Failed writing dictionary file", file, VESPA_STRLOC);
+        }
+    }
+    std::filesystem::rename(std::filesystem::path(tmpFileName), std::filesystem::path(fileName));
+    LOG(info, "Using dictionary %u of %zu bytes for chunks in '%s'", dictionary->id(), dictionary->content().size(), _dataFileName.c_str());
+    _dictionary = std::move(dictionary);
+}
+
 void
 WriteableFileChunk::freeze(CpuUsage::Category cpu_category)
 {
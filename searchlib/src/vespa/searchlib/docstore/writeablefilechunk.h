@@ -69,6 +69,13 @@ public:
     void flushPendingChunks(uint64_t serialNum);
     DataStoreFileChunkStats getStats() const override;
 
+    /**
+     * Use the given dictionary for all chunks written from now on, unless
+     * the file already has one. The dictionary is written to the '.dict'
+     * file before it is used. Must be called before the file is shared.
+     */
+    void setDictionary(std::shared_ptr<const ZStdDictionary> dictionary);
+
     static uint64_t writeIdxHeader(const common::FileHeaderContext &fileHeaderContext, uint32_t docIdLimit, FastOS_FileInterface &file);
 private:
     using ProcessedChunkUP = std::unique_ptr<ProcessedChunk>;
@@ -0,0 +1,62 @@
+// Copyright Vespa.ai. Licensed under the terms of the Apache 2.0 license. See LICENSE in the project root.
+
+#include "adaptive_compression.h"
+#include <algorithm>
+
+namespace search::engine {
+
+namespace {
+
+using CompressionConfig = AdaptiveCompression::CompressionConfig;
+
+CompressionConfig with_type(const CompressionConfig &base, CompressionConfig::Type type, uint8_t level) {
+    return CompressionConfig(type, level, base.threshold, base.minSize);
+}
+
+}
+
+AdaptiveCompression::AdaptiveCompression() noexcept
+    : _ratio_permille(0),
+      _skipped(0)
+{
+}
+
+AdaptiveCompression::CompressionConfig
+AdaptiveCompression::select(const CompressionConfig &base, uint32_t rtt_us, size_t size) noexcept
+{
+    if (!base.useCompression() || (size < base.minSize)) {
+        return base;
+    }
+    if (ratio_permille() >= poor_ratio_permille) {
+        uint32_t skipped = _skipped.fetch_add(1, std::memory_order_relaxed) + 1;
+        if ((skipped % probe_interval) != 0) {
+            return with_type(base, CompressionConfig::NONE, 0);
+        }
+    }
+    if (rtt_us == 0) {
+        return base;
+    }
+    if (rtt_us < near_rtt_us) {
+        if (size < near_min_size) {
+            return with_type(base, CompressionConfig::NONE, 0);
+        }
+        return with_type(base, CompressionConfig::LZ4, 0);
+    }
+    if (rtt_us >= far_rtt_us) {
+        return with_type(base, CompressionConfig::ZSTD, far_zstd_level);
+    }
+    return base;
+}
+
+void
+AdaptiveCompression::report(size_t size, size_t compressed_size) noexcept
+{
+    if (size == 0) {
+        return;
+    }
+    uint32_t sample = std::min(size_t(1000), (compressed_size * 1000) / size);
+    uint32_t old_ratio = _ratio_permille.load(std::memory_order_relaxed);
+    _ratio_permille.store((old_ratio * 7 + sample) / 8, std::memory_order_relaxed);
+}
+
+}
@@ -0,0 +1,63 @@
+// Copyright Vespa.ai. Licensed under the terms of the Apache 2.0 license. See LICENSE in the project root.
+
+#pragma once
+
+#include <vespa/vespalib/util/compressionconfig.h>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+
+namespace search::engine {
+
+/**
+ * Selects how to compress a single rpc reply based on the link it is
+ * about to be sent over and on how well earlier replies compressed.
+ *
+ * Links with a short round-trip time (same rack) are assumed to have
+ * plenty of bandwidth; only large payloads are compressed, using the
+ * fastest codec. Links with a long round-trip time (other data
+ * center) are assumed to be bandwidth constrained; payloads are
+ * compressed harder. Everything in between uses the configured
+ * compression. If recent payloads did not compress well, compression
+ * is skipped for most payloads until a probe shows otherwise.
+ *
+ * Instances are shared between worker threads; all state is relaxed
+ * atomics since an occasional lost update only affects a heuristic.
+ **/
+class AdaptiveCompression
+{
+public:
+    using CompressionConfig = vespalib::compression::CompressionConfig;
+
+    static constexpr uint32_t near_rtt_us = 1000;
+    static constexpr uint32_t far_rtt_us = 10000;
+    static constexpr size_t near_min_size = 64 * 1024;
+    static constexpr uint8_t far_zstd_level = 3;
+    static constexpr uint32_t poor_ratio_permille = 900;
+    static constexpr uint32_t probe_interval = 16;
+
+private:
+    std::atomic<uint32_t> _ratio_permille; // running average of compressed/uncompressed size
+    std::atomic<uint32_t> _skipped;
+
+public:
+    AdaptiveCompression() noexcept;
+
+    /**
+     * @param base the configured compression
+     * @param rtt_us round-trip time of the link, 0 if unknown
+     * @param size uncompressed payload size
+     **/
+    CompressionConfig select(const CompressionConfig &base, uint32_t rtt_us, size_t size) noexcept;
+
+    /**
+     * Report the outcome of compressing a payload with a config
+     * returned by select (compressed_size equals size when the
+     * payload was sent uncompressed because it did not shrink).
+     **/
+    void report(size_t size, size_t compressed_size) noexcept;
+
+    uint32_t ratio_permille() const noexcept { return _ratio_permille.load(std::memory_order_relaxed); }
+};
+
+}
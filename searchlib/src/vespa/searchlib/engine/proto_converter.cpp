@@ -68,6 +68,44 @@ void add_multi_props(fef::Properties &dst, const T &src) {
     }
 }
 
+// Send match features as one column per feature, which is only
+// possible when all values of each feature are of the same kind.
+bool
+add_match_feature_columns(const vespalib::FeatureValues &features, size_t num_hits,
+                          ProtoConverter::ProtoSearchReply &proto)
+{
+    size_t num_features = features.names.size();
+    std::vector<bool> is_tensor(num_features, false);
+    for (size_t j = 0; j < num_features; ++j) {
+        size_t num_tensors = 0;
+        for (size_t i = 0; i < num_hits; ++i) {
+            if (features.values[i * num_features + j].is_data()) {
+                ++num_tensors;
+            }
+        }
+        if ((num_tensors > 0) && (num_tensors < num_hits)) {
+            return false;
+        }
+        is_tensor[j] = (num_tensors > 0);
+    }
+    for (size_t j = 0; j < num_features; ++j) {
+        auto *column = proto.add_match_feature_columns();
+        if (is_tensor[j]) {
+            column->mutable_tensors()->Reserve(num_hits);
+            for (size_t i = 0; i < num_hits; ++i) {
+                auto mem = features.values[i * num_features + j].as_data();
+                column->add_tensors(mem.data, mem.size);
+            }
+        } else {
+            column->mutable_numbers()->Reserve(num_hits);
+            for (size_t i = 0; i < num_hits; ++i) {
+                column->add_numbers(features.values[i * num_features + j].as_double());
+            }
+        }
+    }
+    return true;
+}
+
 DocsumRequest::FieldList
 convertFields(const searchlib::searchprotocol::protobuf::DocsumRequest &proto) {
     DocsumRequest::FieldList fields;
@@ -103,6 +141,7 @@ ProtoConverter::search_request_from_proto(const ProtoSearchRequest &proto, Searc
         request.trace().second_phase_profile_depth(value);
     }
     request.sortSpec = make_sort_spec(proto.sorting());
+    request.columnar_match_features = proto.columnar_match_features();
     request.sessionId.assign(proto.session_key().begin(), proto.session_key().end());
     request.propertiesMap.lookupCreate(MapNames::MATCH).add("documentdb.searchdoctype", proto.document_type());
     if (proto.cache_grouping()) {
@@ -164,8 +203,10 @@ ProtoConverter::search_reply_to_proto(const SearchReply &reply, ProtoSearchReply
         for (const auto & name : reply.match_features.names) {
             proto.add_match_feature_names()->assign(name.data(), name.size());
         }
+        bool columnar = (reply.request && reply.request->columnar_match_features &&
+                         add_match_feature_columns(reply.match_features, reply.hits.size(), proto));
         auto mfv_iter = reply.match_features.values.begin();
-        for (size_t i = 0; i < reply.hits.size(); ++i) {
+        for (size_t i = 0; !columnar && (i < reply.hits.size()); ++i) {
             auto *hit = proto.mutable_hits(i);
             for (size_t j = 0; j < num_match_features; ++j) {
                 auto * obj = hit->add_match_features();
@@ -4,6 +4,7 @@
 #include "searchapi.h"
 #include "docsumapi.h"
 #include "monitorapi.h"
+#include <vespa/fnet/connection.h>
 #include <vespa/fnet/frt/require_capabilities.h>
 #include <vespa/fnet/frt/rpcrequest.h>
 #include <vespa/fnet/frt/supervisor.h>
@@ -36,32 +37,55 @@ CompressionConfig get_compression_config() {
     return CompressionConfig(streamer.getCompressionType(), streamer.getCompressionLevel(), 80, streamer.getCompressionLimit());
 }
 
-template <typename MSG>
-void encode_message(const MSG &src, FRT_Values &dst) {
+bool use_adaptive_compression() {
+    using search::fs4transport::FS4PersistentPacketStreamer;
+    return FS4PersistentPacketStreamer::Instance.getAdaptiveCompression();
+}
+
+uint32_t get_rtt_us(FRT_RPCRequest &req) {
+    FNET_Connection *conn = req.GetConnection();
+    return (conn != nullptr) ? conn->get_smoothed_rtt_us() : 0;
+}
+
+void encode_output(const std::string &output, const CompressionConfig &config, FRT_Values &dst) {
     using vespalib::compression::compress;
-    auto output = src.SerializeAsString();
     ConstBufferRef buf(output.data(), output.size());
     DataBuffer compressed(output.data(), output.size());
-    CompressionConfig::Type type = compress(get_compression_config(), buf, compressed, true);
+    CompressionConfig::Type type = compress(config, buf, compressed, true);
     dst.AddInt8(type);
     dst.AddInt32(buf.size());
     dst.AddData(compressed.getData(), compressed.getDataLen());
 }
 
-void encode_search_reply(const ProtoSearchReply &src, FRT_Values &dst) {
-    using vespalib::compression::compress;
+template <typename MSG>
+void encode_message(const MSG &src, FRT_Values &dst) {
+    encode_output(src.SerializeAsString(), get_compression_config(), dst);
+}
+
+// replies are compressed on the worker thread completing the request,
+// adapting to the connection the reply will be sent over when enabled
+template <typename MSG>
+void encode_reply(const MSG &src, FRT_RPCRequest &req, AdaptiveCompression &adaptive) {
+    if (!use_adaptive_compression()) {
+        return encode_message(src, *req.GetReturn());
+    }
     auto output = src.SerializeAsString();
+    CompressionConfig config = adaptive.select(get_compression_config(), get_rtt_us(req), output.size());
+    encode_output(output, config, *req.GetReturn());
+    if (config.useCompression() && (output.size() >= config.minSize)) {
+        adaptive.report(output.size(), (*req.GetReturn())[2]._data._len);
+    }
+}
+
+void encode_search_reply(const ProtoSearchReply &src, FRT_RPCRequest &req, AdaptiveCompression &adaptive) {
     if (src.grouping_blob().empty()) {
+        auto output = src.SerializeAsString();
+        FRT_Values &dst = *req.GetReturn();
         dst.AddInt8(CompressionConfig::Type::NONE);
         dst.AddInt32(output.size());
         dst.AddData(output.data(), output.size());
     } else {
-        ConstBufferRef buf(output.data(), output.size());
-        DataBuffer compressed(output.data(), output.size());
-        CompressionConfig::Type type = compress(get_compression_config(), buf, compressed, true);
-        dst.AddInt8(type);
-        dst.AddInt32(buf.size());
-        dst.AddData(compressed.getData(), compressed.getDataLen());
+        encode_reply(src, req, adaptive);
     }
 }
 
@@ -106,13 +130,14 @@ std::unique_ptr<SearchRequest::Source::Decoder> search_request_decoder(FRT_RPCRe
 struct SearchCompletionHandler : SearchClient {
     FRT_RPCRequest &req;
     SearchProtocolMetrics &metrics;
+    AdaptiveCompression &compression;
     QueryStats stats;
-    SearchCompletionHandler(FRT_RPCRequest &req_in, SearchProtocolMetrics &metrics_in)
-        : req(req_in), metrics(metrics_in), stats() {}
+    SearchCompletionHandler(FRT_RPCRequest &req_in, SearchProtocolMetrics &metrics_in, AdaptiveCompression &compression_in)
+        : req(req_in), metrics(metrics_in), compression(compression_in), stats() {}
     void searchDone(SearchReply::UP reply) override {
         ProtoSearchReply msg;
         ProtoConverter::search_reply_to_proto(*reply, msg);
-        encode_search_reply(msg, *req.GetReturn());
+        encode_search_reply(msg, req, compression);
         stats.reply_size = (*req.GetReturn())[2]._data._len;
         if (reply->request) {
             stats.latency = vespalib::to_s(reply->request->getTimeUsed());
@@ -152,13 +177,14 @@ std::unique_ptr<DocsumRequest::Source::Decoder> docsum_request_decoder(FRT_RPCRe
 struct GetDocsumsCompletionHandler : DocsumClient {
     FRT_RPCRequest &req;
     SearchProtocolMetrics &metrics;
+    AdaptiveCompression &compression;
     DocsumStats stats;
-    GetDocsumsCompletionHandler(FRT_RPCRequest &req_in, SearchProtocolMetrics &metrics_in)
-        : req(req_in), metrics(metrics_in), stats() {}
+    GetDocsumsCompletionHandler(FRT_RPCRequest &req_in, SearchProtocolMetrics &metrics_in, AdaptiveCompression &compression_in)
+        : req(req_in), metrics(metrics_in), compression(compression_in), stats() {}
     void getDocsumsDone(DocsumReply::UP reply) override {
         ProtoDocsumReply msg;
         ProtoConverter::docsum_reply_to_proto(*reply, msg);
-        encode_message(msg, *req.GetReturn());
+        encode_reply(msg, req, compression);
         stats.reply_size = (*req.GetReturn())[2]._data._len;
         if (reply->hasRequest()) {
             stats.latency = vespalib::to_s(reply->request().getTimeUsed());
@@ -207,7 +233,9 @@ ProtoRpcAdapter::ProtoRpcAdapter(SearchServer &search_server,
       _docsum_server(docsum_server),
       _monitor_server(monitor_server),
       _online(false),
-      _metrics()
+      _metrics(),
+      _search_compression(),
+      _docsum_compression()
 {
     FRT_ReflectionBuilder rb(&orb);
     //-------------------------------------------------------------------------
@@ -238,7 +266,7 @@ ProtoRpcAdapter::rpc_search(FRT_RPCRequest *req)
         return req->SetError(FRTE_RPC_METHOD_FAILED, "Server not online");
     }
     req->Detach();
-    auto &client = req->getStash().create<SearchCompletionHandler>(*req, _metrics);
+    auto &client = req->getStash().create<SearchCompletionHandler>(*req, _metrics, _search_compression);
     auto reply = _search_server.search(search_request_decoder(*req, client.stats), client);
     if (reply) {
         client.searchDone(std::move(reply));
@@ -252,7 +280,7 @@ ProtoRpcAdapter::rpc_getDocsums(FRT_RPCRequest *req)
         return req->SetError(FRTE_RPC_METHOD_FAILED, "Server not online");
     }
     req->Detach();
-    auto &client = req->getStash().create<GetDocsumsCompletionHandler>(*req, _metrics);
+    auto &client = req->getStash().create<GetDocsumsCompletionHandler>(*req, _metrics, _docsum_compression);
     auto reply = _docsum_server.getDocsums(docsum_request_decoder(*req, client.stats), client);
     if (reply) {
         client.getDocsumsDone(std::move(reply));
@@ -6,6 +6,7 @@
 #include "proto_converter.h"
 #include <atomic>
 
+#include "adaptive_compression.h"
 #include "search_protocol_metrics.h"
 
 class FRT_Supervisor;
@@ -36,6 +37,8 @@ private:
     MonitorServer  &_monitor_server;
     std::atomic<bool> _online;
     SearchProtocolMetrics _metrics;
+    AdaptiveCompression _search_compression;
+    AdaptiveCompression _docsum_compression;
 public:
     ProtoRpcAdapter(SearchServer &search_server,
                     DocsumServer &docsum_server,
@@ -36,8 +36,8 @@ SearchProtocolMetrics::~SearchProtocolMetrics() = default;
 void
 SearchProtocolMetrics::update_query_metrics(const QueryStats &stats)
 {
+    _query.latency.addValue(stats.latency); // lock-free
     auto guard = std::lock_guard(_lock);
-    _query.latency.set(stats.latency);
     _query.request_size.set(stats.request_size);
     _query.reply_size.set(stats.reply_size);
 }
@@ -45,8 +45,8 @@ SearchProtocolMetrics::update_query_metrics(const QueryStats &stats)
 void
 SearchProtocolMetrics::update_docsum_metrics(const DocsumStats &stats)
 {
+    _docsum.latency.addValue(stats.latency); // lock-free
     auto guard = std::lock_guard(_lock);
-    _docsum.latency.set(stats.latency);
     _docsum.request_size.set(stats.request_size);
     _docsum.reply_size.set(stats.reply_size);
     _docsum.requested_documents.inc(stats.requested_documents);
@@ -2,6 +2,7 @@
 
 #pragma once
 
+#include <vespa/metrics/histogrammetric.h>
 #include <vespa/metrics/valuemetric.h>
 #include <vespa/metrics/countmetric.h>
 #include <vespa/metrics/metricset.h>
@@ -18,7 +19,7 @@ class SearchProtocolMetrics : public metrics::MetricSet
 public:
     // sub-metrics for query request/reply
     struct QueryMetrics : metrics::MetricSet {
-        metrics::DoubleAverageMetric latency;
+        metrics::HistogramMetric     latency;
         metrics::LongAverageMetric   request_size;
         metrics::LongAverageMetric   reply_size;
 
@@ -36,7 +37,7 @@ public:
 
     // sub-metrics for docsum request/reply
     struct DocsumMetrics : metrics::MetricSet {
-        metrics::DoubleAverageMetric latency;
+        metrics::HistogramMetric     latency;
         metrics::LongAverageMetric   request_size;
         metrics::LongAverageMetric   reply_size;
         metrics::LongCountMetric     requested_documents;
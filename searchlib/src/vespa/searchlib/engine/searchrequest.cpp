@@ -13,7 +13,8 @@ SearchRequest::SearchRequest(RelativeTime relativeTime)
       maxhits(10),
       sortSpec(),
       groupSpec(),
-      sessionId()
+      sessionId(),
+      columnar_match_features(false)
 {
 }
 
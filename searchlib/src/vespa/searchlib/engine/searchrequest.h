@@ -20,6 +20,8 @@ public:
     vespalib::string  sortSpec;
     std::vector<char> groupSpec;
     std::vector<char> sessionId;
+    // the reply may encode match features per feature instead of per hit
+    bool              columnar_match_features;
 
     SearchRequest();
     explicit SearchRequest(RelativeTime relativeTime);
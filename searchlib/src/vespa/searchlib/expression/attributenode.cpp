@@ -219,12 +219,14 @@ AttributeNode::createResultHandler(bool preserveAccurateTypes, const attribute::
                 ? createMulti<FloatResultNodeVector, FloatHandler>()
                 : createSingle<FloatResultNode>();
     } else if (attribute.isStringType()) {
+        // Key on enum handles only when the values are stored in an enum store, strings are resolved afterwards
+        bool useEnum = _useEnumOptimization && attribute.hasEnum();
         if (_hasMultiValue) {
-            return (_useEnumOptimization)
+            return (useEnum)
                     ? createMulti<EnumResultNodeVector, EnumHandler>()
                     : createMulti<StringResultNodeVector, StringHandler>();
         } else {
-            return (_useEnumOptimization)
+            return (useEnum)
                     ? createSingle<EnumResultNode>()
                     : createSingle<StringResultNode>();
         }
@@ -293,7 +295,8 @@ AttributeNode::StringHandler::handle(const AttributeResult & r)
     _wVector.resize(numValues);
     r.getAttribute()->get(r.getDocId(), _wVector.data(), _wVector.size());
     for(size_t i(0); i < numValues; i++) {
-        _vector[i] = _wVector[i].getValue();
+        // Reuse the buffers of the result nodes instead of constructing temporary nodes
+        _vector[i].set(vespalib::stringref(_wVector[i].getValue()));
     }
 }
 
@@ -22,8 +22,8 @@ public:
     DocId getDocId() const { return _docId; }
 protected:
     ConstBufferRef get_raw() const {
-        auto raw = getAttribute()->get_raw(_docId);
-        return {raw.data(), raw.size()};
+        auto value = getAttribute()->get_string_view(_docId);
+        return {value.data(), value.size()};
     }
 private:
     int64_t onGetInteger(size_t index) const override { (void) index; return _attribute->getInt(_docId); }
@@ -44,6 +44,7 @@ private:
     class Handler : public document::fieldvalue::IteratorHandler {
     public:
         virtual void reset() = 0;
+        bool readOnly() const override { return true; }
     private:
         void onCollectionStart(const Content & c) override;
         void onStructStart(const Content & c) override;
@@ -100,19 +100,40 @@ considerUndefined<ConstCharPtr>(ConstCharPtr value, BasicType::Type )
 }
 
 /**
- * Implements the executor for fetching values from a single or array attribute vector
+ * Implements the executor for fetching values from a single or array attribute vector.
+ *
+ * When batching is enabled, the values for all hits in a batch are
+ * read together before the hits are evaluated one by one.
  */
 template <typename T>
 class SingleAttributeExecutor final : public fef::FeatureExecutor {
 private:
-    const T & _attribute;
+    using LoadedValueType = typename T::LoadedValueType;
+    const T &                    _attribute;
+    uint32_t                     _batch_size;
+    std::vector<uint32_t>        _batch_docids;
+    std::vector<uint32_t>        _ready_docids;
+    std::vector<LoadedValueType> _ready_values;
+    size_t                       _ready_pos;
+
+    void handle_add_to_batch(uint32_t docid) override { _batch_docids.push_back(docid); }
 public:
     /**
      * Constructs an executor.
      *
      * @param attribute The attribute vector to use.
+     * @param batch_size The max number of hits to read values for in a batch (0 disables batching).
      */
-    explicit SingleAttributeExecutor(const T & attribute) : _attribute(attribute) { }
+    SingleAttributeExecutor(const T & attribute, uint32_t batch_size)
+        : _attribute(attribute),
+          _batch_size(batch_size),
+          _batch_docids(),
+          _ready_docids(),
+          _ready_values(),
+          _ready_pos(0)
+    {
+        _batch_docids.reserve(batch_size);
+    }
     void handle_bind_outputs(vespalib::ArrayRef<fef::NumberOrObject> outputs_in) override {
         fef::FeatureExecutor::handle_bind_outputs(outputs_in);
         auto o = outputs().get_bound();
@@ -120,6 +141,8 @@ public:
         o[2].as_number = 0;  // contains
         o[3].as_number = 1;  // count
     }
+    size_t max_batch_size() const override { return _batch_size; }
+    void execute_batch() override;
     void execute(uint32_t docId) override;
 };
 
@@ -224,11 +247,33 @@ public:
     void execute(uint32_t docId) override;
 };
 
+template <typename T>
+void
+SingleAttributeExecutor<T>::execute_batch()
+{
+    _ready_values.resize(_batch_docids.size());
+    for (size_t i = 0; i < _batch_docids.size(); ++i) {
+        _ready_values[i] = _attribute.getFast(_batch_docids[i]);
+    }
+    _ready_docids.swap(_batch_docids);
+    _batch_docids.clear();
+    _ready_pos = 0;
+}
+
 template <typename T>
 void
 SingleAttributeExecutor<T>::execute(uint32_t docId)
 {
-    typename T::LoadedValueType v = _attribute.getFast(docId);
+    LoadedValueType v;
+    // hits are evaluated in increasing docid order, possibly skipping some of them
+    while (_ready_pos < _ready_docids.size() && _ready_docids[_ready_pos] < docId) {
+        ++_ready_pos;
+    }
+    if (_ready_pos < _ready_docids.size() && _ready_docids[_ready_pos] == docId) {
+        v = _ready_values[_ready_pos++];
+    } else {
+        v = _attribute.getFast(docId);
+    }
     // value
     auto o = outputs().get_bound();
     o[0].as_number = __builtin_expect(attribute::isUndefined(v), false)
@@ -321,8 +366,8 @@ struct SingleValueExecutorCreator {
         ptr = dynamic_cast<PtrType>(attribute);
         return ptr != nullptr;
     }
-    fef::FeatureExecutor & create(vespalib::Stash &stash) const {
-        return stash.create<ExecType>(*ptr);
+    fef::FeatureExecutor & create(vespalib::Stash &stash, uint32_t batch_size) const {
+        return stash.create<ExecType>(*ptr, batch_size);
     }
 private:
     PtrType ptr;
@@ -348,7 +393,7 @@ private:
 };
 
 fef::FeatureExecutor &
-createAttributeExecutor(uint32_t numOutputs, const IAttributeVector *attribute, const vespalib::string &attrName, const vespalib::string &extraParam, vespalib::Stash &stash)
+createAttributeExecutor(uint32_t numOutputs, const IAttributeVector *attribute, const vespalib::string &attrName, const vespalib::string &extraParam, vespalib::Stash &stash, uint32_t batch_size)
 {
     if (attribute == nullptr) {
         Issue::report("attribute feature: The attribute vector '%s' was not found, returning default values.",
@@ -382,22 +427,22 @@ createAttributeExecutor(uint32_t numOutputs, const IAttributeVector *attribute,
                     assert(numOutputs == 4);
                     if (basicType == BasicType::INT8) {
                         SingleValueExecutorCreator<IntegerAttributeTemplate<int8_t>> creator;
-                        if (creator.handle(attribute)) return creator.create(stash);
+                        if (creator.handle(attribute)) return creator.create(stash, batch_size);
                     } else if (basicType == BasicType::INT32) {
                         SingleValueExecutorCreator<IntegerAttributeTemplate<int32_t>> creator;
-                        if (creator.handle(attribute)) return creator.create(stash);
+                        if (creator.handle(attribute)) return creator.create(stash, batch_size);
                     }
                     SingleValueExecutorCreator<IntegerAttributeTemplate<int64_t>> creator;
-                    if (creator.handle(attribute)) return creator.create(stash);
+                    if (creator.handle(attribute)) return creator.create(stash, batch_size);
                 }
             } else if (attribute->isFloatingPointType()) {
                 assert(numOutputs == 4);
                 if (basicType == BasicType::DOUBLE) {
                     SingleValueExecutorCreator<FloatingPointAttributeTemplate<double>> creator;
-                    if (creator.handle(attribute)) return creator.create(stash);
+                    if (creator.handle(attribute)) return creator.create(stash, batch_size);
                 } else {
                     SingleValueExecutorCreator<FloatingPointAttributeTemplate<float>> creator;
-                    if (creator.handle(attribute)) return creator.create(stash);
+                    if (creator.handle(attribute)) return creator.create(stash, batch_size);
                 }
             }
         }
@@ -486,7 +531,8 @@ AttributeBlueprint::AttributeBlueprint() :
     _attrKey(),
     _extra(),
     _tensorType(ValueType::double_type()),
-    _numOutputs(0)
+    _numOutputs(0),
+    _batch_size(0)
 {
 }
 
@@ -506,6 +552,7 @@ AttributeBlueprint::setup(const fef::IIndexEnvironment & env,
     // params[1] = index (array attribute) or key (weighted set attribute)
     _attrName = params[0].getValue();
     _attrKey = createAttributeKey(_attrName);
+    _batch_size = fef::indexproperties::eval::AttributeBatchSize::lookup(env.getProperties());
     if (params.size() == 2) {
         _extra = params[1].getValue();
     }
@@ -554,7 +601,7 @@ AttributeBlueprint::createExecutor(const fef::IQueryEnvironment &env, vespalib::
     if (_tensorType.has_dimensions()) {
         return createTensorAttributeExecutor(attribute, _attrName, _tensorType, stash);
     } else {
-        return createAttributeExecutor(_numOutputs, attribute, _attrName, _extra, stash);
+        return createAttributeExecutor(_numOutputs, attribute, _attrName, _extra, stash, _batch_size);
     }
 }
 
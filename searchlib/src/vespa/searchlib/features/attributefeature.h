@@ -20,6 +20,7 @@ private:
     vespalib::string          _extra;    // the index or key
     vespalib::eval::ValueType _tensorType;
     uint8_t                   _numOutputs;
+    uint32_t                  _batch_size; // max hits to read values for together, 0 to disable
 
 
 public:
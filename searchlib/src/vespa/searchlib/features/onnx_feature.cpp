@@ -2,6 +2,7 @@
 
 #include "onnx_feature.h"
 #include <vespa/searchlib/fef/properties.h>
+#include <vespa/searchlib/fef/indexproperties.h>
 #include <vespa/searchlib/fef/onnx_model.h>
 #include <vespa/searchlib/fef/featureexecutor.h>
 #include <vespa/eval/eval/value.h>
@@ -30,6 +31,9 @@ using vespalib::eval::value_from_spec;
 using vespalib::make_string_short::fmt;
 using vespalib::eval::Onnx;
 using vespalib::Issue;
+using search::fef::indexproperties::eval::OnnxBatchSize;
+using search::fef::indexproperties::eval::OnnxIntraOpThreads;
+using search::fef::indexproperties::eval::OnnxSharedArena;
 
 namespace search::features {
 
@@ -78,16 +82,78 @@ class OnnxFeatureExecutor : public FeatureExecutor
 {
 private:
     Onnx::EvalContext _eval_context;
+    std::unique_ptr<Onnx::BatchEvalContext> _batch_context;
+    std::vector<uint32_t> _pending_docs;
+    std::vector<uint32_t> _batch_docs;
+    size_t _batch_pos;
+
+    void expose_results() {
+        for (size_t i = 0; i < _eval_context.num_results(); ++i) {
+            outputs().set_object(i, _eval_context.get_result(i));
+        }
+    }
+    // docids are added to and looked up in the batch in increasing order
+    bool expose_batch_results(uint32_t docid) {
+        while ((_batch_pos < _batch_docs.size()) && (_batch_docs[_batch_pos] < docid)) {
+            ++_batch_pos;
+        }
+        if ((_batch_pos == _batch_docs.size()) || (_batch_docs[_batch_pos] != docid)) {
+            return false;
+        }
+        for (size_t i = 0; i < _batch_context->num_results(); ++i) {
+            outputs().set_object(i, _batch_context->get_result(_batch_pos, i));
+        }
+        return true;
+    }
 public:
-    OnnxFeatureExecutor(const Onnx &model, const Onnx::WireInfo &wire_info)
-        : _eval_context(model, wire_info) {}
+    OnnxFeatureExecutor(const Onnx &model, const Onnx::WireInfo &wire_info, size_t batch_size)
+        : _eval_context(model, wire_info),
+          _batch_context(),
+          _pending_docs(),
+          _batch_docs(),
+          _batch_pos(0)
+    {
+        if (batch_size > 1) {
+            _batch_context = std::make_unique<Onnx::BatchEvalContext>(model, wire_info, batch_size);
+            _pending_docs.reserve(batch_size);
+            _batch_docs.reserve(batch_size);
+        }
+    }
     bool isPure() override { return true; }
+    size_t max_batch_size() const override {
+        return _batch_context ? _batch_context->max_batch_size() : 0;
+    }
     void handle_bind_outputs(vespalib::ArrayRef<fef::NumberOrObject>) override {
-        for (size_t i = 0; i < _eval_context.num_results(); ++i) {
-            outputs().set_object(i, _eval_context.get_result(i));
+        expose_results();
+    }
+    void handle_add_to_batch(uint32_t docid) override {
+        size_t slot = _pending_docs.size();
+        for (size_t i = 0; i < _batch_context->num_params(); ++i) {
+            _batch_context->bind_param(slot, i, inputs().get_object(i).get());
+        }
+        _pending_docs.push_back(docid);
+    }
+    void execute_batch() override {
+        _batch_docs.clear();
+        _batch_pos = 0;
+        if (!_pending_docs.empty()) {
+            try {
+                _batch_context->eval(_pending_docs.size());
+                std::swap(_batch_docs, _pending_docs);
+            } catch (const Ort::Exception &ex) {
+                // documents in a failed batch are evaluated one by one
+                Issue::report("onnx model batch evaluation failed: %s", ex.what());
+            }
+            _pending_docs.clear();
         }
     }
-    void execute(uint32_t) override {
+    void execute(uint32_t docid) override {
+        if (_batch_context) {
+            if (expose_batch_results(docid)) {
+                return;
+            }
+            expose_results();
+        }
         for (size_t i = 0; i < _eval_context.num_params(); ++i) {
             _eval_context.bind_param(i, inputs().get_object(i).get());
         }
@@ -105,7 +171,8 @@ OnnxBlueprint::OnnxBlueprint(vespalib::stringref baseName)
       _cache_token(),
       _debug_model(),
       _model(nullptr),
-      _wire_info()
+      _wire_info(),
+      _batch_size(0)
 {
     assert((baseName == "onnx") || (baseName == "onnxModel"));
 }
@@ -125,7 +192,10 @@ OnnxBlueprint::setup(const IIndexEnvironment &env,
             _debug_model = std::make_unique<Onnx>(model_cfg->file_path(), Optimize::DISABLE);
             _model = _debug_model.get();
         } else {
-            _cache_token = OnnxModelCache::load(model_cfg->file_path());
+            auto options = Onnx::Options(Optimize::ENABLE)
+                           .set_intra_op_threads(OnnxIntraOpThreads::lookup(env.getProperties()))
+                           .set_shared_arena(OnnxSharedArena::check(env.getProperties()));
+            _cache_token = OnnxModelCache::load(model_cfg->file_path(), options);
             _model = &(_cache_token->get());
         }
     } catch (const Ort::Exception &ex) {
@@ -172,6 +242,15 @@ OnnxBlueprint::setup(const IIndexEnvironment &env,
     } else {
         LOG(warning, "dry-run disabled for onnx model '%s'", model_cfg->name().c_str());
     }
+    uint32_t batch_size = OnnxBatchSize::lookup(env.getProperties());
+    if (batch_size > 1) {
+        if (Onnx::BatchEvalContext::can_batch(*_model, _wire_info)) {
+            _batch_size = batch_size;
+        } else {
+            LOG(debug, "onnx model '%s' does not have a leading batch dimension of size 1 for all inputs "
+                "and outputs; evaluating one hit at a time", model_cfg->name().c_str());
+        }
+    }
     return true;
 }
 
@@ -179,7 +258,7 @@ FeatureExecutor &
 OnnxBlueprint::createExecutor(const IQueryEnvironment &, Stash &stash) const
 {
     assert(_model != nullptr);
-    return stash.create<OnnxFeatureExecutor>(*_model, _wire_info);
+    return stash.create<OnnxFeatureExecutor>(*_model, _wire_info, _batch_size);
 }
 
 }
@@ -2,12 +2,17 @@
 
 #include "rankingexpressionfeature.h"
 #include "utils.h"
+#include <vespa/searchlib/fef/featurenamebuilder.h>
+#include <vespa/searchlib/fef/featurenameparser.h>
 #include <vespa/searchlib/fef/properties.h>
 #include <vespa/searchlib/fef/indexproperties.h>
 #include <vespa/searchlib/features/rankingexpression/feature_name_extractor.h>
 #include <vespa/eval/eval/param_usage.h>
 #include <vespa/eval/eval/fast_value.h>
+#include <vespa/eval/eval/tensor_nodes.h>
 #include <vespa/vespalib/util/stringfmt.h>
+#include <algorithm>
+#include <map>
 
 #include <vespa/log/log.h>
 LOG_SETUP(".features.rankingexpression");
@@ -27,6 +32,8 @@ using vespalib::eval::PassParams;
 using vespalib::eval::Value;
 using vespalib::eval::ValueType;
 using vespalib::eval::gbdt::FastForest;
+using vespalib::eval::nodes::DumpContext;
+using vespalib::eval::nodes::Node;
 
 namespace search::features {
 
@@ -40,12 +47,119 @@ vespalib::string list_issues(const std::vector<vespalib::string> &issues) {
     return result;
 }
 
+/**
+ * Rewrites an interpreted expression so that each largest
+ * subexpression doing tensor math using only query and constant
+ * features is referenced as a separate rankingExpression feature. The
+ * rank program evaluates such features once per query since all their
+ * inputs are constant, instead of evaluating the subexpression for
+ * each hit. The parameters of the original expression are kept first
+ * (in the same order) followed by the lifted features.
+ **/
+class QueryConstantLifter {
+private:
+    struct Info {
+        bool has_param = false;
+        bool all_const = true;
+        bool has_tensor = false;
+    };
+    const Function &_function;
+    const NodeTypes &_types;
+    std::vector<vespalib::string> _param_names;
+    std::vector<bool> _param_is_const;
+    std::map<const Node *, Info> _info;
+
+    Info analyze(const Node &node) {
+        Info info;
+        if (auto symbol = vespalib::eval::nodes::as<vespalib::eval::nodes::Symbol>(node)) {
+            info.has_param = true;
+            info.all_const = _param_is_const[symbol->id()];
+        }
+        if (auto lambda = vespalib::eval::nodes::as<vespalib::eval::nodes::TensorLambda>(node)) {
+            for (size_t id: lambda->bindings()) {
+                info.has_param = true;
+                info.all_const = (info.all_const && _param_is_const[id]);
+            }
+        }
+        info.has_tensor = !_types.get_type(node).is_double();
+        for (size_t i = 0; i < node.num_children(); ++i) {
+            Info child = analyze(node.get_child(i));
+            info.has_param = (info.has_param || child.has_param);
+            info.all_const = (info.all_const && child.all_const);
+            info.has_tensor = (info.has_tensor || child.has_tensor);
+        }
+        _info[&node] = info;
+        return info;
+    }
+    bool should_lift(const Node &node) const {
+        const Info &info = _info.find(&node)->second;
+        return (info.has_param && info.all_const && info.has_tensor && !node.is_param());
+    }
+    vespalib::string dump(const Node &node) const {
+        DumpContext ctx(_param_names);
+        return node.dump(ctx);
+    }
+    vespalib::string lifted_name(const Node &node, std::vector<vespalib::string> &params) const {
+        auto name = fef::FeatureNameBuilder().baseName("rankingExpression").parameter(dump(node)).buildName();
+        if (std::find(params.begin(), params.end(), name) == params.end()) {
+            params.push_back(name);
+        }
+        return name;
+    }
+    // the dump of a node contains the dumps of its children in order
+    vespalib::string rewrite(const Node &node, std::vector<vespalib::string> &params) const {
+        vespalib::string str = dump(node);
+        size_t pos = 0;
+        for (size_t i = 0; i < node.num_children(); ++i) {
+            const Node &child = node.get_child(i);
+            vespalib::string before = dump(child);
+            vespalib::string after = should_lift(child) ? lifted_name(child, params) : rewrite(child, params);
+            if (after != before) {
+                pos = str.find(before, pos);
+                assert(pos != vespalib::string::npos);
+                str.replace(pos, before.size(), after);
+            }
+            pos += after.size();
+        }
+        return str;
+    }
+
+public:
+    QueryConstantLifter(const Function &function, const NodeTypes &types)
+        : _function(function), _types(types), _param_names(), _param_is_const(), _info()
+    {
+        for (size_t i = 0; i < function.num_params(); ++i) {
+            fef::FeatureNameParser parser(function.param_name(i));
+            _param_names.emplace_back(function.param_name(i));
+            _param_is_const.push_back(parser.valid() &&
+                                      (parser.baseName() == "query" || parser.baseName() == "constant"));
+        }
+        analyze(function.root());
+    }
+    // returns nullptr if nothing was lifted
+    std::shared_ptr<Function const> lift() const {
+        if (_info.find(&_function.root())->second.all_const) {
+            return {}; // the whole expression is already constant
+        }
+        std::vector<vespalib::string> params = _param_names;
+        vespalib::string expr = rewrite(_function.root(), params);
+        if (params.size() == _param_names.size()) {
+            return {};
+        }
+        return Function::parse(params, expr, rankingexpression::FeatureNameExtractor());
+    }
+};
+
 } // namespace search::features::<unnamed>
 
 //-----------------------------------------------------------------------------
 
 /**
  * Implements the executor for fast forest gbdt evaluation
+ *
+ * When batching is enabled, the parameters of the hits added to a
+ * batch are collected per feature and the whole batch is evaluated
+ * at once before the hits are ranked one by one.
  **/
 class FastForestExecutor : public fef::FeatureExecutor
 {
@@ -53,10 +167,22 @@ private:
     const FastForest &_forest;
     FastForest::Context::UP _ctx;
     ArrayRef<float> _params;
+    size_t _batch_size;
+    std::vector<float> _batch_params;
+    std::vector<uint32_t> _pending_docs;
+    std::vector<uint32_t> _batch_docs;
+    std::vector<double> _batch_results;
+    size_t _batch_pos;
+
+    void handle_add_to_batch(uint32_t docid) override;
+    bool expose_batch_result(uint32_t docid);
 
 public:
-    FastForestExecutor(ArrayRef<float> param_space, const FastForest &forest);
+    FastForestExecutor(ArrayRef<float> param_space, const FastForest &forest, size_t batch_size);
+    ~FastForestExecutor() override;
     bool isPure() override { return true; }
+    size_t max_batch_size() const override { return _batch_size; }
+    void execute_batch() override;
     void execute(uint32_t docId) override;
 };
 
@@ -148,16 +274,69 @@ public:
 
 //-----------------------------------------------------------------------------
 
-FastForestExecutor::FastForestExecutor(ArrayRef<float> param_space, const FastForest &forest)
+FastForestExecutor::FastForestExecutor(ArrayRef<float> param_space, const FastForest &forest, size_t batch_size)
     : _forest(forest),
       _ctx(_forest.create_context()),
-      _params(param_space)
+      _params(param_space),
+      _batch_size(batch_size),
+      _batch_params(),
+      _pending_docs(),
+      _batch_docs(),
+      _batch_results(),
+      _batch_pos(0)
+{
+    if (_batch_size > 0) {
+        _batch_params.resize(_params.size() * _batch_size, 0.0);
+        _pending_docs.reserve(_batch_size);
+        _batch_docs.reserve(_batch_size);
+        _batch_results.resize(_batch_size, 0.0);
+    }
+}
+
+FastForestExecutor::~FastForestExecutor() = default;
+
+void
+FastForestExecutor::handle_add_to_batch(uint32_t docid)
+{
+    size_t slot = _pending_docs.size();
+    assert(slot < _batch_size);
+    _pending_docs.push_back(docid);
+    for (size_t i = 0; i < _params.size(); ++i) {
+        _batch_params[(i * _batch_size) + slot] = inputs().get_number(i);
+    }
+}
+
+void
+FastForestExecutor::execute_batch()
+{
+    _batch_docs.clear();
+    _batch_pos = 0;
+    if (!_pending_docs.empty()) {
+        _forest.eval_batch(*_ctx, &_batch_params[0], _batch_size, _pending_docs.size(), &_batch_results[0]);
+        std::swap(_batch_docs, _pending_docs);
+    }
+}
+
+// docids are added to and looked up in the batch in increasing order
+bool
+FastForestExecutor::expose_batch_result(uint32_t docid)
 {
+    while ((_batch_pos < _batch_docs.size()) && (_batch_docs[_batch_pos] < docid)) {
+        ++_batch_pos;
+    }
+    if ((_batch_pos == _batch_docs.size()) || (_batch_docs[_batch_pos] != docid)) {
+        return false;
+    }
+    outputs().set_number(0, _batch_results[_batch_pos]);
+    return true;
 }
 
 void
-FastForestExecutor::execute(uint32_t)
+FastForestExecutor::execute(uint32_t docid)
 {
+    if ((_batch_size > 0) && expose_batch_result(docid)) {
+        return;
+    }
     size_t i = 0;
     for (; (i + 3) < _params.size(); i += 4) {
         _params[i+0] = inputs().get_number(i+0);
@@ -258,6 +437,7 @@ RankingExpressionBlueprint::RankingExpressionBlueprint(rankingexpression::Expres
       _expression_replacer(std::move(replacer)),
       _intrinsic_expression(),
       _fast_forest(),
+      _fast_forest_batch_size(0),
       _interpreted_function(),
       _compile_token(),
       _input_is_object(),
@@ -327,6 +507,25 @@ RankingExpressionBlueprint::setup(const fef::IIndexEnvironment &env,
     if (!node_types.all_types_are_double()) {
         do_compile = false;
     }
+    if (!do_compile && fef::indexproperties::eval::LiftQueryConstants::check(env.getProperties())) {
+        if (auto lifted = QueryConstantLifter(*rank_function, node_types).lift()) {
+            if (lifted->has_error()) {
+                LOG(warning, "%s: could not lift query constants: %s", getName().c_str(), lifted->get_error().c_str());
+            } else {
+                for (size_t i = rank_function->num_params(); i < lifted->num_params(); ++i) {
+                    auto maybe_input = defineInput(lifted->param_name(i), AcceptInput::ANY);
+                    if (!maybe_input) {
+                        return false;
+                    }
+                    const FeatureType &input = maybe_input.value();
+                    _input_is_object.push_back(char(input.is_object()));
+                    input_types.push_back(input.is_object() ? input.type() : ValueType::double_type());
+                }
+                rank_function = std::move(lifted);
+                node_types = NodeTypes(*rank_function, input_types);
+            }
+        }
+    }
     ValueType root_type = node_types.get_type(rank_function->root());
     if (root_type.is_error()) {
         for (const auto &type_error: node_types.errors()) {
@@ -352,6 +551,9 @@ RankingExpressionBlueprint::setup(const fef::IIndexEnvironment &env,
             // fast forest evaluation is a possible replacement for compiled tree models
             if (fef::indexproperties::eval::UseFastForest::check(env.getProperties())) {
                 _fast_forest = FastForest::try_convert(*rank_function);
+                if (_fast_forest && _fast_forest->prefer_batch_eval()) {
+                    _fast_forest_batch_size = fef::indexproperties::eval::FastForestBatchSize::lookup(env.getProperties());
+                }
             }
             if (!_fast_forest) {
                 bool suggest_lazy = CompiledFunction::should_use_lazy_params(*rank_function);
@@ -404,7 +606,7 @@ RankingExpressionBlueprint::createExecutor(const fef::IQueryEnvironment &env, ve
     }
     if (_fast_forest) {
         ArrayRef<float> param_space = stash.create_array<float>(_input_is_object.size(), 0.0);
-        return stash.create<FastForestExecutor>(param_space, *_fast_forest);
+        return stash.create<FastForestExecutor>(param_space, *_fast_forest, _fast_forest_batch_size);
     }
     assert(_compile_token.get() != nullptr); // will be nullptr for VERIFY_SETUP feature motivation
     if (_compile_token->get().pass_params() == PassParams::ARRAY) {
@@ -21,6 +21,7 @@ private:
     rankingexpression::ExpressionReplacer::SP  _expression_replacer;
     rankingexpression::IntrinsicExpression::UP _intrinsic_expression;
     vespalib::eval::gbdt::FastForest::UP       _fast_forest;
+    uint32_t                                   _fast_forest_batch_size;
     vespalib::eval::InterpretedFunction::UP    _interpreted_function;
     vespalib::eval::CompileCache::Token::UP    _compile_token;
     std::vector<char>                          _input_is_object;
@@ -20,6 +20,22 @@ FeatureExecutor::isPure()
     return false;
 }
 
+size_t
+FeatureExecutor::max_batch_size() const
+{
+    return 0;
+}
+
+void
+FeatureExecutor::execute_batch()
+{
+}
+
+void
+FeatureExecutor::handle_add_to_batch(uint32_t)
+{
+}
+
 void
 FeatureExecutor::handle_bind_inputs(vespalib::ConstArrayRef<LazyValue>)
 {
@@ -106,6 +106,14 @@ protected:
      **/
     virtual void execute(uint32_t docId) = 0;
 
+    /**
+     * Add the given document to the current batch. Inputs are
+     * available for the document when this function is called.
+     *
+     * @param docid the local document id being added
+     **/
+    virtual void handle_add_to_batch(uint32_t docId);
+
 public:
     /**
      * Create a feature executor that has not yet been bound to neither
@@ -148,6 +156,38 @@ public:
      **/
     virtual bool isPure();
 
+    /**
+     * Obtain the max number of documents this executor is able to
+     * evaluate together in a batch. Documents are added to the batch
+     * with add_to_batch and evaluated together with execute_batch,
+     * after which execute is called for each document in the batch
+     * to expose its results. Executors not supporting batching
+     * return 0 (the default), in which case the other batch
+     * functions are never called.
+     *
+     * @return max batch size, 0 if batching is not supported
+     **/
+    virtual size_t max_batch_size() const;
+
+    /**
+     * Evaluate all documents added to the current batch and start a
+     * new batch.
+     **/
+    virtual void execute_batch();
+
+    /**
+     * Add a document to the current batch, making sure inputs are
+     * resolved for that document.
+     *
+     * @param docid the local document id being added
+     **/
+    void add_to_batch(uint32_t docid) {
+        _inputs.set_docid(docid);
+        handle_add_to_batch(docid);
+        // the document has not been executed yet
+        _inputs.set_docid(-1);
+    }
+
     /**
      * Make sure this executor has been executed for the given
      * document.
@@ -61,6 +61,21 @@ lookupUint32(const Properties &props, const vespalib::string &name, uint32_t def
     return value;
 }
 
+uint64_t
+lookupUint64(const Properties &props, const vespalib::string &name, uint64_t defaultValue)
+{
+    Property p = props.lookup(name);
+    uint64_t value(defaultValue);
+    if (p.found()) {
+        const auto & valS = p.get();
+        const char * start = valS.c_str();
+        const char * end = start + valS.size();
+        while ((start != end) && isspace(start[0])) { start++; }
+        std::from_chars(start, end, value);
+    }
+    return value;
+}
+
 bool
 lookupBool(const Properties &props, const vespalib::string &name, bool defaultValue)
 {
@@ -94,6 +109,30 @@ const vespalib::string UseFastForest::NAME("vespa.eval.use_fast_forest");
 const bool UseFastForest::DEFAULT_VALUE(false);
 bool UseFastForest::check(const Properties &props) { return lookupBool(props, NAME, DEFAULT_VALUE); }
 
+const vespalib::string LiftQueryConstants::NAME("vespa.eval.lift_query_constants");
+const bool LiftQueryConstants::DEFAULT_VALUE(false);
+bool LiftQueryConstants::check(const Properties &props) { return lookupBool(props, NAME, DEFAULT_VALUE); }
+
+const vespalib::string OnnxBatchSize::NAME("vespa.eval.onnx_batch_size");
+const uint32_t OnnxBatchSize::DEFAULT_VALUE(0);
+uint32_t OnnxBatchSize::lookup(const Properties &props) { return lookupUint32(props, NAME, DEFAULT_VALUE); }
+
+const vespalib::string FastForestBatchSize::NAME("vespa.eval.fast_forest_batch_size");
+const uint32_t FastForestBatchSize::DEFAULT_VALUE(0);
+uint32_t FastForestBatchSize::lookup(const Properties &props) { return lookupUint32(props, NAME, DEFAULT_VALUE); }
+
+const vespalib::string AttributeBatchSize::NAME("vespa.eval.attribute_batch_size");
+const uint32_t AttributeBatchSize::DEFAULT_VALUE(0);
+uint32_t AttributeBatchSize::lookup(const Properties &props) { return lookupUint32(props, NAME, DEFAULT_VALUE); }
+
+const vespalib::string OnnxIntraOpThreads::NAME("vespa.eval.onnx_intra_op_threads");
+const uint32_t OnnxIntraOpThreads::DEFAULT_VALUE(1);
+uint32_t OnnxIntraOpThreads::lookup(const Properties &props) { return lookupUint32(props, NAME, DEFAULT_VALUE); }
+
+const vespalib::string OnnxSharedArena::NAME("vespa.eval.onnx_shared_arena");
+const bool OnnxSharedArena::DEFAULT_VALUE(false);
+bool OnnxSharedArena::check(const Properties &props) { return lookupBool(props, NAME, DEFAULT_VALUE); }
+
 } // namespace eval
 
 namespace rank {
@@ -305,6 +344,27 @@ Feature::lookup(const Properties &props)
     return lookupStringVector(props, NAME, DEFAULT_VALUE);
 }
 
+const vespalib::string HitsPerTask::NAME("vespa.summary.hits_per_task");
+const uint32_t HitsPerTask::DEFAULT_VALUE(0);
+
+uint32_t
+HitsPerTask::lookup(const Properties &props)
+{
+    return lookup(props, DEFAULT_VALUE);
+}
+
+uint32_t
+HitsPerTask::lookup(const Properties &props, uint32_t defaultValue)
+{
+    return lookupUint32(props, NAME, defaultValue);
+}
+
+const vespalib::string PrecomputeFeatures::NAME("vespa.summary.precompute_features");
+const bool PrecomputeFeatures::DEFAULT_VALUE(false);
+bool PrecomputeFeatures::check(const Properties &props, bool fallback) {
+    return lookupBool(props, NAME, fallback);
+}
+
 } // namespace summary
 
 namespace dump {
@@ -346,6 +406,21 @@ TermwiseLimit::lookup(const Properties &props, double defaultValue)
     return lookupDouble(props, NAME, defaultValue);
 }
 
+const vespalib::string FirstPhaseBatchSize::NAME("vespa.matching.first_phase_batch_size");
+const uint32_t FirstPhaseBatchSize::DEFAULT_VALUE(0);
+
+uint32_t
+FirstPhaseBatchSize::lookup(const Properties &props)
+{
+    return lookup(props, DEFAULT_VALUE);
+}
+
+uint32_t
+FirstPhaseBatchSize::lookup(const Properties &props, uint32_t defaultValue)
+{
+    return lookupUint32(props, NAME, defaultValue);
+}
+
 const vespalib::string NumThreadsPerSearch::NAME("vespa.matching.numthreadspersearch");
 const uint32_t NumThreadsPerSearch::DEFAULT_VALUE(std::numeric_limits<uint32_t>::max());
 
@@ -376,6 +451,114 @@ NumSearchPartitions::lookup(const Properties &props, uint32_t defaultValue)
     return lookupUint32(props, NAME, defaultValue);
 }
 
+const vespalib::string NumNumaNodes::NAME("vespa.matching.numnumanodes");
+const uint32_t NumNumaNodes::DEFAULT_VALUE(0);
+
+uint32_t
+NumNumaNodes::lookup(const Properties &props)
+{
+    return lookup(props, DEFAULT_VALUE);
+}
+
+uint32_t
+NumNumaNodes::lookup(const Properties &props, uint32_t defaultValue)
+{
+    return lookupUint32(props, NAME, defaultValue);
+}
+
+const vespalib::string MaxGroupsPerThread::NAME("vespa.matching.maxgroupsperthread");
+const uint32_t MaxGroupsPerThread::DEFAULT_VALUE(0);
+
+uint32_t
+MaxGroupsPerThread::lookup(const Properties &props)
+{
+    return lookup(props, DEFAULT_VALUE);
+}
+
+uint32_t
+MaxGroupsPerThread::lookup(const Properties &props, uint32_t defaultValue)
+{
+    return lookupUint32(props, NAME, defaultValue);
+}
+
+const vespalib::string ApproximateGroupingHits::NAME("vespa.matching.approximategroupinghits");
+const uint32_t ApproximateGroupingHits::DEFAULT_VALUE(0);
+
+uint32_t
+ApproximateGroupingHits::lookup(const Properties &props)
+{
+    return lookup(props, DEFAULT_VALUE);
+}
+
+uint32_t
+ApproximateGroupingHits::lookup(const Properties &props, uint32_t defaultValue)
+{
+    return lookupUint32(props, NAME, defaultValue);
+}
+
+const vespalib::string ProfileSampleRate::NAME("vespa.matching.profile.samplerate");
+const uint32_t ProfileSampleRate::DEFAULT_VALUE(0);
+
+uint32_t
+ProfileSampleRate::lookup(const Properties &props)
+{
+    return lookupUint32(props, NAME, DEFAULT_VALUE);
+}
+
+const vespalib::string LazySetup::NAME("vespa.matching.lazy_setup");
+const bool LazySetup::DEFAULT_VALUE(false);
+
+bool
+LazySetup::check(const Properties &props)
+{
+    return lookupBool(props, NAME, DEFAULT_VALUE);
+}
+
+const vespalib::string ResultCacheMaxEntries::NAME("vespa.matching.result_cache.max_entries");
+const uint32_t ResultCacheMaxEntries::DEFAULT_VALUE(0);
+
+uint32_t
+ResultCacheMaxEntries::lookup(const Properties &props)
+{
+    return lookupUint32(props, NAME, DEFAULT_VALUE);
+}
+
+const vespalib::string ResultCacheMaxAge::NAME("vespa.matching.result_cache.max_age");
+const double ResultCacheMaxAge::DEFAULT_VALUE(60.0);
+
+double
+ResultCacheMaxAge::lookup(const Properties &props)
+{
+    return lookupDouble(props, NAME, DEFAULT_VALUE);
+}
+
+const vespalib::string GlobalFilterCacheMaxBytes::NAME("vespa.matching.global_filter_cache.max_bytes");
+const uint64_t GlobalFilterCacheMaxBytes::DEFAULT_VALUE(0);
+
+uint64_t
+GlobalFilterCacheMaxBytes::lookup(const Properties &props)
+{
+    return lookupUint64(props, NAME, DEFAULT_VALUE);
+}
+
+const vespalib::string GlobalFilterCacheMinCost::NAME("vespa.matching.global_filter_cache.min_cost");
+const double GlobalFilterCacheMinCost::DEFAULT_VALUE(0.001);
+
+double
+GlobalFilterCacheMinCost::lookup(const Properties &props)
+{
+    return lookupDouble(props, NAME, DEFAULT_VALUE);
+}
+
+const vespalib::string GlobalFilterCacheMaxAge::NAME("vespa.matching.global_filter_cache.max_age");
+const double GlobalFilterCacheMaxAge::DEFAULT_VALUE(60.0);
+
+double
+GlobalFilterCacheMaxAge::lookup(const Properties &props)
+{
+    return lookupDouble(props, NAME, DEFAULT_VALUE);
+}
+
 const vespalib::string MinHitsPerThread::NAME("vespa.matching.minhitsperthread");
 const uint32_t MinHitsPerThread::DEFAULT_VALUE(0);
 
@@ -439,6 +622,22 @@ TargetHitsMaxAdjustmentFactor::lookup(const Properties& props, double defaultVal
     return lookupDouble(props, NAME, defaultValue);
 }
 
+const vespalib::string FilterFirstThreshold::NAME("vespa.matching.nns.filter_first_threshold");
+
+const double FilterFirstThreshold::DEFAULT_VALUE(0.0);
+
+double
+FilterFirstThreshold::lookup(const Properties& props)
+{
+    return lookup(props, DEFAULT_VALUE);
+}
+
+double
+FilterFirstThreshold::lookup(const Properties& props, double defaultValue)
+{
+    return lookupDouble(props, NAME, defaultValue);
+}
+
 const vespalib::string FuzzyAlgorithm::NAME("vespa.matching.fuzzy.algorithm");
 const vespalib::FuzzyMatchingAlgorithm FuzzyAlgorithm::DEFAULT_VALUE(vespalib::FuzzyMatchingAlgorithm::DfaTable);
 
@@ -510,6 +709,9 @@ namespace matchphase {
 const vespalib::string DegradationAttribute::NAME("vespa.matchphase.degradation.attribute");
 const vespalib::string DegradationAttribute::DEFAULT_VALUE("");
 
+const vespalib::string DegradationAttributeFromFirstPhase::NAME("vespa.matchphase.degradation.attributefromfirstphase");
+const bool DegradationAttributeFromFirstPhase::DEFAULT_VALUE(false);
+
 const vespalib::string DegradationAscendingOrder::NAME("vespa.matchphase.degradation.ascendingorder");
 const bool DegradationAscendingOrder::DEFAULT_VALUE(false);
 
@@ -543,6 +745,12 @@ DegradationAttribute::lookup(const Properties &props, const vespalib::string & d
     return lookupString(props, NAME, defaultValue);
 }
 
+bool
+DegradationAttributeFromFirstPhase::lookup(const Properties &props, bool defaultValue)
+{
+    return lookupBool(props, NAME, defaultValue);
+}
+
 bool
 DegradationAscendingOrder::lookup(const Properties &props, bool defaultValue)
 {
@@ -34,6 +34,56 @@ struct UseFastForest {
     static bool check(const Properties &props);
 };
 
+// evaluate tensor subexpressions depending only on query and
+// constant features once per query, as separate features, instead of
+// once per hit. affects rank/summary/dump
+struct LiftQueryConstants {
+    static const vespalib::string NAME;
+    static const bool DEFAULT_VALUE;
+    static bool check(const Properties &props);
+};
+
+// max number of hits evaluated together by onnx models supporting
+// batching (see Onnx::BatchEvalContext). 0 disables batching. affects rank
+struct OnnxBatchSize {
+    static const vespalib::string NAME;
+    static const uint32_t DEFAULT_VALUE;
+    static uint32_t lookup(const Properties &props);
+};
+
+// max number of hits evaluated together by fast-forest gbdt models
+// where the trees allow it. 0 disables batching. affects rank
+struct FastForestBatchSize {
+    static const vespalib::string NAME;
+    static const uint32_t DEFAULT_VALUE;
+    static uint32_t lookup(const Properties &props);
+};
+
+// max number of hits for which single value numeric attribute
+// features read their values together in a batch, when the hits are
+// ranked in batches. 0 disables batching. affects rank
+struct AttributeBatchSize {
+    static const vespalib::string NAME;
+    static const uint32_t DEFAULT_VALUE;
+    static uint32_t lookup(const Properties &props);
+};
+
+// number of intra-op threads used by onnx model sessions. models are
+// shared across rank profiles with equal session options. affects rank
+struct OnnxIntraOpThreads {
+    static const vespalib::string NAME;
+    static const uint32_t DEFAULT_VALUE;
+    static uint32_t lookup(const Properties &props);
+};
+
+// let onnx model sessions allocate from a single memory arena shared
+// by all sessions with this option enabled. affects rank
+struct OnnxSharedArena {
+    static const vespalib::string NAME;
+    static const bool DEFAULT_VALUE;
+    static bool check(const Properties &props);
+};
+
 } // namespace eval
 
 namespace rank {
@@ -98,6 +148,33 @@ namespace summary {
         static std::vector<vespalib::string> lookup(const Properties &props);
     };
 
+    /**
+     * Property for the number of hits filled by each task when the
+     * docsums of a single request are filled in parallel. The hit list
+     * is only split when it has more hits than this. The default value
+     * of 0 means that all docsums are filled by the requesting thread.
+     **/
+    struct HitsPerTask {
+        static const vespalib::string NAME;
+        static const uint32_t DEFAULT_VALUE;
+        static uint32_t lookup(const Properties &props);
+        static uint32_t lookup(const Properties &props, uint32_t defaultValue);
+    };
+
+    /**
+     * Property for calculating the summary features of the returned
+     * hits as part of matching, caching them in the search session.
+     * Docsum requests using the cached search session then use these
+     * instead of running the query again. Only used when the search
+     * session is cached. The default value is false.
+     **/
+    struct PrecomputeFeatures {
+        static const vespalib::string NAME;
+        static const bool DEFAULT_VALUE;
+        static bool check(const Properties &props) { return check(props, DEFAULT_VALUE); }
+        static bool check(const Properties &props, bool fallback);
+    };
+
 } // namespace summary
 
 namespace dump {
@@ -245,8 +322,10 @@ namespace matching {
     /**
      * A number in the range [0,1] indicating how much of the corpus
      * the query must match for termwise evaluation to be enabled. 1
-     * means never allowed. 0 means always allowed. The default value
-     * is 1 (never).
+     * means never allowed. 0 means always allowed. A negative value
+     * means that termwise evaluation is decided for each subtree by
+     * comparing the estimated costs from the query flow statistics.
+     * The default value is 1 (never).
      **/
     struct TermwiseLimit {
         static const vespalib::string NAME;
@@ -255,6 +334,23 @@ namespace matching {
         static double lookup(const Properties &props, double defaultValue);
     };
 
+    /**
+     * Property for the number of hits collected before the first phase
+     * ranking program is evaluated for all of them. Only used when the
+     * first phase ranking program does not use match data, since the
+     * match data is overwritten by the unpacking of the next hit.
+     * The default value of 0 means that the batch size supported by
+     * the executors in the first phase ranking program that evaluate
+     * documents in batches is used, and that each hit is ranked when
+     * matched if there are no such executors.
+     **/
+    struct FirstPhaseBatchSize {
+        static const vespalib::string NAME;
+        static const uint32_t DEFAULT_VALUE;
+        static uint32_t lookup(const Properties &props);
+        static uint32_t lookup(const Properties &props, uint32_t defaultValue);
+    };
+
     /**
      * Property for the number of threads used per search.
      **/
@@ -283,6 +379,131 @@ namespace matching {
         static uint32_t lookup(const Properties &props);
         static uint32_t lookup(const Properties &props, uint32_t defaultValue);
     };
+    /**
+     * Property for the maximum number of NUMA nodes the docid space
+     * is partitioned across. The nodes and their cpus are read from
+     * the system topology; nodes beyond this number are folded onto
+     * the first ones. When the machine has more than one node, search
+     * threads take work from the node they are currently running on
+     * and only steal work from other nodes when their own node has no
+     * work left. 0 or 1 disables NUMA aware scheduling.
+     **/
+    struct NumNumaNodes {
+        static const vespalib::string NAME;
+        static const uint32_t DEFAULT_VALUE;
+        static uint32_t lookup(const Properties &props);
+        static uint32_t lookup(const Properties &props, uint32_t defaultValue);
+    };
+
+    /**
+     * Property for the maximum number of groups each search thread
+     * may create per grouping level. Each search thread builds a
+     * partial grouping tree for its own hits before the trees are
+     * merged, and this caps the memory used by each of them. Hits
+     * belonging to groups beyond the limit are not aggregated by that
+     * thread. 0 means no limit.
+     **/
+    struct MaxGroupsPerThread {
+        static const vespalib::string NAME;
+        static const uint32_t DEFAULT_VALUE;
+        static uint32_t lookup(const Properties &props);
+        static uint32_t lookup(const Properties &props, uint32_t defaultValue);
+    };
+
+    /**
+     * Property for approximate grouping. When larger than 0 and the
+     * estimated number of hits exceeds it, grouping only aggregates a
+     * deterministic sample of roughly this many hits. Counts and sums
+     * are scaled back up by the inverse sample rate, and the sample
+     * rate and error bound are reported in the query trace.
+     * 0 means exact grouping.
+     **/
+    struct ApproximateGroupingHits {
+        static const vespalib::string NAME;
+        static const uint32_t DEFAULT_VALUE;
+        static uint32_t lookup(const Properties &props);
+        static uint32_t lookup(const Properties &props, uint32_t defaultValue);
+    };
+
+    /**
+     * Property for sampled profiling of queries. When N is larger than
+     * 0, 1 in N queries using this rank profile are profiled and the
+     * time spent per iterator type and per feature executor is
+     * aggregated. 0 disables sampled profiling.
+     **/
+    struct ProfileSampleRate {
+        static const vespalib::string NAME;
+        static const uint32_t DEFAULT_VALUE;
+        static uint32_t lookup(const Properties &props);
+    };
+
+    /**
+     * Property to set up the rank profile when it is first used by a
+     * query instead of when the config is applied. Ranking constants
+     * and onnx models are then only loaded for rank profiles that are
+     * actually used. Rank profiles not set up lazily are set up
+     * eagerly, and are ready when the config has been applied.
+     **/
+    struct LazySetup {
+        static const vespalib::string NAME;
+        static const bool DEFAULT_VALUE;
+        static bool check(const Properties &props);
+    };
+
+    /**
+     * Property to enable caching of query results for a rank
+     * profile. This is the maximum number of results kept in the
+     * cache; 0 disables the result cache. Cached results are only
+     * used while the document meta store has seen no feed operations
+     * since the result was produced.
+     **/
+    struct ResultCacheMaxEntries {
+        static const vespalib::string NAME;
+        static const uint32_t DEFAULT_VALUE;
+        static uint32_t lookup(const Properties &props);
+    };
+
+    /**
+     * Property to bound the age (in seconds) of a cached query
+     * result, regardless of feed activity.
+     **/
+    struct ResultCacheMaxAge {
+        static const vespalib::string NAME;
+        static const double DEFAULT_VALUE;
+        static double lookup(const Properties &props);
+    };
+
+    /**
+     * Property to enable caching of global filters for a rank
+     * profile, shared by queries with the same query tree apart from
+     * the query tensors. This is the maximum number of bytes used by
+     * the cached filters; 0 disables the global filter cache.
+     **/
+    struct GlobalFilterCacheMaxBytes {
+        static const vespalib::string NAME;
+        static const uint64_t DEFAULT_VALUE;
+        static uint64_t lookup(const Properties &props);
+    };
+
+    /**
+     * Property for the minimum time (in seconds) spent calculating a
+     * global filter for it to be admitted in the global filter cache.
+     **/
+    struct GlobalFilterCacheMinCost {
+        static const vespalib::string NAME;
+        static const double DEFAULT_VALUE;
+        static double lookup(const Properties &props);
+    };
+
+    /**
+     * Property to bound the age (in seconds) of a cached global
+     * filter, regardless of feed activity.
+     **/
+    struct GlobalFilterCacheMaxAge {
+        static const vespalib::string NAME;
+        static const double DEFAULT_VALUE;
+        static double lookup(const Properties &props);
+    };
 
     /**
      * Property to control fallback to not building a global filter
@@ -327,6 +548,22 @@ namespace matching {
         static double lookup(const Properties &props, double defaultValue);
     };
 
+    /**
+     * Property to control when a nearestNeighbor search using HNSW index with pre-filtering
+     * uses filter-first exploration of the graph.
+     *
+     * If the ratio of documents matching the global filter is less than this threshold,
+     * the neighbors of nodes not matching the filter are also explored (ACORN-1 style),
+     * and the distance is only calculated for nodes matching the filter.
+     * The default value of 0.0 disables filter-first exploration.
+     **/
+    struct FilterFirstThreshold {
+        static const vespalib::string NAME;
+        static const double DEFAULT_VALUE;
+        static double lookup(const Properties &props);
+        static double lookup(const Properties &props, double defaultValue);
+    };
+
     /**
      * Property to control the algorithm using for fuzzy matching.
      **/
@@ -405,6 +642,19 @@ namespace matchphase {
         static vespalib::string lookup(const Properties &props, const vespalib::string & defaultValue);
     };
 
+    /**
+     * Property for using the attribute ranked by in first phase for
+     * graceful degradation during match phase, in descending order.
+     * Only used when no degradation attribute is given and first
+     * phase ranking is a single attribute, e.g. 'attribute(popularity)'.
+     **/
+    struct DegradationAttributeFromFirstPhase {
+        static const vespalib::string NAME;
+        static const bool DEFAULT_VALUE;
+        static bool lookup(const Properties &props) { return lookup(props, DEFAULT_VALUE); }
+        static bool lookup(const Properties &props, bool defaultValue);
+    };
+
     /**
      * Property for the order used for graceful degradation during match phase.
      **/
@@ -6,7 +6,15 @@ namespace search {
 namespace fef {
 
 MatchData::MatchData(const Params &cparams)
-    : _termFields(cparams.numTermFields()),
+    : _owned_term_fields(cparams.numTermFields()),
+      _termFields(_owned_term_fields),
+      _termwise_limit(1.0)
+{
+}
+
+MatchData::MatchData(vespalib::ArrayRef<TermFieldMatchData> term_fields)
+    : _owned_term_fields(),
+      _termFields(term_fields),
       _termwise_limit(1.0)
 {
 }
@@ -4,6 +4,7 @@
 
 #include "handle.h"
 #include "termfieldmatchdata.h"
+#include <vespa/vespalib/util/arrayref.h>
 #include <memory>
 #include <vector>
 
@@ -16,8 +17,9 @@ namespace search::fef {
 class MatchData
 {
 private:
-    std::vector<TermFieldMatchData> _termFields;
-    double                          _termwise_limit;
+    std::vector<TermFieldMatchData>        _owned_term_fields;
+    vespalib::ArrayRef<TermFieldMatchData> _termFields;
+    double                                 _termwise_limit;
 
 public:
     /**
@@ -58,6 +60,14 @@ public:
      **/
     explicit MatchData(const Params &cparams);
 
+    /**
+     * Create a new object using term field storage owned by someone
+     * else, typically a per query stash that outlives this object.
+     *
+     * @param term_fields storage for the term fields
+     **/
+    explicit MatchData(vespalib::ArrayRef<TermFieldMatchData> term_fields);
+
     /**
      * Reset this match data in such a way that it can be re-used with
      * either the same search iterator tree or with a new search
@@ -73,8 +83,9 @@ public:
     /**
      * A number in the range [0,1] indicating how much of the corpus
      * the query must match for termwise evaluation to be enabled. 1
-     * means never allowed. 0 means always allowed. The initial value
-     * is 1 (never). This value is used when creating a search
+     * means never allowed. 0 means always allowed. A negative value
+     * lets the flow statistics decide for each subtree. The initial
+     * value is 1 (never). This value is used when creating a search
      * (queryeval::Blueprint::createSearch).
      **/
     double get_termwise_limit() const { return _termwise_limit; }
@@ -1,6 +1,7 @@
 // Copyright Vespa.ai. Licensed under the terms of the Apache 2.0 license. See LICENSE in the project root.
 
 #include "matchdatalayout.h"
+#include <vespa/vespalib/util/stash.h>
 #include <cassert>
 
 namespace search::fef {
@@ -23,4 +24,14 @@ MatchDataLayout::createMatchData() const
     return md;
 }
 
+MatchData &
+MatchDataLayout::createMatchData(vespalib::Stash &stash) const
+{
+    auto &md = stash.create<MatchData>(stash.create_array<TermFieldMatchData>(_fieldIds.size()));
+    for (size_t i = 0; i < _fieldIds.size(); ++i) {
+        md.resolveTermField(i)->setFieldId(_fieldIds[i]);
+    }
+    return md;
+}
+
 }
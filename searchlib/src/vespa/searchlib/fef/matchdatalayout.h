@@ -5,6 +5,8 @@
 #include "handle.h"
 #include "matchdata.h"
 
+namespace vespalib { class Stash; }
+
 namespace search::fef {
 
 /**
@@ -46,6 +48,15 @@ public:
      * @return auto-pointer to a match data object
      **/
     MatchData::UP createMatchData() const;
+
+    /**
+     * Create a match data object with the layout described by this
+     * object in the given stash. The match data and its term fields
+     * are released together with the stash.
+     *
+     * @return reference to a match data object owned by the stash
+     **/
+    MatchData &createMatchData(vespalib::Stash &stash) const;
 };
 
 }
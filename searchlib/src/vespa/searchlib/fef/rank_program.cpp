@@ -6,12 +6,14 @@
 #include <vespa/vespalib/locale/c.h>
 #include <vespa/eval/eval/fast_value.h>
 #include <vespa/eval/eval/value_codec.h>
+#include <vespa/vespalib/stllike/hash_map.hpp>
 #include <vespa/vespalib/stllike/hash_set.hpp>
 #include <vespa/vespalib/util/size_literals.h>
 #include <vespa/vespalib/util/issue.h>
 #include <vespa/vespalib/util/execution_profiler.h>
 #include <algorithm>
 #include <cassert>
+#include <cstring>
 
 #include <vespa/log/log.h>
 LOG_SETUP(".fef.rankprogram");
@@ -102,6 +104,12 @@ struct UnboxingExecutor : FeatureExecutor {
     }
 };
 
+// Placeholder for a constant feature calculated by another rank program
+struct ReusedConstExecutor : FeatureExecutor {
+    bool isPure() override { return true; }
+    void execute(uint32_t) override {}
+};
+
 struct ProfiledExecutor : FeatureExecutor {
     ExecutionProfiler &profiler;
     FeatureExecutor &executor;
@@ -173,6 +181,24 @@ RankProgram::run_const(FeatureExecutor *executor)
     }
 }
 
+FeatureExecutor *
+RankProgram::reuse_const(const vespalib::string &name, vespalib::ArrayRef<NumberOrObject> outputs)
+{
+    if (_const_source == nullptr) {
+        return nullptr;
+    }
+    auto pos = _const_source->_const_features.find(name);
+    if ((pos == _const_source->_const_features.end()) || (pos->second.size() != outputs.size())) {
+        return nullptr;
+    }
+    for (size_t i = 0; i < outputs.size(); ++i) {
+        memcpy(outputs[i].as_bytes, pos->second[i].as_bytes, sizeof(outputs[i].as_bytes));
+        _is_const.insert(&outputs[i]);
+    }
+    ++_num_reused_constants;
+    return &_cold_stash.create<ReusedConstExecutor>();
+}
+
 void
 RankProgram::unbox(BlueprintResolver::FeatureRef seed, const MatchData &md)
 {
@@ -221,8 +247,13 @@ RankProgram::RankProgram(BlueprintResolver::SP resolver)
       _hot_stash(32_Ki),
       _cold_stash(),
       _executors(),
+      _batch_executors(),
+      _max_batch_size(0),
+      _num_reused_constants(0),
       _unboxed_seeds(),
-      _is_const()
+      _is_const(),
+      _const_features(),
+      _const_source(nullptr)
 {
 }
 
@@ -244,6 +275,14 @@ RankProgram::setup(const MatchData &md,
     _is_const.resize(specs.size()*2); // Reserve space in hashmap for executors to be const
     for (uint32_t i = 0; i < specs.size(); ++i) {
         vespalib::ArrayRef<NumberOrObject> outputs = _hot_stash.create_array<NumberOrObject>(specs[i].output_types.size());
+        bool has_override = (override < override_end) && (override->ref.executor == i);
+        if (FeatureExecutor *reused = has_override ? nullptr : reuse_const(specs[i].blueprint->getName(), outputs)) {
+            reused->bind_outputs(outputs);
+            reused->bind_match_data(md);
+            _executors.push_back(reused);
+            _const_features[specs[i].blueprint->getName()] = outputs;
+            continue;
+        }
         StashSelector stash(_hot_stash, _cold_stash);
         FeatureExecutor *executor = &(specs[i].blueprint->createExecutor(queryEnv, stash.get()));
         bool is_const = check_const(executor, specs[i].inputs);
@@ -252,6 +291,7 @@ RankProgram::setup(const MatchData &md,
             executor = &(specs[i].blueprint->createExecutor(queryEnv, stash.get()));
             is_const = executor->isPure();
         }
+        FeatureExecutor *batch_executor = (!is_const && (executor->max_batch_size() > 0)) ? executor : nullptr;
         size_t num_inputs = specs[i].inputs.size();
         vespalib::ArrayRef<LazyValue> inputs = stash.get().create_array<LazyValue>(num_inputs, nullptr);
         for (size_t input_idx = 0; input_idx < num_inputs; ++input_idx) {
@@ -266,6 +306,7 @@ RankProgram::setup(const MatchData &md,
         }
         for (; (override < override_end) && (override->ref.executor == i); ++override) {
             FeatureExecutor *tmp = executor;
+            batch_executor = nullptr;
             executor = &(stash.get().create<FeatureOverrider>(*tmp, override->ref.output, override->number, std::move(override->object)));
         }
         if (profiler) {
@@ -276,8 +317,15 @@ RankProgram::setup(const MatchData &md,
         executor->bind_outputs(outputs);
         executor->bind_match_data(md);
         _executors.push_back(executor);
+        if (batch_executor != nullptr) {
+            _batch_executors.push_back(batch_executor);
+            _max_batch_size = (_max_batch_size == 0)
+                              ? batch_executor->max_batch_size()
+                              : std::min(_max_batch_size, batch_executor->max_batch_size());
+        }
         if (is_const) {
             run_const(executor);
+            _const_features[specs[i].blueprint->getName()] = outputs;
         }
     }
     for (const auto &seed_entry: _resolver->getSeedMap()) {
@@ -287,8 +335,8 @@ RankProgram::setup(const MatchData &md,
         }
     }
     assert(_executors.size() == specs.size());
-    LOG(debug, "Num executors = %ld, hot stash = %ld, cold stash = %ld, match data fields = %d",
-               _executors.size(), _hot_stash.count_used(), _cold_stash.count_used(), md.getNumTermFields());
+    LOG(debug, "Num executors = %ld, reused constants = %ld, hot stash = %ld, cold stash = %ld, match data fields = %d",
+               _executors.size(), _num_reused_constants, _hot_stash.count_used(), _cold_stash.count_used(), md.getNumTermFields());
     if (LOG_WOULD_LOG(debug)) {
         vespalib::hash_map<vespalib::string, size_t> executorStats;
         for (const FeatureExecutor * executor : _executors) {
@@ -305,6 +353,22 @@ RankProgram::setup(const MatchData &md,
     }
 }
 
+void
+RankProgram::add_to_batch(uint32_t docid)
+{
+    for (FeatureExecutor *executor: _batch_executors) {
+        executor->add_to_batch(docid);
+    }
+}
+
+void
+RankProgram::execute_batch()
+{
+    for (FeatureExecutor *executor: _batch_executors) {
+        executor->execute_batch();
+    }
+}
+
 FeatureResolver
 RankProgram::get_seeds(bool unbox_seeds) const
 {
@@ -9,6 +9,7 @@
 #include "feature_resolver.h"
 #include <vespa/vespalib/stllike/string.h>
 #include <vespa/vespalib/util/stash.h>
+#include <vespa/vespalib/stllike/hash_map.h>
 #include <vespa/vespalib/stllike/hash_set.h>
 
 namespace vespalib { class ExecutionProfiler; }
@@ -33,17 +34,24 @@ private:
     using MappedValues = std::map<const NumberOrObject *, LazyValue>;
     using ValueSet = vespalib::hash_set<const NumberOrObject *, vespalib::hash<const NumberOrObject *>,
                                         std::equal_to<>, vespalib::hashtable_base::and_modulator>;
+    using ConstFeatures = vespalib::hash_map<vespalib::string, vespalib::ConstArrayRef<NumberOrObject>>;
 
     BlueprintResolver::SP            _resolver;
     vespalib::Stash                  _hot_stash;
     vespalib::Stash                  _cold_stash;
     std::vector<FeatureExecutor *>   _executors;
+    std::vector<FeatureExecutor *>   _batch_executors;
+    size_t                           _max_batch_size;
+    size_t                           _num_reused_constants;
     MappedValues                     _unboxed_seeds;
     ValueSet                         _is_const;
+    ConstFeatures                    _const_features;
+    const RankProgram               *_const_source;
 
     bool check_const(const NumberOrObject *value) const { return (_is_const.count(value) == 1); }
     bool check_const(FeatureExecutor *executor, const std::vector<BlueprintResolver::FeatureRef> &inputs) const;
     void run_const(FeatureExecutor *executor);
+    FeatureExecutor *reuse_const(const vespalib::string &name, vespalib::ArrayRef<NumberOrObject> outputs);
     void unbox(BlueprintResolver::FeatureRef seed, const MatchData &md);
     FeatureResolver resolve(const BlueprintResolver::FeatureMap &features, bool unbox_seeds) const;
 
@@ -60,7 +68,16 @@ public:
     RankProgram(BlueprintResolver::SP resolver);
     ~RankProgram();
 
+    /**
+     * Reuse the values of constant features calculated by another
+     * rank program set up earlier for the same query, instead of
+     * calculating them again. The other program must outlive this
+     * one. Must be called before setup.
+     **/
+    void reuse_constants_from(const RankProgram &other) { _const_source = &other; }
+
     size_t num_executors() const { return _executors.size(); }
+    size_t num_reused_constants() const { return _num_reused_constants; }
     const FeatureExecutor &get_executor(size_t i) const { return *_executors[i]; }
 
     /**
@@ -83,6 +100,28 @@ public:
      **/
     FeatureResolver get_seeds(bool unbox_seeds = true) const;
 
+    /**
+     * Obtain the max number of documents that can be added to a batch
+     * before calling execute_batch. Returns 0 if no executors in this
+     * program support batched evaluation.
+     **/
+    size_t max_batch_size() const { return _max_batch_size; }
+
+    /**
+     * Add a document to the current batch of all executors supporting
+     * batched evaluation. Posting information for the document must
+     * be unpacked before calling this function.
+     **/
+    void add_to_batch(uint32_t docid);
+
+    /**
+     * Evaluate the current batch of all executors supporting batched
+     * evaluation. After this, the documents in the batch must be
+     * evaluated as usual (with posting information unpacked) to
+     * obtain their feature values.
+     **/
+    void execute_batch();
+
     /**
      * Obtain the names and storage locations of all features for this
      * rank program. This method is intended for debugging and
@@ -6,6 +6,18 @@ using vespalib::eval::ConstantValue;
 
 namespace search::fef {
 
+namespace {
+
+template <typename T>
+bool same(const T *lhs, const T *rhs) {
+    if ((lhs == nullptr) || (rhs == nullptr)) {
+        return (lhs == rhs);
+    }
+    return (*lhs == *rhs);
+}
+
+}
+
 RankingAssetsRepo::RankingAssetsRepo(const ConstantValueFactory &factory,
                                      std::shared_ptr<const RankingConstants> constants,
                                      std::shared_ptr<const RankingExpressions> expressions,
@@ -40,4 +52,26 @@ RankingAssetsRepo::getOnnxModel(const vespalib::string &name) const {
     return _onnxModels ? _onnxModels->getModel(name) : nullptr;
 }
 
+bool
+RankingAssetsRepo::sameConstant(const vespalib::string &name, const RankingAssetsRepo &rhs) const
+{
+    return (&_factory == &rhs._factory) &&
+           same(_constants ? _constants->getConstant(name) : nullptr,
+                rhs._constants ? rhs._constants->getConstant(name) : nullptr);
+}
+
+bool
+RankingAssetsRepo::sameExpression(const vespalib::string &name, const RankingAssetsRepo &rhs) const
+{
+    return same(_rankingExpressions ? _rankingExpressions->getExpressionPath(name) : nullptr,
+                rhs._rankingExpressions ? rhs._rankingExpressions->getExpressionPath(name) : nullptr);
+}
+
+bool
+RankingAssetsRepo::sameOnnxModel(const vespalib::string &name, const RankingAssetsRepo &rhs) const
+{
+    return same(_onnxModels ? _onnxModels->getModel(name) : nullptr,
+                rhs._onnxModels ? rhs._onnxModels->getModel(name) : nullptr);
+}
+
 }
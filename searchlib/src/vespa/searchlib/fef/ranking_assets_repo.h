@@ -34,6 +34,15 @@ public:
     vespalib::eval::ConstantValue::UP getConstant(const vespalib::string &name) const override;
     vespalib::string getExpression(const vespalib::string &name) const override;
     const OnnxModel *getOnnxModel(const vespalib::string &name) const override;
+
+    /**
+     * Check whether the named asset resolves to the same configured asset
+     * (or is missing) in both this and the other repo. Used to decide
+     * whether rank setups using the asset can survive a reconfig.
+     */
+    bool sameConstant(const vespalib::string &name, const RankingAssetsRepo &rhs) const;
+    bool sameExpression(const vespalib::string &name, const RankingAssetsRepo &rhs) const;
+    bool sameOnnxModel(const vespalib::string &name, const RankingAssetsRepo &rhs) const;
 };
 
 }
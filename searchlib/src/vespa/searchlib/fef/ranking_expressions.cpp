@@ -34,6 +34,13 @@ RankingExpressions::add(const vespalib::string &name, const vespalib::string &pa
     return *this;
 }
 
+const vespalib::string *
+RankingExpressions::getExpressionPath(const vespalib::string &name) const
+{
+    auto pos = _expressions.find(name);
+    return (pos != _expressions.end()) ? &pos->second : nullptr;
+}
+
 vespalib::string
 RankingExpressions::loadExpression(const vespalib::string &name) const
 {
@@ -31,6 +31,7 @@ public:
     size_t size() const { return _expressions.size(); }
     RankingExpressions &add(const vespalib::string &name, const vespalib::string &path);
     vespalib::string loadExpression(const vespalib::string &name) const;
+    const vespalib::string *getExpressionPath(const vespalib::string &name) const;
 };
 
 }
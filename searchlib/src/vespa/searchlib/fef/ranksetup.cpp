@@ -7,6 +7,8 @@
 #include "idumpfeaturevisitor.h"
 #include <vespa/vespalib/util/stringfmt.h>
 #include <vespa/vespalib/stllike/asciistream.h>
+#include <vespa/vespalib/stllike/hash_set.h>
+#include <cassert>
 
 using vespalib::make_string_short::fmt;
 
@@ -27,6 +29,40 @@ namespace search::fef {
 
 using namespace indexproperties;
 
+namespace {
+
+/**
+ * Returns the name of the attribute if the given rank feature is
+ * just that attribute, possibly wrapped in a ranking expression
+ * consisting of nothing else. Returns an empty string otherwise.
+ **/
+vespalib::string
+single_attribute_rank_feature(vespalib::string feature, const Properties &props)
+{
+    for (size_t depth = 0; depth < 4; ++depth) {
+        FeatureNameParser parser(feature);
+        if (!parser.valid() || !parser.output().empty() || (parser.parameters().size() != 1)) {
+            return {};
+        }
+        if (parser.baseName() == "attribute") {
+            return parser.parameters()[0];
+        }
+        if (parser.baseName() != "rankingExpression") {
+            return {};
+        }
+        std::string script(props.lookup(feature, "rankingScript").get());
+        auto first = script.find_first_not_of(" \t\n");
+        auto last = script.find_last_not_of(" \t\n");
+        if (first == std::string::npos) {
+            return {};
+        }
+        feature = script.substr(first, last - first + 1);
+    }
+    return {};
+}
+
+} // namespace search::fef::<unnamed>
+
 RankSetup::RankSetup(const BlueprintFactory &factory, const IIndexEnvironment &indexEnv)
     : _factory(factory),
       _indexEnv(indexEnv),
@@ -39,9 +75,14 @@ RankSetup::RankSetup(const BlueprintFactory &factory, const IIndexEnvironment &i
       _secondPhaseRankFeature(),
       _degradationAttribute(),
       _termwise_limit(1.0),
+      _first_phase_batch_size(0),
       _numThreads(0),
       _minHitsPerThread(0),
       _numSearchPartitions(0),
+      _numNumaNodes(0),
+      _maxGroupsPerThread(0),
+      _approximateGroupingHits(0),
+      _summary_hits_per_task(0),
       _heapSize(0),
       _arraySize(0),
       _estimatePoint(0),
@@ -57,6 +98,7 @@ RankSetup::RankSetup(const BlueprintFactory &factory, const IIndexEnvironment &i
       _warnings(),
       _feature_rename_map(),
       _sort_blueprints_by_cost(false),
+      _precompute_summary_features(false),
       _ignoreDefaultRankFeatures(false),
       _compiled(false),
       _compileError(false),
@@ -71,6 +113,7 @@ RankSetup::RankSetup(const BlueprintFactory &factory, const IIndexEnvironment &i
       _global_filter_lower_limit(0.0),
       _global_filter_upper_limit(1.0),
       _target_hits_max_adjustment_factor(20.0),
+      _filter_first_threshold(0.0),
       _fuzzy_matching_algorithm(vespalib::FuzzyMatchingAlgorithm::DfaTable),
       _mutateOnMatch(),
       _mutateOnFirstPhase(),
@@ -93,6 +136,7 @@ RankSetup::configure()
     for (const auto & feature : summaryFeatures) {
         addSummaryFeature(feature);
     }
+    set_summary_hits_per_task(summary::HitsPerTask::lookup(_indexEnv.getProperties()));
     setIgnoreDefaultRankFeatures(dump::IgnoreDefaultFeatures::check(_indexEnv.getProperties()));
     std::vector<vespalib::string> dumpFeatures = dump::Feature::lookup(_indexEnv.getProperties());
     for (const auto & feature : dumpFeatures) {
@@ -102,9 +146,13 @@ RankSetup::configure()
         _feature_rename_map[rename.first] = rename.second;
     }
     set_termwise_limit(matching::TermwiseLimit::lookup(_indexEnv.getProperties()));
+    set_first_phase_batch_size(matching::FirstPhaseBatchSize::lookup(_indexEnv.getProperties()));
     setNumThreadsPerSearch(matching::NumThreadsPerSearch::lookup(_indexEnv.getProperties()));
     setMinHitsPerThread(matching::MinHitsPerThread::lookup(_indexEnv.getProperties()));
     setNumSearchPartitions(matching::NumSearchPartitions::lookup(_indexEnv.getProperties()));
+    setNumNumaNodes(matching::NumNumaNodes::lookup(_indexEnv.getProperties()));
+    setMaxGroupsPerThread(matching::MaxGroupsPerThread::lookup(_indexEnv.getProperties()));
+    setApproximateGroupingHits(matching::ApproximateGroupingHits::lookup(_indexEnv.getProperties()));
     setHeapSize(hitcollector::HeapSize::lookup(_indexEnv.getProperties()));
     setArraySize(hitcollector::ArraySize::lookup(_indexEnv.getProperties()));
     setDegradationAttribute(matchphase::DegradationAttribute::lookup(_indexEnv.getProperties()));
@@ -113,6 +161,10 @@ RankSetup::configure()
     setDegradationMaxFilterCoverage(matchphase::DegradationMaxFilterCoverage::lookup(_indexEnv.getProperties()));
     setDegradationSamplePercentage(matchphase::DegradationSamplePercentage::lookup(_indexEnv.getProperties()));
     setDegradationPostFilterMultiplier(matchphase::DegradationPostFilterMultiplier::lookup(_indexEnv.getProperties()));
+    if (_degradationAttribute.empty() && matchphase::DegradationAttributeFromFirstPhase::lookup(_indexEnv.getProperties())) {
+        setDegradationAttribute(single_attribute_rank_feature(_firstPhaseRankFeature, _indexEnv.getProperties()));
+        setDegradationOrderAscending(false);
+    }
     setDiversityAttribute(matchphase::DiversityAttribute::lookup(_indexEnv.getProperties()));
     setDiversityMinGroups(matchphase::DiversityMinGroups::lookup(_indexEnv.getProperties()));
     setDiversityCutoffFactor(matchphase::DiversityCutoffFactor::lookup(_indexEnv.getProperties()));
@@ -125,6 +177,7 @@ RankSetup::configure()
     set_global_filter_lower_limit(matching::GlobalFilterLowerLimit::lookup(_indexEnv.getProperties()));
     set_global_filter_upper_limit(matching::GlobalFilterUpperLimit::lookup(_indexEnv.getProperties()));
     set_target_hits_max_adjustment_factor(matching::TargetHitsMaxAdjustmentFactor::lookup(_indexEnv.getProperties()));
+    set_filter_first_threshold(matching::FilterFirstThreshold::lookup(_indexEnv.getProperties()));
     set_fuzzy_matching_algorithm(matching::FuzzyAlgorithm::lookup(_indexEnv.getProperties()));
     _mutateOnMatch._attribute = mutate::on_match::Attribute::lookup(_indexEnv.getProperties());
     _mutateOnMatch._operation = mutate::on_match::Operation::lookup(_indexEnv.getProperties());
@@ -136,6 +189,7 @@ RankSetup::configure()
     _mutateOnSummary._operation = mutate::on_summary::Operation::lookup(_indexEnv.getProperties());
     _mutateAllowQueryOverride = mutate::AllowQueryOverride::check(_indexEnv.getProperties());
     _sort_blueprints_by_cost = matching::SortBlueprintsByCost::check(_indexEnv.getProperties());
+    _precompute_summary_features = summary::PrecomputeFeatures::check(_indexEnv.getProperties());
     _always_mark_phrase_expensive = matching::AlwaysMarkPhraseExpensive::check(_indexEnv.getProperties());
 }
 
@@ -251,6 +305,56 @@ RankSetup::prepareSharedState(const IQueryEnvironment &queryEnv, IObjectStore &o
     }
 }
 
+vespalib::string
+RankSetup::dump_plan() const
+{
+    assert(_compiled);
+    vespalib::asciistream os;
+    vespalib::hash_set<vespalib::string> seen;
+    auto dump = [&](const char *program, const BlueprintResolver &resolver) {
+        const auto &specs = resolver.getExecutorSpecs();
+        if (specs.empty()) {
+            return;
+        }
+        size_t shared = 0;
+        for (const auto &spec : specs) {
+            if (seen.contains(spec.blueprint->getName())) {
+                ++shared;
+            }
+        }
+        os << program << ": " << specs.size() << " executors, " << shared << " shared\n";
+        for (size_t i = 0; i < specs.size(); ++i) {
+            const auto &name = specs[i].blueprint->getName();
+            os << "  #" << i << " " << name;
+            if (!specs[i].inputs.empty()) {
+                os << " <-";
+                for (const auto &input : specs[i].inputs) {
+                    os << " #" << input.executor;
+                    if (input.output != 0) {
+                        os << "." << input.output;
+                    }
+                }
+            }
+            if (!seen.insert(name).second) {
+                os << " (shared)";
+            }
+            os << "\n";
+        }
+        for (const auto &seed : resolver.getSeedMap()) {
+            os << "  seed " << seed.first << " = #" << seed.second.executor;
+            if (seed.second.output != 0) {
+                os << "." << seed.second.output;
+            }
+            os << "\n";
+        }
+    };
+    dump("first-phase", *_first_phase_resolver);
+    dump("second-phase", *_second_phase_resolver);
+    dump("match-features", *_match_resolver);
+    dump("summary-features", *_summary_resolver);
+    return os.str();
+}
+
 vespalib::string
 RankSetup::getJoinedWarnings() const {
     vespalib::asciistream os;
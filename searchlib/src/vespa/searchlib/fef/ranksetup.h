@@ -48,9 +48,14 @@ private:
     vespalib::string         _secondPhaseRankFeature;
     vespalib::string         _degradationAttribute;
     double                   _termwise_limit;
+    uint32_t                 _first_phase_batch_size;
     uint32_t                 _numThreads;
     uint32_t                 _minHitsPerThread;
     uint32_t                 _numSearchPartitions;
+    uint32_t                 _numNumaNodes;
+    uint32_t                 _maxGroupsPerThread;
+    uint32_t                 _approximateGroupingHits;
+    uint32_t                 _summary_hits_per_task;
     uint32_t                 _heapSize;
     uint32_t                 _arraySize;
     uint32_t                 _estimatePoint;
@@ -66,6 +71,7 @@ private:
     Warnings                 _warnings;
     StringStringMap          _feature_rename_map;
     bool                     _sort_blueprints_by_cost;
+    bool                     _precompute_summary_features;
     bool                     _ignoreDefaultRankFeatures;
     bool                     _compiled;
     bool                     _compileError;
@@ -80,6 +86,7 @@ private:
     double                   _global_filter_lower_limit;
     double                   _global_filter_upper_limit;
     double                   _target_hits_max_adjustment_factor;
+    double                   _filter_first_threshold;
     vespalib::FuzzyMatchingAlgorithm _fuzzy_matching_algorithm;
     MutateOperation          _mutateOnMatch;
     MutateOperation          _mutateOnFirstPhase;
@@ -149,7 +156,8 @@ public:
      *
      * The termwise limit is a number in the range [0,1] indicating
      * how much of the corpus the query must match for termwise
-     * evaluation to be enabled.
+     * evaluation to be enabled. A negative value lets the flow
+     * statistics of the query decide.
      *
      * @param value termwise limit
      **/
@@ -166,6 +174,22 @@ public:
      **/
     double get_termwise_limit() const { return _termwise_limit; }
 
+    /**
+     * Set the number of hits collected before first phase ranking is
+     * performed for all of them. 0 means that each hit is ranked when matched.
+     *
+     * @param value first phase batch size
+     **/
+    void set_first_phase_batch_size(uint32_t value) { _first_phase_batch_size = value; }
+
+    /**
+     * Get the number of hits collected before first phase ranking is
+     * performed for all of them.
+     *
+     * @return first phase batch size
+     **/
+    uint32_t get_first_phase_batch_size() const { return _first_phase_batch_size; }
+
     /**
      * Sets the number of threads per search.
      *
@@ -186,6 +210,18 @@ public:
 
     uint32_t getNumSearchPartitions() const { return _numSearchPartitions; }
 
+    void setNumNumaNodes(uint32_t numNumaNodes) { _numNumaNodes = numNumaNodes; }
+
+    uint32_t getNumNumaNodes() const { return _numNumaNodes; }
+
+    void setMaxGroupsPerThread(uint32_t maxGroupsPerThread) { _maxGroupsPerThread = maxGroupsPerThread; }
+
+    uint32_t getMaxGroupsPerThread() const { return _maxGroupsPerThread; }
+
+    void setApproximateGroupingHits(uint32_t approximateGroupingHits) { _approximateGroupingHits = approximateGroupingHits; }
+
+    uint32_t getApproximateGroupingHits() const { return _approximateGroupingHits; }
+
     /**
      * Sets the heap size to be used in the hit collector.
      *
@@ -316,6 +352,22 @@ public:
      **/
     uint32_t getEstimatePoint() const { return _estimatePoint; }
 
+    /**
+     * Sets the number of hits filled by each task when filling the
+     * docsums of a request in parallel. 0 means no parallel fill.
+     *
+     * @param value the number of hits per task
+     **/
+    void set_summary_hits_per_task(uint32_t value) { _summary_hits_per_task = value; }
+
+    /**
+     * Returns the number of hits filled by each task when filling the
+     * docsums of a request in parallel.
+     *
+     * @return the number of hits per task
+     **/
+    uint32_t get_summary_hits_per_task() const { return _summary_hits_per_task; }
+
     /**
      * Sets the estimate limit to be used in parallel query evaluation.
      *
@@ -400,6 +452,8 @@ public:
     double get_global_filter_upper_limit() const { return _global_filter_upper_limit; }
     void set_target_hits_max_adjustment_factor(double v) { _target_hits_max_adjustment_factor = v; }
     double get_target_hits_max_adjustment_factor() const { return _target_hits_max_adjustment_factor; }
+    void set_filter_first_threshold(double v) { _filter_first_threshold = v; }
+    double get_filter_first_threshold() const { return _filter_first_threshold; }
     void set_fuzzy_matching_algorithm(vespalib::FuzzyMatchingAlgorithm v) { _fuzzy_matching_algorithm = v; }
     vespalib::FuzzyMatchingAlgorithm get_fuzzy_matching_algorithm() const { return _fuzzy_matching_algorithm; }
 
@@ -436,6 +490,15 @@ public:
      */
     vespalib::string getJoinedWarnings() const;
 
+    /**
+     * Describe the execution plan of the compiled rank programs, with
+     * the executors of each program in evaluation order and their
+     * inputs. Executors also used by an earlier program are marked as
+     * shared; when constant for a query they are calculated only once
+     * (see RankProgram::reuse_constants_from). Intended for tooling.
+     **/
+    vespalib::string dump_plan() const;
+
     // These functions create rank programs for different tasks. Note
     // that the setup function must be called on rank programs for
     // them to be ready to use. Also keep in mind that creating a rank
@@ -447,6 +510,16 @@ public:
     RankProgram::UP create_summary_program() const { return std::make_unique<RankProgram>(_summary_resolver); }
     RankProgram::UP create_dump_program() const { return std::make_unique<RankProgram>(_dumpResolver); }
 
+    // Same as above, but the rank programs are owned by the given
+    // stash, releasing them together with everything else allocated
+    // for the query.
+
+    RankProgram &create_first_phase_program(vespalib::Stash &stash) const { return stash.create<RankProgram>(_first_phase_resolver); }
+    RankProgram &create_second_phase_program(vespalib::Stash &stash) const { return stash.create<RankProgram>(_second_phase_resolver); }
+    RankProgram &create_match_program(vespalib::Stash &stash) const { return stash.create<RankProgram>(_match_resolver); }
+    RankProgram &create_summary_program(vespalib::Stash &stash) const { return stash.create<RankProgram>(_summary_resolver); }
+    RankProgram &create_dump_program(vespalib::Stash &stash) const { return stash.create<RankProgram>(_dumpResolver); }
+
     /**
      * Here you can do some preprocessing. State must be stored in the IObjectStore.
      * This is called before creating multiple execution threads.
@@ -461,6 +534,7 @@ public:
 
     bool allowMutateQueryOverride() const { return _mutateAllowQueryOverride; }
     bool sort_blueprints_by_cost() const noexcept { return _sort_blueprints_by_cost; }
+    bool precompute_summary_features() const noexcept { return _precompute_summary_features; }
 };
 
 }
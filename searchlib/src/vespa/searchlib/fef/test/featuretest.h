@@ -108,6 +108,11 @@ public:
      */
     vespalib::eval::Value::CREF resolveObjectFeature(uint32_t docid = 1);
 
+    /**
+     * Obtain the underlying rank program. Only valid after a successful setup.
+     */
+    RankProgram &getRankProgram() { return *_rankProgram; }
+
 private:
     BlueprintFactory                       &_factory;
     const IndexEnvironment                 &_indexEnv;
@@ -107,6 +107,7 @@ public:
     bool executeOnly(search::fef::test::RankResult &result, uint32_t docId = 1)     { return _test.executeOnly(result, docId); }
     search::fef::test::MatchDataBuilder::UP createMatchDataBuilder()                { return _test.createMatchDataBuilder(); }
     vespalib::eval::Value::CREF resolveObjectFeature(uint32_t docid = 1) { return _test.resolveObjectFeature(docid); }
+    search::fef::RankProgram &getRankProgram()                                      { return _test.getRankProgram(); }
 
     FtIndexEnvironment &getIndexEnv() { return _indexEnv; }
     FtQueryEnvironment &getQueryEnv() { return _queryEnv; }
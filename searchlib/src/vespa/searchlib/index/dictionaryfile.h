@@ -62,6 +62,12 @@ public:
     virtual bool lookup(vespalib::stringref word, uint64_t &wordNum,
                         PostingListOffsetAndCounts &offsetAndCounts) = 0;
 
+    /**
+     * Find the first word in the dictionary that is not less than the given key.
+     * Returns false if all words are less than the key.
+     */
+    virtual bool findLowerBound(vespalib::stringref key, vespalib::string &word) = 0;
+
     /**
      * Open dictionary file for random read.
      */
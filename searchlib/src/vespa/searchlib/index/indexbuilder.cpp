@@ -11,4 +11,6 @@ IndexBuilder::IndexBuilder(const Schema &schema)
 
 IndexBuilder::~IndexBuilder() = default;
 
+FieldIndexBuilder::~FieldIndexBuilder() = default;
+
 }
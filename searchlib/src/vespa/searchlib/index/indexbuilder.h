@@ -2,6 +2,7 @@
 #pragma once
 
 #include <vespa/vespalib/stllike/string.h>
+#include <memory>
 
 namespace search::index {
 
@@ -10,12 +11,29 @@ class Schema;
 class WordDocElementWordPosFeatures;
 
 /**
- * Interface used to build an index for the set of index fields specified in a schema.
+ * Interface used to build the index for a single field.
  *
- * The index should be built as follows:
- *   For each field add the set of unique words in sorted order.
+ * The field index should be built as follows:
+ *   Add the set of unique words in sorted order.
  *   For each word add the set of document ids in sorted order.
  *   For each document id add the position information for that document.
+ *
+ * The field index is complete when the builder is destroyed.
+ */
+class FieldIndexBuilder {
+public:
+    virtual ~FieldIndexBuilder();
+    virtual void startWord(vespalib::stringref word) = 0;
+    virtual void endWord() = 0;
+    virtual void add_document(const DocIdAndFeatures &features) = 0;
+};
+
+/**
+ * Interface used to build an index for the set of index fields specified in a schema.
+ *
+ * Each field is built through its own field index builder. Builders for
+ * different fields may be used concurrently by different threads, but a
+ * field can only be started once.
  */
 class IndexBuilder {
 protected:
@@ -25,11 +43,7 @@ public:
     IndexBuilder(const Schema &schema);
 
     virtual ~IndexBuilder();
-    virtual void startField(uint32_t fieldId) = 0;
-    virtual void endField() = 0;
-    virtual void startWord(vespalib::stringref word) = 0;
-    virtual void endWord() = 0;
-    virtual void add_document(const DocIdAndFeatures &features) = 0;
+    virtual std::unique_ptr<FieldIndexBuilder> startField(uint32_t fieldId) = 0;
 };
 
 }
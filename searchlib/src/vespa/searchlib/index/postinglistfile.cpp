@@ -80,6 +80,13 @@ PostingListFileRandRead::afterOpen(FastOS_FileInterface &file)
     _memoryMapped = (file.MemoryMapPtr(0) != nullptr);
 }
 
+void
+PostingListFileRandRead::prefetchPostingList(uint64_t bitOffset, uint64_t bitLength) const
+{
+    (void) bitOffset;
+    (void) bitLength;
+}
+
 PostingListFileRandReadPassThrough::
 PostingListFileRandReadPassThrough(PostingListFileRandRead *lower,
                                    bool ownLower)
@@ -115,6 +122,12 @@ readPostingList(const PostingListCounts &counts,
     _lower->readPostingList(counts, firstSegment, numSegments,handle);
 }
 
+void
+PostingListFileRandReadPassThrough::prefetchPostingList(uint64_t bitOffset, uint64_t bitLength) const
+{
+    _lower->prefetchPostingList(bitOffset, bitLength);
+}
+
 bool
 PostingListFileRandReadPassThrough::open(const vespalib::string &name,
         const TuneFileRandRead &tuneFileRead)
@@ -163,6 +163,12 @@ public:
                     uint32_t numSegments,
                     PostingListHandle &handle) = 0;
 
+    /**
+     * Hint that the posting list at the given bit offset and length
+     * will be read soon. Default is to do nothing.
+     */
+    virtual void prefetchPostingList(uint64_t bitOffset, uint64_t bitLength) const;
+
     /**
      * Open posting list file for random read.
      */
@@ -202,6 +208,7 @@ public:
 
     void readPostingList(const PostingListCounts &counts, uint32_t firstSegment,
                          uint32_t numSegments, PostingListHandle &handle) override;
+    void prefetchPostingList(uint64_t bitOffset, uint64_t bitLength) const override;
 
     bool open(const vespalib::string &name, const TuneFileRandRead &tuneFileRead) override;
     bool close() override;
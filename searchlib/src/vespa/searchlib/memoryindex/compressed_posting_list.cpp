@@ -0,0 +1,87 @@
+// Copyright Vespa.ai. Licensed under the terms of the Apache 2.0 license. See LICENSE in the project root.
+
+#include "compressed_posting_list.h"
+#include <cassert>
+
+namespace search::memoryindex {
+
+using Format = CompressedPostingListFormat;
+
+template <bool interleaved_features>
+CompressedPostingListBuilder<interleaved_features>::CompressedPostingListBuilder()
+    : _entries(),
+      _skips(),
+      _block(),
+      _num_docs(0),
+      _prev_doc_id(0)
+{
+}
+
+template <bool interleaved_features>
+CompressedPostingListBuilder<interleaved_features>::~CompressedPostingListBuilder() = default;
+
+template <bool interleaved_features>
+void
+CompressedPostingListBuilder<interleaved_features>::clear()
+{
+    _entries.clear();
+    _skips.clear();
+    _block.clear();
+    _num_docs = 0;
+    _prev_doc_id = 0;
+}
+
+template <bool interleaved_features>
+void
+CompressedPostingListBuilder<interleaved_features>::add(uint32_t doc_id, vespalib::datastore::EntryRef features,
+                                                        uint16_t num_occs, uint16_t field_length)
+{
+    assert(doc_id > _prev_doc_id);
+    if ((_num_docs % Format::group_size) == 0) {
+        _skips.push_back(0);
+        _skips.push_back(_entries.size());
+    }
+    Format::write_varint(_entries, doc_id - _prev_doc_id);
+    size_t pos = _entries.size();
+    _entries.resize(pos + 4);
+    Format::write_u32(_entries.data() + pos, features.ref());
+    if constexpr (interleaved_features) {
+        Format::write_varint(_entries, num_occs);
+        Format::write_varint(_entries, field_length);
+    } else {
+        (void) num_occs;
+        (void) field_length;
+    }
+    _skips[_skips.size() - 2] = doc_id;
+    _prev_doc_id = doc_id;
+    ++_num_docs;
+}
+
+template <bool interleaved_features>
+const std::vector<uint8_t>&
+CompressedPostingListBuilder<interleaved_features>::finish()
+{
+    uint32_t num_skips = _skips.size() / Format::skip_entry_words;
+    uint32_t entries_offset = (Format::header_words + _skips.size()) * 4;
+    uint32_t unpadded_size = entries_offset + _entries.size();
+    uint32_t byte_size = (unpadded_size + 3) & ~3u;
+    _block.assign(byte_size, 0);
+    uint8_t* buf = _block.data();
+    Format::write_u32(buf, byte_size);
+    Format::write_u32(buf + 4, _num_docs);
+    Format::write_u32(buf + 8, num_skips);
+    for (uint32_t group = 0; group < num_skips; ++group) {
+        uint8_t* skip_entry = buf + (Format::header_words + group * Format::skip_entry_words) * 4;
+        Format::write_u32(skip_entry, _skips[group * Format::skip_entry_words]);
+        Format::write_u32(skip_entry + 4, entries_offset + _skips[group * Format::skip_entry_words + 1]);
+    }
+    if (!_entries.empty()) {
+        memcpy(buf + entries_offset, _entries.data(), _entries.size());
+    }
+    return _block;
+}
+
+template class CompressedPostingListBuilder<false>;
+template class CompressedPostingListBuilder<true>;
+
+}
@@ -0,0 +1,204 @@
+// Copyright Vespa.ai. Licensed under the terms of the Apache 2.0 license. See LICENSE in the project root.
+
+#pragma once
+
+#include <vespa/vespalib/datastore/entryref.h>
+#include <cstdint>
+#include <cstring>
+#include <limits>
+#include <vector>
+
+namespace search::memoryindex {
+
+/**
+ * Format of a compressed posting list block, used for the stable part of
+ * large posting lists in the memory index.
+ *
+ * Layout (all header fields are 32-bit):
+ *   - byte size of block (including header and padding)
+ *   - number of documents
+ *   - number of skip entries
+ *   - skip entries, one per group of 'group_size' documents: {last docid in group, byte offset of group}
+ *   - document entries: varint(docid delta), 32-bit features ref,
+ *     varint(num occs) and varint(field length) when interleaved features are used.
+ *
+ * The docid delta for the first entry in a group is relative to the last docid
+ * of the previous group (or 0 for the first group), allowing decoding to start
+ * at any group.
+ */
+struct CompressedPostingListFormat {
+    static constexpr uint32_t group_size = 64;
+    static constexpr uint32_t header_words = 3;
+    static constexpr uint32_t skip_entry_words = 2;
+    static constexpr uint32_t max_varint_bytes = 5;
+
+    static uint32_t read_u32(const uint8_t* buf) noexcept {
+        uint32_t val;
+        memcpy(&val, buf, sizeof(val));
+        return val;
+    }
+    static void write_u32(uint8_t* buf, uint32_t val) noexcept {
+        memcpy(buf, &val, sizeof(val));
+    }
+    static uint32_t read_varint(const uint8_t*& buf) noexcept {
+        uint32_t val = 0;
+        uint32_t shift = 0;
+        uint8_t byte;
+        do {
+            byte = *buf++;
+            val |= static_cast<uint32_t>(byte & 0x7f) << shift;
+            shift += 7;
+        } while ((byte & 0x80) != 0);
+        return val;
+    }
+    static void write_varint(std::vector<uint8_t>& buf, uint32_t val) {
+        while (val >= 0x80) {
+            buf.push_back(static_cast<uint8_t>(val | 0x80));
+            val >>= 7;
+        }
+        buf.push_back(static_cast<uint8_t>(val));
+    }
+    static uint32_t byte_size(const uint8_t* block) noexcept { return read_u32(block); }
+    static uint32_t num_docs(const uint8_t* block) noexcept { return read_u32(block + 4); }
+};
+
+/**
+ * Builds a compressed posting list block from entries added in docid order.
+ *
+ * The template parameter specifies whether interleaved features are stored.
+ */
+template <bool interleaved_features>
+class CompressedPostingListBuilder {
+    std::vector<uint8_t>  _entries;
+    std::vector<uint32_t> _skips;
+    std::vector<uint8_t>  _block;
+    uint32_t              _num_docs;
+    uint32_t              _prev_doc_id;
+public:
+    CompressedPostingListBuilder();
+    ~CompressedPostingListBuilder();
+    void clear();
+    void add(uint32_t doc_id, vespalib::datastore::EntryRef features, uint16_t num_occs, uint16_t field_length);
+    uint32_t num_docs() const noexcept { return _num_docs; }
+
+    /**
+     * Finish the block. The returned buffer is valid until the next call to clear().
+     * The buffer size is a multiple of 4 bytes.
+     */
+    const std::vector<uint8_t>& finish();
+};
+
+/**
+ * Lock-free reader for a compressed posting list block. Readers only need the
+ * block to be kept alive (by a generation guard), since blocks are never
+ * modified after being published.
+ */
+template <bool interleaved_features>
+class CompressedPostingListReader {
+    using Format = CompressedPostingListFormat;
+    const uint8_t* _block;
+    const uint8_t* _pos;
+    uint32_t       _num_docs;
+    uint32_t       _num_skips;
+    uint32_t       _index;
+    uint32_t       _doc_id;
+    vespalib::datastore::EntryRef _features;
+    uint16_t       _num_occs;
+    uint16_t       _field_length;
+
+    const uint8_t* skip_entry(uint32_t group) const noexcept {
+        return _block + (Format::header_words + group * Format::skip_entry_words) * 4;
+    }
+    uint32_t group_last_doc(uint32_t group) const noexcept { return Format::read_u32(skip_entry(group)); }
+    uint32_t group_offset(uint32_t group) const noexcept { return Format::read_u32(skip_entry(group) + 4); }
+
+    void decode() noexcept {
+        _doc_id += Format::read_varint(_pos);
+        _features = vespalib::datastore::EntryRef(Format::read_u32(_pos));
+        _pos += 4;
+        if constexpr (interleaved_features) {
+            _num_occs = Format::read_varint(_pos);
+            _field_length = Format::read_varint(_pos);
+        }
+    }
+
+public:
+    CompressedPostingListReader() noexcept
+        : _block(nullptr),
+          _pos(nullptr),
+          _num_docs(0),
+          _num_skips(0),
+          _index(0),
+          _doc_id(0),
+          _features(),
+          _num_occs(0),
+          _field_length(1)
+    {
+    }
+
+    void setup(const uint8_t* block) noexcept {
+        _block = block;
+        _num_docs = Format::num_docs(block);
+        _num_skips = Format::read_u32(block + 8);
+        _index = 0;
+        _doc_id = 0;
+        if (_num_docs > 0) {
+            _pos = _block + group_offset(0);
+            decode();
+        }
+    }
+    bool valid() const noexcept { return _index < _num_docs; }
+    uint32_t size() const noexcept { return _num_docs; }
+    uint32_t get_doc_id() const noexcept { return _doc_id; }
+    vespalib::datastore::EntryRef get_features() const noexcept { return _features; }
+    uint16_t get_num_occs() const noexcept { return _num_occs; }
+    uint16_t get_field_length() const noexcept { return _field_length; }
+
+    void next() noexcept {
+        if (++_index < _num_docs) {
+            decode();
+        }
+    }
+
+    /**
+     * Move forward to the first document with docid >= doc_id, using the skip
+     * entries to avoid decoding groups that cannot contain it.
+     */
+    void seek(uint32_t doc_id) noexcept {
+        if (!valid() || _doc_id >= doc_id) {
+            return;
+        }
+        uint32_t group = _index / Format::group_size;
+        if (group_last_doc(group) < doc_id) {
+            do {
+                ++group;
+            } while (group < _num_skips && group_last_doc(group) < doc_id);
+            if (group >= _num_skips) {
+                _index = _num_docs;
+                return;
+            }
+            _index = group * Format::group_size;
+            _pos = _block + group_offset(group);
+            _doc_id = group_last_doc(group - 1);
+            decode();
+        }
+        while (_doc_id < doc_id) {
+            next();
+        }
+    }
+
+    /**
+     * Check if the given document is present, without moving this reader.
+     */
+    bool contains(uint32_t doc_id) const noexcept {
+        CompressedPostingListReader reader(*this);
+        reader.setup(_block);
+        reader.seek(doc_id);
+        return reader.valid() && reader.get_doc_id() == doc_id;
+    }
+};
+
+extern template class CompressedPostingListBuilder<false>;
+extern template class CompressedPostingListBuilder<true>;
+
+}
@@ -0,0 +1,56 @@
+// Copyright Vespa.ai. Licensed under the terms of the Apache 2.0 license. See LICENSE in the project root.
+
+#include "compressed_posting_store.h"
+#include "compressed_posting_list.h"
+#include <vespa/vespalib/datastore/compacting_buffers.h>
+#include <vespa/vespalib/datastore/compaction_spec.h>
+#include <vespa/vespalib/datastore/compaction_strategy.h>
+#include <vespa/vespalib/datastore/datastore.hpp>
+
+namespace search::memoryindex {
+
+constexpr size_t MIN_BUFFER_ARRAYS = 1024u;
+
+using vespalib::datastore::CompactionSpec;
+using vespalib::datastore::CompactionStrategy;
+using vespalib::datastore::EntryRef;
+
+CompressedPostingStore::CompressedPostingStore()
+    : _store(),
+      _type(buffer_array_size, MIN_BUFFER_ARRAYS, RefType::offsetSize()),
+      _typeId(0)
+{
+    _store.addType(&_type);
+    _store.init_primary_buffers();
+}
+
+CompressedPostingStore::~CompressedPostingStore()
+{
+    _store.dropBuffers();
+}
+
+EntryRef
+CompressedPostingStore::add(const std::vector<uint8_t>& block)
+{
+    assert((block.size() % buffer_array_size) == 0);
+    auto result = _store.rawAllocator<uint8_t>(_typeId).alloc(block.size() / buffer_array_size);
+    memcpy(result.data, block.data(), block.size());
+    return result.ref;
+}
+
+void
+CompressedPostingStore::hold(EntryRef ref)
+{
+    uint32_t byte_size = CompressedPostingListFormat::byte_size(get(ref));
+    _store.hold_entries(ref, byte_size / buffer_array_size);
+}
+
+std::unique_ptr<vespalib::datastore::CompactingBuffers>
+CompressedPostingStore::start_compact()
+{
+    auto compaction_strategy = CompactionStrategy::make_compact_all_active_buffers_strategy();
+    CompactionSpec compaction_spec(true, false);
+    return _store.start_compact_worst_buffers(compaction_spec, compaction_strategy);
+}
+
+}
@@ -0,0 +1,54 @@
+// Copyright Vespa.ai. Licensed under the terms of the Apache 2.0 license. See LICENSE in the project root.
+
+#pragma once
+
+#include <vespa/vespalib/datastore/datastore.h>
+#include <vespa/vespalib/util/generationhandler.h>
+#include <vector>
+
+namespace vespalib::datastore { class CompactingBuffers; }
+
+namespace search::memoryindex {
+
+/**
+ * Class storing compressed posting list blocks (see CompressedPostingListFormat)
+ * in an underlying DataStore, using 32-bit refs to access blocks.
+ *
+ * Blocks are immutable after being added. A replaced block must be put on
+ * hold, and is freed when no reader can reference it anymore.
+ */
+class CompressedPostingStore {
+public:
+    using DataStoreType = vespalib::datastore::DataStoreT<vespalib::datastore::EntryRefT<22>>;
+    using RefType = DataStoreType::RefType;
+    using generation_t = vespalib::GenerationHandler::generation_t;
+    static constexpr uint32_t buffer_array_size = 4u; // Must be a power of 2
+
+private:
+    DataStoreType _store;
+    vespalib::datastore::BufferType<uint8_t> _type;
+    const uint32_t _typeId;
+
+public:
+    CompressedPostingStore();
+    ~CompressedPostingStore();
+
+    /**
+     * Add a block. The size of the block must be a multiple of buffer_array_size.
+     */
+    vespalib::datastore::EntryRef add(const std::vector<uint8_t>& block);
+
+    const uint8_t* get(vespalib::datastore::EntryRef ref) const {
+        RefType iRef(ref);
+        return _store.getEntryArray<uint8_t>(iRef, buffer_array_size);
+    }
+
+    void hold(vespalib::datastore::EntryRef ref);
+
+    void reclaim_memory(generation_t oldest_used_gen) { _store.reclaim_memory(oldest_used_gen); }
+    void assign_generation(generation_t current_gen) { _store.assign_generation(current_gen); }
+    std::unique_ptr<vespalib::datastore::CompactingBuffers> start_compact();
+    vespalib::MemoryUsage getMemoryUsage() const { return _store.getMemoryUsage(); }
+};
+
+}
@@ -5,6 +5,7 @@
 #include "i_field_index_collection.h"
 #include "field_inverter.h"
 #include "invert_task.h"
+#include "push_shard_task.h"
 #include "push_task.h"
 #include "remove_task.h"
 #include "url_field_inverter.h"
@@ -30,10 +31,21 @@ DocumentInverter::DocumentInverter(DocumentInverterContext& context)
     auto& schema = context.get_schema();
     auto& field_indexes = context.get_field_indexes();
     for (uint32_t fieldId = 0; fieldId < schema.getNumIndexFields(); ++fieldId) {
-        auto &remover(field_indexes.get_remover(fieldId));
-        auto &inserter(field_indexes.get_inserter(fieldId));
         auto &calculator(field_indexes.get_calculator(fieldId));
-        _inverters.push_back(std::make_unique<FieldInverter>(schema, fieldId, remover, inserter, calculator));
+        uint32_t num_shards = field_indexes.get_num_shards(fieldId);
+        if (num_shards > 1) {
+            std::vector<FieldIndexRemover *> removers;
+            std::vector<IOrderedFieldIndexInserter *> inserters;
+            for (uint32_t shard = 0; shard < num_shards; ++shard) {
+                removers.push_back(&field_indexes.get_shard_remover(fieldId, shard));
+                inserters.push_back(&field_indexes.get_shard_inserter(fieldId, shard));
+            }
+            _inverters.push_back(std::make_unique<FieldInverter>(schema, fieldId, removers, inserters, calculator));
+        } else {
+            auto &remover(field_indexes.get_remover(fieldId));
+            auto &inserter(field_indexes.get_inserter(fieldId));
+            _inverters.push_back(std::make_unique<FieldInverter>(schema, fieldId, remover, inserter, calculator));
+        }
     }
     auto& schema_index_fields = context.get_schema_index_fields();
     for (auto &urlField : schema_index_fields._uriFields) {
@@ -92,12 +104,27 @@ DocumentInverter::pushDocuments(OnWriteDoneType on_write_done)
 {
     auto retain = std::make_shared<RetainGuard>(_ref_count);
     using PushTasks = std::vector<std::shared_ptr<ScheduleSequencedTaskCallback>>;
-    PushTasks all_push_tasks;
+    std::vector<PushTasks> all_push_tasks;
     auto& push_threads = _context.get_push_threads();
     auto& push_contexts = _context.get_push_contexts();
     for (auto& push_context : push_contexts) {
+        auto& push_tasks = all_push_tasks.emplace_back();
         auto task = std::make_unique<PushTask>(push_context, _inverters, _urlInverters, on_write_done, retain);
-        all_push_tasks.emplace_back(std::make_shared<ScheduleSequencedTaskCallback>(push_threads, push_context.get_id(), std::move(task)));
+        push_tasks.emplace_back(std::make_shared<ScheduleSequencedTaskCallback>(push_threads, push_context.get_id(), std::move(task)));
+        // Each word shard of a sharded field index is pushed on its own executor.
+        for (auto field_id : push_context.get_fields()) {
+            auto& inverter = *_inverters[field_id];
+            uint32_t num_shards = inverter.get_num_shards();
+            if (num_shards == 1) {
+                continue;
+            }
+            auto sharded_push = std::make_shared<ShardedPush>(inverter, on_write_done, retain);
+            for (uint32_t shard_id = 0; shard_id < num_shards; ++shard_id) {
+                auto id = (shard_id == 0) ? push_context.get_id() : push_threads.get_alternate_executor_id(push_context.get_id(), shard_id);
+                auto shard_task = std::make_unique<PushShardTask>(sharded_push, shard_id);
+                push_tasks.emplace_back(std::make_shared<ScheduleSequencedTaskCallback>(push_threads, id, std::move(shard_task)));
+            }
+        }
     }
     auto& invert_threads = _context.get_invert_threads();
     auto& invert_contexts = _context.get_invert_contexts();
@@ -105,7 +132,8 @@ DocumentInverter::pushDocuments(OnWriteDoneType on_write_done)
         PushTasks push_tasks;
         for (auto& pusher : invert_context.get_pushers()) {
             assert(pusher < all_push_tasks.size());
-            push_tasks.emplace_back(all_push_tasks[pusher]);
+            auto& pusher_tasks = all_push_tasks[pusher];
+            push_tasks.insert(push_tasks.end(), pusher_tasks.begin(), pusher_tasks.end());
         }
         invert_threads.execute(invert_context.get_id(), [push_tasks(std::move(push_tasks))]() { });
     }
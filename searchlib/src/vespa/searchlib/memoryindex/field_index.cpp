@@ -6,7 +6,9 @@
 #include <vespa/searchlib/bitcompression/posocccompression.h>
 #include <vespa/searchlib/queryeval/booleanmatchiteratorwrapper.h>
 #include <vespa/searchlib/queryeval/blueprint.h>
+#include <vespa/searchlib/queryeval/flow_cost_table.h>
 #include <vespa/searchlib/queryeval/filter_wrapper.h>
+#include <vespa/searchlib/queryeval/fuzzy_term_expander.h>
 #include <vespa/searchlib/queryeval/searchiterator.h>
 #include <vespa/vespalib/btree/btree.hpp>
 #include <vespa/vespalib/btree/btreeiterator.hpp>
@@ -16,6 +18,7 @@
 #include <vespa/vespalib/btree/btreeroot.hpp>
 #include <vespa/vespalib/btree/btreestore.hpp>
 #include <vespa/vespalib/datastore/buffer_type.hpp>
+#include <vespa/vespalib/datastore/compacting_buffers.h>
 #include <vespa/vespalib/objects/visit.h>
 #include <vespa/vespalib/util/array.hpp>
 
@@ -46,7 +49,13 @@ template <bool interleaved_features>
 FieldIndex<interleaved_features>::FieldIndex(const index::Schema& schema, uint32_t fieldId,
                                              const index::FieldLengthInfo& info)
     : FieldIndexBase(schema, fieldId, info),
-      _postingListStore()
+      _postingListStore(),
+      _compressedStore(),
+      _compressedBuilder(),
+      _compressedAdds(),
+      _compressedRemoves(),
+      _compressMinDocs(0),
+      _hasCompressedBlocks(false)
 {
     using InserterType = OrderedFieldIndexInserter<interleaved_features>;
     _inserter = std::make_unique<InserterType>(*this);
@@ -105,6 +114,10 @@ void
 FieldIndex<interleaved_features>::compactFeatures()
 {
     auto compacting_buffers = _featureStore.start_compact();
+    std::unique_ptr<vespalib::datastore::CompactingBuffers> compacting_compressed_buffers;
+    if (_hasCompressedBlocks) {
+        compacting_compressed_buffers = _compressedStore.start_compact();
+    }
     auto itr = _dict.begin();
     uint32_t packedIndex = _fieldId;
     for (; itr.valid(); ++itr) {
@@ -118,6 +131,13 @@ FieldIndex<interleaved_features>::compactFeatures()
             auto pitr = tree->begin(_postingListStore.getAllocator());
             for (; pitr.valid(); ++pitr) {
                 const PostingListEntryType& posting_entry(pitr.getData());
+                if (pitr.getKey() == compressed_block_doc_id) {
+                    posting_entry.update_features(move_compressed_block(posting_entry.get_features_relaxed()));
+                    continue;
+                }
+                if (!posting_entry.get_features_relaxed().valid()) {
+                    continue; // Tombstone for document in compressed block
+                }
 
                 // Filter on which buffers to move features from when
                 // performing incremental compaction.
@@ -131,6 +151,13 @@ FieldIndex<interleaved_features>::compactFeatures()
             const PostingListKeyDataType *ite = shortArray + clusterSize;
             for (const PostingListKeyDataType *it = shortArray; it < ite; ++it) {
                 const PostingListEntryType& posting_entry(it->getData());
+                if (it->_key == compressed_block_doc_id) {
+                    posting_entry.update_features(move_compressed_block(posting_entry.get_features_relaxed()));
+                    continue;
+                }
+                if (!posting_entry.get_features_relaxed().valid()) {
+                    continue; // Tombstone for document in compressed block
+                }
 
                 // Filter on which buffers to move features from when
                 // performing incremental compaction.
@@ -143,59 +170,237 @@ FieldIndex<interleaved_features>::compactFeatures()
     }
     using generation_t = GenerationHandler::generation_t;
     compacting_buffers->finish();
+    if (compacting_compressed_buffers) {
+        compacting_compressed_buffers->finish();
+    }
     generation_t generation = _generationHandler.getCurrentGeneration();
     _featureStore.assign_generation(generation);
+    _compressedStore.assign_generation(generation);
+}
+
+template <bool interleaved_features>
+EntryRef
+FieldIndex<interleaved_features>::move_compressed_block(EntryRef block)
+{
+    CompressedPostingListReaderType reader;
+    reader.setup(_compressedStore.get(block));
+    _compressedBuilder.clear();
+    for (; reader.valid(); reader.next()) {
+        EntryRef newFeatures = _featureStore.moveFeatures(_fieldId, reader.get_features());
+        _compressedBuilder.add(reader.get_doc_id(), newFeatures, reader.get_num_occs(), reader.get_field_length());
+    }
+    return _compressedStore.add(_compressedBuilder.finish());
+}
+
+template <bool interleaved_features>
+EntryRef
+FieldIndex<interleaved_features>::get_compressed_block(EntryRef plist) const
+{
+    if (!_hasCompressedBlocks || !plist.valid()) {
+        return {};
+    }
+    auto itr = _postingListStore.begin(plist);
+    if (itr.valid() && itr.getKey() == compressed_block_doc_id) {
+        return itr.getData().get_features_relaxed();
+    }
+    return {};
+}
+
+template <bool interleaved_features>
+template <typename Func>
+void
+FieldIndex<interleaved_features>::for_each_posting(EntryRef plist, Func func) const
+{
+    auto itr = _postingListStore.begin(plist);
+    CompressedPostingListReaderType block;
+    if (itr.valid() && itr.getKey() == compressed_block_doc_id) {
+        block.setup(_compressedStore.get(itr.getData().get_features_relaxed()));
+        ++itr;
+    }
+    while (itr.valid() || block.valid()) {
+        if (itr.valid() && (!block.valid() || itr.getKey() <= block.get_doc_id())) {
+            if (block.valid() && itr.getKey() == block.get_doc_id()) {
+                block.next(); // Overridden by entry in B-Tree
+            }
+            const PostingListEntryType& entry(itr.getData());
+            if (entry.get_features_relaxed().valid()) {
+                func(itr.getKey(), entry.get_features_relaxed(), entry.get_num_occs(), entry.get_field_length());
+            }
+            ++itr;
+        } else {
+            func(block.get_doc_id(), block.get_features(), block.get_num_occs(), block.get_field_length());
+            block.next();
+        }
+    }
+}
+
+/*
+ * A posting list with a compressed block can be left with only tombstones
+ * for the documents in the block when all its documents have been removed.
+ */
+template <bool interleaved_features>
+bool
+FieldIndex<interleaved_features>::has_postings(EntryRef plist) const
+{
+    EntryRef block = get_compressed_block(plist);
+    if (!block.valid()) {
+        return plist.valid();
+    }
+    uint32_t num_tombstones = 0;
+    auto itr = _postingListStore.begin(plist);
+    for (++itr; itr.valid(); ++itr) {
+        if (itr.getData().get_features_relaxed().valid()) {
+            return true;
+        }
+        ++num_tombstones;
+    }
+    return CompressedPostingListFormat::num_docs(_compressedStore.get(block)) > num_tombstones;
+}
+
+template <bool interleaved_features>
+void
+FieldIndex<interleaved_features>::compress_posting_list(EntryRef& plist, EntryRef old_block)
+{
+    _compressedBuilder.clear();
+    for_each_posting(plist, [this](uint32_t doc_id, EntryRef features, uint16_t num_occs, uint16_t field_length) {
+        _compressedBuilder.add(doc_id, features, num_occs, field_length);
+    });
+    _compressedRemoves.clear();
+    for (auto itr = _postingListStore.begin(plist); itr.valid(); ++itr) {
+        _compressedRemoves.push_back(itr.getKey());
+    }
+    if (_compressedBuilder.num_docs() == 0) {
+        _postingListStore.apply(plist, nullptr, nullptr, _compressedRemoves.data(),
+                                _compressedRemoves.data() + _compressedRemoves.size());
+    } else {
+        EntryRef block = _compressedStore.add(_compressedBuilder.finish());
+        PostingListKeyDataType block_entry(compressed_block_doc_id, PostingListEntryType(block, 0, 0));
+        _postingListStore.apply(plist, &block_entry, &block_entry + 1, _compressedRemoves.data(),
+                                _compressedRemoves.data() + _compressedRemoves.size());
+        _hasCompressedBlocks = true;
+    }
+    if (old_block.valid()) {
+        _compressedStore.hold(old_block);
+    }
+}
+
+template <bool interleaved_features>
+void
+FieldIndex<interleaved_features>::apply_posting_list_changes(EntryRef& plist,
+                                                              vespalib::ConstArrayRef<PostingListKeyDataType> adds,
+                                                              vespalib::ConstArrayRef<uint32_t> removes)
+{
+    EntryRef block = get_compressed_block(plist);
+    if (!block.valid()) {
+        _postingListStore.apply(plist, adds.begin(), adds.end(), removes.begin(), removes.end());
+    } else {
+        // Documents in the compressed block are removed by adding tombstones.
+        CompressedPostingListReaderType reader;
+        reader.setup(_compressedStore.get(block));
+        _compressedAdds.clear();
+        auto add_itr = adds.begin();
+        for (uint32_t doc_id : removes) {
+            while (add_itr != adds.end() && add_itr->_key < doc_id) {
+                _compressedAdds.push_back(*add_itr++);
+            }
+            if (add_itr != adds.end() && add_itr->_key == doc_id) {
+                continue; // Added again, overriding the entry in the compressed block
+            }
+            reader.seek(doc_id);
+            if (reader.valid() && reader.get_doc_id() == doc_id) {
+                _compressedAdds.emplace_back(doc_id, PostingListEntryType());
+            }
+        }
+        while (add_itr != adds.end()) {
+            _compressedAdds.push_back(*add_itr++);
+        }
+        _postingListStore.apply(plist, _compressedAdds.data(), _compressedAdds.data() + _compressedAdds.size(),
+                                removes.begin(), removes.end());
+    }
+    if (_compressMinDocs == 0 || !plist.valid()) {
+        return;
+    }
+    size_t num_entries = _postingListStore.size(plist);
+    size_t num_block_docs = 0;
+    if (block.valid()) {
+        --num_entries;
+        num_block_docs = CompressedPostingListFormat::num_docs(_compressedStore.get(block));
+    }
+    // Recompressing when the B-Tree has grown by a fraction of the block keeps the amortized cost linear.
+    if (num_entries >= std::max(static_cast<size_t>(_compressMinDocs), num_block_docs / 4)) {
+        compress_posting_list(plist, block);
+    }
 }
 
 template <bool interleaved_features>
 void
-FieldIndex<interleaved_features>::dump(search::index::IndexBuilder & indexBuilder)
+FieldIndex<interleaved_features>::dump(search::index::FieldIndexBuilder& indexBuilder)
 {
     vespalib::stringref word;
     FeatureStore::DecodeContextCooked decoder(nullptr);
     DocIdAndFeatures features;
-    vespalib::Array<uint32_t> wordMap(_numUniqueWords + 1, 0);
     _featureStore.setupForField(_fieldId, decoder);
     for (auto itr = _dict.begin(); itr.valid(); ++itr) {
         const WordKey & wk = itr.getKey();
         typename PostingListStore::RefType plist(itr.getData().load_relaxed());
         word = _wordStore.getWord(wk._wordRef);
-        if (!plist.valid()) {
+        if (!has_postings(plist)) {
             continue;
         }
         indexBuilder.startWord(word);
-        uint32_t clusterSize = _postingListStore.getClusterSize(plist);
-        if (clusterSize == 0) {
-            const PostingList *tree = _postingListStore.getTreeEntry(plist);
-            auto pitr = tree->begin(_postingListStore.getAllocator());
-            assert(pitr.valid());
-            for (; pitr.valid(); ++pitr) {
-                features.set_doc_id(pitr.getKey());
-                const PostingListEntryType &entry(pitr.getData());
-                features.set_num_occs(entry.get_num_occs());
-                features.set_field_length(entry.get_field_length());
-                _featureStore.setupForReadFeatures(entry.get_features_relaxed(), decoder);
-                decoder.readFeatures(features);
-                indexBuilder.add_document(features);
-            }
-        } else {
-            const PostingListKeyDataType *kd =
-                _postingListStore.getKeyDataEntry(plist, clusterSize);
-            const PostingListKeyDataType *kde = kd + clusterSize;
-            for (; kd != kde; ++kd) {
-                features.set_doc_id(kd->_key);
-                const PostingListEntryType &entry(kd->getData());
-                features.set_num_occs(entry.get_num_occs());
-                features.set_field_length(entry.get_field_length());
-                _featureStore.setupForReadFeatures(entry.get_features_relaxed(), decoder);
-                decoder.readFeatures(features);
-                indexBuilder.add_document(features);
-            }
-        }
+        dump_posting_list(plist, decoder, features, indexBuilder);
         indexBuilder.endWord();
     }
 }
 
+template <bool interleaved_features>
+void
+FieldIndex<interleaved_features>::dump_posting_list(EntryRef plist_ref, FeatureStore::DecodeContextCooked& decoder,
+                                                    DocIdAndFeatures& features,
+                                                    search::index::FieldIndexBuilder& indexBuilder) const
+{
+    if (get_compressed_block(plist_ref).valid()) {
+        for_each_posting(plist_ref, [&](uint32_t doc_id, EntryRef features_ref, uint16_t num_occs, uint16_t field_length) {
+            features.set_doc_id(doc_id);
+            features.set_num_occs(num_occs);
+            features.set_field_length(field_length);
+            _featureStore.setupForReadFeatures(features_ref, decoder);
+            decoder.readFeatures(features);
+            indexBuilder.add_document(features);
+        });
+        return;
+    }
+    typename PostingListStore::RefType plist(plist_ref);
+    uint32_t clusterSize = _postingListStore.getClusterSize(plist);
+    if (clusterSize == 0) {
+        const PostingList *tree = _postingListStore.getTreeEntry(plist);
+        auto pitr = tree->begin(_postingListStore.getAllocator());
+        assert(pitr.valid());
+        for (; pitr.valid(); ++pitr) {
+            features.set_doc_id(pitr.getKey());
+            const PostingListEntryType &entry(pitr.getData());
+            features.set_num_occs(entry.get_num_occs());
+            features.set_field_length(entry.get_field_length());
+            _featureStore.setupForReadFeatures(entry.get_features_relaxed(), decoder);
+            decoder.readFeatures(features);
+            indexBuilder.add_document(features);
+        }
+    } else {
+        const PostingListKeyDataType *kd =
+            _postingListStore.getKeyDataEntry(plist, clusterSize);
+        const PostingListKeyDataType *kde = kd + clusterSize;
+        for (; kd != kde; ++kd) {
+            features.set_doc_id(kd->_key);
+            const PostingListEntryType &entry(kd->getData());
+            features.set_num_occs(entry.get_num_occs());
+            features.set_field_length(entry.get_field_length());
+            _featureStore.setupForReadFeatures(entry.get_features_relaxed(), decoder);
+            decoder.readFeatures(features);
+            indexBuilder.add_document(features);
+        }
+    }
+}
+
 template <bool interleaved_features>
 vespalib::MemoryUsage
 FieldIndex<interleaved_features>::getMemoryUsage() const
@@ -205,6 +410,7 @@ FieldIndex<interleaved_features>::getMemoryUsage() const
     usage.merge(_dict.getMemoryUsage());
     usage.merge(_postingListStore.getMemoryUsage());
     usage.merge(_featureStore.getMemoryUsage());
+    usage.merge(_compressedStore.getMemoryUsage());
     usage.merge(_remover.getStore().getMemoryUsage());
     return usage;
 }
@@ -216,7 +422,7 @@ FieldIndex<interleaved_features>::make_search_iterator(const vespalib::string& t
                                                        fef::TermFieldMatchDataArray match_data) const
 {
     return search::memoryindex::make_search_iterator<interleaved_features>
-            (find(term), getFeatureStore(), field_id, std::move(match_data));
+            (find(term), getFeatureStore(), _compressedStore, field_id, std::move(match_data));
 }
 
 namespace {
@@ -230,6 +436,7 @@ private:
     const queryeval::FieldSpec _field;
     PostingListIteratorType _posting_itr;
     const FeatureStore& _feature_store;
+    const CompressedPostingStore& _compressed_store;
     const uint32_t _field_id;
     const vespalib::string _query_term;
     const bool _use_bit_vector;
@@ -238,6 +445,7 @@ public:
     MemoryTermBlueprint(GenerationHandler::Guard&& guard,
                         PostingListIteratorType posting_itr,
                         const FeatureStore& feature_store,
+                        const CompressedPostingStore& compressed_store,
                         const queryeval::FieldSpec& field,
                         uint32_t field_id,
                         const vespalib::string& query_term,
@@ -247,31 +455,41 @@ public:
           _field(field),
           _posting_itr(posting_itr),
           _feature_store(feature_store),
+          _compressed_store(compressed_store),
           _field_id(field_id),
           _query_term(query_term),
           _use_bit_vector(use_bit_vector)
     {
         _guard = std::move(guard);
-        HitEstimate estimate(_posting_itr.size(), !_posting_itr.valid());
+        HitEstimate estimate(doc_count(), !_posting_itr.valid());
         setEstimate(estimate);
     }
 
+    size_t doc_count() const {
+        size_t count = _posting_itr.size();
+        if (_posting_itr.valid() && _posting_itr.getKey() == FieldIndexType::compressed_block_doc_id) {
+            auto block = _compressed_store.get(_posting_itr.getData().get_features());
+            count += CompressedPostingListFormat::num_docs(block) - 1;
+        }
+        return count;
+    }
+
     SearchIterator::UP createLeafSearch(const TermFieldMatchDataArray& tfmda, bool) const override {
-        auto result = make_search_iterator<interleaved_features>(_posting_itr, _feature_store, _field_id, tfmda);
+        auto result = make_search_iterator<interleaved_features>(_posting_itr, _feature_store, _compressed_store, _field_id, tfmda);
         if (_use_bit_vector) {
             LOG(debug, "Return BooleanMatchIteratorWrapper: field_id(%u), doc_count(%zu)",
-                _field_id, _posting_itr.size());
+                _field_id, doc_count());
             return std::make_unique<BooleanMatchIteratorWrapper>(std::move(result), tfmda);
         }
         LOG(debug, "Return PostingIterator: field_id(%u), doc_count(%zu)",
-            _field_id, _posting_itr.size());
+            _field_id, doc_count());
         return result;
     }
 
     SearchIterator::UP createFilterSearch(bool, FilterConstraint) const override {
         auto wrapper = std::make_unique<queryeval::FilterWrapper>(getState().numFields());
         auto & tfmda = wrapper->tfmda();
-        wrapper->wrap(make_search_iterator<interleaved_features>(_posting_itr, _feature_store, _field_id, tfmda));
+        wrapper->wrap(make_search_iterator<interleaved_features>(_posting_itr, _feature_store, _compressed_store, _field_id, tfmda));
         return wrapper;
     }
 
@@ -280,6 +498,10 @@ public:
         visit(visitor, "field_name", _field.getName());
         visit(visitor, "query_term", _query_term);
     }
+
+    const char *flow_cost_key() const noexcept override {
+        return queryeval::FlowCostTable::memory_term_key;
+    }
 };
 
 }
@@ -294,7 +516,33 @@ FieldIndex<interleaved_features>::make_term_blueprint(const vespalib::string& te
     auto posting_itr = findFrozen(term);
     bool use_bit_vector = field.isFilter();
     return std::make_unique<MemoryTermBlueprint<interleaved_features>>
-            (std::move(guard), posting_itr, getFeatureStore(), field, field_id, term, use_bit_vector);
+            (std::move(guard), posting_itr, getFeatureStore(), _compressedStore, field, field_id, term, use_bit_vector);
+}
+
+template <bool interleaved_features>
+void
+FieldIndex<interleaved_features>::expand_fuzzy_term(const queryeval::FuzzyTermExpander& expander,
+                                                    std::vector<vespalib::string>& words)
+{
+    auto guard = takeGenerationGuard();
+    auto frozen_view = _dict.getFrozenView();
+    typename DictionaryTree::ConstIterator itr;
+    bool positioned = false;
+    expander.expand([&](const std::string& key, vespalib::string& word) {
+                        // Keys are increasing, so the iterator only needs to seek forward after the first lookup
+                        if (positioned) {
+                            itr.seek(WordKey(EntryRef()), KeyComp(_wordStore, key));
+                        } else {
+                            itr = frozen_view.lowerBound(WordKey(EntryRef()), KeyComp(_wordStore, key));
+                            positioned = true;
+                        }
+                        if (!itr.valid()) {
+                            return false;
+                        }
+                        word = _wordStore.getWord(itr.getKey()._wordRef);
+                        return true;
+                    },
+                    [&](const vespalib::string& word) { words.push_back(word); });
 }
 
 template class FieldIndex<false>;
@@ -2,6 +2,8 @@
 
 #pragma once
 
+#include "compressed_posting_list.h"
+#include "compressed_posting_store.h"
 #include "field_index_base.h"
 #include "posting_list_entry.h"
 #include <vespa/searchlib/index/indexbuilder.h>
@@ -10,6 +12,7 @@
 #include <vespa/vespalib/btree/btreenodeallocator.h>
 #include <vespa/vespalib/btree/btreeroot.h>
 #include <vespa/vespalib/btree/btreestore.h>
+#include <vespa/vespalib/util/arrayref.h>
 
 namespace search::memoryindex {
 
@@ -25,6 +28,12 @@ class IOrderedFieldIndexInserter;
  *   - BTreeStore containing all the posting lists.
  *   - FeatureStore containing information on where a (word, document) pair matched this field.
  *     This information is unpacked and used during ranking.
+ *   - CompressedPostingStore containing compressed blocks for the stable part of large posting lists
+ *     (when enabled by set_posting_list_compression()).
+ *
+ * A posting list with a compressed block has an entry for the reserved docid 0, referencing the block
+ * instead of features. The remaining B-Tree entries override entries in the block for the same
+ * docid, and entries without features are tombstones for documents removed from the block.
  *
  * Elements in the three stores are accessed using 32-bit references / handles.
  *
@@ -43,9 +52,19 @@ public:
                                                std::less<uint32_t>,
                                                vespalib::btree::BTreeDefaultTraits>;
     using PostingListKeyDataType = typename PostingListStore::KeyDataType;
+    using CompressedPostingListReaderType = CompressedPostingListReader<interleaved_features>;
+
+    // Posting list entry referencing the compressed block of the posting list.
+    static constexpr uint32_t compressed_block_doc_id = 0;
 
 private:
     PostingListStore _postingListStore;
+    CompressedPostingStore _compressedStore;
+    CompressedPostingListBuilder<interleaved_features> _compressedBuilder;
+    std::vector<PostingListKeyDataType> _compressedAdds;
+    std::vector<uint32_t> _compressedRemoves;
+    uint32_t _compressMinDocs;
+    bool _hasCompressedBlocks;
 
     void freeze() {
         _postingListStore.freeze();
@@ -58,6 +77,7 @@ private:
         _postingListStore.reclaim_memory(oldest_used_gen);
         _dict.getAllocator().reclaim_memory(oldest_used_gen);
         _featureStore.reclaim_memory(oldest_used_gen);
+        _compressedStore.reclaim_memory(oldest_used_gen);
     }
 
     void assign_generation() {
@@ -66,12 +86,18 @@ private:
         _postingListStore.assign_generation(generation);
         _dict.getAllocator().assign_generation(generation);
         _featureStore.assign_generation(generation);
+        _compressedStore.assign_generation(generation);
     }
 
     void incGeneration() {
         _generationHandler.incGeneration();
     }
 
+    template <typename Func>
+    void for_each_posting(vespalib::datastore::EntryRef plist, Func func) const;
+    void compress_posting_list(vespalib::datastore::EntryRef& plist, vespalib::datastore::EntryRef old_block);
+    vespalib::datastore::EntryRef move_compressed_block(vespalib::datastore::EntryRef block);
+
 public:
     FieldIndex(const index::Schema& schema, uint32_t fieldId);
     FieldIndex(const index::Schema& schema, uint32_t fieldId, const index::FieldLengthInfo& info);
@@ -82,10 +108,43 @@ public:
 
     void compactFeatures() override;
 
-    void dump(search::index::IndexBuilder & indexBuilder) override;
+    void dump(search::index::FieldIndexBuilder& indexBuilder) override;
+
+    /**
+     * Dump the given posting list (for the current word) to the index builder.
+     */
+    void dump_posting_list(vespalib::datastore::EntryRef plist, FeatureStore::DecodeContextCooked& decoder,
+                           index::DocIdAndFeatures& features, search::index::FieldIndexBuilder& indexBuilder) const;
 
     vespalib::MemoryUsage getMemoryUsage() const override;
     PostingListStore &getPostingListStore() { return _postingListStore; }
+    const CompressedPostingStore& get_compressed_posting_store() const { return _compressedStore; }
+
+    /**
+     * Compress posting lists when at least min_docs entries have been added since
+     * the last compression of the posting list (0 disables compression).
+     * Must be set before any documents are inserted.
+     */
+    void set_posting_list_compression(uint32_t min_docs) override { _compressMinDocs = min_docs; }
+
+    /**
+     * Get the compressed block of the given posting list, or an invalid ref if it has none.
+     */
+    vespalib::datastore::EntryRef get_compressed_block(vespalib::datastore::EntryRef plist) const;
+
+    /**
+     * Returns true if the given posting list has documents, i.e. it is not empty
+     * and does not only have tombstones for the documents in its compressed block.
+     */
+    bool has_postings(vespalib::datastore::EntryRef plist) const;
+
+    /**
+     * Apply adds and removes (sorted on docid) for a word to the given posting list,
+     * compressing the posting list if it has grown enough.
+     */
+    void apply_posting_list_changes(vespalib::datastore::EntryRef& plist,
+                                    vespalib::ConstArrayRef<PostingListKeyDataType> adds,
+                                    vespalib::ConstArrayRef<uint32_t> removes);
 
     void commit() override {
         _remover.flush();
@@ -105,6 +164,9 @@ public:
     std::unique_ptr<queryeval::SimpleLeafBlueprint> make_term_blueprint(const vespalib::string& term,
                                                                         const queryeval::FieldSpec& field,
                                                                         uint32_t field_id) override;
+
+    void expand_fuzzy_term(const queryeval::FuzzyTermExpander& expander,
+                           std::vector<vespalib::string>& words) override;
 };
 
 }
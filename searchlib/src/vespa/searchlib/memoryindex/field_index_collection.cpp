@@ -3,6 +3,7 @@
 #include "field_index_collection.h"
 #include "field_inverter.h"
 #include "ordered_field_index_inserter.h"
+#include "sharded_field_index.h"
 #include <vespa/searchlib/bitcompression/posocccompression.h>
 #include <vespa/searchlib/index/i_field_length_inspector.h>
 #include <vespa/searchcommon/common/schema.h>
@@ -13,7 +14,11 @@
 #include <vespa/vespalib/btree/btreenodestore.hpp>
 #include <vespa/vespalib/btree/btreeroot.hpp>
 #include <vespa/vespalib/btree/btreestore.hpp>
+#include <vespa/vespalib/util/count_down_latch.h>
 #include <vespa/vespalib/util/exceptions.h>
+#include <vespa/vespalib/util/io_scheduler.h>
+#include <vespa/vespalib/util/lambdatask.h>
+#include <atomic>
 
 namespace search {
 
@@ -24,18 +29,46 @@ using index::WordDocElementFeatures;
 
 namespace memoryindex {
 
+namespace {
+
+template <bool interleaved_features>
+std::unique_ptr<IFieldIndex>
+make_field_index(const Schema& schema, uint32_t fieldId, const index::FieldLengthInfo& info, uint32_t num_shards,
+                 std::vector<IFieldIndex*>& shards)
+{
+    if (num_shards > 1) {
+        auto field_index = std::make_unique<ShardedFieldIndex<interleaved_features>>(schema, fieldId, info, num_shards);
+        for (uint32_t shard = 0; shard < num_shards; ++shard) {
+            shards.push_back(&field_index->get_shard_index(shard));
+        }
+        return field_index;
+    }
+    auto field_index = std::make_unique<FieldIndex<interleaved_features>>(schema, fieldId, info);
+    shards.push_back(field_index.get());
+    return field_index;
+}
+
+}
+
 FieldIndexCollection::FieldIndexCollection(const Schema& schema, const IFieldLengthInspector& inspector)
+    : FieldIndexCollection(schema, inspector, 1)
+{
+}
+
+FieldIndexCollection::FieldIndexCollection(const Schema& schema, const IFieldLengthInspector& inspector,
+                                           uint32_t num_shards)
     : _fieldIndexes(),
-      _numFields(schema.getNumIndexFields())
+      _numFields(schema.getNumIndexFields()),
+      _num_shards(std::max(1u, num_shards)),
+      _shards(_numFields)
 {
     for (uint32_t fieldId = 0; fieldId < _numFields; ++fieldId) {
         const auto& field = schema.getIndexField(fieldId);
+        auto info = inspector.get_field_length_info(field.getName());
         if (field.use_interleaved_features()) {
-            _fieldIndexes.push_back(std::make_unique<FieldIndex<true>>(schema, fieldId,
-                                                                       inspector.get_field_length_info(field.getName())));
+            _fieldIndexes.push_back(make_field_index<true>(schema, fieldId, info, _num_shards, _shards[fieldId]));
         } else {
-            _fieldIndexes.push_back(std::make_unique<FieldIndex<false>>(schema, fieldId,
-                                                                        inspector.get_field_length_info(field.getName())));
+            _fieldIndexes.push_back(make_field_index<false>(schema, fieldId, info, _num_shards, _shards[fieldId]));
         }
     }
 }
@@ -46,9 +79,43 @@ void
 FieldIndexCollection::dump(search::index::IndexBuilder &indexBuilder)
 {
     for (uint32_t fieldId = 0; fieldId < _numFields; ++fieldId) {
-        indexBuilder.startField(fieldId);
-        _fieldIndexes[fieldId]->dump(indexBuilder);
-        indexBuilder.endField();
+        auto fieldIndexBuilder = indexBuilder.startField(fieldId);
+        _fieldIndexes[fieldId]->dump(*fieldIndexBuilder);
+    }
+}
+
+void
+FieldIndexCollection::dump(search::index::IndexBuilder &indexBuilder, vespalib::Executor &executor,
+                           uint32_t max_concurrent_fields)
+{
+    // Each task dumps fields until there are no more, keeping at most
+    // max_concurrent_fields field index builders alive at the same time.
+    uint32_t num_tasks = std::min(std::max(max_concurrent_fields, 1u), _numFields);
+    std::atomic<uint32_t> next_field_id(0);
+    vespalib::CountDownLatch done(num_tasks);
+    auto io_class = vespalib::IoScheduler::MyClass::capture();
+    auto dump_fields = [this, &indexBuilder, &next_field_id, &done, io_class]() {
+        vespalib::IoScheduler::MyClass my_io_class(io_class);
+        for (uint32_t fieldId = next_field_id++; fieldId < _numFields; fieldId = next_field_id++) {
+            auto fieldIndexBuilder = indexBuilder.startField(fieldId);
+            _fieldIndexes[fieldId]->dump(*fieldIndexBuilder);
+        }
+        done.countDown();
+    };
+    for (uint32_t i = 0; i < num_tasks; ++i) {
+        auto rejected = executor.execute(vespalib::makeLambdaTask(dump_fields));
+        if (rejected) {
+            rejected->run();
+        }
+    }
+    done.await();
+}
+
+void
+FieldIndexCollection::set_posting_list_compression(uint32_t min_docs)
+{
+    for (auto &fieldIndex : _fieldIndexes) {
+        fieldIndex->set_posting_list_compression(min_docs);
     }
 }
 
@@ -80,5 +147,23 @@ FieldIndexCollection::get_calculator(uint32_t field_id)
     return _fieldIndexes[field_id]->get_calculator();
 }
 
+uint32_t
+FieldIndexCollection::get_num_shards(uint32_t) const
+{
+    return _num_shards;
+}
+
+FieldIndexRemover &
+FieldIndexCollection::get_shard_remover(uint32_t field_id, uint32_t shard)
+{
+    return _shards[field_id][shard]->getDocumentRemover();
+}
+
+IOrderedFieldIndexInserter &
+FieldIndexCollection::get_shard_inserter(uint32_t field_id, uint32_t shard)
+{
+    return _shards[field_id][shard]->getInserter();
+}
+
 }
 }
@@ -9,8 +9,10 @@
 
 namespace search::index {
     class IFieldLengthInspector;
+    class IndexBuilder;
     class Schema;
 }
+namespace vespalib { class Executor; }
 
 namespace search::memoryindex {
 
@@ -29,9 +31,17 @@ private:
 
     std::vector<std::unique_ptr<IFieldIndex>> _fieldIndexes;
     const uint32_t                _numFields;
+    const uint32_t                _num_shards;
+    // Per field, the field indexes owning the word shards.
+    std::vector<std::vector<IFieldIndex*>> _shards;
 
 public:
     FieldIndexCollection(const index::Schema& schema, const index::IFieldLengthInspector& inspector);
+    /*
+     * With num_shards > 1 the words of each field are spread over num_shards
+     * field indexes (see ShardedFieldIndex).
+     */
+    FieldIndexCollection(const index::Schema& schema, const index::IFieldLengthInspector& inspector, uint32_t num_shards);
     ~FieldIndexCollection() override;
 
     uint64_t getNumUniqueWords() const {
@@ -43,6 +53,14 @@ public:
     }
 
     void dump(search::index::IndexBuilder & indexBuilder);
+    /*
+     * Dump up to max_concurrent_fields fields at the same time using the
+     * given executor. Each field being dumped holds its own write buffers,
+     * so the limit bounds the memory used.
+     */
+    void dump(search::index::IndexBuilder & indexBuilder, vespalib::Executor & executor, uint32_t max_concurrent_fields);
+
+    void set_posting_list_compression(uint32_t min_docs);
 
     vespalib::MemoryUsage getMemoryUsage() const;
 
@@ -57,6 +75,9 @@ public:
     FieldIndexRemover &get_remover(uint32_t field_id) override;
     IOrderedFieldIndexInserter &get_inserter(uint32_t field_id) override;
     index::FieldLengthCalculator &get_calculator(uint32_t field_id) override;
+    uint32_t get_num_shards(uint32_t field_id) const override;
+    FieldIndexRemover &get_shard_remover(uint32_t field_id, uint32_t shard) override;
+    IOrderedFieldIndexInserter &get_shard_inserter(uint32_t field_id, uint32_t shard) override;
 };
 
 }
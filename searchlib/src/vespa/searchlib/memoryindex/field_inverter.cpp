@@ -1,7 +1,9 @@
 // Copyright Vespa.ai. Licensed under the terms of the Apache 2.0 license. See LICENSE in the project root.
 
 #include "field_inverter.h"
+#include "field_index_remover.h"
 #include "ordered_field_index_inserter.h"
+#include "sharded_field_index.h"
 #include <vespa/document/annotation/annotation.h>
 #include <vespa/document/annotation/span.h>
 #include <vespa/document/fieldvalue/arrayfieldvalue.h>
@@ -261,12 +263,46 @@ FieldInverter::FieldInverter(const Schema &schema, uint32_t fieldId,
       _removeDocs(),
       _remover(remover),
       _inserter(inserter),
-      _calculator(calculator)
+      _calculator(calculator),
+      _shards(),
+      _word_shards(),
+      _word_starts()
 {
 }
 
+FieldInverter::FieldInverter(const Schema &schema, uint32_t fieldId,
+                             const std::vector<FieldIndexRemover *> &removers,
+                             const std::vector<IOrderedFieldIndexInserter *> &inserters,
+                             index::FieldLengthCalculator &calculator)
+    : FieldInverter(schema, fieldId, *removers[0], *inserters[0], calculator)
+{
+    assert(removers.size() == inserters.size());
+    if (removers.size() > 1) {
+        _shards.reserve(removers.size());
+        for (size_t i = 0; i < removers.size(); ++i) {
+            _shards.push_back(std::make_unique<Shard>(*removers[i], *inserters[i]));
+        }
+    }
+}
+
 FieldInverter::~FieldInverter() = default;
 
+FieldInverter::Shard::Shard(FieldIndexRemover &remover, IOrderedFieldIndexInserter &inserter)
+    : _remover(remover),
+      _inserter(inserter),
+      _features(),
+      _removes()
+{
+}
+
+FieldInverter::Shard::~Shard() = default;
+
+void
+FieldInverter::Shard::remove(const vespalib::stringref word, uint32_t docId)
+{
+    _removes.emplace_back(word, docId);
+}
+
 void
 FieldInverter::abortPendingDoc(uint32_t docId)
 {
@@ -404,6 +440,9 @@ struct FullRadix {
 void
 FieldInverter::applyRemoves()
 {
+    if (!_shards.empty()) {
+        return; // Applied per shard by push_shard()
+    }
     for (auto docId : _removeDocs) {
         _remover.remove(docId, *this);
     }
@@ -497,18 +536,165 @@ FieldInverter::push_documents_internal()
     reset();
 }
 
+void
+FieldInverter::rethrow_overflow(const vespalib::OverflowException &e, const char *func) const
+{
+    const Schema::IndexField &field = _schema.getIndexField(_fieldId);
+    vespalib::asciistream s;
+    s << "FieldInverter::" << func << "(), caught exception for field " << field.getName();
+    throw vespalib::OverflowException(s.c_str(), e);
+}
+
 void
 FieldInverter::pushDocuments()
 {
+    if (!_shards.empty()) {
+        prepare_sharded_push();
+        for (uint32_t shard_id = 0; shard_id < _shards.size(); ++shard_id) {
+            push_shard(shard_id);
+        }
+        finish_sharded_push();
+        return;
+    }
     try {
         push_documents_internal();
     } catch (vespalib::OverflowException &e) {
-        const Schema::IndexField &field = _schema.getIndexField(_fieldId);
-        vespalib::asciistream s;
-        s << "FieldInverter::pushDocuments(), caught exception for field " << field.getName();
-        throw vespalib::OverflowException(s.c_str(), e);
+        rethrow_overflow(e, "pushDocuments");
     }
 }
 
+void
+FieldInverter::prepare_sharded_push()
+{
+    assert(!_shards.empty());
+    trimAbortedDocs();
+    _word_shards.clear();
+    _word_starts.clear();
+    if (_positions.empty()) {
+        return;             // Only removes
+    }
+    sortWords();
+    ShiftBasedRadixSorter<PosInfo, FullRadix, std::less<PosInfo>, 56, true>::
+        radix_sort(FullRadix(), std::less<PosInfo>(), &_positions[0], _positions.size(), 16);
+    uint32_t num_words = _wordRefs.size() - 1;
+    _word_shards.resize(num_words + 1);
+    _word_starts.resize(num_words + 2);
+    for (uint32_t word_num = 1; word_num <= num_words; ++word_num) {
+        _word_shards[word_num] = get_word_shard(getWordFromNum(word_num), _shards.size());
+    }
+    uint32_t pos_idx = 0;
+    for (uint32_t word_num = 1; word_num <= num_words + 1; ++word_num) {
+        while (pos_idx < _positions.size() && _positions[pos_idx]._wordNum < word_num) {
+            ++pos_idx;
+        }
+        _word_starts[word_num] = pos_idx;
+    }
 }
 
+FieldInverter::PosInfoVec::const_iterator
+FieldInverter::add_doc_features(Shard &shard, PosInfoVec::const_iterator itr, PosInfoVec::const_iterator end)
+{
+    constexpr uint32_t NO_ELEMENT_ID = std::numeric_limits<uint32_t>::max();
+    constexpr uint32_t NO_WORD_POS = std::numeric_limits<uint32_t>::max();
+    uint32_t doc_id = itr->_docId;
+    auto &features = shard._features;
+    features.clear(doc_id);
+    features.set_field_length(_elems[itr->_elemRef].get_field_length());
+    uint32_t last_elem_id = NO_ELEMENT_ID;
+    uint32_t last_word_pos = NO_WORD_POS;
+    for (; itr != end && itr->_docId == doc_id; ++itr) {
+        const ElemInfo &elem = _elems[itr->_elemRef];
+        if (itr->_wordPos != last_word_pos || itr->_elemId != last_elem_id) {
+            features.addNextOcc(itr->_elemId, itr->_wordPos, elem._weight, elem._len);
+            last_elem_id = itr->_elemId;
+            last_word_pos = itr->_wordPos;
+        } else {
+            // silently ignore duplicate annotations
+        }
+    }
+    features.set_num_occs(features.word_positions().size());
+    shard._inserter.add(doc_id, features);
+    return itr;
+}
+
+void
+FieldInverter::push_shard_internal(uint32_t shard_id)
+{
+    auto &shard = *_shards[shard_id];
+    auto &removes = shard._removes;
+    for (auto docId : _removeDocs) {
+        shard._remover.remove(docId, shard);
+    }
+    std::sort(removes.begin(), removes.end(), [](const auto &lhs, const auto &rhs) {
+        int cmpres = strcmp(lhs.first.data(), rhs.first.data());
+        return (cmpres != 0) ? (cmpres < 0) : (lhs.second < rhs.second);
+    });
+    removes.erase(std::unique(removes.begin(), removes.end()), removes.end());
+
+    auto &inserter = shard._inserter;
+    inserter.rewind();
+    uint32_t num_words = _word_shards.empty() ? 0u : (_word_shards.size() - 1);
+    auto next_word_num = [&](uint32_t word_num) {
+        while (word_num <= num_words && _word_shards[word_num] != shard_id) {
+            ++word_num;
+        }
+        return word_num;
+    };
+    uint32_t word_num = next_word_num(1);
+    auto rem_itr = removes.cbegin();
+    auto rem_end = removes.cend();
+    while (word_num <= num_words || rem_itr != rem_end) {
+        const char *add_word = (word_num <= num_words) ? getWordFromNum(word_num) : nullptr;
+        int cmpres = (add_word == nullptr) ? 1 : ((rem_itr == rem_end) ? -1 : strcmp(add_word, rem_itr->first.data()));
+        auto word_rem_end = rem_itr;
+        if (cmpres >= 0) {
+            inserter.setNextWord(rem_itr->first);
+            while (word_rem_end != rem_end && word_rem_end->first == rem_itr->first) {
+                ++word_rem_end;
+            }
+        } else {
+            inserter.setNextWord(add_word);
+        }
+        auto pos_itr = _positions.cbegin();
+        auto pos_end = pos_itr;
+        if (cmpres <= 0) {
+            pos_end = _positions.cbegin() + _word_starts[word_num + 1];
+            pos_itr += _word_starts[word_num];
+        }
+        // Removes must come before adds for the same document.
+        while (pos_itr != pos_end || rem_itr != word_rem_end) {
+            if (rem_itr != word_rem_end && (pos_itr == pos_end || rem_itr->second <= pos_itr->_docId)) {
+                inserter.remove(rem_itr->second);
+                ++rem_itr;
+            } else {
+                pos_itr = add_doc_features(shard, pos_itr, pos_end);
+            }
+        }
+        if (cmpres <= 0) {
+            word_num = next_word_num(word_num + 1);
+        }
+    }
+    inserter.flush();
+    inserter.commit();
+    removes.clear();
+}
+
+void
+FieldInverter::push_shard(uint32_t shard_id)
+{
+    try {
+        push_shard_internal(shard_id);
+    } catch (vespalib::OverflowException &e) {
+        rethrow_overflow(e, "push_shard");
+    }
+}
+
+void
+FieldInverter::finish_sharded_push()
+{
+    _word_shards.clear();
+    _word_starts.clear();
+    reset();
+}
+
+}
@@ -9,6 +9,7 @@
 #include <vespa/vespalib/stllike/allocator.h>
 #include <vespa/vespalib/stllike/hash_map.h>
 #include <limits>
+#include <memory>
 
 namespace search::index {
     class FieldLengthCalculator;
@@ -22,6 +23,8 @@ namespace document {
     class ArrayFieldValue;
     class WeightedSetFieldValue;
 }
+namespace vespalib { class OverflowException; }
+
 namespace search::memoryindex {
 
 class IOrderedFieldIndexInserter;
@@ -193,6 +196,29 @@ private:
     IOrderedFieldIndexInserter       &_inserter;
     index::FieldLengthCalculator     &_calculator;
 
+    /*
+     * State for pushing to one word shard of a sharded field index.
+     * The removes for the shard are collected here, since the
+     * remover of the shard reports the words to remove.
+     */
+    class Shard : public IFieldIndexRemoveListener {
+    public:
+        using WordDocId = std::pair<vespalib::stringref, uint32_t>;
+        FieldIndexRemover             &_remover;
+        IOrderedFieldIndexInserter    &_inserter;
+        index::DocIdAndPosOccFeatures  _features;
+        std::vector<WordDocId>         _removes;
+
+        Shard(FieldIndexRemover &remover, IOrderedFieldIndexInserter &inserter);
+        ~Shard() override;
+        void remove(const vespalib::stringref word, uint32_t docId) override;
+    };
+
+    std::vector<std::unique_ptr<Shard>> _shards;
+    // Shard and first position for each word number, set up by prepare_sharded_push().
+    UInt32Vector                        _word_shards;
+    UInt32Vector                        _word_starts;
+
     void invertNormalDocTextField(const document::FieldValue &val, const document::Document& doc);
 
 public:
@@ -249,6 +275,7 @@ public:
     processAnnotations(const document::StringFieldValue &value, const document::Document& doc);
 
     void push_documents_internal();
+    void push_shard_internal(uint32_t shard_id);
 
 private:
     void processNormalDocTextField(const document::StringFieldValue &field, const document::Document& doc);
@@ -276,6 +303,9 @@ private:
      */
     void abortPendingDoc(uint32_t docId);
 
+    PosInfoVec::const_iterator add_doc_features(Shard &shard, PosInfoVec::const_iterator itr, PosInfoVec::const_iterator end);
+    void rethrow_overflow(const vespalib::OverflowException &e, const char *func) const;
+
 public:
     /**
      * Create a new field inverter for the given fieldId, using the given schema.
@@ -284,6 +314,15 @@ public:
                   FieldIndexRemover &remover,
                   IOrderedFieldIndexInserter &inserter,
                   index::FieldLengthCalculator &calculator);
+    /**
+     * Create a new field inverter for the given fieldId, pushing to a field index
+     * sharded by word hash (see ShardedFieldIndex). There is one remover and
+     * one inserter per shard, and shard 0 is used by applyRemoves() and pushDocuments().
+     */
+    FieldInverter(const index::Schema &schema, uint32_t fieldId,
+                  const std::vector<FieldIndexRemover *> &removers,
+                  const std::vector<IOrderedFieldIndexInserter *> &inserters,
+                  index::FieldLengthCalculator &calculator);
     FieldInverter(const FieldInverter &) = delete;
     FieldInverter(const FieldInverter &&) = delete;
     FieldInverter &operator=(const FieldInverter &) = delete;
@@ -295,6 +334,8 @@ public:
      *
      * The remover is tracking all {word, docId} tuples that should removed,
      * and forwards this to the remove() function in this class (via IFieldIndexRemoveListener interface).
+     *
+     * For a sharded field index the removes are instead applied per shard by pushDocuments().
      */
     void applyRemoves();
 
@@ -303,6 +344,24 @@ public:
      */
     void pushDocuments();
 
+    uint32_t get_num_shards() const noexcept { return _shards.empty() ? 1u : _shards.size(); }
+
+    /**
+     * Prepare for pushing the current batch of inverted documents to a
+     * sharded field index. After this, push_shard() can be called for each
+     * shard in parallel, followed by finish_sharded_push().
+     */
+    void prepare_sharded_push();
+
+    /**
+     * Apply pending removes and push the inverted documents for words in
+     * the given shard. The remove and insert for a word are merged and
+     * done in word order, as in pushDocuments().
+     */
+    void push_shard(uint32_t shard_id);
+
+    void finish_sharded_push();
+
     /**
      * Invert a normal text field, based on annotations.
      */
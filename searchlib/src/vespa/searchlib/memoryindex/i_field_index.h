@@ -2,17 +2,20 @@
 
 #pragma once
 
+#include <vespa/vespalib/stllike/string.h>
 #include <vespa/vespalib/util/generationhandler.h>
 #include <vespa/vespalib/util/memoryusage.h>
 #include <memory>
+#include <vector>
 
 namespace search::queryeval {
     struct SimpleLeafBlueprint;
     class FieldSpec;
+    class FuzzyTermExpander;
 }
 namespace search::index {
 class FieldLengthCalculator;
-class IndexBuilder;
+class FieldIndexBuilder;
 }
 
 namespace search::memoryindex {
@@ -37,12 +40,19 @@ public:
     virtual FieldIndexRemover& getDocumentRemover() = 0;
     virtual index::FieldLengthCalculator& get_calculator() = 0;
     virtual void compactFeatures() = 0;
-    virtual void dump(search::index::IndexBuilder& indexBuilder) = 0;
+    virtual void set_posting_list_compression(uint32_t min_docs) = 0;
+    virtual void dump(search::index::FieldIndexBuilder& indexBuilder) = 0;
 
     virtual std::unique_ptr<queryeval::SimpleLeafBlueprint> make_term_blueprint(const vespalib::string& term,
                                                                                 const queryeval::FieldSpec& field,
                                                                                 uint32_t field_id) = 0;
 
+    /**
+     * Appends the words in the dictionary that match the given fuzzy term to the given vector.
+     */
+    virtual void expand_fuzzy_term(const queryeval::FuzzyTermExpander& expander,
+                                   std::vector<vespalib::string>& words) = 0;
+
     // Should only be directly used by unit tests
     virtual vespalib::GenerationHandler::Guard takeGenerationGuard() = 0;
     virtual void commit() = 0;
@@ -20,6 +20,14 @@ public:
     virtual FieldIndexRemover &get_remover(uint32_t field_id) = 0;
     virtual IOrderedFieldIndexInserter &get_inserter(uint32_t field_id) = 0;
     virtual index::FieldLengthCalculator &get_calculator(uint32_t field_id) = 0;
+
+    /*
+     * Number of word shards for the given field. Each shard has its own
+     * remover and inserter, and can be pushed by a separate thread.
+     */
+    virtual uint32_t get_num_shards(uint32_t) const { return 1u; }
+    virtual FieldIndexRemover &get_shard_remover(uint32_t field_id, uint32_t) { return get_remover(field_id); }
+    virtual IOrderedFieldIndexInserter &get_shard_inserter(uint32_t field_id, uint32_t) { return get_inserter(field_id); }
     virtual ~IFieldIndexCollection() = default;
 };
 
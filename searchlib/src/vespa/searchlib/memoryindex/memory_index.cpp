@@ -11,6 +11,7 @@
 #include <vespa/searchlib/index/schemautil.h>
 #include <vespa/searchlib/queryeval/create_blueprint_visitor_helper.h>
 #include <vespa/searchlib/queryeval/emptysearch.h>
+#include <vespa/searchlib/queryeval/fuzzy_term_expander.h>
 #include <vespa/searchlib/queryeval/leaf_blueprints.h>
 #include <vespa/vespalib/btree/btreenodeallocator.hpp>
 #include <vespa/vespalib/data/slime/cursor.h>
@@ -58,10 +59,19 @@ MemoryIndex::MemoryIndex(const Schema& schema,
                          const IFieldLengthInspector& inspector,
                          ISequencedTaskExecutor& invertThreads,
                          ISequencedTaskExecutor& pushThreads)
+    : MemoryIndex(schema, inspector, invertThreads, pushThreads, 1)
+{
+}
+
+MemoryIndex::MemoryIndex(const Schema& schema,
+                         const IFieldLengthInspector& inspector,
+                         ISequencedTaskExecutor& invertThreads,
+                         ISequencedTaskExecutor& pushThreads,
+                         uint32_t num_push_shards)
     : _schema(schema),
       _invertThreads(invertThreads),
       _pushThreads(pushThreads),
-      _fieldIndexes(std::make_unique<FieldIndexCollection>(_schema, inspector)),
+      _fieldIndexes(std::make_unique<FieldIndexCollection>(_schema, inspector, num_push_shards)),
       _inverter_context(std::make_unique<DocumentInverterContext>(_schema, _invertThreads, _pushThreads, *_fieldIndexes)),
       _inverters(std::make_unique<DocumentInverterCollection>(*_inverter_context, 4)),
       _frozen(false),
@@ -131,6 +141,18 @@ MemoryIndex::dump(IndexBuilder &indexBuilder)
     _fieldIndexes->dump(indexBuilder);
 }
 
+void
+MemoryIndex::dump(IndexBuilder &indexBuilder, vespalib::Executor &executor, uint32_t max_concurrent_fields)
+{
+    _fieldIndexes->dump(indexBuilder, executor, max_concurrent_fields);
+}
+
+void
+MemoryIndex::set_posting_list_compression(uint32_t min_docs)
+{
+    _fieldIndexes->set_posting_list_compression(min_docs);
+}
+
 namespace {
 
 /**
@@ -162,6 +184,20 @@ public:
         setResult(fieldIndex->make_term_blueprint(termStr, _field, _fieldId));
     }
 
+    void visitFuzzyTerm(FuzzyTerm &n) {
+        const vespalib::string termStr = queryeval::termAsString(n);
+        LOG(debug, "fuzzy searching for '%s' in '%s'",
+            termStr.c_str(), _field.getName().c_str());
+        IFieldIndex* fieldIndex = _fieldIndexes.getFieldIndex(_fieldId);
+        queryeval::FuzzyTermExpander expander(termStr, n.getMaxEditDistance(), n.getPrefixLength());
+        std::vector<vespalib::string> words;
+        fieldIndex->expand_fuzzy_term(expander, words);
+        setResult(queryeval::make_expanded_term_blueprint(_field, words,
+                                                          [&](const vespalib::string& word, const FieldSpec& field) {
+                                                              return fieldIndex->make_term_blueprint(word, field, _fieldId);
+                                                          }));
+    }
+
     void not_supported(Node &) {}
 
     void visit(LocationTerm &n)  override { visitTerm(n); }
@@ -171,7 +207,7 @@ public:
     void visit(SubstringTerm &n) override { visitTerm(n); }
     void visit(SuffixTerm &n)    override { visitTerm(n); }
     void visit(RegExpTerm &n)    override { visitTerm(n); }
-    void visit(FuzzyTerm &n)    override { visitTerm(n); }
+    void visit(FuzzyTerm &n)    override { visitFuzzyTerm(n); }
     void visit(PredicateQuery &n) override { not_supported(n); }
     void visit(NearestNeighborTerm &n) override { not_supported(n); }
 
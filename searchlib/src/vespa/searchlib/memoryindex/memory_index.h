@@ -16,7 +16,10 @@ namespace search::index {
     class IndexBuilder;
 }
 
-namespace vespalib { class ISequencedTaskExecutor; }
+namespace vespalib {
+class Executor;
+class ISequencedTaskExecutor;
+}
 namespace vespalib::slime { struct Cursor; }
 namespace document { class Document; }
 
@@ -95,6 +98,17 @@ public:
                 ISequencedTaskExecutor& invertThreads,
                 ISequencedTaskExecutor& pushThreads);
 
+    /**
+     * Create a new memory index where the dictionary of each field is sharded
+     * by word hash into num_push_shards shards, allowing changes to a single
+     * field to be pushed by num_push_shards threads in parallel.
+     */
+    MemoryIndex(const index::Schema& schema,
+                const index::IFieldLengthInspector& inspector,
+                ISequencedTaskExecutor& invertThreads,
+                ISequencedTaskExecutor& pushThreads,
+                uint32_t num_push_shards);
+
     MemoryIndex(const MemoryIndex &) = delete;
     MemoryIndex(MemoryIndex &&) = delete;
     MemoryIndex &operator=(const MemoryIndex &) = delete;
@@ -140,6 +154,23 @@ public:
      */
     void dump(index::IndexBuilder &indexBuilder);
 
+    /**
+     * Dump the contents of this index into the given index builder,
+     * dumping up to max_concurrent_fields fields in parallel using the
+     * given executor.
+     */
+    void dump(index::IndexBuilder &indexBuilder, vespalib::Executor &executor, uint32_t max_concurrent_fields);
+
+    /**
+     * Enable compression of posting lists having at least min_docs documents
+     * added since last compression (0 disables compression). The compressed
+     * block replaces the B-Tree entries of the posting list, and later changes
+     * are kept in the B-Tree until the posting list is compressed again.
+     *
+     * Must be called before any documents are inserted.
+     */
+    void set_posting_list_compression(uint32_t min_docs);
+
     // Implements Searchable
     std::unique_ptr<queryeval::Blueprint> createBlueprint(const queryeval::IRequestContext & requestContext,
                                                           const queryeval::FieldSpec &field,
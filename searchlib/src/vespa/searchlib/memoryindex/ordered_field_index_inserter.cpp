@@ -72,7 +72,6 @@ OrderedFieldIndexInserter<interleaved_features>::flush()
         _fieldIndex.add_features_guard_bytes();
     }
     const WordStore &wordStore(_fieldIndex.getWordStore());
-    PostingListStore &postingListStore(_fieldIndex.getPostingListStore());
     size_t adds_offset = 0;
     size_t removes_offset = 0;
     for (const auto& word_entry : _word_entries) {
@@ -97,11 +96,7 @@ OrderedFieldIndexInserter<interleaved_features>::flush()
         }
         //XXX: Feature store leak, removed features not marked dead
         vespalib::datastore::EntryRef pidx(_dItr.getData().load_relaxed());
-        postingListStore.apply(pidx,
-                               adds.begin(),
-                               adds.end(),
-                               removes.begin(),
-                               removes.end());
+        _fieldIndex.apply_posting_list_changes(pidx, adds, removes);
         if (pidx != _dItr.getData().load_relaxed()) {
             _dItr.getWData().store_release(pidx);
         }
@@ -136,6 +136,152 @@ PostingIterator<interleaved_features, unpack_normal_features, unpack_interleaved
     setUnpacked();
 }
 
+/**
+ * Search iterator over memory field index posting list with a compressed block.
+ *
+ * Documents are merged from the compressed block and the remaining B-Tree
+ * entries, where a B-Tree entry overrides the block entry for the same docid
+ * and B-Tree entries without features are tombstones.
+ */
+template <bool interleaved_features, bool unpack_normal_features, bool unpack_interleaved_features>
+class CompressedBlockPostingIterator : public queryeval::RankedSearchIteratorBase {
+    using FieldIndexType = FieldIndex<interleaved_features>;
+    using PostingListIteratorType = typename FieldIndexType::PostingList::ConstIterator;
+    using BlockReaderType = typename FieldIndexType::CompressedPostingListReaderType;
+    PostingListIteratorType _itr;
+    BlockReaderType _block;
+    const uint8_t* _block_data;
+    bool _use_itr;
+    const FeatureStore& _feature_store;
+    FeatureStore::DecodeContextCooked _feature_decoder;
+
+    void settle(uint32_t docId);
+public:
+    CompressedBlockPostingIterator(PostingListIteratorType itr,
+                                   const uint8_t* block_data,
+                                   const FeatureStore& feature_store,
+                                   uint32_t field_id,
+                                   fef::TermFieldMatchDataArray match_data);
+    ~CompressedBlockPostingIterator() override;
+
+    void doSeek(uint32_t docId) override;
+    void doUnpack(uint32_t docId) override;
+    void initRange(uint32_t begin, uint32_t end) override;
+    Trinary is_strict() const override { return Trinary::True; }
+};
+
+template <bool interleaved_features, bool unpack_normal_features, bool unpack_interleaved_features>
+CompressedBlockPostingIterator<interleaved_features, unpack_normal_features, unpack_interleaved_features>::
+CompressedBlockPostingIterator(PostingListIteratorType itr,
+                               const uint8_t* block_data,
+                               const FeatureStore& feature_store,
+                               uint32_t field_id,
+                               fef::TermFieldMatchDataArray match_data)
+    : queryeval::RankedSearchIteratorBase(std::move(match_data)),
+      _itr(itr),
+      _block(),
+      _block_data(block_data),
+      _use_itr(false),
+      _feature_store(feature_store),
+      _feature_decoder(nullptr)
+{
+    _feature_store.setupForField(field_id, _feature_decoder);
+    _block.setup(_block_data);
+}
+
+template <bool interleaved_features, bool unpack_normal_features, bool unpack_interleaved_features>
+CompressedBlockPostingIterator<interleaved_features, unpack_normal_features, unpack_interleaved_features>::
+~CompressedBlockPostingIterator() = default;
+
+template <bool interleaved_features, bool unpack_normal_features, bool unpack_interleaved_features>
+void
+CompressedBlockPostingIterator<interleaved_features, unpack_normal_features, unpack_interleaved_features>::settle(uint32_t docId)
+{
+    for (;;) {
+        _itr.linearSeek(docId);
+        _block.seek(docId);
+        if (_itr.valid() && (!_block.valid() || _itr.getKey() <= _block.get_doc_id())) {
+            if (!_itr.getData().get_features().valid()) {
+                docId = _itr.getKey() + 1; // Tombstone
+                continue;
+            }
+            _use_itr = true;
+            setDocId(_itr.getKey());
+        } else if (_block.valid()) {
+            _use_itr = false;
+            setDocId(_block.get_doc_id());
+        } else {
+            setAtEnd();
+        }
+        return;
+    }
+}
+
+template <bool interleaved_features, bool unpack_normal_features, bool unpack_interleaved_features>
+void
+CompressedBlockPostingIterator<interleaved_features, unpack_normal_features, unpack_interleaved_features>::initRange(uint32_t begin, uint32_t end)
+{
+    SearchIterator::initRange(begin, end);
+    uint32_t first = std::max(begin, FieldIndexType::compressed_block_doc_id + 1);
+    _itr.lower_bound(first);
+    _block.setup(_block_data);
+    settle(first);
+    if (!isAtEnd() && isAtEnd(getDocId())) {
+        setAtEnd();
+    }
+    clearUnpacked();
+}
+
+template <bool interleaved_features, bool unpack_normal_features, bool unpack_interleaved_features>
+void
+CompressedBlockPostingIterator<interleaved_features, unpack_normal_features, unpack_interleaved_features>::doSeek(uint32_t docId)
+{
+    if (getUnpacked()) {
+        clearUnpacked();
+    }
+    settle(docId);
+}
+
+template <bool interleaved_features, bool unpack_normal_features, bool unpack_interleaved_features>
+void
+CompressedBlockPostingIterator<interleaved_features, unpack_normal_features, unpack_interleaved_features>::doUnpack(uint32_t docId)
+{
+    if (!_matchData.valid() || getUnpacked()) {
+        return;
+    }
+    assert(docId == getDocId());
+    if (unpack_normal_features) {
+        vespalib::datastore::EntryRef featureRef = _use_itr ? _itr.getData().get_features() : _block.get_features();
+        _feature_store.setupForUnpackFeatures(featureRef, _feature_decoder);
+        _feature_decoder.unpackFeatures(_matchData, docId);
+    } else {
+        _matchData[0]->reset(docId);
+    }
+    if (interleaved_features && unpack_interleaved_features) {
+        auto* tfmd = _matchData[0];
+        if (_use_itr) {
+            tfmd->setNumOccs(_itr.getData().get_num_occs());
+            tfmd->setFieldLength(_itr.getData().get_field_length());
+        } else {
+            tfmd->setNumOccs(_block.get_num_occs());
+            tfmd->setFieldLength(_block.get_field_length());
+        }
+    }
+    setUnpacked();
+}
+
+template <bool interleaved_features, bool unpack_normal_features, bool unpack_interleaved_features>
+queryeval::SearchIterator::UP
+make_compressed_block_search_iterator(typename FieldIndex<interleaved_features>::PostingList::ConstIterator itr,
+                                      const uint8_t* block_data,
+                                      const FeatureStore& feature_store,
+                                      uint32_t field_id,
+                                      fef::TermFieldMatchDataArray match_data)
+{
+    return std::make_unique<CompressedBlockPostingIterator<interleaved_features, unpack_normal_features, unpack_interleaved_features>>
+            (itr, block_data, feature_store, field_id, std::move(match_data));
+}
+
 template <bool interleaved_features>
 queryeval::SearchIterator::UP
 make_search_iterator(typename FieldIndex<interleaved_features>::PostingList::ConstIterator itr,
@@ -164,10 +310,58 @@ make_search_iterator(typename FieldIndex<interleaved_features>::PostingList::Con
     }
 }
 
+template <bool interleaved_features>
+queryeval::SearchIterator::UP
+make_search_iterator(typename FieldIndex<interleaved_features>::PostingList::ConstIterator itr,
+                     const FeatureStore& feature_store,
+                     const CompressedPostingStore& compressed_store,
+                     uint32_t field_id,
+                     fef::TermFieldMatchDataArray match_data)
+{
+    if (!itr.valid() || itr.getKey() != FieldIndex<interleaved_features>::compressed_block_doc_id) {
+        return make_search_iterator<interleaved_features>(itr, feature_store, field_id, std::move(match_data));
+    }
+    assert(match_data.size() == 1);
+    const uint8_t* block_data = compressed_store.get(itr.getData().get_features());
+    auto* tfmd = match_data[0];
+    if (tfmd->needs_normal_features()) {
+        if (tfmd->needs_interleaved_features()) {
+            return make_compressed_block_search_iterator<interleaved_features, true, true>
+                    (itr, block_data, feature_store, field_id, std::move(match_data));
+        } else {
+            return make_compressed_block_search_iterator<interleaved_features, true, false>
+                    (itr, block_data, feature_store, field_id, std::move(match_data));
+        }
+    } else {
+        if (tfmd->needs_interleaved_features()) {
+            return make_compressed_block_search_iterator<interleaved_features, false, true>
+                    (itr, block_data, feature_store, field_id, std::move(match_data));
+        } else {
+            return make_compressed_block_search_iterator<interleaved_features, false, false>
+                    (itr, block_data, feature_store, field_id, std::move(match_data));
+        }
+    }
+}
+
+template
+queryeval::SearchIterator::UP
+make_search_iterator<false>(typename FieldIndex<false>::PostingList::ConstIterator,
+                            const FeatureStore&,
+                            uint32_t,
+                            fef::TermFieldMatchDataArray);
+
+template
+queryeval::SearchIterator::UP
+make_search_iterator<true>(typename FieldIndex<true>::PostingList::ConstIterator,
+                           const FeatureStore&,
+                           uint32_t,
+                           fef::TermFieldMatchDataArray);
+
 template
 queryeval::SearchIterator::UP
 make_search_iterator<false>(typename FieldIndex<false>::PostingList::ConstIterator,
                             const FeatureStore&,
+                            const CompressedPostingStore&,
                             uint32_t,
                             fef::TermFieldMatchDataArray);
 
@@ -175,6 +369,7 @@ template
 queryeval::SearchIterator::UP
 make_search_iterator<true>(typename FieldIndex<true>::PostingList::ConstIterator,
                            const FeatureStore&,
+                           const CompressedPostingStore&,
                            uint32_t,
                            fef::TermFieldMatchDataArray);
 
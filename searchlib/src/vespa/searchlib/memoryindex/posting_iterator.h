@@ -24,5 +24,19 @@ make_search_iterator(typename FieldIndex<interleaved_features>::PostingList::Con
                      uint32_t field_id,
                      fef::TermFieldMatchDataArray match_data);
 
+/**
+ * Factory for creating search iterator over memory field index posting list
+ * that might have a compressed block (see FieldIndex).
+ *
+ * @param compressed_store reference to store for compressed posting list blocks.
+ */
+template <bool interleaved_features>
+queryeval::SearchIterator::UP
+make_search_iterator(typename FieldIndex<interleaved_features>::PostingList::ConstIterator itr,
+                     const FeatureStore& feature_store,
+                     const CompressedPostingStore& compressed_store,
+                     uint32_t field_id,
+                     fef::TermFieldMatchDataArray match_data);
+
 }
 
@@ -0,0 +1,44 @@
+// Copyright Vespa.ai. Licensed under the terms of the Apache 2.0 license. See LICENSE in the project root.
+
+#include "push_shard_task.h"
+#include "field_inverter.h"
+#include <vespa/vespalib/util/idestructorcallback.h>
+#include <vespa/vespalib/util/retain_guard.h>
+
+namespace search::memoryindex {
+
+ShardedPush::ShardedPush(FieldInverter& inverter, OnWriteDoneType on_write_done, std::shared_ptr<vespalib::RetainGuard> retain)
+    : _inverter(inverter),
+      _prepared(),
+      _on_write_done(on_write_done),
+      _retain(std::move(retain))
+{
+}
+
+ShardedPush::~ShardedPush()
+{
+    _inverter.finish_sharded_push();
+}
+
+void
+ShardedPush::push_shard(uint32_t shard_id)
+{
+    std::call_once(_prepared, [this]() { _inverter.prepare_sharded_push(); });
+    _inverter.push_shard(shard_id);
+}
+
+PushShardTask::PushShardTask(std::shared_ptr<ShardedPush> sharded_push, uint32_t shard_id)
+    : _sharded_push(std::move(sharded_push)),
+      _shard_id(shard_id)
+{
+}
+
+PushShardTask::~PushShardTask() = default;
+
+void
+PushShardTask::run()
+{
+    _sharded_push->push_shard(_shard_id);
+}
+
+}
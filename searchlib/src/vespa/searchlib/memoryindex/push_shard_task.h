@@ -0,0 +1,51 @@
+// Copyright Vespa.ai. Licensed under the terms of the Apache 2.0 license. See LICENSE in the project root.
+
+#pragma once
+
+#include <vespa/vespalib/util/executor.h>
+#include <memory>
+#include <mutex>
+
+namespace vespalib {
+class IDestructorCallback;
+class RetainGuard;
+}
+
+namespace search::memoryindex {
+
+class FieldInverter;
+
+/*
+ * State shared by the tasks pushing the word shards of a field index
+ * sharded by word hash. The first task to run prepares the field
+ * inverter for a sharded push. The field inverter is reset and the
+ * callbacks are released when the last task is done.
+ */
+class ShardedPush {
+    using OnWriteDoneType = const std::shared_ptr<vespalib::IDestructorCallback> &;
+    FieldInverter&                                 _inverter;
+    std::once_flag                                 _prepared;
+    std::shared_ptr<vespalib::IDestructorCallback> _on_write_done;
+    std::shared_ptr<vespalib::RetainGuard>         _retain;
+public:
+    ShardedPush(FieldInverter& inverter, OnWriteDoneType on_write_done, std::shared_ptr<vespalib::RetainGuard> retain);
+    ~ShardedPush();
+    void push_shard(uint32_t shard_id);
+};
+
+/*
+ * Task to push inverted data for one word shard of a field to memory
+ * index structure. The tasks for all shards of a field are scheduled
+ * by DocumentInverter::pushDocuments(), each shard on its own executor.
+ */
+class PushShardTask : public vespalib::Executor::Task
+{
+    std::shared_ptr<ShardedPush> _sharded_push;
+    uint32_t                     _shard_id;
+public:
+    PushShardTask(std::shared_ptr<ShardedPush> sharded_push, uint32_t shard_id);
+    ~PushShardTask() override;
+    void run() override;
+};
+
+}
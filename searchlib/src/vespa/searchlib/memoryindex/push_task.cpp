@@ -34,7 +34,10 @@ void
 PushTask::run()
 {
     for (auto field_id : _context.get_fields()) {
-        push_inverter(*_inverters[field_id]);
+        auto& inverter = *_inverters[field_id];
+        if (inverter.get_num_shards() == 1) {
+            push_inverter(inverter);
+        }
     }
     for (auto uri_field_id : _context.get_uri_fields()) {
         push_inverter(*_uri_inverters[uri_field_id]);
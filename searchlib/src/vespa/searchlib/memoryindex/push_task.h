@@ -19,6 +19,9 @@ class UrlFieldInverter;
 /*
  * Task to push inverted data from a set of field inverters and uri
  * field inverters to to memory index structure.
+ *
+ * Fields with an index sharded by word hash are skipped, they are
+ * pushed by PushShardTask instead.
  */
 class PushTask : public vespalib::Executor::Task
 {
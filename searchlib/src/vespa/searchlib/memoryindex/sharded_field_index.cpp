@@ -0,0 +1,152 @@
+// Copyright Vespa.ai. Licensed under the terms of the Apache 2.0 license. See LICENSE in the project root.
+
+#include "sharded_field_index.h"
+#include <vespa/searchlib/index/docidandfeatures.h>
+#include <vespa/searchlib/queryeval/blueprint.h>
+#include <vespa/vespalib/btree/btree.hpp>
+#include <vespa/vespalib/btree/btreeiterator.hpp>
+#include <vespa/vespalib/btree/btreenode.hpp>
+#include <vespa/vespalib/btree/btreenodeallocator.hpp>
+#include <vespa/vespalib/btree/btreenodestore.hpp>
+#include <vespa/vespalib/btree/btreeroot.hpp>
+#include <vespa/vespalib/btree/btreestore.hpp>
+#include <algorithm>
+#include <cassert>
+#include <cstring>
+
+namespace search::memoryindex {
+
+using index::DocIdAndFeatures;
+using vespalib::datastore::EntryRef;
+
+template <bool interleaved_features>
+ShardedFieldIndex<interleaved_features>::ShardedFieldIndex(const index::Schema& schema, uint32_t fieldId,
+                                                           const index::FieldLengthInfo& info, uint32_t num_shards)
+    : _shards(),
+      _fieldId(fieldId)
+{
+    assert(num_shards > 0);
+    _shards.reserve(num_shards);
+    for (uint32_t shard = 0; shard < num_shards; ++shard) {
+        _shards.push_back(std::make_unique<FieldIndexType>(schema, fieldId, info));
+    }
+}
+
+template <bool interleaved_features>
+ShardedFieldIndex<interleaved_features>::~ShardedFieldIndex() = default;
+
+template <bool interleaved_features>
+uint64_t
+ShardedFieldIndex<interleaved_features>::getNumUniqueWords() const
+{
+    uint64_t num_unique_words = 0;
+    for (const auto& shard : _shards) {
+        num_unique_words += shard->getNumUniqueWords();
+    }
+    return num_unique_words;
+}
+
+template <bool interleaved_features>
+vespalib::MemoryUsage
+ShardedFieldIndex<interleaved_features>::getMemoryUsage() const
+{
+    vespalib::MemoryUsage usage;
+    for (const auto& shard : _shards) {
+        usage.merge(shard->getMemoryUsage());
+    }
+    return usage;
+}
+
+template <bool interleaved_features>
+void
+ShardedFieldIndex<interleaved_features>::compactFeatures()
+{
+    for (auto& shard : _shards) {
+        shard->compactFeatures();
+    }
+}
+
+template <bool interleaved_features>
+void
+ShardedFieldIndex<interleaved_features>::set_posting_list_compression(uint32_t min_docs)
+{
+    for (auto& shard : _shards) {
+        shard->set_posting_list_compression(min_docs);
+    }
+}
+
+template <bool interleaved_features>
+void
+ShardedFieldIndex<interleaved_features>::dump(search::index::FieldIndexBuilder& indexBuilder)
+{
+    using DictionaryIterator = typename FieldIndexType::DictionaryTree::Iterator;
+    std::vector<DictionaryIterator> itrs;
+    std::vector<std::unique_ptr<FeatureStore::DecodeContextCooked>> decoders;
+    DocIdAndFeatures features;
+    itrs.reserve(_shards.size());
+    decoders.reserve(_shards.size());
+    for (uint32_t shard = 0; shard < _shards.size(); ++shard) {
+        itrs.push_back(_shards[shard]->getDictionaryTree().begin());
+        decoders.push_back(std::make_unique<FeatureStore::DecodeContextCooked>(nullptr));
+        _shards[shard]->getFeatureStore().setupForField(_fieldId, *decoders[shard]);
+    }
+    for (;;) {
+        // Words are unique across shards, pick the smallest word among the shard iterators.
+        uint32_t best = _shards.size();
+        const char* best_word = nullptr;
+        for (uint32_t shard = 0; shard < _shards.size(); ++shard) {
+            if (itrs[shard].valid()) {
+                const char* word = _shards[shard]->getWordStore().getWord(itrs[shard].getKey()._wordRef);
+                if (best_word == nullptr || strcmp(word, best_word) < 0) {
+                    best = shard;
+                    best_word = word;
+                }
+            }
+        }
+        if (best_word == nullptr) {
+            break;
+        }
+        EntryRef plist(itrs[best].getData().load_relaxed());
+        if (_shards[best]->has_postings(plist)) {
+            indexBuilder.startWord(best_word);
+            _shards[best]->dump_posting_list(plist, *decoders[best], features, indexBuilder);
+            indexBuilder.endWord();
+        }
+        ++itrs[best];
+    }
+}
+
+template <bool interleaved_features>
+std::unique_ptr<queryeval::SimpleLeafBlueprint>
+ShardedFieldIndex<interleaved_features>::make_term_blueprint(const vespalib::string& term,
+                                                             const queryeval::FieldSpec& field,
+                                                             uint32_t field_id)
+{
+    return _shards[get_word_shard(term, _shards.size())]->make_term_blueprint(term, field, field_id);
+}
+
+template <bool interleaved_features>
+void
+ShardedFieldIndex<interleaved_features>::expand_fuzzy_term(const queryeval::FuzzyTermExpander& expander,
+                                                           std::vector<vespalib::string>& words)
+{
+    size_t old_size = words.size();
+    for (auto& shard : _shards) {
+        shard->expand_fuzzy_term(expander, words);
+    }
+    std::sort(words.begin() + old_size, words.end());
+}
+
+template <bool interleaved_features>
+void
+ShardedFieldIndex<interleaved_features>::commit()
+{
+    for (auto& shard : _shards) {
+        shard->commit();
+    }
+}
+
+template class ShardedFieldIndex<false>;
+template class ShardedFieldIndex<true>;
+
+}
@@ -0,0 +1,76 @@
+// Copyright Vespa.ai. Licensed under the terms of the Apache 2.0 license. See LICENSE in the project root.
+
+#pragma once
+
+#include "field_index.h"
+#include <vespa/vespalib/stllike/hash_fun.h>
+
+namespace search::index { class FieldLengthInfo; }
+
+namespace search::memoryindex {
+
+/*
+ * Returns the shard for the given word when a field index is sharded by word hash.
+ */
+inline uint32_t get_word_shard(vespalib::stringref word, uint32_t num_shards) noexcept {
+    return vespalib::hashValue(word.data(), word.size()) % num_shards;
+}
+
+/**
+ * Memory index for a single field where the words are spread over a set of
+ * FieldIndex shards by word hash.
+ *
+ * Each shard has its own word store, dictionary, posting lists and feature store,
+ * so changes to different shards can be pushed by different threads. A word is
+ * always found in the same shard, given by get_word_shard().
+ *
+ * The feature store, word store, inserter, remover, field length calculator and
+ * generation guard of shard 0 are returned by the single field index accessors.
+ */
+template <bool interleaved_features>
+class ShardedFieldIndex : public IFieldIndex {
+public:
+    using FieldIndexType = FieldIndex<interleaved_features>;
+private:
+    std::vector<std::unique_ptr<FieldIndexType>> _shards;
+    const uint32_t                               _fieldId;
+
+public:
+    ShardedFieldIndex(const index::Schema& schema, uint32_t fieldId, const index::FieldLengthInfo& info,
+                      uint32_t num_shards);
+    ~ShardedFieldIndex() override;
+
+    uint32_t get_num_shards() const noexcept { return _shards.size(); }
+    FieldIndexType& get_shard_index(uint32_t shard) { return *_shards[shard]; }
+
+    uint64_t getNumUniqueWords() const override;
+    vespalib::MemoryUsage getMemoryUsage() const override;
+    const FeatureStore& getFeatureStore() const override { return _shards[0]->getFeatureStore(); }
+    const WordStore& getWordStore() const override { return _shards[0]->getWordStore(); }
+    IOrderedFieldIndexInserter& getInserter() override { return _shards[0]->getInserter(); }
+    FieldIndexRemover& getDocumentRemover() override { return _shards[0]->getDocumentRemover(); }
+    index::FieldLengthCalculator& get_calculator() override { return _shards[0]->get_calculator(); }
+    void compactFeatures() override;
+    void set_posting_list_compression(uint32_t min_docs) override;
+
+    /**
+     * Dump all shards to the index builder, merging the shard dictionaries
+     * to keep the words sorted.
+     */
+    void dump(search::index::FieldIndexBuilder& indexBuilder) override;
+
+    std::unique_ptr<queryeval::SimpleLeafBlueprint> make_term_blueprint(const vespalib::string& term,
+                                                                        const queryeval::FieldSpec& field,
+                                                                        uint32_t field_id) override;
+
+    /**
+     * Expands the fuzzy term in all shards, as matching words can be in any shard.
+     */
+    void expand_fuzzy_term(const queryeval::FuzzyTermExpander& expander,
+                           std::vector<vespalib::string>& words) override;
+
+    vespalib::GenerationHandler::Guard takeGenerationGuard() override { return _shards[0]->takeGenerationGuard(); }
+    void commit() override;
+};
+
+}
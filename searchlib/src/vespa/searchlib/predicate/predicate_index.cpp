@@ -51,8 +51,8 @@ public:
     IntervalSerializer(const PredicateIntervalStore &store) : _store(store) {}
     void serialize(const EntryRef &ref, DataBuffer &buffer) const override {
         uint32_t size;
-        IntervalT single_buf;
-        const IntervalT *interval = _store.get(ref, size, &single_buf);
+        IntervalT decode_buf[PredicateIntervalStore::MAX_PACKED_INTERVALS];
+        const IntervalT *interval = _store.get(ref, size, decode_buf);
         buffer.writeInt16(size);
         for (uint32_t i = 0; i < size; ++i) {
             interval[i].serialize(buffer);
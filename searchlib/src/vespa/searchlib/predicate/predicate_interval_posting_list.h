@@ -17,7 +17,7 @@ class PredicateIntervalPostingList : public PredicatePostingList {
     Iterator                      _iterator;
     const Interval               *_current_interval;
     uint32_t                      _interval_count;
-    Interval                      _single_buf;
+    Interval                      _decode_buf[PredicateIntervalStore::MAX_PACKED_INTERVALS];
 
 public:
     PredicateIntervalPostingList(const PredicateIntervalStore &interval_store, Iterator it);
@@ -57,7 +57,7 @@ PredicateIntervalPostingList<Iterator>::next(uint32_t doc_id) {
             return false;
         }
     }
-    _current_interval = _interval_store.get(_iterator.getData(), _interval_count, &_single_buf);
+    _current_interval = _interval_store.get(_iterator.getData(), _interval_count, _decode_buf);
     setDocId(_iterator.getKey());
     return true;
 }
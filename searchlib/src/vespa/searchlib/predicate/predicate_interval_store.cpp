@@ -20,12 +20,15 @@ PredicateIntervalStore::Entry<T> PredicateIntervalStore::allocNewEntry(uint32_t
 PredicateIntervalStore::PredicateIntervalStore()
     : _store(),
       _size1Type(1, 1024u, RefType::offsetSize()),
+      _packedType(1, 1024u, RefType::offsetSize()),
       _store_adapter(_store),
-      _ref_cache(_store_adapter)
+      _ref_cache(_store_adapter),
+      _packed_ref_cache(_store_adapter)
 {
 
     // This order determines type ids.
     _store.addType(&_size1Type);
+    _store.addType(&_packedType);
 
     _store.init_primary_buffers();
 }
@@ -58,6 +61,11 @@ PredicateIntervalStore::insert(const vector<IntervalT> &intervals) {
     if (size == 1 && intervals[0].interval <= RefCacheType::DATA_REF_MASK) {
         return EntryRef(intervals[0].interval);
     }
+    if constexpr (std::is_same_v<IntervalT, Interval>) {
+        if (canPack(intervals)) {
+            return insertPacked(intervals);
+        }
+    }
     uint32_t cached_ref = _ref_cache.find(reinterpret_cast<const uint32_t *>(&intervals[0]), size);
     if (cached_ref) {
         return EntryRef(cached_ref);
@@ -83,6 +91,39 @@ EntryRef PredicateIntervalStore::insert(const vector<Interval> &);
 template
 EntryRef PredicateIntervalStore::insert(const vector<IntervalWithBounds> &);
 
+bool
+PredicateIntervalStore::canPack(const vector<Interval> &intervals) {
+    if (intervals.size() > MAX_PACKED_INTERVALS) {
+        return false;
+    }
+    for (const auto &interval : intervals) {
+        // Zero is used for padding, and is not a valid interval anyway.
+        if (interval.interval == 0 || (interval.interval & 0xff00ff00) != 0) {
+            return false;
+        }
+    }
+    return true;
+}
+
+EntryRef
+PredicateIntervalStore::insertPacked(const vector<Interval> &intervals) {
+    uint32_t packed[MAX_PACKED_INTERVALS / 2] = {};
+    const uint32_t size = (intervals.size() + 1) / 2;
+    for (size_t i = 0; i < intervals.size(); ++i) {
+        uint32_t interval = intervals[i].interval;
+        packed[i >> 1] |= (((interval >> 8) & 0xff00) | (interval & 0xff)) << ((i & 1) << 4);
+    }
+    uint32_t cached_ref = _packed_ref_cache.find(packed, size);
+    if (cached_ref) {
+        return EntryRef(cached_ref);
+    }
+    auto entry = allocNewEntry<uint32_t>(PACKED_TYPE_ID, size);
+    memcpy(entry.buffer, packed, size * sizeof(uint32_t));
+    EntryRef ref(entry.ref.ref() | (size << RefCacheType::SIZE_SHIFT));
+    _packed_ref_cache.insert(ref.ref());
+    return ref;
+}
+
 void
 PredicateIntervalStore::remove(EntryRef ref) {
     if (ref.valid()) {
@@ -5,6 +5,7 @@
 #include "predicate_ref_cache.h"
 #include <vespa/vespalib/datastore/bufferstate.h>
 #include <vespa/vespalib/datastore/datastore.h>
+#include <type_traits>
 #include <vector>
 
 namespace search::predicate {
@@ -13,6 +14,9 @@ struct Interval;
 /**
  * Stores interval entries in a memory-efficient way.
  * It works with both Interval and IntervalWithBounds entries.
+ *
+ * Short Interval entries where all begin and end values fit in 8 bits
+ * are packed into 16 bits per interval, and are decoded by get().
  */
 class PredicateIntervalStore {
     class DataStoreAdapter;
@@ -21,8 +25,11 @@ class PredicateIntervalStore {
     using RefType =  DataStoreType::RefType;
     using generation_t = vespalib::GenerationHandler::generation_t;
 
+    static constexpr uint32_t PACKED_TYPE_ID = 1;
+
     DataStoreType _store;
     vespalib::datastore::BufferType<uint32_t> _size1Type;
+    vespalib::datastore::BufferType<uint32_t> _packedType;
 
     class DataStoreAdapter {
         const DataStoreType &_store;
@@ -35,6 +42,7 @@ class PredicateIntervalStore {
     };
     DataStoreAdapter _store_adapter;
     RefCacheType     _ref_cache;
+    RefCacheType     _packed_ref_cache;
 
     // Return type for private allocation functions
     template <typename T>
@@ -49,8 +57,13 @@ class PredicateIntervalStore {
     // Returns the size of an interval entry in number of uint32_t.
     template <typename IntervalT>
     static uint32_t entrySize() { return sizeof(IntervalT) / sizeof(uint32_t); }
+    static bool canPack(const std::vector<Interval> &intervals);
+    vespalib::datastore::EntryRef insertPacked(const std::vector<Interval> &intervals);
 
 public:
+    // Max number of intervals in a packed entry, and thus the buffer size needed by get() for Interval.
+    static constexpr uint32_t MAX_PACKED_INTERVALS = 16;
+
     PredicateIntervalStore();
     ~PredicateIntervalStore();
 
@@ -85,22 +98,35 @@ public:
     /**
      * Retrieves a list of intervals.
      * IntervalT is either Interval or IntervalWithBounds.
-     * single_buf is a pointer to a single IntervalT, used by the
-     * single interval optimization.
+     * decode_buf is used by the single interval optimization and
+     * for packed entries. It must have room for MAX_PACKED_INTERVALS
+     * Interval entries, or a single IntervalWithBounds entry.
      */
     template <typename IntervalT>
     const IntervalT
-    *get(vespalib::datastore::EntryRef btree_ref, uint32_t &size_out, IntervalT *single_buf) const
+    *get(vespalib::datastore::EntryRef btree_ref, uint32_t &size_out, IntervalT *decode_buf) const
     {
         uint32_t size = btree_ref.ref() >> RefCacheType::SIZE_SHIFT;
         RefType data_ref(vespalib::datastore::EntryRef(btree_ref.ref() & RefCacheType::DATA_REF_MASK));
         if (__builtin_expect(size == 0, true)) {  // single-interval optimization
-            *single_buf = IntervalT();
-            single_buf->interval = data_ref.ref();
+            *decode_buf = IntervalT();
+            decode_buf->interval = data_ref.ref();
             size_out = 1;
-            return single_buf;
+            return decode_buf;
         }
         const uint32_t *buf = _store.getEntry<uint32_t>(data_ref);
+        if constexpr (std::is_same_v<IntervalT, Interval>) {
+            if (_store.getTypeId(data_ref.bufferId()) == PACKED_TYPE_ID) {
+                // Two intervals per word, (begin << 8 | end) in each half. An odd count is padded with zero.
+                uint32_t count = size * 2 - ((buf[size - 1] >> 16) == 0 ? 1 : 0);
+                for (uint32_t i = 0; i < count; ++i) {
+                    uint32_t packed = (buf[i >> 1] >> ((i & 1) << 4)) & 0xffff;
+                    decode_buf[i].interval = ((packed >> 8) << 16) | (packed & 0xff);
+                }
+                size_out = count;
+                return decode_buf;
+            }
+        }
         if (size == RefCacheType::MAX_SIZE) {
             size = *buf++;
         }
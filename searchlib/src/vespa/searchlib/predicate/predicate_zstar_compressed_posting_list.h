@@ -20,6 +20,7 @@ class PredicateZstarCompressedPostingList : public PredicatePostingList {
     uint32_t _interval_count;
     uint32_t _interval;
     uint32_t _prev_interval;
+    Interval _decode_buf[PredicateIntervalStore::MAX_PACKED_INTERVALS];
 
     void setInterval(uint32_t interval) { _interval = interval; }
 public:
@@ -49,8 +50,7 @@ PredicateZstarCompressedPostingList<Iterator>::next(uint32_t doc_id) {
     if (!_iterator.valid()) {
         return false;
     }
-    Interval single_buf;
-    _current_interval = _interval_store.get(_iterator.getData(), _interval_count, &single_buf);
+    _current_interval = _interval_store.get(_iterator.getData(), _interval_count, _decode_buf);
     setDocId(_iterator.getKey());
     setInterval(_current_interval[0].interval);
     _prev_interval = getInterval();
@@ -0,0 +1,33 @@
+// Copyright Vespa.ai. Licensed under the terms of the Apache 2.0 license. See LICENSE in the project root.
+
+#pragma once
+
+#include <vespa/vespalib/stllike/string.h>
+#include <vector>
+
+namespace search::query {
+
+/*
+ * String terms stored back to back in a single buffer, each followed
+ * by a zero byte. Used by term vectors for multi term query nodes
+ * (in, weightedSet, ...) that may have many thousands of terms, where
+ * a separate string object per term is costly to build and free.
+ */
+class PackedTerms {
+    std::vector<char>     _chars;
+    std::vector<uint32_t> _ends;
+public:
+    explicit PackedTerms(uint32_t sz) : _chars(), _ends() { _ends.reserve(sz); }
+    void add(vespalib::stringref term) {
+        _chars.insert(_chars.end(), term.begin(), term.end());
+        _chars.push_back('\0');
+        _ends.push_back(_chars.size());
+    }
+    [[nodiscard]] vespalib::stringref get(uint32_t index) const noexcept {
+        uint32_t begin = (index > 0) ? _ends[index - 1] : 0;
+        return {_chars.data() + begin, _ends[index] - begin - 1};
+    }
+    [[nodiscard]] uint32_t size() const noexcept { return _ends.size(); }
+};
+
+}
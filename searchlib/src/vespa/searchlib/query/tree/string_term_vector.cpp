@@ -7,9 +7,8 @@
 namespace search::query {
 
 StringTermVector::StringTermVector(uint32_t sz)
-    : _terms()
+    : _terms(sz)
 {
-    _terms.reserve(sz);
 }
 
 StringTermVector::~StringTermVector() = default;
@@ -31,23 +30,22 @@ StringTermVector::addTerm(int64_t, Weight)
 void
 StringTermVector::addTerm(vespalib::stringref term)
 {
-    _terms.emplace_back(term);
+    _terms.add(term);
 }
 
 TermVector::StringAndWeight
 StringTermVector::getAsString(uint32_t index) const
 {
-    const auto & v = _terms[index];
-    return {v, Weight(1)};
+    return {_terms.get(index), Weight(1)};
 }
 
 
 TermVector::IntegerAndWeight
 StringTermVector::getAsInteger(uint32_t index) const
 {
-    const auto & v = _terms[index];
+    auto v = _terms.get(index);
     int64_t value(0);
-    std::from_chars(v.c_str(), v.c_str() + v.size(), value);
+    std::from_chars(v.data(), v.data() + v.size(), value);
     return {value, Weight(1)};
 }
 
@@ -2,8 +2,8 @@
 
 #pragma once
 
+#include "packed_terms.h"
 #include "term_vector.h"
-#include <vector>
 
 namespace search::query {
 
@@ -12,7 +12,7 @@ namespace search::query {
  * Weights are not stored, all terms have weight 1.
  */
 class StringTermVector : public TermVector {
-    std::vector<vespalib::string> _terms;
+    PackedTerms _terms;
 public:
     explicit StringTermVector(uint32_t sz);
     ~StringTermVector() override;
@@ -1,6 +1,7 @@
 // Copyright Vespa.ai. Licensed under the terms of the Apache 2.0 license. See LICENSE in the project root.
 
 #include "termnodes.h"
+#include "packed_terms.h"
 #include <vespa/vespalib/util/exceptions.h>
 #include <charconv>
 #include <cassert>
@@ -32,10 +33,11 @@ namespace {
 
 class WeightedStringTermVector final : public TermVector {
 public:
-    explicit WeightedStringTermVector(uint32_t sz) : _terms() { _terms.reserve(sz); }
+    explicit WeightedStringTermVector(uint32_t sz) : _terms(sz), _weights() { _weights.reserve(sz); }
     ~WeightedStringTermVector() override;
     void addTerm(stringref term, Weight weight) override {
-        _terms.emplace_back(term, weight);
+        _terms.add(term);
+        _weights.push_back(weight);
     }
     void addTerm(int64_t value, Weight weight) override {
         char buf[24];
@@ -43,21 +45,21 @@ public:
         addTerm(stringref(buf, res.ptr - buf), weight);
     }
     [[nodiscard]] StringAndWeight getAsString(uint32_t index) const override {
-        const auto & v = _terms[index];
-        return {v.first, v.second};
+        return {_terms.get(index), _weights[index]};
     }
     [[nodiscard]] IntegerAndWeight getAsInteger(uint32_t index) const override {
-        const auto & v = _terms[index];
+        auto v = _terms.get(index);
         int64_t value(0);
-        std::from_chars(v.first.c_str(), v.first.c_str() + v.first.size(), value);
-        return {value, v.second};
+        std::from_chars(v.data(), v.data() + v.size(), value);
+        return {value, _weights[index]};
     }
     [[nodiscard]] Weight getWeight(uint32_t index) const override {
-        return _terms[index].second;
+        return _weights[index];
     }
     [[nodiscard]] uint32_t size() const override { return _terms.size(); }
 private:
-    std::vector<std::pair<vespalib::string, Weight>> _terms;
+    PackedTerms         _terms;
+    std::vector<Weight> _weights;
 };
 
 class WeightedIntegerTermVector final : public TermVector {
@@ -20,6 +20,7 @@ protected:
     void doSeek(uint32_t docid) override;
     Trinary is_strict() const override { return Trinary::True; }
     SearchIterator::UP andWith(SearchIterator::UP filter, uint32_t estimate) override;
+    uint32_t fill_hits(uint32_t docid, uint32_t end_id, uint32_t *hits, uint32_t max_hits) override;
 public:
     AndSearchStrict(MultiSearch::Children children, const Unpack & unpacker)
         : AndSearchNoStrict<Unpack>(std::move(children), unpacker)
@@ -85,6 +86,24 @@ AndSearchStrict<Unpack>::doSeek(uint32_t docid)
     this->setDocId(docid);
 }
 
+template<typename Unpack>
+uint32_t
+AndSearchStrict<Unpack>::fill_hits(uint32_t docid, uint32_t end_id, uint32_t *hits, uint32_t max_hits)
+{
+    uint32_t num_hits = 0;
+    if (docid > this->getDocId()) {
+        AndSearchStrict::doSeek(docid);
+    }
+    for (docid = this->getDocId(); docid < end_id; docid = this->getDocId()) {
+        hits[num_hits++] = docid;
+        if (num_hits == max_hits) {
+            break;
+        }
+        AndSearchStrict::doSeek(docid + 1);
+    }
+    return num_hits;
+}
+
 template<typename Unpack>
 SearchIterator::UP
 AndSearchStrict<Unpack>::andWith(SearchIterator::UP filter, uint32_t estimate_)
@@ -8,6 +8,7 @@
 #include "andsearch.h"
 #include "orsearch.h"
 #include "andnotsearch.h"
+#include "flow_cost_table.h"
 #include "matching_elements_search.h"
 #include <vespa/searchlib/fef/termfieldmatchdataarray.h>
 #include <vespa/vespalib/objects/visit.hpp>
@@ -131,6 +132,8 @@ Blueprint::~Blueprint() = default;
 
 Blueprint::UP
 Blueprint::optimize(Blueprint::UP bp) {
+    auto cost_table = FlowCostTable::get_global();
+    FlowCostTable::Binding bind_cost_table(cost_table.get());
     Blueprint *root = bp.release();
     root->optimize(root, OptimizePass::FIRST);
     root->optimize(root, OptimizePass::LAST);
@@ -469,6 +472,28 @@ IntermediateBlueprint::count_termwise_nodes(const UnpackInfo &unpack) const
     return termwise_nodes;
 }
 
+bool
+IntermediateBlueprint::termwise_eval_is_cheaper(const UnpackInfo &unpack, bool strict) const
+{
+    // Evaluating a child termwise costs a strict pass over the docid
+    // range plus producing and combining its bitvector. Evaluating it
+    // document at a time costs a strict pass if the child is strict,
+    // otherwise one non-strict check per document flowing into it,
+    // which is at least the global hit ratio.
+    constexpr double bitvector_cost_per_doc = 1.0 / 64;
+    double in_flow = root().hit_ratio();
+    double termwise_cost = 0.0;
+    double docwise_cost = 0.0;
+    for (size_t i = 0; i < _children.size(); ++i) {
+        const Blueprint &child = *_children[i];
+        if (child.getState().allow_termwise_eval() && !unpack.needUnpack(i)) {
+            termwise_cost += child.strict_cost() + bitvector_cost_per_doc;
+            docwise_cost += (strict && inheritStrict(i)) ? child.strict_cost() : in_flow * child.cost();
+        }
+    }
+    return termwise_cost < docwise_cost;
+}
+
 IntermediateBlueprint::IndexList
 IntermediateBlueprint::find(const IPredicate & pred) const
 {
@@ -534,9 +559,13 @@ IntermediateBlueprint::computeNextHitRate(const Blueprint & child, double hit_ra
 }
 
 bool
-IntermediateBlueprint::should_do_termwise_eval(const UnpackInfo &unpack, double match_limit) const
+IntermediateBlueprint::should_do_termwise_eval(const UnpackInfo &unpack, double match_limit, bool strict) const
 {
-    if (root().hit_ratio() <= match_limit) {
+    if (match_limit < 0.0) {
+        if (!termwise_eval_is_cheaper(unpack, strict)) {
+            return false; // flow statistics favor document at a time
+        }
+    } else if (root().hit_ratio() <= match_limit) {
         return false; // global hit density too low
     }
     if (getState().allow_termwise_eval() && unpack.empty() &&
@@ -734,16 +763,31 @@ LeafBlueprint::calculate_relative_estimate() const
     }
 }
 
+namespace {
+
+const FlowCostTable::Entry *
+lookup_flow_cost(const LeafBlueprint &blueprint)
+{
+    const FlowCostTable *table = FlowCostTable::current();
+    const char *key = blueprint.flow_cost_key();
+    return (table != nullptr && key != nullptr) ? table->lookup(key) : nullptr;
+}
+
+}
+
 double
 LeafBlueprint::calculate_cost() const
 {
-    return 1.0;
+    const auto *entry = lookup_flow_cost(*this);
+    return entry ? entry->cost : 1.0;
 }
 
 double
 LeafBlueprint::calculate_strict_cost() const
 {
-    return _can_skip ? estimate() * cost() : cost();
+    const auto *entry = lookup_flow_cost(*this);
+    double strict_cost = entry ? entry->strict_cost : cost();
+    return _can_skip ? estimate() * strict_cost : cost();
 }
 
 void
@@ -359,6 +359,7 @@ private:
     bool infer_want_global_filter() const;
 
     size_t count_termwise_nodes(const UnpackInfo &unpack) const;
+    bool termwise_eval_is_cheaper(const UnpackInfo &unpack, bool strict) const;
     virtual double computeNextHitRate(const Blueprint & child, double hit_rate) const;
 
 protected:
@@ -370,7 +371,8 @@ protected:
 
     virtual bool isPositive(size_t index) const { (void) index; return true; }
 
-    bool should_do_termwise_eval(const UnpackInfo &unpack, double match_limit) const;
+    // A negative match_limit lets the flow statistics decide
+    bool should_do_termwise_eval(const UnpackInfo &unpack, double match_limit, bool strict) const;
 
     const Children& get_children() const { return _children; }
 
@@ -463,6 +465,8 @@ public:
 
     virtual bool getRange(vespalib::string & from, vespalib::string & to) const;
     virtual SearchIteratorUP createLeafSearch(const fef::TermFieldMatchDataArray &tfmda, bool strict) const = 0;
+    // Key used to look up measured costs in the FlowCostTable, nullptr if there are none.
+    virtual const char *flow_cost_key() const noexcept { return nullptr; }
 };
 
 // for leaf nodes representing a single term
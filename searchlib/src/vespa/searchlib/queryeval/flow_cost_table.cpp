@@ -0,0 +1,117 @@
+// Copyright Vespa.ai. Licensed under the terms of the Apache 2.0 license. See LICENSE in the project root.
+
+#include "flow_cost_table.h"
+#include <fstream>
+#include <mutex>
+#include <sstream>
+#include <string>
+
+#include <vespa/log/log.h>
+LOG_SETUP(".queryeval.flow_cost_table");
+
+namespace search::queryeval {
+
+namespace {
+
+thread_local const FlowCostTable *bound_table = nullptr;
+
+std::mutex global_lock;
+FlowCostTable::SP global_table;
+
+}
+
+FlowCostTable::Binding::Binding(const FlowCostTable *table) noexcept
+    : _prev(bound_table)
+{
+    bound_table = table;
+}
+
+FlowCostTable::Binding::~Binding()
+{
+    bound_table = _prev;
+}
+
+FlowCostTable::FlowCostTable() = default;
+FlowCostTable::~FlowCostTable() = default;
+
+void
+FlowCostTable::add(const vespalib::string &key, double cost, double strict_cost)
+{
+    _entries.insert_or_assign(key, Entry(cost, strict_cost));
+}
+
+const FlowCostTable::Entry *
+FlowCostTable::lookup(const vespalib::string &key) const noexcept
+{
+    auto itr = _entries.find(key);
+    return (itr != _entries.end()) ? &itr->second : nullptr;
+}
+
+void
+FlowCostTable::write(std::ostream &os) const
+{
+    os << "# cost strict_cost key\n";
+    for (const auto &[key, entry] : _entries) {
+        os << entry.cost << " " << entry.strict_cost << " " << key << "\n";
+    }
+}
+
+bool
+FlowCostTable::read(std::istream &is)
+{
+    std::string line;
+    while (std::getline(is, line)) {
+        if (line.empty() || line[0] == '#') {
+            continue;
+        }
+        std::istringstream fields(line);
+        double cost = 0.0;
+        double strict_cost = 0.0;
+        fields >> cost >> strict_cost >> std::ws;
+        std::string key;
+        std::getline(fields, key);
+        if (fields.fail() || key.empty() || !(cost > 0.0) || !(strict_cost > 0.0)) {
+            return false;
+        }
+        add(key, cost, strict_cost);
+    }
+    return true;
+}
+
+FlowCostTable::SP
+FlowCostTable::load(const vespalib::string &file_name)
+{
+    std::ifstream file(file_name.c_str(), std::ifstream::in);
+    if (!file.is_open()) {
+        LOG(warning, "Could not open flow cost table file '%s'", file_name.c_str());
+        return {};
+    }
+    auto table = std::make_shared<FlowCostTable>();
+    if (!table->read(file)) {
+        LOG(warning, "Malformed flow cost table file '%s'", file_name.c_str());
+        return {};
+    }
+    return table;
+}
+
+const FlowCostTable *
+FlowCostTable::current() noexcept
+{
+    return bound_table;
+}
+
+void
+FlowCostTable::set_global(SP table)
+{
+    std::lock_guard guard(global_lock);
+    global_table = std::move(table);
+}
+
+FlowCostTable::SP
+FlowCostTable::get_global()
+{
+    std::lock_guard guard(global_lock);
+    return global_table;
+}
+
+}
@@ -0,0 +1,90 @@
+// Copyright Vespa.ai. Licensed under the terms of the Apache 2.0 license. See LICENSE in the project root.
+
+#pragma once
+
+#include <vespa/vespalib/stllike/string.h>
+#include <iosfwd>
+#include <map>
+#include <memory>
+
+namespace search::queryeval {
+
+/**
+ * Measured flow costs for leaf blueprint types, used instead of the
+ * default leaf costs when calculating flow stats. Costs use the same
+ * unit as the default costs; a non-strict cost of 1.0 is the cost of
+ * a plain term. The strict cost is the per-document cost of strict
+ * evaluation for a term matching all documents and is scaled by the
+ * relative estimate for leafs that are able to skip.
+ *
+ * Tables are typically written by the flow cost calibration benchmark
+ * and loaded by proton. The table is looked up using the flow cost key
+ * of the leaf blueprint (see LeafBlueprint::flow_cost_key), which does
+ * not change when blueprint classes are renamed or moved. Each line in
+ * the file contains the cost, the strict cost and the key, separated by
+ * space. Empty lines and lines starting with '#' are ignored.
+ *
+ * The table in effect is bound to the current thread during blueprint
+ * optimization (see Blueprint::optimize), using the table set with
+ * set_global.
+ **/
+class FlowCostTable
+{
+public:
+    using SP = std::shared_ptr<const FlowCostTable>;
+    struct Entry {
+        double cost;
+        double strict_cost;
+        Entry(double cost_in, double strict_cost_in) noexcept
+            : cost(cost_in), strict_cost(strict_cost_in) {}
+    };
+    using Map = std::map<vespalib::string, Entry>;
+
+    /**
+     * Binds a table to the current thread for the lifetime of this
+     * object. Bindings may be nested.
+     **/
+    class Binding {
+        const FlowCostTable *_prev;
+    public:
+        explicit Binding(const FlowCostTable *table) noexcept;
+        Binding(const Binding &) = delete;
+        Binding &operator=(const Binding &) = delete;
+        ~Binding();
+    };
+
+    // Keys of the leaf blueprints measured by the calibration benchmark
+    static constexpr const char *disk_term_key = "disk_term";
+    static constexpr const char *memory_term_key = "memory_term";
+    static constexpr const char *attribute_term_key = "attribute_term";
+    static constexpr const char *attribute_fast_search_term_key = "attribute_fast_search_term";
+
+    FlowCostTable();
+    ~FlowCostTable();
+
+    void add(const vespalib::string &key, double cost, double strict_cost);
+    const Entry *lookup(const vespalib::string &key) const noexcept;
+    const Map &entries() const noexcept { return _entries; }
+    bool empty() const noexcept { return _entries.empty(); }
+
+    void write(std::ostream &os) const;
+    // returns false if the input is malformed
+    bool read(std::istream &is);
+
+    /**
+     * Loads a table from the given file. nullptr is returned (and a
+     * warning is logged) if the file could not be read.
+     **/
+    static SP load(const vespalib::string &file_name);
+
+    // Table bound to the current thread, or nullptr
+    static const FlowCostTable *current() noexcept;
+
+    static void set_global(SP table);
+    static SP get_global();
+
+private:
+    Map _entries;
+};
+
+}
@@ -0,0 +1,59 @@
+// Copyright Vespa.ai. Licensed under the terms of the Apache 2.0 license. See LICENSE in the project root.
+
+#include "fuzzy_term_expander.h"
+#include "equiv_blueprint.h"
+#include "leaf_blueprints.h"
+#include <vespa/searchlib/fef/matchdatalayout.h>
+#include <vespa/vespalib/text/utf8.h>
+
+using vespalib::fuzzy::LevenshteinDfa;
+
+namespace search::queryeval {
+
+FuzzyTermExpander::FuzzyTermExpander(vespalib::stringref term, uint32_t max_edits, uint32_t prefix_length)
+    : _dfa(),
+      _term(term),
+      _prefix()
+{
+    vespalib::Utf8Reader reader(term);
+    uint32_t pos = 0;
+    for (; pos < prefix_length && reader.hasMore(); ++pos) {
+        (void) reader.getChar();
+    }
+    if (!supports_max_edits(max_edits) || pos < prefix_length) {
+        return;
+    }
+    _prefix = _term.substr(0, reader.getPos());
+    std::string_view suffix(term.data() + reader.getPos(), term.size() - reader.getPos());
+    _dfa.emplace(LevenshteinDfa::build(suffix, max_edits, LevenshteinDfa::Casing::Cased,
+                                       LevenshteinDfa::DfaType::Table));
+}
+
+FuzzyTermExpander::~FuzzyTermExpander() = default;
+
+std::unique_ptr<Blueprint>
+make_expanded_term_blueprint(const FieldSpec& field, const std::vector<vespalib::string>& words,
+                             const MakeTermBlueprint& make_term)
+{
+    if (words.empty()) {
+        return std::make_unique<EmptyBlueprint>(field);
+    }
+    if (words.size() == 1) {
+        return make_term(words[0], field);
+    }
+    fef::MatchDataLayout layout;
+    std::vector<FieldSpec> children;
+    children.reserve(words.size());
+    for (size_t i = 0; i < words.size(); ++i) {
+        children.emplace_back(field.getName(), field.getFieldId(), layout.allocTermField(field.getFieldId()), field.isFilter());
+    }
+    FieldSpecBaseList fields;
+    fields.add(field);
+    auto equiv = std::make_unique<EquivBlueprint>(std::move(fields), layout);
+    for (size_t i = 0; i < words.size(); ++i) {
+        equiv->addTerm(make_term(words[i], children[i]), 1.0);
+    }
+    return equiv;
+}
+
+}
@@ -0,0 +1,99 @@
+// Copyright Vespa.ai. Licensed under the terms of the Apache 2.0 license. See LICENSE in the project root.
+
+#pragma once
+
+#include <vespa/vespalib/fuzzy/levenshtein_dfa.h>
+#include <vespa/vespalib/stllike/string.h>
+#include <functional>
+#include <memory>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace search::queryeval {
+
+class Blueprint;
+class FieldSpec;
+
+/**
+ * Expands a fuzzy term into the words in a sorted index dictionary that are
+ * within the max edit distance of the term (with an optional locked prefix).
+ *
+ * A LevenshteinDfa is used to walk the dictionary: each time a dictionary
+ * word does not match, the successor string from the DFA is used to seek
+ * directly to the next possibly matching word. The dictionary is probed via a
+ * lower bound function, so only a small fraction of a large vocabulary is visited.
+ *
+ * Matching is cased, as index dictionaries are ordered byte-wise on the
+ * (already normalized) words. If the max edit distance is not supported by
+ * the DFA, or the term is shorter than the locked prefix, only the term
+ * itself is looked up.
+ */
+class FuzzyTermExpander {
+private:
+    std::optional<vespalib::fuzzy::LevenshteinDfa> _dfa;
+    vespalib::string                               _term;
+    vespalib::string                               _prefix;
+
+public:
+    FuzzyTermExpander(vespalib::stringref term, uint32_t max_edits, uint32_t prefix_length);
+    ~FuzzyTermExpander();
+
+    [[nodiscard]] static constexpr bool supports_max_edits(uint32_t edits) noexcept {
+        return (edits == 1 || edits == 2);
+    }
+
+    /**
+     * Walks the dictionary and calls on_match(word) for each matching word, in dictionary order.
+     *
+     * lower_bound(key, word) must set word to the first dictionary word that is not
+     * less than key (byte-wise) and return true, or return false if there is no such word.
+     * Keys are given in increasing order.
+     */
+    template <typename LowerBound, typename OnMatch>
+    void expand(LowerBound&& lower_bound, OnMatch&& on_match) const;
+};
+
+using MakeTermBlueprint = std::function<std::unique_ptr<Blueprint>(const vespalib::string& word, const FieldSpec& field)>;
+
+/**
+ * Creates a blueprint searching for all the given words in a single field as
+ * if they were one term (an equiv of the per word blueprints created by make_term).
+ * Used to merge the posting lists of the words a fuzzy term expands to.
+ */
+std::unique_ptr<Blueprint> make_expanded_term_blueprint(const FieldSpec& field,
+                                                        const std::vector<vespalib::string>& words,
+                                                        const MakeTermBlueprint& make_term);
+
+template <typename LowerBound, typename OnMatch>
+void
+FuzzyTermExpander::expand(LowerBound&& lower_bound, OnMatch&& on_match) const
+{
+    vespalib::string word;
+    if (!_dfa.has_value()) {
+        if (lower_bound(std::string(_term), word) && word == _term) {
+            on_match(word);
+        }
+        return;
+    }
+    std::string key(_prefix);
+    std::string successor;
+    while (lower_bound(key, word)) {
+        std::string_view candidate(word.data(), word.size());
+        if (!candidate.starts_with(std::string_view(_prefix.data(), _prefix.size()))) {
+            break;
+        }
+        successor.assign(_prefix.data(), _prefix.size());
+        if (_dfa->match(candidate.substr(_prefix.size()), successor).matches()) {
+            on_match(word);
+            // Smallest possible key after the word, as words never contain NUL
+            key.assign(word.data(), word.size());
+            key.push_back('\x01');
+        } else {
+            key.swap(successor);
+        }
+    }
+}
+
+}
@@ -28,6 +28,7 @@ struct Inactive : GlobalFilter {
     uint32_t size() const override { abort(); }
     uint32_t count() const override { abort(); }
     bool check(uint32_t) const override { abort(); }
+    uint32_t next_hit(uint32_t) const override { abort(); }
 };
 
 struct EmptyFilter : GlobalFilter {
@@ -38,6 +39,7 @@ struct EmptyFilter : GlobalFilter {
     uint32_t size() const override { return docid_limit; }
     uint32_t count() const override { return 0; }
     bool check(uint32_t) const override { return false; }
+    uint32_t next_hit(uint32_t) const override { return docid_limit; }
 };
 
 EmptyFilter::~EmptyFilter() = default;
@@ -50,6 +52,9 @@ struct BitVectorFilter : public GlobalFilter {
     uint32_t size() const override { return vector->size(); }
     uint32_t count() const override { return vector->countTrueBits(); }
     bool check(uint32_t docid) const override { return vector->testBit(docid); }
+    uint32_t next_hit(uint32_t docid) const override {
+        return (docid < vector->size()) ? vector->getFirstTrueBit(docid) : vector->size();
+    }
 };
 
 struct MultiBitVectorFilter : public GlobalFilter {
@@ -75,6 +80,23 @@ struct MultiBitVectorFilter : public GlobalFilter {
         }
         return vectors[i]->testBit(docid);
     }
+    uint32_t next_hit(uint32_t docid) const override {
+        size_t i = 0;
+        while ((i < splits.size()) && (docid >= splits[i])) {
+            ++i;
+        }
+        for (; i < vectors.size(); ++i) {
+            const BitVector &vector = *vectors[i];
+            if (docid < vector.size()) {
+                uint32_t hit = vector.getFirstTrueBit(docid);
+                if (hit < vector.size()) {
+                    return hit;
+                }
+            }
+            docid = vector.size();
+        }
+        return total_size;
+    }
 };
 
 struct PartResult {
@@ -153,6 +175,16 @@ void insert_traces(Trace *trace, const std::vector<MakePart> &parts) {
 GlobalFilter::GlobalFilter() noexcept = default;
 GlobalFilter::~GlobalFilter() = default;
 
+uint32_t
+GlobalFilter::next_hit(uint32_t docid) const
+{
+    uint32_t limit = size();
+    while ((docid < limit) && !check(docid)) {
+        ++docid;
+    }
+    return docid;
+}
+
 std::shared_ptr<GlobalFilter>
 GlobalFilter::create() {
     return std::make_shared<Inactive>();
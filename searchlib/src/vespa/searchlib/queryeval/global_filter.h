@@ -32,6 +32,8 @@ public:
     virtual uint32_t size() const = 0;
     virtual uint32_t count() const = 0;
     virtual bool check(uint32_t docid) const = 0;
+    // Returns the first docid >= the given docid that passes the filter, or size() if there is none.
+    virtual uint32_t next_hit(uint32_t docid) const;
     virtual ~GlobalFilter();
 
     const GlobalFilter *ptr_if_active() const {
@@ -45,6 +45,7 @@ HitCollector::HitCollector(uint32_t numDocs,
       _docIdVector(),
       _bitVector(),
       _reRankedHits(),
+      _shared_threshold(nullptr),
       _scale(1.0),
       _adjust(0)
 {
@@ -92,6 +93,7 @@ HitCollector::CollectorBase::replaceHitInVector(uint32_t docId, feature_t score)
     _hc._hits.back().first = docId;
     _hc._hits.back().second = score;
     std::push_heap(_hc._hits.begin(), _hc._hits.end(), ScoreComparator());
+    _hc.publish_heap_threshold();
 }
 
 void
@@ -125,6 +127,7 @@ HitCollector::RankedHitCollector::collectAndChangeCollector(uint32_t docId, feat
     // treat hit vector as a heap
     std::make_heap(hc._hits.begin(), hc._hits.end(), ScoreComparator());
     hc._hitsSortOrder = SortOrder::HEAP;
+    hc.publish_heap_threshold();
     this->considerForHitVector(docId, score);
     hc._collector = std::move(newCollector);
 }
@@ -3,6 +3,7 @@
 #pragma once
 
 #include "scores.h"
+#include "shared_score_threshold.h"
 #include "sorted_hit_sequence.h"
 #include <vespa/searchlib/common/hitrank.h>
 #include <vespa/searchlib/common/resultset.h>
@@ -33,6 +34,7 @@ private:
     std::vector<uint32_t>       _docIdVector;
     std::unique_ptr<BitVector>  _bitVector;
     std::vector<Hit>            _reRankedHits;
+    SharedScoreThreshold       *_shared_threshold;
 
     std::pair<Scores, Scores> _ranges;
     feature_t _scale;
@@ -89,7 +91,9 @@ private:
         CollectorBase(HitCollector &hc) : _hc(hc) { }
         void considerForHitVector(uint32_t docId, feature_t score) {
             if (__builtin_expect((score > _hc._hits[0].second), false)) {
-                replaceHitInVector(docId, score);
+                if (_hc.above_shared_threshold(score)) {
+                    replaceHitInVector(docId, score);
+                }
             }
         }
     protected:
@@ -120,6 +124,16 @@ private:
         virtual void collect(uint32_t docId, feature_t score) override;
     };
 
+    bool above_shared_threshold(feature_t score) const noexcept {
+        return (_shared_threshold == nullptr) || !(score < _shared_threshold->get());
+    }
+    // Called when all ranked hit slots are in use and _hits is a heap
+    void publish_heap_threshold() noexcept {
+        if (_shared_threshold != nullptr) {
+            _shared_threshold->publish(_hits[0].second);
+        }
+    }
+
     HitRank getReScore(feature_t score) const {
         return ((score * _scale) - _adjust);
     }
@@ -153,6 +167,16 @@ public:
         _collector->collect(docId, score);
     }
 
+    /**
+     * Share the lowest score among the ranked hits with collectors in
+     * other threads when all ranked hit slots are in use, and skip
+     * storing rank scores for hits below the highest score shared by
+     * any collector. Only use this when the ranked hits are only used
+     * to select the best hits of the query; a hit skipped this way has
+     * at least maxHitsSize hits with better scores in another collector.
+     **/
+    void set_shared_threshold(SharedScoreThreshold *shared_threshold) { _shared_threshold = shared_threshold; }
+
     /**
      * Returns a sorted sequence of hits that reference internal
      * data. The number of hits returned in the sequence is controlled
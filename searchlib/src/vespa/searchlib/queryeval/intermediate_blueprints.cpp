@@ -194,7 +194,7 @@ AndNotBlueprint::createIntermediateSearch(MultiSearch::Children sub_searches,
                                           bool strict, search::fef::MatchData &md) const
 {
     UnpackInfo unpack_info(calculateUnpackInfo(md));
-    if (should_do_termwise_eval(unpack_info, md.get_termwise_limit())) {
+    if (should_do_termwise_eval(unpack_info, md.get_termwise_limit(), strict)) {
         TermwiseBlueprintHelper helper(*this, std::move(sub_searches), unpack_info);
         bool termwise_strict = (strict && inheritStrict(helper.first_termwise));
         auto termwise_search = (helper.first_termwise == 0)
@@ -294,7 +294,7 @@ AndBlueprint::createIntermediateSearch(MultiSearch::Children sub_searches,
 {
     UnpackInfo unpack_info(calculateUnpackInfo(md));
     std::unique_ptr<AndSearch> search;
-    if (should_do_termwise_eval(unpack_info, md.get_termwise_limit())) {
+    if (should_do_termwise_eval(unpack_info, md.get_termwise_limit(), strict)) {
         TermwiseBlueprintHelper helper(*this, std::move(sub_searches), unpack_info);
         bool termwise_strict = (strict && inheritStrict(helper.first_termwise));
         auto termwise_search = AndSearch::create(helper.get_termwise_children(), termwise_strict);
@@ -409,7 +409,7 @@ OrBlueprint::createIntermediateSearch(MultiSearch::Children sub_searches,
                                       bool strict, search::fef::MatchData & md) const
 {
     UnpackInfo unpack_info(calculateUnpackInfo(md));
-    if (should_do_termwise_eval(unpack_info, md.get_termwise_limit())) {
+    if (should_do_termwise_eval(unpack_info, md.get_termwise_limit(), strict)) {
         TermwiseBlueprintHelper helper(*this, std::move(sub_searches), unpack_info);
         bool termwise_strict = (strict && inheritStrict(helper.first_termwise));
         auto termwise_search = OrSearch::create(helper.get_termwise_children(), termwise_strict);
@@ -4,6 +4,7 @@
 
 #include "searchiterator.h"
 #include <vespa/searchlib/fef/termfieldmatchdata.h>
+#include <limits>
 
 namespace search::fef { class MatchData; }
 
@@ -50,6 +51,10 @@ public:
         _children[ref]->doUnpack(docid);
     }
 
+    // No posting list block information, the whole posting list is one block
+    int32_t get_block_max_weight(ref_t) const { return std::numeric_limits<int32_t>::max(); }
+    uint32_t get_block_end(ref_t) const { return endDocId - 1; }
+
     ref_t size() const { return _children.size(); }
     void initRange(uint32_t begin, uint32_t end) {
         for (auto & child: _children) {
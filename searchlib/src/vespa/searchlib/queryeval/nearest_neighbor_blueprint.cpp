@@ -2,6 +2,8 @@
 
 #include "nearest_neighbor_blueprint.h"
 #include "emptysearch.h"
+#include "executeinfo.h"
+#include "nearest_neighbor_exact_search.h"
 #include "nearest_neighbor_iterator.h"
 #include "nns_index_iterator.h"
 #include <vespa/searchlib/fef/termfieldmatchdataarray.h>
@@ -44,6 +46,7 @@ NearestNeighborBlueprint::NearestNeighborBlueprint(const queryeval::FieldSpec& f
                                                    double global_filter_lower_limit,
                                                    double global_filter_upper_limit,
                                                    double target_hits_max_adjustment_factor,
+                                                   double filter_first_threshold,
                                                    const vespalib::Doom& doom)
     : ComplexLeafBlueprint(field),
       _distance_calc(std::move(distance_calc)),
@@ -57,8 +60,11 @@ NearestNeighborBlueprint::NearestNeighborBlueprint(const queryeval::FieldSpec& f
       _global_filter_lower_limit(global_filter_lower_limit),
       _global_filter_upper_limit(global_filter_upper_limit),
       _target_hits_max_adjustment_factor(target_hits_max_adjustment_factor),
+      _filter_first_threshold(filter_first_threshold),
+      _filter_first(false),
       _distance_heap(target_hits),
       _found_hits(),
+      _found_hits_exact(false),
       _algorithm(Algorithm::EXACT),
       _global_filter(GlobalFilter::create()),
       _global_filter_set(false),
@@ -117,7 +123,8 @@ NearestNeighborBlueprint::perform_top_k(const search::tensor::NearestNeighborInd
     uint32_t k = _adjusted_target_hits;
     const auto &df = _distance_calc->function();
     if (_global_filter->is_active()) {
-        _found_hits = nns_index->find_top_k_with_filter(k, df, *_global_filter, k + _explore_additional_hits, _doom, _distance_threshold);
+        _filter_first = (_global_filter_hit_ratio.has_value() && _global_filter_hit_ratio.value() < _filter_first_threshold);
+        _found_hits = nns_index->find_top_k_with_filter(k, df, *_global_filter, _filter_first, k + _explore_additional_hits, _doom, _distance_threshold);
         _algorithm = Algorithm::INDEX_TOP_K_WITH_FILTER;
     } else {
         _found_hits = nns_index->find_top_k(k, df, k + _explore_additional_hits, _doom, _distance_threshold);
@@ -125,6 +132,24 @@ NearestNeighborBlueprint::perform_top_k(const search::tensor::NearestNeighborInd
     }
 }
 
+void
+NearestNeighborBlueprint::perform_exact_top_k(vespalib::ThreadBundle& thread_bundle)
+{
+    _found_hits = NearestNeighborExactSearch::find_top_k(_adjusted_target_hits, _attr_tensor, _query_tensor,
+                                                         *_global_filter, _distance_threshold, thread_bundle, _doom);
+    _found_hits_exact = true;
+}
+
+void
+NearestNeighborBlueprint::fetchPostings(const ExecuteInfo& execInfo)
+{
+    // The global filter is known when postings are fetched after it has been handled,
+    // calculate the exact top k hits among its documents using all threads.
+    if ((_algorithm == Algorithm::EXACT_FALLBACK) && !_found_hits_exact && _global_filter->is_active()) {
+        perform_exact_top_k(execInfo.thread_bundle());
+    }
+}
+
 std::unique_ptr<SearchIterator>
 NearestNeighborBlueprint::createLeafSearch(const search::fef::TermFieldMatchDataArray& tfmda, bool strict) const
 {
@@ -134,12 +159,19 @@ NearestNeighborBlueprint::createLeafSearch(const search::fef::TermFieldMatchData
     case Algorithm::INDEX_TOP_K_WITH_FILTER:
     case Algorithm::INDEX_TOP_K:
         return NnsIndexIterator::create(tfmd, _found_hits, _distance_calc->function());
+    case Algorithm::EXACT_FALLBACK:
+        if (_found_hits_exact) {
+            return NnsIndexIterator::create(tfmd, _found_hits, _distance_calc->function());
+        }
+        break;
     default:
         ;
     }
-    return NearestNeighborIterator::create(strict, tfmd,
-                                           std::make_unique<search::tensor::DistanceCalculator>(_attr_tensor, _query_tensor),
-                                           _distance_heap, *_global_filter);
+    auto search = NearestNeighborIterator::create(strict, tfmd,
+                                                  std::make_unique<search::tensor::DistanceCalculator>(_attr_tensor, _query_tensor),
+                                                  _distance_heap, *_global_filter);
+    search->set_soft_doom(_doom);
+    return search;
 }
 
 void
@@ -155,6 +187,7 @@ NearestNeighborBlueprint::visitMembers(vespalib::ObjectVisitor& visitor) const
     visitor.visitBool("has_index", _attr_tensor.nearest_neighbor_index());
     visitor.visitString("algorithm", to_string(_algorithm));
     visitor.visitInt("top_k_hits", _found_hits.size());
+    visitor.visitBool("exact_top_k", _found_hits_exact);
 
     visitor.openStruct("global_filter", "GlobalFilter");
     visitor.visitBool("wanted", getState().want_global_filter());
@@ -162,6 +195,8 @@ NearestNeighborBlueprint::visitMembers(vespalib::ObjectVisitor& visitor) const
     visitor.visitBool("calculated", _global_filter->is_active());
     visitor.visitFloat("lower_limit", _global_filter_lower_limit);
     visitor.visitFloat("upper_limit", _global_filter_upper_limit);
+    visitor.visitFloat("filter_first_threshold", _filter_first_threshold);
+    visitor.visitBool("filter_first", _filter_first);
     if (_global_filter_hits.has_value()) {
         visitor.visitInt("hits", _global_filter_hits.value());
     }
@@ -39,8 +39,11 @@ private:
     double _global_filter_lower_limit;
     double _global_filter_upper_limit;
     double _target_hits_max_adjustment_factor;
+    double _filter_first_threshold;
+    bool _filter_first;
     mutable NearestNeighborDistanceHeap _distance_heap;
     std::vector<search::tensor::NearestNeighborIndex::Neighbor> _found_hits;
+    bool _found_hits_exact;
     Algorithm _algorithm;
     std::shared_ptr<const GlobalFilter> _global_filter;
     bool _global_filter_set;
@@ -49,6 +52,7 @@ private:
     const vespalib::Doom& _doom;
 
     void perform_top_k(const search::tensor::NearestNeighborIndex* nns_index);
+    void perform_exact_top_k(vespalib::ThreadBundle& thread_bundle);
 public:
     NearestNeighborBlueprint(const queryeval::FieldSpec& field,
                              std::unique_ptr<search::tensor::DistanceCalculator> distance_calc,
@@ -57,6 +61,7 @@ public:
                              double global_filter_lower_limit,
                              double global_filter_upper_limit,
                              double target_hits_max_adjustment_factor,
+                             double filter_first_threshold,
                              const vespalib::Doom& doom);
     NearestNeighborBlueprint(const NearestNeighborBlueprint&) = delete;
     NearestNeighborBlueprint& operator=(const NearestNeighborBlueprint&) = delete;
@@ -68,7 +73,9 @@ public:
     void set_global_filter(const GlobalFilter &global_filter, double estimated_hit_ratio) override;
     Algorithm get_algorithm() const { return _algorithm; }
     double get_distance_threshold() const { return _distance_threshold; }
+    bool get_filter_first() const { return _filter_first; }
 
+    void fetchPostings(const ExecuteInfo& execInfo) override;
     std::unique_ptr<SearchIterator> createLeafSearch(const search::fef::TermFieldMatchDataArray& tfmda,
                                                      bool strict) const override;
     SearchIteratorUP createFilterSearch(bool strict, FilterConstraint constraint) const override {
@@ -0,0 +1,150 @@
+// Copyright Vespa.ai. Licensed under the terms of the Apache 2.0 license. See LICENSE in the project root.
+
+#include "nearest_neighbor_exact_search.h"
+#include "global_filter.h"
+#include <vespa/searchlib/tensor/distance_calculator.h>
+#include <vespa/vespalib/util/doom.h>
+#include <vespa/vespalib/util/prefetch.h>
+#include <vespa/vespalib/util/thread_bundle.h>
+#include <algorithm>
+#include <cassert>
+
+using search::tensor::DistanceCalculator;
+using search::tensor::ITensorAttribute;
+using search::tensor::VectorBundle;
+using vespalib::Runnable;
+using vespalib::eval::CellTypeUtils;
+
+namespace search::queryeval {
+
+namespace {
+
+using Neighbor = NearestNeighborExactSearch::Neighbor;
+
+struct FartherFirst {
+    bool operator()(const Neighbor& lhs, const Neighbor& rhs) const noexcept {
+        return lhs.distance < rhs.distance;
+    }
+};
+
+struct CloserFirst {
+    bool operator()(const Neighbor& lhs, const Neighbor& rhs) const noexcept {
+        return (lhs.distance < rhs.distance) || ((lhs.distance == rhs.distance) && (lhs.docid < rhs.docid));
+    }
+};
+
+// Number of documents whose vectors are prefetched together
+constexpr uint32_t batch_size = 16;
+// Cache lines prefetched for the first vector of each document
+constexpr size_t max_prefetch_lines = 8;
+
+struct SearchPart : Runnable {
+    uint32_t k;
+    const ITensorAttribute& attr_tensor;
+    const vespalib::eval::Value& query_tensor;
+    const GlobalFilter& filter;
+    double distance_threshold;
+    const vespalib::Doom& doom;
+    uint32_t begin;
+    uint32_t end;
+    std::vector<Neighbor> heap;
+    SearchPart(uint32_t k_in, const ITensorAttribute& attr_tensor_in, const vespalib::eval::Value& query_tensor_in,
+               const GlobalFilter& filter_in, double distance_threshold_in, const vespalib::Doom& doom_in,
+               uint32_t begin_in, uint32_t end_in)
+        : k(k_in), attr_tensor(attr_tensor_in), query_tensor(query_tensor_in), filter(filter_in),
+          distance_threshold(distance_threshold_in), doom(doom_in), begin(begin_in), end(end_in), heap()
+    {}
+    SearchPart(SearchPart&&) noexcept = default;
+    ~SearchPart() override;
+    double limit() const noexcept {
+        return (heap.size() < k) ? distance_threshold : std::min(distance_threshold, heap.front().distance);
+    }
+    void add(uint32_t docid, double distance) {
+        if (distance > limit()) {
+            return;
+        }
+        if (heap.size() == k) {
+            std::pop_heap(heap.begin(), heap.end(), FartherFirst());
+            heap.pop_back();
+        }
+        heap.emplace_back(docid, distance);
+        std::push_heap(heap.begin(), heap.end(), FartherFirst());
+    }
+    void run() override {
+        // The bound distance functions use mutable scratch space, one calculator per thread
+        DistanceCalculator calc(attr_tensor, query_tensor);
+        heap.reserve(k);
+        uint32_t docids[batch_size];
+        VectorBundle vectors[batch_size];
+        uint32_t docid = filter.next_hit(begin);
+        while ((docid < end) && !doom.soft_doom()) {
+            uint32_t num_docs = 0;
+            for (; (num_docs < batch_size) && (docid < end); docid = filter.next_hit(docid + 1)) {
+                docids[num_docs] = docid;
+                vectors[num_docs] = attr_tensor.get_vectors(docid);
+                if (vectors[num_docs].subspaces() > 0) {
+                    auto cells = vectors[num_docs].cells(0);
+                    vespalib::prefetch_range(cells.data, CellTypeUtils::mem_size(cells.type, cells.size),
+                                             max_prefetch_lines);
+                }
+                ++num_docs;
+            }
+            for (uint32_t i = 0; i < num_docs; ++i) {
+                if (vectors[i].subspaces() == 0) {
+                    continue;
+                }
+                double best = std::numeric_limits<double>::max();
+                double max_distance = limit();
+                for (uint32_t subspace = 0; subspace < vectors[i].subspaces(); ++subspace) {
+                    double distance = calc.function().calc_with_limit(vectors[i].cells(subspace), max_distance);
+                    best = std::min(best, distance);
+                }
+                add(docids[i], best);
+            }
+        }
+    }
+};
+
+SearchPart::~SearchPart() = default;
+
+}
+
+std::vector<Neighbor>
+NearestNeighborExactSearch::find_top_k(uint32_t k,
+                                       const ITensorAttribute& attr_tensor,
+                                       const vespalib::eval::Value& query_tensor,
+                                       const GlobalFilter& filter,
+                                       double distance_threshold,
+                                       vespalib::ThreadBundle& thread_bundle,
+                                       const vespalib::Doom& doom)
+{
+    assert(filter.is_active());
+    std::vector<Neighbor> result;
+    uint32_t docid_limit = std::min(filter.size(), attr_tensor.get_num_docs());
+    if ((k == 0) || (docid_limit <= 1)) {
+        return result;
+    }
+    uint32_t num_threads = thread_bundle.size();
+    std::vector<SearchPart> parts;
+    parts.reserve(num_threads);
+    uint32_t docid = 1;
+    uint32_t per_thread = (docid_limit - docid) / num_threads;
+    uint32_t rest_docs = (docid_limit - docid) % num_threads;
+    while (docid < docid_limit) {
+        uint32_t part_size = per_thread + (parts.size() < rest_docs);
+        parts.emplace_back(k, attr_tensor, query_tensor, filter, distance_threshold, doom, docid, docid + part_size);
+        docid += part_size;
+    }
+    thread_bundle.run(parts);
+    for (const auto& part : parts) {
+        result.insert(result.end(), part.heap.begin(), part.heap.end());
+    }
+    if (result.size() > k) {
+        std::nth_element(result.begin(), result.begin() + (k - 1), result.end(), CloserFirst());
+        result.resize(k);
+    }
+    std::sort(result.begin(), result.end(), [](const Neighbor& lhs, const Neighbor& rhs) noexcept { return lhs.docid < rhs.docid; });
+    return result;
+}
+
+}
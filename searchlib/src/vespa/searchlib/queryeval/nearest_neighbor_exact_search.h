@@ -0,0 +1,47 @@
+// Copyright Vespa.ai. Licensed under the terms of the Apache 2.0 license. See LICENSE in the project root.
+
+#pragma once
+
+#include <vespa/searchlib/tensor/nearest_neighbor_index.h>
+#include <vector>
+
+namespace search::tensor { class ITensorAttribute; }
+namespace vespalib { class Doom; struct ThreadBundle; }
+namespace vespalib::eval { struct Value; }
+
+namespace search::queryeval {
+
+class GlobalFilter;
+
+/**
+ * Exact nearest neighbor search over the documents passing an active
+ * global filter, used instead of a per match thread search iterator
+ * when a restrictive filter makes the nearest neighbor blueprint fall
+ * back to exact search.
+ *
+ * The docid space is split between the threads of the thread bundle.
+ * Each thread walks the filter hits in its range in small batches,
+ * prefetching the vectors of a batch before calculating the distances,
+ * and keeps its own top k heap. The heaps are merged to the k closest
+ * documents at the end.
+ */
+class NearestNeighborExactSearch {
+public:
+    using Neighbor = search::tensor::NearestNeighborIndex::Neighbor;
+
+    /**
+     * Returns the (at most) k closest documents passing the filter,
+     * with distance within the given (internal) distance threshold,
+     * sorted on docid. The search stops early if the soft doom is
+     * reached, returning the closest documents found so far.
+     */
+    static std::vector<Neighbor> find_top_k(uint32_t k,
+                                            const search::tensor::ITensorAttribute& attr_tensor,
+                                            const vespalib::eval::Value& query_tensor,
+                                            const GlobalFilter& filter,
+                                            double distance_threshold,
+                                            vespalib::ThreadBundle& thread_bundle,
+                                            const vespalib::Doom& doom);
+};
+
+}
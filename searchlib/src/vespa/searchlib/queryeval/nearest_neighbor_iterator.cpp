@@ -32,6 +32,7 @@ public:
     ~NearestNeighborImpl();
 
     void doSeek(uint32_t docId) override {
+        // brute-force scanning may give up when soft doomed, see set_soft_doom
         double distanceLimit = params().distanceHeap.distanceLimit();
         while (__builtin_expect((docId < getEndId()), true)) {
             if ((!has_filter) || params().filter.check(docId)) {
@@ -43,6 +44,9 @@ public:
                 }
             }
             if (strict) {
+                if (soft_doomed(soft_doom(), docId)) {
+                    break;
+                }
                 ++docId;
             } else {
                 return;
@@ -40,7 +40,8 @@ public:
     };
 
     NearestNeighborIterator(Params params_in)
-        : _params(std::move(params_in))
+        : _params(std::move(params_in)),
+          _soft_doom(nullptr)
     {}
 
     static std::unique_ptr<NearestNeighborIterator> create(
@@ -51,8 +52,12 @@ public:
             const GlobalFilter &filter);
 
     const Params& params() const { return _params; }
+    void set_soft_doom(const vespalib::Doom &doom) override { _soft_doom = &doom; }
+protected:
+    const vespalib::Doom *soft_doom() const noexcept { return _soft_doom; }
 private:
     Params _params;
+    const vespalib::Doom *_soft_doom;
 };
 
 } // namespace
@@ -1,5 +1,6 @@
 // Copyright Vespa.ai. Licensed under the terms of the Apache 2.0 license. See LICENSE in the project root.
 #include "nearsearch.h"
+#include "position_keys.h"
 #include <vespa/vespalib/objects/visit.h>
 #include <vespa/vespalib/util/priority_queue.h>
 #include <limits>
@@ -13,7 +14,6 @@ namespace search::queryeval {
 namespace {
 
 using search::fef::TermFieldMatchDataArray;
-using search::fef::TermFieldMatchDataPositionKey;
 
 template<typename T>
 void setup_fields(uint32_t window, std::vector<T> &matchers, const TermFieldMatchDataArray &in, uint32_t terms) {
@@ -41,6 +41,24 @@ NearSearchBase::NearSearchBase(Children terms,
 {
 }
 
+bool
+NearSearchBase::MatcherBase::decode_positions(uint32_t docId)
+{
+    _keys.clear();
+    _key_offsets.clear();
+    _key_offsets.push_back(0);
+    for (uint32_t i = 0, len = _inputs.size(); i < len; ++i) {
+        const search::fef::TermFieldMatchData *term = _inputs[i];
+        if (term->getDocId() != docId || term->begin() == term->end()) {
+            LOG(debug, "No occurrences found for term %d.", i);
+            return false;
+        }
+        position_keys::append_keys(*term, 0, _keys);
+        _key_offsets.push_back(_keys.size());
+    }
+    return true;
+}
+
 void
 NearSearchBase::visitMembers(vespalib::ObjectVisitor &visitor) const
 {
@@ -134,32 +152,32 @@ NearSearch::NearSearch(Children terms,
 namespace {
 
 struct PosIter {
-    search::fef::TermFieldMatchData::PositionsIterator curPos;
-    search::fef::TermFieldMatchData::PositionsIterator endPos;
+    const uint64_t *curPos;
+    const uint64_t *endPos;
 
     bool operator< (const PosIter &other) const {
         // assumes none is at end
-        TermFieldMatchDataPositionKey mykey = *curPos;
-        TermFieldMatchDataPositionKey otherkey = *other.curPos;
-        return mykey < otherkey;
+        return *curPos < *other.curPos;
     }
 };
 
 struct Iterators
 {
     vespalib::PriorityQueue<PosIter> _queue;
-    TermFieldMatchDataPositionKey _maxOcc;
+    uint64_t _maxOcc;
+
+    Iterators() : _queue(), _maxOcc(0) {}
 
-    void update(TermFieldMatchDataPositionKey occ)
+    void update(uint64_t occ)
     {
         if (_queue.size() == 1 || _maxOcc < occ) { _maxOcc = occ; }
     }
 
-    void add(const search::fef::TermFieldMatchData *term)
+    void add(const uint64_t *begin, const uint64_t *end)
     {
         PosIter iter;
-        iter.curPos = term->begin();
-        iter.endPos = term->end();
+        iter.curPos = begin;
+        iter.endPos = end;
         LOG_ASSERT(iter.curPos != iter.endPos);
         _queue.push(iter);
         update(*iter.curPos);
@@ -168,10 +186,7 @@ struct Iterators
     bool match(uint32_t window) {
         for (;;) {
             PosIter &front = _queue.front();
-            TermFieldMatchDataPositionKey lastAllowed = *front.curPos;
-            lastAllowed.setPosition(front.curPos->getPosition() + window);
-
-            if (!(lastAllowed < _maxOcc)) {
+            if (!(position_keys::window_end(*front.curPos, window) < _maxOcc)) {
                 return true;
             }
             do {
@@ -179,9 +194,7 @@ struct Iterators
                 if (front.curPos == front.endPos) {
                     return false;
                 }
-                lastAllowed = *front.curPos;
-                lastAllowed.setPosition(front.curPos->getPosition() + window);
-            } while (lastAllowed < _maxOcc);
+            } while (position_keys::window_end(*front.curPos, window) < _maxOcc);
 
             update(*front.curPos);
             _queue.adjust();
@@ -194,15 +207,12 @@ struct Iterators
 bool
 NearSearch::Matcher::match(uint32_t docId)
 {
+    if (!decode_positions(docId)) {
+        return false;
+    }
     Iterators pos;
     for (uint32_t i = 0, len = inputs().size(); i < len; ++i) {
-        const search::fef::TermFieldMatchData *term = inputs()[i];
-        if (term->getDocId() != docId || term->begin() == term->end()) {
-            LOG(debug, "No occurrences found for term %d.", i);
-            return false;
-        }
-        LOG(debug, "Got positions iterator for term %d.", i);
-        pos.add(term);
+        pos.add(keys_begin(i), keys_end(i));
     }
 
     // Look for matching window.
@@ -235,43 +245,40 @@ ONearSearch::ONearSearch(Children terms,
 bool
 ONearSearch::Matcher::match(uint32_t docId)
 {
-    uint32_t numTerms = inputs().size();
-    PositionsIteratorList pos;
-    for (uint32_t i = 0; i < numTerms; ++i) {
-        const search::fef::TermFieldMatchData *term = inputs()[i];
-        if (term->getDocId() != docId || term->begin() == term->end()) {
-            LOG(debug, "No occurrences found for term %d.", i);
-            return false;
-        }
-        LOG(debug, "Got positions iterator for term %d.", i);
-        pos.push_back(term->begin());
+    if (!decode_positions(docId)) {
+        return false;
     }
+    uint32_t numTerms = inputs().size();
     if (numTerms < 2) return true; // 1 term is always near itself
 
-    int32_t remain = window();
+    std::vector<const uint64_t *> pos;
+    for (uint32_t i = 0; i < numTerms; ++i) {
+        pos.push_back(keys_begin(i));
+    }
+    uint32_t remain = window();
 
-    TermFieldMatchDataPositionKey prevTermPos;
-    TermFieldMatchDataPositionKey curTermPos;
-    TermFieldMatchDataPositionKey lastAllowed;
+    uint64_t prevTermPos = 0;
+    uint64_t curTermPos = 0;
+    uint64_t lastAllowed = 0;
 
     // Look for match for every occurrence of the first term.
-    for ( ; pos[0] != inputs()[0]->end(); ++pos[0]) {
-        TermFieldMatchDataPositionKey firstTermPos = *pos[0];
-        lastAllowed = firstTermPos;
-        lastAllowed.setPosition(firstTermPos.getPosition() + remain);
+    for ( ; pos[0] != keys_end(0); ++pos[0]) {
+        uint64_t firstTermPos = *pos[0];
+        lastAllowed = position_keys::window_end(firstTermPos, remain);
         if (lastAllowed < curTermPos) {
             // if we already know that we must seek onwards:
             continue;
         }
         prevTermPos = firstTermPos;
         LOG(spam, "Looking for match in window [%d, %d].",
-            firstTermPos.getPosition(), lastAllowed.getPosition());
+            position_keys::position(firstTermPos), position_keys::position(lastAllowed));
         for (uint32_t i = 1; i < numTerms; ++i) {
-            LOG(spam, "Forwarding iterator for term %d beyond %d.", i, prevTermPos.getPosition());
-            while (pos[i] != inputs()[i]->end() && !(prevTermPos < *pos[i])) {
+            LOG(spam, "Forwarding iterator for term %d beyond %d.", i, position_keys::position(prevTermPos));
+            const uint64_t *end = keys_end(i);
+            while (pos[i] != end && *pos[i] <= prevTermPos) {
                 ++pos[i];
             }
-            if (pos[i] == inputs()[i]->end()) {
+            if (pos[i] == end) {
                 LOG(debug, "Reached end of occurrences for term %d without matching ONEAR.", i);
                 return false;
             }
@@ -280,7 +287,7 @@ ONearSearch::Matcher::match(uint32_t docId)
                 // outside window
                 break;
             }
-            LOG(spam, "Current position for term %d is %d.", i, curTermPos.getPosition());
+            LOG(spam, "Current position for term %d is %d.", i, position_keys::position(curTermPos));
             if (i + 1 == numTerms) {
                 LOG(debug, "ONEAR match found for document %d.", docId);
                 // OK for all terms
@@ -25,12 +25,26 @@ protected:
         uint32_t                _window;
         TermFieldMatchDataArray _inputs;
     protected:
+        // Position keys (see position_keys.h) of all terms, back to back.
+        // Reused across documents instead of allocating new ones when needed.
+        std::vector<uint64_t>   _keys;
+        std::vector<size_t>     _key_offsets;
+
         uint32_t window() const { return _window; }
         const TermFieldMatchDataArray &inputs() const { return _inputs; }
+        /**
+         * Decodes the positions of all terms into position keys. Returns false if
+         * some term has no occurrences in the given document.
+         */
+        bool decode_positions(uint32_t docId);
+        const uint64_t *keys_begin(uint32_t term) const { return _keys.data() + _key_offsets[term]; }
+        const uint64_t *keys_end(uint32_t term) const { return _keys.data() + _key_offsets[term + 1]; }
     public:
         MatcherBase(uint32_t win, uint32_t fieldId, const TermFieldMatchDataArray &in)
             : _window(win),
-              _inputs()
+              _inputs(),
+              _keys(),
+              _key_offsets()
         {
             for (size_t i = 0; i < in.size(); ++i) {
                 if (in[i]->getFieldId() == fieldId) {
@@ -40,11 +54,6 @@ protected:
         }
     };
 
-    /**
-     * Typedef the list of positions iterators because it takes far too much space to write out :-)
-     */
-    using PositionsIteratorList = std::vector<search::fef::TermFieldMatchData::PositionsIterator>;
-
     /**
      * Returns whether or not given document matches. This should only be called when all child terms are all
      * at the same document.
@@ -32,6 +32,24 @@ protected:
             setDocId(minNextId);
         }
     }
+    uint32_t fill_hits(uint32_t docid, uint32_t end_id, uint32_t *hits, uint32_t max_hits) override {
+        if constexpr (strict) {
+            uint32_t num_hits = 0;
+            if (docid > getDocId()) {
+                OrLikeSearch::doSeek(docid);
+            }
+            for (docid = getDocId(); docid < end_id; docid = getDocId()) {
+                hits[num_hits++] = docid;
+                if (num_hits == max_hits) {
+                    break;
+                }
+                OrLikeSearch::doSeek(docid + 1);
+            }
+            return num_hits;
+        } else {
+            return SearchIterator::fill_hits(docid, end_id, hits, max_hits);
+        }
+    }
     Trinary is_strict() const override { return strict ? Trinary::True : Trinary::False; }
     void visitMembers(vespalib::ObjectVisitor &visitor) const override {
         MultiSearch::visitMembers(visitor);
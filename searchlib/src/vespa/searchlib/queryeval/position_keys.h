@@ -0,0 +1,80 @@
+// Copyright Vespa.ai. Licensed under the terms of the Apache 2.0 license. See LICENSE in the project root.
+
+#pragma once
+
+#include <vespa/searchlib/fef/termfieldmatchdata.h>
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <vector>
+
+namespace search::queryeval::position_keys {
+
+/**
+ * Utilities used by phrase and near matching to work on the positions of a
+ * term in a document as a compact array of 64-bit keys (element id in the
+ * upper half, position in the lower half) instead of iterating the much
+ * larger TermFieldMatchDataPosition objects. Keys order the same way as
+ * TermFieldMatchDataPositionKey, so merging positions is done with plain
+ * integer compares.
+ */
+
+inline uint64_t make_key(uint32_t element_id, uint32_t position) noexcept {
+    return (uint64_t(element_id) << 32) | position;
+}
+
+inline uint64_t make_key(const fef::TermFieldMatchDataPosition &pos) noexcept {
+    return make_key(pos.getElementId(), pos.getPosition());
+}
+
+inline uint32_t position(uint64_t key) noexcept {
+    return uint32_t(key);
+}
+
+/**
+ * Returns the key of the last position in the same element that is within
+ * the given window after the key (saturating at the end of the element).
+ */
+inline uint64_t window_end(uint64_t key, uint32_t window) noexcept {
+    uint32_t room = std::numeric_limits<uint32_t>::max() - position(key);
+    return key + ((window < room) ? window : room);
+}
+
+/**
+ * Appends the keys of all positions of the term, shifted 'offset' positions
+ * towards the start of the element. Positions closer than 'offset' to the start
+ * of the element are skipped. Used to align the positions of the term at
+ * index 'offset' in a phrase with the start of the phrase.
+ */
+inline void append_keys(const fef::TermFieldMatchData &tmd, uint32_t offset, std::vector<uint64_t> &keys) {
+    keys.reserve(keys.size() + tmd.size());
+    for (const auto &pos : tmd) {
+        if (pos.getPosition() >= offset) {
+            keys.push_back(make_key(pos) - offset);
+        }
+    }
+}
+
+/**
+ * Keeps the keys in 'keys' that are also present in 'other' (both sorted),
+ * preserving duplicates in 'keys'. Returns the number of keys kept, which are
+ * compacted at the start of 'keys'. The merge is branch free; each step
+ * advances one side based on compare results, avoiding mispredicted branches
+ * when positions are interleaved.
+ */
+inline size_t intersect(uint64_t *keys, size_t num_keys, const uint64_t *other, size_t num_other) noexcept {
+    size_t i = 0;
+    size_t j = 0;
+    size_t out = 0;
+    while (i < num_keys && j < num_other) {
+        uint64_t a = keys[i];
+        uint64_t b = other[j];
+        keys[out] = a;
+        out += (a == b);
+        i += (a <= b);
+        j += (b < a);
+    }
+    return out;
+}
+
+}
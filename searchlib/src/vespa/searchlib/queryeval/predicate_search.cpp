@@ -4,6 +4,7 @@
 #include <vespa/searchlib/fef/termfieldmatchdata.h>
 #include <vespa/searchlib/fef/termfieldmatchdataarray.h>
 #include <algorithm>
+#include <cstring>
 
 using search::fef::TermFieldMatchData;
 using search::fef::TermFieldMatchDataArray;
@@ -20,49 +21,61 @@ namespace search::queryeval {
 namespace {
 
 #ifdef __x86_64__
+/**
+ * Finds the documents where the number of matching features (kv) reaches the
+ * min feature of the document, comparing 64 documents per step.
+ */
 class SkipMinFeatureSSE2 : public SkipMinFeature
 {
 public:
     SkipMinFeatureSSE2(const uint8_t * min_feature, const uint8_t * kv, size_t sz);
 private:
-    typedef char v16u8 __attribute__((vector_size(16)));
+    typedef unsigned char v16u8 __attribute__((vector_size(16)));
+    typedef char v16i8 __attribute__((vector_size(16)));
     uint32_t next() override;
-    uint32_t cmp32(size_t j) {
-        v16u8 r0 = _kv[j*2] >= _min_feature[j*2];
-        v16u8 r1 = _kv[j*2+1] >= _min_feature[j*2+1];
-        return __builtin_ia32_pmovmskb128(r0) | (__builtin_ia32_pmovmskb128(r1) << 16);
+    static v16u8 load(const uint8_t * p) {
+        v16u8 v;
+        memcpy(&v, p, sizeof(v));
+        return v;
+    }
+    uint64_t cmp64(size_t j) {
+        uint64_t mask = 0;
+        for (size_t i = 0; i < 4; i++) {
+            size_t offset = (j << 6) + (i << 4);
+            v16i8 r = (v16i8)(load(_kv + offset) >= load(_min_feature + offset));
+            mask |= uint64_t(uint16_t(__builtin_ia32_pmovmskb128(r))) << (i << 4);
+        }
+        return mask;
     }
     void advance();
-    const v16u8 * _min_feature;
-    const v16u8 * _kv;
+    const uint8_t * _min_feature;
+    const uint8_t * _kv;
     uint32_t _sz;
     uint32_t _chunk;
-    uint32_t _last32;
+    uint64_t _last64;
 };
 
 SkipMinFeatureSSE2::SkipMinFeatureSSE2(const uint8_t * min_feature, const uint8_t * kv, size_t sz) :
-    _min_feature(reinterpret_cast<const v16u8 *>(min_feature)),
-    _kv(reinterpret_cast<const v16u8 *>(kv)),
+    _min_feature(min_feature),
+    _kv(kv),
     _sz(sz),
     _chunk(0),
-    _last32(0)
+    _last64(0)
 {
     advance();
     if (_chunk == 1) {
-        _last32 &= ~0x1;
+        _last64 &= ~uint64_t(0x1);
     }
 }
 
 void
 SkipMinFeatureSSE2::advance()
 {
-    for (;(_last32 == 0) && (_chunk < (_sz>>5)); _last32 = cmp32(_chunk++));
-    if (_last32 == 0) {
-        const uint8_t * min_feature = reinterpret_cast<const uint8_t *>(_min_feature);
-        const uint8_t * kv = reinterpret_cast<const uint8_t *>(_kv);
-        for (size_t i(_chunk << 5); i < _sz; i++) {
-            if (kv[i] >= min_feature[i]) {
-                _last32 |= 1 << (i - (_chunk << 5));
+    for (;(_last64 == 0) && (_chunk < (_sz>>6)); _last64 = cmp64(_chunk++));
+    if (_last64 == 0) {
+        for (size_t i(_chunk << 6); i < _sz; i++) {
+            if (_kv[i] >= _min_feature[i]) {
+                _last64 |= uint64_t(1) << (i - (_chunk << 6));
             }
         }
         _chunk++;
@@ -72,13 +85,13 @@ SkipMinFeatureSSE2::advance()
 uint32_t
 SkipMinFeatureSSE2::next()
 {
-    if (__builtin_expect(_last32 == 0, true)) {
+    if (__builtin_expect(_last64 == 0, true)) {
         advance();
     }
-    if (_last32) {
-        uint32_t n = vespalib::Optimized::lsbIdx(_last32);
-        _last32 &= ~(1 << n);
-        n += ((_chunk - 1) << 5);
+    if (_last64) {
+        uint32_t n = vespalib::Optimized::lsbIdx(_last64);
+        _last64 &= (_last64 - 1);
+        n += ((_chunk - 1) << 6);
         return n < _sz ? n : -1;
     } else {
         return -1;
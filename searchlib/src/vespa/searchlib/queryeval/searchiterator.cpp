@@ -87,6 +87,19 @@ SearchIterator::and_hits_into(BitVector &result, uint32_t begin_id)
     }
 }
 
+uint32_t
+SearchIterator::fill_hits(uint32_t docid, uint32_t end_id, uint32_t *hits, uint32_t max_hits)
+{
+    uint32_t num_hits = 0;
+    for (docid = seekFirst(docid); docid < end_id; docid = seekNext(docid + 1)) {
+        hits[num_hits++] = docid;
+        if (num_hits == max_hits) {
+            break;
+        }
+    }
+    return num_hits;
+}
+
 vespalib::string
 SearchIterator::asString() const
 {
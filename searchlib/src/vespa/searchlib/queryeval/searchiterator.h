@@ -5,6 +5,7 @@
 #include "posting_info.h"
 #include "begin_and_end_id.h"
 #include <vespa/vespalib/stllike/string.h>
+#include <vespa/vespalib/util/doom.h>
 #include <vespa/vespalib/util/trinary.h>
 #include <memory>
 #include <vector>
@@ -72,6 +73,20 @@ protected:
      */
     void setAtEnd() noexcept { _docid = search::endDocId; }
 
+    /**
+     * Used by iterators scanning many documents within a single seek
+     * (see @ref set_soft_doom) to check for soft doom. The clock is
+     * only looked at every soft_doom_interval docids to keep the
+     * check cheap.
+     *
+     * @param doom soft doom to check, may be nullptr
+     * @param docid the docid currently being scanned
+     **/
+    static constexpr uint32_t soft_doom_interval = 4096;
+    static bool soft_doomed(const vespalib::Doom *doom, uint32_t docid) noexcept {
+        return (((docid % soft_doom_interval) == 0) && (doom != nullptr) && doom->soft_doom());
+    }
+
 public:
     using Trinary=vespalib::Trinary;
     // doSeek and doUnpack are called by templated classes, so making
@@ -174,6 +189,24 @@ public:
      **/
     virtual void and_hits_into(BitVector &result, uint32_t begin_id);
 
+    /**
+     * Collect hits in increasing docid order into the given buffer,
+     * starting at the given docid and stopping before end_id or when
+     * max_hits hits have been collected. This lets the caller
+     * evaluate a block of documents at a time instead of paying for a
+     * virtual seek call per hit. The iterator is left positioned on
+     * the last hit returned, so that hit can still be unpacked. Note
+     * that this requires the iterator to be strict. The default
+     * implementation seeks one document at a time.
+     *
+     * @return number of hits written to the buffer
+     * @param docid the lowest document id that may be a hit
+     * @param end_id the first document id not to be collected
+     * @param hits buffer with room for at least max_hits document ids
+     * @param max_hits maximum number of hits to collect (must be > 0)
+     **/
+    virtual uint32_t fill_hits(uint32_t docid, uint32_t end_id, uint32_t *hits, uint32_t max_hits);
+
 public:
     using UP = std::unique_ptr<SearchIterator>;
 
@@ -281,6 +314,17 @@ public:
      **/
     virtual const PostingInfo *getPostingInfo() const { return nullptr; }
 
+    /**
+     * Cooperative cancellation for expensive leaf iterators that scan
+     * documents one by one within a single strict seek. When the
+     * given doom is soft doomed the iterator may stop scanning and
+     * jump to the end, leaving the documents after the last hit
+     * unevaluated. The match loop accounts for this by only reporting
+     * coverage up to the last hit when soft doomed. The doom must
+     * outlive the iterator. Ignored by default.
+     **/
+    virtual void set_soft_doom(const vespalib::Doom &) {}
+
     /**
      * Create a human-readable representation of this object. This
      * method will use object visitation internally to capture the
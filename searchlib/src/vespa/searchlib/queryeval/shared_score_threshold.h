@@ -0,0 +1,39 @@
+// Copyright Vespa.ai. Licensed under the terms of the Apache 2.0 license. See LICENSE in the project root.
+
+#pragma once
+
+#include <vespa/searchlib/common/feature.h>
+#include <atomic>
+#include <limits>
+
+namespace search::queryeval {
+
+/**
+ * A score threshold that can be shared between match threads. Each
+ * thread publishes the lowest score a hit must have to be among its own
+ * best hits, and all threads can use the highest published score to
+ * prune hits that cannot make it into the best hits of the query. The
+ * threshold never decreases and is updated and read without locking.
+ **/
+class SharedScoreThreshold {
+private:
+    std::atomic<feature_t> _threshold;
+public:
+    SharedScoreThreshold() noexcept
+        : _threshold(-std::numeric_limits<feature_t>::max())
+    {
+    }
+    feature_t get() const noexcept { return _threshold.load(std::memory_order_relaxed); }
+    // Raise the threshold to the given score. Returns false if it was already at least that high.
+    bool publish(feature_t score) noexcept {
+        feature_t old_threshold = get();
+        while (score > old_threshold) {
+            if (_threshold.compare_exchange_weak(old_threshold, score, std::memory_order_relaxed)) {
+                return true;
+            }
+        }
+        return false;
+    }
+};
+
+}
@@ -1,6 +1,7 @@
 // Copyright Vespa.ai. Licensed under the terms of the Apache 2.0 license. See LICENSE in the project root.
 
 #include "simple_phrase_search.h"
+#include "position_keys.h"
 #include <vespa/searchlib/fef/termfieldmatchdata.h>
 #include <vespa/vespalib/objects/visit.h>
 #include <functional>
@@ -18,90 +19,46 @@ namespace {
 class PhraseMatcher {
     const fef::TermFieldMatchDataArray &_tmds;
     const vector<uint32_t> &_eval_order;
-    vector<TermFieldMatchData::PositionsIterator> &_iterators;
-    uint32_t _element_id;
-    uint32_t _position;
-
-    TermFieldMatchData::PositionsIterator &iterator(uint32_t word_index) {
-        return _iterators[word_index];
-    }
-
-    TermFieldMatchData::PositionsIterator end(uint32_t word_index) {
-        return _tmds[word_index]->end();
-    }
-
-    uint32_t elementId(uint32_t word_index) {
-        return iterator(word_index)->getElementId();
-    }
-
-    uint32_t position(uint32_t word_index) {
-        return iterator(word_index)->getPosition();
-    }
-
-    void iterateToElement(uint32_t word_index) {
-        while (iterator(word_index) != end(word_index) &&
-               elementId(word_index) < _element_id) {
-            ++iterator(word_index);
-        }
-    }
-
-    template <typename FwdIt>
-    bool match(FwdIt first, FwdIt last) {
-        if (first == last) {
-            return true;
-        }
-        uint32_t word_index = *first;
-
-        iterateToElement(word_index);
-        while (iterator(word_index) != end(word_index) &&
-               elementId(word_index) == _element_id) {
-            if (position(word_index) == _position + word_index) {
-                return match(++first, last);
-            } else if (position(word_index) > _position + word_index) {
-                return false;
-            }
-            ++iterator(word_index);
-        }
-        return false;
-    }
-
-    bool match() {
-        _element_id = elementId(_eval_order[0]);
-        if (position(_eval_order[0]) < _eval_order[0]) {
-            // this position too early in element to allow match of other phrase terms
-            return false;
+    vector<uint64_t> &_candidates;
+    vector<uint64_t> &_keys;
+
+    /*
+     * Leaves the keys of the phrase start positions (i.e. the positions of
+     * the first phrase term) that have all phrase terms following them in
+     * _candidates. Candidates are found by intersecting the positions of
+     * each term, shifted back by the index of the term in the phrase.
+     */
+    void findMatches() {
+        _candidates.clear();
+        position_keys::append_keys(*_tmds[_eval_order[0]], _eval_order[0], _candidates);
+        size_t num_candidates = _candidates.size();
+        for (size_t i = 1; i < _eval_order.size() && num_candidates > 0; ++i) {
+            uint32_t word_index = _eval_order[i];
+            _keys.clear();
+            position_keys::append_keys(*_tmds[word_index], word_index, _keys);
+            num_candidates = position_keys::intersect(_candidates.data(), num_candidates, _keys.data(), _keys.size());
         }
-        _position = position(_eval_order[0]) - _eval_order[0];
-        return match(++_eval_order.begin(), _eval_order.end());
+        _candidates.resize(num_candidates);
     }
 
 public:
     PhraseMatcher(const fef::TermFieldMatchDataArray &tmds,
                   const vector<uint32_t> &eval_order,
-                  vector<TermFieldMatchData::PositionsIterator> &iterators)
+                  vector<uint64_t> &candidates,
+                  vector<uint64_t> &keys)
         : _tmds(tmds),
           _eval_order(eval_order),
-          _iterators(iterators),
-          _element_id(0),
-          _position(0)
+          _candidates(candidates),
+          _keys(keys)
     {
-        for (size_t i = 0; i < _tmds.size(); ++i) {
-            _iterators[i] = _tmds[i]->begin();
-        }
     }
 
     bool hasMatch() {
         if (_tmds.size() == 1) {
             return true;
         }
-
-        while (iterator(_eval_order[0]) != end(_eval_order[0])) {
-            if (match()) {
-                return true;
-            }
-            ++iterator(_eval_order[0]);
-        }
-        return false;
+        findMatches();
+        return !_candidates.empty();
     }
 
     void fillPositions(TermFieldMatchData &tmd) {
@@ -116,19 +73,18 @@ public:
                 tmd.setFieldLength(_tmds[0]->getFieldLength());
             }
         } else {
-            const bool needs_normal_features = tmd.needs_normal_features();
-            uint32_t num_occs = 0;
-            while (iterator(_eval_order[0]) != end(_eval_order[0])) {
-                if (match()) {
-                    if (needs_normal_features) {
-                        tmd.appendPosition(*iterator(0));
+            findMatches();
+            if (tmd.needs_normal_features()) {
+                auto it = _tmds[0]->begin();
+                for (uint64_t candidate : _candidates) {
+                    while (position_keys::make_key(*it) < candidate) {
+                        ++it;
                     }
-                    ++num_occs;
+                    tmd.appendPosition(*it);
                 }
-                ++iterator(_eval_order[0]);
             }
             if (tmd.needs_interleaved_features()) {
-                tmd.setNumOccs(num_occs);
+                tmd.setNumOccs(_candidates.size());
                 tmd.setFieldLength(_tmds[0]->getFieldLength());
             }
         }
@@ -156,7 +112,7 @@ SimplePhraseSearch::phraseSeek(uint32_t doc_id) {
 void
 SimplePhraseSearch::matchPhrase(uint32_t doc_id) {
     AndSearch::doUnpack(doc_id);
-    if (PhraseMatcher(_childMatch, _eval_order, _iterators).hasMatch()) {
+    if (PhraseMatcher(_childMatch, _eval_order, _candidates, _keys).hasMatch()) {
         setDocId(doc_id);
     }
 }
@@ -173,7 +129,8 @@ SimplePhraseSearch::SimplePhraseSearch(Children children,
       _eval_order(std::move(eval_order)),
       _tmd(tmd),
       _strict(strict),
-      _iterators(getChildren().size())
+      _candidates(),
+      _keys()
 {
     assert( ! getChildren().empty());
     assert(getChildren().size() == _childMatch.size());
@@ -210,7 +167,7 @@ SimplePhraseSearch::doUnpack(uint32_t doc_id) {
     // All children have already been unpacked before this call is made.
 
     _tmd.reset(doc_id);
-    PhraseMatcher(_childMatch, _eval_order, _iterators).fillPositions(_tmd);
+    PhraseMatcher(_childMatch, _eval_order, _candidates, _keys).fillPositions(_tmd);
 }
 
 void
@@ -23,9 +23,10 @@ class SimplePhraseSearch : public AndSearch
     fef::TermFieldMatchData     &_tmd;
     bool                         _strict;
 
-    using It = fef::TermFieldMatchData::PositionsIterator;
-    // Reuse this vector instead of allocating a new one when needed.
-    std::vector<It> _iterators;
+    // Position keys of phrase matches and of the term being merged in.
+    // Reuse these vectors instead of allocating new ones when needed.
+    std::vector<uint64_t>        _candidates;
+    std::vector<uint64_t>        _keys;
 
     VESPA_DLL_LOCAL void phraseSeek(uint32_t doc_id);
     VESPA_DLL_LOCAL void matchPhrase(uint32_t doc_id) __attribute__((noinline));
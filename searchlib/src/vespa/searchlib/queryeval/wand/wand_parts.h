@@ -179,6 +179,8 @@ public:
 
     uint32_t seek(uint16_t ref, uint32_t docid) { return _iteratorPack.seek(ref, docid); }
     int32_t get_weight(uint16_t ref, uint32_t docid) { return _iteratorPack.get_weight(ref, docid); }
+    int32_t get_block_max_weight(uint16_t ref) const { return _iteratorPack.get_block_max_weight(ref); }
+    docid_t get_block_end(uint16_t ref) const { return _iteratorPack.get_block_end(ref); }
 
     vespalib::string stringify_docid() const;
 };
@@ -447,6 +449,15 @@ struct DotProductScorer
     static score_t calculateScore(VectorizedTerms &terms, ref_t ref, docid_t docId) {
         return terms.weight(ref) * (score_t)terms.get_weight(ref, docId);
     }
+
+    // Upper bound for the score of the term within the posting list block it is positioned in
+    template <typename VectorizedTerms>
+    static score_t calculate_block_max_score(const VectorizedTerms &terms, ref_t ref) {
+        if (terms.weight(ref) < 0) {
+            return terms.maxScore(ref);
+        }
+        return std::min(terms.maxScore(ref), terms.weight(ref) * (score_t)terms.get_block_max_weight(ref));
+    }
 };
 
 //-----------------------------------------------------------------------------
@@ -630,6 +641,31 @@ public:
         return false;
     }
 
+    /**
+     * Check if the candidate can score above the threshold when present
+     * terms use the max score of the posting list block they are
+     * positioned in. If not, no document before the end of the first of
+     * these blocks or before the first future term can score above the
+     * threshold, and next_candidate is set to the document after them.
+     */
+    template <typename VectorizedTerms, typename Heaps, typename Scorer, typename AboveThreshold>
+    bool check_block_max_score(VectorizedTerms &terms, Heaps &heaps, const Scorer &, AboveThreshold &&aboveThreshold,
+                               docid_t &next_candidate)
+    {
+        score_t max_score = _maxUpperBound;
+        docid_t last = heaps.has_future() ? (terms.docId(heaps.future()) - 1) : (search::endDocId - 1);
+        ref_t *end = heaps.present_end();
+        for (ref_t *ref = heaps.present_begin(); ref != end; ++ref) {
+            max_score -= (terms.maxScore(*ref) - Scorer::calculate_block_max_score(terms, *ref));
+            last = std::min(last, terms.get_block_end(*ref));
+        }
+        if (aboveThreshold(max_score)) {
+            return true;
+        }
+        next_candidate = last + 1;
+        return false;
+    }
+
     template <typename VectorizedTerms, typename Heaps, typename Scorer>
     score_t get_full_score(VectorizedTerms &terms, Heaps &heaps, Scorer &&) {
         score_t score = _partial_score;
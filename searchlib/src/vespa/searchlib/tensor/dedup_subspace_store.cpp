@@ -0,0 +1,82 @@
+// Copyright Vespa.ai. Licensed under the terms of the Apache 2.0 license. See LICENSE in the project root.
+
+#include "dedup_subspace_store.h"
+#include <vespa/vespalib/stllike/hash_fun.h>
+#include <vespa/vespalib/util/memoryusage.h>
+#include <cassert>
+#include <cstring>
+
+using vespalib::datastore::EntryRef;
+using vespalib::eval::TypedCells;
+
+namespace search::tensor {
+
+DedupSubspaceStore::DedupSubspaceStore(const vespalib::eval::ValueType& subspace_type, std::shared_ptr<vespalib::alloc::MemoryAllocator> allocator)
+    : _cells(subspace_type, std::move(allocator)),
+      _index()
+{
+}
+
+DedupSubspaceStore::~DedupSubspaceStore() = default;
+
+uint64_t
+DedupSubspaceStore::hash_cells(const void* cells) const noexcept
+{
+    return vespalib::xxhash::xxh3_64(cells, _cells.getBufSize());
+}
+
+bool
+DedupSubspaceStore::equal_cells(EntryRef ref, const void* cells) const noexcept
+{
+    return memcmp(_cells.getRawBuffer(ref), cells, _cells.getBufSize()) == 0;
+}
+
+EntryRef
+DedupSubspaceStore::add(TypedCells cells)
+{
+    assert(cells.type == _cells.type().cell_type());
+    assert(cells.size == _cells.getNumCells());
+    auto hash = hash_cells(cells.data);
+    auto range = _index.equal_range(hash);
+    for (auto itr = range.first; itr != range.second; ++itr) {
+        if (equal_cells(itr->second.ref, cells.data)) {
+            ++itr->second.ref_count;
+            return itr->second.ref;
+        }
+    }
+    auto raw = _cells.allocRawBuffer();
+    memcpy(raw.data, cells.data, _cells.getBufSize());
+    _index.emplace(hash, Entry{raw.ref, 1u});
+    return raw.ref;
+}
+
+void
+DedupSubspaceStore::remove(EntryRef ref)
+{
+    const void* cells = _cells.getRawBuffer(ref);
+    auto range = _index.equal_range(hash_cells(cells));
+    for (auto itr = range.first; itr != range.second; ++itr) {
+        if (itr->second.ref == ref) {
+            if (--itr->second.ref_count == 0u) {
+                _index.erase(itr);
+                _cells.holdTensor(ref);
+            }
+            return;
+        }
+    }
+    assert(false && "removing unknown subspace");
+}
+
+vespalib::MemoryUsage
+DedupSubspaceStore::getMemoryUsage() const
+{
+    auto usage = _cells.getMemoryUsage();
+    // Approximation: node with key, entry and next pointer, plus bucket array
+    size_t index_bytes = _index.size() * (sizeof(std::pair<const uint64_t, Entry>) + sizeof(void*)) +
+                         _index.bucket_count() * sizeof(void*);
+    usage.incAllocatedBytes(index_bytes);
+    usage.incUsedBytes(index_bytes);
+    return usage;
+}
+
+}
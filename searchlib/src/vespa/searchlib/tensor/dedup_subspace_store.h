@@ -0,0 +1,46 @@
+// Copyright Vespa.ai. Licensed under the terms of the Apache 2.0 license. See LICENSE in the project root.
+
+#pragma once
+
+#include "dense_tensor_store.h"
+#include <unordered_map>
+
+namespace search::tensor {
+
+/**
+ * Content addressed store for the dense subspaces of mixed tensors, used by
+ * TensorBufferStore when subspaces are deduplicated. Identical subspaces
+ * are stored once and reference counted.
+ *
+ * The hash index and reference counts are only used by the writer thread.
+ * Readers access cells through entry refs, and cells of removed subspaces
+ * are kept on hold until readers are done.
+ */
+class DedupSubspaceStore
+{
+    using EntryRef = vespalib::datastore::EntryRef;
+    using generation_t = vespalib::GenerationHandler::generation_t;
+    struct Entry {
+        EntryRef ref;
+        uint32_t ref_count;
+    };
+    DenseTensorStore                         _cells;
+    std::unordered_multimap<uint64_t, Entry> _index; // keyed on hash of cells
+
+    uint64_t hash_cells(const void* cells) const noexcept;
+    bool equal_cells(EntryRef ref, const void* cells) const noexcept;
+public:
+    DedupSubspaceStore(const vespalib::eval::ValueType& subspace_type, std::shared_ptr<vespalib::alloc::MemoryAllocator> allocator);
+    ~DedupSubspaceStore();
+    // Returns ref to an existing identical subspace if present, bumping its reference count.
+    EntryRef add(vespalib::eval::TypedCells cells);
+    void remove(EntryRef ref);
+    vespalib::eval::TypedCells get(EntryRef ref) const noexcept { return _cells.get_typed_cells(ref); }
+    size_t num_unique_subspaces() const noexcept { return _index.size(); }
+    vespalib::MemoryUsage getMemoryUsage() const;
+    void reclaim_memory(generation_t oldest_used_gen) { _cells.reclaim_memory(oldest_used_gen); }
+    void assign_generation(generation_t current_gen) { _cells.assign_generation(current_gen); }
+    void reclaim_all_memory() { _cells.reclaim_all_memory(); }
+};
+
+}
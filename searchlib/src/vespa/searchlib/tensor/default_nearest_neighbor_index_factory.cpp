@@ -5,6 +5,7 @@
 #include "random_level_generator.h"
 #include "inv_log_level_generator.h"
 #include "distance_function_factory.h"
+#include "quantized_vector_store.h"
 #include <vespa/searchcommon/attribute/config.h>
 
 namespace search::tensor {
@@ -23,6 +24,18 @@ make_random_level_generator(uint32_t m)
     return std::make_unique<InvLogLevelGenerator>(m);
 }
 
+std::unique_ptr<QuantizedVectorStore>
+make_quantized_vector_store(size_t vector_size, const search::attribute::HnswIndexParams& params)
+{
+    if (params.quantization() == search::attribute::VectorQuantization::None ||
+        !QuantizedVectorStore::supports(params.distance_metric()) ||
+        vector_size == 0)
+    {
+        return {};
+    }
+    return std::make_unique<QuantizedVectorStore>(params.quantization(), params.distance_metric(), vector_size);
+}
+
 } // namespace <unnamed>
 
 std::unique_ptr<NearestNeighborIndex>
@@ -32,7 +45,6 @@ DefaultNearestNeighborIndexFactory::make(const DocVectorAccess& vectors,
                                          vespalib::eval::CellType cell_type,
                                          const search::attribute::HnswIndexParams& params) const
 {
-    (void) vector_size;
     uint32_t m = params.max_links_per_node();
     HnswIndexConfig cfg(m * 2,
                         m,
@@ -43,12 +55,14 @@ DefaultNearestNeighborIndexFactory::make(const DocVectorAccess& vectors,
         return std::make_unique<HnswIndex<HnswIndexType::MULTI>>(vectors,
                                                                   make_distance_function_factory(params.distance_metric(), cell_type),
                                                                   make_random_level_generator(m),
-                                                                  cfg);
+                                                                  cfg,
+                                                                  make_quantized_vector_store(vector_size, params));
     } else {
         return std::make_unique<HnswIndex<HnswIndexType::SINGLE>>(vectors,
                                                                   make_distance_function_factory(params.distance_metric(), cell_type),
                                                                   make_random_level_generator(m),
-                                                                  cfg);
+                                                                  cfg,
+                                                                  make_quantized_vector_store(vector_size, params));
     }
 }
 
@@ -4,6 +4,7 @@
 #include <vespa/eval/eval/fast_value.h>
 #include <vespa/eval/eval/value.h>
 #include <vespa/searchcommon/attribute/config.h>
+#include <vespa/vespalib/datastore/i_compaction_context.h>
 
 using vespalib::eval::FastValueBuilderFactory;
 
@@ -17,6 +18,7 @@ DirectTensorAttribute::DirectTensorAttribute(stringref name, const Config &cfg,
 
 DirectTensorAttribute::~DirectTensorAttribute()
 {
+    _compaction_context.reset();
     getGenerationHolder().reclaim_all();
     _tensorStore.reclaim_all_memory();
 }
@@ -2,7 +2,7 @@
 
 #include "hamming_distance.h"
 #include "temporary_vector_store.h"
-#include <vespa/vespalib/util/binary_hamming_distance.h>
+#include <vespa/vespalib/hwaccelrated/iaccelrated.h>
 
 using vespalib::typify_invoke;
 using vespalib::eval::TypifyCellType;
@@ -35,11 +35,13 @@ using vespalib::eval::Int8Float;
 template<typename FloatType>
 class BoundHammingDistance : public BoundDistanceFunction {
 private:
+    const vespalib::hwaccelrated::IAccelrated & _computer;
     mutable TemporaryVectorStore<FloatType> _tmpSpace;
     const vespalib::ConstArrayRef<FloatType> _lhs_vector;
 public:
     BoundHammingDistance(const vespalib::eval::TypedCells& lhs)
-        : _tmpSpace(lhs.size),
+        : _computer(vespalib::hwaccelrated::IAccelrated::getAccelerator()),
+          _tmpSpace(lhs.size),
           _lhs_vector(_tmpSpace.storeLhs(lhs))
     {}
     double calc(const vespalib::eval::TypedCells& rhs) const override {
@@ -49,7 +51,7 @@ public:
         auto a = _lhs_vector.data();
         auto b = rhs_vector.data();
         if constexpr (std::is_same<Int8Float, FloatType>::value) {
-            return (double) vespalib::binary_hamming_distance(a, b, sz);
+            return (double) _computer.binaryHammingDistance(a, b, sz);
         } else {
             size_t sum = 0;
             for (size_t i = 0; i < sz; ++i) {
@@ -13,7 +13,8 @@ HnswGraph<type>::HnswGraph()
     nodes_size(1u),
     levels_store(HnswIndex<type>::make_default_level_array_store_config(), {}),
     links_store(HnswIndex<type>::make_default_link_array_store_config(), {}),
-    entry_nodeid_and_level()
+    entry_nodeid_and_level(),
+    snapshots()
 {
     nodes.ensure_size(1, NodeType());
     EntryNode entry;
@@ -23,10 +24,41 @@ HnswGraph<type>::HnswGraph()
 template <HnswIndexType type>
 HnswGraph<type>::~HnswGraph() = default;
 
+template <HnswIndexType type>
+std::shared_ptr<HnswGraphSnapshot>
+HnswGraph<type>::make_snapshot() const
+{
+    auto snapshot = std::make_shared<HnswGraphSnapshot>(nodes.get_size());
+    snapshots.push_back(snapshot);
+    return snapshot;
+}
+
+template <HnswIndexType type>
+void
+HnswGraph<type>::preserve_in_snapshots_helper(uint32_t nodeid)
+{
+    std::erase_if(snapshots, [](const auto& snapshot) { return snapshot->released(); });
+    for (const auto& snapshot : snapshots) {
+        snapshot->preserve(nodeid, [this, nodeid](HnswGraphSnapshot::Node& node) {
+            if (nodeid >= nodes.get_size()) {
+                return;
+            }
+            auto& graph_node = nodes.get_elem_ref(nodeid);
+            node.docid = graph_node.acquire_docid();
+            node.subspace = graph_node.acquire_subspace();
+            auto levels = get_level_array(graph_node.levels_ref().load_relaxed());
+            for (const auto& links_ref : levels) {
+                node.links_refs.push_back(links_ref.load_relaxed());
+            }
+        });
+    }
+}
+
 template <HnswIndexType type>
 typename HnswGraph<type>::LevelsRef
 HnswGraph<type>::make_node(uint32_t nodeid, uint32_t docid, uint32_t subspace, uint32_t num_levels)
 {
+    preserve_in_snapshots(nodeid);
     nodes.ensure_size(nodeid + 1, NodeType());
     // A document cannot be added twice.
     assert(!get_levels_ref(nodeid).valid());
@@ -47,6 +79,7 @@ template <HnswIndexType type>
 void
 HnswGraph<type>::remove_node(uint32_t nodeid)
 {
+    preserve_in_snapshots(nodeid);
     auto levels_ref = get_levels_ref(nodeid);
     assert(levels_ref.valid());
     auto levels = levels_store.get(levels_ref);
@@ -78,6 +111,7 @@ template <HnswIndexType type>
 void     
 HnswGraph<type>::set_link_array(uint32_t nodeid, uint32_t level, const LinkArrayRef& new_links)
 {
+    preserve_in_snapshots(nodeid);
     auto new_links_ref = links_store.add(new_links);
     auto levels_ref = get_levels_ref(nodeid);
     assert(levels_ref.valid());
@@ -2,13 +2,16 @@
 
 #pragma once
 
+#include "hnsw_graph_snapshot.h"
 #include "hnsw_index_traits.h"
 #include "hnsw_simple_node.h"
 #include "hnsw_node.h"
 #include <vespa/vespalib/datastore/array_store.h>
 #include <vespa/vespalib/datastore/atomic_entry_ref.h>
 #include <vespa/vespalib/datastore/entryref.h>
+#include <vespa/vespalib/util/prefetch.h>
 #include <vespa/vespalib/util/rcuvector.h>
+#include <memory>
 
 namespace search::tensor {
 
@@ -52,9 +55,22 @@ struct HnswGraph {
 
     std::atomic<uint64_t> entry_nodeid_and_level;
 
+    // Snapshots used by ongoing saves, accessed by writer only
+    mutable std::vector<std::shared_ptr<HnswGraphSnapshot>> snapshots;
+
     HnswGraph();
     ~HnswGraph();
 
+    // Called from writer only
+    std::shared_ptr<HnswGraphSnapshot> make_snapshot() const;
+
+    void preserve_in_snapshots(uint32_t nodeid) {
+        if (!snapshots.empty()) {
+            preserve_in_snapshots_helper(nodeid);
+        }
+    }
+    void preserve_in_snapshots_helper(uint32_t nodeid);
+
     LevelsRef make_node(uint32_t nodeid, uint32_t docid, uint32_t subspace, uint32_t num_levels);
 
     void remove_node(uint32_t nodeid);
@@ -84,6 +100,17 @@ struct HnswGraph {
         return LevelArrayRef();
     }
 
+    // Hints that the level array for the given node will soon be read when exploring its links.
+    void prefetch_level_array(LevelsRef levels_ref) const {
+        if (levels_ref.valid()) {
+            vespalib::prefetch(levels_store.get(levels_ref).data());
+        }
+    }
+
+    void prefetch_node(uint32_t nodeid) const {
+        vespalib::prefetch(&nodes.acquire_elem_ref(nodeid));
+    }
+
     LevelArrayRef get_level_array(uint32_t nodeid) const {
         auto levels_ref = get_levels_ref(nodeid);
         return get_level_array(levels_ref);
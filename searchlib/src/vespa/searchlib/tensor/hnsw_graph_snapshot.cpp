@@ -0,0 +1,27 @@
+// Copyright Vespa.ai. Licensed under the terms of the Apache 2.0 license. See LICENSE in the project root.
+
+#include "hnsw_graph_snapshot.h"
+#include <vespa/vespalib/stllike/hash_map.hpp>
+
+namespace search::tensor {
+
+HnswGraphSnapshot::HnswGraphSnapshot(uint32_t num_nodes)
+    : _num_nodes(num_nodes),
+      _lock(),
+      _preserved(),
+      _released(false)
+{
+}
+
+HnswGraphSnapshot::~HnswGraphSnapshot() = default;
+
+size_t
+HnswGraphSnapshot::num_preserved() const
+{
+    std::lock_guard guard(_lock);
+    return _preserved.size();
+}
+
+}
+
+VESPALIB_HASH_MAP_INSTANTIATE(uint32_t, search::tensor::HnswGraphSnapshot::Node);
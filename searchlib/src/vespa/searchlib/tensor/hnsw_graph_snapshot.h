@@ -0,0 +1,89 @@
+// Copyright Vespa.ai. Licensed under the terms of the Apache 2.0 license. See LICENSE in the project root.
+
+#pragma once
+
+#include <vespa/vespalib/datastore/entryref.h>
+#include <vespa/vespalib/stllike/hash_map.h>
+#include <atomic>
+#include <mutex>
+#include <vector>
+
+namespace search::tensor {
+
+/**
+ * Snapshot of the nodes of an hnsw graph, used when saving the graph.
+ *
+ * Nodes are not copied when the snapshot is taken. Instead the graph
+ * preserves the levels of a node in all active snapshots before the
+ * node is changed for the first time afterwards, and the saver reads
+ * all other nodes directly from the live graph. The link arrays
+ * referenced by both are kept alive by the generation guard held by
+ * the saver. Memory use is thus proportional to the number of nodes
+ * changed while saving, not to the size of the graph.
+ */
+class HnswGraphSnapshot {
+public:
+    using EntryRef = vespalib::datastore::EntryRef;
+
+    struct Node {
+        uint32_t docid;
+        uint32_t subspace;
+        std::vector<EntryRef> links_refs;
+        Node() noexcept : docid(0), subspace(0), links_refs() {}
+    };
+
+private:
+    const uint32_t                      _num_nodes;
+    mutable std::mutex                  _lock;
+    vespalib::hash_map<uint32_t, Node>  _preserved;
+    std::atomic<bool>                   _released;
+
+public:
+    explicit HnswGraphSnapshot(uint32_t num_nodes);
+    ~HnswGraphSnapshot();
+
+    uint32_t num_nodes() const noexcept { return _num_nodes; }
+
+    /*
+     * Preserves the node unless already preserved. Called by the
+     * writer before the node is changed, with the levels it has now.
+     */
+    template <typename ReadNode>
+    void preserve(uint32_t nodeid, ReadNode read_node) {
+        if (nodeid >= _num_nodes) {
+            return;
+        }
+        std::lock_guard guard(_lock);
+        auto insres = _preserved.insert(std::make_pair(nodeid, Node()));
+        if (insres.second) {
+            read_node(insres.first->second);
+        }
+    }
+
+    /*
+     * Gets the node as it was when the snapshot was taken, either from
+     * the preserved nodes or by reading the live graph. The live graph
+     * is read while holding the lock, so the writer cannot preserve
+     * and change the node in the meantime.
+     */
+    template <typename ReadNode>
+    void get(uint32_t nodeid, Node& node, ReadNode read_node) const {
+        std::lock_guard guard(_lock);
+        auto itr = _preserved.find(nodeid);
+        if (itr != _preserved.end()) {
+            node.docid = itr->second.docid;
+            node.subspace = itr->second.subspace;
+            node.links_refs.assign(itr->second.links_refs.begin(), itr->second.links_refs.end());
+        } else {
+            read_node(node);
+        }
+    }
+
+    size_t num_preserved() const;
+
+    // Called when the saver is done, the graph stops preserving nodes
+    void release() noexcept { _released.store(true, std::memory_order_release); }
+    bool released() const noexcept { return _released.load(std::memory_order_acquire); }
+};
+
+}
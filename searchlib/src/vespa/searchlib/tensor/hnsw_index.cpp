@@ -20,8 +20,10 @@
 #include <vespa/vespalib/datastore/compaction_strategy.h>
 #include <vespa/vespalib/util/doom.h>
 #include <vespa/vespalib/util/memory_allocator.h>
+#include <vespa/vespalib/util/prefetch.h>
 #include <vespa/vespalib/util/size_literals.h>
 #include <vespa/vespalib/util/time.h>
+#include <functional>
 #include <vespa/log/log.h>
 
 LOG_SETUP(".searchlib.tensor.hnsw_index");
@@ -44,6 +46,8 @@ constexpr float alloc_grow_factor = 0.3;
 constexpr size_t max_level_array_size = 16;
 constexpr size_t max_link_array_size = 193;
 constexpr vespalib::duration MAX_COUNT_DURATION(100ms);
+// Limits the number of cache lines prefetched for each vector when exploring neighbors.
+constexpr size_t max_prefetch_lines_per_vector = 16;
 
 const vespalib::string hnsw_max_squared_norm = "hnsw.max_squared_norm";
 
@@ -68,6 +72,27 @@ void load_mips_max_distance(const GenericHeader& header, DistanceFunctionFactory
     }
 }
 
+/**
+ * Loader wrapper that populates the quantized codes when the graph has been loaded.
+ */
+class QuantizedCodesPopulatingLoader : public NearestNeighborIndexLoader {
+    std::unique_ptr<NearestNeighborIndexLoader> _loader;
+    std::function<void()>                       _on_complete;
+public:
+    QuantizedCodesPopulatingLoader(std::unique_ptr<NearestNeighborIndexLoader> loader, std::function<void()> on_complete)
+        : _loader(std::move(loader)),
+          _on_complete(std::move(on_complete))
+    {
+    }
+    bool load_next() override {
+        bool more = _loader->load_next();
+        if (!more) {
+            _on_complete();
+        }
+        return more;
+    }
+};
+
 bool has_link_to(vespalib::ConstArrayRef<uint32_t> links, uint32_t id) {
     for (uint32_t link : links) {
         if (link == id) return true;
@@ -347,7 +372,8 @@ template <HnswIndexType type>
 HnswCandidate
 HnswIndex<type>::find_nearest_in_layer(
         const BoundDistanceFunction &df,
-        const HnswCandidate& entry_point, uint32_t level) const
+        const HnswCandidate& entry_point, uint32_t level,
+        const QuantizedVectorStore* codes) const
 {
     HnswCandidate nearest = entry_point;
     bool keep_searching = true;
@@ -358,7 +384,7 @@ HnswIndex<type>::find_nearest_in_layer(
             auto neighbor_ref = neighbor_node.levels_ref().load_acquire();
             uint32_t neighbor_docid = acquire_docid(neighbor_node, neighbor_nodeid);
             uint32_t neighbor_subspace = neighbor_node.acquire_subspace();
-            double dist = calc_distance(df, neighbor_docid, neighbor_subspace);
+            double dist = calc_traversal_distance(df, codes, neighbor_nodeid, neighbor_docid, neighbor_subspace);
             if (_graph.still_valid(neighbor_nodeid, neighbor_ref)
                 && dist < nearest.distance)
             {
@@ -370,6 +396,17 @@ HnswIndex<type>::find_nearest_in_layer(
     return nearest;
 }
 
+template <HnswIndexType type>
+void
+HnswIndex<type>::prefetch_neighbor_nodes(const LinkArrayRef& neighbors, uint32_t nodeid_limit) const
+{
+    for (uint32_t neighbor_nodeid : neighbors) {
+        if (neighbor_nodeid < nodeid_limit) {
+            _graph.prefetch_node(neighbor_nodeid);
+        }
+    }
+}
+
 template <HnswIndexType type>
 template <class VisitedTracker, class BestNeighbors>
 void
@@ -378,7 +415,8 @@ HnswIndex<type>::search_layer_helper(
         uint32_t neighbors_to_find,
         BestNeighbors& best_neighbors, uint32_t level, const GlobalFilter *filter,
         uint32_t nodeid_limit, const vespalib::Doom* const doom,
-        uint32_t estimated_visited_nodes) const
+        uint32_t estimated_visited_nodes,
+        const QuantizedVectorStore* codes) const
 {
     NearestPriQ candidates;
     GlobalFilterWrapper<type> filter_wrapper(filter);
@@ -402,6 +440,17 @@ HnswIndex<type>::search_layer_helper(
         }
     }
     double limit_dist = std::numeric_limits<double>::max();
+    struct UnvisitedNeighbor {
+        uint32_t nodeid;
+        uint32_t docid;
+        typename GraphType::LevelsRef levels_ref;
+        TypedCells cells;
+        UnvisitedNeighbor(uint32_t nodeid_in, uint32_t docid_in, typename GraphType::LevelsRef levels_ref_in, TypedCells cells_in) noexcept
+            : nodeid(nodeid_in), docid(docid_in), levels_ref(levels_ref_in), cells(cells_in)
+        {}
+    };
+    std::vector<UnvisitedNeighbor> unvisited;
+    unvisited.reserve(_cfg.max_links_at_level_0());
 
     while (!candidates.empty()) {
         auto cand = candidates.top();
@@ -409,7 +458,11 @@ HnswIndex<type>::search_layer_helper(
             break;
         }
         candidates.pop();
-        for (uint32_t neighbor_nodeid : _graph.get_link_array(cand.levels_ref, level)) {
+        auto neighbors = _graph.get_link_array(cand.levels_ref, level);
+        prefetch_neighbor_nodes(neighbors, nodeid_limit);
+        // First pass: find the unvisited neighbors and prefetch their vectors.
+        unvisited.clear();
+        for (uint32_t neighbor_nodeid : neighbors) {
             if (neighbor_nodeid >= nodeid_limit) {
                 continue;
             }
@@ -422,11 +475,17 @@ HnswIndex<type>::search_layer_helper(
             }
             uint32_t neighbor_docid = acquire_docid(neighbor_node, neighbor_nodeid);
             uint32_t neighbor_subspace = neighbor_node.acquire_subspace();
-            double dist_to_input = calc_distance(df, neighbor_docid, neighbor_subspace);
+            auto cells = get_traversal_vector(codes, neighbor_nodeid, neighbor_docid, neighbor_subspace);
+            vespalib::prefetch_range(cells.data, vespalib::eval::CellTypeUtils::mem_size(cells.type, cells.size), max_prefetch_lines_per_vector);
+            unvisited.emplace_back(neighbor_nodeid, neighbor_docid, neighbor_ref, cells);
+        }
+        // Second pass: calculate distances while the vectors are (hopefully) in the cache.
+        for (const auto& neighbor : unvisited) {
+            double dist_to_input = df.calc(neighbor.cells);
             if (dist_to_input < limit_dist) {
-                candidates.emplace(neighbor_nodeid, neighbor_ref, dist_to_input);
-                if (filter_wrapper.check(neighbor_docid)) {
-                    best_neighbors.emplace(neighbor_nodeid, neighbor_docid, neighbor_ref, dist_to_input);
+                candidates.emplace(neighbor.nodeid, neighbor.levels_ref, dist_to_input);
+                if (filter_wrapper.check(neighbor.docid)) {
+                    best_neighbors.emplace(neighbor.nodeid, neighbor.docid, neighbor.levels_ref, dist_to_input);
                     while (best_neighbors.size() > neighbors_to_find) {
                         best_neighbors.pop();
                         limit_dist = best_neighbors.top().distance;
@@ -434,6 +493,105 @@ HnswIndex<type>::search_layer_helper(
                 }
             }
         }
+        if (!candidates.empty()) {
+            _graph.prefetch_level_array(candidates.top().levels_ref);
+        }
+        if (doom != nullptr && doom->soft_doom()) {
+            break;
+        }
+    }
+}
+
+template <HnswIndexType type>
+template <class VisitedTracker, class BestNeighbors>
+void
+HnswIndex<type>::search_layer_filter_first_helper(
+        const BoundDistanceFunction &df,
+        uint32_t neighbors_to_find,
+        BestNeighbors& best_neighbors, uint32_t level, const GlobalFilter *filter,
+        uint32_t nodeid_limit, const vespalib::Doom* const doom,
+        uint32_t estimated_visited_nodes,
+        const QuantizedVectorStore* codes) const
+{
+    NearestPriQ candidates;
+    GlobalFilterWrapper<type> filter_wrapper(filter);
+    filter_wrapper.clamp_nodeid_limit(nodeid_limit);
+    VisitedTracker visited(nodeid_limit, estimated_visited_nodes);
+    if (doom != nullptr && doom->soft_doom()) {
+        while (!best_neighbors.empty()) {
+            best_neighbors.pop();
+        }
+        return;
+    }
+    for (const auto &entry : best_neighbors.peek()) {
+        if (entry.nodeid >= nodeid_limit) {
+            continue;
+        }
+        candidates.push(entry);
+        visited.mark(entry.nodeid);
+        if (!filter_wrapper.check(entry.docid)) {
+            assert(best_neighbors.peek().size() == 1);
+            best_neighbors.pop();
+        }
+    }
+    double limit_dist = std::numeric_limits<double>::max();
+    auto consider = [&](uint32_t nodeid, const auto& node, auto ref, uint32_t docid) {
+        double dist_to_input = calc_traversal_distance(df, codes, nodeid, docid, node.acquire_subspace());
+        if (dist_to_input < limit_dist) {
+            candidates.emplace(nodeid, ref, dist_to_input);
+            best_neighbors.emplace(nodeid, docid, ref, dist_to_input);
+            while (best_neighbors.size() > neighbors_to_find) {
+                best_neighbors.pop();
+                limit_dist = best_neighbors.top().distance;
+            }
+        }
+    };
+
+    while (!candidates.empty()) {
+        auto cand = candidates.top();
+        if (cand.distance > limit_dist) {
+            break;
+        }
+        candidates.pop();
+        auto neighbors = _graph.get_link_array(cand.levels_ref, level);
+        prefetch_neighbor_nodes(neighbors, nodeid_limit);
+        for (uint32_t neighbor_nodeid : neighbors) {
+            if (neighbor_nodeid >= nodeid_limit) {
+                continue;
+            }
+            auto& neighbor_node = _graph.acquire_node(neighbor_nodeid);
+            auto neighbor_ref = neighbor_node.levels_ref().load_acquire();
+            if ((! neighbor_ref.valid())
+                || ! visited.try_mark(neighbor_nodeid))
+            {
+                continue;
+            }
+            uint32_t neighbor_docid = acquire_docid(neighbor_node, neighbor_nodeid);
+            if (filter_wrapper.check(neighbor_docid)) {
+                consider(neighbor_nodeid, neighbor_node, neighbor_ref, neighbor_docid);
+                continue;
+            }
+            // Skip past the node not matching the filter without calculating its distance.
+            for (uint32_t hop_nodeid : _graph.get_link_array(neighbor_ref, level)) {
+                if (hop_nodeid >= nodeid_limit) {
+                    continue;
+                }
+                auto& hop_node = _graph.acquire_node(hop_nodeid);
+                auto hop_ref = hop_node.levels_ref().load_acquire();
+                if (! hop_ref.valid()) {
+                    continue;
+                }
+                uint32_t hop_docid = acquire_docid(hop_node, hop_nodeid);
+                // Nodes not matching the filter are left unmarked, so they can be skipped past again from another candidate.
+                if (! filter_wrapper.check(hop_docid) || ! visited.try_mark(hop_nodeid)) {
+                    continue;
+                }
+                consider(hop_nodeid, hop_node, hop_ref, hop_docid);
+            }
+        }
+        if (!candidates.empty()) {
+            _graph.prefetch_level_array(candidates.top().levels_ref);
+        }
         if (doom != nullptr && doom->soft_doom()) {
             break;
         }
@@ -447,28 +605,44 @@ HnswIndex<type>::search_layer(
         const BoundDistanceFunction &df,
         uint32_t neighbors_to_find,
         BestNeighbors& best_neighbors, uint32_t level,
-        const vespalib::Doom* const doom, const GlobalFilter *filter) const
+        const vespalib::Doom* const doom, const GlobalFilter *filter,
+        const QuantizedVectorStore* codes,
+        bool filter_first) const
 {
     uint32_t nodeid_limit = _graph.nodes_size.load(std::memory_order_acquire);
     uint32_t estimated_visited_nodes = estimate_visited_nodes(level, nodeid_limit, neighbors_to_find, filter);
-    if (estimated_visited_nodes >= nodeid_limit / 128) {
-        search_layer_helper<BitVectorVisitedTracker>(df, neighbors_to_find, best_neighbors, level, filter, nodeid_limit, doom, estimated_visited_nodes);
+    if (filter_first && filter != nullptr) {
+        if (estimated_visited_nodes >= nodeid_limit / 128) {
+            search_layer_filter_first_helper<BitVectorVisitedTracker>(df, neighbors_to_find, best_neighbors, level, filter, nodeid_limit, doom, estimated_visited_nodes, codes);
+        } else {
+            search_layer_filter_first_helper<HashSetVisitedTracker>(df, neighbors_to_find, best_neighbors, level, filter, nodeid_limit, doom, estimated_visited_nodes, codes);
+        }
+    } else if (estimated_visited_nodes >= nodeid_limit / 128) {
+        search_layer_helper<BitVectorVisitedTracker>(df, neighbors_to_find, best_neighbors, level, filter, nodeid_limit, doom, estimated_visited_nodes, codes);
     } else {
-        search_layer_helper<HashSetVisitedTracker>(df, neighbors_to_find, best_neighbors, level, filter, nodeid_limit, doom, estimated_visited_nodes);
+        search_layer_helper<HashSetVisitedTracker>(df, neighbors_to_find, best_neighbors, level, filter, nodeid_limit, doom, estimated_visited_nodes, codes);
     }
 }
 
 template <HnswIndexType type>
 HnswIndex<type>::HnswIndex(const DocVectorAccess& vectors, DistanceFunctionFactory::UP distance_ff,
-                     RandomLevelGenerator::UP level_generator, const HnswIndexConfig& cfg)
+                     RandomLevelGenerator::UP level_generator, const HnswIndexConfig& cfg,
+                     std::unique_ptr<QuantizedVectorStore> quantized_vectors)
     : _graph(),
       _vectors(vectors),
       _distance_ff(std::move(distance_ff)),
       _level_generator(std::move(level_generator)),
       _id_mapping(),
-      _cfg(cfg)
+      _cfg(cfg),
+      _quantized_vectors(std::move(quantized_vectors)),
+      _quantized_ff(),
+      _quantized_vectors_loaded(false),
+      _maintenance_nodeid(1)
 {
     assert(_distance_ff);
+    if (_quantized_vectors) {
+        _quantized_ff = std::make_unique<QuantizedDistanceFunctionFactory>(*_distance_ff, *_quantized_vectors);
+    }
 }
 
 template <HnswIndexType type>
@@ -593,6 +767,10 @@ void
 HnswIndex<type>::internal_complete_add_node(uint32_t nodeid, uint32_t docid, uint32_t subspace, PreparedAddNode &prepared_node)
 {
     int32_t num_levels = prepared_node.connections.size();
+    if (_quantized_vectors) {
+        // Codes must be in place before the node is visible to readers.
+        _quantized_vectors->set_vector(nodeid, get_vector(docid, subspace));
+    }
     auto levels_ref = _graph.make_node(nodeid, docid, subspace, num_levels);
     for (int level = 0; level < num_levels; ++level) {
         auto neighbors = filter_valid_nodeids(level, prepared_node.connections[level], nodeid);
@@ -603,6 +781,18 @@ HnswIndex<type>::internal_complete_add_node(uint32_t nodeid, uint32_t docid, uin
     }
 }
 
+template <HnswIndexType type>
+void
+HnswIndex<type>::populate_quantized_vectors()
+{
+    uint32_t nodeid_limit = _graph.nodes.size();
+    for (uint32_t nodeid = 1; nodeid < nodeid_limit; ++nodeid) {
+        if (_graph.get_levels_ref(nodeid).valid()) {
+            _quantized_vectors->set_vector(nodeid, get_vector(nodeid));
+        }
+    }
+}
+
 template <HnswIndexType type>
 std::unique_ptr<PrepareResult>
 HnswIndex<type>::prepare_add_document(uint32_t docid,
@@ -714,6 +904,9 @@ HnswIndex<type>::assign_generation(generation_t current_gen)
     _graph.levels_store.assign_generation(current_gen);
     _graph.links_store.assign_generation(current_gen);
     _id_mapping.assign_generation(current_gen);
+    if (_quantized_vectors) {
+        _quantized_vectors->assign_generation(current_gen);
+    }
 }
 
 template <HnswIndexType type>
@@ -724,6 +917,9 @@ HnswIndex<type>::reclaim_memory(generation_t oldest_used_gen)
     _graph.levels_store.reclaim_memory(oldest_used_gen);
     _graph.links_store.reclaim_memory(oldest_used_gen);
     _id_mapping.reclaim_memory(oldest_used_gen);
+    if (_quantized_vectors) {
+        _quantized_vectors->reclaim_memory(oldest_used_gen);
+    }
 }
 
 template <HnswIndexType type>
@@ -788,6 +984,9 @@ HnswIndex<type>::update_stat(const CompactionStrategy& compaction_strategy)
     result.merge(_graph.levels_store.update_stat(compaction_strategy));
     result.merge(_graph.links_store.update_stat(compaction_strategy));
     result.merge(_id_mapping.update_stat(compaction_strategy));
+    if (_quantized_vectors) {
+        result.merge(_quantized_vectors->memory_usage());
+    }
     return result;
 }
 
@@ -800,6 +999,9 @@ HnswIndex<type>::memory_usage() const
     result.merge(_graph.levels_store.getMemoryUsage());
     result.merge(_graph.links_store.getMemoryUsage());
     result.merge(_id_mapping.memory_usage());
+    if (_quantized_vectors) {
+        result.merge(_quantized_vectors->memory_usage());
+    }
     return result;
 }
 
@@ -824,6 +1026,9 @@ HnswIndex<type>::get_state(const vespalib::slime::Inserter& inserter) const
     StateExplorerUtils::memory_usage_to_slime(_graph.nodes.getMemoryUsage(), memUsageObj.setObject("nodes"));
     StateExplorerUtils::memory_usage_to_slime(_graph.levels_store.getMemoryUsage(), memUsageObj.setObject("levels"));
     StateExplorerUtils::memory_usage_to_slime(_graph.links_store.getMemoryUsage(), memUsageObj.setObject("links"));
+    if (_quantized_vectors) {
+        StateExplorerUtils::memory_usage_to_slime(_quantized_vectors->memory_usage(), memUsageObj.setObject("quantized_vectors"));
+    }
     object.setLong("nodes", _graph.size());
     auto& histogram_array = object.setArray("level_histogram");
     auto& links_hst_array = object.setArray("level_0_links_histogram");
@@ -869,11 +1074,150 @@ HnswIndex<type>::shrink_lid_space(uint32_t doc_id_limit)
     }
 }
 
+template <HnswIndexType type>
+PreparedAddNode
+HnswIndex<type>::prepare_repair_node(uint32_t nodeid, uint32_t num_levels) const
+{
+    std::vector<PreparedAddNode::Links> connections(num_levels);
+    auto entry = _graph.get_entry_node();
+    if (entry.nodeid == 0 || num_levels == 0) {
+        return PreparedAddNode(std::move(connections));
+    }
+    int node_max_level = num_levels - 1;
+    int search_level = entry.level;
+    auto df = _distance_ff->for_insertion_vector(get_vector(nodeid));
+    double entry_dist = calc_distance(*df, entry.nodeid);
+    uint32_t entry_docid = get_docid(entry.nodeid);
+    HnswCandidate entry_point(entry.nodeid, entry_docid, entry.levels_ref, entry_dist);
+    while (search_level > node_max_level) {
+        entry_point = find_nearest_in_layer(*df, entry_point, search_level);
+        --search_level;
+    }
+    FurthestPriQ best_neighbors;
+    best_neighbors.push(entry_point);
+    search_level = std::min(node_max_level, search_level);
+    while (search_level >= 0) {
+        // One extra to explore, as the node itself is among the nearest
+        search_layer(*df, _cfg.neighbors_to_explore_at_construction() + 1, best_neighbors, search_level, nullptr);
+        HnswCandidateVector candidates;
+        candidates.reserve(best_neighbors.size());
+        for (const auto & candidate : best_neighbors.peek()) {
+            if (candidate.nodeid != nodeid) {
+                candidates.push_back(candidate);
+            }
+        }
+        auto neighbors = select_neighbors(candidates, _cfg.max_links_on_inserts());
+        auto& links = connections[search_level];
+        links.reserve(neighbors.used.size());
+        for (const auto & neighbor : neighbors.used) {
+            auto neighbor_levels = _graph.get_level_array(neighbor.levels_ref);
+            if (size_t(search_level) < neighbor_levels.size()) {
+                links.emplace_back(neighbor.nodeid, neighbor.levels_ref);
+            }
+        }
+        --search_level;
+    }
+    return PreparedAddNode(std::move(connections));
+}
+
+template <HnswIndexType type>
+bool
+HnswIndex<type>::complete_repair_node(uint32_t nodeid, PreparedAddNode& prepared_node)
+{
+    bool linked = false;
+    for (uint32_t level = 0; level < prepared_node.connections.size(); ++level) {
+        for (const auto & neighbor : prepared_node.connections[level]) {
+            uint32_t neighbor_nodeid = neighbor.first;
+            if (neighbor_nodeid == nodeid || !_graph.still_valid(neighbor_nodeid, neighbor.second) ||
+                level >= _graph.get_level_array(neighbor.second).size())
+            {
+                continue;
+            }
+            auto old_links = _graph.get_link_array(nodeid, level);
+            if (has_link_to(old_links, neighbor_nodeid)) {
+                continue;
+            }
+            add_link_to(nodeid, level, old_links, neighbor_nodeid);
+            auto neighbor_links = _graph.get_link_array(neighbor_nodeid, level);
+            if (!has_link_to(neighbor_links, nodeid)) {
+                add_link_to(neighbor_nodeid, level, neighbor_links, nodeid);
+            }
+            // Might drop the new link again, in both directions
+            shrink_if_needed(neighbor_nodeid, level);
+            linked = true;
+        }
+        shrink_if_needed(nodeid, level);
+    }
+    return linked;
+}
+
+template <HnswIndexType type>
+bool
+HnswIndex<type>::probe_node(uint32_t nodeid) const
+{
+    // Searching as hard as when adding nodes, a node not found is not reachable in practice
+    auto df = _distance_ff->for_query_vector(get_vector(nodeid));
+    auto best_neighbors = top_k_candidates(*df, _cfg.neighbors_to_explore_at_construction(), nullptr, vespalib::Doom::never());
+    for (const auto & candidate : best_neighbors.peek()) {
+        if (candidate.nodeid == nodeid) {
+            return true;
+        }
+    }
+    return false;
+}
+
+template <HnswIndexType type>
+NearestNeighborIndex::GraphMaintenanceStats
+HnswIndex<type>::maintain_graph(uint32_t nodes_to_check, uint32_t nodes_to_probe, uint32_t max_repairs)
+{
+    GraphMaintenanceStats stats;
+    uint32_t nodeid_limit = _graph.size();
+    if (nodeid_limit <= 2) {
+        // At most one node, nothing to link it to
+        return stats;
+    }
+    // A node left with fewer links than this on level 0 is considered degraded.
+    // Nodes normally have between max_links_on_inserts and max_links_at_level_0 links.
+    uint32_t min_links = std::min(std::max(_cfg.max_links_on_inserts() / 4, 1u), nodeid_limit - 2);
+    uint32_t probe_interval = std::max(nodes_to_check / std::max(nodes_to_probe, 1u), 1u);
+    if (_maintenance_nodeid >= nodeid_limit) {
+        _maintenance_nodeid = 1;
+    }
+    for (uint32_t visited = 1; visited < nodeid_limit && stats.checked_nodes < nodes_to_check; ++visited) {
+        uint32_t nodeid = _maintenance_nodeid;
+        _maintenance_nodeid = (nodeid + 1 < nodeid_limit) ? (nodeid + 1) : 1;
+        auto levels_ref = _graph.get_levels_ref(nodeid);
+        if (!levels_ref.valid()) {
+            continue;
+        }
+        ++stats.checked_nodes;
+        bool degraded = (_graph.get_link_array(levels_ref, 0).size() < min_links);
+        if (!degraded && (stats.probed_nodes < nodes_to_probe) && ((stats.checked_nodes % probe_interval) == 0)) {
+            ++stats.probed_nodes;
+            if (probe_node(nodeid)) {
+                ++stats.found_nodes;
+            } else {
+                degraded = true;
+            }
+        }
+        if (degraded) {
+            ++stats.degraded_nodes;
+            if (stats.repaired_nodes < max_repairs) {
+                auto prepared = prepare_repair_node(nodeid, _graph.get_level_array(levels_ref).size());
+                if (complete_repair_node(nodeid, prepared)) {
+                    ++stats.repaired_nodes;
+                }
+            }
+        }
+    }
+    return stats;
+}
+
 template <HnswIndexType type>
 std::unique_ptr<NearestNeighborIndexSaver>
 HnswIndex<type>::make_saver(GenericHeader& header) const
 {
-    save_mips_max_distance(header, distance_function_factory());
+    save_mips_max_distance(header, *_distance_ff);
     return std::make_unique<HnswIndexSaver<type>>(_graph);
 }
 
@@ -882,10 +1226,36 @@ std::unique_ptr<NearestNeighborIndexLoader>
 HnswIndex<type>::make_loader(FastOS_FileInterface& file, const vespalib::GenericHeader& header)
 {
     assert(get_entry_nodeid() == 0); // cannot load after index has data
-    load_mips_max_distance(header, distance_function_factory());
+    load_mips_max_distance(header, *_distance_ff);
     using ReaderType = FileReader<uint32_t>;
     using LoaderType = HnswIndexLoader<ReaderType, type>;
-    return std::make_unique<LoaderType>(_graph, _id_mapping, std::make_unique<ReaderType>(&file));
+    auto loader = std::make_unique<LoaderType>(_graph, _id_mapping, std::make_unique<ReaderType>(&file));
+    if (_quantized_vectors && !_quantized_vectors_loaded) {
+        return std::make_unique<QuantizedCodesPopulatingLoader>(std::move(loader), [this]() { populate_quantized_vectors(); });
+    }
+    return loader;
+}
+
+template <HnswIndexType type>
+std::unique_ptr<NearestNeighborIndexSaver>
+HnswIndex<type>::make_quantized_vectors_saver() const
+{
+    if (!_quantized_vectors) {
+        return {};
+    }
+    return _quantized_vectors->make_saver(_graph.nodes.get_size());
+}
+
+template <HnswIndexType type>
+bool
+HnswIndex<type>::load_quantized_vectors(const search::fileutil::LoadedBuffer& buf)
+{
+    assert(get_entry_nodeid() == 0); // cannot load after index has data
+    if (!_quantized_vectors) {
+        return false;
+    }
+    _quantized_vectors_loaded = _quantized_vectors->load(buf);
+    return _quantized_vectors_loaded;
 }
 
 struct NeighborsByDocId {
@@ -901,16 +1271,38 @@ std::vector<NearestNeighborIndex::Neighbor>
 HnswIndex<type>::top_k_by_docid(
         uint32_t k,
         const BoundDistanceFunction &df,
-        const GlobalFilter *filter, uint32_t explore_k,
+        const GlobalFilter *filter, bool filter_first, uint32_t explore_k,
         const vespalib::Doom& doom,
         double distance_threshold) const
 {
-    SearchBestNeighbors candidates = top_k_candidates(df, std::max(k, explore_k), filter, doom);
+    auto* quantized_df = (_quantized_vectors) ? dynamic_cast<const QuantizedBoundDistanceFunction*>(&df) : nullptr;
+    SearchBestNeighbors candidates;
+    if (quantized_df != nullptr) {
+        // Traverse the graph using the quantized codes, then rescore the best candidates.
+        auto quantized_candidates = top_k_candidates(quantized_df->traversal(), std::max(k, explore_k), filter, doom,
+                                                     _quantized_vectors.get(), filter_first);
+        candidates = rescore_candidates(quantized_candidates, quantized_df->full());
+    } else {
+        candidates = top_k_candidates(df, std::max(k, explore_k), filter, doom, nullptr, filter_first);
+    }
     auto result = candidates.get_neighbors(k, distance_threshold);
     std::sort(result.begin(), result.end(), NeighborsByDocId());
     return result;
 }
 
+template <HnswIndexType type>
+typename HnswIndex<type>::SearchBestNeighbors
+HnswIndex<type>::rescore_candidates(const SearchBestNeighbors& candidates, const BoundDistanceFunction &df) const
+{
+    SearchBestNeighbors result;
+    for (const auto& candidate : candidates.peek()) {
+        auto& node = _graph.acquire_node(candidate.nodeid);
+        double dist = calc_distance(df, candidate.docid, node.acquire_subspace());
+        result.emplace(candidate.nodeid, candidate.docid, candidate.levels_ref, dist);
+    }
+    return result;
+}
+
 template <HnswIndexType type>
 std::vector<NearestNeighborIndex::Neighbor>
 HnswIndex<type>::find_top_k(
@@ -920,7 +1312,7 @@ HnswIndex<type>::find_top_k(
         const vespalib::Doom& doom,
         double distance_threshold) const
 {
-    return top_k_by_docid(k, df, nullptr, explore_k, doom, distance_threshold);
+    return top_k_by_docid(k, df, nullptr, false, explore_k, doom, distance_threshold);
 }
 
 template <HnswIndexType type>
@@ -928,11 +1320,12 @@ std::vector<NearestNeighborIndex::Neighbor>
 HnswIndex<type>::find_top_k_with_filter(
         uint32_t k,
         const BoundDistanceFunction &df,
-        const GlobalFilter &filter, uint32_t explore_k,
+        const GlobalFilter &filter, bool filter_first,
+        uint32_t explore_k,
         const vespalib::Doom& doom,
         double distance_threshold) const
 {
-    return top_k_by_docid(k, df, &filter, explore_k, doom, distance_threshold);
+    return top_k_by_docid(k, df, &filter, filter_first, explore_k, doom, distance_threshold);
 }
 
 template <HnswIndexType type>
@@ -940,7 +1333,9 @@ typename HnswIndex<type>::SearchBestNeighbors
 HnswIndex<type>::top_k_candidates(
         const BoundDistanceFunction &df,
         uint32_t k, const GlobalFilter *filter,
-        const vespalib::Doom& doom) const
+        const vespalib::Doom& doom,
+        const QuantizedVectorStore* codes,
+        bool filter_first) const
 {
     SearchBestNeighbors best_neighbors;
     auto entry = _graph.get_entry_node();
@@ -949,16 +1344,16 @@ HnswIndex<type>::top_k_candidates(
         return best_neighbors;
     }
     int search_level = entry.level;
-    double entry_dist = calc_distance(df, entry.nodeid);
+    double entry_dist = (codes != nullptr) ? df.calc(codes->get_codes(entry.nodeid)) : calc_distance(df, entry.nodeid);
     uint32_t entry_docid = get_docid(entry.nodeid);
     // TODO: check if entry docid/levels_ref is still valid here
     HnswCandidate entry_point(entry.nodeid, entry_docid, entry.levels_ref, entry_dist);
     while (search_level > 0) {
-        entry_point = find_nearest_in_layer(df, entry_point, search_level);
+        entry_point = find_nearest_in_layer(df, entry_point, search_level, codes);
         --search_level;
     }
     best_neighbors.push(entry_point);
-    search_layer(df, k, best_neighbors, 0, &doom, filter);
+    search_layer(df, k, best_neighbors, 0, &doom, filter, codes, filter_first);
     return best_neighbors;
 }
 
@@ -13,6 +13,7 @@
 #include "hnsw_single_best_neighbors.h"
 #include "hnsw_test_node.h"
 #include "nearest_neighbor_index.h"
+#include "quantized_vector_store.h"
 #include "random_level_generator.h"
 #include "hnsw_graph.h"
 #include "vector_bundle.h"
@@ -109,6 +110,11 @@ protected:
     RandomLevelGenerator::UP _level_generator;
     IdMapping _id_mapping; // mapping from docid to nodeid vector
     HnswIndexConfig _cfg;
+    // Optional quantized codes (indexed by nodeid) used for graph traversal when searching.
+    std::unique_ptr<QuantizedVectorStore> _quantized_vectors;
+    std::unique_ptr<QuantizedDistanceFunctionFactory> _quantized_ff;
+    bool _quantized_vectors_loaded; // codes restored from file, no need to populate them after loading graph
+    uint32_t _maintenance_nodeid; // next node to be checked by maintain_graph()
 
     uint32_t max_links_for_level(uint32_t level) const;
     void add_link_to(uint32_t nodeid, uint32_t level, const LinkArrayRef& old_links, uint32_t new_link) {
@@ -160,26 +166,64 @@ protected:
 
     double calc_distance(const BoundDistanceFunction &df, uint32_t rhs_nodeid) const;
     double calc_distance(const BoundDistanceFunction &df, uint32_t rhs_docid, uint32_t rhs_subspace) const;
+    /**
+     * Calculates the distance used when traversing the graph, either using the full-precision
+     * vector or the quantized codes (if given).
+     */
+    double calc_traversal_distance(const BoundDistanceFunction &df, const QuantizedVectorStore* codes,
+                                   uint32_t rhs_nodeid, uint32_t rhs_docid, uint32_t rhs_subspace) const {
+        return (codes != nullptr) ? df.calc(codes->get_codes(rhs_nodeid)) : calc_distance(df, rhs_docid, rhs_subspace);
+    }
+    /**
+     * Returns the vector used when traversing the graph, either the full-precision
+     * vector or the quantized codes (if given).
+     */
+    TypedCells get_traversal_vector(const QuantizedVectorStore* codes, uint32_t nodeid, uint32_t docid, uint32_t subspace) const {
+        return (codes != nullptr) ? codes->get_codes(nodeid) : get_vector(docid, subspace);
+    }
+    // Hints the cpu to fetch the graph node entries of the given neighbors before they are explored.
+    // The vectors of unvisited neighbors are prefetched separately by search_layer_helper().
+    void prefetch_neighbor_nodes(const LinkArrayRef& neighbors, uint32_t nodeid_limit) const;
     uint32_t estimate_visited_nodes(uint32_t level, uint32_t nodeid_limit, uint32_t neighbors_to_find, const GlobalFilter* filter) const;
 
     /**
      * Performs a greedy search in the given layer to find the candidate that is nearest the input vector.
      */
-    HnswCandidate find_nearest_in_layer(const BoundDistanceFunction &df, const HnswCandidate& entry_point, uint32_t level) const;
+    HnswCandidate find_nearest_in_layer(const BoundDistanceFunction &df, const HnswCandidate& entry_point, uint32_t level,
+                                        const QuantizedVectorStore* codes = nullptr) const;
     template <class VisitedTracker, class BestNeighbors>
     void search_layer_helper(const BoundDistanceFunction &df, uint32_t neighbors_to_find, BestNeighbors& best_neighbors,
                              uint32_t level, const GlobalFilter *filter,
                              uint32_t nodeid_limit,
                              const vespalib::Doom* const doom,
-                             uint32_t estimated_visited_nodes) const;
+                             uint32_t estimated_visited_nodes,
+                             const QuantizedVectorStore* codes) const;
+    /**
+     * Variant of search_layer_helper used when few documents match the filter.
+     * Nodes not matching the filter are never scored, but their neighbors are
+     * explored (two-hop expansion) to keep the search connected.
+     */
+    template <class VisitedTracker, class BestNeighbors>
+    void search_layer_filter_first_helper(const BoundDistanceFunction &df, uint32_t neighbors_to_find, BestNeighbors& best_neighbors,
+                                          uint32_t level, const GlobalFilter *filter,
+                                          uint32_t nodeid_limit,
+                                          const vespalib::Doom* const doom,
+                                          uint32_t estimated_visited_nodes,
+                                          const QuantizedVectorStore* codes) const;
     template <class BestNeighbors>
     void search_layer(const BoundDistanceFunction &df, uint32_t neighbors_to_find, BestNeighbors& best_neighbors,
                       uint32_t level, const vespalib::Doom* const doom,
-                      const GlobalFilter *filter = nullptr) const;
+                      const GlobalFilter *filter = nullptr,
+                      const QuantizedVectorStore* codes = nullptr,
+                      bool filter_first = false) const;
     std::vector<Neighbor> top_k_by_docid(uint32_t k, const BoundDistanceFunction &df,
-                                         const GlobalFilter *filter, uint32_t explore_k,
+                                         const GlobalFilter *filter, bool filter_first, uint32_t explore_k,
                                          const vespalib::Doom& doom,
                                          double distance_threshold) const;
+    /**
+     * Recalculates the distances of the given candidates using the full-precision vectors.
+     */
+    SearchBestNeighbors rescore_candidates(const SearchBestNeighbors& candidates, const BoundDistanceFunction &df) const;
 
     internal::PreparedAddDoc internal_prepare_add(uint32_t docid, VectorBundle input_vectors,
                                         vespalib::GenerationHandler::Guard read_guard) const;
@@ -187,9 +231,21 @@ protected:
     LinkArray filter_valid_nodeids(uint32_t level, const internal::PreparedAddNode::Links &neighbors, uint32_t self_nodeid);
     void internal_complete_add(uint32_t docid, internal::PreparedAddDoc &op);
     void internal_complete_add_node(uint32_t nodeid, uint32_t docid, uint32_t subspace, internal::PreparedAddNode &prepared_node);
+    void populate_quantized_vectors();
+
+    /**
+     * Two-phase repair of a node that lost too many of its neighbors. The prepare step
+     * searches for new neighbors like when the node was added, excluding the node itself.
+     * The complete step links the node to the ones not already linked and still valid.
+     */
+    internal::PreparedAddNode prepare_repair_node(uint32_t nodeid, uint32_t num_levels) const;
+    bool complete_repair_node(uint32_t nodeid, internal::PreparedAddNode& prepared_node);
+    // Returns true if a search using the vector of the given node finds the node.
+    bool probe_node(uint32_t nodeid) const;
 public:
     HnswIndex(const DocVectorAccess& vectors, DistanceFunctionFactory::UP distance_ff,
-              RandomLevelGenerator::UP level_generator, const HnswIndexConfig& cfg);
+              RandomLevelGenerator::UP level_generator, const HnswIndexConfig& cfg,
+              std::unique_ptr<QuantizedVectorStore> quantized_vectors = {});
     ~HnswIndex() override;
 
     const HnswIndexConfig& config() const { return _cfg; }
@@ -212,9 +268,12 @@ public:
     void populate_address_space_usage(search::AddressSpaceUsage& usage) const override;
     void get_state(const vespalib::slime::Inserter& inserter) const override;
     void shrink_lid_space(uint32_t doc_id_limit) override;
+    GraphMaintenanceStats maintain_graph(uint32_t nodes_to_check, uint32_t nodes_to_probe, uint32_t max_repairs) override;
 
     std::unique_ptr<NearestNeighborIndexSaver> make_saver(vespalib::GenericHeader& header) const override;
     std::unique_ptr<NearestNeighborIndexLoader> make_loader(FastOS_FileInterface& file, const vespalib::GenericHeader& header) override;
+    std::unique_ptr<NearestNeighborIndexSaver> make_quantized_vectors_saver() const override;
+    bool load_quantized_vectors(const search::fileutil::LoadedBuffer& buf) override;
 
     std::vector<Neighbor> find_top_k(
             uint32_t k,
@@ -226,16 +285,24 @@ public:
     std::vector<Neighbor> find_top_k_with_filter(
             uint32_t k,
             const BoundDistanceFunction &df,
-            const GlobalFilter &filter, uint32_t explore_k,
+            const GlobalFilter &filter, bool filter_first,
+            uint32_t explore_k,
             const vespalib::Doom& doom,
             double distance_threshold) const override;
 
-    DistanceFunctionFactory &distance_function_factory() const override { return *_distance_ff; }
+    DistanceFunctionFactory &distance_function_factory() const override {
+        if (_quantized_ff) {
+            return *_quantized_ff;
+        }
+        return *_distance_ff;
+    }
 
     SearchBestNeighbors top_k_candidates(
             const BoundDistanceFunction &df,
             uint32_t k, const GlobalFilter *filter,
-            const vespalib::Doom& doom) const;
+            const vespalib::Doom& doom,
+            const QuantizedVectorStore* codes = nullptr,
+            bool filter_first = false) const;
 
     uint32_t get_entry_nodeid() const { return _graph.get_entry_node().nodeid; }
     int32_t get_entry_level() const { return _graph.get_entry_node().level; }
@@ -247,6 +314,7 @@ public:
     std::pair<uint32_t, bool> count_reachable_nodes() const;
     GraphType& get_graph() { return _graph; }
     IdMapping& get_id_mapping() { return _id_mapping; }
+    const QuantizedVectorStore* get_quantized_vectors() const { return _quantized_vectors.get(); }
 
     static vespalib::datastore::ArrayStoreConfig make_default_level_array_store_config();
     static vespalib::datastore::ArrayStoreConfig make_default_link_array_store_config();
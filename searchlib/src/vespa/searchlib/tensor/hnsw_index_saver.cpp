@@ -8,91 +8,58 @@
 
 namespace search::tensor {
 
-namespace {
-
 template <HnswIndexType type>
-size_t
-count_valid_link_arrays(const HnswGraph<type> & graph) {
-    size_t count(0);
-    size_t num_nodes = graph.nodes.get_size(); // Called from writer only
-    for (size_t i = 0; i < num_nodes; ++i) {
-        auto levels_ref = graph.get_levels_ref(i);
-        if (levels_ref.valid()) {
-            count += graph.levels_store.get(levels_ref).size();
-        }
-    }
-    return count;
-}
-
+HnswIndexSaver<type>::~HnswIndexSaver()
+{
+    _snapshot->release();
 }
 
-template <HnswIndexType type>
-HnswIndexSaver<type>::MetaData::MetaData()
-    : entry_nodeid(0),
-      entry_level(-1),
-      refs(),
-      nodes()
-{}
-
-template <HnswIndexType type>
-HnswIndexSaver<type>::MetaData::~MetaData() = default;
-
-template <HnswIndexType type>
-HnswIndexSaver<type>::~HnswIndexSaver() = default;
-
 template <HnswIndexType type>
 HnswIndexSaver<type>::HnswIndexSaver(const HnswGraph<type> &graph)
-    : _graph_links(graph.links_store), _meta_data()
+    : _graph(graph),
+      _entry_nodeid(0),
+      _entry_level(-1),
+      _snapshot()
 {
     auto entry = graph.get_entry_node();
-    _meta_data.entry_nodeid = entry.nodeid;
-    _meta_data.entry_level = entry.level;
+    _entry_nodeid = entry.nodeid;
+    _entry_level = entry.level;
     size_t num_nodes = graph.nodes.get_size(); // Called from writer only
     assert (num_nodes <= (std::numeric_limits<uint32_t>::max() - 1));
-    size_t link_array_count = count_valid_link_arrays(graph);
-    assert (link_array_count <= std::numeric_limits<uint32_t>::max());
-    _meta_data.refs.reserve(link_array_count);
-    _meta_data.nodes.reserve(num_nodes+1);
-    for (size_t i = 0; i < num_nodes; ++i) {
-        auto& node = graph.nodes.get_elem_ref(i);
-        _meta_data.nodes.emplace_back(_meta_data.refs.size(), node);
-        auto levels_ref = node.levels_ref().load_relaxed();
-        if (levels_ref.valid()) {
-            auto levels = graph.levels_store.get(levels_ref);
-            for (const auto& links_ref : levels) {
-                _meta_data.refs.push_back(links_ref.load_relaxed());
-            }
-        }
-    }
-    _meta_data.nodes.emplace_back(_meta_data.refs.size());
+    _snapshot = graph.make_snapshot();
 }
 
 template <HnswIndexType type>
 void
 HnswIndexSaver<type>::save(BufferWriter& writer) const
 {
-    writer.write(&_meta_data.entry_nodeid, sizeof(uint32_t));
-    writer.write(&_meta_data.entry_level, sizeof(int32_t));
-    uint32_t num_nodes = _meta_data.nodes.size() - 1;
+    writer.write(&_entry_nodeid, sizeof(uint32_t));
+    writer.write(&_entry_level, sizeof(int32_t));
+    uint32_t num_nodes = _snapshot->num_nodes();
     writer.write(&num_nodes, sizeof(uint32_t));
+    HnswGraphSnapshot::Node node;
     for (uint32_t i(0); i < num_nodes; i++) {
-        auto& node = _meta_data.nodes[i];
-        uint32_t offset = node.get_refs_offset();
-        uint32_t next_offset = _meta_data.nodes[i+1].get_refs_offset();
-        uint32_t num_levels = next_offset - offset;
+        node.links_refs.clear();
+        _snapshot->get(i, node, [this, i](HnswGraphSnapshot::Node& live) {
+            auto& graph_node = _graph.acquire_node(i);
+            live.docid = graph_node.acquire_docid();
+            live.subspace = graph_node.acquire_subspace();
+            auto levels = _graph.get_level_array(graph_node.levels_ref().load_acquire());
+            for (const auto& links_ref : levels) {
+                live.links_refs.push_back(links_ref.load_acquire());
+            }
+        });
+        uint32_t num_levels = node.links_refs.size();
         writer.write(&num_levels, sizeof(uint32_t));
         if (num_levels > 0) {
-            if constexpr (!HnswIndexSaverMetaDataNode<type>::identity_mapping) {
-                uint32_t docid = node.get_docid();
-                uint32_t subspace = node.get_subspace();
-                writer.write(&docid, sizeof(uint32_t));
-                writer.write(&subspace, sizeof(uint32_t));
+            if constexpr (!HnswGraph<type>::NodeType::identity_mapping) {
+                writer.write(&node.docid, sizeof(uint32_t));
+                writer.write(&node.subspace, sizeof(uint32_t));
             }
         }
-        for (; offset < next_offset; offset++) {
-            auto links_ref = _meta_data.refs[offset];
+        for (auto links_ref : node.links_refs) {
             if (links_ref.valid()) {
-                vespalib::ConstArrayRef<uint32_t> link_array = _graph_links.get(links_ref);
+                vespalib::ConstArrayRef<uint32_t> link_array = _graph.links_store.get(links_ref);
                 uint32_t num_links = link_array.size();
                 writer.write(&num_links, sizeof(uint32_t));
                 writer.write(link_array.cbegin(), sizeof(uint32_t)*num_links);
@@ -103,6 +70,7 @@ HnswIndexSaver<type>::save(BufferWriter& writer) const
         }
     }
     writer.flush();
+    _snapshot->release();
 }
 
 template class HnswIndexSaver<HnswIndexType::SINGLE>;
@@ -4,18 +4,16 @@
 
 #include "nearest_neighbor_index_saver.h"
 #include "hnsw_graph.h"
-#include "hnsw_index_saver_metadata_node.h"
-#include <vespa/vespalib/datastore/entryref.h>
-#include <vespa/vespalib/stllike/allocator.h>
-#include <vector>
+#include <memory>
 
 namespace search::tensor {
 
 /**
  * Implements saving of HNSW graph structure in binary format.
- * The constructor takes a snapshot of all meta-data, but
- * the links will be fetched from the graph in the save()
- * method.
+ * The constructor takes a snapshot of the graph (see HnswGraphSnapshot)
+ * without copying the nodes. The save() method streams the nodes from
+ * the live graph, except the ones changed after the snapshot was taken,
+ * which the graph has preserved in the snapshot.
  **/
 template <HnswIndexType type>
 class HnswIndexSaver : public NearestNeighborIndexSaver {
@@ -25,17 +23,10 @@ public:
     void save(BufferWriter& writer) const override;
 
 private:
-    struct MetaData {
-        using EntryRef = vespalib::datastore::EntryRef;
-        uint32_t entry_nodeid;
-        int32_t  entry_level;
-        std::vector<EntryRef, vespalib::allocator_large<EntryRef>> refs;
-        std::vector<HnswIndexSaverMetaDataNode<type>, vespalib::allocator_large<HnswIndexSaverMetaDataNode<type>>> nodes;
-        MetaData();
-        ~MetaData();
-    };
-    const typename HnswGraph<type>::LinkArrayStore &_graph_links;
-    MetaData _meta_data;
+    const HnswGraph<type>             &_graph;
+    uint32_t                           _entry_nodeid;
+    int32_t                            _entry_level;
+    std::shared_ptr<HnswGraphSnapshot> _snapshot;
 };
 
 }
@@ -52,6 +52,21 @@ public:
             return docid == rhs.docid && distance == rhs.distance;
         }
     };
+    // Outcome of a step of graph maintenance, see maintain_graph().
+    struct GraphMaintenanceStats {
+        uint32_t checked_nodes;  // nodes checked for degradation
+        uint32_t degraded_nodes; // checked nodes found to be degraded
+        uint32_t repaired_nodes; // degraded nodes that were given new neighbors
+        uint32_t probed_nodes;   // checked nodes searched for using their own vector
+        uint32_t found_nodes;    // probed nodes found by that search
+        GraphMaintenanceStats() noexcept
+            : checked_nodes(0), degraded_nodes(0), repaired_nodes(0), probed_nodes(0), found_nodes(0)
+        {}
+        // Estimated recall of searches in the index, 1.0 if no nodes were probed.
+        double probe_recall() const noexcept {
+            return (probed_nodes == 0) ? 1.0 : (double(found_nodes) / probed_nodes);
+        }
+    };
     virtual ~NearestNeighborIndex() = default;
     virtual void add_document(uint32_t docid) = 0;
 
@@ -84,6 +99,23 @@ public:
     virtual void get_state(const vespalib::slime::Inserter& inserter) const = 0;
     virtual void shrink_lid_space(uint32_t doc_id_limit) = 0;
 
+    /**
+     * Checks the health of the next nodes_to_check nodes of the index, and repairs up to
+     * max_repairs of the nodes found to be degraded after heavy removes and updates.
+     * Up to nodes_to_probe of the checked nodes are searched for using their own vector,
+     * to estimate the recall of the index. Successive calls continue where the previous
+     * call stopped, wrapping around at the end of the index.
+     *
+     * This function is only called by the attribute writer thread.
+     * The default implementation does nothing.
+     */
+    virtual GraphMaintenanceStats maintain_graph(uint32_t nodes_to_check, uint32_t nodes_to_probe, uint32_t max_repairs) {
+        (void) nodes_to_check;
+        (void) nodes_to_probe;
+        (void) max_repairs;
+        return {};
+    }
+
     /**
      * Creates a saver that is used to save the index to binary form.
      *
@@ -99,16 +131,34 @@ public:
      */
     virtual std::unique_ptr<NearestNeighborIndexLoader> make_loader(FastOS_FileInterface& file, const vespalib::GenericHeader& header) = 0;
 
+    /**
+     * Creates a saver for the quantized vectors used for graph traversal,
+     * or nullptr if the index has no quantized vectors.
+     *
+     * This function is always called by the attribute write thread.
+     */
+    virtual std::unique_ptr<NearestNeighborIndexSaver> make_quantized_vectors_saver() const = 0;
+
+    /**
+     * Restores quantized vectors saved by a saver from make_quantized_vectors_saver(),
+     * so they are not recalculated from the full vectors when loading the index.
+     * Must be called before make_loader(). Returns false if buf could not be used.
+     */
+    virtual bool load_quantized_vectors(const search::fileutil::LoadedBuffer& buf) = 0;
+
     virtual std::vector<Neighbor> find_top_k(uint32_t k,
                                              const BoundDistanceFunction &df,
                                              uint32_t explore_k,
                                              const vespalib::Doom& doom,
                                              double distance_threshold) const = 0;
 
-    // only return neighbors where the corresponding filter bit is set
+    // only return neighbors where the corresponding filter bit is set.
+    // When filter_first is set, the index may explore past nodes not matching
+    // the filter, without calculating the distance to them (used for low filter hit ratios).
     virtual std::vector<Neighbor> find_top_k_with_filter(uint32_t k,
                                                          const BoundDistanceFunction &df,
                                                          const GlobalFilter &filter,
+                                                         bool filter_first,
                                                          uint32_t explore_k,
                                                          const vespalib::Doom& doom,
                                                          double distance_threshold) const = 0;
@@ -14,7 +14,8 @@ namespace search::tensor {
  *
  * The instance is always created by the attribute write thread,
  * and the caller ensures that an attribute read guard is held during the lifetime of the saver.
- * Data that might change later must be copied in the constructor.
+ * Data that might change later must be copied in the constructor,
+ * or be preserved by the writer before it is changed.
  *
  * A flush thread is calling save() at a later point in time.
  */
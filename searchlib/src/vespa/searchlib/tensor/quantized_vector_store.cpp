@@ -0,0 +1,259 @@
+// Copyright Vespa.ai. Licensed under the terms of the Apache 2.0 license. See LICENSE in the project root.
+
+#include "quantized_vector_store.h"
+#include "hamming_distance.h"
+#include "nearest_neighbor_index_saver.h"
+#include <vespa/eval/eval/int8float.h>
+#include <vespa/searchlib/util/bufferwriter.h>
+#include <vespa/searchlib/util/fileutil.h>
+#include <vespa/vespalib/stllike/allocator.h>
+#include <vespa/vespalib/util/typify.h>
+#include <algorithm>
+#include <cassert>
+#include <cmath>
+#include <cstring>
+
+using search::attribute::DistanceMetric;
+using search::attribute::VectorQuantization;
+using vespalib::eval::CellType;
+using vespalib::eval::Int8Float;
+using vespalib::eval::TypedCells;
+using vespalib::eval::TypifyCellType;
+
+namespace search::tensor {
+
+namespace {
+
+// The int8 scale is derived from the first vector, leaving room for larger values in later vectors.
+constexpr float int8_headroom = 2.0;
+constexpr float int8_max = 127.0;
+
+struct MaxAbsCell {
+    template <typename CT>
+    static float invoke(TypedCells cells) {
+        float result = 0.0;
+        for (auto value : cells.unsafe_typify<CT>()) {
+            result = std::max(result, std::abs(float(value)));
+        }
+        return result;
+    }
+};
+
+struct QuantizeInt8 {
+    template <typename CT>
+    static void invoke(TypedCells cells, float scale, int8_t* dst) {
+        for (auto value : cells.unsafe_typify<CT>()) {
+            float scaled = std::round(float(value) * scale);
+            *dst++ = static_cast<int8_t>(std::clamp(scaled, -int8_max, int8_max));
+        }
+    }
+};
+
+struct QuantizeBinary {
+    template <typename CT>
+    static void invoke(TypedCells cells, int8_t* dst) {
+        auto values = cells.unsafe_typify<CT>();
+        for (size_t i = 0; i < values.size(); i += 8) {
+            uint8_t bits = 0;
+            for (size_t j = i; j < std::min(i + 8, values.size()); ++j) {
+                bits = (bits << 1) | ((float(values[j]) > 0.0f) ? 1 : 0);
+            }
+            *dst++ = static_cast<int8_t>(bits);
+        }
+    }
+};
+
+/*
+ * Layout of saved codes: quantization, code size, int8 scale, nodeid limit,
+ * then code size bytes for each nodeid below the limit.
+ */
+struct SavedCodesHeader {
+    uint32_t quantization;
+    uint32_t code_size;
+    float    scale;
+    uint32_t nodeid_limit;
+};
+
+class QuantizedVectorStoreSaver : public NearestNeighborIndexSaver {
+    SavedCodesHeader                                       _header;
+    std::vector<int8_t, vespalib::allocator_large<int8_t>> _codes;
+public:
+    QuantizedVectorStoreSaver(const SavedCodesHeader& header, const int8_t* codes)
+        : _header(header),
+          _codes(codes, codes + size_t(header.nodeid_limit) * header.code_size)
+    {
+    }
+    void save(BufferWriter& writer) const override {
+        writer.write(&_header, sizeof(_header));
+        writer.write(_codes.data(), _codes.size());
+        writer.flush();
+    }
+};
+
+uint32_t
+calc_code_size(VectorQuantization quantization, uint32_t vector_size)
+{
+    return (quantization == VectorQuantization::Binary) ? ((vector_size + 7) / 8) : vector_size;
+}
+
+DistanceFunctionFactory::UP
+make_code_distance_function_factory(VectorQuantization quantization, DistanceMetric distance_metric)
+{
+    if (quantization == VectorQuantization::Binary) {
+        return std::make_unique<HammingDistanceFunctionFactory<Int8Float>>();
+    }
+    switch (distance_metric) {
+    case DistanceMetric::InnerProduct:
+    case DistanceMetric::Dotproduct:
+        // Codes are only used to order candidates, so the inner product is sufficient.
+        return make_distance_function_factory(DistanceMetric::PrenormalizedAngular, CellType::INT8);
+    default:
+        return make_distance_function_factory(distance_metric, CellType::INT8);
+    }
+}
+
+}
+
+QuantizedVectorStore::QuantizedVectorStore(VectorQuantization quantization,
+                                           DistanceMetric distance_metric,
+                                           uint32_t vector_size)
+    : _quantization(quantization),
+      _vector_size(vector_size),
+      _code_size(calc_code_size(quantization, vector_size)),
+      _scale(0.0),
+      _codes(),
+      _code_distance_ff(make_code_distance_function_factory(quantization, distance_metric))
+{
+    assert(quantization != VectorQuantization::None);
+    assert(supports(distance_metric));
+}
+
+QuantizedVectorStore::~QuantizedVectorStore() = default;
+
+bool
+QuantizedVectorStore::supports(DistanceMetric distance_metric)
+{
+    return (distance_metric != DistanceMetric::GeoDegrees) && (distance_metric != DistanceMetric::Hamming);
+}
+
+float
+QuantizedVectorStore::calc_scale(TypedCells vector) const
+{
+    float max_abs = vespalib::typify_invoke<1,TypifyCellType,MaxAbsCell>(vector.type, vector);
+    return (max_abs > 0.0f) ? (int8_max / (max_abs * int8_headroom)) : 1.0f;
+}
+
+void
+QuantizedVectorStore::quantize(TypedCells vector, int8_t* dst) const
+{
+    assert(vector.size == _vector_size);
+    if (_quantization == VectorQuantization::Binary) {
+        vespalib::typify_invoke<1,TypifyCellType,QuantizeBinary>(vector.type, vector, dst);
+    } else {
+        float scale = _scale.load(std::memory_order_relaxed);
+        vespalib::typify_invoke<1,TypifyCellType,QuantizeInt8>(vector.type, vector, (scale > 0.0f) ? scale : 1.0f, dst);
+    }
+}
+
+void
+QuantizedVectorStore::set_vector(uint32_t nodeid, TypedCells vector)
+{
+    if (_quantization == VectorQuantization::Int8 && _scale.load(std::memory_order_relaxed) == 0.0f) {
+        _scale.store(calc_scale(vector), std::memory_order_relaxed);
+    }
+    size_t offset = size_t(nodeid) * _code_size;
+    _codes.ensure_size(offset + _code_size);
+    quantize(vector, &_codes[offset]);
+}
+
+BoundDistanceFunction::UP
+QuantizedVectorStore::make_traversal_function(const TypedCells& query_vector) const
+{
+    std::vector<int8_t> query_codes(_code_size);
+    quantize(query_vector, query_codes.data());
+    TypedCells lhs(query_codes.data(), CellType::INT8, _code_size);
+    // The bound distance function keeps its own copy of the quantized query vector.
+    return _code_distance_ff->for_query_vector(lhs);
+}
+
+std::unique_ptr<NearestNeighborIndexSaver>
+QuantizedVectorStore::make_saver(uint32_t nodeid_limit) const
+{
+    nodeid_limit = std::min(nodeid_limit, uint32_t(_codes.get_size() / _code_size));
+    SavedCodesHeader header{uint32_t(_quantization), _code_size, _scale.load(std::memory_order_relaxed), nodeid_limit};
+    const int8_t* codes = (nodeid_limit > 0) ? &_codes.acquire_elem_ref(0) : nullptr;
+    return std::make_unique<QuantizedVectorStoreSaver>(header, codes);
+}
+
+bool
+QuantizedVectorStore::load(const fileutil::LoadedBuffer& buf)
+{
+    SavedCodesHeader header;
+    if (buf.size() < sizeof(header)) {
+        return false;
+    }
+    memcpy(&header, buf.c_str(), sizeof(header));
+    size_t codes_size = size_t(header.nodeid_limit) * header.code_size;
+    if ((header.quantization != uint32_t(_quantization)) || (header.code_size != _code_size) ||
+        (buf.size() != sizeof(header) + codes_size)) {
+        return false;
+    }
+    _scale.store(header.scale, std::memory_order_relaxed);
+    if (codes_size > 0) {
+        _codes.ensure_size(codes_size);
+        memcpy(&_codes[0], buf.c_str() + sizeof(header), codes_size);
+    }
+    return true;
+}
+
+void
+QuantizedVectorStore::assign_generation(generation_t current_gen)
+{
+    // Note: RcuVector transfers hold lists as part of reallocation based on current generation.
+    _codes.setGeneration(current_gen + 1);
+}
+
+void
+QuantizedVectorStore::reclaim_memory(generation_t oldest_used_gen)
+{
+    _codes.reclaim_memory(oldest_used_gen);
+}
+
+vespalib::MemoryUsage
+QuantizedVectorStore::memory_usage() const
+{
+    return _codes.getMemoryUsage();
+}
+
+QuantizedBoundDistanceFunction::QuantizedBoundDistanceFunction(BoundDistanceFunction::UP full, BoundDistanceFunction::UP traversal)
+    : BoundDistanceFunction(),
+      _full(std::move(full)),
+      _traversal(std::move(traversal))
+{
+}
+
+QuantizedBoundDistanceFunction::~QuantizedBoundDistanceFunction() = default;
+
+QuantizedDistanceFunctionFactory::QuantizedDistanceFunctionFactory(DistanceFunctionFactory& full_ff, const QuantizedVectorStore& store)
+    : DistanceFunctionFactory(),
+      _full_ff(full_ff),
+      _store(store)
+{
+}
+
+QuantizedDistanceFunctionFactory::~QuantizedDistanceFunctionFactory() = default;
+
+BoundDistanceFunction::UP
+QuantizedDistanceFunctionFactory::for_query_vector(const TypedCells& lhs)
+{
+    return std::make_unique<QuantizedBoundDistanceFunction>(_full_ff.for_query_vector(lhs),
+                                                            _store.make_traversal_function(lhs));
+}
+
+BoundDistanceFunction::UP
+QuantizedDistanceFunctionFactory::for_insertion_vector(const TypedCells& lhs)
+{
+    return _full_ff.for_insertion_vector(lhs);
+}
+
+}
@@ -0,0 +1,133 @@
+// Copyright Vespa.ai. Licensed under the terms of the Apache 2.0 license. See LICENSE in the project root.
+
+#pragma once
+
+#include "bound_distance_function.h"
+#include "distance_function_factory.h"
+#include <vespa/eval/eval/typed_cells.h>
+#include <vespa/searchcommon/attribute/distance_metric.h>
+#include <vespa/searchcommon/attribute/vector_quantization.h>
+#include <vespa/vespalib/util/generationhandler.h>
+#include <vespa/vespalib/util/memoryusage.h>
+#include <vespa/vespalib/util/rcuvector.h>
+#include <atomic>
+
+namespace search::fileutil { class LoadedBuffer; }
+
+namespace search::tensor {
+
+class NearestNeighborIndexSaver;
+
+/**
+ * Compact companion store of quantized vectors, indexed by hnsw nodeid.
+ *
+ * Int8 quantization maps each cell to a signed byte using a scale that is
+ * derived from the first vector stored (with headroom), clamping outliers.
+ * Binary quantization keeps the sign bit of each cell, packed 8 cells per byte.
+ *
+ * The codes are exposed as int8 cells, so the regular distance functions
+ * (or the binary hamming distance) are used to compare them with the
+ * quantized query vector. Supports one writer thread and multiple reader
+ * threads using generation tracking, in the same way as the hnsw graph.
+ */
+class QuantizedVectorStore {
+public:
+    using generation_t = vespalib::GenerationHandler::generation_t;
+private:
+    search::attribute::VectorQuantization _quantization;
+    uint32_t                        _vector_size;
+    uint32_t                        _code_size;
+    std::atomic<float>              _scale;
+    vespalib::RcuVector<int8_t>     _codes;
+    DistanceFunctionFactory::UP     _code_distance_ff;
+
+    float calc_scale(vespalib::eval::TypedCells vector) const;
+public:
+    QuantizedVectorStore(search::attribute::VectorQuantization quantization,
+                         search::attribute::DistanceMetric distance_metric,
+                         uint32_t vector_size);
+    ~QuantizedVectorStore();
+
+    search::attribute::VectorQuantization quantization() const noexcept { return _quantization; }
+    uint32_t code_size() const noexcept { return _code_size; }
+
+    /**
+     * Returns whether traversal on quantized codes is supported for the given metric.
+     */
+    static bool supports(search::attribute::DistanceMetric distance_metric);
+
+    // Quantizes the given vector into code_size() bytes.
+    void quantize(vespalib::eval::TypedCells vector, int8_t* dst) const;
+
+    // Called by writer thread before the node is made visible in the graph.
+    void set_vector(uint32_t nodeid, vespalib::eval::TypedCells vector);
+
+    // Called by reader threads holding a generation guard.
+    vespalib::eval::TypedCells get_codes(uint32_t nodeid) const noexcept {
+        return {&_codes.acquire_elem_ref(size_t(nodeid) * _code_size), vespalib::eval::CellType::INT8, _code_size};
+    }
+
+    /**
+     * Makes a distance function used to compare the quantized query vector
+     * with the codes in this store.
+     */
+    BoundDistanceFunction::UP make_traversal_function(const vespalib::eval::TypedCells& query_vector) const;
+
+    /**
+     * Makes a saver with a copy of the codes for nodeids below nodeid_limit.
+     * Called by writer thread.
+     */
+    std::unique_ptr<NearestNeighborIndexSaver> make_saver(uint32_t nodeid_limit) const;
+
+    /**
+     * Restores codes written by a saver from make_saver(). Returns false (leaving the
+     * store unchanged) if the saved codes do not match the quantization used by this store.
+     */
+    bool load(const fileutil::LoadedBuffer& buf);
+
+    void assign_generation(generation_t current_gen);
+    void reclaim_memory(generation_t oldest_used_gen);
+    vespalib::MemoryUsage memory_usage() const;
+};
+
+/**
+ * Distance function bound to a query vector that carries both the
+ * full-precision distance function and the traversal distance
+ * function working on quantized codes.
+ *
+ * All regular calculations use the full-precision function.
+ */
+class QuantizedBoundDistanceFunction : public BoundDistanceFunction {
+    BoundDistanceFunction::UP _full;
+    BoundDistanceFunction::UP _traversal;
+public:
+    QuantizedBoundDistanceFunction(BoundDistanceFunction::UP full, BoundDistanceFunction::UP traversal);
+    ~QuantizedBoundDistanceFunction() override;
+    const BoundDistanceFunction& full() const noexcept { return *_full; }
+    const BoundDistanceFunction& traversal() const noexcept { return *_traversal; }
+    double calc(const vespalib::eval::TypedCells& rhs) const override { return _full->calc(rhs); }
+    double calc_with_limit(const vespalib::eval::TypedCells& rhs, double limit) const override {
+        return _full->calc_with_limit(rhs, limit);
+    }
+    double convert_threshold(double threshold) const override { return _full->convert_threshold(threshold); }
+    double to_rawscore(double distance) const override { return _full->to_rawscore(distance); }
+    double to_distance(double rawscore) const override { return _full->to_distance(rawscore); }
+    double min_rawscore() const override { return _full->min_rawscore(); }
+};
+
+/**
+ * Distance function factory used by an hnsw index with quantized codes.
+ * Query vectors are bound to a QuantizedBoundDistanceFunction, while
+ * insertion vectors use the full-precision factory.
+ */
+class QuantizedDistanceFunctionFactory : public DistanceFunctionFactory {
+    DistanceFunctionFactory&    _full_ff;
+    const QuantizedVectorStore& _store;
+public:
+    QuantizedDistanceFunctionFactory(DistanceFunctionFactory& full_ff, const QuantizedVectorStore& store);
+    ~QuantizedDistanceFunctionFactory() override;
+    BoundDistanceFunction::UP for_query_vector(const vespalib::eval::TypedCells& lhs) override;
+    BoundDistanceFunction::UP for_insertion_vector(const vespalib::eval::TypedCells& lhs) override;
+};
+
+}
@@ -4,6 +4,7 @@
 #include "serialized_tensor_ref.h"
 #include <vespa/eval/eval/value.h>
 #include <vespa/searchcommon/attribute/config.h>
+#include <vespa/vespalib/datastore/i_compaction_context.h>
 
 #include <vespa/log/log.h>
 
@@ -17,13 +18,15 @@ namespace search::tensor {
 SerializedFastValueAttribute::SerializedFastValueAttribute(stringref name, const Config &cfg, const NearestNeighborIndexFactory& index_factory)
     : TensorAttribute(name, cfg, _tensorBufferStore, index_factory),
       _tensorBufferStore(cfg.tensorType(), get_memory_allocator(),
-                         TensorBufferStore::array_store_max_type_id)
+                         TensorBufferStore::array_store_max_type_id,
+                         cfg.dedup_tensor_subspaces())
 {
 }
 
 
 SerializedFastValueAttribute::~SerializedFastValueAttribute()
 {
+    _compaction_context.reset();
     getGenerationHolder().reclaim_all();
     _tensorStore.reclaim_all_memory();
 }
@@ -63,6 +63,8 @@ TensorAttribute::TensorAttribute(vespalib::stringref name, const Config &cfg, Te
       _is_dense(cfg.tensorType().is_dense()),
       _emptyTensor(createEmptyTensor(cfg.tensorType())),
       _compactGeneration(0),
+      _compaction_context(),
+      _compaction_position(0),
       _subspace_type(cfg.tensorType()),
       _comp(cfg.tensorType())
 {
@@ -100,12 +102,8 @@ void
 TensorAttribute::onCommit()
 {
     incGeneration();
-    if (_tensorStore.consider_compact()) {
-        auto context = _tensorStore.start_compact(getConfig().getCompactionStrategy());
-        if (context) {
-            context->compact(vespalib::ArrayRef<AtomicEntryRef>(&_refVector[0], _refVector.size()));
-        }
-        _compactGeneration = getCurrentGeneration();
+    if (_compaction_context || _tensorStore.consider_compact()) {
+        compact_step();
         incGeneration();
         updateStat(true);
     }
@@ -127,6 +125,9 @@ TensorAttribute::onUpdateStat()
                            total.usedBytes(),
                            total.deadBytes(),
                            total.allocatedBytesOnHold());
+    size_t compaction_pending = (_compaction_context && _compaction_position < _refVector.size())
+                                ? (_refVector.size() - _compaction_position) : 0;
+    getStatus().setCompactionPending(compaction_pending);
 }
 
 void
@@ -205,6 +206,26 @@ TensorAttribute::consider_remove_from_index(DocId docid)
     }
 }
 
+void
+TensorAttribute::compact_step()
+{
+    auto& compaction_strategy = getConfig().getCompactionStrategy();
+    if (!_compaction_context) {
+        _compaction_context = _tensorStore.start_compact(compaction_strategy);
+        _compaction_position = 0;
+        if (!_compaction_context) {
+            return;
+        }
+    }
+    _compaction_position = _compaction_context->compact_step(vespalib::ArrayRef<AtomicEntryRef>(&_refVector[0], _refVector.size()),
+                                                             _compaction_position,
+                                                             compaction_strategy.get_max_moves_per_step());
+    if (_compaction_position >= _refVector.size()) {
+        _compaction_context.reset();
+        _compactGeneration = getCurrentGeneration();
+    }
+}
+
 vespalib::MemoryUsage
 TensorAttribute::update_stat()
 {
@@ -359,12 +380,14 @@ TensorAttribute::onInitSave(vespalib::stringref fileName)
                                              takeGuard());
     auto header = this->createAttributeHeader(fileName);
     auto index_saver = (_index ? _index->make_saver(header.get_extra_tags()) : std::unique_ptr<NearestNeighborIndexSaver>());
+    auto quantized_vectors_saver = (_index ? _index->make_quantized_vectors_saver() : std::unique_ptr<NearestNeighborIndexSaver>());
     return std::make_unique<TensorAttributeSaver>
         (std::move(guard),
          std::move(header),
          attribute::make_entry_ref_vector_snapshot(_refVector, getCommittedDocIdLimit()),
          _tensorStore,
-         std::move(index_saver));
+         std::move(index_saver),
+         std::move(quantized_vectors_saver));
 }
 
 void
@@ -392,9 +415,24 @@ TensorAttribute::update_tensor(DocId docId,
         return;
     }
     auto new_value = update.apply_to(*old_v, FastValueBuilderFactory::get());
-    if (new_value) {
-        setTensor(docId, *new_value);
+    if (!new_value) {
+        return;
+    }
+    if (old_tensor && (_index || _is_dense)) {
+        checkTensorType(*new_value);
+        VectorBundle vectors(new_value->cells().data, new_value->index().size(), _subspace_type);
+        if (tensor_cells_are_unchanged(docId, vectors)) {
+            // Partial updates often leave the cells unchanged (e.g. modifying non-existing cells).
+            // The nearest neighbor index is then left as is, and for dense tensors there is nothing to store.
+            if (!_is_dense) {
+                EntryRef ref = _tensorStore.store_tensor(*new_value);
+                assert(ref.valid());
+                setTensorRef(docId, ref);
+            }
+            return;
+        }
     }
+    setTensor(docId, *new_value);
 }
 
 std::unique_ptr<PrepareResult>
@@ -433,6 +471,19 @@ TensorAttribute::complete_set_tensor(DocId docid, const vespalib::eval::Value& t
     }
 }
 
+NearestNeighborIndex::GraphMaintenanceStats
+TensorAttribute::maintain_nearest_neighbor_index(uint32_t nodes_to_check, uint32_t nodes_to_probe, uint32_t max_repairs)
+{
+    if (!_index) {
+        return {};
+    }
+    auto stats = _index->maintain_graph(nodes_to_check, nodes_to_probe, max_repairs);
+    if (stats.repaired_nodes > 0) {
+        commit();
+    }
+    return stats;
+}
+
 attribute::DistanceMetric
 TensorAttribute::distance_metric() const {
     return getConfig().distance_metric();
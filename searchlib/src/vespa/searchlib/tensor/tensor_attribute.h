@@ -3,6 +3,7 @@
 #pragma once
 
 #include "i_tensor_attribute.h"
+#include "nearest_neighbor_index.h"
 #include "prepare_result.h"
 #include "subspace_type.h"
 #include "tensor_store.h"
@@ -33,6 +34,8 @@ protected:
     bool _is_dense;
     std::unique_ptr<vespalib::eval::Value> _emptyTensor;
     uint64_t    _compactGeneration; // Generation when last compact occurred
+    std::unique_ptr<vespalib::datastore::ICompactionContext> _compaction_context; // ongoing compaction, if any
+    size_t      _compaction_position; // next doc id to be visited by ongoing compaction
     SubspaceType         _subspace_type;
     TypedCellsComparator _comp;
 
@@ -40,6 +43,7 @@ protected:
     void setTensorRef(DocId docId, EntryRef ref);
     void internal_set_tensor(DocId docid, const vespalib::eval::Value& tensor);
     void consider_remove_from_index(DocId docid);
+    void compact_step();
     virtual vespalib::MemoryUsage update_stat();
     void populate_state(vespalib::slime::Cursor& object) const;
     void populate_address_space_usage(AddressSpaceUsage& usage) const override;
@@ -96,6 +100,16 @@ public:
      * It uses the result from the prepare step to do the modifying changes.
      */
     virtual void complete_set_tensor(DocId docid, const vespalib::eval::Value& tensor, std::unique_ptr<PrepareResult> prepare_result);
+
+    /**
+     * Checks the health of the nearest neighbor index and repairs degraded parts of it,
+     * see NearestNeighborIndex::maintain_graph(). Commits if anything was repaired.
+     *
+     * This function is only called by the attribute writer thread.
+     */
+    NearestNeighborIndex::GraphMaintenanceStats maintain_nearest_neighbor_index(uint32_t nodes_to_check,
+                                                                                uint32_t nodes_to_probe,
+                                                                                uint32_t max_repairs);
 };
 
 }
@@ -12,11 +12,11 @@
 #include <vespa/searchlib/attribute/blob_sequence_reader.h>
 #include <vespa/searchlib/attribute/load_utils.h>
 #include <vespa/searchlib/attribute/readerbase.h>
-#include <vespa/vespalib/util/arrayqueue.hpp>
+#include <vespa/vespalib/util/count_down_latch.h>
 #include <vespa/vespalib/util/cpu_usage.h>
 #include <vespa/vespalib/util/lambdatask.h>
-#include <mutex>
-#include <condition_variable>
+#include <vespa/vespalib/util/time.h>
+#include <array>
 
 #include <vespa/log/log.h>
 LOG_SETUP(".searchlib.tensor.tensor_attribute_loader");
@@ -74,102 +74,103 @@ public:
 };
 
 /**
- * Will build nearest neighbor index in parallel. Note that indexing order is not guaranteed,
- * but that is inline with the guarantees vespa already has.
+ * Will build nearest neighbor index in bulk. Inserts are prepared in parallel for a batch
+ * of documents using the shared executor, then completed in lid order in the calling thread.
+ * The next batch is prepared while the previous one is completed, so the serial completion
+ * is overlapped with the parallel preparation.
  */
-class ThreadedIndexBuilder : public IndexBuilder {
+class BatchedIndexBuilder : public IndexBuilder {
 public:
-    ThreadedIndexBuilder(TensorAttribute& attr, vespalib::GenerationHandler& generation_handler, TensorStore& store, NearestNeighborIndex& index, vespalib::Executor& shared_executor)
+    BatchedIndexBuilder(TensorAttribute& attr, vespalib::GenerationHandler& generation_handler, NearestNeighborIndex& index, vespalib::Executor& shared_executor)
         : _attr(attr),
           _generation_handler(generation_handler),
           _index(index),
           _shared_executor(shared_executor),
-          _queue(MAX_PENDING),
-          _pending(0)
+          _batches(),
+          _filling(0),
+          _num_docs(0),
+          _num_batches(0),
+          _timer(),
+          _complete_time(vespalib::duration::zero())
     {
-        (void) store;
+        for (auto& batch : _batches) {
+            batch.lids.reserve(BATCH_SIZE);
+            batch.prepared.reserve(BATCH_SIZE);
+        }
+    }
+    void add(uint32_t lid) override {
+        auto& batch = _batches[_filling];
+        batch.lids.push_back(lid);
+        if (batch.lids.size() >= BATCH_SIZE) {
+            flush_batch();
+        }
     }
-    void add(uint32_t lid) override;
     void wait_complete() override {
-        drainUntilPending(0);
+        flush_batch();
+        complete_batch(_batches[1 - _filling]);
+        LOG(info, "Bulk build of nearest neighbor index for tensor attribute '%s' finished: %u documents in %u batches, "
+            "%.3f seconds (%.3f seconds completing inserts)",
+            _attr.getName().c_str(), _num_docs, _num_batches, vespalib::to_s(_timer.elapsed()), vespalib::to_s(_complete_time));
     }
 private:
-    using Entry = std::pair<uint32_t, std::unique_ptr<PrepareResult>>;
-    using Queue = vespalib::ArrayQueue<Entry>;
-
-    bool pop(Entry & entry) {
-        std::unique_lock guard(_mutex);
-        if (_queue.empty()) return false;
-        entry = std::move(_queue.front());
-        _queue.pop();
-        return true;
+    struct Batch {
+        std::vector<uint32_t>                       lids;
+        std::vector<std::unique_ptr<PrepareResult>> prepared;
+        std::unique_ptr<vespalib::CountDownLatch>   latch; // set while prepared in the shared executor
+    };
+    void start_prepare_batch(Batch& batch) {
+        batch.prepared.resize(batch.lids.size());
+        batch.latch = std::make_unique<vespalib::CountDownLatch>(batch.lids.size());
+        for (size_t i = 0; i < batch.lids.size(); ++i) {
+            auto task = vespalib::makeLambdaTask([this, &batch, i]() {
+                uint32_t lid = batch.lids[i];
+                batch.prepared[i] = _index.prepare_add_document(lid, _attr.get_vectors(lid), _generation_handler.takeGuard());
+                batch.latch->countDown();
+            });
+            _shared_executor.execute(CpuUsage::wrap(std::move(task), CpuUsage::Category::SETUP));
+        }
     }
-    void drainQ() {
-        Queue queue(MAX_PENDING);
-        {
-            std::unique_lock guard(_mutex);
-            queue.swap(_queue);
+    void complete_batch(Batch& batch) {
+        if (!batch.latch) {
+            return;
         }
-        while (!queue.empty()) {
-            auto item = std::move(queue.front());
-            queue.pop();
-            complete(item.first, std::move(item.second));
+        batch.latch->await();
+        batch.latch.reset();
+        vespalib::Timer timer;
+        for (size_t i = 0; i < batch.lids.size(); ++i) {
+            _index.complete_add_document(batch.lids[i], std::move(batch.prepared[i]));
         }
+        _attr.commit();
+        _complete_time += timer.elapsed();
+        _num_docs += batch.lids.size();
+        ++_num_batches;
+        batch.lids.clear();
+        batch.prepared.clear();
     }
-
-    void complete(uint32_t lid, std::unique_ptr<PrepareResult> prepared) {
-        _index.complete_add_document(lid, std::move(prepared));
-        --_pending;
-        if ((lid % LOAD_COMMIT_INTERVAL) == 0) {
-            _attr.commit();
-        };
-    }
-    void drainUntilPending(uint32_t maxPending) {
-        while (_pending > maxPending) {
-            {
-                std::unique_lock guard(_mutex);
-                while (_queue.empty()) {
-                    _cond.wait(guard);
-                }
-            }
-            drainQ();
+    void flush_batch() {
+        auto& batch = _batches[_filling];
+        if (batch.lids.empty()) {
+            return;
         }
+        start_prepare_batch(batch);
+        // Documents in the batch being prepared are not visible when the previous batch is completed,
+        // the same as for documents within a batch. complete_add_document() handles stale links.
+        _filling = 1 - _filling;
+        complete_batch(_batches[_filling]);
     }
-    static constexpr uint32_t MAX_PENDING = 1000;
-    TensorAttribute&        _attr;
-    const vespalib::GenerationHandler& _generation_handler;
-    NearestNeighborIndex&   _index;
-    vespalib::Executor&     _shared_executor;
-    std::mutex              _mutex;
-    std::condition_variable _cond;
-    Queue                   _queue;
-    uint64_t                _pending; // _pending is only modified in forground thread
+    static constexpr uint32_t BATCH_SIZE = 1000;
+    TensorAttribute&                           _attr;
+    const vespalib::GenerationHandler&         _generation_handler;
+    NearestNeighborIndex&                      _index;
+    vespalib::Executor&                        _shared_executor;
+    std::array<Batch, 2>                       _batches;
+    uint32_t                                   _filling; // index of batch being filled with lids
+    uint32_t                                   _num_docs;
+    uint32_t                                   _num_batches;
+    vespalib::Timer                            _timer;
+    vespalib::duration                         _complete_time;
 };
 
-void
-ThreadedIndexBuilder::add(uint32_t lid) {
-    Entry item;
-    while (pop(item)) {
-        // First process items that are ready to complete
-        complete(item.first, std::move(item.second));
-    }
-    // Then ensure that there no more than MAX_PENDING inflight
-    drainUntilPending(MAX_PENDING);
-
-    // Then we can issue a new one
-    ++_pending;
-    auto task = vespalib::makeLambdaTask([this, lid]() {
-        auto prepared = _index.prepare_add_document(lid, _attr.get_vectors(lid),
-                                                    _generation_handler.takeGuard());
-        std::unique_lock guard(_mutex);
-        _queue.push(std::make_pair(lid, std::move(prepared)));
-        if (_queue.size() == 1) {
-            _cond.notify_all();
-        }
-    });
-    _shared_executor.execute(CpuUsage::wrap(std::move(task), CpuUsage::Category::SETUP));
-}
-
 class ForegroundIndexBuilder : public IndexBuilder {
 public:
     ForegroundIndexBuilder(AttributeVector& attr, NearestNeighborIndex& index)
@@ -254,7 +255,7 @@ TensorAttributeLoader::build_index(vespalib::Executor* executor, uint32_t docid_
 {
     std::unique_ptr<IndexBuilder> builder;
     if (executor != nullptr) {
-        builder = std::make_unique<ThreadedIndexBuilder>(_attr, _generation_handler, _store, *_index, *executor);
+        builder = std::make_unique<BatchedIndexBuilder>(_attr, _generation_handler, *_index, *executor);
     } else {
         builder = std::make_unique<ForegroundIndexBuilder>(_attr, *_index);
     }
@@ -268,6 +269,19 @@ TensorAttributeLoader::build_index(vespalib::Executor* executor, uint32_t docid_
     _attr.commit();
 }
 
+void
+TensorAttributeLoader::load_quantized_vectors()
+{
+    if (!LoadUtils::file_exists(_attr, TensorAttributeSaver::quantized_vectors_file_suffix())) {
+        return;
+    }
+    auto buf = LoadUtils::loadFile(_attr, TensorAttributeSaver::quantized_vectors_file_suffix());
+    if (!_index->load_quantized_vectors(*buf)) {
+        LOG(info, "Quantized vectors for nearest neighbor index of tensor attribute '%s' do not match config, recalculating them",
+            _attr.getName().c_str());
+    }
+}
+
 bool
 TensorAttributeLoader::load_index()
 {
@@ -318,6 +332,8 @@ TensorAttributeLoader::on_load(vespalib::Executor* executor)
             use_index_file = can_use_index_save_file(_attr.getConfig(), header);
         }
         if (use_index_file) {
+            // Restoring the quantized vectors avoids reading all (possibly paged out) full vectors
+            load_quantized_vectors();
             if (!load_index()) {
                 return false;
             }
@@ -33,6 +33,7 @@ class TensorAttributeLoader {
     void load_dense_tensor_store(search::attribute::BlobSequenceReader& reader, uint32_t docid_limit, DenseTensorStore& dense_store);
     void load_tensor_store(search::attribute::BlobSequenceReader& reader, uint32_t docid_limit);
     void build_index(vespalib::Executor* executor, uint32_t docid_limit);
+    void load_quantized_vectors();
     bool load_index();
 
 public:
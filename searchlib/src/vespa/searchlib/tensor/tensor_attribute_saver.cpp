@@ -16,11 +16,13 @@ TensorAttributeSaver::TensorAttributeSaver(GenerationHandler::Guard &&guard,
                                            const attribute::AttributeHeader &header,
                                            attribute::EntryRefVector&& refs,
                                            const TensorStore &tensor_store,
-                                           IndexSaverUP index_saver)
+                                           IndexSaverUP index_saver,
+                                           IndexSaverUP quantized_vectors_saver)
     : AttributeSaver(std::move(guard), header),
       _refs(std::move(refs)),
       _tensor_store(tensor_store),
-      _index_saver(std::move(index_saver))
+      _index_saver(std::move(index_saver)),
+      _quantized_vectors_saver(std::move(quantized_vectors_saver))
 {
 }
 
@@ -32,6 +34,12 @@ TensorAttributeSaver::index_file_suffix()
     return "nnidx";
 }
 
+vespalib::string
+TensorAttributeSaver::quantized_vectors_file_suffix()
+{
+    return "nnqv";
+}
+
 bool
 TensorAttributeSaver::onSave(IAttributeSaveTarget &saveTarget)
 {
@@ -40,6 +48,11 @@ TensorAttributeSaver::onSave(IAttributeSaveTarget &saveTarget)
             return false;
         }
     }
+    if (_quantized_vectors_saver) {
+        if (!saveTarget.setup_writer(quantized_vectors_file_suffix(), "Binary data file for quantized vectors of nearest neighbor index")) {
+            return false;
+        }
+    }
 
     auto dat_writer = saveTarget.datWriter().allocBufferWriter();
     auto dense_tensor_store = _tensor_store.as_dense();
@@ -53,6 +66,10 @@ TensorAttributeSaver::onSave(IAttributeSaveTarget &saveTarget)
         // Note: Implementation of save() is responsible to call BufferWriter::flush().
         _index_saver->save(*index_writer);
     }
+    if (_quantized_vectors_saver) {
+        auto quantized_vectors_writer = saveTarget.get_writer(quantized_vectors_file_suffix()).allocBufferWriter();
+        _quantized_vectors_saver->save(*quantized_vectors_writer);
+    }
     return true;
 }
 
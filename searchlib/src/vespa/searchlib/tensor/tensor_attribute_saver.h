@@ -15,7 +15,7 @@ class NearestNeighborIndexSaver;
 
 /**
  * Class for saving a tensor attribute.
- * Will also save the nearest neighbor index if existing.
+ * Will also save the nearest neighbor index if existing, and its quantized vectors.
  */
 class TensorAttributeSaver : public AttributeSaver {
     using GenerationHandler = vespalib::GenerationHandler;
@@ -24,6 +24,7 @@ class TensorAttributeSaver : public AttributeSaver {
     attribute::EntryRefVector _refs;
     const TensorStore& _tensor_store;
     IndexSaverUP _index_saver;
+    IndexSaverUP _quantized_vectors_saver;
 
     bool onSave(IAttributeSaveTarget &saveTarget) override;
     void save_dense_tensor_store(BufferWriter& writer, const DenseTensorStore& dense_tensor_store) const;
@@ -34,11 +35,13 @@ public:
                          const attribute::AttributeHeader &header,
                          attribute::EntryRefVector&& refs,
                          const TensorStore &tensor_store,
-                         IndexSaverUP index_saver);
+                         IndexSaverUP index_saver,
+                         IndexSaverUP quantized_vectors_saver);
 
     ~TensorAttributeSaver() override;
 
     static vespalib::string index_file_suffix();
+    static vespalib::string quantized_vectors_file_suffix();
 };
 
 }
@@ -1,7 +1,9 @@
 // Copyright Vespa.ai. Licensed under the terms of the Apache 2.0 license. See LICENSE in the project root.
 
 #include "tensor_buffer_operations.h"
+#include "dedup_subspace_store.h"
 #include "fast_value_view.h"
+#include <vespa/eval/eval/fast_value.h>
 #include <vespa/eval/eval/value_codec.h>
 #include <vespa/eval/eval/value_type.h>
 #include <vespa/eval/streamed/streamed_value_view.h>
@@ -14,7 +16,9 @@ using vespalib::ConstArrayRef;
 using vespalib::MemoryUsage;
 using vespalib::SharedStringRepo;
 using vespalib::StringIdVector;
+using vespalib::datastore::EntryRef;
 using vespalib::eval::FastAddrMap;
+using vespalib::eval::FastValueBuilderFactory;
 using vespalib::eval::FastValueIndex;
 using vespalib::eval::StreamedValueView;
 using vespalib::eval::TypedCells;
@@ -37,12 +41,19 @@ adjust_min_alignment(size_t min_alignment)
 }
 
 TensorBufferOperations::TensorBufferOperations(const vespalib::eval::ValueType& tensor_type)
+    : TensorBufferOperations(tensor_type, nullptr)
+{
+}
+
+TensorBufferOperations::TensorBufferOperations(const vespalib::eval::ValueType& tensor_type, DedupSubspaceStore* dedup_subspaces)
     : _subspace_type(tensor_type),
       _num_mapped_dimensions(tensor_type.count_mapped_dimensions()),
       _min_alignment(adjust_min_alignment(vespalib::eval::CellTypeUtils::alignment(_subspace_type.cell_type()))),
       _addr(_num_mapped_dimensions),
       _addr_refs(),
-      _empty(_subspace_type)
+      _empty(_subspace_type),
+      _dedup_subspaces(dedup_subspaces),
+      _stored_subspace_mem_size(dedup_subspaces != nullptr ? sizeof(uint32_t) : _subspace_type.mem_size())
 {
     _addr_refs.reserve(_addr.size());
     for (auto& label : _addr) {
@@ -74,7 +85,7 @@ TensorBufferOperations::store_tensor(ArrayRef<char> buf, const vespalib::eval::V
     assert(num_subspaces <= num_subspaces_mask);
     auto labels_end_offset = get_labels_offset() + get_labels_mem_size(num_subspaces);
     auto cells_size = num_subspaces * _subspace_type.size();
-    auto cells_mem_size = num_subspaces * _subspace_type.mem_size(); // Size measured in bytes
+    auto cells_mem_size = get_cells_mem_size(num_subspaces); // Size measured in bytes
     auto aligner = select_aligner(cells_mem_size);
     auto cells_start_offset = aligner.align(labels_end_offset);
     auto cells_end_offset = cells_start_offset + cells_mem_size;
@@ -103,7 +114,14 @@ TensorBufferOperations::store_tensor(ArrayRef<char> buf, const vespalib::eval::V
     }
     auto cells = tensor.cells();
     assert(cells_size == cells.size);
-    if (cells_mem_size > 0) {
+    if (_dedup_subspaces != nullptr) {
+        auto subspace_refs = reinterpret_cast<uint32_t*>(buf.data() + cells_start_offset);
+        auto subspace_mem_size = _subspace_type.mem_size();
+        for (uint32_t i = 0; i < num_subspaces; ++i) {
+            TypedCells subspace_cells(static_cast<const char*>(cells.data) + i * subspace_mem_size, cells.type, _subspace_type.size());
+            subspace_refs[i] = _dedup_subspaces->add(subspace_cells).ref();
+        }
+    } else if (cells_mem_size > 0) {
         memcpy(buf.data() + cells_start_offset, cells.data, cells_mem_size);
     }
     if (cells_end_offset != buf.size()) {
@@ -111,18 +129,40 @@ TensorBufferOperations::store_tensor(ArrayRef<char> buf, const vespalib::eval::V
     }
 }
 
+TypedCells
+TensorBufferOperations::get_cells(ConstArrayRef<char> buf, uint32_t num_subspaces, std::vector<char>& materialized) const
+{
+    auto cells_size = num_subspaces * _subspace_type.size();
+    auto cells_mem_size = get_cells_mem_size(num_subspaces); // Size measured in bytes
+    auto aligner = select_aligner(cells_mem_size);
+    auto cells_start_offset = get_cells_offset(num_subspaces, aligner);
+    assert(cells_start_offset + cells_mem_size <= buf.size());
+    if (_dedup_subspaces == nullptr) {
+        return TypedCells(buf.data() + cells_start_offset, _subspace_type.cell_type(), cells_size);
+    }
+    auto subspace_mem_size = _subspace_type.mem_size();
+    materialized.resize(num_subspaces * subspace_mem_size);
+    auto subspace_refs = reinterpret_cast<const uint32_t*>(buf.data() + cells_start_offset);
+    for (uint32_t i = 0; i < num_subspaces; ++i) {
+        auto subspace_cells = _dedup_subspaces->get(EntryRef(subspace_refs[i]));
+        memcpy(materialized.data() + i * subspace_mem_size, subspace_cells.data, subspace_mem_size);
+    }
+    return TypedCells(materialized.data(), _subspace_type.cell_type(), cells_size);
+}
+
 std::unique_ptr<vespalib::eval::Value>
 TensorBufferOperations::make_fast_view(ConstArrayRef<char> buf, const vespalib::eval::ValueType& tensor_type) const
 {
     auto num_subspaces = get_num_subspaces(buf);
     assert(buf.size() >= get_buffer_size(num_subspaces));
     ConstArrayRef<string_id> labels(reinterpret_cast<const string_id*>(buf.data() + get_labels_offset()), num_subspaces * _num_mapped_dimensions);
-    auto cells_size = num_subspaces * _subspace_type.size();
-    auto cells_mem_size = num_subspaces * _subspace_type.mem_size(); // Size measured in bytes
-    auto aligner = select_aligner(cells_mem_size);
-    auto cells_start_offset = get_cells_offset(num_subspaces, aligner);
-    TypedCells cells(buf.data() + cells_start_offset, _subspace_type.cell_type(), cells_size);
-    assert(cells_start_offset + cells_mem_size <= buf.size());
+    std::vector<char> materialized;
+    auto cells = get_cells(buf, num_subspaces, materialized);
+    if (_dedup_subspaces != nullptr) {
+        // Cells are not contiguous in the store, make a copy owning the materialized cells
+        FastValueView view(tensor_type, labels, cells, _num_mapped_dimensions, num_subspaces);
+        return FastValueBuilderFactory::get().copy(view);
+    }
     return std::make_unique<FastValueView>(tensor_type, labels, cells, _num_mapped_dimensions, num_subspaces);
 }
 
@@ -148,6 +188,13 @@ TensorBufferOperations::reclaim_labels(ArrayRef<char> buf) const
     for (auto& label : labels) {
         SharedStringRepo::unsafe_reclaim(label);
     }
+    if (_dedup_subspaces != nullptr) {
+        auto aligner = select_aligner(get_cells_mem_size(num_subspaces));
+        auto subspace_refs = reinterpret_cast<const uint32_t*>(buf.data() + get_cells_offset(num_subspaces, aligner));
+        for (uint32_t i = 0; i < num_subspaces; ++i) {
+            _dedup_subspaces->remove(EntryRef(subspace_refs[i]));
+        }
+    }
 }
 
 void
@@ -156,12 +203,8 @@ TensorBufferOperations::encode_stored_tensor(ConstArrayRef<char> buf, const vesp
     auto num_subspaces = get_num_subspaces(buf);
     assert(buf.size() >= get_buffer_size(num_subspaces));
     ConstArrayRef<string_id> labels(reinterpret_cast<const string_id*>(buf.data() + get_labels_offset()), num_subspaces * _num_mapped_dimensions);
-    auto cells_size = num_subspaces * _subspace_type.size();
-    auto cells_mem_size = num_subspaces * _subspace_type.mem_size(); // Size measured in bytes
-    auto aligner = select_aligner(cells_mem_size);
-    auto cells_start_offset = get_cells_offset(num_subspaces, aligner);
-    TypedCells cells(buf.data() + cells_start_offset, _subspace_type.cell_type(), cells_size);
-    assert(cells_start_offset + cells_mem_size <= buf.size());
+    std::vector<char> materialized;
+    auto cells = get_cells(buf, num_subspaces, materialized);
     StringIdVector labels_copy(labels.begin(), labels.end());
     StreamedValueView streamed_value_view(tensor_type, _num_mapped_dimensions, cells, num_subspaces, labels_copy);
     vespalib::eval::encode_value(streamed_value_view, target);
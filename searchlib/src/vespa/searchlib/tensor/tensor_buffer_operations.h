@@ -21,6 +21,8 @@ class ValueType;
 
 namespace search::tensor {
 
+class DedupSubspaceStore;
+
 /*
  * Class used to store a tensor in a buffer and make tensor views based on
  * buffer content.
@@ -33,7 +35,9 @@ namespace search::tensor {
  *      as part of compaction or fallback copy (due to datastore buffer fallback resize)).
  * labels[num_subspaces * _num_mapped_dimensions]    - array of labels for sparse dimensions
  * padding                                           - to align start of cells
- * cells[num_subspaces * _dense_subspaces_size]      - array of tensor cell values
+ * cells[num_subspaces * _dense_subspaces_size]      - array of tensor cell values, or
+ * subspace_refs[num_subspaces]                      - array of refs into DedupSubspaceStore
+ *                                                     when subspaces are deduplicated
  * padding                                           - to align start of next buffer
  *
  * Alignment is dynamic, based on cell type, memory used by tensor cell values and
@@ -47,6 +51,8 @@ class TensorBufferOperations
     std::vector<vespalib::string_id>  _addr;
     std::vector<vespalib::string_id*> _addr_refs;
     EmptySubspace                     _empty;
+    DedupSubspaceStore*               _dedup_subspaces;
+    size_t                            _stored_subspace_mem_size;
 
     using Aligner = vespalib::datastore::Aligner<vespalib::datastore::dynamic_alignment>;
 
@@ -58,7 +64,7 @@ class TensorBufferOperations
     static constexpr size_t get_num_subspaces_size() noexcept { return sizeof(uint32_t); }
     static constexpr size_t get_labels_offset() noexcept { return get_num_subspaces_size(); }
     size_t get_cells_mem_size(uint32_t num_subspaces) const noexcept {
-        return _subspace_type.mem_size() * num_subspaces;
+        return _stored_subspace_mem_size * num_subspaces;
     }
     auto select_aligner(size_t cells_mem_size) const noexcept {
         return Aligner((cells_mem_size < CELLS_ALIGNMENT_MEM_SIZE_MIN) ? _min_alignment : CELLS_ALIGNMENT);
@@ -80,6 +86,13 @@ class TensorBufferOperations
     uint32_t get_num_subspaces(vespalib::ConstArrayRef<char> buf) const noexcept {
         return get_num_subspaces(get_num_subspaces_and_flag(buf));
     }
+    // Cells for all subspaces, copied to materialized if subspaces are deduplicated.
+    vespalib::eval::TypedCells get_cells(vespalib::ConstArrayRef<char> buf, uint32_t num_subspaces, std::vector<char>& materialized) const;
+    VectorBundle make_vector_bundle(const char* cells_start, uint32_t num_subspaces) const noexcept {
+        return _dedup_subspaces != nullptr ?
+            VectorBundle(cells_start, num_subspaces, _subspace_type, *_dedup_subspaces) :
+            VectorBundle(cells_start, num_subspaces, _subspace_type);
+    }
 public:
     // Size (in bytes) used to serialize tensor with num_subspaces.
     size_t get_buffer_size(uint32_t num_subspaces) const noexcept {
@@ -88,6 +101,7 @@ public:
         return get_cells_offset(num_subspaces, aligner) + aligner.align(cells_mem_size);
     }
     TensorBufferOperations(const vespalib::eval::ValueType& tensor_type);
+    TensorBufferOperations(const vespalib::eval::ValueType& tensor_type, DedupSubspaceStore* dedup_subspaces);
     ~TensorBufferOperations();
     TensorBufferOperations(const TensorBufferOperations&) = delete;
     TensorBufferOperations(TensorBufferOperations&&) = delete;
@@ -98,7 +112,7 @@ public:
 
     // Mark that reclaim_labels should be skipped for old buffer after copying tensor buffer
     void copied_labels(vespalib::ArrayRef<char> buf) const;
-    // Decrease reference counts for labels and set skip flag unless skip flag is set.
+    // Decrease reference counts for labels (and deduplicated subspaces) and set skip flag unless skip flag is set.
     void reclaim_labels(vespalib::ArrayRef<char> buf) const;
     // Serialize stored tensor to target (used when saving attribute)
     void encode_stored_tensor(vespalib::ConstArrayRef<char> buf, const vespalib::eval::ValueType& type, vespalib::nbostream& target) const;
@@ -109,14 +123,14 @@ public:
         auto num_subspaces = get_num_subspaces(buf);
         auto cells_mem_size = get_cells_mem_size(num_subspaces);
         auto aligner = select_aligner(cells_mem_size);
-        return VectorBundle(buf.data() + get_cells_offset(num_subspaces, aligner), num_subspaces, _subspace_type);
+        return make_vector_bundle(buf.data() + get_cells_offset(num_subspaces, aligner), num_subspaces);
     }
     SerializedTensorRef get_serialized_tensor_ref(vespalib::ConstArrayRef<char> buf) const {
         auto num_subspaces = get_num_subspaces(buf);
         auto cells_mem_size = get_cells_mem_size(num_subspaces);
         auto aligner = select_aligner(cells_mem_size);
         vespalib::ConstArrayRef<vespalib::string_id> labels(reinterpret_cast<const vespalib::string_id*>(buf.data() + get_labels_offset()), num_subspaces * _num_mapped_dimensions);
-        return SerializedTensorRef(VectorBundle(buf.data() + get_cells_offset(num_subspaces, aligner), num_subspaces, _subspace_type), _num_mapped_dimensions, labels);
+        return SerializedTensorRef(make_vector_bundle(buf.data() + get_cells_offset(num_subspaces, aligner), num_subspaces), _num_mapped_dimensions, labels);
     }
     bool is_dense() const noexcept { return _num_mapped_dimensions == 0; }
 };
@@ -27,12 +27,27 @@ namespace {
 
 constexpr float ALLOC_GROW_FACTOR = 0.2;
 
+std::unique_ptr<DedupSubspaceStore>
+make_dedup_subspaces(const ValueType& tensor_type, const std::shared_ptr<MemoryAllocator>& allocator, bool dedup_subspaces)
+{
+    if (!dedup_subspaces || tensor_type.count_indexed_dimensions() == 0) {
+        return {};
+    }
+    return std::make_unique<DedupSubspaceStore>(tensor_type.strip_mapped_dimensions(), allocator);
+}
+
 }
 
 TensorBufferStore::TensorBufferStore(const ValueType& tensor_type, std::shared_ptr<MemoryAllocator> allocator, uint32_t max_small_subspaces_type_id)
+    : TensorBufferStore(tensor_type, std::move(allocator), max_small_subspaces_type_id, false)
+{
+}
+
+TensorBufferStore::TensorBufferStore(const ValueType& tensor_type, std::shared_ptr<MemoryAllocator> allocator, uint32_t max_small_subspaces_type_id, bool dedup_subspaces)
     : TensorStore(ArrayStoreType::get_data_store_base(_array_store)),
       _tensor_type(tensor_type),
-      _ops(_tensor_type),
+      _dedup_subspaces(make_dedup_subspaces(_tensor_type, allocator, dedup_subspaces)),
+      _ops(_tensor_type, _dedup_subspaces.get()),
       _array_store(ArrayStoreType::optimizedConfigForHugePage(max_small_subspaces_type_id,
                                                               TensorBufferTypeMapper(max_small_subspaces_type_id, array_store_grow_factor, ArrayStoreConfig::default_max_buffer_size, &_ops),
                                                               MemoryAllocator::HUGEPAGE_SIZE,
@@ -43,7 +58,53 @@ TensorBufferStore::TensorBufferStore(const ValueType& tensor_type, std::shared_p
 {
 }
 
-TensorBufferStore::~TensorBufferStore() = default;
+TensorBufferStore::~TensorBufferStore()
+{
+    if (_dedup_subspaces) {
+        // Dropping tensor buffers releases their deduplicated subspaces
+        _store.reclaim_all_memory();
+        _store.dropBuffers();
+        _dedup_subspaces->reclaim_all_memory();
+    }
+}
+
+void
+TensorBufferStore::reclaim_memory(generation_t oldest_used_gen)
+{
+    // Reclaiming tensor buffers might put deduplicated subspaces on hold
+    _store.reclaim_memory(oldest_used_gen);
+    if (_dedup_subspaces) {
+        _dedup_subspaces->reclaim_memory(oldest_used_gen);
+    }
+}
+
+void
+TensorBufferStore::assign_generation(generation_t current_gen)
+{
+    _store.assign_generation(current_gen);
+    if (_dedup_subspaces) {
+        _dedup_subspaces->assign_generation(current_gen);
+    }
+}
+
+void
+TensorBufferStore::reclaim_all_memory()
+{
+    _store.reclaim_all_memory();
+    if (_dedup_subspaces) {
+        _dedup_subspaces->reclaim_all_memory();
+    }
+}
+
+vespalib::MemoryUsage
+TensorBufferStore::getMemoryUsage() const
+{
+    auto usage = _store.getMemoryUsage();
+    if (_dedup_subspaces) {
+        usage.merge(_dedup_subspaces->getMemoryUsage());
+    }
+    return usage;
+}
 
 void
 TensorBufferStore::holdTensor(EntryRef ref)
@@ -69,6 +130,9 @@ TensorBufferStore::update_stat(const CompactionStrategy& compaction_strategy)
     auto array_store_address_space_usage = _store.getAddressSpaceUsage();
     auto array_store_memory_usage = _store.getMemoryUsage();
     _compaction_spec = compaction_strategy.should_compact(array_store_memory_usage, array_store_address_space_usage);
+    if (_dedup_subspaces) {
+        array_store_memory_usage.merge(_dedup_subspaces->getMemoryUsage());
+    }
     return array_store_memory_usage;
 }
 
@@ -3,6 +3,7 @@
 #pragma once
 
 #include "tensor_store.h"
+#include "dedup_subspace_store.h"
 #include "tensor_buffer_operations.h"
 #include "tensor_buffer_type_mapper.h"
 #include "large_subspaces_buffer_type.h"
@@ -15,12 +16,16 @@ namespace search::tensor {
 /**
  * Class for storing tensor buffers in memory and making tensor views
  * based on stored tensor buffer.
+ *
+ * If subspaces are deduplicated, the dense subspaces of stored tensors are kept in
+ * a separate DedupSubspaceStore and tensor buffers reference them.
  */
 class TensorBufferStore : public TensorStore
 {
     using RefType = vespalib::datastore::EntryRefT<19>;
     using ArrayStoreType = vespalib::datastore::ArrayStore<char, RefType, TensorBufferTypeMapper>;
     vespalib::eval::ValueType _tensor_type;
+    std::unique_ptr<DedupSubspaceStore> _dedup_subspaces; // Must outlive _array_store
     TensorBufferOperations    _ops;
     ArrayStoreType            _array_store;
 public:
@@ -29,7 +34,12 @@ public:
     static constexpr uint32_t array_store_max_type_id = 300;
 
     TensorBufferStore(const vespalib::eval::ValueType& tensor_type, std::shared_ptr<vespalib::alloc::MemoryAllocator> allocator, uint32_t max_small_subspaces_type_id);
+    TensorBufferStore(const vespalib::eval::ValueType& tensor_type, std::shared_ptr<vespalib::alloc::MemoryAllocator> allocator, uint32_t max_small_subspaces_type_id, bool dedup_subspaces);
     ~TensorBufferStore();
+    void reclaim_memory(generation_t oldest_used_gen) override;
+    void assign_generation(generation_t current_gen) override;
+    void reclaim_all_memory() override;
+    vespalib::MemoryUsage getMemoryUsage() const override;
     void holdTensor(EntryRef ref) override;
     EntryRef move_on_compact(EntryRef ref) override;
     vespalib::MemoryUsage update_stat(const vespalib::datastore::CompactionStrategy& compaction_strategy) override;
@@ -56,6 +66,8 @@ public:
         return _ops.get_serialized_tensor_ref(buf);
     }
 
+    const DedupSubspaceStore* get_dedup_subspaces() const noexcept { return _dedup_subspaces.get(); }
+
     // Used by unit test
     static constexpr uint32_t get_offset_bits() noexcept { return RefType::offset_bits; }
 };
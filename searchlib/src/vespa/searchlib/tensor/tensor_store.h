@@ -52,20 +52,20 @@ public:
     virtual DenseTensorStore* as_dense();
 
     // Inherit doc from DataStoreBase
-    void reclaim_memory(generation_t oldest_used_gen) {
+    virtual void reclaim_memory(generation_t oldest_used_gen) {
         _store.reclaim_memory(oldest_used_gen);
     }
 
     // Inherit doc from DataStoreBase
-    void assign_generation(generation_t current_gen) {
+    virtual void assign_generation(generation_t current_gen) {
         _store.assign_generation(current_gen);
     }
 
-    void reclaim_all_memory() {
+    virtual void reclaim_all_memory() {
         _store.reclaim_all_memory();
     }
 
-    vespalib::MemoryUsage getMemoryUsage() const {
+    virtual vespalib::MemoryUsage getMemoryUsage() const {
         return _store.getMemoryUsage();
     }
 
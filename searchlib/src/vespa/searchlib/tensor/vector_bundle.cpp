@@ -0,0 +1,15 @@
+// Copyright Vespa.ai. Licensed under the terms of the Apache 2.0 license. See LICENSE in the project root.
+
+#include "vector_bundle.h"
+#include "dedup_subspace_store.h"
+
+namespace search::tensor {
+
+vespalib::eval::TypedCells
+VectorBundle::dedup_cells(uint32_t subspace) const noexcept
+{
+    auto subspace_ref = static_cast<const uint32_t*>(_data)[subspace];
+    return _dedup_subspaces->get(vespalib::datastore::EntryRef(subspace_ref));
+}
+
+}
@@ -8,24 +8,33 @@
 
 namespace search::tensor {
 
+class DedupSubspaceStore;
+
 /*
  * Class referencing the cells owned by a tensor in a form suitable to extract tensor cells for
  * a subspace.
+ *
+ * When subspaces are deduplicated, _data references an array of subspace refs into
+ * a DedupSubspaceStore instead of the cells.
  */
 class VectorBundle
 {
-    const void*              _data;
-    vespalib::eval::CellType _cell_type;
-    uint32_t                 _subspaces;
-    size_t                   _subspace_mem_size;
-    size_t                   _subspace_size;
+    const void*               _data;
+    vespalib::eval::CellType  _cell_type;
+    uint32_t                  _subspaces;
+    size_t                    _subspace_mem_size;
+    size_t                    _subspace_size;
+    const DedupSubspaceStore* _dedup_subspaces;
+
+    vespalib::eval::TypedCells dedup_cells(uint32_t subspace) const noexcept;
 public:
     VectorBundle() noexcept
         : _data(nullptr),
           _cell_type(vespalib::eval::CellType::DOUBLE),
           _subspaces(0),
           _subspace_mem_size(0),
-          _subspace_size(0)
+          _subspace_size(0),
+          _dedup_subspaces(nullptr)
     {
     }
     VectorBundle(const void *data, uint32_t subspaces, const SubspaceType& subspace_type) noexcept
@@ -33,13 +42,26 @@ public:
           _cell_type(subspace_type.cell_type()),
           _subspaces(subspaces),
           _subspace_mem_size(subspace_type.mem_size()),
-          _subspace_size(subspace_type.size())
+          _subspace_size(subspace_type.size()),
+          _dedup_subspaces(nullptr)
+    {
+    }
+    VectorBundle(const void *subspace_refs, uint32_t subspaces, const SubspaceType& subspace_type, const DedupSubspaceStore& dedup_subspaces) noexcept
+        : _data(subspace_refs),
+          _cell_type(subspace_type.cell_type()),
+          _subspaces(subspaces),
+          _subspace_mem_size(subspace_type.mem_size()),
+          _subspace_size(subspace_type.size()),
+          _dedup_subspaces(&dedup_subspaces)
     {
     }
     ~VectorBundle() = default;
     uint32_t subspaces() const noexcept { return _subspaces; }
     vespalib::eval::TypedCells cells(uint32_t subspace) const noexcept {
         assert(subspace < _subspaces);
+        if (_dedup_subspaces != nullptr) {
+            return dedup_cells(subspace);
+        }
         return vespalib::eval::TypedCells(static_cast<const char*>(_data) + _subspace_mem_size * subspace, _cell_type, _subspace_size);
     }
 };
@@ -58,12 +58,12 @@ struct Builder
         _ib.open(numWordIds, _mock_field_length_inspector, _tuneFileIndexing, _fileHeaderContext);
     }
 
-    void addDoc(uint32_t docId) {
+    void addDoc(search::index::FieldIndexBuilder &fb, uint32_t docId) {
         _features.clear(docId);
         _features.elements().emplace_back(0, 1, 1);
         _features.elements().back().setNumOccs(1);
         _features.word_positions().emplace_back(0);
-        _ib.add_document(_features);
+        fb.add_document(_features);
     }
 
     void close() {
@@ -89,25 +89,24 @@ TestDiskIndex::buildIndex(const std::string & dir, bool directio,
     Builder b(dir, _schema, docEmpty ? 1 : 32, wordEmpty ? 0 : 2, directio);
     if (!wordEmpty && !fieldEmpty && !docEmpty) {
         // f1
-        b._ib.startField(0);
-        b._ib.startWord("w1");
-        b.addDoc(1);
-        b.addDoc(3);
-        b._ib.endWord();
-        b._ib.endField();
+        auto fb = b._ib.startField(0);
+        fb->startWord("w1");
+        b.addDoc(*fb, 1);
+        b.addDoc(*fb, 3);
+        fb->endWord();
         // f2
-        b._ib.startField(1);
-        b._ib.startWord("w1");
-        b.addDoc(2);
-        b.addDoc(4);
-        b.addDoc(6);
-        b._ib.endWord();
-        b._ib.startWord("w2");
+        fb = b._ib.startField(1);
+        fb->startWord("w1");
+        b.addDoc(*fb, 2);
+        b.addDoc(*fb, 4);
+        b.addDoc(*fb, 6);
+        fb->endWord();
+        fb->startWord("w2");
         for (uint32_t docId = 1; docId < 18; ++docId) {
-            b.addDoc(docId);
+            b.addDoc(*fb, docId);
         }
-        b._ib.endWord();
-        b._ib.endField();
+        fb->endWord();
+        fb.reset();
     }
     b.close();
 }
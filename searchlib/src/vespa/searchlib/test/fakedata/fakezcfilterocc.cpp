@@ -35,6 +35,13 @@ constexpr uint32_t disable_chunking = 1000000000;
 constexpr uint32_t disable_skip = 1000000000;
 constexpr uint32_t force_skip = 1;
 
+Zc4PostingParams
+with_block_docids(Zc4PostingParams params)
+{
+    params._encode_block_docids = true;
+    return params;
+}
+
 }
 
 #define DEBUG_ZCFILTEROCC_PRINTF 0
@@ -169,6 +176,7 @@ FakeZcFilterOcc::setupT(const FakeWord &fw)
     params.set("minChunkDocs", _posting_params._min_chunk_docs); // Control chunking
     params.set("minSkipDocs", _posting_params._min_skip_docs);   // Control skip info
     params.set("interleaved_features", _posting_params._encode_interleaved_features);
+    params.set("block_docids", _posting_params._encode_block_docids);
     writer.set_posting_list_params(params);
     auto &writeContext = writer.get_write_context();
     search::ComprBuffer &cb = writeContext;
@@ -881,6 +889,65 @@ public:
 template <bool bigEndian>
 FakeZc5NoSkipPosOccCf<bigEndian>::~FakeZc5NoSkipPosOccCf() = default;
 
+template <bool bigEndian>
+class FakeZc4BlockPosOcc : public FakeZc4SkipPosOcc<bigEndian>
+{
+public:
+    FakeZc4BlockPosOcc(const FakeWord &fw)
+        : FakeZc4SkipPosOcc<bigEndian>(fw, with_block_docids(Zc4PostingParams(force_skip, disable_chunking, fw._docIdLimit, false, true, false)),
+                                       (bigEndian ? ".zc4blockposoccbe" : ".zc4blockposoccle"))
+    {
+    }
+    ~FakeZc4BlockPosOcc() override;
+};
+
+template <bool bigEndian>
+FakeZc4BlockPosOcc<bigEndian>::~FakeZc4BlockPosOcc() = default;
+
+template <bool bigEndian>
+class FakeZc4BlockPosOccCf : public FakeZc4SkipPosOcc<bigEndian>
+{
+public:
+    FakeZc4BlockPosOccCf(const FakeWord &fw)
+        : FakeZc4SkipPosOcc<bigEndian>(fw, with_block_docids(Zc4PostingParams(force_skip, disable_chunking, fw._docIdLimit, false, true, true)),
+                                       (bigEndian ? ".zc4blockposoccbe.cf" : ".zc4blockposoccle.cf"))
+    {
+    }
+    ~FakeZc4BlockPosOccCf() override;
+};
+
+template <bool bigEndian>
+FakeZc4BlockPosOccCf<bigEndian>::~FakeZc4BlockPosOccCf() = default;
+
+class FakeZc4BlockPosOccCfNoNormalUnpack : public FakeZc4SkipPosOcc<true>
+{
+public:
+    FakeZc4BlockPosOccCfNoNormalUnpack(const FakeWord &fw)
+        : FakeZc4SkipPosOcc<true>(fw, with_block_docids(Zc4PostingParams(force_skip, disable_chunking, fw._docIdLimit, false, true, true)),
+                                  ".zc4blockposoccbe.cf.nnu")
+    {
+        _unpack_normal_features = false;
+    }
+    ~FakeZc4BlockPosOccCfNoNormalUnpack() override;
+};
+
+FakeZc4BlockPosOccCfNoNormalUnpack::~FakeZc4BlockPosOccCfNoNormalUnpack() = default;
+
+template <bool bigEndian>
+class FakeZc5BlockPosOccCf : public FakeZc4SkipPosOcc<bigEndian>
+{
+public:
+    FakeZc5BlockPosOccCf(const FakeWord &fw)
+        : FakeZc4SkipPosOcc<bigEndian>(fw, with_block_docids(Zc4PostingParams(force_skip, disable_chunking, fw._docIdLimit, true, true, true)),
+                                       (bigEndian ? ".zc5blockposoccbe.cf" : ".zc5blockposoccle.cf"))
+    {
+    }
+    ~FakeZc5BlockPosOccCf() override;
+};
+
+template <bool bigEndian>
+FakeZc5BlockPosOccCf<bigEndian>::~FakeZc5BlockPosOccCf() = default;
+
 static FPFactoryInit
 initPosbe(std::make_pair("EGCompr64PosOccBE",
                          makeFPFactory<FPFactoryT<FakeEGCompr64PosOcc<true> > >));
@@ -968,4 +1035,29 @@ static FPFactoryInit
 initNoSkipPoslecf(std::make_pair("Zc5NoSkipPosOccLE.cf",
                                  makeFPFactory<FPFactoryT<FakeZc5NoSkipPosOccCf<false> > >));
 
+
+static FPFactoryInit
+initBlockPosbe(std::make_pair("Zc4BlockPosOccBE",
+                              makeFPFactory<FPFactoryT<FakeZc4BlockPosOcc<true> > >));
+
+
+static FPFactoryInit
+initBlockPosle(std::make_pair("Zc4BlockPosOccLE",
+                              makeFPFactory<FPFactoryT<FakeZc4BlockPosOcc<false> > >));
+
+
+static FPFactoryInit
+initBlockPosbecf(std::make_pair("Zc4BlockPosOccBE.cf",
+                                makeFPFactory<FPFactoryT<FakeZc4BlockPosOccCf<true> > >));
+
+
+static FPFactoryInit
+initBlockPosbecfnnu(std::make_pair("Zc4BlockPosOccBE.cf.nnu",
+                                   makeFPFactory<FPFactoryT<FakeZc4BlockPosOccCfNoNormalUnpack > >));
+
+
+static FPFactoryInit
+initBlockPos5lecf(std::make_pair("Zc5BlockPosOccLE.cf",
+                                 makeFPFactory<FPFactoryT<FakeZc5BlockPosOccCf<false> > >));
+
 }
@@ -39,6 +39,11 @@ createCommitChunk(const DomainConfig &cfg) {
     return std::make_unique<CommitChunk>(cfg.getChunkSizeLimit(), cfg.getChunkSizeLimit()/256);
 }
 
+bool
+is_ready(const std::future<SerializedChunk> & future) {
+    return future.wait_for(std::chrono::seconds(0)) == std::future_status::ready;
+}
+
 VESPA_THREAD_STACK_TAG(tls_domain_commit);
 }
 
@@ -48,6 +53,8 @@ Domain::Domain(const string &domainName, const string & baseDir, vespalib::Execu
       _currentChunk(createCommitChunk(cfg)),
       _lastSerial(0),
       _singleCommitter(std::make_unique<vespalib::ThreadStackExecutor>(1, CpuUsage::wrap(tls_domain_commit, CpuCategory::WRITE))),
+      _pendingCommitsMutex(),
+      _pendingCommits(),
       _executor(executor),
       _sessionId(1),
       _name(domainName),
@@ -55,6 +62,7 @@ Domain::Domain(const string &domainName, const string & baseDir, vespalib::Execu
       _partsMutex(),
       _currentChunkMutex(),
       _sessionMutex(),
+      _recycleMutex(),
       _sessions(),
       _maxSessionRunTime(),
       _baseDir(baseDir),
@@ -70,6 +78,9 @@ Domain::Domain(const string &domainName, const string & baseDir, vespalib::Execu
     if (retval != 0) {
         throw runtime_error(fmt("Failed creating domaindir %s r(%d), e(%d)", dir().c_str(), retval, errno));
     }
+    // Recycling may have been interrupted before the file was ready for reuse
+    std::error_code ec;
+    std::filesystem::remove(std::filesystem::path(recycledPartName() + ".tmp"), ec);
     SerialNumList partIdVector = scanDir();
     const SerialNum lastPart = partIdVector.empty() ? 0 : partIdVector.back();
     vespalib::MonitoredRefCount pending;
@@ -83,7 +94,8 @@ Domain::Domain(const string &domainName, const string & baseDir, vespalib::Execu
     }
     pending.waitForZeroRefCount();
     if (_parts.empty() || _parts.crbegin()->second->isClosed()) {
-        _parts[lastPart] = std::make_shared<DomainPart>(_name, dir(), lastPart, _fileHeaderContext, false);
+        _parts[lastPart] = std::make_shared<DomainPart>(_name, dir(), lastPart, _fileHeaderContext, false,
+                                                       _config.getPartSizeLimit());
         vespalib::File::sync(dir());
     }
     _lastSerial = end();
@@ -98,7 +110,8 @@ Domain::setConfig(const DomainConfig & cfg) {
 
 void
 Domain::addPart(SerialNum partId, bool isLastPart) {
-    auto dp = std::make_shared<DomainPart>(_name, dir(), partId, _fileHeaderContext, isLastPart);
+    auto dp = std::make_shared<DomainPart>(_name, dir(), partId, _fileHeaderContext, isLastPart,
+                                           isLastPart ? _config.getPartSizeLimit() : 0);
     if (dp->size() == 0) {
         // Only last domain part is allowed to be truncated down to
         // empty size.
@@ -306,7 +319,9 @@ Domain::optionallyRotateFile(SerialNum serialNum) {
     if (dp->byteSize() > _config.getPartSizeLimit()) {
         dp->sync();
         dp->close();
-        dp = std::make_shared<DomainPart>(_name, dir(), serialNum, _fileHeaderContext, false);
+        reuseRecycledPart(serialNum);
+        dp = std::make_shared<DomainPart>(_name, dir(), serialNum, _fileHeaderContext, false,
+                                          _config.getPartSizeLimit());
         {
             std::lock_guard guard(_partsMutex);
             _parts[serialNum] = dp;
@@ -317,6 +332,29 @@ Domain::optionallyRotateFile(SerialNum serialNum) {
     return dp;
 }
 
+bool
+Domain::recyclePart(const DomainPartSP &dp)
+{
+    // Only a part nobody is visiting can be emptied in place, and one spare file is enough
+    std::lock_guard guard(_recycleMutex);
+    if ((dp.use_count() > 1) || std::filesystem::exists(std::filesystem::path(recycledPartName()))) {
+        return false;
+    }
+    vespalib::string tmpName = recycledPartName() + ".tmp";
+    dp->recycle(tmpName, _config.getPartSizeLimit());
+    std::filesystem::rename(std::filesystem::path(tmpName), std::filesystem::path(recycledPartName()));
+    return true;
+}
+
+void
+Domain::reuseRecycledPart(SerialNum partId)
+{
+    // The new part takes over the empty file with its disk space already reserved, if there is one
+    std::error_code ec;
+    std::filesystem::rename(std::filesystem::path(recycledPartName()),
+                            std::filesystem::path(DomainPart::partFileName(dir(), _name, partId)), ec);
+}
+
 void
 Domain::append(const Packet & packet, Writer::DoneCallback onDone) {
     std::unique_lock guard(_currentChunkMutex);
@@ -376,12 +414,45 @@ Domain::commitChunk(std::unique_ptr<CommitChunk> chunk, const UniqueLock & chunk
                                       encoding=_config.getEncoding(), compressionLevel=_config.getCompressionlevel()]() mutable {
         promise.set_value(SerializedChunk(std::move(chunk), encoding, compressionLevel));
     }));
-    _singleCommitter->execute( makeLambdaTask([this, future = std::move(future)]() mutable {
-        doCommit(future.get());
-    }));
+    {
+        // Chunks are queued in serial number order as we are holding the chunk order guard
+        std::lock_guard guard(_pendingCommitsMutex);
+        _pendingCommits.push_back(std::move(future));
+    }
+    _singleCommitter->execute(makeLambdaTask([this]() { commitPending(); }));
 }
 
-
+void
+Domain::commitPending() {
+    PendingCommits pending;
+    {
+        std::lock_guard guard(_pendingCommitsMutex);
+        pending.swap(_pendingCommits);
+    }
+    if (pending.empty()) {
+        return; // already committed as part of an earlier batch
+    }
+    // Write the queued chunks that are serialized, then sync once for the whole batch.
+    // Acks are released when the serialized chunks are destructed, after the sync.
+    // Chunks still being serialized are left for the commit task scheduled with them.
+    std::vector<SerializedChunk> batch;
+    batch.reserve(pending.size());
+    size_t i = 0;
+    for (; (i < pending.size()) && (batch.empty() || is_ready(pending[i])); ++i) {
+        batch.push_back(pending[i].get());
+        doCommit(batch.back());
+    }
+    if (i < pending.size()) {
+        std::lock_guard guard(_pendingCommitsMutex);
+        _pendingCommits.insert(_pendingCommits.begin(), std::make_move_iterator(pending.begin() + i),
+                               std::make_move_iterator(pending.end()));
+    }
+    if (_config.getFSyncOnCommit()) {
+        getActivePart()->sync();
+    }
+    cleanSessions();
+    LOG(debug, "Committed batch of %zu chunks, releasing acks.", batch.size());
+}
 
 void
 Domain::doCommit(const SerializedChunk & serialized) {
@@ -389,11 +460,7 @@ Domain::doCommit(const SerializedChunk & serialized) {
     SerialNumRange range = serialized.range();
     DomainPart::SP dp = optionallyRotateFile(range.from());
     dp->commit(serialized);
-    if (_config.getFSyncOnCommit()) {
-        dp->sync();
-    }
-    cleanSessions();
-    LOG(debug, "Releasing %zu acks and %zu entries and %zu bytes.",
+    LOG(debug, "Wrote %zu acks and %zu entries and %zu bytes.",
         serialized.getNumCallBacks(), serialized.getNumEntries(), serialized.getData().size());
 }
 
@@ -407,7 +474,7 @@ Domain::erase(SerialNum to)
         DomainPart::SP dp(it->second);
         _parts.erase(it);
         guard.unlock();
-        retval = retval && dp->erase(to);
+        retval = retval && (recyclePart(dp) || dp->erase(to));
         vespalib::File::sync(dir());
         guard.lock();
     }
@@ -6,6 +6,7 @@
 #include <atomic>
 #include <mutex>
 #include <condition_variable>
+#include <future>
 
 namespace search::common { class FileHeaderContext; }
 namespace search::transactionlog {
@@ -63,6 +64,7 @@ private:
 
     std::unique_ptr<CommitChunk> grabCurrentChunk(const UniqueLock & guard);
     void commitChunk(std::unique_ptr<CommitChunk> chunk, const UniqueLock & chunkOrderGuard);
+    void commitPending();
     void doCommit(const SerializedChunk & serialized);
     SerialNum begin(const UniqueLock & guard) const;
     SerialNum end(const UniqueLock & guard) const;
@@ -72,6 +74,9 @@ private:
     vespalib::string dir() const { return getDir(_baseDir, _name); }
     void addPart(SerialNum partId, bool isLastPart);
     DomainPartSP optionallyRotateFile(SerialNum serialNum);
+    vespalib::string recycledPartName() const { return dir() + "/" + _name + "-recycled"; }
+    bool recyclePart(const DomainPartSP &dp);
+    void reuseRecycledPart(SerialNum partId);
 
     using SerialNumList = std::vector<SerialNum>;
 
@@ -81,11 +86,14 @@ private:
     using DomainPartList = std::map<SerialNum, DomainPartSP>;
     using DurationSeconds = std::chrono::duration<double>;
     using Executor = vespalib::Executor;
+    using PendingCommits = std::vector<std::future<SerializedChunk>>;
 
     DomainConfig                 _config;
     std::unique_ptr<CommitChunk> _currentChunk;
     SerialNum                    _lastSerial;
     std::unique_ptr<Executor>    _singleCommitter;
+    std::mutex                   _pendingCommitsMutex;
+    PendingCommits               _pendingCommits;
     Executor                    &_executor;
     std::atomic<int>             _sessionId;
     vespalib::string             _name;
@@ -93,6 +101,7 @@ private:
     mutable std::mutex           _partsMutex;
     std::mutex                   _currentChunkMutex;
     mutable std::mutex           _sessionMutex;
+    std::mutex                   _recycleMutex;
     SessionList                  _sessions;
     DurationSeconds              _maxSessionRunTime;
     vespalib::string             _baseDir;
@@ -7,6 +7,8 @@
 #include <vespa/fastlib/io/bufferedfile.h>
 #include <cassert>
 #include <filesystem>
+#include <fcntl.h>
+#include <unistd.h>
 
 #include <vespa/log/log.h>
 LOG_SETUP(".transactionlog.domainpart");
@@ -250,17 +252,19 @@ DomainPart::buildPacketMapping(bool allowTruncate)
 }
 
 DomainPart::DomainPart(const string & name, const string & baseDir, SerialNum s,
-                       const FileHeaderContext &fileHeaderContext, bool allowTruncate)
+                       const FileHeaderContext &fileHeaderContext, bool allowTruncate,
+                       size_t preallocateSize)
     : _lock(),
       _fileLock(),
       _range_from(s),
       _range_to(s ? s - 1 : s),
       _sz(0),
       _byteSize(0),
-      _fileName(fmt("%s/%s-%016" PRIu64, baseDir.c_str(), name.c_str(), s)),
+      _fileName(partFileName(baseDir, name, s)),
       _transLog(std::make_unique<FastOS_File>(_fileName.c_str())),
       _skipList(),
       _headerLen(0),
+      _preallocatedSize(0),
       _writeLock(),
       _writtenSerial(0),
       _syncedSerial(0)
@@ -297,6 +301,7 @@ DomainPart::DomainPart(const string & name, const string & baseDir, SerialNum s,
                                 _transLog->GetFileName(), _transLog->getSize()));
     }
     handleSync(*_transLog);
+    preallocate(preallocateSize);
     _writtenSerial = get_range_to();
     _syncedSerial = _writtenSerial;
     assert(int64_t(byteSize()) == _transLog->getSize());
@@ -308,6 +313,12 @@ DomainPart::~DomainPart()
     close();
 }
 
+string
+DomainPart::partFileName(const string &baseDir, const string &name, SerialNum s)
+{
+    return fmt("%s/%s-%016" PRIu64, baseDir.c_str(), name.c_str(), s);
+}
+
 void
 DomainPart::writeHeader(const FileHeaderContext &fileHeaderContext)
 {
@@ -321,6 +332,40 @@ DomainPart::writeHeader(const FileHeaderContext &fileHeaderContext)
     _headerLen = header.writeFile(*_transLog);
 }
 
+void
+DomainPart::preallocate(size_t preallocateSize)
+{
+    size_t currSize = byteSize();
+    if (preallocateSize <= currSize) {
+        return;
+    }
+#ifdef __linux__
+    // Keep the file size unchanged, readers rely on it to find the end of the log.
+    if (fallocate(_transLog->getFileDescriptor(), FALLOC_FL_KEEP_SIZE, currSize, preallocateSize - currSize) == 0) {
+        _preallocatedSize = preallocateSize;
+    } else {
+        LOG(debug, "Failed preallocating %zu bytes for file '%s': %s", preallocateSize,
+            _transLog->GetFileName(), FastOS_File::getLastErrorString().c_str());
+    }
+#endif
+}
+
+void
+DomainPart::releasePreallocated()
+{
+    size_t currSize = byteSize();
+#ifdef __linux__
+    if ((_preallocatedSize > currSize) && _transLog->IsOpened()) {
+        // Truncating to the current size frees the blocks reserved beyond it
+        if (ftruncate(_transLog->getFileDescriptor(), currSize) != 0) {
+            LOG(debug, "Failed releasing space preallocated beyond %zu bytes for file '%s': %s", currSize,
+                _transLog->GetFileName(), FastOS_File::getLastErrorString().c_str());
+        }
+    }
+#endif
+    _preallocatedSize = 0;
+}
+
 bool
 DomainPart::close()
 {
@@ -333,6 +378,7 @@ DomainPart::close()
          * for new domainpart.
          */
         handleSync(*_transLog);
+        releasePreallocated();
         _transLog->dropFromCache();
         retval = _transLog->Close();
         std::lock_guard wguard(_writeLock);
@@ -345,6 +391,30 @@ DomainPart::close()
     return retval;
 }
 
+void
+DomainPart::recycle(const string &recycledName, size_t preallocateSize)
+{
+    close();
+    std::filesystem::rename(std::filesystem::path(_fileName), std::filesystem::path(recycledName));
+    FastOS_File file(recycledName.c_str());
+    if ( ! file.OpenWriteOnlyExisting()) {
+        throw runtime_error(fmt("Failed opening recycled file '%s': %s", recycledName.c_str(), getLastErrorString().c_str()));
+    }
+    if ( ! file.SetSize(0)) {
+        throw runtime_error(fmt("Failed truncating recycled file '%s': %s", recycledName.c_str(), getLastErrorString().c_str()));
+    }
+#ifdef __linux__
+    if ((preallocateSize > 0) && (fallocate(file.getFileDescriptor(), FALLOC_FL_KEEP_SIZE, 0, preallocateSize) != 0)) {
+        LOG(debug, "Failed preallocating %zu bytes for recycled file '%s': %s", preallocateSize,
+            recycledName.c_str(), FastOS_File::getLastErrorString().c_str());
+    }
+#endif
+    handleSync(file);
+    if ( ! file.Close()) {
+        throw runtime_error(fmt("Failed closing recycled file '%s'", recycledName.c_str()));
+    }
+}
+
 bool
 DomainPart::isClosed() const {
     return ! _transLog->IsOpened();
@@ -4,13 +4,12 @@
 #include "common.h"
 #include "ichunk.h"
 #include <vespa/vespalib/util/memory.h>
+#include <vespa/fastos/file.h>
 #include <map>
 #include <vector>
 #include <atomic>
 #include <mutex>
 
-class FastOS_FileInterface;
-
 namespace search::common { class FileHeaderContext; }
 namespace search::transactionlog {
 
@@ -19,14 +18,30 @@ public:
     using SP = std::shared_ptr<DomainPart>;
     DomainPart(const DomainPart &) = delete;
     DomainPart& operator=(const DomainPart &) = delete;
+    /**
+     * If preallocateSize is larger than the current file size, disk space for the
+     * file is reserved up to that size while it is open for writing, so appends
+     * do not need to allocate blocks and the file does not get fragmented.
+     * The logical file size is not affected, as it marks the end of the log.
+     * Appends still grow it, so each fdatasync must persist the new size, but
+     * no longer the block allocations done by the file system.
+     */
     DomainPart(const vespalib::string &name, const vespalib::string &baseDir, SerialNum s,
-               const common::FileHeaderContext &FileHeaderContext, bool allowTruncate);
+               const common::FileHeaderContext &FileHeaderContext, bool allowTruncate,
+               size_t preallocateSize);
 
     ~DomainPart();
 
+    static vespalib::string partFileName(const vespalib::string &baseDir, const vespalib::string &name, SerialNum s);
     const vespalib::string &fileName() const { return _fileName; }
     void commit(const SerializedChunk & serialized);
     bool erase(SerialNum to);
+    /**
+     * Closes this part and moves its file to recycledName instead of removing it.
+     * The file is emptied, but keeps preallocateSize bytes of disk space reserved
+     * for the part that later takes it over. Nobody may be reading the file.
+     */
+    void recycle(const vespalib::string &recycledName, size_t preallocateSize);
     bool visit(FastOS_FileInterface &file, SerialNumRange &r, Packet &packet);
     bool close();
     void sync();
@@ -51,6 +66,8 @@ private:
 
     void write(FastOS_FileInterface &file, SerialNumRange range, vespalib::ConstBufferRef buf);
     void writeHeader(const common::FileHeaderContext &fileHeaderContext);
+    void preallocate(size_t preallocateSize);
+    void releasePreallocated();
     void set_size(size_t sz) noexcept { _sz.store(sz, std::memory_order_relaxed); }
     SerialNum get_range_from() const noexcept { return _range_from.load(std::memory_order_relaxed); }
     SerialNum get_range_to() const noexcept { return _range_to.load(std::memory_order_relaxed); }
@@ -81,9 +98,11 @@ private:
     std::atomic<size_t>   _sz;
     std::atomic<uint64_t> _byteSize;
     vespalib::string      _fileName;
-    std::unique_ptr<FastOS_FileInterface> _transLog;
+    std::unique_ptr<FastOS_File> _transLog;
     std::vector<SkipInfo> _skipList;
     uint32_t              _headerLen;
+    // Protected by _fileLock after construction
+    size_t                _preallocatedSize;
     mutable std::mutex    _writeLock;
     // Protected by _writeLock
     SerialNum             _writtenSerial;
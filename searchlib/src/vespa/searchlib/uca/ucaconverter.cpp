@@ -24,6 +24,8 @@ UcaConverterFactory::create(stringref local, stringref strength) const {
 }
 
 UcaConverter::UcaConverter(vespalib::stringref locale, vespalib::stringref strength) :
+    _locale(locale),
+    _strength(strength),
     _buffer(),
     _u16Buffer(128),
     _collator()
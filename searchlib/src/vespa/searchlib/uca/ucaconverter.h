@@ -28,6 +28,9 @@ public:
     UcaConverter(vespalib::stringref locale, vespalib::stringref strength);
     ~UcaConverter();
     const Collator & getCollator() const { return *_collator; }
+    const vespalib::string & locale() const { return _locale; }
+    // Empty means the default strength (PRIMARY)
+    const vespalib::string & strength() const { return _strength; }
 private:
     struct Buffer {
         vespalib::string _data;
@@ -56,6 +59,8 @@ private:
     };
     int utf8ToUtf16(const ConstBufferRef & src) const;
     ConstBufferRef onConvert(const ConstBufferRef & src) const override;
+    vespalib::string             _locale;
+    vespalib::string             _strength;
     mutable Buffer               _buffer;
     mutable std::vector<UChar>   _u16Buffer;
     std::unique_ptr<Collator>      _collator;
@@ -2,6 +2,7 @@
 
 #include "comprfile.h"
 #include <vespa/fastos/file.h>
+#include <vespa/vespalib/util/io_scheduler.h>
 #include <vespa/vespalib/util/size_literals.h>
 #include <cassert>
 #include <cstring>
@@ -256,6 +257,7 @@ WriteComprBuffer(ComprFileEncodeContext &encodeContext,
                  (flushSlack &&
                   static_cast<unsigned int>(chunksize) <= cbuf.getComprBufSize() +
                   ComprBuffer::minimumPadding()));
+    vespalib::IoScheduler::throttle(cbuf.getUnitSize() * chunksize);
     file.WriteBuf(cbuf.getComprBuf(), cbuf.getUnitSize() * chunksize);
 
     int remainingUnits = chunkUsedUnits - chunksize;
@@ -29,6 +29,7 @@ public:
     const vespalib::GenericHeader& header() const { return _header; }
     uint64_t file_size() const { return _file_size; }
     uint64_t data_size() const { return _file_size - _header_len; }
+    uint64_t header_len() const { return _header_len; }
 
     bool valid() const;
     void rewind();
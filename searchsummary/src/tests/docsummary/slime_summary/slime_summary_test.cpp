@@ -15,6 +15,7 @@
 #include <vespa/searchsummary/docsummary/docsum_store_document.h>
 #include <vespa/searchsummary/docsummary/docsumstate.h>
 #include <vespa/searchsummary/docsummary/docsumwriter.h>
+#include <vespa/searchsummary/docsummary/simple_dfw.h>
 #include <vespa/vespalib/data/slime/slime.h>
 #include <vespa/vespalib/data/smart_buffer.h>
 #include <vespa/vespalib/gtest/gtest.h>
@@ -42,6 +43,14 @@ using document::StructFieldValue;
 
 namespace {
 
+class DocIdDFW : public SimpleDFW {
+public:
+    bool isGenerated() const override { return true; }
+    void insertField(uint32_t docid, GetDocsumsState&, vespalib::slime::Inserter &target) const override {
+        target.insertLong(docid);
+    }
+};
+
 struct SlimeSummaryTest : testing::Test, IDocsumStore, GetDocsumsStateCallback {
     std::unique_ptr<DynamicDocsumWriter> writer;
     StructDataType  int_pair_type;
@@ -49,12 +58,13 @@ struct SlimeSummaryTest : testing::Test, IDocsumStore, GetDocsumsStateCallback {
     GetDocsumsState state;
     bool            fail_get_mapped_docsum;
     bool            empty_get_mapped_docsum;
+    uint32_t        get_document_calls;
     SlimeSummaryTest();
     ~SlimeSummaryTest() override;
     void getDocsum(Slime &slime) {
         Slime slimeOut;
         SlimeInserter inserter(slimeOut);
-        auto rci = writer->resolveClassInfo(state._args.getResultClassName(), {});
+        auto rci = writer->resolveClassInfo(state._args.getResultClassName(), state._args.get_fields());
         writer->insertDocsum(rci, 1u, state, *this, inserter);
         vespalib::SmartBuffer buf(4_Ki);
         BinaryFormat::encode(slimeOut, buf);
@@ -62,6 +72,7 @@ struct SlimeSummaryTest : testing::Test, IDocsumStore, GetDocsumsStateCallback {
     }
     std::unique_ptr<const IDocsumStoreDocument> get_document(uint32_t docid) override {
         EXPECT_EQ(1u, docid);
+        ++get_document_calls;
         if (fail_get_mapped_docsum) {
             return {};
         }
@@ -99,7 +110,8 @@ SlimeSummaryTest::SlimeSummaryTest()
       doc_type("test"),
       state(*this),
       fail_get_mapped_docsum(false),
-      empty_get_mapped_docsum(false)
+      empty_get_mapped_docsum(false),
+      get_document_calls(0)
 {
     auto config = std::make_unique<ResultConfig>();
     ResultClass *cfg = config->addResultClass("default", 0);
@@ -115,6 +127,10 @@ SlimeSummaryTest::SlimeSummaryTest()
     EXPECT_TRUE(cfg->addConfigEntry("longstring_field"));
     EXPECT_TRUE(cfg->addConfigEntry("longdata_field"));
     EXPECT_TRUE(cfg->addConfigEntry("int_pair_field"));
+    ResultClass *generated = config->addResultClass("generated", 1);
+    EXPECT_TRUE(generated != nullptr);
+    EXPECT_TRUE(generated->addConfigEntry("docid_1", std::make_unique<DocIdDFW>()));
+    EXPECT_TRUE(generated->addConfigEntry("docid_2", std::make_unique<DocIdDFW>()));
     config->set_default_result_class_id(0);
     writer = std::make_unique<DynamicDocsumWriter>(std::move(config));
     int_pair_type.addField(Field("foo", *DataType::INT));
@@ -153,6 +169,28 @@ TEST_F(SlimeSummaryTest, docsum_can_be_written_as_slime)
     EXPECT_EQ(s.get()["int_pair_field"]["bar"].asLong(), 2u);
 }
 
+TEST_F(SlimeSummaryTest, generated_docsum_is_written_without_fetching_document)
+{
+    state._args.setResultClassName("generated");
+    Slime s;
+    getDocsum(s);
+    EXPECT_EQ(0u, get_document_calls);
+    EXPECT_EQ(2u, s.get().fields());
+    EXPECT_EQ(1, s.get()["docid_1"].asLong());
+    EXPECT_EQ(1, s.get()["docid_2"].asLong());
+}
+
+TEST_F(SlimeSummaryTest, generated_docsum_only_contains_requested_fields)
+{
+    state._args.setResultClassName("generated");
+    state._args.set_fields({"docid_2", "unknown"});
+    Slime s;
+    getDocsum(s);
+    EXPECT_EQ(0u, get_document_calls);
+    EXPECT_EQ(1u, s.get().fields());
+    EXPECT_EQ(1, s.get()["docid_2"].asLong());
+}
+
 TEST_F(SlimeSummaryTest, unknown_summary_class_gives_empty_slime)
 {
     state._args.setResultClassName("unknown");
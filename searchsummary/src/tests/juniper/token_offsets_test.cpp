@@ -0,0 +1,139 @@
+// Copyright Vespa.ai. Licensed under the terms of the Apache 2.0 license. See LICENSE in the project root.
+#include <vespa/vespalib/testkit/testapp.h>
+#include <vespa/vespalib/test/insertion_operators.h>
+
+#include "testenv.h"
+#include <vespa/juniper/juniper_separators.h>
+#include <vespa/juniper/token_offsets.h>
+#include <string>
+
+using namespace juniper;
+
+struct Fixture
+{
+    PropertyMap              _props;
+    Fast_NormalizeWordFolder _wordfolder;
+    std::unique_ptr<Juniper> _juniper;
+    std::unique_ptr<Config>  _config;
+    Fixture()
+        : _props(),
+          _wordfolder(),
+          _juniper(),
+          _config()
+    {
+        _props.set("juniper.dynsum.highlight_on", "<hi>")
+            .set("juniper.dynsum.highlight_off", "</hi>")
+            .set("juniper.dynsum.continuation", "...")
+            .set("juniper.dynsum.length", "120");
+        _juniper = std::make_unique<Juniper>(&_props, &_wordfolder);
+        _config = _juniper->CreateConfig();
+    }
+    ~Fixture();
+    std::string build(const std::string& text) const {
+        return TokenOffsets::build(_wordfolder, text.data(), text.size());
+    }
+    struct Analysis {
+        size_t      hits;
+        long        relevancy;
+        std::string teaser;
+    };
+    Analysis analyse(const char* query, const std::string& text, const std::string* token_offsets) {
+        QueryParser parser(query);
+        QueryHandle handle(parser, nullptr, _juniper->getModifier());
+        auto result = (token_offsets != nullptr)
+                      ? Analyse(*_config, handle, text.data(), text.size(), 0, 0, *token_offsets)
+                      : Analyse(*_config, handle, text.data(), text.size(), 0, 0);
+        result->Scan();
+        Analysis analysis{result->_matcher->TotalHits(), GetRelevancy(*result), ""};
+        Summary* teaser = GetTeaser(*result, nullptr);
+        analysis.teaser = std::string(teaser->Text(), teaser->Length());
+        return analysis;
+    }
+    void assert_same_analysis(const char* query, const std::string& text) {
+        TEST_STATE(query);
+        auto token_offsets = build(text);
+        auto expected = analyse(query, text, nullptr);
+        auto actual = analyse(query, text, &token_offsets);
+        EXPECT_EQUAL(expected.hits, actual.hits);
+        EXPECT_EQUAL(expected.relevancy, actual.relevancy);
+        EXPECT_EQUAL(expected.teaser, actual.teaser);
+    }
+};
+
+Fixture::~Fixture() = default;
+
+std::string
+make_text()
+{
+    std::string text;
+    for (int i = 0; i < 200; ++i) {
+        text += "Some filler text about nothing in particular, number " + std::to_string(i) + ". ";
+        if (i == 50) {
+            text += "Here the Quick brown FOX jumps over the lazy dog. ";
+        }
+        if (i == 120) {
+            text += "Another fox, and a dog named " + separators::interlinear_annotation_anchor_string + "Dogs" +
+                    separators::interlinear_annotation_separator_string + "dog" +
+                    separators::interlinear_annotation_terminator_string + " too. ";
+        }
+    }
+    return text;
+}
+
+TEST_F("require that token offsets cover all tokens of the text", Fixture) {
+    std::string text("Hello, wonderful world!");
+    auto encoded = f.build(text);
+    TokenOffsets offsets(encoded, text.size());
+    ASSERT_TRUE(offsets.valid());
+    EXPECT_EQUAL(3u, offsets.num_tokens());
+    std::vector<size_t> scan_starts;
+    std::string keys;
+    offsets.for_each([&](size_t scan_start, uint8_t key) {
+                         scan_starts.push_back(scan_start);
+                         keys.push_back(static_cast<char>(key));
+                     });
+    EXPECT_EQUAL((std::vector<size_t>{0, 5, 16}), scan_starts);
+    EXPECT_EQUAL(std::string("hww"), keys);
+}
+
+TEST_F("require that token offsets not matching the text are invalid", Fixture) {
+    std::string text("Hello, wonderful world!");
+    auto encoded = f.build(text);
+    EXPECT_FALSE(TokenOffsets(encoded, text.size() + 1).valid());
+    EXPECT_FALSE(TokenOffsets("", text.size()).valid());
+    EXPECT_FALSE(TokenOffsets(encoded.substr(0, encoded.size() - 1), text.size()).valid());
+    EXPECT_FALSE(TokenOffsets(encoded + "x", text.size()).valid());
+    std::string wrong_version(encoded);
+    wrong_version[0] = 2;
+    EXPECT_FALSE(TokenOffsets(wrong_version, text.size()).valid());
+}
+
+TEST_F("require that analysis using token offsets gives the same result", Fixture) {
+    auto text = make_text();
+    f.assert_same_analysis("fox", text);
+    f.assert_same_analysis("AND(quick,fox)", text);
+    f.assert_same_analysis("PHRASE(lazy,dog)", text);
+    f.assert_same_analysis("OR(dog,number)", text);
+    f.assert_same_analysis("fo*", text);
+    f.assert_same_analysis("*ox", text);
+    f.assert_same_analysis("nomatch", text);
+}
+
+TEST_F("require that only candidate tokens are matched when using token offsets", Fixture) {
+    // Token offsets from another text of the same length are used as is, showing
+    // that tokens with keys not matching any query term are skipped.
+    std::string text("alpha beta gamma");
+    std::string other("gamma beta alpha");
+    auto token_offsets = f.build(other);
+    EXPECT_EQUAL(1u, f.analyse("alpha", text, nullptr).hits);
+    EXPECT_EQUAL(0u, f.analyse("alpha", text, &token_offsets).hits);
+    EXPECT_EQUAL(1u, f.analyse("beta", text, &token_offsets).hits);
+}
+
+TEST_F("require that stale token offsets are ignored", Fixture) {
+    auto text = make_text();
+    auto token_offsets = f.build(text + " fox");
+    EXPECT_EQUAL(f.analyse("fox", text, nullptr).teaser, f.analyse("fox", text, &token_offsets).teaser);
+}
+
+TEST_MAIN() { TEST_RUN_ALL(); }
@@ -208,6 +208,22 @@ bool MatchObject::Match(MatchObject::iterator& mi, Token& token, unsigned& optio
 }
 
 
+bool MatchObject::TokenKeys(juniper::TokenOffsets::KeySet& keys)
+{
+    if (_has_reductions) return false;
+    keys.reset();
+    // Annotated tokens are matched on the annotation
+    keys.set(juniper::TokenOffsets::key(interlinear_annotation_anchor));
+    for (QueryTerm* q : _qt) {
+        ucs4_t first = q->ucs4_term()[0];
+        // Terms starting with a wildcard are matched against all tokens
+        if (first == '*' || first == '?') return false;
+        keys.set(juniper::TokenOffsets::key(first));
+    }
+    return true;
+}
+
+
 void MatchObject::add_nonterm(QueryNode* n)
 {
     _nonterms.push_back(n);
@@ -7,6 +7,7 @@
 #include <vespa/fastlib/text/unicodeutil.h>
 #include "reducematcher.h"
 #include "ITokenProcessor.h"
+#include "token_offsets.h"
 
 using Result = juniper::Result;
 using Token = ITokenProcessor::Token;
@@ -95,6 +96,12 @@ public:
     inline QueryExpr* Query() { return _query; }
     inline bool HasReductions() { return _has_reductions; }
 
+    /** Get the keys (see TokenOffsets) of the tokens that may match a query term
+     * @param keys set to the keys of the first characters of the query terms
+     * @return false if any token may match, e.g. due to reductions or leading wildcards
+     */
+    bool TokenKeys(juniper::TokenOffsets::KeySet& keys);
+
     // internal use only..
     void add_queryterm(QueryTerm* term);
     void add_nonterm(QueryNode* n);
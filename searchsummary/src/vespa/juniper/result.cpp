@@ -35,6 +35,7 @@ Result::Result(const Config& config, QueryHandle& qhandle,
     _docsum(docsum),
     _docsum_len(docsum_len),
     _langid(langid),
+    _token_offsets(),
     _config(&config),
     _matcher(),
     _tokenizer(),
@@ -100,6 +101,18 @@ Result::Result(const Config& config, QueryHandle& qhandle,
 Result::~Result() = default;
 
 
+// Scan only the tokens that may match the query, using precomputed token offsets if available
+bool Result::ScanCandidates()
+{
+    if (_token_offsets.empty() || !_registry->getSpecialTokens().empty()) return false;
+    TokenOffsets offsets(_token_offsets, _docsum_len);
+    TokenOffsets::KeySet keys;
+    if (!offsets.valid() || !_mo->TokenKeys(keys)) return false;
+    _tokenizer->scan_candidates(offsets, keys);
+    return true;
+}
+
+
 long Result::GetRelevancy()
 {
     if (!_mo) return PROXIMITYBOOST_NOCONSTRAINT_OFFSET;
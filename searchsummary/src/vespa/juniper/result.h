@@ -5,6 +5,7 @@
 #include "tokenizer.h"
 #include "juniperdebug.h"
 #include <memory>
+#include <string_view>
 
 namespace juniper
 {
@@ -23,7 +24,9 @@ public:
         if (!_scan_done)
         {
             _tokenizer->SetText(_docsum, _docsum_len);
-            _tokenizer->scan();
+            if (!ScanCandidates()) {
+                _tokenizer->scan();
+            }
             _scan_done = true;
         }
     }
@@ -42,11 +45,14 @@ public:
     const char* _docsum;
     size_t _docsum_len;
     uint32_t _langid;
+    std::string_view _token_offsets; // Precomputed token offsets for docsum, if any
     const Config* _config;
     std::unique_ptr<Matcher> _matcher;
     std::unique_ptr<SpecialTokenRegistry> _registry;
     std::unique_ptr<JuniperTokenizer> _tokenizer;
 private:
+    bool ScanCandidates();
+
     std::vector<std::unique_ptr<Summary>> _summaries; // Active summaries for this result
     bool _scan_done;  // State of the result - is text scan done?
 
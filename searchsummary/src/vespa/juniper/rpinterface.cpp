@@ -96,6 +96,17 @@ std::unique_ptr<Result> Analyse(const Config& config, QueryHandle& qhandle,
     return std::make_unique<Result>(config, qhandle, docsum, docsum_len, langid);
 }
 
+std::unique_ptr<Result> Analyse(const Config& config, QueryHandle& qhandle,
+                const char* docsum,  size_t docsum_len,
+                uint32_t docid,
+                uint32_t langid,
+                std::string_view token_offsets)
+{
+    auto result = Analyse(config, qhandle, docsum, docsum_len, docid, langid);
+    result->_token_offsets = token_offsets;
+    return result;
+}
+
 long GetRelevancy(Result& result_handle)
 {
     return result_handle.GetRelevancy();
@@ -6,6 +6,7 @@
 #include "IJuniperProperties.h"
 #include "rewriter.h"
 #include <memory>
+#include <string_view>
 
 /** @file rpinterface.h This file is the main include file for the advanced
  *    result processing interface to Juniper. The complete set of new interfaces
@@ -170,6 +171,19 @@ std::unique_ptr<Result> Analyse(const Config& config, QueryHandle& query,
                 uint32_t docid,
                 uint32_t langid);
 
+/** As Analyse above, but using token offsets (see token_offsets.h) built for
+ *  the document summary when the document was fed, to only tokenize and match
+ *  the tokens that may match the query. Token offsets not matching the
+ *  document summary are ignored.
+ * @param token_offsets The encoded token offsets for the document summary.
+ *    Must stay valid as long as the Result.
+ */
+std::unique_ptr<Result> Analyse(const Config& config, QueryHandle& query,
+                const char* docsum, size_t docsum_len,
+                uint32_t docid,
+                uint32_t langid,
+                std::string_view token_offsets);
+
 /** Get the computed relevancy of the processed content from the result.
  *  @param result_handle The result to retrieve from
  *  @return The relevancy (proximitymetric) of the processed content.
@@ -0,0 +1,92 @@
+// Copyright Vespa.ai. Licensed under the terms of the Apache 2.0 license. See LICENSE in the project root.
+
+#include "token_offsets.h"
+#include "tokenizer.h"
+#include <vespa/fastlib/text/wordfolder.h>
+
+namespace juniper {
+
+namespace {
+
+constexpr uint8_t format_version = 1;
+
+void write_varint(std::string& out, size_t value)
+{
+    while (value >= 0x80) {
+        out.push_back(static_cast<char>((value & 0x7f) | 0x80));
+        value >>= 7;
+    }
+    out.push_back(static_cast<char>(value));
+}
+
+}
+
+std::string
+TokenOffsets::build(const Fast_WordFolder& wordfolder, const char* text, size_t len)
+{
+    // Same tokenization as JuniperTokenizer::scan() without special tokens
+    std::string entries;
+    size_t num_tokens = 0;
+    ucs4_t buffer[TOKEN_DSTLEN];
+    const char* src = text;
+    const char* src_end = text + len;
+    const char* prev_end = text;
+    const char* startpos = nullptr;
+    size_t result_len;
+    while (src < src_end) {
+        src = wordfolder.UCS4Tokenize(src, src_end, buffer, buffer + TOKEN_DSTLEN, startpos, result_len);
+        if (buffer[0] == 0) break;
+        write_varint(entries, src - prev_end);
+        entries.push_back(static_cast<char>(key(buffer[0])));
+        prev_end = src;
+        ++num_tokens;
+    }
+    std::string result;
+    result.reserve(entries.size() + 12);
+    result.push_back(static_cast<char>(format_version));
+    write_varint(result, len);
+    write_varint(result, num_tokens);
+    result.append(entries);
+    return result;
+}
+
+TokenOffsets::TokenOffsets(std::string_view encoded, size_t text_len)
+    : _entries(encoded.data()),
+      _end(encoded.data() + encoded.size()),
+      _num_tokens(0),
+      _valid(false)
+{
+    if (encoded.empty() || static_cast<uint8_t>(*_entries++) != format_version) {
+        return;
+    }
+    if (read_varint(_entries, _end) != text_len) {
+        return;
+    }
+    _num_tokens = read_varint(_entries, _end);
+    _valid = validate(text_len);
+}
+
+bool
+TokenOffsets::validate(size_t text_len) const noexcept
+{
+    // Each token has at least two bytes
+    if (_num_tokens > size_t(_end - _entries) / 2) {
+        return false;
+    }
+    const char* pos = _entries;
+    size_t end = 0;
+    for (size_t i = 0; i < _num_tokens; ++i) {
+        if (pos >= _end) {
+            return false;
+        }
+        size_t delta = read_varint(pos, _end);
+        if (pos >= _end || delta > text_len - end) {
+            return false;
+        }
+        end += delta;
+        ++pos; // key
+    }
+    return (pos == _end);
+}
+
+}
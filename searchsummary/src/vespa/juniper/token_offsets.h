@@ -0,0 +1,87 @@
+// Copyright Vespa.ai. Licensed under the terms of the Apache 2.0 license. See LICENSE in the project root.
+#pragma once
+
+#include <vespa/fastlib/text/unicodeutil.h>
+#include <bitset>
+#include <string>
+#include <string_view>
+
+class Fast_WordFolder;
+
+namespace juniper {
+
+/**
+ * Side structure holding the token boundaries of a text as found by the
+ * tokenizer used when analysing the text for dynamic teasers. It can be built
+ * when the document is fed and stored along with the text. Analysis can then
+ * skip folding and matching the tokens that cannot match any query term,
+ * instead of tokenizing the whole text for every hit.
+ *
+ * For each token the offset where the token ends (and tokenization of the
+ * next token starts) is stored, together with a one byte key derived from the
+ * first character of the folded token. Query terms are looked up on their
+ * first character when matching, so only tokens with a key in the set of keys
+ * of the query terms need to be tokenized again and matched.
+ *
+ * The structure must be built with the same word folder as used by the
+ * Juniper config of the field. The length of the text is included, and a
+ * structure not matching the text is ignored.
+ */
+class TokenOffsets
+{
+public:
+    using KeySet = std::bitset<256>;
+
+    static uint8_t key(ucs4_t first_char) noexcept { return static_cast<uint8_t>(first_char); }
+
+    /**
+     * Tokenize the text and return the encoded side structure.
+     */
+    static std::string build(const Fast_WordFolder& wordfolder, const char* text, size_t len);
+
+    /**
+     * Decode the header of an encoded side structure for a text of the given length.
+     * The token entries are validated as well, making the structure invalid if they
+     * do not fit in the text.
+     */
+    TokenOffsets(std::string_view encoded, size_t text_len);
+
+    bool valid() const noexcept { return _valid; }
+    size_t num_tokens() const noexcept { return _num_tokens; }
+
+    /**
+     * Call func(scan_start, key) for each token, in text order, where scan_start is
+     * the offset where tokenization of the token starts. Must only be called when valid.
+     */
+    template <typename Func>
+    void for_each(Func func) const {
+        const char* pos = _entries;
+        size_t end = 0;
+        for (size_t i = 0; i < _num_tokens; ++i) {
+            size_t scan_start = end;
+            end += read_varint(pos, _end);
+            func(scan_start, static_cast<uint8_t>(*pos++));
+        }
+    }
+
+private:
+    static size_t read_varint(const char*& pos, const char* end) noexcept {
+        size_t value = 0;
+        for (uint32_t shift = 0; pos < end && shift < 64; shift += 7) {
+            uint8_t byte = *pos++;
+            value |= size_t(byte & 0x7f) << shift;
+            if ((byte & 0x80) == 0) {
+                break;
+            }
+        }
+        return value;
+    }
+    bool validate(size_t text_len) const noexcept;
+
+    const char* _entries;
+    const char* _end;
+    size_t      _num_tokens;
+    bool        _valid;
+};
+
+}
@@ -65,3 +65,34 @@ void JuniperTokenizer::scan()
     token.token = nullptr;
     _successor->handle_end(token);
 }
+
+
+void JuniperTokenizer::scan_candidates(const juniper::TokenOffsets& offsets, const juniper::TokenOffsets::KeySet& keys)
+{
+    ITokenProcessor::Token token;
+
+    const char* src_end = _text + _len;
+    const char* startpos = nullptr;
+    ucs4_t* dst = _buffer;
+    ucs4_t* dst_end = dst + TOKEN_DSTLEN;
+    size_t result_len;
+
+    offsets.for_each([&](size_t scan_start, uint8_t key) {
+        if (keys[key]) {
+            const char* src = _wordfolder->UCS4Tokenize(_text + scan_start, src_end, dst, dst_end, startpos, result_len);
+            if (dst[0] != 0) {
+                token.curlen = result_len;
+                token.token = dst;
+                token.wordpos = _wordpos;
+                token.bytepos = startpos - _text;
+                token.bytelen = src - startpos;
+                _successor->handle_token(token);
+            }
+        }
+        ++_wordpos;
+    });
+    token.bytepos = _len;
+    token.bytelen = 0;
+    token.token = nullptr;
+    _successor->handle_end(token);
+}
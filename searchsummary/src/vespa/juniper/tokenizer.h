@@ -3,6 +3,7 @@
 
 #include "specialtokenregistry.h"
 #include "ITokenProcessor.h"
+#include "token_offsets.h"
 
 class Fast_WordFolder;
 
@@ -21,6 +22,9 @@ public:
 
     // Scan the input and dispatch to the successor
     void scan();
+    // As scan(), but only tokenize and dispatch the tokens with a key in keys,
+    // using precomputed (and valid) token offsets for the input
+    void scan_candidates(const juniper::TokenOffsets& offsets, const juniper::TokenOffsets::KeySet& keys);
 private:
     const Fast_WordFolder* _wordfolder;
     const char*            _text;  // The current input text
@@ -36,6 +36,7 @@ protected:
 public:
     ~AttributeCombinerDFW() override;
     bool isGenerated() const override { return true; }
+    bool is_query_dependent() const override { return _filter_elements; }
     bool setFieldWriterStateIndex(uint32_t fieldWriterStateIndex) override;
     static std::unique_ptr<DocsumFieldWriter> create(const vespalib::string &fieldName, search::attribute::IAttributeContext &attrCtx,
                                                      bool filter_elements, std::shared_ptr<MatchingElementsFields> matching_elems_fields);
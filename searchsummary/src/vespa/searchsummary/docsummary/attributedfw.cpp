@@ -98,7 +98,7 @@ SingleAttrDFW::insertField(uint32_t docid, GetDocsumsState& state, Inserter &tar
         break;
     }
     case BasicType::STRING: {
-        auto s = v.get_raw(docid);
+        auto s = v.get_string_view(docid);
         target.insertString(vespalib::Memory(s.data(), s.size()));
         break;
     }
@@ -251,6 +251,7 @@ public:
         }
     }
     bool setFieldWriterStateIndex(uint32_t fieldWriterStateIndex) override;
+    bool is_query_dependent() const override { return _filter_elements; }
     void insertField(uint32_t docid, GetDocsumsState& state, Inserter& target) const override;
 };
 
@@ -26,6 +26,8 @@ public:
     virtual void insertField(uint32_t docid, const IDocsumStoreDocument* doc, GetDocsumsState& state, vespalib::slime::Inserter &target) const = 0;
     virtual const vespalib::string & getAttributeName() const;
     virtual bool isDefaultValue(uint32_t docid, const GetDocsumsState& state) const;
+    // Whether the field value depends on the query (and thus cannot be reused across requests)
+    virtual bool is_query_dependent() const { return false; }
     void setIndex(size_t v) { _index = v; }
     size_t getIndex() const { return _index; }
     virtual bool setFieldWriterStateIndex(uint32_t fieldWriterStateIndex);
@@ -36,9 +36,34 @@ DocsumStoreDocument::get_field_value(const vespalib::string& field_name) const
     return DocsumStoreFieldValue();
 }
 
+bool
+DocsumStoreDocument::insert_plain_string_field(const vespalib::string& field_name, vespalib::slime::Inserter& inserter) const
+{
+    if (!_document) {
+        return false;
+    }
+    try {
+        const document::Field& field = _document->getField(field_name);
+        if (field.getDataType().getId() != document::DataType::T_STRING) {
+            return false;
+        }
+        vespalib::stringref value;
+        // Empty strings are undefined and not inserted, matching CheckUndefinedValueVisitor.
+        if (_document->getFields().getStringValueRef(field, value) && !value.empty()) {
+            inserter.insertString(vespalib::Memory(value.data(), value.size()));
+        }
+    } catch (document::FieldNotFoundException&) {
+        // Field was not found in document type. Insert nothing.
+    }
+    return true;
+}
+
 void
 DocsumStoreDocument::insert_summary_field(const vespalib::string& field_name, vespalib::slime::Inserter& inserter, IStringFieldConverter* converter) const
 {
+    if ((converter == nullptr) && insert_plain_string_field(field_name, inserter)) {
+        return;
+    }
     auto field_value = get_field_value(field_name);
     if (field_value) {
         SlimeFiller::insert_summary_field(*field_value, inserter, converter);
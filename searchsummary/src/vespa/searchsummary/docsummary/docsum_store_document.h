@@ -14,6 +14,8 @@ namespace search::docsummary {
 class DocsumStoreDocument : public IDocsumStoreDocument
 {
     std::unique_ptr<document::Document> _document;
+    // Inserts a string field directly from its serialized form. Returns false if not a string field.
+    bool insert_plain_string_field(const vespalib::string& field_name, vespalib::slime::Inserter& inserter) const;
 public:
     explicit DocsumStoreDocument(std::unique_ptr<document::Document> document);
     ~DocsumStoreDocument() override;
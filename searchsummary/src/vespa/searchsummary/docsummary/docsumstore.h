@@ -2,7 +2,9 @@
 
 #pragma once
 
+#include <cstdint>
 #include <memory>
+#include <vector>
 
 namespace search::docsummary {
 
@@ -22,6 +24,12 @@ public:
      * Get a docsum specific abstract of the document for the given local document id.
      **/
     virtual std::unique_ptr<const IDocsumStoreDocument> get_document(uint32_t docid) = 0;
+
+    /**
+     * Tell the store that get_document() will be called for the given local document ids next,
+     * in the same order, allowing it to read them together. The default does nothing.
+     **/
+    virtual void prefetch_documents(const std::vector<uint32_t> &docids) { (void) docids; }
 };
 
 }
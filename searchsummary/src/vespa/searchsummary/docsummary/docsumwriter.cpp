@@ -31,6 +31,13 @@ DynamicDocsumWriter::resolveClassInfo(vespalib::stringref class_name,
                       vespalib::string(class_name).c_str());
     } else {
         result.all_fields_generated = res_class->all_fields_generated(fields);
+        if (result.all_fields_generated) {
+            for (uint32_t i = 0; i < res_class->getNumEntries(); ++i) {
+                if (fields.empty() || fields.contains(res_class->getEntry(i)->name())) {
+                    result.generated_entries.push_back(i);
+                }
+            }
+        }
     }
     result.res_class = res_class;
     return result;
@@ -45,12 +52,12 @@ DynamicDocsumWriter::insertDocsum(const ResolveClassInfo & rci, uint32_t docid,
         return;
     }
     if (rci.all_fields_generated) {
-        // generate docsum entry on-the-fly
+        // generate docsum entry on-the-fly, typically from attributes only, without touching the document store
         vespalib::slime::Cursor & docsum = topInserter.insertObject();
-        for (uint32_t i = 0; i < rci.res_class->getNumEntries(); ++i) {
+        for (uint32_t i : rci.generated_entries) {
             const ResConfigEntry *resCfg = rci.res_class->getEntry(i);
             const DocsumFieldWriter *writer = resCfg->writer();
-            if (state._args.need_field(resCfg->name()) && ! writer->isDefaultValue(docid, state)) {
+            if (! writer->isDefaultValue(docid, state)) {
                 const Memory field_name(resCfg->name().data(), resCfg->name().size());
                 ObjectInserter inserter(docsum, field_name);
                 writer->insertField(docid, nullptr, state, inserter);
@@ -8,6 +8,7 @@
 #include "resultclass.h"
 #include "resultconfig.h"
 #include <vespa/vespalib/stllike/string.h>
+#include <vector>
 
 namespace search { class IAttributeManager; }
 
@@ -27,9 +28,12 @@ public:
     struct ResolveClassInfo {
         bool all_fields_generated;
         const ResultClass* res_class;
+        // Indexes of the entries to write when all fields are generated, resolved once per request
+        std::vector<uint32_t> generated_entries;
         ResolveClassInfo()
             : all_fields_generated(false),
-              res_class(nullptr)
+              res_class(nullptr),
+              generated_entries()
         { }
     };
 
@@ -33,6 +33,7 @@ protected:
     std::shared_ptr<const IQueryTermFilter> _query_term_filter;
 private:
     bool isGenerated() const override { return false; }
+    bool is_query_dependent() const override { return true; }
     JuniperDFW(const JuniperDFW &);
     JuniperDFW & operator=(const JuniperDFW &);
 };
@@ -34,6 +34,7 @@ public:
                                                      std::shared_ptr<MatchingElementsFields> matching_elems_fields);
     ~MatchedElementsFilterDFW() override;
     bool isGenerated() const override { return false; }
+    bool is_query_dependent() const override { return true; }
     void insertField(uint32_t docid, const IDocsumStoreDocument* doc, GetDocsumsState& state,
                      vespalib::slime::Inserter& target) const override;
 };
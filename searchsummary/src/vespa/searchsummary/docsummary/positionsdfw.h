@@ -32,6 +32,7 @@ public:
         }
     };
     AllLocations getAllLocations(GetDocsumsState& state) const;
+    bool is_query_dependent() const override { return true; }
 };
 
 class AbsDistanceDFW : public LocationAttrDFW
@@ -14,6 +14,7 @@ public:
     RankFeaturesDFW & operator=(const RankFeaturesDFW &) = delete;
     ~RankFeaturesDFW() override;
     bool isGenerated() const override { return true; }
+    bool is_query_dependent() const override { return true; }
     void insertField(uint32_t docid, GetDocsumsState& state, vespalib::slime::Inserter &target) const override;
 };
 
@@ -12,7 +12,8 @@ ResultClass::ResultClass(const char *name)
       _nameMap(),
       _dynInfo(),
       _omit_summary_features(false),
-      _num_field_writer_states(0)
+      _num_field_writer_states(0),
+      _query_dependent(false)
 { }
 
 
@@ -41,6 +42,9 @@ ResultClass::addConfigEntry(const char *name, std::unique_ptr<DocsumFieldWriter>
         if (docsum_field_writer->setFieldWriterStateIndex(_num_field_writer_states)) {
             ++_num_field_writer_states;
         }
+        if (docsum_field_writer->is_query_dependent()) {
+            _query_dependent = true;
+        }
     }
     e.set_writer(std::move(docsum_field_writer));
     _entries.push_back(std::move(e));
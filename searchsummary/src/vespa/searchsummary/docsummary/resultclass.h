@@ -47,6 +47,7 @@ private:
     // As default, summary features are always included.
     bool                       _omit_summary_features;
     size_t                     _num_field_writer_states;
+    bool                       _query_dependent;
 
 public:
     using UP = std::unique_ptr<ResultClass>;
@@ -129,6 +130,13 @@ public:
     }
 
     size_t get_num_field_writer_states() const noexcept { return _num_field_writer_states; }
+
+    /**
+     * Returns whether any field in this result class depends on the query (dynamic snippets,
+     * summary or rank features, matched elements filtering, distances). Docsums of such
+     * classes are specific to a single request.
+     */
+    bool is_query_dependent() const noexcept { return _query_dependent; }
 };
 
 }
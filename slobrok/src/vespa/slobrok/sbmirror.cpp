@@ -116,8 +116,8 @@ MirrorAPI::updateTo(SpecMap newSpecs, uint32_t newGen)
         _updates.add();
     }
     _specsGen.setFromInt(newGen);
-    if (_rpc_ms < 15000) {
-        _rpc_ms = 15000;
+    if (_rpc_ms < fetch_hold_ms + fetch_margin_ms) {
+        _rpc_ms = fetch_hold_ms + fetch_margin_ms;
     }
 }
 
@@ -286,7 +286,7 @@ MirrorAPI::makeRequest()
     _req = _orb.AllocRPCRequest(_req);
     _req->SetMethodName("slobrok.incremental.fetch");
     _req->GetParams()->AddInt32(_specsGen.getAsInt()); // gencnt
-    _req->GetParams()->AddInt32(5000);                 // mstimeout
+    _req->GetParams()->AddInt32(fetch_hold_ms);        // mstimeout
     _target->InvokeAsync(_req, 0.001 * _rpc_ms, this);
     _reqPending = true;
 }
@@ -307,8 +307,11 @@ MirrorAPI::PerformTask()
 {
     _scheduled = false;
     handleReconfig();
-    if (handleReqDone()) {
-        reSched(0.1); // be nice, do not make request again immediately
+    uint32_t oldGen = _specsGen.getAsInt();
+    if (handleReqDone() && (_specsGen.getAsInt() != oldGen)) {
+        // be nice, do not make request again immediately after a change;
+        // when nothing changed the slobrok has already held the request
+        reSched(0.1);
         return;
     }
     handleReconnect();
@@ -89,6 +89,11 @@ private:
 
     void reSched(double seconds);
 
+    /** how long the slobrok may hold a fetch when nothing has changed **/
+    static constexpr int fetch_hold_ms = 30000;
+    /** rpc timeout margin on top of the hold time **/
+    static constexpr int fetch_margin_ms = 10000;
+
     FRT_Supervisor          &_orb;
     mutable std::mutex       _lock;
     bool                     _reqPending;
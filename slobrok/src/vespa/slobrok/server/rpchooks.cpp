@@ -156,7 +156,7 @@ void RPCHooks::initRPC(FRT_Supervisor *supervisor) {
     rb.MethodDesc("Fetch or update peer mirror of local view");
     rb.ParamDesc("gencnt",  "generation already known by peer");
     rb.ParamDesc("timeout", "How many milliseconds to wait for changes"
-                 "before returning if nothing has changed (max=10000)");
+                 "before returning if nothing has changed (max=60000)");
 
     rb.ReturnDesc("oldgen",  "Generation already known by peer");
     rb.ReturnDesc("removed", "Array of NamedService names to remove");
@@ -220,7 +220,7 @@ void RPCHooks::initRPC(FRT_Supervisor *supervisor) {
     rb.MethodDesc("Fetch or update mirror of name to spec map");
     rb.ParamDesc("gencnt",  "generation already known by client");
     rb.ParamDesc("timeout", "How many milliseconds to wait for changes"
-                 "before returning if nothing has changed (max=10000)");
+                 "before returning if nothing has changed (max=60000)");
 
     rb.ReturnDesc("oldgen",  "diff from generation already known by client");
     rb.ReturnDesc("removed", "Array of NamedService names to remove");
@@ -67,8 +67,8 @@ IncrementalFetch::invoke(uint32_t msTimeout)
     _req->Detach();
     LOG(debug, "IncrementalFetch %p invoked from %s (gen %d, timeout %d ms)",
         this, _req->GetConnection()->GetSpec(), _gen.getAsInt(), msTimeout);
-    if (msTimeout > 10000)
-        msTimeout = 10000;
+    if (msTimeout > max_timeout_ms)
+        msTimeout = max_timeout_ms;
     Schedule(msTimeout * 0.001);
     _smh.asyncGenerationDiff(this, _gen);
 }
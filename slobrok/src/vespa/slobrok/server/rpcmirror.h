@@ -19,6 +19,9 @@ private:
     vespalib::GenCnt _gen;
 
 public:
+    /** the longest a request is held waiting for changes **/
+    static constexpr uint32_t max_timeout_ms = 60000;
+
     IncrementalFetch(const IncrementalFetch &) = delete;
     IncrementalFetch& operator=(const IncrementalFetch &) = delete;
 
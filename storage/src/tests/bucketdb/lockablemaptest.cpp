@@ -779,6 +779,45 @@ TYPED_TEST(LockableMapTest, entry_changes_not_visible_if_write_not_invoked_on_gu
     EXPECT_EQ(*entry, A());
 }
 
+TYPED_TEST(LockableMapTest, snapshot_lookup_does_not_require_bucket_lock) {
+    TypeParam map;
+    BucketId id1(16, 0x00001);
+    BucketId id2(17, 0x00001);
+    bool pre_existed;
+    map.insert(id1.toKey(), A(1, 2, 3), "foo", pre_existed);
+
+    auto entry = map.get(id1.toKey(), "foo");
+    ASSERT_TRUE(entry.locked());
+    // Would deadlock if the lookup tried to acquire the bucket lock held above.
+    auto snapshot = map.get_snapshot(id1.toKey());
+    ASSERT_TRUE(snapshot.has_value());
+    EXPECT_EQ(*snapshot, A(1, 2, 3));
+    EXPECT_FALSE(map.get_snapshot(id2.toKey()).has_value());
+
+    *entry = A(4, 5, 6);
+    entry.write();
+    snapshot = map.get_snapshot(id1.toKey());
+    ASSERT_TRUE(snapshot.has_value());
+    EXPECT_EQ(*snapshot, A(4, 5, 6));
+}
+
+TYPED_TEST(LockableMapTest, read_guard_can_find_exact_bucket) {
+    TypeParam map;
+    BucketId id1(16, 0x00001);
+    BucketId id2(17, 0x00001);
+    bool pre_existed;
+    map.insert(id1.toKey(), A(1, 2, 3), "foo", pre_existed);
+
+    auto guard = map.acquire_read_guard();
+    map.insert(id2.toKey(), A(4, 5, 6), "foo", pre_existed);
+    auto found = guard->find(id1);
+    ASSERT_TRUE(found.has_value());
+    EXPECT_EQ(*found, A(1, 2, 3));
+    // Inserted after the guard was acquired, so not part of its snapshot
+    EXPECT_FALSE(guard->find(id2).has_value());
+    EXPECT_TRUE(map.acquire_read_guard()->find(id2).has_value());
+}
+
 TYPED_TEST(LockableMapTest, track_sizes) {
     TypeParam map;
     EXPECT_EQ(48ul, sizeof(typename TypeParam::WrappedEntry));
@@ -5,6 +5,7 @@
 #include <vespa/vdslib/distribution/distribution.h>
 #include <vespa/vdslib/state/clusterstate.h>
 #include <vespa/vespalib/gtest/gtest.h>
+#include <algorithm>
 
 using document::BucketId;
 using storage::lib::ClusterState;
@@ -190,6 +191,63 @@ TEST_F(DistributorBucketSpaceTest, check_available_nodes)
     EXPECT_EQ((std::vector<bool>{true, true, true, true}), bucket_space.get_available_nodes());
 }
 
+namespace {
+
+std::vector<uint16_t> to_vector(IdealServiceLayerNodesBundle::ConstNodesRef nodes) {
+    return {nodes.begin(), nodes.end()};
+}
+
+bool has_node(IdealServiceLayerNodesBundle::ConstNodesRef nodes, uint16_t node) {
+    return std::find(nodes.begin(), nodes.end(), node) != nodes.end();
+}
+
+void expect_same_ideal_nodes(const IdealServiceLayerNodesBundle& expected, const IdealServiceLayerNodesBundle& actual) {
+    EXPECT_EQ(to_vector(expected.available_nodes()), to_vector(actual.available_nodes()));
+    EXPECT_EQ(to_vector(expected.available_nonretired_nodes()), to_vector(actual.available_nonretired_nodes()));
+    EXPECT_EQ(to_vector(expected.available_nonretired_or_maintenance_nodes()),
+              to_vector(actual.available_nonretired_or_maintenance_nodes()));
+}
+
+}
+
+TEST_F(DistributorBucketSpaceTest, ideal_nodes_cache_only_invalidates_buckets_affected_by_node_going_down)
+{
+    bucket_space.setDistribution(distribution_r2);
+    bucket_space.setClusterState(stable_state);
+    auto buckets = make_normal_buckets();
+    std::vector<const IdealServiceLayerNodesBundle*> cached;
+    std::vector<bool> had_node_1;
+    for (const auto& bucket : buckets) {
+        const auto& bundle = bucket_space.get_ideal_service_layer_nodes_bundle(bucket);
+        cached.push_back(&bundle);
+        had_node_1.push_back(has_node(bundle.available_nonretired_or_maintenance_nodes(), 1));
+    }
+    bucket_space.setClusterState(node_1_down_state);
+
+    DistributorBucketSpace expected_space(0u);
+    expected_space.setDistribution(distribution_r2);
+    expected_space.setClusterState(node_1_down_state);
+    uint32_t retained = 0;
+    for (size_t i = 0; i < buckets.size(); ++i) {
+        const auto& bundle = bucket_space.get_ideal_service_layer_nodes_bundle(buckets[i]);
+        expect_same_ideal_nodes(expected_space.get_ideal_service_layer_nodes_bundle(buckets[i]), bundle);
+        if (!had_node_1[i]) {
+            EXPECT_EQ(cached[i], &bundle);
+            ++retained;
+        }
+    }
+    EXPECT_GT(retained, 0u);
+    EXPECT_LT(retained, buckets.size());
+
+    // Node coming back up may take over any bucket
+    bucket_space.setClusterState(stable_state);
+    expected_space.setClusterState(stable_state);
+    for (const auto& bucket : buckets) {
+        expect_same_ideal_nodes(expected_space.get_ideal_service_layer_nodes_bundle(bucket),
+                                bucket_space.get_ideal_service_layer_nodes_bundle(bucket));
+    }
+}
+
 TEST_F(DistributorBucketSpaceTest, check_owned_deep_split_buckets)
 {
     bucket_space.setDistribution(distribution_r1);
@@ -14,6 +14,7 @@
 #include <vespa/storage/distributor/distributor_stripe.h>
 #include <vespa/storage/distributor/distributormetricsset.h>
 #include <vespa/storage/distributor/externaloperationhandler.h>
+#include <vespa/storage/distributor/node_latency_tracker.h>
 #include <vespa/storage/distributor/operations/external/getoperation.h>
 #include <vespa/storageapi/message/persistence.h>
 #include <iomanip>
@@ -26,6 +27,7 @@ using document::test::makeDocumentBucket;
 using document::BucketId;
 using documentapi::TestAndSetCondition;
 using namespace ::testing;
+using namespace std::chrono_literals;
 
 namespace storage::distributor {
 
@@ -55,12 +57,13 @@ struct GetOperationTest : Test, DistributorStripeTestUtil {
         op.reset();
     }
 
-    void start_operation(std::shared_ptr<api::GetCommand> cmd, api::InternalReadConsistency consistency) {
+    void start_operation(std::shared_ptr<api::GetCommand> cmd, api::InternalReadConsistency consistency,
+                         NodeLatencyTracker* latency_tracker = nullptr) {
         op = std::make_unique<GetOperation>(
                 node_context(), getDistributorBucketSpace(),
                 getDistributorBucketSpace().getBucketDatabase().acquire_read_guard(),
                 std::move(cmd), metrics().gets,
-                consistency);
+                consistency, latency_tracker);
         op->start(_sender);
     }
 
@@ -768,5 +771,58 @@ TEST_F(GetOperationTest, trace_is_aggregated_from_all_sub_replies_and_propagated
     EXPECT_THAT(trace_str, HasSubstr("baz"));
 }
 
+TEST_F(GetOperationTest, non_local_replica_with_lowest_observed_latency_is_preferred) {
+    setClusterState("distributor:1 storage:3");
+    addNodesToBucketDB(bucketId, "1=4,2=4");
+
+    NodeLatencyTracker tracker;
+    auto now = getClock().getMonotonicTime();
+    tracker.record(1, 500ms, now);
+    tracker.record(2, 5ms, now);
+
+    auto msg = std::make_shared<api::GetCommand>(makeDocumentBucket(BucketId(0)), docId, document::AllFields::NAME);
+    start_operation(std::move(msg), api::InternalReadConsistency::Strong, &tracker);
+    ASSERT_EQ("Get => 2", _sender.getCommands(true));
+}
+
+TEST_F(GetOperationTest, local_replica_is_preferred_regardless_of_observed_latency) {
+    setClusterState("distributor:1 storage:3");
+    addNodesToBucketDB(bucketId, "1=4,0=4");
+
+    NodeLatencyTracker tracker;
+    auto now = getClock().getMonotonicTime();
+    tracker.record(0, 500ms, now);
+    tracker.record(1, 5ms, now);
+
+    auto msg = std::make_shared<api::GetCommand>(makeDocumentBucket(BucketId(0)), docId, document::AllFields::NAME);
+    start_operation(std::move(msg), api::InternalReadConsistency::Strong, &tracker);
+    ASSERT_EQ("Get => 0", _sender.getCommands(true));
+}
+
+TEST_F(GetOperationTest, reply_latency_is_recorded_for_replica_node) {
+    setClusterState("distributor:1 storage:2");
+    addNodesToBucketDB(bucketId, "1=4");
+
+    NodeLatencyTracker tracker;
+    auto msg = std::make_shared<api::GetCommand>(makeDocumentBucket(BucketId(0)), docId, document::AllFields::NAME);
+    start_operation(std::move(msg), api::InternalReadConsistency::Strong, &tracker);
+    ASSERT_EQ("Get => 1", _sender.getCommands(true));
+
+    getClock().addMilliSecondsToTime(20);
+    ASSERT_NO_FATAL_FAILURE(replyWithDocument());
+    EXPECT_DOUBLE_EQ(0.02, tracker.expected_latency(1, getClock().getMonotonicTime()));
+    EXPECT_DOUBLE_EQ(0.0, tracker.expected_latency(0, getClock().getMonotonicTime()));
+}
+
+TEST(NodeLatencyTrackerTest, expected_latency_decays_with_time_since_last_sample) {
+    NodeLatencyTracker tracker(0.5, 10s);
+    vespalib::steady_time now;
+    tracker.record(3, 100ms, now);
+    EXPECT_DOUBLE_EQ(0.1, tracker.expected_latency(3, now));
+    tracker.record(3, 300ms, now);
+    EXPECT_DOUBLE_EQ(0.2, tracker.expected_latency(3, now));
+    EXPECT_DOUBLE_EQ(0.1, tracker.expected_latency(3, now + 10s));
+    EXPECT_DOUBLE_EQ(0.0, tracker.expected_latency(4, now));
+}
 
 }
@@ -214,7 +214,7 @@ createThread(PersistenceHandler & persistenceHandler,
              FileStorHandler& filestorHandler,
              framework::Component & component)
 {
-    return std::make_unique<PersistenceThread>(persistenceHandler, filestorHandler, 0, component);
+    return std::make_unique<PersistenceThread>(persistenceHandler, filestorHandler, 0, 0, component);
 }
 
 namespace {
@@ -737,6 +737,46 @@ TEST_F(FileStorManagerTest, handler_timeout) {
               static_cast<api::StorageReply&>(*c.top.getReply(0)).getResult().getResult());
 }
 
+TEST_F(FileStorManagerTest, expired_operations_do_not_hold_back_operations_queued_behind_them) {
+    FileStorHandlerComponents c(*this);
+    auto& filestorHandler = *c.filestorHandler;
+    uint32_t stripeId = 0;
+
+    Document::SP doc(createDocument("some content", "id:footype:testdoctype1:n=1234:bar").release());
+    document::BucketIdFactory factory;
+    document::BucketId bucket(16, factory.getBucketId(doc->getId()).getRawId());
+
+    for (uint8_t pri : {0, 10}) {
+        auto cmd = std::make_shared<api::PutCommand>(makeDocumentBucket(bucket), doc, 100);
+        cmd->setAddress(_storage3);
+        cmd->setPriority(pri);
+        cmd->setTimeout(50ms);
+        filestorHandler.schedule(cmd);
+    }
+    {
+        auto cmd = std::make_shared<api::PutCommand>(makeDocumentBucket(bucket), doc, 100);
+        cmd->setAddress(_storage3);
+        cmd->setPriority(200);
+        cmd->setTimeout(10000ms);
+        filestorHandler.schedule(cmd);
+    }
+
+    std::this_thread::sleep_for(51ms);
+    // A single poll skips past both expired operations
+    auto lock = filestorHandler.getNextMessage(stripeId);
+    ASSERT_TRUE(lock.lock.get() != nullptr);
+    EXPECT_EQ(200, lock.msg->getPriority());
+
+    ASSERT_EQ(2, c.top.getNumReplies());
+    for (uint32_t i = 0; i < 2; ++i) {
+        EXPECT_EQ(api::ReturnCode::TIMEOUT,
+                  static_cast<api::StorageReply&>(*c.top.getReply(i)).getResult().getResult());
+    }
+    EXPECT_EQ(2, c.metrics.stripes[0]->expired_in_queue.getValue());
+    EXPECT_EQ(1, c.metrics.stripes[0]->queue_wait_low_pri.getCount());
+    EXPECT_EQ(0, c.metrics.stripes[0]->queue_wait_high_pri.getCount());
+}
+
 TEST_F(FileStorManagerTest, priority) {
     FileStorHandlerComponents c(*this, 2);
     auto& filestorHandler = *c.filestorHandler;
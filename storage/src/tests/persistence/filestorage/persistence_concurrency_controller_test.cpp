@@ -0,0 +1,74 @@
+// Copyright Vespa.ai. Licensed under the terms of the Apache 2.0 license. See LICENSE in the project root.
+
+#include <vespa/storage/persistence/filestorage/persistence_concurrency_controller.h>
+#include <vespa/vespalib/gtest/gtest.h>
+
+using namespace ::testing;
+
+namespace storage {
+
+namespace {
+
+PersistenceConcurrencyController::Sample sample(double throughput, double queue_wait_ms, double cpu_util) {
+    return {throughput, queue_wait_ms, cpu_util};
+}
+
+}
+
+struct PersistenceConcurrencyControllerTest : Test {
+    PersistenceConcurrencyController::Params params;
+    PersistenceConcurrencyController controller;
+
+    PersistenceConcurrencyControllerTest()
+        : params(2, 8),
+          controller(params)
+    {}
+};
+
+TEST_F(PersistenceConcurrencyControllerTest, all_threads_are_initially_active) {
+    EXPECT_EQ(controller.active_threads(), 8u);
+}
+
+TEST_F(PersistenceConcurrencyControllerTest, cpu_saturation_removes_threads_down_to_minimum) {
+    for (uint32_t expected : {7u, 6u, 5u, 4u, 3u, 2u, 2u}) {
+        EXPECT_EQ(controller.on_sample(sample(1000, 10.0, 0.95)), expected);
+    }
+}
+
+TEST_F(PersistenceConcurrencyControllerTest, queueing_adds_threads_up_to_maximum_while_throughput_improves) {
+    for (int i = 0; i < 3; ++i) {
+        (void)controller.on_sample(sample(1000, 10.0, 0.95));
+    }
+    ASSERT_EQ(controller.active_threads(), 5u);
+    EXPECT_EQ(controller.on_sample(sample(1000, 10.0, 0.5)), 6u);
+    EXPECT_EQ(controller.on_sample(sample(1200, 10.0, 0.5)), 7u);
+    EXPECT_EQ(controller.on_sample(sample(1400, 10.0, 0.5)), 8u);
+    EXPECT_EQ(controller.on_sample(sample(1600, 10.0, 0.5)), 8u);
+}
+
+TEST_F(PersistenceConcurrencyControllerTest, thread_is_removed_again_if_it_did_not_improve_throughput) {
+    for (int i = 0; i < 3; ++i) {
+        (void)controller.on_sample(sample(1000, 10.0, 0.95));
+    }
+    EXPECT_EQ(controller.on_sample(sample(1000, 10.0, 0.5)), 6u);
+    EXPECT_EQ(controller.on_sample(sample(1010, 10.0, 0.5)), 5u);
+    // Growth is held off for a few periods before probing again
+    for (uint32_t i = 1; i < params.hold_periods_after_revert; ++i) {
+        EXPECT_EQ(controller.on_sample(sample(1010, 10.0, 0.5)), 5u);
+    }
+    EXPECT_EQ(controller.on_sample(sample(1010, 10.0, 0.5)), 6u);
+}
+
+TEST_F(PersistenceConcurrencyControllerTest, threads_are_not_added_without_queueing) {
+    (void)controller.on_sample(sample(1000, 10.0, 0.95));
+    EXPECT_EQ(controller.on_sample(sample(1000, 0.1, 0.5)), 7u);
+    EXPECT_EQ(controller.on_sample(sample(1000, 0.1, 0.5)), 7u);
+}
+
+TEST_F(PersistenceConcurrencyControllerTest, reset_makes_all_threads_active) {
+    (void)controller.on_sample(sample(1000, 10.0, 0.95));
+    controller.reset();
+    EXPECT_EQ(controller.active_threads(), 8u);
+}
+
+}
@@ -172,6 +172,16 @@ struct MergeHandlerTest : PersistenceTestUtils {
         return MergeHandler(getEnv(), getPersistenceProvider(),
                             getEnv()._component.cluster_context(), getEnv()._component.getClock(), *_sequenceTaskExecutor, maxChunkSize, 64);
     }
+    MergeHandler createRangeDigestHandler() {
+        return MergeHandler(getEnv(), getPersistenceProvider(),
+                            getEnv()._component.cluster_context(), getEnv()._component.getClock(), *_sequenceTaskExecutor, 4190208, 64, 1);
+    }
+    std::shared_ptr<api::GetBucketDiffCommand> startRangeDigestMerge(MergeHandler& handler);
+    MergeHandler createAdaptiveChunkHandler(size_t maxChunkSize, size_t adaptiveMaxChunkSize) {
+        return MergeHandler(getEnv(), getPersistenceProvider(),
+                            getEnv()._component.cluster_context(), getEnv()._component.getClock(), *_sequenceTaskExecutor,
+                            maxChunkSize, 64, 0, adaptiveMaxChunkSize, 500ms);
+    }
     MergeHandler createHandler(spi::PersistenceProvider & spi) {
         return MergeHandler(getEnv(), spi,
                             getEnv()._component.cluster_context(), getEnv()._component.getClock(), *_sequenceTaskExecutor, 4190208, 64);
@@ -299,6 +309,109 @@ TEST_F(MergeHandlerTest, get_bucket_diff_end_of_chain) {
     testGetBucketDiffChain(false);
 }
 
+std::shared_ptr<api::GetBucketDiffCommand>
+MergeHandlerTest::startRangeDigestMerge(MergeHandler& handler)
+{
+    auto cmd = std::make_shared<api::MergeBucketCommand>(_bucket, _nodes, _maxTimestamp);
+    handler.handleMergeBucket(*cmd, createTracker(cmd, _bucket));
+    EXPECT_EQ(1, messageKeeper()._msgs.size());
+    auto cmd2 = std::dynamic_pointer_cast<api::GetBucketDiffCommand>(messageKeeper()._msgs.back());
+    EXPECT_TRUE(cmd2);
+    return cmd2;
+}
+
+TEST_F(MergeHandlerTest, range_digest_completes_merge_when_all_ranges_are_equal) {
+    MergeHandler handler = createRangeDigestHandler();
+    auto cmd2 = startRangeDigestMerge(handler);
+    ASSERT_TRUE(cmd2);
+    EXPECT_TRUE(cmd2->isRangeDigest());
+    EXPECT_EQ(64, cmd2->getRangeChecksums().size());
+    EXPECT_EQ(0, cmd2->getRangeMask());
+    EXPECT_EQ(0, cmd2->getDiff().size());
+
+    auto reply = std::make_shared<api::GetBucketDiffReply>(*cmd2);
+    reply->setDifferingRanges(0);
+    MessageSenderStub stub;
+    handler.handleGetBucketDiffReply(*reply, stub);
+    EXPECT_EQ(0, stub.commands.size());
+    ASSERT_EQ(1, stub.replies.size());
+    EXPECT_EQ(api::MessageType::MERGEBUCKET_REPLY, stub.replies[0]->getType());
+    EXPECT_TRUE(stub.replies[0]->getResult().success());
+    EXPECT_FALSE(getEnv()._fileStorHandler.isMerging(_bucket));
+}
+
+TEST_F(MergeHandlerTest, range_digest_sends_diff_for_differing_ranges_only) {
+    MergeHandler handler = createRangeDigestHandler();
+    auto cmd2 = startRangeDigestMerge(handler);
+    ASSERT_TRUE(cmd2);
+    uint64_t ranges = 0;
+    for (uint32_t i = 0; i < cmd2->getRangeChecksums().size(); i += 2) {
+        if (cmd2->getRangeChecksums()[i] != 0) {
+            ranges |= (uint64_t(1) << i);
+        }
+    }
+    ASSERT_NE(0, ranges);
+
+    auto reply = std::make_shared<api::GetBucketDiffReply>(*cmd2);
+    reply->setDifferingRanges(ranges);
+    MessageSenderStub stub;
+    handler.handleGetBucketDiffReply(*reply, stub);
+    EXPECT_EQ(0, stub.replies.size());
+    ASSERT_EQ(1, stub.commands.size());
+    auto& cmd3 = dynamic_cast<api::GetBucketDiffCommand&>(*stub.commands[0]);
+    EXPECT_FALSE(cmd3.isRangeDigest());
+    EXPECT_EQ(ranges, cmd3.getRangeMask());
+    EXPECT_GT(cmd3.getDiff().size(), 0);
+    EXPECT_LT(cmd3.getDiff().size(), 17);
+}
+
+TEST_F(MergeHandlerTest, range_digest_falls_back_to_full_diff_if_ranges_were_not_compared) {
+    MergeHandler handler = createRangeDigestHandler();
+    auto cmd2 = startRangeDigestMerge(handler);
+    ASSERT_TRUE(cmd2);
+
+    auto reply = std::make_shared<api::GetBucketDiffReply>(*cmd2);
+    MessageSenderStub stub;
+    handler.handleGetBucketDiffReply(*reply, stub);
+    ASSERT_EQ(1, stub.commands.size());
+    auto& cmd3 = dynamic_cast<api::GetBucketDiffCommand&>(*stub.commands[0]);
+    EXPECT_EQ(api::GetBucketDiffCommand::ALL_RANGES, cmd3.getRangeMask());
+    EXPECT_EQ(17, cmd3.getDiff().size());
+}
+
+TEST_F(MergeHandlerTest, range_digest_end_of_chain_reports_differing_ranges) {
+    std::vector<uint64_t> checksums;
+    {
+        MergeHandler handler = createRangeDigestHandler();
+        auto cmd2 = startRangeDigestMerge(handler);
+        ASSERT_TRUE(cmd2);
+        checksums = cmd2->getRangeChecksums();
+        getEnv()._fileStorHandler.clearMergeStatus(_bucket);
+    }
+    setUpChain(BACK);
+    MergeHandler handler = createHandler();
+
+    auto cmd = std::make_shared<api::GetBucketDiffCommand>(_bucket, _nodes, _maxTimestamp);
+    cmd->getRangeChecksums() = checksums;
+    cmd->setRangeMask(0x4);
+    auto reply = std::dynamic_pointer_cast<api::GetBucketDiffReply>(
+            std::move(*handler.handleGetBucketDiff(*cmd, createTracker(cmd, _bucket))).stealReplySP());
+    ASSERT_TRUE(reply);
+    EXPECT_TRUE(reply->rangesCompared());
+    EXPECT_EQ(0x4, reply->getDifferingRanges());
+    EXPECT_EQ(0, reply->getDiff().size());
+
+    checksums[5] += 1;
+    cmd = std::make_shared<api::GetBucketDiffCommand>(_bucket, _nodes, _maxTimestamp);
+    cmd->getRangeChecksums() = checksums;
+    cmd->setRangeMask(0);
+    reply = std::dynamic_pointer_cast<api::GetBucketDiffReply>(
+            std::move(*handler.handleGetBucketDiff(*cmd, createTracker(cmd, _bucket))).stealReplySP());
+    ASSERT_TRUE(reply);
+    EXPECT_TRUE(reply->rangesCompared());
+    EXPECT_EQ(0x20, reply->getDifferingRanges());
+}
+
 // Test that a simplistic merge with 1 doc to actually merge,
 // sends apply bucket diff through the entire chain of 3 nodes.
 void
@@ -510,6 +623,56 @@ TEST_F(MergeHandlerTest, chunked_apply_bucket_diff) {
     EXPECT_TRUE(reply->getResult().success());
 }
 
+TEST_F(MergeHandlerTest, adaptive_chunk_size_grows_while_rounds_are_fast) {
+    uint32_t docSize = 1024;
+    uint32_t docCount = 20;
+    uint32_t maxChunkSize = docSize * 3;
+    for (uint32_t i = 0; i < docCount; ++i) {
+        doPut(1234, spi::Timestamp(4000 + i), docSize, docSize);
+    }
+
+    MergeHandler handler = createAdaptiveChunkHandler(maxChunkSize, maxChunkSize * 4);
+
+    auto cmd = std::make_shared<api::MergeBucketCommand>(_bucket, _nodes, _maxTimestamp);
+    handler.handleMergeBucket(*cmd, createTracker(cmd, _bucket));
+
+    auto getBucketDiffCmd = fetchSingleMessage<api::GetBucketDiffCommand>();
+    auto getBucketDiffReply = std::make_unique<api::GetBucketDiffReply>(*getBucketDiffCmd);
+    handler.handleGetBucketDiffReply(*getBucketDiffReply, messageKeeper());
+
+    // Rounds complete instantly with the fake clock, so the chunk size is
+    // doubled after each round bounded by it, up to the adaptive max.
+    std::vector<uint32_t> chunkSizes;
+    api::MergeBucketReply::SP reply;
+    while (!reply) {
+        auto applyBucketDiffCmd = fetchSingleMessage<api::ApplyBucketDiffCommand>();
+        ASSERT_TRUE(applyBucketDiffCmd);
+        chunkSizes.push_back(applyBucketDiffCmd->getMaxChunkSize());
+        auto& diff = applyBucketDiffCmd->getDiff();
+        uint32_t effectiveChunkSize = (chunkSizes.back() != 0) ? chunkSizes.back() : maxChunkSize;
+        ASSERT_LE(getFilledDataSize(diff), effectiveChunkSize);
+        for (auto& e : diff) {
+            if (e.filled()) {
+                e._entry._hasMask |= 2u;
+            }
+        }
+        auto applyBucketDiffReply = std::make_shared<api::ApplyBucketDiffReply>(*applyBucketDiffCmd);
+        EXPECT_EQ(applyBucketDiffCmd->getMaxChunkSize(), applyBucketDiffReply->getMaxChunkSize());
+        handler.handleApplyBucketDiffReply(*applyBucketDiffReply, messageKeeper(), createTracker(applyBucketDiffReply, _bucket));
+        if (!messageKeeper()._msgs.empty()) {
+            reply = std::dynamic_pointer_cast<api::MergeBucketReply>(messageKeeper()._msgs.back());
+        }
+    }
+    ASSERT_GE(chunkSizes.size(), 3u);
+    EXPECT_EQ(0u, chunkSizes[0]);
+    EXPECT_EQ(maxChunkSize * 2, chunkSizes[1]);
+    EXPECT_EQ(maxChunkSize * 4, chunkSizes[2]);
+    for (size_t i = 3; i < chunkSizes.size(); ++i) {
+        EXPECT_EQ(maxChunkSize * 4, chunkSizes[i]);
+    }
+    EXPECT_TRUE(reply->getResult().success());
+}
+
 TEST_F(MergeHandlerTest, chunk_limit_partially_filled_diff) {
     setUpChain(FRONT);
 
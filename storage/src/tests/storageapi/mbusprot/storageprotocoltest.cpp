@@ -685,6 +685,34 @@ TEST_P(StorageProtocolTest, get_bucket_diff) {
     EXPECT_EQ(nodes, reply2->getNodes());
     EXPECT_EQ(entries, reply2->getDiff());
     EXPECT_EQ(Timestamp(1056), reply2->getMaxTimestamp());
+    EXPECT_FALSE(reply2->rangesCompared());
+    EXPECT_EQ(GetBucketDiffCommand::ALL_RANGES, cmd2->getRangeMask());
+}
+
+TEST_P(StorageProtocolTest, get_bucket_diff_with_ranges) {
+    std::vector<api::MergeBucketCommand::Node> nodes;
+    nodes.push_back(4);
+    nodes.push_back(13);
+
+    auto digest = std::make_shared<GetBucketDiffCommand>(_bucket, nodes, 1056);
+    digest->getRangeChecksums() = {1, 2, 0xfedcba9876543210};
+    digest->setRangeMask(0);
+    auto digest2 = copyCommand(digest);
+    EXPECT_TRUE(digest2->isRangeDigest());
+    EXPECT_EQ(digest->getRangeChecksums(), digest2->getRangeChecksums());
+    EXPECT_EQ(0u, digest2->getRangeMask());
+
+    auto reply = std::make_shared<GetBucketDiffReply>(*digest2);
+    reply->setDifferingRanges(0x8000000000000001);
+    auto reply2 = copyReply(reply);
+    EXPECT_TRUE(reply2->rangesCompared());
+    EXPECT_EQ(0x8000000000000001u, reply2->getDifferingRanges());
+
+    auto cmd = std::make_shared<GetBucketDiffCommand>(_bucket, nodes, 1056);
+    cmd->setRangeMask(0x10);
+    auto cmd2 = copyCommand(cmd);
+    EXPECT_FALSE(cmd2->isRangeDigest());
+    EXPECT_EQ(0x10u, cmd2->getRangeMask());
 }
 
 namespace {
@@ -44,6 +44,7 @@ struct BouncerTest : public Test {
     // Note: newThreshold is intentionally int (rather than Priority) in order
     // to be able to test out of bounds values.
     void configureRejectionThreshold(int newThreshold);
+    void configure_overload_latency_threshold(uint32_t threshold_ms);
 
     std::shared_ptr<api::StorageCommand> createDummyFeedMessage(
             api::Timestamp timestamp,
@@ -396,5 +397,59 @@ TEST_F(BouncerTest, replies_are_swallowed_after_close) {
     EXPECT_EQ(0, _lower->getNumReplies());
 }
 
+void
+BouncerTest::configure_overload_latency_threshold(uint32_t threshold_ms)
+{
+    using Builder = vespa::config::content::core::StorBouncerConfigBuilder;
+    Builder config;
+    config.overloadLatencyThresholdMs = threshold_ms;
+    config.overloadLatencyWindowMs = 1000;
+    config.overloadSheddingPriorityThreshold = Priority(120);
+    _manager->on_configure(config);
+}
+
+TEST_F(BouncerTest, low_priority_feed_is_shed_while_pending_operations_exceed_latency_threshold) {
+    configure_overload_latency_threshold(100);
+    _upper->sendDown(createDummyFeedMessage(11 * 1000000, Priority(200)));
+    expectMessageNotBounced();
+    _lower->reset();
+    // The first operation is never replied to, so it ages past the threshold.
+    _node->getClock().addMilliSecondsToTime(2000);
+    _upper->sendDown(createDummyFeedMessage(11 * 1000000, Priority(200)));
+    ASSERT_EQ(1, _upper->getNumReplies());
+    EXPECT_EQ(api::ReturnCode::BUSY,
+              dynamic_cast<api::RemoveReply&>(*_upper->getReply(0)).getResult().getResult());
+    EXPECT_EQ(0, _lower->getNumCommands());
+    EXPECT_EQ(1, _manager->metrics().overload_rejects.getValue());
+    _upper->reset();
+    // Higher prioritized feed is still let through
+    _upper->sendDown(createDummyFeedMessage(11 * 1000000, Priority(100)));
+    expectMessageNotBounced();
+}
+
+TEST_F(BouncerTest, feed_is_not_shed_when_operations_complete_within_latency_threshold) {
+    configure_overload_latency_threshold(100);
+    for (int i = 0; i < 3; ++i) {
+        _upper->sendDown(createDummyFeedMessage(11 * 1000000, Priority(200)));
+        expectMessageNotBounced();
+        auto cmd = std::dynamic_pointer_cast<api::StorageCommand>(_lower->getCommand(0));
+        _lower->reset();
+        _node->getClock().addMilliSecondsToTime(10);
+        _lower->sendUp(std::shared_ptr<api::StorageReply>(cmd->makeReply()));
+        _upper->reset();
+        _node->getClock().addMilliSecondsToTime(1000);
+    }
+    EXPECT_EQ(0, _manager->metrics().overload_rejects.getValue());
+}
+
+TEST_F(BouncerTest, overload_shedding_is_disabled_by_default_in_config) {
+    _upper->sendDown(createDummyFeedMessage(11 * 1000000, Priority(200)));
+    expectMessageNotBounced();
+    _lower->reset();
+    _node->getClock().addMilliSecondsToTime(60000);
+    _upper->sendDown(createDummyFeedMessage(11 * 1000000, Priority(255)));
+    expectMessageNotBounced();
+}
+
 } // storage
 
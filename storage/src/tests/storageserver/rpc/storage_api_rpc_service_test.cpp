@@ -12,6 +12,7 @@
 #include <vespa/slobrok/sbmirror.h>
 #include <vespa/storage/storageserver/communicationmanager.h>
 #include <vespa/storage/storageserver/message_dispatcher.h>
+#include <vespa/storage/storageserver/rpc/batched_rpc_request.h>
 #include <vespa/storage/storageserver/rpc/caching_rpc_target_resolver.h>
 #include <vespa/storage/storageserver/rpc/message_codec_provider.h>
 #include <vespa/storage/storageserver/rpc/shared_rpc_resources.h>
@@ -25,6 +26,7 @@
 #include <condition_variable>
 #include <deque>
 #include <functional>
+#include <map>
 #include <memory>
 #include <mutex>
 #include <stdexcept>
@@ -147,10 +149,10 @@ RpcNode::~RpcNode() = default;
 class StorageApiNode : public RpcNode {
     std::unique_ptr<StorageApiRpcService> _service;
 public:
-    StorageApiNode(uint16_t node_index, bool is_distributor, const mbus::Slobrok& slobrok)
+    StorageApiNode(uint16_t node_index, bool is_distributor, const mbus::Slobrok& slobrok,
+                   const StorageApiRpcService::Params& params = StorageApiRpcService::Params())
         : RpcNode(node_index, is_distributor, slobrok)
     {
-        StorageApiRpcService::Params params;
         _service = std::make_unique<StorageApiRpcService>(_messages, *_shared_rpc_resources, *_codec_provider, params);
 
         _shared_rpc_resources->start_server_and_register_slobrok(_slobrok_id);
@@ -159,6 +161,8 @@ public:
     }
     ~StorageApiNode();
 
+    StorageApiRpcService& service() noexcept { return *_service; }
+
     std::shared_ptr<api::PutCommand> create_dummy_put_command() const {
         auto doc_type = _doc_type_repo->getDocumentType("testdoctype1");
         auto doc = std::make_shared<document::Document>(*_doc_type_repo, *doc_type, document::DocumentId("id:foo:testdoctype1::bar"));
@@ -186,10 +190,23 @@ public:
         std::unique_ptr<StorageTransportContext> context(dynamic_cast<StorageTransportContext*>(
                 reply->getTransportContext().release()));
         assert(context);
+        if (context->_batched_reply) {
+            _service->encode_rpc_v1_batched_response(*context->_batched_reply, *reply);
+            return;
+        }
         _service->encode_rpc_v1_response(*context->_request->raw_request(), *reply);
         context->_request->returnRequest();
     }
 
+    [[nodiscard]] std::vector<std::shared_ptr<api::StorageMessage>> wait_and_receive_n_messages(size_t n) {
+        _messages.wait_until_n_messages_received(n);
+        std::vector<std::shared_ptr<api::StorageMessage>> msgs;
+        for (size_t i = 0; i < n; ++i) {
+            msgs.emplace_back(_messages.pop_first_message());
+        }
+        return msgs;
+    }
+
     [[nodiscard]] std::shared_ptr<api::StorageMessage> wait_and_receive_single_message() {
         _messages.wait_until_n_messages_received(1);
         return _messages.pop_first_message();
@@ -224,8 +241,12 @@ struct StorageApiRpcServiceTest : Test {
     std::unique_ptr<StorageApiNode> _node_1;
 
     StorageApiRpcServiceTest()
+        : StorageApiRpcServiceTest(StorageApiRpcService::Params())
+    {
+    }
+    explicit StorageApiRpcServiceTest(const StorageApiRpcService::Params& sender_params)
         : _slobrok(),
-          _node_0(std::make_unique<StorageApiNode>(1, true, _slobrok)),
+          _node_0(std::make_unique<StorageApiNode>(1, true, _slobrok, sender_params)),
           _node_1(std::make_unique<StorageApiNode>(4, false, _slobrok))
     {
         // FIXME ugh, this isn't particularly pretty...
@@ -387,4 +408,103 @@ TEST_F(StorageApiRpcServiceTest, trace_events_are_emitted_for_send_and_receive)
                                          "Response received at"));
 }
 
+namespace {
+
+StorageApiRpcService::Params batching_params(size_t max_batch_size, vespalib::duration window) {
+    StorageApiRpcService::Params params;
+    params.max_batch_size = max_batch_size;
+    params.batch_window = window;
+    return params;
+}
+
+}
+
+struct StorageApiRpcServiceBatchingTest : StorageApiRpcServiceTest {
+    // Long window, so batches are only sent once full
+    StorageApiRpcServiceBatchingTest() : StorageApiRpcServiceTest(batching_params(3, 600s)) {}
+    ~StorageApiRpcServiceBatchingTest() override;
+
+    std::shared_ptr<api::PutCommand> make_put_to_node_1() {
+        auto cmd = _node_0->create_dummy_put_command();
+        cmd->setAddress(_node_1->node_address());
+        return cmd;
+    }
+};
+
+StorageApiRpcServiceBatchingTest::~StorageApiRpcServiceBatchingTest() = default;
+
+TEST_F(StorageApiRpcServiceBatchingTest, batched_requests_get_individual_replies_in_any_order) {
+    std::vector<std::shared_ptr<api::PutCommand>> sent;
+    for (int i = 0; i < 3; ++i) {
+        sent.emplace_back(make_put_to_node_1());
+        sent.back()->setTimeout(std::chrono::seconds(100 + i));
+        _node_0->send_request_verify_not_bounced(sent.back());
+    }
+    auto received = _node_1->wait_and_receive_n_messages(3);
+    for (size_t i = 0; i < received.size(); ++i) {
+        auto* put = dynamic_cast<api::PutCommand*>(received[i].get());
+        ASSERT_TRUE(put != nullptr);
+        EXPECT_EQ(put->getTimeout(), std::chrono::seconds(100 + i));
+    }
+    // Reply out of order; nothing is returned to the sender before the last reply
+    for (size_t i = received.size(); i > 0; --i) {
+        auto& cmd = dynamic_cast<api::PutCommand&>(*received[i - 1]);
+        auto reply = std::shared_ptr<api::StorageReply>(cmd.makeReply());
+        if (i == 2) {
+            reply->setResult(api::ReturnCode(api::ReturnCode::TIMESTAMP_EXIST, "oh no"));
+        }
+        _node_1->send_response(reply);
+    }
+    auto replies = _node_0->wait_and_receive_n_messages(3);
+    std::map<api::StorageMessage::Id, std::shared_ptr<api::StorageMessage>> by_id;
+    for (auto& r : replies) {
+        ASSERT_TRUE(dynamic_cast<api::PutReply*>(r.get()) != nullptr);
+        by_id[r->getMsgId()] = r;
+    }
+    ASSERT_EQ(by_id.size(), 3u);
+    for (size_t i = 0; i < sent.size(); ++i) {
+        ASSERT_TRUE(by_id.contains(sent[i]->getMsgId()));
+        auto& reply = dynamic_cast<api::PutReply&>(*by_id[sent[i]->getMsgId()]);
+        if (i == 1) {
+            EXPECT_EQ(reply.getResult(), api::ReturnCode(api::ReturnCode::TIMESTAMP_EXIST, "oh no"));
+        } else {
+            EXPECT_TRUE(reply.getResult().success());
+        }
+    }
+}
+
+TEST_F(StorageApiRpcServiceBatchingTest, non_batchable_requests_are_sent_immediately) {
+    auto cmd = std::make_shared<api::GetCommand>(makeDocumentBucket(document::BucketId(0)),
+                                                 document::DocumentId("id:foo:testdoctype1::bar"), "[all]");
+    cmd->setAddress(_node_1->node_address());
+    _node_0->send_request_verify_not_bounced(cmd);
+    auto recv_msg = _node_1->wait_and_receive_single_message();
+    EXPECT_TRUE(dynamic_cast<api::GetCommand*>(recv_msg.get()) != nullptr);
+}
+
+TEST_F(StorageApiRpcServiceBatchingTest, pending_batches_can_be_explicitly_flushed) {
+    _node_0->send_request_verify_not_bounced(make_put_to_node_1());
+    _node_0->send_request_verify_not_bounced(make_put_to_node_1());
+    _node_0->service().flush_pending_batches();
+    auto received = _node_1->wait_and_receive_n_messages(2);
+    for (auto& msg : received) {
+        _node_1->send_response(std::shared_ptr<api::StorageReply>(dynamic_cast<api::PutCommand&>(*msg).makeReply()));
+    }
+    auto replies = _node_0->wait_and_receive_n_messages(2);
+    EXPECT_NE(replies[0]->getMsgId(), replies[1]->getMsgId());
+}
+
+struct StorageApiRpcServiceBatchWindowTest : StorageApiRpcServiceTest {
+    StorageApiRpcServiceBatchWindowTest() : StorageApiRpcServiceTest(batching_params(100, 1ms)) {}
+    ~StorageApiRpcServiceBatchWindowTest() override;
+};
+
+StorageApiRpcServiceBatchWindowTest::~StorageApiRpcServiceBatchWindowTest() = default;
+
+TEST_F(StorageApiRpcServiceBatchWindowTest, partial_batch_is_sent_when_batch_window_expires) {
+    auto recv_cmd = send_and_receive_put_command_at_node_1();
+    auto recv_reply = respond_and_receive_put_reply_at_node_0(recv_cmd);
+    EXPECT_TRUE(recv_reply->getResult().success());
+}
+
 }
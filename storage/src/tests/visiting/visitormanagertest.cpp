@@ -264,6 +264,15 @@ VisitorManagerTest::getMessagesAndReply(
             case documentapi::DocumentProtocol::MESSAGE_REMOVEDOCUMENT:
                 docIds.push_back(dynamic_cast<documentapi::RemoveDocumentMessage&>(*session.sentMessages[i]).getDocumentId());
                 break;
+            case documentapi::DocumentProtocol::MESSAGE_DOCUMENTLIST:
+                for (auto& entry : dynamic_cast<documentapi::DocumentListMessage&>(*session.sentMessages[i]).getDocuments()) {
+                    if (entry.isRemoveEntry()) {
+                        docIds.push_back(entry.getDocument()->getId());
+                    } else {
+                        docs.push_back(entry.getDocument());
+                    }
+                }
+                break;
             default:
                 break;
             }
@@ -483,6 +492,38 @@ TEST_F(VisitorManagerTest, visit_puts_and_removes) {
               docIds.size());
 }
 
+TEST_F(VisitorManagerTest, visit_puts_and_removes_in_batches) {
+    ASSERT_NO_FATAL_FAILURE(initializeTest());
+    addSomeRemoves();
+    auto cmd = std::make_shared<api::CreateVisitorCommand>(makeBucketSpace(), "DumpVisitor", "testvis", "");
+    cmd->setAddress(_address);
+    cmd->setVisitRemoves();
+    cmd->getParameters().set("maxbytesperbatch", "1000000");
+    for (uint32_t i=0; i<10; ++i) {
+        cmd->addBucketToBeVisited(document::BucketId(16, i));
+    }
+    _top->sendDown(cmd);
+    std::vector<document::Document::SP> docs;
+    std::vector<document::DocumentId> docIds;
+
+    TestVisitorMessageSession& session = getSession(0);
+    session.waitForMessages(1);
+    {
+        std::lock_guard guard(session.getMonitor());
+        EXPECT_EQ(documentapi::DocumentProtocol::MESSAGE_DOCUMENTLIST, session.sentMessages[0]->getType());
+    }
+    // One document list message per bucket
+    getMessagesAndReply(10, session, docs, docIds);
+
+    ASSERT_NO_FATAL_FAILURE(verifyCreateVisitorReply(api::ReturnCode::OK));
+
+    EXPECT_EQ(docCount - (docCount + 3) / 4,
+              getMatchingDocuments(docs));
+
+    EXPECT_EQ((docCount + 3) / 4,
+              docIds.size());
+}
+
 TEST_F(VisitorManagerTest, visit_with_timeframe_and_selection) {
     ASSERT_NO_FATAL_FAILURE(initializeTest());
     auto cmd = std::make_shared<api::CreateVisitorCommand>(makeBucketSpace(), "DumpVisitor", "testvis", "testdoctype1.headerval < 2");
@@ -11,6 +11,7 @@
 #include <functional>
 #include <iosfwd>
 #include <map>
+#include <optional>
 
 namespace storage::bucketdb {
 
@@ -202,6 +203,17 @@ public:
         return do_acquire_read_guard();
     }
 
+    /**
+     * Returns a copy of the entry stored for the given bucket key, if any,
+     * without taking the database mutex or the bucket lock. The value is read
+     * from a snapshot and may be stale by the time it is inspected, so it must
+     * only be used as a basis for a write if the caller otherwise ensures that
+     * nobody else can modify the bucket (e.g. by holding its persistence lock).
+     */
+    [[nodiscard]] std::optional<ValueT> get_snapshot(const key_type& key) const {
+        return do_get_snapshot(key);
+    }
+
     [[nodiscard]] virtual size_type size() const noexcept = 0;
     [[nodiscard]] virtual size_type getMemoryUsage() const noexcept = 0;
     [[nodiscard]] virtual vespalib::MemoryUsage detailed_memory_usage() const noexcept = 0;
@@ -217,6 +229,7 @@ private:
     virtual void do_for_each_mutable_unordered(std::function<Decision(uint64_t, ValueT&)> func, const char* clientId) = 0;
     virtual void do_for_each(std::function<Decision(uint64_t, const ValueT&)> func, const char* clientId) = 0;
     virtual std::unique_ptr<bucketdb::ReadGuard<ValueT>> do_acquire_read_guard() const = 0;
+    virtual std::optional<ValueT> do_get_snapshot(const key_type& key) const = 0;
 };
 
 template <typename ValueT>
@@ -222,6 +222,7 @@ public:
     explicit ReadGuardImpl(const BTreeBucketDatabase& db);
     ~ReadGuardImpl() override;
 
+    [[nodiscard]] std::optional<Entry> find(const document::BucketId& bucket) const override;
     std::vector<Entry> find_parents_and_self(const document::BucketId& bucket) const override;
     std::vector<Entry> find_parents_self_and_children(const document::BucketId& bucket) const override;
     void for_each(std::function<void(uint64_t, const Entry&)> func) const override;
@@ -235,6 +236,11 @@ BTreeBucketDatabase::ReadGuardImpl::ReadGuardImpl(const BTreeBucketDatabase& db)
 
 BTreeBucketDatabase::ReadGuardImpl::~ReadGuardImpl() = default;
 
+std::optional<Entry>
+BTreeBucketDatabase::ReadGuardImpl::find(const document::BucketId& bucket) const {
+    return _snapshot.find(bucket);
+}
+
 std::vector<Entry>
 BTreeBucketDatabase::ReadGuardImpl::find_parents_and_self(const document::BucketId& bucket) const {
     std::vector<Entry> entries;
@@ -126,6 +126,7 @@ private:
                              uint32_t chunk_size) override;
 
     std::unique_ptr<ReadGuard<T>> do_acquire_read_guard() const override;
+    std::optional<T> do_get_snapshot(const key_type& key) const override;
 
     /**
      * Process up to `chunk_size` bucket database entries from--and possibly
@@ -314,6 +314,7 @@ public:
     explicit ReadGuardImpl(const BTreeLockableMap<T>& db);
     ~ReadGuardImpl() override;
 
+    [[nodiscard]] std::optional<T> find(const document::BucketId& bucket) const override;
     std::vector<T> find_parents_and_self(const document::BucketId& bucket) const override;
     std::vector<T> find_parents_self_and_children(const document::BucketId& bucket) const override;
     void for_each(std::function<void(uint64_t, const T&)> func) const override;
@@ -329,6 +330,12 @@ BTreeLockableMap<T>::ReadGuardImpl::ReadGuardImpl(const BTreeLockableMap<T>& db)
 template <typename T>
 BTreeLockableMap<T>::ReadGuardImpl::~ReadGuardImpl() = default;
 
+template <typename T>
+std::optional<T>
+BTreeLockableMap<T>::ReadGuardImpl::find(const document::BucketId& bucket) const {
+    return _snapshot.find(bucket);
+}
+
 template <typename T>
 std::vector<T>
 BTreeLockableMap<T>::ReadGuardImpl::find_parents_and_self(const document::BucketId& bucket) const {
@@ -374,6 +381,13 @@ std::unique_ptr<ReadGuard<T>> BTreeLockableMap<T>::do_acquire_read_guard() const
     return std::make_unique<ReadGuardImpl>(*this);
 }
 
+template <typename T>
+std::optional<T> BTreeLockableMap<T>::do_get_snapshot(const key_type& key) const {
+    // Only pins the current tree generation; neither _lock nor any bucket lock is taken.
+    typename ImplType::ReadSnapshot snapshot(*_impl);
+    return snapshot.find(BucketId(BucketId::keyToBucketId(key)));
+}
+
 template <typename T>
 void BTreeLockableMap<T>::print(std::ostream& out, bool verbose,
                                 const std::string& indent) const
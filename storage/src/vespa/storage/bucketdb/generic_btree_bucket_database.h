@@ -8,6 +8,7 @@
 #include <vespa/vespalib/btree/minmaxaggregated.h>
 #include <vespa/vespalib/btree/minmaxaggrcalc.h>
 #include <vespa/vespalib/datastore/atomic_value_wrapper.h>
+#include <optional>
 
 namespace storage::bucketdb {
 
@@ -145,6 +146,8 @@ public:
         ReadSnapshot(const ReadSnapshot&) = delete;
         ReadSnapshot& operator=(const ReadSnapshot&) = delete;
 
+        // Point lookup of an exact bucket key within the snapshot.
+        [[nodiscard]] std::optional<ValueType> find(const document::BucketId& bucket) const;
         template <typename IterValueExtractor, typename Func>
         void find_parents_and_self(const document::BucketId& bucket, Func func) const;
         template <typename IterValueExtractor, typename Func>
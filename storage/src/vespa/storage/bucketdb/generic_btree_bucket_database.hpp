@@ -567,6 +567,16 @@ GenericBTreeBucketDatabase<DataStoreTraitsT>::ReadSnapshot::ReadSnapshot(
 template <typename DataStoreTraitsT>
 GenericBTreeBucketDatabase<DataStoreTraitsT>::ReadSnapshot::~ReadSnapshot() = default;
 
+template <typename DataStoreTraitsT>
+std::optional<typename GenericBTreeBucketDatabase<DataStoreTraitsT>::ValueType>
+GenericBTreeBucketDatabase<DataStoreTraitsT>::ReadSnapshot::find(const BucketId& bucket) const {
+    auto iter = _frozen_view.find(bucket.toKey());
+    if (!iter.valid()) {
+        return std::nullopt;
+    }
+    return _db->entry_from_iterator(iter);
+}
+
 template <typename DataStoreTraitsT>
 template <typename IterValueExtractor, typename Func>
 void GenericBTreeBucketDatabase<DataStoreTraitsT>::ReadSnapshot::find_parents_and_self(
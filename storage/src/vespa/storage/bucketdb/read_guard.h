@@ -5,6 +5,7 @@
 #include <vespa/document/bucket/bucketid.h>
 #include <functional>
 #include <memory>
+#include <optional>
 #include <vector>
 
 namespace storage::bucketdb {
@@ -40,6 +41,8 @@ public:
     ReadGuard(const ReadGuard&) = delete;
     ReadGuard& operator=(const ReadGuard&) = delete;
 
+    // Returns the entry stored for exactly the given bucket, if any.
+    [[nodiscard]] virtual std::optional<ValueT> find(const document::BucketId& bucket) const = 0;
     virtual std::vector<ValueT> find_parents_and_self(const document::BucketId& bucket) const = 0;
     virtual std::vector<ValueT> find_parents_self_and_children(const document::BucketId& bucket) const = 0;
     virtual void for_each(std::function<void(uint64_t, const ValueT&)> func) const = 0;
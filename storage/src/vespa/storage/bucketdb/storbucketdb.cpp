@@ -128,4 +128,9 @@ StorBucketDatabase::acquire_read_guard() const {
     return _impl->acquire_read_guard();
 }
 
+std::optional<StorBucketDatabase::Entry>
+StorBucketDatabase::get_snapshot(const document::BucketId& bucket) const {
+    return _impl->get_snapshot(bucket.stripUnused().toKey());
+}
+
 } // storage
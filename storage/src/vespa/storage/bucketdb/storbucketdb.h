@@ -7,6 +7,7 @@
 #include <vespa/storageapi/defs.h>
 #include <vespa/vespalib/util/memoryusage.h>
 #include <memory>
+#include <optional>
 
 namespace storage {
 
@@ -66,6 +67,12 @@ public:
 
     [[nodiscard]] std::unique_ptr<bucketdb::ReadGuard<Entry>> acquire_read_guard() const;
 
+    /**
+     * Lock-free point lookup of a bucket's current entry. Does not take the
+     * bucket lock, so the returned copy may be outdated by the time it is used.
+     */
+    [[nodiscard]] std::optional<Entry> get_snapshot(const document::BucketId& bucket) const;
+
     /**
      * Returns true iff bucket has no superbuckets or sub-buckets in the
      * database. Usage assumption is that any operation that can cause the
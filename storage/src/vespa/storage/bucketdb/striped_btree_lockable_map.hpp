@@ -185,6 +185,7 @@ public:
     explicit ReadGuardImpl(const StripedBTreeLockableMap<T>& db);
     ~ReadGuardImpl() override;
 
+    [[nodiscard]] std::optional<T> find(const document::BucketId& bucket) const override;
     std::vector<T> find_parents_and_self(const document::BucketId& bucket) const override;
     std::vector<T> find_parents_self_and_children(const document::BucketId& bucket) const override;
     void for_each(std::function<void(uint64_t, const T&)> func) const override;
@@ -206,6 +207,12 @@ StripedBTreeLockableMap<T>::ReadGuardImpl::ReadGuardImpl(const StripedBTreeLocka
 template <typename T>
 StripedBTreeLockableMap<T>::ReadGuardImpl::~ReadGuardImpl() = default;
 
+template <typename T>
+std::optional<T>
+StripedBTreeLockableMap<T>::ReadGuardImpl::find(const document::BucketId& bucket) const {
+    return _stripe_guards[_db.stripe_of(bucket.toKey())]->find(bucket);
+}
+
 template <typename T>
 std::vector<T>
 StripedBTreeLockableMap<T>::ReadGuardImpl::find_parents_and_self(const document::BucketId& bucket) const {
@@ -230,6 +237,12 @@ std::unique_ptr<ReadGuard<T>> StripedBTreeLockableMap<T>::do_acquire_read_guard(
     return std::make_unique<ReadGuardImpl>(*this);
 }
 
+template <typename T>
+std::optional<T> StripedBTreeLockableMap<T>::do_get_snapshot(const key_type& key) const {
+    // Point lookups only need a snapshot of the stripe owning the key.
+    return db_for(key).get_snapshot(key);
+}
+
 namespace {
 
 template <typename T> using Iter = ConstIterator<const T&>;
@@ -6,6 +6,7 @@
 #include <vespa/vdslib/state/clusterstate.h>
 #include <vespa/vdslib/distribution/distribution.h>
 #include <vespa/vespalib/stllike/hash_map.hpp>
+#include <algorithm>
 
 namespace storage::distributor {
 
@@ -67,12 +68,81 @@ DistributorBucketSpace::enumerate_available_nodes()
     _available_nodes = std::move(nodes);
 }
 
+/*
+ * The ideal nodes of a bucket only depend on the distribution config, the
+ * distribution bit count and, per storage node, on which of the up-state sets
+ * the node is in and its capacity. A node leaving an up-state set can only
+ * affect buckets that had it among their ideal nodes, so only those are dropped
+ * from the cache. A node entering a set (or changing capacity) may take over
+ * any bucket, in which case everything is recomputed lazily.
+ */
+void
+DistributorBucketSpace::invalidate_ideal_nodes(const lib::ClusterState& old_state, const lib::ClusterState& new_state)
+{
+    if (old_state.getDistributionBitCount() != new_state.getDistributionBitCount()) {
+        _ideal_nodes.clear();
+        return;
+    }
+    std::vector<uint16_t> removed_nodes;
+    const uint16_t node_count = std::max(old_state.getNodeCount(lib::NodeType::STORAGE),
+                                         new_state.getNodeCount(lib::NodeType::STORAGE));
+    for (uint16_t i = 0; i < node_count; ++i) {
+        lib::Node node_key(lib::NodeType::STORAGE, i);
+        const lib::NodeState& old_ns(old_state.getNodeState(node_key));
+        const lib::NodeState& new_ns(new_state.getNodeState(node_key));
+        bool removed = false;
+        for (const char* states : {up_states, nonretired_up_states, nonretired_or_maintenance_up_states}) {
+            const bool was_up = old_ns.getState().oneOf(states);
+            const bool is_up = new_ns.getState().oneOf(states);
+            if (is_up && (!was_up || (old_ns.getCapacity() != new_ns.getCapacity()))) {
+                _ideal_nodes.clear();
+                return;
+            }
+            removed |= (was_up && !is_up);
+        }
+        if (removed) {
+            removed_nodes.push_back(i);
+        }
+    }
+    if (removed_nodes.empty()) {
+        return;
+    }
+    auto has_removed_node = [&removed_nodes](IdealServiceLayerNodesBundle::ConstNodesRef nodes) noexcept {
+        return std::any_of(nodes.begin(), nodes.end(), [&removed_nodes](uint16_t node) noexcept {
+            return std::find(removed_nodes.begin(), removed_nodes.end(), node) != removed_nodes.end();
+        });
+    };
+    std::vector<document::BucketId> stale;
+    for (const auto& entry : _ideal_nodes) {
+        const auto& bundle = *entry.second;
+        if (has_removed_node(bundle.available_nodes()) ||
+            has_removed_node(bundle.available_nonretired_nodes()) ||
+            has_removed_node(bundle.available_nonretired_or_maintenance_nodes()))
+        {
+            stale.push_back(entry.first);
+        }
+    }
+    for (const auto& bucket : stale) {
+        _ideal_nodes.erase(bucket);
+    }
+}
+
 void
 DistributorBucketSpace::setClusterState(std::shared_ptr<const lib::ClusterState> clusterState)
 {
+    auto old_state = std::move(_clusterState);
     _clusterState = std::move(clusterState);
-    clear();
+    _ownerships.clear();
+    if (old_state) {
+        invalidate_ideal_nodes(*old_state, *_clusterState);
+    } else {
+        _ideal_nodes.clear();
+    }
+    const auto old_distribution_bits = _distribution_bits;
     enumerate_available_nodes();
+    if (_distribution_bits != old_distribution_bits) {
+        _ideal_nodes.clear(); // Cache is keyed on super buckets using the old bit count
+    }
 }
 
 
@@ -86,8 +156,14 @@ void
 DistributorBucketSpace::set_pending_cluster_state(std::shared_ptr<const lib::ClusterState> pending_cluster_state)
 {
     _pending_cluster_state = std::move(pending_cluster_state);
-    clear();
+    // Ideal nodes are computed from the current state only, so they stay valid
+    // unless the lookup key bit count changes.
+    _ownerships.clear();
+    const auto old_distribution_bits = _distribution_bits;
     enumerate_available_nodes();
+    if (_distribution_bits != old_distribution_bits) {
+        _ideal_nodes.clear();
+    }
 }
 
 bool
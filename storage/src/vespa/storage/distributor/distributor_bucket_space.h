@@ -45,6 +45,7 @@ class DistributorBucketSpace {
 
     void clear();
     void enumerate_available_nodes();
+    void invalidate_ideal_nodes(const lib::ClusterState& old_state, const lib::ClusterState& new_state);
     bool owns_bucket_in_state(const lib::Distribution& distribution, const lib::ClusterState& cluster_state, document::BucketId bucket) const;
 public:
     explicit DistributorBucketSpace();
@@ -5,6 +5,7 @@
 #include "top_level_distributor.h"
 #include "distributor_bucket_space.h"
 #include "externaloperationhandler.h"
+#include "node_latency_tracker.h"
 #include "operation_sequencer.h"
 #include <vespa/document/base/documentid.h>
 #include <vespa/document/util/feed_reject_helper.h>
@@ -88,6 +89,7 @@ ExternalOperationHandler::ExternalOperationHandler(DistributorNodeContext& node_
       _non_main_thread_ops_mutex(),
       _non_main_thread_ops_owner(*_direct_dispatch_sender, _node_ctx.clock()),
       _uuid_generator(std::make_unique<CryptoUuidGenerator>()),
+      _get_latency_tracker(std::make_unique<NodeLatencyTracker>()),
       _concurrent_gets_enabled(false),
       _use_weak_internal_read_consistency_for_gets(false)
 {
@@ -439,7 +441,7 @@ std::shared_ptr<Operation> ExternalOperationHandler::try_generate_get_operation(
     assert(space_repo != nullptr);
     return std::make_shared<GetOperation>(_node_ctx, space_repo->get(bucket.getBucketSpace()),
                                           snapshot.steal_read_guard(), cmd, metrics,
-                                          desired_get_read_consistency());
+                                          desired_get_read_consistency(), _get_latency_tracker.get());
 }
 
 bool ExternalOperationHandler::onGet(const std::shared_ptr<api::GetCommand>& cmd) {
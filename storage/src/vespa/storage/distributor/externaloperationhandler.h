@@ -17,6 +17,7 @@ namespace storage::distributor {
 class DistributorMetricSet;
 class DirectDispatchSender;
 class MaintenanceOperationGenerator;
+class NodeLatencyTracker;
 class OperationSequencer;
 class OperationOwner;
 class PersistenceOperationMetricSet;
@@ -99,6 +100,8 @@ private:
     mutable std::mutex _non_main_thread_ops_mutex;
     OperationOwner _non_main_thread_ops_owner;
     std::unique_ptr<UuidGenerator> _uuid_generator;
+    // Shared by all gets from this handler, which may run on non-main threads
+    std::unique_ptr<NodeLatencyTracker> _get_latency_tracker;
     std::atomic<bool> _concurrent_gets_enabled;
     std::atomic<bool> _use_weak_internal_read_consistency_for_gets;
 
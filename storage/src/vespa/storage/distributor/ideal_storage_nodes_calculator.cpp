@@ -0,0 +1,39 @@
+// Copyright Vespa.ai. Licensed under the terms of the Apache 2.0 license. See LICENSE in the project root.
+#include "ideal_storage_nodes_calculator.h"
+#include <vespa/document/bucket/bucketid.h>
+#include <vespa/vdslib/distribution/distribution.h>
+#include <vespa/vdslib/state/clusterstate.h>
+
+namespace storage::distributor {
+
+namespace {
+
+uint64_t superbucket_from_id(const document::BucketId& id, uint16_t distribution_bits) noexcept {
+    // The n LSBs of the bucket ID contain the superbucket number. Mask off the rest.
+    return id.getRawId() & ~(UINT64_MAX << distribution_bits);
+}
+
+}
+
+IdealStorageNodesCalculator::~IdealStorageNodesCalculator() = default;
+
+const std::vector<uint16_t>&
+IdealStorageNodesCalculator::ideal_nodes(const document::BucketId& bucket_id) const
+{
+    const auto bits = _state.getDistributionBitCount();
+    // Buckets with too few bits make the distribution throw, and buckets split
+    // beyond 33 bits are spread out within their group; neither may be cached.
+    if ((bucket_id.getUsedBits() < bits) || (bucket_id.getUsedBits() > 33)) {
+        _cached_superbucket = UINT64_MAX;
+        _cached_nodes = _distribution.getIdealStorageNodes(_state, bucket_id, _up_states);
+        return _cached_nodes;
+    }
+    const auto this_superbucket = superbucket_from_id(bucket_id, bits);
+    if (_cached_superbucket != this_superbucket) {
+        _cached_nodes = _distribution.getIdealStorageNodes(_state, bucket_id, _up_states);
+        _cached_superbucket = this_superbucket;
+    }
+    return _cached_nodes;
+}
+
+}
@@ -0,0 +1,50 @@
+// Copyright Vespa.ai. Licensed under the terms of the Apache 2.0 license. See LICENSE in the project root.
+#pragma once
+
+#include <cstdint>
+#include <vector>
+
+namespace document { class BucketId; }
+
+namespace storage::lib {
+class ClusterState;
+class Distribution;
+}
+
+namespace storage::distributor {
+
+/**
+ * Calculator for the ideal storage nodes of buckets when sweeping the bucket
+ * database during a cluster state transition. Unless a bucket uses more than
+ * 33 bits (see lib::Distribution::getStorageSeed), its ideal nodes only depend
+ * on its super bucket, so results are cached and reused for all consecutive
+ * sub-buckets under the same super bucket. The cache is invalidated when a new
+ * super bucket is encountered, so it only provides a benefit when invoked in
+ * bucket ID order.
+ *
+ * Not thread safe due to internal caching.
+ */
+class IdealStorageNodesCalculator {
+    const lib::ClusterState&      _state;
+    const lib::Distribution&      _distribution;
+    const char*                   _up_states;
+    mutable uint64_t              _cached_superbucket;
+    mutable std::vector<uint16_t> _cached_nodes;
+public:
+    IdealStorageNodesCalculator(const lib::ClusterState& state,
+                                const lib::Distribution& distribution,
+                                const char* up_states) noexcept
+        : _state(state),
+          _distribution(distribution),
+          _up_states(up_states),
+          _cached_superbucket(UINT64_MAX),
+          _cached_nodes()
+    {
+    }
+    ~IdealStorageNodesCalculator();
+
+    // Returned reference is valid until the next invocation.
+    [[nodiscard]] const std::vector<uint16_t>& ideal_nodes(const document::BucketId& bucket_id) const;
+};
+
+}
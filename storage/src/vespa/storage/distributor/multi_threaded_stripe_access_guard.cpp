@@ -3,6 +3,7 @@
 #include "distributor_stripe.h"
 #include "distributor_stripe_pool.h"
 #include "distributor_stripe_thread.h"
+#include <vespa/vespalib/util/thread.h>
 
 namespace storage::distributor {
 
@@ -70,10 +71,16 @@ MultiThreadedStripeAccessGuard::remove_superfluous_buckets(document::BucketSpace
                                                            const lib::ClusterState& new_state,
                                                            bool is_distribution_change)
 {
-    PotentialDataLossReport report;
-    for_each_stripe([&](TickableStripe& stripe) {
-        report.merge(stripe.remove_superfluous_buckets(bucket_space, new_state, is_distribution_change));
+    // Each stripe sweeps its own bucket DB, which for large DBs is the dominating
+    // cost of a cluster state transition, so let all stripes do this at once.
+    std::vector<PotentialDataLossReport> stripe_reports(_stripe_pool.stripe_count());
+    for_each_stripe_in_parallel([&](size_t stripe_idx, TickableStripe& stripe) {
+        stripe_reports[stripe_idx] = stripe.remove_superfluous_buckets(bucket_space, new_state, is_distribution_change);
     });
+    PotentialDataLossReport report;
+    for (const auto& stripe_report : stripe_reports) {
+        report.merge(stripe_report);
+    }
     return report;
 }
 
@@ -89,23 +96,17 @@ MultiThreadedStripeAccessGuard::merge_entries_into_db(document::BucketSpace buck
     if (entries.empty()) {
         return;
     }
-    std::vector<dbtransition::Entry> stripe_entries;
-    stripe_entries.reserve(entries.size() / _stripe_pool.stripe_count());
-    auto* curr_stripe = &_stripe_pool.stripe_of_key(entries[0].bucket_key);
-    stripe_entries.push_back(entries[0]);
-    for (size_t i = 1; i < entries.size(); ++i) {
-        const auto& entry = entries[i];
-        auto* next_stripe = &_stripe_pool.stripe_of_key(entry.bucket_key);
-        if (curr_stripe != next_stripe) {
-            curr_stripe->merge_entries_into_db(bucket_space, gathered_at_timestamp, distribution,
-                                               new_state, storage_up_states, outdated_nodes, stripe_entries);
-            stripe_entries.clear();
-        }
-        curr_stripe = next_stripe;
-        stripe_entries.push_back(entry);
+    // Entries are in bucket key order, so each stripe gets a sorted subset.
+    std::vector<std::vector<dbtransition::Entry>> stripe_entries(_stripe_pool.stripe_count());
+    for (const auto& entry : entries) {
+        stripe_entries[_stripe_pool.stripe_index_of_key(entry.bucket_key)].push_back(entry);
     }
-    curr_stripe->merge_entries_into_db(bucket_space, gathered_at_timestamp, distribution,
-                                       new_state, storage_up_states, outdated_nodes, stripe_entries);
+    for_each_stripe_in_parallel([&](size_t stripe_idx, TickableStripe& stripe) {
+        if (!stripe_entries[stripe_idx].empty()) {
+            stripe.merge_entries_into_db(bucket_space, gathered_at_timestamp, distribution,
+                                         new_state, storage_up_states, outdated_nodes, stripe_entries[stripe_idx]);
+        }
+    });
 }
 
 void MultiThreadedStripeAccessGuard::update_read_snapshot_before_db_pruning() {
@@ -181,6 +182,20 @@ void MultiThreadedStripeAccessGuard::for_each_stripe(Func&& f) const {
     }
 }
 
+template <typename Func>
+void MultiThreadedStripeAccessGuard::for_each_stripe_in_parallel(Func&& f) {
+    // All stripe threads are parked while the guard is held, so helper threads
+    // do the work on their behalf. The calling thread processes the first stripe.
+    vespalib::ThreadPool helpers;
+    for (size_t i = 1; i < _stripe_pool.stripe_count(); ++i) {
+        helpers.start([&f, i, &stripe = _stripe_pool.stripe_thread(i).stripe()]() {
+            f(i, stripe);
+        });
+    }
+    f(0, _stripe_pool.stripe_thread(0).stripe());
+    helpers.join();
+}
+
 std::unique_ptr<StripeAccessGuard> MultiThreadedStripeAccessor::rendezvous_and_hold_all() {
     // For sanity checking of invariant of only one guard being allowed at any given time.
     assert(!_guard_held);
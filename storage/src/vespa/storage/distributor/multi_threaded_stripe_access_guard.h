@@ -67,6 +67,11 @@ private:
 
     template <typename Func>
     void for_each_stripe(Func&& f) const;
+
+    // Invokes f(stripe_index, stripe) for all stripes concurrently. Only safe for
+    // operations that touch nothing but state owned by the stripe itself.
+    template <typename Func>
+    void for_each_stripe_in_parallel(Func&& f);
 };
 
 /**
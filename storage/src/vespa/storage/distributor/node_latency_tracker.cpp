@@ -0,0 +1,51 @@
+// Copyright Vespa.ai. Licensed under the terms of the Apache 2.0 license. See LICENSE in the project root.
+
+#include "node_latency_tracker.h"
+#include <cmath>
+
+namespace storage::distributor {
+
+NodeLatencyTracker::NodeLatencyTracker(double alpha, vespalib::duration half_life)
+    : _lock(),
+      _nodes(),
+      _alpha(alpha),
+      _half_life_s(vespalib::to_s(half_life))
+{
+}
+
+NodeLatencyTracker::~NodeLatencyTracker() = default;
+
+void
+NodeLatencyTracker::record(uint16_t node, vespalib::duration latency, vespalib::steady_time now)
+{
+    double latency_s = vespalib::to_s(latency);
+    std::lock_guard guard(_lock);
+    if (node >= _nodes.size()) {
+        _nodes.resize(node + 1);
+    }
+    Entry& entry = _nodes[node];
+    if (entry.valid) {
+        entry.ewma_s += _alpha * (latency_s - entry.ewma_s);
+    } else {
+        entry.ewma_s = latency_s;
+        entry.valid = true;
+    }
+    entry.updated = now;
+}
+
+double
+NodeLatencyTracker::expected_latency(uint16_t node, vespalib::steady_time now) const
+{
+    std::lock_guard guard(_lock);
+    if ((node >= _nodes.size()) || !_nodes[node].valid) {
+        return 0.0;
+    }
+    const Entry& entry = _nodes[node];
+    double age_s = std::max(vespalib::to_s(now - entry.updated), 0.0);
+    if (_half_life_s <= 0.0) {
+        return entry.ewma_s;
+    }
+    return entry.ewma_s * std::exp2(-age_s / _half_life_s);
+}
+
+}
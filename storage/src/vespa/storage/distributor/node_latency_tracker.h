@@ -0,0 +1,48 @@
+// Copyright Vespa.ai. Licensed under the terms of the Apache 2.0 license. See LICENSE in the project root.
+#pragma once
+
+#include <vespa/vespalib/util/time.h>
+#include <cstdint>
+#include <mutex>
+#include <vector>
+
+namespace storage::distributor {
+
+/**
+ * Keeps an exponentially weighted moving average of the observed
+ * reply latency per content node, used to prefer the fastest of
+ * otherwise equivalent replicas when reading.
+ *
+ * A node is only measured while it is being chosen, so the expected
+ * latency of a node decays towards zero with the time since its last
+ * sample. A node that was slow is thus retried once it has been left
+ * alone for a while, instead of being avoided forever.
+ *
+ * Thread safe.
+ */
+class NodeLatencyTracker {
+public:
+    static constexpr double default_alpha = 0.2;
+    static constexpr vespalib::duration default_half_life = std::chrono::seconds(10);
+
+    NodeLatencyTracker() : NodeLatencyTracker(default_alpha, default_half_life) {}
+    NodeLatencyTracker(double alpha, vespalib::duration half_life);
+    ~NodeLatencyTracker();
+
+    void record(uint16_t node, vespalib::duration latency, vespalib::steady_time now);
+    // Expected reply latency in seconds, 0 if the node has not been measured.
+    [[nodiscard]] double expected_latency(uint16_t node, vespalib::steady_time now) const;
+private:
+    struct Entry {
+        double                ewma_s;
+        vespalib::steady_time updated;
+        bool                  valid;
+        Entry() noexcept : ewma_s(0.0), updated(), valid(false) {}
+    };
+    mutable std::mutex _lock;
+    std::vector<Entry> _nodes;
+    const double       _alpha;
+    const double       _half_life_s;
+};
+
+}
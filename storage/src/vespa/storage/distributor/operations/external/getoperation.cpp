@@ -5,6 +5,7 @@
 #include <vespa/storage/distributor/distributor_bucket_space.h>
 #include <vespa/storage/distributor/distributor_node_context.h>
 #include <vespa/storage/distributor/distributormetricsset.h>
+#include <vespa/storage/distributor/node_latency_tracker.h>
 #include <vespa/storageapi/message/persistence.h>
 #include <vespa/vdslib/state/nodestate.h>
 #include <vespa/vdslib/state/clusterstate.h>
@@ -53,7 +54,8 @@ GetOperation::GetOperation(const DistributorNodeContext& node_ctx,
                            const std::shared_ptr<BucketDatabase::ReadGuard> & read_guard,
                            std::shared_ptr<api::GetCommand> msg,
                            PersistenceOperationMetricSet& metric,
-                           api::InternalReadConsistency desired_read_consistency)
+                           api::InternalReadConsistency desired_read_consistency,
+                           NodeLatencyTracker* latency_tracker)
     : Operation(),
       _node_ctx(node_ctx),
       _bucketSpace(bucketSpace),
@@ -65,6 +67,7 @@ GetOperation::GetOperation(const DistributorNodeContext& node_ctx,
       _operationTimer(node_ctx.clock()),
       _trace(_msg->getTrace().getLevel()),
       _desired_read_consistency(desired_read_consistency),
+      _latency_tracker(latency_tracker),
       _has_replica_inconsistency(false),
       _any_replicas_failed(false)
 {
@@ -88,6 +91,8 @@ int
 GetOperation::findBestUnsentTarget(const GroupVector& candidates) const
 {
     int best = -1;
+    double best_latency = 0.0;
+    const auto now = _node_ctx.clock().getMonotonicTime();
     for (uint32_t i = 0; i < candidates.size(); ++i) {
         if (candidates[i].sent) {
             continue;
@@ -95,8 +100,12 @@ GetOperation::findBestUnsentTarget(const GroupVector& candidates) const
         if (copyIsOnLocalNode(candidates[i].copy)) {
             return i; // Can't get better match than this.
         }
-        if (best == -1) {
+        const double latency = _latency_tracker
+                ? _latency_tracker->expected_latency(candidates[i].copy.getNode(), now)
+                : 0.0;
+        if ((best == -1) || (latency < best_latency)) {
             best = i;
+            best_latency = latency;
         }
     }
     return best;
@@ -122,6 +131,7 @@ GetOperation::sendForChecksum(DistributorStripeMessageSender& sender, const docu
         const auto target_node = res[best].copy.getNode();
         res[best].sent = sender.sendToNode(lib::NodeType::STORAGE, target_node, command);
         res[best].to_node = target_node;
+        res[best].sent_time = _node_ctx.clock().getMonotonicTime();
         return true;
     }
 
@@ -170,6 +180,10 @@ GetOperation::onReceive(DistributorStripeMessageSender& sender, const std::share
 
                 send_state.received = true;
                 send_state.returnCode = getreply->getResult();
+                if (_latency_tracker) {
+                    const auto now = _node_ctx.clock().getMonotonicTime();
+                    _latency_tracker->record(send_state.to_node, now - send_state.sent_time, now);
+                }
 
                 if (getreply->getResult().success()) {
                     if (_newest_replica.has_value() && (getreply->getLastModifiedTimestamp() != _newest_replica->timestamp)) {
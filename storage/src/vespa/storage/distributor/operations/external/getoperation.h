@@ -18,6 +18,7 @@ namespace storage::distributor {
 
 class DistributorNodeContext;
 class DistributorBucketSpace;
+class NodeLatencyTracker;
 class PersistenceOperationMetricSet;
 
 class GetOperation  : public Operation
@@ -28,7 +29,8 @@ public:
                  const std::shared_ptr<BucketDatabase::ReadGuard>& read_guard,
                  std::shared_ptr<api::GetCommand> msg,
                  PersistenceOperationMetricSet& metric,
-                 api::InternalReadConsistency desired_read_consistency = api::InternalReadConsistency::Strong);
+                 api::InternalReadConsistency desired_read_consistency = api::InternalReadConsistency::Strong,
+                 NodeLatencyTracker* latency_tracker = nullptr);
 
     void onClose(DistributorStripeMessageSender& sender) override;
     void onStart(DistributorStripeMessageSender& sender) override;
@@ -77,12 +79,13 @@ private:
 
     struct BucketChecksumGroup {
         explicit BucketChecksumGroup(const BucketCopy& c) noexcept
-            : copy(c), sent(0), returnCode(api::ReturnCode::OK), to_node(UINT16_MAX), received(false)
+            : copy(c), sent(0), returnCode(api::ReturnCode::OK), sent_time(), to_node(UINT16_MAX), received(false)
         {}
 
         BucketCopy copy;
         api::StorageMessage::Id sent;
         api::ReturnCode returnCode;
+        vespalib::steady_time sent_time;
         uint16_t to_node;
         bool received;
     };
@@ -105,6 +108,7 @@ private:
     DbReplicaState                      _replicas_in_db;
     vespalib::Trace                     _trace;
     api::InternalReadConsistency        _desired_read_consistency;
+    NodeLatencyTracker*                 _latency_tracker;
     bool                                _has_replica_inconsistency;
     bool                                _any_replicas_failed;
 
@@ -116,6 +120,9 @@ private:
     /**
      * Returns the vector index of the target to send to, or -1 if none
      * could be found (i.e. all targets have already been sent to).
+     * A replica on the local node is always preferred; otherwise the
+     * replica with the lowest expected latency is chosen if a latency
+     * tracker is present.
      */
     int findBestUnsentTarget(const GroupVector& candidates) const;
 
@@ -89,12 +89,8 @@ PendingBucketSpaceDbTransition::DbMerger::insertInfo(BucketDatabase::Entry& info
     std::vector<BucketCopy> copiesToAddOrUpdate(
             getCopiesThatAreNewOrAltered(info, range));
 
-    std::vector<uint16_t> order(
-            _distribution.getIdealStorageNodes(
-                    _new_state,
-                    _entries[range.first].bucket_id(),
-                    _storage_up_states));
-    info->addNodes(copiesToAddOrUpdate, order, TrustedUpdate::DEFER);
+    info->addNodes(copiesToAddOrUpdate, _ideal_nodes_calc.ideal_nodes(_entries[range.first].bucket_id()),
+                   TrustedUpdate::DEFER);
 }
 
 bool
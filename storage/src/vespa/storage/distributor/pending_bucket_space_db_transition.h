@@ -1,6 +1,7 @@
 // Copyright Vespa.ai. Licensed under the terms of the Apache 2.0 license. See LICENSE in the project root.
 #pragma once
 
+#include "ideal_storage_nodes_calculator.h"
 #include "pending_bucket_space_db_transition_entry.h"
 #include "outdated_nodes.h"
 #include <vespa/document/bucket/bucketspace.h>
@@ -78,6 +79,7 @@ public:
         const char* _storage_up_states;
         const OutdatedNodes & _outdated_nodes; // TODO hash_set
         const std::vector<dbtransition::Entry>& _entries;
+        IdealStorageNodesCalculator _ideal_nodes_calc;
         uint32_t _iter;
     public:
         DbMerger(api::Timestamp creation_timestamp,
@@ -92,6 +94,7 @@ public:
               _storage_up_states(storage_up_states),
               _outdated_nodes(outdated_nodes),
               _entries(entries),
+              _ideal_nodes_calc(_new_state, _distribution, _storage_up_states),
               _iter(0)
         {}
         ~DbMerger() override = default;
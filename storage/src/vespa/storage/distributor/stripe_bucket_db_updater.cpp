@@ -673,6 +673,7 @@ StripeBucketDBUpdater::MergingNodeRemover::MergingNodeRemover(
       _distribution(distribution),
       _upStates(upStates),
       _ownership_calc(_state, _distribution, localIndex),
+      _ideal_nodes_calc(_state, _distribution, _upStates),
       _track_non_owned_entries(track_non_owned_entries)
 {
     const uint16_t storage_count = s.getNodeCount(lib::NodeType::STORAGE);
@@ -711,11 +712,7 @@ StripeBucketDBUpdater::MergingNodeRemover::setCopiesInEntry(
         const std::vector<BucketCopy>& copies) const
 {
     e->clear();
-
-    std::vector<uint16_t> order =
-            _distribution.getIdealStorageNodes(_state, e.getBucketId(), _upStates);
-
-    e->addNodes(copies, order);
+    e->addNodes(copies, _ideal_nodes_calc.ideal_nodes(e.getBucketId()));
 
     LOG(spam, "Changed %s", e->toString().c_str());
 }
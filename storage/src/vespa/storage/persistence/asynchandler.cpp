@@ -5,6 +5,7 @@
 #include "testandsethelper.h"
 #include "bucketownershipnotifier.h"
 #include "bucketprocessor.h"
+#include <vespa/persistence/spi/batched_operation.h>
 #include <vespa/persistence/spi/persistenceprovider.h>
 #include <vespa/persistence/spi/docentry.h>
 #include <vespa/persistence/spi/doctype_gid_and_timestamp.h>
@@ -153,7 +154,13 @@ AsyncHandler::handleRunTask(RunTaskCommand& cmd, MessageTracker::UP tracker) con
 }
 
 MessageTracker::UP
-AsyncHandler::handlePut(api::PutCommand& cmd, MessageTracker::UP trackerUP) const
+AsyncHandler::handlePut(api::PutCommand& cmd, MessageTracker::UP tracker) const
+{
+    return handlePut(cmd, std::move(tracker), nullptr);
+}
+
+MessageTracker::UP
+AsyncHandler::handlePut(api::PutCommand& cmd, MessageTracker::UP trackerUP, std::vector<spi::BatchedOperation>* batch) const
 {
     MessageTracker & tracker = *trackerUP;
     auto& metrics = _env._metrics.put;
@@ -172,8 +179,12 @@ AsyncHandler::handlePut(api::PutCommand& cmd, MessageTracker::UP trackerUP) cons
         tracker->checkForError(*response);
         tracker->sendReply();
     });
-    _spi.putAsync(bucket, spi::Timestamp(cmd.getTimestamp()), cmd.getDocument(),
-                  std::make_unique<ResultTaskOperationDone>(_sequencedExecutor, cmd.getBucketId(), std::move(task)));
+    auto onDone = std::make_unique<ResultTaskOperationDone>(_sequencedExecutor, cmd.getBucketId(), std::move(task));
+    if (batch != nullptr) {
+        batch->push_back(spi::BatchedOperation::make_put(spi::Timestamp(cmd.getTimestamp()), cmd.getDocument(), std::move(onDone)));
+    } else {
+        _spi.putAsync(bucket, spi::Timestamp(cmd.getTimestamp()), cmd.getDocument(), std::move(onDone));
+    }
 
     return trackerUP;
 }
@@ -361,7 +372,13 @@ AsyncHandler::handleSetBucketState(api::SetBucketStateCommand& cmd, MessageTrack
 }
 
 MessageTracker::UP
-AsyncHandler::handleUpdate(api::UpdateCommand& cmd, MessageTracker::UP trackerUP) const
+AsyncHandler::handleUpdate(api::UpdateCommand& cmd, MessageTracker::UP tracker) const
+{
+    return handleUpdate(cmd, std::move(tracker), nullptr);
+}
+
+MessageTracker::UP
+AsyncHandler::handleUpdate(api::UpdateCommand& cmd, MessageTracker::UP trackerUP, std::vector<spi::BatchedOperation>* batch) const
 {
     MessageTracker & tracker = *trackerUP;
     auto& metrics = _env._metrics.update;
@@ -385,13 +402,23 @@ AsyncHandler::handleUpdate(api::UpdateCommand& cmd, MessageTracker::UP trackerUP
         }
         tracker->sendReply();
     });
-    _spi.updateAsync(bucket, spi::Timestamp(cmd.getTimestamp()), cmd.getUpdate(),
-                     std::make_unique<ResultTaskOperationDone>(_sequencedExecutor, cmd.getBucketId(), std::move(task)));
+    auto onDone = std::make_unique<ResultTaskOperationDone>(_sequencedExecutor, cmd.getBucketId(), std::move(task));
+    if (batch != nullptr) {
+        batch->push_back(spi::BatchedOperation::make_update(spi::Timestamp(cmd.getTimestamp()), cmd.getUpdate(), std::move(onDone)));
+    } else {
+        _spi.updateAsync(bucket, spi::Timestamp(cmd.getTimestamp()), cmd.getUpdate(), std::move(onDone));
+    }
     return trackerUP;
 }
 
 MessageTracker::UP
-AsyncHandler::handleRemove(api::RemoveCommand& cmd, MessageTracker::UP trackerUP) const
+AsyncHandler::handleRemove(api::RemoveCommand& cmd, MessageTracker::UP tracker) const
+{
+    return handleRemove(cmd, std::move(tracker), nullptr);
+}
+
+MessageTracker::UP
+AsyncHandler::handleRemove(api::RemoveCommand& cmd, MessageTracker::UP trackerUP, std::vector<spi::BatchedOperation>* batch) const
 {
     MessageTracker & tracker = *trackerUP;
     auto& metrics = _env._metrics.remove;
@@ -416,11 +443,39 @@ AsyncHandler::handleRemove(api::RemoveCommand& cmd, MessageTracker::UP trackerUP
         }
         tracker->sendReply();
     });
-    _spi.removeIfFoundAsync(bucket, spi::Timestamp(cmd.getTimestamp()), cmd.getDocumentId(),
-                            std::make_unique<ResultTaskOperationDone>(_sequencedExecutor, cmd.getBucketId(), std::move(task)));
+    auto onDone = std::make_unique<ResultTaskOperationDone>(_sequencedExecutor, cmd.getBucketId(), std::move(task));
+    if (batch != nullptr) {
+        batch->push_back(spi::BatchedOperation::make_remove_if_found(spi::Timestamp(cmd.getTimestamp()), cmd.getDocumentId(), std::move(onDone)));
+    } else {
+        _spi.removeIfFoundAsync(bucket, spi::Timestamp(cmd.getTimestamp()), cmd.getDocumentId(), std::move(onDone));
+    }
     return trackerUP;
 }
 
+MessageTracker::UP
+AsyncHandler::add_to_feed_batch(api::StorageCommand& cmd, MessageTracker::UP tracker,
+                                std::vector<spi::BatchedOperation>& batch) const
+{
+    switch (cmd.getType().getId()) {
+    case api::MessageType::PUT_ID:
+        return handlePut(static_cast<api::PutCommand&>(cmd), std::move(tracker), &batch);
+    case api::MessageType::UPDATE_ID:
+        return handleUpdate(static_cast<api::UpdateCommand&>(cmd), std::move(tracker), &batch);
+    case api::MessageType::REMOVE_ID:
+        return handleRemove(static_cast<api::RemoveCommand&>(cmd), std::move(tracker), &batch);
+    default:
+        LOG_ABORT("should not be reached");
+    }
+}
+
+void
+AsyncHandler::send_feed_batch(const document::Bucket& bucket, std::vector<spi::BatchedOperation> batch) const
+{
+    if ( ! batch.empty()) {
+        _spi.feedBatchAsync(spi::Bucket(bucket), std::move(batch));
+    }
+}
+
 bool
 AsyncHandler::is_async_unconditional_message(const api::StorageMessage & cmd) noexcept
 {
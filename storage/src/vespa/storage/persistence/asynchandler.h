@@ -10,6 +10,7 @@ namespace vespalib { class ISequencedTaskExecutor; }
 namespace storage {
 
 namespace spi {
+    struct BatchedOperation;
     struct PersistenceProvider;
     class Context;
 }
@@ -29,6 +30,14 @@ public:
     MessageTrackerUP handlePut(api::PutCommand& cmd, MessageTrackerUP tracker) const;
     MessageTrackerUP handleRemove(api::RemoveCommand& cmd, MessageTrackerUP tracker) const;
     MessageTrackerUP handleUpdate(api::UpdateCommand& cmd, MessageTrackerUP tracker) const;
+    /**
+     * Prepares an unconditional put, update or remove (see is_async_unconditional_message)
+     * and adds it to the given batch instead of sending it to the provider. Returns the
+     * tracker if the operation was completed right away.
+     */
+    MessageTrackerUP add_to_feed_batch(api::StorageCommand& cmd, MessageTrackerUP tracker,
+                                       std::vector<spi::BatchedOperation>& batch) const;
+    void send_feed_batch(const document::Bucket& bucket, std::vector<spi::BatchedOperation> batch) const;
     MessageTrackerUP handleRunTask(RunTaskCommand & cmd, MessageTrackerUP tracker) const;
     MessageTrackerUP handleSetBucketState(api::SetBucketStateCommand& cmd, MessageTrackerUP tracker) const;
     MessageTrackerUP handleDeleteBucket(api::DeleteBucketCommand& cmd, MessageTrackerUP tracker) const;
@@ -37,6 +46,10 @@ public:
     MessageTrackerUP handleRemoveLocation(api::RemoveLocationCommand& cmd, MessageTrackerUP tracker) const;
     static bool is_async_unconditional_message(const api::StorageMessage& cmd) noexcept;
 private:
+    // Operations are added to batch if it is set, otherwise sent directly to the provider
+    MessageTrackerUP handlePut(api::PutCommand& cmd, MessageTrackerUP tracker, std::vector<spi::BatchedOperation>* batch) const;
+    MessageTrackerUP handleRemove(api::RemoveCommand& cmd, MessageTrackerUP tracker, std::vector<spi::BatchedOperation>* batch) const;
+    MessageTrackerUP handleUpdate(api::UpdateCommand& cmd, MessageTrackerUP tracker, std::vector<spi::BatchedOperation>* batch) const;
     [[nodiscard]] bool checkProviderBucketInfoMatches(const spi::Bucket&, const api::BucketInfo&) const;
     static bool tasConditionExists(const api::TestAndSetCommand& cmd);
     bool tasConditionMatches(const api::TestAndSetCommand& cmd, MessageTracker& tracker,
@@ -173,6 +173,17 @@ public:
      */
     virtual LockedMessage getNextMessage(uint32_t stripeId, vespalib::steady_time deadline) = 0;
 
+    /**
+     * Used by file stor threads to take more queued unconditional puts, updates
+     * and removes (see AsyncHandler::is_async_unconditional_message) for the
+     * bucket locked by the given message, so that they can be handed to the
+     * provider together with it. The returned messages share the lock of the
+     * given message and are in the order they were queued. Fewer than
+     * max_count messages are returned if the next queued operation for the
+     * bucket cannot be batched or no throttle token is available for it.
+     */
+    virtual std::vector<LockedMessage> next_batchable_messages(const LockedMessage& locked, uint32_t max_count) = 0;
+
     /** Only used for testing, should be removed */
     LockedMessage getNextMessage(uint32_t stripeId) {
         return getNextMessage(stripeId, vespalib::steady_clock::now() + _getNextMessageTimout);
@@ -287,6 +298,19 @@ public:
     virtual void use_dynamic_operation_throttling(bool use_dynamic) noexcept = 0;
 
     virtual void set_throttle_apply_bucket_diff_ops(bool throttle_apply_bucket_diff) noexcept = 0;
+
+    /**
+     * Returns whether the persistence thread with the given index may currently process
+     * operations. A thread that may not should idle until this changes.
+     */
+    [[nodiscard]] virtual bool persistence_thread_is_active(uint32_t thread_index) const noexcept = 0;
+
+    /**
+     * If enabled, the number of active persistence threads is adjusted periodically based
+     * on observed queue wait times, throughput and CPU utilization. If disabled, all
+     * persistence threads are active.
+     */
+    virtual void use_adaptive_persistence_concurrency(bool enabled) noexcept = 0;
 private:
     vespalib::duration _getNextMessageTimout;
 };
@@ -14,6 +14,7 @@
 #include <vespa/vespalib/stllike/hash_map.hpp>
 #include <vespa/vespalib/util/exceptions.h>
 #include <vespa/vespalib/util/string_escape.h>
+#include <thread>
 
 #include <vespa/log/log.h>
 LOG_SETUP(".persistence.filestor.handler.impl");
@@ -60,7 +61,19 @@ FileStorHandlerImpl::FileStorHandlerImpl(uint32_t numThreads, uint32_t numStripe
       _max_active_merges_per_stripe(per_stripe_merge_limit(numThreads, numStripes)),
       _paused(false),
       _throttle_apply_bucket_diff_ops(false),
-      _last_active_operations_stats()
+      _last_active_operations_stats(),
+      _num_persistence_threads(std::max(numThreads, 1u)),
+      _active_persistence_threads(_num_persistence_threads),
+      _adaptive_persistence_concurrency(false),
+      _total_queue_wait_us(0),
+      _total_dequeued_ops(0),
+      // Every stripe must keep at least one thread polling it
+      _concurrency_controller(PersistenceConcurrencyController::Params(std::min(numStripes, _num_persistence_threads),
+                                                                       _num_persistence_threads)),
+      _cpu_util(),
+      _last_total_queue_wait_us(0),
+      _last_total_dequeued_ops(0),
+      _last_concurrency_sample_time(vespalib::steady_clock::now())
 {
     assert(numStripes > 0);
     _stripes.reserve(numStripes);
@@ -363,6 +376,43 @@ FileStorHandlerImpl::updateMetrics(const MetricLockGuard &)
         _metrics->averageQueueWaitingTime.addTotalValueWithCount(m.getTotal(), m.getCount());
     }
     update_active_operations_metrics();
+    update_persistence_concurrency();
+}
+
+void
+FileStorHandlerImpl::update_persistence_concurrency()
+{
+    const auto now = vespalib::steady_clock::now();
+    const uint64_t total_wait_us = _total_queue_wait_us.load(std::memory_order_relaxed);
+    const uint64_t total_ops = _total_dequeued_ops.load(std::memory_order_relaxed);
+    const uint64_t delta_ops = total_ops - _last_total_dequeued_ops;
+    const uint64_t delta_wait_us = total_wait_us - _last_total_queue_wait_us;
+    const double elapsed_s = vespalib::to_s(now - _last_concurrency_sample_time);
+    _last_total_dequeued_ops = total_ops;
+    _last_total_queue_wait_us = total_wait_us;
+    _last_concurrency_sample_time = now;
+
+    uint32_t active_threads = _num_persistence_threads;
+    if (_adaptive_persistence_concurrency.load(std::memory_order_relaxed) && (elapsed_s > 0.0)) {
+        PersistenceConcurrencyController::Sample sample;
+        sample.throughput = delta_ops / elapsed_s;
+        sample.avg_queue_wait_ms = (delta_ops != 0) ? (delta_wait_us / 1000.0) / delta_ops : 0.0;
+        const auto util = _cpu_util.get_util();
+        double cores_used = 0.0;
+        for (size_t i = 0; i < util.size(); ++i) {
+            cores_used += util[i];
+        }
+        sample.cpu_util = cores_used / std::max(std::thread::hardware_concurrency(), 1u);
+        active_threads = _concurrency_controller.on_sample(sample);
+    } else {
+        _concurrency_controller.reset();
+    }
+    if (active_threads != _active_persistence_threads.load(std::memory_order_relaxed)) {
+        LOG(debug, "Changing number of active persistence threads from %u to %u",
+            _active_persistence_threads.load(std::memory_order_relaxed), active_threads);
+        _active_persistence_threads.store(active_threads, std::memory_order_relaxed);
+    }
+    _metrics->active_persistence_threads.addValue(active_threads);
 }
 
 bool
@@ -407,9 +457,15 @@ FileStorHandlerImpl::getNextMessage(uint32_t stripeId, vespalib::steady_time dea
     return _stripes[stripeId].getNextMessage(deadline);
 }
 
+std::vector<FileStorHandler::LockedMessage>
+FileStorHandlerImpl::next_batchable_messages(const LockedMessage& locked, uint32_t max_count)
+{
+    return stripe(locked.lock->getBucket()).next_batchable_messages(locked, max_count);
+}
+
 std::shared_ptr<FileStorHandler::BucketLockInterface>
 FileStorHandlerImpl::Stripe::lock(const document::Bucket &bucket, api::LockingRequirements lockReq) {
-    std::unique_lock guard(*_lock);
+    auto guard = lockStripe();
 
     while (isLocked(guard, bucket, lockReq)) {
         LOG(spam, "Contending for filestor lock for %s with %s access",
@@ -816,7 +872,7 @@ FileStorHandlerImpl::remapQueue(const RemapInfo& source, RemapInfo& target1, Rem
 void
 FileStorHandlerImpl::Stripe::failOperations(const document::Bucket &bucket, const api::ReturnCode& err)
 {
-    std::lock_guard guard(*_lock);
+    auto guard = lockStripe();
 
     BucketIdx& idx(bmi::get<2>(*_queue));
     std::pair<BucketIdx::iterator, BucketIdx::iterator> range(idx.equal_range(bucket));
@@ -857,10 +913,29 @@ FileStorHandlerImpl::sendReplyDirectly(const std::shared_ptr<api::StorageReply>&
     _messageSender.sendReplyDirectly(msg);
 }
 
+namespace {
+
+vespalib::steady_time
+queue_deadline_of(const api::StorageMessage& msg)
+{
+    if (msg.getType().isReply()) {
+        return vespalib::steady_time::max();
+    }
+    const auto timeout = static_cast<const api::StorageCommand&>(msg).getTimeout();
+    const auto now = vespalib::steady_clock::now();
+    if (timeout >= (vespalib::steady_time::max() - now)) {
+        return vespalib::steady_time::max();
+    }
+    return now + timeout;
+}
+
+}
+
 FileStorHandlerImpl::MessageEntry::MessageEntry(const std::shared_ptr<api::StorageMessage>& cmd,
                                                 const document::Bucket &bucket)
     : _command(cmd),
       _timer(),
+      _deadline(queue_deadline_of(*cmd)),
       _bucket(bucket),
       _priority(cmd->getPriority())
 { }
@@ -869,6 +944,7 @@ FileStorHandlerImpl::MessageEntry::MessageEntry(const std::shared_ptr<api::Stora
 FileStorHandlerImpl::MessageEntry::MessageEntry(const MessageEntry& entry) noexcept
     : _command(entry._command),
       _timer(entry._timer),
+      _deadline(entry._deadline),
       _bucket(entry._bucket),
       _priority(entry._priority)
 { }
@@ -877,6 +953,7 @@ FileStorHandlerImpl::MessageEntry::MessageEntry(const MessageEntry& entry) noexc
 FileStorHandlerImpl::MessageEntry::MessageEntry(MessageEntry && entry) noexcept
     : _command(std::move(entry._command)),
       _timer(entry._timer),
+      _deadline(entry._deadline),
       _bucket(entry._bucket),
       _priority(entry._priority)
 { }
@@ -903,6 +980,7 @@ FileStorHandlerImpl::Stripe::Stripe(const FileStorHandlerImpl & owner, MessageSe
       _messageSender(messageSender),
       _metrics(nullptr),
       _lock(std::make_unique<std::mutex>()),
+      _lockStats(&vespalib::LockStats::get("storage.filestor.stripe")),
       _cond(std::make_unique<std::condition_variable>()),
       _queue(std::make_unique<PriorityQueue>()),
       _cached_queue_size(_queue->size()),
@@ -938,10 +1016,57 @@ FileStorHandlerImpl::Stripe::operation_type_should_be_throttled(api::MessageType
     }
 }
 
+namespace {
+
+// Sends its replies when destroyed, which lets replies be gathered while holding a lock
+// that has been released by the time they are sent.
+class DeferredReplySender {
+    MessageSender&                                  _sender;
+    std::vector<std::shared_ptr<api::StorageReply>> _replies;
+public:
+    explicit DeferredReplySender(MessageSender& sender) noexcept : _sender(sender), _replies() {}
+    ~DeferredReplySender() {
+        for (auto& reply : _replies) {
+            _sender.sendReply(reply);
+        }
+    }
+    std::vector<std::shared_ptr<api::StorageReply>>& replies() noexcept { return _replies; }
+};
+
+}
+
+FileStorHandlerImpl::PriorityIdx::iterator
+FileStorHandlerImpl::Stripe::next_runnable_message(const monitor_guard& guard, PriorityIdx& idx,
+                                                   std::vector<std::shared_ptr<api::StorageReply>>& expired)
+{
+    const auto now = vespalib::steady_clock::now();
+    const size_t expired_before = expired.size();
+    auto iter = idx.begin();
+    while (iter != idx.end()) {
+        if (iter->has_expired(now)) {
+            // No point in executing an operation the sender has already given up on, nor in
+            // letting it hold back a runnable operation queued behind it.
+            expired.emplace_back(makeQueueTimeoutReply(*iter->_command));
+            iter = idx.erase(iter);
+        } else if (operationIsInhibited(guard, iter->_bucket, *iter->_command)) {
+            ++iter;
+        } else {
+            break;
+        }
+    }
+    if (expired.size() != expired_before) {
+        _metrics->expired_in_queue.inc(expired.size() - expired_before);
+        update_cached_queue_size(guard);
+        _cond->notify_all();
+    }
+    return iter;
+}
+
 FileStorHandler::LockedMessage
 FileStorHandlerImpl::Stripe::getNextMessage(vespalib::steady_time deadline)
 {
-    std::unique_lock guard(*_lock);
+    DeferredReplySender expired(_messageSender); // Must outlive the guard
+    auto guard = lockStripe();
     ThrottleToken throttle_token;
     // Try to grab a message+lock, immediately retrying once after a wait
     // if none can be found and then exiting if the same is the case on the
@@ -949,12 +1074,9 @@ FileStorHandlerImpl::Stripe::getNextMessage(vespalib::steady_time deadline)
     // ticks at regular intervals while not busy-waiting.
     for (int attempt = 0; (attempt < 2) && !_owner.isPaused(); ++attempt) {
         PriorityIdx& idx(bmi::get<1>(*_queue));
-        PriorityIdx::iterator iter(idx.begin()), end(idx.end());
+        PriorityIdx::iterator iter(next_runnable_message(guard, idx, expired.replies())), end(idx.end());
         bool was_throttled = false;
 
-        while ((iter != end) && operationIsInhibited(guard, iter->_bucket, *iter->_command)) {
-            iter++;
-        }
         if (iter != end) {
             const bool should_throttle_op = operation_type_should_be_throttled(iter->_command->getType().getId());
             if (!should_throttle_op && throttle_token.valid()) {
@@ -1021,7 +1143,10 @@ FileStorHandler::LockedMessage
 FileStorHandlerImpl::Stripe::getMessage(monitor_guard & guard, PriorityIdx & idx, PriorityIdx::iterator iter,
                                         ThrottleToken throttle_token)
 {
-    std::chrono::milliseconds waitTime(uint64_t(iter->_timer.stop(_metrics->averageQueueWaitingTime)));
+    const double wait_ms = iter->_timer.stop(_metrics->averageQueueWaitingTime);
+    _metrics->queue_wait_for_priority(iter->_priority).addValue(wait_ms);
+    _owner.record_dequeued_operation(wait_ms);
+    const std::chrono::milliseconds waitTime(static_cast<int64_t>(wait_ms));
 
     std::shared_ptr<api::StorageMessage> msg = std::move(iter->_command);
     document::Bucket bucket(iter->_bucket);
@@ -1043,10 +1168,49 @@ FileStorHandlerImpl::Stripe::getMessage(monitor_guard & guard, PriorityIdx & idx
     }
 }
 
+std::vector<FileStorHandler::LockedMessage>
+FileStorHandlerImpl::Stripe::next_batchable_messages(const FileStorHandler::LockedMessage& locked, uint32_t max_count)
+{
+    std::vector<FileStorHandler::LockedMessage> batch;
+    if (max_count == 0) {
+        return batch;
+    }
+    const document::Bucket& bucket = locked.lock->getBucket();
+    const uint8_t priority = locked.msg->getPriority();
+    const auto now = vespalib::steady_clock::now();
+    auto guard = lockStripe();
+    BucketIdx& idx(bmi::get<2>(*_queue));
+    auto iter = idx.lower_bound(bucket);
+    // Entries for the same bucket are in the order they were queued. Stop at the first one that
+    // cannot be batched, as taking later ones would reorder them relative to it. Operations
+    // with the same priority as the locked one were all queued after it.
+    while ((batch.size() < max_count) && (iter != idx.end()) && (iter->_bucket == bucket)) {
+        if ((iter->_priority != priority) || iter->has_expired(now)
+            || !AsyncHandler::is_async_unconditional_message(*iter->_command))
+        {
+            break;
+        }
+        auto throttle_token = _owner.operation_throttler().try_acquire_one();
+        if (!throttle_token.valid()) {
+            _metrics->throttled_persistence_thread_polls.inc();
+            break;
+        }
+        const double wait_ms = iter->_timer.stop(_metrics->averageQueueWaitingTime);
+        _metrics->queue_wait_for_priority(iter->_priority).addValue(wait_ms);
+        _owner.record_dequeued_operation(wait_ms);
+        batch.emplace_back(locked.lock, iter->_command, std::move(throttle_token));
+        iter = idx.erase(iter);
+    }
+    if ( ! batch.empty()) {
+        update_cached_queue_size(guard);
+    }
+    return batch;
+}
+
 void
 FileStorHandlerImpl::Stripe::waitUntilNoLocks() const
 {
-    std::unique_lock guard(*_lock);
+    auto guard = lockStripe();
     while (!_lockedBuckets.empty()) {
         _cond->wait_for(guard, 100ms);
     }
@@ -1054,7 +1218,7 @@ FileStorHandlerImpl::Stripe::waitUntilNoLocks() const
 
 void
 FileStorHandlerImpl::Stripe::waitInactive(const AbortBucketOperationsCommand& cmd) const {
-    std::unique_lock guard(*_lock);
+    auto guard = lockStripe();
     while (hasActive(guard, cmd)) {
         _cond->wait_for(guard, 100ms);
     }
@@ -1076,7 +1240,7 @@ void
 FileStorHandlerImpl::Stripe::abort(std::vector<std::shared_ptr<api::StorageReply>> & aborted,
                                    const AbortBucketOperationsCommand& cmd)
 {
-    std::lock_guard lockGuard(*_lock);
+    auto lockGuard = lockStripe();
     for (auto it(_queue->begin()); it != _queue->end();) {
         api::StorageMessage& msg(*it->_command);
         if (messageMayBeAborted(msg) && cmd.shouldAbort(it->_bucket)) {
@@ -1093,7 +1257,7 @@ bool
 FileStorHandlerImpl::Stripe::schedule(MessageEntry messageEntry)
 {
     {
-        std::lock_guard guard(*_lock);
+        auto guard = lockStripe();
         _queue->emplace_back(std::move(messageEntry));
         update_cached_queue_size(guard);
     }
@@ -1104,7 +1268,7 @@ FileStorHandlerImpl::Stripe::schedule(MessageEntry messageEntry)
 FileStorHandler::LockedMessage
 FileStorHandlerImpl::Stripe::schedule_and_get_next_async_message(MessageEntry entry)
 {
-    std::unique_lock guard(*_lock);
+    auto guard = lockStripe();
     _queue->emplace_back(std::move(entry));
     update_cached_queue_size(guard);
     auto lockedMessage = get_next_async_message(guard);
@@ -1117,7 +1281,7 @@ FileStorHandlerImpl::Stripe::schedule_and_get_next_async_message(MessageEntry en
 void
 FileStorHandlerImpl::Stripe::flush()
 {
-    std::unique_lock guard(*_lock);
+    auto guard = lockStripe();
     while (!(_queue->empty() && _lockedBuckets.empty())) {
         LOG(debug, "Still %ld in queue and %ld locked buckets", _queue->size(), _lockedBuckets.size());
         _cond->wait_for(guard, 100ms);
@@ -1153,7 +1317,7 @@ FileStorHandlerImpl::Stripe::release(const document::Bucket & bucket,
                                      api::StorageMessage::Id lockMsgId,
                                      bool was_active_merge)
 {
-    std::unique_lock guard(*_lock);
+    auto guard = lockStripe();
     auto iter = _lockedBuckets.find(bucket);
     assert(iter != _lockedBuckets.end());
     auto& entry = iter->second;
@@ -1193,7 +1357,7 @@ FileStorHandlerImpl::Stripe::release(const document::Bucket & bucket,
 void
 FileStorHandlerImpl::Stripe::decrease_active_sync_merges_counter() noexcept
 {
-    std::unique_lock guard(*_lock);
+    auto guard = lockStripe();
     assert(_active_merges > 0);
     const bool may_have_blocked_merge = (_active_merges == _owner._max_active_merges_per_stripe);
     --_active_merges;
@@ -1335,7 +1499,7 @@ FileStorHandlerImpl::dumpActiveHtml(std::ostream & os) const
 void
 FileStorHandlerImpl::Stripe::dumpQueueHtml(std::ostream & os) const
 {
-    std::lock_guard guard(*_lock);
+    auto guard = lockStripe();
 
     const PriorityIdx& idx = bmi::get<1>(*_queue);
     for (const auto & entry : idx) {
@@ -1360,7 +1524,7 @@ void
 FileStorHandlerImpl::Stripe::dumpActiveHtml(std::ostream & os) const
 {
     Clock::time_point now = Clock::now();
-    std::lock_guard guard(*_lock);
+    auto guard = lockStripe();
     for (const auto & e : _lockedBuckets) {
         if (e.second._exclusiveLock) {
             dump_lock_entry(e.first.getBucketId(), *e.second._exclusiveLock,
@@ -1376,7 +1540,7 @@ FileStorHandlerImpl::Stripe::dumpActiveHtml(std::ostream & os) const
 void
 FileStorHandlerImpl::Stripe::dumpQueue(std::ostream & os) const
 {
-    std::lock_guard guard(*_lock);
+    auto guard = lockStripe();
 
     const PriorityIdx& idx = bmi::get<1>(*_queue);
     for (const auto & entry : idx) {
@@ -17,6 +17,7 @@
 
 #include "filestorhandler.h"
 #include "active_operations_stats.h"
+#include "persistence_concurrency_controller.h"
 #include <vespa/document/bucket/bucketid.h>
 #include <vespa/metrics/metrictimer.h>
 #include <vespa/storage/common/servicelayercomponent.h>
@@ -31,6 +32,9 @@
 #include <vespa/storage/common/messagesender.h>
 #include <vespa/vespalib/stllike/hash_map.h>
 #include <vespa/vespalib/datastore/atomic_value_wrapper.h>
+#include <vespa/vespalib/util/cpu_usage.h>
+#include <vespa/vespalib/util/lock_stats.h>
+#include <vespa/vespalib/util/time.h>
 #include <atomic>
 #include <optional>
 
@@ -52,6 +56,7 @@ public:
     struct MessageEntry {
         std::shared_ptr<api::StorageMessage> _command;
         metrics::MetricTimer _timer;
+        vespalib::steady_time _deadline;
         document::Bucket _bucket;
         uint8_t _priority;
 
@@ -64,6 +69,10 @@ public:
         bool operator<(const MessageEntry& entry) const {
             return (_priority < entry._priority);
         }
+        // Replies never expire
+        [[nodiscard]] bool has_expired(vespalib::steady_time now) const noexcept {
+            return (now >= _deadline);
+        }
     };
 
     using PriorityOrder = bmi::ordered_non_unique<bmi::identity<MessageEntry> >;
@@ -155,10 +164,13 @@ public:
         void failOperations(const document::Bucket & bucket, const api::ReturnCode & code);
 
         FileStorHandler::LockedMessage getNextMessage(vespalib::steady_time deadline);
+        std::vector<FileStorHandler::LockedMessage> next_batchable_messages(const FileStorHandler::LockedMessage& locked,
+                                                                            uint32_t max_count);
         void dumpQueue(std::ostream & os) const;
         void dumpActiveHtml(std::ostream & os) const;
         void dumpQueueHtml(std::ostream & os) const;
         std::mutex & exposeLock() { return *_lock; }
+        monitor_guard lockStripe() const { return _lockStats->lock(*_lock); }
         PriorityQueue & exposeQueue() { return *_queue; }
         BucketIdx & exposeBucketIdx() { return bmi::get<2>(*_queue); }
         void setMetrics(FileStorStripeMetrics * metrics) { _metrics = metrics; }
@@ -172,6 +184,11 @@ public:
         }
         bool hasActive(monitor_guard & monitor, const AbortBucketOperationsCommand& cmd) const;
         FileStorHandler::LockedMessage get_next_async_message(monitor_guard& guard);
+        // Returns the first entry in priority order that is not inhibited by a bucket lock,
+        // or end. Expired entries seen on the way are removed and their timeout replies
+        // appended to `expired`, which must be sent only after the stripe lock is released.
+        PriorityIdx::iterator next_runnable_message(const monitor_guard& guard, PriorityIdx& idx,
+                                                    std::vector<std::shared_ptr<api::StorageReply>>& expired);
         [[nodiscard]] bool operation_type_should_be_throttled(api::MessageType::Id type_id) const noexcept;
 
         // Precondition: the bucket used by `iter`s operation is not locked in a way that conflicts
@@ -184,6 +201,7 @@ public:
         MessageSender                  &_messageSender;
         FileStorStripeMetrics          *_metrics;
         std::unique_ptr<std::mutex>                _lock;
+        vespalib::LockStats                       *_lockStats;
         std::unique_ptr<std::condition_variable>   _cond;
         std::unique_ptr<PriorityQueue>  _queue;
         atomic_size_t                   _cached_queue_size;
@@ -234,6 +252,7 @@ public:
     ScheduleAsyncResult schedule_and_get_next_async_message(const std::shared_ptr<api::StorageMessage>& msg) override;
 
     FileStorHandler::LockedMessage getNextMessage(uint32_t stripeId, vespalib::steady_time deadline) override;
+    std::vector<LockedMessage> next_batchable_messages(const LockedMessage& locked, uint32_t max_count) override;
 
     void remapQueueAfterJoin(const RemapInfo& source, RemapInfo& target) override;
     void remapQueueAfterSplit(const RemapInfo& source, RemapInfo& target1, RemapInfo& target2) override;
@@ -292,6 +311,14 @@ public:
         _throttle_apply_bucket_diff_ops.store(throttle_apply_bucket_diff, std::memory_order_relaxed);
     }
 
+    [[nodiscard]] bool persistence_thread_is_active(uint32_t thread_index) const noexcept override {
+        return (thread_index < _active_persistence_threads.load(std::memory_order_relaxed));
+    }
+
+    void use_adaptive_persistence_concurrency(bool enabled) noexcept override {
+        _adaptive_persistence_concurrency.store(enabled, std::memory_order_relaxed);
+    }
+
     // Implements ResumeGuard::Callback
     void resume() override;
 
@@ -316,6 +343,18 @@ private:
     std::atomic<bool>               _paused;
     std::atomic<bool>               _throttle_apply_bucket_diff_ops;
     std::optional<ActiveOperationsStats> _last_active_operations_stats;
+    // Adaptive persistence concurrency. Queue wait and dequeue counters are updated by
+    // the stripes, everything else only by the metric update hook.
+    const uint32_t                    _num_persistence_threads;
+    std::atomic<uint32_t>             _active_persistence_threads;
+    std::atomic<bool>                 _adaptive_persistence_concurrency;
+    mutable std::atomic<uint64_t>     _total_queue_wait_us;
+    mutable std::atomic<uint64_t>     _total_dequeued_ops;
+    PersistenceConcurrencyController  _concurrency_controller;
+    vespalib::CpuUtil                 _cpu_util;
+    uint64_t                          _last_total_queue_wait_us;
+    uint64_t                          _last_total_dequeued_ops;
+    vespalib::steady_time             _last_concurrency_sample_time;
 
     // Returns the index in the targets array we are sending to, or -1 if none of them match.
     int calculateTargetBasedOnDocId(const api::StorageMessage& msg, std::vector<RemapInfo*>& targets);
@@ -352,6 +391,13 @@ private:
     static bool messageMayBeAborted(const api::StorageMessage& msg);
 
     void update_active_operations_metrics();
+    void update_persistence_concurrency();
+
+    // Called by stripes whenever an operation is taken out of the queue
+    void record_dequeued_operation(double queue_wait_ms) const noexcept {
+        _total_queue_wait_us.fetch_add(static_cast<uint64_t>(queue_wait_ms * 1000.0), std::memory_order_relaxed);
+        _total_dequeued_ops.fetch_add(1, std::memory_order_relaxed);
+    }
 
     // Implements framework::MetricUpdateHook
     void updateMetrics(const MetricLockGuard &) override;
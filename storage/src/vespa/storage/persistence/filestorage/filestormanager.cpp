@@ -233,7 +233,7 @@ FileStorManager::on_configure(const StorFilestorConfig& config)
         LOG(spam, "Setting up %u persistence threads", numThreads);
         for (uint32_t i = 0; i < numThreads; i++) {
             _threads.push_back(std::make_unique<PersistenceThread>(createRegisteredHandler(_component),
-                                                                   *_filestorHandler, i % numStripes, _component));
+                                                                   *_filestorHandler, i % numStripes, i, _component));
         }
         _bucketExecutorRegistration = _provider->register_executor(std::make_shared<BucketExecutorWrapper>(*this));
     } else {
@@ -245,10 +245,12 @@ FileStorManager::on_configure(const StorFilestorConfig& config)
     {
         _filestorHandler->use_dynamic_operation_throttling(use_dynamic_throttling);
         _filestorHandler->set_throttle_apply_bucket_diff_ops(!throttle_merge_feed_ops);
+        _filestorHandler->use_adaptive_persistence_concurrency(config.adaptivePersistenceThreadCount);
         std::lock_guard guard(_lock);
         for (auto& ph : _persistenceHandlers) {
             ph->set_throttle_merge_feed_ops(throttle_merge_feed_ops);
             ph->set_use_per_document_throttled_delete_bucket(config.usePerDocumentThrottledDeleteBucket);
+            ph->set_max_feed_op_batch_size(std::max(config.maxFeedOpBatchSize, 1));
         }
     }
 }
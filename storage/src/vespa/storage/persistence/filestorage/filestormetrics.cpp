@@ -1,6 +1,7 @@
 // Copyright Vespa.ai. Licensed under the terms of the Apache 2.0 license. See LICENSE in the project root.
 #include "filestormetrics.h"
 #include <vespa/metrics/summetric.hpp>
+#include <vespa/storageapi/messageapi/storagemessage.h>
 #include <sstream>
 
 namespace storage {
@@ -172,6 +173,8 @@ FileStorThreadMetrics::FileStorThreadMetrics(const std::string& name, const std:
       applyBucketDiff("applybucketdiff", "Number of applybucketdiff commands that have been processed.", this),
       getBucketDiffReply("getbucketdiffreply", {}, "Number of getbucketdiff replies that have been processed.", this),
       applyBucketDiffReply("applybucketdiffreply", {}, "Number of applybucketdiff replies that have been processed.", this),
+      feed_op_batch_size("feed_op_batch_size", {}, "Number of operations in each batch of puts, updates and "
+                         "removes handed to the persistence provider together", this),
       merge_handler_metrics(this)
 { }
 
@@ -180,6 +183,14 @@ FileStorThreadMetrics::~FileStorThreadMetrics() = default;
 FileStorStripeMetrics::FileStorStripeMetrics(const std::string& name, const std::string& description)
     : MetricSet(name, {{"partofsum"}}, description),
       averageQueueWaitingTime("averagequeuewait", {}, "Average time an operation spends in input queue.", this),
+      queue_wait_high_pri("queue_wait_high_pri", {}, "Average time an operation with a priority higher "
+                          "than normal spends in input queue.", this),
+      queue_wait_normal_pri("queue_wait_normal_pri", {}, "Average time an operation with normal priority "
+                            "spends in input queue.", this),
+      queue_wait_low_pri("queue_wait_low_pri", {}, "Average time an operation with low priority "
+                         "spends in input queue.", this),
+      expired_in_queue("expired_in_queue", {}, "Number of operations failed with a timeout because their "
+                       "deadline passed while they were waiting in input queue", this),
       throttled_rpc_direct_dispatches("throttled_rpc_direct_dispatches", {},
                                       "Number of times an RPC thread could not directly dispatch an async operation "
                                       "directly to Proton because it was disallowed by the throttle policy", this),
@@ -194,6 +205,17 @@ FileStorStripeMetrics::FileStorStripeMetrics(const std::string& name, const std:
 
 FileStorStripeMetrics::~FileStorStripeMetrics() = default;
 
+metrics::DoubleAverageMetric&
+FileStorStripeMetrics::queue_wait_for_priority(uint8_t priority) noexcept
+{
+    if (priority < api::StorageMessage::NORMAL) {
+        return queue_wait_high_pri;
+    } else if (priority < api::StorageMessage::LOW) {
+        return queue_wait_normal_pri;
+    }
+    return queue_wait_low_pri;
+}
+
 FileStorMetrics::FileStorMetrics()
     : MetricSet("filestor", {{"filestor"}}, ""),
       sumThreads("allthreads", {{"sum"}}, "", this),
@@ -204,6 +226,8 @@ FileStorMetrics::FileStorMetrics()
       throttle_window_size("throttle_window_size", {}, "Current size of async operation throttler window size", this),
       throttle_waiting_threads("throttle_waiting_threads", {}, "Number of threads waiting to acquire a throttle token", this),
       throttle_active_tokens("throttle_active_tokens", {}, "Current number of active throttle tokens", this),
+      active_persistence_threads("active_persistence_threads", {}, "Number of persistence threads currently "
+                                 "allowed to process operations", this),
       active_operations(this),
       bucket_db_init_latency("bucket_db_init_latency", {}, "Time taken (in ms) to initialize bucket databases with "
                                                            "information from the persistence provider", this)
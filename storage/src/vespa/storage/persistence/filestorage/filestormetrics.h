@@ -7,6 +7,7 @@
 
 #include "merge_handler_metrics.h"
 #include "active_operations_metrics.h"
+#include <vespa/metrics/histogrammetric.h>
 #include <vespa/metrics/metricset.h>
 #include <vespa/metrics/summetric.h>
 
@@ -19,7 +20,7 @@ struct FileStorThreadMetrics : public metrics::MetricSet
     struct Op : metrics::MetricSet {
         std::string _name;
         metrics::LongCountMetric count;
-        metrics::DoubleAverageMetric latency;
+        metrics::HistogramMetric latency;
         metrics::LongCountMetric failed;
 
         Op(const std::string& id, const std::string& name, MetricSet* owner = nullptr);
@@ -107,6 +108,7 @@ struct FileStorThreadMetrics : public metrics::MetricSet
     Op applyBucketDiff;
     metrics::LongCountMetric getBucketDiffReply;
     metrics::LongCountMetric applyBucketDiffReply;
+    metrics::LongAverageMetric feed_op_batch_size;
     MergeHandlerMetrics merge_handler_metrics;
 
     FileStorThreadMetrics(const std::string& name, const std::string& desc);
@@ -118,11 +120,17 @@ class FileStorStripeMetrics : public metrics::MetricSet
 public:
     using SP = std::shared_ptr<FileStorStripeMetrics>;
     metrics::DoubleAverageMetric averageQueueWaitingTime;
+    metrics::DoubleAverageMetric queue_wait_high_pri;
+    metrics::DoubleAverageMetric queue_wait_normal_pri;
+    metrics::DoubleAverageMetric queue_wait_low_pri;
+    metrics::LongCountMetric expired_in_queue;
     metrics::LongCountMetric throttled_rpc_direct_dispatches;
     metrics::LongCountMetric throttled_persistence_thread_polls;
     metrics::LongCountMetric timeouts_waiting_for_throttle_token;
     FileStorStripeMetrics(const std::string& name, const std::string& description);
     ~FileStorStripeMetrics() override;
+
+    metrics::DoubleAverageMetric& queue_wait_for_priority(uint8_t priority) noexcept;
 };
 
 struct FileStorMetrics : public metrics::MetricSet
@@ -137,6 +145,7 @@ struct FileStorMetrics : public metrics::MetricSet
     metrics::LongAverageMetric    throttle_window_size;
     metrics::LongAverageMetric    throttle_waiting_threads;
     metrics::LongAverageMetric    throttle_active_tokens;
+    metrics::LongAverageMetric    active_persistence_threads;
     ActiveOperationsMetrics       active_operations;
     metrics::LongAverageMetric    bucket_db_init_latency;
 
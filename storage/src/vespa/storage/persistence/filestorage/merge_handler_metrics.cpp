@@ -20,6 +20,9 @@ MergeHandlerMetrics::MergeHandlerMetrics(metrics::MetricSet* owner)
                             "current node.", owner),
       mergeAverageDataReceivedNeeded("mergeavgdatareceivedneeded", {}, "Amount of data transferred from previous node "
                                                                        "in chain that we needed to apply locally.", owner),
+      mergesCompletedByRangeDigest("merges_completed_by_range_digest", {},
+                                   "Number of merges where range checksums were equal on all "
+                                   "nodes, so no diff had to be exchanged.", owner),
       put_latency("put_latency", {}, "Latency of individual puts that are part of merge operations", owner),
       remove_latency("remove_latency", {}, "Latency of individual removes that are part of merge operations", owner)
 {}
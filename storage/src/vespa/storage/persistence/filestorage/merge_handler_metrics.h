@@ -19,6 +19,7 @@ struct MergeHandlerMetrics {
     metrics::DoubleAverageMetric mergeDataReadLatency;
     metrics::DoubleAverageMetric mergeDataWriteLatency;
     metrics::DoubleAverageMetric mergeAverageDataReceivedNeeded;
+    metrics::LongCountMetric mergesCompletedByRangeDigest;
     // Individual operation metrics. These capture both count and latency sum, so
     // no need for explicit count metric on the side.
     metrics::DoubleAverageMetric put_latency;
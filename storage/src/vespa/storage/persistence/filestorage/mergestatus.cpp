@@ -13,7 +13,8 @@ MergeStatus::MergeStatus(const framework::Clock& clock,
                          api::StorageMessage::Priority priority,
                          uint32_t traceLevel)
     : reply(), full_node_list(), nodeList(), maxTimestamp(0), diff(), pendingId(0),
-      pendingGetDiff(), pendingApplyDiff(), timeout(0), startTime(clock),
+      pendingGetDiff(), pendingApplyDiff(), rangeDigestPending(false), rangeDigestEntries(),
+      timeout(0), startTime(clock), chunkSize(0), applyDiffStartTime(clock),
       delayed_error(),
       context(priority, traceLevel)
 {}
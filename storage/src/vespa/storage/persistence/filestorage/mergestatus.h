@@ -26,8 +26,16 @@ public:
     api::StorageMessage::Id pendingId;
     std::shared_ptr<api::GetBucketDiffReply> pendingGetDiff;
     std::shared_ptr<api::ApplyBucketDiffReply> pendingApplyDiff;
+    // Set on the first node while waiting for a range digest reply. The
+    // local entries are kept to build the diff for differing ranges.
+    bool rangeDigestPending;
+    std::vector<api::GetBucketDiffCommand::Entry> rangeDigestEntries;
     vespalib::duration timeout;
     framework::MilliSecTimer startTime;
+    // Chunk size used for apply bucket diff rounds sent from the first node,
+    // adapted to round trip times. 0 until adapted.
+    uint32_t chunkSize;
+    framework::MilliSecTimer applyDiffStartTime;
     std::optional<std::future<vespalib::string>> delayed_error;
     spi::Context context;
  	
@@ -0,0 +1,67 @@
+// Copyright Vespa.ai. Licensed under the terms of the Apache 2.0 license. See LICENSE in the project root.
+
+#include "persistence_concurrency_controller.h"
+#include <algorithm>
+
+namespace storage {
+
+PersistenceConcurrencyController::Params::Params(uint32_t min_threads_in, uint32_t max_threads_in) noexcept
+    : min_threads(std::max(min_threads_in, 1u)),
+      max_threads(std::max(max_threads_in, std::max(min_threads_in, 1u))),
+      cpu_saturation_threshold(0.9),
+      queue_wait_threshold_ms(1.0),
+      min_throughput_gain(0.05),
+      hold_periods_after_revert(3)
+{
+}
+
+PersistenceConcurrencyController::PersistenceConcurrencyController(const Params& params) noexcept
+    : _params(params),
+      _active_threads(params.max_threads),
+      _last_throughput(0.0),
+      _last_step_was_increase(false),
+      _hold_periods_left(0)
+{
+}
+
+uint32_t
+PersistenceConcurrencyController::on_sample(const Sample& sample) noexcept
+{
+    const bool was_increase = _last_step_was_increase;
+    const double last_throughput = _last_throughput;
+    _last_step_was_increase = false;
+    _last_throughput = sample.throughput;
+    if (_hold_periods_left > 0) {
+        --_hold_periods_left;
+    }
+
+    if (sample.cpu_util >= _params.cpu_saturation_threshold) {
+        if (_active_threads > _params.min_threads) {
+            --_active_threads;
+        }
+    } else if (was_increase && (sample.throughput < last_throughput * (1.0 + _params.min_throughput_gain))) {
+        // The extra thread did not pay for itself
+        if (_active_threads > _params.min_threads) {
+            --_active_threads;
+        }
+        _hold_periods_left = _params.hold_periods_after_revert;
+    } else if ((sample.avg_queue_wait_ms > _params.queue_wait_threshold_ms)
+               && (_hold_periods_left == 0)
+               && (_active_threads < _params.max_threads))
+    {
+        ++_active_threads;
+        _last_step_was_increase = true;
+    }
+    return _active_threads;
+}
+
+void
+PersistenceConcurrencyController::reset() noexcept
+{
+    _active_threads = _params.max_threads;
+    _last_throughput = 0.0;
+    _last_step_was_increase = false;
+    _hold_periods_left = 0;
+}
+
+}
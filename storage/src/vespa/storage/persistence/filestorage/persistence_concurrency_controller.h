@@ -0,0 +1,60 @@
+// Copyright Vespa.ai. Licensed under the terms of the Apache 2.0 license. See LICENSE in the project root.
+#pragma once
+
+#include <cstdint>
+
+namespace storage {
+
+/**
+ * Hill climbing controller for the number of persistence threads that are allowed to
+ * process operations concurrently.
+ *
+ * The controller is fed one sample per control period and adjusts the active thread
+ * count by at most one thread per sample:
+ *
+ *  - If the CPU is saturated, a thread is removed, since more threads would only add
+ *    contention.
+ *  - If the previous adjustment added a thread and throughput did not improve by at
+ *    least min_throughput_gain, the thread is removed again and growth is held off
+ *    for a few periods before probing again.
+ *  - Otherwise, if operations are waiting in queue for longer than queue_wait_threshold_ms,
+ *    a thread is added.
+ *
+ * Idle threads are not removed, as parked threads have no cost worth saving.
+ *
+ * Not thread safe.
+ */
+class PersistenceConcurrencyController {
+public:
+    struct Params {
+        uint32_t min_threads;
+        uint32_t max_threads;
+        double   cpu_saturation_threshold; // Fraction of all cores in [0, 1]
+        double   queue_wait_threshold_ms;
+        double   min_throughput_gain;      // Relative, e.g. 0.05 == 5%
+        uint32_t hold_periods_after_revert;
+
+        Params(uint32_t min_threads_in, uint32_t max_threads_in) noexcept;
+    };
+    struct Sample {
+        double throughput;        // Operations dequeued per second
+        double avg_queue_wait_ms;
+        double cpu_util;          // Fraction of all cores in [0, 1]
+    };
+private:
+    Params   _params;
+    uint32_t _active_threads;
+    double   _last_throughput;
+    bool     _last_step_was_increase;
+    uint32_t _hold_periods_left;
+public:
+    explicit PersistenceConcurrencyController(const Params& params) noexcept;
+
+    [[nodiscard]] uint32_t active_threads() const noexcept { return _active_threads; }
+    // Returns the active thread count to use until the next sample
+    uint32_t on_sample(const Sample& sample) noexcept;
+    // Forgets all history and lets every thread be active
+    void reset() noexcept;
+};
+
+}
@@ -13,6 +13,7 @@
 #include <vespa/document/fieldvalue/document.h>
 #include <vespa/vespalib/objects/nbostream.h>
 #include <vespa/vespalib/util/exceptions.h>
+#include <vespa/vespalib/util/io_scheduler.h>
 #include <vespa/vespalib/util/isequencedtaskexecutor.h>
 #include <algorithm>
 #include <sstream>
@@ -29,7 +30,10 @@ MergeHandler::MergeHandler(PersistenceUtil& env, spi::PersistenceProvider& spi,
                            const ClusterContext& cluster_context, const framework::Clock & clock,
                            vespalib::ISequencedTaskExecutor& executor,
                            uint32_t maxChunkSize,
-                           uint32_t commonMergeChainOptimalizationMinimumSize)
+                           uint32_t commonMergeChainOptimalizationMinimumSize,
+                           uint32_t rangeDigestMinimumSize,
+                           uint32_t adaptiveMaxChunkSize,
+                           vespalib::duration adaptiveChunkTargetRoundTime)
     : _clock(clock),
       _cluster_context(cluster_context),
       _env(env),
@@ -37,6 +41,9 @@ MergeHandler::MergeHandler(PersistenceUtil& env, spi::PersistenceProvider& spi,
       _monitored_ref_count(std::make_unique<MonitoredRefCount>()),
       _maxChunkSize(maxChunkSize),
       _commonMergeChainOptimalizationMinimumSize(commonMergeChainOptimalizationMinimumSize),
+      _rangeDigestMinimumSize(rangeDigestMinimumSize),
+      _adaptiveMaxChunkSize(adaptiveMaxChunkSize),
+      _adaptiveChunkTargetRoundTime(adaptiveChunkTargetRoundTime),
       _executor(executor),
       _throttle_merge_feed_ops(true)
 {
@@ -92,6 +99,57 @@ struct DiffEntryTimestampPredicate {
 };
 
 
+/*
+ * Range digests: entries are partitioned into 64 ranges by a hash of their
+ * timestamp (which identifies an entry within a bucket), and each range gets
+ * an order independent checksum of its entries. Nodes with equal checksums for
+ * a range are assumed to have the same entries in it, so only the entries of
+ * differing ranges need to be exchanged when building the merge diff.
+ */
+constexpr uint32_t merge_range_count = 64;
+
+uint32_t merge_range_of(api::Timestamp timestamp) noexcept {
+    return (timestamp * 0x9e3779b97f4a7c15ULL) >> 58;
+}
+
+uint64_t range_entry_checksum(const api::GetBucketDiffCommand::Entry& e) noexcept {
+    uint64_t h = e._timestamp ^ (((e._flags & getDeleteFlag()) != 0) ? 0x5bd1e9955bd1e995ULL : 0);
+    h = (h ^ (h >> 30)) * 0xbf58476d1ce4e5b9ULL;
+    h = (h ^ (h >> 27)) * 0x94d049bb133111ebULL;
+    return h ^ (h >> 31);
+}
+
+std::vector<uint64_t>
+make_range_checksums(const std::vector<api::GetBucketDiffCommand::Entry>& entries) {
+    std::vector<uint64_t> checksums(merge_range_count, 0);
+    for (const auto& e : entries) {
+        checksums[merge_range_of(e._timestamp)] += range_entry_checksum(e);
+    }
+    return checksums;
+}
+
+uint64_t find_differing_ranges(const std::vector<uint64_t>& expected, const std::vector<uint64_t>& actual) noexcept {
+    if (expected.size() != actual.size()) {
+        return api::GetBucketDiffCommand::ALL_RANGES;
+    }
+    uint64_t differing = 0;
+    for (uint32_t i = 0; i < actual.size(); ++i) {
+        if (expected[i] != actual[i]) {
+            differing |= (uint64_t(1) << i);
+        }
+    }
+    return differing;
+}
+
+void retain_ranges(std::vector<api::GetBucketDiffCommand::Entry>& entries, uint64_t ranges) {
+    if (ranges == api::GetBucketDiffCommand::ALL_RANGES) {
+        return;
+    }
+    std::erase_if(entries, [ranges](const auto& e) {
+        return ((ranges >> merge_range_of(e._timestamp)) & 1) == 0;
+    });
+}
+
 void check_apply_diff_sync(std::shared_ptr<ApplyBucketDiffState> async_results) {
     auto future = async_results->get_future();
     async_results.reset();
@@ -348,8 +406,12 @@ MergeHandler::fetchLocalData(
         const spi::Bucket& bucket,
         std::vector<api::ApplyBucketDiffCommand::Entry>& diff,
         uint8_t nodeIndex,
-        spi::Context& context) const
+        spi::Context& context,
+        uint32_t maxChunkSize) const
 {
+    if (maxChunkSize == 0) {
+        maxChunkSize = _maxChunkSize;
+    }
     uint32_t nodeMask = 1 << nodeIndex;
         // Preload documents in memory
     std::vector<spi::Timestamp> slots;
@@ -362,9 +424,9 @@ MergeHandler::fetchLocalData(
             alreadyFilled += e._headerBlob.size() + e._bodyBlob.size();
         }
     }
-    uint32_t remainingSize = _maxChunkSize - std::min(_maxChunkSize, alreadyFilled);
+    uint32_t remainingSize = maxChunkSize - std::min(maxChunkSize, alreadyFilled);
     LOG(debug, "Diff of %s has already filled %u of max %u bytes, remaining size to fill is %u",
-        bucket.toString().c_str(), alreadyFilled, _maxChunkSize, remainingSize);
+        bucket.toString().c_str(), alreadyFilled, maxChunkSize, remainingSize);
     if (remainingSize == 0) {
         LOG(debug, "Diff already at max chunk size, not fetching any local data");
         return;
@@ -419,7 +481,7 @@ MergeHandler::fetchLocalData(
             } else {
                 LOG(spam, "Adding %s would exceed chunk size limit of %u; "
                     "not filling up any more diffs for current round",
-                    entry->toString().c_str(), _maxChunkSize);
+                    entry->toString().c_str(), maxChunkSize);
                 chunkLimitReached = true;
                 break;
             }
@@ -516,6 +578,8 @@ MergeHandler::applyDiffEntry(std::shared_ptr<ApplyBucketDiffState> async_results
     spi::Timestamp timestamp(e._entry._timestamp);
     if (!(e._entry._flags & (DELETED | DELETED_IN_PLACE))) {
         // Regular put entry
+        vespalib::IoScheduler::instance().acquire(vespalib::IoScheduler::Class::MERGE,
+                                                  e._headerBlob.size() + e._bodyBlob.size());
         std::shared_ptr<document::Document> doc(deserializeDiffDocument(e, repo));
         document::DocumentId docId = doc->getId();
         auto complete = std::make_unique<ApplyBucketDiffEntryComplete>(std::move(async_results), std::move(docId),
@@ -647,6 +711,29 @@ MergeHandler::applyDiffLocally(
         bucket.toString().c_str(), addedCount);
 }
 
+void
+MergeHandler::adaptChunkSize(MergeStatus& status, size_t roundEntries, size_t completedEntries) const
+{
+    if ((_adaptiveMaxChunkSize <= _maxChunkSize) || (roundEntries == 0)) {
+        return;
+    }
+    // Entries left incomplete means the round was bounded by the chunk size,
+    // i.e. more (or larger) documents would have needed more rounds.
+    bool chunkLimited = (completedEntries < roundEntries);
+    uint32_t chunkSize = (status.chunkSize != 0) ? status.chunkSize : _maxChunkSize;
+    vespalib::duration roundTime = status.applyDiffStartTime.getElapsedTime();
+    if (roundTime > 2 * _adaptiveChunkTargetRoundTime) {
+        chunkSize = std::max(chunkSize / 2, _maxChunkSize);
+    } else if (chunkLimited && (roundTime < _adaptiveChunkTargetRoundTime)) {
+        chunkSize = uint32_t(std::min(uint64_t(chunkSize) * 2, uint64_t(_adaptiveMaxChunkSize)));
+    }
+    if (chunkSize != status.chunkSize) {
+        LOG(spam, "Merge round completing %zu of %zu entries took %.3f ms. Using chunk size %u for next round.",
+            completedEntries, roundEntries, vespalib::to_s(roundTime) * 1000.0, chunkSize);
+        status.chunkSize = chunkSize;
+    }
+}
+
 void
 MergeHandler::sync_bucket_info(const spi::Bucket& bucket) const
 {
@@ -828,13 +915,15 @@ MergeHandler::processBucketMerge(const spi::Bucket& bucket, MergeStatus& status,
     }
     cmd->setPriority(status.context.getPriority());
     cmd->setTimeout(status.timeout);
+    cmd->setMaxChunkSize(status.chunkSize);
     if (async_results) {
         // Check currently pending writes to local node before sending new command.
         check_apply_diff_sync(std::move(async_results));
     }
+    status.applyDiffStartTime = framework::MilliSecTimer(_clock);
     if (applyDiffNeedLocalData(cmd->getDiff(), 0, true)) {
         framework::MilliSecTimer startTime(_clock);
-        fetchLocalData(bucket, cmd->getDiff(), 0, context);
+        fetchLocalData(bucket, cmd->getDiff(), 0, context, status.chunkSize);
         _env._metrics.merge_handler_metrics.mergeDataReadLatency.addValue(startTime.getElapsedTimeAsDouble());
     }
     status.pendingId = cmd->getMsgId();
@@ -947,12 +1036,20 @@ MergeHandler::handleMergeBucket(api::MergeBucketCommand& cmd, MessageTracker::UP
         return tracker;
     }
     _env._metrics.merge_handler_metrics.mergeMetadataReadLatency.addValue(s->startTime.getElapsedTimeAsDouble());
+    if ((_rangeDigestMinimumSize != 0) && (cmd2->getDiff().size() >= _rangeDigestMinimumSize)) {
+        // Compare range checksums first, keeping our entries until we know which ranges differ
+        cmd2->getRangeChecksums() = make_range_checksums(cmd2->getDiff());
+        cmd2->setRangeMask(0);
+        s->rangeDigestEntries.swap(cmd2->getDiff());
+        s->rangeDigestPending = true;
+    }
     LOG(spam, "Sending GetBucketDiff %" PRIu64 " for %s to next node %u "
-        "with diff of %u entries.",
+        "with diff of %u entries%s.",
         cmd2->getMsgId(),
         bucket.toString().c_str(),
         s->nodeList[1].index,
-        uint32_t(cmd2->getDiff().size()));
+        uint32_t(cmd2->getDiff().size()),
+        (s->rangeDigestPending ? " (range digest)" : ""));
     cmd2->setAddress(createAddress(_cluster_context.cluster_name_ptr(), s->nodeList[1].index));
     cmd2->setPriority(s->context.getPriority());
     cmd2->setTimeout(s->timeout);
@@ -1114,8 +1211,16 @@ MergeHandler::handleGetBucketDiffStage2(api::GetBucketDiffCommand& cmd, MessageT
         tracker->fail(api::ReturnCode::BUCKET_DELETED, "Bucket not found in buildBucketInfo step");
         return tracker;
     }
-    if (!mergeLists(remote, local, local)) {
-        LOG(error, "Diffing %s found suspect entries.", bucket.toString().c_str());
+    const bool rangeDigest = cmd.isRangeDigest();
+    uint64_t differingRanges = 0;
+    if (rangeDigest) {
+        differingRanges = cmd.getRangeMask() | find_differing_ranges(cmd.getRangeChecksums(), make_range_checksums(local));
+        local.clear();
+    } else {
+        retain_ranges(local, cmd.getRangeMask());
+        if (!mergeLists(remote, local, local)) {
+            LOG(error, "Diffing %s found suspect entries.", bucket.toString().c_str());
+        }
     }
     _env._metrics.merge_handler_metrics.mergeMetadataReadLatency.addValue(startTime.getElapsedTimeAsDouble());
 
@@ -1142,6 +1247,9 @@ MergeHandler::handleGetBucketDiffStage2(api::GetBucketDiffCommand& cmd, MessageT
 
         auto reply = std::make_shared<api::GetBucketDiffReply>(cmd);
         reply->getDiff().swap(final);
+        if (rangeDigest) {
+            reply->setDifferingRanges(differingRanges);
+        }
         tracker->setReply(std::move(reply));
     } else {
         // When not the last node in merge chain, we must save reply, and
@@ -1159,6 +1267,12 @@ MergeHandler::handleGetBucketDiffStage2(api::GetBucketDiffCommand& cmd, MessageT
         auto cmd2 = std::make_shared<api::GetBucketDiffCommand>(bucket.getBucket(), cmd.getNodes(), cmd.getMaxTimestamp());
         cmd2->setAddress(createAddress(_cluster_context.cluster_name_ptr(), cmd.getNodes()[index + 1].index));
         cmd2->getDiff().swap(local);
+        if (rangeDigest) {
+            cmd2->getRangeChecksums() = cmd.getRangeChecksums();
+            cmd2->setRangeMask(differingRanges);
+        } else {
+            cmd2->setRangeMask(cmd.getRangeMask());
+        }
         cmd2->setPriority(cmd.getPriority());
         cmd2->setTimeout(cmd.getTimeout());
         s->pendingId = cmd2->getMsgId();
@@ -1200,6 +1314,9 @@ MergeHandler::handleGetBucketDiffReply(api::GetBucketDiffReply& reply, MessageSe
             if (reply.getResult().failed()) {
                 // We failed, so we should reply to the pending message.
                 replyToSend = s->reply;
+            } else if (s->rangeDigestPending) {
+                replyToSend = handleRangeDigestReply(bucket, *s, reply, sender);
+                clearState = static_cast<bool>(replyToSend);
             } else {
                 // If we didn't fail, reply should have good content
                 // Sanity check for nodes
@@ -1229,6 +1346,9 @@ MergeHandler::handleGetBucketDiffReply(api::GetBucketDiffReply& reply, MessageSe
                 "size %zu. Sending it on.",
                 bucket.toString().c_str(), reply.getDiff().size());
             s->pendingGetDiff->getDiff().swap(reply.getDiff());
+            if (reply.rangesCompared()) {
+                s->pendingGetDiff->setDifferingRanges(reply.getDifferingRanges());
+            }
         }
     } catch (std::exception& e) {
         _env._fileStorHandler.clearMergeStatus(
@@ -1247,6 +1367,36 @@ MergeHandler::handleGetBucketDiffReply(api::GetBucketDiffReply& reply, MessageSe
     }
 }
 
+api::StorageReply::SP
+MergeHandler::handleRangeDigestReply(const spi::Bucket& bucket, MergeStatus& status,
+                                     const api::GetBucketDiffReply& reply, MessageSender& sender) const
+{
+    status.rangeDigestPending = false;
+    // Nodes not knowing about range digests will not have compared anything,
+    // in which case we fall back to diffing all ranges.
+    uint64_t ranges = reply.rangesCompared() ? reply.getDifferingRanges() : api::GetBucketDiffCommand::ALL_RANGES;
+    if (ranges == 0) {
+        LOG(debug, "Done with merge of %s. Range checksums are equal on all nodes.", bucket.toString().c_str());
+        _env._metrics.merge_handler_metrics.mergesCompletedByRangeDigest.inc();
+        _env._metrics.merge_handler_metrics.mergeLatencyTotal.addValue(status.startTime.getElapsedTimeAsDouble());
+        return status.reply;
+    }
+    auto cmd = std::make_shared<api::GetBucketDiffCommand>(bucket.getBucket(), status.nodeList, status.maxTimestamp.getTime());
+    cmd->getDiff().swap(status.rangeDigestEntries);
+    retain_ranges(cmd->getDiff(), ranges);
+    cmd->setRangeMask(ranges);
+    LOG(spam, "Sending GetBucketDiff %" PRIu64 " for %s to next node %u "
+        "with diff of %u entries in differing ranges 0x%" PRIx64 ".",
+        cmd->getMsgId(), bucket.toString().c_str(), status.nodeList[1].index,
+        uint32_t(cmd->getDiff().size()), ranges);
+    cmd->setAddress(createAddress(_cluster_context.cluster_name_ptr(), status.nodeList[1].index));
+    cmd->setPriority(status.context.getPriority());
+    cmd->setTimeout(status.timeout);
+    status.pendingId = cmd->getMsgId();
+    sender.sendCommand(cmd);
+    return api::StorageReply::SP();
+}
+
 MessageTracker::UP
 MergeHandler::handleApplyBucketDiff(api::ApplyBucketDiffCommand& cmd, MessageTracker::UP tracker) const
 {
@@ -1266,7 +1416,7 @@ MergeHandler::handleApplyBucketDiff(api::ApplyBucketDiffCommand& cmd, MessageTra
     bool lastInChain = index + 1u >= cmd.getNodes().size();
     if (applyDiffNeedLocalData(cmd.getDiff(), index, !lastInChain)) {
        framework::MilliSecTimer startTime(_clock);
-        fetchLocalData(bucket, cmd.getDiff(), index, tracker->context());
+        fetchLocalData(bucket, cmd.getDiff(), index, tracker->context(), cmd.getMaxChunkSize());
         _env._metrics.merge_handler_metrics.mergeDataReadLatency.addValue(startTime.getElapsedTimeAsDouble());
     } else {
         LOG(spam, "Merge(%s): Moving %zu entries, didn't need "
@@ -1323,6 +1473,7 @@ MergeHandler::handleApplyBucketDiff(api::ApplyBucketDiffCommand& cmd, MessageTra
         cmd2->getDiff().swap(cmd.getDiff());
         cmd2->setPriority(cmd.getPriority());
         cmd2->setTimeout(cmd.getTimeout());
+        cmd2->setMaxChunkSize(cmd.getMaxChunkSize());
         s->pendingId = cmd2->getMsgId();
         if (async_results) {
             // Reply handler should check for delayed error.
@@ -1375,7 +1526,7 @@ MergeHandler::handleApplyBucketDiffReply(api::ApplyBucketDiffReply& reply, Messa
             uint8_t index = findOwnIndex(reply.getNodes(), _env._nodeIndex);
             if (applyDiffNeedLocalData(diff, index, false)) {
                 framework::MilliSecTimer startTime(_clock);
-                fetchLocalData(bucket, diff, index, s->context);
+                fetchLocalData(bucket, diff, index, s->context, reply.getMaxChunkSize());
                 _env._metrics.merge_handler_metrics.mergeDataReadLatency.addValue(startTime.getElapsedTimeAsDouble());
             }
             if (applyDiffHasLocallyNeededData(diff, index)) {
@@ -1419,6 +1570,7 @@ MergeHandler::handleApplyBucketDiffReply(api::ApplyBucketDiffReply& reply, Messa
                 // Should reply now, since we failed.
                 replyToSend = s->reply;
             } else {
+                adaptChunkSize(*s, diff.size(), diffSizeBefore - s->diff.size());
                 replyToSend = processBucketMerge(bucket, *s, sender, s->context, async_results);
 
                 if (!replyToSend.get()) {
@@ -19,6 +19,7 @@
 #include <vespa/storage/common/cluster_context.h>
 #include <vespa/storage/common/messagesender.h>
 #include <vespa/vespalib/util/monitored_refcount.h>
+#include <vespa/vespalib/util/time.h>
 #include <vespa/storageframework/generic/clock/time.h>
 #include <atomic>
 
@@ -53,7 +54,10 @@ public:
                  const ClusterContext& cluster_context, const framework::Clock & clock,
                  vespalib::ISequencedTaskExecutor& executor,
                  uint32_t maxChunkSize = 4190208,
-                 uint32_t commonMergeChainOptimalizationMinimumSize = 64);
+                 uint32_t commonMergeChainOptimalizationMinimumSize = 64,
+                 uint32_t rangeDigestMinimumSize = 0,
+                 uint32_t adaptiveMaxChunkSize = 0,
+                 vespalib::duration adaptiveChunkTargetRoundTime = std::chrono::milliseconds(500));
 
     ~MergeHandler() override;
 
@@ -66,7 +70,8 @@ public:
     void fetchLocalData(const spi::Bucket& bucket,
                         std::vector<api::ApplyBucketDiffCommand::Entry>& diff,
                         uint8_t nodeIndex,
-                        spi::Context& context) const;
+                        spi::Context& context,
+                        uint32_t maxChunkSize = 0) const;
     void applyDiffLocally(const spi::Bucket& bucket,
                           std::vector<api::ApplyBucketDiffCommand::Entry>& diff,
                           uint8_t nodeIndex,
@@ -100,10 +105,27 @@ private:
     std::unique_ptr<vespalib::MonitoredRefCount> _monitored_ref_count;
     const uint32_t            _maxChunkSize;
     const uint32_t            _commonMergeChainOptimalizationMinimumSize;
+    // Buckets with at least this many entries on the first node start the
+    // merge by comparing range checksums. 0 disables range digests.
+    const uint32_t            _rangeDigestMinimumSize;
+    // The chunk size of apply bucket diff rounds sent from the first node is
+    // adapted between _maxChunkSize and this value, aiming for rounds taking
+    // _adaptiveChunkTargetRoundTime. Disabled if not above _maxChunkSize.
+    const uint32_t            _adaptiveMaxChunkSize;
+    const vespalib::duration  _adaptiveChunkTargetRoundTime;
     vespalib::ISequencedTaskExecutor& _executor;
     std::atomic<bool>         _throttle_merge_feed_ops;
 
     MessageTrackerUP handleGetBucketDiffStage2(api::GetBucketDiffCommand&, MessageTrackerUP) const;
+    /**
+     * Continues the merge after comparing range checksums, sending a
+     * GetBucketDiff for the differing ranges. Returns a reply if the merge is
+     * complete.
+     */
+    api::StorageReply::SP handleRangeDigestReply(const spi::Bucket& bucket,
+                                                 MergeStatus& status,
+                                                 const api::GetBucketDiffReply& reply,
+                                                 MessageSender& sender) const;
     /** Returns a reply if merge is complete */
     api::StorageReply::SP processBucketMerge(const spi::Bucket& bucket,
                                              MergeStatus& status,
@@ -111,6 +133,13 @@ private:
                                              spi::Context& context,
                                              std::shared_ptr<ApplyBucketDiffState>& async_results) const;
 
+    /**
+     * Adapt the chunk size of the next apply bucket diff round based on the
+     * round trip time of the last round and whether it was bounded by the
+     * chunk size.
+     */
+    void adaptChunkSize(MergeStatus& status, size_t roundEntries, size_t completedEntries) const;
+
     /**
      * Invoke either put, remove or unrevertable remove on the SPI
      * depending on the flags in the diff entry.
@@ -1,6 +1,7 @@
 // Copyright Vespa.ai. Licensed under the terms of the Apache 2.0 license. See LICENSE in the project root.
 
 #include "persistencehandler.h"
+#include <vespa/persistence/spi/batched_operation.h>
 
 #include <vespa/log/log.h>
 LOG_SETUP(".persistence.persistencehandler");
@@ -21,11 +22,15 @@ PersistenceHandler::PersistenceHandler(vespalib::ISequencedTaskExecutor & sequen
       _processAllHandler(_env, provider),
       _mergeHandler(_env, provider, component.cluster_context(), _clock, sequencedExecutor,
                     cfg.bucketMergeChunkSize,
-                    cfg.commonMergeChainOptimalizationMinimumSize),
+                    cfg.commonMergeChainOptimalizationMinimumSize,
+                    cfg.mergeRangeDigestMinimumSize,
+                    cfg.mergeAdaptiveMaxChunkSize,
+                    vespalib::from_s(cfg.mergeAdaptiveChunkTargetRoundTime)),
       _asyncHandler(_env, provider, bucketOwnershipNotifier, sequencedExecutor, component.getBucketIdFactory()),
       _splitJoinHandler(_env, provider, bucketOwnershipNotifier, cfg.enableMultibitSplitOptimalization),
       _simpleHandler(_env, provider, component.getBucketIdFactory()),
-      _use_per_op_throttled_delete_bucket(false)
+      _use_per_op_throttled_delete_bucket(false),
+      _max_feed_op_batch_size(std::max(cfg.maxFeedOpBatchSize, 1))
 {
 }
 
@@ -168,6 +173,15 @@ PersistenceHandler::processMessage(api::StorageMessage& msg, MessageTracker::UP
 void
 PersistenceHandler::processLockedMessage(FileStorHandler::LockedMessage lock) const {
     LOG(debug, "NodeIndex %d, ptr=%p", _env._nodeIndex, lock.msg.get());
+    const uint32_t max_batch_size = _max_feed_op_batch_size.load(std::memory_order_relaxed);
+    if ((max_batch_size > 1) && AsyncHandler::is_async_unconditional_message(*lock.msg)) {
+        auto batch = _env._fileStorHandler.next_batchable_messages(lock, max_batch_size - 1);
+        if ( ! batch.empty()) {
+            batch.insert(batch.begin(), std::move(lock));
+            process_feed_batch(std::move(batch));
+            return;
+        }
+    }
     api::StorageMessage & msg(*lock.msg);
 
     // Important: we _copy_ the message shared_ptr instead of moving to ensure that `msg` remains
@@ -180,6 +194,33 @@ PersistenceHandler::processLockedMessage(FileStorHandler::LockedMessage lock) co
     }
 }
 
+void
+PersistenceHandler::process_feed_batch(std::vector<FileStorHandler::LockedMessage> batch) const {
+    const document::Bucket bucket = batch.front().lock->getBucket();
+    std::vector<spi::BatchedOperation> ops;
+    ops.reserve(batch.size());
+    for (auto& locked : batch) {
+        auto& cmd = static_cast<api::StorageCommand&>(*locked.msg);
+        MBUS_TRACE(cmd.getTrace(), 5, "PersistenceHandler: Processing message in persistence layer as part of a feed batch");
+        _env._metrics.operations.inc();
+        auto tracker = std::make_unique<MessageTracker>(framework::MilliSecTimer(_clock), _env, _env._fileStorHandler,
+                                                        std::move(locked.lock), locked.msg, std::move(locked.throttle_token));
+        try {
+            tracker = _asyncHandler.add_to_feed_batch(cmd, std::move(tracker), ops);
+        } catch (std::exception& e) {
+            LOG(debug, "Caught exception for %s: %s", cmd.toString().c_str(), e.what());
+            api::StorageReply::SP reply(cmd.makeReply());
+            reply->setResult(api::ReturnCode(api::ReturnCode::INTERNAL_FAILURE, e.what()));
+            _env._fileStorHandler.sendReply(reply);
+        }
+        if (tracker) {
+            tracker->sendReply();
+        }
+    }
+    _env._metrics.feed_op_batch_size.addValue(ops.size());
+    _asyncHandler.send_feed_batch(bucket, std::move(ops));
+}
+
 void
 PersistenceHandler::set_throttle_merge_feed_ops(bool throttle) noexcept
 {
@@ -196,4 +237,9 @@ PersistenceHandler::set_use_per_document_throttled_delete_bucket(bool throttle)
     _use_per_op_throttled_delete_bucket.store(throttle, std::memory_order_relaxed);
 }
 
+void
+PersistenceHandler::set_max_feed_op_batch_size(uint32_t max_batch_size) noexcept {
+    _max_feed_op_batch_size.store(max_batch_size, std::memory_order_relaxed);
+}
+
 }
@@ -39,12 +39,14 @@ public:
 
     void set_throttle_merge_feed_ops(bool throttle) noexcept;
     void set_use_per_document_throttled_delete_bucket(bool throttle) noexcept;
+    void set_max_feed_op_batch_size(uint32_t max_batch_size) noexcept;
 private:
     // Message handling functions
     MessageTracker::UP handleCommandSplitByType(api::StorageCommand&, MessageTracker::UP tracker) const;
     MessageTracker::UP handleReply(api::StorageReply&, MessageTracker::UP) const;
 
     MessageTracker::UP processMessage(api::StorageMessage& msg, MessageTracker::UP tracker) const;
+    void process_feed_batch(std::vector<FileStorHandler::LockedMessage> batch) const;
     [[nodiscard]] bool use_per_op_throttled_delete_bucket() const noexcept;
 
     const framework::Clock  & _clock;
@@ -55,6 +57,7 @@ private:
     SplitJoinHandler          _splitJoinHandler;
     SimpleMessageHandler      _simpleHandler;
     std::atomic<bool>         _use_per_op_throttled_delete_bucket;
+    std::atomic<uint32_t>     _max_feed_op_batch_size;
 };
 
 } // storage
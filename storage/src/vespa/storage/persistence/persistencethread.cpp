@@ -11,10 +11,11 @@ LOG_SETUP(".persistence.thread");
 namespace storage {
 
 PersistenceThread::PersistenceThread(PersistenceHandler & persistenceHandler, FileStorHandler & fileStorHandler,
-                                     uint32_t stripeId, framework::Component & component)
+                                     uint32_t stripeId, uint32_t threadIndex, framework::Component & component)
     : _persistenceHandler(persistenceHandler),
       _fileStorHandler(fileStorHandler),
       _stripeId(stripeId),
+      _threadIndex(threadIndex),
       _thread()
 {
     _thread = component.startThread(*this, 60s, 1s, 1, vespalib::CpuUsage::Category::WRITE);
@@ -39,6 +40,11 @@ PersistenceThread::run(framework::ThreadHandle& thread)
         vespalib::steady_time now = vespalib::steady_clock::now();
         thread.registerTick(framework::UNKNOWN_CYCLE, now);
 
+        if (!_fileStorHandler.persistence_thread_is_active(_threadIndex)) {
+            // Parked by adaptive concurrency control; wake up regularly to keep ticking.
+            std::this_thread::sleep_for(max_wait_time);
+            continue;
+        }
         vespalib::steady_time deadline = now + max_wait_time;
         FileStorHandler::LockedMessage lock(_fileStorHandler.getNextMessage(_stripeId, deadline));
 
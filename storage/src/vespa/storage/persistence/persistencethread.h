@@ -19,7 +19,7 @@ class PersistenceThread final : public DiskThread, public Types
 {
 public:
     PersistenceThread(PersistenceHandler & handler, FileStorHandler & fileStorHandler,
-                      uint32_t stripeId, framework::Component & component);
+                      uint32_t stripeId, uint32_t threadIndex, framework::Component & component);
     ~PersistenceThread() override;
 
     /** Waits for current operation to be finished. */
@@ -30,6 +30,7 @@ private:
     PersistenceHandler                 & _persistenceHandler;
     FileStorHandler                    & _fileStorHandler;
     uint32_t                             _stripeId;
+    uint32_t                             _threadIndex;
     std::unique_ptr<framework::Thread>   _thread;
 
     void run(framework::ThreadHandle&) override;
@@ -187,9 +187,25 @@ PersistenceUtil::~PersistenceUtil() = default;
 void
 PersistenceUtil::updateBucketDatabase(const document::Bucket &bucket, const api::BucketInfo& i) const
 {
+    // Callers hold the persistence lock of the bucket, so its entry can only
+    // change through us. Check a lock-free snapshot first, and skip taking
+    // the entry lock when there is nothing to write, e.g. after an operation
+    // that did not modify the bucket.
+    StorBucketDatabase& db(getBucketDatabase(bucket.getBucketSpace()));
+    auto current = db.get_snapshot(bucket.getBucketId());
+    if (!current) {
+        LOG(debug, "Bucket(%s).getBucketInfo: Bucket does not exist.", bucket.getBucketId().toString().c_str());
+        return;
+    }
+    if (current->info.getLastModified() != 0) {
+        api::BucketInfo info = i;
+        info.setLastModified(current->info.getLastModified());
+        if (info == current->info) {
+            return;
+        }
+    }
     // Update bucket database
-    StorBucketDatabase::WrappedEntry entry(getBucketDatabase(bucket.getBucketSpace()).get(bucket.getBucketId(),
-                                                                                          "env::updatebucketdb"));
+    StorBucketDatabase::WrappedEntry entry(db.get(bucket.getBucketId(), "env::updatebucketdb"));
     if (entry.exists()) {
         api::BucketInfo info = i;
 
@@ -1,6 +1,7 @@
 // Copyright Vespa.ai. Licensed under the terms of the Apache 2.0 license. See LICENSE in the project root.
 
 #include "provider_error_wrapper.h"
+#include <vespa/persistence/spi/batched_operation.h>
 #include <vespa/persistence/spi/docentry.h>
 #include <vespa/vespalib/util/idestructorcallback.h>
 
@@ -189,6 +190,15 @@ ProviderErrorWrapper::updateAsync(const spi::Bucket &bucket, spi::Timestamp ts,
     _impl.updateAsync(bucket, ts, std::move(upd), std::move(onComplete));
 }
 
+void
+ProviderErrorWrapper::feedBatchAsync(const spi::Bucket& bucket, std::vector<spi::BatchedOperation> ops)
+{
+    for (auto& op : ops) {
+        op.onComplete->addResultHandler(this);
+    }
+    _impl.feedBatchAsync(bucket, std::move(ops));
+}
+
 std::unique_ptr<vespalib::IDestructorCallback>
 ProviderErrorWrapper::register_executor(std::shared_ptr<spi::BucketExecutor> executor)
 {
@@ -0,0 +1,116 @@
+// Copyright Vespa.ai. Licensed under the terms of the Apache 2.0 license. See LICENSE in the project root.
+
+#include "admission_controller.h"
+#include <algorithm>
+
+namespace storage {
+
+namespace {
+
+constexpr vespalib::duration stale_pending_age = 10min;
+
+}
+
+AdmissionController::AdmissionController()
+    : _lock(),
+      _latency_threshold(vespalib::duration::zero()),
+      _window(1s),
+      _pending(),
+      _window_start(),
+      _window_latency_sum(vespalib::duration::zero()),
+      _window_samples(0),
+      _average_latency(vespalib::duration::zero()),
+      _overloaded(false)
+{
+}
+
+AdmissionController::~AdmissionController() = default;
+
+void
+AdmissionController::configure(vespalib::duration latency_threshold, vespalib::duration window)
+{
+    std::lock_guard guard(_lock);
+    _latency_threshold = latency_threshold;
+    _window = std::max(window, vespalib::duration(1ms));
+    if (_latency_threshold == vespalib::duration::zero()) {
+        _pending.clear();
+        _window_latency_sum = vespalib::duration::zero();
+        _window_samples = 0;
+        _average_latency = vespalib::duration::zero();
+        _overloaded = false;
+    }
+}
+
+bool
+AdmissionController::enabled() const noexcept
+{
+    std::lock_guard guard(_lock);
+    return (_latency_threshold > vespalib::duration::zero());
+}
+
+void
+AdmissionController::maybe_roll_window(vespalib::steady_time now)
+{
+    if (now - _window_start < _window) {
+        return;
+    }
+    _average_latency = (_window_samples > 0) ? (_window_latency_sum / int64_t(_window_samples)) : vespalib::duration::zero();
+    // Operations stuck in the queues do not complete, so their age must count as well.
+    // Operations pending for much longer than any operation timeout are assumed to have
+    // had their reply bypass us, and are forgotten.
+    vespalib::duration oldest_pending = vespalib::duration::zero();
+    for (auto itr = _pending.begin(); itr != _pending.end();) {
+        vespalib::duration age = now - itr->second;
+        if (age > stale_pending_age) {
+            itr = _pending.erase(itr);
+        } else {
+            oldest_pending = std::max(oldest_pending, age);
+            ++itr;
+        }
+    }
+    _overloaded = (_latency_threshold > vespalib::duration::zero()) &&
+                  ((_average_latency > _latency_threshold) || (oldest_pending > _latency_threshold));
+    _window_start = now;
+    _window_latency_sum = vespalib::duration::zero();
+    _window_samples = 0;
+}
+
+void
+AdmissionController::on_admitted(MessageId id, vespalib::steady_time now)
+{
+    std::lock_guard guard(_lock);
+    if (_latency_threshold > vespalib::duration::zero()) {
+        _pending[id] = now;
+    }
+}
+
+void
+AdmissionController::on_completed(MessageId id, vespalib::steady_time now)
+{
+    std::lock_guard guard(_lock);
+    auto itr = _pending.find(id);
+    if (itr == _pending.end()) {
+        return;
+    }
+    _window_latency_sum += (now - itr->second);
+    ++_window_samples;
+    _pending.erase(itr);
+    maybe_roll_window(now);
+}
+
+bool
+AdmissionController::overloaded(vespalib::steady_time now)
+{
+    std::lock_guard guard(_lock);
+    maybe_roll_window(now);
+    return _overloaded;
+}
+
+AdmissionController::State
+AdmissionController::state() const
+{
+    std::lock_guard guard(_lock);
+    return {_overloaded, _average_latency, _pending.size()};
+}
+
+}
@@ -0,0 +1,62 @@
+// Copyright Vespa.ai. Licensed under the terms of the Apache 2.0 license. See LICENSE in the project root.
+
+#pragma once
+
+#include <vespa/storageapi/messageapi/storagemessage.h>
+#include <vespa/vespalib/util/time.h>
+#include <mutex>
+#include <unordered_map>
+
+namespace storage {
+
+/**
+ * Tracks the latency of operations passing through a node, from the command
+ * going down the storage chain until its reply comes back up, i.e. the time
+ * spent waiting in the persistence queues plus the time spent by the
+ * persistence provider.
+ *
+ * Latencies are averaged over fixed length windows. The node is considered
+ * overloaded when the average latency of the last window, or the age of the
+ * oldest operation still pending, exceeds the configured threshold. Callers
+ * use this to shed low priority load before queues grow without bounds.
+ *
+ * Thread safe.
+ */
+class AdmissionController {
+public:
+    using MessageId = api::StorageMessage::Id;
+
+    struct State {
+        bool               overloaded;
+        vespalib::duration average_latency;
+        size_t             pending;
+    };
+private:
+    mutable std::mutex                                   _lock;
+    vespalib::duration                                   _latency_threshold;
+    vespalib::duration                                   _window;
+    std::unordered_map<MessageId, vespalib::steady_time> _pending;
+    vespalib::steady_time                                _window_start;
+    vespalib::duration                                   _window_latency_sum;
+    size_t                                               _window_samples;
+    vespalib::duration                                   _average_latency;
+    bool                                                 _overloaded;
+
+    void maybe_roll_window(vespalib::steady_time now);
+public:
+    AdmissionController();
+    ~AdmissionController();
+
+    // A zero latency threshold disables the controller and forgets all pending operations
+    void configure(vespalib::duration latency_threshold, vespalib::duration window);
+    [[nodiscard]] bool enabled() const noexcept;
+
+    void on_admitted(MessageId id, vespalib::steady_time now);
+    // Ignores operations not admitted through on_admitted
+    void on_completed(MessageId id, vespalib::steady_time now);
+
+    [[nodiscard]] bool overloaded(vespalib::steady_time now);
+    [[nodiscard]] State state() const;
+};
+
+}
@@ -30,10 +30,13 @@ Bouncer::Bouncer(StorageComponentRegister& compReg, const StorBouncerConfig& boo
       _derivedNodeStates(),
       _clusterState(&lib::State::UP),
       _metrics(std::make_unique<BouncerMetrics>()),
+      _admission(),
       _closed(false)
 {
+    configure_admission(bootstrap_config);
     _component.getStateUpdater().addStateListener(*this);
     _component.registerMetric(*_metrics);
+    _component.registerMetricUpdateHook(*this, 5s);
 }
 
 Bouncer::~Bouncer()
@@ -64,10 +67,18 @@ Bouncer::on_configure(const vespa::config::content::core::StorBouncerConfig& con
 {
     validateConfig(config);
     auto new_config = std::make_unique<StorBouncerConfig>(config);
+    configure_admission(config);
     std::lock_guard lock(_lock);
     _config = std::move(new_config);
 }
 
+void
+Bouncer::configure_admission(const StorBouncerConfig& config)
+{
+    _admission.configure(std::chrono::milliseconds(std::max(config.overloadLatencyThresholdMs, 0)),
+                         std::chrono::milliseconds(std::max(config.overloadLatencyWindowMs, 1)));
+}
+
 const BouncerMetrics& Bouncer::metrics() const noexcept {
     return *_metrics;
 }
@@ -194,6 +205,23 @@ Bouncer::isExternalWriteOperation(const api::MessageType& type) noexcept {
     }
 }
 
+bool
+Bouncer::isExternalWriteReply(const api::MessageType& type) noexcept {
+    switch (type.getId()) {
+    case api::MessageType::PUT_REPLY_ID:
+    case api::MessageType::REMOVE_REPLY_ID:
+    case api::MessageType::UPDATE_REPLY_ID:
+        return true;
+    default:
+        return false;
+    }
+}
+
+bool
+Bouncer::isSheddableOperation(const api::MessageType& type) noexcept {
+    return (isExternalWriteOperation(type) || (type.getId() == api::MessageType::VISITOR_CREATE_ID));
+}
+
 void
 Bouncer::rejectDueToInsufficientPriority(
         api::StorageMessage& msg,
@@ -222,6 +250,17 @@ Bouncer::reject_due_to_too_few_bucket_bits(api::StorageMessage& msg) {
     sendUp(reply);
 }
 
+void
+Bouncer::reject_due_to_overload(api::StorageMessage& msg) {
+    std::shared_ptr<api::StorageReply> reply(dynamic_cast<api::StorageCommand&>(msg).makeReply());
+    std::ostringstream ost;
+    ost << "Node is overloaded, rejecting operation with priority " << int(msg.getPriority());
+    append_node_identity(ost);
+    reply->setResult(api::ReturnCode(api::ReturnCode::BUSY, ost.str()));
+    _metrics->overload_rejects.inc();
+    sendUp(reply);
+}
+
 void
 Bouncer::reject_due_to_node_shutdown(api::StorageMessage& msg) {
     std::shared_ptr<api::StorageReply> reply(dynamic_cast<api::StorageCommand&>(msg).makeReply());
@@ -239,6 +278,8 @@ Bouncer::onDown(const std::shared_ptr<api::StorageMessage>& msg)
     bool closed;
     const lib::State* cluster_state;
     int feedPriorityLowerBound;
+    bool overloadSheddingEnabled;
+    int overloadSheddingPriorityThreshold;
     {
         std::lock_guard lock(_lock);
         state                    = &getDerivedNodeState(msg->getBucket().getBucketSpace()).getState();
@@ -247,6 +288,8 @@ Bouncer::onDown(const std::shared_ptr<api::StorageMessage>& msg)
         cluster_state            = _clusterState;
         isInAvailableState       = state->oneOf(_config->stopAllLoadWhenNodestateNotIn.c_str());
         feedPriorityLowerBound   = _config->feedRejectionPriorityThreshold;
+        overloadSheddingEnabled  = (_config->overloadLatencyThresholdMs > 0) && !isDistributor();
+        overloadSheddingPriorityThreshold = _config->overloadSheddingPriorityThreshold;
         closed                   = _closed;
     }
     const api::MessageType& type = msg->getType();
@@ -321,9 +364,41 @@ Bouncer::onDown(const std::shared_ptr<api::StorageMessage>& msg)
         reject_due_to_too_few_bucket_bits(*msg);
         return true;
     }
+
+    if (overloadSheddingEnabled) {
+        const auto now = _component.getClock().getMonotonicTime();
+        if (isSheddableOperation(type)
+            && (msg->getPriority() > overloadSheddingPriorityThreshold)
+            && _admission.overloaded(now))
+        {
+            reject_due_to_overload(*msg);
+            return true;
+        }
+        if (isExternalWriteOperation(type)) {
+            _admission.on_admitted(msg->getMsgId(), now);
+        }
+    }
     return false;
 }
 
+bool
+Bouncer::onUp(const std::shared_ptr<api::StorageMessage>& msg)
+{
+    if (isExternalWriteReply(msg->getType())) {
+        _admission.on_completed(msg->getMsgId(), _component.getClock().getMonotonicTime());
+    }
+    return false;
+}
+
+void
+Bouncer::updateMetrics(const MetricLockGuard&)
+{
+    const auto state = _admission.state();
+    _metrics->overloaded.set(state.overloaded ? 1 : 0);
+    _metrics->average_operation_latency.set(vespalib::to_s(state.average_latency) * 1000.0);
+    _metrics->pending_operations.set(state.pending);
+}
+
 namespace {
 
 lib::NodeState
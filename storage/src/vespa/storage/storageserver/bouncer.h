@@ -6,12 +6,14 @@
 
 #pragma once
 
+#include "admission_controller.h"
 #include <vespa/config/helper/ifetchercallback.h>
 #include <vespa/vdslib/state/nodestate.h>
 #include <vespa/storage/common/nodestateupdater.h>
 #include <vespa/storage/common/storagecomponent.h>
 #include <vespa/storage/common/storagelink.h>
 #include <vespa/storage/config/config-stor-bouncer.h>
+#include <vespa/storageframework/generic/metric/metricupdatehook.h>
 #include <unordered_map>
 
 namespace config {
@@ -24,7 +26,8 @@ namespace storage {
 struct BouncerMetrics;
 
 class Bouncer : public StorageLink,
-                private StateListener
+                private StateListener,
+                private framework::MetricUpdateHook
 {
     using StorBouncerConfig = vespa::config::content::core::StorBouncerConfig;
     using BucketSpaceNodeStateMapping = std::unordered_map<document::BucketSpace, lib::NodeState, document::BucketSpace::hash>;
@@ -36,6 +39,7 @@ class Bouncer : public StorageLink,
     BucketSpaceNodeStateMapping        _derivedNodeStates;
     const lib::State*                  _clusterState;
     std::unique_ptr<BouncerMetrics>    _metrics;
+    AdmissionController                _admission;
     bool                               _closed;
 
 public:
@@ -57,10 +61,14 @@ private:
     void rejectDueToInsufficientPriority(api::StorageMessage&, api::StorageMessage::Priority);
     void reject_due_to_too_few_bucket_bits(api::StorageMessage&);
     void reject_due_to_node_shutdown(api::StorageMessage&);
+    void reject_due_to_overload(api::StorageMessage&);
+    void configure_admission(const StorBouncerConfig& config);
     static bool clusterIsUp(const lib::State& cluster_state);
     bool isDistributor() const;
     static bool isExternalLoad(const api::MessageType&) noexcept;
     static bool isExternalWriteOperation(const api::MessageType&) noexcept;
+    static bool isExternalWriteReply(const api::MessageType&) noexcept;
+    static bool isSheddableOperation(const api::MessageType&) noexcept;
     static bool priorityRejectionIsEnabled(int configuredPriority) noexcept {
         return (configuredPriority != -1);
     }
@@ -71,6 +79,8 @@ private:
      */
     static uint64_t extractMutationTimestampIfAny(const api::StorageMessage& msg);
     bool onDown(const std::shared_ptr<api::StorageMessage>&) override;
+    bool onUp(const std::shared_ptr<api::StorageMessage>&) override;
+    void updateMetrics(const MetricLockGuard&) override;
     void handleNewState() noexcept override;
     const lib::NodeState &getDerivedNodeState(document::BucketSpace bucketSpace) const;
     void append_node_identity(std::ostream& target_stream) const;
@@ -9,7 +9,15 @@ BouncerMetrics::BouncerMetrics()
       clock_skew_aborts("clock_skew_aborts", {}, "Number of client operations that were aborted due to "
                         "clock skew between sender and receiver exceeding acceptable range", this),
       unavailable_node_aborts("unavailable_node_aborts", {}, "Number of operations that were aborted due "
-                              "to the node (or target bucket space) being unavailable", this)
+                              "to the node (or target bucket space) being unavailable", this),
+      overload_rejects("overload_rejects", {}, "Number of low priority client operations that were "
+                       "rejected with a busy error because the node was overloaded", this),
+      overloaded("overloaded", {}, "1 if the node currently sheds low priority client operations "
+                 "due to high operation latency, 0 otherwise", this),
+      average_operation_latency("average_operation_latency", {}, "Average latency (in ms) of client "
+                                "feed operations in the last overload detection window", this),
+      pending_operations("pending_operations", {}, "Number of client feed operations tracked for "
+                         "overload detection that are still in progress", this)
 {
 }
 
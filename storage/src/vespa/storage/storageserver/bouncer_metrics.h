@@ -4,12 +4,17 @@
 
 #include <vespa/metrics/metricset.h>
 #include <vespa/metrics/countmetric.h>
+#include <vespa/metrics/valuemetric.h>
 
 namespace storage {
 
 struct BouncerMetrics : metrics::MetricSet {
     metrics::LongCountMetric clock_skew_aborts;
     metrics::LongCountMetric unavailable_node_aborts;
+    metrics::LongCountMetric overload_rejects;
+    metrics::LongValueMetric overloaded;
+    metrics::DoubleValueMetric average_operation_latency;
+    metrics::LongValueMetric pending_operations;
 
     BouncerMetrics();
     ~BouncerMetrics() override;
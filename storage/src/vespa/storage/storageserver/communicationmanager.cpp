@@ -10,6 +10,7 @@
 #include <vespa/storage/common/bucket_resolver.h>
 #include <vespa/storage/common/nodestateupdater.h>
 #include <vespa/storage/storageserver/configurable_bucket_resolver.h>
+#include <vespa/storage/storageserver/rpc/batched_rpc_request.h>
 #include <vespa/storage/storageserver/rpc/shared_rpc_resources.h>
 #include <vespa/storage/storageserver/rpc/cluster_controller_api_rpc_service.h>
 #include <vespa/storage/storageserver/rpc/message_codec_provider.h>
@@ -39,6 +40,10 @@ StorageTransportContext::StorageTransportContext(std::unique_ptr<RPCRequestWrapp
     : _request(std::move(request))
 { }
 
+StorageTransportContext::StorageTransportContext(std::unique_ptr<rpc::BatchedRpcReplySlot> batched_reply)
+    : _batched_reply(std::move(batched_reply))
+{ }
+
 StorageTransportContext::~StorageTransportContext() = default;
 
 void
@@ -417,6 +422,8 @@ CommunicationManager::on_configure(const CommunicationManagerConfig& config)
     rpc::StorageApiRpcService::Params rpc_params;
     rpc_params.compression_config = convert_to_rpc_compression_config(config);
     rpc_params.num_rpc_targets_per_node = config.rpc.numTargetsPerNode;
+    rpc_params.max_batch_size = std::max(config.rpc.batching.maxBatchSize, 0);
+    rpc_params.batch_window = std::chrono::microseconds(config.rpc.batching.windowUs);
     _storage_api_rpc_service = std::make_unique<rpc::StorageApiRpcService>(
             *this, *_shared_rpc_resources, *_message_codec_provider, rpc_params);
 
@@ -703,6 +710,8 @@ CommunicationManager::sendReply(const std::shared_ptr<api::StorageReply>& reply)
     framework::MilliSecTimer startTime(_component.getClock());
     if (context->_request) {
         sendDirectRPCReply(*(context->_request), reply);
+    } else if (context->_batched_reply) {
+        _storage_api_rpc_service->encode_rpc_v1_batched_response(*context->_batched_reply, *reply);
     } else {
         sendMessageBusReply(*context, reply);
     }
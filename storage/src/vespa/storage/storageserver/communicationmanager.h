@@ -36,6 +36,7 @@ namespace mbus {
 namespace storage {
 
 namespace rpc {
+class BatchedRpcReplySlot;
 class ClusterControllerApiRpcService;
 class MessageCodecProvider;
 class SharedRpcResources;
@@ -51,10 +52,12 @@ class StorageTransportContext : public api::TransportContext {
 public:
     explicit StorageTransportContext(std::unique_ptr<documentapi::DocumentMessage> msg);
     explicit StorageTransportContext(std::unique_ptr<RPCRequestWrapper> request);
+    explicit StorageTransportContext(std::unique_ptr<rpc::BatchedRpcReplySlot> batched_reply);
     ~StorageTransportContext() override;
 
     std::unique_ptr<documentapi::DocumentMessage> _docAPIMsg;
     std::unique_ptr<RPCRequestWrapper>            _request;
+    std::unique_ptr<rpc::BatchedRpcReplySlot>     _batched_reply;
 };
 
 class CommunicationManager final
@@ -0,0 +1,103 @@
+// Copyright Vespa.ai. Licensed under the terms of the Apache 2.0 license. See LICENSE in the project root.
+
+#include "batched_rpc_request.h"
+#include <vespa/fnet/frt/error.h>
+#include <vespa/fnet/frt/rpcrequest.h>
+#include <vespa/storage/storageserver/rpcrequestwrapper.h>
+#include <cassert>
+
+namespace storage::rpc {
+
+BatchedRpcRequest::EncodedReply::EncodedReply() noexcept
+    : header(),
+      body_encoding(0),
+      body_decoded_size(0),
+      body(0)
+{}
+
+BatchedRpcRequest::EncodedReply::EncodedReply(EncodedReply&&) noexcept = default;
+BatchedRpcRequest::EncodedReply& BatchedRpcRequest::EncodedReply::operator=(EncodedReply&&) noexcept = default;
+BatchedRpcRequest::EncodedReply::~EncodedReply() = default;
+
+BatchedRpcRequest::BatchedRpcRequest(FRT_RPCRequest* req, uint32_t num_entries)
+    : _lock(),
+      _req(req),
+      _replies(num_entries),
+      _pending(num_entries),
+      _failed(false)
+{
+    assert(num_entries > 0);
+}
+
+BatchedRpcRequest::~BatchedRpcRequest() {
+    // All slots hold a reference to us, so the request has already been returned.
+    assert(_req == nullptr);
+}
+
+void BatchedRpcRequest::complete_entry(uint32_t index, EncodedReply reply) {
+    std::unique_lock guard(_lock);
+    assert(index < _replies.size());
+    _replies[index] = std::move(reply);
+    assert(_pending > 0);
+    if (--_pending == 0) {
+        guard.unlock();
+        return_request();
+    }
+}
+
+void BatchedRpcRequest::fail_entry(uint32_t index) {
+    std::unique_lock guard(_lock);
+    assert(index < _replies.size());
+    (void)index;
+    _failed = true;
+    assert(_pending > 0);
+    if (--_pending == 0) {
+        guard.unlock();
+        return_request();
+    }
+}
+
+void BatchedRpcRequest::return_request() {
+    // No more entries can be touched once _pending reaches zero, so no locking is needed.
+    auto* req = _req;
+    _req = nullptr;
+    if (_failed) {
+        req->SetError(RPCRequestWrapper::ERR_REQUEST_DELETED, "Request deleted without having been replied to");
+        req->Return();
+        return;
+    }
+    const auto n = static_cast<uint32_t>(_replies.size());
+    auto& ret = *req->GetReturn();
+    uint8_t* header_encodings = ret.AddInt8Array(n);
+    uint32_t* header_sizes = ret.AddInt32Array(n);
+    FRT_DataValue* headers = ret.AddDataArray(n);
+    for (uint32_t i = 0; i < n; ++i) {
+        header_encodings[i] = 0; // NONE; reply headers are never compressed
+        header_sizes[i] = static_cast<uint32_t>(_replies[i].header.size());
+        ret.SetData(&headers[i], _replies[i].header.data(), header_sizes[i]);
+    }
+    uint8_t* body_encodings = ret.AddInt8Array(n);
+    uint32_t* body_sizes = ret.AddInt32Array(n);
+    FRT_DataValue* bodies = ret.AddDataArray(n);
+    for (uint32_t i = 0; i < n; ++i) {
+        body_encodings[i] = _replies[i].body_encoding;
+        body_sizes[i] = _replies[i].body_decoded_size;
+        ret.SetData(&bodies[i], _replies[i].body.getData(), static_cast<uint32_t>(_replies[i].body.getDataLen()));
+    }
+    _replies.clear();
+    req->Return();
+}
+
+BatchedRpcReplySlot::~BatchedRpcReplySlot() {
+    if (!_replied) {
+        _request->fail_entry(_index);
+    }
+}
+
+void BatchedRpcReplySlot::complete(BatchedRpcRequest::EncodedReply reply) {
+    assert(!_replied);
+    _replied = true;
+    _request->complete_entry(_index, std::move(reply));
+}
+
+}
@@ -0,0 +1,74 @@
+// Copyright Vespa.ai. Licensed under the terms of the Apache 2.0 license. See LICENSE in the project root.
+#pragma once
+
+#include <vespa/vespalib/data/databuffer.h>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+
+class FRT_RPCRequest;
+
+namespace storage::rpc {
+
+/**
+ * Server side state of a single batched StorageAPI RPC request.
+ *
+ * Every command unpacked from the batch is dispatched individually and carries a
+ * BatchedRpcReplySlot in its transport context. Replies may be encoded into their
+ * slots in any order and from any thread. The underlying RPC request is returned
+ * once every slot has either been replied to or destroyed. If any slot is destroyed
+ * without a reply, the RPC request as a whole fails, which mirrors what
+ * RPCRequestWrapper does for unreplied non-batched requests.
+ */
+class BatchedRpcRequest {
+public:
+    struct EncodedReply {
+        std::string          header;
+        uint8_t              body_encoding;
+        uint32_t             body_decoded_size;
+        vespalib::DataBuffer body;
+
+        EncodedReply() noexcept;
+        EncodedReply(EncodedReply&&) noexcept;
+        EncodedReply& operator=(EncodedReply&&) noexcept;
+        ~EncodedReply();
+    };
+private:
+    std::mutex                _lock;
+    FRT_RPCRequest*           _req;
+    std::vector<EncodedReply> _replies;
+    uint32_t                  _pending;
+    bool                      _failed;
+
+    void return_request();
+public:
+    // Takes over the (detached) request, which is returned when the last slot completes.
+    BatchedRpcRequest(FRT_RPCRequest* req, uint32_t num_entries);
+    ~BatchedRpcRequest();
+
+    void complete_entry(uint32_t index, EncodedReply reply);
+    void fail_entry(uint32_t index);
+};
+
+/**
+ * Handle to the reply of a single command of a BatchedRpcRequest.
+ */
+class BatchedRpcReplySlot {
+    std::shared_ptr<BatchedRpcRequest> _request;
+    uint32_t                           _index;
+    bool                               _replied;
+public:
+    BatchedRpcReplySlot(std::shared_ptr<BatchedRpcRequest> request, uint32_t index) noexcept
+        : _request(std::move(request)),
+          _index(index),
+          _replied(false)
+    {}
+    BatchedRpcReplySlot(const BatchedRpcReplySlot&) = delete;
+    BatchedRpcReplySlot& operator=(const BatchedRpcReplySlot&) = delete;
+    ~BatchedRpcReplySlot();
+
+    void complete(BatchedRpcRequest::EncodedReply reply);
+};
+
+}
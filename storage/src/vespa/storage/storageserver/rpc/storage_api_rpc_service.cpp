@@ -1,5 +1,6 @@
 // Copyright Vespa.ai. Licensed under the terms of the Apache 2.0 license. See LICENSE in the project root.
 
+#include "batched_rpc_request.h"
 #include "caching_rpc_target_resolver.h"
 #include "message_codec_provider.h"
 #include "rpc_envelope_proto.h"
@@ -14,6 +15,7 @@
 #include <vespa/storage/storageserver/message_dispatcher.h>
 #include <vespa/storage/storageserver/rpcrequestwrapper.h>
 #include <vespa/storageapi/mbusprot/protocolserialization7.h>
+#include <vespa/storageapi/message/persistence.h>
 #include <vespa/storageapi/messageapi/storagecommand.h>
 #include <vespa/vespalib/data/databuffer.h>
 #include <vespa/vespalib/trace/tracelevel.h>
@@ -38,20 +40,37 @@ StorageApiRpcService::StorageApiRpcService(MessageDispatcher& message_dispatcher
       _message_codec_provider(message_codec_provider),
       _params(params),
       _target_resolver(std::make_unique<CachingRpcTargetResolver>(_rpc_resources.slobrok_mirror(), _rpc_resources.target_factory(),
-                                                                  params.num_rpc_targets_per_node))
+                                                                  params.num_rpc_targets_per_node)),
+      _batch_lock(),
+      _pending_batches(),
+      _batch_flush_scheduled(false),
+      _batch_flush_task(std::make_unique<BatchFlushTask>(_rpc_resources.supervisor().GetScheduler(), *this))
 {
     register_server_methods(rpc_resources);
 }
 
-StorageApiRpcService::~StorageApiRpcService() = default;
+StorageApiRpcService::~StorageApiRpcService() {
+    _batch_flush_task->Kill();
+}
 
 StorageApiRpcService::Params::Params()
     : compression_config(),
-      num_rpc_targets_per_node(1)
+      num_rpc_targets_per_node(1),
+      max_batch_size(0),
+      batch_window(100us)
 {}
 
 StorageApiRpcService::Params::~Params() = default;
 
+StorageApiRpcService::PendingBatch::PendingBatch() noexcept = default;
+StorageApiRpcService::PendingBatch::PendingBatch(PendingBatch&&) noexcept = default;
+StorageApiRpcService::PendingBatch& StorageApiRpcService::PendingBatch::operator=(PendingBatch&&) noexcept = default;
+StorageApiRpcService::PendingBatch::~PendingBatch() = default;
+
+void StorageApiRpcService::BatchFlushTask::PerformTask() {
+    _service.flush_pending_batches();
+}
+
 void StorageApiRpcService::register_server_methods(SharedRpcResources& rpc_resources) {
     FRT_ReflectionBuilder rb(&rpc_resources.supervisor());
     rb.DefineMethod(rpc_v1_method_name(), "bixbix", "bixbix", FRT_METHOD(StorageApiRpcService::RPC_rpc_v1_send), this);
@@ -69,6 +88,23 @@ void StorageApiRpcService::register_server_methods(SharedRpcResources& rpc_resou
     rb.ReturnDesc("body_encoding",  "0=raw, 6=lz4");
     rb.ReturnDesc("body_decoded_size", "Uncompressed body blob size");
     rb.ReturnDesc("body_payload", "The reply body blob");
+
+    rb.DefineMethod(rpc_v1_batch_method_name(), "BIXBIX", "BIXBIX", FRT_METHOD(StorageApiRpcService::RPC_rpc_v1_send_batch), this);
+    rb.RequestAccessFilter(FRT_RequireCapabilities::of(vespalib::net::tls::Capability::content_storage_api()));
+    rb.MethodDesc("V1 of StorageAPI direct RPC protocol, sending multiple independent requests at once. "
+                  "Array element i of every parameter and return value belongs to request i");
+    rb.ParamDesc("header_encodings", "0=raw, 6=lz4");
+    rb.ParamDesc("header_decoded_sizes", "Uncompressed header blob sizes");
+    rb.ParamDesc("header_payloads", "The message header blobs");
+    rb.ParamDesc("body_encodings", "0=raw, 6=lz4");
+    rb.ParamDesc("body_decoded_sizes", "Uncompressed body blob sizes");
+    rb.ParamDesc("body_payloads", "The message body blobs");
+    rb.ReturnDesc("header_encodings",  "0=raw, 6=lz4");
+    rb.ReturnDesc("header_decoded_sizes", "Uncompressed header blob sizes");
+    rb.ReturnDesc("header_payloads", "The reply header blobs");
+    rb.ReturnDesc("body_encodings",  "0=raw, 6=lz4");
+    rb.ReturnDesc("body_decoded_sizes", "Uncompressed body blob sizes");
+    rb.ReturnDesc("body_payloads", "The reply body blobs");
 }
 
 void StorageApiRpcService::detach_and_forward_to_enqueuer(std::shared_ptr<api::StorageMessage> cmd, FRT_RPCRequest* req) {
@@ -88,22 +124,43 @@ struct SubRefDeleter {
 };
 
 template <typename HeaderType>
-bool decode_header_from_rpc_params(const FRT_Values& params, HeaderType& hdr) {
-    const auto compression_type = vespalib::compression::CompressionConfig::toType(params[0]._intval8);
-    const uint32_t uncompressed_length = params[1]._intval32;
+bool decode_header(uint8_t encoding, uint32_t uncompressed_length, const char* buf, uint32_t len, HeaderType& hdr) {
+    const auto compression_type = vespalib::compression::CompressionConfig::toType(encoding);
 
     if (compression_type == vespalib::compression::CompressionConfig::NONE) {
         // Fast-path in the common case where request header is not compressed.
-        return hdr.ParseFromArray(params[2]._data._buf, params[2]._data._len);
+        return hdr.ParseFromArray(buf, len);
     } else {
-        vespalib::DataBuffer uncompressed(params[2]._data._buf, params[2]._data._len);
-        vespalib::ConstBufferRef blob(params[2]._data._buf, params[2]._data._len);
+        vespalib::DataBuffer uncompressed(buf, len);
+        vespalib::ConstBufferRef blob(buf, len);
         decompress(compression_type, uncompressed_length, blob, uncompressed, true);
         assert(uncompressed_length == uncompressed.getDataLen());
         return hdr.ParseFromArray(uncompressed.getData(), uncompressed.getDataLen());
     }
 }
 
+template <typename HeaderType>
+bool decode_header_from_rpc_params(const FRT_Values& params, HeaderType& hdr) {
+    return decode_header(params[0]._intval8, params[1]._intval32, params[2]._data._buf, params[2]._data._len, hdr);
+}
+
+// Decodes the header of request/reply `index` of a batched RPC
+template <typename HeaderType>
+bool decode_header_from_batched_rpc_params(const FRT_Values& params, uint32_t index, HeaderType& hdr) {
+    const auto& header = params[2]._data_array._pt[index];
+    return decode_header(params[0]._int8_array._pt[index], params[1]._int32_array._pt[index],
+                         header._buf, header._len, hdr);
+}
+
+// Returns true iff all 6 array parameters of a batched RPC have the same, non-zero number of elements
+bool batched_rpc_params_are_consistent(const FRT_Values& params) {
+    const uint32_t n = params[0]._int8_array._len;
+    return ((n > 0)
+            && (params[1]._int32_array._len == n) && (params[2]._data_array._len == n)
+            && (params[3]._int8_array._len == n) && (params[4]._int32_array._len == n)
+            && (params[5]._data_array._len == n));
+}
+
 // Must be done prior to adding payload
 template <typename HeaderType>
 void encode_header_into_rpc_params(HeaderType& hdr, FRT_Values& params) {
@@ -115,20 +172,43 @@ void encode_header_into_rpc_params(HeaderType& hdr, FRT_Values& params) {
     hdr.SerializeWithCachedSizesToArray(header_buf);
 }
 
-void compress_and_add_payload_to_rpc_params(mbus::BlobRef payload,
-                                            FRT_Values& params,
-                                            const CompressionConfig& compression_cfg) {
+CompressionConfig::Type compress_payload(mbus::BlobRef payload,
+                                         const CompressionConfig& compression_cfg,
+                                         vespalib::DataBuffer& buf) {
     assert(payload.size() <= UINT32_MAX);
     vespalib::ConstBufferRef to_compress(payload.data(), payload.size());
-    vespalib::DataBuffer buf(vespalib::roundUp2inN(payload.size()));
     auto comp_type = compress(compression_cfg, to_compress, buf, false);
     assert(buf.getDataLen() <= UINT32_MAX);
+    return comp_type;
+}
+
+void compress_and_add_payload_to_rpc_params(mbus::BlobRef payload,
+                                            FRT_Values& params,
+                                            const CompressionConfig& compression_cfg) {
+    vespalib::DataBuffer buf(vespalib::roundUp2inN(payload.size()));
+    auto comp_type = compress_payload(payload, compression_cfg, buf);
 
     params.AddInt8(comp_type);
-    params.AddInt32(static_cast<uint32_t>(to_compress.size()));
+    params.AddInt32(static_cast<uint32_t>(payload.size()));
     params.AddData(std::move(buf));
 }
 
+void prepare_received_command(api::StorageCommand& cmd, const protobuf::RequestHeader& hdr,
+                              uint32_t uncompressed_size, const SharedRpcResources& rpc_resources)
+{
+    cmd.setApproxByteSize(uncompressed_size);
+    cmd.getTrace().setLevel(hdr.trace_level());
+    cmd.setTimeout(std::chrono::milliseconds(hdr.time_remaining_ms()));
+    if (cmd.getTrace().shouldTrace(TraceLevel::SEND_RECEIVE)) {
+        cmd.getTrace().trace(TraceLevel::SEND_RECEIVE,
+                             vespalib::make_string("Request received at '%s' (tcp/%s:%d) with %u bytes of payload",
+                                                   rpc_resources.handle().c_str(),
+                                                   rpc_resources.hostname().c_str(),
+                                                   rpc_resources.listen_port(),
+                                                   uncompressed_size));
+    }
+}
+
 } // anon ns
 
 template <typename MessageType>
@@ -144,11 +224,21 @@ bool StorageApiRpcService::uncompress_rpc_payload(
         const FRT_Values& params,
         PayloadCodecCallback payload_callback)
 {
-    const auto compression_type = vespalib::compression::CompressionConfig::toType(params[3]._intval8);
-    const uint32_t uncompressed_length = params[4]._intval32;
+    return uncompress_rpc_payload(params[3]._intval8, params[4]._intval32,
+                                  params[5]._data._buf, params[5]._data._len,
+                                  std::move(payload_callback));
+}
+
+template <typename PayloadCodecCallback>
+bool StorageApiRpcService::uncompress_rpc_payload(
+        uint8_t encoding, uint32_t uncompressed_length,
+        const char* buf, uint32_t len,
+        PayloadCodecCallback payload_callback)
+{
+    const auto compression_type = vespalib::compression::CompressionConfig::toType(encoding);
     // TODO fast path if uncompressed?
-    vespalib::DataBuffer uncompressed(params[5]._data._buf, params[5]._data._len);
-    vespalib::ConstBufferRef blob(params[5]._data._buf, params[5]._data._len);
+    vespalib::DataBuffer uncompressed(buf, len);
+    vespalib::ConstBufferRef blob(buf, len);
     decompress(compression_type, uncompressed_length, blob, uncompressed, true);
     assert(uncompressed_length == uncompressed.getDataLen());
     assert(uncompressed_length <= UINT32_MAX);
@@ -181,24 +271,62 @@ void StorageApiRpcService::RPC_rpc_v1_send(FRT_RPCRequest* req) {
     if (ok) {
         assert(cmd && cmd->has_command());
         auto scmd = cmd->steal_command();
-        scmd->setApproxByteSize(uncompressed_size);
-        scmd->getTrace().setLevel(hdr.trace_level());
-        scmd->setTimeout(std::chrono::milliseconds(hdr.time_remaining_ms()));
         req->DiscardBlobs();
-        if (scmd->getTrace().shouldTrace(TraceLevel::SEND_RECEIVE)) {
-            scmd->getTrace().trace(TraceLevel::SEND_RECEIVE,
-                                   vespalib::make_string("Request received at '%s' (tcp/%s:%d) with %u bytes of payload",
-                                                         _rpc_resources.handle().c_str(),
-                                                         _rpc_resources.hostname().c_str(),
-                                                         _rpc_resources.listen_port(),
-                                                         uncompressed_size));
-        }
+        prepare_received_command(*scmd, hdr, uncompressed_size, _rpc_resources);
         detach_and_forward_to_enqueuer(std::move(scmd), req);
     } else {
         req->SetError(FRTE_RPC_METHOD_FAILED, "Unable to decode RPC request payload");
     }
 }
 
+void StorageApiRpcService::RPC_rpc_v1_send_batch(FRT_RPCRequest* req) {
+    LOG(spam, "Server: received rpc.v1 batch request");
+    const auto& params = *req->GetParams();
+    if (!batched_rpc_params_are_consistent(params)) {
+        req->SetError(FRTE_RPC_METHOD_FAILED, "Inconsistent number of elements in batched RPC request parameters");
+        return;
+    }
+    const uint32_t n = params[0]._int8_array._len;
+    // Decode everything up front so that a malformed batch fails as a whole
+    // instead of having only some of its requests executed.
+    std::vector<std::shared_ptr<api::StorageCommand>> cmds;
+    cmds.reserve(n);
+    for (uint32_t i = 0; i < n; ++i) {
+        protobuf::RequestHeader hdr;
+        if (!decode_header_from_batched_rpc_params(params, i, hdr)) {
+            req->SetError(FRTE_RPC_METHOD_FAILED, "Unable to decode RPC request header protobuf");
+            return;
+        }
+        const auto& body = params[5]._data_array._pt[i];
+        std::unique_ptr<mbusprot::StorageCommand> cmd;
+        uint32_t uncompressed_size = 0;
+        bool ok = uncompress_rpc_payload(params[3]._int8_array._pt[i], params[4]._int32_array._pt[i],
+                                         body._buf, body._len,
+                                         [&cmd, &uncompressed_size](auto& codec, auto payload) {
+            cmd = codec.decodeCommand(payload);
+            uncompressed_size = static_cast<uint32_t>(payload.size());
+        });
+        if (!ok) {
+            req->SetError(FRTE_RPC_METHOD_FAILED, "Unable to decode RPC request payload");
+            return;
+        }
+        assert(cmd && cmd->has_command());
+        auto scmd = cmd->steal_command();
+        prepare_received_command(*scmd, hdr, uncompressed_size, _rpc_resources);
+        cmds.emplace_back(std::move(scmd));
+    }
+    req->DiscardBlobs();
+    auto batch = std::make_shared<BatchedRpcRequest>(req, n);
+    req->Detach();
+    for (uint32_t i = 0; i < n; ++i) {
+        cmds[i]->setTransportContext(std::make_unique<StorageTransportContext>(std::make_unique<BatchedRpcReplySlot>(batch, i)));
+    }
+    batch.reset();
+    for (auto& cmd : cmds) {
+        _message_dispatcher.dispatch_sync(std::move(cmd));
+    }
+}
+
 void StorageApiRpcService::encode_rpc_v1_response(FRT_RPCRequest& request, api::StorageReply& reply) {
     LOG(spam, "Server: encoding rpc.v1 response header and payload");
     auto* ret = request.GetReturn();
@@ -217,6 +345,26 @@ void StorageApiRpcService::encode_rpc_v1_response(FRT_RPCRequest& request, api::
     encode_and_compress_rpc_payload<api::StorageReply>(reply, *ret);
 }
 
+void StorageApiRpcService::encode_rpc_v1_batched_response(BatchedRpcReplySlot& slot, api::StorageReply& reply) {
+    LOG(spam, "Server: encoding rpc.v1 batched response header and payload");
+    if (reply.getTrace().shouldTrace(TraceLevel::SEND_RECEIVE)) {
+        reply.getTrace().trace(TraceLevel::SEND_RECEIVE,
+                               vespalib::make_string("Sending response from '%s'", _rpc_resources.handle().c_str()));
+    }
+    protobuf::ResponseHeader hdr;
+    if (reply.getTrace().getLevel() > 0) {
+        hdr.set_trace_payload(reply.getTrace().encode());
+    }
+    BatchedRpcRequest::EncodedReply encoded;
+    encoded.header = hdr.SerializeAsString();
+    auto wrapped_codec = _message_codec_provider.wrapped_codec();
+    auto payload = wrapped_codec->codec().encode(reply);
+    encoded.body = vespalib::DataBuffer(vespalib::roundUp2inN(payload.size()));
+    encoded.body_encoding = compress_payload(payload, _params.compression_config, encoded.body);
+    encoded.body_decoded_size = static_cast<uint32_t>(payload.size());
+    slot.complete(std::move(encoded));
+}
+
 void StorageApiRpcService::send_rpc_v1_request(std::shared_ptr<api::StorageCommand> cmd) {
     LOG(spam, "Client: sending rpc.v1 request for message of type %s to %s",
         cmd->getType().getName().c_str(), cmd->getAddress()->toString().c_str());
@@ -242,6 +390,106 @@ void StorageApiRpcService::send_rpc_v1_request(std::shared_ptr<api::StorageComma
                                                     CachingRpcTargetResolver::address_to_slobrok_id(*cmd->getAddress()).c_str(),
                                                     target->spec().c_str(), vespalib::to_s(cmd->getTimeout())));
     }
+    if (is_batchable(*cmd)) {
+        enqueue_for_batching(std::move(target), std::move(cmd));
+    } else {
+        send_rpc_v1_request_to_target(*target, std::move(cmd));
+    }
+}
+
+bool StorageApiRpcService::is_batchable(const api::StorageCommand& cmd) const noexcept {
+    if (_params.max_batch_size < 2) {
+        return false;
+    }
+    const auto type_id = cmd.getType().getId();
+    return ((type_id == api::MessageType::PUT_ID) || (type_id == api::MessageType::REMOVE_ID));
+}
+
+void StorageApiRpcService::enqueue_for_batching(std::shared_ptr<RpcTarget> target,
+                                                std::shared_ptr<api::StorageCommand> cmd)
+{
+    PendingBatch full_batch;
+    {
+        std::lock_guard guard(_batch_lock);
+        auto& batch = _pending_batches[target.get()];
+        if (!batch.target) {
+            batch.target = std::move(target);
+        }
+        batch.cmds.emplace_back(std::move(cmd));
+        if (batch.cmds.size() >= _params.max_batch_size) {
+            auto iter = _pending_batches.find(batch.target.get());
+            full_batch = std::move(iter->second);
+            _pending_batches.erase(iter);
+        } else if (!_batch_flush_scheduled) {
+            _batch_flush_scheduled = true;
+            _batch_flush_task->Schedule(vespalib::to_s(_params.batch_window));
+        }
+    }
+    if (!full_batch.cmds.empty()) {
+        send_rpc_v1_batch(std::move(full_batch));
+    }
+}
+
+void StorageApiRpcService::flush_pending_batches() {
+    PendingBatchMap to_send;
+    {
+        std::lock_guard guard(_batch_lock);
+        to_send.swap(_pending_batches);
+        _batch_flush_scheduled = false;
+    }
+    for (auto& entry : to_send) {
+        send_rpc_v1_batch(std::move(entry.second));
+    }
+}
+
+void StorageApiRpcService::send_rpc_v1_batch(PendingBatch batch) {
+    if (batch.cmds.size() == 1) {
+        send_rpc_v1_request_to_target(*batch.target, std::move(batch.cmds.front()));
+        return;
+    }
+    LOG(spam, "Client: sending rpc.v1 batch request with %zu messages to %s",
+        batch.cmds.size(), batch.target->spec().c_str());
+    std::unique_ptr<FRT_RPCRequest, SubRefDeleter> req(_rpc_resources.supervisor().AllocRPCRequest());
+    req->SetMethodName(rpc_v1_batch_method_name());
+
+    const auto n = static_cast<uint32_t>(batch.cmds.size());
+    auto* params = req->GetParams();
+    uint8_t* header_encodings = params->AddInt8Array(n);
+    uint32_t* header_sizes = params->AddInt32Array(n);
+    FRT_DataValue* headers = params->AddDataArray(n);
+    vespalib::duration timeout = vespalib::duration::zero();
+    for (uint32_t i = 0; i < n; ++i) {
+        const auto& cmd = *batch.cmds[i];
+        protobuf::RequestHeader req_hdr;
+        req_hdr.set_time_remaining_ms(std::chrono::duration_cast<std::chrono::milliseconds>(cmd.getTimeout()).count());
+        req_hdr.set_trace_level(cmd.getTrace().getLevel());
+        auto encoded_hdr = req_hdr.SerializeAsString();
+        assert(encoded_hdr.size() <= UINT32_MAX);
+        header_encodings[i] = CompressionConfig::Type::NONE;
+        header_sizes[i] = static_cast<uint32_t>(encoded_hdr.size());
+        params->SetData(&headers[i], encoded_hdr.data(), header_sizes[i]);
+        // Every request carries its own deadline in its header; the RPC itself must outlive all of them.
+        timeout = std::max(timeout, cmd.getTimeout());
+    }
+    uint8_t* body_encodings = params->AddInt8Array(n);
+    uint32_t* body_sizes = params->AddInt32Array(n);
+    FRT_DataValue* bodies = params->AddDataArray(n);
+    auto wrapped_codec = _message_codec_provider.wrapped_codec();
+    for (uint32_t i = 0; i < n; ++i) {
+        auto payload = wrapped_codec->codec().encode(*batch.cmds[i]);
+        vespalib::DataBuffer buf(vespalib::roundUp2inN(payload.size()));
+        body_encodings[i] = compress_payload(payload, _params.compression_config, buf);
+        body_sizes[i] = static_cast<uint32_t>(payload.size());
+        params->SetData(&bodies[i], buf.getData(), static_cast<uint32_t>(buf.getDataLen()));
+    }
+    auto target = batch.target;
+    auto& req_ctx = req->getStash().create<BatchedRpcRequestContext>(std::move(batch));
+    req->SetContext(FNET_Context(&req_ctx));
+
+    target->get()->InvokeAsync(req.release(), vespalib::to_s(timeout), this);
+}
+
+void StorageApiRpcService::send_rpc_v1_request_to_target(RpcTarget& target, std::shared_ptr<api::StorageCommand> cmd) {
     std::unique_ptr<FRT_RPCRequest, SubRefDeleter> req(_rpc_resources.supervisor().AllocRPCRequest());
     req->SetMethodName(rpc_v1_method_name());
 
@@ -258,22 +506,27 @@ void StorageApiRpcService::send_rpc_v1_request(std::shared_ptr<api::StorageComma
     auto& req_ctx = req->getStash().create<RpcRequestContext>(std::move(cmd));
     req->SetContext(FNET_Context(&req_ctx));
 
-    target->get()->InvokeAsync(req.release(), vespalib::to_s(timeout), this);
+    target.get()->InvokeAsync(req.release(), vespalib::to_s(timeout), this);
 }
 
 void StorageApiRpcService::RequestDone(FRT_RPCRequest* raw_req) {
     std::unique_ptr<FRT_RPCRequest, SubRefDeleter> req(raw_req);
+    if (std::string_view(req->GetMethodName()) == rpc_v1_batch_method_name()) {
+        auto* batch_ctx = static_cast<BatchedRpcRequestContext*>(req->GetContext()._value.VOIDP);
+        handle_batch_request_done(*req, *batch_ctx);
+        return;
+    }
     auto* req_ctx = static_cast<RpcRequestContext*>(req->GetContext()._value.VOIDP);
     auto& cmd = *req_ctx->_originator_cmd;
     if (!req->CheckReturnTypes("bixbix")) {
-        handle_request_done_rpc_error(*req, *req_ctx);
+        handle_request_done_rpc_error(*req, cmd);
         return;
     }
     LOG(spam, "Client: received rpc.v1 OK response");
     const auto& ret = *req->GetReturn();
     protobuf::ResponseHeader hdr;
     if (!decode_header_from_rpc_params(ret, hdr)) {
-        handle_request_done_decode_error(*req_ctx, "Failed to decode RPC response header protobuf");
+        handle_request_done_decode_error(cmd, "Failed to decode RPC response header protobuf");
         return;
     }
     std::unique_ptr<mbusprot::StorageReply> wrapped_reply;
@@ -284,16 +537,76 @@ void StorageApiRpcService::RequestDone(FRT_RPCRequest* raw_req) {
     });
     if (!ok) {
         assert(!wrapped_reply);
-        handle_request_done_decode_error(*req_ctx, "Failed to decode RPC response payload");
+        handle_request_done_decode_error(cmd, "Failed to decode RPC response payload");
         return;
     }
     // TODO the reply wrapper does lazy deserialization. Can we/should we ever defer?
     auto reply = wrapped_reply->getInternalMessage(); // TODO message stealing
+    // TODO ensure that no implicit long-lived refs end up pointing into RPC memory...!
+    req->DiscardBlobs();
+    dispatch_received_reply(cmd, std::move(reply), hdr.trace_payload(), uncompressed_size);
+}
+
+void StorageApiRpcService::handle_batch_request_done(FRT_RPCRequest& req, BatchedRpcRequestContext& req_ctx) {
+    auto& cmds = req_ctx._originator_cmds;
+    if (req.GetErrorCode() == FRTE_RPC_NO_SUCH_METHOD) {
+        // The receiver predates batching, so give each request a go of its own.
+        LOG(debug, "Client: '%s' does not support batched rpc.v1 requests; resending %zu requests individually",
+            req_ctx._target->spec().c_str(), cmds.size());
+        for (auto& cmd : cmds) {
+            send_rpc_v1_request_to_target(*req_ctx._target, std::move(cmd));
+        }
+        return;
+    }
+    if (req.CheckReturnTypes("BIXBIX")
+        && (!batched_rpc_params_are_consistent(*req.GetReturn()) || ((*req.GetReturn())[0]._int8_array._len != cmds.size())))
+    {
+        req.SetError(FRTE_RPC_WRONG_RETURN, "Number of replies in batched RPC response does not match number of requests");
+    }
+    if (req.IsError()) {
+        for (auto& cmd : cmds) {
+            handle_request_done_rpc_error(req, *cmd);
+        }
+        return;
+    }
+    LOG(spam, "Client: received rpc.v1 OK batch response");
+    const auto& ret = *req.GetReturn();
+    for (uint32_t i = 0; i < cmds.size(); ++i) {
+        auto& cmd = *cmds[i];
+        protobuf::ResponseHeader hdr;
+        if (!decode_header_from_batched_rpc_params(ret, i, hdr)) {
+            handle_request_done_decode_error(cmd, "Failed to decode RPC response header protobuf");
+            continue;
+        }
+        const auto& body = ret[5]._data_array._pt[i];
+        std::unique_ptr<mbusprot::StorageReply> wrapped_reply;
+        uint32_t uncompressed_size = 0;
+        bool ok = uncompress_rpc_payload(ret[3]._int8_array._pt[i], ret[4]._int32_array._pt[i],
+                                         body._buf, body._len,
+                                         [&wrapped_reply, &uncompressed_size, &cmd](auto& codec, auto payload) {
+            wrapped_reply = codec.decodeReply(payload, cmd);
+            uncompressed_size = payload.size();
+        });
+        if (!ok) {
+            assert(!wrapped_reply);
+            handle_request_done_decode_error(cmd, "Failed to decode RPC response payload");
+            continue;
+        }
+        dispatch_received_reply(cmd, wrapped_reply->getInternalMessage(), hdr.trace_payload(), uncompressed_size);
+    }
+    req.DiscardBlobs();
+}
+
+void StorageApiRpcService::dispatch_received_reply(api::StorageCommand& cmd,
+                                                   std::shared_ptr<api::StorageMessage> reply,
+                                                   vespalib::stringref trace_payload,
+                                                   uint32_t uncompressed_size)
+{
     assert(reply);
     assert(reply->getMsgId() == cmd.getMsgId());
 
-    if (!hdr.trace_payload().empty()) {
-        cmd.getTrace().addChild(mbus::TraceNode::decode(hdr.trace_payload()));
+    if (!trace_payload.empty()) {
+        cmd.getTrace().addChild(mbus::TraceNode::decode(trace_payload));
     }
     if (cmd.getTrace().shouldTrace(TraceLevel::SEND_RECEIVE)) {
         cmd.getTrace().trace(TraceLevel::SEND_RECEIVE,
@@ -303,28 +616,22 @@ void StorageApiRpcService::RequestDone(FRT_RPCRequest* raw_req) {
     }
     reply->getTrace().swap(cmd.getTrace());
     reply->setApproxByteSize(uncompressed_size);
-
-    // TODO ensure that no implicit long-lived refs end up pointing into RPC memory...!
-    req->DiscardBlobs();
     _message_dispatcher.dispatch_sync(std::move(reply));
 }
 
-void StorageApiRpcService::handle_request_done_rpc_error(FRT_RPCRequest& req,
-                                                         const RpcRequestContext& req_ctx) {
-    auto& cmd = *req_ctx._originator_cmd;
+void StorageApiRpcService::handle_request_done_rpc_error(FRT_RPCRequest& req, api::StorageCommand& cmd) {
     api::ReturnCode error;
     if (req.GetErrorCode() == FRTE_RPC_NO_SUCH_METHOD) {
         error = api::ReturnCode(api::ReturnCode::NOT_CONNECTED, "Legacy MessageBus StorageAPI transport is no longer supported. "
                                                                 "Old nodes must be upgraded to a newer Vespa version.");
     } else {
-        error = map_frt_error_to_storage_api_error(req, req_ctx);
+        error = map_frt_error_to_storage_api_error(req, cmd);
     }
     create_and_dispatch_error_reply(cmd, std::move(error));
 }
 
-void StorageApiRpcService::handle_request_done_decode_error(const RpcRequestContext& req_ctx,
+void StorageApiRpcService::handle_request_done_decode_error(api::StorageCommand& cmd,
                                                             vespalib::stringref description) {
-    auto& cmd = *req_ctx._originator_cmd;
     assert(cmd.has_transport_context()); // Otherwise, reply already (destructively) generated by codec
     create_and_dispatch_error_reply(cmd, api::ReturnCode(
             static_cast<api::ReturnCode::Result>(mbus::ErrorCode::DECODE_ERROR), description));
@@ -344,9 +651,8 @@ void StorageApiRpcService::create_and_dispatch_error_reply(api::StorageCommand&
 
 api::ReturnCode
 StorageApiRpcService::map_frt_error_to_storage_api_error(FRT_RPCRequest& req,
-                                                         const RpcRequestContext& req_ctx) {
+                                                         const api::StorageCommand& cmd) {
     // TODO determine all codes that must be (re)mapped. Current remapping is adapted from RPCSend
-    const auto& cmd = *req_ctx._originator_cmd;
     auto target_service = CachingRpcTargetResolver::address_to_slobrok_id(*cmd.getAddress());
     switch (req.GetErrorCode()) {
     case FRTE_RPC_TIMEOUT:
@@ -4,11 +4,16 @@
 #include "rpc_target.h"
 #include <vespa/fnet/frt/invokable.h>
 #include <vespa/fnet/frt/invoker.h>
+#include <vespa/fnet/task.h>
 #include <vespa/storageapi/messageapi/returncode.h>
 #include <vespa/vespalib/stllike/string.h>
 #include <vespa/vespalib/util/compressionconfig.h>
+#include <vespa/vespalib/util/time.h>
 #include <atomic>
 #include <memory>
+#include <mutex>
+#include <unordered_map>
+#include <vector>
 
 class FRT_RPCRequest;
 class FRT_Target;
@@ -28,6 +33,7 @@ class StorageReply;
 
 namespace rpc {
 
+class BatchedRpcReplySlot;
 class CachingRpcTargetResolver;
 class MessageCodecProvider;
 class SharedRpcResources;
@@ -37,6 +43,11 @@ public:
     struct Params {
         vespalib::compression::CompressionConfig compression_config;
         size_t num_rpc_targets_per_node;
+        // Puts and Removes sent to the same RPC target within batch_window of each
+        // other are coalesced into a single batched RPC of at most max_batch_size
+        // commands. Batching is disabled if max_batch_size is less than 2.
+        size_t max_batch_size;
+        vespalib::duration batch_window;
 
         Params();
         ~Params();
@@ -47,6 +58,32 @@ private:
     MessageCodecProvider& _message_codec_provider;
     const Params          _params;
     std::unique_ptr<CachingRpcTargetResolver> _target_resolver;
+
+    struct PendingBatch {
+        std::shared_ptr<RpcTarget>                        target;
+        std::vector<std::shared_ptr<api::StorageCommand>> cmds;
+
+        PendingBatch() noexcept;
+        PendingBatch(PendingBatch&&) noexcept;
+        PendingBatch& operator=(PendingBatch&&) noexcept;
+        ~PendingBatch();
+    };
+    using PendingBatchMap = std::unordered_map<const RpcTarget*, PendingBatch>;
+
+    class BatchFlushTask : public FNET_Task {
+        StorageApiRpcService& _service;
+    public:
+        BatchFlushTask(FNET_Scheduler* scheduler, StorageApiRpcService& service)
+            : FNET_Task(scheduler),
+              _service(service)
+        {}
+        void PerformTask() override;
+    };
+
+    std::mutex                      _batch_lock;
+    PendingBatchMap                 _pending_batches;
+    bool                            _batch_flush_scheduled;
+    std::unique_ptr<BatchFlushTask> _batch_flush_task;
 public:
     StorageApiRpcService(MessageDispatcher& message_dispatcher,
                          SharedRpcResources& rpc_resources,
@@ -61,9 +98,17 @@ public:
     void encode_rpc_v1_response(FRT_RPCRequest& request, api::StorageReply& reply);
     void send_rpc_v1_request(std::shared_ptr<api::StorageCommand> cmd);
 
+    void RPC_rpc_v1_send_batch(FRT_RPCRequest* req);
+    void encode_rpc_v1_batched_response(BatchedRpcReplySlot& slot, api::StorageReply& reply);
+    // Sends any commands currently waiting for their batch window to expire.
+    void flush_pending_batches();
+
     static constexpr const char* rpc_v1_method_name() noexcept {
         return "storageapi.v1.send";
     }
+    static constexpr const char* rpc_v1_batch_method_name() noexcept {
+        return "storageapi.v1.send_batch";
+    }
 private:
     void detach_and_forward_to_enqueuer(std::shared_ptr<api::StorageMessage> cmd, FRT_RPCRequest* req);
 
@@ -75,19 +120,41 @@ private:
         {}
     };
 
+    struct BatchedRpcRequestContext {
+        std::shared_ptr<RpcTarget>                        _target;
+        std::vector<std::shared_ptr<api::StorageCommand>> _originator_cmds;
+
+        explicit BatchedRpcRequestContext(PendingBatch batch)
+            : _target(std::move(batch.target)),
+              _originator_cmds(std::move(batch.cmds))
+        {}
+    };
+
+    [[nodiscard]] bool is_batchable(const api::StorageCommand& cmd) const noexcept;
+    void enqueue_for_batching(std::shared_ptr<RpcTarget> target, std::shared_ptr<api::StorageCommand> cmd);
+    void send_rpc_v1_request_to_target(RpcTarget& target, std::shared_ptr<api::StorageCommand> cmd);
+    void send_rpc_v1_batch(PendingBatch batch);
+    void handle_batch_request_done(FRT_RPCRequest& req, BatchedRpcRequestContext& req_ctx);
+    void dispatch_received_reply(api::StorageCommand& cmd, std::shared_ptr<api::StorageMessage> reply,
+                                 vespalib::stringref trace_payload, uint32_t uncompressed_size);
+
     void register_server_methods(SharedRpcResources&);
     template <typename PayloadCodecCallback>
     [[nodiscard]] bool uncompress_rpc_payload(const FRT_Values& params, PayloadCodecCallback payload_callback);
+    template <typename PayloadCodecCallback>
+    [[nodiscard]] bool uncompress_rpc_payload(uint8_t encoding, uint32_t uncompressed_length,
+                                              const char* buf, uint32_t len,
+                                              PayloadCodecCallback payload_callback);
     template <typename MessageType>
     void encode_and_compress_rpc_payload(const MessageType& msg, FRT_Values& params);
     void RequestDone(FRT_RPCRequest* request) override;
 
-    void handle_request_done_rpc_error(FRT_RPCRequest& req, const RpcRequestContext& req_ctx);
-    void handle_request_done_decode_error(const RpcRequestContext& req_ctx,
+    void handle_request_done_rpc_error(FRT_RPCRequest& req, api::StorageCommand& cmd);
+    void handle_request_done_decode_error(api::StorageCommand& cmd,
                                           vespalib::stringref description);
     void create_and_dispatch_error_reply(api::StorageCommand& cmd, api::ReturnCode error);
 
-    api::ReturnCode map_frt_error_to_storage_api_error(FRT_RPCRequest& req, const RpcRequestContext& req_ctx);
+    api::ReturnCode map_frt_error_to_storage_api_error(FRT_RPCRequest& req, const api::StorageCommand& cmd);
     api::ReturnCode make_no_address_for_service_error(const api::StorageMessageAddress& addr) const;
 };
 
@@ -76,28 +76,28 @@ StateReporter::reportStatus(std::ostream& out,
 vespalib::string
 StateReporter::getMetrics(const vespalib::string &consumer)
 {
-    metrics::MetricLockGuard guard(_manager.getMetricLock());
-    auto periods = _manager.getSnapshotPeriods(guard);
-    if (periods.empty()) {
-        return ""; // no configuration yet
-    }
-    auto interval = periods[0];
-
-    // To get unset metrics, we have to copy active metrics, clear them
-    // and then assign the snapshot
-    metrics::MetricSnapshot snapshot(
-            _manager.getMetricSnapshot(guard, interval).getName(), interval,
-            _manager.getActiveMetrics(guard).getMetrics(), true);
-
-    snapshot.reset();
-    _manager.getMetricSnapshot(guard, interval).addToSnapshot(snapshot, _component.getClock().getSystemTime());
-
-    vespalib::asciistream json;
-    vespalib::JsonStream stream(json);
-    metrics::JsonWriter metricJsonWriter(stream);
-    _manager.visit(guard, snapshot, metricJsonWriter, consumer);
-    stream.finalize();
-    return json.str();
+    return _manager.getCachedSnapshotRendering("statereporter:" + consumer, [this, &consumer](const metrics::MetricLockGuard &guard) {
+        auto periods = _manager.getSnapshotPeriods(guard);
+        if (periods.empty()) {
+            return vespalib::string(); // no configuration yet
+        }
+        auto interval = periods[0];
+        const metrics::MetricSnapshot &source(_manager.getMetricSnapshot(guard, interval));
+
+        // To get unset metrics, we have to copy active metrics, clear them
+        // and then assign the snapshot
+        metrics::MetricSnapshot snapshot(source.getName(), interval, _manager.getActiveMetrics(guard).getMetrics(), true);
+
+        snapshot.reset();
+        source.addToSnapshot(snapshot, source.getToTime());
+
+        vespalib::asciistream json;
+        vespalib::JsonStream stream(json);
+        metrics::JsonWriter metricJsonWriter(stream);
+        _manager.visit(guard, snapshot, metricJsonWriter, consumer);
+        stream.finalize();
+        return vespalib::string(json.str());
+    });
 }
 
 vespalib::string
@@ -2,28 +2,37 @@
 
 #include "dumpvisitorsingle.h"
 #include <vespa/persistence/spi/docentry.h>
+#include <vespa/document/datatype/documenttype.h>
+#include <vespa/document/repo/documenttyperepo.h>
 #include <vespa/document/update/documentupdate.h>
 #include <vespa/document/fieldvalue/document.h>
 #include <vespa/documentapi/messagebus/messages/putdocumentmessage.h>
 #include <vespa/documentapi/messagebus/messages/removedocumentmessage.h>
+#include <vespa/documentapi/messagebus/messages/visitor.h>
+#include <vespa/vdslib/container/parameters.hpp>
 
 #include <vespa/log/log.h>
 LOG_SETUP(".visitor.instance.dumpvisitorsingle");
 
 namespace storage {
 
-DumpVisitorSingle::DumpVisitorSingle(StorageComponent& component, const vdslib::Parameters&)
-    : Visitor(component)
+DumpVisitorSingle::DumpVisitorSingle(StorageComponent& component, const vdslib::Parameters& params)
+    : Visitor(component),
+      _maxBytesPerBatch(params.get("maxbytesperbatch", 0u))
 {
 }
 
-void DumpVisitorSingle::handleDocuments(const document::BucketId&,
+void DumpVisitorSingle::handleDocuments(const document::BucketId& bucketId,
                                         DocEntryList& entries,
                                         HitCounter& hitCounter)
 {
     LOG(debug, "Visitor %s handling block of %zu documents.",
                _id.c_str(), entries.size());
 
+    if (_maxBytesPerBatch > 0) {
+        handleDocumentsBatched(bucketId, entries, hitCounter);
+        return;
+    }
     for (size_t i = 0; i < entries.size(); ++i) {
         spi::DocEntry& entry(*entries[i]);
         const uint32_t docSize = entry.getSize();
@@ -39,4 +48,44 @@ void DumpVisitorSingle::handleDocuments(const document::BucketId&,
     }
 }
 
+void DumpVisitorSingle::handleDocumentsBatched(const document::BucketId& bucketId,
+                                               DocEntryList& entries,
+                                               HitCounter& hitCounter)
+{
+    auto repo = _component.getTypeRepo()->documentTypeRepo;
+    std::unique_ptr<documentapi::DocumentListMessage> msg;
+    uint32_t batchBytes = 0;
+    for (size_t i = 0; i < entries.size(); ++i) {
+        spi::DocEntry& entry(*entries[i]);
+        const uint32_t docSize = entry.getSize();
+        const document::DocumentId& docId(*entry.getDocumentId());
+        hitCounter.addHit(docId, docSize);
+        std::shared_ptr<document::Document> doc;
+        if (entry.isRemove()) {
+            const document::DocumentType* type = repo->getDocumentType(docId.getDocType());
+            if (type == nullptr) {
+                sendMessage(std::make_unique<documentapi::RemoveDocumentMessage>(docId));
+                continue;
+            }
+            doc = std::make_shared<document::Document>(*repo, *type, docId);
+        } else {
+            doc = entry.releaseDocument();
+        }
+        if (!msg) {
+            msg = std::make_unique<documentapi::DocumentListMessage>(bucketId);
+        }
+        msg->getDocuments().emplace_back(entry.getTimestamp(), std::move(doc), entry.isRemove());
+        batchBytes += docSize;
+        if (batchBytes >= _maxBytesPerBatch) {
+            msg->setApproxSize(batchBytes);
+            sendMessage(std::move(msg));
+            batchBytes = 0;
+        }
+    }
+    if (msg) {
+        msg->setApproxSize(batchBytes);
+        sendMessage(std::move(msg));
+    }
+}
+
 }
@@ -4,7 +4,11 @@
  * @ingroup visitors
  *
  * @brief A dump visitor is a visitor that sends documents to the client.
- * Each document is sent as a single message
+ * Each document is sent as a single message, unless the client sets the
+ * "maxbytesperbatch" parameter. Documents are then sent in document list
+ * messages of up to roughly that many bytes per bucket chunk, which saves
+ * per message routing and serialization overhead, and lets the message
+ * bus compress larger payloads.
  *
  */
 #pragma once
@@ -19,7 +23,10 @@ public:
                       const vdslib::Parameters& params);
 
 private:
+    uint32_t _maxBytesPerBatch;
+
     void handleDocuments(const document::BucketId&, DocEntryList&, HitCounter&) override;
+    void handleDocumentsBatched(const document::BucketId&, DocEntryList&, HitCounter&);
 };
 
 struct DumpVisitorSingleFactory : public VisitorFactory {
@@ -91,6 +91,17 @@ std::shared_ptr<document::Document> get_document(const protobuf::Document& src_d
     return {};
 }
 
+// Fed documents keep their serialized form, which is reused when persisting them
+std::shared_ptr<document::Document> get_fed_document(const protobuf::Document& src_doc,
+                                                     const document::DocumentTypeRepo& type_repo)
+{
+    if (!src_doc.payload().empty()) {
+        vespalib::nbostream doc_buf(src_doc.payload().data(), src_doc.payload().size());
+        return document::Document::make_retaining_serialized_form(type_repo, doc_buf);
+    }
+    return {};
+}
+
 void set_update(protobuf::Update& dest, const document::DocumentUpdate& src) {
     vespalib::nbostream stream;
     src.serializeHEAD(stream);
@@ -433,7 +444,7 @@ void ProtocolSerialization7::onEncode(GBBuf& buf, const api::PutReply& msg) cons
 
 api::StorageCommand::UP ProtocolSerialization7::onDecodePutCommand(BBuf& buf) const {
     return decode_bucket_request<protobuf::PutRequest>(buf, [&](auto& req, auto& bucket) {
-        auto document = get_document(req.document(), type_repo());
+        auto document = get_fed_document(req.document(), type_repo());
         auto cmd = std::make_unique<api::PutCommand>(bucket, std::move(document), req.new_timestamp());
         cmd->setUpdateTimestamp(req.expected_old_timestamp());
         if (req.has_condition()) {
@@ -907,12 +918,22 @@ void ProtocolSerialization7::onEncode(GBBuf& buf, const api::GetBucketDiffComman
         set_merge_nodes(*req.mutable_nodes(), msg.getNodes());
         req.set_max_timestamp(msg.getMaxTimestamp());
         fill_proto_meta_diff(*req.mutable_diff(), msg.getDiff());
+        if (msg.isRangeDigest()) {
+            req.mutable_range_checksums()->Add(msg.getRangeChecksums().begin(), msg.getRangeChecksums().end());
+            req.set_differing_ranges(msg.getRangeMask());
+        } else if (msg.getRangeMask() != api::GetBucketDiffCommand::ALL_RANGES) {
+            req.set_range_mask(msg.getRangeMask());
+        }
     });
 }
 
 void ProtocolSerialization7::onEncode(GBBuf& buf, const api::GetBucketDiffReply& msg) const {
     encode_bucket_response<protobuf::GetBucketDiffResponse>(buf, msg, [&](auto& res) {
         fill_proto_meta_diff(*res.mutable_diff(), msg.getDiff());
+        if (msg.rangesCompared()) {
+            res.set_ranges_compared(true);
+            res.set_differing_ranges(msg.getDifferingRanges());
+        }
     });
 }
 
@@ -921,6 +942,12 @@ api::StorageCommand::UP ProtocolSerialization7::onDecodeGetBucketDiffCommand(BBu
         auto nodes = get_merge_nodes(req.nodes());
         auto cmd = std::make_unique<api::GetBucketDiffCommand>(bucket, std::move(nodes), req.max_timestamp());
         fill_api_meta_diff(cmd->getDiff(), req.diff());
+        if (req.range_checksums_size() > 0) {
+            cmd->getRangeChecksums().assign(req.range_checksums().begin(), req.range_checksums().end());
+            cmd->setRangeMask(req.differing_ranges());
+        } else if (req.range_mask() != 0) {
+            cmd->setRangeMask(req.range_mask());
+        }
         return cmd;
     });
 }
@@ -929,6 +956,9 @@ api::StorageReply::UP ProtocolSerialization7::onDecodeGetBucketDiffReply(const S
     return decode_bucket_response<protobuf::GetBucketDiffResponse>(buf, [&](auto& res) {
         auto reply = std::make_unique<api::GetBucketDiffReply>(static_cast<const api::GetBucketDiffCommand&>(cmd));
         fill_api_meta_diff(reply->getDiff(), res.diff());
+        if (res.ranges_compared()) {
+            reply->setDifferingRanges(res.differing_ranges());
+        }
         return reply;
     });
 }
@@ -983,6 +1013,7 @@ void ProtocolSerialization7::onEncode(GBBuf& buf, const api::ApplyBucketDiffComm
         set_merge_nodes(*req.mutable_nodes(), msg.getNodes());
         req.set_max_buffer_size(0x400000); // Unused, GC soon.
         fill_proto_apply_diff_vector(*req.mutable_entries(), msg.getDiff());
+        req.set_max_chunk_size(msg.getMaxChunkSize());
     });
 }
 
@@ -997,6 +1028,7 @@ api::StorageCommand::UP ProtocolSerialization7::onDecodeApplyBucketDiffCommand(B
         auto nodes = get_merge_nodes(req.nodes());
         auto cmd = std::make_unique<api::ApplyBucketDiffCommand>(bucket, std::move(nodes));
         fill_api_apply_diff_vector(cmd->getDiff(), req.entries());
+        cmd->setMaxChunkSize(req.max_chunk_size());
         return cmd;
     });
 }
@@ -218,7 +218,10 @@ GetBucketDiffCommand::GetBucketDiffCommand(
         Timestamp maxTimestamp)
     : BucketCommand(MessageType::GETBUCKETDIFF, bucket),
       _nodes(nodes),
-      _maxTimestamp(maxTimestamp)
+      _maxTimestamp(maxTimestamp),
+      _diff(),
+      _rangeChecksums(),
+      _rangeMask(ALL_RANGES)
 {}
 
 GetBucketDiffCommand::~GetBucketDiffCommand() = default;
@@ -233,8 +236,9 @@ GetBucketDiffCommand::print(std::ostream& out, bool verbose,
         if (i != 0) out << ", ";
         out << _nodes[i];
     }
-    
-    if (_diff.empty()) {
+    if (isRangeDigest()) {
+        out << "], " << _rangeChecksums.size() << " range checksums";
+    } else if (_diff.empty()) {
         out << "], no entries";
     } else if (verbose) {
         out << "],";
@@ -257,7 +261,9 @@ GetBucketDiffReply::GetBucketDiffReply(const GetBucketDiffCommand& cmd)
     : BucketReply(cmd),
       _nodes(cmd.getNodes()),
       _maxTimestamp(cmd.getMaxTimestamp()),
-      _diff(cmd.getDiff())
+      _diff(cmd.getDiff()),
+      _rangesCompared(false),
+      _differingRanges(0)
 {}
 
 GetBucketDiffReply::~GetBucketDiffReply() = default;
@@ -272,7 +278,9 @@ GetBucketDiffReply::print(std::ostream& out, bool verbose,
         if (i != 0) out << ", ";
         out << _nodes[i];
     }
-    if (_diff.empty()) {
+    if (_rangesCompared) {
+        out << "], differing ranges 0x" << std::hex << _differingRanges << std::dec;
+    } else if (_diff.empty()) {
         out << "], no entries";
     } else if (verbose) {
         out << "],";
@@ -354,7 +362,8 @@ ApplyBucketDiffCommand::ApplyBucketDiffCommand(
         const document::Bucket &bucket, const std::vector<Node>& nodes)
     : BucketInfoCommand(MessageType::APPLYBUCKETDIFF, bucket),
       _nodes(nodes),
-      _diff()
+      _diff(),
+      _maxChunkSize(0)
 {}
 
 ApplyBucketDiffCommand::~ApplyBucketDiffCommand() = default;
@@ -401,7 +410,8 @@ ApplyBucketDiffCommand::print(std::ostream& out, bool verbose,
 ApplyBucketDiffReply::ApplyBucketDiffReply(const ApplyBucketDiffCommand& cmd)
     : BucketInfoReply(cmd),
       _nodes(cmd.getNodes()),
-      _diff(cmd.getDiff())
+      _diff(cmd.getDiff()),
+      _maxChunkSize(cmd.getMaxChunkSize())
 {}
 
 ApplyBucketDiffReply::~ApplyBucketDiffReply() = default;
@@ -206,10 +206,18 @@ public:
         bool operator<(const Entry& e) const
             { return (_timestamp < e._timestamp); }
     };
+    static constexpr uint64_t ALL_RANGES = ~uint64_t(0);
 private:
     std::vector<Node> _nodes;
     Timestamp _maxTimestamp;
     std::vector<Entry> _diff;
+    // Checksums of the first node's entries per range. If set, this is a
+    // range digest round where nodes report ranges differing from these
+    // instead of building a diff.
+    std::vector<uint64_t> _rangeChecksums;
+    // Range digest round: ranges found to differ so far in the chain.
+    // Diff round: ranges nodes should include entries from.
+    uint64_t _rangeMask;
 
 public:
     GetBucketDiffCommand(const document::Bucket &bucket,
@@ -221,6 +229,11 @@ public:
     Timestamp getMaxTimestamp() const { return _maxTimestamp; }
     const std::vector<Entry>& getDiff() const { return _diff; }
     std::vector<Entry>& getDiff() { return _diff; }
+    const std::vector<uint64_t>& getRangeChecksums() const { return _rangeChecksums; }
+    std::vector<uint64_t>& getRangeChecksums() { return _rangeChecksums; }
+    bool isRangeDigest() const { return !_rangeChecksums.empty(); }
+    uint64_t getRangeMask() const { return _rangeMask; }
+    void setRangeMask(uint64_t mask) { _rangeMask = mask; }
 
     void print(std::ostream& out, bool verbose, const std::string& indent) const override;
 
@@ -242,6 +255,9 @@ private:
     std::vector<Node> _nodes;
     Timestamp _maxTimestamp;
     std::vector<Entry> _diff;
+    // Set when all nodes in the chain compared their range checksums.
+    bool _rangesCompared;
+    uint64_t _differingRanges;
 
 public:
     explicit GetBucketDiffReply(const GetBucketDiffCommand& cmd);
@@ -251,6 +267,12 @@ public:
     Timestamp getMaxTimestamp() const { return _maxTimestamp; }
     const std::vector<Entry>& getDiff() const { return _diff; }
     std::vector<Entry>& getDiff() { return _diff; }
+    bool rangesCompared() const { return _rangesCompared; }
+    uint64_t getDifferingRanges() const { return _differingRanges; }
+    void setDifferingRanges(uint64_t ranges) {
+        _rangesCompared = true;
+        _differingRanges = ranges;
+    }
     void print(std::ostream& out, bool verbose, const std::string& indent) const override;
 
     DECLARE_STORAGEREPLY(GetBucketDiffReply, onGetBucketDiffReply)
@@ -290,6 +312,9 @@ public:
 private:
     std::vector<Node> _nodes;
     std::vector<Entry> _diff;
+    // Max bytes of document data each node adds to the diff. 0 means
+    // the configured merge chunk size of the node.
+    uint32_t _maxChunkSize;
 
 public:
     ApplyBucketDiffCommand(const document::Bucket &bucket,
@@ -299,6 +324,8 @@ public:
     const std::vector<Node>& getNodes() const { return _nodes; }
     const std::vector<Entry>& getDiff() const { return _diff; }
     std::vector<Entry>& getDiff() { return _diff; }
+    uint32_t getMaxChunkSize() const { return _maxChunkSize; }
+    void setMaxChunkSize(uint32_t maxChunkSize) { _maxChunkSize = maxChunkSize; }
     void print(std::ostream& out, bool verbose, const std::string& indent) const override;
 
     DECLARE_STORAGECOMMAND(ApplyBucketDiffCommand, onApplyBucketDiff)
@@ -318,6 +345,7 @@ public:
 private:
     std::vector<Node> _nodes;
     std::vector<Entry> _diff;
+    uint32_t _maxChunkSize;
 
 public:
     explicit ApplyBucketDiffReply(const ApplyBucketDiffCommand& cmd);
@@ -326,6 +354,7 @@ public:
     const std::vector<Node>& getNodes() const { return _nodes; }
     const std::vector<Entry>& getDiff() const { return _diff; }
     std::vector<Entry>& getDiff() { return _diff; }
+    uint32_t getMaxChunkSize() const { return _maxChunkSize; }
 
     void print(std::ostream& out, bool verbose, const std::string& indent) const override;
 
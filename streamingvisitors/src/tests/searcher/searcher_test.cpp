@@ -632,6 +632,18 @@ TEST("utf8 substring search") {
     }
 }
 
+TEST("utf8 substring search across ascii blocks and non-ascii text") {
+    UTF8SubStringFieldSearcher fs(0);
+    std::string field = "The Quick Brown Fox Jumps Over The Lazy Dog in \xc3\x86r\xc3\xb8sk\xc3\xb8bing Harbour";
+    assertString(fs, "quick", field, Hits().add({0, 1}));
+    assertString(fs, "harbour", field, Hits().add({0, 11}));
+    assertString(fs, StringList().add("ump").add("dog").add("\xc3\xb8bing").add("fox"), field,
+                 HitsList().add(Hits().add({0, 4})).add(Hits().add({0, 8}))
+                           .add(Hits().add({0, 10})).add(Hits().add({0, 3})));
+    assertString(fs, StringList().add("zzz").add("the"), field,
+                 HitsList().add(Hits()).add(Hits().add({0, 0}).add({0, 6})));
+}
+
 TEST("utf8 substring search with empty term")
 {
     UTF8SubStringFieldSearcher fs(0);
@@ -0,0 +1,143 @@
+// Copyright Vespa.ai. Licensed under the terms of the Apache 2.0 license. See LICENSE in the project root.
+
+// Measures the throughput of the string field searchers used in
+// streaming search when matching a few query terms against mail-like
+// documents (headers, mixed case prose, addresses, some non-ascii
+// names and quoted replies).
+//
+// usage: vsm_searcher_benchmark_app [--smoke-test]
+
+#include <vespa/document/fieldvalue/document.h>
+#include <vespa/document/fieldvalue/stringfieldvalue.h>
+#include <vespa/searchlib/query/streaming/queryterm.h>
+#include <vespa/vsm/searcher/futf8strchrfieldsearcher.h>
+#include <vespa/vsm/searcher/mock_field_searcher_env.h>
+#include <vespa/vsm/searcher/utf8strchrfieldsearcher.h>
+#include <vespa/vsm/searcher/utf8substringsearcher.h>
+#include <vespa/vespalib/util/benchmark_timer.h>
+#include <cstdio>
+#include <random>
+#include <string>
+#include <vector>
+
+using search::streaming::Normalizing;
+using search::streaming::QueryNodeResultFactory;
+using search::streaming::QueryTerm;
+using search::streaming::QueryTermList;
+using vespalib::BenchmarkTimer;
+using namespace vsm;
+
+double budget = 2.0;
+size_t num_docs = 2000;
+
+const std::vector<std::string> names = { "Alice Johnson", "Bj\xc3\xb8rn S\xc3\xa6ther", "Chlo\xc3\xa9 Dubois",
+                                         "Dmitri Ivanov", "Eva M\xc3\xbcller", "Fatima Haddad", "Giulia Rossi" };
+const std::vector<std::string> words = { "meeting", "project", "Budget", "deadline", "review", "Quarterly",
+                                         "report", "attached", "please", "thanks", "schedule", "invoice",
+                                         "Tomorrow", "update", "release", "customer", "feedback", "the", "and",
+                                         "for", "with", "about", "regarding", "Re:", "Fwd:", "caf\xc3\xa9" };
+
+std::string make_mail(std::mt19937 &rnd) {
+    auto pick = [&](const std::vector<std::string> &list) -> const std::string & {
+        return list[rnd() % list.size()];
+    };
+    std::string mail = "From: " + pick(names) + " <user" + std::to_string(rnd() % 1000) + "@example.com>\n";
+    mail += "To: " + pick(names) + " <team@example.org>\n";
+    mail += "Subject: " + pick(words) + " " + pick(words) + " " + pick(words) + "\n\n";
+    size_t num_lines = 5 + (rnd() % 30);
+    for (size_t line = 0; line < num_lines; ++line) {
+        if ((rnd() % 5) == 0) {
+            mail += "> ";
+        }
+        size_t num_words = 4 + (rnd() % 10);
+        for (size_t i = 0; i < num_words; ++i) {
+            mail += pick(words);
+            mail += ((rnd() % 8) == 0) ? ", " : " ";
+        }
+        mail += ".\n";
+    }
+    mail += "--\n" + pick(names) + "\n";
+    return mail;
+}
+
+struct Corpus {
+    std::vector<std::unique_ptr<StorageDocument>> docs;
+    size_t bytes;
+    Corpus() : docs(), bytes(0) {
+        std::mt19937 rnd(42);
+        auto field_paths = std::make_shared<FieldPathMapT>();
+        field_paths->emplace_back();
+        for (size_t i = 0; i < num_docs; ++i) {
+            auto mail = make_mail(rnd);
+            bytes += mail.size();
+            auto doc = std::make_unique<StorageDocument>(std::make_unique<document::Document>(), field_paths, 1);
+            doc->setField(0, std::make_unique<document::StringFieldValue>(mail));
+            docs.push_back(std::move(doc));
+        }
+    }
+};
+
+struct Query {
+    QueryNodeResultFactory factory;
+    std::vector<QueryTerm::UP> terms;
+    QueryTermList list;
+    Query(const std::vector<std::string> &words, QueryTerm::Type type) : factory(), terms(), list() {
+        for (const auto &word: words) {
+            terms.push_back(std::make_unique<QueryTerm>(factory.create(), word, "index", type, Normalizing::LOWERCASE_AND_FOLD));
+            list.push_back(terms.back().get());
+        }
+    }
+    void reset() {
+        for (auto &term: terms) {
+            term->reset();
+        }
+    }
+};
+
+size_t total_hits(const Query &query) {
+    size_t hits = 0;
+    for (const auto &term: query.terms) {
+        hits += term->getHitList().size();
+    }
+    return hits;
+}
+
+void benchmark(const char *name, FieldSearcher &searcher, const Corpus &corpus,
+               const std::vector<std::string> &words, QueryTerm::Type type)
+{
+    Query query(words, type);
+    test::MockFieldSearcherEnv env;
+    env.prepare(searcher, query.list);
+    size_t hits = 0;
+    auto fun = [&]() {
+        for (const auto &doc: corpus.docs) {
+            query.reset();
+            searcher.search(*doc);
+            hits += total_hits(query);
+        }
+    };
+    double seconds = BenchmarkTimer::benchmark(fun, budget);
+    fprintf(stderr, "%-40s %zu terms: %8.1f MB/s (%zu hits)\n", name, words.size(),
+            (corpus.bytes / seconds) / (1024.0 * 1024.0), hits);
+}
+
+int main(int argc, char **argv) {
+    if ((argc > 1) && (std::string(argv[1]) == "--smoke-test")) {
+        budget = 0.001;
+        num_docs = 20;
+    }
+    Corpus corpus;
+    std::vector<std::string> one_term = { "report" };
+    std::vector<std::string> few_terms = { "invoice", "deadline", "caf\xc3\xa9" };
+    std::vector<std::string> many_terms = { "invoice", "deadline", "release", "quarter", "feedback",
+                                            "s\xc3\xa6ther", "customer", "budget" };
+    for (const auto *terms: { &one_term, &few_terms, &many_terms }) {
+        UTF8SubStringFieldSearcher substring(0);
+        benchmark("utf8 substring", substring, corpus, *terms, QueryTerm::Type::SUBSTRINGTERM);
+        UTF8StrChrFieldSearcher regular(0);
+        benchmark("utf8 regular", regular, corpus, *terms, QueryTerm::Type::WORD);
+        FUTF8StrChrFieldSearcher fast_regular(0);
+        benchmark("utf8 regular (ascii folding)", fast_regular, corpus, *terms, QueryTerm::Type::WORD);
+    }
+    return 0;
+}
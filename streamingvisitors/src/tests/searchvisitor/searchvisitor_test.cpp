@@ -259,6 +259,22 @@ TEST_F(SearchVisitorTest, match_features_returned_in_search_result)
     expect_match_features({"attribute(id)", "myfunc"}, {{5.0}, {25.0}, {7.0}, {27.0}}, *res);
 }
 
+TEST_F(SearchVisitorTest, documents_can_be_matched_in_parallel)
+{
+    DocumentVector docs;
+    for (int id = 1; id <= 40; ++id) {
+        docs.emplace_back(id);
+    }
+    auto exp_res = execute_query(RequestBuilder().summary_count(15).set_param("matchthreads", "1").
+                                     number_term("[5;30]", "id").build(), docs);
+    auto res = execute_query(RequestBuilder().summary_count(15).set_param("matchthreads", "3").
+                                     number_term("[5;30]", "id").build(), docs);
+    EXPECT_EQ(15u, res->getSearchResult().getHitCount());
+    EXPECT_EQ(to_hit_vector(exp_res->getSearchResult()), to_hit_vector(res->getSearchResult()));
+    EXPECT_EQ(to_hit_vector(exp_res->getDocumentSummary()), to_hit_vector(res->getDocumentSummary()));
+    EXPECT_EQ(exp_res->getSearchResult().getTotalHitCount(), res->getSearchResult().getTotalHitCount());
+}
+
 TEST_F(SearchVisitorTest, visitor_only_require_weak_read_consistency)
 {
     vdslib::Parameters params;
@@ -1,13 +1,17 @@
 // Copyright Vespa.ai. Licensed under the terms of the Apache 2.0 license. See LICENSE in the project root.
 
 #include "search_environment_snapshot.h"
+#include <vespa/vespalib/util/executor.h>
 
 namespace streaming {
 
-SearchEnvironmentSnapshot::SearchEnvironmentSnapshot(const RankManager& rank_manager, const vsm::VSMAdapter& vsm_adapter)
+SearchEnvironmentSnapshot::SearchEnvironmentSnapshot(const RankManager& rank_manager, const vsm::VSMAdapter& vsm_adapter,
+                                                     std::shared_ptr<vespalib::Executor> match_executor, uint32_t match_threads)
     : _rank_manager_snapshot(rank_manager.getSnapshot()),
       _vsm_fields_cfg(vsm_adapter.getFieldsConfig()),
-      _docsum_tools(vsm_adapter.getDocsumTools())
+      _docsum_tools(vsm_adapter.getDocsumTools()),
+      _match_executor(std::move(match_executor)),
+      _match_threads(match_threads)
 {
 }
 
@@ -4,6 +4,8 @@
 
 #include "rankmanager.h"
 
+namespace vespalib { class Executor; }
+
 namespace streaming {
 
 /*
@@ -16,13 +18,20 @@ class SearchEnvironmentSnapshot
     std::shared_ptr<const RankManager::Snapshot> _rank_manager_snapshot;
     std::shared_ptr<VsmfieldsConfig>             _vsm_fields_cfg;
     std::shared_ptr<const vsm::DocsumTools>      _docsum_tools;
+    std::shared_ptr<vespalib::Executor>          _match_executor;
+    uint32_t                                     _match_threads;
 
 public:
-    SearchEnvironmentSnapshot(const RankManager& rank_manager, const vsm::VSMAdapter& vsm_adapter);
+    SearchEnvironmentSnapshot(const RankManager& rank_manager, const vsm::VSMAdapter& vsm_adapter,
+                              std::shared_ptr<vespalib::Executor> match_executor, uint32_t match_threads);
     ~SearchEnvironmentSnapshot();
     const std::shared_ptr<const RankManager::Snapshot>& get_rank_manager_snapshot() const noexcept { return _rank_manager_snapshot; }
     const std::shared_ptr<VsmfieldsConfig>& get_vsm_fields_config() const noexcept { return _vsm_fields_cfg; }
     const std::shared_ptr<const vsm::DocsumTools>& get_docsum_tools() const noexcept { return _docsum_tools; }
+    // Executor used to match documents in parallel, sized by the matchthreads vsmfields config.
+    // Not set when matchthreads is 1.
+    vespalib::Executor* get_match_executor() const noexcept { return _match_executor.get(); }
+    uint32_t get_match_threads() const noexcept { return _match_threads; }
 };
 
 }
@@ -10,8 +10,10 @@
 #include <vespa/searchlib/fef/ranking_assets_builder.h>
 #include <vespa/searchlib/fef/ranking_assets_repo.h>
 #include <vespa/vespalib/stllike/hash_map.hpp>
+#include <vespa/vespalib/util/threadstackexecutor.h>
 #include <vespa/searchsummary/config/config-juniperrc.h>
 #include <vespa/fastlib/text/normwordfolder.h>
+#include <algorithm>
 #include <cassert>
 
 #include <vespa/log/log.h>
@@ -27,6 +29,12 @@ using vsm::VSMAdapter;
 
 namespace streaming {
 
+namespace {
+
+constexpr int max_match_threads = 64;
+
+}
+
 __thread SearchEnvironment::EnvMap * SearchEnvironment::_localEnvMap = nullptr;
 
 SearchEnvironment::Env::Env(const config::ConfigUri& configUri, const Fast_NormalizeWordFolder& wf, FNET_Transport* transport, const vespalib::string& file_distributor_connection_spec)
@@ -43,6 +51,8 @@ SearchEnvironment::Env::Env(const config::ConfigUri& configUri, const Fast_Norma
       _ranking_constants(),
       _ranking_expressions(),
       _ranking_assets_repo(),
+      _match_executor(),
+      _match_threads(1),
       _transport(transport),
       _file_distributor_connection_spec(file_distributor_connection_spec)
 {
@@ -76,7 +86,16 @@ SearchEnvironment::Env::configure(const config::ConfigSnapshot & snapshot)
     _generation = snapshot.getGeneration();
     _vsmAdapter->configure(snap);
     _rankManager->configure(snap, _ranking_assets_repo);
-    auto se_snapshot = std::make_shared<const SearchEnvironmentSnapshot>(*_rankManager, *_vsmAdapter);
+    // Visitors keep using the old executor through their snapshot until they are done.
+    uint32_t match_threads = std::clamp(_vsmAdapter->getFieldsConfig()->matchthreads, 1, max_match_threads);
+    if (match_threads != _match_threads) {
+        _match_executor.reset();
+        if (match_threads > 1) {
+            _match_executor = std::make_shared<vespalib::ThreadStackExecutor>(match_threads);
+        }
+        _match_threads = match_threads;
+    }
+    auto se_snapshot = std::make_shared<const SearchEnvironmentSnapshot>(*_rankManager, *_vsmAdapter, _match_executor, _match_threads);
     std::lock_guard guard(_lock);
     std::swap(se_snapshot, _snapshot);
 }
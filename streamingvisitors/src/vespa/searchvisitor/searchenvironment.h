@@ -15,6 +15,8 @@
 class FNET_Transport;
 class Fast_NormalizeWordFolder;
 
+namespace vespalib { class Executor; }
+
 namespace search::fef {
 
 struct IRankingAssetsRepo;
@@ -59,6 +61,8 @@ private:
         std::shared_ptr<const search::fef::RankingConstants>   _ranking_constants;
         std::shared_ptr<const search::fef::RankingExpressions> _ranking_expressions;
         std::shared_ptr<const search::fef::IRankingAssetsRepo> _ranking_assets_repo;
+        std::shared_ptr<vespalib::Executor>                    _match_executor;
+        uint32_t                                               _match_threads;
         FNET_Transport* const                                  _transport;
         const vespalib::string                                 _file_distributor_connection_spec;
     };
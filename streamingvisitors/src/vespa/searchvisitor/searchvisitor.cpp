@@ -21,7 +21,9 @@
 #include <vespa/vespalib/geo/zcurve.h>
 #include <vespa/vespalib/objects/nbostream.h>
 #include <vespa/vespalib/stllike/hash_map.hpp>
+#include <vespa/vespalib/util/count_down_latch.h>
 #include <vespa/vespalib/util/exceptions.h>
+#include <vespa/vespalib/util/lambdatask.h>
 #include <vespa/vespalib/util/size_literals.h>
 #include <vespa/vespalib/data/slime/slime.h>
 #include <vespa/vespalib/text/stringtokenizer.h>
@@ -309,7 +311,10 @@ SearchVisitor::SearchVisitor(StorageComponent& component,
     _rankAttribute(dynamic_cast<search::SingleFloatExtAttribute &>(*_rankAttributeBacking)),
     _shouldFillRankAttribute(false),
     _syntheticFieldsController(),
-    _rankController()
+    _rankController(),
+    _backingDocuments(),
+    _matchThreads(),
+    _matchExecutor(nullptr)
 {
     LOG(debug, "Created SearchVisitor");
 }
@@ -500,6 +505,16 @@ SearchVisitor::init(const Parameters & params)
             // This depends on _fieldPathMap (from setupScratchDocument),
             // and IQueryEnvironment (from setupRankProcessors).
             prepare_field_searchers();
+
+            // The match executor is sized by config, a query can only ask for fewer threads.
+            uint32_t matchThreads = _env->get_match_threads();
+            if (params.lookup("matchthreads", valueRef)) {
+                uint32_t wantedThreads = strtoul(vespalib::string(valueRef.data(), valueRef.size()).c_str(), nullptr, 0);
+                matchThreads = std::min(matchThreads, wantedThreads);
+            }
+            if (matchThreads > 1) {
+                setupMatchThreads(matchThreads, vespalib::stringref(queryBlob.data(), queryBlob.size()));
+            }
         } else {
             LOG(warning, "No query received");
         }
@@ -829,6 +844,50 @@ SearchVisitor::prepare_field_searchers()
                               *_fieldPathMap, _rankController.getRankProcessor()->get_query_env());
 }
 
+SearchVisitor::MatchThread::MatchThread(SearchVisitor & visitor, vespalib::stringref queryBlob)
+    : _query(),
+      _fieldSearcherMap(),
+      _searchBuffer(std::make_shared<vsm::SearcherBuf>())
+{
+    QueryTermDataFactory addOnFactory(&visitor);
+    _query = Query(addOnFactory, queryBlob);
+    _searchBuffer->reserve(0x10000);
+    const auto & specMap = visitor._fieldSearchSpecMap;
+    StringFieldIdTMap fieldsInQuery = specMap.buildFieldsInQuery(_query);
+    specMap.buildSearcherMap(fieldsInQuery.map(), _fieldSearcherMap);
+    _fieldSearcherMap.prepare(specMap.documentTypeMap(), _searchBuffer, _query, *visitor._fieldPathMap,
+                              visitor._rankController.getRankProcessor()->get_query_env());
+}
+
+SearchVisitor::MatchThread::~MatchThread() = default;
+
+bool
+SearchVisitor::MatchThread::match(const StorageDocument & doc)
+{
+    // let the visitor thread handle and report documents failing to match
+    bool hit(true);
+    try {
+        for (vsm::FieldSearcherContainer & fSearch : _fieldSearcherMap) {
+            fSearch->search(doc);
+        }
+        hit = _query.evaluate();
+    } catch (const std::exception &) {
+    }
+    _query.reset();
+    return hit;
+}
+
+void
+SearchVisitor::setupMatchThreads(uint32_t numThreads, vespalib::stringref queryBlob)
+{
+    _matchExecutor = _env->get_match_executor();
+    assert(_matchExecutor != nullptr);
+    for (uint32_t i = 0; i < numThreads; ++i) {
+        _matchThreads.push_back(std::make_unique<MatchThread>(*this, queryBlob));
+    }
+    LOG(debug, "Using %u threads to match documents", numThreads);
+}
+
 void
 SearchVisitor::setupSnippetModifiers()
 {
@@ -1029,19 +1088,27 @@ SearchVisitor::handleDocuments(const document::BucketId&, DocEntryList & entries
 
     const document::DocumentType* defaultDocType = _docTypeMapping.getDefaultDocumentType();
     assert(defaultDocType);
+    DocumentVector documents;
+    documents.reserve(entries.size());
     for (const auto & entry : entries) {
         auto document = std::make_unique<StorageDocument>(entry->releaseDocument(), _fieldPathMap, highestFieldNo);
-
+        if (defaultDocType != nullptr
+            && !compatibleDocumentTypes(*defaultDocType, document->docDoc().getType()))
+        {
+            LOG(debug, "Skipping document of type '%s' when handling only documents of type '%s'",
+                document->docDoc().getType().getName().c_str(), defaultDocType->getName().c_str());
+        } else {
+            documents.push_back(std::move(document));
+        }
+    }
+    std::vector<uint8_t> mayMatch = matchInParallel(documents);
+    for (size_t i = 0; i < documents.size(); ++i) {
+        auto & document = documents[i];
         try {
-            if (defaultDocType != nullptr
-                && !compatibleDocumentTypes(*defaultDocType, document->docDoc().getType()))
-            {
-                LOG(debug, "Skipping document of type '%s' when handling only documents of type '%s'",
-                    document->docDoc().getType().getName().c_str(), defaultDocType->getName().c_str());
-            } else {
-                if (handleDocument(*document)) {
-                    _backingDocuments.push_back(std::move(document));
-                }
+            if ( ! mayMatch.empty() && ! mayMatch[i]) {
+                handleNonMatchingDocument(*document);
+            } else if (handleDocument(*document)) {
+                _backingDocuments.push_back(std::move(document));
             }
         } catch (const std::exception & e) {
             LOG(warning, "Caught exception handling document '%s'. Exception='%s'",
@@ -1050,6 +1117,47 @@ SearchVisitor::handleDocuments(const document::BucketId&, DocEntryList & entries
     }
 }
 
+std::vector<uint8_t>
+SearchVisitor::matchInParallel(const DocumentVector & documents)
+{
+    std::vector<uint8_t> mayMatch;
+    size_t numThreads = _matchThreads.size();
+    if ((numThreads < 2) || (documents.size() < 2 * numThreads)) {
+        return mayMatch;
+    }
+    mayMatch.resize(documents.size(), 1);
+    size_t chunkSize = (documents.size() + numThreads - 1) / numThreads;
+    auto matchChunk = [&](size_t thread) {
+        size_t end = std::min(documents.size(), (thread + 1) * chunkSize);
+        for (size_t i = thread * chunkSize; i < end; ++i) {
+            mayMatch[i] = _matchThreads[thread]->match(*documents[i]) ? 1 : 0;
+        }
+    };
+    // the visitor thread matches the last chunk itself
+    vespalib::CountDownLatch latch(numThreads - 1);
+    for (size_t thread = 0; thread + 1 < numThreads; ++thread) {
+        auto rejected = _matchExecutor->execute(vespalib::makeLambdaTask([&matchChunk, &latch, thread]() {
+            matchChunk(thread);
+            latch.countDown();
+        }));
+        if (rejected) {
+            rejected->run();
+        }
+    }
+    matchChunk(numThreads - 1);
+    latch.await();
+    return mayMatch;
+}
+
+void
+SearchVisitor::handleNonMatchingDocument(StorageDocument & document)
+{
+    _syntheticFieldsController.onDocument(document);
+    group(document.docDoc(), 0, true);
+    _docSearchedCount++;
+    LOG(debug, "Did not match document with id '%s'", document.docDoc().getId().getScheme().toString().c_str());
+}
+
 bool
 SearchVisitor::handleDocument(StorageDocument & document)
 {
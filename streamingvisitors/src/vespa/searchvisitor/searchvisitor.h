@@ -105,6 +105,7 @@ private:
 
     public:
         AttributeInserter(search::AttributeVector & attribute, search::AttributeVector::DocId docId);
+        bool readOnly() const override { return true; }
     };
 
     class PositionInserter : public AttributeInserter {
@@ -397,6 +398,41 @@ private:
     using GroupingList = std::vector< GroupingEntry >;
     using DocumentVector = std::vector<vsm::StorageDocument::UP>;
 
+    /**
+     * Query and field searchers used to check whether documents match
+     * the query on a thread other than the visitor thread. Only the
+     * outcome is used; matching documents are matched again on the
+     * visitor thread before being ranked, grouped and collected.
+     **/
+    class MatchThread {
+    public:
+        MatchThread(SearchVisitor & visitor, vespalib::stringref queryBlob);
+        ~MatchThread();
+        bool match(const vsm::StorageDocument & doc);
+    private:
+        search::streaming::Query _query;
+        vsm::FieldIdTSearcherMap _fieldSearcherMap;
+        vsm::SharedSearcherBuf   _searchBuffer;
+    };
+
+    /**
+     * Setup query and field searchers for the given number of match threads.
+     **/
+    void setupMatchThreads(uint32_t numThreads, vespalib::stringref queryBlob);
+
+    /**
+     * Match the given documents in parallel using the match threads.
+     *
+     * @return per document whether it may match the query, or an empty
+     *         vector if the documents were not matched in parallel.
+     **/
+    std::vector<uint8_t> matchInParallel(const DocumentVector & documents);
+
+    /**
+     * Process one document known not to match the query.
+     **/
+    void handleNonMatchingDocument(vsm::StorageDocument & document);
+
     class StreamingDocsumsState {
         using ResolveClassInfo = search::docsummary::IDocsumWriter::ResolveClassInfo;
         GetDocsumsState  _state;
@@ -483,6 +519,8 @@ private:
     SyntheticFieldsController               _syntheticFieldsController;
     RankController                          _rankController;
     DocumentVector                          _backingDocuments;
+    std::vector<std::unique_ptr<MatchThread>> _matchThreads;
+    vespalib::Executor                    * _matchExecutor;
     vsm::StringFieldIdTMapT                 _fieldsUnion;
 
     void setupAttributeVector(const vsm::FieldPath &fieldPath);
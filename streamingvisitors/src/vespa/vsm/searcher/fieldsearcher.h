@@ -82,6 +82,7 @@ private:
 
     public:
         explicit IteratorHandler(FieldSearcher & searcher) noexcept : _searcher(searcher) {}
+        bool readOnly() const override { return true; }
     };
     friend class IteratorHandler; // to allow calls to onValue();
 
@@ -10,6 +10,23 @@ using search::byte;
 
 namespace vsm {
 
+namespace {
+
+constexpr size_t ascii_block_size = 16;
+
+// check if a block only contains printable 7-bit ascii characters
+// (no separators and nothing needing utf8 decoding). written without
+// early exit to let the compiler vectorize it.
+bool is_printable_ascii_block(const byte * p) noexcept {
+    byte bad = 0;
+    for (size_t i = 0; i < ascii_block_size; ++i) {
+        bad |= byte(byte(p[i] - 0x20) >= 0x60);
+    }
+    return (bad == 0);
+}
+
+}
+
 template<typename Reader>
 void
 UTF8StringFieldSearcherBase::tokenize(Reader & reader) {
@@ -187,6 +204,18 @@ UTF8StringFieldSearcherBase::skipSeparators(const search::byte * p, size_t sz, T
     const search::byte * b(p);
 
     for(; p < e; ) {
+        if ((size_t(e - p) >= ascii_block_size) && is_printable_ascii_block(p)) {
+            ucs4_t folded[ascii_block_size];
+            for (size_t i = 0; i < ascii_block_size; ++i) {
+                ucs4_t ch = p[i];
+                folded[i] = ((ch - 'A') < 26u) ? (ch + ('a' - 'A')) : ch;
+            }
+            for (size_t i = 0; i < ascii_block_size; ++i) {
+                dstbuf.onCharacter(folded[i], (p - b) + i);
+            }
+            p += ascii_block_size;
+            continue;
+        }
         ucs4_t c(*p);
         const search::byte * oldP(p);
         if (c < 128) {
@@ -2,17 +2,27 @@
 #pragma once
 
 #include "utf8strchrfieldsearcher.h"
+#include <bitset>
 
 namespace vsm {
 
 /**
  * This class does substring utf8 searches.
+ * When matching multiple terms, only positions where the field
+ * character may start one of the terms are compared against the terms.
  **/
 class UTF8SubStringFieldSearcher : public UTF8StringFieldSearcherBase
 {
+private:
+    // low byte of the first character of each term; all set if any term is empty
+    std::bitset<256> _first_chars;
 public:
     std::unique_ptr<FieldSearcher> duplicate() const override;
-    explicit UTF8SubStringFieldSearcher(FieldIdT fId) : UTF8StringFieldSearcherBase(fId) { }
+    explicit UTF8SubStringFieldSearcher(FieldIdT fId) : UTF8StringFieldSearcherBase(fId), _first_chars() { }
+    void prepare(search::streaming::QueryTermList& qtl,
+                 const SharedSearcherBuf& buf,
+                 const vsm::FieldPathMapT& field_paths,
+                 search::fef::IQueryEnvironment& query_env) override;
 protected:
     size_t matchTerm(const FieldRef & f, search::streaming::QueryTerm & qt) override;
     size_t matchTerms(const FieldRef & f, size_t shortestTerm) override;
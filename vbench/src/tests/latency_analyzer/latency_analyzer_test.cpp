@@ -27,10 +27,43 @@ TEST_FF("verify percentiles", RequestSink(), LatencyAnalyzer(f1)) {
         post(0.001 * i, f2);
     }
     LatencyAnalyzer::Stats stats = f2.getStats();
-    EXPECT_APPROX(5.0, stats.per50, 10e-6);
-    EXPECT_APPROX(9.5, stats.per95, 10e-6);
-    EXPECT_APPROX(9.9, stats.per99, 10e-6);
+    // histogram keeps 3 significant digits
+    EXPECT_APPROX(5.0, stats.per50, 5e-3);
+    EXPECT_APPROX(9.5, stats.per95, 10e-3);
+    EXPECT_APPROX(9.9, stats.per99, 10e-3);
     fprintf(stderr, "%s", stats.toString().c_str());
 }
 
+TEST_FF("require that small latencies are recorded exactly", RequestSink(), LatencyAnalyzer(f1)) {
+    for (size_t i = 0; i <= 1000; ++i) {
+        post(0.000001 * i, f2);
+    }
+    LatencyAnalyzer::Stats stats = f2.getStats();
+    EXPECT_APPROX(0.000500, stats.per50, 10e-9);
+    EXPECT_APPROX(0.000950, stats.per95, 10e-9);
+    EXPECT_APPROX(0.000990, stats.per99, 10e-9);
+}
+
+TEST_FF("require that outliers are not lost", RequestSink(), LatencyAnalyzer(f1)) {
+    for (size_t i = 0; i < 90; ++i) {
+        post(0.010, f2);
+    }
+    for (size_t i = 0; i < 10; ++i) {
+        post(100.0, f2);
+    }
+    LatencyAnalyzer::Stats stats = f2.getStats();
+    EXPECT_APPROX(0.010, stats.per50, 10e-6);
+    EXPECT_APPROX(100.0, stats.per95, 0.1);
+    EXPECT_APPROX(100.0, stats.per99, 0.1);
+    EXPECT_EQUAL(100.0, stats.max);
+}
+
+TEST_FF("require that open loop latency is measured from scheduled time", RequestSink(), LatencyAnalyzer(f1, true)) {
+    Request::UP req(new Request());
+    req->scheduledTime(1.0).startTime(3.0).endTime(3.5);
+    f2.handle(std::move(req));
+    EXPECT_APPROX(2.5, f2.getStats().min, 10e-6);
+    EXPECT_APPROX(2.5, f2.getStats().max, 10e-6);
+}
+
 TEST_MAIN() { TEST_RUN_ALL(); }
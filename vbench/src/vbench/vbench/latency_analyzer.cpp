@@ -1,10 +1,37 @@
 // Copyright Vespa.ai. Licensed under the terms of the Apache 2.0 license. See LICENSE in the project root.
 
 #include "latency_analyzer.h"
+#include <algorithm>
+#include <bit>
 #include <cmath>
 
 namespace vbench {
 
+size_t
+LatencyAnalyzer::toIndex(uint64_t micros)
+{
+    uint32_t bucket = std::bit_width(micros | (2 * sub_bucket_half - 1)) - (sub_bucket_bits + 1);
+    if (bucket >= num_buckets) {
+        return (num_buckets + 1) * sub_bucket_half - 1;
+    }
+    uint64_t sub = (micros >> bucket);
+    return ((bucket + 1) * sub_bucket_half) + (sub - sub_bucket_half);
+}
+
+double
+LatencyAnalyzer::fromIndex(size_t idx)
+{
+    int32_t bucket = int32_t(idx >> sub_bucket_bits) - 1;
+    uint64_t sub = (idx & (sub_bucket_half - 1)) + sub_bucket_half;
+    if (bucket < 0) {
+        bucket = 0;
+        sub -= sub_bucket_half;
+    }
+    uint64_t lowest = (sub << bucket);
+    uint64_t width = (1ul << bucket);
+    return (double(lowest + (width >> 1)) / 1000000.0);
+}
+
 double
 LatencyAnalyzer::getN(size_t n) const
 {
@@ -12,7 +39,7 @@ LatencyAnalyzer::getN(size_t n) const
     for (size_t i = 0; i < _hist.size(); ++i) {
         acc += _hist[i];
         if (acc > n) {
-            return (((double)i) / 1000.0);
+            return std::clamp(fromIndex(i), _min, _max);
         }
     }
     return _max;
@@ -42,13 +69,14 @@ LatencyAnalyzer::Stats::toString() const
     return str;
 }
 
-LatencyAnalyzer::LatencyAnalyzer(Handler<Request> &next)
+LatencyAnalyzer::LatencyAnalyzer(Handler<Request> &next, bool openLoop)
     : _next(next),
+      _openLoop(openLoop),
       _cnt(0),
       _min(0.0),
       _max(0.0),
       _total(0.0),
-      _hist(10000, 0)
+      _hist((num_buckets + 1) * sub_bucket_half, 0)
 {
 }
 
@@ -58,7 +86,7 @@ void
 LatencyAnalyzer::handle(Request::UP request)
 {
     if (request->status() == Request::STATUS_OK) {
-        addLatency(request->latency());
+        addLatency(_openLoop ? request->scheduledLatency() : request->latency());
     }
     _next.handle(std::move(request));
 }
@@ -80,10 +108,8 @@ LatencyAnalyzer::addLatency(double latency)
     }
     ++_cnt;
     _total += latency;
-    size_t idx = (size_t)(latency * 1000.0 + 0.5);
-    if (idx < _hist.size()) {
-        ++_hist[idx];
-    }
+    uint64_t micros = (latency > 0.0) ? (uint64_t)(latency * 1000000.0 + 0.5) : 0;
+    ++_hist[toIndex(micros)];
 }
 
 LatencyAnalyzer::Stats
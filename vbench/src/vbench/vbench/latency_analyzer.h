@@ -8,18 +8,31 @@ namespace vbench {
 
 /**
  * Component picking up the latency of successful requests and
- * calculating relevant aggregated values.
+ * calculating relevant aggregated values. Latencies are recorded with
+ * microsecond granularity in a log-linear histogram (HdrHistogram
+ * style) keeping 3 significant digits across the entire value range,
+ * so that outliers are never lost. In open-loop mode latency is
+ * measured from the time the request was scheduled to be sent rather
+ * than from the time it was actually sent, avoiding coordinated
+ * omission when the server (or the benchmark itself) falls behind.
  **/
 class LatencyAnalyzer : public Analyzer
 {
 private:
+    static constexpr uint32_t sub_bucket_bits  = 10;
+    static constexpr uint64_t sub_bucket_half  = (1ul << sub_bucket_bits);
+    static constexpr uint32_t num_buckets      = 27; // ~76 hours at max
+
     Handler<Request>    &_next;
+    bool                 _openLoop;
     size_t               _cnt;
     double               _min;
     double               _max;
     double               _total;
     std::vector<size_t>  _hist;
 
+    static size_t toIndex(uint64_t micros);
+    static double fromIndex(size_t idx);
     double getN(size_t n) const;
     double getPercentile(double per) const;
 
@@ -34,7 +47,7 @@ public:
         Stats() : min(0), avg(0), max(0), per50(0), per95(0), per99(0) {}
         string toString() const;
     };
-    LatencyAnalyzer(Handler<Request> &next);
+    LatencyAnalyzer(Handler<Request> &next, bool openLoop = false);
     ~LatencyAnalyzer() override;
     void handle(Request::UP request) override;
     void report() override;
@@ -67,6 +67,10 @@ public:
 
     double latency() const { return (_endTime - _startTime); }
 
+    // latency as seen by a client sending at the scheduled time;
+    // includes any time spent waiting for an available worker
+    double scheduledLatency() const { return (_endTime - _scheduledTime); }
+
     void handleHeader(const string &name, const string &value) override;
     void handleContent(const Memory &data) override;
     void handleFailure(const string &reason) override;
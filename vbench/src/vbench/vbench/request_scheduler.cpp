@@ -9,6 +9,15 @@ namespace vbench {
 VESPA_THREAD_STACK_TAG(vbench_request_scheduler_thread);
 VESPA_THREAD_STACK_TAG(vbench_handler_thread);
 
+void
+RequestScheduler::WorkerSpawner::handle(Request::UP request)
+{
+    // only called by the scheduler thread; workers are joined after it
+    parent._workers.push_back(std::make_unique<Worker>(parent._dispatcher, parent._proxy,
+                                                       parent._connectionPool, parent._timer,
+                                                       std::move(request)));
+}
+
 void
 RequestScheduler::run()
 {
@@ -29,12 +38,13 @@ RequestScheduler::run()
     }
 }
 
-RequestScheduler::RequestScheduler(CryptoEngine::SP crypto, Handler<Request> &next, size_t numWorkers)
+RequestScheduler::RequestScheduler(CryptoEngine::SP crypto, Handler<Request> &next, size_t numWorkers, bool openLoop)
     : _timer(),
       _proxy(next, vbench_handler_thread),
       _queue(10.0, 0.020),
       _droppedTagger(_proxy),
-      _dispatcher(_droppedTagger),
+      _workerSpawner(*this),
+      _dispatcher(openLoop ? static_cast<Handler<Request>&>(_workerSpawner) : _droppedTagger),
       _thread(),
       _connectionPool(std::move(crypto), _timer),
       _workers(),
@@ -15,16 +15,26 @@ namespace vbench {
 /**
  * Component responsible for dispatching requests to workers at the
  * appropriate time based on what start time the requests are tagged
- * with.
+ * with. Requests that cannot be dispatched because all workers are
+ * busy are dropped, unless running in open-loop mode, in which case a
+ * new worker is started to perform the request. This keeps the
+ * schedule from ever being blocked by a slow server.
  **/
 class RequestScheduler : public Handler<Request>,
                          public vespalib::Runnable
 {
 private:
+    struct WorkerSpawner : Handler<Request> {
+        RequestScheduler &parent;
+        explicit WorkerSpawner(RequestScheduler &parent_in) : parent(parent_in) {}
+        void handle(Request::UP request) override;
+    };
+
     Timer                   _timer;
     HandlerThread<Request>  _proxy;
     TimeQueue<Request>      _queue;
     DroppedTagger           _droppedTagger;
+    WorkerSpawner           _workerSpawner;
     Dispatcher<Request>     _dispatcher;
     std::thread             _thread;
     HttpConnectionPool      _connectionPool;
@@ -37,7 +47,9 @@ private:
 public:
     using UP = std::unique_ptr<RequestScheduler>;
     using CryptoEngine = vespalib::CryptoEngine;
-    RequestScheduler(CryptoEngine::SP crypto, Handler<Request> &next, size_t numWorkers);
+    RequestScheduler(CryptoEngine::SP crypto, Handler<Request> &next, size_t numWorkers, bool openLoop);
+    RequestScheduler(CryptoEngine::SP crypto, Handler<Request> &next, size_t numWorkers)
+        : RequestScheduler(std::move(crypto), next, numWorkers, false) {}
     void abort();
     void handle(Request::UP request) override;
     void start();
@@ -7,28 +7,44 @@ namespace vbench {
 
 VESPA_THREAD_STACK_TAG(vbench_worker_thread);
 
+void
+Worker::perform(Request::UP request)
+{
+    request->startTime(_timer.sample());
+    HttpClient::fetch(_pool, request->server(), request->url(), *request);
+    request->endTime(_timer.sample());
+    _next.handle(std::move(request));
+}
+
 void
 Worker::run()
 {
+    if (_first) {
+        perform(std::move(_first));
+    }
     for (;;) {
         Request::UP request = _provider.provide();
         if (request.get() == 0) {
             break;
         }
-        request->startTime(_timer.sample());
-        HttpClient::fetch(_pool, request->server(), request->url(), *request);
-        request->endTime(_timer.sample());
-        _next.handle(std::move(request));
+        perform(std::move(request));
     }
 }
 
 Worker::Worker(Provider<Request> &provider, Handler<Request> &next,
                HttpConnectionPool &pool, Timer &timer)
+    : Worker(provider, next, pool, timer, Request::UP())
+{
+}
+
+Worker::Worker(Provider<Request> &provider, Handler<Request> &next,
+               HttpConnectionPool &pool, Timer &timer, Request::UP first)
     : _thread(),
       _provider(provider),
       _next(next),
       _pool(pool),
-      _timer(timer)
+      _timer(timer),
+      _first(std::move(first))
 {
     _thread = vespalib::thread::start(*this, vbench_worker_thread);
 }
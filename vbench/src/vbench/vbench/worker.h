@@ -15,7 +15,9 @@ namespace vbench {
  * Obtains requests from a request provider, performs the requests and
  * passes the requests along to a request handler. Runs its own
  * internal thread that will stop when the request provider starts
- * handing out empty requests.
+ * handing out empty requests. A worker may be given an initial
+ * request to perform before it starts obtaining requests from the
+ * provider; this is used when growing the worker pool on demand.
  **/
 class Worker : public vespalib::Runnable
 {
@@ -25,12 +27,16 @@ private:
     Handler<Request>   &_next;
     HttpConnectionPool &_pool;
     Timer              &_timer;
+    Request::UP         _first;
 
+    void perform(Request::UP request);
     void run() override;
 public:
     using UP = std::unique_ptr<Worker>;
     Worker(Provider<Request> &provider, Handler<Request> &next,
            HttpConnectionPool &pool, Timer &timer);
+    Worker(Provider<Request> &provider, Handler<Request> &next,
+           HttpConnectionPool &pool, Timer &timer, Request::UP first);
     void join() { _thread.join(); }
 };
 
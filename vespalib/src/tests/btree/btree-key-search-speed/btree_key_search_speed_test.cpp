@@ -0,0 +1,145 @@
+// Copyright Vespa.ai. Licensed under the terms of the Apache 2.0 license. See LICENSE in the project root.
+
+#include <vespa/vespalib/btree/btreeroot.h>
+#include <vespa/vespalib/btree/btreebuilder.h>
+#include <vespa/vespalib/btree/btreenodeallocator.h>
+#include <vespa/vespalib/btree/btree.h>
+#include <vespa/vespalib/btree/btreenodeallocator.hpp>
+#include <vespa/vespalib/btree/btreenode.hpp>
+#include <vespa/vespalib/btree/btreenodestore.hpp>
+#include <vespa/vespalib/btree/btreeiterator.hpp>
+#include <vespa/vespalib/btree/btreeroot.hpp>
+#include <vespa/vespalib/btree/btreebuilder.hpp>
+#include <vespa/vespalib/btree/btree.hpp>
+#include <vespa/vespalib/datastore/buffer_type.hpp>
+#include <vespa/vespalib/util/rand48.h>
+#include <vespa/vespalib/util/time.h>
+#include <cassert>
+#include <cinttypes>
+#include <vector>
+
+using vespalib::btree::BTree;
+using vespalib::btree::BTreeNode;
+using vespalib::btree::BTreeNoLeafData;
+using vespalib::btree::BTreeTraits;
+
+enum class SearchMethod
+{
+    LOWER_BOUND,
+    SEEK
+};
+
+class KeySearchSpeed
+{
+    std::vector<uint32_t> _lookup_keys;
+
+    template <typename Traits>
+    void work_loop(SearchMethod search_method);
+public:
+    KeySearchSpeed();
+    int main();
+};
+
+namespace {
+
+const char *search_method_name(SearchMethod search_method)
+{
+    switch (search_method) {
+    case SearchMethod::LOWER_BOUND:
+        return "lower_bound";
+    default:
+        return "seek";
+    }
+}
+
+constexpr size_t num_entries = 1000000;
+constexpr size_t num_lookups = 1000000;
+constexpr size_t num_inner_loops = 10;
+
+}
+
+KeySearchSpeed::KeySearchSpeed()
+    : _lookup_keys()
+{
+    vespalib::Rand48 rnd;
+    rnd.srand48(42);
+    _lookup_keys.reserve(num_lookups);
+    for (size_t i = 0; i < num_lookups; ++i) {
+        _lookup_keys.push_back(rnd.lrand48() % (2 * num_entries));
+    }
+}
+
+template <typename Traits>
+void
+KeySearchSpeed::work_loop(SearchMethod search_method)
+{
+    using Tree = BTree<uint32_t, BTreeNoLeafData, vespalib::btree::NoAggregated, std::less<uint32_t>, Traits>;
+    using Builder = typename Tree::Builder;
+    using ConstIterator = typename Tree::ConstIterator;
+    Tree tree;
+    Builder builder(tree.getAllocator());
+    for (size_t i = 0; i < num_entries; ++i) {
+        builder.insert(2 * i, BTreeNoLeafData());
+    }
+    tree.assign(builder);
+    assert(num_entries == tree.size());
+    assert(tree.isValid());
+    uint64_t sum = 0;
+    vespalib::Timer timer;
+    for (size_t innerl = 0; innerl < num_inner_loops; ++innerl) {
+        ConstIterator itr(BTreeNode::Ref(), tree.getAllocator());
+        if (search_method == SearchMethod::LOWER_BOUND) {
+            for (auto key : _lookup_keys) {
+                itr.lower_bound(tree.getRoot(), key);
+                sum += itr.valid() ? itr.getKey() : 0;
+            }
+        } else {
+            // Skip through the tree in increasing strides, like a posting list iterator
+            for (size_t i = 0; i < num_lookups; ++i) {
+                uint32_t key = (i * 2 * num_entries) / num_lookups + (_lookup_keys[i] & 0xf);
+                if (i == 0) {
+                    itr.lower_bound(tree.getRoot(), key);
+                } else if (itr.valid() && itr.getKey() < key) {
+                    itr.seek(key);
+                }
+                sum += itr.valid() ? itr.getKey() : 0;
+            }
+        }
+    }
+    double used = vespalib::to_s(timer.elapsed());
+    printf("Elapsed time for %zu key searches is %8.5f, "
+           "method=%s, fanout=%u,%u, linear_key_search=%s, sum=%" PRIu64 "\n",
+           num_lookups * num_inner_loops,
+           used,
+           search_method_name(search_method),
+           static_cast<int>(Traits::LEAF_SLOTS),
+           static_cast<int>(Traits::INTERNAL_SLOTS),
+           Traits::LINEAR_KEY_SEARCH ? "true" : "false",
+           sum);
+    fflush(stdout);
+}
+
+int
+KeySearchSpeed::main()
+{
+    using DefTraits = BTreeTraits<16, 16, 10, true>;
+    using DefLinearTraits = BTreeTraits<16, 16, 10, true, true>;
+    using LargeTraits = BTreeTraits<32, 16, 10, true>;
+    using LargeLinearTraits = BTreeTraits<32, 16, 10, true, true>;
+    using HugeTraits = BTreeTraits<64, 16, 10, true>;
+    using HugeLinearTraits = BTreeTraits<64, 16, 10, true, true>;
+    for (auto search_method : { SearchMethod::LOWER_BOUND, SearchMethod::SEEK }) {
+        work_loop<DefTraits>(search_method);
+        work_loop<DefLinearTraits>(search_method);
+        work_loop<LargeTraits>(search_method);
+        work_loop<LargeLinearTraits>(search_method);
+        work_loop<HugeTraits>(search_method);
+        work_loop<HugeLinearTraits>(search_method);
+    }
+    return 0;
+}
+
+int main(int, char **) {
+    KeySearchSpeed app;
+    return app.main();
+}
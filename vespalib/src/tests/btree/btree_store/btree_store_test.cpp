@@ -9,11 +9,13 @@
 #include <vespa/vespalib/datastore/compaction_strategy.h>
 #include <vespa/vespalib/datastore/entry_ref_filter.h>
 #include <vespa/vespalib/gtest/gtest.h>
+#include <vespa/vespalib/test/memory_allocator_observer.h>
 
 using vespalib::GenerationHandler;
 using vespalib::datastore::CompactionSpec;
 using vespalib::datastore::CompactionStrategy;
 using vespalib::datastore::EntryRef;
+using vespalib::alloc::test::MemoryAllocatorObserver;
 
 namespace vespalib::btree {
 
@@ -185,6 +187,37 @@ TEST_F(BTreeStoreTest, require_that_nodes_for_multiple_btrees_are_compacted)
     store.clear(refs[1]);
 }
 
+TEST_F(BTreeStoreTest, require_that_bulk_merge_applies_changes)
+{
+    auto &store = this->_store;
+    std::vector<EntryRef> refs;
+    refs.emplace_back();                  // no old data
+    refs.emplace_back(add_sequence(0, 4));   // short array
+    refs.emplace_back(add_sequence(0, 100)); // tree
+    std::vector<TreeStore::KeyDataType> additions;
+    std::vector<TreeStore::KeyType> removals;
+    for (int i = 0; i < 200; i += 2) {
+        additions.emplace_back(i, 1);
+    }
+    for (int i = 1; i < 100; i += 2) {
+        removals.emplace_back(i);
+    }
+    std::vector<int> exp_sequence;
+    for (int i = 0; i < 200; i += 2) {
+        exp_sequence.emplace_back(i);
+    }
+    for (auto& ref : refs) {
+        store.bulk_merge(ref,
+                         additions.data(), additions.data() + additions.size(),
+                         removals.data(), removals.data() + removals.size());
+    }
+    inc_generation();
+    for (auto& ref : refs) {
+        EXPECT_EQ(exp_sequence, get_sequence(ref));
+        store.clear(ref);
+    }
+}
+
 TEST_F(BTreeStoreTest, require_that_short_arrays_are_compacted)
 {
     test_compact_sequence(4);
@@ -195,6 +228,28 @@ TEST_F(BTreeStoreTest, require_that_btree_roots_are_compacted)
     test_compact_sequence(10);
 }
 
+TEST(BTreeStoreAllocatorTest, require_that_btree_nodes_use_memory_allocator)
+{
+    MemoryAllocatorObserver::Stats stats;
+    {
+        TreeStore store(true, std::make_shared<MemoryAllocatorObserver>(stats));
+        EXPECT_EQ(2u, stats.alloc_cnt);
+        std::vector<TreeStore::KeyDataType> additions;
+        for (int i = 0; i < 100; ++i) {
+            additions.emplace_back(i, 0);
+        }
+        EntryRef root;
+        store.apply(root, additions.data(), additions.data() + additions.size(), nullptr, nullptr);
+        EXPECT_TRUE(store.isBTree(root));
+        store.clear(root);
+        store.clearBuilder();
+        store.freeze();
+        store.assign_generation(0);
+        store.reclaim_memory(1);
+    }
+    EXPECT_EQ(stats.alloc_cnt, stats.free_cnt);
+}
+
 }
 
 GTEST_MAIN_RUN_ALL_TESTS()
@@ -151,6 +151,9 @@ using LSeekTraits = BTreeTraits<16, 16, 10, false>;
 typedef BTree<int, BTreeNoLeafData, btree::NoAggregated,
               std::less<int>, LSeekTraits> SetTreeL;
 
+using LKeySearchTraits = BTreeTraits<16, 16, 10, true, true>;
+using SetTreeK = BTree<int, BTreeNoLeafData, btree::NoAggregated, std::less<int>, LKeySearchTraits>;
+
 struct LeafPairLess {
     bool operator()(const LeafPair & lhs, const LeafPair & rhs) const {
         return UNWRAP(lhs.first) < UNWRAP(rhs.first);
@@ -515,6 +518,7 @@ struct BTreeStealTraits
     static constexpr size_t INTERNAL_SLOTS = 6;
     static constexpr size_t PATH_SIZE = 20;
     [[maybe_unused]] static constexpr bool BINARY_SEEK = true;
+    [[maybe_unused]] static constexpr bool LINEAR_KEY_SEARCH = false;
 };
 
 }
@@ -708,6 +712,12 @@ TEST_F(BTreeTest, require_that_node_lower_bound_works)
     EXPECT_EQ(3u, n->lower_bound(6, MyComp()));
     EXPECT_TRUE(MyComp()(6, n->getKey(3u)));
     EXPECT_EQ(4u, n->lower_bound(8, MyComp()));
+    for (int key = 0; key < 10; ++key) {
+        EXPECT_EQ(n->lower_bound(key, MyComp()), n->linear_lower_bound(0, key, MyComp()));
+        EXPECT_EQ(n->upper_bound(0, key, MyComp()), n->linear_upper_bound(0, key, MyComp()));
+        EXPECT_EQ(n->lower_bound(2, key, MyComp()), n->linear_lower_bound(2, key, MyComp()));
+        EXPECT_EQ(n->upper_bound(2, key, MyComp()), n->linear_upper_bound(2, key, MyComp()));
+    }
     cleanup(g, m, nPair.ref, n);
 }
 
@@ -1160,6 +1170,7 @@ TEST_F(BTreeTest, require_that_lower_bound_works)
 {
     requireThatLowerBoundWorksT<SetTreeB>();
     requireThatLowerBoundWorksT<SetTreeL>();
+    requireThatLowerBoundWorksT<SetTreeK>();
 }
 
 template <typename TreeType>
@@ -1189,6 +1200,7 @@ TEST_F(BTreeTest, require_that_upper_bound_works)
 {
     requireThatUpperBoundWorksT<SetTreeB>();
     requireThatUpperBoundWorksT<SetTreeL>();
+    requireThatUpperBoundWorksT<SetTreeK>();
 }
 
 struct UpdKeyComp {
@@ -606,6 +606,7 @@ struct BTreeStealTraits
     static constexpr size_t INTERNAL_SLOTS = 6;
     static constexpr size_t PATH_SIZE = 20;
     [[maybe_unused]] static constexpr bool BINARY_SEEK = true;
+    [[maybe_unused]] static constexpr bool LINEAR_KEY_SEARCH = false;
 };
 
 }
@@ -3,6 +3,9 @@
 #include <vespa/vespalib/testkit/test_kit.h>
 #include <vespa/vespalib/stllike/string.h>
 #include <vespa/vespalib/util/compressor.h>
+#include <vespa/vespalib/util/exceptions.h>
+#include <vespa/vespalib/util/stringfmt.h>
+#include <vespa/vespalib/util/zstd_dictionary.h>
 #include <vespa/vespalib/data/databuffer.h>
 
 #include <vespa/log/log.h>
@@ -67,6 +70,55 @@ TEST("requiret that zstd compression/decompression works") {
     EXPECT_EQUAL(_G_compressableText, vespalib::string(decompress.data(), decompress.size()));
 }
 
+vespalib::string make_document(size_t i) {
+    return make_string("{\"title\":\"Document number %zu\",\"category\":\"category-%zu\","
+                       "\"description\":\"A small document sharing most of its structure with the others.\","
+                       "\"price\":%zu,\"in_stock\":%s}", i, i % 7, (i * 31) % 1000, (i % 2) ? "true" : "false");
+}
+
+ZStdDictionary::SP train_dictionary(size_t num_samples) {
+    ZStdDictionary::Samples samples(1024 * 1024);
+    for (size_t i = 0; i < num_samples; ++i) {
+        vespalib::string doc = make_document(i);
+        samples.add(ConstBufferRef(doc.data(), doc.size()));
+    }
+    return ZStdDictionary::train(samples, 4096, 9);
+}
+
+TEST("require that zstd dictionary is not trained from too few samples") {
+    EXPECT_TRUE(train_dictionary(2).get() == nullptr);
+}
+
+TEST("require that zstd dictionary compression/decompression works") {
+    auto dictionary = train_dictionary(2000);
+    ASSERT_TRUE(dictionary);
+    EXPECT_NOT_EQUAL(0u, dictionary->id());
+    EXPECT_TRUE(dictionary->canCompress());
+    vespalib::string doc = make_document(4711);
+    std::vector<char> compressed(doc.size() * 2);
+    size_t compressed_len = compressed.size();
+    ASSERT_TRUE(dictionary->compress(doc.data(), doc.size(), compressed.data(), compressed_len));
+    EXPECT_EQUAL(dictionary->id(), ZStdDictionary::frameDictionaryId(compressed.data(), compressed_len));
+
+    CompressionConfig cfg(CompressionConfig::Type::ZSTD);
+    Compress plain(cfg, doc.data(), doc.size());
+    EXPECT_LESS(compressed_len, plain.size());
+    EXPECT_EQUAL(0u, ZStdDictionary::frameDictionaryId(plain.data(), plain.size()));
+
+    ZStdDictionary loaded(dictionary->content());
+    EXPECT_EQUAL(dictionary->id(), loaded.id());
+    EXPECT_FALSE(loaded.canCompress());
+    std::vector<char> decompressed(doc.size());
+    size_t decompressed_len = decompressed.size();
+    ASSERT_TRUE(loaded.decompress(compressed.data(), compressed_len, decompressed.data(), decompressed_len));
+    EXPECT_EQUAL(doc, vespalib::string(decompressed.data(), decompressed_len));
+}
+
+TEST("require that loading an invalid zstd dictionary fails") {
+    EXPECT_EXCEPTION(ZStdDictionary(ConstBufferRef(_G_compressableText.c_str(), _G_compressableText.size())),
+                     IllegalArgumentException, "Not a zstd dictionary");
+}
+
 TEST("require that CompressionConfig is Atomic") {
     EXPECT_EQUAL(8u, sizeof(CompressionConfig));
     EXPECT_TRUE(std::atomic<CompressionConfig>::is_always_lock_free);
@@ -441,6 +441,39 @@ TEST_F(NumberStoreTwoSmallBufferTypesTest, buffer_with_most_dead_space_is_compac
     test_compaction(*this);
 }
 
+TEST_F(NumberStoreTwoSmallBufferTypesTest, compaction_can_be_interleaved_with_writes_in_bounded_steps)
+{
+    std::vector<AtomicEntryRef> refs;
+    for (uint32_t i = 0; i < 4; ++i) {
+        refs.emplace_back(add({i, i}));
+    }
+    remove(add({5,5}));
+    reclaim_memory();
+    EntryRef old_ref = refs[0].load_relaxed();
+    uint32_t compacted_buffer_id = getBufferId(old_ref);
+    store.set_compaction_spec(CompactionSpec(true, false));
+    auto ctx = store.compact_worst(CompactionStrategy());
+    EXPECT_EQ(3u, ctx->compact_step(ArrayRef<AtomicEntryRef>(refs), 0, 3));
+    for (uint32_t i = 0; i < 3; ++i) {
+        EXPECT_NE(compacted_buffer_id, getBufferId(refs[i].load_relaxed()));
+    }
+    EXPECT_EQ(compacted_buffer_id, getBufferId(refs[3].load_relaxed()));
+    // Writes between steps never land in the buffer being compacted
+    refs.emplace_back(add({7, 7}));
+    EXPECT_NE(compacted_buffer_id, getBufferId(refs[4].load_relaxed()));
+    EXPECT_EQ(5u, ctx->compact_step(ArrayRef<AtomicEntryRef>(refs), 3, 3));
+    for (uint32_t i = 0; i < 4; ++i) {
+        EXPECT_NE(compacted_buffer_id, getBufferId(refs[i].load_relaxed()));
+        assertGet(refs[i].load_relaxed(), {i, i});
+    }
+    assertGet(old_ref, {0, 0}); // Old ref should still point to data.
+    EXPECT_FALSE(store.bufferState(old_ref).isOnHold());
+    ctx.reset();
+    EXPECT_TRUE(store.bufferState(old_ref).isOnHold());
+    reclaim_memory();
+    EXPECT_TRUE(store.bufferState(old_ref).isFree());
+}
+
 namespace {
 
 template <typename Fixture>
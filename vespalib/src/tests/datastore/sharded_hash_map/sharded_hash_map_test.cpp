@@ -397,6 +397,30 @@ TEST_F(DataStoreShardedHashTest, foreach_key_works)
     }
 }
 
+TEST_F(DataStoreShardedHashTest, find_many_works)
+{
+    populate_sample_data(large_population);
+    std::vector<MyComparator> comps;
+    for (uint32_t i = 0; i < 2 * large_population; ++i) {
+        comps.emplace_back(_comparator.make_for_lookup(i));
+    }
+    std::vector<const vespalib::datastore::EntryComparator*> comp_ptrs;
+    for (auto& comp : comps) {
+        comp_ptrs.emplace_back(&comp);
+    }
+    std::vector<const MyHashMap::KvType*> result(comp_ptrs.size());
+    _hash_map.find_many(comp_ptrs, result);
+    for (uint32_t i = 0; i < comp_ptrs.size(); ++i) {
+        EXPECT_EQ(_hash_map.find(comps[i], EntryRef()), result[i]);
+        if (i < large_population) {
+            ASSERT_NE(nullptr, result[i]);
+            EXPECT_EQ(i, _allocator.get_wrapped(result[i]->first.load_relaxed()).value());
+        } else {
+            EXPECT_EQ(nullptr, result[i]);
+        }
+    }
+}
+
 TEST_F(DataStoreShardedHashTest, move_keys_on_compact_works)
 {
     populate_sample_data(small_population);
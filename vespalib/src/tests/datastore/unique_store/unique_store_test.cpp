@@ -423,7 +423,7 @@ TYPED_TEST(TestBase, store_can_be_enumerated)
 TYPED_TEST(TestBase, provided_memory_allocator_is_used)
 {
     if constexpr (std::is_same_v<const char *, typename TestFixture::ValueType>) {
-        EXPECT_EQ(AllocStats(18, 0), this->stats);
+        EXPECT_EQ(AllocStats(22, 0), this->stats);
     } else {
         EXPECT_EQ(AllocStats(1, 0), this->stats);
     }
@@ -127,6 +127,18 @@ TEST_F(StringTest, string_length_determines_buffer)
     EXPECT_EQ(get_buffer_id(ref1), get_buffer_id(ref4));
 }
 
+TEST_F(StringTest, short_strings_use_tight_size_classes)
+{
+    // Ref count (4 bytes) + string + terminating NUL, rounded up to a multiple of 4
+    EXPECT_EQ(8u, buffer_state(add("")).getArraySize());
+    EXPECT_EQ(8u, buffer_state(add("abc")).getArraySize());
+    EXPECT_EQ(12u, buffer_state(add("12345")).getArraySize());
+    EXPECT_EQ(16u, buffer_state(add("abcdefgh")).getArraySize());
+    EXPECT_EQ(20u, buffer_state(add("abcdefghijklmno")).getArraySize());
+    EXPECT_EQ(28u, buffer_state(add("abcdefghijklmnopqrstuvw")).getArraySize());
+    EXPECT_EQ(32u, buffer_state(add("abcdefghijklmnopqrstuvwx")).getArraySize());
+}
+
 TEST_F(StringTest, free_list_is_used_when_enabled)
 {
     // Free lists are default enabled for UniqueStoreStringAllocator
@@ -179,7 +191,7 @@ TEST_F(StringTest, free_list_is_never_used_for_move_on_compact)
 
 TEST_F(StringTest, provided_memory_allocator_is_used)
 {
-    EXPECT_EQ(AllocStats(18, 0), allocStats);
+    EXPECT_EQ(AllocStats(22, 0), allocStats);
 }
 
 TEST_F(SmallOffsetStringTest, new_underlying_buffer_is_allocated_when_current_is_full)
@@ -3,6 +3,7 @@
 #include <vespa/vespalib/util/execution_profiler.h>
 #include <vespa/vespalib/data/slime/slime.h>
 #include <vespa/vespalib/gtest/gtest.h>
+#include <map>
 #include <thread>
 
 using Profiler = vespalib::ExecutionProfiler;
@@ -232,4 +233,31 @@ TEST(ExecutionProfilerTest, flat_profiling_does_not_report_tasks_with_count_0) {
     EXPECT_EQ(slime["roots"][0]["count"].asLong(), 1);
 }
 
+std::map<vespalib::string,size_t> visit_counts(int32_t profile_depth) {
+    Profiler profiler(profile_depth);
+    for (int i = 0; i < 3; ++i) {
+        foo(profiler);
+        bar(profiler);
+        baz(profiler);
+        fox(profiler);
+    }
+    std::map<vespalib::string,size_t> counts;
+    vespalib::duration self_time = vespalib::duration::zero();
+    profiler.visit_tasks([&](Profiler::TaskId task, size_t count, vespalib::duration task_self_time)
+                         {
+                             counts[profiler.name_of(task)] += count;
+                             EXPECT_GE(task_self_time, vespalib::duration::zero());
+                             self_time += task_self_time;
+                         });
+    // all time is spent sleeping in fox
+    EXPECT_GE(self_time, 72ms);
+    return counts;
+}
+
+TEST(ExecutionProfilerTest, tasks_can_be_visited) {
+    std::map<vespalib::string,size_t> expect = {{"foo", 3}, {"bar", 6}, {"baz", 18}, {"fox", 72}};
+    EXPECT_EQ(visit_counts(64), expect);
+    EXPECT_EQ(visit_counts(-64), expect);
+}
+
 GTEST_MAIN_RUN_ALL_TESTS()
@@ -4,6 +4,7 @@
 #include <vespa/vespalib/util/threadstackexecutor.h>
 #include <vespa/vespalib/util/backtrace.h>
 #include <vespa/vespalib/util/size_literals.h>
+#include <vespa/vespalib/util/lambdatask.h>
 #include <atomic>
 #include <thread>
 
@@ -242,4 +243,50 @@ TEST("Test that utilization is computed") {
     EXPECT_GREATER(0.50, stats.getUtil());
 }
 
+TEST("require that hardware counters are aggregated") {
+    ExecutorStats stats;
+    stats.hwCounters.cycles = 100;
+    stats.hwCounters.instructions = 150;
+    ExecutorStats other;
+    other.hwCounters.cycles = 100;
+    other.hwCounters.instructions = 50;
+    other.hwCounters.llc_misses = 3;
+    other.hwCounters.branch_misses = 5;
+    stats.aggregate(other);
+    EXPECT_EQUAL(200u, stats.hwCounters.cycles);
+    EXPECT_EQUAL(200u, stats.hwCounters.instructions);
+    EXPECT_EQUAL(3u, stats.hwCounters.llc_misses);
+    EXPECT_EQUAL(5u, stats.hwCounters.branch_misses);
+    EXPECT_EQUAL(1.0, stats.hwCounters.ipc());
+}
+
+TEST("require that hardware counters are sampled for worker threads when enabled") {
+    ThreadHwCounters::set_enabled(true);
+    {
+        ThreadStackExecutor executor(2);
+        for (size_t i = 0; i < 4; ++i) {
+            executor.execute(makeLambdaTask([]() {
+                std::atomic<uint64_t> sum(0);
+                for (uint64_t j = 0; j < 1000000; ++j) {
+                    sum.fetch_add(j, std::memory_order_relaxed);
+                }
+            }));
+        }
+        executor.sync();
+        auto stats = executor.getStats();
+        if (ThreadHwCounters::available()) {
+            EXPECT_GREATER(stats.hwCounters.cycles, 0u);
+            EXPECT_GREATER(stats.hwCounters.instructions, 0u);
+        } else {
+            fprintf(stderr, "hardware counters not available, skipping checks\n");
+            EXPECT_EQUAL(0u, stats.hwCounters.cycles);
+        }
+    }
+    ThreadHwCounters::set_enabled(false);
+    ThreadStackExecutor executor(1);
+    executor.execute(makeLambdaTask([]() {}));
+    executor.sync();
+    EXPECT_EQUAL(0u, executor.getStats().hwCounters.cycles);
+}
+
 TEST_MAIN() { TEST_RUN_ALL(); }
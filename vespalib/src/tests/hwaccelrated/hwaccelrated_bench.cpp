@@ -1,7 +1,6 @@
 // Copyright Vespa.ai. Licensed under the terms of the Apache 2.0 license. See LICENSE in the project root.
 
 #include <vespa/vespalib/hwaccelrated/iaccelrated.h>
-#include <vespa/vespalib/hwaccelrated/generic.h>
 #include <vespa/vespalib/util/time.h>
 #include <cinttypes>
 
@@ -32,6 +31,48 @@ benchmarkEuclideanDistance(const hwaccelrated::IAccelrated & accel, size_t sz, s
     printf("sum=%f of N=%zu and vector length=%zu took %" PRId64 "\n", sumOfSums, count, sz, count_ms(elapsed));
 }
 
+template<typename T>
+void
+benchmarkDotProduct(const hwaccelrated::IAccelrated & accel, size_t sz, size_t count) {
+    srand(1);
+    std::vector<T> a = createAndFill<T>(sz);
+    std::vector<T> b = createAndFill<T>(sz);
+    steady_time start = steady_clock::now();
+    double sumOfSums(0);
+    for (size_t j(0); j < count; j++) {
+        double sum = accel.dotProduct(&a[0], &b[0], sz);
+        sumOfSums += sum;
+    }
+    duration elapsed = steady_clock::now() - start;
+    printf("sum=%f of N=%zu and vector length=%zu took %" PRId64 "\n", sumOfSums, count, sz, count_ms(elapsed));
+}
+
+void
+benchmarkPopulationCount(const hwaccelrated::IAccelrated & accel, size_t sz, size_t count) {
+    srand(1);
+    std::vector<uint64_t> a(sz);
+    for (auto & word : a) {
+        word = (uint64_t(rand()) << 32) | rand();
+    }
+    steady_time start = steady_clock::now();
+    size_t sumOfSums(0);
+    for (size_t j(0); j < count; j++) {
+        sumOfSums += accel.populationCount(&a[0], sz);
+    }
+    duration elapsed = steady_clock::now() - start;
+    printf("sum=%zu of N=%zu and vector length=%zu took %" PRId64 "\n", sumOfSums, count, sz, count_ms(elapsed));
+}
+
+void
+benchMarkDotProduct(const hwaccelrated::IAccelrated & accelrator, size_t sz, size_t count) {
+    printf("double : ");
+    benchmarkDotProduct<double>(accelrator, sz, count);
+    printf("float  : ");
+    benchmarkDotProduct<float>(accelrator, sz, count);
+    printf("int8_t : ");
+    benchmarkDotProduct<int8_t>(accelrator, sz, count);
+}
+
 void
 benchMarkEuclidianDistance(const hwaccelrated::IAccelrated & accelrator, size_t sz, size_t count) {
     printf("double : ");
@@ -52,8 +93,14 @@ int main(int argc, char *argv[]) {
         count = atol(argv[2]);
     }
     printf("%s %d %d\n", argv[0], length, count);
-    printf("Squared Euclidian Distance - Generic\n");
-    benchMarkEuclidianDistance(hwaccelrated::GenericAccelrator(), length, count);
+    for (const auto & [name, accelrator] : hwaccelrated::IAccelrated::create_supported_accelerators()) {
+        printf("Squared Euclidian Distance - %s\n", name);
+        benchMarkEuclidianDistance(*accelrator, length, count);
+        printf("Dot Product - %s\n", name);
+        benchMarkDotProduct(*accelrator, length, count);
+        printf("Population Count - %s\n", name);
+        benchmarkPopulationCount(*accelrator, length, count);
+    }
     printf("Squared Euclidian Distance - Optimized for this cpu\n");
     benchMarkEuclidianDistance(hwaccelrated::IAccelrated::getAccelerator(), length, count);
     return 0;
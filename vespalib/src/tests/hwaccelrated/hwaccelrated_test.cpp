@@ -47,4 +47,68 @@ TEST("test euclidean distance") {
     TEST_DO(verifyEuclideanDistance(hwaccelrated::IAccelrated::getAccelerator(), TEST_LENGTH));
 }
 
+TEST("test euclidean distance on all supported accelerators") {
+    constexpr size_t TEST_LENGTH = 140000; // must be longer than 64k
+    for (const auto & [name, accelrator] : hwaccelrated::IAccelrated::create_supported_accelerators()) {
+        TEST_STATE(name);
+        TEST_DO(verifyEuclideanDistance(*accelrator, TEST_LENGTH));
+    }
+}
+
+void
+verifyInt8DotProduct(const hwaccelrated::IAccelrated & accel, size_t testLength) {
+    srand(1);
+    std::vector<int8_t> a(testLength);
+    std::vector<int8_t> b(testLength);
+    for (size_t i(0); i < testLength; i++) {
+        a[i] = rand() % 256 - 128;
+        b[i] = rand() % 256 - 128;
+    }
+    for (size_t j(0); j < 0x20; j++) {
+        int64_t sum(0);
+        for (size_t i(j); i < testLength; i++) {
+            sum += int64_t(a[i]) * int64_t(b[i]);
+        }
+        EXPECT_EQUAL(sum, accel.dotProduct(&a[j], &b[j], testLength - j));
+    }
+}
+
+TEST("test int8 dot product on all supported accelerators") {
+    constexpr size_t TEST_LENGTH = 140000; // must be longer than 64k
+    for (const auto & [name, accelrator] : hwaccelrated::IAccelrated::create_supported_accelerators()) {
+        TEST_STATE(name);
+        TEST_DO(verifyInt8DotProduct(*accelrator, TEST_LENGTH));
+    }
+}
+
+void
+verifyBinaryHammingDistance(const hwaccelrated::IAccelrated & accel, size_t testLength) {
+    srand(1);
+    std::vector<uint8_t> a(testLength);
+    std::vector<uint8_t> b(testLength);
+    for (size_t i(0); i < testLength; i++) {
+        a[i] = rand() % 256;
+        b[i] = rand() % 256;
+    }
+    for (size_t j(0); j < 0x20; j++) {
+        for (size_t sz : {testLength - j, size_t(0), size_t(7), size_t(63), size_t(64), size_t(65),
+                          size_t(128), size_t(256), size_t(300)})
+        {
+            size_t expected(0);
+            for (size_t i(j); i < j + sz; i++) {
+                expected += __builtin_popcount(a[i] ^ b[i]);
+            }
+            EXPECT_EQUAL(expected, accel.binaryHammingDistance(&a[j], &b[j], sz));
+        }
+    }
+}
+
+TEST("test binary hamming distance on all supported accelerators") {
+    constexpr size_t TEST_LENGTH = 140000;
+    for (const auto & [name, accelrator] : hwaccelrated::IAccelrated::create_supported_accelerators()) {
+        TEST_STATE(name);
+        TEST_DO(verifyBinaryHammingDistance(*accelrator, TEST_LENGTH));
+    }
+}
+
 TEST_MAIN() { TEST_RUN_ALL(); }
@@ -0,0 +1,72 @@
+// Copyright Vespa.ai. Licensed under the terms of the Apache 2.0 license. See LICENSE in the project root.
+
+#include <vespa/vespalib/io/batch_pread.h>
+#include <vespa/vespalib/gtest/gtest.h>
+#include <algorithm>
+#include <cerrno>
+#include <fcntl.h>
+#include <unistd.h>
+#include <vector>
+
+using vespalib::BatchPread;
+
+class BatchPreadTest : public ::testing::Test {
+protected:
+    std::vector<char> content;
+    int fd;
+    BatchPreadTest()
+        : content(100000),
+          fd(-1)
+    {
+        for (size_t i = 0; i < content.size(); ++i) {
+            content[i] = char(i * 7 + i / 251);
+        }
+        fd = ::open("batch_pread_test.dat", O_RDWR | O_CREAT | O_TRUNC, 0644);
+        ssize_t written = ::write(fd, content.data(), content.size());
+        EXPECT_EQ(ssize_t(content.size()), written);
+    }
+    ~BatchPreadTest() override {
+        ::close(fd);
+        ::unlink("batch_pread_test.dat");
+    }
+};
+
+TEST_F(BatchPreadTest, all_reads_in_batch_are_performed)
+{
+    constexpr size_t num_reads = 300;
+    std::vector<std::vector<char>> buffers(num_reads, std::vector<char>(317));
+    std::vector<BatchPread::Request> requests;
+    for (size_t i = 0; i < num_reads; ++i) {
+        requests.emplace_back(fd, buffers[i].data(), buffers[i].size(), (i * 7919) % (content.size() - 317));
+    }
+    BatchPread::read(requests);
+    for (size_t i = 0; i < num_reads; ++i) {
+        ASSERT_EQ(317, requests[i].result);
+        EXPECT_TRUE(std::equal(buffers[i].begin(), buffers[i].end(), content.begin() + requests[i].offset));
+    }
+}
+
+TEST_F(BatchPreadTest, reads_are_short_at_end_of_file)
+{
+    std::vector<char> buf(1000);
+    std::vector<BatchPread::Request> requests;
+    requests.emplace_back(fd, buf.data(), 500, content.size() - 200);
+    requests.emplace_back(fd, buf.data() + 500, 500, content.size() + 10);
+    BatchPread::read(requests);
+    EXPECT_EQ(200, requests[0].result);
+    EXPECT_EQ(0, requests[1].result);
+    EXPECT_TRUE(std::equal(buf.begin(), buf.begin() + 200, content.end() - 200));
+}
+
+TEST_F(BatchPreadTest, failed_reads_report_errno)
+{
+    char buf[16];
+    std::vector<BatchPread::Request> requests;
+    requests.emplace_back(-1, buf, sizeof(buf), 0);
+    requests.emplace_back(fd, buf, sizeof(buf), 0);
+    BatchPread::read(requests);
+    EXPECT_EQ(-EBADF, requests[0].result);
+    EXPECT_EQ(16, requests[1].result);
+}
+
+GTEST_MAIN_RUN_ALL_TESTS()
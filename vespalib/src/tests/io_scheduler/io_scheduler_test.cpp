@@ -0,0 +1,99 @@
+// Copyright Vespa.ai. Licensed under the terms of the Apache 2.0 license. See LICENSE in the project root.
+
+#include <vespa/vespalib/testkit/testapp.h>
+#include <vespa/vespalib/util/io_scheduler.h>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+using namespace vespalib;
+using namespace std::chrono_literals;
+
+using IoClass = IoScheduler::Class;
+
+const IoScheduler::ClassStats &stats_of(const IoScheduler::Stats &stats, IoClass cls) {
+    return stats[IoScheduler::index_of(cls)];
+}
+
+TEST("require that bytes are counted per class without throttling when unlimited") {
+    IoScheduler scheduler;
+    scheduler.acquire(IoClass::FLUSH, 100);
+    scheduler.acquire(IoClass::FUSION, 200);
+    scheduler.acquire(IoClass::FLUSH, 50);
+    auto stats = scheduler.get_stats();
+    EXPECT_EQUAL(150u, stats_of(stats, IoClass::FLUSH).bytes);
+    EXPECT_EQUAL(200u, stats_of(stats, IoClass::FUSION).bytes);
+    EXPECT_EQUAL(0u, stats_of(stats, IoClass::COMPACTION).bytes);
+    EXPECT_EQUAL(0u, stats_of(stats, IoClass::FLUSH).throttled);
+}
+
+TEST("require that requests wait when the bucket is in debt") {
+    IoScheduler scheduler;
+    scheduler.set_bandwidth(100000, 1000);
+    scheduler.acquire(IoClass::FLUSH, 2000);
+    scheduler.acquire(IoClass::COMPACTION, 100);
+    auto stats = scheduler.get_stats();
+    EXPECT_EQUAL(0u, stats_of(stats, IoClass::FLUSH).throttled);
+    EXPECT_EQUAL(1u, stats_of(stats, IoClass::COMPACTION).throttled);
+    EXPECT_GREATER(stats_of(stats, IoClass::COMPACTION).wait_time, 5ms);
+}
+
+TEST("require that higher priority classes are let through first") {
+    IoScheduler scheduler;
+    scheduler.set_bandwidth(10000, 1000);
+    scheduler.acquire(IoClass::FLUSH, 3000);
+    std::mutex lock;
+    std::vector<IoClass> order;
+    auto waiter = [&](IoClass cls) {
+        scheduler.acquire(cls, 1000);
+        std::lock_guard guard(lock);
+        order.push_back(cls);
+    };
+    std::thread compaction(waiter, IoClass::COMPACTION);
+    std::this_thread::sleep_for(20ms);
+    std::thread flush(waiter, IoClass::FLUSH);
+    compaction.join();
+    flush.join();
+    ASSERT_EQUAL(2u, order.size());
+    EXPECT_TRUE(order[0] == IoClass::FLUSH);
+    EXPECT_TRUE(order[1] == IoClass::COMPACTION);
+}
+
+TEST("require that throttle charges the class declared by the current thread") {
+    auto &scheduler = IoScheduler::instance();
+    auto before = scheduler.get_stats();
+    IoScheduler::throttle(100);
+    {
+        IoScheduler::MyClass my_class(IoClass::FUSION);
+        IoScheduler::throttle(200);
+        {
+            IoScheduler::MyClass inner(IoClass::MERGE);
+            IoScheduler::throttle(300);
+        }
+        IoScheduler::throttle(400);
+    }
+    auto after = scheduler.get_stats();
+    EXPECT_EQUAL(600u, stats_of(after, IoClass::FUSION).bytes - stats_of(before, IoClass::FUSION).bytes);
+    EXPECT_EQUAL(300u, stats_of(after, IoClass::MERGE).bytes - stats_of(before, IoClass::MERGE).bytes);
+    EXPECT_EQUAL(0u, stats_of(after, IoClass::FLUSH).bytes - stats_of(before, IoClass::FLUSH).bytes);
+}
+
+TEST("require that a captured class is charged by the thread declaring it") {
+    auto &scheduler = IoScheduler::instance();
+    auto before = scheduler.get_stats();
+    auto none = IoScheduler::MyClass::capture();
+    IoScheduler::MyClass my_class(IoClass::FLUSH);
+    auto flush = IoScheduler::MyClass::capture();
+    std::thread([flush, none]() {
+                    {
+                        IoScheduler::MyClass captured(flush);
+                        IoScheduler::throttle(100);
+                    }
+                    IoScheduler::MyClass captured(none);
+                    IoScheduler::throttle(200);
+                }).join();
+    auto after = scheduler.get_stats();
+    EXPECT_EQUAL(100u, stats_of(after, IoClass::FLUSH).bytes - stats_of(before, IoClass::FLUSH).bytes);
+}
+
+TEST_MAIN() { TEST_RUN_ALL(); }
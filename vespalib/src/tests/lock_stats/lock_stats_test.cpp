@@ -0,0 +1,82 @@
+// Copyright Vespa.ai. Licensed under the terms of the Apache 2.0 license. See LICENSE in the project root.
+
+#include <vespa/vespalib/util/lock_stats.h>
+#include <vespa/vespalib/util/gate.h>
+#include <vespa/vespalib/gtest/gtest.h>
+#include <thread>
+
+using namespace vespalib;
+
+LockStats::Snapshot find(const vespalib::string &name) {
+    for (const auto &stats : LockStats::snapshot_all()) {
+        if (stats.name == name) {
+            return stats;
+        }
+    }
+    return {};
+}
+
+struct LockStatsTest : ::testing::Test {
+    std::mutex mutex;
+    LockStatsTest() { LockStats::set_enabled(true); }
+    ~LockStatsTest() override { LockStats::set_enabled(false); }
+};
+
+TEST_F(LockStatsTest, same_name_gives_same_stats) {
+    EXPECT_EQ(&LockStats::get("a"), &LockStats::get("a"));
+    EXPECT_NE(&LockStats::get("a"), &LockStats::get("b"));
+}
+
+TEST_F(LockStatsTest, nothing_is_recorded_when_disabled) {
+    LockStats::set_enabled(false);
+    auto &stats = LockStats::get("disabled");
+    {
+        auto guard = stats.lock(mutex);
+        EXPECT_TRUE(guard.owns_lock());
+    }
+    EXPECT_EQ(find("disabled").acquisitions, 0u);
+}
+
+TEST_F(LockStatsTest, uncontended_acquisitions_are_counted) {
+    auto &stats = LockStats::get("uncontended");
+    for (size_t i = 0; i < 3; ++i) {
+        auto guard = stats.lock(mutex);
+        EXPECT_TRUE(guard.owns_lock());
+    }
+    auto snapshot = find("uncontended");
+    EXPECT_EQ(snapshot.acquisitions, 3u);
+    EXPECT_EQ(snapshot.contended, 0u);
+    EXPECT_EQ(snapshot.total_wait, duration::zero());
+}
+
+TEST_F(LockStatsTest, wait_time_is_recorded_for_contended_acquisitions) {
+    auto &stats = LockStats::get("contended");
+    Gate locked;
+    std::thread holder([&]() {
+        auto guard = stats.lock(mutex);
+        locked.countDown();
+        std::this_thread::sleep_for(20ms);
+    });
+    locked.await();
+    {
+        auto guard = stats.lock(mutex);
+        EXPECT_TRUE(guard.owns_lock());
+    }
+    holder.join();
+    auto snapshot = find("contended");
+    EXPECT_EQ(snapshot.acquisitions, 2u);
+    EXPECT_EQ(snapshot.contended, 1u);
+    EXPECT_GT(snapshot.total_wait, 5ms);
+    EXPECT_EQ(snapshot.max_wait, snapshot.total_wait);
+    size_t bucket = 0;
+    for (size_t i = 0; i < snapshot.histogram.size(); ++i) {
+        if (snapshot.histogram[i] > 0) {
+            EXPECT_EQ(snapshot.histogram[i], 1u);
+            bucket = i;
+        }
+    }
+    EXPECT_LT(snapshot.max_wait, LockStats::Snapshot::bucket_limit(bucket));
+    EXPECT_GE(snapshot.max_wait, LockStats::Snapshot::bucket_limit(bucket - 1));
+}
+
+GTEST_MAIN_RUN_ALL_TESTS()
@@ -41,7 +41,9 @@ struct Fixture {
     Selector<Context> selector;
     std::vector<SocketPair> sockets;
     std::vector<Context> contexts;
-    Fixture(size_t size, bool read_enabled, bool write_enabled) : wakeup(false), selector(), sockets(), contexts() {
+    Fixture(size_t size, bool read_enabled, bool write_enabled, bool use_io_uring = false)
+      : wakeup(false), selector(use_io_uring), sockets(), contexts()
+    {
         for (size_t i = 0; i < size; ++i) {
             sockets.push_back(SocketPair::create());
             contexts.push_back(Context(sockets.back().a.get()));
@@ -107,7 +109,7 @@ constexpr std::pair<bool,bool> in   = std::make_pair(true,  false);
 constexpr std::pair<bool,bool> out  = std::make_pair(false, true);
 constexpr std::pair<bool,bool> both = std::make_pair(true,  true);
 
-TEST_F("require that basic events trigger correctly", Fixture(1, true, true)) {
+void verify_basic_events(Fixture &f1) {
     TEST_DO(f1.reset().poll().verify(false, {out}));
     EXPECT_TRUE(f1.write(0, "test"));
     TEST_DO(f1.reset().poll().verify(false, {both}));
@@ -123,6 +125,18 @@ TEST_F("require that basic events trigger correctly", Fixture(1, true, true)) {
     TEST_DO(f1.reset().poll().verify(false, {both}));
 }
 
+TEST_F("require that basic events trigger correctly", Fixture(1, true, true)) {
+    verify_basic_events(f1);
+}
+
+TEST_F("require that basic events trigger correctly with io_uring", Fixture(1, true, true, true)) {
+    if (!f1.selector.uses_io_uring()) {
+        fprintf(stderr, "io_uring not supported, skipping test\n");
+        return;
+    }
+    verify_basic_events(f1);
+}
+
 TEST_FFF("require that sources can be added with some events disabled",
          Fixture(1, true, false), Fixture(1, false, true), Fixture(1, false, false))
 {
@@ -140,7 +154,7 @@ TEST_FFF("require that sources can be added with some events disabled",
     TEST_DO(f3.reset().poll().verify(false, {both}));
 }
 
-TEST_F("require that multiple sources can be selected on", Fixture(5, true, false)) {
+void verify_multiple_sources(Fixture &f1) {
     TEST_DO(f1.reset().poll(10).verify(false, {none, none, none, none, none}));
     EXPECT_TRUE(f1.write(1, "test"));
     EXPECT_TRUE(f1.write(3, "test"));
@@ -152,7 +166,19 @@ TEST_F("require that multiple sources can be selected on", Fixture(5, true, fals
     TEST_DO(f1.reset().poll(10).verify(false, {none, none, none, none, none}));
 }
 
-TEST_F("require that removed sources no longer produce events", Fixture(2, true, true)) {
+TEST_F("require that multiple sources can be selected on", Fixture(5, true, false)) {
+    verify_multiple_sources(f1);
+}
+
+TEST_F("require that multiple sources can be selected on with io_uring", Fixture(5, true, false, true)) {
+    if (!f1.selector.uses_io_uring()) {
+        fprintf(stderr, "io_uring not supported, skipping test\n");
+        return;
+    }
+    verify_multiple_sources(f1);
+}
+
+void verify_removed_sources(Fixture &f1) {
     TEST_DO(f1.reset().poll().verify(false, {out, out}));
     EXPECT_TRUE(f1.write(0, "test"));
     EXPECT_TRUE(f1.write(1, "test"));
@@ -161,6 +187,18 @@ TEST_F("require that removed sources no longer produce events", Fixture(2, true,
     TEST_DO(f1.reset().poll().verify(false, {none, both}));
 }
 
+TEST_F("require that removed sources no longer produce events", Fixture(2, true, true)) {
+    verify_removed_sources(f1);
+}
+
+TEST_F("require that removed sources no longer produce events with io_uring", Fixture(2, true, true, true)) {
+    if (!f1.selector.uses_io_uring()) {
+        fprintf(stderr, "io_uring not supported, skipping test\n");
+        return;
+    }
+    verify_removed_sources(f1);
+}
+
 TEST_F("require that filling the output buffer disables write events", Fixture(1, true, true)) {
     EXPECT_TRUE(f1.write(0, "test"));
     TEST_DO(f1.reset().poll().verify(false, {both}));
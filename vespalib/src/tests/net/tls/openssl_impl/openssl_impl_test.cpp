@@ -5,13 +5,16 @@
 #include <vespa/vespalib/data/smart_buffer.h>
 #include <vespa/vespalib/net/tls/authorization_mode.h>
 #include <vespa/vespalib/net/tls/crypto_codec.h>
+#include <vespa/vespalib/net/tls/kernel_tls.h>
 #include <vespa/vespalib/net/tls/statistics.h>
 #include <vespa/vespalib/net/tls/tls_context.h>
 #include <vespa/vespalib/net/tls/transport_security_options.h>
 #include <vespa/vespalib/net/tls/impl/openssl_crypto_codec_impl.h>
 #include <vespa/vespalib/net/tls/impl/openssl_tls_context_impl.h>
+#include <vespa/vespalib/net/tls/impl/session_ticket_keys.h>
 #include <vespa/vespalib/test/make_tls_options_for_testing.h>
 #include <vespa/vespalib/test/peer_policy_utils.h>
+#include <vespa/vespalib/util/exceptions.h>
 #include <vespa/vespalib/util/size_literals.h>
 #include <stdexcept>
 #include <stdlib.h>
@@ -421,6 +424,283 @@ TEST_F("server with certificate signed by untrusted CA is rejected by client", F
     EXPECT_FALSE(f.handshake());
 }
 
+TransportSecurityOptions kernel_tls_options(bool enable) {
+    auto source_opts = vespalib::test::make_tls_options_for_testing();
+    return TransportSecurityOptions(TransportSecurityOptions::Params().
+            ca_certs_pem(source_opts.ca_certs_pem()).
+            cert_chain_pem(source_opts.cert_chain_pem()).
+            private_key_pem(source_opts.private_key_pem()).
+            authorized_peers(AuthorizedPeers::allow_all_authenticated()).
+            enable_kernel_tls(enable));
+}
+
+struct KernelTlsFixture : Fixture {
+    KernelTlsFixture() : Fixture() {
+        auto ctx = TlsContext::create_default_context(kernel_tls_options(true), AuthorizationMode::Enforce);
+        client = create_openssl_codec(ctx, CryptoCodec::Mode::Client);
+        server = create_openssl_codec(ctx, CryptoCodec::Mode::Server);
+    }
+};
+
+bool keys_are_equal(const KernelTlsKeys& a, const KernelTlsKeys& b) {
+    return ((a.cipher == b.cipher) && (a.key_size == b.key_size) && (a.sequence == b.sequence) &&
+            (memcmp(a.key, b.key, a.key_size) == 0) && (memcmp(a.iv, b.iv, sizeof(a.iv)) == 0));
+}
+
+TEST_F("Kernel TLS keys exported by client and server are mirrored", KernelTlsFixture) {
+    ASSERT_TRUE(f.handshake());
+    KernelTlsKeys client_tx, client_rx, server_tx, server_rx;
+    ASSERT_TRUE(f.client->export_kernel_tls_keys(client_tx, client_rx));
+    ASSERT_TRUE(f.server->export_kernel_tls_keys(server_tx, server_rx));
+    EXPECT_TRUE(keys_are_equal(client_tx, server_rx));
+    EXPECT_TRUE(keys_are_equal(server_tx, client_rx));
+    EXPECT_FALSE(keys_are_equal(client_tx, client_rx));
+    EXPECT_EQUAL(0u, client_tx.sequence);
+    // Key material is only handed out once
+    EXPECT_FALSE(f.client->export_kernel_tls_keys(client_tx, client_rx));
+}
+
+TEST_F("Kernel TLS keys are not exported unless enabled in transport options", Fixture) {
+    ASSERT_TRUE(f.handshake());
+    KernelTlsKeys tx, rx;
+    EXPECT_FALSE(f.client->export_kernel_tls_keys(tx, rx));
+    EXPECT_FALSE(f.server->export_kernel_tls_keys(tx, rx));
+}
+
+TEST_F("Kernel TLS keys are not exported after records have been processed in user space", KernelTlsFixture) {
+    ASSERT_TRUE(f.handshake());
+    ASSERT_FALSE(f.client_encode("Hello kernel").failed);
+    vespalib::string decoded;
+    ASSERT_TRUE(f.server_decode(decoded, 256).frame_decoded_ok());
+    KernelTlsKeys tx, rx;
+    EXPECT_FALSE(f.client->export_kernel_tls_keys(tx, rx));
+    EXPECT_FALSE(f.server->export_kernel_tls_keys(tx, rx));
+}
+
+struct ToggledVerifyCallback : CertificateVerificationCallback {
+    mutable bool reject = false; // only used in single thread testing context
+    VerificationResult verify([[maybe_unused]] const PeerCredentials& peer_creds) const override {
+        return reject ? VerificationResult::make_not_authorized()
+                      : VerificationResult::make_authorized_with_all_capabilities();
+    }
+};
+
+vespalib::string make_ticket_key(char fill) {
+    return vespalib::string(SessionTicketKey::serialized_size, fill);
+}
+
+struct SessionResumptionFixture : Fixture {
+    std::shared_ptr<ToggledVerifyCallback> verify_cb;
+    std::shared_ptr<TlsContext> resumption_ctx;
+    // Context used by servers; same as the client context unless replaced by a test
+    std::shared_ptr<TlsContext> server_ctx;
+    SocketSpec peer_spec;
+
+    static TransportSecurityOptions session_resumption_options(bool enable, vespalib::stringref ticket_keys = "") {
+        auto source_opts = vespalib::test::make_tls_options_for_testing();
+        return TransportSecurityOptions(TransportSecurityOptions::Params().
+                ca_certs_pem(source_opts.ca_certs_pem()).
+                cert_chain_pem(source_opts.cert_chain_pem()).
+                private_key_pem(source_opts.private_key_pem()).
+                session_ticket_keys(ticket_keys).
+                authorized_peers(AuthorizedPeers::allow_all_authenticated()).
+                disable_hostname_validation(true).
+                enable_session_resumption(enable));
+    }
+
+    explicit SessionResumptionFixture(bool enable = true)
+        : Fixture(),
+          verify_cb(std::make_shared<ToggledVerifyCallback>()),
+          resumption_ctx(make_context(session_resumption_options(enable))),
+          server_ctx(resumption_ctx),
+          peer_spec("tcp/localhost:12345")
+    {
+        reconnect();
+    }
+    ~SessionResumptionFixture();
+
+    std::shared_ptr<TlsContext> make_context(const TransportSecurityOptions& opts) const {
+        return TlsContext::create_default_context(opts, verify_cb, AuthorizationMode::Enforce);
+    }
+
+    void reconnect() {
+        client = create_openssl_codec(resumption_ctx, CryptoCodec::Mode::Client, peer_spec);
+        server = create_openssl_codec(server_ctx, CryptoCodec::Mode::Server);
+    }
+
+    void reconnect_to_server_with_ticket_keys(vespalib::stringref ticket_keys) {
+        server_ctx = make_context(session_resumption_options(true, ticket_keys));
+        reconnect();
+    }
+
+    // TLSv1.3 session tickets are sent after the handshake, so the client only
+    // sees them once it starts decoding data from the server.
+    bool handshake_and_receive_session_ticket() {
+        if (!handshake()) {
+            return false;
+        }
+        if (server_encode("ticket please").failed) {
+            return false;
+        }
+        vespalib::string decoded;
+        return client_decode(decoded, 256).frame_decoded_ok();
+    }
+
+    size_t num_client_sessions() const {
+        return dynamic_cast<OpenSslTlsContextImpl&>(*resumption_ctx).num_client_sessions();
+    }
+};
+
+SessionResumptionFixture::~SessionResumptionFixture() = default;
+
+struct SessionResumptionDisabledFixture : SessionResumptionFixture {
+    SessionResumptionDisabledFixture() : SessionResumptionFixture(false) {}
+};
+
+TEST_F("Client resumes earlier session when reconnecting to the same peer", SessionResumptionFixture) {
+    ASSERT_TRUE(f.handshake_and_receive_session_ticket());
+    EXPECT_FALSE(f.client->session_was_resumed());
+    EXPECT_FALSE(f.server->session_was_resumed());
+    EXPECT_EQUAL(1u, f.num_client_sessions());
+    auto first_creds = f.server->peer_credentials();
+
+    f.reconnect();
+    ASSERT_TRUE(f.handshake_and_receive_session_ticket());
+    EXPECT_TRUE(f.client->session_was_resumed());
+    EXPECT_TRUE(f.server->session_was_resumed());
+    // Credentials and capabilities are still derived from the peer certificate
+    EXPECT_EQUAL(first_creds.to_string(), f.server->peer_credentials().to_string());
+    EXPECT_EQUAL(first_creds.to_string(), f.client->peer_credentials().to_string());
+    EXPECT_TRUE(f.server->granted_capabilities() == CapabilitySet::make_with_all_capabilities());
+}
+
+TEST_F("Sessions are not resumed for peers without a socket spec", SessionResumptionFixture) {
+    f.client = f.create_openssl_codec(f.resumption_ctx, CryptoCodec::Mode::Client);
+    ASSERT_TRUE(f.handshake_and_receive_session_ticket());
+    EXPECT_EQUAL(0u, f.num_client_sessions());
+}
+
+TEST_F("Sessions are not resumed unless enabled in transport options", SessionResumptionDisabledFixture) {
+    ASSERT_TRUE(f.handshake_and_receive_session_ticket());
+    EXPECT_EQUAL(0u, f.num_client_sessions());
+    f.reconnect();
+    ASSERT_TRUE(f.handshake_and_receive_session_ticket());
+    EXPECT_FALSE(f.client->session_was_resumed());
+}
+
+TEST_F("Resumed session is rejected if peer is no longer authorized", SessionResumptionFixture) {
+    ASSERT_TRUE(f.handshake_and_receive_session_ticket());
+    EXPECT_EQUAL(1u, f.num_client_sessions());
+    f.verify_cb->reject = true;
+    f.reconnect();
+    EXPECT_FALSE(f.handshake());
+    EXPECT_EQUAL(0u, f.num_client_sessions());
+}
+
+TEST_F("Session is resumed by server after its TLS context has been replaced", SessionResumptionFixture) {
+    ASSERT_TRUE(f.handshake_and_receive_session_ticket());
+    f.server_ctx = f.make_context(SessionResumptionFixture::session_resumption_options(true));
+    f.reconnect();
+    ASSERT_TRUE(f.handshake_and_receive_session_ticket());
+    EXPECT_TRUE(f.client->session_was_resumed());
+    EXPECT_TRUE(f.server->session_was_resumed());
+}
+
+TEST_F("TLS contexts without explicit ticket keys share process-wide keys", SessionResumptionFixture) {
+    auto other_ctx = f.make_context(SessionResumptionFixture::session_resumption_options(true));
+    auto& a = dynamic_cast<OpenSslTlsContextImpl&>(*f.resumption_ctx);
+    auto& b = dynamic_cast<OpenSslTlsContextImpl&>(*other_ctx);
+    ASSERT_TRUE(a.session_ticket_keys());
+    EXPECT_EQUAL(a.session_ticket_keys().get(), b.session_ticket_keys().get());
+}
+
+TEST_F("Session is resumed by server that still has the ticket key after key rotation", SessionResumptionFixture) {
+    f.reconnect_to_server_with_ticket_keys(make_ticket_key('a'));
+    ASSERT_TRUE(f.handshake_and_receive_session_ticket());
+    EXPECT_FALSE(f.server->session_was_resumed());
+    // New key first; old key is only used for decrypting
+    f.reconnect_to_server_with_ticket_keys(make_ticket_key('b') + make_ticket_key('a'));
+    ASSERT_TRUE(f.handshake_and_receive_session_ticket());
+    EXPECT_TRUE(f.client->session_was_resumed());
+    EXPECT_TRUE(f.server->session_was_resumed());
+    // Client was handed a ticket protected by the new key, so the old key can be dropped
+    f.reconnect_to_server_with_ticket_keys(make_ticket_key('b'));
+    ASSERT_TRUE(f.handshake_and_receive_session_ticket());
+    EXPECT_TRUE(f.server->session_was_resumed());
+}
+
+TEST_F("Server does full handshake if ticket key is unknown", SessionResumptionFixture) {
+    f.reconnect_to_server_with_ticket_keys(make_ticket_key('a'));
+    ASSERT_TRUE(f.handshake_and_receive_session_ticket());
+    f.reconnect_to_server_with_ticket_keys(make_ticket_key('b'));
+    ASSERT_TRUE(f.handshake_and_receive_session_ticket());
+    EXPECT_FALSE(f.client->session_was_resumed());
+    EXPECT_FALSE(f.server->session_was_resumed());
+}
+
+TEST_F("Session tickets are not issued when kernel TLS is enabled", SessionResumptionFixture) {
+    auto source_opts = vespalib::test::make_tls_options_for_testing();
+    f.resumption_ctx = f.make_context(TransportSecurityOptions(TransportSecurityOptions::Params().
+            ca_certs_pem(source_opts.ca_certs_pem()).
+            cert_chain_pem(source_opts.cert_chain_pem()).
+            private_key_pem(source_opts.private_key_pem()).
+            authorized_peers(AuthorizedPeers::allow_all_authenticated()).
+            enable_session_resumption(true).
+            enable_kernel_tls(true)));
+    f.server_ctx = f.resumption_ctx;
+    f.reconnect();
+    ASSERT_TRUE(f.handshake_and_receive_session_ticket());
+    EXPECT_EQUAL(0u, f.num_client_sessions());
+}
+
+TEST("Session ticket key file data must be a non-zero multiple of the key size") {
+    auto keys = SessionTicketKeys::from_key_file_data(make_ticket_key('a') + make_ticket_key('b'));
+    EXPECT_EQUAL(2u, keys->num_keys());
+    EXPECT_EXCEPTION(SessionTicketKeys::from_key_file_data(""), IllegalArgumentException,
+                     "must contain a non-zero multiple of 80 bytes, but has 0 bytes");
+    EXPECT_EXCEPTION(SessionTicketKeys::from_key_file_data(make_ticket_key('a') + "x"), IllegalArgumentException,
+                     "must contain a non-zero multiple of 80 bytes, but has 81 bytes");
+}
+
+TEST("Explicitly provided session ticket keys are never rotated") {
+    auto keys = SessionTicketKeys::from_key_file_data(make_ticket_key('b') + make_ticket_key('a'));
+    auto now = std::chrono::steady_clock::now() + std::chrono::hours(1000);
+    auto key = keys->encryption_key(now);
+    EXPECT_TRUE(key.has_name(reinterpret_cast<const unsigned char*>(make_ticket_key('b').data())));
+    auto found = keys->decryption_key(reinterpret_cast<const unsigned char*>(make_ticket_key('a').data()), now);
+    ASSERT_TRUE(found.has_value());
+    EXPECT_FALSE(found->is_current);
+}
+
+TEST("Random session ticket keys are rotated, keeping the previous key for decryption") {
+    using namespace std::chrono_literals;
+    auto t0 = std::chrono::steady_clock::now();
+    SessionTicketKeys keys(1h, t0);
+    auto first = keys.encryption_key(t0 + 59min);
+    auto found = keys.decryption_key(first.name(), t0 + 59min);
+    ASSERT_TRUE(found.has_value());
+    EXPECT_TRUE(found->is_current);
+
+    auto second = keys.encryption_key(t0 + 1h);
+    EXPECT_FALSE(second.has_name(first.name()));
+    EXPECT_EQUAL(2u, keys.num_keys());
+    found = keys.decryption_key(first.name(), t0 + 1h);
+    ASSERT_TRUE(found.has_value());
+    EXPECT_FALSE(found->is_current);
+
+    // Tickets issued with the first key have expired by the time of the next rotation
+    auto third = keys.encryption_key(t0 + 2h);
+    EXPECT_FALSE(third.has_name(second.name()));
+    EXPECT_EQUAL(2u, keys.num_keys());
+    EXPECT_FALSE(keys.decryption_key(first.name(), t0 + 2h).has_value());
+    EXPECT_TRUE(keys.decryption_key(second.name(), t0 + 2h).has_value());
+
+    // Both keys are stale after being idle for more than two rotation intervals
+    keys.encryption_key(t0 + 5h);
+    EXPECT_EQUAL(1u, keys.num_keys());
+    EXPECT_FALSE(keys.decryption_key(third.name(), t0 + 5h).has_value());
+}
+
 TEST_F("Can specify multiple trusted CA certs in transport options", Fixture) {
     auto& base_opts = f.tls_opts;
     auto multi_ca_pem = base_opts.ca_certs_pem() + "\n" + unknown_ca_pem;
@@ -70,6 +70,32 @@ TEST("missing file referenced by field throws exception") {
                      "File 'missing_privkey.txt' referenced by TLS config does not exist");
 }
 
+TEST("session ticket keys are empty if not specified") {
+    auto opts = read_options_from_json_file("ok_config.json");
+    EXPECT_EQUAL("", opts->session_ticket_keys());
+}
+
+TEST("session ticket keys can be loaded via config file") {
+    const char* json = R"({"files":{"private-key":"dummy_privkey.txt",
+                                    "certificates":"dummy_certs.txt",
+                                    "ca-certificates":"dummy_ca_certs.txt",
+                                    "session-ticket-keys":"dummy_session_ticket_keys.txt"}})";
+    auto opts = read_options_from_json_string(json);
+    EXPECT_EQUAL(File::readAll("dummy_session_ticket_keys.txt"), opts->session_ticket_keys());
+    EXPECT_EQUAL(80u, opts->session_ticket_keys().size());
+    // Ticket keys are as secret as the private key
+    EXPECT_EQUAL("", opts->copy_without_private_key().session_ticket_keys());
+}
+
+TEST("session ticket key file with size that is not a multiple of the key size throws exception") {
+    const char* json = R"({"files":{"private-key":"dummy_privkey.txt",
+                                    "certificates":"dummy_certs.txt",
+                                    "ca-certificates":"dummy_ca_certs.txt",
+                                    "session-ticket-keys":"dummy_certs.txt"}})";
+    EXPECT_EXCEPTION(read_options_from_json_string(json), IllegalArgumentException,
+                     "TLS session ticket key file must contain a non-zero multiple of 80 bytes, but has 21 bytes");
+}
+
 vespalib::string json_with_policies(const vespalib::string& policies) {
     const char* fmt = R"({"files":{"private-key":"dummy_privkey.txt",
                                    "certificates":"dummy_certs.txt",
@@ -0,0 +1,102 @@
+// Copyright Vespa.ai. Licensed under the terms of the Apache 2.0 license. See LICENSE in the project root.
+
+#include <vespa/vespalib/testkit/testapp.h>
+#include <vespa/vespalib/util/priority_thread_pool.h>
+#include <vespa/vespalib/util/lambdatask.h>
+#include <vespa/vespalib/util/gate.h>
+#include <atomic>
+#include <mutex>
+#include <thread>
+
+using namespace vespalib;
+using namespace std::chrono_literals;
+
+VESPA_THREAD_STACK_TAG(priority_thread_pool_test)
+
+TEST("require that all tasks in all classes are executed") {
+    PriorityThreadPool pool(4, priority_thread_pool_test);
+    auto feed = pool.make_executor(2, 2, 1000);
+    auto query = pool.make_executor(1, 4, 1000);
+    std::atomic<size_t> feed_cnt(0);
+    std::atomic<size_t> query_cnt(0);
+    for (size_t i = 0; i < 500; ++i) {
+        EXPECT_FALSE(feed->execute(makeLambdaTask([&feed_cnt]() { feed_cnt++; })));
+        EXPECT_FALSE(query->execute(makeLambdaTask([&query_cnt]() { query_cnt++; })));
+    }
+    feed->sync();
+    EXPECT_EQUAL(500u, feed_cnt.load());
+    query->sync();
+    EXPECT_EQUAL(500u, query_cnt.load());
+    EXPECT_EQUAL(2u, feed->getNumThreads());
+    EXPECT_EQUAL(4u, query->getNumThreads());
+    auto stats = feed->getStats();
+    EXPECT_EQUAL(500u, stats.acceptedTasks);
+    EXPECT_EQUAL(0u, stats.rejectedTasks);
+}
+
+TEST("require that class concurrency limit is respected") {
+    PriorityThreadPool pool(8, priority_thread_pool_test);
+    auto executor = pool.make_executor(0, 3, 1000);
+    std::atomic<size_t> active(0);
+    std::atomic<size_t> max_active(0);
+    for (size_t i = 0; i < 200; ++i) {
+        executor->execute(makeLambdaTask([&]() {
+            size_t now = ++active;
+            size_t seen = max_active.load();
+            while (now > seen && !max_active.compare_exchange_weak(seen, now)) {}
+            std::this_thread::sleep_for(100us);
+            --active;
+        }));
+    }
+    executor->sync();
+    EXPECT_LESS_EQUAL(max_active.load(), 3u);
+    EXPECT_GREATER(max_active.load(), 0u);
+}
+
+TEST("require that higher priority classes are served first") {
+    PriorityThreadPool pool(1, priority_thread_pool_test);
+    auto low = pool.make_executor(1, 1, 1000);
+    auto high = pool.make_executor(10, 1, 1000);
+    Gate started;
+    Gate release;
+    std::mutex lock;
+    std::vector<int> order;
+    low->execute(makeLambdaTask([&]() { started.countDown(); release.await(); }));
+    started.await();
+    for (int i = 0; i < 3; ++i) {
+        low->execute(makeLambdaTask([&, i]() { std::lock_guard guard(lock); order.push_back(i); }));
+        high->execute(makeLambdaTask([&, i]() { std::lock_guard guard(lock); order.push_back(10 + i); }));
+    }
+    release.countDown();
+    low->sync();
+    high->sync();
+    std::vector<int> expect({10, 11, 12, 0, 1, 2});
+    ASSERT_EQUAL(expect.size(), order.size());
+    for (size_t i = 0; i < expect.size(); ++i) {
+        EXPECT_EQUAL(expect[i], order[i]);
+    }
+}
+
+TEST("require that tasks are rejected when task limit is reached or after shutdown") {
+    PriorityThreadPool pool(1, priority_thread_pool_test);
+    auto executor = pool.make_executor(0, 1, 2);
+    Gate started;
+    Gate release;
+    EXPECT_FALSE(executor->execute(makeLambdaTask([&]() { started.countDown(); release.await(); })));
+    started.await();
+    EXPECT_FALSE(executor->execute(makeLambdaTask([]() {})));
+    EXPECT_FALSE(executor->execute(makeLambdaTask([]() {})));
+    EXPECT_TRUE(executor->execute(makeLambdaTask([]() {})));
+    executor->setTaskLimit(3);
+    EXPECT_EQUAL(3u, executor->getTaskLimit());
+    EXPECT_FALSE(executor->execute(makeLambdaTask([]() {})));
+    release.countDown();
+    executor->sync();
+    executor->shutdown();
+    EXPECT_TRUE(executor->execute(makeLambdaTask([]() {})));
+    auto stats = executor->getStats();
+    EXPECT_EQUAL(4u, stats.acceptedTasks);
+    EXPECT_EQUAL(2u, stats.rejectedTasks);
+}
+
+TEST_MAIN() { TEST_RUN_ALL(); }
@@ -0,0 +1,188 @@
+// Copyright Vespa.ai. Licensed under the terms of the Apache 2.0 license. See LICENSE in the project root.
+
+#include <vespa/vespalib/regex/regex.h>
+#include <vespa/vespalib/regex/regex_automaton.h>
+#include <vespa/vespalib/text/lowercase.h>
+#include <vespa/vespalib/text/utf8.h>
+#include <vespa/vespalib/gtest/gtest.h>
+#include <map>
+#include <string>
+
+using namespace vespalib;
+using Casing = RegexAutomaton::Casing;
+using StringVector = std::vector<std::string>;
+
+namespace {
+
+std::vector<uint32_t>
+to_ucs4(std::string_view word)
+{
+    std::vector<uint32_t> result;
+    Utf8Reader reader(word.data(), word.size());
+    while (reader.hasMore()) {
+        result.push_back(reader.getChar());
+    }
+    return result;
+}
+
+std::vector<uint32_t>
+to_code_points(const std::string& word, Casing casing)
+{
+    return (casing == Casing::Uncased) ? LowerCase::convert_to_ucs4(std::string_view(word))
+                                       : to_ucs4(word);
+}
+
+/*
+ * Dictionary ordered on (lowercased if uncased) code points, like an attribute enum store dictionary.
+ */
+struct Dictionary {
+    Casing                                       casing;
+    std::map<std::vector<uint32_t>, std::string> words;
+    size_t                                       seeks;
+
+    Dictionary(Casing casing_in, const StringVector& words_in) : casing(casing_in), words(), seeks(0) {
+        for (const auto& word : words_in) {
+            words.emplace(to_code_points(word, casing), word);
+        }
+    }
+
+    StringVector brute_force(const std::string& pattern) const {
+        auto regex = Regex::from_pattern(pattern, (casing == Casing::Uncased) ? Regex::Options::IgnoreCase : Regex::Options::None);
+        StringVector result;
+        for (const auto& entry : words) {
+            if (regex.partial_match(entry.second)) {
+                result.push_back(entry.second);
+            }
+        }
+        return result;
+    }
+
+    StringVector match(const std::string& pattern) {
+        auto regex = Regex::from_pattern(pattern, (casing == Casing::Uncased) ? Regex::Options::IgnoreCase : Regex::Options::None);
+        auto automaton = RegexAutomaton::build(pattern, casing);
+        EXPECT_TRUE(automaton.valid());
+        StringVector result;
+        std::vector<uint32_t> successor;
+        seeks = 0;
+        auto itr = words.begin();
+        while (itr != words.end()) {
+            if (regex.partial_match(itr->second)) {
+                result.push_back(itr->second);
+                ++itr;
+            } else if (automaton.is_viable_prefix(itr->second, successor)) {
+                ++itr;
+            } else {
+                EXPECT_LT(itr->first, successor);
+                itr = words.lower_bound(successor);
+                ++seeks;
+            }
+        }
+        return result;
+    }
+};
+
+bool
+is_start_anchored(const std::string& pattern)
+{
+    return RegexAutomaton::build(pattern, Casing::Cased).valid();
+}
+
+}
+
+TEST(RegexAutomatonTest, only_start_anchored_patterns_are_compiled)
+{
+    EXPECT_TRUE(is_start_anchored("^foo"));
+    EXPECT_TRUE(is_start_anchored("^foo|^bar"));
+    EXPECT_TRUE(is_start_anchored("(^foo|^bar)baz"));
+    EXPECT_TRUE(is_start_anchored("^"));
+    EXPECT_TRUE(is_start_anchored("\\Afoo"));
+    EXPECT_FALSE(is_start_anchored(""));
+    EXPECT_FALSE(is_start_anchored("foo"));
+    EXPECT_FALSE(is_start_anchored("^foo|bar"));
+    EXPECT_FALSE(is_start_anchored("x*^foo"));
+    EXPECT_FALSE(is_start_anchored("(^foo)?"));
+}
+
+TEST(RegexAutomatonTest, unsupported_syntax_is_not_compiled)
+{
+    EXPECT_FALSE(is_start_anchored("^(?i)foo"));
+    EXPECT_FALSE(is_start_anchored("^\\Qfoo\\E"));
+    EXPECT_FALSE(is_start_anchored("^[[:alpha:]]"));
+    EXPECT_FALSE(is_start_anchored("^\\1"));
+    EXPECT_FALSE(is_start_anchored("^(foo"));
+    EXPECT_FALSE(is_start_anchored("^foo)"));
+    EXPECT_FALSE(is_start_anchored("^[foo"));
+    EXPECT_FALSE(is_start_anchored("^*"));
+    EXPECT_FALSE(is_start_anchored(std::string(2000, '(') + "^" + std::string(2000, ')')));
+}
+
+TEST(RegexAutomatonTest, successor_is_smallest_viable_string_greater_than_word)
+{
+    auto automaton = RegexAutomaton::build("^ab[m-p]x", Casing::Cased);
+    ASSERT_TRUE(automaton.valid());
+    std::vector<uint32_t> successor;
+    EXPECT_TRUE(automaton.is_viable_prefix("a", successor));
+    EXPECT_TRUE(automaton.is_viable_prefix("abn", successor));
+    EXPECT_TRUE(automaton.is_viable_prefix("abnxyz", successor));
+    EXPECT_FALSE(automaton.is_viable_prefix("abc", successor));
+    EXPECT_EQ(to_ucs4("abm"), successor);
+    EXPECT_FALSE(automaton.is_viable_prefix("abmy", successor));
+    EXPECT_EQ(to_ucs4("abn"), successor);
+    EXPECT_FALSE(automaton.is_viable_prefix("abq", successor));
+    EXPECT_EQ(std::vector<uint32_t>({RegexAutomaton::beyond_unicode}), successor);
+    EXPECT_FALSE(automaton.is_viable_prefix("0", successor));
+    EXPECT_EQ(to_ucs4("a"), successor);
+}
+
+TEST(RegexAutomatonTest, uncased_automaton_matches_lowercased_words)
+{
+    auto automaton = RegexAutomaton::build("^AB[M-P]", Casing::Uncased);
+    ASSERT_TRUE(automaton.valid());
+    std::vector<uint32_t> successor;
+    EXPECT_TRUE(automaton.is_viable_prefix("abn", successor));
+    EXPECT_TRUE(automaton.is_viable_prefix("ABN", successor));
+    EXPECT_FALSE(automaton.is_viable_prefix("ABC", successor));
+    EXPECT_EQ(to_ucs4("abm"), successor);
+    // Non-ASCII code points are never rejected, as lowercasing might differ from the case folding of the regex
+    EXPECT_TRUE(automaton.is_viable_prefix("ab\xc3\xa6", successor));
+}
+
+TEST(RegexAutomatonTest, result_matches_brute_force_scan_of_dictionary)
+{
+    StringVector words({"", "a", "A", "ab", "aB", "abc", "abcd", "abd", "ac", "b", "ba", "bab", "bc", "bcd", "c", "cab",
+                        "dab", "x1", "x12", "x1y", "x-y", "x.y", "x\ny", "foo", "foobar", "Foobar", "fooBAZ", "fop",
+                        "\xc3\xa6\xc3\xb8\xc3\xa5", "\xc3\xa6\xc3\xb8", "\xc3\x86z", "\xc3\xb8\xc3\xa5", "\xe2\x84\xaa" "ab", "\xc4\xb0x", "sx"});
+    StringVector patterns({"^a", "^ab", "^ab|^c", "(^a|^b)b", "^a?b", "^a*b", "^(ab)+c?", "^a{2,3}", "^.b", "^[a-c]b",
+                           "^[^a]", "^[^a-c]a", "^\\w\\d", "^x\\D", "^x\\W", "^x\\.", "^x[-.]", "^x\\s", "^\\x61b",
+                           "^\\x{e6}", "^[\\x{e6}-\\x{f8}]", "^\xc3\xa6\xc3\xb8", "^foo(bar|baz)$", "^foo$", "^(?:fo)+",
+                           "^(?P<name>a)b", "^foo\\b", "^\\pL", "^a{,2}", "^[]a]", "^k", "^[^k]ab", "^[^iI]x", "^\xc5\xbfx", "^.*b", "^"});
+    for (auto casing : {Casing::Cased, Casing::Uncased}) {
+        Dictionary dict(casing, words);
+        for (const auto& pattern : patterns) {
+            SCOPED_TRACE(pattern + (casing == Casing::Uncased ? " uncased" : " cased"));
+            EXPECT_EQ(dict.brute_force(pattern), dict.match(pattern));
+        }
+    }
+}
+
+TEST(RegexAutomatonTest, dictionary_is_skipped_using_successor_strings)
+{
+    StringVector words;
+    for (char c1 = 'a'; c1 <= 'z'; ++c1) {
+        for (char c2 = 'a'; c2 <= 'z'; ++c2) {
+            for (char c3 = 'a'; c3 <= 'z'; ++c3) {
+                words.push_back(std::string({c1, c2, c3, 'x', 'y', 'z'}));
+            }
+        }
+    }
+    Dictionary dict(Casing::Cased, words);
+    auto result = dict.match("^[km][aeiou]r");
+    EXPECT_EQ(dict.brute_force("^[km][aeiou]r"), result);
+    EXPECT_EQ(10u, result.size());
+    EXPECT_LT(dict.seeks, 50u);
+    result = dict.match("^(foo|bar)|^zz[a-c]");
+    EXPECT_EQ(StringVector({"barxyz", "fooxyz", "zzaxyz", "zzbxyz", "zzcxyz"}), result);
+    EXPECT_LT(dict.seeks, 10u);
+}
+
+GTEST_MAIN_RUN_ALL_TESTS()
@@ -36,7 +36,7 @@ struct Add : Rendezvous<size_t, std::pair<size_t, size_t>, ext_id> {
     using Super::size;
     using Super::in;
     using Super::out;
-    Add(size_t n) : Super(n) {}
+    Add(size_t n, uint32_t max_spins = 0, AdaptiveSpin *spin = nullptr) : Super(n, nullptr, max_spins, spin) {}
     ~Add() override;
     void mingle() override {
         size_t sum = 0;
@@ -199,6 +199,25 @@ TEST_MT_FF("require that rendezvous can be used multiple times", 10, Add<false>(
     EXPECT_EQUAL(45u, f2.rendezvous(thread_id, thread_id).first);
 }
 
+TEST_MT_FF("require that spinning rendezvous can be used multiple times", 4,
+           Add<false>(num_threads, 100000), Add<true>(num_threads, 100000))
+{
+    for (size_t i = 0; i < 1000; ++i) {
+        EXPECT_EQUAL(6u, f1.rendezvous(thread_id).first);
+        EXPECT_EQUAL(6u, f2.rendezvous(thread_id, thread_id).first);
+    }
+}
+
+TEST_MT_FFF("require that rendezvous instances can share a spin budget kept outside them", 4,
+            AdaptiveSpin(100000), Add<false>(num_threads, 100000, &f1), Add<true>(num_threads, 100000, &f1))
+{
+    for (size_t i = 0; i < 1000; ++i) {
+        EXPECT_EQUAL(6u, f2.rendezvous(thread_id).first);
+        EXPECT_EQUAL(6u, f3.rendezvous(thread_id, thread_id).first);
+    }
+    EXPECT_GREATER_EQUAL(f1.budget(), AdaptiveSpin::min_budget);
+}
+
 TEST_MT_FF("require that rendezvous can be run with additional threads", 100, Add<false>(10), CountDownLatch(10)) {
     auto res = f1.rendezvous(thread_id);
     TEST_BARRIER();
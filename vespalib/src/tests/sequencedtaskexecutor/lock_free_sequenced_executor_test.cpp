@@ -0,0 +1,173 @@
+// Copyright Vespa.ai. Licensed under the terms of the Apache 2.0 license. See LICENSE in the project root.
+
+#include <vespa/vespalib/util/lock_free_sequenced_executor.h>
+#include <vespa/vespalib/util/gate.h>
+#include <vespa/vespalib/testkit/testapp.h>
+#include <vespa/vespalib/test/insertion_operators.h>
+
+#include <atomic>
+#include <condition_variable>
+#include <thread>
+#include <unistd.h>
+
+namespace vespalib {
+
+VESPA_THREAD_STACK_TAG(lock_free_executor)
+
+class Fixture
+{
+public:
+    LockFreeSequencedExecutor _threads;
+
+    Fixture() : _threads(lock_free_executor, 2, 1000) { }
+};
+
+
+class TestObj
+{
+public:
+    std::mutex _m;
+    std::condition_variable _cv;
+    int _done;
+    int _fail;
+    int _val;
+
+    TestObj() noexcept
+        : _m(),
+          _cv(),
+          _done(0),
+          _fail(0),
+          _val(0)
+    {
+    }
+
+    void
+    modify(int oldValue, int newValue)
+    {
+        {
+            std::lock_guard<std::mutex> guard(_m);
+            if (_val == oldValue) {
+                _val = newValue;
+            } else {
+                ++_fail;
+            }
+            ++_done;
+            _cv.notify_all();
+        }
+    }
+
+    void
+    wait(int wantDone)
+    {
+        std::unique_lock<std::mutex> guard(_m);
+        _cv.wait(guard, [&] { return this->_done >= wantDone; });
+    }
+};
+
+TEST_F("testExecute", Fixture) {
+    std::shared_ptr<TestObj> tv(std::make_shared<TestObj>());
+    EXPECT_EQUAL(0, tv->_val);
+    f._threads.execute(1, [&]() { tv->modify(0, 42); });
+    tv->wait(1);
+    EXPECT_EQUAL(0,  tv->_fail);
+    EXPECT_EQUAL(42, tv->_val);
+    f._threads.sync_all();
+    EXPECT_EQUAL(0,  tv->_fail);
+    EXPECT_EQUAL(42, tv->_val);
+}
+
+TEST_F("require that task with same component id are serialized", Fixture)
+{
+    std::shared_ptr<TestObj> tv(std::make_shared<TestObj>());
+    EXPECT_EQUAL(0, tv->_val);
+    f._threads.execute(0, [&]() { usleep(2000); tv->modify(0, 14); });
+    f._threads.execute(0, [&]() { tv->modify(14, 42); });
+    tv->wait(2);
+    EXPECT_EQUAL(0,  tv->_fail);
+    EXPECT_EQUAL(42, tv->_val);
+    f._threads.sync_all();
+    EXPECT_EQUAL(0,  tv->_fail);
+    EXPECT_EQUAL(42, tv->_val);
+}
+
+TEST_F("require that task with different component ids are not serialized", Fixture)
+{
+    int tryCnt = 0;
+    for (tryCnt = 0; tryCnt < 100; ++tryCnt) {
+        std::shared_ptr<TestObj> tv(std::make_shared<TestObj>());
+        EXPECT_EQUAL(0, tv->_val);
+        f._threads.execute(0, [&]() { usleep(2000); tv->modify(0, 14); });
+        f._threads.execute(1, [&]() { tv->modify(14, 42); });
+        tv->wait(2);
+        if (tv->_fail != 1) {
+             continue;
+        }
+        EXPECT_EQUAL(1,  tv->_fail);
+        EXPECT_EQUAL(14, tv->_val);
+        f._threads.sync_all();
+        EXPECT_EQUAL(1,  tv->_fail);
+        EXPECT_EQUAL(14, tv->_val);
+        break;
+    }
+    EXPECT_TRUE(tryCnt < 100);
+}
+
+TEST("require that tasks from concurrent producers keep per producer order") {
+    constexpr size_t num_producers = 4;
+    constexpr size_t num_tasks = 20000;
+    LockFreeSequencedExecutor executor(lock_free_executor, 3, 100, true, 16, 10);
+    std::vector<size_t> last(num_producers, 0);
+    std::atomic<size_t> failed(0);
+    std::vector<std::thread> producers;
+    for (size_t p = 0; p < num_producers; ++p) {
+        producers.emplace_back([&executor, &last, &failed, p]() {
+            for (size_t i = 1; i <= num_tasks; ++i) {
+                executor.execute(ISequencedTaskExecutor::ExecutorId(0), [&last, &failed, p, i]() {
+                    if (last[p] + 1 != i) {
+                        ++failed;
+                    }
+                    last[p] = i;
+                });
+            }
+        });
+    }
+    for (auto &producer : producers) {
+        producer.join();
+    }
+    executor.sync_all();
+    EXPECT_EQUAL(0u, failed.load());
+    for (size_t p = 0; p < num_producers; ++p) {
+        EXPECT_EQUAL(num_tasks, last[p]);
+    }
+    auto stats = executor.getStats();
+    EXPECT_EQUAL(num_producers * num_tasks + 3, stats.acceptedTasks);
+}
+
+TEST("require that producer is blocked by task limit") {
+    LockFreeSequencedExecutor executor(lock_free_executor, 1, 2);
+    Gate gate;
+    std::atomic<bool> third_accepted(false);
+    executor.execute(0, [&gate]() { gate.await(); });
+    executor.execute(0, []() { });
+    std::thread producer([&]() {
+        executor.execute(0, []() { });
+        third_accepted = true;
+    });
+    usleep(20000);
+    EXPECT_FALSE(third_accepted.load());
+    gate.countDown();
+    producer.join();
+    EXPECT_TRUE(third_accepted.load());
+}
+
+TEST("require that you distribute well") {
+    LockFreeSequencedExecutor seven(lock_free_executor, 7, 10);
+    EXPECT_EQUAL(7u, seven.getNumExecutors());
+    for (uint32_t id=0; id < 1000; id++) {
+        EXPECT_EQUAL(id%7, seven.getExecutorId(id).getId());
+    }
+}
+
+}
+
+TEST_MAIN() { TEST_RUN_ALL(); }
@@ -2,14 +2,18 @@
 
 #include <vespa/vespalib/util/sequencedtaskexecutor.h>
 #include <vespa/vespalib/util/adaptive_sequenced_executor.h>
+#include <vespa/vespalib/util/lock_free_sequenced_executor.h>
 #include <vespa/vespalib/util/lambdatask.h>
 #include <vespa/vespalib/util/time.h>
 #include <atomic>
 #include <cinttypes>
+#include <thread>
+#include <vector>
 
 using vespalib::ISequencedTaskExecutor;
 using vespalib::SequencedTaskExecutor;
 using vespalib::AdaptiveSequencedExecutor;
+using vespalib::LockFreeSequencedExecutor;
 using ExecutorId = vespalib::ISequencedTaskExecutor::ExecutorId;
 
 size_t do_work(size_t size) {
@@ -52,9 +56,16 @@ int main(int argc, char **argv) {
     size_t num_threads = params.next("num_threads", num_strands);
     size_t max_waiting = params.next("max_waiting", optimize_for_throughput ? 32 : 0);
     size_t work_size = params.next("work_size", 0);
+    bool use_lock_free_executor = params.next("use_lock_free_executor", 0);
+    size_t max_batch = params.next("max_batch", 64);
+    size_t spin_rounds = params.next("spin_rounds", 100);
+    size_t num_producers = params.next("num_producers", 1);
     std::atomic<long> counter(0);
     std::unique_ptr<ISequencedTaskExecutor> executor;
-    if (use_adaptive_executor) {
+    if (use_lock_free_executor) {
+        executor = std::make_unique<LockFreeSequencedExecutor>(sequenced_executor, num_strands, task_limit, true,
+                                                               max_batch, spin_rounds);
+    } else if (use_adaptive_executor) {
         executor = std::make_unique<AdaptiveSequencedExecutor>(num_strands, num_threads, max_waiting, task_limit, true);
     } else {
         auto optimize = optimize_for_throughput
@@ -63,9 +74,17 @@ int main(int argc, char **argv) {
         executor = SequencedTaskExecutor::create(sequenced_executor, num_strands, task_limit, true, optimize);
     }
     vespalib::Timer timer;
-    for (size_t task_id = 0; task_id < num_tasks; ++task_id) {
-        executor->executeTask(ExecutorId(task_id % num_strands),
-                              vespalib::makeLambdaTask([&counter,work_size] { (void) do_work(work_size); counter++; }));
+    std::vector<std::thread> producers;
+    for (size_t producer_id = 0; producer_id < num_producers; ++producer_id) {
+        producers.emplace_back([&, producer_id]() {
+            for (size_t task_id = producer_id; task_id < num_tasks; task_id += num_producers) {
+                executor->executeTask(ExecutorId(task_id % num_strands),
+                                      vespalib::makeLambdaTask([&counter,work_size] { (void) do_work(work_size); counter++; }));
+            }
+        });
+    }
+    for (auto &producer : producers) {
+        producer.join();
     }
     executor.reset();
     fprintf(stderr, "\ntotal time: %" PRId64 " ms\n", vespalib::count_ms(timer.elapsed()));
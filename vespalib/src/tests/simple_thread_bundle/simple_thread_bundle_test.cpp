@@ -159,6 +159,62 @@ TEST("require that all strategies work with variable number of threads and targe
     }
 }
 
+TEST("require that spinning bundles work with variable number of threads and targets") {
+    for (size_t t = 1; t <= 8; ++t) {
+        State state(t);
+        SimpleThreadBundle threadBundle(t, Runnable::default_init_function, SimpleThreadBundle::USE_SIGNAL_LIST, 100000);
+        EXPECT_EQUAL(100000u, threadBundle.max_spins());
+        for (size_t i = 0; i < 100; ++i) {
+            for (size_t r = 0; r <= t; ++r) {
+                threadBundle.run(state.getTargets(r));
+            }
+        }
+        std::vector<size_t> expect;
+        for (size_t e = 0; e < t; ++e) {
+            expect.push_back(100 * (t - e));
+        }
+        EXPECT_TRUE(state.check(expect));
+    }
+}
+
+TEST("require that pooled bundles keep their sync spin budget across uses") {
+    SimpleThreadBundle::Pool pool(2, Runnable::default_init_function, 1000);
+    auto bundle = pool.obtain();
+    AdaptiveSpin *spin = bundle->sync_spin();
+    ASSERT_TRUE(spin != nullptr);
+    EXPECT_TRUE(spin->enabled());
+    EXPECT_TRUE(spin->spin_until([]() noexcept { return true; }));
+    EXPECT_EQUAL(2 * AdaptiveSpin::min_budget, spin->budget());
+    pool.release(std::move(bundle));
+    bundle = pool.obtain();
+    EXPECT_EQUAL(spin, bundle->sync_spin());
+    EXPECT_EQUAL(2 * AdaptiveSpin::min_budget, bundle->sync_spin()->budget());
+    pool.release(std::move(bundle));
+    SimpleThreadBundle plain(2);
+    EXPECT_FALSE(plain.sync_spin()->enabled());
+}
+
+TEST("require that adaptive spin budget grows on success and shrinks on failure") {
+    AdaptiveSpin spin(1000);
+    EXPECT_TRUE(spin.enabled());
+    EXPECT_EQUAL(AdaptiveSpin::min_budget, spin.budget());
+    EXPECT_TRUE(spin.spin_until([]() noexcept { return true; }));
+    EXPECT_EQUAL(2 * AdaptiveSpin::min_budget, spin.budget());
+    for (size_t i = 0; i < 10; ++i) {
+        EXPECT_TRUE(spin.spin_until([]() noexcept { return true; }));
+    }
+    EXPECT_EQUAL(1000u, spin.budget());
+    EXPECT_FALSE(spin.spin_until([]() noexcept { return false; }));
+    EXPECT_EQUAL(500u, spin.budget());
+    for (size_t i = 0; i < 10; ++i) {
+        EXPECT_FALSE(spin.spin_until([]() noexcept { return false; }));
+    }
+    EXPECT_EQUAL(AdaptiveSpin::min_budget, spin.budget());
+    AdaptiveSpin disabled(0);
+    EXPECT_FALSE(disabled.enabled());
+    EXPECT_FALSE(disabled.spin_until([]() noexcept { return true; }));
+}
+
 TEST_F("require that bundle pool gives out bundles", SimpleThreadBundle::Pool(5)) {
     auto b1 = f1.getBundle();
     auto b2 = f1.getBundle();
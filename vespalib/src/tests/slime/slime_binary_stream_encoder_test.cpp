@@ -0,0 +1,113 @@
+// Copyright Vespa.ai. Licensed under the terms of the Apache 2.0 license. See LICENSE in the project root.
+
+#include <vespa/vespalib/data/simple_buffer.h>
+#include <vespa/vespalib/data/slime/binary_stream_encoder.h>
+#include <vespa/vespalib/data/slime/slime.h>
+#include <vespa/vespalib/gtest/gtest.h>
+
+using namespace vespalib::slime::convenience;
+using vespalib::SimpleBuffer;
+using vespalib::slime::BinaryFormat;
+using vespalib::slime::BinaryStreamEncoder;
+
+SimpleBuffer encode(const Slime &slime) {
+    SimpleBuffer buf;
+    BinaryFormat::encode(slime, buf);
+    return buf;
+}
+
+SimpleBuffer encode(const BinaryStreamEncoder &encoder) {
+    SimpleBuffer buf;
+    encoder.encode(buf);
+    return buf;
+}
+
+TEST(BinaryStreamEncoderTest, empty_encoder_gives_nix)
+{
+    Slime expect;
+    BinaryStreamEncoder encoder;
+    EXPECT_EQ(encode(expect), encode(encoder));
+}
+
+TEST(BinaryStreamEncoderTest, simple_values_are_encoded_as_tree)
+{
+    auto check = [](auto make_expect, auto make_actual) {
+        Slime expect;
+        make_expect(expect);
+        BinaryStreamEncoder encoder;
+        make_actual(encoder);
+        EXPECT_EQ(encode(expect), encode(encoder));
+    };
+    check([](Slime &s){ s.setNix(); }, [](BinaryStreamEncoder &e){ e.addNix(); });
+    check([](Slime &s){ s.setBool(true); }, [](BinaryStreamEncoder &e){ e.addBool(true); });
+    check([](Slime &s){ s.setBool(false); }, [](BinaryStreamEncoder &e){ e.addBool(false); });
+    check([](Slime &s){ s.setLong(0); }, [](BinaryStreamEncoder &e){ e.addLong(0); });
+    check([](Slime &s){ s.setLong(-123456789); }, [](BinaryStreamEncoder &e){ e.addLong(-123456789); });
+    check([](Slime &s){ s.setDouble(3.5); }, [](BinaryStreamEncoder &e){ e.addDouble(3.5); });
+    check([](Slime &s){ s.setString("foo"); }, [](BinaryStreamEncoder &e){ e.addString("foo"); });
+    check([](Slime &s){ s.setData("bar"); }, [](BinaryStreamEncoder &e){ e.addData("bar"); });
+}
+
+TEST(BinaryStreamEncoderTest, nested_structure_is_encoded_as_tree)
+{
+    Slime expect;
+    Cursor &root = expect.setObject();
+    Cursor &docsums = root.setArray("docsums");
+    BinaryStreamEncoder encoder;
+    encoder.startObject().field("docsums").startArray();
+    for (int i = 0; i < 100; ++i) {
+        Cursor &docsum = docsums.addObject().setObject("docsum");
+        docsum.setLong("id", i);
+        docsum.setString("title", "some title");
+        Cursor &tags = docsum.setArray("tags");
+        encoder.startObject().field("docsum").startObject()
+            .field("id").addLong(i)
+            .field("title").addString("some title")
+            .field("tags").startArray();
+        for (int j = 0; j < i; ++j) {
+            tags.addLong(j);
+            encoder.addLong(j);
+        }
+        encoder.end().end().end();
+    }
+    encoder.end();
+    root.setBool("done", true);
+    encoder.field("done").addBool(true).end();
+    EXPECT_EQ(0u, encoder.depth());
+    EXPECT_EQ(expect.symbols(), encoder.symbols());
+    EXPECT_EQ(encode(expect), encode(encoder));
+}
+
+TEST(BinaryStreamEncoderTest, large_object_is_encoded_as_tree)
+{
+    Slime expect;
+    Cursor &root = expect.setObject();
+    BinaryStreamEncoder encoder;
+    encoder.startObject();
+    for (int i = 0; i < 1000; ++i) {
+        auto name = "field_" + std::to_string(i);
+        root.setLong(name, i);
+        encoder.field(vespalib::Memory(name)).addLong(i);
+    }
+    encoder.end();
+    EXPECT_EQ(encode(expect), encode(encoder));
+}
+
+TEST(BinaryStreamEncoderTest, existing_structure_can_be_added)
+{
+    Slime expect;
+    Cursor &root = expect.setObject();
+    root.setLong("a", 1);
+    Cursor &arr = root.setArray("b");
+    arr.addString("x");
+    arr.addObject().setDouble("c", 2.5);
+    BinaryStreamEncoder encoder;
+    encoder.add(expect.get());
+    EXPECT_EQ(encode(expect), encode(encoder));
+    Slime decoded;
+    auto out = encode(encoder);
+    EXPECT_EQ(out.get().size, BinaryFormat::decode(out.get(), decoded));
+    EXPECT_EQ(expect, decoded);
+}
+
+GTEST_MAIN_RUN_ALL_TESTS()
@@ -12,6 +12,8 @@
 #include <vespa/vespalib/util/stringfmt.h>
 #include <vespa/vespalib/util/host_name.h>
 #include <vespa/vespalib/process/process.h>
+#include <vespa/vespalib/stllike/hash_fun.h>
+#include <cinttypes>
 #include <sys/stat.h>
 
 using namespace vespalib;
@@ -60,6 +62,10 @@ vespalib::string get_json(const JsonGetHandler &handler,
     return {};
 }
 
+vespalib::string make_etag(const vespalib::string &payload) {
+    return make_string("%016" PRIx64, xxhash::xxh3_64(payload.data(), payload.size()));
+}
+
 //-----------------------------------------------------------------------------
 
 struct DummyHandler : JsonGetHandler {
@@ -102,6 +108,7 @@ TEST_FF("require that non-empty known url returns expected headers", DummyHandle
                             "Connection: close\r\n"
                             "Content-Type: application/json\r\n"
                             "Content-Length: 5\r\n"
+                            "ETag: \"" + make_etag("[123]") + "\"\r\n"
                             "X-XSS-Protection: 1; mode=block\r\n"
                             "X-Frame-Options: DENY\r\n"
                             "Content-Security-Policy: default-src 'none'; frame-ancestors 'none'\r\n"
@@ -114,6 +121,49 @@ TEST_FF("require that non-empty known url returns expected headers", DummyHandle
     EXPECT_EQUAL(expect, actual);
 }
 
+TEST_FF("require that conditional request for unchanged content returns 304 response", DummyHandler("[123]"), HttpServer(0)) {
+    auto token = f2.repo().bind(my_path, f1);
+    vespalib::string expect("HTTP/1.1 304 Not Modified\r\n"
+                            "Connection: close\r\n"
+                            "ETag: \"" + make_etag("[123]") + "\"\r\n"
+                            "\r\n");
+    auto if_none_match = make_string("-H 'If-None-Match: \"%s\"'", make_etag("[123]").c_str());
+    EXPECT_EQUAL(expect, getPage(f2.port(), my_path, "-D - " + if_none_match));
+    f1.result = "[124]";
+    EXPECT_EQUAL("[124]", getPage(f2.port(), my_path, if_none_match));
+}
+
+TEST_FF("require that successful responses are cached for the configured ttl", DummyHandler(""), HttpServer(0)) {
+    auto token = f2.repo().bind(my_path, f1);
+    f2.set_response_cache_ttl(from_s(600));
+    EXPECT_EQUAL("HTTP/1.1 404 Not Found", getFull(f2.port(), my_path).substr(0, 22));
+    f1.result = "[123]";
+    EXPECT_EQUAL("[123]", getPage(f2.port(), my_path));
+    f1.result = "[124]";
+    EXPECT_EQUAL("[123]", getPage(f2.port(), my_path));
+    EXPECT_EQUAL("[124]", getPage(f2.port(), my_path + "?foo=bar"));
+    auto if_none_match = make_string("-H 'If-None-Match: \"%s\"'", make_etag("[123]").c_str());
+    EXPECT_EQUAL("HTTP/1.1 304 Not Modified", getPage(f2.port(), my_path, "-D - " + if_none_match).substr(0, 25));
+    f2.set_response_cache_ttl(duration::zero());
+    EXPECT_EQUAL("[124]", getPage(f2.port(), my_path));
+}
+
+TEST_FF("require that larger responses are gzip encoded when accepted", DummyHandler(""), HttpServer(0)) {
+    auto token = f2.repo().bind(my_path, f1);
+    f1.result = "[0";
+    for (size_t i = 1; i < 1000; ++i) {
+        f1.result.append(",0");
+    }
+    f1.result.append("]");
+    EXPECT_EQUAL(f1.result, getPage(f2.port(), my_path, "--compressed"));
+    vespalib::string headers = getPage(f2.port(), my_path, "--compressed -D - -o /dev/null");
+    EXPECT_TRUE(headers.find("Content-Encoding: gzip\r\n") != vespalib::string::npos);
+    EXPECT_TRUE(headers.find("ETag: \"" + make_etag(f1.result) + "-gzip\"\r\n") != vespalib::string::npos);
+    headers = getPage(f2.port(), my_path, "-D - -o /dev/null");
+    EXPECT_TRUE(headers.find("Content-Encoding") == vespalib::string::npos);
+    EXPECT_TRUE(headers.find(make_string("Content-Length: %zu\r\n", f1.result.size())) != vespalib::string::npos);
+}
+
 TEST_FFFF("require that handler is selected based on longest matching url prefix",
           DummyHandler("[1]"), DummyHandler("[2]"), DummyHandler("[3]"),
           HttpServer(0))
@@ -20,6 +20,11 @@ public:
         }
         return ok;
     }
+    void read(const std::vector<K> & keys, std::vector<V> & values, std::vector<bool> & found) const {
+        for (size_t i(0); i < keys.size(); i++) {
+            found[i] = read(keys[i], values[i]);
+        }
+    }
     void write(const K & k, const V & v) {
         (*this)[k] = v;
     }
@@ -48,6 +53,24 @@ TEST("testCache") {
     EXPECT_TRUE(cache.size() == 1);
 }
 
+TEST("require that multiple keys can be read at once") {
+    B m;
+    cache< CacheParam<P, B> > cache(m, -1);
+    cache.write(1, "cached");
+    m[2] = "in backing store";
+    auto values = cache.read(std::vector<uint32_t>{2, 3, 1});
+    ASSERT_EQUAL(3u, values.size());
+    EXPECT_EQUAL("in backing store", values[0]);
+    EXPECT_EQUAL("", values[1]);
+    EXPECT_EQUAL("cached", values[2]);
+    EXPECT_TRUE(cache.hasKey(2));
+    EXPECT_FALSE(cache.hasKey(3));
+    EXPECT_EQUAL(1u, cache.getHit());
+    EXPECT_EQUAL(2u, cache.getMiss());
+    EXPECT_EQUAL(1u, cache.getInsert());
+    EXPECT_EQUAL(1u, cache.getNoneExisting());
+}
+
 TEST("testCacheSize")
 {
     B m;
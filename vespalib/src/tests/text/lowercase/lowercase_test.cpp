@@ -4,6 +4,7 @@ LOG_SETUP("lowercase_test");
 #include <vespa/vespalib/testkit/test_kit.h>
 #include <vespa/vespalib/testkit/testapp.h>
 #include <vespa/vespalib/text/lowercase.h>
+#include <vespa/vespalib/text/utf8.h>
 #include <iostream>
 #include <fstream>
 
@@ -40,4 +41,23 @@ TEST("lowercase utf8 string to ucs4")
     EXPECT_EQUAL((uint32_t)'c', res[2]);
 }
 
+TEST("ascii fast path agrees with codepoint lowercasing")
+{
+    vespalib::string input("Hello WORLD, this Is A Longer ASCII Prefix \xc3\x86\xc3\x98\xc3\x85 and ZEBRA \xff tail ABCDEFGHIJ");
+    EXPECT_EQUAL(43u, LowerCase::ascii_prefix_length(input.data(), input.size()));
+    vespalib::string expected;
+    std::vector<uint32_t> expected_ucs4;
+    Utf8Reader r(input);
+    Utf8Writer w(expected);
+    while (r.hasMore()) {
+        uint32_t c = LowerCase::convert(r.getChar());
+        w.putChar(c);
+        expected_ucs4.push_back(c);
+    }
+    EXPECT_EQUAL(expected, LowerCase::convert(input));
+    EXPECT_EQUAL("hello world, this is a longer ascii prefix \xc3\xa6\xc3\xb8\xc3\xa5 and zebra \xef\xbf\xbd tail abcdefghij",
+                 LowerCase::convert(input));
+    EXPECT_TRUE(expected_ucs4 == LowerCase::convert_to_ucs4(input));
+}
+
 TEST_MAIN() { TEST_RUN_ALL(); }
@@ -3,6 +3,7 @@
 #include <vespa/vespalib/testkit/test_kit.h>
 #include <vespa/vespalib/util/thread.h>
 #include <iostream>
+#include <sched.h>
 
 using namespace vespalib;
 
@@ -66,4 +67,16 @@ TEST("use thread pool to run multiple things") {
     EXPECT_TRUE(was_run);
 }
 
+TEST("pin thread to cpu") {
+    std::thread thread([]()
+                       {
+                           int cpu = sched_getcpu();
+                           ASSERT_TRUE(cpu >= 0);
+                           EXPECT_TRUE(thread::pin_current_to_cpu(cpu));
+                           EXPECT_EQUAL(sched_getcpu(), cpu);
+                           EXPECT_FALSE(thread::pin_current_to_cpu(-1));
+                       });
+    thread.join();
+}
+
 TEST_MAIN() { TEST_RUN_ALL(); }
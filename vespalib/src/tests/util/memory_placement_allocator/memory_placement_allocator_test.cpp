@@ -0,0 +1,121 @@
+// Copyright Vespa.ai. Licensed under the terms of the Apache 2.0 license. See LICENSE in the project root.
+
+#include <vespa/vespalib/util/alloc.h>
+#include <vespa/vespalib/util/memory_placement_allocator.h>
+#include <vespa/vespalib/gtest/gtest.h>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <string>
+
+using vespalib::alloc::Alloc;
+using vespalib::alloc::MemoryAllocator;
+using vespalib::alloc::MemoryPlacement;
+using vespalib::alloc::MemoryPlacementAllocator;
+using HugePages = MemoryPlacement::HugePages;
+
+namespace {
+
+bool
+is_huge_page_aligned(const void* ptr)
+{
+    return (reinterpret_cast<uintptr_t>(ptr) % MemoryAllocator::HUGEPAGE_SIZE) == 0;
+}
+
+// Returns the VmFlags line from /proc/self/smaps for the mapping containing ptr, empty if unknown
+std::string
+vm_flags(const void* ptr)
+{
+    std::ifstream smaps("/proc/self/smaps");
+    auto addr = reinterpret_cast<uintptr_t>(ptr);
+    bool in_mapping = false;
+    std::string line;
+    while (std::getline(smaps, line)) {
+        unsigned long start = 0;
+        unsigned long end = 0;
+        if (sscanf(line.c_str(), "%lx-%lx ", &start, &end) == 2 && line.find(':') > line.find(' ')) {
+            in_mapping = (addr >= start) && (addr < end);
+        } else if (in_mapping && line.rfind("VmFlags:", 0) == 0) {
+            return line;
+        }
+    }
+    return {};
+}
+
+bool
+is_advised_huge_pages(const void* ptr)
+{
+    return vm_flags(ptr).find(" hg") != std::string::npos;
+}
+
+}
+
+TEST(MemoryPlacementTest, default_placement_is_default)
+{
+    EXPECT_TRUE(MemoryPlacement().is_default());
+    EXPECT_FALSE(MemoryPlacement(HugePages::TRANSPARENT, MemoryPlacement::NO_NUMA_NODE).is_default());
+    EXPECT_FALSE(MemoryPlacement(HugePages::DEFAULT, 0).is_default());
+    EXPECT_EQ(MemoryPlacement(HugePages::EXPLICIT, 1), MemoryPlacement(HugePages::EXPLICIT, 1));
+    EXPECT_NE(MemoryPlacement(HugePages::EXPLICIT, 1), MemoryPlacement(HugePages::EXPLICIT, 0));
+}
+
+TEST(MemoryPlacementAllocatorTest, small_allocations_use_heap)
+{
+    MemoryPlacementAllocator allocator(MemoryPlacement(HugePages::TRANSPARENT, MemoryPlacement::NO_NUMA_NODE));
+    auto buf = Alloc::alloc_with_allocator(&allocator).create(1000);
+    ASSERT_NE(nullptr, buf.get());
+    EXPECT_EQ(1000u, buf.size());
+    memset(buf.get(), 1, buf.size());
+}
+
+TEST(MemoryPlacementAllocatorTest, large_allocations_are_huge_page_aligned)
+{
+    MemoryPlacementAllocator allocator(MemoryPlacement(HugePages::TRANSPARENT, MemoryPlacement::NO_NUMA_NODE));
+    auto buf = Alloc::alloc_with_allocator(&allocator).create(3 * MemoryAllocator::HUGEPAGE_SIZE + 1);
+    ASSERT_NE(nullptr, buf.get());
+    EXPECT_EQ(4 * MemoryAllocator::HUGEPAGE_SIZE, buf.size());
+    EXPECT_TRUE(is_huge_page_aligned(buf.get()));
+    memset(buf.get(), 1, buf.size());
+    EXPECT_FALSE(buf.resize_inplace(buf.size() * 2));
+}
+
+TEST(MemoryPlacementAllocatorTest, only_requested_huge_pages_are_advised)
+{
+    int probe = 0;
+    if (vm_flags(&probe).empty()) {
+        GTEST_SKIP() << "VmFlags not available in /proc/self/smaps";
+    }
+    MemoryPlacementAllocator transparent(MemoryPlacement(HugePages::TRANSPARENT, MemoryPlacement::NO_NUMA_NODE));
+    MemoryPlacementAllocator numa_only(MemoryPlacement(HugePages::DEFAULT, 0));
+    auto advised = transparent.alloc(MemoryAllocator::HUGEPAGE_SIZE);
+    auto not_advised = numa_only.alloc(MemoryAllocator::HUGEPAGE_SIZE);
+    EXPECT_TRUE(is_advised_huge_pages(advised.get()));
+    EXPECT_FALSE(is_advised_huge_pages(not_advised.get()));
+    transparent.free(advised);
+    numa_only.free(not_advised);
+}
+
+TEST(MemoryPlacementAllocatorTest, explicit_huge_page_allocations_are_huge_page_aligned)
+{
+    MemoryPlacementAllocator allocator(MemoryPlacement(HugePages::EXPLICIT, MemoryPlacement::NO_NUMA_NODE));
+    auto buf = Alloc::alloc_with_allocator(&allocator).create(MemoryAllocator::HUGEPAGE_SIZE);
+    ASSERT_NE(nullptr, buf.get());
+    EXPECT_EQ(MemoryAllocator::HUGEPAGE_SIZE, buf.size());
+    EXPECT_TRUE(is_huge_page_aligned(buf.get()));
+    memset(buf.get(), 1, buf.size());
+}
+
+TEST(MemoryPlacementAllocatorTest, memory_can_be_placed_on_numa_node)
+{
+    MemoryPlacementAllocator allocator(MemoryPlacement(HugePages::DEFAULT, 0));
+    size_t requested = 2 * MemoryAllocator::HUGEPAGE_SIZE - 10;
+    auto buf = allocator.alloc(requested);
+    ASSERT_NE(nullptr, buf.get());
+    EXPECT_EQ(2 * MemoryAllocator::HUGEPAGE_SIZE, buf.size());
+    memset(buf.get(), 1, buf.size());
+    // Freeing with the requested size unmaps the whole rounded up region
+    allocator.free(buf.get(), requested);
+}
+
+GTEST_MAIN_RUN_ALL_TESTS()
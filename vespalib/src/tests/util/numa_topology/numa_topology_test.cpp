@@ -0,0 +1,89 @@
+// Copyright Vespa.ai. Licensed under the terms of the Apache 2.0 license. See LICENSE in the project root.
+
+#include <vespa/vespalib/util/numa_topology.h>
+#include <vespa/vespalib/gtest/gtest.h>
+#include <filesystem>
+#include <fstream>
+
+using vespalib::NumaTopology;
+namespace fs = std::filesystem;
+
+using Cpus = std::vector<size_t>;
+
+TEST(NumaTopologyTest, cpu_lists_are_parsed)
+{
+    EXPECT_EQ(NumaTopology::parse_cpu_list("0"), Cpus({0}));
+    EXPECT_EQ(NumaTopology::parse_cpu_list("0-3,8,10-11\n"), Cpus({0, 1, 2, 3, 8, 10, 11}));
+    EXPECT_EQ(NumaTopology::parse_cpu_list(""), Cpus());
+    EXPECT_EQ(NumaTopology::parse_cpu_list("\n"), Cpus());
+}
+
+TEST(NumaTopologyTest, malformed_cpu_lists_are_rejected)
+{
+    EXPECT_EQ(NumaTopology::parse_cpu_list("3-1"), Cpus());
+    EXPECT_EQ(NumaTopology::parse_cpu_list("0,x"), Cpus());
+    EXPECT_EQ(NumaTopology::parse_cpu_list("0-"), Cpus());
+    EXPECT_EQ(NumaTopology::parse_cpu_list("0,,1"), Cpus());
+    EXPECT_EQ(NumaTopology::parse_cpu_list("0-100000"), Cpus());
+}
+
+TEST(NumaTopologyTest, default_topology_has_a_single_node)
+{
+    NumaTopology topology;
+    EXPECT_EQ(topology.num_nodes(), 1u);
+    EXPECT_EQ(topology.node_of_cpu(0), 0u);
+    EXPECT_EQ(topology.node_of_cpu(17), 0u);
+    EXPECT_EQ(topology.current_node(), 0u);
+}
+
+TEST(NumaTopologyTest, nodes_are_numbered_densely_and_empty_nodes_are_dropped)
+{
+    NumaTopology topology({{0, 1, 4, 5}, {}, {2, 3}});
+    EXPECT_EQ(topology.num_nodes(), 2u);
+    EXPECT_EQ(topology.num_cpus(0), 4u);
+    EXPECT_EQ(topology.num_cpus(1), 2u);
+    EXPECT_EQ(topology.node_of_cpu(0), 0u);
+    EXPECT_EQ(topology.node_of_cpu(2), 1u);
+    EXPECT_EQ(topology.node_of_cpu(3), 1u);
+    EXPECT_EQ(topology.node_of_cpu(5), 0u);
+    EXPECT_EQ(topology.node_of_cpu(100), 0u);
+}
+
+TEST(NumaTopologyTest, topology_is_read_from_sysfs_layout)
+{
+    fs::path dir = fs::temp_directory_path() / "vespalib_numa_topology_test";
+    fs::remove_all(dir);
+    auto add_node = [&](const char *name, const char *cpulist) {
+        fs::create_directories(dir / name);
+        std::ofstream(dir / name / "cpulist") << cpulist;
+    };
+    add_node("node0", "0-1,4\n");
+    add_node("node10", "5\n");  // sorted numerically, not as a string
+    add_node("node2", "2-3\n");
+    add_node("node3", "\n");    // memory only node
+    fs::create_directories(dir / "power");
+    auto topology = NumaTopology::from_sysfs(dir.string());
+    fs::remove_all(dir);
+    EXPECT_EQ(topology.num_nodes(), 3u);
+    EXPECT_EQ(topology.num_cpus(0), 3u);
+    EXPECT_EQ(topology.num_cpus(1), 2u);
+    EXPECT_EQ(topology.num_cpus(2), 1u);
+    EXPECT_EQ(topology.node_of_cpu(4), 0u);
+    EXPECT_EQ(topology.node_of_cpu(3), 1u);
+    EXPECT_EQ(topology.node_of_cpu(5), 2u);
+}
+
+TEST(NumaTopologyTest, missing_sysfs_gives_single_node)
+{
+    auto topology = NumaTopology::from_sysfs("/this/path/does/not/exist");
+    EXPECT_EQ(topology.num_nodes(), 1u);
+}
+
+TEST(NumaTopologyTest, system_topology_can_be_read)
+{
+    const auto &topology = NumaTopology::system();
+    EXPECT_GE(topology.num_nodes(), 1u);
+    EXPECT_LT(topology.current_node(), topology.num_nodes());
+}
+
+GTEST_MAIN_RUN_ALL_TESTS()
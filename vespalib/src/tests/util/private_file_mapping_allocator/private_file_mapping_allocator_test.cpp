@@ -0,0 +1,102 @@
+// Copyright Vespa.ai. Licensed under the terms of the Apache 2.0 license. See LICENSE in the project root.
+
+#include <vespa/vespalib/util/private_file_mapping_allocator.h>
+#include <vespa/vespalib/gtest/gtest.h>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <vector>
+
+using vespalib::alloc::Alloc;
+using vespalib::alloc::MemoryAllocator;
+using vespalib::alloc::PrivateFileMappingAllocator;
+
+namespace {
+
+vespalib::string file_name("private-file-mapping-allocator.dat");
+constexpr size_t header_size = 4_Ki;
+constexpr size_t num_values = 3000;
+
+std::vector<uint32_t>
+read_values_from_file()
+{
+    std::vector<uint32_t> values(num_values);
+    std::ifstream is(file_name, std::ios::binary);
+    is.seekg(header_size);
+    is.read(reinterpret_cast<char*>(values.data()), num_values * sizeof(uint32_t));
+    return values;
+}
+
+}
+
+class PrivateFileMappingAllocatorTest : public ::testing::Test
+{
+protected:
+    PrivateFileMappingAllocator _allocator;
+
+    PrivateFileMappingAllocatorTest()
+        : ::testing::Test(),
+          _allocator(MemoryAllocator::select_allocator())
+    {
+        std::vector<char> header(header_size, 'h');
+        std::vector<uint32_t> values(num_values);
+        for (size_t i = 0; i < num_values; ++i) {
+            values[i] = i * 3;
+        }
+        std::ofstream os(file_name, std::ios::binary);
+        os.write(header.data(), header.size());
+        os.write(reinterpret_cast<const char*>(values.data()), values.size() * sizeof(uint32_t));
+    }
+    ~PrivateFileMappingAllocatorTest() override
+    {
+        std::filesystem::remove(std::filesystem::path(file_name));
+    }
+};
+
+TEST_F(PrivateFileMappingAllocatorTest, mapped_region_is_readable_and_writes_are_private)
+{
+    auto buf = _allocator.map_file(file_name, header_size, num_values * sizeof(uint32_t));
+    ASSERT_NE(nullptr, buf.get());
+    EXPECT_EQ(num_values * sizeof(uint32_t), buf.size());
+    EXPECT_TRUE(_allocator.has_mapping());
+    auto* values = static_cast<uint32_t*>(buf.get());
+    EXPECT_EQ(0u, values[0]);
+    EXPECT_EQ(3u * 1500, values[1500]);
+    EXPECT_EQ(3u * (num_values - 1), values[num_values - 1]);
+    values[1500] = 42;
+    EXPECT_EQ(42u, values[1500]);
+    EXPECT_EQ(3u * 1500, read_values_from_file()[1500]);
+    buf.reset();
+    EXPECT_FALSE(_allocator.has_mapping());
+}
+
+TEST_F(PrivateFileMappingAllocatorTest, other_allocations_use_fallback_allocator)
+{
+    auto mapped = _allocator.map_file(file_name, header_size, num_values * sizeof(uint32_t));
+    ASSERT_NE(nullptr, mapped.get());
+    auto buf = mapped.create(num_values * 2 * sizeof(uint32_t));
+    ASSERT_NE(nullptr, buf.get());
+    EXPECT_NE(mapped.get(), buf.get());
+    memcpy(buf.get(), mapped.get(), mapped.size());
+    EXPECT_EQ(3u * 10, static_cast<const uint32_t*>(buf.get())[10]);
+    EXPECT_FALSE(mapped.resize_inplace(mapped.size() * 2));
+    mapped.reset();
+    EXPECT_FALSE(_allocator.has_mapping());
+    EXPECT_EQ(3u * 10, static_cast<const uint32_t*>(buf.get())[10]);
+}
+
+TEST_F(PrivateFileMappingAllocatorTest, unaligned_offset_is_not_mapped)
+{
+    auto buf = _allocator.map_file(file_name, header_size + 4, 4_Ki);
+    EXPECT_EQ(nullptr, buf.get());
+    EXPECT_FALSE(_allocator.has_mapping());
+}
+
+TEST_F(PrivateFileMappingAllocatorTest, missing_file_is_not_mapped)
+{
+    auto buf = _allocator.map_file("no-such-file.dat", 0, 4_Ki);
+    EXPECT_EQ(nullptr, buf.get());
+    EXPECT_FALSE(_allocator.has_mapping());
+}
+
+GTEST_MAIN_RUN_ALL_TESTS()
@@ -306,3 +306,7 @@ FastOS_FileInterface::getLastErrorString()
 void FastOS_FileInterface::dropFromCache() const
 {
 }
+
+void FastOS_FileInterface::prefetch(int64_t, size_t) const
+{
+}
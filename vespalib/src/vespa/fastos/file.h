@@ -445,6 +445,12 @@ public:
      **/
     virtual void dropFromCache() const;
 
+    /**
+     * Hint that the given range of the file will be read soon, so the
+     * OS can start reading it into the FS cache. Does not block.
+     **/
+    virtual void prefetch(int64_t offset, size_t length) const;
+
     enum Error
     {
         ERR_ZERO = 1,   // No error                       New style
@@ -8,6 +8,7 @@
 *****************************************************************************/
 
 #include "file.h"
+#include <algorithm>
 #include <sstream>
 #include <cassert>
 #include <cstring>
@@ -242,6 +243,23 @@ void FastOS_UNIX_File::dropFromCache() const
 #endif
 }
 
+void FastOS_UNIX_File::prefetch(int64_t offset, size_t length) const
+{
+    if ((offset < 0) || (length == 0)) {
+        return;
+    }
+    if ((_mmapbase != nullptr) && (uint64_t(offset) < _mmaplen)) {
+        size_t pageSize = getpagesize();
+        size_t start = offset - (offset % pageSize);
+        size_t end = std::min(size_t(offset) + length, _mmaplen);
+        madvise(static_cast<char *>(_mmapbase) + start, end - start, MADV_WILLNEED);
+        return;
+    }
+#ifdef __linux__
+    posix_fadvise(_filedes, offset, length, POSIX_FADV_WILLNEED);
+#endif
+}
+
 
 bool
 FastOS_UNIX_File::Close()
@@ -51,6 +51,7 @@ public:
     bool Open(unsigned int openFlags, const char *filename) override;
     [[nodiscard]] bool Close() override;
     bool IsOpened() const override { return _filedes >= 0; }
+    int getFileDescriptor() const { return _filedes; }
 
     void enableMemoryMap(int flags) override {
         _mmapEnabled = true;
@@ -76,6 +77,7 @@ public:
     [[nodiscard]] bool Sync() override;
     bool SetSize(int64_t newSize) override;
     void dropFromCache() const override;
+    void prefetch(int64_t offset, size_t length) const override;
 
     static int GetLastOSError();
     static Error TranslateError(const int osError);
@@ -43,6 +43,7 @@ public:
     BTree(const BTree &rhs) = delete;
     BTree & operator=(BTree &rhs) = delete;
     BTree();
+    explicit BTree(std::shared_ptr<alloc::MemoryAllocator> memory_allocator);
     ~BTree();
 
     const NodeAllocatorType &getAllocator() const { return _alloc; }
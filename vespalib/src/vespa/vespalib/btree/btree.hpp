@@ -9,7 +9,14 @@ namespace vespalib::btree {
 template <typename KeyT, typename DataT, typename AggrT, typename CompareT,
           typename TraitsT, class AggrCalcT>
 BTree<KeyT, DataT, AggrT, CompareT, TraitsT, AggrCalcT>::BTree()
-    : _alloc(),
+    : BTree(std::shared_ptr<alloc::MemoryAllocator>())
+{
+}
+
+template <typename KeyT, typename DataT, typename AggrT, typename CompareT,
+          typename TraitsT, class AggrCalcT>
+BTree<KeyT, DataT, AggrT, CompareT, TraitsT, AggrCalcT>::BTree(std::shared_ptr<alloc::MemoryAllocator> memory_allocator)
+    : _alloc(std::move(memory_allocator)),
       _tree()
 {
 }
@@ -338,6 +338,18 @@ public:
      */
     bool valid() const noexcept{ return _leaf.valid(); }
 
+    /**
+     * Get aggregated values for the leaf node at current iterator
+     * location.  Only valid when the iterator is valid.
+     */
+    const AggrT & getLeafAggregated() const noexcept { return _leaf.getNode()->getAggregated(); }
+
+    /**
+     * Get last key in the leaf node at current iterator location.
+     * Only valid when the iterator is valid.
+     */
+    const KeyType & getLeafLastKey() const noexcept { return _leaf.getNode()->getLastKey(); }
+
     /**
      * Return the number of elements in the tree.
      */
@@ -528,6 +540,27 @@ protected:
     /** Pointer to seek node and path index to the parent node **/
     using SeekNode = std::pair<const BTreeNode *, uint32_t>;
 
+    /*
+     * Search within a single node, using the key search selected by
+     * the tree traits.
+     */
+    template <typename NodeType>
+    static uint32_t node_lower_bound(const NodeType *node, uint32_t sidx, const KeyType &key, CompareT comp) {
+        if constexpr (TraitsT::LINEAR_KEY_SEARCH) {
+            return node->template linear_lower_bound<CompareT>(sidx, key, comp);
+        } else {
+            return node->template lower_bound<CompareT>(sidx, key, comp);
+        }
+    }
+    template <typename NodeType>
+    static uint32_t node_upper_bound(const NodeType *node, uint32_t sidx, const KeyType &key, CompareT comp) {
+        if constexpr (TraitsT::LINEAR_KEY_SEARCH) {
+            return node->template linear_upper_bound<CompareT>(sidx, key, comp);
+        } else {
+            return node->template upper_bound<CompareT>(sidx, key, comp);
+        }
+    }
+
 public:
     /**
      * Create iterator pointing to first element in the tree referenced
@@ -628,7 +661,8 @@ public:
      * that is greater than or equal to the key argument.  Original
      * position must be valid with a key that is less than the key argument.
      *
-     * Binary search is performed within each tree node.
+     * Binary search (or branch free linear key search if selected by
+     * tree traits) is performed within each tree node.
      *
      * @param key       Key to search for
      * @param comp      Comparator for the tree ordering.
@@ -665,7 +699,8 @@ public:
      * that is greater than the key argument.  Original position must
      * be valid with a key that is less than or equal to the key argument.
      *
-     * Binary search is performed within each tree node.
+     * Binary search (or branch free linear key search if selected by
+     * tree traits) is performed within each tree node.
      *
      * @param key       Key to search for
      * @param comp      Comparator for the tree ordering.
@@ -660,7 +660,7 @@ lower_bound(const KeyType & key, CompareT comp)
     if (_pathSize == 0) {
         if (_leafRoot == nullptr)
             return;
-        uint32_t idx = _leafRoot->template lower_bound<CompareT>(key, comp);
+        uint32_t idx = node_lower_bound(_leafRoot, 0, key, comp);
         if (idx >= _leafRoot->validSlots()) {
             _leaf.invalidate();
         } else {
@@ -671,7 +671,7 @@ lower_bound(const KeyType & key, CompareT comp)
     uint32_t level = _pathSize - 1;
     PathElement &pe = _path[level];
     const InternalNodeType *inode = pe.getNode();
-    uint32_t idx = inode->template lower_bound<CompareT>(key, comp);
+    uint32_t idx = node_lower_bound(inode, 0, key, comp);
     if (__builtin_expect(idx >= inode->validSlots(), false)) {
         end();
         return;
@@ -682,7 +682,7 @@ lower_bound(const KeyType & key, CompareT comp)
         --level;
         assert(!_allocator->isLeafRef(childRef));
         inode = _allocator->mapInternalRef(childRef);
-        idx = inode->template lower_bound<CompareT>(key, comp);
+        idx = node_lower_bound(inode, 0, key, comp);
         assert(idx < inode->validSlots());
         _path[level].setNodeAndIdx(inode, idx);
         childRef = inode->getChild(idx);
@@ -690,7 +690,7 @@ lower_bound(const KeyType & key, CompareT comp)
     }
     assert(_allocator->isLeafRef(childRef));
     const LeafNodeType *lnode = _allocator->mapLeafRef(childRef);
-    idx = lnode->template lower_bound<CompareT>(key, comp);
+    idx = node_lower_bound(lnode, 0, key, comp);
     assert(idx < lnode->validSlots());
     _leaf.setNodeAndIdx(lnode, idx);
 }
@@ -710,7 +710,7 @@ lower_bound(BTreeNode::Ref rootRef, const KeyType & key, CompareT comp)
         clearPath(0u);
         const LeafNodeType *lnode = _allocator->mapLeafRef(rootRef);
         _leafRoot = lnode;
-        uint32_t idx = lnode->template lower_bound<CompareT>(key, comp);
+        uint32_t idx = node_lower_bound(lnode, 0, key, comp);
         if (idx >= lnode->validSlots()) {
             _leaf.invalidate();
         } else {
@@ -720,7 +720,7 @@ lower_bound(BTreeNode::Ref rootRef, const KeyType & key, CompareT comp)
     }
     _leafRoot = nullptr;
     const InternalNodeType *inode = _allocator->mapInternalRef(rootRef);
-    uint32_t idx = inode->template lower_bound<CompareT>(key, comp);
+    uint32_t idx = node_lower_bound(inode, 0, key, comp);
     if (idx >= inode->validSlots()) {
         end(rootRef);
         return;
@@ -735,14 +735,14 @@ lower_bound(BTreeNode::Ref rootRef, const KeyType & key, CompareT comp)
     while (pidx != 0) {
         --pidx;
         inode = _allocator->mapInternalRef(childRef);
-        idx = inode->template lower_bound<CompareT>(key, comp);
+        idx = node_lower_bound(inode, 0, key, comp);
         assert(idx < inode->validSlots());
         _path[pidx].setNodeAndIdx(inode, idx);
         childRef = inode->getChild(idx);
         assert(childRef.valid());
     }
     const LeafNodeType *lnode = _allocator->mapLeafRef(childRef);
-    idx = lnode->template lower_bound<CompareT>(key, comp);
+    idx = node_lower_bound(lnode, 0, key, comp);
     assert(idx < lnode->validSlots());
     _leaf.setNodeAndIdx(lnode, idx);
 }
@@ -789,12 +789,12 @@ binarySeek(const KeyType & key, CompareT comp)
         } else {
             const InternalNodeType *node  = _path[level].getNode();
             uint32_t idx = _path[level].getIdx();
-            idx = node->template lower_bound<CompareT>(idx + 1, key, comp);
+            idx = node_lower_bound(node, idx + 1, key, comp);
             _path[level].setIdx(idx);
             while (level > 0) {
                 --level;
                 node = _allocator->mapInternalRef(node->getChild(idx));
-                idx = node->template lower_bound<CompareT>(0, key, comp);
+                idx = node_lower_bound(node, 0, key, comp);
                 _path[level].setNodeAndIdx(node, idx);
             }
             lnode = _allocator->mapLeafRef(node->getChild(idx));
@@ -802,7 +802,7 @@ binarySeek(const KeyType & key, CompareT comp)
             lidx = 0;
         }
     }
-    lidx = lnode->template lower_bound<CompareT>(lidx, key, comp);
+    lidx = node_lower_bound(lnode, lidx, key, comp);
     _leaf.setIdx(lidx);
 }
 
@@ -899,12 +899,12 @@ binarySeekPast(const KeyType & key, CompareT comp)
         } else {
             const InternalNodeType *node  = _path[level].getNode();
             uint32_t idx = _path[level].getIdx();
-            idx = node->template upper_bound<CompareT>(idx + 1, key, comp);
+            idx = node_upper_bound(node, idx + 1, key, comp);
             _path[level].setIdx(idx);
             while (level > 0) {
                 --level;
                 node = _allocator->mapInternalRef(node->getChild(idx));
-                idx = node->template upper_bound<CompareT>(0, key, comp);
+                idx = node_upper_bound(node, 0, key, comp);
                 _path[level].setNodeAndIdx(node, idx);
             }
             lnode = _allocator->mapLeafRef(node->getChild(idx));
@@ -912,7 +912,7 @@ binarySeekPast(const KeyType & key, CompareT comp)
             lidx = 0;
         }
     }
-    lidx = lnode->template upper_bound<CompareT>(lidx, key, comp);
+    lidx = node_upper_bound(lnode, lidx, key, comp);
     _leaf.setIdx(lidx);
 }
 
@@ -224,6 +224,19 @@ public:
     template <typename CompareT>
     uint32_t upper_bound(uint32_t sidx, const KeyT & key, CompareT comp) const;
 
+    /*
+     * Branch free variants of lower_bound and upper_bound that count the
+     * keys ordered before the given key. The keys of a node span only a
+     * few cache lines and the count is a data parallel loop that the
+     * compiler can vectorize for arithmetic keys, avoiding the mispredicted
+     * branches of a binary search.
+     */
+    template <typename CompareT>
+    uint32_t linear_lower_bound(uint32_t sidx, const KeyT & key, CompareT comp) const;
+
+    template <typename CompareT>
+    uint32_t linear_upper_bound(uint32_t sidx, const KeyT & key, CompareT comp) const;
+
     bool isFull() const noexcept { return validSlots() == NumSlots; }
     bool isAtLeastHalfFull() const noexcept { return validSlots() >= minSlots(); }
     static constexpr uint32_t maxSlots() noexcept { return NumSlots; }
@@ -72,6 +72,33 @@ upper_bound(uint32_t sidx, const KeyT & key, CompareT comp) const
     return itr - _keys;
 }
 
+template <typename KeyT, uint32_t NumSlots>
+template <typename CompareT>
+uint32_t
+BTreeNodeT<KeyT, NumSlots>::
+linear_lower_bound(uint32_t sidx, const KeyT & key, CompareT comp) const
+{
+    uint32_t idx = sidx;
+    uint32_t valid = validSlots();
+    for (uint32_t i = sidx; i < valid; ++i) {
+        idx += comp(_keys[i], key) ? 1 : 0;
+    }
+    return idx;
+}
+
+template <typename KeyT, uint32_t NumSlots>
+template <typename CompareT>
+uint32_t
+BTreeNodeT<KeyT, NumSlots>::
+linear_upper_bound(uint32_t sidx, const KeyT & key, CompareT comp) const
+{
+    uint32_t idx = sidx;
+    uint32_t valid = validSlots();
+    for (uint32_t i = sidx; i < valid; ++i) {
+        idx += comp(key, _keys[i]) ? 0 : 1;
+    }
+    return idx;
+}
 
 template <typename KeyT, typename DataT, typename AggrT, uint32_t NumSlots>
 void
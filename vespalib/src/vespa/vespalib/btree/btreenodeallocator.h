@@ -52,6 +52,7 @@ public:
     BTreeNodeAllocator(const BTreeNodeAllocator &rhs) = delete;
     BTreeNodeAllocator & operator=(const BTreeNodeAllocator &rhs) = delete;
     BTreeNodeAllocator();
+    explicit BTreeNodeAllocator(std::shared_ptr<alloc::MemoryAllocator> memory_allocator);
     ~BTreeNodeAllocator();
 
     void disableFreeLists() {
@@ -14,7 +14,15 @@ template <typename KeyT, typename DataT, typename AggrT,
           size_t INTERNAL_SLOTS, size_t LEAF_SLOTS>
 BTreeNodeAllocator<KeyT, DataT, AggrT, INTERNAL_SLOTS, LEAF_SLOTS>::
 BTreeNodeAllocator()
-    : _nodeStore(),
+    : BTreeNodeAllocator(std::shared_ptr<alloc::MemoryAllocator>())
+{
+}
+
+template <typename KeyT, typename DataT, typename AggrT,
+          size_t INTERNAL_SLOTS, size_t LEAF_SLOTS>
+BTreeNodeAllocator<KeyT, DataT, AggrT, INTERNAL_SLOTS, LEAF_SLOTS>::
+BTreeNodeAllocator(std::shared_ptr<alloc::MemoryAllocator> memory_allocator)
+    : _nodeStore(std::move(memory_allocator)),
       _internalToFreeze(),
       _leafToFreeze(),
       _treeToFreeze(),
@@ -5,7 +5,9 @@
 #include "btreenode.h"
 #include "btreetraits.h"
 #include <vespa/vespalib/datastore/datastore.h>
+#include <memory>
 
+namespace vespalib::alloc { class MemoryAllocator; }
 namespace vespalib::datastore { class CompactingBuffers; }
 
 namespace vespalib::btree {
@@ -31,14 +33,18 @@ class BTreeNodeBufferType : public datastore::BufferType<EntryType, FrozenBtreeN
     using ParentType::_arraySize;
     using EntryCount = typename ParentType::EntryCount;
     using CleanContext = typename ParentType::CleanContext;
+    std::shared_ptr<alloc::MemoryAllocator> _memory_allocator;
 public:
-    BTreeNodeBufferType(uint32_t min_entries, uint32_t max_entries)
-        : ParentType(1, min_entries, max_entries)
+    BTreeNodeBufferType(uint32_t min_entries, uint32_t max_entries,
+                        std::shared_ptr<alloc::MemoryAllocator> memory_allocator)
+        : ParentType(1, min_entries, max_entries),
+          _memory_allocator(std::move(memory_allocator))
     { }
 
     void initialize_reserved_entries(void *buffer, EntryCount reserved_entries) override;
 
     void clean_hold(void *buffer, size_t offset, EntryCount num_entries, CleanContext cleanCtx) override;
+    const alloc::MemoryAllocator* get_memory_allocator() const override { return _memory_allocator.get(); }
 };
 
 
@@ -75,6 +81,8 @@ private:
 
 public:
     BTreeNodeStore();
+    // Node buffers are allocated with the given memory allocator (default allocator if nullptr)
+    explicit BTreeNodeStore(std::shared_ptr<alloc::MemoryAllocator> memory_allocator);
 
     ~BTreeNodeStore();
 
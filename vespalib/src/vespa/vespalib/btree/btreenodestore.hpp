@@ -37,9 +37,17 @@ template <typename KeyT, typename DataT, typename AggrT,
           size_t INTERNAL_SLOTS, size_t LEAF_SLOTS>
 BTreeNodeStore<KeyT, DataT, AggrT, INTERNAL_SLOTS, LEAF_SLOTS>::
 BTreeNodeStore()
+    : BTreeNodeStore(std::shared_ptr<alloc::MemoryAllocator>())
+{
+}
+
+template <typename KeyT, typename DataT, typename AggrT,
+          size_t INTERNAL_SLOTS, size_t LEAF_SLOTS>
+BTreeNodeStore<KeyT, DataT, AggrT, INTERNAL_SLOTS, LEAF_SLOTS>::
+BTreeNodeStore(std::shared_ptr<alloc::MemoryAllocator> memory_allocator)
     : _store(),
-      _internalNodeType(MIN_BUFFER_ARRAYS, RefType::offsetSize()),
-      _leafNodeType(MIN_BUFFER_ARRAYS, RefType::offsetSize())
+      _internalNodeType(MIN_BUFFER_ARRAYS, RefType::offsetSize(), memory_allocator),
+      _leafNodeType(MIN_BUFFER_ARRAYS, RefType::offsetSize(), std::move(memory_allocator))
 {
     _store.addType(&_internalNodeType);
     _store.addType(&_leafNodeType);
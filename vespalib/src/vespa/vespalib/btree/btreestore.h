@@ -97,6 +97,8 @@ protected:
 public:
     BTreeStore();
     BTreeStore(bool init);
+    // B-tree nodes are allocated with the given memory allocator (default allocator if nullptr)
+    BTreeStore(bool init, std::shared_ptr<alloc::MemoryAllocator> memory_allocator);
     ~BTreeStore();
 
     const NodeAllocatorType &getAllocator() const { return _allocator; }
@@ -166,6 +168,18 @@ public:
      */
     void apply(EntryRef &ref, AddIter a, AddIter ae, RemoveIter r, RemoveIter re, CompareT comp = CompareT());
 
+    /**
+     * Apply multiple changes at once by streaming the old entries and
+     * the changes through the builder, producing a tree with full nodes
+     * instead of inserting and removing entries one by one.  Intended
+     * for bulk load and for change batches that are large compared to
+     * the existing data.
+     *
+     * additions and removals should be sorted on key without duplicates.
+     * Overlap between additions and removals indicates updates.
+     */
+    void bulk_merge(EntryRef &ref, AddIter a, AddIter ae, RemoveIter r, RemoveIter re, CompareT comp = CompareT());
+
     void clear(const EntryRef ref);
     size_t size(const EntryRef ref) const;
     size_t frozenSize(const EntryRef ref) const;
@@ -263,6 +277,7 @@ public:
 
 private:
     static constexpr size_t MIN_BUFFER_ARRAYS = 128u;
+    void applyChanges(EntryRef &ref, AddIter a, AddIter ae, RemoveIter r, RemoveIter re, CompareT comp, bool bulk);
     template <typename FunctionType, bool Frozen>
     void foreach_key(EntryRef ref, FunctionType func) const;
 
@@ -24,6 +24,14 @@ template <typename KeyT, typename DataT, typename AggrT, typename CompareT,
           typename TraitsT, typename AggrCalcT>
 BTreeStore<KeyT, DataT, AggrT, CompareT, TraitsT, AggrCalcT>::
 BTreeStore(bool init)
+    : BTreeStore(init, std::shared_ptr<alloc::MemoryAllocator>())
+{
+}
+
+template <typename KeyT, typename DataT, typename AggrT, typename CompareT,
+          typename TraitsT, typename AggrCalcT>
+BTreeStore<KeyT, DataT, AggrT, CompareT, TraitsT, AggrCalcT>::
+BTreeStore(bool init, std::shared_ptr<alloc::MemoryAllocator> memory_allocator)
     : _store(),
       _treeType(1, MIN_BUFFER_ARRAYS, RefType::offsetSize()),
       _small1Type(1, MIN_BUFFER_ARRAYS, RefType::offsetSize()),
@@ -34,7 +42,7 @@ BTreeStore(bool init)
       _small6Type(6, MIN_BUFFER_ARRAYS, RefType::offsetSize()),
       _small7Type(7, MIN_BUFFER_ARRAYS, RefType::offsetSize()),
       _small8Type(8, MIN_BUFFER_ARRAYS, RefType::offsetSize()),
-      _allocator(),
+      _allocator(std::move(memory_allocator)),
       _aggrCalc(),
       _builder(_allocator, _aggrCalc)
 {
@@ -763,6 +771,40 @@ apply(EntryRef &ref,
       RemoveIter r,
       RemoveIter re,
       CompareT comp)
+{
+    applyChanges(ref, a, ae, r, re, comp, false);
+}
+
+
+template <typename KeyT, typename DataT, typename AggrT, typename CompareT,
+          typename TraitsT, typename AggrCalcT>
+void
+BTreeStore<KeyT, DataT, AggrT, CompareT, TraitsT, AggrCalcT>::
+bulk_merge(EntryRef &ref,
+           AddIter a,
+           AddIter ae,
+           RemoveIter r,
+           RemoveIter re,
+           CompareT comp)
+{
+    if (a == ae && r == re) {
+        return;
+    }
+    applyChanges(ref, a, ae, r, re, comp, true);
+}
+
+
+template <typename KeyT, typename DataT, typename AggrT, typename CompareT,
+          typename TraitsT, typename AggrCalcT>
+void
+BTreeStore<KeyT, DataT, AggrT, CompareT, TraitsT, AggrCalcT>::
+applyChanges(EntryRef &ref,
+             AddIter a,
+             AddIter ae,
+             RemoveIter r,
+             RemoveIter re,
+             CompareT comp,
+             bool bulk)
 {
     if (!ref.valid()) {
         // No old data
@@ -780,7 +822,11 @@ apply(EntryRef &ref,
     }
     // Old data was tree or has been converted to a tree
     BTreeType *tree = getWTreeEntry(iRef);
-    applyTree(tree, a, ae, r, re, comp);
+    if (bulk) {
+        applyBuildTree(tree, a, ae, r, re, comp);
+    } else {
+        applyTree(tree, a, ae, r, re, comp);
+    }
     normalizeTree(ref, tree, wasArray);
 }
 
@@ -6,12 +6,22 @@
 
 namespace vespalib::btree {
 
-template <size_t LS, size_t IS, size_t PS, bool BS>
+/*
+ * LS:  number of slots in leaf nodes
+ * IS:  number of slots in internal nodes
+ * PS:  max tree height
+ * BS:  use binary (instead of linear) seek when stepping iterators forward
+ * LKS: use branch free linear key search within nodes instead of binary
+ *      search. Pays off for small, cheaply compared keys (e.g. docids)
+ *      where a node spans a few cache lines.
+ */
+template <size_t LS, size_t IS, size_t PS, bool BS, bool LKS = false>
 struct BTreeTraits {
     static constexpr size_t LEAF_SLOTS = LS;
     static constexpr size_t INTERNAL_SLOTS = IS;
     static constexpr size_t PATH_SIZE = PS;
     static constexpr bool BINARY_SEEK = BS;
+    static constexpr bool LINEAR_KEY_SEARCH = LKS;
 };
 
 using BTreeDefaultTraits = BTreeTraits<16, 16, 10, true>;
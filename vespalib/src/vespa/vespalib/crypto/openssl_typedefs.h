@@ -29,6 +29,13 @@ struct SslCtxDeleter {
 };
 using SslCtxPtr = std::unique_ptr<::SSL_CTX, SslCtxDeleter>;
 
+struct SslSessionDeleter {
+    void operator()(::SSL_SESSION* session) const noexcept {
+        ::SSL_SESSION_free(session);
+    }
+};
+using SslSessionPtr = std::unique_ptr<::SSL_SESSION, SslSessionDeleter>;
+
 struct X509Deleter {
     void operator()(::X509* cert) const noexcept {
         ::X509_free(cert);
@@ -0,0 +1,255 @@
+// Copyright Vespa.ai. Licensed under the terms of the Apache 2.0 license. See LICENSE in the project root.
+
+#include "binary_stream_encoder.h"
+#include "array_traverser.h"
+#include "binary_format.h"
+#include "inspector.h"
+#include "object_traverser.h"
+#include <vespa/vespalib/data/output_writer.h>
+#include <algorithm>
+#include <cassert>
+#include <cstring>
+
+namespace vespalib::slime {
+
+using namespace binary_format;
+
+namespace {
+
+struct Copier : ArrayTraverser, ObjectTraverser {
+    BinaryStreamEncoder &encoder;
+    explicit Copier(BinaryStreamEncoder &encoder_in) noexcept : encoder(encoder_in) {}
+    void entry(size_t, const Inspector &inspector) override {
+        encoder.add(inspector);
+    }
+    void field(const Memory &symbol, const Inspector &inspector) override {
+        encoder.field(symbol).add(inspector);
+    }
+};
+
+}
+
+BinaryStreamEncoder::BinaryStreamEncoder()
+    : _symbols(),
+      _buf(),
+      _used(0),
+      _stack(),
+      _root_values(0)
+{
+}
+
+BinaryStreamEncoder::~BinaryStreamEncoder() = default;
+
+char *
+BinaryStreamEncoder::reserve(size_t bytes)
+{
+    if (_buf.size() < (_used + bytes)) {
+        _buf.resize(std::max(_buf.size() * 2, std::max(_used + bytes, size_t(4096))));
+    }
+    return _buf.data() + _used;
+}
+
+void
+BinaryStreamEncoder::write(const char *data, size_t size)
+{
+    if (size > 0) {
+        memcpy(reserve(size), data, size);
+        commit(size);
+    }
+}
+
+void
+BinaryStreamEncoder::write_cmpr_ulong(uint64_t value)
+{
+    commit(encode_cmpr_ulong(reserve(10), value));
+}
+
+void
+BinaryStreamEncoder::write_type_and_size(uint32_t type, uint64_t size)
+{
+    char *start = reserve(11); // max size
+    char *pos = start;
+    if (size <= 30) {
+        *pos++ = encode_type_and_meta(type, size + 1);
+    } else {
+        *pos++ = encode_type_and_meta(type, 0);
+        pos += encode_cmpr_ulong(pos, size);
+    }
+    commit(pos - start);
+}
+
+template <bool top>
+void
+BinaryStreamEncoder::write_type_and_bytes(uint32_t type, uint64_t bits)
+{
+    char *start = reserve(9); // max size
+    char *pos = start + 1;
+    while (bits != 0) {
+        if (top) {
+            *pos++ = (bits >> 56);
+            bits <<= 8;
+        } else {
+            *pos++ = (bits & 0xff);
+            bits >>= 8;
+        }
+    }
+    *start = encode_type_and_meta(type, pos - start - 1);
+    commit(pos - start);
+}
+
+void
+BinaryStreamEncoder::value_added() noexcept
+{
+    if (_stack.empty()) {
+        ++_root_values;
+    } else {
+        ++_stack.back().children;
+    }
+}
+
+void
+BinaryStreamEncoder::start(uint32_t type)
+{
+    value_added();
+    // the type byte is patched with the size when the value is ended
+    _stack.push_back(Frame{_used, 0, type});
+    *reserve(1) = encode_type_and_meta(type, 0);
+    commit(1);
+}
+
+BinaryStreamEncoder &
+BinaryStreamEncoder::field(Symbol symbol)
+{
+    assert(!_stack.empty() && _stack.back().type == OBJECT::ID);
+    write_cmpr_ulong(symbol.getValue());
+    return *this;
+}
+
+BinaryStreamEncoder &
+BinaryStreamEncoder::addNix()
+{
+    value_added();
+    *reserve(1) = NIX::ID;
+    commit(1);
+    return *this;
+}
+
+BinaryStreamEncoder &
+BinaryStreamEncoder::addBool(bool value)
+{
+    value_added();
+    *reserve(1) = encode_type_and_meta(BOOL::ID, value ? 1 : 0);
+    commit(1);
+    return *this;
+}
+
+BinaryStreamEncoder &
+BinaryStreamEncoder::addLong(int64_t value)
+{
+    value_added();
+    write_type_and_bytes<false>(LONG::ID, encode_zigzag(value));
+    return *this;
+}
+
+BinaryStreamEncoder &
+BinaryStreamEncoder::addDouble(double value)
+{
+    value_added();
+    write_type_and_bytes<true>(DOUBLE::ID, encode_double(value));
+    return *this;
+}
+
+BinaryStreamEncoder &
+BinaryStreamEncoder::addString(Memory value)
+{
+    value_added();
+    write_type_and_size(STRING::ID, value.size);
+    write(value.data, value.size);
+    return *this;
+}
+
+BinaryStreamEncoder &
+BinaryStreamEncoder::addData(Memory value)
+{
+    value_added();
+    write_type_and_size(DATA::ID, value.size);
+    write(value.data, value.size);
+    return *this;
+}
+
+BinaryStreamEncoder &
+BinaryStreamEncoder::startArray()
+{
+    start(ARRAY::ID);
+    return *this;
+}
+
+BinaryStreamEncoder &
+BinaryStreamEncoder::startObject()
+{
+    start(OBJECT::ID);
+    return *this;
+}
+
+BinaryStreamEncoder &
+BinaryStreamEncoder::end()
+{
+    assert(!_stack.empty());
+    Frame frame = _stack.back();
+    _stack.pop_back();
+    if (frame.children <= 30) {
+        _buf[frame.pos] = encode_type_and_meta(frame.type, frame.children + 1);
+    } else {
+        char size[10];
+        uint32_t size_bytes = encode_cmpr_ulong(size, frame.children);
+        reserve(size_bytes);
+        char *children = _buf.data() + frame.pos + 1;
+        memmove(children + size_bytes, children, _used - frame.pos - 1);
+        memcpy(children, size, size_bytes);
+        commit(size_bytes);
+    }
+    return *this;
+}
+
+BinaryStreamEncoder &
+BinaryStreamEncoder::add(const Inspector &inspector)
+{
+    switch (inspector.type().getId()) {
+    case NIX::ID:    return addNix();
+    case BOOL::ID:   return addBool(inspector.asBool());
+    case LONG::ID:   return addLong(inspector.asLong());
+    case DOUBLE::ID: return addDouble(inspector.asDouble());
+    case STRING::ID: return addString(inspector.asString());
+    case DATA::ID:   return addData(inspector.asData());
+    }
+    Copier copier(*this);
+    if (inspector.type().getId() == ARRAY::ID) {
+        startArray();
+        inspector.traverse(static_cast<ArrayTraverser &>(copier));
+    } else {
+        startObject();
+        inspector.traverse(static_cast<ObjectTraverser &>(copier));
+    }
+    return end();
+}
+
+void
+BinaryStreamEncoder::encode(Output &output) const
+{
+    assert(_stack.empty() && _root_values <= 1);
+    OutputWriter out(output, 8000);
+    size_t num_symbols = _symbols.symbols();
+    binary_format::write_cmpr_ulong(out, num_symbols);
+    for (size_t i = 0; i < num_symbols; ++i) {
+        Memory image = _symbols.inspect(Symbol(i));
+        binary_format::write_cmpr_ulong(out, image.size);
+        out.write(image.data, image.size);
+    }
+    if (_root_values == 0) {
+        out.write(NIX::ID);
+    } else {
+        out.write(_buf.data(), _used);
+    }
+}
+
+} // namespace vespalib::slime
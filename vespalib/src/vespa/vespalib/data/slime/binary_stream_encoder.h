@@ -0,0 +1,86 @@
+// Copyright Vespa.ai. Licensed under the terms of the Apache 2.0 license. See LICENSE in the project root.
+
+#pragma once
+
+#include "symbol.h"
+#include "symbol_table.h"
+#include <vespa/vespalib/data/memory.h>
+#include <vespa/vespalib/data/output.h>
+#include <vector>
+
+namespace vespalib::slime {
+
+struct Inspector;
+
+/**
+ * Encodes a slime structure in the binary format while it is being
+ * produced, without building the intermediate tree of values.
+ *
+ * Values are added depth first. Inside an object, the name of each
+ * field is given before its value. The size of an array or object is
+ * patched in when it is ended, moving its children only when the size
+ * does not fit in the type byte. Given that symbols are inserted in
+ * the same order, the encoded result is identical to what
+ * BinaryFormat::encode produces for the equivalent tree.
+ **/
+class BinaryStreamEncoder
+{
+private:
+    struct Frame {
+        size_t   pos;      // position of the type byte
+        uint64_t children;
+        uint32_t type;
+    };
+    SymbolTable        _symbols;
+    std::vector<char>  _buf;
+    size_t             _used;
+    std::vector<Frame> _stack;
+    size_t             _root_values;
+
+    char *reserve(size_t bytes);
+    void commit(size_t bytes) noexcept { _used += bytes; }
+    void write(const char *data, size_t size);
+    void write_cmpr_ulong(uint64_t value);
+    void write_type_and_size(uint32_t type, uint64_t size);
+    template <bool top> void write_type_and_bytes(uint32_t type, uint64_t bits);
+    void value_added() noexcept;
+    void start(uint32_t type);
+
+public:
+    BinaryStreamEncoder();
+    BinaryStreamEncoder(const BinaryStreamEncoder &) = delete;
+    BinaryStreamEncoder &operator=(const BinaryStreamEncoder &) = delete;
+    ~BinaryStreamEncoder();
+
+    Symbol insert(Memory name) { return _symbols.insert(name); }
+
+    // name the next value added to the current object
+    BinaryStreamEncoder &field(Symbol symbol);
+    BinaryStreamEncoder &field(Memory name) { return field(insert(name)); }
+
+    BinaryStreamEncoder &addNix();
+    BinaryStreamEncoder &addBool(bool value);
+    BinaryStreamEncoder &addLong(int64_t value);
+    BinaryStreamEncoder &addDouble(double value);
+    BinaryStreamEncoder &addString(Memory value);
+    BinaryStreamEncoder &addData(Memory value);
+    BinaryStreamEncoder &startArray();
+    BinaryStreamEncoder &startObject();
+    // end the innermost array or object
+    BinaryStreamEncoder &end();
+
+    // copy an existing slime sub-structure
+    BinaryStreamEncoder &add(const Inspector &inspector);
+
+    size_t depth() const noexcept { return _stack.size(); }
+    size_t symbols() const noexcept { return _symbols.symbols(); }
+
+    /**
+     * Write the symbol table followed by the encoded value. All
+     * arrays and objects must have been ended. Nix is encoded if no
+     * value was added.
+     **/
+    void encode(Output &output) const;
+};
+
+} // namespace vespalib::slime
@@ -31,4 +31,20 @@ CompactionContext::compact(vespalib::ArrayRef<AtomicEntryRef> refs)
     }
 }
 
+size_t
+CompactionContext::compact_step(vespalib::ArrayRef<AtomicEntryRef> refs, size_t start, size_t max_moves)
+{
+    size_t moves = 0;
+    size_t pos = start;
+    for (; pos < refs.size() && (max_moves == 0 || moves < max_moves); ++pos) {
+        auto ref = refs[pos].load_relaxed();
+        if (ref.valid() && _filter.has(ref)) {
+            EntryRef newRef = _store.move_on_compact(ref);
+            refs[pos].store_release(newRef);
+            ++moves;
+        }
+    }
+    return pos;
+}
+
 }
@@ -23,6 +23,7 @@ public:
     CompactionContext(ICompactable& store, std::unique_ptr<CompactingBuffers> compacting_buffers);
     ~CompactionContext() override;
     void compact(vespalib::ArrayRef<AtomicEntryRef> refs) override;
+    size_t compact_step(vespalib::ArrayRef<AtomicEntryRef> refs, size_t start, size_t max_moves) override;
 };
 
 }
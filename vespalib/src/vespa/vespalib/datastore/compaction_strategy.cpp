@@ -31,6 +31,7 @@ std::ostream& operator<<(std::ostream& os, const CompactionStrategy& compaction_
 {
     os << "{maxDeadBytesRatio=" << compaction_strategy.getMaxDeadBytesRatio() <<
         ", maxDeadAddressSpaceRatio=" << compaction_strategy.getMaxDeadAddressSpaceRatio() <<
+        ", maxMovesPerStep=" << compaction_strategy.get_max_moves_per_step() <<
         "}";
     return os;
 }
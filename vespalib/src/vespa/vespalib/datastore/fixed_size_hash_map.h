@@ -8,6 +8,7 @@
 #include <vespa/vespalib/util/arrayref.h>
 #include <vespa/vespalib/util/generation_hold_list.h>
 #include <vespa/vespalib/util/generationhandler.h>
+#include <vespa/vespalib/util/prefetch.h>
 #include <atomic>
 #include <deque>
 #include <functional>
@@ -142,6 +143,21 @@ public:
         return nullptr;
     }
 
+    /*
+     * Prefetch helpers used by batched lookups to overlap the cache misses
+     * for many keys, first for the chain heads and then for the first node
+     * in each chain.
+     */
+    void prefetch_chain_head(const ShardedHashComparator & comp) const noexcept {
+        vespalib::prefetch(&_chain_heads[comp.hash_idx() % _modulo]);
+    }
+    void prefetch_first_node(const ShardedHashComparator & comp) const noexcept {
+        uint32_t node_idx = _chain_heads[comp.hash_idx() % _modulo].load_acquire();
+        if (node_idx != no_node_idx) {
+            vespalib::prefetch(&_nodes[node_idx]);
+        }
+    }
+
     void assign_generation(generation_t current_gen) {
         _hold_list.assign_generation(current_gen);
     }
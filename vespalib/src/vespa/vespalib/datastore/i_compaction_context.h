@@ -18,6 +18,13 @@ struct ICompactionContext {
     using UP = std::unique_ptr<ICompactionContext>;
     virtual ~ICompactionContext() {}
     virtual void compact(vespalib::ArrayRef<AtomicEntryRef> refs) = 0;
+    /*
+     * Compact the entry refs starting at position start, stopping when max_moves entries have been
+     * moved (0 means no limit). Returns the position to resume from, which is at least refs.size()
+     * when all entry refs have been visited. The compacted buffers are not released before the context is
+     * destroyed, thus entry refs can be passed in several steps interleaved with other writes.
+     */
+    virtual size_t compact_step(vespalib::ArrayRef<AtomicEntryRef> refs, size_t start, size_t max_moves) = 0;
 };
 
 }
@@ -4,9 +4,16 @@
 #include "fixed_size_hash_map.h"
 #include "entry_comparator.h"
 #include <vespa/vespalib/util/memoryusage.h>
+#include <cassert>
 
 namespace vespalib::datastore {
 
+namespace {
+
+constexpr size_t find_many_batch_size = 16;
+
+}
+
 class ShardedHashMapShardHeld : public GenerationHeldBase
 {
     std::unique_ptr<const FixedSizeHashMap> _data;
@@ -106,6 +113,37 @@ ShardedHashMap::find(const EntryComparator& comp, EntryRef key_ref) const
     return map->find(shardedComp);
 }
 
+void
+ShardedHashMap::find_many(ConstArrayRef<const EntryComparator*> comps, ArrayRef<const KvType*> result) const
+{
+    assert(comps.size() == result.size());
+    std::vector<ShardedHashComparator> sharded_comps;
+    std::vector<FixedSizeHashMap*> maps;
+    sharded_comps.reserve(find_many_batch_size);
+    maps.reserve(find_many_batch_size);
+    for (size_t start = 0; start < comps.size(); start += find_many_batch_size) {
+        size_t end = std::min(comps.size(), start + find_many_batch_size);
+        sharded_comps.clear();
+        maps.clear();
+        for (size_t i = start; i < end; ++i) {
+            auto& sharded_comp = sharded_comps.emplace_back(*comps[i], EntryRef(), num_shards);
+            auto map = _maps[sharded_comp.shard_idx()].load(std::memory_order_acquire);
+            if (map != nullptr) {
+                map->prefetch_chain_head(sharded_comp);
+            }
+            maps.push_back(map);
+        }
+        for (size_t j = 0; j < maps.size(); ++j) {
+            if (maps[j] != nullptr) {
+                maps[j]->prefetch_first_node(sharded_comps[j]);
+            }
+        }
+        for (size_t j = 0; j < maps.size(); ++j) {
+            result[start + j] = (maps[j] != nullptr) ? maps[j]->find(sharded_comps[j]) : nullptr;
+        }
+    }
+}
+
 void
 ShardedHashMap::assign_generation(generation_t current_gen)
 {
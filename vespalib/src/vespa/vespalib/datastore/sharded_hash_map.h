@@ -4,6 +4,7 @@
 
 #include "atomic_entry_ref.h"
 #include <atomic>
+#include <vespa/vespalib/util/arrayref.h>
 #include <vespa/vespalib/util/generationholder.h>
 #include <functional>
 
@@ -52,6 +53,13 @@ public:
     KvType* remove(const EntryComparator& comp, EntryRef key_ref);
     KvType* find(const EntryComparator& comp, EntryRef key_ref);
     const KvType* find(const EntryComparator& comp, EntryRef key_ref) const;
+    /*
+     * Look up many keys, each given by a comparator for lookup. Keys are
+     * hashed and their chains prefetched in batches before probing, to
+     * overlap cache misses. result[i] is set to the entry matching
+     * comps[i], or nullptr if not found.
+     */
+    void find_many(ConstArrayRef<const EntryComparator*> comps, ArrayRef<const KvType*> result) const;
     void assign_generation(generation_t current_gen);
     void reclaim_memory(generation_t oldest_used_gen);
     size_t size() const noexcept;
@@ -20,8 +20,8 @@ protected:
     BTreeDictionaryT _btree_dict;
 public:
     static constexpr bool has_btree_dictionary = true;
-    UniqueStoreBTreeDictionaryBase()
-        : _btree_dict()
+    explicit UniqueStoreBTreeDictionaryBase(std::shared_ptr<alloc::MemoryAllocator> memory_allocator)
+        : _btree_dict(std::move(memory_allocator))
     {
     }
 };
@@ -31,7 +31,7 @@ class UniqueStoreBTreeDictionaryBase<NoBTreeDictionary>
 {
 public:
     static constexpr bool has_btree_dictionary = false;
-    UniqueStoreBTreeDictionaryBase()
+    explicit UniqueStoreBTreeDictionaryBase(std::shared_ptr<alloc::MemoryAllocator>)
     {
     }
 };
@@ -72,6 +72,8 @@ public:
     using UniqueStoreBTreeDictionaryBase<BTreeDictionaryT>::has_btree_dictionary;
     using UniqueStoreHashDictionaryBase<HashDictionaryT>::has_hash_dictionary;
     UniqueStoreDictionary(std::unique_ptr<EntryComparator> compare);
+    // B-tree dictionary nodes are allocated with the given memory allocator (default allocator if nullptr)
+    UniqueStoreDictionary(std::unique_ptr<EntryComparator> compare, std::shared_ptr<alloc::MemoryAllocator> memory_allocator);
     ~UniqueStoreDictionary() override;
     void freeze() override;
     void assign_generation(generation_t current_gen) override;
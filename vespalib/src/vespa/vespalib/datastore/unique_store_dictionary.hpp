@@ -21,8 +21,15 @@ namespace vespalib::datastore {
 
 template <typename BTreeDictionaryT, typename ParentT, typename HashDictionaryT>
 UniqueStoreDictionary<BTreeDictionaryT, ParentT, HashDictionaryT>::UniqueStoreDictionary(std::unique_ptr<EntryComparator> compare)
+    : UniqueStoreDictionary(std::move(compare), std::shared_ptr<alloc::MemoryAllocator>())
+{
+}
+
+template <typename BTreeDictionaryT, typename ParentT, typename HashDictionaryT>
+UniqueStoreDictionary<BTreeDictionaryT, ParentT, HashDictionaryT>::UniqueStoreDictionary(std::unique_ptr<EntryComparator> compare,
+                                                                                         std::shared_ptr<alloc::MemoryAllocator> memory_allocator)
     : ParentT(),
-      UniqueStoreBTreeDictionaryBase<BTreeDictionaryT>(),
+      UniqueStoreBTreeDictionaryBase<BTreeDictionaryT>(std::move(memory_allocator)),
       UniqueStoreHashDictionaryBase<HashDictionaryT>(std::move(compare))
 {
 }
@@ -15,7 +15,7 @@ constexpr float ALLOC_GROW_FACTOR = 0.2;
 
 namespace string_allocator {
 
-std::vector<size_t> array_sizes = { 16, 24, 32, 40, 48, 64, 80, 96, 112, 128, 144, 160, 176, 192, 208, 224, 256 };
+std::vector<size_t> array_sizes = { 8, 12, 16, 20, 24, 28, 32, 40, 48, 64, 80, 96, 112, 128, 144, 160, 176, 192, 208, 224, 256 };
 
 const size_t small_string_entry_value_offset = UniqueStoreSmallStringEntry().value_offset();
 
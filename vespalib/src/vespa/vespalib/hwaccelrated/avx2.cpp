@@ -10,6 +10,11 @@ Avx2Accelrator::populationCount(const uint64_t *a, size_t sz) const noexcept {
     return helper::populationCount(a, sz);
 }
 
+size_t
+Avx2Accelrator::binaryHammingDistance(const void * a, const void * b, size_t sz) const noexcept {
+    return helper::binaryHammingDistance(a, b, sz);
+}
+
 double
 Avx2Accelrator::squaredEuclideanDistance(const int8_t * a, const int8_t * b, size_t sz) const noexcept {
     return helper::squaredEuclideanDistance(a, b, sz);
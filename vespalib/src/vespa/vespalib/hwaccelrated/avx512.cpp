@@ -20,6 +20,11 @@ Avx512Accelrator::populationCount(const uint64_t *a, size_t sz) const noexcept {
     return helper::populationCount(a, sz);
 }
 
+size_t
+Avx512Accelrator::binaryHammingDistance(const void * a, const void * b, size_t sz) const noexcept {
+    return helper::binaryHammingDistance(a, b, sz);
+}
+
 double
 Avx512Accelrator::squaredEuclideanDistance(const int8_t * a, const int8_t * b, size_t sz) const noexcept {
     return helper::squaredEuclideanDistance(a, b, sz);
@@ -15,6 +15,7 @@ public:
     float dotProduct(const float * a, const float * b, size_t sz) const noexcept override;
     double dotProduct(const double * a, const double * b, size_t sz) const noexcept override;
     size_t populationCount(const uint64_t *a, size_t sz) const noexcept override;
+    size_t binaryHammingDistance(const void * a, const void * b, size_t sz) const noexcept override;
     double squaredEuclideanDistance(const int8_t * a, const int8_t * b, size_t sz) const noexcept override;
     double squaredEuclideanDistance(const float * a, const float * b, size_t sz) const noexcept override;
     double squaredEuclideanDistance(const double * a, const double * b, size_t sz) const noexcept override;
@@ -0,0 +1,62 @@
+// Copyright Vespa.ai. Licensed under the terms of the Apache 2.0 license. See LICENSE in the project root.
+
+#include "avx512_vnni.h"
+#include <immintrin.h>
+#include <algorithm>
+
+namespace vespalib::hwaccelrated {
+
+namespace {
+
+// Number of 32 cell iterations before the 32-bit lanes are summed into a 64-bit result.
+// Each lane gets at most 2 * 255 * 255 added per iteration, which must not overflow
+// when the 16 lanes are summed.
+constexpr size_t ITERATIONS_PER_BLOCK = 256;
+
+inline __m512i
+load_int16(const int8_t * p) noexcept {
+    return _mm512_cvtepi8_epi16(_mm256_loadu_si256(reinterpret_cast<const __m256i *>(p)));
+}
+
+template <typename Accumulate, typename Scalar>
+int64_t
+compute(const int8_t * a, const int8_t * b, size_t sz, Accumulate accumulate, Scalar scalar) noexcept {
+    int64_t sum(0);
+    size_t i(0);
+    while (i + 32 <= sz) {
+        __m512i acc = _mm512_setzero_si512();
+        size_t block_end = std::min(sz - (sz % 32), i + ITERATIONS_PER_BLOCK * 32);
+        for (; i < block_end; i += 32) {
+            acc = accumulate(acc, load_int16(a + i), load_int16(b + i));
+        }
+        sum += _mm512_reduce_add_epi32(acc);
+    }
+    for (; i < sz; ++i) {
+        sum += scalar(a[i], b[i]);
+    }
+    return sum;
+}
+
+}
+
+int64_t
+Avx512VnniAccelrator::dotProduct(const int8_t * a, const int8_t * b, size_t sz) const noexcept {
+    return compute(a, b, sz,
+                   [](__m512i acc, __m512i x, __m512i y) noexcept { return _mm512_dpwssd_epi32(acc, x, y); },
+                   [](int8_t x, int8_t y) noexcept { return int64_t(x) * int64_t(y); });
+}
+
+double
+Avx512VnniAccelrator::squaredEuclideanDistance(const int8_t * a, const int8_t * b, size_t sz) const noexcept {
+    return compute(a, b, sz,
+                   [](__m512i acc, __m512i x, __m512i y) noexcept {
+                       __m512i diff = _mm512_sub_epi16(x, y);
+                       return _mm512_dpwssd_epi32(acc, diff, diff);
+                   },
+                   [](int8_t x, int8_t y) noexcept {
+                       int64_t diff = int64_t(x) - int64_t(y);
+                       return diff * diff;
+                   });
+}
+
+}
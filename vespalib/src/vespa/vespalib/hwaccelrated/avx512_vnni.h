@@ -0,0 +1,21 @@
+// Copyright Vespa.ai. Licensed under the terms of the Apache 2.0 license. See LICENSE in the project root.
+
+#pragma once
+
+#include "avx512.h"
+
+namespace vespalib::hwaccelrated {
+
+/**
+ * Avx-512 implementation using the VNNI instructions for int8 vectors.
+ */
+class Avx512VnniAccelrator : public Avx512Accelrator
+{
+public:
+    int64_t dotProduct(const int8_t * a, const int8_t * b, size_t sz) const noexcept override;
+    double squaredEuclideanDistance(const int8_t * a, const int8_t * b, size_t sz) const noexcept override;
+    using Avx512Accelrator::dotProduct;
+    using Avx512Accelrator::squaredEuclideanDistance;
+};
+
+}
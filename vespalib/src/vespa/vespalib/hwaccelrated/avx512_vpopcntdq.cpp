@@ -0,0 +1,65 @@
+// Copyright Vespa.ai. Licensed under the terms of the Apache 2.0 license. See LICENSE in the project root.
+
+#include "avx512_vpopcntdq.h"
+#include <immintrin.h>
+
+namespace vespalib::hwaccelrated {
+
+namespace {
+
+inline __m512i
+xor_popcount(const uint8_t * a, const uint8_t * b) noexcept {
+    return _mm512_popcnt_epi64(_mm512_xor_si512(_mm512_loadu_si512(a), _mm512_loadu_si512(b)));
+}
+
+// Fully unrolled for the common binary embedding sizes (512, 1024 and 2048 bits).
+template <size_t NumChunks>
+size_t
+fixed_hamming_distance(const uint8_t * a, const uint8_t * b) noexcept {
+    __m512i acc = _mm512_setzero_si512();
+    for (size_t i(0); i < NumChunks; ++i) {
+        acc = _mm512_add_epi64(acc, xor_popcount(a + i * 64, b + i * 64));
+    }
+    return _mm512_reduce_add_epi64(acc);
+}
+
+}
+
+size_t
+Avx512VpopcntdqAccelrator::populationCount(const uint64_t *a, size_t sz) const noexcept {
+    __m512i acc = _mm512_setzero_si512();
+    size_t i(0);
+    for (; i + 8 <= sz; i += 8) {
+        acc = _mm512_add_epi64(acc, _mm512_popcnt_epi64(_mm512_loadu_si512(a + i)));
+    }
+    if (i < sz) {
+        __mmask8 mask = (1u << (sz - i)) - 1;
+        acc = _mm512_add_epi64(acc, _mm512_popcnt_epi64(_mm512_maskz_loadu_epi64(mask, a + i)));
+    }
+    return _mm512_reduce_add_epi64(acc);
+}
+
+size_t
+Avx512VpopcntdqAccelrator::binaryHammingDistance(const void * lhs, const void * rhs, size_t sz) const noexcept {
+    const auto * a = static_cast<const uint8_t *>(lhs);
+    const auto * b = static_cast<const uint8_t *>(rhs);
+    switch (sz) {
+    case 64:  return fixed_hamming_distance<1>(a, b);
+    case 128: return fixed_hamming_distance<2>(a, b);
+    case 256: return fixed_hamming_distance<4>(a, b);
+    default: break;
+    }
+    __m512i acc = _mm512_setzero_si512();
+    size_t i(0);
+    for (; i + 64 <= sz; i += 64) {
+        acc = _mm512_add_epi64(acc, xor_popcount(a + i, b + i));
+    }
+    if (i < sz) {
+        __mmask64 mask = (uint64_t(1) << (sz - i)) - 1;
+        __m512i x = _mm512_xor_si512(_mm512_maskz_loadu_epi8(mask, a + i), _mm512_maskz_loadu_epi8(mask, b + i));
+        acc = _mm512_add_epi64(acc, _mm512_popcnt_epi64(x));
+    }
+    return _mm512_reduce_add_epi64(acc);
+}
+
+}
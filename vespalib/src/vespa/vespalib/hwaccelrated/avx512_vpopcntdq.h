@@ -0,0 +1,19 @@
+// Copyright Vespa.ai. Licensed under the terms of the Apache 2.0 license. See LICENSE in the project root.
+
+#pragma once
+
+#include "avx512_vnni.h"
+
+namespace vespalib::hwaccelrated {
+
+/**
+ * Avx-512 implementation using the VPOPCNTDQ instructions for binary hamming distance.
+ */
+class Avx512VpopcntdqAccelrator : public Avx512VnniAccelrator
+{
+public:
+    size_t populationCount(const uint64_t *a, size_t sz) const noexcept override;
+    size_t binaryHammingDistance(const void * a, const void * b, size_t sz) const noexcept override;
+};
+
+}
@@ -157,6 +157,11 @@ GenericAccelrator::populationCount(const uint64_t *a, size_t sz) const noexcept
     return helper::populationCount(a, sz);
 }
 
+size_t
+GenericAccelrator::binaryHammingDistance(const void * a, const void * b, size_t sz) const noexcept {
+    return helper::binaryHammingDistance(a, b, sz);
+}
+
 double
 GenericAccelrator::squaredEuclideanDistance(const int8_t * a, const int8_t * b, size_t sz) const noexcept {
     return helper::squaredEuclideanDistance(a, b, sz);
@@ -5,6 +5,11 @@
 #ifdef __x86_64__
 #include "avx2.h"
 #include "avx512.h"
+#include "avx512_vnni.h"
+#include "avx512_vpopcntdq.h"
+#endif
+#ifdef __aarch64__
+#include "neon.h"
 #endif
 #include <vespa/vespalib/util/memory.h>
 #include <cstdio>
@@ -17,15 +22,44 @@ namespace vespalib::hwaccelrated {
 
 namespace {
 
+#ifdef __x86_64__
+// avx512_vnni.cpp is compiled for Cascade Lake
+bool supports_cascadelake() {
+    return __builtin_cpu_supports("avx512vnni") && __builtin_cpu_supports("avx512bw");
+}
+
+// avx512_vpopcntdq.cpp is compiled for Ice Lake server, which adds more than VPOPCNTDQ
+bool supports_icelake_server() {
+    return supports_cascadelake() &&
+           __builtin_cpu_supports("avx512vpopcntdq") &&
+           __builtin_cpu_supports("avx512vbmi") &&
+           __builtin_cpu_supports("avx512vbmi2") &&
+           __builtin_cpu_supports("avx512bitalg") &&
+           __builtin_cpu_supports("gfni") &&
+           __builtin_cpu_supports("vpclmulqdq") &&
+           __builtin_cpu_supports("vaes");
+}
+#endif
+
 IAccelrated::UP create_accelerator() {
 #ifdef __x86_64__
     __builtin_cpu_init();
+    if (supports_cascadelake()) {
+        if (supports_icelake_server()) {
+            return std::make_unique<Avx512VpopcntdqAccelrator>();
+        }
+        return std::make_unique<Avx512VnniAccelrator>();
+    }
     if (__builtin_cpu_supports("avx512f")) {
         return std::make_unique<Avx512Accelrator>();
     }
     if (__builtin_cpu_supports("avx2")) {
         return std::make_unique<Avx2Accelrator>();
     }
+#endif
+#ifdef __aarch64__
+    // NEON is mandatory on aarch64.
+    return std::make_unique<NeonAccelrator>();
 #endif
     return std::make_unique<GenericAccelrator>();
 }
@@ -39,7 +73,7 @@ std::vector<T> createAndFill(size_t sz) {
     return v;
 }
 
-template<typename T>
+template<typename T, typename SumT = T>
 void
 verifyDotproduct(const IAccelrated & accel)
 {
@@ -48,11 +82,11 @@ verifyDotproduct(const IAccelrated & accel)
     std::vector<T> a = createAndFill<T>(testLength);
     std::vector<T> b = createAndFill<T>(testLength);
     for (size_t j(0); j < 0x20; j++) {
-        T sum(0);
+        SumT sum(0);
         for (size_t i(j); i < testLength; i++) {
-            sum += a[i]*b[i];
+            sum += SumT(a[i])*SumT(b[i]);
         }
-        T hwComputedSum(accel.dotProduct(&a[j], &b[j], testLength - j));
+        SumT hwComputedSum(accel.dotProduct(&a[j], &b[j], testLength - j));
         if (sum != hwComputedSum) {
             fprintf(stderr, "Accelrator is not computing dotproduct correctly.\n");
             LOG_ABORT("should not be reached");
@@ -60,7 +94,7 @@ verifyDotproduct(const IAccelrated & accel)
     }
 }
 
-template<typename T>
+template<typename T, typename SumT = T>
 void
 verifyEuclideanDistance(const IAccelrated & accel) {
     const size_t testLength(255);
@@ -68,11 +102,11 @@ verifyEuclideanDistance(const IAccelrated & accel) {
     std::vector<T> a = createAndFill<T>(testLength);
     std::vector<T> b = createAndFill<T>(testLength);
     for (size_t j(0); j < 0x20; j++) {
-        T sum(0);
+        SumT sum(0);
         for (size_t i(j); i < testLength; i++) {
-            sum += (a[i] - b[i]) * (a[i] - b[i]);
+            sum += (SumT(a[i]) - SumT(b[i])) * (SumT(a[i]) - SumT(b[i]));
         }
-        T hwComputedSum(accel.squaredEuclideanDistance(&a[j], &b[j], testLength - j));
+        SumT hwComputedSum(accel.squaredEuclideanDistance(&a[j], &b[j], testLength - j));
         if (sum != hwComputedSum) {
             fprintf(stderr, "Accelrator is not computing euclidean distance correctly.\n");
             LOG_ABORT("should not be reached");
@@ -98,6 +132,28 @@ verifyPopulationCount(const IAccelrated & accel)
     }
 }
 
+void
+verifyBinaryHammingDistance(const IAccelrated & accel)
+{
+    const size_t testLength(300);
+    srand(1);
+    std::vector<uint8_t> a = createAndFill<uint8_t>(testLength);
+    std::vector<uint8_t> b = createAndFill<uint8_t>(testLength);
+    for (size_t j(0); j < 0x20; j++) {
+        for (size_t sz : {testLength - j, size_t(64), size_t(128), size_t(256)}) {
+            size_t expected(0);
+            for (size_t i(j); i < j + sz; i++) {
+                expected += __builtin_popcount(a[i] ^ b[i]);
+            }
+            size_t hwComputed = accel.binaryHammingDistance(&a[j], &b[j], sz);
+            if (hwComputed != expected) {
+                fprintf(stderr, "Accelrator is not computing binaryHammingDistance correctly. Expected %zu, computed %zu\n", expected, hwComputed);
+                LOG_ABORT("should not be reached");
+            }
+        }
+    }
+}
+
 void
 fill(std::vector<uint64_t> & v, size_t n) {
     v.reserve(n);
@@ -218,11 +274,14 @@ private:
     void verify(const IAccelrated & accelrated) {
         verifyDotproduct<float>(accelrated);
         verifyDotproduct<double>(accelrated);
+        verifyDotproduct<int8_t, int64_t>(accelrated);
         verifyDotproduct<int32_t>(accelrated);
         verifyDotproduct<int64_t>(accelrated);
         verifyEuclideanDistance<float>(accelrated);
         verifyEuclideanDistance<double>(accelrated);
+        verifyEuclideanDistance<int8_t, double>(accelrated);
         verifyPopulationCount(accelrated);
+        verifyBinaryHammingDistance(accelrated);
         verifyAnd64(accelrated);
         verifyOr64(accelrated);
     }
@@ -248,4 +307,30 @@ IAccelrated::getAccelerator()
     return *accelrator;
 }
 
+std::vector<std::pair<const char *, IAccelrated::UP>>
+IAccelrated::create_supported_accelerators()
+{
+    std::vector<std::pair<const char *, IAccelrated::UP>> result;
+    result.emplace_back("generic", std::make_unique<GenericAccelrator>());
+#ifdef __x86_64__
+    __builtin_cpu_init();
+    if (__builtin_cpu_supports("avx2")) {
+        result.emplace_back("avx2", std::make_unique<Avx2Accelrator>());
+    }
+    if (__builtin_cpu_supports("avx512f")) {
+        result.emplace_back("avx512", std::make_unique<Avx512Accelrator>());
+    }
+    if (supports_cascadelake()) {
+        result.emplace_back("avx512-vnni", std::make_unique<Avx512VnniAccelrator>());
+        if (supports_icelake_server()) {
+            result.emplace_back("avx512-vpopcntdq", std::make_unique<Avx512VpopcntdqAccelrator>());
+        }
+    }
+#endif
+#ifdef __aarch64__
+    result.emplace_back("neon", std::make_unique<NeonAccelrator>());
+#endif
+    return result;
+}
+
 }
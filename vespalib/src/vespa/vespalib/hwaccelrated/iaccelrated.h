@@ -28,6 +28,8 @@ public:
     virtual void andNotBit(void * a, const void * b, size_t bytes) const noexcept = 0;
     virtual void notBit(void * a, size_t bytes) const noexcept = 0;
     virtual size_t populationCount(const uint64_t *a, size_t sz) const noexcept = 0;
+    // Number of differing bits between two blobs of sz bytes, no alignment required
+    virtual size_t binaryHammingDistance(const void * a, const void * b, size_t sz) const noexcept = 0;
     virtual double squaredEuclideanDistance(const int8_t * a, const int8_t * b, size_t sz) const noexcept = 0;
     virtual double squaredEuclideanDistance(const float * a, const float * b, size_t sz) const noexcept = 0;
     virtual double squaredEuclideanDistance(const double * a, const double * b, size_t sz) const noexcept = 0;
@@ -37,6 +39,8 @@ public:
     virtual void or128(size_t offset, const std::vector<std::pair<const void *, bool>> &src, void *dest) const noexcept = 0;
 
     static const IAccelrated & getAccelerator() __attribute__((noinline));
+    // All implementations supported by this cpu, starting with the generic one. Used for benchmarking.
+    static std::vector<std::pair<const char *, UP>> create_supported_accelerators();
 };
 
 }
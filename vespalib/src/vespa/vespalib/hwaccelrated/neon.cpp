@@ -0,0 +1,183 @@
+// Copyright Vespa.ai. Licensed under the terms of the Apache 2.0 license. See LICENSE in the project root.
+
+#include "neon.h"
+#include <arm_neon.h>
+#include <algorithm>
+
+namespace vespalib::hwaccelrated {
+
+namespace {
+
+// Number of 16 cell iterations before the 32-bit int8 accumulators are summed into a 64-bit result.
+// Each lane gets at most 4 * 255 * 255 added per iteration.
+constexpr size_t INT8_ITERATIONS_PER_BLOCK = 4096;
+
+// Number of 64 byte iterations before the 16-bit hamming accumulators are summed into a 64-bit result.
+// Each lane gets at most 2 * 32 added per iteration.
+constexpr size_t HAMMING_ITERATIONS_PER_BLOCK = 1023;
+
+inline uint8x16_t
+xor_popcount(const uint8_t * a, const uint8_t * b) noexcept {
+    return vcntq_u8(veorq_u8(vld1q_u8(a), vld1q_u8(b)));
+}
+
+template <typename Accumulate>
+int64_t
+compute_int8(const int8_t * a, const int8_t * b, size_t sz, Accumulate accumulate) noexcept {
+    int64_t sum(0);
+    size_t i(0);
+    const size_t vector_end = sz - (sz % 16);
+    while (i < vector_end) {
+        int32x4_t acc = vdupq_n_s32(0);
+        size_t block_end = std::min(vector_end, i + INT8_ITERATIONS_PER_BLOCK * 16);
+        for (; i < block_end; i += 16) {
+            acc = accumulate(acc, vld1q_s8(a + i), vld1q_s8(b + i));
+        }
+        sum += vaddlvq_s32(acc);
+    }
+    return sum;
+}
+
+}
+
+float
+NeonAccelrator::dotProduct(const float * a, const float * b, size_t sz) const noexcept {
+    float32x4_t acc0 = vdupq_n_f32(0.0f);
+    float32x4_t acc1 = vdupq_n_f32(0.0f);
+    size_t i(0);
+    for (; i + 8 <= sz; i += 8) {
+        acc0 = vfmaq_f32(acc0, vld1q_f32(a + i), vld1q_f32(b + i));
+        acc1 = vfmaq_f32(acc1, vld1q_f32(a + i + 4), vld1q_f32(b + i + 4));
+    }
+    float sum = vaddvq_f32(vaddq_f32(acc0, acc1));
+    for (; i < sz; ++i) {
+        sum += a[i] * b[i];
+    }
+    return sum;
+}
+
+double
+NeonAccelrator::dotProduct(const double * a, const double * b, size_t sz) const noexcept {
+    float64x2_t acc0 = vdupq_n_f64(0.0);
+    float64x2_t acc1 = vdupq_n_f64(0.0);
+    size_t i(0);
+    for (; i + 4 <= sz; i += 4) {
+        acc0 = vfmaq_f64(acc0, vld1q_f64(a + i), vld1q_f64(b + i));
+        acc1 = vfmaq_f64(acc1, vld1q_f64(a + i + 2), vld1q_f64(b + i + 2));
+    }
+    double sum = vaddvq_f64(vaddq_f64(acc0, acc1));
+    for (; i < sz; ++i) {
+        sum += a[i] * b[i];
+    }
+    return sum;
+}
+
+int64_t
+NeonAccelrator::dotProduct(const int8_t * a, const int8_t * b, size_t sz) const noexcept {
+    int64_t sum = compute_int8(a, b, sz, [](int32x4_t acc, int8x16_t x, int8x16_t y) noexcept {
+        acc = vpadalq_s16(acc, vmull_s8(vget_low_s8(x), vget_low_s8(y)));
+        return vpadalq_s16(acc, vmull_high_s8(x, y));
+    });
+    for (size_t i = sz - (sz % 16); i < sz; ++i) {
+        sum += int64_t(a[i]) * int64_t(b[i]);
+    }
+    return sum;
+}
+
+double
+NeonAccelrator::squaredEuclideanDistance(const int8_t * a, const int8_t * b, size_t sz) const noexcept {
+    int64_t sum = compute_int8(a, b, sz, [](int32x4_t acc, int8x16_t x, int8x16_t y) noexcept {
+        int16x8_t diff_low = vsubl_s8(vget_low_s8(x), vget_low_s8(y));
+        int16x8_t diff_high = vsubl_high_s8(x, y);
+        acc = vmlal_s16(acc, vget_low_s16(diff_low), vget_low_s16(diff_low));
+        acc = vmlal_high_s16(acc, diff_low, diff_low);
+        acc = vmlal_s16(acc, vget_low_s16(diff_high), vget_low_s16(diff_high));
+        return vmlal_high_s16(acc, diff_high, diff_high);
+    });
+    for (size_t i = sz - (sz % 16); i < sz; ++i) {
+        int64_t diff = int64_t(a[i]) - int64_t(b[i]);
+        sum += diff * diff;
+    }
+    return sum;
+}
+
+double
+NeonAccelrator::squaredEuclideanDistance(const float * a, const float * b, size_t sz) const noexcept {
+    float32x4_t acc0 = vdupq_n_f32(0.0f);
+    float32x4_t acc1 = vdupq_n_f32(0.0f);
+    size_t i(0);
+    for (; i + 8 <= sz; i += 8) {
+        float32x4_t d0 = vsubq_f32(vld1q_f32(a + i), vld1q_f32(b + i));
+        float32x4_t d1 = vsubq_f32(vld1q_f32(a + i + 4), vld1q_f32(b + i + 4));
+        acc0 = vfmaq_f32(acc0, d0, d0);
+        acc1 = vfmaq_f32(acc1, d1, d1);
+    }
+    double sum = vaddvq_f32(vaddq_f32(acc0, acc1));
+    for (; i < sz; ++i) {
+        double diff = a[i] - b[i];
+        sum += diff * diff;
+    }
+    return sum;
+}
+
+double
+NeonAccelrator::squaredEuclideanDistance(const double * a, const double * b, size_t sz) const noexcept {
+    float64x2_t acc0 = vdupq_n_f64(0.0);
+    float64x2_t acc1 = vdupq_n_f64(0.0);
+    size_t i(0);
+    for (; i + 4 <= sz; i += 4) {
+        float64x2_t d0 = vsubq_f64(vld1q_f64(a + i), vld1q_f64(b + i));
+        float64x2_t d1 = vsubq_f64(vld1q_f64(a + i + 2), vld1q_f64(b + i + 2));
+        acc0 = vfmaq_f64(acc0, d0, d0);
+        acc1 = vfmaq_f64(acc1, d1, d1);
+    }
+    double sum = vaddvq_f64(vaddq_f64(acc0, acc1));
+    for (; i < sz; ++i) {
+        double diff = a[i] - b[i];
+        sum += diff * diff;
+    }
+    return sum;
+}
+
+size_t
+NeonAccelrator::populationCount(const uint64_t *a, size_t sz) const noexcept {
+    size_t count(0);
+    size_t i(0);
+    for (; i + 2 <= sz; i += 2) {
+        // At most 128 bits are set, which fits in the 8-bit horizontal sum.
+        count += vaddvq_u8(vcntq_u8(vld1q_u8(reinterpret_cast<const uint8_t *>(a + i))));
+    }
+    for (; i < sz; ++i) {
+        count += __builtin_popcountl(a[i]);
+    }
+    return count;
+}
+
+size_t
+NeonAccelrator::binaryHammingDistance(const void * lhs, const void * rhs, size_t sz) const noexcept {
+    const auto * a = static_cast<const uint8_t *>(lhs);
+    const auto * b = static_cast<const uint8_t *>(rhs);
+    size_t sum(0);
+    size_t i(0);
+    const size_t vector_end = sz - (sz % 64);
+    while (i < vector_end) {
+        uint16x8_t acc = vdupq_n_u16(0);
+        size_t block_end = std::min(vector_end, i + HAMMING_ITERATIONS_PER_BLOCK * 64);
+        for (; i < block_end; i += 64) {
+            uint8x16_t c01 = vaddq_u8(xor_popcount(a + i, b + i), xor_popcount(a + i + 16, b + i + 16));
+            uint8x16_t c23 = vaddq_u8(xor_popcount(a + i + 32, b + i + 32), xor_popcount(a + i + 48, b + i + 48));
+            acc = vpadalq_u8(acc, vaddq_u8(c01, c23));
+        }
+        sum += vaddlvq_u16(acc);
+    }
+    for (; i + 16 <= sz; i += 16) {
+        // At most 128 bits differ, which fits in the 8-bit horizontal sum.
+        sum += vaddvq_u8(xor_popcount(a + i, b + i));
+    }
+    for (; i < sz; ++i) {
+        sum += __builtin_popcount(a[i] ^ b[i]);
+    }
+    return sum;
+}
+
+}
@@ -24,6 +24,42 @@ populationCount(const uint64_t *a, size_t sz) {
     return count;
 }
 
+template <size_t NumWords>
+inline size_t
+binaryHammingDistanceWords(const uint8_t *a, const uint8_t *b) noexcept {
+    size_t sum(0);
+    for (size_t i(0); i < NumWords; i++) {
+        uint64_t x, y;
+        memcpy(&x, a + i * sizeof(uint64_t), sizeof(uint64_t));
+        memcpy(&y, b + i * sizeof(uint64_t), sizeof(uint64_t));
+        sum += Optimized::popCount(x ^ y);
+    }
+    return sum;
+}
+
+inline size_t
+binaryHammingDistance(const void *lhs, const void *rhs, size_t sz) noexcept {
+    const auto *a = static_cast<const uint8_t *>(lhs);
+    const auto *b = static_cast<const uint8_t *>(rhs);
+    // Common binary embedding sizes (512, 1024 and 2048 bits) get fully unrolled loops.
+    switch (sz) {
+    case 64:  return binaryHammingDistanceWords<8>(a, b);
+    case 128: return binaryHammingDistanceWords<16>(a, b);
+    case 256: return binaryHammingDistanceWords<32>(a, b);
+    default: break;
+    }
+    size_t numWords = sz / sizeof(uint64_t);
+    size_t sum(0);
+    size_t i(0);
+    for (; i < numWords; i++) {
+        sum += binaryHammingDistanceWords<1>(a + i * sizeof(uint64_t), b + i * sizeof(uint64_t));
+    }
+    for (i *= sizeof(uint64_t); i < sz; i++) {
+        sum += Optimized::popCount(static_cast<unsigned int>(a[i] ^ b[i]));
+    }
+    return sum;
+}
+
 template<typename T, unsigned ChunkSize>
 T get(const void * base, bool invert) {
     static_assert(sizeof(T) == ChunkSize, "sizeof(T) == ChunkSize");
@@ -0,0 +1,147 @@
+// Copyright Vespa.ai. Licensed under the terms of the Apache 2.0 license. See LICENSE in the project root.
+
+#include "batch_pread.h"
+#include <vespa/config.h>
+#include <algorithm>
+#include <cerrno>
+#include <memory>
+#include <unistd.h>
+
+#ifdef VESPA_HAS_IO_URING
+#include <vespa/vespalib/util/require.h>
+#include <liburing.h>
+#include <cstdlib>
+#endif
+
+namespace vespalib {
+
+namespace {
+
+// Read until len bytes are read or end of file is reached.
+ssize_t
+pread_fully(int fd, char *buf, size_t len, uint64_t offset, size_t done)
+{
+    while (done < len) {
+        ssize_t res = ::pread(fd, buf + done, len - done, offset + done);
+        if (res > 0) {
+            done += res;
+        } else if (res == 0) {
+            break;
+        } else if (errno != EINTR) {
+            return (done > 0) ? ssize_t(done) : -errno;
+        }
+    }
+    return done;
+}
+
+void
+complete(BatchPread::Request &req, size_t done)
+{
+    req.result = pread_fully(req.fd, static_cast<char *>(req.buf), req.len, req.offset, done);
+}
+
+#ifdef VESPA_HAS_IO_URING
+
+constexpr unsigned int QUEUE_DEPTH = 128;
+
+bool check_support() {
+    io_uring_probe *probe = io_uring_get_probe();
+    bool supported = (probe != nullptr) && io_uring_opcode_supported(probe, IORING_OP_READ);
+    free(probe);
+    return supported;
+}
+
+struct Ring {
+    io_uring uring;
+    bool     valid;
+    Ring() : valid(io_uring_queue_init(QUEUE_DEPTH, &uring, 0) == 0) {}
+    ~Ring() {
+        if (valid) {
+            io_uring_queue_exit(&uring);
+        }
+    }
+    Ring(const Ring &) = delete;
+    Ring &operator=(const Ring &) = delete;
+
+    void read(std::span<BatchPread::Request> requests) {
+        size_t submitted = 0;
+        for (auto &req: requests) {
+            io_uring_sqe *sqe = io_uring_get_sqe(&uring);
+            REQUIRE(sqe != nullptr);
+            io_uring_prep_read(sqe, req.fd, req.buf, req.len, req.offset);
+            io_uring_sqe_set_data(sqe, &req);
+            ++submitted;
+        }
+        int res = io_uring_submit_and_wait(&uring, submitted);
+        REQUIRE(res >= 0);
+        for (size_t completed = 0; completed < submitted; ++completed) {
+            io_uring_cqe *cqe = nullptr;
+            int wait_res;
+            while ((wait_res = io_uring_wait_cqe(&uring, &cqe)) == -EINTR) { }
+            REQUIRE_EQ(wait_res, 0);
+            auto &req = *static_cast<BatchPread::Request *>(io_uring_cqe_get_data(cqe));
+            req.result = cqe->res;
+            io_uring_cqe_seen(&uring, cqe);
+        }
+        for (auto &req: requests) {
+            // short reads and errors are retried with pread to get
+            // the same result as without io_uring
+            if ((req.result < 0) || ((req.result > 0) && (size_t(req.result) < req.len))) {
+                complete(req, (req.result > 0) ? req.result : 0);
+            }
+        }
+    }
+};
+
+bool uring_supported() {
+    static const bool supported = check_support();
+    return supported;
+}
+
+thread_local std::unique_ptr<Ring> _tlRing;
+
+Ring *
+get_ring()
+{
+    if ( ! uring_supported()) {
+        return nullptr;
+    }
+    if ( ! _tlRing) {
+        _tlRing = std::make_unique<Ring>();
+    }
+    return _tlRing->valid ? _tlRing.get() : nullptr;
+}
+
+#endif
+
+}
+
+void
+BatchPread::read(std::span<Request> requests)
+{
+#ifdef VESPA_HAS_IO_URING
+    if (requests.size() > 1) {
+        if (Ring *ring = get_ring()) {
+            for (size_t i = 0; i < requests.size(); i += QUEUE_DEPTH) {
+                ring->read(requests.subspan(i, std::min(size_t(QUEUE_DEPTH), requests.size() - i)));
+            }
+            return;
+        }
+    }
+#endif
+    for (auto &req: requests) {
+        complete(req, 0);
+    }
+}
+
+bool
+BatchPread::uses_io_uring()
+{
+#ifdef VESPA_HAS_IO_URING
+    return uring_supported();
+#else
+    return false;
+#endif
+}
+
+}
@@ -0,0 +1,41 @@
+// Copyright Vespa.ai. Licensed under the terms of the Apache 2.0 license. See LICENSE in the project root.
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <span>
+#include <sys/types.h>
+
+namespace vespalib {
+
+/**
+ * Performs a batch of positional reads and returns when all of them
+ * are done. When io_uring is available all reads in the batch are
+ * submitted to the kernel at once and waited for together, so the
+ * latency of a batch on a device with deep queues is close to the
+ * latency of a single read instead of the sum of them. Otherwise (not
+ * compiled in, or not supported by the running kernel) the reads are
+ * performed one by one with pread.
+ *
+ * Each thread uses its own ring, so no locking is needed.
+ **/
+class BatchPread
+{
+public:
+    struct Request {
+        int      fd;
+        void    *buf;
+        size_t   len;
+        uint64_t offset;
+        // bytes read (less than len only at end of file) or -errno
+        ssize_t  result;
+        Request(int fd_in, void *buf_in, size_t len_in, uint64_t offset_in) noexcept
+            : fd(fd_in), buf(buf_in), len(len_in), offset(offset_in), result(0)
+        {}
+    };
+    static void read(std::span<Request> requests);
+    static bool uses_io_uring();
+};
+
+}
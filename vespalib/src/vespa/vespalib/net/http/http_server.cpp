@@ -3,24 +3,152 @@
 #include "http_server.h"
 #include <vespa/vespalib/net/crypto_engine.h>
 #include <vespa/vespalib/net/connection_auth_context.h>
+#include <vespa/vespalib/stllike/asciistream.h>
+#include <vespa/vespalib/stllike/hash_fun.h>
+#include <vespa/vespalib/util/stringfmt.h>
+#include <cinttypes>
+#include <zlib.h>
 
 namespace vespalib {
 
+namespace {
+
+vespalib::string make_etag(vespalib::stringref payload) {
+    return make_string("%016" PRIx64, xxhash::xxh3_64(payload.data(), payload.size()));
+}
+
+bool etag_matches(const vespalib::string &if_none_match, const vespalib::string &etag) {
+    return (if_none_match == "*") || (if_none_match.find("\"" + etag + "\"") != vespalib::string::npos);
+}
+
+// Smaller payloads are not worth compressing
+constexpr size_t gzip_min_size = 1024;
+
+// Limits the number of distinct requests with cached responses
+constexpr size_t max_cache_entries = 256;
+
+bool accepts_gzip(const vespalib::string &accept_encoding) {
+    return (accept_encoding.find("gzip") != vespalib::string::npos);
+}
+
+// Returns an empty string if compression fails
+vespalib::string gzip_compress(vespalib::stringref payload) {
+    z_stream stream = {};
+    // 15 window bits, +16 to get a gzip header and trailer
+    if (deflateInit2(&stream, Z_DEFAULT_COMPRESSION, Z_DEFLATED, 15 + 16, 8, Z_DEFAULT_STRATEGY) != Z_OK) {
+        return {};
+    }
+    vespalib::string result;
+    result.resize(deflateBound(&stream, payload.size()));
+    stream.next_in = reinterpret_cast<Bytef *>(const_cast<char *>(payload.data()));
+    stream.avail_in = payload.size();
+    stream.next_out = reinterpret_cast<Bytef *>(&result[0]);
+    stream.avail_out = result.size();
+    bool ok = (deflate(&stream, Z_FINISH) == Z_STREAM_END);
+    result.resize(ok ? stream.total_out : 0);
+    deflateEnd(&stream);
+    return result;
+}
+
+} // namespace vespalib::<unnamed>
+
+struct HttpServer::CachedResponse {
+    std::mutex       lock; // held while rendering, compressing and responding
+    steady_time      expires;
+    vespalib::string payload;
+    vespalib::string etag;
+    vespalib::string gzip_payload; // compressed on first request accepting it
+    CachedResponse() : lock(), expires(), payload(), etag(), gzip_payload() {}
+};
+
+std::shared_ptr<HttpServer::CachedResponse>
+HttpServer::get_cache_entry(const Portal::GetRequest &req)
+{
+    std::lock_guard guard(_cache_lock);
+    if (_cache_ttl == duration::zero()) {
+        return {};
+    }
+    // Handlers check the peer capabilities, so responses are only shared between peers having the same ones
+    asciistream key;
+    key << req.get_host() << '\n' << req.get_path() << '\n' << req.auth_context().capabilities().to_string();
+    for (const auto &[name, value] : req.export_params()) {
+        key << '\n' << name << '=' << value;
+    }
+    auto pos = _cache.find(key.str());
+    if (pos != _cache.end()) {
+        return pos->second;
+    }
+    if (_cache.size() >= max_cache_entries) {
+        steady_time now = steady_clock::now();
+        std::erase_if(_cache, [now](const auto &entry) noexcept {
+            return (entry.second.use_count() == 1) && (entry.second->expires <= now);
+        });
+        if (_cache.size() >= max_cache_entries) {
+            return {};
+        }
+    }
+    auto entry = std::make_shared<CachedResponse>();
+    _cache.emplace(key.str(), entry);
+    return entry;
+}
+
 void
 HttpServer::get(Portal::GetRequest req)
 {
-    auto response = _handler_repo.get(req.get_host(), req.get_path(), req.export_params(), req.auth_context());
-    if (response.failed()) {
-        req.respond_with_error(response.status_code(), response.status_message());
+    CachedResponse uncached;
+    auto cached = get_cache_entry(req);
+    CachedResponse &res = cached ? *cached : uncached;
+    std::lock_guard guard(res.lock);
+    steady_time now = steady_clock::now();
+    if (!cached || (res.expires <= now)) {
+        auto response = _handler_repo.get(req.get_host(), req.get_path(), req.export_params(), req.auth_context());
+        if (response.failed()) {
+            req.respond_with_error(response.status_code(), response.status_message());
+            return;
+        }
+        res.payload = response.payload();
+        res.etag = make_etag(res.payload);
+        res.gzip_payload.clear();
+        res.expires = now + _cache_ttl;
+    }
+    vespalib::stringref content = res.payload;
+    vespalib::string etag = res.etag;
+    vespalib::stringref content_encoding;
+    if ((res.payload.size() >= gzip_min_size) && accepts_gzip(req.get_header("accept-encoding"))) {
+        if (res.gzip_payload.empty()) {
+            res.gzip_payload = gzip_compress(res.payload);
+        }
+        if (!res.gzip_payload.empty()) {
+            content = res.gzip_payload;
+            // each representation needs its own entity tag
+            etag += "-gzip";
+            content_encoding = "gzip";
+        }
+    }
+    // Scrapers polling more often than the underlying state changes (e.g. the
+    // metric snapshot period) can revalidate instead of fetching it again.
+    if (etag_matches(req.get_header("if-none-match"), etag)) {
+        req.respond_not_modified(etag);
     } else {
-        req.respond_with_content("application/json", response.payload());
+        req.respond_with_content("application/json", content, etag, content_encoding);
     }
 }
 
+void
+HttpServer::set_response_cache_ttl(duration ttl)
+{
+    std::lock_guard guard(_cache_lock);
+    _cache_ttl = ttl;
+    _cache.clear();
+}
+
 //-----------------------------------------------------------------------------
 
 HttpServer::HttpServer(int port_in)
     : _handler_repo(),
+      _cache_lock(),
+      _cache_ttl(duration::zero()),
+      _cache(),
       _server(Portal::create(CryptoEngine::get_default(), port_in)),
       _root(_server->bind("/", *this))
 {
@@ -3,7 +3,10 @@
 #pragma once
 
 #include <vespa/vespalib/portal/portal.h>
+#include <vespa/vespalib/util/time.h>
 #include "json_handler_repo.h"
+#include <map>
+#include <mutex>
 
 namespace vespalib {
 
@@ -13,15 +16,27 @@ namespace vespalib {
  * a specific port to the constructor or use 0 to bind to a random
  * port. Note that you may not ask about the actual port until after
  * the server has been started. Request dispatching is done using a
- * JsonHandlerRepo.
+ * JsonHandlerRepo. Responses are tagged with an ETag derived from the
+ * payload, and conditional requests for unchanged content get a 304
+ * response without payload. Larger responses are gzip encoded for
+ * clients accepting it. Rendered responses may be cached for a short
+ * while, so that many clients polling the same resource (e.g. metrics
+ * scrapers) share the work of rendering and compressing it.
  **/
 class HttpServer : public Portal::GetHandler
 {
 private:
+    struct CachedResponse;
+    using CacheMap = std::map<vespalib::string, std::shared_ptr<CachedResponse>>;
+
     JsonHandlerRepo _handler_repo;
+    std::mutex _cache_lock;
+    duration _cache_ttl;
+    CacheMap _cache;
     Portal::SP _server;
     Portal::Token::UP _root;
 
+    std::shared_ptr<CachedResponse> get_cache_entry(const Portal::GetRequest &req);
     void get(Portal::GetRequest req) override;
 public:
     using UP = std::unique_ptr<HttpServer>;
@@ -30,6 +45,9 @@ public:
     const vespalib::string &host() const { return _server->my_host(); }
     JsonHandlerRepo &repo() { return _handler_repo; }
     int port() const { return _server->listen_port(); }
+    // Successful responses are reused for identical requests (same host, path,
+    // parameters and peer capabilities) for 'ttl'; zero (the default) disables caching.
+    void set_response_cache_ttl(duration ttl);
 };
 
 } // namespace vespalib
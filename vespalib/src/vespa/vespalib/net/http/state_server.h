@@ -29,6 +29,8 @@ public:
     ~StateServer();
     int getListenPort() { return _server.port(); }
     JsonHandlerRepo &repo() { return _api.repo(); }
+    // See HttpServer::set_response_cache_ttl
+    void set_response_cache_ttl(duration ttl) { _server.set_response_cache_ttl(ttl); }
 };
 
 } // namespace vespalib
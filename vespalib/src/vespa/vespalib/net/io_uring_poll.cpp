@@ -0,0 +1,206 @@
+// Copyright Vespa.ai. Licensed under the terms of the Apache 2.0 license. See LICENSE in the project root.
+
+#include "io_uring_poll.h"
+#include <vespa/config.h>
+#include <cstdlib>
+
+#ifdef VESPA_HAS_IO_URING
+#include <vespa/vespalib/util/require.h>
+#include <liburing.h>
+#include <poll.h>
+#include <sys/epoll.h>
+#include <vector>
+#endif
+
+namespace vespalib {
+
+#ifdef VESPA_HAS_IO_URING
+
+namespace {
+
+constexpr unsigned int QUEUE_DEPTH = 4096;
+constexpr uint64_t IGNORED = ~uint64_t(0);
+
+uint32_t maybe(uint32_t value, bool yes) { return yes ? value : 0; }
+
+}
+
+struct IoUringPoll::Impl {
+    // Poll state for a single file descriptor, indexed by the file
+    // descriptor itself. The generation is part of the user data of
+    // each poll request, so that completions for requests that have
+    // been replaced or removed can be recognized and ignored.
+    struct Slot {
+        void    *ctx = nullptr;
+        uint32_t events = 0;
+        uint32_t armed_events = 0;
+        uint32_t generation = 0;
+        bool     in_use = false;
+        bool     armed = false;
+    };
+    io_uring          uring;
+    std::vector<Slot> slots;
+    std::vector<int>  rearm;
+
+    Impl() : uring(), slots(), rearm() {
+        int res = io_uring_queue_init(QUEUE_DEPTH, &uring, 0);
+        REQUIRE_EQ(res, 0);
+    }
+    ~Impl() {
+        io_uring_queue_exit(&uring);
+    }
+    static uint64_t token(int fd, uint32_t generation) {
+        return (uint64_t(generation) << 32) | uint32_t(fd);
+    }
+    io_uring_sqe *get_sqe() {
+        io_uring_sqe *sqe = io_uring_get_sqe(&uring);
+        while (sqe == nullptr) {
+            int res = io_uring_submit(&uring);
+            REQUIRE(res >= 0);
+            sqe = io_uring_get_sqe(&uring);
+        }
+        return sqe;
+    }
+    Slot &slot(int fd) {
+        if (size_t(fd) >= slots.size()) {
+            slots.resize(fd + 1);
+        }
+        return slots[fd];
+    }
+    void arm(int fd) {
+        Slot &s = slots[fd];
+        if (s.in_use && !s.armed && (s.events != 0)) {
+            io_uring_sqe *sqe = get_sqe();
+            io_uring_prep_poll_add(sqe, fd, s.events);
+            io_uring_sqe_set_data64(sqe, token(fd, s.generation));
+            s.armed = true;
+            s.armed_events = s.events;
+        }
+    }
+    void disarm(int fd) {
+        Slot &s = slots[fd];
+        if (s.armed) {
+            io_uring_sqe *sqe = get_sqe();
+            // the request to remove is identified by its user data (passed as addr)
+            io_uring_prep_rw(IORING_OP_POLL_REMOVE, sqe, -1, nullptr, 0, 0);
+            sqe->addr = token(fd, s.generation);
+            io_uring_sqe_set_data64(sqe, IGNORED);
+            s.armed = false;
+        }
+        ++s.generation;
+    }
+    void set(int fd, void *ctx, bool read, bool write) {
+        Slot &s = slot(fd);
+        s.in_use = true;
+        s.ctx = ctx;
+        s.events = maybe(POLLIN, read) | maybe(POLLOUT, write);
+        if (s.armed && (s.armed_events != s.events)) {
+            disarm(fd);
+        }
+        arm(fd);
+    }
+    size_t wait(epoll_event *events, size_t max_events, int timeout_ms) {
+        for (int fd: rearm) {
+            arm(fd);
+        }
+        rearm.clear();
+        io_uring_cqe *cqe = nullptr;
+        __kernel_timespec ts;
+        ts.tv_sec = timeout_ms / 1000;
+        ts.tv_nsec = (timeout_ms % 1000) * 1000000L;
+        int res = io_uring_submit_and_wait_timeout(&uring, &cqe, 1, (timeout_ms < 0) ? nullptr : &ts, nullptr);
+        REQUIRE((res >= 0) || (res == -ETIME) || (res == -EINTR));
+        size_t num_events = 0;
+        while ((num_events < max_events) && (io_uring_peek_cqe(&uring, &cqe) == 0)) {
+            uint64_t data = io_uring_cqe_get_data64(cqe);
+            int result = cqe->res;
+            io_uring_cqe_seen(&uring, cqe);
+            if (data == IGNORED) {
+                continue;
+            }
+            int fd = int(uint32_t(data));
+            uint32_t generation = uint32_t(data >> 32);
+            Slot &s = slots[fd];
+            if (!s.in_use || !s.armed || (s.generation != generation)) {
+                continue; // stale completion for a replaced or removed request
+            }
+            s.armed = false;
+            if (result == -ECANCELED) {
+                arm(fd);
+                continue;
+            }
+            epoll_event &evt = events[num_events++];
+            evt.events = (result < 0) ? uint32_t(EPOLLERR) : uint32_t(result);
+            evt.data.ptr = s.ctx;
+            rearm.push_back(fd);
+        }
+        return num_events;
+    }
+};
+
+IoUringPoll::IoUringPoll()
+    : _impl(std::make_unique<Impl>())
+{
+}
+
+IoUringPoll::~IoUringPoll() = default;
+
+bool
+IoUringPoll::is_supported()
+{
+    static const bool supported = []() noexcept {
+        io_uring_probe *probe = io_uring_get_probe();
+        bool result = (probe != nullptr) &&
+                      io_uring_opcode_supported(probe, IORING_OP_POLL_ADD) &&
+                      io_uring_opcode_supported(probe, IORING_OP_POLL_REMOVE);
+        free(probe);
+        return result;
+    }();
+    return supported;
+}
+
+void
+IoUringPoll::add(int fd, void *ctx, bool read, bool write)
+{
+    _impl->set(fd, ctx, read, write);
+}
+
+void
+IoUringPoll::update(int fd, void *ctx, bool read, bool write)
+{
+    _impl->set(fd, ctx, read, write);
+}
+
+void
+IoUringPoll::remove(int fd)
+{
+    if ((size_t(fd) < _impl->slots.size()) && _impl->slots[fd].in_use) {
+        _impl->disarm(fd);
+        _impl->slots[fd].in_use = false;
+        // submit right away; a pending poll request keeps the file open
+        // and the caller is about to close the file descriptor
+        io_uring_submit(&_impl->uring);
+    }
+}
+
+size_t
+IoUringPoll::wait(epoll_event *events, size_t max_events, int timeout_ms)
+{
+    return _impl->wait(events, max_events, timeout_ms);
+}
+
+#else // VESPA_HAS_IO_URING
+
+struct IoUringPoll::Impl {};
+
+IoUringPoll::IoUringPoll() { abort(); }
+IoUringPoll::~IoUringPoll() = default;
+bool IoUringPoll::is_supported() { return false; }
+void IoUringPoll::add(int, void *, bool, bool) { abort(); }
+void IoUringPoll::update(int, void *, bool, bool) { abort(); }
+void IoUringPoll::remove(int) { abort(); }
+size_t IoUringPoll::wait(epoll_event *, size_t, int) { abort(); }
+
+#endif // VESPA_HAS_IO_URING
+
+}
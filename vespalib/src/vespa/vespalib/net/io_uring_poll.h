@@ -0,0 +1,40 @@
+// Copyright Vespa.ai. Licensed under the terms of the Apache 2.0 license. See LICENSE in the project root.
+
+#pragma once
+
+#include <cstddef>
+#include <memory>
+
+struct epoll_event;
+
+namespace vespalib {
+
+/**
+ * Drop-in alternative to the Epoll class that uses io_uring poll
+ * requests to detect readiness. Interest changes (add/update) are
+ * queued and submitted together with the next wait, so that all
+ * bookkeeping for one event loop iteration costs a single system
+ * call instead of one epoll_ctl per change. Readiness is level
+ * triggered like with epoll; each poll request is one-shot and is
+ * re-armed in the same batch after the event has been handled.
+ *
+ * Only available when built with liburing and when the running
+ * kernel supports the needed operations; check is_supported()
+ * before creating an instance.
+ **/
+class IoUringPoll
+{
+private:
+    struct Impl;
+    std::unique_ptr<Impl> _impl;
+public:
+    IoUringPoll();
+    ~IoUringPoll();
+    static bool is_supported();
+    void add(int fd, void *ctx, bool read, bool write);
+    void update(int fd, void *ctx, bool read, bool write);
+    void remove(int fd);
+    size_t wait(epoll_event *events, size_t max_events, int timeout_ms);
+};
+
+}
@@ -3,11 +3,13 @@
 #pragma once
 
 #include "wakeup_pipe.h"
+#include "io_uring_poll.h"
 #ifdef __APPLE__
 #include "emulated_epoll.h"
 #else
 #include "native_epoll.h"
 #endif
+#include <memory>
 #include <vector>
 
 namespace vespalib {
@@ -25,6 +27,9 @@ public:
     void extract(Epoll &epoll, int timeout_ms) {
         _num_events = epoll.wait(&_epoll_events[0], _epoll_events.size(), timeout_ms);
     }
+    void extract(IoUringPoll &uring, int timeout_ms) {
+        _num_events = uring.wait(&_epoll_events[0], _epoll_events.size(), timeout_ms);
+    }
     const epoll_event *begin() const { return &_epoll_events[0]; }
     const epoll_event *end() const { return &_epoll_events[_num_events]; }
     size_t size() const { return _num_events; }
@@ -33,27 +38,67 @@ public:
 //-----------------------------------------------------------------------------
 enum class SelectorDispatchResult {WAKEUP_CALLED, NO_WAKEUP};
 
+/**
+ * Events are obtained using epoll by default. If io_uring is
+ * requested (and supported by the platform), readiness is instead
+ * detected using io_uring poll requests, which batches all interest
+ * changes into the system call used to wait for events. Note that
+ * the io_uring variant must only be used by a single thread, and
+ * that changes take effect on the next call to poll.
+ **/
 template <typename Context>
 class Selector
 {
 private:
-    Epoll       _epoll;
-    WakeupPipe  _wakeup_pipe;
-    EpollEvents _events;
+    Epoll                        _epoll;
+    std::unique_ptr<IoUringPoll> _uring;
+    WakeupPipe                   _wakeup_pipe;
+    EpollEvents                  _events;
+
+    void add_fd(int fd, void *ctx, bool read, bool write) {
+        if (_uring) {
+            _uring->add(fd, ctx, read, write);
+        } else {
+            _epoll.add(fd, ctx, read, write);
+        }
+    }
 public:
-    Selector()
-        : _epoll(), _wakeup_pipe(), _events(4096)
+    Selector() : Selector(false) {}
+    explicit Selector(bool use_io_uring)
+        : _epoll(), _uring(), _wakeup_pipe(), _events(4096)
     {
-        _epoll.add(_wakeup_pipe.get_read_fd(), nullptr, true, false);
+        if (use_io_uring && IoUringPoll::is_supported()) {
+            _uring = std::make_unique<IoUringPoll>();
+        }
+        add_fd(_wakeup_pipe.get_read_fd(), nullptr, true, false);
     }
     ~Selector() {
-        _epoll.remove(_wakeup_pipe.get_read_fd());
+        remove(_wakeup_pipe.get_read_fd());
+    }
+    bool uses_io_uring() const { return bool(_uring); }
+    void add(int fd, Context &ctx, bool read, bool write) { add_fd(fd, &ctx, read, write); }
+    void update(int fd, Context &ctx, bool read, bool write) {
+        if (_uring) {
+            _uring->update(fd, &ctx, read, write);
+        } else {
+            _epoll.update(fd, &ctx, read, write);
+        }
+    }
+    void remove(int fd) {
+        if (_uring) {
+            _uring->remove(fd);
+        } else {
+            _epoll.remove(fd);
+        }
     }
-    void add(int fd, Context &ctx, bool read, bool write) { _epoll.add(fd, &ctx, read, write); }
-    void update(int fd, Context &ctx, bool read, bool write) { _epoll.update(fd, &ctx, read, write); }
-    void remove(int fd) { _epoll.remove(fd); }
     void wakeup() { _wakeup_pipe.write_token(); }
-    void poll(int timeout_ms) { _events.extract(_epoll, timeout_ms); }
+    void poll(int timeout_ms) {
+        if (_uring) {
+            _events.extract(*_uring, timeout_ms);
+        } else {
+            _events.extract(_epoll, timeout_ms);
+        }
+    }
     size_t num_events() const { return _events.size(); }
     template <typename Handler>
     SelectorDispatchResult dispatch(Handler &handler) {
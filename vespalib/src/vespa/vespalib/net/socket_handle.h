@@ -50,6 +50,7 @@ public:
     bool set_ipv6_only(bool value) { return SocketOptions::set_ipv6_only(_fd, value); }
     bool set_keepalive(bool value) { return SocketOptions::set_keepalive(_fd, value); }
     bool set_linger(bool enable, int value) { return SocketOptions::set_linger(_fd, enable, value); }
+    int get_incoming_cpu() const { return SocketOptions::get_incoming_cpu(_fd); }
 
     ssize_t read(char *buf, size_t len);
     ssize_t write(const char *buf, size_t len);
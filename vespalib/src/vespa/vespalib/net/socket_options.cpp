@@ -2,6 +2,7 @@
 
 #include "socket_options.h"
 
+#include <cstddef>
 #include <fcntl.h>
 #include <netinet/in.h>
 #include <netinet/tcp.h>
@@ -70,4 +71,37 @@ SocketOptions::set_linger(int fd, bool enable, int value)
     return (setsockopt(fd, SOL_SOCKET, SO_LINGER, &data, sizeof(data)) == 0);
 }
 
+uint32_t
+SocketOptions::get_smoothed_rtt_us(int fd)
+{
+#ifdef TCP_INFO
+    struct tcp_info info;
+    memset(&info, 0, sizeof(info));
+    socklen_t len = sizeof(info);
+    if ((getsockopt(fd, IPPROTO_TCP, TCP_INFO, &info, &len) == 0) &&
+        (len >= (offsetof(struct tcp_info, tcpi_rtt) + sizeof(info.tcpi_rtt))))
+    {
+        return info.tcpi_rtt;
+    }
+#else
+    (void) fd;
+#endif
+    return 0;
+}
+
+int
+SocketOptions::get_incoming_cpu(int fd)
+{
+#ifdef SO_INCOMING_CPU
+    int cpu = -1;
+    socklen_t len = sizeof(cpu);
+    if (getsockopt(fd, SOL_SOCKET, SO_INCOMING_CPU, &cpu, &len) == 0) {
+        return cpu;
+    }
+#else
+    (void) fd;
+#endif
+    return -1;
+}
+
 } // namespace vespalib
@@ -2,11 +2,22 @@
 
 #pragma once
 
+#include <cstdint>
+
 namespace vespalib {
 
 /**
  * Low-level functions used to adjust various socket related
  * options. Return values indicate success/failure.
+ *
+ * get_smoothed_rtt_us samples the round-trip time estimate the
+ * kernel keeps for a connected tcp socket (in microseconds); 0 is
+ * returned if it is not available.
+ *
+ * get_incoming_cpu returns the cpu that processed the last packet
+ * received on the socket, which is the cpu servicing the receive
+ * queue of the network interface; -1 is returned if it is not
+ * available.
  **/
 struct SocketOptions {
     static bool set_blocking(int fd, bool value);
@@ -15,6 +26,8 @@ struct SocketOptions {
     static bool set_ipv6_only(int fd, bool value);
     static bool set_keepalive(int fd, bool value);
     static bool set_linger(int fd, bool enable, int value);
+    static uint32_t get_smoothed_rtt_us(int fd);
+    static int get_incoming_cpu(int fd);
 };
 
 } // namespace vespalib
@@ -55,6 +55,7 @@ struct DecodeResult {
 
 struct TlsContext;
 struct PeerCredentials;
+struct KernelTlsKeys;
 
 // TODO move to different namespace, not dependent on TLS?
 
@@ -189,6 +190,22 @@ public:
      */
     [[nodiscard]] virtual CapabilitySet granted_capabilities() const noexcept = 0;
 
+    /**
+     * Exports the symmetric record protection state of an established session so that
+     * record encryption (tx, first argument) and decryption (rx, second argument)
+     * can be taken over by the kernel.
+     * Returns false if this is not possible for the codec, the negotiated protocol
+     * version or cipher, or if records have already been encoded or decoded by the
+     * codec itself. Key material is exported at most once.
+     *
+     * After a successful export, encode(), decode() and half_close() must not be called.
+     *
+     * Precondition: handshake must be completed
+     */
+    [[nodiscard]] virtual bool export_kernel_tls_keys(KernelTlsKeys&, KernelTlsKeys&) noexcept {
+        return false;
+    }
+
     /*
      * Creates an implementation defined CryptoCodec that provides at least TLSv1.2
      * compliant handshaking and full duplex data transfer.
@@ -1,9 +1,13 @@
 // Copyright Vespa.ai. Licensed under the terms of the Apache 2.0 license. See LICENSE in the project root.
 
 #include "crypto_codec_adapter.h"
+#include "kernel_tls.h"
 #include <vespa/vespalib/net/connection_auth_context.h>
 #include <assert.h>
 
+#include <vespa/log/log.h>
+LOG_SETUP(".vespalib.net.tls.crypto_codec_adapter");
+
 namespace vespalib::net::tls {
 
 CryptoSocket::HandshakeResult
@@ -57,6 +61,38 @@ CryptoCodecAdapter::flush_all()
     return res;
 }
 
+void
+CryptoCodecAdapter::try_enable_kernel_tls()
+{
+    if (_kernel_tls_checked) {
+        return;
+    }
+    _kernel_tls_checked = true;
+    KernelTlsKeys tx_keys;
+    KernelTlsKeys rx_keys;
+    if (!_codec->export_kernel_tls_keys(tx_keys, rx_keys)) {
+        return;
+    }
+    if (!attach_kernel_tls(_socket.get())) {
+        LOG(debug, "Could not attach kernel TLS to socket: %s", strerror(errno));
+        return;
+    }
+    // Once the kernel has taken over a direction, there is no way back to user space
+    // record protection. Failing to do so after attaching makes the connection unusable.
+    _kernel_tls_tx = install_kernel_tls_keys(_socket.get(), tx_keys, true);
+    if (!_kernel_tls_tx) {
+        LOG(warning, "Could not install kernel TLS transmit keys: %s", strerror(errno));
+        return;
+    }
+    // Ciphertext already read into our input buffer can only be decrypted by the codec
+    if (_input.obtain().size == 0) {
+        _kernel_tls_rx = install_kernel_tls_keys(_socket.get(), rx_keys, false);
+        if (!_kernel_tls_rx) {
+            LOG(warning, "Could not install kernel TLS receive keys: %s", strerror(errno));
+        }
+    }
+}
+
 void
 CryptoCodecAdapter::inject_read_data(const char *buf, size_t len)
 {
@@ -78,7 +114,13 @@ CryptoCodecAdapter::handshake()
         _output.commit(hs_res.bytes_produced);
         switch (hs_res.state) {
         case ::vespalib::net::tls::HandshakeResult::State::Failed: return HandshakeResult::FAIL;
-        case ::vespalib::net::tls::HandshakeResult::State::Done: return hs_try_flush();
+        case ::vespalib::net::tls::HandshakeResult::State::Done: {
+            auto flush_res = hs_try_flush();
+            if (flush_res == HandshakeResult::DONE) {
+                try_enable_kernel_tls();
+            }
+            return flush_res;
+        }
         case ::vespalib::net::tls::HandshakeResult::State::NeedsWork: return HandshakeResult::NEED_WORK;
         case ::vespalib::net::tls::HandshakeResult::State::NeedsMorePeerData:
             auto flush_res = hs_try_flush();
@@ -103,6 +145,9 @@ CryptoCodecAdapter::do_handshake_work()
 ssize_t
 CryptoCodecAdapter::read(char *buf, size_t len)
 {
+    if (_kernel_tls_rx) {
+        return _got_tls_close ? 0 : kernel_tls_read(_socket.get(), buf, len, _got_tls_close);
+    }
     auto drain_res = drain(buf, len);
     if ((drain_res != 0) || _got_tls_close) {
         return drain_res;
@@ -126,6 +171,9 @@ CryptoCodecAdapter::read(char *buf, size_t len)
 ssize_t
 CryptoCodecAdapter::drain(char *buf, size_t len)
 {
+    if (_kernel_tls_rx) {
+        return 0; // nothing is buffered in user space
+    }
     auto src = _input.obtain();
     auto res = _codec->decode(src.data, src.size, buf, len);
     if (res.failed()) {
@@ -142,6 +190,9 @@ CryptoCodecAdapter::drain(char *buf, size_t len)
 ssize_t
 CryptoCodecAdapter::write(const char *buf, size_t len)
 {
+    if (_kernel_tls_tx) {
+        return _socket.write(buf, len);
+    }
     if (_output.obtain().size >= _codec->min_encode_buffer_size()) {
         if (flush() < 0) {
             return -1;
@@ -185,6 +236,15 @@ CryptoCodecAdapter::half_close()
     if (flush_res < 0) {
         return flush_res;
     }
+    if (_kernel_tls_tx) {
+        if (!_encoded_tls_close) {
+            if (kernel_tls_send_close_notify(_socket.get()) < 0) {
+                return -1;
+            }
+            _encoded_tls_close = true;
+        }
+        return _socket.half_close();
+    }
     if (!_encoded_tls_close) {
         auto dst = _output.reserve(_codec->min_encode_buffer_size());
         auto res = _codec->half_close(dst.data, dst.size);
@@ -23,6 +23,9 @@ private:
     std::unique_ptr<CryptoCodec> _codec;
     bool                         _got_tls_close;
     bool                         _encoded_tls_close;
+    bool                         _kernel_tls_checked;
+    bool                         _kernel_tls_tx; // records are encrypted by the kernel
+    bool                         _kernel_tls_rx; // records are decrypted by the kernel
 
     bool is_blocked(ssize_t res, int error) const {
         return ((res < 0) && ((error == EWOULDBLOCK) || (error == EAGAIN)));
@@ -31,10 +34,12 @@ private:
     HandshakeResult hs_try_fill();
     ssize_t fill_input(); // -1/0/1 -> error/eof/ok
     ssize_t flush_all();  // -1/0 -> error/ok
+    void try_enable_kernel_tls();
 public:
     CryptoCodecAdapter(SocketHandle socket, std::unique_ptr<CryptoCodec> codec)
         : _input(0), _output(0), _socket(std::move(socket)), _codec(std::move(codec)),
-          _got_tls_close(false), _encoded_tls_close(false) {}
+          _got_tls_close(false), _encoded_tls_close(false),
+          _kernel_tls_checked(false), _kernel_tls_tx(false), _kernel_tls_rx(false) {}
     void inject_read_data(const char *buf, size_t len) override;
     int get_fd() const override { return _socket.get(); }
     HandshakeResult handshake() override;
@@ -5,6 +5,7 @@
 
 #include <vespa/vespalib/crypto/crypto_exception.h>
 #include <vespa/vespalib/net/tls/crypto_codec.h>
+#include <vespa/vespalib/net/tls/kernel_tls.h>
 #include <vespa/vespalib/net/tls/statistics.h>
 
 #include <mutex>
@@ -15,6 +16,8 @@
 #include <openssl/ssl.h>
 #include <openssl/crypto.h>
 #include <openssl/err.h>
+#include <openssl/evp.h>
+#include <openssl/hmac.h>
 #include <openssl/pem.h>
 
 #include <vespa/log/bufferedlogger.h>
@@ -171,6 +174,92 @@ void log_ssl_error(const char* source, const SocketAddress& peer_address, int ss
           ssl_error_to_str(ssl_error), ssl_error_from_stack().c_str());
 }
 
+#if (OPENSSL_VERSION_NUMBER >= 0x10101000L)
+
+int hex_digit_value(char c) noexcept {
+    if ((c >= '0') && (c <= '9')) {
+        return c - '0';
+    } else if ((c >= 'a') && (c <= 'f')) {
+        return c - 'a' + 10;
+    } else if ((c >= 'A') && (c <= 'F')) {
+        return c - 'A' + 10;
+    }
+    return -1;
+}
+
+// Key log lines are on the form "<label> <client random as hex> <secret as hex>"
+bool decode_key_log_secret(const char* line, const char* label, std::vector<unsigned char>& secret_out) {
+    const size_t label_len = strlen(label);
+    if ((strncmp(line, label, label_len) != 0) || (line[label_len] != ' ')) {
+        return false;
+    }
+    const char* hex = strchr(line + label_len + 1, ' ');
+    if (hex == nullptr) {
+        return false;
+    }
+    ++hex;
+    const size_t hex_len = strlen(hex);
+    if ((hex_len == 0) || ((hex_len % 2) != 0) || (hex_len / 2 > EVP_MAX_MD_SIZE)) {
+        return false;
+    }
+    std::vector<unsigned char> secret(hex_len / 2);
+    for (size_t i = 0; i < secret.size(); ++i) {
+        const int hi = hex_digit_value(hex[i * 2]);
+        const int lo = hex_digit_value(hex[i * 2 + 1]);
+        if ((hi < 0) || (lo < 0)) {
+            OPENSSL_cleanse(secret.data(), secret.size());
+            return false;
+        }
+        secret[i] = static_cast<unsigned char>((hi << 4) | lo);
+    }
+    OPENSSL_cleanse(secret_out.data(), secret_out.size());
+    secret_out = std::move(secret);
+    return true;
+}
+
+// HKDF-Expand-Label(secret, label, "", out_len) as specified by RFC 8446, section 7.1.
+// All our outputs are shorter than the digest size, so a single HMAC block suffices.
+bool hkdf_expand_label(const ::EVP_MD* md, const std::vector<unsigned char>& secret,
+                       const char* label, unsigned char* out, size_t out_len) noexcept
+{
+    unsigned char info[2 + 1 + 255 + 1 + 1];
+    const size_t label_len = strlen(label);
+    const size_t full_label_len = strlen("tls13 ") + label_len;
+    if ((out_len > static_cast<size_t>(EVP_MD_size(md))) || (full_label_len > 255)) {
+        return false;
+    }
+    size_t pos = 0;
+    info[pos++] = static_cast<unsigned char>(out_len >> 8);
+    info[pos++] = static_cast<unsigned char>(out_len & 0xff);
+    info[pos++] = static_cast<unsigned char>(full_label_len);
+    memcpy(info + pos, "tls13 ", strlen("tls13 "));
+    pos += strlen("tls13 ");
+    memcpy(info + pos, label, label_len);
+    pos += label_len;
+    info[pos++] = 0; // empty context
+    info[pos++] = 1; // HKDF-Expand block counter
+    unsigned char block[EVP_MAX_MD_SIZE];
+    unsigned int block_len = 0;
+    if (::HMAC(md, secret.data(), static_cast<int>(secret.size()), info, pos, block, &block_len) == nullptr) {
+        return false;
+    }
+    memcpy(out, block, out_len);
+    OPENSSL_cleanse(block, sizeof(block));
+    return true;
+}
+
+bool derive_kernel_tls_keys(const ::EVP_MD* md, KernelTlsKeys::Cipher cipher, size_t key_size,
+                            const std::vector<unsigned char>& secret, KernelTlsKeys& keys) noexcept
+{
+    keys.cipher = cipher;
+    keys.key_size = key_size;
+    keys.sequence = 0; // No application data records have been sent with this secret yet
+    return (hkdf_expand_label(md, secret, "key", keys.key, key_size) &&
+            hkdf_expand_label(md, secret, "iv", keys.iv, sizeof(keys.iv)));
+}
+
+#endif
+
 } // anon ns
 
 OpenSslCryptoCodecImpl::OpenSslCryptoCodecImpl(std::shared_ptr<OpenSslTlsContextImpl> ctx,
@@ -183,7 +272,10 @@ OpenSslCryptoCodecImpl::OpenSslCryptoCodecImpl(std::shared_ptr<OpenSslTlsContext
       _ssl(::SSL_new(_ctx->native_context())),
       _mode(mode),
       _deferred_handshake_params(),
-      _deferred_handshake_result()
+      _deferred_handshake_result(),
+      _client_traffic_secret(),
+      _server_traffic_secret(),
+      _has_user_space_records(false)
 {
     if (!_ssl) {
         throw CryptoException("Failed to create new SSL from SSL_CTX");
@@ -232,9 +324,14 @@ OpenSslCryptoCodecImpl::OpenSslCryptoCodecImpl(std::shared_ptr<OpenSslTlsContext
     if (SSL_set_app_data(_ssl.get(), this) != 1) {
         throw CryptoException("SSL_set_app_data() failed");
     }
+    if (_mode == Mode::Client) {
+        resume_session_if_enabled();
+    }
 }
 
-OpenSslCryptoCodecImpl::~OpenSslCryptoCodecImpl() = default;
+OpenSslCryptoCodecImpl::~OpenSslCryptoCodecImpl() {
+    wipe_traffic_secrets();
+}
 
 std::unique_ptr<OpenSslCryptoCodecImpl>
 OpenSslCryptoCodecImpl::make_client_codec(std::shared_ptr<OpenSslTlsContextImpl> ctx,
@@ -278,6 +375,32 @@ void OpenSslCryptoCodecImpl::set_server_name_indication_extension() {
     }
 }
 
+void OpenSslCryptoCodecImpl::resume_session_if_enabled() {
+    if (_peer_spec.valid() && _ctx->transport_security_options().enable_session_resumption()) {
+        if (_ctx->resume_client_session(_ssl.get(), _peer_spec.spec())) {
+            LOG(spam, "Attempting to resume earlier TLS session with %s", _peer_spec.spec().c_str());
+        }
+    }
+}
+
+bool OpenSslCryptoCodecImpl::session_was_resumed() const noexcept {
+    return (SSL_session_reused(_ssl.get()) == 1);
+}
+
+bool OpenSslCryptoCodecImpl::verify_resumed_session_if_reused() noexcept {
+    if (!session_was_resumed()) {
+        return true;
+    }
+    LOG(debug, "Resumed TLS session with %s", _peer_address.spec().c_str());
+    if (_ctx->verify_resumed_session(_ssl.get(), *this)) {
+        return true;
+    }
+    if (_mode == Mode::Client) {
+        _ctx->forget_client_session(_peer_spec.spec());
+    }
+    return false;
+}
+
 std::optional<vespalib::string> OpenSslCryptoCodecImpl::client_provided_sni_extension() const {
     if ((_mode != Mode::Server) || (SSL_get_servername_type(_ssl.get()) != TLSEXT_NAMETYPE_host_name)) {
         return {};
@@ -369,6 +492,10 @@ HandshakeResult OpenSslCryptoCodecImpl::do_handshake_and_consume_peer_input_byte
             LOG(error, "SSL handshake is not completed even though no more peer data is requested");
             return handshake_failed();
         }
+        if (!verify_resumed_session_if_reused()) {
+            ConnectionStatistics::get(_mode == Mode::Server).inc_failed_tls_handshakes();
+            return handshake_failed();
+        }
         LOG(debug, "SSL_do_handshake() with %s is complete, using protocol %s",
             _peer_address.spec().c_str(), SSL_get_version(_ssl.get()));
         ConnectionStatistics::get(_mode == Mode::Server).inc_tls_connections();
@@ -407,6 +534,7 @@ EncodeResult OpenSslCryptoCodecImpl::encode(const char* plaintext, size_t plaint
             return encode_failed();
         }
         bytes_consumed = static_cast<size_t>(consumed);
+        _has_user_space_records = true;
     }
     const int produced = BIO_pending(_output_bio);
     return encoded_bytes(bytes_consumed, static_cast<size_t>(produced));
@@ -428,6 +556,9 @@ DecodeResult OpenSslCryptoCodecImpl::decode(const char* ciphertext, size_t ciphe
 
     LOG_ASSERT(input_pending_before >= input_pending_after);
     const int consumed = input_pending_before - input_pending_after;
+    if ((consumed > 0) || (produce_res.bytes_produced > 0)) {
+        _has_user_space_records = true;
+    }
     LOG(spam, "decode: consumed %d bytes (ciphertext buffer %d -> %d bytes), produced %zu bytes. Need read: %s",
         consumed, input_pending_before, input_pending_after, produce_res.bytes_produced,
         (produce_res.state == DecodeResult::State::NeedsMorePeerData) ? "yes" : "no");
@@ -473,6 +604,7 @@ EncodeResult OpenSslCryptoCodecImpl::half_close(char* ciphertext, size_t ciphert
     LOG_ASSERT(verify_buf(ciphertext, ciphertext_size));
     MutableBufferViewGuard mut_view_guard(*_output_bio, ciphertext, ciphertext_size);
     const int pending_before = BIO_pending(_output_bio);
+    _has_user_space_records = true;
     int ssl_result = ::SSL_shutdown(_ssl.get());
     if (ssl_result < 0) {
         log_ssl_error("SSL_shutdown()", _peer_address, ::SSL_get_error(_ssl.get(), ssl_result));
@@ -483,6 +615,71 @@ EncodeResult OpenSslCryptoCodecImpl::half_close(char* ciphertext, size_t ciphert
     return encoded_bytes(0, static_cast<size_t>(pending_after - pending_before));
 }
 
+void OpenSslCryptoCodecImpl::on_key_log_line([[maybe_unused]] const char* line) noexcept {
+#if (OPENSSL_VERSION_NUMBER >= 0x10101000L)
+    if (!decode_key_log_secret(line, "CLIENT_TRAFFIC_SECRET_0", _client_traffic_secret)) {
+        decode_key_log_secret(line, "SERVER_TRAFFIC_SECRET_0", _server_traffic_secret);
+    }
+#endif
+}
+
+void OpenSslCryptoCodecImpl::wipe_traffic_secrets() noexcept {
+    OPENSSL_cleanse(_client_traffic_secret.data(), _client_traffic_secret.size());
+    OPENSSL_cleanse(_server_traffic_secret.data(), _server_traffic_secret.size());
+    _client_traffic_secret.clear();
+    _server_traffic_secret.clear();
+}
+
+bool OpenSslCryptoCodecImpl::export_kernel_tls_keys([[maybe_unused]] KernelTlsKeys& tx,
+                                                     [[maybe_unused]] KernelTlsKeys& rx) noexcept {
+#if (OPENSSL_VERSION_NUMBER >= 0x10101000L)
+    if (_client_traffic_secret.empty() || _server_traffic_secret.empty()) {
+        return false; // Kernel TLS not enabled, TLSv1.2 negotiated, or already exported
+    }
+    const bool can_export = (SSL_is_init_finished(_ssl.get()) &&
+                             (::SSL_version(_ssl.get()) == TLS1_3_VERSION) &&
+                             !_has_user_space_records &&
+                             (::SSL_has_pending(_ssl.get()) == 0));
+    const ::SSL_CIPHER* cipher = ::SSL_get_current_cipher(_ssl.get());
+    if (!can_export || (cipher == nullptr)) {
+        wipe_traffic_secrets();
+        return false;
+    }
+    const ::EVP_MD* md = nullptr;
+    KernelTlsKeys::Cipher kernel_cipher;
+    size_t key_size = 0;
+    switch (::SSL_CIPHER_get_id(cipher)) {
+    case TLS1_3_CK_AES_128_GCM_SHA256:
+        md = ::EVP_sha256();
+        kernel_cipher = KernelTlsKeys::Cipher::AES_128_GCM;
+        key_size = 16;
+        break;
+    case TLS1_3_CK_AES_256_GCM_SHA384:
+        md = ::EVP_sha384();
+        kernel_cipher = KernelTlsKeys::Cipher::AES_256_GCM;
+        key_size = 32;
+        break;
+    case TLS1_3_CK_CHACHA20_POLY1305_SHA256:
+        md = ::EVP_sha256();
+        kernel_cipher = KernelTlsKeys::Cipher::CHACHA20_POLY1305;
+        key_size = 32;
+        break;
+    default:
+        wipe_traffic_secrets();
+        return false;
+    }
+    const bool is_client = (_mode == Mode::Client);
+    const bool ok = (derive_kernel_tls_keys(md, kernel_cipher, key_size,
+                                            is_client ? _client_traffic_secret : _server_traffic_secret, tx) &&
+                     derive_kernel_tls_keys(md, kernel_cipher, key_size,
+                                            is_client ? _server_traffic_secret : _client_traffic_secret, rx));
+    wipe_traffic_secrets();
+    return ok;
+#else
+    return false;
+#endif
+}
+
 }
 
 // External references:
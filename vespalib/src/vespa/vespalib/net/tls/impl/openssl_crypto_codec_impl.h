@@ -10,6 +10,7 @@
 #include <vespa/vespalib/net/tls/transport_security_options.h>
 #include <memory>
 #include <optional>
+#include <vector>
 
 namespace vespalib::net::tls { struct TlsContext; }
 
@@ -59,6 +60,10 @@ class OpenSslCryptoCodecImpl : public CryptoCodec {
     std::optional<HandshakeResult>         _deferred_handshake_result;
     PeerCredentials _peer_credentials;
     CapabilitySet   _granted_capabilities;
+    // TLSv1.3 application traffic secrets, only captured when kernel TLS is enabled
+    std::vector<unsigned char> _client_traffic_secret;
+    std::vector<unsigned char> _server_traffic_secret;
+    bool            _has_user_space_records;
 public:
     ~OpenSslCryptoCodecImpl() override;
 
@@ -107,7 +112,12 @@ public:
         return _granted_capabilities;
     }
 
+    [[nodiscard]] bool export_kernel_tls_keys(KernelTlsKeys& tx, KernelTlsKeys& rx) noexcept override;
+
     const SocketAddress& peer_address() const noexcept { return _peer_address; }
+    const SocketSpec& peer_spec() const noexcept { return _peer_spec; }
+    // True iff the handshake resumed an earlier session rather than doing a full handshake.
+    bool session_was_resumed() const noexcept;
     /*
      * If a client has sent a SNI extension field as part of the handshake,
      * returns the raw string representation of this. It only makes sense to
@@ -123,6 +133,8 @@ public:
     void set_granted_capabilities(CapabilitySet granted_capabilities) {
         _granted_capabilities = granted_capabilities;
     }
+    // Only used by the context's key log callback, which is only installed when kernel TLS is enabled.
+    void on_key_log_line(const char* line) noexcept;
 private:
     OpenSslCryptoCodecImpl(std::shared_ptr<OpenSslTlsContextImpl> ctx,
                            const SocketSpec& peer_spec,
@@ -131,10 +143,13 @@ private:
 
     void enable_hostname_validation_if_requested();
     void set_server_name_indication_extension();
+    void resume_session_if_enabled();
+    bool verify_resumed_session_if_reused() noexcept;
     HandshakeResult do_handshake_and_consume_peer_input_bytes() noexcept;
     DecodeResult drain_and_produce_plaintext_from_ssl(char* plaintext, size_t plaintext_size) noexcept;
     // Precondition: read_result < 0
     DecodeResult remap_ssl_read_failure_to_decode_result(int read_result) noexcept;
+    void wipe_traffic_secrets() noexcept;
 };
 
 }
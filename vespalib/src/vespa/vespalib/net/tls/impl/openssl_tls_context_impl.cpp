@@ -3,11 +3,13 @@
 #include "openssl_tls_context_impl.h"
 #include "iana_cipher_map.h"
 #include "openssl_crypto_codec_impl.h"
+#include "session_ticket_keys.h"
 #include <vespa/vespalib/crypto/crypto_exception.h>
 #include <vespa/vespalib/crypto/openssl_typedefs.h>
 #include <vespa/vespalib/net/tls/statistics.h>
 #include <vespa/vespalib/net/tls/transport_security_options.h>
 #include <vespa/vespalib/util/stringfmt.h>
+#include <cstring>
 #include <mutex>
 #include <vector>
 #include <memory>
@@ -18,6 +20,14 @@
 #include <openssl/x509v3.h>
 #include <openssl/asn1.h>
 #include <openssl/pem.h>
+#include <openssl/evp.h>
+#include <openssl/rand.h>
+#if (OPENSSL_VERSION_NUMBER >= 0x30000000L)
+#  include <openssl/core_names.h>
+#  include <openssl/params.h>
+#else
+#  include <openssl/hmac.h>
+#endif
 
 #include <vespa/log/bufferedlogger.h>
 LOG_SETUP(".vespalib.net.tls.openssl_tls_context_impl");
@@ -189,6 +199,73 @@ SslCtxPtr new_tls_ctx_with_auto_init() {
 #endif
 }
 
+// Sets up `cipher_ctx` and the HMAC (via `init_hmac`) for encrypting a new session ticket
+// (enc == 1) or decrypting the ticket named by `key_name` (enc == 0). Follows the return
+// value convention of SSL_CTX_set_tlsext_ticket_key_cb(): for decryption, 0 means the key
+// is unknown (do a full handshake), 1 that the ticket is fine and 2 that it should be
+// replaced by one protected by the current key.
+template <typename InitHmac>
+int handle_ticket_key(::SSL* ssl, unsigned char* key_name, unsigned char* iv,
+                      ::EVP_CIPHER_CTX* cipher_ctx, int enc, InitHmac init_hmac)
+{
+    auto* self = static_cast<OpenSslTlsContextImpl*>(SSL_CTX_get_app_data(::SSL_get_SSL_CTX(ssl)));
+    if ((self == nullptr) || !self->session_ticket_keys()) {
+        return -1;
+    }
+    auto& keys = *self->session_ticket_keys();
+    const auto now = std::chrono::steady_clock::now();
+    if (enc == 1) {
+        auto key = keys.encryption_key(now);
+        memcpy(key_name, key.name(), SessionTicketKey::name_size);
+        if (::RAND_bytes(iv, ::EVP_CIPHER_iv_length(::EVP_aes_256_cbc())) != 1) {
+            return -1;
+        }
+        if (::EVP_EncryptInit_ex(cipher_ctx, ::EVP_aes_256_cbc(), nullptr, key.aes_key(), iv) != 1) {
+            return -1;
+        }
+        return init_hmac(key.hmac_key()) ? 1 : -1;
+    }
+    auto found = keys.decryption_key(key_name, now);
+    if (!found) {
+        return 0;
+    }
+    if (!init_hmac(found->key.hmac_key())) {
+        return -1;
+    }
+    if (::EVP_DecryptInit_ex(cipher_ctx, ::EVP_aes_256_cbc(), nullptr, found->key.aes_key(), iv) != 1) {
+        return -1;
+    }
+    return found->is_current ? 1 : 2;
+}
+
+#if (OPENSSL_VERSION_NUMBER >= 0x30000000L)
+
+int ticket_key_evp_cb(::SSL* ssl, unsigned char* key_name, unsigned char* iv,
+                      ::EVP_CIPHER_CTX* cipher_ctx, ::EVP_MAC_CTX* mac_ctx, int enc)
+{
+    return handle_ticket_key(ssl, key_name, iv, cipher_ctx, enc, [mac_ctx](const unsigned char* hmac_key) {
+        char digest[] = "SHA256";
+        ::OSSL_PARAM params[3];
+        params[0] = ::OSSL_PARAM_construct_octet_string(OSSL_MAC_PARAM_KEY, const_cast<unsigned char*>(hmac_key),
+                                                        SessionTicketKey::hmac_key_size);
+        params[1] = ::OSSL_PARAM_construct_utf8_string(OSSL_MAC_PARAM_DIGEST, digest, 0);
+        params[2] = ::OSSL_PARAM_construct_end();
+        return (::EVP_MAC_CTX_set_params(mac_ctx, params) == 1);
+    });
+}
+
+#else
+
+int ticket_key_hmac_cb(::SSL* ssl, unsigned char* key_name, unsigned char* iv,
+                       ::EVP_CIPHER_CTX* cipher_ctx, ::HMAC_CTX* hmac_ctx, int enc)
+{
+    return handle_ticket_key(ssl, key_name, iv, cipher_ctx, enc, [hmac_ctx](const unsigned char* hmac_key) {
+        return (::HMAC_Init_ex(hmac_ctx, hmac_key, SessionTicketKey::hmac_key_size, ::EVP_sha256(), nullptr) == 1);
+    });
+}
+
+#endif
+
 } // anon ns
 
 OpenSslTlsContextImpl::OpenSslTlsContextImpl(
@@ -213,7 +290,11 @@ OpenSslTlsContextImpl::OpenSslTlsContextImpl(
     enable_ephemeral_key_exchange();
     disable_compression();
     disable_renegotiation();
-    disable_session_resumption();
+    if (ts_opts.enable_session_resumption()) {
+        enable_session_resumption(ts_opts);
+    } else {
+        disable_session_resumption();
+    }
     enforce_peer_certificate_verification();
     set_ssl_ctx_self_reference();
     if (!ts_opts.accepted_ciphers().empty()) {
@@ -223,6 +304,13 @@ OpenSslTlsContextImpl::OpenSslTlsContextImpl(
     } else {
         set_accepted_cipher_suites(modern_iana_cipher_suites());
     }
+    if (ts_opts.enable_kernel_tls()) {
+        if (ts_opts.enable_session_resumption()) {
+            LOG(info, "Both kernel TLS and session resumption are enabled; sessions will not be resumed "
+                      "since session tickets cannot be exchanged once the kernel has taken over");
+        }
+        enable_kernel_tls_key_export();
+    }
 }
 
 OpenSslTlsContextImpl::~OpenSslTlsContextImpl() {
@@ -331,6 +419,109 @@ void OpenSslTlsContextImpl::disable_session_resumption() {
     SSL_CTX_set_options(_ctx.get(), SSL_OP_NO_TICKET);
 }
 
+void OpenSslTlsContextImpl::enable_session_resumption(const TransportSecurityOptions& ts_opts) {
+    // Servers refuse to resume sessions when verifying peers unless a session ID context is set.
+    // This context is never shared with anything else, so any constant will do.
+    constexpr unsigned char session_id_context[] = "vespa";
+    if (::SSL_CTX_set_session_id_context(_ctx.get(), session_id_context, sizeof(session_id_context) - 1) != 1) {
+        throw CryptoException("SSL_CTX_set_session_id_context() failed");
+    }
+    // Servers hand out stateless session tickets, so they have no need for a session cache.
+    // Clients keep their sessions in _client_sessions, keyed on peer rather than session ID.
+    SSL_CTX_set_session_cache_mode(_ctx.get(), SSL_SESS_CACHE_CLIENT | SSL_SESS_CACHE_SERVER |
+                                               SSL_SESS_CACHE_NO_INTERNAL_STORE);
+    SSL_CTX_clear_options(_ctx.get(), SSL_OP_NO_TICKET);
+    ::SSL_CTX_set_timeout(_ctx.get(), session_timeout_seconds);
+    ::SSL_CTX_sess_set_new_cb(_ctx.get(), new_session_cb_wrapper);
+    use_session_ticket_keys(ts_opts);
+}
+
+void OpenSslTlsContextImpl::use_session_ticket_keys(const TransportSecurityOptions& ts_opts) {
+    if (!ts_opts.session_ticket_keys().empty()) {
+        _session_ticket_keys = SessionTicketKeys::from_key_file_data(ts_opts.session_ticket_keys());
+    } else {
+        // Tickets must be decryptable for their entire lifetime, see SessionTicketKeys
+        _session_ticket_keys = SessionTicketKeys::process_wide(std::chrono::seconds(session_timeout_seconds));
+    }
+#if (OPENSSL_VERSION_NUMBER >= 0x30000000L)
+    if (::SSL_CTX_set_tlsext_ticket_key_evp_cb(_ctx.get(), ticket_key_evp_cb) != 1) {
+        throw CryptoException("SSL_CTX_set_tlsext_ticket_key_evp_cb() failed");
+    }
+#else
+    if (SSL_CTX_set_tlsext_ticket_key_cb(_ctx.get(), ticket_key_hmac_cb) != 1) {
+        throw CryptoException("SSL_CTX_set_tlsext_ticket_key_cb() failed");
+    }
+#endif
+}
+
+int OpenSslTlsContextImpl::new_session_cb_wrapper(::SSL* ssl, ::SSL_SESSION* session) {
+    if (SSL_is_server(ssl)) {
+        return 0;
+    }
+    void* data = SSL_get_app_data(ssl);
+    LOG_ASSERT(data != nullptr);
+    auto* codec_impl = static_cast<OpenSslCryptoCodecImpl*>(data);
+    if (!codec_impl->peer_spec().valid()) {
+        return 0; // nothing to key the session on
+    }
+    auto* self = static_cast<OpenSslTlsContextImpl*>(SSL_CTX_get_app_data(::SSL_get_SSL_CTX(ssl)));
+    LOG_ASSERT(self != nullptr);
+    self->store_client_session(codec_impl->peer_spec().spec(), session);
+    return 0; // we never take over the reference to the session passed to us
+}
+
+void OpenSslTlsContextImpl::store_client_session(const vespalib::string& peer_key, ::SSL_SESSION* session) {
+#if (OPENSSL_VERSION_NUMBER >= 0x10101000L)
+    if (::SSL_SESSION_is_resumable(session) != 1) {
+        return;
+    }
+    // The session passed to us is the one used by the connection, and OpenSSL marks it as
+    // not resumable if the connection is torn down without a proper TLS shutdown. We don't
+    // do those, so keep a copy of our own instead.
+    SslSessionPtr copy(::SSL_SESSION_dup(session));
+    if (!copy) {
+        return;
+    }
+    std::lock_guard guard(_client_sessions_lock);
+    auto iter = _client_sessions.find(peer_key);
+    if (iter != _client_sessions.end()) {
+        iter->second = std::move(copy);
+        return;
+    }
+    if (_client_sessions.size() >= max_client_sessions) {
+        _client_sessions.erase(_client_sessions.begin());
+    }
+    _client_sessions.emplace(peer_key, std::move(copy));
+#else
+    (void) peer_key;
+    (void) session; // we only resume sessions on OpenSSL versions that can copy them
+#endif
+}
+
+bool OpenSslTlsContextImpl::resume_client_session(::SSL* ssl, const vespalib::string& peer_key) {
+    std::lock_guard guard(_client_sessions_lock);
+    auto iter = _client_sessions.find(peer_key);
+    if (iter == _client_sessions.end()) {
+        return false;
+    }
+    // Bumps the refcount of the session, so it stays valid even if replaced in the map
+    if (::SSL_set_session(ssl, iter->second.get()) != 1) {
+        _client_sessions.erase(iter);
+        return false;
+    }
+    return true;
+}
+
+void OpenSslTlsContextImpl::forget_client_session(const vespalib::string& peer_key) {
+    std::lock_guard guard(_client_sessions_lock);
+    _client_sessions.erase(peer_key);
+}
+
+size_t OpenSslTlsContextImpl::num_client_sessions() {
+    std::lock_guard guard(_client_sessions_lock);
+    return _client_sessions.size();
+}
+
 namespace {
 
 // There's no good reason for entries to contain embedded nulls, aside from
@@ -460,9 +651,8 @@ int OpenSslTlsContextImpl::verify_cb_wrapper(int preverified_ok, ::X509_STORE_CT
 }
 
 bool OpenSslTlsContextImpl::verify_trusted_certificate(::X509_STORE_CTX* store_ctx, OpenSslCryptoCodecImpl& codec_impl) {
-    const auto authz_mode = authorization_mode();
     // TODO consider if we want to fill in peer credentials even if authorization is disabled
-    if (authz_mode == AuthorizationMode::Disable) {
+    if (authorization_mode() == AuthorizationMode::Disable) {
         return true;
     }
     ::X509* cert = ::X509_STORE_CTX_get_current_cert(store_ctx); // _not_ owned by us
@@ -470,6 +660,31 @@ bool OpenSslTlsContextImpl::verify_trusted_certificate(::X509_STORE_CTX* store_c
         LOG(error, "Got X509_STORE_CTX with preverified_ok == 1 but no current cert");
         return false;
     }
+    return verify_peer_certificate(cert, codec_impl);
+}
+
+bool OpenSslTlsContextImpl::verify_resumed_session(::SSL* ssl, OpenSslCryptoCodecImpl& codec_impl) {
+    if (authorization_mode() == AuthorizationMode::Disable) {
+        return true;
+    }
+#if (OPENSSL_VERSION_NUMBER >= 0x30000000L)
+    X509Ptr cert(::SSL_get1_peer_certificate(ssl));
+#else
+    X509Ptr cert(::SSL_get_peer_certificate(ssl));
+#endif
+    if (!cert) {
+        LOG(error, "Resumed session with peer '%s' has no peer certificate", codec_impl.peer_address().spec().c_str());
+        return false;
+    }
+    if (verify_peer_certificate(cert.get(), codec_impl)) {
+        return true;
+    }
+    ConnectionStatistics::get(SSL_is_server(ssl) != 0).inc_invalid_peer_credentials();
+    return false;
+}
+
+bool OpenSslTlsContextImpl::verify_peer_certificate(::X509* cert, OpenSslCryptoCodecImpl& codec_impl) {
+    const auto authz_mode = authorization_mode();
     PeerCredentials creds;
     if (!fill_certificate_common_name(cert, creds)) {
         return false;
@@ -509,6 +724,32 @@ void OpenSslTlsContextImpl::set_ssl_ctx_self_reference() {
     SSL_CTX_set_app_data(_ctx.get(), this);
 }
 
+void OpenSslTlsContextImpl::enable_kernel_tls_key_export() {
+#if (OPENSSL_VERSION_NUMBER >= 0x10101000L)
+    ::SSL_CTX_set_keylog_callback(_ctx.get(), keylog_cb_wrapper);
+    // TLSv1.3 session tickets are sent by the server after the handshake has completed,
+    // as records protected by the application traffic keys. A server would have to
+    // account for these records in the sequence number handed to the kernel, and a
+    // client has usually already handed receiving over to the kernel by the time
+    // they arrive, at which point kernel_tls_read() discards them. Kernel TLS thus
+    // rules out session resumption in both directions, and we do not issue tickets
+    // that can never be used. Nodes that enable kernel TLS will always do full
+    // handshakes, regardless of the session resumption setting.
+    if (::SSL_CTX_set_num_tickets(_ctx.get(), 0) != 1) {
+        throw CryptoException("SSL_CTX_set_num_tickets() failed");
+    }
+#else
+    LOG(warning, "Kernel TLS requested, but OpenSSL version is too old to support it");
+#endif
+}
+
+void OpenSslTlsContextImpl::keylog_cb_wrapper(const ::SSL* ssl, const char* line) {
+    void* data = SSL_get_app_data(ssl);
+    if (data != nullptr) {
+        static_cast<OpenSslCryptoCodecImpl*>(data)->on_key_log_line(line);
+    }
+}
+
 void OpenSslTlsContextImpl::set_accepted_cipher_suites(const std::vector<vespalib::string>& ciphers) {
     vespalib::string openssl_ciphers;
     size_t bad_ciphers = 0;
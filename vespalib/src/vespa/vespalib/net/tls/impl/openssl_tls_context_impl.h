@@ -9,17 +9,33 @@
 #include <vespa/vespalib/stllike/string.h>
 
 #include <chrono>
+#include <map>
+#include <mutex>
 
 namespace vespalib::net::tls::impl {
 
 class OpenSslCryptoCodecImpl;
+class SessionTicketKeys;
 
 class OpenSslTlsContextImpl : public TlsContext {
     crypto::SslCtxPtr _ctx;
     AuthorizationMode _authorization_mode;
     std::shared_ptr<CertificateVerificationCallback> _cert_verify_callback;
     TransportSecurityOptions _redacted_transport_options;
+    // Keys protecting the session tickets we issue as a server. Outlives this context,
+    // so tickets stay valid across TLS config reloads. Only set when session resumption
+    // is enabled.
+    std::shared_ptr<SessionTicketKeys> _session_ticket_keys;
+    // Most recent resumable session per peer, keyed on peer spec. Only used when
+    // session resumption is enabled.
+    std::mutex _client_sessions_lock;
+    std::map<vespalib::string, crypto::SslSessionPtr> _client_sessions;
 public:
+    // Upper bound on the number of peers we remember client sessions for
+    static constexpr size_t max_client_sessions = 4096;
+    // Lifetime of sessions (and their tickets) issued by this context
+    static constexpr long session_timeout_seconds = 3600;
+
     OpenSslTlsContextImpl(const TransportSecurityOptions& ts_opts,
                           std::shared_ptr<CertificateVerificationCallback> cert_verify_callback,
                           AuthorizationMode authz_mode);
@@ -30,6 +46,20 @@ public:
         return _redacted_transport_options;
     }
     AuthorizationMode authorization_mode() const noexcept override { return _authorization_mode; }
+
+    // Makes the given client SSL attempt to resume the last session established with
+    // the peer, if any. Returns true iff a session was found.
+    bool resume_client_session(::SSL* ssl, const vespalib::string& peer_key);
+    // Drops any session remembered for the peer, e.g. because it could not be used.
+    void forget_client_session(const vespalib::string& peer_key);
+    size_t num_client_sessions();
+    const std::shared_ptr<SessionTicketKeys>& session_ticket_keys() const noexcept {
+        return _session_ticket_keys;
+    }
+    // Certificate verification callbacks are not invoked for resumed sessions, so the
+    // peer certificate stored in the session must be run through the same verification
+    // and authorization logic once the handshake has completed.
+    bool verify_resumed_session(::SSL* ssl, OpenSslCryptoCodecImpl& codec_impl);
 private:
     // Note: single use per instance; does _not_ clear existing chain!
     void add_certificate_authorities(stringref ca_pem);
@@ -48,10 +78,23 @@ private:
     void enforce_peer_certificate_verification();
     void set_ssl_ctx_self_reference();
     void set_accepted_cipher_suites(const std::vector<vespalib::string>& ciphers);
+    // Capture TLSv1.3 traffic secrets so that codecs can hand record protection over
+    // to the kernel once handshaking has completed.
+    void enable_kernel_tls_key_export();
+    // Allow TLS session tickets, and remember the sessions we get as a client so
+    // that they can be resumed when reconnecting to the same peer.
+    void enable_session_resumption(const TransportSecurityOptions& ts_opts);
+    // Protect issued tickets with our own keys rather than the per-context keys OpenSSL
+    // generates by default, which would not survive the context being replaced.
+    void use_session_ticket_keys(const TransportSecurityOptions& ts_opts);
 
     bool verify_trusted_certificate(::X509_STORE_CTX* store_ctx, OpenSslCryptoCodecImpl& codec_impl);
+    bool verify_peer_certificate(::X509* cert, OpenSslCryptoCodecImpl& codec_impl);
+    void store_client_session(const vespalib::string& peer_key, ::SSL_SESSION* session);
 
     static int verify_cb_wrapper(int preverified_ok, ::X509_STORE_CTX* store_ctx);
+    static void keylog_cb_wrapper(const ::SSL* ssl, const char* line);
+    static int new_session_cb_wrapper(::SSL* ssl, ::SSL_SESSION* session);
 };
 
 }
@@ -0,0 +1,119 @@
+// Copyright Vespa.ai. Licensed under the terms of the Apache 2.0 license. See LICENSE in the project root.
+
+#include "session_ticket_keys.h"
+#include <vespa/vespalib/crypto/crypto_exception.h>
+#include <vespa/vespalib/net/tls/transport_security_options.h>
+#include <vespa/vespalib/util/exceptions.h>
+#include <vespa/vespalib/util/stringfmt.h>
+#include <cstring>
+#include <openssl/rand.h>
+
+namespace vespalib::net::tls::impl {
+
+SessionTicketKey::SessionTicketKey(const unsigned char* bytes) noexcept
+    : _bytes()
+{
+    memcpy(_bytes.data(), bytes, serialized_size);
+}
+
+SessionTicketKey::~SessionTicketKey() {
+    secure_memzero(_bytes.data(), _bytes.size());
+}
+
+SessionTicketKey SessionTicketKey::make_random() {
+    unsigned char bytes[serialized_size];
+    if (::RAND_bytes(bytes, sizeof(bytes)) != 1) {
+        throw crypto::CryptoException("RAND_bytes() failed to generate session ticket key");
+    }
+    SessionTicketKey key(bytes);
+    secure_memzero(bytes, sizeof(bytes));
+    return key;
+}
+
+bool SessionTicketKey::has_name(const unsigned char* name) const noexcept {
+    return (memcmp(_bytes.data(), name, name_size) == 0);
+}
+
+SessionTicketKeys::SessionTicketKeys(duration rotation_interval, steady_time now)
+    : _lock(),
+      _keys(),
+      _rotation_interval(rotation_interval),
+      _last_rotation(now)
+{
+    _keys.emplace_back(SessionTicketKey::make_random());
+}
+
+SessionTicketKeys::SessionTicketKeys(std::vector<SessionTicketKey> keys)
+    : _lock(),
+      _keys(std::move(keys)),
+      _rotation_interval(duration::zero()),
+      _last_rotation()
+{
+    if (_keys.empty()) {
+        throw IllegalArgumentException("At least one session ticket key must be provided");
+    }
+}
+
+SessionTicketKeys::~SessionTicketKeys() = default;
+
+std::shared_ptr<SessionTicketKeys>
+SessionTicketKeys::from_key_file_data(vespalib::stringref key_file_data) {
+    if (key_file_data.empty() || (key_file_data.size() % SessionTicketKey::serialized_size) != 0) {
+        throw IllegalArgumentException(make_string("Session ticket key file must contain a non-zero multiple of "
+                                                   "%zu bytes, but has %zu bytes",
+                                                   SessionTicketKey::serialized_size, key_file_data.size()));
+    }
+    std::vector<SessionTicketKey> keys;
+    const auto* bytes = reinterpret_cast<const unsigned char*>(key_file_data.data());
+    for (size_t i = 0; i < key_file_data.size(); i += SessionTicketKey::serialized_size) {
+        keys.emplace_back(bytes + i);
+    }
+    return std::make_shared<SessionTicketKeys>(std::move(keys));
+}
+
+std::shared_ptr<SessionTicketKeys>
+SessionTicketKeys::process_wide(duration rotation_interval) {
+    static std::shared_ptr<SessionTicketKeys> keys =
+            std::make_shared<SessionTicketKeys>(rotation_interval, std::chrono::steady_clock::now());
+    return keys;
+}
+
+void SessionTicketKeys::maybe_rotate(steady_time now) {
+    if ((_rotation_interval == duration::zero()) || ((now - _last_rotation) < _rotation_interval)) {
+        return;
+    }
+    if ((now - _last_rotation) >= 2 * _rotation_interval) {
+        // Even the tickets issued right before the last rotation have expired by now
+        _keys.clear();
+    }
+    _keys.insert(_keys.begin(), SessionTicketKey::make_random());
+    if (_keys.size() > 2) {
+        _keys.erase(_keys.begin() + 2, _keys.end());
+    }
+    _last_rotation = now;
+}
+
+SessionTicketKey SessionTicketKeys::encryption_key(steady_time now) {
+    std::lock_guard guard(_lock);
+    maybe_rotate(now);
+    return _keys.front();
+}
+
+std::optional<SessionTicketKeys::Lookup>
+SessionTicketKeys::decryption_key(const unsigned char* name, steady_time now) {
+    std::lock_guard guard(_lock);
+    maybe_rotate(now);
+    for (size_t i = 0; i < _keys.size(); ++i) {
+        if (_keys[i].has_name(name)) {
+            return Lookup{_keys[i], (i == 0)};
+        }
+    }
+    return std::nullopt;
+}
+
+size_t SessionTicketKeys::num_keys() const {
+    std::lock_guard guard(_lock);
+    return _keys.size();
+}
+
+}
@@ -0,0 +1,98 @@
+// Copyright Vespa.ai. Licensed under the terms of the Apache 2.0 license. See LICENSE in the project root.
+#pragma once
+
+#include <vespa/vespalib/stllike/string.h>
+#include <array>
+#include <chrono>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <vector>
+
+namespace vespalib::net::tls::impl {
+
+/**
+ * A single TLS session ticket key. Tickets are encrypted with AES-256-CBC and
+ * authenticated with HMAC-SHA256, and carry the key name in the clear so that
+ * the server can pick the right key when a ticket is presented to it.
+ */
+class SessionTicketKey {
+public:
+    static constexpr size_t name_size = 16;
+    static constexpr size_t hmac_key_size = 32;
+    static constexpr size_t aes_key_size = 32;
+    static constexpr size_t serialized_size = name_size + hmac_key_size + aes_key_size;
+private:
+    std::array<unsigned char, serialized_size> _bytes;
+public:
+    // Expects exactly serialized_size bytes laid out as name, HMAC key, AES key
+    explicit SessionTicketKey(const unsigned char* bytes) noexcept;
+    SessionTicketKey(const SessionTicketKey&) noexcept = default;
+    SessionTicketKey& operator=(const SessionTicketKey&) noexcept = default;
+    ~SessionTicketKey();
+
+    static SessionTicketKey make_random();
+
+    const unsigned char* name() const noexcept { return _bytes.data(); }
+    const unsigned char* hmac_key() const noexcept { return _bytes.data() + name_size; }
+    const unsigned char* aes_key() const noexcept { return _bytes.data() + name_size + hmac_key_size; }
+    bool has_name(const unsigned char* name) const noexcept;
+};
+
+/**
+ * The set of keys a TLS context uses to protect the session tickets it hands out.
+ *
+ * Tickets must be decryptable by whatever context receives them, which is not
+ * necessarily the context that issued them: the TLS config may be reloaded at any
+ * time, and every context created by OpenSSL on its own would pick fresh random
+ * keys and invalidate all outstanding tickets. Keys therefore live outside the
+ * context, either explicitly provided in the TLS config (and shared by all nodes
+ * that use the same file) or generated at random and shared by all contexts
+ * within this process.
+ *
+ * The first key is used to encrypt new tickets; all keys are accepted when
+ * decrypting. Random keys are rotated every rotation interval, keeping the
+ * previous key around for another interval so that no ticket is rejected
+ * before its lifetime is up as long as the interval is at least the ticket
+ * lifetime. Explicitly configured keys are never rotated by us; operators
+ * rotate them by prepending a new key to the key file.
+ */
+class SessionTicketKeys {
+public:
+    using steady_time = std::chrono::steady_clock::time_point;
+    using duration = std::chrono::steady_clock::duration;
+
+    // Outcome of looking up a key for a ticket presented by a client
+    struct Lookup {
+        SessionTicketKey key;
+        bool is_current;
+    };
+private:
+    mutable std::mutex _lock;
+    std::vector<SessionTicketKey> _keys;
+    duration _rotation_interval; // zero if keys are never rotated
+    steady_time _last_rotation;
+
+    void maybe_rotate(steady_time now);
+public:
+    // Random keys that are rotated every `rotation_interval`
+    SessionTicketKeys(duration rotation_interval, steady_time now);
+    // Fixed keys; `keys` must be non-empty and the first key is used for encryption
+    explicit SessionTicketKeys(std::vector<SessionTicketKey> keys);
+    ~SessionTicketKeys();
+
+    // Parses the contents of a session ticket key file, which is a non-empty sequence
+    // of keys in their serialized form. Throws IllegalArgumentException if the size
+    // of `key_file_data` is not a non-zero multiple of the serialized key size.
+    static std::shared_ptr<SessionTicketKeys> from_key_file_data(vespalib::stringref key_file_data);
+    // Random keys shared by all TLS contexts in this process that do not have keys
+    // configured explicitly, rotated every `rotation_interval`. The interval given
+    // by the first caller is the one that is used.
+    static std::shared_ptr<SessionTicketKeys> process_wide(duration rotation_interval);
+
+    SessionTicketKey encryption_key(steady_time now);
+    std::optional<Lookup> decryption_key(const unsigned char* name, steady_time now);
+    size_t num_keys() const;
+};
+
+}
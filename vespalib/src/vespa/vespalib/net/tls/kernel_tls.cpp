@@ -0,0 +1,216 @@
+// Copyright Vespa.ai. Licensed under the terms of the Apache 2.0 license. See LICENSE in the project root.
+
+#include "kernel_tls.h"
+#include "transport_security_options.h"
+#include <cerrno>
+#include <cstring>
+
+#ifdef __linux__
+#include <sys/socket.h>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <linux/tls.h>
+#  ifdef TLS_1_3_VERSION
+#    define VESPA_KERNEL_TLS 1
+#  endif
+#endif
+
+namespace vespalib::net::tls {
+
+KernelTlsKeys::KernelTlsKeys() noexcept
+    : cipher(Cipher::AES_128_GCM),
+      key(),
+      key_size(0),
+      iv(),
+      sequence(0)
+{
+}
+
+KernelTlsKeys::~KernelTlsKeys() {
+    secure_memzero(key, sizeof(key));
+    secure_memzero(iv, sizeof(iv));
+}
+
+#ifdef VESPA_KERNEL_TLS
+
+namespace {
+
+#ifndef SOL_TLS
+constexpr int SOL_TLS = 282;
+#endif
+#ifndef TCP_ULP
+constexpr int TCP_ULP = 31;
+#endif
+
+// TLS record content types (RFC 8446, section 5.1)
+constexpr uint8_t alert_record = 21;
+constexpr uint8_t handshake_record = 22;
+constexpr uint8_t application_data_record = 23;
+constexpr uint8_t new_session_ticket_message = 4;
+constexpr uint8_t alert_level_warning = 1;
+constexpr uint8_t close_notify_alert = 0;
+
+void store_sequence(unsigned char* dst, uint64_t sequence) noexcept {
+    for (int i = 7; i >= 0; --i) {
+        dst[i] = static_cast<unsigned char>(sequence & 0xff);
+        sequence >>= 8;
+    }
+}
+
+// TLSv1.3 uses a single 12 byte nonce; the kernel wants it split as 4 bytes of salt and 8 bytes of iv
+template <typename CryptoInfo>
+bool set_gcm_crypto_info(int fd, int direction, uint16_t cipher_type, const KernelTlsKeys& keys) noexcept {
+    CryptoInfo info;
+    memset(&info, 0, sizeof(info));
+    static_assert(sizeof(info.salt) + sizeof(info.iv) == sizeof(keys.iv));
+    if (keys.key_size != sizeof(info.key)) {
+        errno = EINVAL;
+        return false;
+    }
+    info.info.version = TLS_1_3_VERSION;
+    info.info.cipher_type = cipher_type;
+    memcpy(info.key, keys.key, sizeof(info.key));
+    memcpy(info.salt, keys.iv, sizeof(info.salt));
+    memcpy(info.iv, keys.iv + sizeof(info.salt), sizeof(info.iv));
+    store_sequence(info.rec_seq, keys.sequence);
+    bool ok = (::setsockopt(fd, SOL_TLS, direction, &info, sizeof(info)) == 0);
+    secure_memzero(&info, sizeof(info));
+    return ok;
+}
+
+#ifdef TLS_CIPHER_CHACHA20_POLY1305
+bool set_chacha_crypto_info(int fd, int direction, const KernelTlsKeys& keys) noexcept {
+    tls12_crypto_info_chacha20_poly1305 info;
+    memset(&info, 0, sizeof(info));
+    static_assert(sizeof(info.iv) == sizeof(keys.iv));
+    if (keys.key_size != sizeof(info.key)) {
+        errno = EINVAL;
+        return false;
+    }
+    info.info.version = TLS_1_3_VERSION;
+    info.info.cipher_type = TLS_CIPHER_CHACHA20_POLY1305;
+    memcpy(info.key, keys.key, sizeof(info.key));
+    memcpy(info.iv, keys.iv, sizeof(info.iv));
+    store_sequence(info.rec_seq, keys.sequence);
+    bool ok = (::setsockopt(fd, SOL_TLS, direction, &info, sizeof(info)) == 0);
+    secure_memzero(&info, sizeof(info));
+    return ok;
+}
+#endif
+
+}
+
+bool kernel_tls_is_supported() noexcept {
+    return true;
+}
+
+bool attach_kernel_tls(int fd) noexcept {
+    return (::setsockopt(fd, SOL_TCP, TCP_ULP, "tls", sizeof("tls")) == 0);
+}
+
+bool install_kernel_tls_keys(int fd, const KernelTlsKeys& keys, bool tx) noexcept {
+    const int direction = tx ? TLS_TX : TLS_RX;
+    switch (keys.cipher) {
+    case KernelTlsKeys::Cipher::AES_128_GCM:
+        return set_gcm_crypto_info<tls12_crypto_info_aes_gcm_128>(fd, direction, TLS_CIPHER_AES_GCM_128, keys);
+    case KernelTlsKeys::Cipher::AES_256_GCM:
+        return set_gcm_crypto_info<tls12_crypto_info_aes_gcm_256>(fd, direction, TLS_CIPHER_AES_GCM_256, keys);
+    case KernelTlsKeys::Cipher::CHACHA20_POLY1305:
+#ifdef TLS_CIPHER_CHACHA20_POLY1305
+        return set_chacha_crypto_info(fd, direction, keys);
+#else
+        break;
+#endif
+    }
+    errno = ENOTSUP;
+    return false;
+}
+
+ssize_t kernel_tls_read(int fd, char* buf, size_t len, bool& got_close_notify) noexcept {
+    for (;;) {
+        char control[CMSG_SPACE(sizeof(unsigned char))];
+        struct iovec iov = {buf, len};
+        struct msghdr msg;
+        memset(&msg, 0, sizeof(msg));
+        msg.msg_iov = &iov;
+        msg.msg_iovlen = 1;
+        msg.msg_control = control;
+        msg.msg_controllen = sizeof(control);
+        ssize_t res = ::recvmsg(fd, &msg, 0);
+        if (res == 0) {
+            errno = EIO; // truncated stream; peer did not send close_notify
+            return -1;
+        }
+        if (res < 0) {
+            return res;
+        }
+        const struct cmsghdr* cmsg = CMSG_FIRSTHDR(&msg);
+        if ((cmsg == nullptr) || (cmsg->cmsg_level != SOL_TLS) || (cmsg->cmsg_type != TLS_GET_RECORD_TYPE)) {
+            return res;
+        }
+        const uint8_t record_type = *reinterpret_cast<const unsigned char*>(CMSG_DATA(cmsg));
+        if (record_type == application_data_record) {
+            return res;
+        }
+        if ((record_type == alert_record) && (res >= 2) && (static_cast<uint8_t>(buf[1]) == close_notify_alert)) {
+            got_close_notify = true;
+            return 0;
+        }
+        if ((record_type == handshake_record) && (static_cast<uint8_t>(buf[0]) == new_session_ticket_message)) {
+            continue; // Session resumption is not used
+        }
+        // Fatal alerts and handshake messages we cannot act on (such as key updates)
+        errno = EIO;
+        return -1;
+    }
+}
+
+ssize_t kernel_tls_send_close_notify(int fd) noexcept {
+    unsigned char alert[2] = {alert_level_warning, close_notify_alert};
+    char control[CMSG_SPACE(sizeof(unsigned char))];
+    memset(control, 0, sizeof(control));
+    struct iovec iov = {alert, sizeof(alert)};
+    struct msghdr msg;
+    memset(&msg, 0, sizeof(msg));
+    msg.msg_iov = &iov;
+    msg.msg_iovlen = 1;
+    msg.msg_control = control;
+    msg.msg_controllen = sizeof(control);
+    struct cmsghdr* cmsg = CMSG_FIRSTHDR(&msg);
+    cmsg->cmsg_level = SOL_TLS;
+    cmsg->cmsg_type = TLS_SET_RECORD_TYPE;
+    cmsg->cmsg_len = CMSG_LEN(sizeof(unsigned char));
+    *reinterpret_cast<unsigned char*>(CMSG_DATA(cmsg)) = alert_record;
+    msg.msg_controllen = cmsg->cmsg_len;
+    return ::sendmsg(fd, &msg, MSG_NOSIGNAL);
+}
+
+#else // VESPA_KERNEL_TLS
+
+bool kernel_tls_is_supported() noexcept {
+    return false;
+}
+
+bool attach_kernel_tls(int) noexcept {
+    errno = ENOTSUP;
+    return false;
+}
+
+bool install_kernel_tls_keys(int, const KernelTlsKeys&, bool) noexcept {
+    errno = ENOTSUP;
+    return false;
+}
+
+ssize_t kernel_tls_read(int, char*, size_t, bool&) noexcept {
+    errno = ENOTSUP;
+    return -1;
+}
+
+ssize_t kernel_tls_send_close_notify(int) noexcept {
+    errno = ENOTSUP;
+    return -1;
+}
+
+#endif // VESPA_KERNEL_TLS
+
+}
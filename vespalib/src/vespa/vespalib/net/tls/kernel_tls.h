@@ -0,0 +1,61 @@
+// Copyright Vespa.ai. Licensed under the terms of the Apache 2.0 license. See LICENSE in the project root.
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <sys/types.h>
+
+namespace vespalib::net::tls {
+
+/*
+ * Symmetric record protection state for one direction of an established
+ * TLSv1.3 session, in the form expected by the kernel TLS (kTLS) record
+ * layer. Key material is wiped on destruction.
+ */
+struct KernelTlsKeys {
+    enum class Cipher {
+        AES_128_GCM,
+        AES_256_GCM,
+        CHACHA20_POLY1305
+    };
+    Cipher   cipher;
+    uint8_t  key[32];
+    size_t   key_size;
+    uint8_t  iv[12];
+    uint64_t sequence;
+
+    KernelTlsKeys() noexcept;
+    KernelTlsKeys(const KernelTlsKeys&) = delete;
+    KernelTlsKeys& operator=(const KernelTlsKeys&) = delete;
+    ~KernelTlsKeys();
+};
+
+/*
+ * Thin wrappers around the Linux kTLS socket interface. All functions fail
+ * gracefully (return false/-1 with errno set) when kTLS is not available,
+ * either because of the platform we were built for or the running kernel.
+ */
+
+// Whether this binary was built with kTLS support at all.
+[[nodiscard]] bool kernel_tls_is_supported() noexcept;
+
+// Attaches the TLS upper layer protocol to a connected TCP socket. Until keys
+// are installed for a direction, data passes through that direction unchanged.
+[[nodiscard]] bool attach_kernel_tls(int fd) noexcept;
+
+// Installs keys for transmitting (tx == true) or receiving on a socket that has
+// kTLS attached. After this, the kernel encrypts or decrypts all records in
+// that direction, starting at keys.sequence.
+[[nodiscard]] bool install_kernel_tls_keys(int fd, const KernelTlsKeys& keys, bool tx) noexcept;
+
+// Reads application data from a socket with kernel decryption enabled, with
+// normal read semantics. Post-handshake session tickets are skipped. If the
+// peer sends close_notify, got_close_notify is set and 0 (EOF) is returned.
+// Any other control record, or EOF without close_notify, fails with EIO.
+ssize_t kernel_tls_read(int fd, char* buf, size_t len, bool& got_close_notify) noexcept;
+
+// Sends a close_notify alert through a socket with kernel encryption enabled.
+// Returns a positive value on success, otherwise -1 with errno set.
+ssize_t kernel_tls_send_close_notify(int fd) noexcept;
+
+}
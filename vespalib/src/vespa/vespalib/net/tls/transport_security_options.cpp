@@ -10,9 +10,12 @@ TransportSecurityOptions::TransportSecurityOptions(Params params)
     : _ca_certs_pem(std::move(params._ca_certs_pem)),
       _cert_chain_pem(std::move(params._cert_chain_pem)),
       _private_key_pem(std::move(params._private_key_pem)),
+      _session_ticket_keys(std::move(params._session_ticket_keys)),
       _authorized_peers(std::move(params._authorized_peers)),
       _accepted_ciphers(std::move(params._accepted_ciphers)),
-      _disable_hostname_validation(params._disable_hostname_validation)
+      _disable_hostname_validation(params._disable_hostname_validation),
+      _enable_kernel_tls(params._enable_kernel_tls),
+      _enable_session_resumption(params._enable_session_resumption)
 {
 }
 
@@ -20,12 +23,17 @@ TransportSecurityOptions::TransportSecurityOptions(vespalib::string ca_certs_pem
                                                    vespalib::string cert_chain_pem,
                                                    vespalib::string private_key_pem,
                                                    AuthorizedPeers authorized_peers,
-                                                   bool disable_hostname_validation)
+                                                   bool disable_hostname_validation,
+                                                   bool enable_kernel_tls,
+                                                   bool enable_session_resumption)
     : _ca_certs_pem(std::move(ca_certs_pem)),
       _cert_chain_pem(std::move(cert_chain_pem)),
       _private_key_pem(std::move(private_key_pem)),
+      _session_ticket_keys(),
       _authorized_peers(std::move(authorized_peers)),
-      _disable_hostname_validation(disable_hostname_validation)
+      _disable_hostname_validation(disable_hostname_validation),
+      _enable_kernel_tls(enable_kernel_tls),
+      _enable_session_resumption(enable_session_resumption)
 {
 }
 
@@ -35,11 +43,13 @@ TransportSecurityOptions& TransportSecurityOptions::operator=(TransportSecurityO
 
 TransportSecurityOptions::~TransportSecurityOptions() {
     secure_memzero(&_private_key_pem[0], _private_key_pem.size());
+    secure_memzero(&_session_ticket_keys[0], _session_ticket_keys.size());
 }
 
 TransportSecurityOptions TransportSecurityOptions::copy_without_private_key() const {
     return TransportSecurityOptions(_ca_certs_pem, _cert_chain_pem, "",
-                                    _authorized_peers, _disable_hostname_validation);
+                                    _authorized_peers, _disable_hostname_validation, _enable_kernel_tls,
+                                    _enable_session_resumption);
 }
 
 void secure_memzero(void* buf, size_t size) noexcept {
@@ -50,14 +60,18 @@ TransportSecurityOptions::Params::Params()
     : _ca_certs_pem(),
       _cert_chain_pem(),
       _private_key_pem(),
+      _session_ticket_keys(),
       _authorized_peers(),
       _accepted_ciphers(),
-      _disable_hostname_validation(false)
+      _disable_hostname_validation(false),
+      _enable_kernel_tls(false),
+      _enable_session_resumption(false)
 {
 }
 
 TransportSecurityOptions::Params::~Params() {
     secure_memzero(&_private_key_pem[0], _private_key_pem.size());
+    secure_memzero(&_session_ticket_keys[0], _session_ticket_keys.size());
 }
 
 TransportSecurityOptions::Params::Params(const Params&) = default;
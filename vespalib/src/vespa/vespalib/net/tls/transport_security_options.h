@@ -12,17 +12,23 @@ class TransportSecurityOptions {
     vespalib::string _ca_certs_pem;
     vespalib::string _cert_chain_pem;
     vespalib::string _private_key_pem;
+    vespalib::string _session_ticket_keys;
     AuthorizedPeers  _authorized_peers;
     std::vector<vespalib::string> _accepted_ciphers;
     bool _disable_hostname_validation;
+    bool _enable_kernel_tls;
+    bool _enable_session_resumption;
 public:
     struct Params {
         vespalib::string _ca_certs_pem;
         vespalib::string _cert_chain_pem;
         vespalib::string _private_key_pem;
+        vespalib::string _session_ticket_keys;
         AuthorizedPeers  _authorized_peers;
         std::vector<vespalib::string> _accepted_ciphers;
         bool _disable_hostname_validation;
+        bool _enable_kernel_tls;
+        bool _enable_session_resumption;
 
         Params();
         ~Params();
@@ -34,6 +40,7 @@ public:
         Params& ca_certs_pem(vespalib::stringref pem) { _ca_certs_pem = pem; return *this; }
         Params& cert_chain_pem(vespalib::stringref pem) { _cert_chain_pem = pem; return *this; }
         Params& private_key_pem(vespalib::stringref pem) { _private_key_pem = pem; return *this; }
+        Params& session_ticket_keys(vespalib::stringref keys) { _session_ticket_keys = keys; return *this; }
         Params& authorized_peers(AuthorizedPeers auth) { _authorized_peers = std::move(auth); return *this; }
         Params& accepted_ciphers(std::vector<vespalib::string> ciphers) {
             _accepted_ciphers = std::move(ciphers);
@@ -43,6 +50,14 @@ public:
             _disable_hostname_validation = disable;
             return *this;
         }
+        Params& enable_kernel_tls(bool enable) {
+            _enable_kernel_tls = enable;
+            return *this;
+        }
+        Params& enable_session_resumption(bool enable) {
+            _enable_session_resumption = enable;
+            return *this;
+        }
     };
 
     explicit TransportSecurityOptions(Params params);
@@ -56,18 +71,29 @@ public:
     const vespalib::string& ca_certs_pem() const noexcept { return _ca_certs_pem; }
     const vespalib::string& cert_chain_pem() const noexcept { return _cert_chain_pem; }
     const vespalib::string& private_key_pem() const noexcept { return _private_key_pem; }
+    // Raw session ticket key material, see impl::SessionTicketKeys. If empty, random
+    // keys shared by all TLS contexts in the process are used instead.
+    const vespalib::string& session_ticket_keys() const noexcept { return _session_ticket_keys; }
     const AuthorizedPeers& authorized_peers() const noexcept { return _authorized_peers; }
 
+    // Also drops the session ticket keys, which are just as secret as the private key
     TransportSecurityOptions copy_without_private_key() const;
     const std::vector<vespalib::string>& accepted_ciphers() const noexcept { return _accepted_ciphers; }
     bool disable_hostname_validation() const noexcept { return _disable_hostname_validation; }
+    // Hand record protection over to the kernel (kTLS) after handshaking, where supported
+    bool enable_kernel_tls() const noexcept { return _enable_kernel_tls; }
+    // Let clients resume earlier sessions with a peer using session tickets instead of
+    // doing a full handshake on every reconnect
+    bool enable_session_resumption() const noexcept { return _enable_session_resumption; }
 
 private:
     TransportSecurityOptions(vespalib::string ca_certs_pem,
                              vespalib::string cert_chain_pem,
                              vespalib::string private_key_pem,
                              AuthorizedPeers authorized_peers,
-                             bool disable_hostname_validation);
+                             bool disable_hostname_validation,
+                             bool enable_kernel_tls,
+                             bool enable_session_resumption);
 };
 
 // Zeroes out `size` bytes in `buf` in a way that shall never be optimized
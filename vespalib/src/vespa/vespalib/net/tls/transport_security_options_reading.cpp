@@ -6,6 +6,7 @@
 #include <vespa/vespalib/io/mapped_file_input.h>
 #include <vespa/vespalib/data/memory_input.h>
 #include <vespa/vespalib/net/tls/capability_set.h>
+#include <vespa/vespalib/net/tls/impl/session_ticket_keys.h>
 #include <vespa/vespalib/stllike/hash_set.h>
 #include <filesystem>
 
@@ -19,7 +20,8 @@ namespace vespalib::net::tls {
   "files": {
     "private-key": "myhost.key",
     "ca-certificates": "my_cas.pem",
-    "certificates": "certs.pem"
+    "certificates": "certs.pem",
+    "session-ticket-keys": "ticket.keys"
   },
   "authorized-peers": [
     {
@@ -54,6 +56,24 @@ vespalib::string load_file_referenced_by_field(const Inspector& cursor, const ch
     return File::readAll(file_path);
 }
 
+// Session ticket keys are optional, and only make sense with session resumption enabled.
+// Unlike the other files, the size of the key file is verified up front, since a truncated
+// key file would otherwise only be detected once the first TLS context is created.
+vespalib::string load_session_ticket_keys(const Inspector& files) {
+    if (!files["session-ticket-keys"].valid()) {
+        return {};
+    }
+    auto keys = load_file_referenced_by_field(files, "session-ticket-keys");
+    if (keys.empty() || (keys.size() % impl::SessionTicketKey::serialized_size) != 0) {
+        size_t size = keys.size();
+        secure_memzero(&keys[0], keys.size());
+        throw IllegalArgumentException(make_string("TLS session ticket key file must contain a non-zero multiple "
+                                                   "of %zu bytes, but has %zu bytes",
+                                                   impl::SessionTicketKey::serialized_size, size));
+    }
+    return keys;
+}
+
 RequiredPeerCredential parse_peer_credential(const Inspector& req_entry) {
     auto field_string = req_entry["field"].asString().make_string();
     RequiredPeerCredential::Field field;
@@ -150,6 +170,7 @@ std::unique_ptr<TransportSecurityOptions> load_from_input(Input& input) {
     auto ca_certs = load_file_referenced_by_field(files, "ca-certificates");
     auto certs    = load_file_referenced_by_field(files, "certificates");
     auto priv_key = load_file_referenced_by_field(files, "private-key");
+    auto ticket_keys = load_session_ticket_keys(files);
     auto authorized_peers = parse_authorized_peers(root["authorized-peers"]);
     auto accepted_ciphers = parse_accepted_ciphers(root["accepted-ciphers"]);
     // FIXME this is temporary until we know it won't break a bunch of things!
@@ -158,16 +179,28 @@ std::unique_ptr<TransportSecurityOptions> load_from_input(Input& input) {
     if (root["disable-hostname-validation"].valid()) {
         disable_hostname_validation = root["disable-hostname-validation"].asBool();
     }
+    bool enable_kernel_tls = false;
+    if (root["enable-kernel-tls"].valid()) {
+        enable_kernel_tls = root["enable-kernel-tls"].asBool();
+    }
+    bool enable_session_resumption = false;
+    if (root["enable-session-resumption"].valid()) {
+        enable_session_resumption = root["enable-session-resumption"].asBool();
+    }
 
     auto options = std::make_unique<TransportSecurityOptions>(
             TransportSecurityOptions::Params()
                 .ca_certs_pem(ca_certs)
                 .cert_chain_pem(certs)
                 .private_key_pem(priv_key)
+                .session_ticket_keys(ticket_keys)
                 .authorized_peers(std::move(authorized_peers))
                 .accepted_ciphers(std::move(accepted_ciphers))
-                .disable_hostname_validation(disable_hostname_validation));
+                .disable_hostname_validation(disable_hostname_validation)
+                .enable_kernel_tls(enable_kernel_tls)
+                .enable_session_resumption(enable_session_resumption));
     secure_memzero(&priv_key[0], priv_key.size());
+    secure_memzero(&ticket_keys[0], ticket_keys.size());
     return options;
 }
 
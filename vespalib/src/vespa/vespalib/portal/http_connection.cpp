@@ -113,6 +113,12 @@ void emit_http_security_headers(OutputWriter &dst) {
     dst.printf("Pragma: no-cache\r\n");
 }
 
+void emit_etag(OutputWriter &dst, vespalib::stringref etag) {
+    dst.printf("ETag: \"");
+    dst.write(etag.data(), etag.size());
+    dst.printf("\"\r\n");
+}
+
 } // namespace vespalib::portal::<unnamed>
 
 void
@@ -246,7 +252,9 @@ HttpConnection::handle_event(bool, bool)
 
 void
 HttpConnection::respond_with_content(vespalib::stringref content_type,
-                                     vespalib::stringref content)
+                                     vespalib::stringref content,
+                                     vespalib::stringref etag,
+                                     vespalib::stringref content_encoding)
 {
     {
         OutputWriter dst(_output, CHUNK_SIZE);
@@ -256,6 +264,15 @@ HttpConnection::respond_with_content(vespalib::stringref content_type,
         dst.write(content_type.data(), content_type.size());
         dst.printf("\r\n");
         dst.printf("Content-Length: %zu\r\n", content.size());
+        if (!content_encoding.empty()) {
+            dst.printf("Content-Encoding: ");
+            dst.write(content_encoding.data(), content_encoding.size());
+            dst.printf("\r\n");
+            dst.printf("Vary: Accept-Encoding\r\n");
+        }
+        if (!etag.empty()) {
+            emit_etag(dst, etag);
+        }
         emit_http_security_headers(dst);
         dst.printf("\r\n");
         dst.write(content.data(), content.size());
@@ -264,6 +281,20 @@ HttpConnection::respond_with_content(vespalib::stringref content_type,
     _reply_ready.store(true, std::memory_order_release);
 }
 
+void
+HttpConnection::respond_not_modified(vespalib::stringref etag)
+{
+    {
+        OutputWriter dst(_output, CHUNK_SIZE);
+        dst.printf("HTTP/1.1 304 Not Modified\r\n");
+        dst.printf("Connection: close\r\n");
+        emit_etag(dst, etag);
+        dst.printf("\r\n");
+    }
+    _token->update(false, true);
+    _reply_ready.store(true, std::memory_order_release);
+}
+
 void
 HttpConnection::respond_with_error(int code, vespalib::stringref msg)
 {
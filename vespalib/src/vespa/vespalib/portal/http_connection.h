@@ -54,7 +54,10 @@ public:
     const net::ConnectionAuthContext &auth_context() const noexcept { return *_auth_ctx; }
 
     void respond_with_content(vespalib::stringref content_type,
-                              vespalib::stringref content);
+                              vespalib::stringref content,
+                              vespalib::stringref etag,
+                              vespalib::stringref content_encoding);
+    void respond_not_modified(vespalib::stringref etag);
     void respond_with_error(int code, const vespalib::stringref msg);
 };
 
@@ -80,9 +80,26 @@ Portal::GetRequest::export_params() const
 void
 Portal::GetRequest::respond_with_content(vespalib::stringref content_type,
                                          vespalib::stringref content)
+{
+    respond_with_content(content_type, content, vespalib::stringref(), vespalib::stringref());
+}
+
+void
+Portal::GetRequest::respond_with_content(vespalib::stringref content_type,
+                                         vespalib::stringref content,
+                                         vespalib::stringref etag,
+                                         vespalib::stringref content_encoding)
+{
+    assert(active());
+    _conn->respond_with_content(content_type, content, etag, content_encoding);
+    _conn = nullptr;
+}
+
+void
+Portal::GetRequest::respond_not_modified(vespalib::stringref etag)
 {
     assert(active());
-    _conn->respond_with_content(content_type, content);
+    _conn->respond_not_modified(etag);
     _conn = nullptr;
 }
 
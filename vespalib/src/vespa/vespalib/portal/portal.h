@@ -67,6 +67,13 @@ public:
         std::map<vespalib::string, vespalib::string> export_params() const;
         void respond_with_content(vespalib::stringref content_type,
                                   vespalib::stringref content);
+        // The (unquoted) entity tag lets clients make conditional requests;
+        // a non-empty content encoding (e.g. "gzip") tells how the content is encoded
+        void respond_with_content(vespalib::stringref content_type,
+                                  vespalib::stringref content,
+                                  vespalib::stringref etag,
+                                  vespalib::stringref content_encoding);
+        void respond_not_modified(vespalib::stringref etag);
         void respond_with_error(int code, vespalib::stringref msg);
         const net::ConnectionAuthContext &auth_context() const noexcept;
         ~GetRequest();
@@ -0,0 +1,601 @@
+// Copyright Vespa.ai. Licensed under the terms of the Apache 2.0 license. See LICENSE in the project root.
+
+#include "regex_automaton.h"
+#include <vespa/vespalib/text/lowercase.h>
+#include <vespa/vespalib/text/utf8.h>
+#include <algorithm>
+#include <cctype>
+#include <utility>
+
+namespace vespalib {
+
+namespace {
+
+constexpr uint32_t max_code_point = 0x10FFFF;
+// Upper bounds protecting against pathological patterns; the automaton is then simply not used.
+constexpr size_t max_states = 100000;
+constexpr uint32_t max_nesting_depth = 1000;
+
+using Intervals = std::vector<std::pair<uint32_t, uint32_t>>;
+
+void
+normalize(Intervals& intervals)
+{
+    std::sort(intervals.begin(), intervals.end());
+    Intervals result;
+    for (const auto& interval : intervals) {
+        if (!result.empty() && interval.first <= result.back().second + 1) {
+            result.back().second = std::max(result.back().second, interval.second);
+        } else {
+            result.push_back(interval);
+        }
+    }
+    intervals.swap(result);
+}
+
+// Expects normalized intervals
+Intervals
+complement(const Intervals& intervals)
+{
+    Intervals result;
+    uint32_t next = 0;
+    for (const auto& interval : intervals) {
+        if (interval.first > next) {
+            result.emplace_back(next, interval.first - 1);
+        }
+        next = interval.second + 1;
+    }
+    if (next <= max_code_point) {
+        result.emplace_back(next, max_code_point);
+    }
+    return result;
+}
+
+/*
+ * Widens a character set for matching lowercased input. ASCII upper case letters are
+ * replaced by their lower case counterparts. Non-ASCII code points are always accepted,
+ * as the lowercasing of the input might differ from the case folding used by the regex
+ * engine. The only non-ASCII code points related to ASCII letters are LATIN SMALL LETTER
+ * LONG S and KELVIN SIGN (case folding) and LATIN CAPITAL LETTER I WITH DOT ABOVE (lowercasing).
+ */
+void
+widen_uncased(Intervals& intervals)
+{
+    Intervals result;
+    for (const auto& interval : intervals) {
+        uint32_t lo = std::max(interval.first, uint32_t('A'));
+        uint32_t hi = std::min(interval.second, uint32_t('Z'));
+        if (lo <= hi) {
+            result.emplace_back(lo + ('a' - 'A'), hi + ('a' - 'A'));
+        }
+        if (interval.first < 'A') {
+            result.emplace_back(interval.first, std::min(interval.second, uint32_t('A' - 1)));
+        }
+        if (interval.second > 'Z') {
+            result.emplace_back(std::max(interval.first, uint32_t('Z' + 1)), interval.second);
+        }
+        for (auto [code_point, ascii_letter] : {std::pair<uint32_t, uint32_t>{0x0130, 'i'}, {0x017F, 's'}, {0x212A, 'k'}}) {
+            if (interval.first <= code_point && interval.second >= code_point) {
+                result.emplace_back(ascii_letter, ascii_letter);
+            }
+        }
+    }
+    result.emplace_back(0x80, max_code_point);
+    normalize(result);
+    intervals.swap(result);
+}
+
+}
+
+/**
+ * Recursive descent parser for the RE2 syntax, building the automaton using
+ * Thompson's construction. Each parsed construct is a fragment with a start
+ * state and an end state that has no outgoing edges yet.
+ */
+class RegexAutomaton::Builder {
+    struct Fragment {
+        uint32_t start;
+        uint32_t end;
+    };
+    RegexAutomaton&       _automaton;
+    std::vector<uint32_t> _pattern;
+    size_t                _pos;
+    bool                  _ok;
+
+    [[nodiscard]] bool more() const noexcept { return _pos < _pattern.size(); }
+    [[nodiscard]] uint32_t peek(size_t offset = 0) const noexcept {
+        return (_pos + offset < _pattern.size()) ? _pattern[_pos + offset] : 0;
+    }
+    uint32_t next() noexcept { return more() ? _pattern[_pos++] : 0; }
+    Fragment fail() noexcept {
+        _ok = false;
+        return empty();
+    }
+
+    uint32_t new_state() {
+        if (_automaton._states.size() >= max_states) {
+            _ok = false;
+        }
+        _automaton._states.emplace_back();
+        return _automaton._states.size() - 1;
+    }
+    void add_epsilon(uint32_t from, uint32_t to, bool begin_only = false) {
+        _automaton._states[from].epsilons.push_back(Epsilon{to, begin_only});
+    }
+    Fragment empty() {
+        uint32_t state = new_state();
+        return {state, state};
+    }
+    Fragment begin_anchor() {
+        Fragment result{new_state(), new_state()};
+        add_epsilon(result.start, result.end, true);
+        return result;
+    }
+    Fragment chars(Intervals intervals) {
+        if (_automaton._casing == Casing::Uncased) {
+            widen_uncased(intervals);
+        }
+        Fragment result{new_state(), new_state()};
+        for (const auto& interval : intervals) {
+            _automaton._states[result.start].transitions.push_back(Transition{interval.first, interval.second, result.end});
+        }
+        return result;
+    }
+    Fragment concat(Fragment lhs, Fragment rhs) {
+        add_epsilon(lhs.end, rhs.start);
+        return {lhs.start, rhs.end};
+    }
+    Fragment alternate(Fragment lhs, Fragment rhs) {
+        Fragment result{new_state(), new_state()};
+        add_epsilon(result.start, lhs.start);
+        add_epsilon(result.start, rhs.start);
+        add_epsilon(lhs.end, result.end);
+        add_epsilon(rhs.end, result.end);
+        return result;
+    }
+    Fragment repeat(Fragment inner, bool allow_none, bool allow_many) {
+        Fragment result{new_state(), new_state()};
+        add_epsilon(result.start, inner.start);
+        add_epsilon(inner.end, result.end);
+        if (allow_none) {
+            add_epsilon(result.start, result.end);
+        }
+        if (allow_many) {
+            add_epsilon(inner.end, inner.start);
+        }
+        return result;
+    }
+
+    bool parse_hex(uint32_t& value);
+    bool parse_counted_repetition(uint32_t& min_count);
+    bool parse_escape(Intervals& intervals, bool in_class, Fragment* zero_width);
+    Fragment parse_class();
+    Fragment parse_atom(uint32_t depth);
+    Fragment parse_repetition(uint32_t depth);
+    Fragment parse_concatenation(uint32_t depth);
+    Fragment parse_alternation(uint32_t depth);
+public:
+    Builder(RegexAutomaton& automaton, std::string_view pattern);
+    bool build();
+};
+
+RegexAutomaton::Builder::Builder(RegexAutomaton& automaton, std::string_view pattern)
+    : _automaton(automaton),
+      _pattern(),
+      _pos(0),
+      _ok(true)
+{
+    Utf8Reader reader(pattern.data(), pattern.size());
+    while (reader.hasMore()) {
+        _pattern.push_back(reader.getChar());
+    }
+}
+
+bool
+RegexAutomaton::Builder::parse_hex(uint32_t& value)
+{
+    bool braced = (peek() == '{');
+    if (braced) {
+        next();
+    }
+    value = 0;
+    uint32_t digits = 0;
+    while (more() && (braced ? (peek() != '}') : (digits < 2))) {
+        uint32_t c = next();
+        uint32_t digit;
+        if (c >= '0' && c <= '9') {
+            digit = c - '0';
+        } else if (c >= 'a' && c <= 'f') {
+            digit = c - 'a' + 10;
+        } else if (c >= 'A' && c <= 'F') {
+            digit = c - 'A' + 10;
+        } else {
+            return false;
+        }
+        value = value * 16 + digit;
+        if (value > max_code_point) {
+            return false;
+        }
+        ++digits;
+    }
+    if (braced && next() != '}') {
+        return false;
+    }
+    return (digits > 0) && (braced || digits == 2);
+}
+
+/*
+ * Parses {n}, {n,} or {n,m}, leaving the position unchanged if the brace does
+ * not start a repetition (it is then a literal). Only the minimum count is
+ * returned, as the repetition is widened to x* or x+.
+ */
+bool
+RegexAutomaton::Builder::parse_counted_repetition(uint32_t& min_count)
+{
+    size_t pos = 1;
+    uint32_t count = 0;
+    size_t digits = 0;
+    for (; peek(pos) >= '0' && peek(pos) <= '9'; ++pos, ++digits) {
+        count = std::min(count * 10 + (peek(pos) - '0'), 100000u);
+    }
+    if (digits == 0) {
+        return false;
+    }
+    if (peek(pos) == ',') {
+        for (++pos; peek(pos) >= '0' && peek(pos) <= '9'; ++pos) { }
+    }
+    if (peek(pos) != '}') {
+        return false;
+    }
+    _pos += pos + 1;
+    min_count = count;
+    return true;
+}
+
+/*
+ * Parses the escape sequence following a backslash into a character set.
+ * Zero width assertions (only allowed outside character classes) are returned
+ * as a fragment instead.
+ */
+bool
+RegexAutomaton::Builder::parse_escape(Intervals& intervals, bool in_class, Fragment* zero_width)
+{
+    uint32_t c = next();
+    switch (c) {
+    case 'd': intervals.emplace_back('0', '9'); return true;
+    case 'D': intervals = complement({{'0', '9'}}); return true;
+    case 's': intervals.insert(intervals.end(), {{'\t', '\n'}, {'\f', '\r'}, {' ', ' '}}); return true;
+    case 'S': intervals = complement({{'\t', '\n'}, {'\f', '\r'}, {' ', ' '}}); return true;
+    case 'w': intervals.insert(intervals.end(), {{'0', '9'}, {'A', 'Z'}, {'_', '_'}, {'a', 'z'}}); return true;
+    case 'W': intervals = complement({{'0', '9'}, {'A', 'Z'}, {'_', '_'}, {'a', 'z'}}); return true;
+    case 'a': intervals.emplace_back(0x07, 0x07); return true;
+    case 'f': intervals.emplace_back('\f', '\f'); return true;
+    case 't': intervals.emplace_back('\t', '\t'); return true;
+    case 'n': intervals.emplace_back('\n', '\n'); return true;
+    case 'r': intervals.emplace_back('\r', '\r'); return true;
+    case 'v': intervals.emplace_back('\v', '\v'); return true;
+    case 'x': {
+        uint32_t value;
+        if (!parse_hex(value)) {
+            return false;
+        }
+        intervals.emplace_back(value, value);
+        return true;
+    }
+    case 'p':
+    case 'P':
+        // Unicode classes are widened to any code point
+        if (in_class) {
+            return false;
+        }
+        if (peek() == '{') {
+            while (more() && next() != '}') { }
+        } else {
+            next();
+        }
+        intervals.emplace_back(0, max_code_point);
+        return true;
+    case 'A':
+    case 'z':
+    case 'b':
+    case 'B':
+        if (in_class) {
+            return false;
+        }
+        *zero_width = (c == 'A') ? begin_anchor() : empty();
+        return true;
+    default:
+        if (c == 0 || (c < 0x80 && std::isalnum(c))) {
+            // Octal codes, \C, \Q...\E and unknown escapes
+            return false;
+        }
+        intervals.emplace_back(c, c);
+        return true;
+    }
+}
+
+RegexAutomaton::Builder::Fragment
+RegexAutomaton::Builder::parse_class()
+{
+    bool negated = (peek() == '^');
+    if (negated) {
+        next();
+    }
+    Intervals intervals;
+    for (bool first = true; ; first = false) {
+        if (!more()) {
+            return fail();
+        }
+        uint32_t lo = next();
+        if (lo == ']' && !first) {
+            break;
+        }
+        if (lo == '[' && peek() == ':') {
+            return fail(); // POSIX classes
+        }
+        if (lo == '\\') {
+            Intervals escaped;
+            if (!parse_escape(escaped, true, nullptr)) {
+                return fail();
+            }
+            if (escaped.size() != 1 || escaped[0].first != escaped[0].second) {
+                intervals.insert(intervals.end(), escaped.begin(), escaped.end());
+                continue;
+            }
+            lo = escaped[0].first;
+        }
+        uint32_t hi = lo;
+        if (peek() == '-' && peek(1) != ']' && _pos + 1 < _pattern.size()) {
+            next();
+            hi = next();
+            if (hi == '\\') {
+                Intervals escaped;
+                if (!parse_escape(escaped, true, nullptr) || escaped.size() != 1 || escaped[0].first != escaped[0].second) {
+                    return fail();
+                }
+                hi = escaped[0].first;
+            }
+            if (hi < lo) {
+                return fail();
+            }
+        }
+        intervals.emplace_back(lo, hi);
+    }
+    normalize(intervals);
+    return chars(negated ? complement(intervals) : intervals);
+}
+
+RegexAutomaton::Builder::Fragment
+RegexAutomaton::Builder::parse_atom(uint32_t depth)
+{
+    uint32_t c = next();
+    switch (c) {
+    case '(': {
+        if (peek() == '?') {
+            next();
+            if (peek() == 'P' && peek(1) == '<') {
+                next();
+            }
+            if (peek() == '<') {
+                while (more() && next() != '>') { }
+            } else if (next() != ':') {
+                return fail(); // Flags
+            }
+        }
+        Fragment inner = parse_alternation(depth + 1);
+        if (next() != ')') {
+            return fail();
+        }
+        return inner;
+    }
+    case '[':
+        return parse_class();
+    case '.':
+        return chars({{0, max_code_point}});
+    case '^':
+        return begin_anchor();
+    case '$':
+        return empty();
+    case '\\': {
+        Intervals intervals;
+        Fragment zero_width{0, 0};
+        if (!parse_escape(intervals, false, &zero_width)) {
+            return fail();
+        }
+        return intervals.empty() ? zero_width : chars(std::move(intervals));
+    }
+    case ')':
+    case '*':
+    case '+':
+    case '?':
+        return fail();
+    default:
+        return chars({{c, c}});
+    }
+}
+
+RegexAutomaton::Builder::Fragment
+RegexAutomaton::Builder::parse_repetition(uint32_t depth)
+{
+    Fragment result = parse_atom(depth);
+    while (_ok && more()) {
+        uint32_t c = peek();
+        uint32_t min_count = 0;
+        if (c == '*' || c == '+' || c == '?') {
+            next();
+            result = repeat(result, c != '+', c != '?');
+        } else if (c == '{' && parse_counted_repetition(min_count)) {
+            // x{n,m} is widened to x* or x+, which accept a superset of the strings
+            result = repeat(result, min_count == 0, true);
+        } else {
+            break;
+        }
+        if (peek() == '?') {
+            next(); // Non-greedy, which does not change the set of matched strings
+        }
+    }
+    return result;
+}
+
+RegexAutomaton::Builder::Fragment
+RegexAutomaton::Builder::parse_concatenation(uint32_t depth)
+{
+    Fragment result = empty();
+    while (_ok && more() && peek() != '|' && peek() != ')') {
+        result = concat(result, parse_repetition(depth));
+    }
+    return result;
+}
+
+RegexAutomaton::Builder::Fragment
+RegexAutomaton::Builder::parse_alternation(uint32_t depth)
+{
+    if (depth > max_nesting_depth) {
+        return fail();
+    }
+    Fragment result = parse_concatenation(depth);
+    while (_ok && peek() == '|' && more()) {
+        next();
+        result = alternate(result, parse_concatenation(depth));
+    }
+    return result;
+}
+
+bool
+RegexAutomaton::Builder::build()
+{
+    Fragment fragment = parse_alternation(0);
+    if (!_ok || more()) {
+        return false;
+    }
+    _automaton._accept = new_state();
+    add_epsilon(fragment.end, _automaton._accept);
+    // A partial match accepts anything after the matched prefix
+    _automaton._states[_automaton._accept].transitions.push_back(Transition{0, max_code_point, _automaton._accept});
+    _automaton._start = fragment.start;
+    return _ok;
+}
+
+RegexAutomaton::RegexAutomaton() noexcept
+    : _states(),
+      _start(0),
+      _accept(0),
+      _casing(Casing::Cased),
+      _valid(false)
+{
+}
+
+RegexAutomaton::RegexAutomaton(RegexAutomaton&&) noexcept = default;
+RegexAutomaton& RegexAutomaton::operator=(RegexAutomaton&&) noexcept = default;
+RegexAutomaton::~RegexAutomaton() = default;
+
+void
+RegexAutomaton::closure(std::vector<uint32_t>& states, size_t first, std::vector<bool>& seen, bool at_begin) const
+{
+    for (size_t i = first; i < states.size(); ++i) {
+        for (const auto& epsilon : _states[states[i]].epsilons) {
+            if ((at_begin || !epsilon.begin_only) && !seen[epsilon.target]) {
+                seen[epsilon.target] = true;
+                states.push_back(epsilon.target);
+            }
+        }
+    }
+}
+
+uint32_t
+RegexAutomaton::next_label(const uint32_t* first, const uint32_t* last, uint32_t c) const noexcept
+{
+    uint32_t result = beyond_unicode;
+    for (; first != last; ++first) {
+        for (const auto& transition : _states[*first].transitions) {
+            if (transition.hi > c) {
+                result = std::min(result, std::max(transition.lo, c + 1));
+            }
+        }
+    }
+    return result;
+}
+
+/*
+ * Matches starting after the first position can only be ruled out if all paths
+ * from the start state pass a begin anchor before consuming any input.
+ */
+bool
+RegexAutomaton::is_start_anchored() const
+{
+    std::vector<uint32_t> states(1, _start);
+    std::vector<bool> seen(_states.size(), false);
+    seen[_start] = true;
+    closure(states, 0, seen, false);
+    return std::all_of(states.begin(), states.end(), [this](uint32_t state) {
+        return _states[state].transitions.empty();
+    });
+}
+
+bool
+RegexAutomaton::is_viable_prefix(std::string_view word, std::vector<uint32_t>& successor) const
+{
+    // State sets after each consumed code point are kept back to back to find the successor
+    std::vector<uint32_t> states(1, _start);
+    std::vector<size_t> offsets(1, 0);
+    std::vector<uint32_t> input;
+    std::vector<bool> seen(_states.size(), false);
+    seen[_start] = true;
+    closure(states, 0, seen, true);
+    Utf8Reader reader(word.data(), word.size());
+    while (reader.hasMore()) {
+        size_t first = offsets.back();
+        size_t last = states.size();
+        for (size_t i = first; i < last; ++i) {
+            seen[states[i]] = false;
+            if (states[i] == _accept) {
+                return true;
+            }
+        }
+        uint32_t c = reader.getChar();
+        if (_casing == Casing::Uncased) {
+            c = LowerCase::convert(c);
+        }
+        input.push_back(c);
+        offsets.push_back(last);
+        for (size_t i = first; i < last; ++i) {
+            for (const auto& transition : _states[states[i]].transitions) {
+                if (c >= transition.lo && c <= transition.hi && !seen[transition.target]) {
+                    seen[transition.target] = true;
+                    states.push_back(transition.target);
+                }
+            }
+        }
+        if (states.size() == last) {
+            // No word starting with the input so far can match. Find the last position where
+            // a greater code point leads to a live state; that is the smallest viable successor.
+            for (size_t pos = input.size(); pos-- > 0; ) {
+                uint32_t label = next_label(states.data() + offsets[pos], states.data() + offsets[pos + 1], input[pos]);
+                if (label != beyond_unicode) {
+                    successor.assign(input.begin(), input.begin() + pos);
+                    successor.push_back(label);
+                    return false;
+                }
+            }
+            successor.assign(1, beyond_unicode);
+            return false;
+        }
+        closure(states, last, seen, false);
+    }
+    return true;
+}
+
+RegexAutomaton
+RegexAutomaton::build(std::string_view pattern, Casing casing)
+{
+    RegexAutomaton result;
+    result._casing = casing;
+    Builder builder(result, pattern);
+    if (!builder.build() || !result.is_start_anchored()) {
+        return {};
+    }
+    result._valid = true;
+    return result;
+}
+
+}
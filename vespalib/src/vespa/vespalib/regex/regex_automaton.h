@@ -0,0 +1,94 @@
+// Copyright Vespa.ai. Licensed under the terms of the Apache 2.0 license. See LICENSE in the project root.
+#pragma once
+
+#include <cstdint>
+#include <string_view>
+#include <vector>
+
+namespace vespalib {
+
+/**
+ * A conservative automaton compiled from a start-anchored regular expression,
+ * used to skip ranges of a sorted dictionary that cannot contain any word
+ * matched (with partial match semantics) by the expression.
+ *
+ * The expression is compiled into a Thompson NFA over code points that accepts
+ * a superset of the strings that have a match at their start. Constructs that
+ * cannot be represented exactly (word boundaries, end anchors, counted
+ * repetitions, unicode classes) are widened, so the automaton never rejects
+ * a prefix that could be extended into a match. The actual match must still
+ * be decided by vespalib::Regex.
+ *
+ * When a word is rejected, the automaton computes the smallest string greater
+ * than the word that is still a viable prefix, using the character classes
+ * reachable from each state along the word. A dictionary iterator can seek
+ * directly to this successor, pruning the whole subrange in between.
+ *
+ * Expressions that are not anchored at the start, or that use syntax not
+ * understood by the compiler (flags, quoting, back references etc.), result
+ * in an invalid automaton; such expressions must be evaluated for every word.
+ *
+ * Uncased automatons expect dictionary words to be compared on lowercased
+ * code points, and all code points at or above U+0080 are accepted in place
+ * of any letter to stay safe with respect to unicode case folding.
+ *
+ * Thread safety: a built automaton is immutable and may be used from multiple threads.
+ */
+class RegexAutomaton {
+public:
+    enum class Casing { Cased, Uncased };
+
+    // Successor returned when no dictionary word greater than the current word may match.
+    static constexpr uint32_t beyond_unicode = 0x110000;
+
+private:
+    struct Transition {
+        uint32_t lo;
+        uint32_t hi;
+        uint32_t target;
+    };
+    struct Epsilon {
+        uint32_t target;
+        bool     begin_only;
+    };
+    struct State {
+        std::vector<Transition> transitions;
+        std::vector<Epsilon>    epsilons;
+    };
+    std::vector<State> _states;
+    uint32_t           _start;
+    uint32_t           _accept;
+    Casing             _casing;
+    bool               _valid;
+
+    class Builder;
+    friend class Builder;
+
+    void closure(std::vector<uint32_t>& states, size_t first, std::vector<bool>& seen, bool at_begin) const;
+    [[nodiscard]] uint32_t next_label(const uint32_t* first, const uint32_t* last, uint32_t c) const noexcept;
+    [[nodiscard]] bool is_start_anchored() const;
+public:
+    // Default constructed automaton is invalid
+    RegexAutomaton() noexcept;
+    RegexAutomaton(RegexAutomaton&&) noexcept;
+    RegexAutomaton& operator=(RegexAutomaton&&) noexcept;
+    ~RegexAutomaton();
+
+    [[nodiscard]] bool valid() const noexcept { return _valid; }
+    [[nodiscard]] size_t num_states() const noexcept { return _states.size(); }
+
+    /**
+     * Returns true if some string starting with the UTF-8 encoded word may be
+     * matched by the expression. Otherwise, successor is set to the smallest
+     * (lowercased if uncased) code point string greater than the word which may
+     * be the prefix of a match, or to a single beyond_unicode code point if
+     * there is no such string.
+     *
+     * Must only be called on a valid automaton.
+     */
+    [[nodiscard]] bool is_viable_prefix(std::string_view word, std::vector<uint32_t>& successor) const;
+
+    [[nodiscard]] static RegexAutomaton build(std::string_view pattern, Casing casing);
+};
+
+}
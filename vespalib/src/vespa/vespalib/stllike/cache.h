@@ -5,6 +5,7 @@
 #include <vespa/vespalib/util/memoryusage.h>
 #include <atomic>
 #include <mutex>
+#include <vector>
 
 namespace vespalib {
 
@@ -98,6 +99,15 @@ public:
      */
     V read(const K & key);
 
+    /**
+     * Return the objects with the given keys. The backing store is consulted once for all the keys
+     * not in the cache, and the cache is updated with the objects found. Objects not found are empty.
+     * This requires the backing store to also implement
+     * void read(const std::vector<K> & keys, std::vector<V> & values, std::vector<bool> & found) const
+     * where values and found are sized as keys.
+     */
+    std::vector<V> read(const std::vector<K> & keys);
+
     /**
      * Update the cache and write through to backing store.
      * Object is then put at head of LRU list.
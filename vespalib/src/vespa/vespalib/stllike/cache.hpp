@@ -116,6 +116,51 @@ cache<P>::read(const K & key)
     return value;
 }
 
+template< typename P >
+std::vector<typename P::Value>
+cache<P>::read(const std::vector<K> & keys)
+{
+    std::vector<V> values(keys.size());
+    std::vector<K> missing;
+    std::vector<size_t> missingPos;
+    {
+        std::lock_guard guard(_hashLock);
+        for (size_t i(0); i < keys.size(); i++) {
+            if (Lru::hasKey(keys[i])) {
+                increment_stat(_hit, guard);
+                values[i] = V((*this)[keys[i]]);
+            } else {
+                increment_stat(_miss, guard);
+                missing.push_back(keys[i]);
+                missingPos.push_back(i);
+            }
+        }
+    }
+    if (missing.empty()) {
+        return values;
+    }
+    std::vector<V> fetched(missing.size());
+    std::vector<bool> found(missing.size(), false);
+    _store.read(missing, fetched, found);
+    std::lock_guard guard(_hashLock);
+    for (size_t i(0); i < missing.size(); i++) {
+        V & value = values[missingPos[i]];
+        if ( ! found[i]) {
+            _noneExisting.fetch_add(1);
+        } else if (Lru::hasKey(missing[i])) {
+            // Somebody else fetched or wrote it while we were reading.
+            increment_stat(_race, guard);
+            value = V((*this)[missing[i]]);
+        } else {
+            Lru::insert(missing[i], fetched[i]);
+            _sizeBytes.store(sizeBytes() + calcSize(missing[i], fetched[i]), std::memory_order_relaxed);
+            increment_stat(_insert, guard);
+            value = std::move(fetched[i]);
+        }
+    }
+    return values;
+}
+
 template< typename P >
 void
 cache<P>::write(const K & key, V value)
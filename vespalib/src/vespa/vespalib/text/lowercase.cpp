@@ -2,20 +2,49 @@
 
 #include "lowercase.h"
 #include <vespa/vespalib/text/utf8.h>
+#include <cstring>
 
 namespace vespalib {
 
+size_t
+LowerCase::ascii_prefix_length(const char *buf, size_t len) noexcept
+{
+    constexpr uint64_t high_bits = 0x8080808080808080ul;
+    size_t pos = 0;
+    for (; pos + sizeof(uint64_t) <= len; pos += sizeof(uint64_t)) {
+        uint64_t word;
+        memcpy(&word, buf + pos, sizeof(word));
+        if ((word & high_bits) != 0) {
+            break;
+        }
+    }
+    while ((pos < len) && (static_cast<unsigned char>(buf[pos]) < 0x80)) {
+        ++pos;
+    }
+    return pos;
+}
+
 vespalib::string
 LowerCase::convert(vespalib::stringref input)
 {
     vespalib::string output;
-    Utf8Reader r(input);
+    output.reserve(input.size());
     Utf8Writer w(output);
-
-    while (r.hasMore()) {
-        uint32_t lower = r.getChar();
-        uint32_t upper = convert(lower);
-        w.putChar(upper);
+    size_t pos = 0;
+    while (pos < input.size()) {
+        size_t ascii = ascii_prefix_length(input.data() + pos, input.size() - pos);
+        if (ascii > 0) {
+            size_t old_size = output.size();
+            output.resize(old_size + ascii);
+            convert_ascii(input.data() + pos, ascii, &output[old_size]);
+            pos += ascii;
+        }
+        // decode characters one at a time until back at ASCII
+        Utf8Reader r(input.data() + pos, input.size() - pos);
+        while (r.hasMore() && (static_cast<unsigned char>(input[pos + r.getPos()]) >= 0x80)) {
+            w.putChar(convert(r.getChar()));
+        }
+        pos += r.getPos();
     }
     return output;
 }
@@ -25,9 +54,18 @@ LowerCase::convert_to_ucs4(vespalib::stringref input)
 {
     std::vector<uint32_t> result;
     result.reserve(input.size());
-    Utf8Reader reader(input.data());
-    while (reader.hasMore()) {
-        result.emplace_back(convert(reader.getChar()));
+    size_t pos = 0;
+    while (pos < input.size()) {
+        size_t ascii = ascii_prefix_length(input.data() + pos, input.size() - pos);
+        for (size_t i = 0; i < ascii; ++i) {
+            result.emplace_back(lowercase_0_block[static_cast<unsigned char>(input[pos + i])]);
+        }
+        pos += ascii;
+        Utf8Reader reader(input.data() + pos, input.size() - pos);
+        while (reader.hasMore() && (static_cast<unsigned char>(input[pos + reader.getPos()]) >= 0x80)) {
+            result.emplace_back(convert(reader.getChar()));
+        }
+        pos += reader.getPos();
     }
     return result;
 }
@@ -98,6 +98,24 @@ public:
         return convert((unsigned char)c);
     }
 
+    /**
+     * Returns the length of the longest prefix of the given buffer
+     * containing only ASCII characters. Checks 8 bytes at a time.
+     **/
+    static size_t ascii_prefix_length(const char *buf, size_t len) noexcept;
+
+    /**
+     * lowercase len ASCII characters from src into dst (which may be
+     * the same buffer as src). Written without branches so that the
+     * compiler can vectorize it.
+     **/
+    static void convert_ascii(const char *src, size_t len, char *dst) noexcept {
+        for (size_t i = 0; i < len; ++i) {
+            unsigned char c = src[i];
+            dst[i] = c | ((static_cast<unsigned char>(c - 'A') < 26u) << 5);
+        }
+    }
+
     /**
      * lowercase a string in UTF-8 format; note that this will replace
      * any bytes that aren't valid UTF-8 with the Unicode REPLACEMENT
@@ -0,0 +1,75 @@
+// Copyright Vespa.ai. Licensed under the terms of the Apache 2.0 license. See LICENSE in the project root.
+
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <cstdint>
+
+namespace vespalib {
+
+/**
+ * Spin budget for hybrid spin-then-block waiting. A waiter first
+ * spins for up to the current budget, checking whether the awaited
+ * condition has become true, before falling back to blocking. The
+ * budget is doubled (up to the max) each time spinning succeeds and
+ * halved (down to a small minimum) each time the waiter ends up
+ * blocking anyway. Waits that are typically short are then spun,
+ * avoiding the wake-up latency of blocking, while long waits quickly
+ * stop burning cpu. A max of 0 disables spinning.
+ *
+ * The budget may be shared by several waiting threads; concurrent
+ * updates may be lost, which only affects how fast it adapts.
+ **/
+class AdaptiveSpin {
+private:
+    std::atomic<uint32_t> _budget;
+    uint32_t              _max;
+
+    static void pause() noexcept {
+#if defined(__x86_64__) || defined(__i386__)
+        __builtin_ia32_pause();
+#elif defined(__aarch64__)
+        asm volatile("yield");
+#endif
+    }
+public:
+    static constexpr uint32_t min_budget = 64;
+
+    explicit AdaptiveSpin(uint32_t max_spins) noexcept
+        : _budget(std::min(min_budget, max_spins)),
+          _max(max_spins)
+    {}
+    AdaptiveSpin(const AdaptiveSpin &rhs) noexcept
+        : _budget(rhs._budget.load(std::memory_order_relaxed)),
+          _max(rhs._max)
+    {}
+    AdaptiveSpin &operator=(const AdaptiveSpin &) = delete;
+
+    bool enabled() const noexcept { return (_max > 0); }
+    uint32_t budget() const noexcept { return _budget.load(std::memory_order_relaxed); }
+
+    /**
+     * Spin until done() returns true or the budget is spent.
+     *
+     * @return whether done() returned true while spinning
+     **/
+    template <typename Done>
+    bool spin_until(Done &&done) noexcept {
+        if (_max == 0) {
+            return false;
+        }
+        uint32_t budget = _budget.load(std::memory_order_relaxed);
+        for (uint32_t i = 0; i < budget; ++i) {
+            if (done()) {
+                _budget.store(std::min<uint64_t>(_max, uint64_t(budget) * 2), std::memory_order_relaxed);
+                return true;
+            }
+            pause();
+        }
+        _budget.store(std::max(std::min(min_budget, _max), budget / 2), std::memory_order_relaxed);
+        return false;
+    }
+};
+
+}
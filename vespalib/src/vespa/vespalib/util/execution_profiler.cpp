@@ -123,6 +123,17 @@ public:
             render_children(obj.setArray("roots"), _roots, ctx);
         }
     }
+    void visit(const ExecutionProfiler::TaskVisitor &visitor) const override {
+        vespalib::hash_map<TaskId, std::pair<size_t, duration>> tasks;
+        for (const auto &node: _nodes) {
+            auto &entry = tasks[node.task];
+            entry.first += node.count;
+            entry.second += (node.total_time - get_children_time(node.children));
+        }
+        for (const auto &[task, entry]: tasks) {
+            visitor(task, entry.first, entry.second);
+        }
+    }
 };
 
 class FlatProfiler : public ExecutionProfiler::Impl
@@ -210,6 +221,13 @@ public:
             }
         }
     }
+    void visit(const ExecutionProfiler::TaskVisitor &visitor) const override {
+        for (uint32_t i = 0; i < _nodes.size(); ++i) {
+            if (_nodes[i].count > 0) {
+                visitor(i, _nodes[i].count, _nodes[i].self_time);
+            }
+        }
+    }
 };
 
 }
@@ -26,11 +26,14 @@ class ExecutionProfiler {
 public:
     using TaskId = uint32_t;
     struct ReportContext;
+    // called with task, number of completions and time not spent in sub-tasks
+    using TaskVisitor = std::function<void(TaskId task, size_t count, duration self_time)>;
     struct Impl {
         virtual ~Impl() = default;
         virtual void track_start(TaskId task) = 0;
         virtual void track_complete() = 0;
         virtual void report(slime::Cursor &obj, ReportContext &ctx) const = 0;
+        virtual void visit(const TaskVisitor &visitor) const = 0;
     };
     using NameMapper = std::function<vespalib::string(const vespalib::string &)>;
 
@@ -58,6 +61,10 @@ public:
     }
     void report(slime::Cursor &obj, const NameMapper &name_mapper =
                 [](const vespalib::string &name) noexcept { return name; }) const;
+    // Visit the self time of all completed tasks (aggregated across
+    // all call paths for the tree profiler). Use name_of to look up
+    // task names.
+    void visit_tasks(const TaskVisitor &visitor) const { _impl->visit(visitor); }
 };
 
 }
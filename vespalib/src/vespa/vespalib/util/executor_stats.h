@@ -2,6 +2,7 @@
 
 #pragma once
 
+#include "hw_counters.h"
 #include <algorithm>
 #include <cstdint>
 #include <limits>
@@ -65,6 +66,7 @@ public:
     size_t     acceptedTasks;
     size_t     rejectedTasks;
     size_t     wakeupCount; // Number of times a worker was woken up,
+    HwCounters hwCounters;  // Hardware events counted by the worker threads (when enabled)
 
     ExecutorStats() : ExecutorStats(QueueSizeT(), 0, 0, 0) {}
     ExecutorStats(QueueSizeT queueSize_in, size_t accepted, size_t rejected, size_t wakeupCount_in)
@@ -74,7 +76,8 @@ public:
           queueSize(queueSize_in),
           acceptedTasks(accepted),
           rejectedTasks(rejected),
-          wakeupCount(wakeupCount_in)
+          wakeupCount(wakeupCount_in),
+          hwCounters()
     {}
     void aggregate(const ExecutorStats & rhs) {
         _threadCount += rhs._threadCount;
@@ -85,6 +88,7 @@ public:
         acceptedTasks += rhs.acceptedTasks;
         rejectedTasks += rhs.rejectedTasks;
         wakeupCount += rhs.wakeupCount;
+        hwCounters += rhs.hwCounters;
         _absUtil += rhs._absUtil;
         _saturation = std::max(_saturation, rhs.get_saturation());
     }
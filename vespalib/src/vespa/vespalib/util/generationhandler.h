@@ -12,6 +12,14 @@ namespace vespalib {
  * (changed by a single writer), and previous generations still
  * occupied by multiple readers.  Readers will take a generation guard
  * by calling takeGuard().
+ *
+ * Each component (e.g. each attribute vector) has its own generation
+ * handler, thus a long-lived reader only delays reclamation of memory
+ * held by the components it has taken guards on.  Readers observe the
+ * latest published state rather than a snapshot, so memory that became
+ * reachable after a guard was taken must also be kept while the guard
+ * is alive.  This is why reclamation is bounded by the oldest guard
+ * and not by the generation range an element was reachable in.
  **/
 class GenerationHandler {
 public:
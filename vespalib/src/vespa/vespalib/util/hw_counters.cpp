@@ -0,0 +1,152 @@
+// Copyright Vespa.ai. Licensed under the terms of the Apache 2.0 license. See LICENSE in the project root.
+
+#include "hw_counters.h"
+#include <algorithm>
+#include <atomic>
+#include <linux/perf_event.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+
+namespace vespalib {
+
+namespace {
+
+std::atomic<bool> counters_enabled(false);
+std::atomic<bool> counters_available(false);
+
+// counted events, in the order they appear in HwCounters
+constexpr uint64_t events[4] = {
+    PERF_COUNT_HW_CPU_CYCLES,
+    PERF_COUNT_HW_INSTRUCTIONS,
+    PERF_COUNT_HW_CACHE_MISSES,
+    PERF_COUNT_HW_BRANCH_MISSES
+};
+
+int open_counter(uint64_t event, int group_fd) noexcept {
+    perf_event_attr attr{};
+    attr.type = PERF_TYPE_HARDWARE;
+    attr.size = sizeof(attr);
+    attr.config = event;
+    attr.exclude_kernel = 1;
+    attr.exclude_hv = 1;
+    attr.read_format = PERF_FORMAT_GROUP | PERF_FORMAT_TOTAL_TIME_ENABLED | PERF_FORMAT_TOTAL_TIME_RUNNING;
+    return syscall(SYS_perf_event_open, &attr, 0, -1, group_fd, PERF_FLAG_FD_CLOEXEC);
+}
+
+uint64_t &field(HwCounters &counters, size_t idx) noexcept {
+    switch (idx) {
+    case 0: return counters.cycles;
+    case 1: return counters.instructions;
+    case 2: return counters.llc_misses;
+    default: return counters.branch_misses;
+    }
+}
+
+}
+
+ThreadHwCounters::ThreadHwCounters() noexcept
+    : _lock(),
+      _group_fd(-1),
+      _fds{-1, -1, -1, -1},
+      _last()
+{
+}
+
+bool
+ThreadHwCounters::open() noexcept
+{
+    // cycles lead the group; the other events are optional since
+    // not all of them are exposed on every (virtual) machine.
+    _fds[0] = open_counter(events[0], -1);
+    if (_fds[0] < 0) {
+        return false;
+    }
+    _group_fd = _fds[0];
+    for (size_t i = 1; i < 4; ++i) {
+        _fds[i] = open_counter(events[i], _group_fd);
+    }
+    return true;
+}
+
+bool
+ThreadHwCounters::read_totals(HwCounters &totals) noexcept
+{
+    uint64_t buf[3 + 4];
+    ssize_t res = ::read(_group_fd, buf, sizeof(buf));
+    if (res < ssize_t(3 * sizeof(uint64_t))) {
+        return false;
+    }
+    uint64_t nr = buf[0];
+    uint64_t time_enabled = buf[1];
+    uint64_t time_running = buf[2];
+    // scale when the group has been multiplexed with other groups
+    double scale = (time_running > 0 && time_running < time_enabled)
+                   ? (double(time_enabled) / time_running) : 1.0;
+    size_t value_idx = 0;
+    for (size_t i = 0; i < 4 && value_idx < nr; ++i) {
+        if (_fds[i] >= 0) {
+            field(totals, i) = uint64_t(buf[3 + value_idx++] * scale);
+        }
+    }
+    return true;
+}
+
+ThreadHwCounters::~ThreadHwCounters()
+{
+    for (int fd: _fds) {
+        if (fd >= 0) {
+            ::close(fd);
+        }
+    }
+}
+
+ThreadHwCounters::UP
+ThreadHwCounters::create_for_this_thread()
+{
+    if (!enabled()) {
+        return {};
+    }
+    UP counters(new ThreadHwCounters());
+    if (!counters->open()) {
+        return {};
+    }
+    counters_available.store(true, std::memory_order_relaxed);
+    return counters;
+}
+
+HwCounters
+ThreadHwCounters::sample() noexcept
+{
+    std::lock_guard guard(_lock);
+    HwCounters totals;
+    HwCounters delta;
+    if (read_totals(totals)) {
+        for (size_t i = 0; i < 4; ++i) {
+            uint64_t now = field(totals, i);
+            uint64_t &last = field(_last, i);
+            field(delta, i) = (now > last) ? (now - last) : 0;
+            last = std::max(now, last);
+        }
+    }
+    return delta;
+}
+
+void
+ThreadHwCounters::set_enabled(bool value) noexcept
+{
+    counters_enabled.store(value, std::memory_order_relaxed);
+}
+
+bool
+ThreadHwCounters::enabled() noexcept
+{
+    return counters_enabled.load(std::memory_order_relaxed);
+}
+
+bool
+ThreadHwCounters::available() noexcept
+{
+    return counters_available.load(std::memory_order_relaxed);
+}
+
+}
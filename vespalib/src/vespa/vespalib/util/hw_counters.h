@@ -0,0 +1,77 @@
+// Copyright Vespa.ai. Licensed under the terms of the Apache 2.0 license. See LICENSE in the project root.
+
+#pragma once
+
+#include <cstdint>
+#include <memory>
+#include <mutex>
+
+namespace vespalib {
+
+/**
+ * Hardware event counts (cycles, instructions, last level cache
+ * misses and branch misses) accumulated by one or more threads.
+ **/
+struct HwCounters {
+    uint64_t cycles;
+    uint64_t instructions;
+    uint64_t llc_misses;
+    uint64_t branch_misses;
+    HwCounters() noexcept : cycles(0), instructions(0), llc_misses(0), branch_misses(0) {}
+    HwCounters &operator+=(const HwCounters &rhs) noexcept {
+        cycles += rhs.cycles;
+        instructions += rhs.instructions;
+        llc_misses += rhs.llc_misses;
+        branch_misses += rhs.branch_misses;
+        return *this;
+    }
+    double ipc() const noexcept { return (cycles > 0) ? (double(instructions) / cycles) : 0.0; }
+};
+
+/**
+ * A group of hardware performance counters (perf_event_open) counting
+ * events for the thread that created it. The counters may be sampled
+ * from any thread, also after the owning thread has terminated.
+ *
+ * Counting is disabled by default since each counted thread needs a
+ * set of file descriptors and the kernel may restrict access to the
+ * counters. Use set_enabled early in process startup, before the
+ * threads to be counted are started; executors create counters for
+ * their worker threads when these start running.
+ **/
+class ThreadHwCounters {
+private:
+    std::mutex _lock;
+    int        _group_fd;
+    int        _fds[4];
+    HwCounters _last;
+
+    ThreadHwCounters() noexcept;
+    bool open() noexcept;
+    bool read_totals(HwCounters &totals) noexcept;
+public:
+    using UP = std::unique_ptr<ThreadHwCounters>;
+    ThreadHwCounters(const ThreadHwCounters &) = delete;
+    ThreadHwCounters &operator=(const ThreadHwCounters &) = delete;
+    ~ThreadHwCounters();
+
+    /**
+     * Start counting events for the calling thread. Returns nullptr
+     * if counting is disabled or the counters are not available.
+     **/
+    static UP create_for_this_thread();
+
+    /**
+     * Returns the events counted since the previous call to sample
+     * (or since creation). Thread-safe.
+     **/
+    HwCounters sample() noexcept;
+
+    static void set_enabled(bool value) noexcept;
+    static bool enabled() noexcept;
+
+    // true if counters could be created for at least one thread
+    static bool available() noexcept;
+};
+
+}
@@ -0,0 +1,146 @@
+// Copyright Vespa.ai. Licensed under the terms of the Apache 2.0 license. See LICENSE in the project root.
+
+#include "io_scheduler.h"
+#include <algorithm>
+
+namespace vespalib {
+
+namespace {
+
+// 0 means no class, otherwise IoScheduler::index_of(class) + 1
+thread_local uint8_t my_io_class = 0;
+
+}
+
+const char *
+IoScheduler::name_of(Class cls) noexcept
+{
+    switch (cls) {
+    case Class::FLUSH:      return "flush";
+    case Class::FUSION:     return "fusion";
+    case Class::COMPACTION: return "compaction";
+    case Class::MERGE:      return "merge";
+    }
+    return "unknown";
+}
+
+uint8_t
+IoScheduler::MyClass::set_class_for_this_thread(uint8_t cls) noexcept
+{
+    uint8_t old = my_io_class;
+    my_io_class = cls;
+    return old;
+}
+
+IoScheduler::MyClass::Captured
+IoScheduler::MyClass::capture() noexcept
+{
+    return {my_io_class};
+}
+
+IoScheduler::IoScheduler()
+    : _lock(),
+      _cond(),
+      _bytes_per_second(0),
+      _burst_bytes(0),
+      _tokens(0),
+      _last_refill(steady_clock::now()),
+      _waiters(),
+      _stats()
+{
+}
+
+IoScheduler::~IoScheduler() = default;
+
+void
+IoScheduler::refill(steady_time now)
+{
+    if (now > _last_refill) {
+        _tokens = std::min(_burst_bytes, _tokens + to_s(now - _last_refill) * _bytes_per_second);
+        _last_refill = now;
+    }
+}
+
+bool
+IoScheduler::higher_priority_waiting(size_t idx) const noexcept
+{
+    for (size_t i = 0; i < idx; ++i) {
+        if (_waiters[i] > 0) {
+            return true;
+        }
+    }
+    return false;
+}
+
+void
+IoScheduler::set_bandwidth(uint64_t bytes_per_second, uint64_t burst_bytes)
+{
+    std::lock_guard guard(_lock);
+    refill(steady_clock::now());
+    bool was_unlimited = (_bytes_per_second == 0);
+    _bytes_per_second = bytes_per_second;
+    _burst_bytes = std::max(burst_bytes, uint64_t(1));
+    _tokens = was_unlimited ? _burst_bytes : std::min(_tokens, _burst_bytes);
+    _cond.notify_all();
+}
+
+void
+IoScheduler::acquire(Class cls, size_t bytes)
+{
+    size_t idx = index_of(cls);
+    std::unique_lock guard(_lock);
+    ClassStats &stats = _stats[idx];
+    stats.bytes += bytes;
+    if (_bytes_per_second == 0) {
+        return;
+    }
+    steady_time now = steady_clock::now();
+    refill(now);
+    if ((_tokens > 0) && !higher_priority_waiting(idx)) {
+        _tokens -= bytes;
+        return;
+    }
+    steady_time start = now;
+    ++_waiters[idx];
+    ++stats.throttled;
+    while ((_bytes_per_second > 0) && ((_tokens <= 0) || higher_priority_waiting(idx))) {
+        if (_tokens <= 0) {
+            // wake up when the bucket is expected to have tokens again
+            _cond.wait_for(guard, from_s((1.0 - _tokens) / _bytes_per_second));
+        } else {
+            // higher priority waiters notify when they are let through
+            _cond.wait(guard);
+        }
+        now = steady_clock::now();
+        refill(now);
+    }
+    --_waiters[idx];
+    _tokens -= bytes;
+    stats.wait_time += (now - start);
+    _cond.notify_all();
+}
+
+IoScheduler::Stats
+IoScheduler::get_stats() const
+{
+    std::lock_guard guard(_lock);
+    return _stats;
+}
+
+IoScheduler &
+IoScheduler::instance()
+{
+    static IoScheduler scheduler;
+    return scheduler;
+}
+
+void
+IoScheduler::throttle(size_t bytes)
+{
+    uint8_t cls = my_io_class;
+    if (cls != 0) {
+        instance().acquire(static_cast<Class>(cls - 1), bytes);
+    }
+}
+
+}
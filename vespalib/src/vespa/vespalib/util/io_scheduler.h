@@ -0,0 +1,136 @@
+// Copyright Vespa.ai. Licensed under the terms of the Apache 2.0 license. See LICENSE in the project root.
+
+#pragma once
+
+#include "time.h"
+#include <array>
+#include <condition_variable>
+#include <cstdint>
+#include <mutex>
+
+namespace vespalib {
+
+/**
+ * Token bucket limiting the disk bandwidth used by background work
+ * (flush, fusion, compaction, merge) on a node. Writers call
+ * 'throttle' with the number of bytes they are about to write, and
+ * the bytes are charged to the class of work declared by the current
+ * thread (see MyClass). Threads without a declared class (feed,
+ * queries, tools) are never throttled.
+ *
+ * When the bucket is empty, waiting threads are let through in class
+ * priority order, so a flush does not wait behind a compaction. A
+ * request may drive the bucket negative, which delays the requests
+ * after it correspondingly; this keeps large writes from starving.
+ *
+ * Bandwidth is unlimited until set_bandwidth is called with a
+ * non-zero rate, but bytes are counted per class either way.
+ **/
+class IoScheduler
+{
+public:
+    // The kind of background disk work, in priority order (highest first).
+    enum class Class {
+        FLUSH      = 0, // flushing in-memory structures (attributes, memory index)
+        FUSION     = 1, // merging disk indexes
+        COMPACTION = 2, // compacting the document store
+        MERGE      = 3  // bucket merges between content nodes
+    };
+    static constexpr size_t num_classes = 4;
+    static constexpr size_t index_of(Class cls) noexcept { return static_cast<size_t>(cls); }
+    static const char *name_of(Class cls) noexcept;
+
+    // Cumulative statistics for a class of work.
+    struct ClassStats {
+        uint64_t bytes;     // bytes charged to the class
+        uint64_t throttled; // requests that had to wait for tokens
+        duration wait_time; // total time spent waiting for tokens
+        ClassStats() noexcept : bytes(0), throttled(0), wait_time(duration::zero()) {}
+    };
+    using Stats = std::array<ClassStats, num_classes>;
+
+    // Declares the class of the disk work done by the current thread
+    // while this object lives. Instances may shadow each other, but
+    // must be destructed in reverse construction order:
+    //
+    // IoScheduler::MyClass my_io_class(IoScheduler::Class::FUSION);
+    //
+    // Work handed off to other threads can be charged to the class of
+    // the thread handing it off by capturing it first:
+    //
+    // auto io_class = IoScheduler::MyClass::capture();
+    // ... in the other thread:
+    // IoScheduler::MyClass my_io_class(io_class);
+    class MyClass {
+    public:
+        // The class declared by a thread, possibly none.
+        struct Captured {
+            uint8_t cls;
+        };
+    private:
+        uint8_t _old;
+        static uint8_t set_class_for_this_thread(uint8_t cls) noexcept;
+    public:
+        explicit MyClass(Class cls) noexcept
+            : _old(set_class_for_this_thread(index_of(cls) + 1)) {}
+        explicit MyClass(Captured captured) noexcept
+            : _old(set_class_for_this_thread(captured.cls)) {}
+        static Captured capture() noexcept;
+        MyClass(MyClass &&) = delete;
+        MyClass(const MyClass &) = delete;
+        MyClass &operator=(MyClass &&) = delete;
+        MyClass &operator=(const MyClass &) = delete;
+        ~MyClass() { set_class_for_this_thread(_old); }
+    };
+
+private:
+    mutable std::mutex                   _lock;
+    std::condition_variable              _cond;
+    double                               _bytes_per_second; // 0 means unlimited
+    double                               _burst_bytes;
+    double                               _tokens;
+    steady_time                          _last_refill;
+    std::array<uint32_t, num_classes>    _waiters;
+    Stats                                _stats;
+
+    void refill(steady_time now);
+    bool higher_priority_waiting(size_t idx) const noexcept;
+
+public:
+    IoScheduler();
+    IoScheduler(const IoScheduler &) = delete;
+    IoScheduler &operator=(const IoScheduler &) = delete;
+    ~IoScheduler();
+
+    /**
+     * Set the total bandwidth shared by all classes. A rate of 0
+     * disables throttling.
+     *
+     * @param bytes_per_second refill rate of the bucket
+     * @param burst_bytes max number of tokens that can be saved up
+     *        while idle
+     **/
+    void set_bandwidth(uint64_t bytes_per_second, uint64_t burst_bytes);
+
+    /**
+     * Charge the given number of bytes to the given class, blocking
+     * until the bucket allows it.
+     **/
+    void acquire(Class cls, size_t bytes);
+
+    Stats get_stats() const;
+
+    /**
+     * The scheduler shared by all disk writers in this process.
+     **/
+    static IoScheduler &instance();
+
+    /**
+     * Charge the given number of bytes to the class declared by the
+     * current thread in the shared scheduler. Does nothing if the
+     * thread has not declared a class.
+     **/
+    static void throttle(size_t bytes);
+};
+
+}
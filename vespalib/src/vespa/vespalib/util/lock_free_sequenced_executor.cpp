@@ -0,0 +1,249 @@
+// Copyright Vespa.ai. Licensed under the terms of the Apache 2.0 license. See LICENSE in the project root.
+
+#include "lock_free_sequenced_executor.h"
+#include "count_down_latch.h"
+#include "lambdatask.h"
+#include <cassert>
+#include <thread>
+
+namespace vespalib {
+
+//-----------------------------------------------------------------------------
+
+LockFreeSequencedExecutor::MpscQueue::MpscQueue()
+    : _head(new Node(Task::UP())),
+      _tail(_head.load(std::memory_order_relaxed))
+{
+}
+
+LockFreeSequencedExecutor::MpscQueue::~MpscQueue()
+{
+    while (pop()) { }
+    delete _tail;
+}
+
+void
+LockFreeSequencedExecutor::MpscQueue::push(Node *node) noexcept
+{
+    Node *prev = _head.exchange(node, std::memory_order_acq_rel);
+    prev->next.store(node, std::memory_order_release);
+}
+
+Executor::Task::UP
+LockFreeSequencedExecutor::MpscQueue::pop() noexcept
+{
+    Node *next = _tail->next.load(std::memory_order_acquire);
+    if (next == nullptr) {
+        return {};
+    }
+    Task::UP task = std::move(next->task);
+    delete _tail;
+    _tail = next;
+    return task;
+}
+
+//-----------------------------------------------------------------------------
+
+LockFreeSequencedExecutor::Strand::Strand()
+    : parent(nullptr),
+      queue(),
+      pending(0),
+      sleeping(false),
+      blocked_producers(0),
+      lock(),
+      worker_cond(),
+      producer_cond(),
+      idle_tracker(),
+      idle_total(steady_clock::now()),
+      accepted_tasks(0),
+      wakeup_count(0)
+{
+}
+
+LockFreeSequencedExecutor::Strand::~Strand()
+{
+    assert(pending.load(std::memory_order_relaxed) == 0);
+}
+
+//-----------------------------------------------------------------------------
+
+void
+LockFreeSequencedExecutor::maybe_block_producer(Strand &strand)
+{
+    auto below_limit = [&]() noexcept {
+        return strand.pending.load(std::memory_order_seq_cst) < _task_limit.load(std::memory_order_relaxed);
+    };
+    if (below_limit()) {
+        return;
+    }
+    strand.blocked_producers.fetch_add(1, std::memory_order_seq_cst);
+    {
+        std::unique_lock guard(strand.lock);
+        strand.producer_cond.wait(guard, below_limit);
+    }
+    strand.blocked_producers.fetch_sub(1, std::memory_order_relaxed);
+}
+
+void
+LockFreeSequencedExecutor::notify_blocked_producers(Strand &strand)
+{
+    if (strand.blocked_producers.load(std::memory_order_seq_cst) > 0) {
+        std::lock_guard guard(strand.lock);
+        strand.producer_cond.notify_all();
+    }
+}
+
+void
+LockFreeSequencedExecutor::park(Strand &strand)
+{
+    std::unique_lock guard(strand.lock);
+    strand.sleeping.store(true, std::memory_order_seq_cst);
+    auto should_wake = [&]() noexcept {
+        return (strand.pending.load(std::memory_order_seq_cst) > 0) || _closed.load(std::memory_order_relaxed);
+    };
+    if (!should_wake()) {
+        strand.idle_tracker.set_idle(steady_clock::now());
+        strand.worker_cond.wait(guard, should_wake);
+        strand.idle_total.was_idle(strand.idle_tracker.set_active(steady_clock::now()));
+        strand.wakeup_count.fetch_add(1, std::memory_order_relaxed);
+    }
+    strand.sleeping.store(false, std::memory_order_relaxed);
+}
+
+void
+LockFreeSequencedExecutor::worker_main(Strand &strand)
+{
+    uint32_t idle_rounds = 0;
+    for (;;) {
+        size_t done = 0;
+        while (done < _max_batch) {
+            Task::UP task = strand.queue.pop();
+            if (!task) {
+                break;
+            }
+            task->run();
+            ++done;
+        }
+        if (done > 0) {
+            strand.pending.fetch_sub(done, std::memory_order_seq_cst);
+            notify_blocked_producers(strand);
+            idle_rounds = 0;
+        } else if (strand.pending.load(std::memory_order_acquire) > 0) {
+            // a producer is in the middle of linking its task into the queue
+            std::this_thread::yield();
+        } else if (_closed.load(std::memory_order_relaxed)) {
+            break;
+        } else if (++idle_rounds < _spin_rounds) {
+            std::this_thread::yield();
+        } else {
+            park(strand);
+            idle_rounds = 0;
+        }
+    }
+}
+
+LockFreeSequencedExecutor::LockFreeSequencedExecutor(Runnable::init_fun_t init_fun, uint32_t num_strands,
+                                                     uint32_t task_limit, bool is_task_limit_hard,
+                                                     uint32_t max_batch, uint32_t spin_rounds)
+    : ISequencedTaskExecutor(num_strands),
+      _strands(std::make_unique<Strand[]>(num_strands)),
+      _pool(),
+      _closed(false),
+      _task_limit(std::max(1u, task_limit)),
+      _is_task_limit_hard(is_task_limit_hard),
+      _max_batch(std::max(1u, max_batch)),
+      _spin_rounds(spin_rounds)
+{
+    assert(num_strands > 0);
+    _pool.reserve(num_strands);
+    for (uint32_t i = 0; i < num_strands; ++i) {
+        _strands[i].parent = this;
+        _pool.start(_strands[i], init_fun);
+    }
+}
+
+LockFreeSequencedExecutor::LockFreeSequencedExecutor(Runnable::init_fun_t init_fun, uint32_t num_strands,
+                                                     uint32_t task_limit)
+    : LockFreeSequencedExecutor(std::move(init_fun), num_strands, task_limit, true, 64, 100)
+{
+}
+
+LockFreeSequencedExecutor::~LockFreeSequencedExecutor()
+{
+    sync_all();
+    _closed.store(true, std::memory_order_relaxed);
+    for (uint32_t i = 0; i < getNumExecutors(); ++i) {
+        std::lock_guard guard(_strands[i].lock);
+        _strands[i].worker_cond.notify_one();
+    }
+    _pool.join();
+}
+
+ISequencedTaskExecutor::ExecutorId
+LockFreeSequencedExecutor::getExecutorId(uint64_t component) const {
+    return ExecutorId(component % getNumExecutors());
+}
+
+void
+LockFreeSequencedExecutor::executeTask(ExecutorId id, Task::UP task)
+{
+    assert(id.getId() < getNumExecutors());
+    assert(!_closed.load(std::memory_order_relaxed));
+    Strand &strand = _strands[id.getId()];
+    if (_is_task_limit_hard) {
+        maybe_block_producer(strand);
+    }
+    strand.pending.fetch_add(1, std::memory_order_seq_cst);
+    strand.queue.push(new Node(std::move(task)));
+    strand.accepted_tasks.fetch_add(1, std::memory_order_relaxed);
+    if (strand.sleeping.load(std::memory_order_seq_cst)) {
+        std::lock_guard guard(strand.lock);
+        strand.worker_cond.notify_one();
+    }
+}
+
+void
+LockFreeSequencedExecutor::sync_all()
+{
+    CountDownLatch latch(getNumExecutors());
+    for (uint32_t i = 0; i < getNumExecutors(); ++i) {
+        executeTask(ExecutorId(i), makeLambdaTask([&latch]() { latch.countDown(); }));
+    }
+    latch.await();
+}
+
+void
+LockFreeSequencedExecutor::setTaskLimit(uint32_t task_limit)
+{
+    _task_limit.store(std::max(1u, task_limit), std::memory_order_relaxed);
+    for (uint32_t i = 0; i < getNumExecutors(); ++i) {
+        std::lock_guard guard(_strands[i].lock);
+        _strands[i].producer_cond.notify_all();
+    }
+}
+
+ExecutorStats
+LockFreeSequencedExecutor::getStats()
+{
+    ExecutorStats accumulated_stats;
+    for (uint32_t i = 0; i < getNumExecutors(); ++i) {
+        Strand &strand = _strands[i];
+        ExecutorStats::QueueSizeT queue_size(strand.pending.load(std::memory_order_relaxed));
+        ExecutorStats stats(queue_size, strand.accepted_tasks.exchange(0, std::memory_order_relaxed), 0,
+                            strand.wakeup_count.exchange(0, std::memory_order_relaxed));
+        {
+            std::lock_guard guard(strand.lock);
+            steady_time now = steady_clock::now();
+            strand.idle_total.was_idle(strand.idle_tracker.reset(now));
+            stats.setUtil(1, strand.idle_total.reset(now, 1));
+        }
+        if (i == 0) {
+            accumulated_stats = stats;
+        } else {
+            accumulated_stats.aggregate(stats);
+        }
+    }
+    return accumulated_stats;
+}
+
+}
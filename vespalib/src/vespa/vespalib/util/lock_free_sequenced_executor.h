@@ -0,0 +1,102 @@
+// Copyright Vespa.ai. Licensed under the terms of the Apache 2.0 license. See LICENSE in the project root.
+
+#pragma once
+
+#include "isequencedtaskexecutor.h"
+#include "runnable.h"
+#include "thread.h"
+#include <vespa/vespalib/util/executor_idle_tracking.h>
+#include <atomic>
+#include <condition_variable>
+#include <mutex>
+
+namespace vespalib {
+
+/**
+ * Sequenced executor with one worker thread per strand, where tasks
+ * are handed over to the strand through a lock-free multi-producer
+ * single-consumer queue. The worker drains up to 'max_batch' tasks
+ * per round and spins for a while before parking when the queue is
+ * empty. The mutex and condition variables of a strand are only used
+ * when the worker is parked or a producer is blocked by the task
+ * limit.
+ **/
+class LockFreeSequencedExecutor : public ISequencedTaskExecutor
+{
+private:
+    using Task = Executor::Task;
+
+    /**
+     * Intrusive node in the queue of a strand.
+     **/
+    struct Node {
+        Task::UP           task;
+        std::atomic<Node*> next;
+        explicit Node(Task::UP task_in) noexcept : task(std::move(task_in)), next(nullptr) {}
+    };
+
+    /**
+     * Multi-producer single-consumer queue (Vyukov). The consumer
+     * owns '_tail', which always points to an already consumed (or
+     * stub) node. A push is not visible to the consumer until the
+     * previous head is linked to it, so pop may briefly return
+     * nullptr for a queue where a push is in progress.
+     **/
+    class MpscQueue {
+    private:
+        alignas(64) std::atomic<Node*> _head;
+        alignas(64) Node              *_tail;
+    public:
+        MpscQueue();
+        ~MpscQueue();
+        void push(Node *node) noexcept;
+        Task::UP pop() noexcept;
+    };
+
+    /**
+     * Tasks that need to be sequenced are handled by a single strand
+     * with its own worker thread.
+     **/
+    struct alignas(64) Strand : Runnable {
+        LockFreeSequencedExecutor *parent;
+        MpscQueue               queue;
+        alignas(64) std::atomic<size_t> pending;
+        std::atomic<bool>       sleeping;
+        std::atomic<uint32_t>   blocked_producers;
+        std::mutex              lock;
+        std::condition_variable worker_cond;
+        std::condition_variable producer_cond;
+        ThreadIdleTracker       idle_tracker;
+        ExecutorIdleTracker     idle_total;
+        std::atomic<size_t>     accepted_tasks;
+        std::atomic<size_t>     wakeup_count;
+        Strand();
+        ~Strand() override;
+        void run() override { parent->worker_main(*this); }
+    };
+
+    std::unique_ptr<Strand[]> _strands;
+    ThreadPool                _pool;
+    std::atomic<bool>         _closed;
+    std::atomic<uint32_t>     _task_limit;
+    const bool                _is_task_limit_hard;
+    const uint32_t            _max_batch;
+    const uint32_t            _spin_rounds;
+
+    void maybe_block_producer(Strand &strand);
+    void notify_blocked_producers(Strand &strand);
+    void park(Strand &strand);
+    void worker_main(Strand &strand);
+public:
+    LockFreeSequencedExecutor(Runnable::init_fun_t init_fun, uint32_t num_strands, uint32_t task_limit,
+                              bool is_task_limit_hard, uint32_t max_batch, uint32_t spin_rounds);
+    LockFreeSequencedExecutor(Runnable::init_fun_t init_fun, uint32_t num_strands, uint32_t task_limit);
+    ~LockFreeSequencedExecutor() override;
+    ExecutorId getExecutorId(uint64_t component) const override;
+    void executeTask(ExecutorId id, Task::UP task) override;
+    void sync_all() override;
+    void setTaskLimit(uint32_t task_limit) override;
+    ExecutorStats getStats() override;
+};
+
+}
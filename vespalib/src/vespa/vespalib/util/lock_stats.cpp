@@ -0,0 +1,124 @@
+// Copyright Vespa.ai. Licensed under the terms of the Apache 2.0 license. See LICENSE in the project root.
+
+#include "lock_stats.h"
+#include <algorithm>
+#include <bit>
+#include <map>
+#include <memory>
+
+namespace vespalib {
+
+namespace {
+
+struct Registry {
+    std::mutex lock;
+    std::map<vespalib::string, std::unique_ptr<LockStats>> stats;
+};
+
+Registry &registry() {
+    static Registry *instance = new Registry(); // never destructed; LockStats are referenced from static locals
+    return *instance;
+}
+
+}
+
+std::atomic<bool> LockStats::_enabled(false);
+
+LockStats::Snapshot::Snapshot() noexcept
+    : name(),
+      acquisitions(0),
+      contended(0),
+      total_wait(duration::zero()),
+      max_wait(duration::zero()),
+      histogram()
+{
+}
+
+duration
+LockStats::Snapshot::bucket_limit(size_t idx) noexcept
+{
+    return std::chrono::microseconds(uint64_t(1) << idx);
+}
+
+LockStats::LockStats(const vespalib::string &name)
+    : _name(name),
+      _acquisitions(0),
+      _contended(0),
+      _total_wait_ns(0),
+      _max_wait_ns(0),
+      _histogram()
+{
+}
+
+LockStats::~LockStats() = default;
+
+std::unique_lock<std::mutex>
+LockStats::profiled_lock(std::mutex &mutex)
+{
+    _acquisitions.fetch_add(1, std::memory_order_relaxed);
+    std::unique_lock<std::mutex> guard(mutex, std::try_to_lock);
+    if (!guard.owns_lock()) {
+        steady_time start = steady_clock::now();
+        guard.lock();
+        add_wait(steady_clock::now() - start);
+    }
+    return guard;
+}
+
+void
+LockStats::add_wait(duration wait) noexcept
+{
+    uint64_t wait_ns = count_ns(wait);
+    uint64_t wait_us = wait_ns / 1000;
+    size_t bucket = std::min(size_t(std::bit_width(wait_us)), num_buckets - 1);
+    _contended.fetch_add(1, std::memory_order_relaxed);
+    _total_wait_ns.fetch_add(wait_ns, std::memory_order_relaxed);
+    _histogram[bucket].fetch_add(1, std::memory_order_relaxed);
+    uint64_t old_max = _max_wait_ns.load(std::memory_order_relaxed);
+    while ((wait_ns > old_max) &&
+           !_max_wait_ns.compare_exchange_weak(old_max, wait_ns, std::memory_order_relaxed))
+    {
+    }
+}
+
+LockStats::Snapshot
+LockStats::snapshot() const
+{
+    Snapshot result;
+    result.name = _name;
+    result.acquisitions = _acquisitions.load(std::memory_order_relaxed);
+    result.contended = _contended.load(std::memory_order_relaxed);
+    result.total_wait = std::chrono::nanoseconds(_total_wait_ns.load(std::memory_order_relaxed));
+    result.max_wait = std::chrono::nanoseconds(_max_wait_ns.load(std::memory_order_relaxed));
+    for (size_t i = 0; i < num_buckets; ++i) {
+        result.histogram[i] = _histogram[i].load(std::memory_order_relaxed);
+    }
+    return result;
+}
+
+LockStats &
+LockStats::get(const vespalib::string &name)
+{
+    Registry &reg = registry();
+    std::lock_guard guard(reg.lock);
+    auto &entry = reg.stats[name];
+    if (!entry) {
+        entry.reset(new LockStats(name));
+    }
+    return *entry;
+}
+
+std::vector<LockStats::Snapshot>
+LockStats::snapshot_all()
+{
+    Registry &reg = registry();
+    std::lock_guard guard(reg.lock);
+    std::vector<Snapshot> result;
+    result.reserve(reg.stats.size());
+    for (const auto &entry : reg.stats) {
+        result.push_back(entry.second->snapshot());
+    }
+    return result;
+}
+
+}
@@ -0,0 +1,84 @@
+// Copyright Vespa.ai. Licensed under the terms of the Apache 2.0 license. See LICENSE in the project root.
+
+#pragma once
+
+#include "time.h"
+#include <vespa/vespalib/stllike/string.h>
+#include <array>
+#include <atomic>
+#include <mutex>
+#include <vector>
+
+namespace vespalib {
+
+/**
+ * Opt-in contention profiling for hot mutexes. Each named lock has a
+ * single LockStats instance that lives for the rest of the process;
+ * all mutexes sharing a name (e.g. one per stripe or per document
+ * type) contribute to the same stats. Code wanting its mutex profiled
+ * takes the lock through the stats object instead of constructing
+ * the guard directly:
+ *
+ *   static LockStats &stats = LockStats::get("my.lock");
+ *   auto guard = stats.lock(_mutex); // std::unique_lock<std::mutex>
+ *
+ * When profiling is disabled (default) this is a plain lock with the
+ * cost of a single relaxed load. When enabled, each acquisition first
+ * tries to take the lock without blocking; only acquisitions that
+ * have to wait are timed, and the wait time is added to a histogram
+ * with power of two buckets (in microseconds).
+ **/
+class LockStats {
+public:
+    static constexpr size_t num_buckets = 24;
+
+    // Snapshot of the stats for a single named lock
+    struct Snapshot {
+        vespalib::string name;
+        uint64_t acquisitions;
+        uint64_t contended;
+        duration total_wait;
+        duration max_wait;
+        // histogram[i] counts waits in [2^(i-1), 2^i) us, histogram[0] waits below 1us
+        std::array<uint64_t,num_buckets> histogram;
+        Snapshot() noexcept;
+        static duration bucket_limit(size_t idx) noexcept;
+    };
+
+    LockStats(const LockStats &) = delete;
+    LockStats &operator=(const LockStats &) = delete;
+    ~LockStats();
+
+    std::unique_lock<std::mutex> lock(std::mutex &mutex) {
+        if (!enabled()) [[likely]] {
+            return std::unique_lock<std::mutex>(mutex);
+        }
+        return profiled_lock(mutex);
+    }
+    Snapshot snapshot() const;
+
+    /**
+     * Obtain the stats for the lock with the given name, creating
+     * them on first use. The returned object is never destructed.
+     **/
+    static LockStats &get(const vespalib::string &name);
+    static std::vector<Snapshot> snapshot_all();
+
+    static void set_enabled(bool value) noexcept { _enabled.store(value, std::memory_order_relaxed); }
+    static bool enabled() noexcept { return _enabled.load(std::memory_order_relaxed); }
+
+private:
+    vespalib::string                              _name;
+    std::atomic<uint64_t>                         _acquisitions;
+    std::atomic<uint64_t>                         _contended;
+    std::atomic<uint64_t>                         _total_wait_ns;
+    std::atomic<uint64_t>                         _max_wait_ns;
+    std::array<std::atomic<uint64_t>,num_buckets> _histogram;
+    static std::atomic<bool>                      _enabled;
+
+    explicit LockStats(const vespalib::string &name);
+    std::unique_lock<std::mutex> profiled_lock(std::mutex &mutex);
+    void add_wait(duration wait) noexcept;
+};
+
+}
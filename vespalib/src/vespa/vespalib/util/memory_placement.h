@@ -0,0 +1,41 @@
+// Copyright Vespa.ai. Licensed under the terms of the Apache 2.0 license. See LICENSE in the project root.
+
+#pragma once
+
+#include <cstdint>
+
+namespace vespalib::alloc {
+
+/*
+ * Describes how the memory backing large allocations should be placed:
+ * whether huge pages should be used and which numa node is preferred.
+ */
+class MemoryPlacement {
+public:
+    enum class HugePages : uint8_t {
+        DEFAULT,     // Whatever the default allocator does
+        TRANSPARENT, // Huge page aligned mappings advised to use transparent huge pages
+        EXPLICIT     // Mappings from the hugetlbfs pool, falling back to TRANSPARENT when exhausted
+    };
+    static constexpr int NO_NUMA_NODE = -1;
+
+    MemoryPlacement() noexcept : MemoryPlacement(HugePages::DEFAULT, NO_NUMA_NODE) { }
+    MemoryPlacement(HugePages huge_pages, int numa_node) noexcept
+        : _huge_pages(huge_pages),
+          _numa_node(numa_node)
+    { }
+    HugePages huge_pages() const noexcept { return _huge_pages; }
+    int numa_node() const noexcept { return _numa_node; }
+    bool is_default() const noexcept {
+        return (_huge_pages == HugePages::DEFAULT) && (_numa_node == NO_NUMA_NODE);
+    }
+    bool operator==(const MemoryPlacement& rhs) const noexcept {
+        return (_huge_pages == rhs._huge_pages) && (_numa_node == rhs._numa_node);
+    }
+    bool operator!=(const MemoryPlacement& rhs) const noexcept { return !operator==(rhs); }
+private:
+    HugePages _huge_pages;
+    int       _numa_node;
+};
+
+}
@@ -0,0 +1,169 @@
+// Copyright Vespa.ai. Licensed under the terms of the Apache 2.0 license. See LICENSE in the project root.
+
+#include "memory_placement_allocator.h"
+#include "exceptions.h"
+#include "stringfmt.h"
+#include <sys/mman.h>
+#include <atomic>
+#include <cerrno>
+#include <climits>
+#include <cstdlib>
+#include <cstring>
+#include <vector>
+#ifdef __linux__
+#include <sys/syscall.h>
+#include <unistd.h>
+#endif
+
+#include <vespa/log/log.h>
+LOG_SETUP(".vespalib.alloc.memory_placement_allocator");
+
+namespace vespalib::alloc {
+
+namespace {
+
+constexpr int prot = PROT_READ | PROT_WRITE;
+constexpr int flags = MAP_ANON | MAP_PRIVATE;
+
+std::atomic<bool> huge_page_pool_exhausted(false);
+std::atomic<bool> numa_binding_failed(false);
+
+[[noreturn]] void
+throw_oom(const char *what, size_t sz)
+{
+    throw OOMException(make_string("%s of size %zu failed with error '%s'", what, sz, std::strerror(errno)));
+}
+
+}
+
+MemoryPlacementAllocator::MemoryPlacementAllocator(MemoryPlacement placement) noexcept
+    : MemoryAllocator(),
+      _placement(placement)
+{
+}
+
+MemoryPlacementAllocator::~MemoryPlacementAllocator() = default;
+
+void*
+MemoryPlacementAllocator::map_huge_pages(size_t sz) const
+{
+#ifdef __linux__
+    void* buf = mmap(nullptr, sz, prot, flags | MAP_HUGETLB, -1, 0);
+    if (buf != MAP_FAILED) {
+        huge_page_pool_exhausted.store(false, std::memory_order_relaxed);
+        return buf;
+    }
+    if (!huge_page_pool_exhausted.exchange(true, std::memory_order_relaxed)) {
+        LOG(info, "Failed mapping %zu bytes from the huge page pool due to '%s'."
+                  " Will use transparent huge pages until it works again.", sz, std::strerror(errno));
+    }
+#else
+    (void) sz;
+#endif
+    return nullptr;
+}
+
+void*
+MemoryPlacementAllocator::map_aligned(size_t sz) const
+{
+    // Over-map by one huge page and trim both ends to get a huge page aligned region
+    size_t mapped_sz = sz + HUGEPAGE_SIZE;
+    void* mapped = mmap(nullptr, mapped_sz, prot, flags, -1, 0);
+    if (mapped == MAP_FAILED) {
+        throw_oom("Anonymous mmap", mapped_sz);
+    }
+    auto start = reinterpret_cast<uintptr_t>(mapped);
+    uintptr_t aligned = (start + (HUGEPAGE_SIZE - 1)) & ~(uintptr_t(HUGEPAGE_SIZE) - 1);
+    size_t head = aligned - start;
+    size_t tail = HUGEPAGE_SIZE - head;
+    if (head > 0) {
+        munmap(mapped, head);
+    }
+    if (tail > 0) {
+        munmap(reinterpret_cast<void*>(aligned + sz), tail);
+    }
+    void* buf = reinterpret_cast<void*>(aligned);
+#ifdef __linux__
+    // Leave the system default transparent huge page policy alone unless huge pages were asked for
+    if (_placement.huge_pages() != MemoryPlacement::HugePages::DEFAULT) {
+        if (madvise(buf, sz, MADV_HUGEPAGE) != 0) {
+            // Just an advise, not everyone will listen...
+        }
+    }
+#endif
+    return buf;
+}
+
+void
+MemoryPlacementAllocator::bind_to_numa_node(void* buf, size_t sz) const
+{
+#if defined(__linux__) && defined(SYS_mbind)
+    constexpr int mpol_preferred = 1;
+    constexpr size_t bits = sizeof(unsigned long) * CHAR_BIT;
+    size_t node = _placement.numa_node();
+    std::vector<unsigned long> node_mask(node / bits + 1, 0ul);
+    node_mask[node / bits] |= (1ul << (node % bits));
+    if (syscall(SYS_mbind, buf, sz, mpol_preferred, node_mask.data(), node_mask.size() * bits + 1, 0) != 0) {
+        if (!numa_binding_failed.exchange(true, std::memory_order_relaxed)) {
+            LOG(warning, "Failed binding %zu bytes to numa node %d due to '%s'", sz, _placement.numa_node(), std::strerror(errno));
+        }
+    }
+#else
+    (void) buf;
+    (void) sz;
+#endif
+}
+
+PtrAndSize
+MemoryPlacementAllocator::alloc(size_t sz) const
+{
+    if (sz == 0) {
+        return {};
+    }
+    if (!use_mmap(sz)) {
+        void* buf = malloc(sz);
+        if (buf == nullptr) {
+            throw_oom("malloc", sz);
+        }
+        return {buf, sz};
+    }
+    sz = roundUpToHugePages(sz);
+    void* buf = (_placement.huge_pages() == MemoryPlacement::HugePages::EXPLICIT) ? map_huge_pages(sz) : nullptr;
+    if (buf == nullptr) {
+        buf = map_aligned(sz);
+    }
+    if (_placement.numa_node() != MemoryPlacement::NO_NUMA_NODE) {
+        bind_to_numa_node(buf, sz);
+    }
+    return {buf, sz};
+}
+
+void
+MemoryPlacementAllocator::free(PtrAndSize alloc) const noexcept
+{
+    if (alloc.get() == nullptr) {
+        return;
+    }
+    if (!use_mmap(alloc.size())) {
+        ::free(alloc.get());
+        return;
+    }
+    if (munmap(alloc.get(), alloc.size()) != 0) {
+        LOG(error, "munmap(%p, %zu) failed due to '%s'", alloc.get(), alloc.size(), std::strerror(errno));
+        abort();
+    }
+}
+
+void
+MemoryPlacementAllocator::free(void* ptr, size_t sz) const noexcept
+{
+    free(PtrAndSize(ptr, use_mmap(sz) ? roundUpToHugePages(sz) : sz));
+}
+
+size_t
+MemoryPlacementAllocator::resize_inplace(PtrAndSize, size_t) const
+{
+    return 0;
+}
+
+}
@@ -0,0 +1,38 @@
+// Copyright Vespa.ai. Licensed under the terms of the Apache 2.0 license. See LICENSE in the project root.
+
+#pragma once
+
+#include "memory_allocator.h"
+#include "memory_placement.h"
+
+namespace vespalib::alloc {
+
+/*
+ * Allocator placing large allocations according to a memory placement.
+ *
+ * Allocations of at least one huge page are mapped anonymously, rounded up to
+ * and aligned on huge page boundaries such that the kernel can back them with
+ * huge pages, and bound to the preferred numa node if one is given. Mappings
+ * are only advised to use transparent huge pages when huge pages are
+ * requested. Smaller allocations are forwarded to the heap. Thread safe.
+ */
+class MemoryPlacementAllocator : public MemoryAllocator {
+    MemoryPlacement _placement;
+
+    bool use_mmap(size_t sz) const noexcept { return sz >= HUGEPAGE_SIZE; }
+    void* map_huge_pages(size_t sz) const;
+    void* map_aligned(size_t sz) const;
+    void bind_to_numa_node(void* buf, size_t sz) const;
+public:
+    explicit MemoryPlacementAllocator(MemoryPlacement placement) noexcept;
+    ~MemoryPlacementAllocator() override;
+
+    const MemoryPlacement& get_placement() const noexcept { return _placement; }
+
+    PtrAndSize alloc(size_t sz) const override;
+    void free(PtrAndSize alloc) const noexcept override;
+    void free(void* ptr, size_t sz) const noexcept override;
+    size_t resize_inplace(PtrAndSize current, size_t newSize) const override;
+};
+
+}
@@ -0,0 +1,168 @@
+// Copyright Vespa.ai. Licensed under the terms of the Apache 2.0 license. See LICENSE in the project root.
+
+#include "numa_topology.h"
+#include <cctype>
+#include <charconv>
+#include <filesystem>
+#include <fstream>
+#include <map>
+#include <sched.h>
+
+namespace vespalib {
+
+namespace {
+
+bool parse_cpu(vespalib::stringref str, size_t &cpu) {
+    auto res = std::from_chars(str.data(), str.data() + str.size(), cpu);
+    return (res.ec == std::errc()) && (res.ptr == str.data() + str.size());
+}
+
+vespalib::string trim(vespalib::stringref str) {
+    size_t begin = 0;
+    size_t end = str.size();
+    while ((begin < end) && isspace(static_cast<unsigned char>(str[begin]))) {
+        ++begin;
+    }
+    while ((end > begin) && isspace(static_cast<unsigned char>(str[end - 1]))) {
+        --end;
+    }
+    return str.substr(begin, end - begin);
+}
+
+// upper bound on the cpu ids we accept, guarding against garbage input
+constexpr size_t MAX_CPU = 1 << 16;
+
+}
+
+NumaTopology::NumaTopology()
+    : _cpu_node(),
+      _node_cpus(1, 0)
+{
+}
+
+NumaTopology::NumaTopology(const std::vector<std::vector<size_t>> &node_cpus)
+    : _cpu_node(),
+      _node_cpus()
+{
+    for (const auto &cpus: node_cpus) {
+        if (cpus.empty()) {
+            continue;
+        }
+        uint32_t node = _node_cpus.size();
+        for (size_t cpu: cpus) {
+            if (cpu >= _cpu_node.size()) {
+                _cpu_node.resize(cpu + 1, 0);
+            }
+            _cpu_node[cpu] = node;
+        }
+        _node_cpus.push_back(cpus.size());
+    }
+    if (_node_cpus.empty()) {
+        _node_cpus.push_back(0);
+    }
+}
+
+NumaTopology::NumaTopology(const NumaTopology &) = default;
+NumaTopology &NumaTopology::operator=(const NumaTopology &) = default;
+NumaTopology::~NumaTopology() = default;
+
+std::vector<size_t>
+NumaTopology::parse_cpu_list(vespalib::stringref list)
+{
+    std::vector<size_t> cpus;
+    vespalib::string str = trim(list);
+    vespalib::stringref rest(str);
+    while (!rest.empty()) {
+        size_t comma = rest.find(',');
+        vespalib::stringref item = rest.substr(0, comma);
+        rest = (comma == vespalib::stringref::npos) ? vespalib::stringref() : rest.substr(comma + 1);
+        size_t dash = item.find('-');
+        size_t first = 0;
+        size_t last = 0;
+        if (dash == vespalib::stringref::npos) {
+            if (!parse_cpu(item, first)) {
+                return {};
+            }
+            last = first;
+        } else if (!parse_cpu(item.substr(0, dash), first) || !parse_cpu(item.substr(dash + 1), last)) {
+            return {};
+        }
+        if ((last < first) || (last >= MAX_CPU)) {
+            return {};
+        }
+        for (size_t cpu = first; cpu <= last; ++cpu) {
+            cpus.push_back(cpu);
+        }
+    }
+    return cpus;
+}
+
+namespace {
+
+// cpu ids for each node found in 'node_dir', in order of kernel node id,
+// keeping only the cpus accepted by 'cpu_allowed'
+template <typename CpuAllowed>
+std::vector<std::vector<size_t>>
+read_node_cpus(const vespalib::string &node_dir, CpuAllowed cpu_allowed)
+{
+    namespace fs = std::filesystem;
+    std::map<size_t, std::vector<size_t>> nodes; // ordered by kernel node id
+    std::error_code ec;
+    for (const auto &entry: fs::directory_iterator(fs::path(node_dir), ec)) {
+        auto name = entry.path().filename().string();
+        size_t node_id = 0;
+        if ((name.rfind("node", 0) != 0) || !parse_cpu(vespalib::stringref(name).substr(4), node_id)) {
+            continue;
+        }
+        std::ifstream file(entry.path() / "cpulist");
+        std::string line;
+        if (!std::getline(file, line)) {
+            continue;
+        }
+        auto &cpus = nodes[node_id];
+        for (size_t cpu: NumaTopology::parse_cpu_list(line)) {
+            if (cpu_allowed(cpu)) {
+                cpus.push_back(cpu);
+            }
+        }
+    }
+    std::vector<std::vector<size_t>> node_cpus;
+    for (auto &[node_id, cpus]: nodes) {
+        node_cpus.push_back(std::move(cpus));
+    }
+    return node_cpus;
+}
+
+}
+
+NumaTopology
+NumaTopology::from_sysfs(const vespalib::string &node_dir)
+{
+    return NumaTopology(read_node_cpus(node_dir, [](size_t) noexcept { return true; }));
+}
+
+const NumaTopology &
+NumaTopology::system()
+{
+    static const NumaTopology topology = []() {
+        cpu_set_t allowed;
+        CPU_ZERO(&allowed);
+        bool have_affinity = (sched_getaffinity(0, sizeof(allowed), &allowed) == 0);
+        return NumaTopology(read_node_cpus("/sys/devices/system/node", [&](size_t cpu) noexcept {
+            return !have_affinity || (cpu >= CPU_SETSIZE) || CPU_ISSET(cpu, &allowed);
+        }));
+    }();
+    return topology;
+}
+
+size_t
+NumaTopology::current_node() const noexcept
+{
+    if (num_nodes() < 2) {
+        return 0;
+    }
+    int cpu = sched_getcpu();
+    return (cpu < 0) ? 0 : node_of_cpu(cpu);
+}
+
+}
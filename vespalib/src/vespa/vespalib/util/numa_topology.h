@@ -0,0 +1,50 @@
+// Copyright Vespa.ai. Licensed under the terms of the Apache 2.0 license. See LICENSE in the project root.
+#pragma once
+
+#include <vespa/vespalib/stllike/string.h>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace vespalib {
+
+/**
+ * The NUMA topology of the machine: which NUMA node each cpu belongs
+ * to. Nodes are numbered densely from 0 in the order of their kernel
+ * node ids. Machines without NUMA support, or where the topology
+ * cannot be read, are seen as a single node containing all cpus.
+ **/
+class NumaTopology {
+private:
+    std::vector<uint32_t> _cpu_node;  // indexed by cpu id
+    std::vector<size_t>   _node_cpus; // number of cpus per node
+public:
+    // a single node containing all cpus
+    NumaTopology();
+    // cpu ids for each node; nodes without cpus are dropped
+    explicit NumaTopology(const std::vector<std::vector<size_t>> &node_cpus);
+    NumaTopology(const NumaTopology &);
+    NumaTopology &operator=(const NumaTopology &);
+    ~NumaTopology();
+
+    // Reads the topology from a directory laid out like /sys/devices/system/node,
+    // with a 'nodeN/cpulist' file for each node.
+    static NumaTopology from_sysfs(const vespalib::string &node_dir);
+    // The topology of this machine, restricted to the cpus this process may run on,
+    // so that nodes the process is not allowed to run on are left out. Read once,
+    // on first use.
+    static const NumaTopology &system();
+    // Parses a kernel cpu list like "0-3,8,10-11"; returns an empty list on errors
+    static std::vector<size_t> parse_cpu_list(vespalib::stringref list);
+
+    size_t num_nodes() const noexcept { return _node_cpus.size(); }
+    size_t num_cpus(size_t node) const noexcept { return _node_cpus[node]; }
+    // the node of the given cpu; unknown cpus are reported as being on node 0
+    size_t node_of_cpu(size_t cpu) const noexcept {
+        return (cpu < _cpu_node.size()) ? _cpu_node[cpu] : 0;
+    }
+    // the node of the cpu the calling thread is currently running on
+    size_t current_node() const noexcept;
+};
+
+}
@@ -0,0 +1,34 @@
+// Copyright Vespa.ai. Licensed under the terms of the Apache 2.0 license. See LICENSE in the project root.
+
+#pragma once
+
+#include <cstddef>
+
+namespace vespalib {
+
+constexpr size_t prefetch_cache_line_size = 64;
+
+/**
+ * Hint the cpu to bring the cache line containing the given address
+ * into the cache, since it will soon be read.
+ **/
+inline void prefetch(const void *addr) noexcept {
+    __builtin_prefetch(addr);
+}
+
+/**
+ * Hint the cpu to bring the cache lines covering the given memory
+ * range into the cache. At most max_lines cache lines are prefetched.
+ **/
+inline void prefetch_range(const void *addr, size_t bytes, size_t max_lines) noexcept {
+    const char *p = static_cast<const char *>(addr);
+    size_t lines = (bytes + prefetch_cache_line_size - 1) / prefetch_cache_line_size;
+    if (lines > max_lines) {
+        lines = max_lines;
+    }
+    for (size_t i = 0; i < lines; ++i) {
+        __builtin_prefetch(p + i * prefetch_cache_line_size);
+    }
+}
+
+}
@@ -0,0 +1,200 @@
+// Copyright Vespa.ai. Licensed under the terms of the Apache 2.0 license. See LICENSE in the project root.
+
+#include "priority_thread_pool.h"
+#include <algorithm>
+#include <atomic>
+#include <cassert>
+
+namespace vespalib {
+
+struct PriorityThreadPool::Class {
+    struct Entry {
+        uint64_t       seq;
+        Executor::Task::UP task;
+    };
+    const int               priority;
+    const uint32_t          max_concurrency;
+    std::atomic<uint32_t>   task_limit;
+    std::deque<Entry>       queue;
+    std::vector<uint64_t>   running;
+    uint64_t                next_seq;
+    bool                    closed;
+    ExecutorStats::QueueSizeT queue_size;
+    size_t                  accepted;
+    size_t                  rejected;
+
+    Class(int priority_in, uint32_t max_concurrency_in, uint32_t task_limit_in)
+        : priority(priority_in),
+          max_concurrency(std::max(max_concurrency_in, 1u)),
+          task_limit(task_limit_in),
+          queue(),
+          running(),
+          next_seq(0),
+          closed(false),
+          queue_size(),
+          accepted(0),
+          rejected(0)
+    {}
+    bool can_run() const { return (!queue.empty() && (running.size() < max_concurrency)); }
+    // sequence number of the oldest task not yet completed
+    uint64_t oldest_pending() const {
+        uint64_t oldest = queue.empty() ? next_seq : queue.front().seq;
+        for (uint64_t seq: running) {
+            oldest = std::min(oldest, seq);
+        }
+        return oldest;
+    }
+};
+
+class PriorityThreadPool::ClassExecutor : public SyncableThreadExecutor {
+private:
+    PriorityThreadPool    &_pool;
+    std::unique_ptr<Class> _class;
+public:
+    ClassExecutor(PriorityThreadPool &pool, std::unique_ptr<Class> cls)
+        : _pool(pool),
+          _class(std::move(cls))
+    {}
+    ~ClassExecutor() override {
+        shutdown();
+        sync();
+        _pool.remove_class(*_class);
+    }
+    Task::UP execute(Task::UP task) override {
+        std::lock_guard guard(_pool._lock);
+        Class &cls = *_class;
+        if (_pool._closed || cls.closed || (cls.queue.size() >= cls.task_limit.load(std::memory_order_relaxed))) {
+            ++cls.rejected;
+            return task;
+        }
+        cls.queue.push_back(Class::Entry{cls.next_seq++, std::move(task)});
+        cls.queue_size.add(cls.queue.size());
+        ++cls.accepted;
+        if (cls.can_run()) {
+            _pool._cond.notify_one();
+        }
+        return {};
+    }
+    void wakeup() override {}
+    ClassExecutor &sync() override {
+        std::unique_lock guard(_pool._lock);
+        Class &cls = *_class;
+        uint64_t wait_for = cls.next_seq;
+        ++_pool._sync_waiters;
+        _pool._sync_cond.wait(guard, [&cls, wait_for]() { return (cls.oldest_pending() >= wait_for); });
+        --_pool._sync_waiters;
+        return *this;
+    }
+    ClassExecutor &shutdown() override {
+        std::lock_guard guard(_pool._lock);
+        _class->closed = true;
+        return *this;
+    }
+    size_t getNumThreads() const override {
+        return std::min(size_t(_class->max_concurrency), _pool.num_threads());
+    }
+    ExecutorStats getStats() override {
+        std::lock_guard guard(_pool._lock);
+        Class &cls = *_class;
+        ExecutorStats stats(cls.queue_size, cls.accepted, cls.rejected, 0);
+        cls.queue_size = ExecutorStats::QueueSizeT(cls.queue.size());
+        cls.accepted = 0;
+        cls.rejected = 0;
+        return stats;
+    }
+    void setTaskLimit(uint32_t task_limit) override {
+        _class->task_limit.store(task_limit, std::memory_order_relaxed);
+    }
+    uint32_t getTaskLimit() const override {
+        return _class->task_limit.load(std::memory_order_relaxed);
+    }
+};
+
+PriorityThreadPool::PriorityThreadPool(size_t num_threads, init_fun_t init_fun)
+    : _lock(),
+      _cond(),
+      _sync_cond(),
+      _classes(),
+      _num_threads(std::max(num_threads, size_t(1))),
+      _sync_waiters(0),
+      _closed(false),
+      _pool()
+{
+    _pool.reserve(_num_threads);
+    for (size_t i = 0; i < _num_threads; ++i) {
+        _pool.start(*this, init_fun);
+    }
+}
+
+PriorityThreadPool::~PriorityThreadPool()
+{
+    {
+        std::lock_guard guard(_lock);
+        _closed = true;
+        _cond.notify_all();
+    }
+    _pool.join();
+    assert(_classes.empty());
+}
+
+PriorityThreadPool::Class *
+PriorityThreadPool::select_class() const
+{
+    for (Class *cls: _classes) {
+        if (cls->can_run()) {
+            return cls;
+        }
+    }
+    return nullptr;
+}
+
+void
+PriorityThreadPool::remove_class(Class &cls)
+{
+    std::lock_guard guard(_lock);
+    _classes.erase(std::find(_classes.begin(), _classes.end(), &cls));
+}
+
+void
+PriorityThreadPool::run()
+{
+    std::unique_lock guard(_lock);
+    for (;;) {
+        Class *cls = select_class();
+        if (cls == nullptr) {
+            if (_closed) {
+                break;
+            }
+            _cond.wait(guard);
+            continue;
+        }
+        Class::Entry entry = std::move(cls->queue.front());
+        cls->queue.pop_front();
+        cls->running.push_back(entry.seq);
+        guard.unlock();
+        entry.task->run();
+        entry.task.reset();
+        guard.lock();
+        auto pos = std::find(cls->running.begin(), cls->running.end(), entry.seq);
+        *pos = cls->running.back();
+        cls->running.pop_back();
+        if (_sync_waiters > 0) {
+            _sync_cond.notify_all();
+        }
+    }
+}
+
+std::unique_ptr<SyncableThreadExecutor>
+PriorityThreadPool::make_executor(int priority, uint32_t max_concurrency, uint32_t task_limit)
+{
+    auto cls = std::make_unique<Class>(priority, max_concurrency, task_limit);
+    {
+        std::lock_guard guard(_lock);
+        auto pos = std::find_if(_classes.begin(), _classes.end(),
+                                [priority](const Class *other) { return (other->priority < priority); });
+        _classes.insert(pos, cls.get());
+    }
+    return std::make_unique<ClassExecutor>(*this, std::move(cls));
+}
+
+}
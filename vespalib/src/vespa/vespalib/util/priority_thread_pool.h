@@ -0,0 +1,75 @@
+// Copyright Vespa.ai. Licensed under the terms of the Apache 2.0 license. See LICENSE in the project root.
+
+#pragma once
+
+#include "runnable.h"
+#include "thread.h"
+#include "threadexecutor.h"
+#include <condition_variable>
+#include <deque>
+#include <mutex>
+#include <vector>
+
+namespace vespalib {
+
+/**
+ * A fixed set of threads shared by several classes of work. Each
+ * class is used through its own executor (see make_executor) with a
+ * priority and a limit on how many of the threads may run its tasks
+ * at the same time. An idle thread runs the oldest task of the class
+ * with the highest priority that is below its concurrency limit, so
+ * threads move between classes as the mix of work changes instead of
+ * sitting idle in one executor while another is oversubscribed.
+ *
+ * Lower priority classes only get threads when higher priority
+ * classes are empty or at their concurrency limit; use the limits to
+ * make sure all classes make progress. All class executors must be
+ * destructed before the pool.
+ **/
+class PriorityThreadPool : public Runnable
+{
+public:
+    using init_fun_t = Runnable::init_fun_t;
+
+private:
+    struct Class;
+    class ClassExecutor;
+
+    mutable std::mutex      _lock;
+    std::condition_variable _cond;
+    std::condition_variable _sync_cond;
+    std::vector<Class *>    _classes; // sorted on priority, highest first
+    size_t                  _num_threads;
+    size_t                  _sync_waiters;
+    bool                    _closed;
+    ThreadPool              _pool;
+
+    Class *select_class() const;
+    void remove_class(Class &cls);
+    void run() override;
+
+public:
+    PriorityThreadPool(size_t num_threads, init_fun_t init_fun);
+    PriorityThreadPool(const PriorityThreadPool &) = delete;
+    PriorityThreadPool &operator=(const PriorityThreadPool &) = delete;
+    /**
+     * Runs all queued tasks before stopping the threads.
+     **/
+    ~PriorityThreadPool() override;
+
+    size_t num_threads() const { return _num_threads; }
+
+    /**
+     * Create an executor for a new class of work. Classes with the
+     * same priority are served in the order they were created.
+     *
+     * @param priority higher values are served first
+     * @param max_concurrency max number of threads running tasks for
+     *        this class at the same time (capped to the pool size)
+     * @param task_limit max number of queued tasks before new tasks
+     *        are rejected
+     **/
+    std::unique_ptr<SyncableThreadExecutor> make_executor(int priority, uint32_t max_concurrency, uint32_t task_limit);
+};
+
+}
@@ -0,0 +1,86 @@
+// Copyright Vespa.ai. Licensed under the terms of the Apache 2.0 license. See LICENSE in the project root.
+
+#include "private_file_mapping_allocator.h"
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <unistd.h>
+#include <cassert>
+
+namespace vespalib::alloc {
+
+PrivateFileMappingAllocator::PrivateFileMappingAllocator(const MemoryAllocator* fallback)
+    : _fallback(fallback),
+      _pending(),
+      _mapping()
+{
+    assert(_fallback != nullptr);
+}
+
+PrivateFileMappingAllocator::~PrivateFileMappingAllocator()
+{
+    assert(_pending.get() == nullptr);
+    assert(_mapping.get() == nullptr);
+}
+
+Alloc
+PrivateFileMappingAllocator::map_file(const vespalib::string& file_name, uint64_t offset, size_t size)
+{
+    assert(!has_mapping());
+    long page_size = sysconf(_SC_PAGESIZE);
+    if (size == 0 || page_size <= 0 || (offset % page_size) != 0) {
+        return {};
+    }
+    int fd = open(file_name.c_str(), O_RDONLY);
+    if (fd < 0) {
+        return {};
+    }
+    void* buf = mmap(nullptr, size, PROT_READ | PROT_WRITE, MAP_PRIVATE, fd, offset);
+    close(fd);
+    if (buf == MAP_FAILED) {
+        return {};
+    }
+    int retval = madvise(buf, size, MADV_RANDOM);
+    assert(retval == 0);
+#ifdef __linux__
+    retval = madvise(buf, size, MADV_DONTDUMP);
+    assert(retval == 0);
+#endif
+    _pending = PtrAndSize(buf, size);
+    auto result = Alloc::alloc_with_allocator(this).create(size);
+    assert(result.get() == buf);
+    return result;
+}
+
+PtrAndSize
+PrivateFileMappingAllocator::alloc(size_t sz) const
+{
+    if (_pending.get() != nullptr && _pending.size() == sz) {
+        _mapping = _pending;
+        _pending.reset();
+        return _mapping;
+    }
+    return _fallback->alloc(sz);
+}
+
+void
+PrivateFileMappingAllocator::free(PtrAndSize alloc) const noexcept
+{
+    if (alloc.get() != nullptr && alloc.get() == _mapping.get()) {
+        int retval = munmap(_mapping.get(), _mapping.size());
+        assert(retval == 0);
+        _mapping.reset();
+        return;
+    }
+    _fallback->free(alloc);
+}
+
+size_t
+PrivateFileMappingAllocator::resize_inplace(PtrAndSize current, size_t newSize) const
+{
+    if (current.get() != nullptr && current.get() == _mapping.get()) {
+        return 0;
+    }
+    return _fallback->resize_inplace(current, newSize);
+}
+
+}
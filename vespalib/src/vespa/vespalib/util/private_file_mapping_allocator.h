@@ -0,0 +1,46 @@
+// Copyright Vespa.ai. Licensed under the terms of the Apache 2.0 license. See LICENSE in the project root.
+
+#pragma once
+
+#include "alloc.h"
+#include "memory_allocator.h"
+#include <vespa/vespalib/stllike/string.h>
+
+namespace vespalib::alloc {
+
+/*
+ * Class handling a private (copy-on-write) memory mapping of a region of an
+ * existing file, e.g. the data part of an attribute vector file. Pages that
+ * are only read stay backed by the file and can be evicted by the kernel,
+ * while pages that are written are copied into anonymous memory.
+ *
+ * Only one mapping can be active at a time. All other allocations are
+ * forwarded to the fallback allocator, so this allocator can be used for
+ * all later buffers of a container that started out with the mapping.
+ * Not reentrant or thread safe. Should not be destructed before all allocations
+ * have been freed.
+ */
+class PrivateFileMappingAllocator : public MemoryAllocator {
+    const MemoryAllocator* _fallback;
+    mutable PtrAndSize     _pending;
+    mutable PtrAndSize     _mapping;
+public:
+    explicit PrivateFileMappingAllocator(const MemoryAllocator* fallback);
+    ~PrivateFileMappingAllocator() override;
+
+    /*
+     * Map size bytes from the given file starting at offset, which must be a
+     * multiple of the page size. Returns an empty allocation if the region
+     * could not be mapped, in which case the caller should load the data
+     * into memory allocated by the fallback allocator instead.
+     */
+    Alloc map_file(const vespalib::string& file_name, uint64_t offset, size_t size);
+    bool has_mapping() const noexcept { return _mapping.get() != nullptr; }
+    const MemoryAllocator* get_fallback() const noexcept { return _fallback; }
+
+    PtrAndSize alloc(size_t sz) const override;
+    void free(PtrAndSize alloc) const noexcept override;
+    size_t resize_inplace(PtrAndSize current, size_t newSize) const override;
+};
+
+}
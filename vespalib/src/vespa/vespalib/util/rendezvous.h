@@ -2,6 +2,8 @@
 
 #pragma once
 
+#include "adaptive_spin.h"
+#include "lock_stats.h"
 #include <type_traits>
 #include <condition_variable>
 #include <vector>
@@ -30,6 +32,9 @@ private:
     size_t                  _gen;
     std::vector<IN *>       _in;
     std::vector<OUT *>      _out;
+    LockStats              *_lock_stats;
+    AdaptiveSpin            _own_spin;
+    AdaptiveSpin           &_spin;
 
     /**
      * Function called to perform the actual inter-thread state
@@ -48,6 +53,10 @@ private:
      **/
     void meet_others(IN &input, OUT &output, size_t my_id, std::unique_lock<std::mutex> guard);
 
+    std::unique_lock<std::mutex> lock() {
+        return _lock_stats ? _lock_stats->lock(_lock) : std::unique_lock<std::mutex>(_lock);
+    }
+
 protected:
     /**
      * Obtain an input parameter. This function is called by mingle.
@@ -74,8 +83,15 @@ public:
      * least 1.
      *
      * @param n the size of this Rendezvous
+     * @param lock_stats optional contention profiling of the internal lock
+     * @param max_spins how long waiting threads may spin before blocking
+     * @param shared_spin spin budget kept outside this Rendezvous (typically
+     *                    by the thread bundle running the participants) to be
+     *                    used instead of starting from scratch; it should
+     *                    have been created with the same max_spins
      **/
-    Rendezvous(size_t n);
+    Rendezvous(size_t n, LockStats *lock_stats = nullptr, uint32_t max_spins = 0,
+               AdaptiveSpin *shared_spin = nullptr);
     virtual ~Rendezvous();
 
     /**
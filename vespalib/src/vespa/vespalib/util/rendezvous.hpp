@@ -30,10 +30,20 @@ Rendezvous<IN, OUT, external_id>::meet_others(IN &input, OUT &output, size_t my_
             std::fill(_out.begin(), _out.end(), nullptr);
         }
         _next = 0;
-        ++_gen;
+        std::atomic_ref<size_t>(_gen).store(_gen + 1, std::memory_order_release);
         _cond.notify_all();
     } else {
         size_t oldgen = _gen;
+        if (_spin.enabled()) {
+            guard.unlock();
+            if (_spin.spin_until([this, oldgen]() noexcept {
+                        return (std::atomic_ref<size_t>(_gen).load(std::memory_order_acquire) != oldgen);
+                    }))
+            {
+                return;
+            }
+            guard.lock();
+        }
         while (oldgen == _gen) {
             _cond.wait(guard);
         }
@@ -41,14 +51,18 @@ Rendezvous<IN, OUT, external_id>::meet_others(IN &input, OUT &output, size_t my_
 }
 
 template <typename IN, typename OUT, bool external_id>
-Rendezvous<IN, OUT, external_id>::Rendezvous(size_t n)
+Rendezvous<IN, OUT, external_id>::Rendezvous(size_t n, LockStats *lock_stats, uint32_t max_spins,
+                                             AdaptiveSpin *shared_spin)
     : _lock(),
       _cond(),
       _size(n),
       _next(0),
       _gen(0),
       _in(n, nullptr),
-      _out(n, nullptr)
+      _out(n, nullptr),
+      _lock_stats(lock_stats),
+      _own_spin(shared_spin ? 0 : max_spins),
+      _spin(shared_spin ? *shared_spin : _own_spin)
 {
     if (n == 0) {
         throw IllegalArgumentException("size must be greater than 0");
@@ -68,7 +82,7 @@ Rendezvous<IN, OUT, external_id>::rendezvous(IN input)
     if (_size == 1) {
         meet_self(input, ret);
     } else {
-        std::unique_lock guard(_lock);
+        auto guard = lock();
         meet_others(input, ret, _next, std::move(guard));
     }
     return ret;
@@ -85,7 +99,7 @@ Rendezvous<IN, OUT, external_id>::rendezvous(IN input, size_t my_id)
     if (_size == 1) {
         meet_self(input, ret);
     } else {
-        meet_others(input, ret, my_id, std::unique_lock(_lock));
+        meet_others(input, ret, my_id, lock());
     }
     return ret;
 }
@@ -52,18 +52,20 @@ Runnable::UP chain(Runnable::UP first, Runnable::UP second) {
 
 //-----------------------------------------------------------------------------
 
-Signal::Signal() noexcept
+Signal::Signal(uint32_t max_spins) noexcept
     : valid(true),
       generation(0),
       monitor(std::make_unique<std::mutex>()),
-      cond(std::make_unique<std::condition_variable>())
+      cond(std::make_unique<std::condition_variable>()),
+      spin(max_spins)
 {}
 Signal::~Signal() = default;
 
-SimpleThreadBundle::Pool::Pool(size_t bundleSize, init_fun_t init_fun)
+SimpleThreadBundle::Pool::Pool(size_t bundleSize, init_fun_t init_fun, uint32_t max_spins)
     : _lock(),
       _bundleSize(bundleSize),
       _init_fun(init_fun),
+      _max_spins(max_spins),
       _bundles()
 {
 }
@@ -87,7 +89,7 @@ SimpleThreadBundle::Pool::obtain()
             return ret;
         }
     }
-    return std::make_unique<SimpleThreadBundle>(_bundleSize, _init_fun, USE_SIGNAL_LIST);
+    return std::make_unique<SimpleThreadBundle>(_bundleSize, _init_fun, USE_SIGNAL_LIST, _max_spins);
 }
 
 void
@@ -100,19 +102,23 @@ SimpleThreadBundle::Pool::release(SimpleThreadBundle::UP bundle)
 
 //-----------------------------------------------------------------------------
 
-SimpleThreadBundle::SimpleThreadBundle(size_t size_in, Runnable::init_fun_t init_fun, Strategy strategy)
+SimpleThreadBundle::SimpleThreadBundle(size_t size_in, Runnable::init_fun_t init_fun, Strategy strategy, uint32_t max_spins)
     : _work(),
       _signals(),
       _workers(),
-      _hook()
+      _hook(),
+      _max_spins(max_spins),
+      _done_spin(max_spins),
+      _sync_spin(max_spins)
 {
     if (size_in == 0) {
         throw IllegalArgumentException("size must be greater than 0");
     }
-    if (strategy == USE_BROADCAST) {
-        _signals.resize(1); // share single signal
-    } else {
-        _signals.resize(size_in - 1); // separate signal per worker
+    // share single signal when broadcasting, separate signal per worker otherwise
+    size_t num_signals = (strategy == USE_BROADCAST) ? 1 : (size_in - 1);
+    _signals.reserve(num_signals);
+    for (size_t i = 0; i < num_signals; ++i) {
+        _signals.emplace_back(max_spins);
     }
     size_t next_unwired = 1;
     for (size_t i = 0; i < size_in; ++i) {
@@ -173,7 +179,11 @@ SimpleThreadBundle::run(Runnable* const* targets, size_t cnt)
     _work.targets = targets;
     _work.cnt = cnt;
     _work.latch = &latch;
+    _work.done.store(0, std::memory_order_relaxed);
     _hook->run();
+    _done_spin.spin_until([this, num_parts = size()]() noexcept {
+        return (_work.done.load(std::memory_order_acquire) == num_parts);
+    });
     latch.await();
 }
 
@@ -2,6 +2,7 @@
 
 #pragma once
 
+#include "adaptive_spin.h"
 #include "count_down_latch.h"
 #include "thread.h"
 #include "runnable.h"
@@ -21,7 +22,9 @@ struct Work {
     Runnable* const* targets;
     size_t cnt;
     CountDownLatch *latch;
-    Work() noexcept : targets(nullptr), cnt(0), latch(nullptr) {}
+    // number of parts done, lets the caller spin before awaiting the latch
+    mutable std::atomic<size_t> done;
+    Work() noexcept : targets(nullptr), cnt(0), latch(nullptr), done(0) {}
 };
 
 /**
@@ -36,22 +39,30 @@ struct Part {
         if (valid()) {
             work.targets[offset]->run();
         }
-        work.latch->countDown();
+        CountDownLatch *latch = work.latch;
+        work.done.fetch_add(1, std::memory_order_release);
+        latch->countDown();
     }
 };
 
 /**
- * countable signal path between threads.
+ * countable signal path between threads. The waiting thread may spin
+ * for a while before blocking (see AdaptiveSpin).
  **/
 struct Signal {
     bool valid;
     size_t generation;
     std::unique_ptr<std::mutex> monitor;
     std::unique_ptr<std::condition_variable> cond;
-    Signal() noexcept;
+    AdaptiveSpin spin;
+    Signal() noexcept : Signal(0) {}
+    explicit Signal(uint32_t max_spins) noexcept;
     Signal(Signal &&) noexcept = default;
     ~Signal();
-    size_t wait(size_t &localGen) const {
+    size_t wait(size_t &localGen) {
+        spin.spin_until([this, localGen]() noexcept {
+            return (std::atomic_ref<size_t>(generation).load(std::memory_order_acquire) != localGen);
+        });
         std::unique_lock guard(*monitor);
         while (localGen == generation) {
             cond->wait(guard);
@@ -60,20 +71,23 @@ struct Signal {
         localGen = generation;
         return (valid ? diff : 0);
     }
+    void next_generation() {
+        std::atomic_ref<size_t>(generation).store(generation + 1, std::memory_order_release);
+    }
     void send() {
         std::lock_guard guard(*monitor);
-        ++generation;
+        next_generation();
         cond->notify_one();
     }
     void broadcast() {
         std::lock_guard guard(*monitor);
-        ++generation;
+        next_generation();
         cond->notify_all();
     }
     void cancel() {
         std::lock_guard guard(*monitor);
-        ++generation;
         valid = false;
+        next_generation();
         cond->notify_all();
     }
 };
@@ -100,6 +114,7 @@ public:
         std::mutex _lock;
         size_t     _bundleSize;
         init_fun_t _init_fun;
+        uint32_t   _max_spins;
         std::vector<SimpleThreadBundle*> _bundles;
 
     public:
@@ -114,7 +129,8 @@ public:
             SimpleThreadBundle::UP  _bundle;
             Pool                   &_pool;
         };
-        Pool(size_t bundleSize, init_fun_t init_fun);
+        Pool(size_t bundleSize, init_fun_t init_fun, uint32_t max_spins);
+        Pool(size_t bundleSize, init_fun_t init_fun) : Pool(bundleSize, std::move(init_fun), 0) {}
         explicit Pool(size_t bundleSize) : Pool(bundleSize, Runnable::default_init_function) {}
         ~Pool();
         Guard getBundle() { return Guard(*this); }
@@ -137,15 +153,27 @@ private:
     std::vector<Signal>     _signals;
     std::vector<Worker::UP> _workers;
     Runnable::UP            _hook;
+    uint32_t                _max_spins;
+    AdaptiveSpin            _done_spin;
+    AdaptiveSpin            _sync_spin;
 
 public:
-    SimpleThreadBundle(size_t size, init_fun_t init_fun, Strategy strategy);
+    /**
+     * With max_spins > 0, waiting workers and the thread waiting for
+     * all parts to complete spin for up to max_spins iterations before
+     * blocking. This trades cpu for lower dispatch latency.
+     **/
+    SimpleThreadBundle(size_t size, init_fun_t init_fun, Strategy strategy, uint32_t max_spins);
+    SimpleThreadBundle(size_t size, init_fun_t init_fun, Strategy strategy)
+      : SimpleThreadBundle(size, std::move(init_fun), strategy, 0) {}
     SimpleThreadBundle(size_t size, Strategy strategy)
       : SimpleThreadBundle(size, Runnable::default_init_function, strategy) {}
     explicit SimpleThreadBundle(size_t size)
             : SimpleThreadBundle(size, USE_SIGNAL_LIST) {}
     ~SimpleThreadBundle() override;
     size_t size() const override;
+    uint32_t max_spins() const override { return _max_spins; }
+    AdaptiveSpin *sync_spin() override { return &_sync_spin; }
     using ThreadBundle::run;
     void run(Runnable* const* targets, size_t cnt) override;
 };
@@ -22,6 +22,7 @@ SingleExecutor::SingleExecutor(init_fun_t func, uint32_t reservedQueueSize, bool
       _wakeupCount(0),
       _lastAccepted(0),
       _queueSize(),
+      _hwCounters(),
       _wakeupConsumerAt(0),
       _producerNeedWakeupAt(0),
       _wp(0),
@@ -137,6 +138,10 @@ SingleExecutor::shutdown() {
 
 void
 SingleExecutor::run() {
+    if (auto hwCounters = ThreadHwCounters::create_for_this_thread()) {
+        Lock lock(_mutex);
+        _hwCounters = std::move(hwCounters);
+    }
     while (!stopped()) {
         drain_tasks();
         _producerCondition.notify_all();
@@ -230,6 +235,9 @@ SingleExecutor::getStats() {
     _idleTracker.was_idle(_threadIdleTracker.reset(now));
     ExecutorStats stats(_queueSize, (accepted - _lastAccepted), 0, _wakeupCount);
     stats.setUtil(1, _idleTracker.reset(now, 1));
+    if (_hwCounters) {
+        stats.hwCounters = _hwCounters->sample();
+    }
     _wakeupCount = 0;
     _lastAccepted = accepted;
     _queueSize = ExecutorStats::QueueSizeT() ;
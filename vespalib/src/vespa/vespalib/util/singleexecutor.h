@@ -7,6 +7,7 @@
 #include <vespa/vespalib/util/time.h>
 #include <vespa/vespalib/util/arrayqueue.hpp>
 #include <vespa/vespalib/util/executor_idle_tracking.h>
+#include <vespa/vespalib/util/hw_counters.h>
 #include <thread>
 #include <atomic>
 #include <mutex>
@@ -76,6 +77,7 @@ private:
     uint64_t                    _wakeupCount;
     uint64_t                    _lastAccepted;
     ExecutorStats::QueueSizeT   _queueSize;
+    ThreadHwCounters::UP        _hwCounters;
     std::atomic<uint64_t>       _wakeupConsumerAt;
     std::atomic<uint64_t>       _producerNeedWakeupAt;
     std::atomic<uint64_t>       _wp;
@@ -2,6 +2,8 @@
 
 #include "thread.h"
 #include <cstring>
+#include <pthread.h>
+#include <sched.h>
 
 namespace vespalib::thread {
 
@@ -19,4 +21,19 @@ size_t as_zu(std::thread::id id) {
     return res;
 }
 
+bool pin_current_to_cpu(int cpu) {
+#ifdef __linux__
+    if ((cpu < 0) || (cpu >= CPU_SETSIZE)) {
+        return false;
+    }
+    cpu_set_t cpus;
+    CPU_ZERO(&cpus);
+    CPU_SET(cpu, &cpus);
+    return (pthread_setaffinity_np(pthread_self(), sizeof(cpus), &cpus) == 0);
+#else
+    (void) cpu;
+    return false;
+#endif
+}
+
 }
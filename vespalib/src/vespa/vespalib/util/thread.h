@@ -11,6 +11,8 @@ namespace vespalib {
 namespace thread {
 [[nodiscard]] std::thread start(Runnable &runnable, Runnable::init_fun_t init_fun);
 size_t as_zu(std::thread::id id);
+// Restrict the calling thread to run on the given cpu only. Returns false if not possible.
+bool pin_current_to_cpu(int cpu);
 }
 
 /**
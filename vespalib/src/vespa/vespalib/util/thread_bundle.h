@@ -8,6 +8,8 @@
 
 namespace vespalib {
 
+class AdaptiveSpin;
+
 namespace thread_bundle {
 
 template <typename T>
@@ -40,6 +42,21 @@ struct ThreadBundle {
      **/
     virtual void run(Runnable* const* targets, size_t cnt) = 0;
 
+    /**
+     * The maximum number of iterations threads of this bundle spin
+     * before blocking when waiting for each other. Code synchronizing
+     * the targets it runs may use this to apply the same policy. 0
+     * means no spinning.
+     **/
+    virtual uint32_t max_spins() const { return 0; }
+
+    /**
+     * Spin budget for code synchronizing the targets run by this
+     * bundle, owned by the bundle so that it stays adapted to the
+     * workload across runs. nullptr if the bundle does not keep one.
+     **/
+    virtual AdaptiveSpin *sync_spin() { return nullptr; }
+
     // convenience run wrapper
     template <thread_bundle::direct_dispatch_array Array>
     void run(const Array &items) {
@@ -119,6 +119,11 @@ ThreadStackExecutorBase::run()
 {
     Worker worker;
     _master = this;
+    auto hwCounters = ThreadHwCounters::create_for_this_thread();
+    if (hwCounters) {
+        unique_lock guard(_lock);
+        _hwCounters.push_back(hwCounters.get());
+    }
     worker.verify(/* idle: */ true);
     while (obtainTask(worker)) {
         worker.verify(/* idle: */ false);
@@ -127,6 +132,11 @@ ThreadStackExecutorBase::run()
     }
     _executorCompletion.await(); // to allow unsafe signaling
     worker.verify(/* idle: */ true);
+    if (hwCounters) {
+        unique_lock guard(_lock);
+        _stats.hwCounters += hwCounters->sample();
+        std::erase(_hwCounters, hwCounters.get());
+    }
     _master = nullptr;
 }
 
@@ -143,6 +153,7 @@ ThreadStackExecutorBase::ThreadStackExecutorBase(uint32_t taskLimit, init_fun_t
       _executorCompletion(),
       _tasks(),
       _workers(),
+      _hwCounters(),
       _barrier(),
       _taskCount(0),
       _taskLimit(taskLimit),
@@ -212,6 +223,9 @@ ThreadStackExecutorBase::getStats()
     }
     size_t numThreads = getNumThreads();
     stats.setUtil(numThreads, _idleTracker.reset(now, numThreads));
+    for (ThreadHwCounters *hwCounters : _hwCounters) {
+        stats.hwCounters += hwCounters->sample();
+    }
     _stats = ExecutorStats();
     _stats.queueSize.add(_taskCount);
     return stats;
@@ -8,6 +8,7 @@
 #include "arrayqueue.hpp"
 #include "gate.h"
 #include "executor_idle_tracking.h"
+#include "hw_counters.h"
 #include <vector>
 #include <functional>
 
@@ -78,6 +79,7 @@ private:
     ArrayQueue<TaggedTask>               _tasks;
     ArrayQueue<Worker*>                  _workers;
     std::vector<BlockedThread*>          _blocked;
+    std::vector<ThreadHwCounters*>       _hwCounters;
     EventBarrier<BarrierCompletion>      _barrier;
     uint32_t                             _taskCount;
     uint32_t                             _taskLimit;
@@ -0,0 +1,150 @@
+// Copyright Vespa.ai. Licensed under the terms of the Apache 2.0 license. See LICENSE in the project root.
+
+#include "zstd_dictionary.h"
+#include <vespa/vespalib/util/exceptions.h>
+#include <vespa/vespalib/util/stringfmt.h>
+#include <zstd.h>
+#include <zdict.h>
+
+namespace vespalib::compression {
+
+namespace {
+
+class CompressContext {
+public:
+    CompressContext() : _ctx(ZSTD_createCCtx()) {}
+    ~CompressContext() { ZSTD_freeCCtx(_ctx); }
+    ZSTD_CCtx * get() { return _ctx; }
+private:
+    ZSTD_CCtx * _ctx;
+};
+class DecompressContext {
+public:
+    DecompressContext() : _ctx(ZSTD_createDCtx()) {}
+    ~DecompressContext() { ZSTD_freeDCtx(_ctx); }
+    ZSTD_DCtx * get() { return _ctx; }
+private:
+    ZSTD_DCtx * _ctx;
+};
+
+thread_local std::unique_ptr<CompressContext>  _tlCompressState;
+thread_local std::unique_ptr<DecompressContext> _tlDecompressState;
+
+// zstd refuses to train with fewer samples than this
+constexpr size_t MIN_SAMPLES = 8;
+
+}
+
+ZStdDictionary::Samples::Samples(size_t maxBytes)
+    : _data(),
+      _sizes(),
+      _maxBytes(maxBytes)
+{
+    _data.reserve(maxBytes);
+}
+
+ZStdDictionary::Samples::~Samples() = default;
+
+bool
+ZStdDictionary::Samples::add(ConstBufferRef sample)
+{
+    if (full()) {
+        return false;
+    }
+    if (sample.size() > 0) {
+        _data.insert(_data.end(), sample.c_str(), sample.c_str() + sample.size());
+        _sizes.push_back(sample.size());
+    }
+    return true;
+}
+
+ZStdDictionary::ZStdDictionary(ConstBufferRef content)
+    : ZStdDictionary(content, 0, false)
+{
+}
+
+ZStdDictionary::ZStdDictionary(ConstBufferRef content, int compressionLevel)
+    : ZStdDictionary(content, compressionLevel, true)
+{
+}
+
+ZStdDictionary::ZStdDictionary(ConstBufferRef content, int compressionLevel, bool compress)
+    : _content(content.c_str(), content.c_str() + content.size()),
+      _id(ZDICT_getDictID(content.c_str(), content.size())),
+      _compressionLevel(compressionLevel),
+      _cdict(nullptr),
+      _ddict(nullptr)
+{
+    if (_id == 0) {
+        throw IllegalArgumentException(make_string("Not a zstd dictionary (%zu bytes)", content.size()), VESPA_STRLOC);
+    }
+    if (compress) {
+        _cdict = ZSTD_createCDict(_content.data(), _content.size(), compressionLevel);
+    }
+    _ddict = ZSTD_createDDict(_content.data(), _content.size());
+    if ((compress && (_cdict == nullptr)) || (_ddict == nullptr)) {
+        ZSTD_freeCDict(_cdict);
+        ZSTD_freeDDict(_ddict);
+        throw IllegalArgumentException(make_string("Failed loading zstd dictionary %u", _id), VESPA_STRLOC);
+    }
+}
+
+ZStdDictionary::~ZStdDictionary()
+{
+    ZSTD_freeCDict(_cdict);
+    ZSTD_freeDDict(_ddict);
+}
+
+ZStdDictionary::SP
+ZStdDictionary::train(const Samples & samples, size_t maxSize, int compressionLevel)
+{
+    if (samples.count() < MIN_SAMPLES) {
+        return {};
+    }
+    std::vector<char> content(maxSize);
+    size_t sz = ZDICT_trainFromBuffer(content.data(), content.size(), samples.data(),
+                                      samples.sizes().data(), samples.count());
+    if (ZDICT_isError(sz)) {
+        return {};
+    }
+    return std::make_shared<ZStdDictionary>(ConstBufferRef(content.data(), sz), compressionLevel);
+}
+
+bool
+ZStdDictionary::compress(const void * input, size_t inputLen, void * output, size_t & outputLen) const
+{
+    if (_cdict == nullptr) {
+        return false;
+    }
+    if ( ! _tlCompressState) {
+        _tlCompressState = std::make_unique<CompressContext>();
+    }
+    size_t sz = ZSTD_compress_usingCDict(_tlCompressState->get(), output, outputLen, input, inputLen, _cdict);
+    if (ZSTD_isError(sz)) {
+        return false;
+    }
+    outputLen = sz;
+    return true;
+}
+
+bool
+ZStdDictionary::decompress(const void * input, size_t inputLen, void * output, size_t & outputLen) const
+{
+    if ( ! _tlDecompressState) {
+        _tlDecompressState = std::make_unique<DecompressContext>();
+    }
+    size_t sz = ZSTD_decompress_usingDDict(_tlDecompressState->get(), output, outputLen, input, inputLen, _ddict);
+    if (ZSTD_isError(sz)) {
+        return false;
+    }
+    outputLen = sz;
+    return true;
+}
+
+uint32_t
+ZStdDictionary::frameDictionaryId(const void * input, size_t inputLen) noexcept
+{
+    return ZSTD_getDictID_fromFrame(input, inputLen);
+}
+
+}
@@ -0,0 +1,83 @@
+// Copyright Vespa.ai. Licensed under the terms of the Apache 2.0 license. See LICENSE in the project root.
+#pragma once
+
+#include "buffer.h"
+#include <memory>
+#include <vector>
+
+struct ZSTD_CDict_s;
+struct ZSTD_DDict_s;
+
+namespace vespalib::compression {
+
+/**
+ * A trained zstd dictionary used to compress many small buffers with
+ * similar content (like chunks of documents of the same type) better
+ * than they compress on their own. The dictionary id is stored in each
+ * frame compressed with it, so frames compressed without a dictionary
+ * can still be told apart and decompressed without it.
+ **/
+class ZStdDictionary
+{
+public:
+    using SP = std::shared_ptr<const ZStdDictionary>;
+
+    /**
+     * Samples used to train a dictionary. Samples are copied until
+     * the given number of bytes has been collected.
+     **/
+    class Samples {
+    public:
+        explicit Samples(size_t maxBytes);
+        ~Samples();
+        // returns false when there is no room for more samples
+        bool add(ConstBufferRef sample);
+        bool full() const noexcept { return _data.size() >= _maxBytes; }
+        size_t count() const noexcept { return _sizes.size(); }
+        size_t bytes() const noexcept { return _data.size(); }
+        const char * data() const noexcept { return _data.data(); }
+        const std::vector<size_t> & sizes() const noexcept { return _sizes; }
+    private:
+        std::vector<char>   _data;
+        std::vector<size_t> _sizes;
+        size_t              _maxBytes;
+    };
+
+    /**
+     * Load a dictionary earlier produced by train(). A dictionary loaded
+     * without a compression level can only be used for decompression.
+     * Throws IllegalArgumentException if it is not a valid zstd dictionary.
+     */
+    explicit ZStdDictionary(ConstBufferRef content);
+    ZStdDictionary(ConstBufferRef content, int compressionLevel);
+    ZStdDictionary(const ZStdDictionary &) = delete;
+    ZStdDictionary & operator = (const ZStdDictionary &) = delete;
+    ~ZStdDictionary();
+
+    /**
+     * Train a dictionary of at most maxSize bytes from the given samples.
+     * Returns nullptr if there are too few samples to train a dictionary.
+     */
+    static SP train(const Samples & samples, size_t maxSize, int compressionLevel);
+
+    uint32_t id() const noexcept { return _id; }
+    ConstBufferRef content() const noexcept { return {_content.data(), _content.size()}; }
+    int compressionLevel() const noexcept { return _compressionLevel; }
+
+    bool canCompress() const noexcept { return _cdict != nullptr; }
+    // Same contract as ICompressor::process/unprocess
+    bool compress(const void * input, size_t inputLen, void * output, size_t & outputLen) const;
+    bool decompress(const void * input, size_t inputLen, void * output, size_t & outputLen) const;
+
+    // Id of the dictionary used to compress the given zstd frame, 0 if none.
+    static uint32_t frameDictionaryId(const void * input, size_t inputLen) noexcept;
+private:
+    ZStdDictionary(ConstBufferRef content, int compressionLevel, bool compress);
+    std::vector<char>  _content;
+    uint32_t           _id;
+    int                _compressionLevel;
+    ZSTD_CDict_s     * _cdict;
+    ZSTD_DDict_s     * _ddict;
+};
+
+}
@@ -0,0 +1,134 @@
+// Copyright Vespa.ai. Licensed under the terms of the Apache 2.0 license. See LICENSE in the project root.
+
+#include <gtest/gtest.h>
+#include <vespa/log/log-target-async.h>
+#include <condition_variable>
+#include <map>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace ns_log {
+
+namespace {
+
+// Collects the lines written to it, optionally blocking writes until released.
+class CollectingTarget : public LogTarget {
+    std::mutex              _lock;
+    std::condition_variable _cond;
+    bool                    _blocked;
+    std::vector<std::string> _lines;
+    size_t                  _writes;
+public:
+    CollectingTarget(bool blocked) : LogTarget("collect:"), _lock(), _cond(), _blocked(blocked), _lines(), _writes(0) {}
+    int write(const char *buf, int bufLen) override {
+        std::unique_lock guard(_lock);
+        _cond.wait(guard, [this]() { return !_blocked; });
+        ++_writes;
+        std::string data(buf, bufLen);
+        size_t pos = 0;
+        for (size_t end = data.find('\n'); end != std::string::npos; end = data.find('\n', pos)) {
+            _lines.emplace_back(data.substr(pos, end - pos));
+            pos = end + 1;
+        }
+        return bufLen;
+    }
+    void release() {
+        std::lock_guard guard(_lock);
+        _blocked = false;
+        _cond.notify_all();
+    }
+    std::vector<std::string> lines() {
+        std::lock_guard guard(_lock);
+        return _lines;
+    }
+    size_t writes() {
+        std::lock_guard guard(_lock);
+        return _writes;
+    }
+};
+
+std::string
+make_line(int thread, int seq)
+{
+    return "thread " + std::to_string(thread) + " message " + std::to_string(seq) + "\n";
+}
+
+}
+
+TEST(AsyncTargetTest, messages_from_each_thread_are_written_in_order)
+{
+    constexpr int num_threads = 4;
+    constexpr int num_messages = 2000;
+    auto inner = std::make_unique<CollectingTarget>(false);
+    auto &collected = *inner;
+    LogTargetAsync target("async:collect:", std::move(inner), 1024 * 1024);
+    std::vector<std::thread> threads;
+    for (int t = 0; t < num_threads; ++t) {
+        threads.emplace_back([&target, t]() {
+            for (int i = 0; i < num_messages; ++i) {
+                auto line = make_line(t, i);
+                target.write(line.data(), line.size());
+            }
+        });
+    }
+    for (auto &thread : threads) {
+        thread.join();
+    }
+    target.flush();
+    EXPECT_EQ(num_threads * num_messages, target.written());
+    EXPECT_EQ(0u, target.dropped());
+    EXPECT_GT(uint64_t(num_threads * num_messages), collected.writes());
+    std::map<int, int> next_seq;
+    for (const auto &line : collected.lines()) {
+        int thread, seq;
+        ASSERT_EQ(2, sscanf(line.c_str(), "thread %d message %d", &thread, &seq));
+        EXPECT_EQ(next_seq[thread]++, seq);
+    }
+    for (int t = 0; t < num_threads; ++t) {
+        EXPECT_EQ(num_messages, next_seq[t]);
+    }
+}
+
+TEST(AsyncTargetTest, messages_are_dropped_and_counted_when_ring_is_full)
+{
+    auto inner = std::make_unique<CollectingTarget>(true);
+    auto &collected = *inner;
+    LogTargetAsync target("async:collect:", std::move(inner), 1024);
+    auto line = make_line(0, 0);
+    // The writer thread blocks in the underlying target, and the ring fills up
+    size_t accepted = 0;
+    for (int i = 0; i < 200; ++i) {
+        if (target.write(line.data(), line.size()) > 0) {
+            ++accepted;
+        }
+    }
+    EXPECT_LT(accepted, 200u);
+    EXPECT_EQ(200u - accepted, target.dropped());
+    collected.release();
+    target.flush();
+    EXPECT_EQ(accepted, target.written());
+}
+
+TEST(AsyncTargetTest, messages_too_large_for_ring_are_written_directly)
+{
+    auto inner = std::make_unique<CollectingTarget>(false);
+    auto &collected = *inner;
+    LogTargetAsync target("async:collect:", std::move(inner), 64);
+    std::string line(100, 'x');
+    line += "\n";
+    EXPECT_EQ(int(line.size()), target.write(line.data(), line.size()));
+    ASSERT_EQ(1u, collected.lines().size());
+    EXPECT_EQ(line.substr(0, 100), collected.lines()[0]);
+    EXPECT_EQ(1u, target.written());
+}
+
+}
+
+int
+main(int argc, char* argv[])
+{
+    ::testing::InitGoogleTest(&argc, argv);
+    return RUN_ALL_TESTS();
+}
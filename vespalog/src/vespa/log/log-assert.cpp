@@ -1,17 +1,32 @@
 // Copyright Vespa.ai. Licensed under the terms of the Apache 2.0 license. See LICENSE in the project root.
 
 #include "log.h"
+#include "log-target.h"
+#include "internal.h"
 #include <cstdio>
 LOG_SETUP("");
 
 namespace ns_log {
 
+namespace {
+
+// Make sure the message is written before aborting, also when the log target buffers messages.
+void flush_log_target() {
+    try {
+        Logger::getCurrentTarget()->flush();
+    } catch (InvalidLogException &) {
+    }
+}
+
+}
+
 void log_assert_fail(const char *assertion,
                      const char *file,
                      uint32_t line)
 {
     LOG(error, "%s:%d: Failed assertion: '%s'",
         file, line, assertion);
+    flush_log_target();
     fprintf(stderr, "%s:%d: Failed assertion: '%s'\n",
             file, line, assertion);
     abort();
@@ -24,6 +39,7 @@ void log_abort(const char *message,
 {
     LOG(error, "%s:%d: Abort called. Reason: %s",
         file, line, message);
+    flush_log_target();
     fprintf(stderr, "%s:%d: Abort called. Reason: %s\n",
             file, line, message);
     abort();
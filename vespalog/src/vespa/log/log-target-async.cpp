@@ -0,0 +1,240 @@
+// Copyright Vespa.ai. Licensed under the terms of the Apache 2.0 license. See LICENSE in the project root.
+#include "log.h"
+LOG_SETUP(".log");
+#include "log-target-async.h"
+
+#include <algorithm>
+#include <cinttypes>
+#include <cstring>
+
+namespace ns_log {
+
+namespace {
+
+constexpr size_t max_batch_size = 64 * 1024;
+constexpr auto idle_wait = std::chrono::milliseconds(10);
+
+std::atomic<uint64_t> next_target_id(1);
+
+size_t
+round_up_to_power_of_2(size_t value)
+{
+    size_t result = 1;
+    while (result < value) {
+        result <<= 1;
+    }
+    return result;
+}
+
+}
+
+/**
+ * Single producer, single consumer ring buffer of length prefixed
+ * messages. The producer is the thread owning the ring, the consumer
+ * is whoever holds the drain lock of the async log target.
+ **/
+class LogTargetAsync::Ring {
+private:
+    std::unique_ptr<char[]> _buf;
+    const size_t            _size;
+    std::atomic<uint64_t>   _head; // bytes produced
+    std::atomic<uint64_t>   _tail; // bytes consumed
+    std::atomic<bool>       _abandoned;
+
+    void copy_in(uint64_t pos, const char *src, size_t len) noexcept {
+        size_t offset = pos & (_size - 1);
+        size_t first = std::min(len, _size - offset);
+        memcpy(_buf.get() + offset, src, first);
+        memcpy(_buf.get(), src + first, len - first);
+    }
+    void copy_out(uint64_t pos, char *dst, size_t len) const noexcept {
+        size_t offset = pos & (_size - 1);
+        size_t first = std::min(len, _size - offset);
+        memcpy(dst, _buf.get() + offset, first);
+        memcpy(dst + first, _buf.get(), len - first);
+    }
+public:
+    explicit Ring(size_t size)
+        : _buf(std::make_unique<char[]>(size)),
+          _size(size),
+          _head(0),
+          _tail(0),
+          _abandoned(false)
+    {}
+    static size_t needed(size_t len) noexcept { return sizeof(uint32_t) + len; }
+    bool fits(size_t len) const noexcept { return needed(len) <= _size; }
+    bool push(const char *msg, uint32_t len) noexcept {
+        uint64_t head = _head.load(std::memory_order_relaxed);
+        uint64_t tail = _tail.load(std::memory_order_acquire);
+        if ((_size - (head - tail)) < needed(len)) {
+            return false;
+        }
+        copy_in(head, reinterpret_cast<const char *>(&len), sizeof(len));
+        copy_in(head + sizeof(len), msg, len);
+        _head.store(head + needed(len), std::memory_order_release);
+        return true;
+    }
+    // Appends complete messages to the batch, calling flush_batch when it would exceed the max batch size.
+    template <typename FlushBatch>
+    size_t drain(std::vector<char> &batch, FlushBatch flush_batch) {
+        size_t messages = 0;
+        uint64_t tail = _tail.load(std::memory_order_relaxed);
+        uint64_t head = _head.load(std::memory_order_acquire);
+        while (tail < head) {
+            uint32_t len;
+            copy_out(tail, reinterpret_cast<char *>(&len), sizeof(len));
+            if (!batch.empty() && (batch.size() + len > max_batch_size)) {
+                flush_batch();
+            }
+            size_t old_size = batch.size();
+            batch.resize(old_size + len);
+            copy_out(tail + sizeof(len), batch.data() + old_size, len);
+            tail += needed(len);
+            ++messages;
+        }
+        _tail.store(tail, std::memory_order_release);
+        return messages;
+    }
+    bool empty() const noexcept {
+        return _tail.load(std::memory_order_acquire) == _head.load(std::memory_order_acquire);
+    }
+    void abandon() noexcept { _abandoned.store(true, std::memory_order_release); }
+    bool abandoned() const noexcept { return _abandoned.load(std::memory_order_acquire); }
+};
+
+namespace {
+
+// The ring buffer of this thread, and the async log target it belongs to.
+struct ThreadRing {
+    uint64_t                               owner = 0;
+    std::shared_ptr<LogTargetAsync::Ring>  ring;
+    ~ThreadRing() {
+        if (ring) {
+            ring->abandon();
+        }
+    }
+};
+
+thread_local ThreadRing thread_ring;
+
+}
+
+LogTargetAsync::LogTargetAsync(const char *target, std::unique_ptr<LogTarget> inner,
+                               size_t ring_size, size_t max_rings)
+    : LogTarget(target),
+      _target(std::move(inner)),
+      _id(next_target_id.fetch_add(1, std::memory_order_relaxed)),
+      _ring_size(round_up_to_power_of_2(ring_size)),
+      _max_rings(max_rings),
+      _lock(),
+      _drain_lock(),
+      _cond(),
+      _rings(),
+      _stop(false),
+      _written(0),
+      _dropped(0),
+      _unreported_drops(0),
+      _writer()
+{
+    _writer = std::thread([this]() { run(); });
+}
+
+LogTargetAsync::~LogTargetAsync()
+{
+    {
+        std::lock_guard guard(_lock);
+        _stop.store(true, std::memory_order_release);
+    }
+    _cond.notify_all();
+    _writer.join();
+}
+
+LogTargetAsync::Ring *
+LogTargetAsync::get_ring()
+{
+    if (thread_ring.owner != _id) {
+        std::lock_guard guard(_lock);
+        thread_ring.owner = _id;
+        if (thread_ring.ring) {
+            thread_ring.ring->abandon();
+        }
+        thread_ring.ring.reset();
+        if (_rings.size() < _max_rings) {
+            thread_ring.ring = std::make_shared<Ring>(_ring_size);
+            _rings.push_back(thread_ring.ring);
+        }
+    }
+    return thread_ring.ring.get();
+}
+
+int
+LogTargetAsync::write(const char *buf, int bufLen)
+{
+    Ring *ring = get_ring();
+    if ((ring == nullptr) || !ring->fits(bufLen)) {
+        _written.fetch_add(1, std::memory_order_relaxed);
+        return _target->write(buf, bufLen);
+    }
+    if (!ring->push(buf, bufLen)) {
+        _dropped.fetch_add(1, std::memory_order_relaxed);
+        _unreported_drops.fetch_add(1, std::memory_order_relaxed);
+        return 0;
+    }
+    return bufLen;
+}
+
+size_t
+LogTargetAsync::drain(std::vector<char> &batch)
+{
+    std::lock_guard drain_guard(_drain_lock);
+    std::vector<std::shared_ptr<Ring>> rings;
+    {
+        std::lock_guard guard(_lock);
+        rings = _rings;
+    }
+    auto flush_batch = [this, &batch]() {
+        _target->write(batch.data(), batch.size());
+        batch.clear();
+    };
+    size_t messages = 0;
+    for (const auto &ring : rings) {
+        messages += ring->drain(batch, flush_batch);
+    }
+    if (!batch.empty()) {
+        flush_batch();
+    }
+    _written.fetch_add(messages, std::memory_order_relaxed);
+    {
+        std::lock_guard guard(_lock);
+        std::erase_if(_rings, [](const auto &ring) { return ring->abandoned() && ring->empty(); });
+    }
+    return messages;
+}
+
+void
+LogTargetAsync::flush()
+{
+    std::vector<char> batch;
+    drain(batch);
+}
+
+void
+LogTargetAsync::run()
+{
+    std::vector<char> batch;
+    batch.reserve(max_batch_size);
+    while (!_stop.load(std::memory_order_acquire)) {
+        size_t messages = drain(batch);
+        uint64_t drops = _unreported_drops.exchange(0, std::memory_order_relaxed);
+        if (drops > 0) {
+            LOG(warning, "Dropped %" PRIu64 " log messages since the log writer could not keep up", drops);
+        }
+        if (messages == 0) {
+            std::unique_lock guard(_lock);
+            _cond.wait_for(guard, idle_wait, [this]() { return _stop.load(std::memory_order_acquire); });
+        }
+    }
+    drain(batch);
+}
+
+} // end namespace ns_log
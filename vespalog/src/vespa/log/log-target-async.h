@@ -0,0 +1,74 @@
+// Copyright Vespa.ai. Licensed under the terms of the Apache 2.0 license. See LICENSE in the project root.
+#pragma once
+
+#include "log-target.h"
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace ns_log {
+
+/**
+ * Log target decoupling the threads emitting log messages from the
+ * (possibly slow) underlying log target. Selected by prefixing the
+ * log target with "async:", e.g. "async:file:vespa.log".
+ *
+ * Each thread writing log messages gets its own bounded single
+ * producer, single consumer ring buffer, so writing a message is lock
+ * free after the first message from a thread. A background writer
+ * thread drains all ring buffers and writes the messages to the
+ * underlying target in batches. Messages from a single thread keep
+ * their order, while messages from different threads may be
+ * reordered within a batch.
+ *
+ * A message is dropped if the ring buffer of the thread is full, and
+ * the number of dropped messages is counted and periodically logged.
+ * Messages that can never fit in a ring buffer, and messages from
+ * threads beyond the max number of ring buffers, are written directly
+ * to the underlying target.
+ **/
+class LogTargetAsync : public LogTarget {
+public:
+    static constexpr size_t default_ring_size = 64 * 1024;
+    static constexpr size_t default_max_rings = 256;
+    class Ring;
+private:
+    std::unique_ptr<LogTarget>         _target;
+    const uint64_t                     _id;
+    const size_t                       _ring_size;
+    const size_t                       _max_rings;
+    std::mutex                         _lock;
+    std::mutex                         _drain_lock;
+    std::condition_variable            _cond;
+    std::vector<std::shared_ptr<Ring>> _rings;
+    std::atomic<bool>                  _stop;
+    std::atomic<uint64_t>              _written;
+    std::atomic<uint64_t>              _dropped;
+    std::atomic<uint64_t>              _unreported_drops;
+    std::thread                        _writer;
+
+    Ring *get_ring();
+    size_t drain(std::vector<char> &batch);
+    void run();
+
+public:
+    LogTargetAsync(const char *target, std::unique_ptr<LogTarget> inner,
+                   size_t ring_size = default_ring_size, size_t max_rings = default_max_rings);
+    LogTargetAsync(const LogTargetAsync &) = delete;
+    LogTargetAsync & operator=(const LogTargetAsync &) = delete;
+    ~LogTargetAsync() override;
+    int write(const char *buf, int bufLen) override;
+    bool makeHumanReadable() const override { return _target->makeHumanReadable(); }
+    // Passes all messages buffered when called to the underlying target.
+    void flush() override;
+    // Number of messages passed to the underlying target
+    uint64_t written() const noexcept { return _written.load(std::memory_order_relaxed); }
+    // Number of messages dropped because the ring buffer of the writing thread was full
+    uint64_t dropped() const noexcept { return _dropped.load(std::memory_order_relaxed); }
+};
+
+} // end namespace ns_log
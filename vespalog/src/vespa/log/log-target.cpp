@@ -7,6 +7,7 @@ LOG_SETUP(".log");
 
 #include "log-target-fd.h"
 #include "log-target-file.h"
+#include "log-target-async.h"
 #include "internal.h"
 
 namespace ns_log {
@@ -38,6 +39,9 @@ LogTarget::makeTarget(const char *const target)
         }
     } else if (strncmp(target, "file:", 5) == 0) {
         return new LogTargetFile(target);
+    } else if (strncmp(target, "async:", 6) == 0) {
+        std::unique_ptr<LogTarget> inner(makeTarget(target + 6));
+        return new LogTargetAsync(target, std::move(inner));
     }
     throwInvalid("Log target '%s' is invalid.", target);
 }
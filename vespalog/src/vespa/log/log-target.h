@@ -22,6 +22,8 @@ public:
     static LogTarget *defaultTarget();
     virtual const char *name() const { return _name; }
     virtual bool makeHumanReadable() const { return false; }
+    // Write any messages buffered by this target
+    virtual void flush() {}
 };
 
 } // end namespace ns_log
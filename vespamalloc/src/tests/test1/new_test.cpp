@@ -5,7 +5,9 @@
 #include <vespa/log/log.h>
 #include <malloc.h>
 #include <dlfcn.h>
+#include <unistd.h>
 #include <functional>
+#include <vector>
 
 LOG_SETUP("new_test");
 
@@ -223,6 +225,74 @@ TEST("verify mallopt") {
     EXPECT_EQUAL(1, mallopt(M_MMAP_THRESHOLD, 1_Gi));
 }
 
+TEST("verify heap profile can be dumped") {
+    if (_env == MallocLibrary::UNKNOWN) return;
+    using DumpFunction = int (*)(int fd);
+    auto dump = reinterpret_cast<DumpFunction>(dlsym(RTLD_NEXT, "vespamalloc_dump_heap_profile"));
+    ASSERT_TRUE(dump != nullptr);
+    FILE * fp = tmpfile();
+    ASSERT_TRUE(fp != nullptr);
+    EXPECT_EQUAL(0, dump(fileno(fp)));
+    rewind(fp);
+    char header[64];
+    ASSERT_TRUE(fgets(header, sizeof(header), fp) != nullptr);
+    EXPECT_EQUAL(0, strncmp(header, "heap profile: ", 14));
+    fclose(fp);
+}
+
+TEST("verify malloc_trim keeps freed memory reusable") {
+    std::vector<void *> ptrs;
+    for (size_t i = 0; i < 64; i++) {
+        ptrs.push_back(malloc(256_Ki));
+        memset(ptrs.back(), 1, 256_Ki);
+    }
+    for (void * ptr : ptrs) {
+        free(ptr);
+    }
+    int ret = malloc_trim(0);
+    EXPECT_TRUE((ret == 0) || (ret == 1));
+    for (size_t i = 0; i < ptrs.size(); i++) {
+        ptrs[i] = malloc(256_Ki);
+        memset(ptrs[i], 2, 256_Ki);
+    }
+    for (void * ptr : ptrs) {
+        free(ptr);
+    }
+}
+
+size_t
+resident_bytes() {
+    FILE *fp = fopen("/proc/self/statm", "r");
+    size_t size = 0;
+    size_t resident = 0;
+    if (fp != nullptr) {
+        if (fscanf(fp, "%zu %zu", &size, &resident) != 2) {
+            resident = 0;
+        }
+        fclose(fp);
+    }
+    return resident * sysconf(_SC_PAGESIZE);
+}
+
+TEST("verify malloc_trim returns freed memory to the OS") {
+    std::vector<void *> ptrs;
+    for (size_t i = 0; i < 16; i++) {
+        ptrs.push_back(malloc(4_Mi));
+        memset(ptrs.back(), 1, 4_Mi);
+    }
+    for (void * ptr : ptrs) {
+        free(ptr);
+    }
+    size_t before = resident_bytes();
+    malloc_trim(0);
+    size_t after = resident_bytes();
+    LOG(info, "resident before trim = %zu, after trim = %zu", before, after);
+    EXPECT_LESS_EQUAL(after, before);
+    if (_env == MallocLibrary::UNKNOWN) return;
+    // The blocks are kept by vespamalloc until trimmed
+    EXPECT_GREATER_EQUAL(before - after, 32_Mi);
+}
+
 TEST("verify mmap_limit") {
     if (_env == MallocLibrary::UNKNOWN) return;
     EXPECT_EQUAL(1, mallopt(M_MMAP_THRESHOLD, 0x100000));
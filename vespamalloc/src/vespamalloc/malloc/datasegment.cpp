@@ -43,6 +43,27 @@ DataSegment::freeSize() const {
     return _freeList.numFreeBlocks() * BlockSize;
 }
 
+size_t
+DataSegment::releaseFreeMemory()
+{
+    size_t released(0);
+    Guard sync(_mutex);
+    const char * dataEnd = static_cast<const char *>(end());
+    // Blocks in the unmapped list smaller than the madvise limit have not been released yet either.
+    for (const FreeList * list : { &_freeList, &_unMappedList }) {
+        for (BlockIdT i(0); i < list->numChains(); i++) {
+            BlockIdT bId = list->chainStart(i);
+            char * first = static_cast<char *>(fromBlockId(bId));
+            // Blocks beyond the end have never been touched.
+            const char * last = std::min<const char *>(first + size_t(_blockList[bId].freeChainLength()) * BlockSize, dataEnd);
+            if ((first < last) && _osMemory.discard(first, last - first)) {
+                released += last - first;
+            }
+        }
+    }
+    return released;
+}
+
 void *
 DataSegment::getBlock(size_t & oldBlockSize, SizeClassT sc)
 {
@@ -45,6 +45,11 @@ public:
     static size_t adjustedClassSize(SizeClassT sc)  { return (sc > 0x400) ? (sc - 0x400) << 16 : sc; }
     size_t dataSize()                         const { return (const char*)end() - (const char*)start(); }
     size_t freeSize() const;
+    /**
+     * Gives the memory backing free blocks back to the OS, while keeping
+     * the blocks in the free list. Returns number of bytes released.
+     */
+    size_t releaseFreeMemory() __attribute__((noinline));
     size_t infoThread(FILE * os, int level, uint32_t thread, SizeClassT sct, uint32_t maxThreadId=0) const __attribute__((noinline));
     void info(FILE * os, size_t level) __attribute__((noinline));
     void setupLog(size_t bigMemLogLevel, size_t bigLimit, size_t bigIncrement, size_t allocs2Show) {
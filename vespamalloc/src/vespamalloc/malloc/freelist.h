@@ -80,6 +80,8 @@ public:
         }
     }
     Index numFreeBlocks() const;
+    Index numChains() const { return _count; }
+    Index chainStart(Index i) const { return _freeStartIndex[i]; }
     void info(FILE * os) __attribute__((noinline));
 private:
     void * linkOut(Index findex, Index left) __attribute__((noinline));
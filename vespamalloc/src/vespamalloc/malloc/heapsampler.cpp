@@ -0,0 +1,197 @@
+// Copyright Vespa.ai. Licensed under the terms of the Apache 2.0 license. See LICENSE in the project root.
+#include "heapsampler.h"
+#include <execinfo.h>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <unistd.h>
+#include <cstring>
+
+namespace vespamalloc {
+
+namespace {
+
+/**
+ * Formats into a stack buffer and writes it out when full, so that dumping
+ * never calls back into the allocator.
+ */
+class FdWriter {
+public:
+    explicit FdWriter(int fd) : _fd(fd), _pos(0), _ok(true) { }
+    ~FdWriter() { flush(); }
+    template <typename... Args>
+    void printf(const char * fmt, Args... args) {
+        if ((sizeof(_buf) - _pos) < 0x100) {
+            flush();
+        }
+        int n = snprintf(_buf + _pos, sizeof(_buf) - _pos, fmt, args...);
+        if (n > 0) {
+            _pos += std::min(size_t(n), sizeof(_buf) - _pos - 1);
+        }
+    }
+    void write(const char * buf, size_t sz) {
+        flush();
+        writeAll(buf, sz);
+    }
+    bool flush() {
+        writeAll(_buf, _pos);
+        _pos = 0;
+        return _ok;
+    }
+private:
+    void writeAll(const char * buf, size_t sz) {
+        while (_ok && (sz > 0)) {
+            ssize_t written = ::write(_fd, buf, sz);
+            if (written <= 0) {
+                _ok = false;
+            } else {
+                buf += written;
+                sz -= written;
+            }
+        }
+    }
+    int    _fd;
+    size_t _pos;
+    bool   _ok;
+    char   _buf[0x4000];
+};
+
+}
+
+HeapSampler::HeapSampler()
+    : _mutex(),
+      _sampleRate(0),
+      _heads(nullptr),
+      _samples(nullptr),
+      _used(0),
+      _freeList(0),
+      _numSamples(0),
+      _numDropped(0)
+{ }
+
+HeapSampler::~HeapSampler() = default;
+
+bool
+HeapSampler::mapTable()
+{
+    const int prot = PROT_READ | PROT_WRITE;
+    const int flags = MAP_ANON | MAP_PRIVATE | MAP_NORESERVE;
+    void * samples = ::mmap(nullptr, sizeof(Sample) * MaxSamples, prot, flags, -1, 0);
+    void * heads = ::mmap(nullptr, sizeof(std::atomic<uint32_t>) * NumBuckets, prot, flags, -1, 0);
+    if ((samples == MAP_FAILED) || (heads == MAP_FAILED)) {
+        fprintf(_G_logFile, "Failed mapping heap sampler table, sampling disabled\n");
+        if (samples != MAP_FAILED) {
+            munmap(samples, sizeof(Sample) * MaxSamples);
+        }
+        if (heads != MAP_FAILED) {
+            munmap(heads, sizeof(std::atomic<uint32_t>) * NumBuckets);
+        }
+        return false;
+    }
+    // Anonymous mappings are zero filled, which is the empty state.
+    _samples = static_cast<Sample *>(samples);
+    _heads.store(static_cast<std::atomic<uint32_t> *>(heads), std::memory_order_release);
+    return true;
+}
+
+void
+HeapSampler::setSampleRate(size_t sampleRate)
+{
+    Guard sync(_mutex);
+    if ((sampleRate != 0) && (_heads.load(std::memory_order_relaxed) == nullptr) && ! mapTable()) {
+        sampleRate = 0;
+    }
+    _sampleRate.store(sampleRate, std::memory_order_relaxed);
+}
+
+void
+HeapSampler::record(const void * ptr, size_t sz)
+{
+    void * stack[MaxStackDepth + 1];
+    int depth = backtrace(stack, NELEMS(stack));
+    Guard sync(_mutex);
+    std::atomic<uint32_t> * heads = _heads.load(std::memory_order_relaxed);
+    uint32_t index(0);
+    if (_freeList != 0) {
+        index = _freeList;
+        _freeList = _samples[index - 1]._next;
+    } else if (_used < MaxSamples) {
+        index = ++_used;
+    } else {
+        _numDropped.fetch_add(1, std::memory_order_relaxed);
+        return;
+    }
+    Sample & s = _samples[index - 1];
+    s._ptr = ptr;
+    s._size = sz;
+    // Do not include self
+    s._depth = (depth > 1) ? depth - 1 : 0;
+    memcpy(s._stack, stack + 1, s._depth * sizeof(s._stack[0]));
+    std::atomic<uint32_t> & head = heads[bucket(ptr)];
+    s._next = head.load(std::memory_order_relaxed);
+    head.store(index, std::memory_order_relaxed);
+    _numSamples.fetch_add(1, std::memory_order_relaxed);
+}
+
+void
+HeapSampler::forgetSampled(const void * ptr)
+{
+    Guard sync(_mutex);
+    std::atomic<uint32_t> & head = _heads.load(std::memory_order_relaxed)[bucket(ptr)];
+    uint32_t prev(0);
+    for (uint32_t index = head.load(std::memory_order_relaxed); index != 0; index = _samples[index - 1]._next) {
+        Sample & s = _samples[index - 1];
+        if (s._ptr == ptr) {
+            if (prev == 0) {
+                head.store(s._next, std::memory_order_relaxed);
+            } else {
+                _samples[prev - 1]._next = s._next;
+            }
+            s._ptr = nullptr;
+            s._next = _freeList;
+            _freeList = index;
+            _numSamples.fetch_sub(1, std::memory_order_relaxed);
+            return;
+        }
+        prev = index;
+    }
+}
+
+bool
+HeapSampler::dump(int fd) const
+{
+    FdWriter os(fd);
+    {
+        Guard sync(_mutex);
+        size_t count(0);
+        size_t bytes(0);
+        for (uint32_t i(0); i < _used; i++) {
+            if (_samples[i]._ptr != nullptr) {
+                count++;
+                bytes += _samples[i]._size;
+            }
+        }
+        os.printf("heap profile: %zu: %zu [ %zu: %zu] @ heap_v2/%zu\n", count, bytes, count, bytes, sampleRate());
+        for (uint32_t i(0); i < _used; i++) {
+            const Sample & s = _samples[i];
+            if (s._ptr != nullptr) {
+                os.printf("1: %zu [1: %zu] @", s._size, s._size);
+                for (uint32_t d(0); d < s._depth; d++) {
+                    os.printf(" %p", s._stack[d]);
+                }
+                os.printf("\n");
+            }
+        }
+    }
+    os.printf("\nMAPPED_LIBRARIES:\n");
+    int maps = open("/proc/self/maps", O_RDONLY);
+    if (maps >= 0) {
+        char buf[0x1000];
+        for (ssize_t n = read(maps, buf, sizeof(buf)); n > 0; n = read(maps, buf, sizeof(buf))) {
+            os.write(buf, n);
+        }
+        close(maps);
+    }
+    return os.flush();
+}
+
+}
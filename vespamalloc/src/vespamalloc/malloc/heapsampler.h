@@ -0,0 +1,73 @@
+// Copyright Vespa.ai. Licensed under the terms of the Apache 2.0 license. See LICENSE in the project root.
+#pragma once
+
+#include "common.h"
+
+namespace vespamalloc {
+
+/**
+ * Keeps the call stack of a sample of the live allocations, on average one
+ * for every sampleRate bytes allocated. It is cheap enough to be enabled in
+ * production. The sample table is mapped when sampling is first enabled, and
+ * the profile is written in the legacy gperftools heap profile format which
+ * pprof understands.
+ */
+class HeapSampler
+{
+public:
+    static constexpr size_t MaxStackDepth = 32;
+    static constexpr uint32_t MaxSamples = 0x10000;
+    static constexpr uint32_t NumBuckets = 0x100000;
+
+    HeapSampler();
+    HeapSampler(const HeapSampler &) = delete;
+    HeapSampler & operator = (const HeapSampler &) = delete;
+    ~HeapSampler();
+    void enableThreadSupport() { _mutex.init(); }
+    void setSampleRate(size_t sampleRate) __attribute__((noinline));
+    size_t sampleRate() const { return _sampleRate.load(std::memory_order_relaxed); }
+    bool enabled() const { return sampleRate() != 0; }
+    /// Number of bytes to allocate before the next sample. Jittered to avoid aliasing with allocation patterns.
+    size_t nextInterval(const void * ptr) const {
+        size_t rate = sampleRate();
+        return (rate/2) + (hash(ptr) % (rate + 1));
+    }
+    void record(const void * ptr, size_t sz) __attribute__((noinline));
+    void forget(const void * ptr) {
+        const std::atomic<uint32_t> * heads = _heads.load(std::memory_order_relaxed);
+        if (__builtin_expect(heads != nullptr, false) && (heads[bucket(ptr)].load(std::memory_order_relaxed) != 0)) {
+            forgetSampled(ptr);
+        }
+    }
+    size_t numSamples() const { return _numSamples.load(std::memory_order_relaxed); }
+    size_t numDropped() const { return _numDropped.load(std::memory_order_relaxed); }
+    /**
+     * Writes the heap profile to the given file descriptor. It does not
+     * allocate any memory, so it can safely be called at any time.
+     */
+    bool dump(int fd) const __attribute__((noinline));
+private:
+    struct Sample {
+        const void * _ptr;
+        size_t       _size;
+        uint32_t     _next;   // Index + 1 of next sample in bucket or free list, 0 terminates.
+        uint32_t     _depth;
+        void       * _stack[MaxStackDepth];
+    };
+    static size_t hash(const void * ptr) { return (size_t(ptr) >> 4) * 0x9E3779B97F4A7C15ul; }
+    static uint32_t bucket(const void * ptr) { return hash(ptr) >> (64 - 20); }
+    static_assert(NumBuckets == (1u << 20));
+    bool mapTable();
+    void forgetSampled(const void * ptr) __attribute__((noinline));
+
+    mutable Mutex                        _mutex;
+    std::atomic<size_t>                  _sampleRate;
+    std::atomic<std::atomic<uint32_t> *> _heads;
+    Sample                             * _samples;
+    uint32_t                             _used;
+    uint32_t                             _freeList;
+    std::atomic<size_t>                  _numSamples;
+    std::atomic<size_t>                  _numDropped;
+};
+
+}
@@ -6,6 +6,7 @@
 #include "allocchunk.h"
 #include "globalpool.h"
 #include "threadpool.h"
+#include "heapsampler.h"
 #include "threadlist.h"
 #include "threadproxy.h"
 
@@ -46,10 +47,12 @@ public:
     }
 
     int mallopt(int param, int value);
+    int trim();
     void *malloc(size_t sz);
     void *malloc(size_t sz, std::align_val_t);
     void *realloc(void *oldPtr, size_t sz);
     void free(void *ptr) {
+        _sampler.forget(ptr);
         if (_segment.containsPtr(ptr)) {
             freeSC(ptr, _segment.sizeClass(ptr));
         } else {
@@ -57,6 +60,7 @@ public:
         }
     }
     void free(void *ptr, size_t sz) {
+        _sampler.forget(ptr);
         if (_segment.containsPtr(ptr)) {
             freeSC(ptr, MemBlockPtrT::sizeClass(MemBlockPtrT::adjustSize(sz)));
         } else {
@@ -64,6 +68,7 @@ public:
         }
     }
     void free(void *ptr, size_t sz, std::align_val_t alignment) {
+        _sampler.forget(ptr);
         if (_segment.containsPtr(ptr)) {
             freeSC(ptr, MemBlockPtrT::sizeClass(MemBlockPtrT::adjustSize(sz, alignment)));
         } else {
@@ -96,18 +101,25 @@ public:
         _threadList.setParams(threadCacheLimit);
         _allocPool.setParams(threadCacheLimit);
     }
+    void setHeapSampleRate(size_t sampleRate) { _sampler.setSampleRate(sampleRate); }
+    bool dumpHeapProfile(int fd) const { return _sampler.dump(fd); }
     const DataSegment & dataSegment() const { return _segment; }
     const MMapPool & mmapPool() const { return _mmapPool; }
+    const HeapSampler & heapSampler() const { return _sampler; }
 private:
     void freeSC(void *ptr, SizeClassT sc);
     void crash() __attribute__((noinline));
     using AllocPool = AllocPoolT<MemBlockPtrT>;
     using ThreadPool = typename ThreadListT::ThreadPool;
+    void sampleAllocation(ThreadPool & tp, const void * ptr, size_t sz) __attribute__((noinline));
     size_t       _prAllocLimit;
     DataSegment  _segment;
     AllocPool    _allocPool;
     MMapPool     _mmapPool;
     ThreadListT  _threadList;
+    HeapSampler  _sampler;
+    /// How often threads check if sampling has been enabled, when it is not.
+    static constexpr size_t SAMPLING_RECHECK_INTERVAL = 0x40000000; // 1G
 };
 
 template <typename MemBlockPtrT, typename ThreadListT>
@@ -117,7 +129,8 @@ MemoryManager<MemBlockPtrT, ThreadListT>::MemoryManager(size_t logLimitAtStart)
     _segment(*this),
     _allocPool(_segment),
     _mmapPool(),
-    _threadList(_allocPool, _mmapPool)
+    _threadList(_allocPool, _mmapPool),
+    _sampler()
 {
     setAllocatorForThreads(this);
     initThisThread();
@@ -152,6 +165,7 @@ void MemoryManager<MemBlockPtrT, ThreadListT>::enableThreadSupport()
     _segment.enableThreadSupport();
     _allocPool.enableThreadSupport();
     _threadList.enableThreadSupport();
+    _sampler.enableThreadSupport();
 }
 
 template <typename MemBlockPtrT, typename ThreadListT>
@@ -180,6 +194,12 @@ int MemoryManager<MemBlockPtrT, ThreadListT>::mallopt(int param, int value) {
     return _threadList.getCurrent().mallopt(param, value);
 }
 
+template <typename MemBlockPtrT, typename ThreadListT>
+int MemoryManager<MemBlockPtrT, ThreadListT>::trim() {
+    _threadList.getCurrent().trim();
+    return (_segment.releaseFreeMemory() > 0) ? 1 : 0;
+}
+
 template <typename MemBlockPtrT, typename ThreadListT>
 void * MemoryManager<MemBlockPtrT, ThreadListT>::malloc(size_t sz)
 {
@@ -192,6 +212,9 @@ void * MemoryManager<MemBlockPtrT, ThreadListT>::malloc(size_t sz)
     }
     mem.setExact(sz);
     mem.alloc(_prAllocLimit<=mem.adjustSize(sz));
+    if (tp.countSampledBytes(sz)) {
+        sampleAllocation(tp, mem.ptr(), sz);
+    }
     return mem.ptr();
 }
 
@@ -207,9 +230,23 @@ void * MemoryManager<MemBlockPtrT, ThreadListT>::malloc(size_t sz, std::align_va
     }
     mem.setExact(sz, alignment);
     mem.alloc(_prAllocLimit<=mem.adjustSize(sz, alignment));
+    if (tp.countSampledBytes(sz)) {
+        sampleAllocation(tp, mem.ptr(), sz);
+    }
     return mem.ptr();
 }
 
+template <typename MemBlockPtrT, typename ThreadListT>
+void MemoryManager<MemBlockPtrT, ThreadListT>::sampleAllocation(ThreadPool & tp, const void * ptr, size_t sz)
+{
+    if (_sampler.enabled()) {
+        tp.resetSampleCountdown(_sampler.nextInterval(ptr));
+        _sampler.record(ptr, sz);
+    } else {
+        tp.resetSampleCountdown(SAMPLING_RECHECK_INTERVAL);
+    }
+}
+
 template <typename MemBlockPtrT, typename ThreadListT>
 void MemoryManager<MemBlockPtrT, ThreadListT>::freeSC(void *ptr, SizeClassT sc)
 {
@@ -241,6 +278,7 @@ void * MemoryManager<MemBlockPtrT, ThreadListT>::realloc(void *oldPtr, size_t sz
         void * ptr = malloc(sz);
         size_t oldBlockSize = _mmapPool.get_size(MemBlockPtrT(oldPtr).rawPtr());
         memcpy(ptr, oldPtr, MemBlockPtrT::unAdjustSize(oldBlockSize));
+        _sampler.forget(oldPtr);
         _mmapPool.unmap(MemBlockPtrT(oldPtr).rawPtr());
         return ptr;
     }
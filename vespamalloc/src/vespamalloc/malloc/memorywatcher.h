@@ -25,6 +25,7 @@ private:
     int     getDumpSignal() const { return _params[Params::dumpsignal].valueAsLong(); }
     static int getReconfigSignal() { return SIGHUP; }
     bool activateLogFile(const char *logfile);
+    void writeHeapProfile();
     void activateOptions();
     void getOptions() __attribute__ ((noinline));
     void parseOptions(char * options) __attribute__ ((noinline));
@@ -67,6 +68,8 @@ private:
             bigblocklimit,
             fillvalue,
             dumpsignal,
+            heapprofile_samplerate,
+            heapprofile_file,
             numberofentries  // Must be the last one
         };
         Params() __attribute__ ((noinline));
@@ -126,6 +129,8 @@ MemoryWatcher<T, S>::Params::Params()
     _params[          bigblocklimit] = NameValuePair("bigblocklimit", "0x80000000"); // 8M
     _params[              fillvalue] = NameValuePair("fillvalue", "0xa8"); // Means NO fill.
     _params[             dumpsignal] = NameValuePair("dumpsignal", "27"); // SIGPROF
+    _params[ heapprofile_samplerate] = NameValuePair("heapprofile_samplerate", "0"); // 0 means no sampling, 0x80000 is a sane value
+    _params[       heapprofile_file] = NameValuePair("heapprofile_file", "vespamalloc.heap");
 }
 
 template <typename T, typename S>
@@ -191,6 +196,22 @@ bool MemoryWatcher<T, S>::activateLogFile(const char *logfile)
     return (_logFile != nullptr);
 }
 
+template <typename T, typename S>
+void MemoryWatcher<T, S>::writeHeapProfile()
+{
+    char fileName[1024];
+    snprintf(fileName, sizeof(fileName), "%s.%d", _params[Params::heapprofile_file].value(), getpid());
+    int fd = open(fileName, O_WRONLY | O_CREAT | O_TRUNC, 0644);
+    if (fd >= 0) {
+        if ( ! this->dumpHeapProfile(fd)) {
+            fprintf(_logFile, "Failed writing heap profile to %s\n", fileName);
+        }
+        close(fd);
+    } else {
+        fprintf(_logFile, "Failed opening %s for heap profile\n", fileName);
+    }
+}
+
 template <typename T, typename S>
 void MemoryWatcher<T, S>::activateOptions()
 {
@@ -204,6 +225,7 @@ void MemoryWatcher<T, S>::activateOptions()
     this->setParams(_params[Params::threadcachelimit].valueAsLong());
     _G_bigBlockLimit = _params[Params::bigblocklimit].valueAsLong();
     T::setFill(_params[Params::fillvalue].valueAsLong());
+    this->setHeapSampleRate(_params[Params::heapprofile_samplerate].valueAsLong());
 
 }
 
@@ -323,6 +345,9 @@ void MemoryWatcher<T, S>::signalHandler(int signum, siginfo_t * sig, void *  arg
     }
     if (signum == getDumpSignal()) {
         this->info(_logFile, _params[Params::sigprof_loglevel].valueAsLong());
+        if (this->heapSampler().enabled()) {
+            writeHeapProfile();
+        }
     } else if (signum == getReconfigSignal()) {
         getOptions();
         if (_params[Params::sigprof_loglevel].valueAsLong() > 1) {
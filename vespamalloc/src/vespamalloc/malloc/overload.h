@@ -153,6 +153,16 @@ int mallopt(int param, int value) throw() {
     return vespamalloc::createAllocator()->mallopt(param, value);
 }
 
+int vespamalloc_dump_heap_profile(int fd) __attribute((visibility("default")));
+int vespamalloc_dump_heap_profile(int fd) {
+    return vespamalloc::createAllocator()->dumpHeapProfile(fd) ? 0 : -1;
+}
+
+int malloc_trim(size_t pad) __THROW __attribute((visibility("default")));
+int malloc_trim(size_t) __THROW {
+    return vespamalloc::createAllocator()->trim();
+}
+
 void * malloc(size_t sz) __attribute((visibility("default")));
 void * malloc(size_t sz) {
     return vespamalloc::createAllocator()->malloc(sz);
@@ -29,6 +29,15 @@ public:
     int mallopt(int param, int value);
     void malloc(size_t sz, MemBlockPtrT & mem);
     void free(MemBlockPtrT mem, SizeClassT sc);
+    /**
+     * Counts down the number of bytes to allocate before the next heap sample.
+     * @return true if this allocation should be sampled.
+     */
+    bool countSampledBytes(size_t sz) {
+        _bytesUntilSample -= sz;
+        return __builtin_expect(_bytesUntilSample <= 0, false);
+    }
+    void resetSampleCountdown(size_t bytes) { _bytesUntilSample = bytes; }
 
     void info(FILE * os, size_t level, const DataSegment & ds) const __attribute__((noinline));
     /**
@@ -43,7 +52,12 @@ public:
     bool isUsed() const;
     int osThreadId()       const { return _osThreadId; }
     uint32_t threadId()    const { return _threadId; }
-    void quit() { _osThreadId = 0; } // Implicit memory barrier
+    /**
+     * Hands all memory cached by this thread back to the global pool.
+     * Must be called by the owning thread.
+     */
+    void trim();
+    void quit() { trim(); _osThreadId = 0; } // Implicit memory barrier
     void init(int thrId);
     static void setParams(size_t threadCacheLimit);
     bool grabAvailable();
@@ -77,6 +91,7 @@ private:
     size_t        _mmapLimit;
     AllocFree     _memList[NUM_SIZE_CLASSES];
     ThreadStatT   _stat[NUM_SIZE_CLASSES];
+    ssize_t       _bytesUntilSample;
     uint32_t      _threadId;
     std::atomic<ssize_t> _osThreadId;
 
@@ -104,6 +104,7 @@ ThreadPoolT<MemBlockPtrT, ThreadStatT>::ThreadPoolT() :
     _allocPool(nullptr),
     _mmapPool(nullptr),
     _mmapLimit(MMAP_LIMIT_MAX),
+    _bytesUntilSample(0),
     _threadId(0),
     _osThreadId(0)
 {
@@ -177,6 +178,28 @@ void ThreadPoolT<MemBlockPtrT, ThreadStatT>::free(MemBlockPtrT mem, SizeClassT s
     PARANOID_CHECK2(if (af._freeTo->full()) { *(int *)1 = 1; } );
 }
 
+template <typename MemBlockPtrT, typename ThreadStatT >
+void ThreadPoolT<MemBlockPtrT, ThreadStatT>::trim()
+{
+    for (SizeClassT sc(0); sc < SizeClassT(NUM_SIZE_CLASSES); sc++) {
+        AllocFree & af = _memList[sc];
+        if (af._allocFrom == nullptr) {
+            continue;
+        }
+        for (ChunkSList ** csl : { &af._freeTo, &af._allocFrom }) {
+            if ( ! (*csl)->empty()) {
+                if ( ! alwaysReuse(sc) ) {
+                    *csl = _allocPool->exchangeFree(sc, *csl);
+                    _stat[sc].incExchangeFree();
+                } else {
+                    *csl = _allocPool->returnMemory(sc, *csl);
+                    _stat[sc].incReturnFree();
+                }
+            }
+        }
+    }
+}
+
 template <typename MemBlockPtrT, typename ThreadStatT >
 bool ThreadPoolT<MemBlockPtrT, ThreadStatT>::isActive() const
 {
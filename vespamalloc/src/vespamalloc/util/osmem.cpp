@@ -244,6 +244,18 @@ MmapMemory::release(void * mem, size_t len)
     return true;
 }
 
+bool
+MmapMemory::discard(void * mem, size_t len)
+{
+    // Unlike release, this ignores the madvise limit as it is only used on explicit request.
+    int ret = madvise(mem, len, MADV_DONTNEED);
+    if (ret != 0) {
+        char tmp[256];
+        fprintf(stderr, "madvise(%p, %0lx, MADV_DONTNEED) = %d errno=%s\n", mem, len, ret, strerror_r(errno, tmp, sizeof(tmp)));
+    }
+    return (ret == 0);
+}
+
 bool
 MmapMemory::freeTail(void * mem, size_t len)
 {
@@ -31,6 +31,7 @@ public:
     void *reserve(size_t & len);
     void *get(size_t len);
     bool release(void * mem, size_t len);
+    bool discard(void * mem, size_t len);
     bool reclaim(void * mem, size_t len);
     bool freeTail(void * mem, size_t len);
 private: